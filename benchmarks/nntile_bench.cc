@@ -0,0 +1,384 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file benchmarks/nntile_bench.cc
+ * Benchmarks of tensor operations and underlying StarPU codelets
+ *
+ * Every operation is timed for a sweep of shapes, base tile shapes and
+ * precisions with codelets restricted to CPU and to CUDA workers (if
+ * present). Results are reported as a JSON array of records with achieved
+ * GFLOP/s, GB/s and, if peak performance of the hardware is provided,
+ * fraction of the roofline bound. Codelets without implementation for the
+ * requested workers ignore the restriction. Rate of submission of tiny
+ * tasks is measured with and without the pool of arguments of codelets.
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-10
+ * */
+
+#include <nntile.hh>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+//! Description of a benchmarked operation on tensors of shape [m, n] or, in
+//! case of gemm, operation on matrices of shape [m, m]
+template<typename T>
+struct Benchmark
+{
+    //! Name of operation
+    std::string name;
+    //! Number of floating point operations for given m and n
+    std::function<double(Index, Index)> nflops;
+    //! Number of elements read and written for given m and n
+    std::function<double(Index, Index)> nelems_moved;
+    //! Submit operation on preallocated tensors
+    std::function<void(const std::vector<Tensor<T>> &)> submit;
+    //! Shapes of required tensors for given m and n
+    std::function<std::vector<std::vector<Index>>(Index, Index)> shapes;
+};
+
+//! Options of the benchmark run
+struct Options
+{
+    std::string output = "benchmarks.json";
+    Index niters = 5;
+    double peak_gflops = 0;
+    double peak_gbps = 0;
+};
+
+// Base tile shape of an auxiliary tensor, deduced from the main tile
+std::vector<Index> get_basetile(const std::vector<Index> &shape, Index tile)
+{
+    std::vector<Index> basetile(shape);
+    for(Index i = 0; i < shape.size(); ++i)
+    {
+        // Leading dimension of 2 is used by maxsumexp and is not tiled
+        if(shape[i] > 2)
+        {
+            basetile[i] = std::min(shape[i], tile);
+        }
+    }
+    return basetile;
+}
+
+template<typename T>
+std::vector<Benchmark<T>> get_benchmarks()
+{
+    using S = std::vector<std::vector<Index>>;
+    std::vector<Benchmark<T>> b;
+    auto mn = [](Index m, Index n){return double(m)*double(n);};
+    b.push_back({"fill", [](Index, Index){return 0.0;}, mn,
+            [](const std::vector<Tensor<T>> &t){fill_async<T>(T(0.5), t[0]);},
+            [](Index m, Index n){return S{{m, n}};}});
+    b.push_back({"copy", [](Index, Index){return 0.0;},
+            [=](Index m, Index n){return 2*mn(m, n);},
+            [](const std::vector<Tensor<T>> &t){copy_async<T>(t[0], t[1]);},
+            [](Index m, Index n){return S{{m, n}, {m, n}};}});
+    b.push_back({"add", [=](Index m, Index n){return 3*mn(m, n);},
+            [=](Index m, Index n){return 3*mn(m, n);},
+            [](const std::vector<Tensor<T>> &t)
+            {
+                add_async<T>(T(1), t[0], T(1), t[1]);
+            },
+            [](Index m, Index n){return S{{m, n}, {m, n}};}});
+    b.push_back({"scal", mn, [=](Index m, Index n){return 2*mn(m, n);},
+            [](const std::vector<Tensor<T>> &t)
+            {
+                scal_async<T>(T(0.5), t[0], t[1]);
+            },
+            [](Index m, Index n){return S{{m, n}, {m, n}};}});
+    b.push_back({"prod", mn, [=](Index m, Index n){return 3*mn(m, n);},
+            [](const std::vector<Tensor<T>> &t){prod_async<T>(t[0], t[1]);},
+            [](Index m, Index n){return S{{m, n}, {m, n}};}});
+    b.push_back({"hypot", [=](Index m, Index n){return 5*mn(m, n);},
+            [=](Index m, Index n){return 3*mn(m, n);},
+            [](const std::vector<Tensor<T>> &t)
+            {
+                hypot_async<T>(T(1), t[0], T(1), t[1]);
+            },
+            [](Index m, Index n){return S{{m, n}, {m, n}};}});
+    b.push_back({"sqrt", mn, [=](Index m, Index n){return 2*mn(m, n);},
+            [](const std::vector<Tensor<T>> &t){sqrt_async<T>(t[0], t[1]);},
+            [](Index m, Index n){return S{{m, n}, {m, n}};}});
+    b.push_back({"relu", mn, [=](Index m, Index n){return 2*mn(m, n);},
+            [](const std::vector<Tensor<T>> &t){relu_async<T>(t[0]);},
+            [](Index m, Index n){return S{{m, n}};}});
+    b.push_back({"gelu", [=](Index m, Index n){return 10*mn(m, n);},
+            [=](Index m, Index n){return 2*mn(m, n);},
+            [](const std::vector<Tensor<T>> &t){gelu_async<T>(t[0]);},
+            [](Index m, Index n){return S{{m, n}};}});
+    b.push_back({"gelutanh", [=](Index m, Index n){return 10*mn(m, n);},
+            [=](Index m, Index n){return 2*mn(m, n);},
+            [](const std::vector<Tensor<T>> &t)
+            {
+                gelutanh_async<T>(t[0], t[1]);
+            },
+            [](Index m, Index n){return S{{m, n}, {m, n}};}});
+    b.push_back({"sum_slice", mn, mn,
+            [](const std::vector<Tensor<T>> &t)
+            {
+                sum_slice_async<T>(T(1), t[0], T(0), t[1], 0);
+            },
+            [](Index m, Index n){return S{{m, n}, {n}};}});
+    b.push_back({"norm_slice", [=](Index m, Index n){return 2*mn(m, n);},
+            mn,
+            [](const std::vector<Tensor<T>> &t)
+            {
+                norm_slice_async<T>(T(1), t[0], T(0), t[1], 0);
+            },
+            [](Index m, Index n){return S{{m, n}, {n}};}});
+    b.push_back({"maxsumexp", [=](Index m, Index n){return 4*mn(m, n);},
+            mn,
+            [](const std::vector<Tensor<T>> &t)
+            {
+                clear_async<T>(t[1]);
+                maxsumexp_async<T>(t[0], t[1], 0);
+            },
+            [](Index m, Index n){return S{{m, n}, {2, n}};}});
+    b.push_back({"softmax", [=](Index m, Index n){return 3*mn(m, n);},
+            [=](Index m, Index n){return 2*mn(m, n);},
+            [](const std::vector<Tensor<T>> &t)
+            {
+                softmax_async<T>(t[1], t[0], T(1), t[2], 0);
+            },
+            [](Index m, Index n){return S{{m, n}, {2, n}, {m, n}};}});
+    b.push_back({"adam_step", [=](Index m, Index n){return 15*mn(m, n);},
+            [=](Index m, Index n){return 7*mn(m, n);},
+            [](const std::vector<Tensor<T>> &t)
+            {
+                adam_step_async<T>(2, T(0.9), T(0.999), T(1e-8), T(1e-3),
+                        T(0), t[0], t[1], t[2], t[3]);
+            },
+            [](Index m, Index n){return S{{m, n}, {m, n}, {m, n}, {m, n}};}});
+    b.push_back({"gemm",
+            [](Index m, Index n){return 2*double(m)*double(m)*double(m);},
+            [](Index m, Index n){return 4*double(m)*double(m);},
+            [](const std::vector<Tensor<T>> &t)
+            {
+                gemm_async<T>(T(1), TransOp(TransOp::NoTrans), t[0],
+                        TransOp(TransOp::NoTrans), t[1], T(0), t[2], 1, 0);
+            },
+            [](Index m, Index n){return S{{m, m}, {m, m}, {m, m}};}});
+    return b;
+}
+
+// Run a single benchmark and print its JSON record
+template<typename T>
+void run(const Benchmark<T> &b, const char *dtype, const char *where,
+        Index m, Index n, Index tile, const Options &opts, std::ostream &out,
+        bool &first)
+{
+    starpu_mpi_tag_t last_tag = 0;
+    std::vector<Tensor<T>> tensors;
+    std::stringstream record;
+    record << "  {\"op\": \"" << b.name << "\", \"dtype\": \"" << dtype
+        << "\", \"where\": \"" << where << "\", \"shape\": [" << m << ", "
+        << n << "], \"tile\": " << tile;
+    try
+    {
+        for(const auto &shape: b.shapes(m, n))
+        {
+            TensorTraits traits(shape, get_basetile(shape, tile));
+            std::vector<int> distr(traits.grid.nelems, 0);
+            tensors.emplace_back(traits, distr, last_tag);
+            std::vector<Index> start(shape.size(), 0);
+            randn_async<T>(tensors.back(), start, shape, 0, T(0), T(1));
+        }
+        // Inputs of softmax shall be consistent
+        if(b.name == "softmax")
+        {
+            clear_async<T>(tensors[1]);
+            maxsumexp_async<T>(tensors[0], tensors[1], 0);
+        }
+        // Warmup also calibrates performance models
+        b.submit(tensors);
+        starpu_task_wait_for_all();
+        auto time0 = std::chrono::steady_clock::now();
+        for(Index i = 0; i < opts.niters; ++i)
+        {
+            b.submit(tensors);
+        }
+        starpu_task_wait_for_all();
+        auto time1 = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(time1-time0).count()
+            / opts.niters;
+        double gflops = b.nflops(m, n) / seconds * 1e-9;
+        double gbps = b.nelems_moved(m, n) * sizeof(T) / seconds * 1e-9;
+        record << ", \"time\": " << seconds << ", \"gflops\": " << gflops
+            << ", \"gbps\": " << gbps;
+        // Roofline bound is the minimum of peak compute and bandwidth bound
+        if(opts.peak_gflops > 0 and opts.peak_gbps > 0)
+        {
+            double intensity = b.nflops(m, n)
+                / (b.nelems_moved(m, n)*sizeof(T));
+            double fraction;
+            if(intensity > 0)
+            {
+                fraction = gflops / std::min(opts.peak_gflops,
+                        intensity*opts.peak_gbps);
+            }
+            else
+            {
+                fraction = gbps / opts.peak_gbps;
+            }
+            record << ", \"roofline\": " << fraction;
+        }
+    }
+    catch(const std::exception &e)
+    {
+        record << ", \"error\": \"" << e.what() << "\"";
+    }
+    record << "}";
+    for(auto &t: tensors)
+    {
+        t.unregister();
+    }
+    if(not first)
+    {
+        out << ",\n";
+    }
+    first = false;
+    out << record.str();
+    std::cout << record.str() << "\n";
+}
+
+template<typename T>
+void run_all(const char *dtype, const char *where, const Options &opts,
+        std::ostream &out, bool &first)
+{
+    // Elementwise and reduction operations, while gemm is done only for
+    // square matrices of the first dimension
+    const std::vector<std::vector<Index>> shapes = {{1024, 1024},
+        {4096, 4096}};
+    const std::vector<Index> tiles = {256, 1024, 4096};
+    for(const auto &b: get_benchmarks<T>())
+    {
+        for(const auto &shape: shapes)
+        {
+            for(Index tile: tiles)
+            {
+                if(tile > shape[0])
+                {
+                    continue;
+                }
+                run<T>(b, dtype, where, shape[0], shape[1], tile, opts, out,
+                        first);
+            }
+        }
+    }
+}
+
+// Rate of submission and execution of tiny tasks with and without the pool
+// of buffers for arguments of codelets
+template<typename T>
+void run_submission(const char *dtype, const Options &opts,
+        std::ostream &out, bool &first)
+{
+    starpu_mpi_tag_t last_tag = 0;
+    TensorTraits traits({1024, 1024}, {16, 16});
+    std::vector<int> distr(traits.grid.nelems, 0);
+    Tensor<T> x(traits, distr, last_tag);
+    for(bool pool: {false, true})
+    {
+        starpu::ArgsPool::set_enabled(pool);
+        // Warmup fills the pool
+        fill_async<T>(T(0), x);
+        starpu_task_wait_for_all();
+        auto time0 = std::chrono::steady_clock::now();
+        for(Index i = 0; i < opts.niters; ++i)
+        {
+            fill_async<T>(T(0.5), x);
+        }
+        auto time1 = std::chrono::steady_clock::now();
+        starpu_task_wait_for_all();
+        auto time2 = std::chrono::steady_clock::now();
+        double ntasks = double(traits.grid.nelems) * opts.niters;
+        double submit = std::chrono::duration<double>(time1-time0).count();
+        double total = std::chrono::duration<double>(time2-time0).count();
+        std::stringstream record;
+        record << "  {\"op\": \"submit\", \"dtype\": \"" << dtype
+            << "\", \"args_pool\": " << (pool ? "true" : "false")
+            << ", \"ntasks\": " << ntasks << ", \"submit_rate\": "
+            << ntasks/submit << ", \"task_rate\": " << ntasks/total << "}";
+        if(not first)
+        {
+            out << ",\n";
+        }
+        first = false;
+        out << record.str();
+        std::cout << record.str() << "\n";
+    }
+    starpu::ArgsPool::set_enabled(true);
+    x.unregister();
+}
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    for(int i = 1; i < argc; ++i)
+    {
+        if(std::strcmp(argv[i], "--output") == 0 and i+1 < argc)
+        {
+            opts.output = argv[++i];
+        }
+        else if(std::strcmp(argv[i], "--niters") == 0 and i+1 < argc)
+        {
+            opts.niters = std::stoll(argv[++i]);
+        }
+        else if(std::strcmp(argv[i], "--peak-gflops") == 0 and i+1 < argc)
+        {
+            opts.peak_gflops = std::stod(argv[++i]);
+        }
+        else if(std::strcmp(argv[i], "--peak-gbps") == 0 and i+1 < argc)
+        {
+            opts.peak_gbps = std::stod(argv[++i]);
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--output file.json] "
+                "[--niters N] [--peak-gflops X] [--peak-gbps Y]\n";
+            return 1;
+        }
+    }
+    if(opts.niters <= 0)
+    {
+        std::cerr << "Number of iterations shall be positive\n";
+        return 1;
+    }
+    // Init StarPU with all the workers and all the codelets
+    starpu::Config starpu(-1, -1, 1);
+    starpu::init();
+    std::ofstream out(opts.output);
+    out << "[\n";
+    bool first = true;
+    std::vector<std::pair<const char *, uint32_t>> wheres = {
+        {"cpu", STARPU_CPU}};
+    if(starpu_worker_get_count_by_type(STARPU_CUDA_WORKER) > 0)
+    {
+        wheres.push_back({"cuda", STARPU_CUDA});
+    }
+    for(const auto &where: wheres)
+    {
+        starpu::restrict_where(where.second);
+        run_all<fp32_t>("fp32", where.first, opts, out, first);
+        run_all<fp64_t>("fp64", where.first, opts, out, first);
+        starpu::restore_where();
+    }
+    // Tasks per second are measured with tasks on any workers
+    run_submission<fp32_t>("fp32", opts, out, first);
+    out << "\n]\n";
+    return 0;
+}
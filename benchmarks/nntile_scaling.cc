@@ -0,0 +1,447 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file benchmarks/nntile_scaling.cc
+ * Weak and strong scaling of distributed tensor operations
+ *
+ * Every operation is timed on tensors, distributed block-cyclically over the
+ * first p MPI nodes for p = 1, 2, 4, ... up to the number of nodes of the
+ * run. Strong scaling keeps the shape of tensors, while weak scaling grows
+ * the last dimension proportionally to p. Communication volume is the number
+ * of bytes of tiles, that are sent to nodes executing tasks, as every
+ * distributed operation executes tasks on the node of the destination tile.
+ * Cached tiles are flushed after each iteration, so that each iteration
+ * sends the same tiles. Results are reported as a JSON array of records
+ * with time, GFLOP/s, communication volume and parallel efficiency relative
+ * to a single node. Operation flash_softmax_gemm submits all of its tasks on
+ * every node, so it is timed only by single-node runs as a baseline for
+ * attention benchmarks.
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include <nntile.hh>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace nntile;
+using namespace nntile::tensor;
+using T = fp32_t;
+
+//! Options of the benchmark run
+struct Options
+{
+    std::string output = "scaling.json";
+    Index niters = 5;
+    int max_nodes = 0;
+    bool weak = true;
+    bool strong = true;
+};
+
+//! Bytes of tiles, sent between MPI nodes within a single operation
+/*! StarPU-MPI caches received tiles until they are flushed, so a tile is
+ * sent to a node at most once.
+ * */
+class CommVolume
+{
+    std::set<std::tuple<int, Index, int>> sent;
+public:
+    double bytes = 0;
+    //! Account for a tile of a tensor with a given id, needed on a node
+    template<typename V>
+    void add(int id, const Tensor<V> &t, Index tile, int rank)
+    {
+        if(t.get_tile_handle(tile).mpi_get_rank() == rank)
+        {
+            return;
+        }
+        if(sent.emplace(id, tile, rank).second)
+        {
+            bytes += double(t.get_tile_traits(tile).nelems) * sizeof(V);
+        }
+    }
+};
+
+//! Prepared distributed problem
+/*! Closures hold copies of tensors, so tensors are unregistered together
+ * with the problem.
+ * */
+struct Problem
+{
+    //! Shape of the main tensor
+    std::vector<Index> shape;
+    //! Base tile of the main tensor
+    Index tile;
+    //! Number of floating point operations
+    double nflops;
+    //! Communication volume in bytes
+    double comm_bytes;
+    //! Submit operation
+    std::function<void()> submit;
+    //! Flush cached tiles of all tensors
+    std::function<void()> flush;
+};
+
+//! Description of a benchmarked operation
+struct Benchmark
+{
+    //! Name of operation
+    std::string name;
+    //! Maximal number of nodes of a run, zero means no limit
+    int max_nodes;
+    //! Create tensors, distributed over nodes [0, p), with the last
+    //! dimension multiplied by a given scale
+    std::function<Problem(int, Index, starpu_mpi_tag_t &)> make;
+};
+
+//! The most square grid of p MPI nodes
+std::vector<int> mpi_grid_2d(int p)
+{
+    int rows = 1;
+    for(int i = 1; i*i <= p; ++i)
+    {
+        if(p % i == 0)
+        {
+            rows = i;
+        }
+    }
+    return {rows, p/rows};
+}
+
+//! Tensor of random values, distributed block-cyclically over nodes [0, p)
+Tensor<T> make_tensor(const std::vector<Index> &shape,
+        const std::vector<Index> &basetile, const std::vector<int> &mpi_grid,
+        int p, starpu_mpi_tag_t &last_tag)
+{
+    TensorTraits traits(shape, basetile);
+    auto distr = distributions::block_cyclic(traits.grid.shape, mpi_grid, 0,
+            p);
+    Tensor<T> t(traits, distr, last_tag);
+    std::vector<Index> start(shape.size(), 0);
+    randn_async<T>(t, start, shape, 0, T(0), T(1));
+    return t;
+}
+
+//! Matrix product C = A*B of matrices of shape [m, m] by [m, m*scale]
+Problem make_gemm(int p, Index scale, starpu_mpi_tag_t &last_tag)
+{
+    constexpr Index m = 2048, tile = 512;
+    Index n = m * scale;
+    auto grid = mpi_grid_2d(p);
+    auto A = make_tensor({m, m}, {tile, tile}, grid, p, last_tag);
+    auto B = make_tensor({m, n}, {tile, tile}, grid, p, last_tag);
+    auto C = make_tensor({m, n}, {tile, tile}, grid, p, last_tag);
+    // Tiles A(i,l) and B(l,j) are sent to the owner of C(i,j)
+    CommVolume comm;
+    for(Index j = 0; j < C.grid.shape[1]; ++j)
+    {
+        for(Index i = 0; i < C.grid.shape[0]; ++i)
+        {
+            int rank = C.get_tile_handle({i, j}).mpi_get_rank();
+            for(Index l = 0; l < A.grid.shape[1]; ++l)
+            {
+                comm.add(0, A, A.grid.index_to_linear({i, l}), rank);
+                comm.add(1, B, B.grid.index_to_linear({l, j}), rank);
+            }
+        }
+    }
+    return {{m, n}, tile, 2*double(m)*double(m)*double(n), comm.bytes,
+        [=]()
+        {
+            gemm_async<T>(T(1), TransOp(TransOp::NoTrans), A,
+                    TransOp(TransOp::NoTrans), B, T(0), C, 1, 0);
+        },
+        [=](){A.mpi_flush(); B.mpi_flush(); C.mpi_flush();}};
+}
+
+//! Sum of a matrix of shape [m, m*scale] along the first axis
+Problem make_sum_slice(int p, Index scale, starpu_mpi_tag_t &last_tag)
+{
+    constexpr Index m = 4096, tile = 512;
+    Index n = m * scale;
+    auto src = make_tensor({m, n}, {tile, tile}, mpi_grid_2d(p), p,
+            last_tag);
+    auto dst = make_tensor({n}, {tile}, {p}, p, last_tag);
+    // Tiles src(i,j) are sent to the owner of dst(j)
+    CommVolume comm;
+    for(Index j = 0; j < dst.grid.shape[0]; ++j)
+    {
+        int rank = dst.get_tile_handle(j).mpi_get_rank();
+        for(Index i = 0; i < src.grid.shape[0]; ++i)
+        {
+            comm.add(0, src, src.grid.index_to_linear({i, j}), rank);
+        }
+    }
+    return {{m, n}, tile, double(m)*double(n), comm.bytes,
+        [=](){sum_slice_async<T>(T(1), src, T(0), dst, 0);},
+        [=](){src.mpi_flush(); dst.mpi_flush();}};
+}
+
+//! Scatter or gather of a matrix of shape [m, m*scale] to or from a single
+//! tile on the root node
+Problem make_scatter_gather(bool scatter, int p, Index scale,
+        starpu_mpi_tag_t &last_tag)
+{
+    constexpr Index m = 2048, tile = 256;
+    Index n = m * scale;
+    auto single = make_tensor({m, n}, {m, n}, {1, 1}, 1, last_tag);
+    auto tiled = make_tensor({m, n}, {tile, tile}, mpi_grid_2d(p), p,
+            last_tag);
+    // Every tile, that is not on the root node, is sent once
+    double bytes = 0;
+    for(Index i = 0; i < tiled.grid.nelems; ++i)
+    {
+        if(tiled.get_tile_handle(i).mpi_get_rank() != 0)
+        {
+            bytes += double(tiled.get_tile_traits(i).nelems) * sizeof(T);
+        }
+    }
+    return {{m, n}, tile, 0, bytes,
+        [=]()
+        {
+            if(scatter)
+            {
+                scatter_async<T>(single, tiled);
+            }
+            else
+            {
+                gather_async<T>(tiled, single);
+            }
+        },
+        [=](){single.mpi_flush(); tiled.mpi_flush();}};
+}
+
+//! Attention softmax(K^T Q) V with head size 64, sequence of 1024 tokens,
+//! 8 heads and batch of 4*scale sequences
+Problem make_flash(int p, Index scale, starpu_mpi_tag_t &last_tag)
+{
+    constexpr Index head = 64, seq = 1024, seq_tile = 256, n_head = 8;
+    Index batch = 4 * scale;
+    std::vector<int> grid{1, 1, 1, 1};
+    std::vector<Index> shape{head, seq, batch, n_head},
+        basetile{head, seq_tile, 1, 1};
+    auto Q = make_tensor(shape, basetile, grid, 1, last_tag);
+    auto K = make_tensor(shape, basetile, grid, 1, last_tag);
+    auto V = make_tensor(shape, basetile, grid, 1, last_tag);
+    auto dst = make_tensor(shape, basetile, grid, 1, last_tag);
+    auto maxsumexp = make_tensor({2, seq, batch, n_head},
+            {2, seq_tile, 1, 1}, grid, 1, last_tag);
+    auto tmp = make_tensor({seq, seq, batch, n_head},
+            {seq_tile, seq_tile, 1, 1}, grid, 1, last_tag);
+    // Mask without masked out elements
+    TensorTraits mask_traits({seq, seq}, {seq_tile, seq_tile});
+    std::vector<int> mask_distr(mask_traits.grid.nelems, 0);
+    Tensor<bool_t> mask(mask_traits, mask_distr, last_tag);
+    if(starpu_mpi_world_rank() == 0)
+    {
+        for(Index i = 0; i < mask.grid.nelems; ++i)
+        {
+            auto tile = mask.get_tile(i);
+            auto tile_local = tile.acquire(STARPU_W);
+            for(Index j = 0; j < tile.nelems; ++j)
+            {
+                tile_local[j] = bool_t(true);
+            }
+            tile_local.release();
+        }
+    }
+    clear_async<T>(maxsumexp);
+    flash_maxsumexp_async<T>(Q, K, mask, maxsumexp, tmp);
+    return {shape, seq_tile,
+        4*double(seq)*double(seq)*double(head)*double(batch*n_head), 0,
+        [=]()
+        {
+            flash_softmax_gemm_async<T>(Q, K, V, mask, maxsumexp, dst, tmp);
+        },
+        [](){}};
+}
+
+std::vector<Benchmark> get_benchmarks()
+{
+    using namespace std::placeholders;
+    return {{"gemm", 0, make_gemm},
+        {"sum_slice", 0, make_sum_slice},
+        {"scatter", 0, std::bind(make_scatter_gather, true, _1, _2, _3)},
+        {"gather", 0, std::bind(make_scatter_gather, false, _1, _2, _3)},
+        {"flash_softmax_gemm", 1, make_flash}};
+}
+
+//! Synchronize all the nodes
+void wait_all()
+{
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+}
+
+//! Time operation on p nodes, return time of a single iteration
+double run(const Benchmark &b, int p, Index scale, const Options &opts,
+        starpu_mpi_tag_t &last_tag, std::stringstream &record)
+{
+    auto problem = b.make(p, scale, last_tag);
+    record << ", \"shape\": [";
+    for(Index i = 0; i < problem.shape.size(); ++i)
+    {
+        record << (i == 0 ? "" : ", ") << problem.shape[i];
+    }
+    record << "], \"tile\": " << problem.tile;
+    // Warmup also calibrates performance models
+    problem.submit();
+    problem.flush();
+    wait_all();
+    auto time0 = std::chrono::steady_clock::now();
+    for(Index i = 0; i < opts.niters; ++i)
+    {
+        problem.submit();
+        problem.flush();
+    }
+    wait_all();
+    auto time1 = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(time1-time0).count()
+        / opts.niters;
+    record << ", \"time\": " << seconds << ", \"gflops\": "
+        << problem.nflops / seconds * 1e-9 << ", \"comm_bytes\": "
+        << problem.comm_bytes;
+    return seconds;
+}
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    for(int i = 1; i < argc; ++i)
+    {
+        if(std::strcmp(argv[i], "--output") == 0 and i+1 < argc)
+        {
+            opts.output = argv[++i];
+        }
+        else if(std::strcmp(argv[i], "--niters") == 0 and i+1 < argc)
+        {
+            opts.niters = std::stoll(argv[++i]);
+        }
+        else if(std::strcmp(argv[i], "--max-nodes") == 0 and i+1 < argc)
+        {
+            opts.max_nodes = std::stoi(argv[++i]);
+        }
+        else if(std::strcmp(argv[i], "--weak") == 0)
+        {
+            opts.strong = false;
+        }
+        else if(std::strcmp(argv[i], "--strong") == 0)
+        {
+            opts.weak = false;
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--output file.json] "
+                "[--niters N] [--max-nodes P] [--weak | --strong]\n";
+            return 1;
+        }
+    }
+    if(opts.niters <= 0 or (not opts.weak and not opts.strong))
+    {
+        std::cerr << "Number of iterations shall be positive and at least "
+            "one of weak and strong scaling shall be requested\n";
+        return 1;
+    }
+    // Init StarPU with all the workers and all the codelets
+    starpu::Config starpu(-1, -1, 1);
+    starpu::init();
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_rank = starpu_mpi_world_rank();
+    if(opts.max_nodes <= 0 or opts.max_nodes > mpi_size)
+    {
+        opts.max_nodes = mpi_size;
+    }
+    // Powers of 2 and the total number of nodes
+    std::vector<int> nodes;
+    for(int p = 1; p < opts.max_nodes; p *= 2)
+    {
+        nodes.push_back(p);
+    }
+    nodes.push_back(opts.max_nodes);
+    std::vector<std::pair<const char *, bool>> modes;
+    if(opts.strong)
+    {
+        modes.push_back({"strong", false});
+    }
+    if(opts.weak)
+    {
+        modes.push_back({"weak", true});
+    }
+    std::ofstream out;
+    if(mpi_rank == 0)
+    {
+        out.open(opts.output);
+        out << "[\n";
+    }
+    bool first = true;
+    starpu_mpi_tag_t last_tag = 0;
+    for(const auto &b: get_benchmarks())
+    {
+        if(b.max_nodes > 0 and mpi_size > b.max_nodes)
+        {
+            continue;
+        }
+        for(const auto &mode: modes)
+        {
+            double time1 = 0;
+            for(int p: nodes)
+            {
+                Index scale = mode.second ? p : 1;
+                std::stringstream record;
+                record << "  {\"op\": \"" << b.name << "\", \"mode\": \""
+                    << mode.first << "\", \"nodes\": " << p;
+                try
+                {
+                    double seconds = run(b, p, scale, opts, last_tag,
+                            record);
+                    if(p == 1)
+                    {
+                        time1 = seconds;
+                    }
+                    // Ideal time of weak scaling is constant, while ideal
+                    // time of strong scaling is inversely proportional to p
+                    double ideal = mode.second ? time1 : time1 / p;
+                    if(time1 > 0)
+                    {
+                        record << ", \"efficiency\": " << ideal / seconds;
+                    }
+                }
+                catch(const std::exception &e)
+                {
+                    record << ", \"error\": \"" << e.what() << "\"";
+                }
+                record << "}";
+                if(mpi_rank == 0)
+                {
+                    if(not first)
+                    {
+                        out << ",\n";
+                    }
+                    out << record.str();
+                    std::cout << record.str() << "\n";
+                }
+                first = false;
+            }
+        }
+    }
+    if(mpi_rank == 0)
+    {
+        out << "\n]\n";
+    }
+    return 0;
+}
+
@@ -0,0 +1,204 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file benchmarks/nntile_submission.cc
+ * Throughput of submission and execution of tiny tasks
+ *
+ * Tasks do almost no work, so that time is spent on submission and
+ * scheduling only. Tasks of clear (a single buffer without arithmetic) and
+ * add (two buffers of a tiny kernel) are submitted for every tile of
+ * tensors with a growing number of tiles, either directly through
+ * starpu::clear::submit and starpu::add::submit for all the tile handles,
+ * or through tensor-wise clear_async and add_async, that also check
+ * ownership of tiles by MPI nodes. Submission rate is the number of tasks
+ * divided by time of the submission loop, while task rate also includes
+ * waiting for all the tasks to complete. StarPU is initialized once per
+ * process, so every run measures a single scheduling policy, and target
+ * benchmarks_submission runs it for every policy of
+ * NNTILE_BENCH_SCHEDULERS. Results are reported as a JSON array of records.
+ * The same measurements through Python bindings are done by
+ * nntile.benchmark_submission.
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include <nntile.hh>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+//! Options of the benchmark run
+struct Options
+{
+    std::string output = "submission.json";
+    std::string sched = "dmda";
+    Index niters = 5;
+    Index max_ntiles = 65536;
+    Index tile = 16;
+    int ncpus = -1;
+    int ncuda = -1;
+};
+
+//! Submit one task per tile directly through StarPU wrappers
+template<typename T>
+void submit_starpu(const char *op, const Tensor<T> &x, const Tensor<T> &y)
+{
+    bool clear = std::strcmp(op, "clear") == 0;
+    for(Index i = 0; i < x.grid.nelems; ++i)
+    {
+        const auto &y_tile_handle = y.get_tile_handle(i);
+        if(clear)
+        {
+            starpu::clear::submit(y_tile_handle);
+        }
+        else
+        {
+            auto x_tile_traits = x.get_tile_traits(i);
+            starpu::add::submit<T>(x_tile_traits.nelems, 1.0,
+                    x.get_tile_handle(i), 1.0, y_tile_handle);
+        }
+    }
+}
+
+//! Submit one task per tile through tensor-wise operations
+template<typename T>
+void submit_tensor(const char *op, const Tensor<T> &x, const Tensor<T> &y)
+{
+    if(std::strcmp(op, "clear") == 0)
+    {
+        clear_async<T>(y);
+    }
+    else
+    {
+        add_async<T>(1.0, x, 1.0, y);
+    }
+}
+
+template<typename T>
+void run_all(const char *dtype, const Options &opts, std::ostream &out,
+        bool &first)
+{
+    using submit_t = std::function<void(const char *, const Tensor<T> &,
+            const Tensor<T> &)>;
+    std::vector<std::pair<const char *, submit_t>> paths = {
+        {"starpu", submit_starpu<T>}, {"tensor", submit_tensor<T>}};
+    starpu_mpi_tag_t last_tag = 0;
+    for(Index ntiles = 1; ntiles <= opts.max_ntiles; ntiles *= 16)
+    {
+        TensorTraits traits({ntiles*opts.tile}, {opts.tile});
+        std::vector<int> distr(ntiles, 0);
+        Tensor<T> x(traits, distr, last_tag), y(traits, distr, last_tag);
+        clear_async<T>(x);
+        for(const char *op: {"clear", "add"})
+        {
+            for(const auto &path: paths)
+            {
+                // Warmup allocates tiles and fills the pool of arguments
+                path.second(op, x, y);
+                starpu_task_wait_for_all();
+                auto time0 = std::chrono::steady_clock::now();
+                for(Index i = 0; i < opts.niters; ++i)
+                {
+                    path.second(op, x, y);
+                }
+                auto time1 = std::chrono::steady_clock::now();
+                starpu_task_wait_for_all();
+                auto time2 = std::chrono::steady_clock::now();
+                double ntasks = double(ntiles) * opts.niters;
+                double submit = std::chrono::duration<double>(
+                        time1-time0).count();
+                double total = std::chrono::duration<double>(
+                        time2-time0).count();
+                std::stringstream record;
+                record << "  {\"sched\": \"" << opts.sched
+                    << "\", \"op\": \"" << op << "\", \"path\": \""
+                    << path.first << "\", \"dtype\": \"" << dtype
+                    << "\", \"ntiles\": " << ntiles << ", \"ntasks\": "
+                    << ntasks << ", \"submit_rate\": " << ntasks/submit
+                    << ", \"task_rate\": " << ntasks/total
+                    << ", \"submit_us\": " << submit/ntasks*1e6 << "}";
+                if(not first)
+                {
+                    out << ",\n";
+                }
+                first = false;
+                out << record.str();
+                std::cout << record.str() << "\n";
+            }
+        }
+        x.unregister();
+        y.unregister();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    for(int i = 1; i < argc; ++i)
+    {
+        if(std::strcmp(argv[i], "--output") == 0 and i+1 < argc)
+        {
+            opts.output = argv[++i];
+        }
+        else if(std::strcmp(argv[i], "--sched") == 0 and i+1 < argc)
+        {
+            opts.sched = argv[++i];
+        }
+        else if(std::strcmp(argv[i], "--niters") == 0 and i+1 < argc)
+        {
+            opts.niters = std::stoll(argv[++i]);
+        }
+        else if(std::strcmp(argv[i], "--max-ntiles") == 0 and i+1 < argc)
+        {
+            opts.max_ntiles = std::stoll(argv[++i]);
+        }
+        else if(std::strcmp(argv[i], "--tile") == 0 and i+1 < argc)
+        {
+            opts.tile = std::stoll(argv[++i]);
+        }
+        else if(std::strcmp(argv[i], "--ncpus") == 0 and i+1 < argc)
+        {
+            opts.ncpus = std::stoi(argv[++i]);
+        }
+        else if(std::strcmp(argv[i], "--ncuda") == 0 and i+1 < argc)
+        {
+            opts.ncuda = std::stoi(argv[++i]);
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--output file.json] "
+                "[--sched policy] [--niters N] [--max-ntiles N] "
+                "[--tile N] [--ncpus N] [--ncuda N]\n";
+            return 1;
+        }
+    }
+    if(opts.niters <= 0 or opts.max_ntiles <= 0 or opts.tile <= 0)
+    {
+        std::cerr << "Number of iterations, tiles and size of tiles shall "
+            "be positive\n";
+        return 1;
+    }
+    // Init StarPU with the requested scheduling policy and all the codelets
+    starpu::Config starpu(opts.ncpus, opts.ncuda, 1, opts.sched);
+    starpu::init();
+    std::ofstream out(opts.output);
+    out << "[\n";
+    bool first = true;
+    run_all<fp32_t>("fp32", opts, out, first);
+    out << "\n]\n";
+    return 0;
+}
+
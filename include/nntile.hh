@@ -33,5 +33,8 @@
 #include <nntile/tensor.hh>
 
 // Layers
-//#include <nntile/layer.hh>
+#include <nntile/layer.hh>
+
+// Models
+#include <nntile/model.hh>
 
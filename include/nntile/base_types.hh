@@ -16,6 +16,15 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
+
+// Conversions of BF16 and FP16 types are also used in CUDA kernels
+#ifdef __CUDACC__
+#   define NNTILE_HOST_DEVICE __host__ __device__
+#   include <cuda_fp16.h>
+#else
+#   define NNTILE_HOST_DEVICE
+#endif
 
 namespace nntile
 {
@@ -28,17 +37,268 @@ using Index = int64_t;
 using fp64_t = double;
 //! Single precision alias
 using fp32_t = float;
-//! Half precision FP16 mock type
+//! Half precision IEEE FP16 type
+/*! Only storage and conversions to and from single precision are provided,
+ * the layout is the same as of __half of CUDA. Single precision values are
+ * rounded to the nearest even, values above the largest finite half
+ * precision value become infinities and NaN stays NaN. Computations are
+ * performed in compute_t<fp16_t>.
+ * */
 class fp16_t
 {
-private:
-    int16_t _;
+public:
+    //! Bits of the half precision value
+    std::uint16_t value;
+    fp16_t() = default;
+    //! Round single precision value
+    NNTILE_HOST_DEVICE fp16_t(fp32_t x)
+        noexcept
+    {
+#ifdef __CUDA_ARCH__
+        value = __half_as_ushort(__float2half_rn(x));
+#else // __CUDA_ARCH__
+        std::uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        std::uint32_t sign = (bits >> 16) & 0x8000u;
+        std::uint32_t abs = bits & 0x7fffffffu;
+        if(abs > 0x7f800000u)
+        {
+            // Quiet NaN
+            value = sign | 0x7e00u;
+        }
+        else if(abs >= 0x477ff000u)
+        {
+            // Infinity, including values that overflow after rounding
+            value = sign | 0x7c00u;
+        }
+        else if(abs >= 0x38800000u)
+        {
+            // Normal value, rounding may carry into the exponent
+            std::uint32_t half = (abs - 0x38000000u) >> 13;
+            std::uint32_t rest = abs & 0x1fffu;
+            if(rest > 0x1000u or (rest == 0x1000u and (half & 1u)))
+            {
+                ++half;
+            }
+            value = sign | half;
+        }
+        else
+        {
+            // Subnormal value or zero
+            int shift = 126 - int(abs >> 23);
+            std::uint32_t half = 0;
+            if(shift < 25)
+            {
+                std::uint32_t mant = (abs & 0x7fffffu) | 0x800000u;
+                half = mant >> shift;
+                std::uint32_t rest = mant & ((1u << shift) - 1);
+                std::uint32_t tie = 1u << (shift-1);
+                if(rest > tie or (rest == tie and (half & 1u)))
+                {
+                    ++half;
+                }
+            }
+            value = sign | half;
+        }
+#endif // __CUDA_ARCH__
+    }
+    //! Exact conversion into single precision
+    NNTILE_HOST_DEVICE operator fp32_t() const
+        noexcept
+    {
+#ifdef __CUDA_ARCH__
+        return __half2float(__ushort_as_half(value));
+#else // __CUDA_ARCH__
+        std::uint32_t sign = std::uint32_t(value & 0x8000u) << 16;
+        std::uint32_t exp = (value >> 10) & 0x1fu;
+        std::uint32_t mant = value & 0x3ffu;
+        std::uint32_t bits;
+        if(exp == 0x1fu)
+        {
+            // Infinity or NaN
+            bits = sign | 0x7f800000u | (mant << 13);
+        }
+        else if(exp != 0)
+        {
+            bits = sign | ((exp+112) << 23) | (mant << 13);
+        }
+        else
+        {
+            // Subnormal value or zero is exactly mant*2^-24
+            fp32_t x = fp32_t(mant) * 0x1p-24f;
+            return sign ? -x : x;
+        }
+        fp32_t x;
+        std::memcpy(&x, &bits, sizeof(x));
+        return x;
+#endif // __CUDA_ARCH__
+    }
+};
+
+//! Brain floating point BF16 type
+/*! Only storage and conversions to and from single precision are provided.
+ * Single precision bits are rounded to the nearest even and NaN stays NaN.
+ * Computations are performed in compute_t<bf16_t>.
+ * */
+class bf16_t
+{
+public:
+    //! Upper 16 bits of the corresponding single precision value
+    std::uint16_t value;
+    bf16_t() = default;
+    //! Round single precision value
+    NNTILE_HOST_DEVICE bf16_t(fp32_t x)
+        noexcept
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        if((bits & 0x7fffffffu) > 0x7f800000u)
+        {
+            // Quiet NaN
+            value = (bits >> 16) | 0x40u;
+        }
+        else
+        {
+            value = (bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16;
+        }
+    }
+    //! Exact conversion into single precision
+    NNTILE_HOST_DEVICE operator fp32_t() const
+        noexcept
+    {
+        std::uint32_t bits = std::uint32_t(value) << 16;
+        fp32_t x;
+        std::memcpy(&x, &bits, sizeof(x));
+        return x;
+    }
+};
+
+//! FP8 E4M3 type for quantized storage of weights
+/*! Only storage and conversions to and from single precision are provided,
+ * the layout is the same as of __nv_fp8_e4m3 of CUDA: 1 sign bit, 4 bits of
+ * exponent with a bias of 7 and 3 bits of mantissa. There are no infinities,
+ * the largest finite value is 448. Single precision values are rounded to
+ * the nearest even, values above 448 by modulus saturate to 448 and NaN
+ * stays NaN. Computations are performed in compute_t<fp8_e4m3_t>.
+ * */
+class fp8_e4m3_t
+{
+public:
+    //! Bits of the FP8 value
+    std::uint8_t value;
+    fp8_e4m3_t() = default;
+    //! Round single precision value
+    NNTILE_HOST_DEVICE fp8_e4m3_t(fp32_t x)
+        noexcept
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        std::uint32_t sign = (bits >> 24) & 0x80u;
+        std::uint32_t abs = bits & 0x7fffffffu;
+        if(abs > 0x7f800000u)
+        {
+            // NaN
+            value = sign | 0x7fu;
+        }
+        else if(abs >= 0x43e00000u)
+        {
+            // Saturation, including infinities
+            value = sign | 0x7eu;
+        }
+        else if(abs >= 0x3c800000u)
+        {
+            // Normal value, rounding may carry into the exponent
+            std::uint32_t fp8 = (abs - 0x3c000000u) >> 20;
+            std::uint32_t rest = abs & 0xfffffu;
+            if(rest > 0x80000u or (rest == 0x80000u and (fp8 & 1u)))
+            {
+                ++fp8;
+            }
+            value = sign | fp8;
+        }
+        else
+        {
+            // Subnormal value or zero
+            int shift = 141 - int(abs >> 23);
+            std::uint32_t fp8 = 0;
+            if(shift < 25)
+            {
+                std::uint32_t mant = (abs & 0x7fffffu) | 0x800000u;
+                fp8 = mant >> shift;
+                std::uint32_t rest = mant & ((1u << shift) - 1);
+                std::uint32_t tie = 1u << (shift-1);
+                if(rest > tie or (rest == tie and (fp8 & 1u)))
+                {
+                    ++fp8;
+                }
+            }
+            value = sign | fp8;
+        }
+    }
+    //! Exact conversion into single precision
+    NNTILE_HOST_DEVICE operator fp32_t() const
+        noexcept
+    {
+        std::uint32_t sign = std::uint32_t(value & 0x80u) << 24;
+        std::uint32_t exp = (value >> 3) & 0xfu;
+        std::uint32_t mant = value & 0x7u;
+        std::uint32_t bits;
+        if((value & 0x7fu) == 0x7fu)
+        {
+            // NaN
+            bits = sign | 0x7fc00000u;
+        }
+        else if(exp != 0)
+        {
+            bits = sign | ((exp+120) << 23) | (mant << 20);
+        }
+        else
+        {
+            // Subnormal value or zero is exactly mant*2^-9
+            fp32_t x = fp32_t(mant) * 0x1p-9f;
+            return sign ? -x : x;
+        }
+        fp32_t x;
+        std::memcpy(&x, &bits, sizeof(x));
+        return x;
+    }
 };
 
 // Boolean type for mask
 using bool_t = bool;
 
-// Add more types like fp16_t, bf16_t and tf32_t in the future
+//! Type of intermediate values of computations over type T
+template<typename T>
+struct compute_type
+{
+    using type = T;
+};
+
+//! BF16 values are processed in single precision
+template<>
+struct compute_type<bf16_t>
+{
+    using type = fp32_t;
+};
+
+//! FP16 values are processed in single precision
+template<>
+struct compute_type<fp16_t>
+{
+    using type = fp32_t;
+};
+
+//! FP8 values are processed in single precision
+template<>
+struct compute_type<fp8_e4m3_t>
+{
+    using type = fp32_t;
+};
+
+template<typename T>
+using compute_t = typename compute_type<T>::type;
+
+// Add more types like tf32_t in the future
 
 } // namespace nntile
 
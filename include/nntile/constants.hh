@@ -48,5 +48,43 @@ public:
     operator T() = delete;
 };
 
-} // namespace nntile
+//! Compute mode of gemm on CUDA devices
+//
+// Uses predefined constants GemmCompute::Default, GemmCompute::FastTF32,
+// GemmCompute::FastFP16 and GemmCompute::FastBF16. Default mode computes in
+// the precision of fp32_t and fp64_t inputs and accumulates products of
+// fp16_t and bf16_t inputs in fp32_t. Other modes allow tensor cores to
+// round fp32_t inputs into TF32, FP16 or BF16, while products are still
+// accumulated in fp32_t. They do not change gemm of other types and gemm on
+// CPU.
+class GemmCompute
+{
+public:
+    //! Compute mode value
+    enum Value: int
+    {
+        Default,
+        FastTF32,
+        FastFP16,
+        FastBF16
+    } value;
+    //! Constructor for compute mode object
+    constexpr explicit GemmCompute(const enum GemmCompute::Value &value_):
+        value(value_)
+    {
+        if(value != GemmCompute::Default and value != GemmCompute::FastTF32
+                and value != GemmCompute::FastFP16
+                and value != GemmCompute::FastBF16)
+        {
+            throw std::runtime_error("Invalid value of GemmCompute object");
+        }
+    }
+    //! All constructors but one are disabled
+    template<typename T>
+    explicit GemmCompute(const T &) = delete;
+    //! All conversions are disabled
+    template<typename T>
+    operator T() = delete;
+};
 
+} // namespace nntile
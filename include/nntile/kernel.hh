@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <nntile/kernel/simd.hh>
+#include <nntile/kernel/parallel.hh>
 #include <nntile/kernel/accumulate_maxsumexp.hh>
 #include <nntile/kernel/add_slice.hh>
 #include <nntile/kernel/add_slice3.hh>
@@ -29,23 +31,35 @@
 #include <nntile/kernel/dgelu.hh>
 #include <nntile/kernel/dgelutanh.hh>
 #include <nntile/kernel/drelu.hh>
+#include <nntile/kernel/dropout.hh>
 #include <nntile/kernel/hypot.hh>
+#include <nntile/kernel/moe_combine.hh>
+#include <nntile/kernel/moe_combine_backward.hh>
+#include <nntile/kernel/moe_dispatch.hh>
+#include <nntile/kernel/moe_route.hh>
 #include <nntile/kernel/normalize.hh>
 #include <nntile/kernel/prod.hh>
 #include <nntile/kernel/randn.hh>
+#include <nntile/kernel/randn_philox.hh>
 #include <nntile/kernel/relu.hh>
 #include <nntile/kernel/relu_forward.hh>
 #include <nntile/kernel/relu_backward.hh>
+#include <nntile/kernel/rope.hh>
 #include <nntile/kernel/subcopy.hh>
 #include <nntile/kernel/sumnorm.hh>
 #include <nntile/kernel/fill.hh>
+#include <nntile/kernel/fill_padding.hh>
 #include <nntile/kernel/sum_slice.hh>
 #include <nntile/kernel/sum_fiber.hh>
 #include <nntile/kernel/norm_slice.hh>
 #include <nntile/kernel/pow.hh>
 #include <nntile/kernel/maxsumexp.hh>
 #include <nntile/kernel/softmax.hh>
+#include <nntile/kernel/softmax_crossentropy.hh>
 #include <nntile/kernel/softmax_inplace.hh>
+#include <nntile/kernel/flash_attention.hh>
+#include <nntile/kernel/flash_attention_backward.hh>
+#include <nntile/kernel/flash_attention_dequant.hh>
 #include <nntile/kernel/sqrt.hh>
 #include <nntile/kernel/sqrt_inplace.hh>
 #include <nntile/kernel/maximum.hh>
@@ -61,14 +75,46 @@
 #include <nntile/kernel/add_scalar.hh>
 #include <nntile/kernel/embedding.hh>
 #include <nntile/kernel/embedding_backward.hh>
+#include <nntile/kernel/embedding_rows.hh>
 #include <nntile/kernel/fp32_to_fp16.hh>
 #include <nntile/kernel/fp16_to_fp32.hh>
+#include <nntile/kernel/fp32_to_bf16.hh>
+#include <nntile/kernel/bf16_to_fp32.hh>
 #include <nntile/kernel/mask_scalar.hh>
 #include <nntile/kernel/scal.hh>
 #include <nntile/kernel/adam_step.hh>
+#include <nntile/kernel/sparse_adam_step.hh>
 #include <nntile/kernel/adamw_step.hh>
+#include <nntile/kernel/multi_adam_step.hh>
+#include <nntile/kernel/sgd_step.hh>
+#include <nntile/kernel/adafactor_step.hh>
+#include <nntile/kernel/quantized_adam_step.hh>
+#include <nntile/kernel/clip_scale.hh>
+#include <nntile/kernel/nrm2.hh>
+#include <nntile/kernel/fused_elementwise.hh>
+#include <nntile/kernel/layer_norm.hh>
+#include <nntile/kernel/layer_norm_backward.hh>
+#include <nntile/kernel/add_layer_norm.hh>
+#include <nntile/kernel/add_layer_norm_backward.hh>
+#include <nntile/kernel/rms_norm.hh>
+#include <nntile/kernel/rms_norm_backward.hh>
+#include <nntile/kernel/swiglu.hh>
+#include <nntile/kernel/swiglu_backward.hh>
+#include <nntile/kernel/embedding_pos.hh>
+#include <nntile/kernel/embedding_pos_backward.hh>
+#include <nntile/kernel/softmax_online.hh>
+#include <nntile/kernel/bias_gelutanh.hh>
+#include <nntile/kernel/bias_gelutanh_backward.hh>
+#include <nntile/kernel/quantize.hh>
+#include <nntile/kernel/gemm_dequant.hh>
+#include <nntile/kernel/topk.hh>
+#include <nntile/kernel/topk_sample.hh>
 #include <nntile/kernel/transpose.hh>
 #include <nntile/kernel/conv2d.hh>
+#include <nntile/kernel/strassen.hh>
+#include <nntile/kernel/batch_norm_act.hh>
+#include <nntile/kernel/batch_norm_act_backward.hh>
+#include <nntile/kernel/batch_norm_backward.hh>
 
 namespace nntile
 {
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/adafactor_step.hh
+ * Fused Adafactor step with factored second moments
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/kernel/adafactor_step/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/adafactor_step/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::adafactor_step
+/*! Low-level implementations of fused Adafactor step
+ * */
+namespace adafactor_step
+{
+
+} // namespace adafactor_step
+} // namespace kernel
+} // namespace nntile
+
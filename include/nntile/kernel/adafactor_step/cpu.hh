@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/adafactor_step/cpu.hh
+ * Fused Adafactor step on CPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace adafactor_step
+{
+
+// Fused Adafactor step on CPU buffers
+template<typename T>
+void cpu(Index num_iter, Index m, Index k, Index n, T beta_2, T eps, T lr,
+        T weight_decay, const T *row, const T *col, const T *mean,
+        const T *grad, T *p)
+    noexcept;
+
+} // namespace adafactor_step
+} // namespace kernel
+} // namespace nntile
+
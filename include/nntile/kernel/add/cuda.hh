@@ -32,11 +32,6 @@ void cuda(cudaStream_t stream, Index nelems, T alpha, const T* src, T beta,
         T* dst)
     noexcept;
 
-// specific specialization for fp16_t, temporary solution
-void cuda16(cudaStream_t stream, Index nelems, fp32_t alpha, const fp16_t *src, fp32_t beta,
-        fp16_t *dst)
-    noexcept;
-
 } // namespace add
 } // namespace kernel
 } // namespace nntile
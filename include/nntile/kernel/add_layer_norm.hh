@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/add_layer_norm.hh
+ * Fused residual addition and layer normalization
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/kernel/add_layer_norm/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/add_layer_norm/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::add_layer_norm
+/*! Low-level implementations of fused residual addition and layer
+ * normalization, that produce both the sum and its normalization in a single
+ * pass
+ * */
+namespace add_layer_norm
+{
+
+} // namespace add_layer_norm
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/add_layer_norm/cuda.hh
+ * Fused residual addition and layer normalization on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace add_layer_norm
+{
+
+// Fused residual addition and layer normalization on CUDA
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, T eps,
+        const T *src1, const T *src2, const T *gamma, const T *beta, T *sum,
+        T *mean, T *inv_stddev, T *dst)
+    noexcept;
+
+} // namespace add_layer_norm
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/add_layer_norm_backward/cuda.hh
+ * Backward of fused residual addition and layer normalization on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace add_layer_norm_backward
+{
+
+// Backward of fused residual addition and layer normalization on CUDA
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, const T *sum,
+        const T *dst_grad, const T *gamma, const T *mean,
+        const T *inv_stddev, const T *sum_grad, T *src1_grad, T *src2_grad,
+        T *gamma_grad, T *beta_grad)
+    noexcept;
+
+} // namespace add_layer_norm_backward
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/batch_norm_act/activation.hh
+ * Activations, that are fused with batch normalization
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+namespace nntile
+{
+namespace kernel
+{
+namespace batch_norm_act
+{
+
+//! Activation, applied to output of batch normalization
+enum class activation_t: int
+{
+    //! No activation, output of normalization as is
+    NONE = 0,
+    //! ReLU, as nntile::kernel::relu
+    RELU = 1,
+    //! Approximate GeLU, as nntile::kernel::gelutanh
+    GELUTANH = 2
+};
+
+} // namespace batch_norm_act
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/batch_norm_act/cpu.hh
+ * Batch normalization followed by an activation on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/kernel/batch_norm_act/activation.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace batch_norm_act
+{
+
+template<typename T>
+void cpu(Index m, Index n, Index k, activation_t act, const T *src,
+        const T *mean, const T *inv_stddev, const T *gamma, const T *beta,
+        T *dst)
+    noexcept;
+
+} // namespace batch_norm_act
+} // namespace kernel
+} // namespace nntile
+
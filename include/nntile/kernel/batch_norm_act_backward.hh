@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/batch_norm_act_backward.hh
+ * Backward of an activation, that follows batch normalization
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/kernel/batch_norm_act_backward/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/batch_norm_act_backward/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::batch_norm_act_backward
+/*! Low-level implementations of backward of an activation, fused with batch
+ * normalization, that also accumulate gradients of its parameters
+ * */
+namespace batch_norm_act_backward
+{
+
+} // namespace batch_norm_act_backward
+} // namespace kernel
+} // namespace nntile
+
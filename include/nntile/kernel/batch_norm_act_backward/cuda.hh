@@ -0,0 +1,40 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/batch_norm_act_backward/cuda.hh
+ * Backward of an activation, that follows batch normalization, on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/kernel/batch_norm_act/activation.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace batch_norm_act_backward
+{
+
+using batch_norm_act::activation_t;
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, activation_t act,
+        const T *src, const T *mean, const T *inv_stddev, const T *gamma,
+        const T *beta, const T *dst_grad, T *y_grad, T *sum_grad,
+        T *sum_grad_xhat)
+    noexcept;
+
+} // namespace batch_norm_act_backward
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/batch_norm_backward/cuda.hh
+ * Backward of batch normalization with stored statistics on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace batch_norm_backward
+{
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, T alpha,
+        const T *src, const T *mean, const T *inv_stddev, const T *gamma,
+        const T *sum_grad, const T *sum_grad_xhat, T *grad)
+    noexcept;
+
+} // namespace batch_norm_backward
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/bf16_to_fp32.hh
+ * Convert bf16_t array into fp32_t array
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-31
+ * */
+
+#pragma once
+
+#include <nntile/defs.h>
+#include <nntile/kernel/bf16_to_fp32/cpu.hh>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/bf16_to_fp32/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::bf16_to_fp32
+/*! Low-level implementations of convertion bf16 to fp32 operation
+ * */
+namespace bf16_to_fp32
+{
+
+} // namespace bf16_to_fp32
+} // namespace kernel
+} // namespace nntile
+
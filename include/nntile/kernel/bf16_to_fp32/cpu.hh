@@ -0,0 +1,32 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/bf16_to_fp32/cpu.hh
+ * Convert bf16_t array into fp32_t array on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-31
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace bf16_to_fp32
+{
+
+void cpu(Index nelems, const bf16_t *src, fp32_t *dst)
+    noexcept;
+
+} // namespace bf16_to_fp32
+} // namespace kernel
+} // namespace nntile
+
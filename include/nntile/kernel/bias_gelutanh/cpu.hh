@@ -0,0 +1,33 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/bias_gelutanh/cpu.hh
+ * Bias addition followed by approximate GeLU on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace bias_gelutanh
+{
+
+template<typename T>
+void cpu(Index m, Index n, Index k, const T *bias, T *src, T *dst)
+    noexcept;
+
+} // namespace bias_gelutanh
+} // namespace kernel
+} // namespace nntile
+
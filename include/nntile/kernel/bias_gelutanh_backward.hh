@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/bias_gelutanh_backward.hh
+ * Backward of bias addition followed by approximate GeLU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#pragma once
+
+#include <nntile/kernel/bias_gelutanh_backward/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/bias_gelutanh_backward/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::bias_gelutanh_backward
+/*! Low-level implementations of backward of fused bias addition and
+ * approximate GeLU
+ * */
+namespace bias_gelutanh_backward
+{
+
+} // namespace bias_gelutanh_backward
+} // namespace kernel
+} // namespace nntile
+
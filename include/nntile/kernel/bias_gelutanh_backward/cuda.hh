@@ -0,0 +1,35 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/bias_gelutanh_backward/cuda.hh
+ * Backward of bias addition followed by approximate GeLU on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace bias_gelutanh_backward
+{
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, const T *src,
+        const T *dst_grad, T *src_grad, T *bias_grad)
+    noexcept;
+
+} // namespace bias_gelutanh_backward
+} // namespace kernel
+} // namespace nntile
+
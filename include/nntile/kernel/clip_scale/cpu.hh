@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/clip_scale/cpu.hh
+ * Learning rate and scale of gradients for clipping by a global norm on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace clip_scale
+{
+
+// Learning rate and scale of gradients for clipping on CPU
+template<typename T>
+void cpu(T lr, T max_norm, const T *norm, T *scalars)
+    noexcept;
+
+} // namespace clip_scale
+} // namespace kernel
+} // namespace nntile
+
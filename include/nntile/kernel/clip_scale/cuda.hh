@@ -0,0 +1,35 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/clip_scale/cuda.hh
+ * Learning rate and scale of gradients for clipping by a global norm on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace clip_scale
+{
+
+// Learning rate and scale of gradients for clipping on CUDA
+template<typename T>
+void cuda(cudaStream_t stream, T lr, T max_norm, const T *norm, T *scalars)
+    noexcept;
+
+} // namespace clip_scale
+} // namespace kernel
+} // namespace nntile
+
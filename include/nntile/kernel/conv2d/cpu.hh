@@ -15,16 +15,58 @@
 #pragma once
 
 #include <nntile/base_types.hh>
+#include <nntile/defs.h>
 
 namespace nntile {
 namespace kernel {
 namespace conv2d {
 
+// Window of full 2D-Convolution, method is chosen by kernel size
 template <typename T>
-void cpu(Index src_offset_n, Index src_offset_m, Index batch, Index src_n,
+void cpu(Index offset_n, Index offset_m, Index batch, Index src_n,
          Index src_m, const T *src, Index kernel_n, Index kernel_m,
          const T *kernel, Index dst_n, Index dst_m, T *dst) noexcept;
 
+// Gradient of a window of 2D-Convolution over src
+template <typename T>
+void cpu_backward_input(Index offset_n, Index offset_m, Index batch,
+        Index dst_n, Index dst_m, const T *dst_grad, Index kernel_n,
+        Index kernel_m, const T *kernel, Index src_n, Index src_m,
+        T *src_grad) noexcept;
+
+// Gradient of a window of 2D-Convolution over kernel
+template <typename T>
+void cpu_backward_weight(Index offset_n, Index offset_m, Index batch,
+        Index src_n, Index src_m, const T *src, Index dst_n, Index dst_m,
+        const T *dst_grad, Index kernel_n, Index kernel_m, T *kernel_grad)
+    noexcept;
+
+// Direct 2D-Convolution
+template <typename T>
+void cpu_direct(Index offset_n, Index offset_m, Index batch, Index src_n,
+        Index src_m, const T *src, Index kernel_n, Index kernel_m,
+        const T *kernel, Index dst_n, Index dst_m, T *dst) noexcept;
+
+// 2D-Convolution with a 3-by-3 kernel through Winograd F(2x2,3x3)
+template <typename T>
+void cpu_winograd(Index offset_n, Index offset_m, Index batch, Index src_n,
+        Index src_m, const T *src, const T *kernel, Index dst_n, Index dst_m,
+        T *dst) noexcept;
+
+#ifdef NNTILE_USE_CBLAS
+// 2D-Convolution through im2col and gemm
+template <typename T>
+void cpu_im2col(Index offset_n, Index offset_m, Index batch, Index src_n,
+        Index src_m, const T *src, Index kernel_n, Index kernel_m,
+        const T *kernel, Index dst_n, Index dst_m, T *dst) noexcept;
+#endif // NNTILE_USE_CBLAS
+
+// 2D-Convolution through FFT
+template <typename T>
+void cpu_fft(Index offset_n, Index offset_m, Index batch, Index src_n,
+        Index src_m, const T *src, Index kernel_n, Index kernel_m,
+        const T *kernel, Index dst_n, Index dst_m, T *dst) noexcept;
+
 }  // namespace conv2d
 }  // namespace kernel
 }  // namespace nntile
@@ -20,8 +20,22 @@ namespace kernel {
 namespace conv2d {
 
 template <typename T>
-void cuda(cudaStream_t stream, Index nx, Index ny, const T* src, Index mx,
-          Index my, const T* kernel, T* dst) noexcept;
+void cuda(cudaStream_t stream, Index offset_n, Index offset_m, Index batch,
+        Index src_n, Index src_m, const T *src, Index kernel_n,
+        Index kernel_m, const T *kernel, Index dst_n, Index dst_m, T *dst)
+    noexcept;
+
+template <typename T>
+void cuda_backward_input(cudaStream_t stream, Index offset_n, Index offset_m,
+        Index batch, Index dst_n, Index dst_m, const T *dst_grad,
+        Index kernel_n, Index kernel_m, const T *kernel, Index src_n,
+        Index src_m, T *src_grad) noexcept;
+
+template <typename T>
+void cuda_backward_weight(cudaStream_t stream, Index offset_n,
+        Index offset_m, Index batch, Index src_n, Index src_m, const T *src,
+        Index dst_n, Index dst_m, const T *dst_grad, Index kernel_n,
+        Index kernel_m, T *kernel_grad) noexcept;
 
 }  // namespace conv2d
 }  // namespace kernel
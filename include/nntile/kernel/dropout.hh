@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/dropout.hh
+ * Dropout operation with a mask regenerated by a counter-based generator
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/kernel/dropout/mask.hh>
+#include <nntile/kernel/dropout/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/dropout/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::dropout
+/*! Low-level implementations of dropout operation, that never stores its
+ * mask, as the mask is regenerated from a seed by a Philox generator
+ * */
+namespace dropout
+{
+
+} // namespace dropout
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,35 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/dropout/cpu.hh
+ * Dropout operation on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace dropout
+{
+
+// Dropout of a buffer with regenerated mask on CPU
+template<typename T>
+void cpu(Index nelems, unsigned long long seed, Index sequence, T p,
+        const T *src, T beta, T *dst)
+    noexcept;
+
+} // namespace dropout
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,56 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/dropout/mask.hh
+ * Mask of dropout operation by a counter-based Philox generator
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/kernel/randn_philox/philox.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace dropout
+{
+
+//! Threshold of 24-bit random numbers for a given dropout probability
+NNTILE_HOST_DEVICE inline uint32_t threshold(fp64_t p)
+{
+    return uint32_t(p * 16777216.0);
+}
+
+//! Mask of dropout for a group of 4 consecutive elements
+/*! Element i of a sequence is kept if the upper 24 bits of a word i%4 of
+ * Philox output for the counter i/4 are not less than the threshold.
+ *
+ * @param[in] seed: Key of the generator
+ * @param[in] group: Index of the group of 4 elements within the sequence
+ * @param[in] sequence: Index of an independent sequence
+ * @param[in] thresh: Threshold, obtained by threshold() function
+ * @param[out] keep: Mask of the group
+ * */
+NNTILE_HOST_DEVICE inline void mask4(unsigned long long seed, Index group,
+        Index sequence, uint32_t thresh, bool keep[4])
+{
+    uint32_t ctr[4];
+    randn_philox::philox_words(seed, group, sequence, ctr);
+    for(int i = 0; i < 4; ++i)
+    {
+        keep[i] = (ctr[i] >> 8) >= thresh;
+    }
+}
+
+} // namespace dropout
+} // namespace kernel
+} // namespace nntile
+
@@ -26,7 +26,8 @@ namespace embedding
 // Fill embedding from vocabulary
 template<typename T>
 void cpu(Index m, Index n, Index k, Index k_start, Index k_size,
-        const Index *index, const T *vocab, T *embed)
+        Index vocab_start, Index vocab_size, const Index *index,
+        const T *vocab, T *embed)
     noexcept;
 
 } // namespace embedding
@@ -26,7 +26,8 @@ namespace embedding_backward
 // Accumulate gradients of embeddings into vocabulary
 template<typename T>
 void cpu(Index m, Index n, Index k, Index k_start, Index k_size,
-        const Index *index, const T *embed, T *vocab)
+        Index vocab_start, Index vocab_size, const Index *index,
+        const T *embed, T *vocab, Index *tmp)
     noexcept;
 
 } // namespace embedding_backward
@@ -27,7 +27,8 @@ namespace embedding_backward
 // Accumulate gradients of embeddings into vocabulary
 template<typename T>
 void cuda(cudaStream_t stream, Index m, Index n, Index k, Index k_start,
-        Index k_size, const Index *index, const T *embed, T *vocab)
+        Index k_size, Index vocab_start, Index vocab_size,
+        const Index *index, const T *embed, T *vocab, Index *tmp)
     noexcept;
 
 } // namespace embedding_backward
@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/embedding_pos.hh
+ * Embeddings of tokens with added positional embeddings
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/kernel/embedding_pos/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/embedding_pos/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::embedding_pos
+/*! Low-level implementations of embeddings of tokens with added positional
+ * embeddings, that are gathered and summed in a single write
+ * */
+namespace embedding_pos
+{
+
+} // namespace embedding_pos
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/embedding_pos/cpu.hh
+ * Embeddings of tokens and positions on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace embedding_pos
+{
+
+// Embeddings of tokens and positions on CPU
+template<typename T>
+void cpu(Index m, Index n, Index k, Index k_start, Index k_size,
+        Index pos_size, const Index *index, const Index *pos, const T *vocab,
+        const T *pos_vocab, T *embed)
+    noexcept;
+
+} // namespace embedding_pos
+} // namespace kernel
+} // namespace nntile
+
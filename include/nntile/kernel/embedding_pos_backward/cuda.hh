@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/embedding_pos_backward/cuda.hh
+ * Backward of embeddings of tokens and positions on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace embedding_pos_backward
+{
+
+// Backward of embeddings of tokens and positions on CUDA
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, Index k_start,
+        Index k_size, Index pos_size, const Index *index, const Index *pos,
+        const T *embed, T *vocab, T *pos_vocab, Index *tmp)
+    noexcept;
+
+} // namespace embedding_pos_backward
+} // namespace kernel
+} // namespace nntile
+
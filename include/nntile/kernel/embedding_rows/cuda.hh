@@ -0,0 +1,35 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/embedding_rows/cuda.hh
+ * Mark rows of vocabulary, used by tokens, on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-13
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace embedding_rows
+{
+
+// Mark rows of vocabulary, used by tokens, on CUDA
+void cuda(cudaStream_t stream, Index ntokens, const Index *index,
+        bool_t *rows)
+    noexcept;
+
+} // namespace embedding_rows
+} // namespace kernel
+} // namespace nntile
+
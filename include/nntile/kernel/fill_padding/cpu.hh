@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/fill_padding/cpu.hh
+ * Fill padding of a tile beyond a logical extent along an axis on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace fill_padding
+{
+
+// Fill padding of a tile along an axis on CPU
+template<typename T>
+void cpu(Index m, Index n, Index k, Index k_start, T val, T *data)
+    noexcept;
+
+} // namespace fill_padding
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/flash_attention.hh
+ * Fused single-pass flash attention forward low-level kernels
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#pragma once
+
+#include <nntile/kernel/flash_attention/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/flash_attention/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::flash_attention
+/*! Low level kernels for fused attention, that computes softmax of
+ * masked scaled dot products and its product with value tensor in a single
+ * pass over key and value tiles
+ * */
+namespace flash_attention
+{
+
+} // namespace flash_attention
+} // namespace kernel
+} // namespace nntile
+
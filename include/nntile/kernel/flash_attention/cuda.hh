@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/flash_attention/cuda.hh
+ * Fused single-pass flash attention forward on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_attention
+{
+
+// Fused attention forward update for a pair of key and query tiles on CUDA
+template<typename T>
+void cuda(cudaStream_t stream, Index seq, Index head, Index batch,
+        Index n_batch, Index kv_group, const T *K, const T *Q,
+        const bool_t *mask, const T *V, T *maxsumexp, T *A)
+    noexcept;
+
+} // namespace flash_attention
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/flash_attention_backward.hh
+ * Fused single-pass flash attention backward low-level kernels
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#pragma once
+
+#include <nntile/kernel/flash_attention_backward/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/flash_attention_backward/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::flash_attention_backward
+/*! Low level kernels for backward of fused attention, that recomputes
+ * softmax probabilities on the fly instead of reading them from memory
+ * */
+namespace flash_attention_backward
+{
+
+} // namespace flash_attention_backward
+} // namespace kernel
+} // namespace nntile
+
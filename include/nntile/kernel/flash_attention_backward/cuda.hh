@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/flash_attention_backward/cuda.hh
+ * Fused single-pass flash attention backward on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_attention_backward
+{
+
+// Fused attention backward for a pair of key and query tiles on CUDA
+template<typename T>
+void cuda(cudaStream_t stream, Index seq, Index head, Index batch, const T *K,
+        const T *Q, const bool_t *mask, const T *maxsumexp, const T *dA,
+        const T *V, const T *sumprod_slice, T *dQ, T *dK, T *dV)
+    noexcept;
+
+} // namespace flash_attention_backward
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/flash_attention_dequant.hh
+ * Fused attention over quantized keys and values low-level kernels
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/kernel/flash_attention_dequant/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/flash_attention_dequant/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::flash_attention_dequant
+/*! Low level kernels for fused attention of single precision queries to
+ * 8-bit keys and values of KV-cache, that are dequantized on the fly
+ * */
+namespace flash_attention_dequant
+{
+
+} // namespace flash_attention_dequant
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/flash_attention_dequant/cpu.hh
+ * Fused attention over quantized keys and values on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_attention_dequant
+{
+
+// Fused attention update for quantized tiles of keys and values on CPU
+template<typename Q>
+void cpu(Index k_seq, Index q_seq, Index head, Index batch, Index n_batch,
+        Index kv_group, Index mask_stride, const Q *K, const fp32_t *K_scale,
+        const fp32_t *query, const bool_t *mask, const Q *V,
+        const fp32_t *V_scale, fp32_t *maxsumexp, fp32_t *A)
+    noexcept;
+
+} // namespace flash_attention_dequant
+} // namespace kernel
+} // namespace nntile
+
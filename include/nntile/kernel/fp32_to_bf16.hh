@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/fp32_to_bf16.hh
+ * Convert fp32_t array into bf16_t array
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-31
+ * */
+
+#pragma once
+
+#include <nntile/defs.h>
+#include <nntile/kernel/fp32_to_bf16/cpu.hh>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/fp32_to_bf16/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::fp32_to_bf16
+/*! Low-level implementations of convertion fp32 to bf16 operation
+ * */
+namespace fp32_to_bf16
+{
+
+} // namespace fp32_to_bf16
+} // namespace kernel
+} // namespace nntile
+
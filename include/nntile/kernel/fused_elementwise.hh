@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/fused_elementwise.hh
+ * Chain of elementwise operations on buffers, fused into a single pass
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/kernel/fused_elementwise/program.hh>
+#include <nntile/kernel/fused_elementwise/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/fused_elementwise/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::fused_elementwise
+/*! Low-level implementations of a program of elementwise operations, that
+ * is applied to buffers of the same size in a single pass over memory
+ * */
+namespace fused_elementwise
+{
+
+} // namespace fused_elementwise
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/fused_elementwise/cpu.hh
+ * Chain of elementwise operations on CPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/kernel/fused_elementwise/program.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace fused_elementwise
+{
+
+// Apply a program of elementwise operations to CPU buffers
+template<typename T>
+void cpu(Index nelems, const program_t<T> &program, T * const *buffers)
+    noexcept;
+
+} // namespace fused_elementwise
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/fused_elementwise/cuda.hh
+ * Chain of elementwise operations on CUDA buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/kernel/fused_elementwise/program.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace fused_elementwise
+{
+
+// Apply a program of elementwise operations to CUDA buffers
+template<typename T>
+void cuda(cudaStream_t stream, Index nelems, const program_t<T> &program,
+        T * const *buffers)
+    noexcept;
+
+} // namespace fused_elementwise
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,129 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/fused_elementwise/program.hh
+ * Program of elementwise operations for the fused kernel
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace fused_elementwise
+{
+
+//! Maximal number of operations in a program
+static constexpr int MAX_OPS = 32;
+//! Maximal number of buffers of a program
+static constexpr int MAX_BUFFERS = 16;
+
+//! Elementwise operations, their semantics match the non-fused operations
+enum class opcode_t: int
+{
+    //! dst = alpha*src + beta*dst, which also covers axpy
+    ADD = 0,
+    //! dst = src * dst
+    PROD = 1,
+    //! dst = alpha * src, which also covers scal_inplace if src is dst
+    SCAL = 2,
+    //! dst = alpha + beta*dst
+    ADD_SCALAR = 3,
+    //! dst = hypot(alpha*src, beta*dst)
+    HYPOT = 4,
+    //! dst = sqrt(src), which also covers sqrt_inplace if src is dst
+    SQRT = 5
+};
+
+//! Single operation of a program over indices of buffers
+template<typename T>
+struct op_t
+{
+    opcode_t code;
+    int src;
+    int dst;
+    T alpha;
+    T beta;
+};
+
+//! Program of operations, applied in order to every element of buffers
+template<typename T>
+struct program_t
+{
+    int nops;
+    int nbuffers;
+    op_t<T> ops[MAX_OPS];
+};
+
+//! Check if an operation reads its source and destination buffers
+template<typename T>
+inline void op_reads(const op_t<T> &op, bool &src, bool &dst)
+{
+    switch(op.code)
+    {
+        case opcode_t::ADD:
+        case opcode_t::HYPOT:
+            src = op.alpha != T(0);
+            dst = op.beta != T(0);
+            break;
+        case opcode_t::PROD:
+            src = true;
+            dst = true;
+            break;
+        case opcode_t::ADD_SCALAR:
+            src = false;
+            dst = op.beta != T(0);
+            break;
+        default:
+            src = true;
+            dst = false;
+    }
+}
+
+//! Find buffers, that are read before being written, and written buffers
+/*! Values of buffers, that are written before being read, are not needed,
+ * so they can be accessed in the write-only mode.
+ *
+ * @param[in] program: Program of operations
+ * @param[out] load: load[i] is true if the buffer i is read before written
+ * @param[out] store: store[i] is true if the buffer i is written
+ * */
+template<typename T>
+inline void get_access(const program_t<T> &program, bool *load, bool *store)
+{
+    for(int i = 0; i < program.nbuffers; ++i)
+    {
+        load[i] = false;
+        store[i] = false;
+    }
+    for(int k = 0; k < program.nops; ++k)
+    {
+        const op_t<T> &op = program.ops[k];
+        bool src, dst;
+        op_reads(op, src, dst);
+        if(src and not store[op.src])
+        {
+            load[op.src] = true;
+        }
+        if(dst and not store[op.dst])
+        {
+            load[op.dst] = true;
+        }
+        store[op.dst] = true;
+    }
+}
+
+} // namespace fused_elementwise
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/gemm_dequant/cuda.hh
+ * Gemm with dequantization of 8-bit weights on the fly on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace gemm_dequant
+{
+
+template<typename Q>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, Index group,
+        fp32_t alpha, const Q *A, const fp32_t *scale, const fp32_t *B,
+        fp32_t beta, fp32_t *C)
+    noexcept;
+
+} // namespace gemm_dequant
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/layer_norm.hh
+ * Fused layer normalization
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-05
+ * */
+
+#pragma once
+
+#include <nntile/kernel/layer_norm/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/layer_norm/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::layer_norm
+/*! Low-level implementations of fused layer normalization, that computes mean
+ * and inverse of standard deviation in a single pass
+ * */
+namespace layer_norm
+{
+
+} // namespace layer_norm
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,35 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/layer_norm/cpu.hh
+ * Fused layer normalization on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-05
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace layer_norm
+{
+
+// Fused layer normalization on CPU
+template<typename T>
+void cpu(Index m, Index n, Index k, T eps, const T *src, const T *gamma,
+        const T *beta, T *mean, T *inv_stddev, T *dst)
+    noexcept;
+
+} // namespace layer_norm
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/layer_norm_backward.hh
+ * Backward of fused layer normalization
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-05
+ * */
+
+#pragma once
+
+#include <nntile/kernel/layer_norm_backward/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/layer_norm_backward/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::layer_norm_backward
+/*! Low-level implementations of backward of fused layer normalization
+ * */
+namespace layer_norm_backward
+{
+
+} // namespace layer_norm_backward
+} // namespace kernel
+} // namespace nntile
+
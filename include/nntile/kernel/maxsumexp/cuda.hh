@@ -37,6 +37,16 @@ extern template void LaunchMaxSumExp1<fp64_t>(cudaStream_t stream, Index m,
                                               const fp64_t *src,
                                               fp64_t *maxsumexp) noexcept;
 
+extern template void LaunchMaxSumExp1<bf16_t>(cudaStream_t stream, Index m,
+                                              Index n, Index k,
+                                              const bf16_t *src,
+                                              bf16_t *maxsumexp) noexcept;
+
+extern template void LaunchMaxSumExp1<fp16_t>(cudaStream_t stream, Index m,
+                                              Index n, Index k,
+                                              const fp16_t *src,
+                                              fp16_t *maxsumexp) noexcept;
+
 //! Launch accelerated implementation of `maxsumexp` kernel.
 //
 //  Speed up was archived through use of shared memory with block and warp
@@ -57,6 +67,35 @@ extern template void LaunchMaxSumExp3<fp64_t>(cudaStream_t stream, Index m,
                                               const fp64_t *src,
                                               fp64_t *maxsumexp) noexcept;
 
+//! Launch coalesced implementation of `maxsumexp` kernel.
+//
+//  Threads of a warp process 32 consecutive slices, so that their reads of
+//  the input are coalesced, while the reference implementation reads
+//  elements strided by m. It is used for m >= 32.
+template <typename T>
+void LaunchMaxSumExpCoalesced(cudaStream_t stream, Index m, Index n, Index k,
+                              T const *src, T *dst) noexcept;
+
+extern template void
+LaunchMaxSumExpCoalesced<fp32_t>(cudaStream_t stream, Index m, Index n,
+                                 Index k, const fp32_t *src,
+                                 fp32_t *maxsumexp) noexcept;
+
+extern template void
+LaunchMaxSumExpCoalesced<fp64_t>(cudaStream_t stream, Index m, Index n,
+                                 Index k, const fp64_t *src,
+                                 fp64_t *maxsumexp) noexcept;
+
+extern template void
+LaunchMaxSumExpCoalesced<bf16_t>(cudaStream_t stream, Index m, Index n,
+                                 Index k, const bf16_t *src,
+                                 bf16_t *maxsumexp) noexcept;
+
+extern template void
+LaunchMaxSumExpCoalesced<fp16_t>(cudaStream_t stream, Index m, Index n,
+                                 Index k, const fp16_t *src,
+                                 fp16_t *maxsumexp) noexcept;
+
 //! Max and sum of exponents along middle axis
 /*! For a provided m-by-k-by-n input array src compute maximums and sums of
  * exponents of slices along second axis with k elements, resulting in
@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/moe_combine/cpu.hh
+ * Weighted scatter of buffers of experts into tokens on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace moe_combine
+{
+
+// Weighted scatter of buffers of experts into tokens on CPU
+template<typename T>
+void cpu(Index m, Index seq, Index seq_start, Index seq_size,
+        Index batch_start, Index batch_size, Index capacity, Index n_experts,
+        Index expert, const Index *slots, const T *probs, const T *src,
+        T *dst)
+    noexcept;
+
+} // namespace moe_combine
+} // namespace kernel
+} // namespace nntile
+
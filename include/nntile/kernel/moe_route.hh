@@ -0,0 +1,33 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/moe_route.hh
+ * Routing of tokens to experts with a limited capacity
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/kernel/moe_route/cpu.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::moe_route
+/*! Low-level implementations of routing of tokens to experts with a
+ * limited capacity
+ * */
+namespace moe_route
+{
+
+} // namespace moe_route
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,35 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/moe_route/cpu.hh
+ * Routing of tokens to experts on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace moe_route
+{
+
+// Routing of tokens to experts on CPU
+template<typename T>
+void cpu(Index k, Index n_tokens, Index n_experts, Index capacity,
+        const Index *experts, Index *slots, T *load)
+    noexcept;
+
+} // namespace moe_route
+} // namespace kernel
+} // namespace nntile
+
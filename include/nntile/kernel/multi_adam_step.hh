@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/multi_adam_step.hh
+ * Fused Adam and AdamW steps on many buffers at once
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-02
+ * */
+
+#pragma once
+
+#include <nntile/kernel/multi_adam_step/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/multi_adam_step/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::multi_adam_step
+/*! Low-level implementations of fused Adam and AdamW steps, that update many
+ * buffers of parameters by a single call
+ * */
+namespace multi_adam_step
+{
+
+} // namespace multi_adam_step
+} // namespace kernel
+} // namespace nntile
+
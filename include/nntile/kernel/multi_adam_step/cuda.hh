@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/multi_adam_step/cuda.hh
+ * Fused Adam and AdamW steps on many CUDA buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-02
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace multi_adam_step
+{
+
+// Fused Adam or AdamW step on many buffers on CUDA
+template<typename T>
+void cuda(cudaStream_t stream, Index ntensors, const Index *num_elems,
+        Index num_iter, T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        bool decoupled, T * const *grad, T * const *first_moment,
+        T * const *second_moment, T * const *p, const T *scalars=nullptr)
+    noexcept;
+
+} // namespace multi_adam_step
+} // namespace kernel
+} // namespace nntile
+
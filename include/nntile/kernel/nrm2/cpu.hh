@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/nrm2/cpu.hh
+ * Euclidean norm of a buffer accumulated into a scalar by hypot on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace nrm2
+{
+
+// Accumulate Euclidean norm of a buffer into a scalar on CPU
+template<typename T>
+void cpu(Index nelems, T alpha, const T *src, T beta, T *dst)
+    noexcept;
+
+} // namespace nrm2
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/nrm2/cuda.hh
+ * Euclidean norm of a buffer accumulated into a scalar by hypot on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace nrm2
+{
+
+// Accumulate Euclidean norm of a buffer into a scalar on CUDA
+template<typename T>
+void cuda(cudaStream_t stream, Index nelems, T alpha, const T *src, T beta,
+        T *dst, Index nwork, T *work)
+    noexcept;
+
+} // namespace nrm2
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,85 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/parallel.hh
+ * Intra-task parallelism of CPU kernels with OpenMP
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/defs.h>
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::parallel
+/*! Number of threads, that CPU kernels may use, is a property of a calling
+ * thread. It is 1 by default, so that ordinary StarPU workers never
+ * oversubscribe CPU cores, and is set by parallel (combined) workers to
+ * their size.
+ * */
+namespace parallel
+{
+
+// Get number of threads for CPU kernels called by the current thread
+int get_num_threads()
+    noexcept;
+
+// Set number of threads for CPU kernels called by the current thread
+int set_num_threads(int nthreads)
+    noexcept;
+
+//! Set number of threads of CPU kernels until the end of a scope
+class Scope
+{
+    int saved;
+public:
+    explicit Scope(int nthreads):
+        saved(set_num_threads(nthreads))
+    {
+    }
+    ~Scope()
+    {
+        set_num_threads(saved);
+    }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+};
+
+//! Split range [0,n) into contiguous chunks, that are processed in parallel
+/*! Chunks of at least grain elements are passed to func(begin, end) by
+ * threads of an OpenMP team. A range is processed by the calling thread
+ * only, if it is too small or if only a single thread is allowed.
+ * */
+template<typename F>
+void parallel_for(Index n, Index grain, const F &func)
+    noexcept
+{
+    Index nchunks = std::min<Index>(get_num_threads(),
+            n / std::max<Index>(grain, 1));
+    if(nchunks <= 1)
+    {
+        func(Index(0), n);
+        return;
+    }
+#pragma omp parallel for num_threads(nchunks) schedule(static)
+    for(Index i = 0; i < nchunks; ++i)
+    {
+        func(i*n/nchunks, (i+1)*n/nchunks);
+    }
+}
+
+} // namespace parallel
+} // namespace kernel
+} // namespace nntile
+
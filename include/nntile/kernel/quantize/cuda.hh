@@ -0,0 +1,35 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/quantize/cuda.hh
+ * Quantization of weights into 8-bit types with per-group scales on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace quantize
+{
+
+template<typename Q>
+void cuda(cudaStream_t stream, Index m, Index k, Index group,
+        const fp32_t *src, Q *dst, fp32_t *scale)
+    noexcept;
+
+} // namespace quantize
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/quantized_adam_step/cuda.hh
+ * Fused Adam step with block-wise 8-bit moments on CUDA buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace quantized_adam_step
+{
+
+// Fused Adam or AdamW step with block-wise 8-bit moments on CUDA buffers
+void cuda(cudaStream_t stream, Index num_iter, Index num_elems, Index block,
+        fp32_t beta_1, fp32_t beta_2, fp32_t eps, fp32_t lr,
+        fp32_t weight_decay, bool decoupled, const fp32_t *grad,
+        std::int8_t *first_moment, fp32_t *first_scale,
+        fp8_e4m3_t *second_moment, fp32_t *second_scale, fp32_t *p)
+    noexcept;
+
+} // namespace quantized_adam_step
+} // namespace kernel
+} // namespace nntile
+
@@ -15,11 +15,10 @@
 #pragma once
 
 #include <nntile/kernel/randn/cpu.hh>
-// No support for randn on CUDA
-//#include <nntile/defs.h>
-//#ifdef NNTILE_USE_CUDA
-//#include <nntile/kernel/randn/cuda.hh>
-//#endif // NNTILE_USE_CUDA
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/randn/cuda.hh>
+#endif // NNTILE_USE_CUDA
 
 namespace nntile
 {
@@ -0,0 +1,44 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/randn/cuda.hh
+ * Randn operation on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace randn
+{
+
+// Fill manydimensional array with random normally distributed numbers on CUDA
+template<typename T>
+void cuda(cudaStream_t stream, Index ndim, Index nelems,
+        unsigned long long seed, T mean, T stddev, const Index *start,
+        const Index *shape, const Index *underlying_shape, T *data,
+        const Index *stride, Index *tmp_index)
+    noexcept;
+
+// Fill a scalar with a random normally distributed number on CUDA
+template<typename T>
+void cuda_ndim0(cudaStream_t stream, unsigned long long seed, T mean,
+        T stddev, T *data)
+    noexcept;
+
+} // namespace randn
+} // namespace kernel
+} // namespace nntile
+
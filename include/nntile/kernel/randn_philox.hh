@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/randn_philox.hh
+ * Randn operation by a counter-based Philox generator
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/kernel/randn_philox/philox.hh>
+#include <nntile/kernel/randn_philox/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/randn_philox/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::randn_philox
+/*! Low-level implementations of Randn operation by a counter-based Philox
+ * generator
+ * */
+namespace randn_philox
+{
+
+} // namespace randn_philox
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/randn_philox/cuda.hh
+ * Randn operation by a counter-based Philox generator on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace randn_philox
+{
+
+// Fill an array with random normal numbers by Philox generator on CUDA
+template<typename T>
+void cuda(cudaStream_t stream, Index ndim, Index nelems,
+        unsigned long long seed, T mean, T stddev, const Index *start,
+        const Index *shape, const Index *underlying_shape, T *data,
+        const Index *stride, Index *tmp_index)
+    noexcept;
+
+} // namespace randn_philox
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,113 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/randn_philox/philox.hh
+ * Counter-based Philox4x32-10 generator, shared by CPU and CUDA kernels
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <math.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace randn_philox
+{
+
+//! Philox4x32-10 block cipher of a 128-bit counter with a 64-bit key
+/*! See Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", 2011.
+ * Output depends only on the counter and the key, so any element of a
+ * random sequence is generated without generating the previous ones.
+ *
+ * @param[inout] ctr: Counter on input, 4 random 32-bit words on output
+ * @param[in] key0: Lower half of the key
+ * @param[in] key1: Upper half of the key
+ * */
+NNTILE_HOST_DEVICE inline void philox4x32_10(uint32_t ctr[4], uint32_t key0,
+        uint32_t key1)
+{
+    constexpr uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+    constexpr uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+    for(int round = 0; round < 10; ++round)
+    {
+        uint64_t prod0 = uint64_t{M0} * ctr[0];
+        uint64_t prod1 = uint64_t{M1} * ctr[2];
+        uint32_t hi0 = prod0 >> 32, lo0 = uint32_t(prod0);
+        uint32_t hi1 = prod1 >> 32, lo1 = uint32_t(prod1);
+        ctr[0] = hi1 ^ ctr[1] ^ key0;
+        ctr[1] = lo1;
+        ctr[2] = hi0 ^ ctr[3] ^ key1;
+        ctr[3] = lo0;
+        key0 += W0;
+        key1 += W1;
+    }
+}
+
+//! Random words for an element of one of independent random sequences
+/*! Upper half of the counter enumerates sequences, so that a single seed
+ * gives as many independent streams, as there are, for example, tiles.
+ * */
+NNTILE_HOST_DEVICE inline void philox_words(unsigned long long seed,
+        Index offset, Index sequence, uint32_t ctr[4])
+{
+    uint64_t counter = offset, counter_hi = sequence;
+    ctr[0] = uint32_t(counter);
+    ctr[1] = uint32_t(counter >> 32);
+    ctr[2] = uint32_t(counter_hi);
+    ctr[3] = uint32_t(counter_hi >> 32);
+    philox4x32_10(ctr, uint32_t(seed), uint32_t(seed >> 32));
+}
+
+//! Random words for an element of a random sequence
+NNTILE_HOST_DEVICE inline void philox_words(unsigned long long seed,
+        Index offset, uint32_t ctr[4])
+{
+    philox_words(seed, offset, 0, ctr);
+}
+
+//! Normally distributed element of a random sequence by Box-Muller method
+NNTILE_HOST_DEVICE inline fp32_t philox_randn(unsigned long long seed,
+        Index offset, fp32_t mean, fp32_t stddev)
+{
+    constexpr fp32_t twopi=6.2831853071795864769252867663;
+    constexpr fp32_t scale = 1.0f / 16777216.0f;
+    uint32_t ctr[4];
+    philox_words(seed, offset, ctr);
+    // Uniform numbers in (0,1) and in [0,1) with 24 random bits
+    fp32_t t1 = (fp32_t(ctr[0]>>8)+0.5f) * scale;
+    fp32_t t2 = fp32_t(ctr[1]>>8) * scale * twopi;
+    fp32_t t3 = sqrtf(-2.0f*logf(t1)) * cosf(t2);
+    return stddev*t3 + mean;
+}
+
+//! Normally distributed element of a random sequence by Box-Muller method
+NNTILE_HOST_DEVICE inline fp64_t philox_randn(unsigned long long seed,
+        Index offset, fp64_t mean, fp64_t stddev)
+{
+    constexpr fp64_t twopi=6.2831853071795864769252867663;
+    constexpr fp64_t scale = 1.0 / 9007199254740992.0;
+    uint32_t ctr[4];
+    philox_words(seed, offset, ctr);
+    // Uniform numbers in (0,1) and in [0,1) with 53 random bits
+    uint64_t u1 = (uint64_t{ctr[0]} | uint64_t{ctr[1]}<<32) >> 11;
+    uint64_t u2 = (uint64_t{ctr[2]} | uint64_t{ctr[3]}<<32) >> 11;
+    fp64_t t1 = (fp64_t(u1)+0.5) * scale;
+    fp64_t t2 = fp64_t(u2) * scale * twopi;
+    fp64_t t3 = sqrt(-2.0*log(t1)) * cos(t2);
+    return stddev*t3 + mean;
+}
+
+} // namespace randn_philox
+} // namespace kernel
+} // namespace nntile
+
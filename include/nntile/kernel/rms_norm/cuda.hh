@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/rms_norm/cuda.hh
+ * Root mean square layer normalization on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace rms_norm
+{
+
+// Root mean square layer normalization on CUDA
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, T eps,
+        const T *src, const T *gamma, T *inv_rms, T *dst)
+    noexcept;
+
+} // namespace rms_norm
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,35 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/rms_norm_backward/cpu.hh
+ * Backward of root mean square layer normalization on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace rms_norm_backward
+{
+
+// Backward of root mean square layer normalization on CPU
+template<typename T>
+void cpu(Index m, Index n, Index k, const T *src, const T *dst_grad,
+        const T *gamma, const T *inv_rms, T *src_grad, T *gamma_grad)
+    noexcept;
+
+} // namespace rms_norm_backward
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,35 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/rope/cpu.hh
+ * Rotary position embedding on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace rope
+{
+
+// In-place rotary position embedding on CPU
+template<typename T>
+void cpu(Index m, Index n, Index k, Index head_size, Index offset_m,
+        Index offset_n, T base, bool inverse, T *data)
+    noexcept;
+
+} // namespace rope
+} // namespace kernel
+} // namespace nntile
+
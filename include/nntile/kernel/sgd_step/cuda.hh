@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/sgd_step/cuda.hh
+ * Fused SGD step with momentum on CUDA buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace sgd_step
+{
+
+// Fused SGD step with momentum on CUDA buffers
+template<typename T>
+void cuda(cudaStream_t stream, Index num_iter, Index num_elems, T momentum,
+        T dampening, T lr, T weight_decay, bool nesterov, const T *grad,
+        T *velocity, T *p)
+    noexcept;
+
+} // namespace sgd_step
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,522 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/simd.hh
+ * Helpers for vectorized (AVX2 and AVX-512) CPU kernels
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-26
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/defs.h>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+// Vector extensions of GCC and Clang are used together with per-function
+// target attributes, so that the library is still built for a generic x86-64
+// and the instruction set is chosen at run time
+#if defined(NNTILE_USE_CPU_SIMD) && defined(__x86_64__) && defined(__GNUC__)
+#   define NNTILE_KERNEL_SIMD_X86
+#   define NNTILE_SIMD_INLINE inline __attribute__((always_inline))
+#   define NNTILE_SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#   define NNTILE_SIMD_TARGET_AVX512 \
+        __attribute__((target("avx512f,avx2,fma")))
+#   define NNTILE_SIMD_LOOP __attribute__((always_inline))
+#   include <immintrin.h>
+#else
+#   define NNTILE_SIMD_LOOP
+#endif
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::simd
+/*! Selection of vectorized CPU kernels and vector math used by them
+ * */
+namespace simd
+{
+
+//! Instruction set extensions used by CPU kernels
+enum class Level: int
+{
+    NONE = 0,
+    AVX2 = 1,
+    AVX512 = 2
+};
+
+// Get instruction set used by CPU kernels
+Level get_level()
+    noexcept;
+
+// Restrict instruction set used by CPU kernels
+Level set_level(Level level)
+    noexcept;
+
+// Name of an instruction set
+const char *level_name(Level level)
+    noexcept;
+
+#ifdef NNTILE_KERNEL_SIMD_X86
+
+//! Call a loop compiled for AVX2
+template<typename F>
+NNTILE_SIMD_TARGET_AVX2
+void call_avx2(const F &loop)
+    noexcept
+{
+    loop();
+}
+
+//! Call a loop compiled for AVX-512
+template<typename F>
+NNTILE_SIMD_TARGET_AVX512
+void call_avx512(const F &loop)
+    noexcept
+{
+    loop();
+}
+
+#endif // NNTILE_KERNEL_SIMD_X86
+
+//! Call a loop compiled for the instruction set used by CPU kernels
+/*! The loop is a lambda with NNTILE_SIMD_LOOP attribute, so that it is
+ * inlined into a copy for every instruction set and auto-vectorized by the
+ * compiler for it. This suits simple loops, that do not need vector math.
+ * */
+template<typename F>
+void dispatch(const F &loop)
+    noexcept
+{
+#ifdef NNTILE_KERNEL_SIMD_X86
+    switch(get_level())
+    {
+        case Level::AVX512:
+            call_avx512(loop);
+            return;
+        case Level::AVX2:
+            call_avx2(loop);
+            return;
+        default:
+            break;
+    }
+#endif // NNTILE_KERNEL_SIMD_X86
+    loop();
+}
+
+#ifdef NNTILE_KERNEL_SIMD_X86
+
+// Helpers below are always inlined into functions with a proper target
+// attribute, so the warning about vector return values ABI is irrelevant.
+// It is disabled only for the helpers, not for files including them, while
+// kernels calling them are built with -Wno-psabi (see CMakeLists.txt).
+#ifndef __clang__
+#   pragma GCC diagnostic push
+#   pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+//! Vector of W values of type T
+template<typename T, int W>
+struct Vec
+{
+    //! Floating point vector
+    typedef T type __attribute__((vector_size(W*sizeof(T))));
+    //! Integer vector of the same size, also a type of comparison results
+    using int_t = std::conditional_t<sizeof(T) == 4, std::int32_t,
+          std::int64_t>;
+    typedef int_t itype __attribute__((vector_size(W*sizeof(T))));
+};
+
+//! Constants of vectorized exp and log
+template<typename T>
+struct MathConst;
+
+template<>
+struct MathConst<fp32_t>
+{
+    static constexpr fp32_t log2e = 1.44269504088896341f;
+    static constexpr fp32_t ln2_hi = 0.693359375f;
+    static constexpr fp32_t ln2_lo = -2.12194440e-4f;
+    // exp(x) underflows to zero below exp_lo and overflows above exp_hi
+    static constexpr fp32_t exp_lo = -87.3365402f;
+    static constexpr fp32_t exp_hi = 88.7228317f;
+    // 1.5*2^23 rounds to the nearest integer when added and subtracted
+    static constexpr fp32_t round_magic = 12582912.0f;
+    static constexpr int mant_bits = 23;
+    static constexpr int exp_bias = 127;
+    // Taylor coefficients 1/j! of exp on [-ln(2)/2, ln(2)/2]
+    static constexpr int exp_ncoef = 8;
+    static constexpr fp32_t exp_coef[exp_ncoef] = {1.0f, 1.0f, 1.0f/2,
+        1.0f/6, 1.0f/24, 1.0f/120, 1.0f/720, 1.0f/5040};
+    // Coefficients 2/(2j+1) of log((1+s)/(1-s)) = 2*atanh(s) series
+    static constexpr int log_ncoef = 6;
+    static constexpr fp32_t log_coef[log_ncoef] = {2.0f, 2.0f/3, 2.0f/5,
+        2.0f/7, 2.0f/9, 2.0f/11};
+    // Chebyshev coefficients of log(erfc(x)*exp(x^2)/t) over y = 2t-1,
+    // t = 2/(2+x), with the first coefficient already halved
+    static constexpr int erfc_ncoef = 14;
+    static constexpr fp32_t erfc_coef[erfc_ncoef] = {-6.513268599e-01f,
+        6.419697924e-01f, 1.947647320e-02f, -9.561514787e-03f,
+        -9.465953445e-04f, 3.668394979e-04f, 4.252332481e-05f,
+        -2.027857811e-05f, -1.624290005e-06f, 1.303655836e-06f,
+        1.562644172e-08f, -8.523809591e-08f, 6.529054439e-09f,
+        5.059343496e-09f};
+    // erfc(x) underflows to zero above erfc_hi
+    static constexpr fp32_t erfc_hi = 10.1f;
+    // Parts of pi/2 for reduction of arguments of cos, the first two of them
+    // have lower bits of mantissa cleared (Cody-Waite)
+    static constexpr fp32_t two_over_pi = 0.636619772367581343f;
+    static constexpr fp32_t pio2_1 = 1.5703125f;
+    static constexpr fp32_t pio2_2 = 4.837512969970703125e-4f;
+    static constexpr fp32_t pio2_3 = 7.54978995489188216e-8f;
+    // Taylor coefficients (-1)^j/(2j)! of cos and (-1)^j/(2j+1)! of sin on
+    // [-pi/4, pi/4] over the square of argument
+    static constexpr int cos_ncoef = 6;
+    static constexpr fp32_t cos_coef[cos_ncoef] = {1.0f, -1.0f/2, 1.0f/24,
+        -1.0f/720, 1.0f/40320, -1.0f/3628800};
+    static constexpr fp32_t sin_coef[cos_ncoef] = {1.0f, -1.0f/6, 1.0f/120,
+        -1.0f/5040, 1.0f/362880, -1.0f/39916800};
+    // Number of lower mantissa bits, that are cleared to get a value with
+    // an exactly representable square
+    static constexpr int split_bits = 12;
+};
+
+template<>
+struct MathConst<fp64_t>
+{
+    static constexpr fp64_t log2e = 1.44269504088896340736;
+    static constexpr fp64_t ln2_hi = 6.93147180369123816490e-01;
+    static constexpr fp64_t ln2_lo = 1.90821492927058770002e-10;
+    static constexpr fp64_t exp_lo = -708.396418532264106;
+    static constexpr fp64_t exp_hi = 709.782712893383973;
+    static constexpr fp64_t round_magic = 6755399441055744.0;
+    static constexpr int mant_bits = 52;
+    static constexpr int exp_bias = 1023;
+    static constexpr int exp_ncoef = 14;
+    static constexpr fp64_t exp_coef[exp_ncoef] = {1.0, 1.0, 1.0/2, 1.0/6,
+        1.0/24, 1.0/120, 1.0/720, 1.0/5040, 1.0/40320, 1.0/362880,
+        1.0/3628800, 1.0/39916800, 1.0/479001600, 1.0/6227020800};
+    static constexpr int log_ncoef = 12;
+    static constexpr fp64_t log_coef[log_ncoef] = {2.0, 2.0/3, 2.0/5, 2.0/7,
+        2.0/9, 2.0/11, 2.0/13, 2.0/15, 2.0/17, 2.0/19, 2.0/21, 2.0/23};
+    static constexpr int erfc_ncoef = 28;
+    static constexpr fp64_t erfc_coef[erfc_ncoef] = {-6.513268598908547e-01,
+        6.419697923564902e-01, 1.9476473204185836e-02,
+        -9.561514786808632e-03, -9.465953444820369e-04,
+        3.6683949785276145e-04, 4.252332480690777e-05,
+        -2.0278578112534242e-05, -1.6242900046470256e-06,
+        1.3036558355805232e-06, 1.5626441722066142e-08,
+        -8.523809591492654e-08, 6.5290544390988515e-09,
+        5.059343495551469e-09, -9.91364156493033e-10,
+        -2.273651222931836e-10, 9.646791102015527e-11,
+        2.3940380830391146e-12, -6.886027526497553e-12,
+        8.944879273090725e-13, 3.130921399342958e-13,
+        -1.1270822361367252e-13, 3.810905255189232e-16,
+        7.106097613609237e-15, -1.5230282014571043e-15,
+        -9.457494571291233e-17, 1.210237189224279e-16,
+        -2.816663087747177e-17};
+    static constexpr fp64_t erfc_hi = 27.3;
+    static constexpr fp64_t two_over_pi = 6.36619772367581382433e-01;
+    static constexpr fp64_t pio2_1 = 1.57079632673412561417e+00;
+    static constexpr fp64_t pio2_2 = 6.07710050630396597660e-11;
+    static constexpr fp64_t pio2_3 = 2.02226624871116645580e-21;
+    static constexpr int cos_ncoef = 9;
+    static constexpr fp64_t cos_coef[cos_ncoef] = {1.0, -1.0/2, 1.0/24,
+        -1.0/720, 1.0/40320, -1.0/3628800, 1.0/479001600,
+        -1.0/87178291200, 1.0/20922789888000};
+    static constexpr fp64_t sin_coef[cos_ncoef] = {1.0, -1.0/6, 1.0/120,
+        -1.0/5040, 1.0/362880, -1.0/39916800, 1.0/6227020800,
+        -1.0/1307674368000, 1.0/355687428096000};
+    static constexpr int split_bits = 27;
+};
+
+//! Load W contiguous values from unaligned memory
+template<typename T, int W>
+NNTILE_SIMD_INLINE typename Vec<T, W>::type load(const T *ptr)
+    noexcept
+{
+    typename Vec<T, W>::type res;
+    std::memcpy(&res, ptr, sizeof(res));
+    return res;
+}
+
+//! Store W contiguous values into unaligned memory
+template<typename T, int W>
+NNTILE_SIMD_INLINE void store(const typename Vec<T, W>::type &val, T *ptr)
+    noexcept
+{
+    std::memcpy(ptr, &val, sizeof(val));
+}
+
+//! Vector with all elements equal to a given scalar
+template<typename T, int W>
+NNTILE_SIMD_INLINE typename Vec<T, W>::type broadcast(T val)
+    noexcept
+{
+    typename Vec<T, W>::type res = {};
+    return res + val;
+}
+
+//! Absolute value
+template<typename T, int W>
+NNTILE_SIMD_INLINE typename Vec<T, W>::type abs(
+        const typename Vec<T, W>::type &x)
+    noexcept
+{
+    using V = typename Vec<T, W>::type;
+    using I = typename Vec<T, W>::itype;
+    using int_t = typename Vec<T, W>::int_t;
+    // Clear the sign bit
+    return (V)((I)x & std::numeric_limits<int_t>::max());
+}
+
+//! Vectorized exponent
+/*! Argument is reduced as x = n*ln(2) + r, |r| <= ln(2)/2, with ln(2) split
+ * into two parts (Cody-Waite), and exp(r) is computed by the Taylor series.
+ * Relative error is bounded by 2 ulp for x within [exp_lo, exp_hi]. Smaller
+ * arguments, including -inf, result in zero and larger arguments in +inf.
+ * NaN is propagated.
+ * */
+template<typename T, int W>
+NNTILE_SIMD_INLINE typename Vec<T, W>::type exp(
+        const typename Vec<T, W>::type &x)
+    noexcept
+{
+    using C = MathConst<T>;
+    using V = typename Vec<T, W>::type;
+    using I = typename Vec<T, W>::itype;
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    const V lo = broadcast<T, W>(C::exp_lo), hi = broadcast<T, W>(C::exp_hi);
+    V xc = x < lo ? lo : x;
+    xc = xc > hi ? hi : xc;
+    // Round x/ln(2) to the nearest integer
+    V n = xc*C::log2e + C::round_magic;
+    n = n - C::round_magic;
+    V r = xc - n*C::ln2_hi;
+    r = r - n*C::ln2_lo;
+    V p = broadcast<T, W>(C::exp_coef[C::exp_ncoef-1]);
+    for(int i = C::exp_ncoef-2; i >= 0; --i)
+    {
+        p = p*r + C::exp_coef[i];
+    }
+    // Multiply by 2^n in two steps to avoid overflow of the exponent near
+    // exp_hi and underflow near exp_lo
+    I ni = __builtin_convertvector(n, I);
+    I n1 = ni >> 1;
+    I n2 = ni - n1;
+    V s1 = (V)((n1+C::exp_bias) << C::mant_bits);
+    V s2 = (V)((n2+C::exp_bias) << C::mant_bits);
+    V res = p * s1 * s2;
+    res = x < lo ? broadcast<T, W>(0) : res;
+    res = x > hi ? broadcast<T, W>(inf) : res;
+    res = x != x ? x : res;
+    return res;
+}
+
+//! Vectorized natural logarithm of a positive normalized value
+/*! A value x = 2^e * f, f in [sqrt(1/2), sqrt(2)), gives log(x) = e*ln(2) +
+ * 2*atanh((f-1)/(f+1)), where the series for atanh is used. Relative error is
+ * bounded by 2 ulp. Zero results in -inf, +inf in +inf and negative values or
+ * NaN in NaN. Subnormal values are not supported.
+ * */
+template<typename T, int W>
+NNTILE_SIMD_INLINE typename Vec<T, W>::type log(
+        const typename Vec<T, W>::type &x)
+    noexcept
+{
+    using C = MathConst<T>;
+    using V = typename Vec<T, W>::type;
+    using I = typename Vec<T, W>::itype;
+    using int_t = typename Vec<T, W>::int_t;
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    constexpr T nan = std::numeric_limits<T>::quiet_NaN();
+    constexpr int_t mant_mask = (int_t{1} << C::mant_bits) - 1;
+    constexpr int_t one_bits = int_t{C::exp_bias} << C::mant_bits;
+    // Split into exponent and mantissa in [1, 2)
+    I bits = (I)x;
+    I e = (bits >> C::mant_bits) - C::exp_bias;
+    V f = (V)((bits & mant_mask) | one_bits);
+    // Move mantissa into [sqrt(1/2), sqrt(2))
+    auto big = f > T(1.41421356237309504880);
+    f = big ? f*T(0.5) : f;
+    e = big ? e+1 : e;
+    V s = (f-T(1)) / (f+T(1));
+    V z = s * s;
+    V p = broadcast<T, W>(C::log_coef[C::log_ncoef-1]);
+    for(int i = C::log_ncoef-2; i >= 0; --i)
+    {
+        p = p*z + C::log_coef[i];
+    }
+    V ef = __builtin_convertvector(e, V);
+    V res = ef*C::ln2_hi + (s*p + ef*C::ln2_lo);
+    res = x == T(0) ? broadcast<T, W>(-inf) : res;
+    res = x == inf ? x : res;
+    res = x < T(0) ? broadcast<T, W>(nan) : res;
+    res = x != x ? x : res;
+    return res;
+}
+
+//! Vectorized cosine of a finite argument of a moderate magnitude
+/*! Argument is reduced as x = n*pi/2 + r, |r| <= pi/4, with pi/2 split into
+ * three parts (Cody-Waite), and cos(r) or sin(r) is computed by the Taylor
+ * series depending on the quadrant n. Absolute error is below 1 ulp of one
+ * for |x| up to 2^13 in single precision and up to 2^20 in double precision,
+ * where products of n and the first two parts are exact. Infinity or NaN
+ * results in NaN.
+ * */
+template<typename T, int W>
+NNTILE_SIMD_INLINE typename Vec<T, W>::type cos(
+        const typename Vec<T, W>::type &x)
+    noexcept
+{
+    using C = MathConst<T>;
+    using V = typename Vec<T, W>::type;
+    using I = typename Vec<T, W>::itype;
+    // Round 2x/pi to the nearest integer
+    V n = x*C::two_over_pi + C::round_magic;
+    n = n - C::round_magic;
+    V r = x - n*C::pio2_1;
+    r = r - n*C::pio2_2;
+    r = r - n*C::pio2_3;
+    V z = r * r;
+    V c = broadcast<T, W>(C::cos_coef[C::cos_ncoef-1]);
+    V s = broadcast<T, W>(C::sin_coef[C::cos_ncoef-1]);
+    for(int i = C::cos_ncoef-2; i >= 0; --i)
+    {
+        c = c*z + C::cos_coef[i];
+        s = s*z + C::sin_coef[i];
+    }
+    s = s * r;
+    // Quadrants 1 and 3 use sine, while quadrants 1 and 2 change sign
+    I q = __builtin_convertvector(n, I);
+    V res = (q & 1) != 0 ? s : c;
+    res = ((q+1) & 2) != 0 ? -res : res;
+    res = x != x ? x : res;
+    return res;
+}
+
+//! Vectorized complementary error function
+/*! For a = |x| it is erfc(a) = t*exp(-a^2)*exp(P(2t-1)), t = 2/(2+a), where
+ * P is a Chebyshev series fitted once in extended precision. To avoid loss
+ * of accuracy for large a, the square is split as a^2 = ah^2 + al*(a+ah),
+ * where ah is a with lower bits of mantissa cleared, so that ah^2 is exact.
+ * Negative arguments use erfc(x) = 2-erfc(-x). Relative error is bounded by
+ * 4 ulp while the result is a normalized number, otherwise it may be
+ * flushed to zero. NaN is propagated.
+ * */
+template<typename T, int W>
+NNTILE_SIMD_INLINE typename Vec<T, W>::type erfc(
+        const typename Vec<T, W>::type &x)
+    noexcept
+{
+    using C = MathConst<T>;
+    using V = typename Vec<T, W>::type;
+    using I = typename Vec<T, W>::itype;
+    using int_t = typename Vec<T, W>::int_t;
+    constexpr int_t split_mask = ~((int_t{1} << C::split_bits) - 1);
+    V a = abs<T, W>(x);
+    // Larger arguments, including infinity, underflow anyway
+    a = a > C::erfc_hi ? broadcast<T, W>(C::erfc_hi) : a;
+    V t = T(2) / (T(2)+a);
+    V y = T(2)*t - T(1);
+    // Clenshaw recurrence for the Chebyshev series
+    V y2 = y + y;
+    V b1 = {}, b2 = {};
+    for(int i = C::erfc_ncoef-1; i > 0; --i)
+    {
+        V b0 = y2*b1 - b2 + C::erfc_coef[i];
+        b2 = b1;
+        b1 = b0;
+    }
+    V p = y*b1 - b2 + C::erfc_coef[0];
+    V ah = (V)((I)a & split_mask);
+    V al = a - ah;
+    V res = t * exp<T, W>(-ah*ah) * exp<T, W>(p - al*(a+ah));
+    res = x < T(0) ? T(2)-res : res;
+    res = x != x ? x : res;
+    return res;
+}
+
+//! Square roots by instructions of AVX2 and AVX-512
+/*! Vector extensions have no square root, so intrinsics are used. Each
+ * overload has its own target attribute. Overloads are not always inlined,
+ * as generic helpers can not inline functions with a wider instruction set.
+ * They are inlined later into functions with the same instruction set.
+ * */
+inline NNTILE_SIMD_TARGET_AVX2 Vec<fp32_t, 8>::type sqrt_vec(
+        const Vec<fp32_t, 8>::type &x)
+    noexcept
+{
+    return (Vec<fp32_t, 8>::type)_mm256_sqrt_ps((__m256)x);
+}
+
+inline NNTILE_SIMD_TARGET_AVX2 Vec<fp64_t, 4>::type sqrt_vec(
+        const Vec<fp64_t, 4>::type &x)
+    noexcept
+{
+    return (Vec<fp64_t, 4>::type)_mm256_sqrt_pd((__m256d)x);
+}
+
+inline NNTILE_SIMD_TARGET_AVX512 Vec<fp32_t, 16>::type sqrt_vec(
+        const Vec<fp32_t, 16>::type &x)
+    noexcept
+{
+    return (Vec<fp32_t, 16>::type)_mm512_sqrt_ps((__m512)x);
+}
+
+inline NNTILE_SIMD_TARGET_AVX512 Vec<fp64_t, 8>::type sqrt_vec(
+        const Vec<fp64_t, 8>::type &x)
+    noexcept
+{
+    return (Vec<fp64_t, 8>::type)_mm512_sqrt_pd((__m512d)x);
+}
+
+//! Vectorized square root, correctly rounded as std::sqrt
+template<typename T, int W>
+NNTILE_SIMD_INLINE typename Vec<T, W>::type sqrt(
+        const typename Vec<T, W>::type &x)
+    noexcept
+{
+    return sqrt_vec(x);
+}
+
+//! Vectorized hypotenuse without undue overflow or underflow
+/*! It is computed as max*sqrt(1+(min/max)^2), so its relative error is a few
+ * ulp, while std::hypot is correctly rounded. NaN results in NaN, and
+ * infinity results in infinity unless the other argument is infinity or NaN.
+ * */
+template<typename T, int W>
+NNTILE_SIMD_INLINE typename Vec<T, W>::type hypot(
+        const typename Vec<T, W>::type &x, const typename Vec<T, W>::type &y)
+    noexcept
+{
+    using V = typename Vec<T, W>::type;
+    V a = abs<T, W>(x), b = abs<T, W>(y);
+    // NaN in any of arguments goes into the maximum
+    auto a_less = a < b;
+    V vmax = a_less ? b : a;
+    V vmin = a_less ? a : b;
+    vmax = b != b ? b : vmax;
+    V r = vmax > T(0) ? vmin/vmax : broadcast<T, W>(0);
+    return vmax * sqrt<T, W>(T(1) + r*r);
+}
+
+#ifndef __clang__
+#   pragma GCC diagnostic pop
+#endif
+
+#endif // NNTILE_KERNEL_SIMD_X86
+
+} // namespace simd
+} // namespace kernel
+} // namespace nntile
+
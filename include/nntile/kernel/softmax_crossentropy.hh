@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/softmax_crossentropy.hh
+ * Fused loss and gradient of softmax cross-entropy
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-14
+ * */
+
+#pragma once
+
+#include <nntile/kernel/softmax_crossentropy/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/softmax_crossentropy/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::softmax_crossentropy
+/*! Low-level implementations of fused loss and gradient of softmax
+ * cross-entropy
+ * */
+namespace softmax_crossentropy
+{
+
+} // namespace softmax_crossentropy
+} // namespace kernel
+} // namespace nntile
+
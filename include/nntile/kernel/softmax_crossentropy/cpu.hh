@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/softmax_crossentropy/cpu.hh
+ * Fused loss and gradient of softmax cross-entropy on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-14
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace softmax_crossentropy
+{
+
+// Fused loss and gradient of softmax cross-entropy on CPU
+template<typename T>
+void cpu(Index n_labels, Index n_outputs, Index label_start, T scale,
+        const T *maxsumexp, const T *src, const Index *labels, T *dst,
+        T *val)
+    noexcept;
+
+} // namespace softmax_crossentropy
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,41 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/softmax_online.hh
+ * Online softmax along the middle axis of several buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/kernel/softmax_online/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/softmax_online/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::softmax_online
+/*! Low-level implementations of softmax along the middle axis of several
+ * buffers, that finds maximums and sums of exponents by a single pass
+ * */
+namespace softmax_online
+{
+
+//! Maximal number of buffers of a single call. All the pointers are passed
+//! to a CUDA kernel as a parameter.
+constexpr Index MAX_TILES = 64;
+
+} // namespace softmax_online
+} // namespace kernel
+} // namespace nntile
+
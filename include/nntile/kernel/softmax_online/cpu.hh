@@ -0,0 +1,35 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/softmax_online/cpu.hh
+ * Online softmax along the middle axis of several buffers on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace softmax_online
+{
+
+// Online softmax along the middle axis of several buffers on CPU
+template<typename T>
+void cpu(Index m, Index n, Index ntiles, const Index *k, T alpha,
+        T * const *dst)
+    noexcept;
+
+} // namespace softmax_online
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/softmax_online/cuda.hh
+ * Online softmax along the middle axis of several buffers on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace softmax_online
+{
+
+// Online softmax along the middle axis of several buffers on CUDA
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index ntiles,
+        const Index *k, T alpha, T * const *dst)
+    noexcept;
+
+} // namespace softmax_online
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/sparse_adam_step/cpu.hh
+ * Fused Adam step on marked columns of CPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-13
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace sparse_adam_step
+{
+
+// Fused Adam step on marked columns of CPU buffers
+template<typename T>
+void cpu(Index m, Index n, T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        const bool_t *cols, Index *cols_iter, const T *grad, T *first_moment,
+        T *second_moment, T *p)
+    noexcept;
+
+} // namespace sparse_adam_step
+} // namespace kernel
+} // namespace nntile
+
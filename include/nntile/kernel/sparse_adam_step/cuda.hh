@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/sparse_adam_step/cuda.hh
+ * Fused Adam step on marked columns of CUDA buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-13
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace sparse_adam_step
+{
+
+// Fused Adam step on marked columns of CUDA buffers
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, T beta_1, T beta_2, T eps,
+        T lr, T weight_decay, const bool_t *cols, Index *cols_iter,
+        const T *grad, T *first_moment, T *second_moment, T *p)
+    noexcept;
+
+} // namespace sparse_adam_step
+} // namespace kernel
+} // namespace nntile
+
@@ -24,13 +24,13 @@ namespace kernel
 namespace strassen
 {
 
-// Per-element product of two buffers
+// Strassen multiplication of contiguous matrices on CPU
 template <typename T>
 void cpu(TransOp transA, TransOp transB,
                           Index M, Index N, Index K, T alpha,
                           const T *A, const T *B, T beta, T *C) noexcept;
 
-} // namespace prod
+} // namespace strassen
 } // namespace kernel
 } // namespace nntile
 
@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/strassen/cuda.hh
+ * Strassen multiplication operation on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/constants.hh>
+#include <cublas_v2.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace strassen
+{
+
+// Strassen-Winograd multiplication of contiguous matrices on CUDA
+template<typename T>
+void cuda(cublasHandle_t handle, TransOp transA, TransOp transB, Index m,
+        Index n, Index k, T alpha, const T *A, const T *B, T beta, T *C,
+        T *work, int nlevels)
+    noexcept;
+
+} // namespace strassen
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,57 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/strassen/workspace.hh
+ * Size of workspace for Strassen multiplication on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace strassen
+{
+
+//! Number of elements of workspace for Strassen multiplication on CUDA
+/*! Each level of recursion needs two buffers for sums of blocks of op(A)
+ * and op(B) and two buffers for products. Products of a level are computed
+ * one by one, so deeper levels reuse the same part of workspace.
+ *
+ * @param[in] m: Number of rows of op(A) and C
+ * @param[in] n: Number of columns of op(B) and C
+ * @param[in] k: Number of columns of op(A) and number of rows of op(B)
+ * @param[in] nlevels: Maximal number of levels of recursion
+ * */
+inline Index workspace_size(Index m, Index n, Index k, int nlevels)
+    noexcept
+{
+    Index size = 0;
+    for(int level = 0; level < nlevels; ++level)
+    {
+        m /= 2;
+        n /= 2;
+        k /= 2;
+        if(m == 0 or n == 0 or k == 0)
+        {
+            break;
+        }
+        size += m*k + k*n + 2*m*n;
+    }
+    return size;
+}
+
+} // namespace strassen
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/subcopy/cuda.hh
+ * Copy subarray based on contiguous indices on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace subcopy
+{
+
+// Complex copying of one multidimensional array into another on CUDA
+template<typename T>
+void cuda(cudaStream_t stream, Index ndim, const Index *src_start,
+        const Index *src_stride, const Index *copy_shape, const T *src,
+        const Index *dst_start, const Index *dst_stride, T *dst)
+    noexcept;
+
+} // namespace subcopy
+} // namespace kernel
+} // namespace nntile
+
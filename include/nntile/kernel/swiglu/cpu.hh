@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/swiglu/cpu.hh
+ * SiLU-gated product of buffers on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace swiglu
+{
+
+// SiLU-gated product of buffers on CPU
+template<typename T>
+void cpu(Index nelems, const T *gate, const T *up, T *dst)
+    noexcept;
+
+} // namespace swiglu
+} // namespace kernel
+} // namespace nntile
+
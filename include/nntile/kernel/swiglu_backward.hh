@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/swiglu_backward.hh
+ * Backward of SiLU of a gate multiplied by an up-projection
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/kernel/swiglu_backward/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/swiglu_backward/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::swiglu_backward
+/*! Low-level implementations of backward of SiLU of a gate multiplied by an
+ * up-projection, that accumulates gradients of both inputs in a single pass
+ * */
+namespace swiglu_backward
+{
+
+} // namespace swiglu_backward
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/swiglu_backward/cuda.hh
+ * Backward of SiLU-gated product of buffers on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace swiglu_backward
+{
+
+// Backward of SiLU-gated product of buffers on CUDA
+template<typename T>
+void cuda(cudaStream_t stream, Index nelems, const T *gate, const T *up,
+        const T *dst_grad, T *gate_grad, T *up_grad)
+    noexcept;
+
+} // namespace swiglu_backward
+} // namespace kernel
+} // namespace nntile
+
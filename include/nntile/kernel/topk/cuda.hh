@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/topk/cuda.hh
+ * Largest values and their indices along middle axis on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-11
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace topk
+{
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, Index nk,
+        Index offset, Index size, bool init, const T *src, T *values,
+        Index *indices)
+    noexcept;
+
+} // namespace topk
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/topk_sample.hh
+ * Sampling of tokens among the largest logits
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-11
+ * */
+
+#pragma once
+
+#include <nntile/kernel/topk_sample/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/topk_sample/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::topk_sample
+/*! Low-level implementations of sampling of tokens among the largest logits
+ * */
+namespace topk_sample
+{
+
+} // namespace topk_sample
+} // namespace kernel
+} // namespace nntile
+
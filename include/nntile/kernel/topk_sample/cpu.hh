@@ -0,0 +1,35 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/topk_sample/cpu.hh
+ * Sampling of tokens among the largest logits on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-11
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace topk_sample
+{
+
+template<typename T>
+void cpu(Index nk, Index n, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed, Index sequence, const T *values,
+        const Index *indices, Index *ids)
+    noexcept;
+
+} // namespace topk_sample
+} // namespace kernel
+} // namespace nntile
+
@@ -28,6 +28,11 @@ template<typename T>
 void cpu(Index m, Index n, T alpha, const T* src, T* dst)
     noexcept;
 
+// Apply transpose for a square buffer inplace on CPU
+template<typename T>
+void cpu_inplace(Index n, T alpha, T *data)
+    noexcept;
+
 } // namespace transpose
 } // namespace kernel
 } // namespace nntile
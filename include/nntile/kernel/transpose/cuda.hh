@@ -29,6 +29,11 @@ template<typename T>
 void cuda(cudaStream_t stream, Index m, Index n, T alpha, const T* src, T* dst)
     noexcept;
 
+// Apply transpose for a square buffer inplace on CUDA
+template<typename T>
+void cuda_inplace(cudaStream_t stream, Index n, T alpha, T *data)
+    noexcept;
+
 } // namespace transpose
 } // namespace kernel
 } // namespace nntile
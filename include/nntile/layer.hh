@@ -14,10 +14,22 @@
 
 #pragma once
 
-#include <nntile/layer/linear.hh>
+//#include <nntile/layer/linear.hh>
 //#include <nntile/layer/gelu.hh>
 //#include <nntile/layer/gelutanh.hh>
 //#include <nntile/layer/mlp.hh>
+#include <nntile/layer/module.hh>
+#include <nntile/layer/act.hh>
+#include <nntile/layer/add.hh>
+#include <nntile/layer/add_layer_norm.hh>
+#include <nntile/layer/add_slice.hh>
+#include <nntile/layer/attention.hh>
+#include <nntile/layer/dense.hh>
+#include <nntile/layer/embedding.hh>
+#include <nntile/layer/flash_attention.hh>
+#include <nntile/layer/layer_norm.hh>
+#include <nntile/layer/rms_norm.hh>
+#include <nntile/layer/sequential.hh>
 
 namespace nntile
 {
@@ -0,0 +1,48 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/layer/act.hh
+ * Elementwise activation layer
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/layer/module.hh>
+#include <string>
+
+namespace nntile
+{
+namespace layer
+{
+
+//! Elementwise activation: "relu", "gelu" or "gelutanh"
+template<typename T>
+class Act: public Module<T>
+{
+    enum Func {ReLU, GeLU, GeLUTanh};
+    Func func;
+public:
+    Moments<T> x, y;
+    Act(const Moments<T> &x_, const Moments<T> &y_,
+            const std::string &funcname);
+    void forward_async() const override;
+    void backward_async() const override;
+};
+
+// Explicit instantiations
+extern template
+class Act<fp32_t>;
+
+extern template
+class Act<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
@@ -0,0 +1,44 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/layer/add.hh
+ * Sum of two tensors
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/layer/module.hh>
+
+namespace nntile
+{
+namespace layer
+{
+
+//! Sum of two tensors of the same shape, e.g., a residual connection
+template<typename T>
+class Add: public Module<T>
+{
+public:
+    Moments<T> x, y, res;
+    Add(const Moments<T> &x_, const Moments<T> &y_, const Moments<T> &res_);
+    void forward_async() const override;
+    void backward_async() const override;
+};
+
+// Explicit instantiations
+extern template
+class Add<fp32_t>;
+
+extern template
+class Add<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
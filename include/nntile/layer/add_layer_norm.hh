@@ -0,0 +1,55 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/layer/add_layer_norm.hh
+ * Residual connection fused with layer normalization
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/layer/module.hh>
+
+namespace nntile
+{
+namespace layer
+{
+
+//! Residual sum res = x + r and its layer normalization y by fused kernels
+/*! The axis of normalization shall not be split into tiles.
+ * */
+template<typename T>
+class AddLayerNorm: public Module<T>
+{
+public:
+    Moments<T> x, r, res, y, gamma, beta;
+    tensor::Tensor<T> mean, inv_stddev;
+    Index axis;
+    T eps;
+    int redux;
+    AddLayerNorm(const Moments<T> &x_, const Moments<T> &r_,
+            const Moments<T> &res_, const Moments<T> &y_,
+            const Moments<T> &gamma_, const Moments<T> &beta_,
+            const tensor::Tensor<T> &mean_,
+            const tensor::Tensor<T> &inv_stddev_, Index axis_, T eps_,
+            int redux_=0);
+    void forward_async() const override;
+    void backward_async() const override;
+};
+
+// Explicit instantiations
+extern template
+class AddLayerNorm<fp32_t>;
+
+extern template
+class AddLayerNorm<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
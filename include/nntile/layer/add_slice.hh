@@ -0,0 +1,50 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/layer/add_slice.hh
+ * Sum of a tensor and a broadcasted slice
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/layer/module.hh>
+
+namespace nntile
+{
+namespace layer
+{
+
+//! Sum of a tensor and a slice, broadcasted along a given axis
+/*! Computes U = X + Y, where Y has no axis of X, e.g., positional
+ * embeddings, that are the same for all sequences of a batch.
+ * */
+template<typename T>
+class AddSlice: public Module<T>
+{
+public:
+    Moments<T> x, y, u;
+    Index axis;
+    int redux;
+    AddSlice(const Moments<T> &x_, const Moments<T> &y_, const Moments<T> &u_,
+            Index axis_, int redux_=0);
+    void forward_async() const override;
+    void backward_async() const override;
+};
+
+// Explicit instantiations
+extern template
+class AddSlice<fp32_t>;
+
+extern template
+class AddSlice<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
@@ -0,0 +1,81 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/layer/attention.hh
+ * Multi-head attention layer
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/layer/module.hh>
+#include <optional>
+
+namespace nntile
+{
+namespace layer
+{
+
+//! Multi-head attention with an explicit softmax matrix
+/*! Shapes of tensors are the same as of nntile.layer.Attention:
+ * X_Q, X_K, X_V and Y are (n_emb, n_seq, n_batch), W_Q, W_K and W_V are
+ * (n_head, head_size, n_emb), W is (n_emb, n_head, head_size), Q, K, V and
+ * B are (head_size, n_seq, n_batch, n_head) and A is (n_seq, n_seq,
+ * n_batch, n_head). Biases are optional, masked out elements of A are set
+ * to minus infinity before the softmax. KV-cache is not supported.
+ * */
+template<typename T>
+class Attention: public Module<T>
+{
+public:
+    Moments<T> x_q, x_k, x_v, y, w_q, w_k, w_v, w, q_transposed, q,
+        k_transposed, k, v_transposed, v, a, b, b_transposed;
+    tensor::Tensor<T> a_maxsumexp, a_sumprod_slice;
+    std::optional<Moments<T>> in_proj_bias_q, in_proj_bias_k,
+        in_proj_bias_v, out_proj_bias;
+    std::optional<tensor::Tensor<bool_t>> mask;
+    Index head_size;
+    int redux;
+    Attention(const Moments<T> &x_q_, const Moments<T> &x_k_,
+            const Moments<T> &x_v_, const Moments<T> &y_,
+            const Moments<T> &w_q_, const Moments<T> &w_k_,
+            const Moments<T> &w_v_, const Moments<T> &w_,
+            const Moments<T> &q_transposed_, const Moments<T> &q_,
+            const Moments<T> &k_transposed_, const Moments<T> &k_,
+            const Moments<T> &v_transposed_, const Moments<T> &v_,
+            const Moments<T> &a_, const tensor::Tensor<T> &a_maxsumexp_,
+            const tensor::Tensor<T> &a_sumprod_slice_, const Moments<T> &b_,
+            const Moments<T> &b_transposed_,
+            const std::optional<Moments<T>> &in_proj_bias_q_,
+            const std::optional<Moments<T>> &in_proj_bias_k_,
+            const std::optional<Moments<T>> &in_proj_bias_v_,
+            const std::optional<Moments<T>> &out_proj_bias_,
+            const std::optional<tensor::Tensor<bool_t>> &mask_,
+            int redux_=0);
+    void forward_async() const override;
+    void backward_async() const override;
+protected:
+    //! B is kept after the forward pass, if backward_attend_async reads it
+    bool keep_b = false;
+    //! Get B out of Q, K and V
+    virtual void attend_async() const;
+    //! Get gradients of Q, K and V out of gradient of B
+    virtual void backward_attend_async() const;
+};
+
+// Explicit instantiations
+extern template
+class Attention<fp32_t>;
+
+extern template
+class Attention<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
@@ -0,0 +1,63 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/layer/dense.hh
+ * Fully connected layer with an optional bias
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/layer/module.hh>
+#include <nntile/constants.hh>
+#include <optional>
+
+namespace nntile
+{
+namespace layer
+{
+
+//! Fully connected layer with an optional bias
+/*! Computes Y = op(X) W + b for side 'L' and Y = W op(X) + b for side
+ * 'R', where products are over ndim axes. Gradients over X, W and b are
+ * computed only if x_grad_required, w_grad_required and b_grad_required are
+ * set correspondingly, e.g., for frozen parameters. Gradients, that are not
+ * required, are neither read nor written, so they may be placeholders.
+ * */
+template<typename T>
+class Dense: public Module<T>
+{
+public:
+    char side;
+    TransOp trans_x;
+    Moments<T> x, y, w;
+    std::optional<Moments<T>> b;
+    Index ndim;
+    bool x_grad_required;
+    int redux;
+    bool w_grad_required, b_grad_required;
+    Dense(char side_, const TransOp &trans_x_, const Moments<T> &x_,
+            const Moments<T> &y_, const Moments<T> &w_,
+            const std::optional<Moments<T>> &b_, Index ndim_,
+            bool x_grad_required_=true, int redux_=0,
+            bool w_grad_required_=true, bool b_grad_required_=true);
+    void forward_async() const override;
+    void backward_async() const override;
+};
+
+// Explicit instantiations
+extern template
+class Dense<fp32_t>;
+
+extern template
+class Dense<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
@@ -0,0 +1,54 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/layer/embedding.hh
+ * Embedding layer
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/layer/module.hh>
+#include <optional>
+
+namespace nntile
+{
+namespace layer
+{
+
+//! Embeddings of tokens, that are columns of a vocabulary
+/*! Output Y gets a new axis of embeddings at the position axis of input ids
+ * X, W is (emb_size, vocab_size). If rows is provided, backward also marks
+ * rows of the vocabulary, used by tokens, for a sparse update.
+ * */
+template<typename T>
+class Embedding: public Module<T>
+{
+public:
+    tensor::Tensor<Index> x;
+    Moments<T> y, w;
+    Index axis;
+    std::optional<tensor::Tensor<bool_t>> rows;
+    Embedding(const tensor::Tensor<Index> &x_, const Moments<T> &y_,
+            const Moments<T> &w_, Index axis_,
+            const std::optional<tensor::Tensor<bool_t>> &rows_={});
+    void forward_async() const override;
+    void backward_async() const override;
+};
+
+// Explicit instantiations
+extern template
+class Embedding<fp32_t>;
+
+extern template
+class Embedding<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
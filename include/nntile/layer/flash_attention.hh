@@ -0,0 +1,72 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/layer/flash_attention.hh
+ * Multi-head attention layer with flash-like softmax
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/layer/attention.hh>
+#include <nntile/tensor/mask_tiles.hh>
+
+namespace nntile
+{
+namespace layer
+{
+
+//! Multi-head attention, that never stores the whole softmax matrix
+/*! Tensors are the same as of Attention, but the mask is required. If fused
+ * is set, single-pass kernels with an online softmax get B right out of Q,
+ * K and V and recompute attention weights in the backward pass, so A is not
+ * touched at all. Otherwise, softmax and its product with V are computed
+ * tile by tile with A used only as a temporary buffer. Dropout of attention
+ * weights is not supported. Pairs of tiles of keys and queries are skipped
+ * by the block-sparse layout of the mask, that is read from the mask on every
+ * call, unless mask_layout is set once, e.g. for a sliding window.
+ * */
+template<typename T>
+class FlashAttention: public Attention<T>
+{
+public:
+    bool fused;
+    // Block-sparse layout of mask, see tensor::mask_layout()
+    std::vector<tensor::MaskTile> mask_layout;
+    FlashAttention(const Moments<T> &x_q_, const Moments<T> &x_k_,
+            const Moments<T> &x_v_, const Moments<T> &y_,
+            const Moments<T> &w_q_, const Moments<T> &w_k_,
+            const Moments<T> &w_v_, const Moments<T> &w_,
+            const Moments<T> &q_transposed_, const Moments<T> &q_,
+            const Moments<T> &k_transposed_, const Moments<T> &k_,
+            const Moments<T> &v_transposed_, const Moments<T> &v_,
+            const Moments<T> &a_, const tensor::Tensor<T> &a_maxsumexp_,
+            const tensor::Tensor<T> &a_sumprod_slice_, const Moments<T> &b_,
+            const Moments<T> &b_transposed_,
+            const std::optional<Moments<T>> &in_proj_bias_q_,
+            const std::optional<Moments<T>> &in_proj_bias_k_,
+            const std::optional<Moments<T>> &in_proj_bias_v_,
+            const std::optional<Moments<T>> &out_proj_bias_,
+            const tensor::Tensor<bool_t> &mask_, bool fused_=false,
+            int redux_=0);
+protected:
+    void attend_async() const override;
+    void backward_attend_async() const override;
+};
+
+// Explicit instantiations
+extern template
+class FlashAttention<fp32_t>;
+
+extern template
+class FlashAttention<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
@@ -0,0 +1,52 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/layer/layer_norm.hh
+ * Layer normalization by fused kernels
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/layer/module.hh>
+
+namespace nntile
+{
+namespace layer
+{
+
+//! Layer normalization along a single axis, that is not split into tiles
+template<typename T>
+class LayerNorm: public Module<T>
+{
+public:
+    Moments<T> x, y, gamma, beta;
+    tensor::Tensor<T> mean, inv_stddev;
+    Index axis;
+    T eps;
+    int redux;
+    LayerNorm(const Moments<T> &x_, const Moments<T> &y_,
+            const Moments<T> &gamma_, const Moments<T> &beta_,
+            const tensor::Tensor<T> &mean_,
+            const tensor::Tensor<T> &inv_stddev_, Index axis_, T eps_,
+            int redux_=0);
+    void forward_async() const override;
+    void backward_async() const override;
+};
+
+// Explicit instantiations
+extern template
+class LayerNorm<fp32_t>;
+
+extern template
+class LayerNorm<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
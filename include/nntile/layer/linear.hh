@@ -23,19 +23,29 @@ namespace layer
 {
 
 //! Linear layer
+/*! Gradients over weight and over input are computed only if
+ * weight_grad_required and input_grad_required are set correspondingly,
+ * e.g., for frozen weights or for the first layer of a model.
+ * */
 template<typename T>
 class Linear: public Base<T>
 {
 public:
     tensor::Tensor<T> &weight;
     tensor::Tensor<T> &grad_weight;
+    bool weight_grad_required;
+    bool input_grad_required;
     Linear(const tensor::TensorTraits &input_traits_,
             const tensor::TensorTraits &output_traits_,
             tensor::Tensor<T> params_,
-            tensor::Tensor<T> grads_):
+            tensor::Tensor<T> grads_,
+            bool weight_grad_required_=true,
+            bool input_grad_required_=true):
         Base<T>(input_traits_, output_traits_, {params_}, {grads_}),
         weight(this->params[0]),
-        grad_weight(this->grads[0])
+        grad_weight(this->grads[0]),
+        weight_grad_required(weight_grad_required_),
+        input_grad_required(input_grad_required_)
     {
     }
     virtual ~Linear() = default;
@@ -54,11 +64,18 @@ public:
     {
         constexpr T one = 1, zero = 0;
         constexpr TransOp opN(TransOp::NoTrans), opT(TransOp::Trans);
-        tensor::gemm_async<T>(one, opN, input, opT, forward_input, zero,
-                grad_weight, 1);
+        if(weight_grad_required)
+        {
+            tensor::gemm_async<T>(one, opN, input, opT, forward_input, zero,
+                    grad_weight, 1);
+        }
         forward_input.invalidate_submit();
-        tensor::gemm_async<T>(one, opT, weight, opN, input, zero, output, 1);
-        weight.wont_use();
+        if(input_grad_required)
+        {
+            tensor::gemm_async<T>(one, opT, weight, opN, input, zero, output,
+                    1);
+            weight.wont_use();
+        }
         input.invalidate_submit();
     }
 };
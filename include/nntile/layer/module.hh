@@ -0,0 +1,52 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/layer/module.hh
+ * Layer, that submits its forward and backward passes on its own tensors
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace layer
+{
+
+//! Value of a tensor and its gradient
+template<typename T>
+struct Moments
+{
+    tensor::Tensor<T> value;
+    tensor::Tensor<T> grad;
+};
+
+//! Common API of layers, that own references to all their tensors
+/*! Unlike Base, inputs, outputs, parameters, their gradients and temporaries
+ * are provided at construction, so a layer submits all its tasks by a
+ * single call without any arguments. Tensors are shared with the Python
+ * layers, that created them, and every layer submits the same tasks as
+ * its Python counterpart. Gradients of inputs and parameters are
+ * accumulated.
+ * */
+template<typename T>
+class Module
+{
+public:
+    // Destructor is virtual since this is a base class for all layers
+    virtual ~Module() = default;
+    virtual void forward_async() const = 0;
+    virtual void backward_async() const = 0;
+};
+
+} // namespace layer
+} // namespace nntile
+
@@ -0,0 +1,51 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/layer/rms_norm.hh
+ * Root mean square layer normalization
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/layer/module.hh>
+
+namespace nntile
+{
+namespace layer
+{
+
+//! Root mean square layer normalization along a single axis, that is not
+//! split into tiles
+template<typename T>
+class RMSNorm: public Module<T>
+{
+public:
+    Moments<T> x, y, gamma;
+    tensor::Tensor<T> inv_rms;
+    Index axis;
+    T eps;
+    int redux;
+    RMSNorm(const Moments<T> &x_, const Moments<T> &y_,
+            const Moments<T> &gamma_, const tensor::Tensor<T> &inv_rms_,
+            Index axis_, T eps_, int redux_=0);
+    void forward_async() const override;
+    void backward_async() const override;
+};
+
+// Explicit instantiations
+extern template
+class RMSNorm<fp32_t>;
+
+extern template
+class RMSNorm<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
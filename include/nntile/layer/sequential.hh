@@ -0,0 +1,63 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/layer/sequential.hh
+ * Chain of layers, that is submitted by a single call
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/layer/module.hh>
+#include <memory>
+
+namespace nntile
+{
+namespace layer
+{
+
+//! Chain of layers, that is submitted by a single call
+/*! Python layers with a C++ counterpart are collected into a chain, so a
+ * forward or a backward pass of the whole chain, e.g., of all the
+ * transformer blocks of a model, is submitted from C++ without the Python
+ * interpreter, and Python wrappers release the GIL meanwhile.
+ * */
+template<typename T>
+class Sequential
+{
+public:
+    std::vector<std::shared_ptr<Module<T>>> layers;
+    explicit Sequential(const std::vector<std::shared_ptr<Module<T>>>
+            &layers_={}):
+        layers(layers_)
+    {
+    }
+    void append(const std::shared_ptr<Module<T>> &layer)
+    {
+        layers.push_back(layer);
+    }
+    void forward_async() const;
+    //! Backward of layers in reverse order
+    /*! Tasks of the i-th layer get priority first_priority+i, the same as
+     * tasks of the Python model, and priority of submitted tasks is
+     * restored at the end.
+     * */
+    void backward_async(int first_priority) const;
+};
+
+// Explicit instantiations
+extern template
+class Sequential<fp32_t>;
+
+extern template
+class Sequential<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
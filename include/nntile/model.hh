@@ -14,7 +14,8 @@
 
 #pragma once
 
-#include <nntile/model/deep_linear.hh>
+//#include <nntile/model/deep_linear.hh>
+#include <nntile/model/gpt2.hh>
 
 namespace nntile
 {
@@ -60,8 +60,9 @@ class DeepLinear: public Base<T>
                     traits.grid.shape, mpi_grid, 0, mpi_size);
             tensor::Tensor<T> weight(traits, distr, last_tag),
                 grad_weight(traits, distr, last_tag);
+            // Input of the first layer does not require gradient
             auto layer = new layer::Linear<T>(input_traits, output_traits,
-                    {weight}, {grad_weight});
+                    {weight}, {grad_weight}, true, i > 0);
             layers.push_back(std::shared_ptr<layer::Base<T>>(layer));
         }
         return layers;
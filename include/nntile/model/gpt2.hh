@@ -0,0 +1,97 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/model/gpt2.hh
+ * GPT2 model, that is submitted from C++
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/layer.hh>
+#include <string>
+
+namespace nntile
+{
+namespace model
+{
+
+//! Hyperparameters of GPT2 model, the same as of nntile.model.gpt2
+struct GPT2Config
+{
+    Index vocab_size;
+    Index vocab_embed_dim_tile;
+    Index embed_dim;
+    Index embed_dim_tile;
+    Index max_position_embeddings;
+    Index inner_dim;
+    Index inner_dim_tile;
+    double layer_norm_epsilon;
+    Index num_hidden_layers;
+    Index n_head;
+    Index n_head_tile;
+    std::string activation_function;
+    bool flashattention = true;
+    bool flashattention_fused = false;
+    int redux = 0;
+};
+
+//! GPT2 language model, that allocates and owns all its tensors
+/*! Layers and shapes of tensors are the same as of
+ * nntile.model.gpt2.GPT2Model without KV-cache, dropout and parallelism,
+ * and all tiles are owned by MPI node 0. Parameters are stored in the order
+ * of GPT2Model.parameters, so values of a Python model are loaded by their
+ * indices. Positional ids and the causal mask are set at construction, ids
+ * of tokens shall be set before every forward pass. Layer normalization
+ * requires embed_dim_tile to be equal to embed_dim.
+ * */
+template<typename T>
+class GPT2
+{
+public:
+    GPT2Config config;
+    //! Ids of tokens of shape (seq_len, batch_size)
+    tensor::Tensor<Index> input_ids;
+    //! Positions of tokens of shape (seq_len)
+    tensor::Tensor<Index> positional_ids;
+    //! Causal mask of shape (seq_len, seq_len)
+    tensor::Tensor<bool_t> mask;
+    //! Parameters in the order of the Python model
+    std::vector<layer::Moments<T>> params;
+    //! Outputs of layers, the last one is logits of shape (vocab_size,
+    //! seq_len, batch_size)
+    std::vector<layer::Moments<T>> activations;
+    //! Temporary tensors of layers
+    std::vector<tensor::Tensor<T>> tmps;
+    layer::Sequential<T> layers;
+    GPT2(const GPT2Config &config_, Index seq_len, Index seq_len_tile,
+            Index batch_size, Index batch_size_tile,
+            starpu_mpi_tag_t &last_tag);
+    void forward_async() const
+    {
+        layers.forward_async();
+    }
+    //! Backward pass with the same priorities of tasks as of the Python
+    //! model
+    void backward_async() const;
+    //! Clear gradients of parameters and activations
+    void clear_gradients_async() const;
+    void unregister();
+};
+
+// Explicit instantiations
+extern template
+class GPT2<fp32_t>;
+
+extern template
+class GPT2<fp64_t>;
+
+} // namespace model
+} // namespace nntile
+
@@ -19,6 +19,9 @@
 // StarPU wrappers for data handles and config
 #include <nntile/starpu/config.hh>
 
+// Pool of threads, that submit tasks of tensor operations
+#include <nntile/starpu/submitters.hh>
+
 // StarPU wrappers for low-level kernels
 #include <nntile/starpu/accumulate.hh>
 #include <nntile/starpu/accumulate_hypot.hh>
@@ -38,20 +41,28 @@
 #include <nntile/starpu/dgelu.hh>
 #include <nntile/starpu/dgelutanh.hh>
 #include <nntile/starpu/drelu.hh>
+#include <nntile/starpu/dropout.hh>
 #include <nntile/starpu/gemm.hh>
 #include <nntile/starpu/gemm_ex.hh>
 #include <nntile/starpu/hypot.hh>
 #include <nntile/starpu/hypot_scalar_inverse.hh>
 #include <nntile/starpu/nrm2.hh>
+#include <nntile/starpu/moe_combine.hh>
+#include <nntile/starpu/moe_combine_backward.hh>
+#include <nntile/starpu/moe_dispatch.hh>
+#include <nntile/starpu/moe_route.hh>
 #include <nntile/starpu/normalize.hh>
 #include <nntile/starpu/prod.hh>
 #include <nntile/starpu/randn.hh>
+#include <nntile/starpu/randn_philox.hh>
 #include <nntile/starpu/relu.hh>
 #include <nntile/starpu/relu_forward.hh>
 #include <nntile/starpu/relu_backward.hh>
+#include <nntile/starpu/rope.hh>
 #include <nntile/starpu/subcopy.hh>
 #include <nntile/starpu/sumnorm.hh>
 #include <nntile/starpu/fill.hh>
+#include <nntile/starpu/fill_padding.hh>
 #include <nntile/starpu/sum_slice.hh>
 #include <nntile/starpu/sum_fiber.hh>
 #include <nntile/starpu/norm_slice.hh>
@@ -59,9 +70,13 @@
 #include <nntile/starpu/flash_maxsumexp.hh>
 #include <nntile/starpu/maxsumexp.hh>
 #include <nntile/starpu/softmax.hh>
+#include <nntile/starpu/softmax_crossentropy.hh>
 #include <nntile/starpu/flash_softmax_gemm.hh>
 #include <nntile/starpu/flash_softmax_gemm_backward_sumprod_slice.hh>
 #include <nntile/starpu/flash_softmax_gemm_backward_dq_dk.hh>
+#include <nntile/starpu/flash_attention.hh>
+#include <nntile/starpu/flash_attention_backward.hh>
+#include <nntile/starpu/flash_attention_dequant.hh>
 #include <nntile/starpu/softmax_inplace.hh>
 #include <nntile/starpu/sqrt.hh>
 #include <nntile/starpu/sqrt_inplace.hh>
@@ -81,14 +96,49 @@
 #include <nntile/starpu/add_scalar.hh>
 #include <nntile/starpu/embedding.hh>
 #include <nntile/starpu/embedding_backward.hh>
+#include <nntile/starpu/embedding_rows.hh>
 #include <nntile/starpu/fp32_to_fp16.hh>
 #include <nntile/starpu/fp16_to_fp32.hh>
+#include <nntile/starpu/fp32_to_bf16.hh>
+#include <nntile/starpu/bf16_to_fp32.hh>
 #include <nntile/starpu/mask_scalar.hh>
 #include <nntile/starpu/adam_step.hh>
+#include <nntile/starpu/sparse_adam_step.hh>
 #include <nntile/starpu/adamw_step.hh>
+#include <nntile/starpu/multi_adam_step.hh>
+#include <nntile/starpu/sgd_step.hh>
+#include <nntile/starpu/adafactor_step.hh>
+#include <nntile/starpu/quantized_adam_step.hh>
+#include <nntile/starpu/clip_scale.hh>
+#include <nntile/starpu/fused_elementwise.hh>
+#include <nntile/starpu/layer_norm.hh>
+#include <nntile/starpu/layer_norm_backward.hh>
+#include <nntile/starpu/add_layer_norm.hh>
+#include <nntile/starpu/add_layer_norm_backward.hh>
+#include <nntile/starpu/rms_norm.hh>
+#include <nntile/starpu/rms_norm_backward.hh>
+#include <nntile/starpu/swiglu.hh>
+#include <nntile/starpu/swiglu_backward.hh>
+#include <nntile/starpu/embedding_pos.hh>
+#include <nntile/starpu/embedding_pos_backward.hh>
+#include <nntile/starpu/softmax_online.hh>
+#include <nntile/starpu/bias_gelutanh.hh>
+#include <nntile/starpu/bias_gelutanh_backward.hh>
+#include <nntile/starpu/gemm_bias_gelutanh.hh>
+#include <nntile/starpu/quantize.hh>
+#include <nntile/starpu/gemm_dequant.hh>
+#include <nntile/starpu/topk.hh>
+#include <nntile/starpu/topk_sample.hh>
+#include <nntile/starpu/tile_io.hh>
 #include <nntile/starpu/transpose.hh>
 #include <nntile/starpu/strassen.hh>
+#include <nntile/starpu/gemm_grouped.hh>
 #include <nntile/starpu/conv2d.hh>
+#include <nntile/starpu/conv2d_backward_input.hh>
+#include <nntile/starpu/conv2d_backward_weight.hh>
+#include <nntile/starpu/batch_norm_act.hh>
+#include <nntile/starpu/batch_norm_act_backward.hh>
+#include <nntile/starpu/batch_norm_backward.hh>
 
 namespace nntile
 {
@@ -119,29 +169,40 @@ void init()
     dgelu::init();
     dgelutanh::init();
     drelu::init();
+    dropout::init();
     gemm::init();
-    gemm_ex::init();
     hypot::init();
     hypot_scalar_inverse::init();
     nrm2::init();
+    moe_combine::init();
+    moe_combine_backward::init();
+    moe_dispatch::init();
+    moe_route::init();
     normalize::init();
     randn::init();
+    randn_philox::init();
     relu::init();
     relu_forward::init();
     relu_backward::init();
+    rope::init();
     prod::init();
     subcopy::init();
     sumnorm::init();
     fill::init();
+    fill_padding::init();
     sum_slice::init();
     sum_fiber::init();
     norm_slice::init();
     pow::init();
     softmax::init();
+    softmax_crossentropy::init();
     softmax_inplace::init();
     flash_softmax_gemm::init();
     flash_softmax_gemm_backward_sumprod_slice::init();
     flash_softmax_gemm_backward_dq_dk::init();
+    flash_attention::init();
+    flash_attention_backward::init();
+    flash_attention_dequant::init();
     flash_maxsumexp::init();
     maxsumexp::init();
     sqrt::init();
@@ -162,14 +223,49 @@ void init()
     add_scalar::init();
     embedding::init();
     embedding_backward::init();
+    embedding_rows::init();
     fp32_to_fp16::init();
     fp16_to_fp32::init();
+    fp32_to_bf16::init();
+    bf16_to_fp32::init();
     mask_scalar::init();
     adam_step::init();
+    sparse_adam_step::init();
     adamw_step::init();
+    multi_adam_step::init();
+    sgd_step::init();
+    adafactor_step::init();
+    quantized_adam_step::init();
+    clip_scale::init();
+    fused_elementwise::init();
+    layer_norm::init();
+    layer_norm_backward::init();
+    add_layer_norm::init();
+    add_layer_norm_backward::init();
+    rms_norm::init();
+    rms_norm_backward::init();
+    swiglu::init();
+    swiglu_backward::init();
+    embedding_pos::init();
+    embedding_pos_backward::init();
+    softmax_online::init();
+    bias_gelutanh::init();
+    bias_gelutanh_backward::init();
+    gemm_bias_gelutanh::init();
+    quantize::init();
+    gemm_dequant::init();
+    topk::init();
+    topk_sample::init();
+    tile_io::init();
     transpose::init();
     strassen::init();
+    gemm_grouped::init();
     conv2d::init();
+    conv2d_backward_input::init();
+    conv2d_backward_weight::init();
+    batch_norm_act::init();
+    batch_norm_act_backward::init();
+    batch_norm_backward::init();
 }
 
 // Restrict StarPU codelets to certain computational units
@@ -193,29 +289,40 @@ void restrict_where(uint32_t where)
     dgelu::restrict_where(where);
     dgelutanh::restrict_where(where);
     drelu::restrict_where(where);
+    dropout::restrict_where(where);
     gemm::restrict_where(where);
-    gemm_ex::restrict_where(where);
     hypot::restrict_where(where);
     hypot_scalar_inverse::restrict_where(where);
     nrm2::restrict_where(where);
+    moe_combine::restrict_where(where);
+    moe_combine_backward::restrict_where(where);
+    moe_dispatch::restrict_where(where);
+    moe_route::restrict_where(where);
     normalize::restrict_where(where);
     prod::restrict_where(where);
     randn::restrict_where(where);
+    randn_philox::restrict_where(where);
     relu::restrict_where(where);
     relu_forward::restrict_where(where);
     relu_backward::restrict_where(where);
+    rope::restrict_where(where);
     subcopy::restrict_where(where);
     sumnorm::restrict_where(where);
     fill::restrict_where(where);
+    fill_padding::restrict_where(where);
     sum_slice::restrict_where(where);
     sum_fiber::restrict_where(where);
     norm_slice::restrict_where(where);
     pow::restrict_where(where);
     softmax::restrict_where(where);
+    softmax_crossentropy::restrict_where(where);
     softmax_inplace::restrict_where(where);
     flash_softmax_gemm::restrict_where(where);
     flash_softmax_gemm_backward_sumprod_slice::restrict_where(where);
     flash_softmax_gemm_backward_dq_dk::restrict_where(where);
+    flash_attention::restrict_where(where);
+    flash_attention_backward::restrict_where(where);
+    flash_attention_dequant::restrict_where(where);
     flash_maxsumexp::restrict_where(where);
     maxsumexp::restrict_where(where);
     sqrt::restrict_where(where);
@@ -235,14 +342,49 @@ void restrict_where(uint32_t where)
     add_scalar::restrict_where(where);
     embedding::restrict_where(where);
     embedding_backward::restrict_where(where);
+    embedding_rows::restrict_where(where);
     fp32_to_fp16::restrict_where(where);
     fp16_to_fp32::restrict_where(where);
+    fp32_to_bf16::restrict_where(where);
+    bf16_to_fp32::restrict_where(where);
     mask_scalar::restrict_where(where);
     adam_step::restrict_where(where);
+    sparse_adam_step::restrict_where(where);
     adamw_step::restrict_where(where);
+    multi_adam_step::restrict_where(where);
+    sgd_step::restrict_where(where);
+    adafactor_step::restrict_where(where);
+    quantized_adam_step::restrict_where(where);
+    clip_scale::restrict_where(where);
+    fused_elementwise::restrict_where(where);
+    layer_norm::restrict_where(where);
+    layer_norm_backward::restrict_where(where);
+    add_layer_norm::restrict_where(where);
+    add_layer_norm_backward::restrict_where(where);
+    rms_norm::restrict_where(where);
+    rms_norm_backward::restrict_where(where);
+    swiglu::restrict_where(where);
+    swiglu_backward::restrict_where(where);
+    embedding_pos::restrict_where(where);
+    embedding_pos_backward::restrict_where(where);
+    softmax_online::restrict_where(where);
+    bias_gelutanh::restrict_where(where);
+    bias_gelutanh_backward::restrict_where(where);
+    gemm_bias_gelutanh::restrict_where(where);
+    quantize::restrict_where(where);
+    gemm_dequant::restrict_where(where);
+    topk::restrict_where(where);
+    topk_sample::restrict_where(where);
+    tile_io::restrict_where(where);
     transpose::restrict_where(where);
     strassen::restrict_where(where);
+    gemm_grouped::restrict_where(where);
     conv2d::restrict_where(where);
+    conv2d_backward_input::restrict_where(where);
+    conv2d_backward_weight::restrict_where(where);
+    batch_norm_act::restrict_where(where);
+    batch_norm_act_backward::restrict_where(where);
+    batch_norm_backward::restrict_where(where);
 }
 
 // Restore computational units for StarPU codelets
@@ -266,29 +408,40 @@ void restore_where()
     dgelu::restore_where();
     dgelutanh::restore_where();
     drelu::restore_where();
+    dropout::restore_where();
     gemm::restore_where();
-    gemm_ex::restore_where();
     hypot::restore_where();
     hypot_scalar_inverse::restore_where();
     nrm2::restore_where();
+    moe_combine::restore_where();
+    moe_combine_backward::restore_where();
+    moe_dispatch::restore_where();
+    moe_route::restore_where();
     normalize::restore_where();
     prod::restore_where();
     randn::restore_where();
+    randn_philox::restore_where();
     relu::restore_where();
     relu_forward::restore_where();
     relu_backward::restore_where();
+    rope::restore_where();
     subcopy::restore_where();
     sumnorm::restore_where();
     fill::restore_where();
+    fill_padding::restore_where();
     sum_slice::restore_where();
     sum_fiber::restore_where();
     norm_slice::restore_where();
     pow::restore_where();
     softmax::restore_where();
+    softmax_crossentropy::restore_where();
     softmax_inplace::restore_where();
     flash_softmax_gemm::restore_where();
     flash_softmax_gemm_backward_sumprod_slice::restore_where();
     flash_softmax_gemm_backward_dq_dk::restore_where();
+    flash_attention::restore_where();
+    flash_attention_backward::restore_where();
+    flash_attention_dequant::restore_where();
     flash_maxsumexp::restore_where();
     maxsumexp::restore_where();
     sqrt::restore_where();
@@ -308,14 +461,49 @@ void restore_where()
     add_scalar::restore_where();
     embedding::restore_where();
     embedding_backward::restore_where();
+    embedding_rows::restore_where();
     fp32_to_fp16::restore_where();
     fp16_to_fp32::restore_where();
+    fp32_to_bf16::restore_where();
+    bf16_to_fp32::restore_where();
     mask_scalar::restore_where();
     adam_step::restore_where();
+    sparse_adam_step::restore_where();
     adamw_step::restore_where();
+    multi_adam_step::restore_where();
+    sgd_step::restore_where();
+    adafactor_step::restore_where();
+    quantized_adam_step::restore_where();
+    clip_scale::restore_where();
+    fused_elementwise::restore_where();
+    layer_norm::restore_where();
+    layer_norm_backward::restore_where();
+    add_layer_norm::restore_where();
+    add_layer_norm_backward::restore_where();
+    rms_norm::restore_where();
+    rms_norm_backward::restore_where();
+    swiglu::restore_where();
+    swiglu_backward::restore_where();
+    embedding_pos::restore_where();
+    embedding_pos_backward::restore_where();
+    softmax_online::restore_where();
+    bias_gelutanh::restore_where();
+    bias_gelutanh_backward::restore_where();
+    gemm_bias_gelutanh::restore_where();
+    quantize::restore_where();
+    gemm_dequant::restore_where();
+    topk::restore_where();
+    topk_sample::restore_where();
+    tile_io::restore_where();
     transpose::restore_where();
     strassen::restore_where();
+    gemm_grouped::restore_where();
     conv2d::restore_where();
+    conv2d_backward_input::restore_where();
+    conv2d_backward_weight::restore_where();
+    batch_norm_act::restore_where();
+    batch_norm_act_backward::restore_where();
+    batch_norm_backward::restore_where();
 }
 
 } // namespace starpu
@@ -65,7 +65,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Handle src, Handle dst);
+void submit(HandleRef src, HandleRef dst);
 
 } // namespace accumulate_maxsumexp
 } // namespace starpu
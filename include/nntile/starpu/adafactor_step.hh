@@ -0,0 +1,89 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/adafactor_step.hh
+ * Fused Adafactor step with StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace adafactor_step
+{
+
+//! Structure for arguments
+template<typename T>
+struct args_t
+{
+    Index num_iter;
+    Index m;
+    Index k;
+    Index n;
+    T beta_2;
+    T eps;
+    T lr;
+    T weight_decay;
+    bool factored;
+};
+
+// Apply Adafactor step to StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// Apply Adafactor step to StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet_fp32, codelet_fp64;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T>
+void submit(Index num_iter, Index m, Index k, Index n, T beta_2, T eps,
+        T lr, T weight_decay, HandleRef row, HandleRef col, HandleRef mean,
+        HandleRef grad, HandleRef p);
+
+} // namespace adafactor_step
+} // namespace starpu
+} // namespace nntile
+
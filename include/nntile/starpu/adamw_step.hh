@@ -79,7 +79,8 @@ void restore_where();
 
 template<typename T>
 void submit(Index num_iter, Index num_elems, T beta_1, T beta_2, T eps, T lr, T weight_decay,
-            Handle grad, Handle first_moment, Handle second_moment, Handle p);
+            HandleRef grad, HandleRef first_moment, HandleRef second_moment,
+            HandleRef p);
 
 } // namespace adamw_step
 } // namespace starpu
@@ -53,7 +53,7 @@ void cuda(void *buffers[], void *cl_args)
     noexcept;
 #endif // NNTILE_USE_CUDA
 
-extern Codelet codelet_fp32, codelet_fp64;
+extern Codelet codelet_fp32, codelet_fp64, codelet_bf16, codelet_fp16;
 
 template<typename T>
 constexpr Codelet *codelet()
@@ -74,6 +74,18 @@ constexpr Codelet *codelet<fp64_t>()
     return &codelet_fp64;
 }
 
+template<>
+constexpr Codelet *codelet<bf16_t>()
+{
+    return &codelet_bf16;
+}
+
+template<>
+constexpr Codelet *codelet<fp16_t>()
+{
+    return &codelet_fp16;
+}
+
 void init();
 
 void restrict_where(uint32_t where);
@@ -81,7 +93,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index nelems, T alpha, Handle src, T beta, Handle dst);
+void submit(Index nelems, T alpha, HandleRef src, T beta, HandleRef dst);
 
 } // namespace add
 } // namespace starpu
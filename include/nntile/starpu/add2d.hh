@@ -72,8 +72,9 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template <typename T>
-void submit(Index nx, Index ny, T alpha, Handle src, Index offset_src,
-            Index ld_src, T beta, Handle dst, Index offset_dst, Index ld_dst);
+void submit(Index nx, Index ny, T alpha, HandleRef src, Index offset_src,
+            Index ld_src, T beta, HandleRef dst, Index offset_dst,
+            Index ld_dst);
 
 } // namespace add2d
 } // namespace starpu
@@ -70,8 +70,8 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index m, Index n, Index k, Index batch, T alpha, Handle src,
-        T beta, Handle dst);
+void submit(Index m, Index n, Index k, Index batch, T alpha, HandleRef src,
+        T beta, HandleRef dst);
 
 } // namespace add_fiber
 } // namespace starpu
@@ -81,7 +81,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index num_elements, T alpha, T beta, Handle dst);
+void submit(Index num_elements, T alpha, T beta, HandleRef dst);
 
 } // namespace add_scalar
 } // namespace starpu
@@ -17,6 +17,7 @@
 #include <nntile/base_types.hh>
 #include <nntile/starpu/config.hh>
 #include <nntile/defs.h>
+#include <vector>
 
 namespace nntile
 {
@@ -32,6 +33,8 @@ struct args_t
     Index m;
     Index n;
     Index k;
+    //! Number of destination tiles of the same shape
+    Index ndst;
     T alpha;
     T beta;
 };
@@ -76,8 +79,12 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index m, Index n, Index k, T alpha, Handle src, T beta,
-        Handle dst);
+void submit(Index m, Index n, Index k, T alpha, HandleRef src, T beta,
+        HandleRef dst);
+
+template<typename T>
+void submit(Index m, Index n, Index k, T alpha, HandleRef src, T beta,
+        const std::vector<Handle> &dst);
 
 } // namespace add_slice
 } // namespace starpu
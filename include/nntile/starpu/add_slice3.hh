@@ -76,8 +76,8 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index m, Index n, Index k, T alpha, Handle src1, T beta,
-        Handle src2, Handle dst);
+void submit(Index m, Index n, Index k, T alpha, HandleRef src1, T beta,
+        HandleRef src2, HandleRef dst);
 
 } // namespace add_slice3
 } // namespace starpu
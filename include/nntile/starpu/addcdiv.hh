@@ -74,7 +74,8 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(T val, T eps, Index nelems, Handle nom, Handle denom, Handle src);
+void submit(T val, T eps, Index nelems, HandleRef nom, HandleRef denom,
+        HandleRef src);
 
 } // namespace addcdiv
 } // namespace starpu
@@ -103,10 +103,10 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Handle alpha, Index nelems, Handle src, Handle dst);
+void submit(HandleRef alpha, Index nelems, HandleRef src, HandleRef dst);
 
 template<typename T>
-void submit(T alpha, Index nelems, Handle src, Handle dst);
+void submit(T alpha, Index nelems, HandleRef src, HandleRef dst);
 
 } // namespace axpy
 } // namespace starpu
@@ -0,0 +1,88 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/batch_norm_act_backward.hh
+ * Backward of an activation, that follows batch normalization, of StarPU
+ * buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <nntile/kernel/batch_norm_act/activation.hh>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace batch_norm_act_backward
+{
+
+using kernel::batch_norm_act::activation_t;
+
+//! Structure for arguments
+struct args_t
+{
+    Index m;
+    Index n;
+    Index k;
+    activation_t act;
+};
+
+// StarPU wrapper for kernel::batch_norm_act_backward::cpu<T>
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// StarPU wrapper for kernel::batch_norm_act_backward::cuda<T>
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet_fp32, codelet_fp64;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T>
+void submit(Index m, Index n, Index k, activation_t act, HandleRef src,
+        HandleRef mean, HandleRef inv_stddev, HandleRef gamma, HandleRef beta,
+        HandleRef dst_grad, HandleRef y_grad, HandleRef sum_grad,
+        HandleRef sum_grad_xhat, int redux=0);
+
+} // namespace batch_norm_act_backward
+} // namespace starpu
+} // namespace nntile
+
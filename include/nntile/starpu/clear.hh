@@ -43,7 +43,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 //! Insert task to clear buffer
-void submit(Handle data);
+void submit(HandleRef data);
 
 } // namespace clear
 } // namespace starpu
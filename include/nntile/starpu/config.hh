@@ -19,15 +19,44 @@
 #include <memory>
 #include <cstring>
 #include <iostream>
+#include <string>
+#include <cstdlib>
+#include <filesystem>
+#include <chrono>
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <type_traits>
+#include <climits>
+#include <cerrno>
+#include <tuple>
+#include <sys/mman.h>
 #include <starpu.h>
-// Disabled MPI for now
-//#include <starpu_mpi.h>
 #include <nntile/defs.h>
+#include <nntile/kernel/simd.hh>
+#include <nntile/starpu/scheduler.hh>
+#include <nntile/starpu/trace.hh>
+#include <nntile/starpu/offload.hh>
+#include <nntile/starpu/direct.hh>
+#include <nntile/starpu/transfer_dtype.hh>
+#ifdef NNTILE_USE_MPI
+#include <starpu_mpi.h>
+#endif // NNTILE_USE_MPI
+
+#ifndef NNTILE_USE_MPI
+// MPI tag type for a build without StarPU-MPI
+using starpu_mpi_tag_t = int64_t;
+#endif // NNTILE_USE_MPI
 
 namespace nntile
 {
 
-// Fake STARPU functions
+#ifndef NNTILE_USE_MPI
+// Fake STARPU-MPI functions for a single-process build
 #define MPI_COMM_WORLD 0
 
 static int starpu_mpi_world_size()
@@ -49,17 +78,507 @@ static int starpu_mpi_barrier(int comm)
 {
     return 0;
 }
+#endif // NNTILE_USE_MPI
 
 namespace starpu
 {
 
+//! Statistics of the pool of pinned memory
+struct HostMemoryPoolStats
+{
+    //! Number of allocations served from cached buffers
+    std::size_t nhits = 0;
+    //! Number of allocations served by new buffers
+    std::size_t nmisses = 0;
+    //! Total bytes of buffers currently in use
+    std::size_t used = 0;
+    //! Total bytes of cached free buffers
+    std::size_t cached = 0;
+    //! Total bytes of used and cached buffers backed by huge pages
+    std::size_t huge = 0;
+};
+
+//! Pool of pinned buffers in CPU RAM for StarPU-owned data handles
+/*! StarPU allocates buffers of data handles lazily, i.e., a buffer on a
+ * memory node appears only when data is written on or transferred to the
+ * node, and frees buffers of invalidated (see
+ * tensor::Tensor::invalidate_submit) and unregistered data. When the pool
+ * is enabled, StarPU allocates buffers of variables in CPU RAM through this
+ * pool. Buffers are allocated with STARPU_MALLOC_PINNED flag, so that
+ * transfers between CPU and CUDA devices do not go through staging buffers.
+ * Freed buffers are cached by memory nodes and size classes and reused by
+ * new allocations (e.g., temporaries of layers created at each step). Size
+ * classes have 4 steps per doubling of size, so that at most 25% of memory
+ * is wasted.
+ *
+ * Bandwidth-bound CPU kernels (e.g., adam_step, add, copy) over large
+ * tiles suffer from misses of TLB. If a huge page size (2 MB or 1 GB) is
+ * provided, buffers of at least 4 huge pages, that are multiples of the
+ * huge page by choice of size classes, are mapped with huge pages of
+ * hugetlbfs. If no huge pages are reserved in the system, such buffers are
+ * aligned to the huge page and advised to be backed by transparent huge
+ * pages. These buffers are pinned by starpu_memory_pin() and are counted
+ * by StarPU memory limits as the other ones.
+ * */
+class HostMemoryPool
+{
+private:
+    static constexpr int flags = STARPU_MALLOC_PINNED | STARPU_MALLOC_COUNT;
+    static inline std::mutex mutex;
+    static inline std::atomic<bool> enabled = false;
+    static inline std::size_t max_cached = 0;
+    static inline std::size_t huge_page_size = 0;
+    static inline HostMemoryPoolStats stats;
+    // Free buffers by memory nodes and size classes
+    static inline std::map<std::pair<unsigned, std::size_t>,
+           std::vector<uintptr_t>> free_buffers;
+    // Buffers in use with their size classes
+    static inline std::unordered_map<uintptr_t, std::size_t> used_buffers;
+    // Buffers, backed by huge pages, and whether they are mapped from
+    // hugetlbfs (otherwise they are transparent huge pages)
+    static inline std::unordered_map<uintptr_t, bool> huge_buffers;
+    // Allocation and deallocation of variables without the pool
+    static inline starpu_ssize_t (*allocate_default)(void *, unsigned) =
+        nullptr;
+    static inline void (*free_default)(void *, unsigned) = nullptr;
+    // Allocate a variable on a memory node, called by StarPU
+    static starpu_ssize_t _allocate_on_node(void *data_interface,
+            unsigned node)
+    {
+        if(not enabled or starpu_node_get_kind(node) != STARPU_CPU_RAM)
+        {
+            return allocate_default(data_interface, node);
+        }
+        auto var = reinterpret_cast<starpu_variable_interface *>(
+                data_interface);
+        uintptr_t ptr = allocate(node, var->elemsize);
+        if(ptr == 0)
+        {
+            return -ENOMEM;
+        }
+        var->ptr = ptr;
+        var->dev_handle = ptr;
+        var->offset = 0;
+        return var->elemsize;
+    }
+    // Free a variable on a memory node, called by StarPU
+    static void _free_on_node(void *data_interface, unsigned node)
+    {
+        auto var = reinterpret_cast<starpu_variable_interface *>(
+                data_interface);
+        if(not release(node, var->ptr))
+        {
+            free_default(data_interface, node);
+        }
+    }
+    // Allocate a buffer backed by huge pages, returns 0 on failure
+    static uintptr_t _allocate_huge(unsigned node, std::size_t size)
+    {
+        if(starpu_memory_allocate(node, size, 0) != 0)
+        {
+            return 0;
+        }
+        void *ptr = MAP_FAILED;
+        bool hugetlb = false;
+#ifdef MAP_HUGETLB
+        int huge_flag = 0;
+#ifdef MAP_HUGE_SHIFT
+        int log2_page = 0;
+        while((std::size_t(1)<<log2_page) < huge_page_size)
+        {
+            ++log2_page;
+        }
+        huge_flag = log2_page << MAP_HUGE_SHIFT;
+#endif // MAP_HUGE_SHIFT
+        ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | huge_flag, -1, 0);
+        hugetlb = ptr != MAP_FAILED;
+#endif // MAP_HUGETLB
+        // Fall back to transparent huge pages
+        if(not hugetlb)
+        {
+            ptr = nullptr;
+            if(posix_memalign(&ptr, huge_page_size, size) != 0)
+            {
+                starpu_memory_deallocate(node, size);
+                return 0;
+            }
+#ifdef MADV_HUGEPAGE
+            madvise(ptr, size, MADV_HUGEPAGE);
+#endif // MADV_HUGEPAGE
+        }
+        // Pin memory for transfers to CUDA devices
+        starpu_memory_pin(ptr, size);
+        auto result = reinterpret_cast<uintptr_t>(ptr);
+        huge_buffers[result] = hugetlb;
+        stats.huge += size;
+        return result;
+    }
+    // Free a buffer, allocated by the pool
+    static void _free(unsigned node, uintptr_t ptr, std::size_t size)
+    {
+        auto it = huge_buffers.find(ptr);
+        if(it == huge_buffers.end())
+        {
+            starpu_free_on_node_flags(node, ptr, size, flags);
+            return;
+        }
+        auto buffer = reinterpret_cast<void *>(ptr);
+        starpu_memory_unpin(buffer, size);
+        if(it->second)
+        {
+            munmap(buffer, size);
+        }
+        else
+        {
+            std::free(buffer);
+        }
+        starpu_memory_deallocate(node, size);
+        huge_buffers.erase(it);
+        stats.huge -= size;
+    }
+public:
+    //! Size class of a buffer
+    static std::size_t get_size_class(std::size_t size)
+    {
+        constexpr std::size_t min_size = 4096;
+        if(size <= min_size)
+        {
+            return min_size;
+        }
+        // Step is a quarter of the largest power of 2, not exceeding size
+        std::size_t step = 1;
+        while(step <= size/2)
+        {
+            step *= 2;
+        }
+        step /= 4;
+        return (size+step-1) / step * step;
+    }
+    //! Enable the pool with a limit on total size of cached free buffers
+    /*! It shall be called after StarPU is initialized, as memory is pinned
+     * only for initialized CUDA workers. Buffers, allocated by StarPU
+     * before this call, are freed without the pool. Zero huge page size
+     * disables huge pages, otherwise it shall be a power of 2 of at least
+     * 4096 bytes.
+     * */
+    static void enable(std::size_t max_cached_=std::size_t(-1),
+            std::size_t huge_page_size_=0)
+    {
+        if(not starpu_is_initialized())
+        {
+            throw std::runtime_error("Pool of pinned memory shall be "
+                    "enabled after StarPU is initialized");
+        }
+        if(huge_page_size_ != 0 and (huge_page_size_ < 4096
+                    or (huge_page_size_ & (huge_page_size_-1)) != 0))
+        {
+            throw std::runtime_error("Huge page size shall be a power of 2 "
+                    "of at least 4096 bytes");
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        // Allocation methods of variables are replaced only once
+        if(allocate_default == nullptr)
+        {
+            allocate_default =
+                starpu_interface_variable_ops.allocate_data_on_node;
+            free_default = starpu_interface_variable_ops.free_data_on_node;
+            starpu_interface_variable_ops.allocate_data_on_node =
+                _allocate_on_node;
+            starpu_interface_variable_ops.free_data_on_node = _free_on_node;
+        }
+        enabled = true;
+        max_cached = max_cached_;
+        huge_page_size = huge_page_size_;
+    }
+    //! Disable the pool for new allocations and free all cached buffers
+    /*! Buffers in use are returned into system when StarPU frees them. */
+    static void disable()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            enabled = false;
+        }
+        trim();
+    }
+    //! Check if the pool is enabled
+    static bool is_enabled()
+    {
+        return enabled;
+    }
+    //! Free all cached buffers
+    static void trim()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(auto &[key, buffers]: free_buffers)
+        {
+            for(auto ptr: buffers)
+            {
+                _free(key.first, ptr, key.second);
+            }
+        }
+        free_buffers.clear();
+        stats.cached = 0;
+    }
+    //! Get statistics of the pool
+    static HostMemoryPoolStats get_stats()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+    //! Allocate a buffer on a memory node in CPU RAM
+    /*! Returns 0 if the pool is disabled or there is not enough memory. */
+    static uintptr_t allocate(unsigned node, std::size_t size)
+    {
+        if(not enabled)
+        {
+            return 0;
+        }
+        std::size_t size_class = get_size_class(size);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = free_buffers.find({node, size_class});
+        uintptr_t ptr;
+        if(it != free_buffers.end() and not it->second.empty())
+        {
+            ptr = it->second.back();
+            it->second.pop_back();
+            stats.cached -= size_class;
+            ++stats.nhits;
+        }
+        else
+        {
+            ptr = 0;
+            if(huge_page_size != 0 and size_class >= 4*huge_page_size)
+            {
+                ptr = _allocate_huge(node, size_class);
+            }
+            if(ptr == 0)
+            {
+                ptr = starpu_malloc_on_node_flags(node, size_class, flags);
+            }
+            if(ptr == 0)
+            {
+                return 0;
+            }
+            ++stats.nmisses;
+        }
+        used_buffers[ptr] = size_class;
+        stats.used += size_class;
+        return ptr;
+    }
+    //! Return a buffer into the pool
+    /*! Returns false if the buffer was not allocated by the pool. */
+    static bool release(unsigned node, uintptr_t ptr)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = used_buffers.find(ptr);
+        if(it == used_buffers.end())
+        {
+            return false;
+        }
+        std::size_t size_class = it->second;
+        used_buffers.erase(it);
+        stats.used -= size_class;
+        if(enabled and stats.cached+size_class <= max_cached)
+        {
+            free_buffers[{node, size_class}].push_back(ptr);
+            stats.cached += size_class;
+        }
+        else
+        {
+            _free(node, ptr, size_class);
+        }
+        return true;
+    }
+};
+
+//! Pool of buffers for arguments of codelets
+/*! Arguments of a task are allocated at submission and released by a
+ * callback of the task, i.e. usually by another thread. Released buffers
+ * are cached by every thread and moved to the shared list in batches, so
+ * that submission takes a buffer without calling malloc and locks the
+ * shared list only once per batch. All the buffers are of the same size,
+ * that fits arguments of a fixed size of any codelet. When the pool is
+ * disabled, buffers are simply allocated and freed.
+ * */
+class ArgsPool
+{
+public:
+    //! Size of a buffer
+    static constexpr std::size_t buffer_size = 256;
+private:
+    // Number of buffers, that are moved between threads at once
+    static constexpr std::size_t batch_size = 64;
+    // Maximal number of buffers in the shared list
+    static constexpr std::size_t max_shared = 65536;
+    static inline std::mutex mutex;
+    static inline std::atomic<bool> enabled = true;
+    static inline std::vector<void *> shared;
+    // Buffers, cached by the current thread, go back to the shared list
+    // when the thread exits
+    struct LocalCache
+    {
+        std::vector<void *> buffers;
+        ~LocalCache()
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            for(auto ptr: buffers)
+            {
+                if(shared.size() < max_shared)
+                {
+                    shared.push_back(ptr);
+                }
+                else
+                {
+                    std::free(ptr);
+                }
+            }
+        }
+    };
+    static LocalCache &_local()
+    {
+        static thread_local LocalCache cache;
+        return cache;
+    }
+    static void *_allocate()
+    {
+        if(not enabled)
+        {
+            return std::malloc(buffer_size);
+        }
+        auto &local = _local().buffers;
+        if(local.empty())
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            std::size_t n = std::min(batch_size, shared.size());
+            local.insert(local.end(), shared.end()-n, shared.end());
+            shared.resize(shared.size()-n);
+        }
+        if(local.empty())
+        {
+            return std::malloc(buffer_size);
+        }
+        void *ptr = local.back();
+        local.pop_back();
+        return ptr;
+    }
+public:
+    //! Enable or disable caching of buffers
+    static void set_enabled(bool enabled_)
+    {
+        enabled = enabled_;
+    }
+    //! Check if caching of buffers is enabled
+    static bool is_enabled()
+    {
+        return enabled;
+    }
+    //! Get a buffer for arguments of type T
+    template<typename T>
+    static T *allocate()
+    {
+        static_assert(sizeof(T) <= buffer_size, "Arguments do not fit into "
+                "a buffer of the pool");
+        static_assert(std::is_trivially_copyable<T>::value, "Arguments "
+                "shall be trivially copyable");
+        return reinterpret_cast<T *>(_allocate());
+    }
+    //! Get a buffer with a copy of given arguments
+    template<typename T>
+    static T *allocate(const T &value)
+    {
+        T *ptr = allocate<T>();
+        std::memcpy(ptr, &value, sizeof(T));
+        return ptr;
+    }
+    //! Release a buffer, it is a callback of tasks
+    /*! Tasks pass arguments with STARPU_CL_ARGS_NFREE and release them with
+     * STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args.
+     * */
+    static void release(void *ptr)
+    {
+        if(not enabled)
+        {
+            std::free(ptr);
+            return;
+        }
+        auto &local = _local().buffers;
+        local.push_back(ptr);
+        if(local.size() >= 2*batch_size)
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            for(std::size_t i = local.size()-batch_size; i < local.size();
+                    ++i)
+            {
+                if(shared.size() < max_shared)
+                {
+                    shared.push_back(local[i]);
+                }
+                else
+                {
+                    std::free(local[i]);
+                }
+            }
+            local.resize(local.size()-batch_size);
+        }
+    }
+};
+
 //! Convenient StarPU initialization and shutdown
 class Config: public starpu_conf
 {
     int cublas;
+    //! Name of the scheduling policy
+    std::string sched;
+    //! Directory of the disk memory node
+    std::string disk_path;
+    //! Scheduling contexts, created by sched_ctx_create(), with their names
+    std::map<unsigned, std::unique_ptr<std::string>> sched_ctxs;
 public:
-    explicit Config(int ncpus_=-1, int ncuda_=-1, int cublas_=-1)
+    //! Disk memory node or -1 if it is not attached
+    int disk_node = -1;
+    //! Init StarPU with a given scheduling policy
+    /*! Policy is either a name of a StarPU scheduler or scheduler::name for
+     * the locality-aware scheduler of NNTile (see scheduler::policy).
+     * Nonempty disk_path_ attaches a disk memory node (see attach_disk).
+     * If numa_ is true, StarPU defines a memory node per NUMA node and binds
+     * CPU workers to cores, so that each CPU worker allocates and accesses
+     * data in memory of its own NUMA node. Ownership of tiles by NUMA nodes
+     * is set by tensor::Tensor::set_numa_distribution.
+     * Value of nworker_per_cuda_ greater than 1 creates several CUDA workers
+     * per device, each with its own CUDA stream and cuBLAS handle, so that
+     * small tasks run concurrently on the same device. Each of such workers
+     * is a separate device for tensor::Tensor::set_device_distribution.
+     * */
+    explicit Config(int ncpus_=-1, int ncuda_=-1, int cublas_=-1,
+            const std::string &sched_="dmda",
+            const std::string &disk_path_="", std::size_t disk_size_=0,
+            bool numa_=false, int nworker_per_cuda_=1):
+        sched(sched_)
     {
+        // StarPU reads these settings from environment during its
+        // initialization
+        if(numa_)
+        {
+            if(setenv("STARPU_USE_NUMA", "1", 1) != 0
+                    or unsetenv("STARPU_WORKERS_NOBIND") != 0)
+            {
+                throw std::runtime_error("Failed to enable NUMA nodes");
+            }
+        }
+        if(nworker_per_cuda_ < 1)
+        {
+            throw std::runtime_error("nworker_per_cuda_ < 1");
+        }
+        if(nworker_per_cuda_ > 1)
+        {
+            std::string value = std::to_string(nworker_per_cuda_);
+            if(setenv("STARPU_NWORKER_PER_CUDA", value.c_str(), 1) != 0)
+            {
+                throw std::runtime_error("Failed to set "
+                        "STARPU_NWORKER_PER_CUDA");
+            }
+        }
         starpu_fxt_autostart_profiling(0);
         // Init StarPU configuration with default values at first
         int ret = starpu_conf_init(this);
@@ -74,30 +593,239 @@ public:
 #else // NNTILE_USE_CUDA
         ncuda = 0;
 #endif // NNTILE_USE_CUDA
-        // Set history-based scheduler to utilize performance models
-        sched_policy_name = "dmda";
+        // History-based dmda scheduler utilizes performance models by default
+        if(sched == scheduler::name)
+        {
+            sched_policy = &scheduler::policy;
+            sched_policy_name = nullptr;
+        }
+        else
+        {
+            sched_policy_name = sched.c_str();
+            // Tasks get priorities of scheduler::priority_get() as well
+            scheduler::apply_priorities(sched_policy_name);
+        }
         // Save initial value
         cublas = cublas_;
+#ifdef NNTILE_USE_MPI
+        // Init StarPU together with StarPU-MPI, MPI is initialized as well
+        ret = starpu_mpi_init_conf(nullptr, nullptr, 1, MPI_COMM_WORLD, this);
+        if(ret != 0)
+        {
+            throw std::runtime_error("Error in starpu_mpi_init_conf()");
+        }
+#else // NNTILE_USE_MPI
         // Init StarPU (master-slave)
         ret = starpu_init(this);
         if(ret != 0)
         {
             throw std::runtime_error("Error in starpu_initialize()");
         }
+#endif // NNTILE_USE_MPI
         else
         {
             int ncpus_ = starpu_worker_get_count_by_type(STARPU_CPU_WORKER);
             int ncuda_ = starpu_worker_get_count_by_type(STARPU_CUDA_WORKER);
             std::cout << "Initialized NCPU=" << ncpus_ << " NCUDA=" << ncuda_
+#ifdef NNTILE_USE_MPI
+                << " MPI_RANK=" << starpu_mpi_world_rank()
+                << " MPI_SIZE=" << starpu_mpi_world_size()
+#endif // NNTILE_USE_MPI
+                << "\n";
+            std::cout << "Initialized CPU SIMD="
+                << kernel::simd::level_name(kernel::simd::get_level())
                 << "\n";
+            if(numa_)
+            {
+                std::cout << "Initialized NNUMA=" << scheduler::get_nnuma()
+                    << "\n";
+            }
+            if(nworker_per_cuda_ > 1)
+            {
+                std::cout << "Initialized NWORKER_PER_CUDA="
+                    << nworker_per_cuda_ << "\n";
+            }
         }
 #ifdef NNTILE_USE_CUDA
+        // cuBLAS handle of each CUDA worker is bound to the stream of the
+        // worker, so that workers of the same device do not share handles
         if(cublas != 0)
         {
             starpu_cublas_init();
             std::cout << "Initialized cuBLAS\n";
         }
 #endif // NNTILE_USE_CUDA
+        if(not disk_path_.empty())
+        {
+            attach_disk(disk_path_, disk_size_);
+        }
+    }
+    //! Attach a disk memory node for out-of-core data
+    /*! Files of the node are created in a given directory, e.g., on an NVMe
+     * drive, and are accessed with O_DIRECT, so that transfers bypass the
+     * page cache and are asynchronous if StarPU is built with AIO. When host
+     * RAM is full, StarPU evicts tiles to the disk and reads them back on
+     * demand. Only data, that is allowed to spill (see Tensor::set_spill),
+     * is evicted, as hot data would make the disk a bottleneck.
+     *
+     * @param[in] path: Existing directory for files of the node
+     * @param[in] size: Maximal size of data on the disk in bytes
+     * */
+    int attach_disk(const std::string &path, std::size_t size)
+    {
+        if(disk_node >= 0)
+        {
+            throw std::runtime_error("Disk memory node is already attached");
+        }
+        // Parameter of the disk driver shall outlive the memory node
+        disk_path = path;
+        int node = starpu_disk_register(&starpu_disk_unistd_o_direct_ops,
+                const_cast<char *>(disk_path.c_str()), size);
+        if(node < 0)
+        {
+            throw std::runtime_error("Error in starpu_disk_register()");
+        }
+        disk_node = node;
+        std::cout << "Attached disk memory node " << node << " at "
+            << disk_path << "\n";
+        return node;
+    }
+    //! Create a scheduling context over a subset of workers
+    /*! Tasks of a context are executed only by its workers and are scheduled
+     * by its own policy, so that several workloads (e.g., training and
+     * inference) share the same StarPU without competing for the same
+     * workers. A worker may belong to several contexts. Tasks go to a
+     * context after sched_ctx_enter() by the submitting thread.
+     *
+     * @param[in] workers: Identifiers of workers, see get_worker_ids()
+     * @param[in] name: Name of the context
+     * @param[in] policy: Name of a StarPU scheduler or scheduler::name. Empty
+     *      string stands for the policy of this configuration.
+     * */
+    unsigned sched_ctx_create(const std::vector<int> &workers,
+            const std::string &name, const std::string &policy="")
+    {
+        _check_worker_ids(workers);
+        std::string policy_ = policy.empty() ? sched : policy;
+        std::vector<int> ids(workers);
+        // Name of the context shall outlive it
+        auto name_ptr = std::make_unique<std::string>(name);
+        unsigned ctx;
+        if(policy_ == scheduler::name)
+        {
+            ctx = starpu_sched_ctx_create(&ids[0], ids.size(),
+                    name_ptr->c_str(), STARPU_SCHED_CTX_POLICY_STRUCT,
+                    &scheduler::policy, 0);
+        }
+        else
+        {
+            ctx = starpu_sched_ctx_create(&ids[0], ids.size(),
+                    name_ptr->c_str(), STARPU_SCHED_CTX_POLICY_NAME,
+                    policy_.c_str(), 0);
+        }
+        if(ctx >= STARPU_NMAX_SCHED_CTXS)
+        {
+            throw std::runtime_error("Error in starpu_sched_ctx_create()");
+        }
+        sched_ctxs[ctx] = std::move(name_ptr);
+        return ctx;
+    }
+    //! Delete a scheduling context, created by sched_ctx_create()
+    /*! All the tasks of the context shall be finished. Submitting thread
+     * returns to the global context if the deleted one was active.
+     * */
+    void sched_ctx_delete(unsigned ctx)
+    {
+        auto it = sched_ctxs.find(ctx);
+        if(it == sched_ctxs.end())
+        {
+            throw std::runtime_error("Scheduling context was not created by "
+                    "sched_ctx_create()");
+        }
+        if(starpu_sched_ctx_get_context() == ctx)
+        {
+            sched_ctx_exit();
+        }
+        starpu_sched_ctx_delete(ctx);
+        sched_ctxs.erase(it);
+    }
+    //! Submit all the following tasks of this thread to a given context
+    static void sched_ctx_enter(unsigned ctx)
+    {
+        starpu_sched_ctx_set_context(&ctx);
+    }
+    //! Submit all the following tasks of this thread to the global context
+    static void sched_ctx_exit()
+    {
+        unsigned ctx = 0;
+        starpu_sched_ctx_set_context(&ctx);
+    }
+    //! Move workers into a context to rebalance shares of workloads
+    /*! Workers are not removed from other contexts, use
+     * sched_ctx_remove_workers() for it.
+     * */
+    static void sched_ctx_add_workers(unsigned ctx,
+            const std::vector<int> &workers)
+    {
+        _check_worker_ids(workers);
+        std::vector<int> ids(workers);
+        starpu_sched_ctx_add_workers(&ids[0], ids.size(), ctx);
+    }
+    //! Remove workers from a context, that keeps at least one worker
+    static void sched_ctx_remove_workers(unsigned ctx,
+            const std::vector<int> &workers)
+    {
+        _check_worker_ids(workers);
+        if(workers.size() >= starpu_sched_ctx_get_nworkers(ctx))
+        {
+            throw std::runtime_error("Context shall keep at least one "
+                    "worker");
+        }
+        std::vector<int> ids(workers);
+        starpu_sched_ctx_remove_workers(&ids[0], ids.size(), ctx);
+    }
+    //! Get identifiers of workers of a context
+    static std::vector<int> sched_ctx_get_workers(unsigned ctx)
+    {
+        int *ids = nullptr;
+        unsigned n = starpu_sched_ctx_get_workers_list(ctx, &ids);
+        std::vector<int> workers(ids, ids+n);
+        std::free(ids);
+        return workers;
+    }
+    //! Wait for all the submitted tasks of a context
+    static void sched_ctx_wait(unsigned ctx)
+    {
+        int ret = starpu_task_wait_for_all_in_ctx(ctx);
+        if(ret != 0)
+        {
+            throw std::runtime_error("Error in "
+                    "starpu_task_wait_for_all_in_ctx()");
+        }
+    }
+    //! Get identifiers of all CPU or CUDA workers
+    static std::vector<int> get_worker_ids(bool cuda)
+    {
+        int ids[STARPU_NMAXWORKERS];
+        int n = starpu_worker_get_ids_by_type(cuda ? STARPU_CUDA_WORKER
+                : STARPU_CPU_WORKER, ids, STARPU_NMAXWORKERS);
+        return std::vector<int>(ids, ids+(n > 0 ? n : 0));
+    }
+    // Check that a list of workers is not empty and has valid identifiers
+    static void _check_worker_ids(const std::vector<int> &workers)
+    {
+        if(workers.empty())
+        {
+            throw std::runtime_error("Empty list of workers");
+        }
+        int nworkers = starpu_worker_get_count();
+        for(int id: workers)
+        {
+            if(id < 0 or id >= nworkers)
+            {
+                throw std::runtime_error("Invalid identifier of a worker");
+            }
+        }
     }
     ~Config()
     {
@@ -105,20 +833,211 @@ public:
     }
     void shutdown()
     {
+        offload::shutdown();
+        // Contexts are deleted before StarPU itself
+        if(not sched_ctxs.empty())
+        {
+            sched_ctx_exit();
+            while(not sched_ctxs.empty())
+            {
+                sched_ctx_delete(sched_ctxs.begin()->first);
+            }
+        }
+        HostMemoryPool::disable();
 #ifdef NNTILE_USE_CUDA
         if(cublas != 0)
         {
             starpu_cublas_shutdown();
             std::cout << "Shutdown cuBLAS\n";
         }
-#endif // NNTILE_USE_CUDA
-        starpu_shutdown();
-        std::cout << "Shutdown StarPU\n";
+#endif // NNTILE_USE_CUDA
+#ifdef NNTILE_USE_MPI
+        // StarPU-MPI shuts down StarPU and MPI, as it initialized both
+        starpu_mpi_shutdown();
+        std::cout << "Shutdown StarPU-MPI\n";
+#else // NNTILE_USE_MPI
+        starpu_shutdown();
+        std::cout << "Shutdown StarPU\n";
+#endif // NNTILE_USE_MPI
+    }
+    //! StarPU commute data access mode for accumulating codelets
+    /*! It is STARPU_RW|STARPU_COMMUTE by default, so that tasks accumulating
+     * into the same buffer (e.g., gemm with beta=1) may be reordered by the
+     * scheduler. Commute mode can be switched off at runtime to get a strict
+     * submission order of such tasks.
+     * */
+    static inline starpu_data_access_mode STARPU_RW_COMMUTE
+        = static_cast<starpu_data_access_mode>(STARPU_RW | STARPU_COMMUTE);
+    //! Enable commute mode for accumulating codelets
+    static void commute_enable()
+    {
+        STARPU_RW_COMMUTE = static_cast<starpu_data_access_mode>(
+                STARPU_RW | STARPU_COMMUTE);
+    }
+    //! Disable commute mode for accumulating codelets
+    static void commute_disable()
+    {
+        STARPU_RW_COMMUTE = STARPU_RW;
+    }
+    //! Check if commute mode is enabled
+    static bool commute_is_enabled()
+    {
+        return (STARPU_RW_COMMUTE & STARPU_COMMUTE) != 0;
+    }
+    //! Deterministic mode of reductions
+    /*! Order of accumulation of both the commute mode and STARPU_REDUX
+     * depends on scheduling, so results of consecutive runs differ bitwise.
+     * In the deterministic mode commute mode is switched off and tensor
+     * operations replace STARPU_REDUX by a tree reduction of a fixed shape,
+     * whose levels still run in parallel, or by a sequential chain of tasks,
+     * if the operation does not support tree reduction (see
+     * tensor::redux_mode()).
+     * */
+    static inline bool deterministic = false;
+    //! Enable deterministic mode of reductions
+    static void deterministic_enable()
+    {
+        deterministic = true;
+        commute_disable();
+    }
+    //! Disable deterministic mode of reductions
+    static void deterministic_disable()
+    {
+        deterministic = false;
+        commute_enable();
+    }
+    //! Check if deterministic mode of reductions is enabled
+    static bool deterministic_is_enabled()
+    {
+        return deterministic;
+    }
+    //! Directory, where StarPU stores calibrated performance models
+    /*! StarPU reads it from STARPU_PERF_MODEL_DIR or, if it is not defined,
+     * uses .starpu/sampling subdirectory of STARPU_HOME or HOME.
+     * */
+    static std::filesystem::path perfmodel_dir()
+    {
+        const char *dir = std::getenv("STARPU_PERF_MODEL_DIR");
+        if(dir != nullptr)
+        {
+            return std::filesystem::path(dir);
+        }
+        const char *home = std::getenv("STARPU_HOME");
+        if(home == nullptr)
+        {
+            home = std::getenv("HOME");
+        }
+        if(home == nullptr)
+        {
+            throw std::runtime_error("Neither STARPU_PERF_MODEL_DIR nor "
+                    "STARPU_HOME nor HOME is defined");
+        }
+        return std::filesystem::path(home) / ".starpu" / "sampling";
+    }
+    //! Name performance models after a hardware profile
+    /*! StarPU appends a hostname to names of files with performance models.
+     * Fresh containers get random hostnames, so calibrated models are never
+     * found again. Setting a hostname to a name of a hardware profile makes
+     * the models reusable on any node with the same hardware. It must be
+     * called before StarPU is initialized.
+     * */
+    static void perfmodel_set_profile(const std::string &profile)
+    {
+        if(profile.empty())
+        {
+            throw std::runtime_error("Hardware profile name is empty");
+        }
+        if(starpu_is_initialized())
+        {
+            throw std::runtime_error("Hardware profile must be set before "
+                    "StarPU is initialized");
+        }
+        if(setenv("STARPU_HOSTNAME", profile.c_str(), 1) != 0)
+        {
+            throw std::runtime_error("Failed to set STARPU_HOSTNAME");
+        }
+    }
+    //! Import bundle of calibrated performance models of a hardware profile
+    /*! Bundle is a directory with the same layout as perfmodel_dir(). Its
+     * models of the given profile (both codelets and bus) are copied into
+     * perfmodel_dir() and the profile is set as a hostname for StarPU. It
+     * must be called before StarPU is initialized, as StarPU reads models
+     * during initialization and the first submission of each codelet.
+     * */
+    static void perfmodel_import(const std::string &bundle,
+            const std::string &profile)
+    {
+        if(not std::filesystem::is_directory(bundle))
+        {
+            throw std::runtime_error("Bundle of performance models " + bundle
+                    + " is not a directory");
+        }
+        perfmodel_set_profile(profile);
+        std::size_t ncopied = _perfmodel_copy(bundle, perfmodel_dir(),
+                profile);
+        if(ncopied == 0)
+        {
+            throw std::runtime_error("Bundle of performance models " + bundle
+                    + " has no models of profile " + profile);
+        }
+    }
+    //! Export calibrated performance models of a hardware profile
+    /*! Models of the given profile are copied from perfmodel_dir() into the
+     * bundle directory, that is created if needed. StarPU writes models to
+     * disk only at shutdown, so it shall be called after shutdown().
+     * Returns number of exported files.
+     * */
+    static std::size_t perfmodel_export(const std::string &bundle,
+            const std::string &profile)
+    {
+        if(starpu_is_initialized())
+        {
+            throw std::runtime_error("Performance models must be exported "
+                    "after StarPU is shut down");
+        }
+        return _perfmodel_copy(perfmodel_dir(), bundle, profile);
+    }
+    // Copy files of performance models of a profile between directories
+    static std::size_t _perfmodel_copy(const std::filesystem::path &src,
+            const std::filesystem::path &dst, const std::string &profile)
+    {
+        namespace fs = std::filesystem;
+        std::size_t ncopied = 0;
+        // Codelet models are named <symbol>.<profile> and bus models are
+        // named <profile>.<kind>
+        for(const auto &subdir: {"codelets", "bus"})
+        {
+            fs::path src_subdir = src / subdir;
+            if(not fs::is_directory(src_subdir))
+            {
+                continue;
+            }
+            for(const auto &entry:
+                    fs::recursive_directory_iterator(src_subdir))
+            {
+                if(not entry.is_regular_file())
+                {
+                    continue;
+                }
+                std::string name = entry.path().filename().string();
+                bool match = name.size() > profile.size() and (
+                        name.compare(name.size()-profile.size()-1,
+                            std::string::npos, "."+profile) == 0
+                        or name.compare(0, profile.size()+1, profile+".")
+                            == 0);
+                if(not match)
+                {
+                    continue;
+                }
+                fs::path dst_file = dst / fs::relative(entry.path(), src);
+                fs::create_directories(dst_file.parent_path());
+                fs::copy_file(entry.path(), dst_file,
+                        fs::copy_options::overwrite_existing);
+                ++ncopied;
+            }
+        }
+        return ncopied;
     }
-    //! StarPU commute data access mode
-    static constexpr starpu_data_access_mode STARPU_RW_COMMUTE
-        = STARPU_RW; // Temporarily disabled commute mode
-    //    = static_cast<starpu_data_access_mode>(STARPU_RW | STARPU_COMMUTE);
     // Unpack args by pointers without copying actual data
     template<typename... Ts>
     static
@@ -161,9 +1080,470 @@ public:
     }
 };
 
+//! Tracker of memory, allocated for registered data handles
+/*! When enabled, all the registered variable handles are tracked together
+ * with their sizes and names (tensors name their tiles). Sampling finds
+ * which handles are allocated on each memory node and updates peak values.
+ * Peak of a node is reported with a breakdown by names of handles at the
+ * time of the peak, so that it is clear which tensors were resident. Values
+ * of used memory of StarPU itself are sampled as well. Sampling is done on
+ * request or periodically by a background thread.
+ *
+ * Transfers between memory nodes are counted separately (see
+ * transfers_enable), both per pair of nodes and per name of a handle.
+ * */
+class MemoryTracker
+{
+public:
+    //! Memory statistics of a single memory node
+    struct NodeStats
+    {
+        //! Bytes of tracked handles, allocated on the node
+        std::size_t used = 0;
+        //! Peak value of used bytes
+        std::size_t peak = 0;
+        //! Bytes of used memory of StarPU on the node
+        std::size_t starpu_used = 0;
+        //! Peak value of used memory of StarPU
+        std::size_t starpu_peak = 0;
+        //! Used bytes by names of handles
+        std::map<std::string, std::size_t> used_by_name;
+        //! Used bytes by names of handles at the time of the peak
+        std::map<std::string, std::size_t> peak_by_name;
+    };
+    //! Information about a tracked handle
+    struct HandleInfo
+    {
+        //! Size of data in bytes
+        std::size_t size;
+        //! Name of a tensor or a tile
+        std::string name;
+    };
+    //! Transfers of data from one memory node to another
+    struct TransferStats
+    {
+        //! Source memory node
+        unsigned src;
+        //! Destination memory node
+        unsigned dst;
+        //! Transferred bytes
+        std::size_t bytes = 0;
+        //! Number of transfers
+        std::size_t count = 0;
+        //! Total time of transfers in seconds (only per pair of nodes)
+        double time = 0;
+    };
+private:
+    static inline std::mutex mutex;
+    static inline std::atomic<bool> enabled = false;
+    static inline std::unordered_map<starpu_data_handle_t, HandleInfo>
+        handles;
+    static inline std::vector<NodeStats> nodes;
+    static inline std::size_t next_id = 0;
+    // Background sampling
+    static inline std::thread sampler;
+    static inline std::condition_variable sampler_cv;
+    static inline bool sampler_stop = false;
+    // Counting of transfers has its own mutex, as copy methods are called
+    // by StarPU with locked handles, while sampling locks handles as well
+    static inline std::mutex transfers_mutex;
+    static inline std::atomic<bool> transfers_enabled = false;
+    // Names of tracked handles by their data interfaces on all nodes
+    static inline std::unordered_map<void *, std::string> interfaces;
+    // Transfers by names of handles and pairs of nodes
+    static inline std::map<std::tuple<std::string, unsigned, unsigned>,
+           TransferStats> transfers_by_name;
+    // Statistics of buses at the last reset
+    static inline std::vector<starpu_profiling_bus_info> bus_baseline;
+    // Copy methods of variable handles with counting of transfers
+    static inline starpu_data_copy_methods copy_methods;
+    static inline int (*any_to_any)(void *, unsigned, void *, unsigned,
+            void *) = nullptr;
+    static int _any_to_any(void *src_interface, unsigned src_node,
+            void *dst_interface, unsigned dst_node, void *async_data)
+    {
+        if(transfers_enabled)
+        {
+            std::size_t bytes = reinterpret_cast<starpu_variable_interface *>(
+                    dst_interface)->elemsize;
+            std::lock_guard<std::mutex> lock(transfers_mutex);
+            auto it = interfaces.find(dst_interface);
+            std::string name = (it != interfaces.end()) ? it->second
+                : "untracked";
+            auto &s = transfers_by_name[{name, src_node, dst_node}];
+            s.src = src_node;
+            s.dst = dst_node;
+            s.bytes += bytes;
+            ++s.count;
+        }
+        return any_to_any(src_interface, src_node, dst_interface, dst_node,
+                async_data);
+    }
+    // Set names of data interfaces of a handle on all memory nodes
+    static void _set_interfaces(starpu_data_handle_t handle,
+            const std::string *name)
+    {
+        unsigned nnodes = starpu_memory_nodes_get_count();
+        std::vector<void *> handle_interfaces(nnodes);
+        for(unsigned node = 0; node < nnodes; ++node)
+        {
+            handle_interfaces[node] = starpu_data_get_interface_on_node(
+                    handle, node);
+        }
+        std::lock_guard<std::mutex> lock(transfers_mutex);
+        for(auto ptr: handle_interfaces)
+        {
+            if(name != nullptr)
+            {
+                interfaces[ptr] = *name;
+            }
+            else
+            {
+                interfaces.erase(ptr);
+            }
+        }
+    }
+    // Update memory of StarPU, mutex shall be locked
+    static void _sample_starpu()
+    {
+        nodes.resize(starpu_memory_nodes_get_count());
+        for(unsigned node = 0; node < nodes.size(); ++node)
+        {
+            auto &s = nodes[node];
+            s.starpu_used = starpu_memory_get_used(node);
+            s.starpu_peak = std::max(s.starpu_peak, s.starpu_used);
+        }
+    }
+    // Update all memory statistics, mutex shall be locked
+    static void _sample()
+    {
+        _sample_starpu();
+        for(unsigned node = 0; node < nodes.size(); ++node)
+        {
+            auto &s = nodes[node];
+            s.used = 0;
+            s.used_by_name.clear();
+            for(const auto &[handle, info]: handles)
+            {
+                if(starpu_data_is_on_node(handle, node))
+                {
+                    s.used += info.size;
+                    s.used_by_name[info.name] += info.size;
+                }
+            }
+            if(s.used > s.peak)
+            {
+                s.peak = s.used;
+                s.peak_by_name = s.used_by_name;
+            }
+        }
+    }
+    // Body of the background sampling thread
+    static void _sampler_loop(std::chrono::milliseconds period)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while(not sampler_stop)
+        {
+            _sample();
+            sampler_cv.wait_for(lock, period);
+        }
+    }
+public:
+    //! Start tracking of newly registered handles
+    /*! If sampling period is positive, memory is sampled periodically by a
+     * background thread. Otherwise, sample() shall be called explicitly.
+     * */
+    static void enable(int sampling_period_ms=0)
+    {
+        disable();
+        std::lock_guard<std::mutex> lock(mutex);
+        enabled = true;
+        if(sampling_period_ms > 0)
+        {
+            sampler_stop = false;
+            sampler = std::thread(_sampler_loop,
+                    std::chrono::milliseconds(sampling_period_ms));
+        }
+    }
+    //! Stop tracking and forget all tracked handles
+    static void disable()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            enabled = false;
+            sampler_stop = true;
+            handles.clear();
+            std::lock_guard<std::mutex> transfers_lock(transfers_mutex);
+            interfaces.clear();
+        }
+        sampler_cv.notify_all();
+        if(sampler.joinable())
+        {
+            sampler.join();
+        }
+    }
+    //! Check if tracking is enabled
+    static bool is_enabled()
+    {
+        return enabled;
+    }
+    //! Track a newly registered handle
+    static void track(starpu_data_handle_t handle, std::size_t size)
+    {
+        if(not enabled)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        auto &info = handles[handle];
+        info = {size, "handle " + std::to_string(next_id++)};
+        _set_interfaces(handle, &info.name);
+        _sample_starpu();
+    }
+    //! Stop tracking of a handle, that is about to be unregistered
+    static void untrack(starpu_data_handle_t handle)
+    {
+        if(not enabled)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        _sample_starpu();
+        if(handles.erase(handle) > 0)
+        {
+            _set_interfaces(handle, nullptr);
+        }
+    }
+    //! Set name of a tracked handle
+    static void set_name(starpu_data_handle_t handle, const std::string &name)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = handles.find(handle);
+        if(it != handles.end())
+        {
+            it->second.name = name;
+            _set_interfaces(handle, &name);
+        }
+    }
+    //! Get a unique default name with a given prefix
+    static std::string get_default_name(const std::string &prefix)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return prefix + " " + std::to_string(next_id++);
+    }
+    //! Sample memory of all the nodes
+    static void sample()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        _sample();
+    }
+    //! Reset peak values to current ones
+    static void reset_peak()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(auto &s: nodes)
+        {
+            s.peak = s.used;
+            s.peak_by_name = s.used_by_name;
+            s.starpu_peak = s.starpu_used;
+        }
+    }
+    //! Get memory statistics of all the nodes as of the last sample
+    static std::vector<NodeStats> get_stats()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        _sample_starpu();
+        return nodes;
+    }
+    //! Start counting of transfers between memory nodes
+    /*! Bus profiling of StarPU gives bytes, number and time of transfers for
+     * every pair of memory nodes. Transfers of variable handles are also
+     * counted per name of a handle by a wrapper of their copy methods, so
+     * that tensors, that move between devices, are easy to find. Only
+     * handles, registered while memory tracking is enabled, have names.
+     * Statistics start from zero.
+     * */
+    static void transfers_enable()
+    {
+        if(any_to_any == nullptr)
+        {
+            copy_methods = *starpu_interface_variable_ops.copy_methods;
+            any_to_any = copy_methods.any_to_any;
+            copy_methods.any_to_any = _any_to_any;
+            starpu_interface_variable_ops.copy_methods = &copy_methods;
+        }
+        starpu_profiling_status_set(STARPU_PROFILING_ENABLE);
+        transfers_reset();
+        transfers_enabled = true;
+    }
+    //! Stop counting of transfers, statistics are kept
+    static void transfers_disable()
+    {
+        transfers_enabled = false;
+    }
+    //! Check if transfers are counted
+    static bool transfers_is_enabled()
+    {
+        return transfers_enabled;
+    }
+    //! Reset statistics of transfers, e.g., at the start of an iteration
+    static void transfers_reset()
+    {
+        std::lock_guard<std::mutex> lock(transfers_mutex);
+        transfers_by_name.clear();
+        bus_baseline.resize(starpu_bus_get_count());
+        for(int bus = 0; bus < bus_baseline.size(); ++bus)
+        {
+            starpu_bus_get_profiling_info(bus, &bus_baseline[bus]);
+        }
+    }
+    //! Get transfers for all pairs of memory nodes since the last reset
+    static std::vector<TransferStats> transfers_get_by_bus()
+    {
+        std::lock_guard<std::mutex> lock(transfers_mutex);
+        std::vector<TransferStats> result;
+        for(int bus = 0; bus < bus_baseline.size(); ++bus)
+        {
+            starpu_profiling_bus_info info;
+            starpu_bus_get_profiling_info(bus, &info);
+            auto &base = bus_baseline[bus];
+            TransferStats s;
+            s.src = starpu_bus_get_src(bus);
+            s.dst = starpu_bus_get_dst(bus);
+            s.bytes = info.transferred_bytes - base.transferred_bytes;
+            s.count = info.transfer_count - base.transfer_count;
+            s.time = (starpu_timing_timespec_to_us(&info.total_time)
+                    - starpu_timing_timespec_to_us(&base.total_time)) * 1e-6;
+            if(s.count > 0)
+            {
+                result.push_back(s);
+            }
+        }
+        return result;
+    }
+    //! Get transfers by names of handles since the last reset
+    static std::vector<std::pair<std::string, TransferStats>>
+        transfers_get_by_name()
+    {
+        std::lock_guard<std::mutex> lock(transfers_mutex);
+        std::vector<std::pair<std::string, TransferStats>> result;
+        for(const auto &[key, s]: transfers_by_name)
+        {
+            result.emplace_back(std::get<0>(key), s);
+        }
+        return result;
+    }
+    //! Get information about all tracked handles
+    /*! Returns handles together with lists of memory nodes, where they are
+     * allocated.
+     * */
+    static std::vector<std::pair<HandleInfo, std::vector<unsigned>>>
+        get_handles()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<std::pair<HandleInfo, std::vector<unsigned>>> result;
+        unsigned nnodes = starpu_memory_nodes_get_count();
+        for(const auto &[handle, info]: handles)
+        {
+            std::vector<unsigned> handle_nodes;
+            for(unsigned node = 0; node < nnodes; ++node)
+            {
+                if(starpu_data_is_on_node(handle, node))
+                {
+                    handle_nodes.push_back(node);
+                }
+            }
+            result.emplace_back(info, handle_nodes);
+        }
+        return result;
+    }
+};
+
 // Forward declaration
 class HandleLocalData;
 
+//! Non-owning reference to a StarPU data handle
+/*! Submission of a task needs only the raw data handle, while a copy of
+ * Handle is an atomic increment and decrement of the reference counter of
+ * its shared pointer. Therefore, submit functions take HandleRef by value
+ * and Handle converts into it implicitly. The referenced data shall stay
+ * registered during the call only, as StarPU waits for the submitted tasks
+ * before unregistering data.
+ * */
+class HandleRef
+{
+    //! Raw data handle
+    starpu_data_handle_t handle;
+public:
+    //! Default constructor with nullptr
+    HandleRef():
+        handle(nullptr)
+    {
+    }
+    //! Constructor with a raw data handle
+    explicit HandleRef(starpu_data_handle_t handle_):
+        handle(handle_)
+    {
+    }
+    //! Convert to starpu_data_handle_t (only if explicitly asked)
+    explicit operator starpu_data_handle_t() const
+    {
+        return handle;
+    }
+    //! Get rank of the MPI node owning the data handle
+    int mpi_get_rank() const
+    {
+#ifdef NNTILE_USE_MPI
+        return starpu_mpi_data_get_rank(handle);
+#else // NNTILE_USE_MPI
+        return 0;
+#endif // NNTILE_USE_MPI
+    }
+    //! Get tag of the data handle
+    starpu_mpi_tag_t mpi_get_tag() const
+    {
+#ifdef NNTILE_USE_MPI
+        return starpu_mpi_data_get_tag(handle);
+#else // NNTILE_USE_MPI
+        return 0;
+#endif // NNTILE_USE_MPI
+    }
+    //! Transfer data to a provided node rank
+    /*! Only the owner of the data and the destination node take part in the
+     * transfer. Destination node caches received data until mpi_flush() is
+     * called. Data with a lossy precision of transfers is sent in the
+     * compressed form instead (see transfer_dtype).
+     * */
+    void mpi_transfer(int dst_rank, int mpi_rank) const
+    {
+#ifdef NNTILE_USE_MPI
+        if(transfer_dtype::transfer(handle, dst_rank, mpi_rank))
+        {
+            return;
+        }
+        if(mpi_rank == dst_rank or mpi_rank == mpi_get_rank())
+        {
+            // This function shall be removed in near future, all data
+            // transfers shall be initiated by starpu_mpi_task_build and others
+            int ret = starpu_mpi_get_data_on_node_detached(MPI_COMM_WORLD,
+                    handle, dst_rank, nullptr, nullptr);
+            if(ret != 0)
+            {
+                throw std::runtime_error("Error in starpu_mpi_get_data_on_"
+                        "node_detached");
+            }
+        }
+#endif // NNTILE_USE_MPI
+    }
+    //! Flush cached data
+    void mpi_flush() const
+    {
+#ifdef NNTILE_USE_MPI
+        starpu_mpi_cache_flush(MPI_COMM_WORLD, handle);
+#endif // NNTILE_USE_MPI
+    }
+};
+
 //! StarPU data handle as a shared pointer to its internal state
 //
 // This class takes the ownership of the data handle. That said, it unregisters
@@ -177,6 +1557,9 @@ class Handle
         // All the tasks using given starpu data handle shall be finished
         // before unregistering the handle
         //std::cerr << "[nntile] unregister\n";
+        MemoryTracker::untrack(ptr);
+        trace::untrack(ptr);
+        transfer_dtype::untrack(ptr);
         starpu_data_unregister(ptr);
     }
     static void _deleter_no_coherency(starpu_data_handle_t ptr)
@@ -185,6 +1568,9 @@ class Handle
         // All the tasks using given starpu data handle shall be finished
         // before unregistering the handle
         //std::cerr << "[nntile] unregister_no_coherency\n";
+        MemoryTracker::untrack(ptr);
+        trace::untrack(ptr);
+        transfer_dtype::untrack(ptr);
         starpu_data_unregister_no_coherency(ptr);
     }
     static void _deleter_temporary(starpu_data_handle_t ptr)
@@ -194,6 +1580,9 @@ class Handle
         // starpu as it will be deallocated during actual unregistering and at
         // the time of submission.
         //std::cerr << "[nntile] unregister_submit\n";
+        MemoryTracker::untrack(ptr);
+        trace::untrack(ptr);
+        transfer_dtype::untrack(ptr);
         starpu_data_unregister_submit(ptr);
     }
     static std::shared_ptr<_starpu_data_state> _get_shared_ptr(
@@ -246,6 +1635,11 @@ public:
     {
         return handle.get();
     }
+    //! Convert to a non-owning reference for submission of tasks
+    operator HandleRef() const
+    {
+        return HandleRef(handle.get());
+    }
     //! Acquire data locally
     HandleLocalData acquire(starpu_data_access_mode mode) const;
     //! Unregister underlying handle without waiting for destructor
@@ -253,40 +1647,45 @@ public:
     {
         handle.reset();
     }
+    //! Unregister underlying handle without blocking the calling thread
+    /*! Data, allocated by StarPU, is unregistered after all the submitted
+     * tasks, that use it, are finished, while the calling thread continues
+     * submission of tasks. Data, registered with a user buffer, is written
+     * back into the buffer, which may be freed right after return, so it is
+     * still unregistered in a blocking way. If there are other references to
+     * the handle, the last one unregisters it in the same way.
+     * */
+    void unregister_submit()
+    {
+        auto deleter = std::get_deleter<void (*)(starpu_data_handle_t)>(
+                handle);
+        if(deleter != nullptr and *deleter == _deleter_no_coherency)
+        {
+            *deleter = _deleter_temporary;
+        }
+        handle.reset();
+    }
     //! Get rank of the MPI node owning the data handle
     int mpi_get_rank() const
     {
-        return 0;
-        //return starpu_mpi_data_get_rank(handle.get());
+        return HandleRef(*this).mpi_get_rank();
     }
     //! Get tag of the data handle
-    int mpi_get_tag() const
+    starpu_mpi_tag_t mpi_get_tag() const
     {
-        return 0;
-        //return starpu_mpi_data_get_tag(handle.get());
+        return HandleRef(*this).mpi_get_tag();
     }
     //! Transfer data to a provided node rank
+    /*! See HandleRef::mpi_transfer() for details.
+     * */
     void mpi_transfer(int dst_rank, int mpi_rank) const
     {
-        //if(mpi_rank == dst_rank or mpi_rank == mpi_get_rank())
-        //{
-        //    // This function shall be removed in near future, all data
-        //    // transfers shall be initiated by starpu_mpi_task_build and others
-        //    starpu_mpi_get_data_on_node_detached(MPI_COMM_WORLD,
-        //            handle.get(), dst_rank, nullptr, nullptr);
-        //    //int ret = starpu_mpi_get_data_on_node_detached(MPI_COMM_WORLD,
-        //    //        handle.get(), dst_rank, nullptr, nullptr);
-        //    //if(ret != 0)
-        //    //{
-        //    //    throw std::runtime_error("Error in starpu_mpi_get_data_on_"
-        //    //            "node_detached");
-        //    //}
-        //}
+        HandleRef(*this).mpi_transfer(dst_rank, mpi_rank);
     }
     //! Flush cached data
     void mpi_flush() const
     {
-        //starpu_mpi_cache_flush(MPI_COMM_WORLD, handle.get());
+        HandleRef(*this).mpi_flush();
     }
 };
 
@@ -358,7 +1757,12 @@ public:
 class VariableHandle: public Handle
 {
     //! Register variable for StarPU-owned memory
-    static starpu_data_handle_t _reg_data(size_t size)
+    /*! Memory is allocated only on nodes, where data is written to or
+     * transferred to (see HostMemoryPool). Mode of access defines how data
+     * is unregistered.
+     * */
+    static starpu_data_handle_t _reg_data(size_t size,
+            starpu_data_access_mode mode)
     {
         if(size == 0)
         {
@@ -366,6 +1770,9 @@ class VariableHandle: public Handle
         }
         starpu_data_handle_t tmp;
         starpu_variable_data_register(&tmp, -1, 0, size);
+        // Data is not evicted to disk unless allowed (see Config::attach_disk)
+        starpu_data_set_ooc_flag(tmp, 0);
+        MemoryTracker::track(tmp, size);
         return tmp;
     }
     //! Register variable
@@ -378,12 +1785,14 @@ class VariableHandle: public Handle
         starpu_data_handle_t tmp;
         starpu_variable_data_register(&tmp, STARPU_MAIN_RAM,
                 reinterpret_cast<uintptr_t>(ptr), size);
+        starpu_data_set_ooc_flag(tmp, 0);
+        MemoryTracker::track(tmp, size);
         return tmp;
     }
 public:
     //! Constructor for variable that is (de)allocated by StarPU
     explicit VariableHandle(size_t size, starpu_data_access_mode mode):
-        Handle(_reg_data(size), mode)
+        Handle(_reg_data(size, mode), mode)
     {
     }
     //! Constructor for variable that is (de)allocated by user
@@ -392,6 +1801,148 @@ public:
         Handle(_reg_data(ptr, size), mode)
     {
     }
+    //! Constructor with shared pointer, e.g. for a part of a variable
+    explicit VariableHandle(std::shared_ptr<_starpu_data_state> handle_):
+        Handle(handle_)
+    {
+    }
+};
+
+//! Plan of a partition of a variable into contiguous parts
+/*! Parts are registered once by starpu_data_partition_plan and switched on
+ * and off asynchronously by partition_submit() and unpartition_submit(), so
+ * StarPU orders tasks on the whole variable and on its parts without copies
+ * of data, that is not replicated. Parts shall be accessed only while the
+ * variable is partitioned. Parts are unregistered by clean(), that shall be
+ * called while the variable is not partitioned.
+ * */
+class VariablePartition
+{
+    // Split data of a variable at given byte offsets
+    static void _filter(void *father_interface, void *child_interface,
+            starpu_data_filter *f, unsigned id, unsigned nparts)
+    {
+        auto father = reinterpret_cast<starpu_variable_interface *>(
+                father_interface);
+        auto child = reinterpret_cast<starpu_variable_interface *>(
+                child_interface);
+        auto bounds = reinterpret_cast<const size_t *>(f->filter_arg_ptr);
+        size_t offset = bounds[id];
+        child->id = father->id;
+        child->elemsize = bounds[id+1] - offset;
+        if(father->dev_handle)
+        {
+            if(father->ptr)
+            {
+                child->ptr = father->ptr + offset;
+            }
+            child->dev_handle = father->dev_handle;
+            child->offset = father->offset + offset;
+        }
+    }
+    // Parts do not own their StarPU handles, as clean() unregisters them
+    static void _deleter_part(starpu_data_handle_t ptr)
+    {
+    }
+public:
+    //! Partitioned variable
+    Handle parent;
+    //! Byte offsets of parts followed by the size of the variable
+    std::vector<size_t> bounds;
+    //! StarPU handles of parts
+    std::vector<starpu_data_handle_t> part_handles;
+    //! Parts as ordinary variables
+    std::vector<VariableHandle> parts;
+    VariablePartition(const VariablePartition &) = delete;
+    VariablePartition(VariablePartition &&) = default;
+    //! Plan a partition at given byte offsets
+    /*! With MPI parts are registered with tags, starting at last_tag, on
+     * the owner of the variable.
+     * */
+    explicit VariablePartition(const Handle &parent_,
+            const std::vector<size_t> &bounds_, starpu_mpi_tag_t &last_tag):
+        parent(parent_),
+        bounds(bounds_)
+    {
+        auto handle = static_cast<starpu_data_handle_t>(parent);
+        if(bounds.size() < 2 or bounds[0] != 0
+                or bounds.back() != starpu_variable_get_elemsize(handle))
+        {
+            throw std::runtime_error("Parts shall cover the whole variable");
+        }
+        Index nparts = bounds.size() - 1;
+        for(Index i = 0; i < nparts; ++i)
+        {
+            if(bounds[i] >= bounds[i+1])
+            {
+                throw std::runtime_error("Parts shall not be empty");
+            }
+        }
+        starpu_data_filter filter;
+        std::memset(&filter, 0, sizeof(filter));
+        filter.filter_func = _filter;
+        filter.nchildren = nparts;
+        filter.filter_arg_ptr = bounds.data();
+        part_handles.resize(nparts);
+        starpu_data_partition_plan(handle, &filter, part_handles.data());
+        parts.reserve(nparts);
+        for(Index i = 0; i < nparts; ++i)
+        {
+            parts.emplace_back(std::shared_ptr<_starpu_data_state>(
+                        part_handles[i], _deleter_part));
+#ifdef NNTILE_USE_MPI
+            starpu_mpi_data_register(part_handles[i], last_tag,
+                    parent.mpi_get_rank());
+            ++last_tag;
+#endif // NNTILE_USE_MPI
+        }
+    }
+    //! Submit switch from the whole variable to its parts
+    void partition_submit() const
+    {
+        // Cached copy of a remote variable becomes stale
+        parent.mpi_flush();
+        starpu_data_partition_submit(static_cast<starpu_data_handle_t>(
+                    parent), part_handles.size(),
+                const_cast<starpu_data_handle_t *>(part_handles.data()));
+    }
+    //! Submit switch from parts back to the whole variable
+    void unpartition_submit() const
+    {
+        for(const auto &part: parts)
+        {
+            part.mpi_flush();
+        }
+        starpu_data_unpartition_submit(static_cast<starpu_data_handle_t>(
+                    parent), part_handles.size(),
+                const_cast<starpu_data_handle_t *>(part_handles.data()),
+                -1);
+    }
+    //! Unregister parts
+    void clean()
+    {
+        if(part_handles.empty())
+        {
+            return;
+        }
+        parts.clear();
+        starpu_data_partition_clean(static_cast<starpu_data_handle_t>(
+                    parent), part_handles.size(), part_handles.data());
+        part_handles.clear();
+    }
+};
+
+//! Statistics of tasks of a single codelet, executed by a single worker
+struct CodeletWorkerStats
+{
+    //! Number of executed tasks
+    std::size_t ntasks = 0;
+    //! Total execution time in seconds
+    double time = 0;
+    //! Total number of floating point operations, declared by tasks
+    double flops = 0;
+    //! Total number of bytes read and written by tasks
+    double bytes = 0;
 };
 
 //! StarPU codelet+perfmodel wrapper
@@ -399,11 +1950,100 @@ class Codelet: public starpu_codelet, public starpu_perfmodel
 {
 private:
     uint32_t where_default = STARPU_NOWHERE; // uninitialized value
+    // Actual implementations, that are wrapped when statistics are collected
+    starpu_cpu_func_t cpu_funcs_orig[STARPU_MAXIMPLEMENTATIONS] = {};
+    starpu_cuda_func_t cuda_funcs_orig[STARPU_MAXIMPLEMENTATIONS] = {};
+    // All initialized codelets
+    static inline std::vector<Codelet *> registry;
+    // Whether statistics of executed tasks are collected
+    static inline bool stats_enabled = false;
+    // Update statistics of the current worker by a finished task
+    void _stats_record(starpu_task *task, double time)
+    {
+        int workerid = starpu_worker_get_id();
+        if(workerid < 0 or workerid >= stats.size())
+        {
+            return;
+        }
+        // Each worker updates only its own entry, no locking is needed
+        auto &s = stats[workerid];
+        ++s.ntasks;
+        s.time += time;
+        s.flops += task->flops;
+        for(unsigned i = 0; i < STARPU_TASK_GET_NBUFFERS(task); ++i)
+        {
+            auto mode = STARPU_TASK_GET_MODE(task, i);
+            double size = starpu_data_get_size(STARPU_TASK_GET_HANDLE(task,
+                        i));
+            if(mode & STARPU_R)
+            {
+                s.bytes += size;
+            }
+            if(mode & STARPU_W)
+            {
+                s.bytes += size;
+            }
+        }
+    }
+    // CPU implementation, that measures time of the actual one
+    static void _cpu_stats_func(void *buffers[], void *cl_args)
+    {
+        starpu_task *task = starpu_task_get_current();
+        auto cl = static_cast<Codelet *>(task->cl);
+        unsigned impl = starpu_task_get_implementation(task);
+        auto start = std::chrono::steady_clock::now();
+        cl->cpu_funcs_orig[impl](buffers, cl_args);
+        auto end = std::chrono::steady_clock::now();
+        cl->_stats_record(task,
+                std::chrono::duration<double>(end-start).count());
+    }
+    // CUDA implementation, that measures time of the actual one
+    static void _cuda_stats_func(void *buffers[], void *cl_args)
+    {
+        starpu_task *task = starpu_task_get_current();
+        auto cl = static_cast<Codelet *>(task->cl);
+        unsigned impl = starpu_task_get_implementation(task);
+        auto start = std::chrono::steady_clock::now();
+        cl->cuda_funcs_orig[impl](buffers, cl_args);
+#ifdef NNTILE_USE_CUDA
+        // Kernels are asynchronous, so wait for them to get proper timings
+        cudaStreamSynchronize(starpu_cuda_get_local_stream());
+#endif // NNTILE_USE_CUDA
+        auto end = std::chrono::steady_clock::now();
+        cl->_stats_record(task,
+                std::chrono::duration<double>(end-start).count());
+    }
+    // Switch between actual and wrapped implementations
+    void _stats_set(bool enable)
+    {
+        if(enable and stats.size() == 0)
+        {
+            stats.resize(starpu_worker_get_count());
+        }
+        for(int i = 0; i < STARPU_MAXIMPLEMENTATIONS; ++i)
+        {
+            if(cpu_funcs_orig[i])
+            {
+                starpu_codelet::cpu_funcs[i] = enable ? _cpu_stats_func
+                    : cpu_funcs_orig[i];
+            }
+            if(cuda_funcs_orig[i])
+            {
+                starpu_codelet::cuda_funcs[i] = enable ? _cuda_stats_func
+                    : cuda_funcs_orig[i];
+            }
+        }
+    }
 public:
+    //! Statistics of executed tasks per worker
+    std::vector<CodeletWorkerStats> stats;
     //! Zero-initialize codelet
     Codelet()
     {
-        std::memset(this, 0, sizeof(*this));
+        std::memset(static_cast<starpu_codelet *>(this), 0,
+                sizeof(starpu_codelet));
+        std::memset(static_cast<starpu_perfmodel *>(this), 0,
+                sizeof(starpu_perfmodel));
     }
     void init(const char *name_, uint32_t (*footprint_)(starpu_task *),
             std::initializer_list<starpu_cpu_func_t> cpu_funcs_,
@@ -431,7 +2071,7 @@ public:
             {
                 if(*it)
                 {
-                    starpu_codelet::cpu_funcs[i] = *it;
+                    starpu_codelet::cpu_funcs[i] = cpu_funcs_orig[i] = *it;
                     starpu_codelet::where = where_default = STARPU_CPU;
                 }
             }
@@ -448,13 +2088,20 @@ public:
             {
                 if(*it)
                 {
-                    starpu_codelet::cuda_funcs[i] = *it;
+                    starpu_codelet::cuda_funcs[i] = cuda_funcs_orig[i] = *it;
                     starpu_codelet::cuda_flags[i] = STARPU_CUDA_ASYNC;
                     where_default = where_default | STARPU_CUDA;
                     starpu_codelet::where = where_default;
                 }
             }
         }
+        // Register codelet to collect statistics of its tasks
+        if(std::find(registry.begin(), registry.end(), this)
+                == registry.end())
+        {
+            registry.push_back(this);
+        }
+        _stats_set(stats_enabled);
     }
     void restrict_where(uint32_t where_)
     {
@@ -471,6 +2118,67 @@ public:
     {
         starpu_codelet::where = where_default;
     }
+    //! Allow CPU implementations to be executed by parallel workers
+    /*! Tasks become of STARPU_FORKJOIN type: a CPU implementation is called
+     * once by the master of a combined worker and is allowed to use
+     * starpu_combined_worker_get_size() threads. Combined workers are used
+     * only by parallel-aware schedulers (e.g., pheft or peager), while other
+     * schedulers execute such tasks on ordinary workers with a single
+     * thread.
+     *
+     * @param[in] max_parallelism: Maximal size of a combined worker
+     * */
+    void set_parallel(int max_parallelism=INT_MAX)
+    {
+        starpu_codelet::type = STARPU_FORKJOIN;
+        starpu_codelet::max_parallelism = max_parallelism;
+    }
+    //! Get all initialized codelets
+    static const std::vector<Codelet *> &get_registry()
+    {
+        return registry;
+    }
+    //! Start collecting statistics of executed tasks of all codelets
+    /*! Implementations of codelets are wrapped to measure time of each task
+     * and to account FLOPs (as declared by STARPU_FLOPS on submission) and
+     * bytes of all its buffers. Timings of CUDA tasks require
+     * synchronization of the CUDA stream of a worker, so collecting
+     * statistics slows down execution. Shall be called when no tasks are
+     * being executed.
+     * */
+    static void stats_enable()
+    {
+        stats_enabled = true;
+        for(auto cl: registry)
+        {
+            cl->_stats_set(true);
+        }
+    }
+    //! Stop collecting statistics, collected values are kept
+    static void stats_disable()
+    {
+        stats_enabled = false;
+        for(auto cl: registry)
+        {
+            cl->_stats_set(false);
+        }
+    }
+    //! Check if statistics are collected
+    static bool stats_is_enabled()
+    {
+        return stats_enabled;
+    }
+    //! Reset statistics of all codelets
+    /*! Shall be called when no tasks are being executed.
+     * */
+    static void stats_reset()
+    {
+        for(auto cl: registry)
+        {
+            std::fill(cl->stats.begin(), cl->stats.end(),
+                    CodeletWorkerStats());
+        }
+    }
 };
 
 } // namespace config
@@ -80,8 +80,8 @@ void restore_where();
 
 template <typename T>
 void submit(Index offset_n, Index offset_m, Index batch, Index src_n,
-            Index src_m, Handle src, Index kernel_n, Index kernel_m,
-            Handle kernel, Index dst_n, Index dst_m, Handle dst);
+            Index src_m, HandleRef src, Index kernel_n, Index kernel_m,
+            HandleRef kernel, Index dst_n, Index dst_m, HandleRef dst);
 
 } // namespace conv2d
 } // namespace starpu
@@ -0,0 +1,90 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/conv2d_backward_weight.hh
+ * StarPU wrappers for gradient of 2D-Convolution over kernel
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <nntile/defs.h>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace conv2d_backward_weight
+{
+
+//! Structure for arguments, shapes are the same as of the forward conv2d
+struct args_t
+{
+    Index offset_n;
+    Index offset_m;
+    Index batch;
+    Index src_n;
+    Index src_m;
+    Index kernel_n;
+    Index kernel_m;
+    Index dst_n;
+    Index dst_m;
+};
+
+// StarPU wrapper for kernel::conv2d::cpu_backward_weight<T>
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// StarPU wrapper for kernel::conv2d::cuda_backward_weight<T>
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet_fp32, codelet_fp64;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template <typename T>
+void submit(Index offset_n, Index offset_m, Index batch, Index src_n,
+        Index src_m, HandleRef src, Index dst_n, Index dst_m,
+        HandleRef dst_grad, Index kernel_n, Index kernel_m,
+        HandleRef kernel_grad);
+
+} // namespace conv2d_backward_weight
+} // namespace starpu
+} // namespace nntile
+
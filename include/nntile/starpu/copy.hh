@@ -43,7 +43,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 //! Insert task to copy buffer
-void submit(Handle src, Handle dst);
+void submit(HandleRef src, HandleRef dst);
 
 } // namespace copy
 } // namespace starpu
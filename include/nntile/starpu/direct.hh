@@ -0,0 +1,89 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/direct.hh
+ * Direct execution of tasks by the submitting thread
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <starpu.h>
+#include <nntile/starpu/scheduler.hh>
+#include <cerrno>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace direct
+{
+
+//! Execute all the following tasks directly by the submitting thread
+/*! Instead of going through dependency tracking and scheduling of StarPU,
+ * CPU implementation of a codelet is called right at submission, after all
+ * the buffers of the task are acquired in host RAM. Tasks are executed in
+ * order of submission, so the result is the same as with the scheduler. It
+ * removes the overhead of StarPU per a task, that dominates latency of small
+ * models on a single node. Tasks, that can not be executed directly (e.g.,
+ * codelet is restricted to CUDA, parallel codelets or statistics of tasks
+ * are collected), are submitted to StarPU as usual.
+ * */
+void enter();
+
+//! Submit all the following tasks to StarPU
+void exit();
+
+//! Check if tasks are executed directly
+bool is_active();
+
+//! Execute a task, built by starpu_task_build(), and destroy it
+/*! Returns the same value as starpu_task_insert() would return.
+ * */
+int execute(starpu_task *task);
+
+} // namespace direct
+
+// Insert a task directly or by StarPU
+template<typename... Args>
+int _task_insert(starpu_codelet *cl, Args... args)
+{
+    if(not direct::is_active())
+    {
+        return starpu_task_insert(cl, args...);
+    }
+    starpu_task *task = starpu_task_build(cl, args...);
+    if(task == nullptr)
+    {
+        return -EINVAL;
+    }
+    return direct::execute(task);
+}
+
+//! Insert a task with the same arguments as starpu_task_insert()
+/*! Task is executed directly by the calling thread if direct mode is active
+ * (see direct::enter()), otherwise it is passed to StarPU. Kinds of workers
+ * of the task are restricted by scheduler::where_get(), if the codelet
+ * supports any of them.
+ * */
+template<typename... Args>
+int task_insert(starpu_codelet *cl, Args... args)
+{
+    uint32_t where = scheduler::where_get() & cl->where;
+    if(where != 0)
+    {
+        return _task_insert(cl, STARPU_TASK_WHERE, static_cast<int>(where),
+                args...);
+    }
+    return _task_insert(cl, args...);
+}
+
+} // namespace starpu
+} // namespace nntile
+
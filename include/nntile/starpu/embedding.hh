@@ -33,6 +33,8 @@ struct args_t
     Index k;
     Index k_start;
     Index k_size;
+    Index vocab_start;
+    Index vocab_size;
 };
 
 // Copy embedding from vocabulary within StarPU buffers on CPU
@@ -69,7 +71,8 @@ void restore_where();
 
 template<typename T>
 void submit(Index m, Index n, Index k, Index k_start, Index k_size,
-        Handle index, Handle vocab, Handle embed);
+        Index vocab_start, Index vocab_size, HandleRef index, HandleRef vocab,
+        HandleRef embed);
 
 } // namespace embedding
 } // namespace starpu
@@ -33,6 +33,8 @@ struct args_t
     Index k;
     Index k_start;
     Index k_size;
+    Index vocab_start;
+    Index vocab_size;
 };
 
 template<typename T>
@@ -68,7 +70,8 @@ void restore_where();
 
 template<typename T>
 void submit(Index m, Index n, Index k, Index k_start, Index k_size,
-        Handle index, Handle embed, Handle vocab, int redux=0);
+        Index vocab_start, Index vocab_size, HandleRef index, HandleRef embed,
+        HandleRef vocab, HandleRef tmp, int redux=0);
 
 } // namespace embedding_backward
 } // namespace starpu
@@ -0,0 +1,52 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/embedding_rows.hh
+ * Mark rows of vocabulary, used by tokens, within StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-13
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <nntile/defs.h>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace embedding_rows
+{
+
+// Mark used rows of vocabulary within a StarPU buffer on CPU
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// Mark used rows of vocabulary within a StarPU buffer on CUDA
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet;
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+//! Insert task to mark rows of vocabulary, used by tokens
+void submit(HandleRef index, HandleRef rows);
+
+} // namespace embedding_rows
+} // namespace starpu
+} // namespace nntile
+
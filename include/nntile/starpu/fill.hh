@@ -73,7 +73,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index nelems, T val, Handle data);
+void submit(Index nelems, T val, HandleRef data);
 
 } // namespace fill
 } // namespace starpu
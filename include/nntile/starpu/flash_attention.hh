@@ -0,0 +1,89 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/flash_attention.hh
+ * Fused single-pass flash attention forward
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <nntile/defs.h>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace flash_attention
+{
+
+//! Structure for arguments
+struct args_t
+{
+    Index seq;
+    Index head;
+    Index batch;
+    // Heads of queries per head of keys and values for grouped-query
+    // attention, batch consists of n_batch sequences times heads
+    Index n_batch;
+    Index kv_group;
+    // Causal tile of mask is generated by the kernel instead of being read
+    int mask_causal;
+};
+
+// Fused single-pass flash attention forward for StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// Fused single-pass flash attention forward for StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet_fp32, codelet_fp64;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T>
+void submit(Index seq, Index head, Index batch, HandleRef K, HandleRef Q,
+        HandleRef mask, HandleRef V, HandleRef maxsumexp, HandleRef A,
+        Index n_batch=1, Index kv_group=1, int mask_causal=0);
+
+} // namespace flash_attention
+} // namespace starpu
+} // namespace nntile
+
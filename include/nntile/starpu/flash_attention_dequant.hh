@@ -0,0 +1,91 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/flash_attention_dequant.hh
+ * Fused attention over quantized keys and values for StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <nntile/defs.h>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace flash_attention_dequant
+{
+
+//! Structure for arguments
+struct args_t
+{
+    Index k_seq;
+    Index q_seq;
+    Index head;
+    Index batch;
+    // Heads of queries per head of keys and values for grouped-query
+    // attention, batch consists of n_batch sequences times heads
+    Index n_batch;
+    Index kv_group;
+    // Stride of mask between sequences, zero for a shared mask
+    Index mask_stride;
+};
+
+// StarPU wrapper for kernel::flash_attention_dequant::cpu<Q>
+template<typename Q>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// StarPU wrapper for kernel::flash_attention_dequant::cuda<Q>
+template<typename Q>
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet_int8, codelet_fp8_e4m3;
+
+template<typename Q>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<std::int8_t>()
+{
+    return &codelet_int8;
+}
+
+template<>
+constexpr Codelet *codelet<fp8_e4m3_t>()
+{
+    return &codelet_fp8_e4m3;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename Q>
+void submit(Index k_seq, Index q_seq, Index head, Index batch, HandleRef K,
+        HandleRef K_scale, HandleRef query, HandleRef mask, HandleRef V,
+        HandleRef V_scale, HandleRef maxsumexp, HandleRef A, Index n_batch=1,
+        Index kv_group=1, Index mask_stride=0);
+
+} // namespace flash_attention_dequant
+} // namespace starpu
+} // namespace nntile
+
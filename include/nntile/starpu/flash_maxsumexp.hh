@@ -30,6 +30,12 @@ struct args_t
     Index seq;
     Index head;
     Index batch;
+    // Batch of Q is n_batch by heads, every kv_group consecutive heads of Q
+    // share the same head of K (grouped-query attention)
+    Index n_batch;
+    Index kv_group;
+    // Tile of mask has no false entries, so it is not applied at all
+    int mask_full;
 };
 
 #ifdef NNTILE_USE_CBLAS
@@ -72,9 +78,10 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index seq, Index head, Index batch, Handle K, Handle Q,
-        Handle mask, Handle maxsumexp, Handle tmp, int redux=0,
-        int fp32_fast_tf32=0);
+void submit(Index seq, Index head, Index batch, HandleRef K, HandleRef Q,
+        HandleRef mask, HandleRef maxsumexp, HandleRef tmp, int redux=0,
+        int fp32_fast_tf32=0, Index n_batch=1, Index kv_group=1,
+        int mask_full=0);
 
 } // namespace flash_maxsumexp
 } // namespace starpu
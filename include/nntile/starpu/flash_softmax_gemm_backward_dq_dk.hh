@@ -30,6 +30,11 @@ struct args_t
     Index seq;
     Index head;
     Index batch;
+    // Dropout of attention weights, mask is regenerated from seed and index
+    // of random sequence of a tile, no dropout if dropout_p is zero
+    fp64_t dropout_p;
+    unsigned long long seed;
+    Index sequence;
 };
 
 #ifdef NNTILE_USE_CBLAS
@@ -72,10 +77,11 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index seq, Index head, Index batch, Handle K, Handle Q,
-        Handle mask, Handle maxsumexp, Handle dA, Handle V,
-        Handle sumprod_slice, Handle dQ, Handle dK, Handle tmp,
-        Handle tmp_grad, int redux=0, int fp32_fast_tf32=0);
+void submit(Index seq, Index head, Index batch, HandleRef K, HandleRef Q,
+        HandleRef mask, HandleRef maxsumexp, HandleRef dA, HandleRef V,
+        HandleRef sumprod_slice, HandleRef dQ, HandleRef dK, HandleRef tmp,
+        HandleRef tmp_grad, int redux=0, int fp32_fast_tf32=0, T dropout_p=0,
+        unsigned long long seed=0, Index sequence=0);
 
 } // namespace flash_softmax_gemm_backward_dq_dk
 } // namespace starpu
@@ -41,7 +41,7 @@ void restrict_where(uint32_t where);
 
 void restore_where();
 
-void submit(Index nelems, Handle src, Handle dst);
+void submit(Index nelems, HandleRef src, HandleRef dst);
 
 } // namespace fp16_to_fp32
 } // namespace starpu
@@ -0,0 +1,84 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/fused_elementwise.hh
+ * Chain of elementwise operations on StarPU buffers by a single task
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <nntile/kernel/fused_elementwise/program.hh>
+#include <vector>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace fused_elementwise
+{
+
+//! Structure for arguments
+template<typename T>
+struct args_t
+{
+    Index nelems;
+    kernel::fused_elementwise::program_t<T> program;
+};
+
+// Apply a program of elementwise operations to StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// Apply a program of elementwise operations to StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet_fp32, codelet_fp64;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T>
+void submit(Index nelems,
+        const kernel::fused_elementwise::program_t<T> &program,
+        const std::vector<Handle> &buffers);
+
+} // namespace fused_elementwise
+} // namespace starpu
+} // namespace nntile
+
@@ -64,7 +64,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index nelems, Handle data);
+void submit(Index nelems, HandleRef data);
 
 } // namespace gelu
 } // namespace starpu
@@ -64,7 +64,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index nelems, Handle src, Handle dst);
+void submit(Index nelems, HandleRef src, HandleRef dst);
 
 } // namespace gelutanh
 } // namespace starpu
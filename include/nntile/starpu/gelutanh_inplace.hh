@@ -36,7 +36,7 @@ void cuda(void *buffers[], void *cl_args)
     noexcept;
 #endif // NNTILE_USE_CUDA
 
-extern Codelet codelet_fp32, codelet_fp64;
+extern Codelet codelet_fp32, codelet_fp64, codelet_bf16, codelet_fp16;
 
 template<typename T>
 constexpr Codelet *codelet()
@@ -57,6 +57,18 @@ constexpr Codelet *codelet<fp64_t>()
     return &codelet_fp64;
 }
 
+template<>
+constexpr Codelet *codelet<bf16_t>()
+{
+    return &codelet_bf16;
+}
+
+template<>
+constexpr Codelet *codelet<fp16_t>()
+{
+    return &codelet_fp16;
+}
+
 void init();
 
 void restrict_where(uint32_t where);
@@ -64,7 +76,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index nelems, Handle data);
+void submit(Index nelems, HandleRef data);
 
 } // namespace gelutanh_inplace
 } // namespace starpu
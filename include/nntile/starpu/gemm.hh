@@ -38,18 +38,31 @@ struct args_t
     Index batch; // Number of gemms in a batch
     T_scal alpha;
     T_scal beta;
+    GemmCompute compute; // Compute mode on CUDA devices
 };
 
 #ifdef NNTILE_USE_CBLAS
 template<typename T>
 void cpu(void *buffers[], void *cl_args)
     noexcept;
+
+template<typename T>
+void cpu_half(void *buffers[], void *cl_args)
+    noexcept;
+
+template<typename T>
+void cpu_mixed(void *buffers[], void *cl_args)
+    noexcept;
 #endif // NNTILE_USE_CBLAS
 
 #ifdef NNTILE_USE_CUDA
 template<typename T, typename T_scal>
 void cuda(void *buffers[], void *cl_args)
     noexcept;
+
+template<typename T>
+void cuda_mixed(void *buffers[], void *cl_args)
+    noexcept;
 #endif // NNTILE_USE_CUDA
 
 extern Codelet codelet_NN_fp32, codelet_NN_fp64,
@@ -60,6 +73,16 @@ extern Codelet codelet_NN_fp32, codelet_NN_fp64,
 extern Codelet codelet_NN_fp16, codelet_NT_fp16,
        codelet_TN_fp16, codelet_TT_fp16;
 
+extern Codelet codelet_NN_bf16, codelet_NT_bf16,
+       codelet_TN_bf16, codelet_TT_bf16;
+
+// Codelets for fp16_t and bf16_t matrices A and B and fp32_t matrix C
+extern Codelet codelet_NN_fp16_fp32, codelet_NT_fp16_fp32,
+       codelet_TN_fp16_fp32, codelet_TT_fp16_fp32;
+
+extern Codelet codelet_NN_bf16_fp32, codelet_NT_bf16_fp32,
+       codelet_TN_bf16_fp32, codelet_TT_bf16_fp32;
+
 template<typename T>
 static
 Codelet *codelet(TransOp transA, TransOp transB)
@@ -158,6 +181,104 @@ Codelet *codelet<fp16_t>(TransOp transA, TransOp transB)
     }
 }
 
+template<>
+Codelet *codelet<bf16_t>(TransOp transA, TransOp transB)
+{
+    switch(transA.value)
+    {
+        case TransOp::NoTrans:
+            switch(transB.value)
+            {
+                case TransOp::NoTrans:
+                    return &codelet_NN_bf16;
+                default:
+                // This parameter was already checked in gemm_check_opA_opB
+                //case TransOp::Trans:
+                    return &codelet_NT_bf16;
+            }
+        // This parameter was already checked in gemm_check_opA_opB
+        //case TransOp::Trans:
+        default:
+            switch(transB.value)
+            {
+                case TransOp::NoTrans:
+                    return &codelet_TN_bf16;
+                // This parameter was already checked in gemm_check_opA_opB
+                //case TransOp::Trans:
+                default:
+                    return &codelet_TT_bf16;
+            }
+    }
+}
+
+template<typename T>
+static
+Codelet *codelet_mixed(TransOp transA, TransOp transB)
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+Codelet *codelet_mixed<fp16_t>(TransOp transA, TransOp transB)
+{
+    switch(transA.value)
+    {
+        case TransOp::NoTrans:
+            switch(transB.value)
+            {
+                case TransOp::NoTrans:
+                    return &codelet_NN_fp16_fp32;
+                default:
+                // This parameter was already checked in gemm_check_opA_opB
+                //case TransOp::Trans:
+                    return &codelet_NT_fp16_fp32;
+            }
+        // This parameter was already checked in gemm_check_opA_opB
+        //case TransOp::Trans:
+        default:
+            switch(transB.value)
+            {
+                case TransOp::NoTrans:
+                    return &codelet_TN_fp16_fp32;
+                // This parameter was already checked in gemm_check_opA_opB
+                //case TransOp::Trans:
+                default:
+                    return &codelet_TT_fp16_fp32;
+            }
+    }
+}
+
+template<>
+Codelet *codelet_mixed<bf16_t>(TransOp transA, TransOp transB)
+{
+    switch(transA.value)
+    {
+        case TransOp::NoTrans:
+            switch(transB.value)
+            {
+                case TransOp::NoTrans:
+                    return &codelet_NN_bf16_fp32;
+                default:
+                // This parameter was already checked in gemm_check_opA_opB
+                //case TransOp::Trans:
+                    return &codelet_NT_bf16_fp32;
+            }
+        // This parameter was already checked in gemm_check_opA_opB
+        //case TransOp::Trans:
+        default:
+            switch(transB.value)
+            {
+                case TransOp::NoTrans:
+                    return &codelet_TN_bf16_fp32;
+                // This parameter was already checked in gemm_check_opA_opB
+                //case TransOp::Trans:
+                default:
+                    return &codelet_TT_bf16_fp32;
+            }
+    }
+}
+
 void init();
 
 void restrict_where(uint32_t where);
@@ -166,8 +287,27 @@ void restore_where();
 
 template<typename T, typename T_scal>
 void submit(const TransOp &transA, const TransOp &transB, Index m, Index n,
-        Index k, Index batch, T_scal alpha, Handle A, Handle B, T_scal beta,
-        Handle C, int redux=0);
+        Index k, Index batch, T_scal alpha, HandleRef A, HandleRef B,
+        T_scal beta, HandleRef C, int redux=0,
+        GemmCompute compute=GemmCompute(GemmCompute::Default));
+
+template<typename T>
+void submit_mixed(const TransOp &transA, const TransOp &transB, Index m,
+        Index n, Index k, Index batch, fp32_t alpha, HandleRef A, HandleRef B,
+        fp32_t beta, HandleRef C, int redux=0,
+        GemmCompute compute=GemmCompute(GemmCompute::Default));
+
+//! Expected time of a task on a worker by the calibrated performance model
+/*! Time is in microseconds, as returned by starpu_task_expected_length. NaN
+ * is returned if the model is not calibrated for the sizes on the kind of
+ * the worker. Handles are used only to describe the task, that is never
+ * submitted.
+ * */
+template<typename T, typename T_scal>
+double expected_time(int workerid, const TransOp &transA,
+        const TransOp &transB, Index m, Index n, Index k, Index batch,
+        HandleRef A, HandleRef B, HandleRef C,
+        GemmCompute compute=GemmCompute(GemmCompute::Default));
 
 } // namespace gemm
 } // namespace starpu
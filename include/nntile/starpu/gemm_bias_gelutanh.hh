@@ -0,0 +1,89 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/gemm_bias_gelutanh.hh
+ * GEMM with fused bias addition and approximate GeLU of StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/constants.hh>
+// This also includes all definitions
+#include <nntile/starpu/config.hh>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace gemm_bias_gelutanh
+{
+
+//! Structure for arguments
+template<typename T>
+struct args_t
+{
+    TransOp transA; // op(A)
+    TransOp transB; // op(B)
+    Index m; // Number of rows of op(A) and C
+    Index n; // Number of columns of op(B) and C
+    Index k; // Number of columns of op(A) and number of rows of op(B)
+    Index bias_axis; // 0 for bias of length m, 1 for bias of length n
+    T alpha;
+};
+
+#ifdef NNTILE_USE_CBLAS
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CBLAS
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet_fp32, codelet_fp64;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T>
+void submit(const TransOp &transA, const TransOp &transB, Index m, Index n,
+        Index k, Index bias_axis, T alpha, HandleRef A, HandleRef B,
+        HandleRef bias, HandleRef C, HandleRef D);
+
+} // namespace gemm_bias_gelutanh
+} // namespace starpu
+} // namespace nntile
+
@@ -0,0 +1,84 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/gemm_dequant.hh
+ * Gemm with dequantization of 8-bit weights on the fly on StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace gemm_dequant
+{
+
+//! Structure for arguments
+struct args_t
+{
+    Index m;
+    Index n;
+    Index k;
+    Index group;
+    fp32_t alpha;
+    fp32_t beta;
+};
+
+// StarPU wrapper for kernel::gemm_dequant::cpu<Q>
+template<typename Q>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// StarPU wrapper for kernel::gemm_dequant::cuda<Q>
+template<typename Q>
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet_int8, codelet_fp8_e4m3;
+
+template<typename Q>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<std::int8_t>()
+{
+    return &codelet_int8;
+}
+
+template<>
+constexpr Codelet *codelet<fp8_e4m3_t>()
+{
+    return &codelet_fp8_e4m3;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename Q>
+void submit(Index m, Index n, Index k, Index group, fp32_t alpha, HandleRef A,
+        HandleRef scale, HandleRef B, fp32_t beta, HandleRef C);
+
+} // namespace gemm_dequant
+} // namespace starpu
+} // namespace nntile
+
@@ -23,80 +23,14 @@ namespace nntile
 {
 namespace starpu
 {
+//! Gemm with TF32 tensor cores, that is a shortcut for starpu::gemm
 namespace gemm_ex
 {
 
-//! Structure for arguments
-template<typename T>
-struct args_t
-{
-    TransOp transA; // op(A)
-    TransOp transB; // op(B)
-    Index m; // Number of rows of op(A) and C
-    Index n; // Number of columns of op(B) and C
-    Index k; // Number of columns of op(A) and number of rows of op(B)
-    Index batch; // Number of gemms in a batch
-    T alpha;
-    T beta;
-};
-
-#ifdef NNTILE_USE_CUDA
-template<typename T>
-void cuda(void *buffers[], void *cl_args)
-    noexcept;
-#endif // NNTILE_USE_CUDA
-
-extern Codelet codelet_NN_fp32, codelet_NT_fp32, codelet_TN_fp32,
-       codelet_TT_fp32;
-
-template<typename T>
-static
-Codelet *codelet(TransOp transA, TransOp transB)
-{
-    throw std::runtime_error("Non-supported type");
-    return nullptr;
-}
-
-template<>
-Codelet *codelet<fp32_t>(TransOp transA, TransOp transB)
-{
-    switch(transA.value)
-    {
-        case TransOp::NoTrans:
-            switch(transB.value)
-            {
-                case TransOp::NoTrans:
-                    return &codelet_NN_fp32;
-                default:
-                // This parameter was already checked in gemm_check_opA_opB
-                //case TransOp::Trans:
-                    return &codelet_NT_fp32;
-            }
-        // This parameter was already checked in gemm_check_opA_opB
-        //case TransOp::Trans:
-        default:
-            switch(transB.value)
-            {
-                case TransOp::NoTrans:
-                    return &codelet_TN_fp32;
-                // This parameter was already checked in gemm_check_opA_opB
-                //case TransOp::Trans:
-                default:
-                    return &codelet_TT_fp32;
-            }
-    }
-}
-
-void init();
-
-void restrict_where(uint32_t where);
-
-void restore_where();
-
 template<typename T>
 void submit(const TransOp &transA, const TransOp &transB, Index m, Index n,
-        Index k, Index batch, T alpha, Handle A, Handle B, T beta, Handle C,
-        int redux=0);
+        Index k, Index batch, T alpha, HandleRef A, HandleRef B, T beta,
+        HandleRef C, int redux=0);
 
 } // namespace gemm_ex
 } // namespace starpu
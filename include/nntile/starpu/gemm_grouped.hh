@@ -0,0 +1,100 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/gemm_grouped.hh
+ * Grouped GEMM operation for StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/constants.hh>
+// This also includes all definitions
+#include <nntile/starpu/config.hh>
+#include <vector>
+
+namespace nntile
+{
+namespace starpu
+{
+//! Several independent products of tiles of the same shape in a single task
+/*! Buffers of a task are ntiles tiles A, followed by ntiles tiles B and
+ * ntiles tiles C, and every triple of tiles is multiplied as by starpu::gemm.
+ * This amortizes overhead of tasks and of calls of BLAS over many tiny tiles.
+ * */
+namespace gemm_grouped
+{
+
+//! Structure for arguments
+template<typename T>
+struct args_t
+{
+    TransOp transA; // op(A)
+    TransOp transB; // op(B)
+    Index m; // Number of rows of op(A) and C
+    Index n; // Number of columns of op(B) and C
+    Index k; // Number of columns of op(A) and number of rows of op(B)
+    Index batch; // Number of gemms in a batch of every tile
+    //! Number of triples of tiles
+    Index ntiles;
+    T alpha;
+    T beta;
+    GemmCompute compute; // Compute mode on CUDA devices
+};
+
+#ifdef NNTILE_USE_CBLAS
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CBLAS
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet_fp32, codelet_fp64;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T>
+void submit(const TransOp &transA, const TransOp &transB, Index m, Index n,
+        Index k, Index batch, T alpha, const std::vector<Handle> &A,
+        const std::vector<Handle> &B, T beta, const std::vector<Handle> &C,
+        GemmCompute compute=GemmCompute(GemmCompute::Default));
+
+} // namespace gemm_grouped
+} // namespace starpu
+} // namespace nntile
+
@@ -74,7 +74,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index nelems, T alpha, Handle src, T beta, Handle dst);
+void submit(Index nelems, T alpha, HandleRef src, T beta, HandleRef dst);
 
 } // namespace hypot
 } // namespace starpu
@@ -72,7 +72,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index nelems, T eps, T alpha, Handle dst);
+void submit(Index nelems, T eps, T alpha, HandleRef dst);
 
 } // namespace hypot_scalar_inverse
 } // namespace starpu
@@ -63,7 +63,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index nelems, Handle maxsumexp, Handle logsumexp);
+void submit(Index nelems, HandleRef maxsumexp, HandleRef logsumexp);
 
 } // namespace logsumexp
 } // namespace starpu
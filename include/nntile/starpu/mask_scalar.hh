@@ -75,7 +75,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index nrows, Index ncols, Handle mask, T val, Handle data);
+void submit(Index nrows, Index ncols, HandleRef mask, T val, HandleRef data);
 
 } // namespace mask_scalar
 } // namespace starpu
@@ -0,0 +1,91 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/moe_combine.hh
+ * StarPU wrappers for weighted scatter of buffers of experts into tokens
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <nntile/defs.h>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace moe_combine
+{
+
+//! Structure for arguments
+struct args_t
+{
+    Index m;
+    Index seq;
+    Index seq_start;
+    Index seq_size;
+    Index batch_start;
+    Index batch_size;
+    Index capacity;
+    Index n_experts;
+    Index expert;
+    bool weighted;
+};
+
+// StarPU wrapper for kernel::moe_combine::cpu<T>
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// StarPU wrapper for kernel::moe_combine::cuda<T>
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet_fp32, codelet_fp64;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T>
+void submit(Index m, Index seq, Index seq_start, Index seq_size,
+        Index batch_start, Index batch_size, Index capacity, Index n_experts,
+        Index expert, HandleRef slots, HandleRef probs, HandleRef src,
+        HandleRef dst);
+
+} // namespace moe_combine
+} // namespace starpu
+} // namespace nntile
+
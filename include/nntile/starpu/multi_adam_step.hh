@@ -0,0 +1,93 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/multi_adam_step.hh
+ * Fused Adam and AdamW steps on many StarPU buffers by a single task
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-02
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <vector>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace multi_adam_step
+{
+
+//! Structure for arguments
+template<typename T>
+struct args_t
+{
+    Index ntensors;
+    Index num_iter;
+    T beta_1;
+    T beta_2;
+    T eps;
+    T lr;
+    T weight_decay;
+    bool decoupled;
+    //! Learning rate and scale of gradients are in the last buffer
+    bool scaled;
+};
+
+// Apply Adam or AdamW step to StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// Apply Adam or AdamW step to StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet_fp32, codelet_fp64;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T>
+void submit(Index num_iter, T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        bool decoupled, const std::vector<Handle> &grad,
+        const std::vector<Handle> &first_moment,
+        const std::vector<Handle> &second_moment,
+        const std::vector<Handle> &p, HandleRef scalars=HandleRef());
+
+} // namespace multi_adam_step
+} // namespace starpu
+} // namespace nntile
+
@@ -75,8 +75,8 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index m, Index n, Index k, T alpha, Handle src, T beta,
-        Handle dst, int redux=0);
+void submit(Index m, Index n, Index k, T alpha, HandleRef src, T beta,
+        HandleRef dst, int redux=0);
 
 } // namespace norm_slice
 } // namespace starpu
@@ -76,8 +76,8 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index m, Index n, Index k, Index l, T eps, Handle gamma_beta,
-        Handle sumnorm, Handle dst);
+void submit(Index m, Index n, Index k, Index l, T eps, HandleRef gamma_beta,
+        HandleRef sumnorm, HandleRef dst);
 
 } // namespace normalize
 } // namespace starpu
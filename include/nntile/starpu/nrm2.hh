@@ -26,15 +26,23 @@ namespace starpu
 namespace nrm2
 {
 
-#ifdef NNTILE_USE_CBLAS
-//! NRM2 for contiguous matrices without padding through StarPU buffers
+//! Structure for arguments
+template<typename T>
+struct args_t
+{
+    Index nelems;
+    T alpha;
+    T beta;
+    Index nwork;
+};
+
+//! NRM2 for contiguous buffers through StarPU buffers on CPU
 template<typename T>
 void cpu(void *buffers[], void *cl_args)
     noexcept;
-#endif // NNTILE_USE_CBLAS
 
 #ifdef NNTILE_USE_CUDA
-//! AXPY for contiguous matrices without padding through StarPU buffers
+//! NRM2 for contiguous buffers through StarPU buffers on CUDA
 template<typename T>
 void cuda(void *buffers[], void *cl_args)
     noexcept;
@@ -67,8 +75,13 @@ void restrict_where(uint32_t where);
 
 void restore_where();
 
+// dst = hypot(alpha*norm(src), beta*dst)
+template<typename T>
+void submit(Index nelems, T alpha, HandleRef src, T beta, HandleRef dst);
+
+// dst = norm(src)
 template<typename T>
-void submit(Index nelems, Handle src, Handle dst);
+void submit(Index nelems, HandleRef src, HandleRef dst);
 
 } // namespace nrm2
 } // namespace starpu
@@ -0,0 +1,47 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/offload.hh
+ * Submission of tasks to CPU workers only
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <starpu.h>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace offload
+{
+
+//! Submit all the following tasks of this thread to CPU workers
+/*! Tasks go to a separate scheduling context with all CPU workers, that is
+ * created at the first call. Data, that is accessed only by such tasks
+ * (e.g., master weights and moments of an optimizer), never leaves host
+ * RAM, while data, that is shared with other tasks, is transferred on
+ * demand. Does nothing if there are no CPU workers.
+ * */
+void enter();
+
+//! Submit all the following tasks to the previous scheduling context
+void exit();
+
+//! Check if tasks are submitted to CPU workers only
+bool is_active();
+
+//! Delete the scheduling context, shall be called before shutdown of StarPU
+void shutdown();
+
+} // namespace offload
+} // namespace starpu
+} // namespace nntile
+
@@ -74,7 +74,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index nelems, T alpha, T exp, Handle data);
+void submit(Index nelems, T alpha, T exp, HandleRef data);
 
 } // namespace pow
 } // namespace starpu
@@ -68,7 +68,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index m, Index n, Index k, T alpha, Handle src, Handle dst);
+void submit(Index m, Index n, Index k, T alpha, HandleRef src, HandleRef dst);
 
 } // namespace prod_fiber
 } // namespace starpu
@@ -68,8 +68,8 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index m, Index n, Index k, T alpha, Handle src1, Handle src2,
-        Handle dst);
+void submit(Index m, Index n, Index k, T alpha, HandleRef src1, HandleRef src2,
+        HandleRef dst);
 
 } // namespace prod_fiber3
 } // namespace starpu
@@ -0,0 +1,82 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/quantize.hh
+ * Quantization of weights into 8-bit types with per-group scales on StarPU
+ * buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace quantize
+{
+
+//! Structure for arguments
+struct args_t
+{
+    Index m;
+    Index k;
+    Index group;
+};
+
+// StarPU wrapper for kernel::quantize::cpu<Q>
+template<typename Q>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// StarPU wrapper for kernel::quantize::cuda<Q>
+template<typename Q>
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet_int8, codelet_fp8_e4m3;
+
+template<typename Q>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<std::int8_t>()
+{
+    return &codelet_int8;
+}
+
+template<>
+constexpr Codelet *codelet<fp8_e4m3_t>()
+{
+    return &codelet_fp8_e4m3;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename Q>
+void submit(Index m, Index k, Index group, HandleRef src, HandleRef dst,
+        HandleRef scale);
+
+} // namespace quantize
+} // namespace starpu
+} // namespace nntile
+
@@ -0,0 +1,68 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/quantized_adam_step.hh
+ * Fused Adam step with block-wise 8-bit moments with StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace quantized_adam_step
+{
+
+//! Structure for arguments
+struct args_t
+{
+    Index num_iter;
+    Index num_elems;
+    Index block;
+    fp32_t beta_1;
+    fp32_t beta_2;
+    fp32_t eps;
+    fp32_t lr;
+    fp32_t weight_decay;
+    bool decoupled;
+};
+
+// Apply Adam step with 8-bit moments to StarPU buffers on CPU
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// Apply Adam step with 8-bit moments to StarPU buffers on CUDA
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet;
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+void submit(Index num_iter, Index num_elems, Index block, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t lr, fp32_t weight_decay,
+        bool decoupled, HandleRef grad, HandleRef first_moment,
+        HandleRef first_scale, HandleRef second_moment,
+        HandleRef second_scale, HandleRef p);
+
+} // namespace quantized_adam_step
+} // namespace starpu
+} // namespace nntile
+
@@ -85,8 +85,8 @@ template<typename T>
 void submit(Index ndim, Index nelems, unsigned long long seed,
         T mean, T stddev, const std::vector<Index> &start,
         const std::vector<Index> &shape, const std::vector<Index> &stride,
-        const std::vector<Index> &underlying_shape, Handle data,
-        Handle tmp_index);
+        const std::vector<Index> &underlying_shape, HandleRef data,
+        HandleRef tmp_index);
 
 } // namespace randn
 } // namespace starpu
@@ -65,10 +65,11 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index nelems, Handle x, Handle dy, Handle dx);
+void submit(Index nelems, HandleRef x, HandleRef dy, HandleRef dx);
 
 template<typename T>
-void submit_mpi(Index nelems, Handle x, Handle dy, Handle dx, int exec_rank);
+void submit_mpi(Index nelems, HandleRef x, HandleRef dy, HandleRef dx,
+        int exec_rank);
 
 } // namespace relu_backward
 } // namespace starpu
@@ -73,7 +73,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index nelems, T alpha, Handle src, Handle dst);
+void submit(Index nelems, T alpha, HandleRef src, HandleRef dst);
 
 } // namespace scal
 } // namespace starpu
@@ -74,7 +74,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(T alpha, Index nelems, Handle data);
+void submit(T alpha, Index nelems, HandleRef data);
 
 } // namespace scal_inplace
 } // namespace starpu
@@ -0,0 +1,174 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/scheduler.hh
+ * Locality-aware StarPU scheduler with priorities
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <starpu.h>
+#include <cstdint>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace scheduler
+{
+
+//! Name of the scheduler for starpu::Config
+constexpr const char *name = "nntile_locality";
+
+//! Locality-aware scheduling policy
+/*! Every data handle, that is written by a task, is owned by a single CUDA
+ * worker, just like every tile is owned by a single MPI node. Tasks are
+ * queued to the owner of their first output buffer, so all updates of a
+ * tile happen on the same device and tiles do not travel between devices.
+ * Owners are set by set_device() or assigned on the first write to the
+ * CUDA worker with the shortest queue. Tasks, that cannot run on the owner,
+ * go to a shared queue. An idle CUDA worker steals from the longest queue
+ * of another CUDA worker only if that queue holds at least two tasks.
+ * Similarly, a data handle can be owned by a NUMA node (see set_numa()).
+ * Tasks, that are not queued to a CUDA worker, are queued to CPU workers of
+ * the NUMA node of their first output buffer, so that the buffer is
+ * allocated (first touched) and updated in memory of the node. An idle CPU
+ * worker takes tasks of another NUMA node only if there is nothing else.
+ * Queues are ordered by task priorities, that are taken from priority_get()
+ * at the time of submission.
+ * */
+extern struct starpu_sched_policy policy;
+
+//! Set CUDA device, that owns a data handle
+/*! Device index is taken modulo the number of CUDA workers, so that tile
+ * distributions of tensors (e.g., block_cyclic with max_rank equal to the
+ * number of devices) can be reused. Negative value resets the owner.
+ * */
+void set_device(starpu_data_handle_t handle, int device);
+
+//! Get CUDA device, that owns a data handle, or -1 if it is not set
+int get_device(starpu_data_handle_t handle);
+
+//! Get number of CUDA devices, that can own data handles
+int get_ndevices();
+
+//! Get memory node of the owner device of a data handle
+/*! If the owner is not set, the only CUDA device is used. Returns -1 if the
+ * owner is not set and there are several CUDA workers or there are no CUDA
+ * workers at all.
+ * */
+int get_device_node(starpu_data_handle_t handle);
+
+//! Place a data handle into memory of its owner device asynchronously
+/*! If the owner is not set, the only CUDA device is used. Does nothing if
+ * the owner is not set and there are several CUDA workers or there are no
+ * CUDA workers at all.
+ * */
+void prefetch_on_device(starpu_data_handle_t handle);
+
+//! Set NUMA node, that owns a data handle
+/*! NUMA nodes are memory nodes of StarPU of the STARPU_CPU_RAM kind, that
+ * appear when StarPU is initialized with NUMA support (see Config). Node
+ * index is taken modulo the number of NUMA nodes, so that tile
+ * distributions of tensors can be reused. Negative value resets the owner.
+ * */
+void set_numa(starpu_data_handle_t handle, int numa);
+
+//! Get NUMA node, that owns a data handle, or -1 if it is not set
+int get_numa(starpu_data_handle_t handle);
+
+//! Get number of NUMA nodes, that can own data handles
+int get_nnuma();
+
+//! Place a data handle into memory of its owner NUMA node asynchronously
+/*! Does nothing if the owner is not set.
+ * */
+void prefetch_on_numa(starpu_data_handle_t handle);
+
+//! Set priority of tasks, submitted after this call
+void priority_set(int priority);
+
+//! Get priority of tasks being submitted
+int priority_get();
+
+//! Set priority of tasks off the critical path
+/*! Gradients over parameters and updates of parameters are needed only by
+ * the next iteration, so they get this priority instead of the priority of
+ * their layer. Default value STARPU_DEFAULT_PRIO-1 is below priorities of
+ * all layers of backward propagation, that start at STARPU_DEFAULT_PRIO.
+ * */
+void priority_background_set(int priority);
+
+//! Get priority of tasks off the critical path
+int priority_background_get();
+
+//! Set priority of tasks, submitted during the lifetime of the object
+class PriorityScope
+{
+    int previous;
+public:
+    explicit PriorityScope(int priority):
+        previous(priority_get())
+    {
+        priority_set(priority);
+    }
+    ~PriorityScope()
+    {
+        priority_set(previous);
+    }
+    PriorityScope(const PriorityScope &) = delete;
+    PriorityScope &operator=(const PriorityScope &) = delete;
+};
+
+//! Restrict kinds of workers for tasks, submitted after this call
+/*! Unlike restrict_where(), that changes codelets for all their tasks, the
+ * hint is attached to every next task by STARPU_TASK_WHERE, e.g., to keep
+ * small reductions on CPU, where their data already is, or to force a gemm
+ * onto CUDA devices. The hint is a mask of STARPU_CPU and STARPU_CUDA, that
+ * is intersected with the codelet of a task. Tasks of codelets, that
+ * cannot run on any of hinted workers, are not restricted. Zero value
+ * resets the hint.
+ * */
+void where_set(uint32_t where);
+
+//! Get restriction of kinds of workers for tasks being submitted
+uint32_t where_get();
+
+//! Restrict kinds of workers for tasks during the lifetime of the object
+class WhereScope
+{
+    uint32_t previous;
+public:
+    explicit WhereScope(uint32_t where):
+        previous(where_get())
+    {
+        where_set(where);
+    }
+    ~WhereScope()
+    {
+        where_set(previous);
+    }
+    WhereScope(const WhereScope &) = delete;
+    WhereScope &operator=(const WhereScope &) = delete;
+};
+
+//! Apply priorities of priority_get() with a predefined scheduling policy
+/*! Priorities are applied by a submit hook of the policy, just like the
+ * locality-aware scheduler does. Policies, that already have their own hook,
+ * are left intact. Only policies, that sort tasks by priorities (e.g.,
+ * dmdas or prio), make use of them, while dmda ignores priorities.
+ * Called by starpu::Config before initialization of StarPU.
+ * */
+void apply_priorities(const char *policy_name);
+
+} // namespace scheduler
+} // namespace starpu
+} // namespace nntile
+
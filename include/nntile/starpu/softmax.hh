@@ -75,8 +75,8 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index m, Index n, Index k, Handle maxsumnorm, Handle src, T alpha,
-        Handle dst);
+void submit(Index m, Index n, Index k, HandleRef maxsumnorm, HandleRef src,
+        T alpha, HandleRef dst);
 
 } // namespace softmax
 } // namespace starpu
@@ -47,7 +47,7 @@ void cuda(void *buffers[], void *cl_args)
     noexcept;
 #endif // NNTILE_USE_CUDA
 
-extern Codelet codelet_fp32, codelet_fp64;
+extern Codelet codelet_fp32, codelet_fp64, codelet_bf16, codelet_fp16;
 
 template<typename T>
 constexpr Codelet *codelet()
@@ -68,6 +68,18 @@ constexpr Codelet *codelet<fp64_t>()
     return &codelet_fp64;
 }
 
+template<>
+constexpr Codelet *codelet<bf16_t>()
+{
+    return &codelet_bf16;
+}
+
+template<>
+constexpr Codelet *codelet<fp16_t>()
+{
+    return &codelet_fp16;
+}
+
 void init();
 
 void restrict_where(uint32_t where);
@@ -75,7 +87,8 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index m, Index n, Index k, Handle maxsumnorm, T alpha, Handle dst);
+void submit(Index m, Index n, Index k, HandleRef maxsumnorm, T alpha,
+        HandleRef dst);
 
 } // namespace softmax_inplace
 } // namespace starpu
@@ -4,12 +4,12 @@
  * NNTile is software framework for fast training of big neural networks on
  * distributed-memory heterogeneous systems based on StarPU runtime system.
  *
- * @file include/nntile/starpu/gemm.hh
- * GEMM operation for StarPU buffers
+ * @file include/nntile/starpu/strassen.hh
+ * Strassen multiplication operation for StarPU buffers
  *
  * @version 1.0.0
  * @author Aleksandr Mikhalev
- * @date 2023-05-05
+ * @date 2024-02-15
  * */
 
 #pragma once
@@ -18,6 +18,7 @@
 #include <nntile/constants.hh>
 // This also includes all definitions
 #include <nntile/starpu/config.hh>
+#include <nntile/starpu/gemm.hh>
 
 namespace nntile
 {
@@ -26,19 +27,13 @@ namespace starpu
 namespace strassen
 {
 
-//! Structure for arguments
+//! Structure for arguments is shared with gemm
+/*! Codelets contain the classic GEMM of starpu::gemm as the first
+ * implementation, so that the scheduler chooses between classic and Strassen
+ * implementations by their calibrated performance models.
+ * */
 template<typename T_scal>
-struct args_t
-{
-    TransOp transA; // op(A)
-    TransOp transB; // op(B)
-    Index m; // Number of rows of op(A) and C
-    Index n; // Number of columns of op(B) and C
-    Index k; // Number of columns of op(A) and number of rows of op(B)
-    Index batch; // Number of gemms in a batch
-    T_scal alpha;
-    T_scal beta;
-};
+using args_t = gemm::args_t<T_scal>;
 
 #ifdef NNTILE_USE_CBLAS
 template<typename T>
@@ -47,11 +42,35 @@ void cpu(void *buffers[], void *cl_args)
 #endif // NNTILE_USE_CBLAS
 
 #ifdef NNTILE_USE_CUDA
-template<typename T, typename T_scal>
+template<typename T, int nlevels>
 void cuda(void *buffers[], void *cl_args)
     noexcept;
 #endif // NNTILE_USE_CUDA
 
+//! Maximal number of levels of recursion on CUDA
+constexpr int cuda_max_nlevels = 2;
+
+//! Number of elements of workspace for a task with given sizes
+Index workspace_size(Index m, Index n, Index k);
+
+//! Use Strassen for tiles of tensor::gemm_async
+/*! Tiles, that are large enough for at least one level of recursion with
+ * blocks of at least leaf_size rows and columns, are multiplied by codelets
+ * of this namespace instead of starpu::gemm. Levels of recursion are tried
+ * only while leaf blocks are not smaller than leaf_size. Shall be called when
+ * no tasks are being submitted.
+ * */
+void enable(Index leaf_size=512);
+
+//! Do not use Strassen for tiles of tensor::gemm_async
+void disable();
+
+//! Check if Strassen is used by tensor::gemm_async
+bool is_enabled();
+
+//! Check if a tile of gemm shall be multiplied by Strassen codelets
+bool use_for(Index m, Index n, Index k);
+
 extern Codelet codelet_NN_fp32, codelet_NN_fp64,
        codelet_NT_fp32, codelet_NT_fp64,
        codelet_TN_fp32, codelet_TN_fp64,
@@ -166,10 +185,10 @@ void restore_where();
 
 template<typename T, typename T_scal>
 void submit(const TransOp &transA, const TransOp &transB, Index m, Index n,
-        Index k, Index batch, T_scal alpha, Handle A, Handle B, T_scal beta,
-        Handle C, int redux=0);
+        Index k, Index batch, T_scal alpha, HandleRef A, HandleRef B,
+        T_scal beta, HandleRef C, HandleRef work, int redux=0);
 
-} // namespace gemm
+} // namespace strassen
 } // namespace starpu
 } // namespace nntile
 
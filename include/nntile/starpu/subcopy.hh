@@ -30,8 +30,8 @@ template<typename T>
 void cpu(void *buffers[], void *cl_args)
     noexcept;
 
-extern Codelet codelet_fp16, codelet_fp32, codelet_fp64, codelet_int64,
-       codelet_bool;
+extern Codelet codelet_fp16, codelet_bf16, codelet_fp32, codelet_fp64,
+       codelet_int64, codelet_bool, codelet_int8, codelet_fp8_e4m3;
 
 template<typename T>
 constexpr Codelet *codelet()
@@ -46,6 +46,12 @@ constexpr Codelet *codelet<fp16_t>()
     return &codelet_fp16;
 }
 
+template<>
+constexpr Codelet *codelet<bf16_t>()
+{
+    return &codelet_bf16;
+}
+
 template<>
 constexpr Codelet *codelet<fp32_t>()
 {
@@ -70,6 +76,18 @@ constexpr Codelet *codelet<bool_t>()
     return &codelet_bool;
 }
 
+template<>
+constexpr Codelet *codelet<std::int8_t>()
+{
+    return &codelet_int8;
+}
+
+template<>
+constexpr Codelet *codelet<fp8_e4m3_t>()
+{
+    return &codelet_fp8_e4m3;
+}
+
 void init();
 
 void restrict_where(uint32_t where);
@@ -81,8 +99,8 @@ void submit(Index ndim, const std::vector<Index> &src_start,
         const std::vector<Index> &src_stride,
         const std::vector<Index> &dst_start,
         const std::vector<Index> &dst_stride,
-        const std::vector<Index> &copy_shape, Handle src, Handle dst,
-        Handle tmp_index, starpu_data_access_mode mode);
+        const std::vector<Index> &copy_shape, HandleRef src, HandleRef dst,
+        HandleRef tmp_index, starpu_data_access_mode mode);
 
 } // namespace subcopy
 } // namespace starpu
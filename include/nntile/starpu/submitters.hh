@@ -0,0 +1,57 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/submitters.hh
+ * Pool of threads, that submit tasks of tensor operations
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <functional>
+
+namespace nntile
+{
+namespace starpu
+{
+//! Pool of threads, that submit tasks of tensor operations
+/*! Tensor operations submit tasks of every output tile in a loop, and for
+ * large grids submission alone delays the start of computations. Such
+ * operations may pass the loop over output tiles to parallel_for(), that
+ * splits it into contiguous ranges and submits them from the calling
+ * thread and a few pooled threads at once. All the tasks, that write the
+ * same output tile, are submitted by the same thread in the original
+ * order, while input tiles are only read, so StarPU infers the same
+ * dependencies, as for the sequential loop. Tasks of several output tiles
+ * shall not write the same data.
+ * */
+namespace submitters
+{
+
+//! Set the number of submitting threads including the calling one
+/*! Value 1, that is the default, disables the pool. */
+void set_nthreads(int nthreads);
+
+//! Get the number of submitting threads including the calling one
+int get_nthreads();
+
+//! Call body(i) for every i in [0,n), splitting the range among threads
+/*! The loop is sequential if the pool is disabled, if the range is too
+ * small, if there are several MPI nodes (as transfers of data shall be
+ * posted in the same order on all the nodes) or if it is called from a
+ * body of another parallel_for() or concurrently with it. An exception of
+ * any body is rethrown after all the threads finish their ranges.
+ * */
+void parallel_for(Index n, const std::function<void(Index)> &body);
+
+} // namespace submitters
+} // namespace starpu
+} // namespace nntile
+
@@ -71,7 +71,8 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index n_labels, Index n_outputs, T val, Handle labels, Handle dst);
+void submit(Index n_labels, Index n_outputs, T val, HandleRef labels,
+        HandleRef dst);
 
 } // namespace subtract_indexed_column
 } // namespace starpu
@@ -72,7 +72,7 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index m, Index n, Index k, Handle src, Handle dst);
+void submit(Index m, Index n, Index k, HandleRef src, HandleRef dst);
 
 } // namespace sumnorm
 } // namespace starpu
@@ -68,8 +68,8 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index m, Index n, Index k, T alpha, Handle src1, Handle src2,
-        T beta, Handle dst, int redux=0);
+void submit(Index m, Index n, Index k, T alpha, HandleRef src1, HandleRef src2,
+        T beta, HandleRef dst, int redux=0);
 
 } // namespace sumprod_fiber
 } // namespace starpu
@@ -0,0 +1,196 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/tile_io.hh
+ * StarPU wrappers for writing and reading tiles to/from files
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-14
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace tile_io
+{
+
+//! Structure for arguments, that is followed by a path of a file
+struct args_t
+{
+    Index offset;
+    Index nbytes;
+    Index path_size;
+};
+
+//! Types of elements of host arrays, that are loaded into tiles
+enum class src_type_t: int
+{
+    fp64,
+    fp32,
+    fp16,
+    bf16
+};
+
+//! Size of an element of a host array in bytes
+Index src_type_size(src_type_t src_type);
+
+//! Structure for arguments of a load, that is followed by a shape of a tile
+//! and strides of the host array
+struct load_args_t
+{
+    const void *src;
+    src_type_t src_type;
+    Index ndim;
+};
+
+//! Types of tokens of flat binary files of a tokenized dataset
+enum class token_type_t: int
+{
+    uint16,
+    uint32,
+    int64
+};
+
+//! Size of a token in bytes
+Index token_type_size(token_type_t token_type);
+
+//! Structure for arguments of a load of random windows of tokens
+struct tokens_args_t
+{
+    const void *tokens;
+    token_type_t token_type;
+    Index ntokens;
+    Index seq_len;
+    Index seq_start;
+    Index seq_size;
+    Index batch_start;
+    Index batch_size;
+    unsigned long long seed;
+    Index step;
+    Index shift;
+};
+
+//! Structure for arguments of a readback of a buffer into host memory
+struct readback_args_t
+{
+    void *dst;
+    std::atomic<Index> *ready;
+    Index ticket;
+};
+
+// Write bytes into a file, returns errno on failure
+int write_file(const std::string &path, const void *src, Index offset,
+        Index nbytes);
+
+// Read bytes from a file, returns errno on failure
+int read_file(const std::string &path, void *dst, Index offset,
+        Index nbytes);
+
+// Write StarPU buffer into a file on CPU
+void cpu_write(void *buffers[], void *cl_args)
+    noexcept;
+
+// Read StarPU buffer from a file on CPU
+void cpu_read(void *buffers[], void *cl_args)
+    noexcept;
+
+// Copy StarPU buffer into a staging buffer on CPU
+void cpu_stage(void *buffers[], void *cl_args)
+    noexcept;
+
+// Copy StarPU buffer into host memory and mark it as ready on CPU
+void cpu_readback(void *buffers[], void *cl_args)
+    noexcept;
+
+// Convert strided host array into StarPU buffer on CPU
+template<typename T>
+void cpu_load(void *buffers[], void *cl_args)
+    noexcept;
+
+// Copy random windows of tokens of a host array into StarPU buffer on CPU
+void cpu_tokens(void *buffers[], void *cl_args)
+    noexcept;
+
+extern Codelet codelet_write, codelet_read, codelet_stage,
+       codelet_readback, codelet_tokens;
+
+extern Codelet codelet_load_fp32, codelet_load_fp64, codelet_load_bf16,
+       codelet_load_fp16;
+
+template<typename T>
+constexpr Codelet *codelet_load()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet_load<fp32_t>()
+{
+    return &codelet_load_fp32;
+}
+
+template<>
+constexpr Codelet *codelet_load<fp64_t>()
+{
+    return &codelet_load_fp64;
+}
+
+template<>
+constexpr Codelet *codelet_load<bf16_t>()
+{
+    return &codelet_load_bf16;
+}
+
+template<>
+constexpr Codelet *codelet_load<fp16_t>()
+{
+    return &codelet_load_fp16;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+void submit_write(HandleRef src, const std::string &path, Index offset,
+        Index nbytes);
+
+void submit_read(HandleRef dst, const std::string &path, Index offset,
+        Index nbytes);
+
+void submit_stage(HandleRef src, HandleRef dst);
+
+void submit_readback(HandleRef src, void *dst, std::atomic<Index> *ready,
+        Index ticket);
+
+template<typename T>
+void submit_load(const void *src, src_type_t src_type,
+        const std::vector<Index> &shape, const std::vector<Index> &stride,
+        HandleRef dst);
+
+void submit_tokens(const void *tokens, token_type_t token_type,
+        Index ntokens, Index seq_len, Index seq_start, Index seq_size,
+        Index batch_start, Index batch_size, unsigned long long seed,
+        Index step, Index shift, HandleRef dst);
+
+Index get_nerrors();
+
+} // namespace tile_io
+} // namespace starpu
+} // namespace nntile
+
@@ -74,8 +74,8 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(T alpha, Index n_labels, Index n_outputs, Handle logsumexp, Handle src,
-        Handle class_labels, Handle val);
+void submit(T alpha, Index n_labels, Index n_outputs, HandleRef logsumexp,
+        HandleRef src, HandleRef class_labels, HandleRef val);
 
 } // namespace total_sum_accum
 } // namespace starpu
@@ -0,0 +1,124 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/trace.hh
+ * Timeline of StarPU tasks with names of layers and tensors
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <starpu.h>
+#include <string>
+#include <vector>
+
+namespace nntile
+{
+namespace starpu
+{
+//! @namespace nntile::starpu::trace
+/*! Tracing records every task, submitted while it is enabled, together with
+ * the current scope (e.g., a layer and a pass of a model), the name of the
+ * codelet, its number of flops and the names of tiles it accesses. Times of
+ * submission, fetching of input data, start and end of execution and the
+ * worker are taken from profiling information of StarPU. The timeline is exported in the Chrome trace format, that is read
+ * by Perfetto UI and chrome://tracing, with a track per worker, so that idle
+ * gaps of workers (including waiting for data transfers) are easy to spot.
+ *
+ * Tasks are recorded by the submit hook of the scheduling policy, that also
+ * applies priorities (see scheduler::apply_priorities), so policies with
+ * their own submit hook are not traced.
+ * */
+namespace trace
+{
+
+//! Executed task
+struct Event
+{
+    //! Name of the codelet
+    std::string name;
+    //! Scope, that was current at the submission
+    std::string scope;
+    //! Names of tiles of all buffers, written buffers are marked with '*'
+    std::vector<std::string> data;
+    //! Priority of the task
+    int priority;
+    //! Number of floating point operations, given at the submission
+    double flops;
+    //! Worker, that executed the task
+    int workerid;
+    //! Time of submission in microseconds
+    double submit_us;
+    //! Time, that the worker spent fetching input data, in microseconds
+    double fetch_us;
+    //! Time of start of execution in microseconds
+    double start_us;
+    //! Time of end of execution in microseconds
+    double end_us;
+};
+
+//! Start recording of tasks and enable profiling of StarPU
+void enable();
+
+//! Stop recording of tasks, already recorded events are kept
+void disable();
+
+//! Check if tasks are recorded
+bool is_enabled();
+
+//! Drop all recorded events
+void clear();
+
+//! Set scope of tasks, submitted after this call
+void scope_set(const std::string &scope);
+
+//! Get scope of tasks being submitted
+std::string scope_get();
+
+//! Set scope of tasks, submitted during the lifetime of the object
+class Scope
+{
+    std::string previous;
+public:
+    explicit Scope(const std::string &scope):
+        previous(scope_get())
+    {
+        scope_set(scope);
+    }
+    ~Scope()
+    {
+        scope_set(previous);
+    }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+};
+
+//! Set name of a data handle, that appears in events of its tasks
+void set_name(starpu_data_handle_t handle, const std::string &name);
+
+//! Forget name of a data handle, that is about to be unregistered
+void untrack(starpu_data_handle_t handle);
+
+//! Record a task being submitted, it is called by the submit hook
+void submit_hook(starpu_task *task);
+
+//! Get all events, recorded so far, in order of their completion
+std::vector<Event> get_events();
+
+//! Write recorded events into a file in the Chrome trace format
+/*! Times are relative to the start of the earliest event. Tracks of workers
+ * belong to a process with the MPI rank as its id, so files of all MPI
+ * ranks can be merged into a single timeline.
+ * */
+void export_json(const std::string &path);
+
+} // namespace trace
+} // namespace starpu
+} // namespace nntile
+
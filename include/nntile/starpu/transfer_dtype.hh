@@ -0,0 +1,68 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/transfer_dtype.hh
+ * Lossy precision of transfers of data handles between MPI nodes
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <starpu.h>
+
+namespace nntile
+{
+namespace starpu
+{
+//! @namespace nntile::starpu::transfer_dtype
+/*! Single precision data handles, e.g., tiles of activations and gradients,
+ * that tolerate half precision in flight, can be sent between MPI nodes in
+ * a compressed form. The owner converts data into a temporary buffer of
+ * half precision on the device, where the data is, and sends it, while the
+ * destination node receives the buffer and converts it back into its local
+ * copy of the handle. Only the bytes, that are sent over the network, are
+ * halved: transfers between memory nodes of the same MPI node are done by
+ * StarPU as is. Unlike usual transfers, converted copies are not cached, so
+ * every HandleRef::mpi_transfer() sends data again.
+ * */
+namespace transfer_dtype
+{
+
+//! Precision of transfers
+enum class Dtype
+{
+    //! Data is sent as is
+    FP32,
+    //! IEEE half precision, available with CUDA only
+    FP16,
+    //! Brain floating point
+    BF16
+};
+
+//! Set precision of transfers of a handle of single precision values
+void set(starpu_data_handle_t handle, Dtype dtype);
+
+//! Get precision of transfers of a handle
+Dtype get(starpu_data_handle_t handle);
+
+//! Forget precision of a data handle, that is about to be unregistered
+void untrack(starpu_data_handle_t handle);
+
+//! Transfer data in the compressed form, if it is enabled for the handle
+/*! Shall be called on all MPI nodes in the same order, as temporary
+ * buffers get their MPI tags in order of calls. Returns false if transfers
+ * of the handle are not compressed, so the caller has to transfer it on
+ * its own.
+ * */
+bool transfer(starpu_data_handle_t handle, int dst_rank, int mpi_rank);
+
+} // namespace transfer_dtype
+} // namespace starpu
+} // namespace nntile
+
@@ -39,14 +39,25 @@ template<typename T>
 void cpu(void *buffers[], void *cl_args)
     noexcept;
 
+// Apply inplace transpose for a square StarPU buffer on CPU
+template<typename T>
+void cpu_inplace(void *buffers[], void *cl_args)
+    noexcept;
+
 #ifdef NNTILE_USE_CUDA
 // Apply transpose of StarPU buffers on CUDA
 template<typename T>
 void cuda(void *buffers[], void *cl_args)
     noexcept;
+
+// Apply inplace transpose for a square StarPU buffer on CUDA
+template<typename T>
+void cuda_inplace(void *buffers[], void *cl_args)
+    noexcept;
 #endif // NNTILE_USE_CUDA
 
-extern Codelet codelet_fp32, codelet_fp64;
+extern Codelet codelet_fp32, codelet_fp64, codelet_inplace_fp32,
+       codelet_inplace_fp64;
 
 template<typename T>
 constexpr Codelet *codelet()
@@ -67,6 +78,25 @@ constexpr Codelet *codelet<fp64_t>()
     return &codelet_fp64;
 }
 
+template<typename T>
+constexpr Codelet *codelet_inplace()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet_inplace<fp32_t>()
+{
+    return &codelet_inplace_fp32;
+}
+
+template<>
+constexpr Codelet *codelet_inplace<fp64_t>()
+{
+    return &codelet_inplace_fp64;
+}
+
 void init();
 
 void restrict_where(uint32_t where);
@@ -74,7 +104,10 @@ void restrict_where(uint32_t where);
 void restore_where();
 
 template<typename T>
-void submit(Index m, Index n, T alpha, Handle src, Handle dst);
+void submit(Index m, Index n, T alpha, HandleRef src, HandleRef dst);
+
+template<typename T>
+void submit_inplace(Index n, T alpha, HandleRef data);
 
 } // namespace transpose
 } // namespace starpu
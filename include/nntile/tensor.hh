@@ -20,6 +20,8 @@
 #include <nntile/tensor/tensor.hh>
 // MPI distributions
 #include <nntile/tensor/distributions.hh>
+// Explicit tree reductions
+#include <nntile/tensor/tree_reduction.hh>
 
 // Tensor operations
 #include <nntile/tensor/axpy.hh>
@@ -32,24 +34,35 @@
 #include <nntile/tensor/clear.hh>
 #include <nntile/tensor/copy.hh>
 #include <nntile/tensor/copy_intersection.hh>
+#include <nntile/tensor/redistribute.hh>
 #include <nntile/tensor/gather.hh>
+#include <nntile/tensor/collectives.hh>
 #include <nntile/tensor/gelu.hh>
 #include <nntile/tensor/gelutanh.hh>
 #include <nntile/tensor/gelutanh_inplace.hh>
 #include <nntile/tensor/dgelu.hh>
 #include <nntile/tensor/dgelutanh.hh>
 #include <nntile/tensor/drelu.hh>
+#include <nntile/tensor/dropout.hh>
 #include <nntile/tensor/gemm.hh>
 #include <nntile/tensor/gemm_ex.hh>
+#include <nntile/tensor/gemm_summa.hh>
+#include <nntile/tensor/block_sparse.hh>
 #include <nntile/tensor/nrm2.hh>
+#include <nntile/tensor/moe_combine.hh>
+#include <nntile/tensor/moe_dispatch.hh>
+#include <nntile/tensor/moe_route.hh>
 #include <nntile/tensor/normalize.hh>
 #include <nntile/tensor/prod.hh>
 #include <nntile/tensor/randn.hh>
+#include <nntile/tensor/randn_philox.hh>
 #include <nntile/tensor/relu.hh>
 #include <nntile/tensor/relu_forward.hh>
 #include <nntile/tensor/relu_backward.hh>
+#include <nntile/tensor/rope.hh>
 #include <nntile/tensor/scatter.hh>
 #include <nntile/tensor/fill.hh>
+#include <nntile/tensor/fill_padding.hh>
 #include <nntile/tensor/sum_slice.hh>
 #include <nntile/tensor/sum_fiber.hh>
 #include <nntile/tensor/norm_slice.hh>
@@ -59,7 +72,11 @@
 #include <nntile/tensor/maxsumexp.hh>
 #include <nntile/tensor/flash_softmax_gemm.hh>
 #include <nntile/tensor/flash_softmax_gemm_backward.hh>
+#include <nntile/tensor/flash_attention.hh>
+#include <nntile/tensor/flash_attention_backward.hh>
+#include <nntile/tensor/flash_attention_dequant.hh>
 #include <nntile/tensor/softmax.hh>
+#include <nntile/tensor/softmax_crossentropy.hh>
 #include <nntile/tensor/softmax_inplace.hh>
 #include <nntile/tensor/sqrt.hh>
 #include <nntile/tensor/sqrt_inplace.hh>
@@ -78,16 +95,59 @@
 #include <nntile/tensor/add_scalar.hh>
 #include <nntile/tensor/embedding.hh>
 #include <nntile/tensor/embedding_backward.hh>
+#include <nntile/tensor/embedding_rows.hh>
 #include <nntile/tensor/fp32_to_fp16.hh>
 #include <nntile/tensor/fp16_to_fp32.hh>
+#include <nntile/tensor/fp32_to_bf16.hh>
+#include <nntile/tensor/bf16_to_fp32.hh>
 #include <nntile/tensor/mask_scalar.hh>
+#include <nntile/tensor/mask_tiles.hh>
 #include <nntile/tensor/hypot.hh>
 #include <nntile/tensor/hypot_scalar_inverse.hh>
 #include <nntile/tensor/adam_step.hh>
+#include <nntile/tensor/sparse_adam_step.hh>
 #include <nntile/tensor/adamw_step.hh>
+#include <nntile/tensor/multi_adam_step.hh>
+#include <nntile/tensor/sgd_step.hh>
+#include <nntile/tensor/adafactor_step.hh>
+#include <nntile/tensor/quantized_adam_step.hh>
+#include <nntile/tensor/clip_scale.hh>
+#include <nntile/tensor/global_nrm2.hh>
+#include <nntile/tensor/fused_elementwise.hh>
+#include <nntile/tensor/layer_norm.hh>
+#include <nntile/tensor/layer_norm_backward.hh>
+#include <nntile/tensor/add_layer_norm.hh>
+#include <nntile/tensor/add_layer_norm_backward.hh>
+#include <nntile/tensor/rms_norm.hh>
+#include <nntile/tensor/rms_norm_backward.hh>
+#include <nntile/tensor/swiglu.hh>
+#include <nntile/tensor/swiglu_backward.hh>
+#include <nntile/tensor/embedding_pos.hh>
+#include <nntile/tensor/embedding_pos_backward.hh>
+#include <nntile/tensor/softmax_online.hh>
+#include <nntile/tensor/bias_gelutanh.hh>
+#include <nntile/tensor/bias_gelutanh_backward.hh>
+#include <nntile/tensor/gemm_bias_gelutanh.hh>
+#include <nntile/tensor/quantize.hh>
+#include <nntile/tensor/gemm_dequant.hh>
+#include <nntile/tensor/topk.hh>
+#include <nntile/tensor/topk_sample.hh>
+#include <nntile/tensor/tile_io.hh>
+#include <nntile/tensor/readback.hh>
+#include <nntile/tensor/future.hh>
+#include <nntile/tensor/partition.hh>
+#include <nntile/tensor/hierarchical.hh>
+#include <nntile/tensor/aggregate.hh>
 #include <nntile/tensor/transpose.hh>
+#include <nntile/tensor/permute.hh>
+#include <nntile/tensor/contract.hh>
 #include <nntile/tensor/conv2d.hh>
+#include <nntile/tensor/conv2d_backward_input.hh>
+#include <nntile/tensor/conv2d_backward_weight.hh>
 #include <nntile/tensor/strassen.hh>
+#include <nntile/tensor/batch_norm_act.hh>
+#include <nntile/tensor/batch_norm_act_backward.hh>
+#include <nntile/tensor/batch_norm_backward.hh>
 
 namespace nntile
 {
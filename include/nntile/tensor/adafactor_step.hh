@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/adafactor_step.hh
+ * Fused Adafactor step for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous tensor-wise fused Adafactor step
+template<typename T>
+void adafactor_step_async(Index num_iter, T beta_2, T eps, T lr,
+        T weight_decay, const Tensor<T> &row, const Tensor<T> &col,
+        const Tensor<T> &mean, const Tensor<T> &grad, const Tensor<T> &p);
+
+// Blocking version of tensor-wise fused Adafactor step
+template<typename T>
+void adafactor_step(Index num_iter, T beta_2, T eps, T lr, T weight_decay,
+        const Tensor<T> &row, const Tensor<T> &col, const Tensor<T> &mean,
+        const Tensor<T> &grad, const Tensor<T> &p);
+
+} // namespace tensor
+} // namespace nntile
+
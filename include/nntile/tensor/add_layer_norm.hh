@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/add_layer_norm.hh
+ * Fused residual addition and layer normalization of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void add_layer_norm_async(T eps, const Tensor<T> &src1, const Tensor<T> &src2,
+        const Tensor<T> &gamma, const Tensor<T> &beta, const Tensor<T> &sum,
+        const Tensor<T> &mean, const Tensor<T> &inv_stddev,
+        const Tensor<T> &dst, Index axis);
+
+template<typename T>
+void add_layer_norm(T eps, const Tensor<T> &src1, const Tensor<T> &src2,
+        const Tensor<T> &gamma, const Tensor<T> &beta, const Tensor<T> &sum,
+        const Tensor<T> &mean, const Tensor<T> &inv_stddev,
+        const Tensor<T> &dst, Index axis);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,42 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/add_layer_norm_backward.hh
+ * Backward of fused residual addition and layer normalization of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void add_layer_norm_backward_async(const Tensor<T> &sum,
+        const Tensor<T> &dst_grad, const Tensor<T> &gamma,
+        const Tensor<T> &mean, const Tensor<T> &inv_stddev,
+        const Tensor<T> &sum_grad, const Tensor<T> &src1_grad,
+        const Tensor<T> &src2_grad, const Tensor<T> &gamma_grad,
+        const Tensor<T> &beta_grad, Index axis, int redux=0);
+
+template<typename T>
+void add_layer_norm_backward(const Tensor<T> &sum, const Tensor<T> &dst_grad,
+        const Tensor<T> &gamma, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &sum_grad,
+        const Tensor<T> &src1_grad, const Tensor<T> &src2_grad,
+        const Tensor<T> &gamma_grad, const Tensor<T> &beta_grad, Index axis,
+        int redux=0);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/aggregate.hh
+ * Aggregation of tiny tiles into tasks
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Set the size of tiles, that are aggregated into tasks
+/*! StarPU spends a few microseconds on each task, which dominates for tiny
+ * tiles. Operations, that support aggregation (add_slice), submit a single
+ * task for neighbouring tiles of the same shape, until the task covers
+ * more than nelems elements. Tiles of at least nelems elements get their
+ * own tasks, and zero disables aggregation.
+ * */
+void set_aggregate_nelems(Index nelems);
+
+//! Get the size of tiles, that are aggregated into tasks
+Index get_aggregate_nelems();
+
+} // namespace tensor
+} // namespace nntile
+
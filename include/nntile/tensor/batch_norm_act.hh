@@ -0,0 +1,44 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/batch_norm_act.hh
+ * Batch normalization followed by an activation of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <nntile/kernel/batch_norm_act/activation.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+using kernel::batch_norm_act::activation_t;
+
+void batch_norm_act_check(const TensorTraits &param, const TensorTraits &src,
+        const TensorTraits &dst, Index axis);
+
+template<typename T>
+void batch_norm_act_async(const Tensor<T> &src, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &gamma,
+        const Tensor<T> &beta, const Tensor<T> &dst, Index axis,
+        activation_t act);
+
+template<typename T>
+void batch_norm_act(const Tensor<T> &src, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &gamma,
+        const Tensor<T> &beta, const Tensor<T> &dst, Index axis,
+        activation_t act);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,42 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/batch_norm_act_backward.hh
+ * Backward of an activation, that follows batch normalization, of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/batch_norm_act.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void batch_norm_act_backward_async(const Tensor<T> &src,
+        const Tensor<T> &mean, const Tensor<T> &inv_stddev,
+        const Tensor<T> &gamma, const Tensor<T> &beta,
+        const Tensor<T> &dst_grad, const Tensor<T> &y_grad,
+        const Tensor<T> &sum_grad, const Tensor<T> &sum_grad_xhat,
+        Index axis, activation_t act, int redux=0);
+
+template<typename T>
+void batch_norm_act_backward(const Tensor<T> &src, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &gamma,
+        const Tensor<T> &beta, const Tensor<T> &dst_grad,
+        const Tensor<T> &y_grad, const Tensor<T> &sum_grad,
+        const Tensor<T> &sum_grad_xhat, Index axis, activation_t act,
+        int redux=0);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/batch_norm_backward.hh
+ * Backward of batch normalization with stored statistics of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void batch_norm_backward_async(const Tensor<T> &src, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &gamma,
+        const Tensor<T> &sum_grad, const Tensor<T> &sum_grad_xhat,
+        const Tensor<T> &grad, Index axis);
+
+template<typename T>
+void batch_norm_backward(const Tensor<T> &src, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &gamma,
+        const Tensor<T> &sum_grad, const Tensor<T> &sum_grad_xhat,
+        const Tensor<T> &grad, Index axis);
+
+} // namespace tensor
+} // namespace nntile
+
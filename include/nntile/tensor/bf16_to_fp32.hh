@@ -0,0 +1,30 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/bf16_to_fp32.hh
+ * Convert bf16_t array into fp32_t array
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-31
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+void bf16_to_fp32_async(const Tensor<bf16_t> &src, const Tensor<fp32_t> &dst);
+
+void bf16_to_fp32(const Tensor<bf16_t> &src, const Tensor<fp32_t> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
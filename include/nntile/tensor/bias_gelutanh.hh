@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/bias_gelutanh.hh
+ * Bias addition followed by approximate GeLU of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+void bias_gelutanh_check(const TensorTraits &bias, const TensorTraits &src,
+        const TensorTraits &dst, Index axis);
+
+template<typename T>
+void bias_gelutanh_async(const Tensor<T> &bias, const Tensor<T> &src,
+        const Tensor<T> &dst, Index axis);
+
+template<typename T>
+void bias_gelutanh(const Tensor<T> &bias, const Tensor<T> &src,
+        const Tensor<T> &dst, Index axis);
+
+} // namespace tensor
+} // namespace nntile
+
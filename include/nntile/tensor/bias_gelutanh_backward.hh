@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/bias_gelutanh_backward.hh
+ * Backward of bias addition followed by approximate GeLU of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void bias_gelutanh_backward_async(const Tensor<T> &src,
+        const Tensor<T> &dst_grad, const Tensor<T> &src_grad,
+        const Tensor<T> &bias_grad, Index axis, int redux=0);
+
+template<typename T>
+void bias_gelutanh_backward(const Tensor<T> &src, const Tensor<T> &dst_grad,
+        const Tensor<T> &src_grad, const Tensor<T> &bias_grad, Index axis,
+        int redux=0);
+
+} // namespace tensor
+} // namespace nntile
+
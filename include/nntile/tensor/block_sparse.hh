@@ -0,0 +1,133 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/block_sparse.hh
+ * Block-sparse tensor and operations, that skip absent tiles
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <nntile/constants.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Tensor, that stores only a subset of its tiles
+/*! Absent tiles are zero and they are not registered in StarPU at all, so
+ * their handles are empty, and memory and MPI tags are spent only on tiles,
+ * that are present, e.g., nonzero blocks of a pruned weight. The layout of
+ * present tiles is fixed at construction, so that a gradient of the same
+ * layout keeps the structured sparsity during training. A block-sparse
+ * tensor can be passed only to operations of this header, as other
+ * operations access all the tiles.
+ * */
+template<typename T>
+class BlockSparseTensor: public Tensor<T>
+{
+    // Register present tiles only
+    static std::vector<starpu::VariableHandle> _register_tiles(
+            const TensorTraits &traits, const std::vector<int> &distribution,
+            const std::vector<bool> &present, starpu_mpi_tag_t &last_tag)
+    {
+        if(distribution.size() != traits.grid.nelems)
+        {
+            throw std::runtime_error("Wrong distribution");
+        }
+        if(present.size() != traits.grid.nelems)
+        {
+            throw std::runtime_error("Wrong layout of tiles");
+        }
+        std::vector<starpu::VariableHandle> handles;
+        handles.reserve(traits.grid.nelems);
+        std::vector<Index> tile_index(traits.ndim, 0);
+        for(Index i = 0; i < traits.grid.nelems; ++i)
+        {
+            if(not present[i])
+            {
+                handles.emplace_back(
+                        std::shared_ptr<_starpu_data_state>(nullptr));
+            }
+            else
+            {
+                Index tile_nelems = 1;
+                for(Index tile_size: traits.get_tile_shape(tile_index))
+                {
+                    tile_nelems *= tile_size;
+                }
+                handles.emplace_back(sizeof(T)*tile_nelems, STARPU_R);
+#ifdef NNTILE_USE_MPI
+                starpu_mpi_data_register(
+                        static_cast<starpu_data_handle_t>(handles[i]),
+                        last_tag, distribution[i]);
+                ++last_tag;
+#endif // NNTILE_USE_MPI
+            }
+            traits.grid.next_index(tile_index);
+        }
+        return handles;
+    }
+public:
+    //! Linear offsets of present tiles in increasing order
+    std::vector<Index> nonzero_tiles;
+    //! Constructor out of a layout of present tiles
+    /*! Only entries of the distribution for present tiles are used.
+     * */
+    explicit BlockSparseTensor(const TensorTraits &traits,
+            const std::vector<int> &distribution,
+            const std::vector<bool> &present, starpu_mpi_tag_t &last_tag):
+        Tensor<T>(traits, _register_tiles(traits, distribution, present,
+                    last_tag), distribution, 0)
+    {
+        this->next_tag = last_tag;
+        for(Index i = 0; i < this->grid.nelems; ++i)
+        {
+            if(present[i])
+            {
+                nonzero_tiles.push_back(i);
+            }
+        }
+    }
+    //! Check if a tile is present
+    bool is_nonzero(Index linear_offset) const
+    {
+        return this->tile_handles[linear_offset].handle != nullptr;
+    }
+    //! Fraction of present tiles
+    double density() const
+    {
+        return double(nonzero_tiles.size()) / double(this->grid.nelems);
+    }
+};
+
+// Copy present tiles of a tensor into present tiles of another one
+template<typename T>
+void copy_block_sparse_async(const Tensor<T> &src, const Tensor<T> &dst);
+
+template<typename T>
+void copy_block_sparse(const Tensor<T> &src, const Tensor<T> &dst);
+
+// Tensor-wise gemm, that skips products with absent tiles
+template<typename T>
+void gemm_block_sparse_async(T alpha, const TransOp &transA,
+        const Tensor<T> &A, const TransOp &transB, const Tensor<T> &B,
+        T beta, const Tensor<T> &C, Index ndim, Index batch_ndim,
+        int redux=0);
+
+template<typename T>
+void gemm_block_sparse(T alpha, const TransOp &transA, const Tensor<T> &A,
+        const TransOp &transB, const Tensor<T> &B, T beta,
+        const Tensor<T> &C, Index ndim, Index batch_ndim, int redux=0);
+
+} // namespace tensor
+} // namespace nntile
+
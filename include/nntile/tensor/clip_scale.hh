@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/clip_scale.hh
+ * Learning rate and scale of gradients for clipping for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous learning rate and scale of gradients for clipping
+template<typename T>
+void clip_scale_async(T lr, T max_norm, const Tensor<T> &norm,
+        const Tensor<T> &scalars);
+
+// Blocking version of learning rate and scale of gradients for clipping
+template<typename T>
+void clip_scale(T lr, T max_norm, const Tensor<T> &norm,
+        const Tensor<T> &scalars);
+
+} // namespace tensor
+} // namespace nntile
+
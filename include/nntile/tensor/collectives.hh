@@ -0,0 +1,66 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/collectives.hh
+ * Hierarchical collective operations over replicas of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <vector>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous broadcast of the first tensor into the other ones
+template<typename T>
+void broadcast_async(const std::vector<Tensor<T>> &tensors,
+        Index ranks_per_node=0);
+
+// Blocking broadcast of the first tensor into the other ones
+template<typename T>
+void broadcast(const std::vector<Tensor<T>> &tensors,
+        Index ranks_per_node=0);
+
+// Asynchronous sum of all the tensors into the first one
+template<typename T>
+void reduce_async(const std::vector<Tensor<T>> &tensors,
+        Index ranks_per_node=0);
+
+// Blocking sum of all the tensors into the first one
+template<typename T>
+void reduce(const std::vector<Tensor<T>> &tensors, Index ranks_per_node=0);
+
+// Asynchronous sum of all the tensors into all of them
+template<typename T>
+void allreduce_async(const std::vector<Tensor<T>> &tensors,
+        Index ranks_per_node=0);
+
+// Blocking sum of all the tensors into all of them
+template<typename T>
+void allreduce(const std::vector<Tensor<T>> &tensors,
+        Index ranks_per_node=0);
+
+// Asynchronous copy of a distributed tensor into all the replicas
+template<typename T>
+void allgather_async(const Tensor<T> &src, const std::vector<Tensor<T>> &dst,
+        Index ranks_per_node=0);
+
+// Blocking copy of a distributed tensor into all the replicas
+template<typename T>
+void allgather(const Tensor<T> &src, const std::vector<Tensor<T>> &dst,
+        Index ranks_per_node=0);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,73 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/contract.hh
+ * Contraction of two tensors, described by einsum-like subscripts
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <nntile/constants.hh>
+#include <string>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Plan of a contraction of two tensors by a single gemm
+/*! Gemm multiplies operands with layouts [M,K,batch] (or [K,M,batch] if
+ * transposed) and [K,N,batch] (or [N,K,batch]) into [M,N,batch], where
+ * every group consists of modes in the same order in all the tensors. A
+ * plan keeps tensors, that already have such layouts, and permutes others
+ * into temporary tensors.
+ * */
+struct ContractPlan
+{
+    //! Whether B is the first operand of gemm and A is the second one
+    bool swap = false;
+    //! Transposition of the first operand of gemm
+    TransOp trans_first = TransOp(TransOp::NoTrans);
+    //! Transposition of the second operand of gemm
+    TransOp trans_second = TransOp(TransOp::NoTrans);
+    //! Number of contracted modes
+    Index ndim = 0;
+    //! Number of batch modes
+    Index batch_ndim = 0;
+    //! Permutations of A, B and C into layouts of gemm
+    /*! Axis i of a layout is axis perm[i] of the tensor (see
+     * permute_async). An empty permutation means the tensor is used as is.
+     * */
+    std::vector<Index> perm_A, perm_B, perm_C;
+    //! Number of elements, that are moved by permutations
+    Index nelems_moved = 0;
+};
+
+// Plan a contraction with the least amount of permuted data
+ContractPlan contract_plan(const std::string &subscripts,
+        const TensorTraits &A, const TensorTraits &B, const TensorTraits &C,
+        bool read_C);
+
+// Asynchronous contraction C = alpha*contract(A,B) + beta*C
+template<typename T>
+void contract_async(T alpha, const Tensor<T> &A, const Tensor<T> &B, T beta,
+        const Tensor<T> &C, const std::string &subscripts,
+        starpu_mpi_tag_t &last_tag, int redux=0);
+
+// Blocking version of contraction C = alpha*contract(A,B) + beta*C
+template<typename T>
+void contract(T alpha, const Tensor<T> &A, const Tensor<T> &B, T beta,
+        const Tensor<T> &C, const std::string &subscripts,
+        starpu_mpi_tag_t &last_tag, int redux=0);
+
+} // namespace tensor
+} // namespace nntile
+
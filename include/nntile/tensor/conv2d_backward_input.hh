@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/conv2d_backward_input.hh
+ * Tensor wrappers for gradient of 2D-Convolution over its input
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Tensor<T> gradient of 2D-Convolution over its input
+template<typename T>
+void conv2d_backward_input_async(const Tensor<T> &dst_grad,
+        const Tensor<T> &kernel, const Tensor<T> &src_grad);
+
+// Tensor<T> gradient of 2D-Convolution over its input
+template<typename T>
+void conv2d_backward_input(const Tensor<T> &dst_grad,
+        const Tensor<T> &kernel, const Tensor<T> &src_grad);
+
+} // namespace tensor
+} // namespace nntile
+
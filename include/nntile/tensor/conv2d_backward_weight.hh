@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/conv2d_backward_weight.hh
+ * Tensor wrappers for gradient of 2D-Convolution over its kernel
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Tensor<T> gradient of 2D-Convolution over its kernel
+template<typename T>
+void conv2d_backward_weight_async(const Tensor<T> &src,
+        const Tensor<T> &dst_grad, const Tensor<T> &kernel_grad);
+
+// Tensor<T> gradient of 2D-Convolution over its kernel
+template<typename T>
+void conv2d_backward_weight(const Tensor<T> &src,
+        const Tensor<T> &dst_grad, const Tensor<T> &kernel_grad);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -27,6 +27,9 @@ namespace distributions
 std::vector<int> block_cyclic(const std::vector<Index> &tensor_grid,
         const std::vector<int> &mpi_grid, int start_rank, int max_rank);
 
+std::vector<int> local_cyclic(const std::vector<int> &distribution,
+        int ndevices);
+
 } // namespace distributions
 } // namespace tensor
 } // namespace nntile
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/dropout.hh
+ * Dropout operation with regenerated mask for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Tensor-wise dropout operation
+template<typename T>
+void dropout_async(unsigned long long seed, T p, const Tensor<T> &src,
+        T beta, const Tensor<T> &dst);
+
+// Tensor-wise dropout operation
+template<typename T>
+void dropout(unsigned long long seed, T p, const Tensor<T> &src, T beta,
+        const Tensor<T> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/embedding_pos.hh
+ * Embeddings of tokens and positions from vocabularies
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void embedding_pos_async(const Tensor<Index> &index, const Tensor<Index> &pos,
+        const Tensor<T> &vocab, const Tensor<T> &pos_vocab,
+        const Tensor<T> &embed, Index axis);
+
+template<typename T>
+void embedding_pos(const Tensor<Index> &index, const Tensor<Index> &pos,
+        const Tensor<T> &vocab, const Tensor<T> &pos_vocab,
+        const Tensor<T> &embed, Index axis);
+
+} // namespace tensor
+} // namespace nntile
+
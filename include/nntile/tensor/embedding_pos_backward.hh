@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/embedding_pos_backward.hh
+ * Backward of embeddings of tokens and positions
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void embedding_pos_backward_async(const Tensor<Index> &index,
+        const Tensor<Index> &pos, const Tensor<T> &embed,
+        const Tensor<T> &vocab, const Tensor<T> &pos_vocab, Index axis,
+        int redux=0);
+
+template<typename T>
+void embedding_pos_backward(const Tensor<Index> &index,
+        const Tensor<Index> &pos, const Tensor<T> &embed,
+        const Tensor<T> &vocab, const Tensor<T> &pos_vocab, Index axis,
+        int redux=0);
+
+} // namespace tensor
+} // namespace nntile
+
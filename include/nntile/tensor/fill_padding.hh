@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/fill_padding.hh
+ * Fill padding of a tensor beyond its logical shape
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Shape of a padded tensor, which tiles are all of the base tile shape
+std::vector<Index> padded_shape(const std::vector<Index> &shape,
+        const std::vector<Index> &basetile_shape);
+
+template<typename T>
+void fill_padding_async(T val, const std::vector<Index> &logical_shape,
+        const Tensor<T> &A);
+
+template<typename T>
+void fill_padding(T val, const std::vector<Index> &logical_shape,
+        const Tensor<T> &A);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,56 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/flash_attention.hh
+ * Fused single-pass flash attention forward
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <nntile/tensor/mask_tiles.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous tensor-wise fused attention forward
+template<typename T>
+void flash_attention_async(const Tensor<T> &Q, const Tensor<T> &K,
+        const Tensor<T> &V, const Tensor<bool_t> &mask,
+        const Tensor<T> &maxsumexp, const Tensor<T> &dst,
+        const std::vector<MaskTile> &layout={});
+
+// Blocking version of tensor-wise fused attention forward
+template<typename T>
+void flash_attention(const Tensor<T> &Q, const Tensor<T> &K,
+        const Tensor<T> &V, const Tensor<bool_t> &mask,
+        const Tensor<T> &maxsumexp, const Tensor<T> &dst,
+        const std::vector<MaskTile> &layout={});
+
+// Asynchronous tensor-wise fused attention forward, that passes tiles of keys
+// and values over a ring of nodes
+template<typename T>
+void flash_attention_ring_async(const Tensor<T> &Q, const Tensor<T> &K,
+        const Tensor<T> &V, const Tensor<bool_t> &mask,
+        const Tensor<T> &maxsumexp, const Tensor<T> &dst,
+        const std::vector<MaskTile> &layout={});
+
+// Blocking version of tensor-wise fused attention forward over a ring
+template<typename T>
+void flash_attention_ring(const Tensor<T> &Q, const Tensor<T> &K,
+        const Tensor<T> &V, const Tensor<bool_t> &mask,
+        const Tensor<T> &maxsumexp, const Tensor<T> &dst,
+        const std::vector<MaskTile> &layout={});
+
+} // namespace tensor
+} // namespace nntile
+
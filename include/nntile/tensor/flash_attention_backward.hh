@@ -0,0 +1,45 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/flash_attention_backward.hh
+ * Fused single-pass flash attention backward
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <nntile/tensor/mask_tiles.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous tensor-wise fused attention backward
+template<typename T>
+void flash_attention_backward_async(const Tensor<T> &Q, const Tensor<T> &dQ,
+        const Tensor<T> &K, const Tensor<T> &dK, const Tensor<T> &V,
+        const Tensor<T> &dV, const Tensor<bool_t> &mask,
+        const Tensor<T> &maxsumexp, const Tensor<T> &dst,
+        const Tensor<T> &dst_grad, const Tensor<T> &sumprod_slice,
+        int redux=0, const std::vector<MaskTile> &layout={});
+
+// Blocking version of tensor-wise fused attention backward
+template<typename T>
+void flash_attention_backward(const Tensor<T> &Q, const Tensor<T> &dQ,
+        const Tensor<T> &K, const Tensor<T> &dK, const Tensor<T> &V,
+        const Tensor<T> &dV, const Tensor<bool_t> &mask,
+        const Tensor<T> &maxsumexp, const Tensor<T> &dst,
+        const Tensor<T> &dst_grad, const Tensor<T> &sumprod_slice,
+        int redux=0, const std::vector<MaskTile> &layout={});
+
+} // namespace tensor
+} // namespace nntile
+
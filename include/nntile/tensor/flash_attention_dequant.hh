@@ -0,0 +1,42 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/flash_attention_dequant.hh
+ * Fused attention over quantized keys and values for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous fused attention over quantized keys and values
+template<typename Q>
+void flash_attention_dequant_async(const Tensor<fp32_t> &query,
+        const Tensor<Q> &K, const Tensor<fp32_t> &K_scale,
+        const Tensor<Q> &V, const Tensor<fp32_t> &V_scale,
+        const Tensor<bool_t> &mask, const Tensor<fp32_t> &maxsumexp,
+        const Tensor<fp32_t> &dst);
+
+// Blocking fused attention over quantized keys and values
+template<typename Q>
+void flash_attention_dequant(const Tensor<fp32_t> &query,
+        const Tensor<Q> &K, const Tensor<fp32_t> &K_scale,
+        const Tensor<Q> &V, const Tensor<fp32_t> &V_scale,
+        const Tensor<bool_t> &mask, const Tensor<fp32_t> &maxsumexp,
+        const Tensor<fp32_t> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <nntile/tensor/tensor.hh>
+#include <nntile/tensor/mask_tiles.hh>
 
 namespace nntile
 {
@@ -24,12 +25,14 @@ namespace tensor
 template<typename T>
 void flash_maxsumexp_async(const Tensor<T> &Q, const Tensor<T> &K,
         const Tensor<bool_t> &mask, const Tensor<T> &maxsumexp,
-        const Tensor<T> &tmp, int redux=0, int fp32_fast_tf32=0);
+        const Tensor<T> &tmp, int redux=0, int fp32_fast_tf32=0,
+        const std::vector<MaskTile> &layout={});
 
 template<typename T>
 void flash_maxsumexp(const Tensor<T> &Q, const Tensor<T> &K,
         const Tensor<bool_t> &mask, const Tensor<T> &maxsumexp,
-        const Tensor<T> &tmp, int redux=0, int fp32_fast_tf32=0);
+        const Tensor<T> &tmp, int redux=0, int fp32_fast_tf32=0,
+        const std::vector<MaskTile> &layout={});
 
 } // namespace tensor
 } // namespace nntile
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <nntile/tensor/tensor.hh>
+#include <nntile/tensor/mask_tiles.hh>
 
 namespace nntile
 {
@@ -25,13 +26,17 @@ template<typename T>
 void flash_softmax_gemm_async(const Tensor<T> &Q, const Tensor<T> &K,
         const Tensor<T> &V, const Tensor<bool_t> &mask,
         const Tensor<T> &maxsumexp, const Tensor<T> &dst,
-        const Tensor<T> &tmp, int redux=0, int fp32_fast_tf32=0);
+        const Tensor<T> &tmp, int redux=0, int fp32_fast_tf32=0,
+        T dropout_p=0, unsigned long long seed=0,
+        const std::vector<MaskTile> &layout={});
 
 template<typename T>
 void flash_softmax_gemm(const Tensor<T> &Q, const Tensor<T> &K,
         const Tensor<T> &V, const Tensor<bool_t> &mask,
         const Tensor<T> &maxsumexp, const Tensor<T> &dst,
-        const Tensor<T> &tmp, int redux=0, int fp32_fast_tf32=0);
+        const Tensor<T> &tmp, int redux=0, int fp32_fast_tf32=0,
+        T dropout_p=0, unsigned long long seed=0,
+        const std::vector<MaskTile> &layout={});
 
 
 } // namespace tensor
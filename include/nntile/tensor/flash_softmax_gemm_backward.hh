@@ -15,6 +15,7 @@
 #pragma once
 
 #include <nntile/tensor/tensor.hh>
+#include <nntile/tensor/mask_tiles.hh>
 
 namespace nntile
 {
@@ -27,7 +28,9 @@ void flash_softmax_gemm_backward_async(const Tensor<T> &Q, const Tensor<T> &dQ,
         const Tensor<T> &dV, const Tensor<bool_t> &mask,
         const Tensor<T> &maxsumexp, const Tensor<T> &dst_grad,
         const Tensor<T> &tmp, const Tensor<T> &tmp_grad,
-        const Tensor<T> &tmp_sumprod_slice, int redux=0, int fp32_fast_tf32=0);
+        const Tensor<T> &tmp_sumprod_slice, int redux=0, int fp32_fast_tf32=0,
+        T dropout_p=0, unsigned long long seed=0,
+        const std::vector<MaskTile> &layout={});
 
 template<typename T>
 void flash_softmax_gemm_backward(const Tensor<T> &Q, const Tensor<T> &dQ,
@@ -35,7 +38,9 @@ void flash_softmax_gemm_backward(const Tensor<T> &Q, const Tensor<T> &dQ,
         const Tensor<T> &dV, const Tensor<bool_t> &mask,
         const Tensor<T> &maxsumexp, const Tensor<T> &dst_grad,
         const Tensor<T> &tmp, const Tensor<T> &tmp_grad,
-        const Tensor<T> &tmp_sumprod_slice, int redux=0, int fp32_fast_tf32=0);
+        const Tensor<T> &tmp_sumprod_slice, int redux=0, int fp32_fast_tf32=0,
+        T dropout_p=0, unsigned long long seed=0,
+        const std::vector<MaskTile> &layout={});
 
 } // namespace tensor
 } // namespace nntile
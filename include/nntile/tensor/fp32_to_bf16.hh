@@ -0,0 +1,30 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/fp32_to_bf16.hh
+ * Convert fp32_t array into bf16_t array
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-31
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+void fp32_to_bf16_async(const Tensor<fp32_t> &src, const Tensor<bf16_t> &dst);
+
+void fp32_to_bf16(const Tensor<fp32_t> &src, const Tensor<bf16_t> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/fused_elementwise.hh
+ * Chain of elementwise operations on Tensor<T> by a single task per tile
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <nntile/kernel/fused_elementwise/program.hh>
+#include <vector>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void fused_elementwise_async(
+        const std::vector<kernel::fused_elementwise::op_t<T>> &ops,
+        const std::vector<Tensor<T>> &buffers);
+
+template<typename T>
+void fused_elementwise(
+        const std::vector<kernel::fused_elementwise::op_t<T>> &ops,
+        const std::vector<Tensor<T>> &buffers);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,81 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/future.hh
+ * Future of values of tensors, that waits only for their tasks
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Future of values of tensors
+/*! A future is ready, when all the tasks, that were submitted to write
+ * local tiles of the awaited tensors before await_tensor(), are finished.
+ * Waiting for a future does not drain the runtime system, as
+ * starpu_task_wait_for_all() does, so tasks submitted later keep running
+ * and host code waits only for the results it needs. The future neither
+ * transfers tiles between MPI nodes nor keeps tiles acquired, so values
+ * may be read by acquiring tiles right after the wait.
+ * */
+class TensorFuture
+{
+public:
+    // State shared with callbacks of StarPU
+    struct State
+    {
+        //! Number of tiles, that are not yet available
+        std::atomic<Index> pending;
+        std::mutex mutex;
+        std::condition_variable ready;
+        explicit State(Index pending_):
+            pending(pending_)
+        {
+        }
+    };
+    std::shared_ptr<State> state;
+    //! Future, that waits for nothing
+    TensorFuture():
+        state(std::make_shared<State>(0))
+    {
+    }
+    //! Check if values are available without waiting
+    bool is_ready() const
+    {
+        return state->pending.load(std::memory_order_acquire) == 0;
+    }
+    //! Wait until values are available
+    void wait() const
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->ready.wait(lock, [this]{return is_ready();});
+    }
+};
+
+// Get future of values of local tiles of a tensor
+template<typename T>
+TensorFuture await_tensor(const Tensor<T> &src);
+
+// Get future of values of local tiles of several tensors
+template<typename T>
+TensorFuture await_tensors(const std::vector<Tensor<T>> &srcs);
+
+} // namespace tensor
+} // namespace nntile
+
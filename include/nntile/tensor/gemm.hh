@@ -22,6 +22,38 @@ namespace nntile
 namespace tensor
 {
 
+//! Set the number of chains of tasks of gemm with few tiles of output
+/*! Every tile of C is a sequential chain of products of tiles over the
+ * contracted dimensions, so gemm with fewer tiles of C than workers, e.g.,
+ * a gradient over weights of a linear layer, does not occupy all of them.
+ * Without reductions, gemm with less than nchains tiles of C splits the
+ * contracted dimensions of every tile of C into about nchains/C.grid.nelems
+ * chains, that are computed into partial results in parallel and summed by
+ * TreeReduction (see redux_tree). Values below 2 disable the split.
+ * */
+void set_gemm_split_k(Index nchains);
+
+//! Get the number of chains of tasks of gemm with few tiles of output
+Index get_gemm_split_k();
+
+//! Enable split of tiles of gemm output between CPU and CUDA workers
+/*! Schedulers tend to either leave CPU workers idle during a large gemm or
+ * give them whole tiles, that finish long after the CUDA workers are done.
+ * With the split enabled, every tile of C of gemm without reductions is
+ * split by StarPU partitioning into two ranges of columns, computed by CPU
+ * and CUDA workers respectively. The CPU range gets a share of columns,
+ * proportional to the throughput of all CPU workers, predicted by
+ * calibrated performance models, or a fixed share cpu_share, if it is
+ * positive. Shares of the models require workers of both kinds, and tiles
+ * are not split until the models are calibrated on whole tiles. Only gemm
+ * with non-transposed B, without batch dimensions in tiles, on a single MPI
+ * node, is split.
+ * */
+void set_gemm_hetero(bool enable, fp64_t cpu_share=0);
+
+//! Check if tiles of gemm output are split between CPU and CUDA workers
+bool get_gemm_hetero();
+
 void gemm_check(const TransOp &transA, const TensorTraits &A,
         const TransOp &transB, const TensorTraits &B, const TensorTraits &C,
         Index ndim, Index batch_ndim);
@@ -29,12 +61,26 @@ void gemm_check(const TransOp &transA, const TensorTraits &A,
 template<typename T, typename T_scal>
 void gemm_async(T_scal alpha, const TransOp &transA, const Tensor<T> &A,
         const TransOp &transB, const Tensor<T> &B, T_scal beta,
-        const Tensor<T> &C, Index ndim, Index batch_ndim, int redux=0);
+        const Tensor<T> &C, Index ndim, Index batch_ndim, int redux=0,
+        GemmCompute compute=GemmCompute(GemmCompute::Default));
 
 template<typename T, typename T_scal>
 void gemm(T_scal alpha, const TransOp &transA, const Tensor<T> &A,
         const TransOp &transB, const Tensor<T> &B, T_scal beta,
-        const Tensor<T> &C, Index ndim, Index batch_ndim, int redux=0);
+        const Tensor<T> &C, Index ndim, Index batch_ndim, int redux=0,
+        GemmCompute compute=GemmCompute(GemmCompute::Default));
+
+template<typename T>
+void gemm_mixed_async(fp32_t alpha, const TransOp &transA, const Tensor<T> &A,
+        const TransOp &transB, const Tensor<T> &B, fp32_t beta,
+        const Tensor<fp32_t> &C, Index ndim, Index batch_ndim, int redux=0,
+        GemmCompute compute=GemmCompute(GemmCompute::Default));
+
+template<typename T>
+void gemm_mixed(fp32_t alpha, const TransOp &transA, const Tensor<T> &A,
+        const TransOp &transB, const Tensor<T> &B, fp32_t beta,
+        const Tensor<fp32_t> &C, Index ndim, Index batch_ndim, int redux=0,
+        GemmCompute compute=GemmCompute(GemmCompute::Default));
 
 } // namespace tensor
 } // namespace nntile
@@ -0,0 +1,39 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/gemm_bias_gelutanh.hh
+ * GEMM with fused bias addition and approximate GeLU of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <nntile/constants.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void gemm_bias_gelutanh_async(T alpha, const TransOp &transA,
+        const Tensor<T> &A, const TransOp &transB, const Tensor<T> &B,
+        const Tensor<T> &bias, const Tensor<T> &C, const Tensor<T> &D,
+        Index ndim, Index axis, int redux=0);
+
+template<typename T>
+void gemm_bias_gelutanh(T alpha, const TransOp &transA, const Tensor<T> &A,
+        const TransOp &transB, const Tensor<T> &B, const Tensor<T> &bias,
+        const Tensor<T> &C, const Tensor<T> &D, Index ndim, Index axis,
+        int redux=0);
+
+} // namespace tensor
+} // namespace nntile
+
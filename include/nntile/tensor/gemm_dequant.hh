@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/gemm_dequant.hh
+ * Gemm with dequantization of 8-bit weights on the fly for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename Q>
+void gemm_dequant_async(fp32_t alpha, const Tensor<Q> &A,
+        const Tensor<fp32_t> &scale, const Tensor<fp32_t> &B, fp32_t beta,
+        const Tensor<fp32_t> &C, Index ndim);
+
+template<typename Q>
+void gemm_dequant(fp32_t alpha, const Tensor<Q> &A,
+        const Tensor<fp32_t> &scale, const Tensor<fp32_t> &B, fp32_t beta,
+        const Tensor<fp32_t> &C, Index ndim);
+
+} // namespace tensor
+} // namespace nntile
+
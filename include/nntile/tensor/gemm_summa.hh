@@ -0,0 +1,40 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/gemm_summa.hh
+ * Communication-avoiding distributed GEMM (SUMMA and 2.5D) for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <nntile/constants.hh>
+#include <vector>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void gemm_summa_async(T alpha, const TransOp &transA, const Tensor<T> &A,
+        const TransOp &transB, const Tensor<T> &B, T beta,
+        const Tensor<T> &C, Index ndim, Index batch_ndim,
+        const std::vector<Tensor<T>> &C_replicas={}, int redux=0);
+
+template<typename T>
+void gemm_summa(T alpha, const TransOp &transA, const Tensor<T> &A,
+        const TransOp &transB, const Tensor<T> &B, T beta,
+        const Tensor<T> &C, Index ndim, Index batch_ndim,
+        const std::vector<Tensor<T>> &C_replicas={}, int redux=0);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/global_nrm2.hh
+ * Euclidean norm of many tensors as a whole
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <vector>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous Euclidean norm of many tensors as a whole
+template<typename T>
+void global_nrm2_async(const std::vector<Tensor<T>> &src,
+        const Tensor<T> &dst);
+
+// Blocking version of Euclidean norm of many tensors as a whole
+template<typename T>
+void global_nrm2(const std::vector<Tensor<T>> &src, const Tensor<T> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
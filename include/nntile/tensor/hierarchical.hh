@@ -0,0 +1,129 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/hierarchical.hh
+ * Tensor with two levels of tiles: node tiles split into device tiles
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/partition.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Level of tiles of a hierarchical tensor
+enum class TileLevel: int
+{
+    //! Large tiles, distributed over MPI nodes
+    Node,
+    //! Parts of node tiles for workers of a node
+    Device
+};
+
+//! Tensor with node tiles, that are split into device tiles
+/*! Tiles are distributed over MPI nodes at the node level, so that large
+ * tiles keep the number of MPI messages small. Every node tile is split into
+ * device tiles along the last axis without copying data (see
+ * TensorPartition), and all device tiles of a node tile stay on its owner,
+ * so operations at the device level never communicate. Operations, that
+ * move data between nodes (e.g. gemm, copy or redistribute), shall use the
+ * node level, while elementwise operations and reductions over fibers may
+ * use many small device tiles to load all the CPU cores and GPUs of a node.
+ *
+ * Both levels are ordinary tensors, and get() or node() and device() submit
+ * an asynchronous switch between them when the requested level is not the
+ * current one. A switch is ordered by StarPU after all the tasks, that were
+ * submitted for the other level. Tensor of a level obtained before a switch
+ * shall not be used until the level is requested again.
+ * */
+template<typename T>
+class HierarchicalTensor
+{
+    // Node level tensor, that owns tiles
+    Tensor<T> _node;
+    // Split of node tiles into device tiles
+    TensorPartition<T> _partition;
+    // Current level
+    TileLevel _level;
+public:
+    //! Constructor
+    /*! Node tiles are described by traits and distribution, as for
+     * Tensor<T>, and device tiles have the same base tile except the last
+     * axis, where it shall divide the base tile of node tiles. Tags of both
+     * levels start at last_tag. The tensor starts at the node level.
+     * */
+    explicit HierarchicalTensor(const TensorTraits &traits,
+            const std::vector<int> &distribution,
+            Index device_basetile_last, starpu_mpi_tag_t &last_tag):
+        _node(traits, distribution, last_tag),
+        _partition(_node, device_basetile_last, last_tag),
+        _level(TileLevel::Node)
+    {
+    }
+    HierarchicalTensor(const HierarchicalTensor &) = delete;
+    ~HierarchicalTensor()
+    {
+        unregister();
+    }
+    //! Current level of tiles
+    TileLevel level() const
+    {
+        return _level;
+    }
+    //! Tensor of the requested level, switching to it if needed
+    const Tensor<T> &get(TileLevel level)
+    {
+        if(level != _level)
+        {
+            if(level == TileLevel::Device)
+            {
+                _partition.partition_submit();
+            }
+            else
+            {
+                _partition.unpartition_submit();
+            }
+            _level = level;
+        }
+        if(level == TileLevel::Device)
+        {
+            return _partition.parts;
+        }
+        return _node;
+    }
+    //! Tensor of node tiles
+    const Tensor<T> &node()
+    {
+        return get(TileLevel::Node);
+    }
+    //! Tensor of device tiles
+    const Tensor<T> &device()
+    {
+        return get(TileLevel::Device);
+    }
+    //! Unregister both levels, switching back to node tiles first
+    void unregister()
+    {
+        if(_level == TileLevel::Device)
+        {
+            _partition.unpartition_submit();
+            _level = TileLevel::Node;
+        }
+        _partition.clean();
+        _node.unregister();
+    }
+};
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/layer_norm.hh
+ * Fused layer normalization of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-05
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void layer_norm_async(T eps, const Tensor<T> &src, const Tensor<T> &gamma,
+        const Tensor<T> &beta, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &dst, Index axis);
+
+template<typename T>
+void layer_norm(T eps, const Tensor<T> &src, const Tensor<T> &gamma,
+        const Tensor<T> &beta, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &dst, Index axis);
+
+} // namespace tensor
+} // namespace nntile
+
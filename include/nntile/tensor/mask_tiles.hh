@@ -0,0 +1,47 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/mask_tiles.hh
+ * Classification of tiles of a boolean mask of attention
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Kind of a tile of a mask
+enum class MaskTile: int
+{
+    // All entries are false, pair of tiles of keys and queries is skipped
+    empty,
+    // Some entries are false, mask is applied
+    partial,
+    // No false entries, mask is not applied at all
+    full,
+    // Square tile on the diagonal with entries mask[k,q] = (k <= q), fused
+    // flash attention generates it out of indices and does not read it
+    causal
+};
+
+// Get kinds of all tiles of a mask on every node
+std::vector<MaskTile> mask_tiles(const Tensor<bool_t> &mask);
+
+// Get a given block-sparse layout of a mask or kinds of its tiles
+std::vector<MaskTile> mask_layout(const Tensor<bool_t> &mask,
+        const std::vector<MaskTile> &layout);
+
+} // namespace tensor
+} // namespace nntile
+
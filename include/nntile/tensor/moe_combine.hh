@@ -0,0 +1,44 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/moe_combine.hh
+ * Weighted scatter of outputs of experts back to tokens
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void moe_combine_async(const Tensor<Index> &slots, const Tensor<T> &probs,
+        const Tensor<T> &buf, const Tensor<T> &y);
+
+template<typename T>
+void moe_combine(const Tensor<Index> &slots, const Tensor<T> &probs,
+        const Tensor<T> &buf, const Tensor<T> &y);
+
+template<typename T>
+void moe_combine_backward_async(const Tensor<Index> &slots,
+        const Tensor<T> &probs, const Tensor<T> &buf, const Tensor<T> &dy,
+        const Tensor<T> &dbuf, const Tensor<T> &dprobs);
+
+template<typename T>
+void moe_combine_backward(const Tensor<Index> &slots, const Tensor<T> &probs,
+        const Tensor<T> &buf, const Tensor<T> &dy, const Tensor<T> &dbuf,
+        const Tensor<T> &dprobs);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,42 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/moe_dispatch.hh
+ * Gather of tokens into buffers of experts
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void moe_dispatch_async(const Tensor<Index> &slots, const Tensor<T> &x,
+        const Tensor<T> &buf);
+
+template<typename T>
+void moe_dispatch(const Tensor<Index> &slots, const Tensor<T> &x,
+        const Tensor<T> &buf);
+
+template<typename T>
+void moe_dispatch_backward_async(const Tensor<Index> &slots,
+        const Tensor<T> &dbuf, const Tensor<T> &dx);
+
+template<typename T>
+void moe_dispatch_backward(const Tensor<Index> &slots, const Tensor<T> &dbuf,
+        const Tensor<T> &dx);
+
+} // namespace tensor
+} // namespace nntile
+
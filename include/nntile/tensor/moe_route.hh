@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/moe_route.hh
+ * Routing of tokens to slots of experts
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void moe_route_async(const Tensor<Index> &experts, const Tensor<Index> &slots,
+        const Tensor<T> &load);
+
+template<typename T>
+void moe_route(const Tensor<Index> &experts, const Tensor<Index> &slots,
+        const Tensor<T> &load);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,57 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/multi_adam_step.hh
+ * Fused Adam and AdamW steps for many Tensor<T> at once
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-02
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <vector>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void multi_adam_step_async(Index num_iter, T beta_1, T beta_2, T eps, T lr,
+        T weight_decay, bool decoupled, const std::vector<Tensor<T>> &grad,
+        const std::vector<Tensor<T>> &first_moment,
+        const std::vector<Tensor<T>> &second_moment,
+        const std::vector<Tensor<T>> &p, Index max_nelems);
+
+template<typename T>
+void multi_adam_step(Index num_iter, T beta_1, T beta_2, T eps, T lr,
+        T weight_decay, bool decoupled, const std::vector<Tensor<T>> &grad,
+        const std::vector<Tensor<T>> &first_moment,
+        const std::vector<Tensor<T>> &second_moment,
+        const std::vector<Tensor<T>> &p, Index max_nelems);
+
+template<typename T>
+void multi_adam_step_scaled_async(Index num_iter, T beta_1, T beta_2, T eps,
+        T weight_decay, bool decoupled, const std::vector<Tensor<T>> &grad,
+        const std::vector<Tensor<T>> &first_moment,
+        const std::vector<Tensor<T>> &second_moment,
+        const std::vector<Tensor<T>> &p, const Tensor<T> &scalars,
+        Index max_nelems);
+
+template<typename T>
+void multi_adam_step_scaled(Index num_iter, T beta_1, T beta_2, T eps,
+        T weight_decay, bool decoupled, const std::vector<Tensor<T>> &grad,
+        const std::vector<Tensor<T>> &first_moment,
+        const std::vector<Tensor<T>> &second_moment,
+        const std::vector<Tensor<T>> &p, const Tensor<T> &scalars,
+        Index max_nelems);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,156 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/partition.hh
+ * Temporary split of tiles of a tensor into sub-tiles by StarPU partitioning
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Temporary split of tiles of a tensor into sub-tiles along the last axis
+/*! Tile granularity of a tensor is fixed at construction, while many small
+ * tiles are better for elementwise operations and reductions on CPU and
+ * large tiles are better for gemm. Every tile is split into contiguous
+ * sub-tiles, as a range of the last axis of a tile in a Fortran order is
+ * contiguous, and the parts form a tensor with a smaller base tile along
+ * the last axis. No data is copied.
+ *
+ * Tasks may use the tensor of parts only between partition_submit() and
+ * unpartition_submit(), and the source tensor only outside of this range.
+ * StarPU orders all the tasks accordingly. Parts are unregistered by
+ * clean() or by the destructor, while tiles are not partitioned.
+ * */
+template<typename T>
+class TensorPartition
+{
+    // Plan partitions of all the tiles
+    static std::vector<starpu::VariablePartition> _plan(const Tensor<T> &src,
+            Index basetile_last, starpu_mpi_tag_t &last_tag)
+    {
+        if(src.ndim == 0)
+        {
+            throw std::runtime_error("Scalar tensor cannot be partitioned");
+        }
+        if(basetile_last <= 0
+                or src.basetile_shape[src.ndim-1] % basetile_last != 0)
+        {
+            throw std::runtime_error("Base tile of parts shall divide base "
+                    "tile of the tensor along the last axis");
+        }
+        std::vector<starpu::VariablePartition> plans;
+        plans.reserve(src.grid.nelems);
+        for(Index i = 0; i < src.grid.nelems; ++i)
+        {
+            const auto &traits = src.get_tile_traits(i);
+            Index last = traits.shape[src.ndim-1];
+            Index stride = traits.stride[src.ndim-1];
+            Index nparts = (last-1)/basetile_last + 1;
+            std::vector<size_t> bounds(nparts+1);
+            for(Index j = 0; j <= nparts; ++j)
+            {
+                bounds[j] = sizeof(T) * stride
+                    * std::min(j*basetile_last, last);
+            }
+            plans.emplace_back(src.get_tile_handle(i), bounds, last_tag);
+        }
+        return plans;
+    }
+    // Traits of the tensor of parts
+    static TensorTraits _parts_traits(const Tensor<T> &src,
+            Index basetile_last)
+    {
+        std::vector<Index> basetile(src.basetile_shape);
+        basetile[src.ndim-1] = basetile_last;
+        return TensorTraits(src.shape, basetile);
+    }
+    // Parts of tiles in the order of tiles of the tensor of parts
+    static std::vector<starpu::VariableHandle> _parts_handles(
+            const Tensor<T> &src, const TensorTraits &traits,
+            const std::vector<starpu::VariablePartition> &plans,
+            std::vector<int> &distr)
+    {
+        Index ndim = src.ndim;
+        Index ratio = src.basetile_shape[ndim-1]
+            / traits.basetile_shape[ndim-1];
+        std::vector<starpu::VariableHandle> handles;
+        handles.reserve(traits.grid.nelems);
+        distr.resize(traits.grid.nelems);
+        for(Index i = 0; i < traits.grid.nelems; ++i)
+        {
+            auto index = traits.grid.linear_to_index(i);
+            Index part = index[ndim-1] % ratio;
+            index[ndim-1] /= ratio;
+            Index j = src.grid.index_to_linear(index);
+            handles.push_back(plans[j].parts[part]);
+            distr[i] = src.tile_distr[j];
+        }
+        return handles;
+    }
+    // Distribution of parts, that is set by _parts_handles
+    std::vector<int> _distr;
+public:
+    //! Plans of partitions of all the tiles of the source tensor
+    std::vector<starpu::VariablePartition> plans;
+    //! Tensor of parts
+    Tensor<T> parts;
+    //! Plan a split of tiles into parts of basetile_last along the last axis
+    /*! basetile_last shall divide the base tile of the source tensor along
+     * the last axis. With MPI parts get tags, starting at last_tag.
+     * */
+    explicit TensorPartition(const Tensor<T> &src, Index basetile_last,
+            starpu_mpi_tag_t &last_tag):
+        plans(_plan(src, basetile_last, last_tag)),
+        parts(_parts_traits(src, basetile_last),
+                _parts_handles(src, _parts_traits(src, basetile_last), plans,
+                    _distr), _distr, last_tag)
+    {
+    }
+    TensorPartition(const TensorPartition &) = delete;
+    ~TensorPartition()
+    {
+        clean();
+    }
+    //! Submit switch from tiles to parts
+    void partition_submit() const
+    {
+        for(const auto &plan: plans)
+        {
+            plan.partition_submit();
+        }
+    }
+    //! Submit switch from parts back to tiles
+    void unpartition_submit() const
+    {
+        for(const auto &plan: plans)
+        {
+            plan.unpartition_submit();
+        }
+    }
+    //! Unregister parts
+    void clean()
+    {
+        parts.unregister();
+        for(auto &plan: plans)
+        {
+            plan.clean();
+        }
+    }
+};
+
+} // namespace tensor
+} // namespace nntile
+
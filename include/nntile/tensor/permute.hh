@@ -0,0 +1,40 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/permute.hh
+ * Permutation of axes of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Check if dst is src with permuted axes
+void permute_check(const TensorTraits &src, const TensorTraits &dst,
+        const std::vector<Index> &perm);
+
+// Asynchronous tensor-wise permutation of axes
+template<typename T>
+void permute_async(const Tensor<T> &src, const Tensor<T> &dst,
+        const std::vector<Index> &perm);
+
+// Blocking version of tensor-wise permutation of axes
+template<typename T>
+void permute(const Tensor<T> &src, const Tensor<T> &dst,
+        const std::vector<Index> &perm);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,39 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/quantize.hh
+ * Quantization of weights into 8-bit types with per-group scales for
+ * Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Check if tensors match quantize
+void quantize_check(const TensorTraits &src, const TensorTraits &dst,
+        const TensorTraits &scale, Index axis, Index group);
+
+template<typename Q>
+void quantize_async(const Tensor<fp32_t> &src, const Tensor<Q> &dst,
+        const Tensor<fp32_t> &scale, Index axis, Index group);
+
+template<typename Q>
+void quantize(const Tensor<fp32_t> &src, const Tensor<Q> &dst,
+        const Tensor<fp32_t> &scale, Index axis, Index group);
+
+} // namespace tensor
+} // namespace nntile
+
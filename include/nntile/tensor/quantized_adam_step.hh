@@ -0,0 +1,48 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/quantized_adam_step.hh
+ * Fused Adam step with block-wise 8-bit moments for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Check if tensors match quantized_adam_step
+void quantized_adam_step_check(Index block, const TensorTraits &p,
+        const TensorTraits &moment, const TensorTraits &scale);
+
+// Asynchronous tensor-wise Adam step with block-wise 8-bit moments
+void quantized_adam_step_async(Index num_iter, Index block, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t lr, fp32_t weight_decay,
+        bool decoupled, const Tensor<fp32_t> &grad,
+        const Tensor<std::int8_t> &first_moment,
+        const Tensor<fp32_t> &first_scale,
+        const Tensor<fp8_e4m3_t> &second_moment,
+        const Tensor<fp32_t> &second_scale, const Tensor<fp32_t> &p);
+
+// Blocking version of tensor-wise Adam step with block-wise 8-bit moments
+void quantized_adam_step(Index num_iter, Index block, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t lr, fp32_t weight_decay,
+        bool decoupled, const Tensor<fp32_t> &grad,
+        const Tensor<std::int8_t> &first_moment,
+        const Tensor<fp32_t> &first_scale,
+        const Tensor<fp8_e4m3_t> &second_moment,
+        const Tensor<fp32_t> &second_scale, const Tensor<fp32_t> &p);
+
+} // namespace tensor
+} // namespace nntile
+
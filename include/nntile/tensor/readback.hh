@@ -0,0 +1,76 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/readback.hh
+ * Ring buffer in host memory for asynchronous readback of scalar tensors
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Ring buffer in host memory for asynchronous readback of scalar tensors
+/*! Every submit() copies a scalar tensor into the next slot of the ring by
+ * a low priority task and returns a ticket of the value. Values are read by
+ * tickets without any barrier: is_ready() does not wait at all and wait()
+ * waits only for the copy of the given ticket. A slot is reused after
+ * capacity submissions, so a ticket may be read until capacity newer
+ * values are submitted. Every MPI node gets its own copy of each value.
+ * */
+template<typename T>
+class Readback
+{
+    //! Number of slots
+    Index capacity;
+    //! Values of slots
+    std::vector<T> values;
+    //! Ticket of the value of every slot, that is already copied, or -1
+    std::unique_ptr<std::atomic<Index>[]> ready;
+    //! Ticket of the next submission
+    Index next_ticket;
+public:
+    //! Constructor for a given number of slots
+    explicit Readback(Index capacity_);
+    //! Wait for all the pending copies, as they write into the ring
+    ~Readback();
+    Readback(const Readback &) = delete;
+    Readback &operator=(const Readback &) = delete;
+    //! Submit a copy of a scalar tensor and get its ticket
+    /*! If the slot is still occupied by a pending copy, that was submitted
+     * capacity submissions ago, waits for it.
+     * */
+    Index submit(const Tensor<T> &src);
+    //! Check if the value of a ticket is already copied
+    bool is_ready(Index ticket) const;
+    //! Wait for the value of a ticket and get it
+    T wait(Index ticket) const;
+    //! Ticket of the next submission
+    Index get_next_ticket() const
+    {
+        return next_ticket;
+    }
+    //! Number of slots
+    Index get_capacity() const
+    {
+        return capacity;
+    }
+};
+
+} // namespace tensor
+} // namespace nntile
+
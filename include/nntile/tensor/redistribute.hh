@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/redistribute.hh
+ * Redistribute tensor into another tiling or distribution
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-09
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous tensor-wise redistribution operation
+template<typename T>
+void redistribute_async(const Tensor<T> &src, const Tensor<T> &dst);
+
+// Blocking version of tensor-wise redistribution operation
+template<typename T>
+void redistribute(const Tensor<T> &src, const Tensor<T> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/rms_norm.hh
+ * Root mean square layer normalization of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void rms_norm_async(T eps, const Tensor<T> &src, const Tensor<T> &gamma,
+        const Tensor<T> &inv_rms, const Tensor<T> &dst, Index axis);
+
+template<typename T>
+void rms_norm(T eps, const Tensor<T> &src, const Tensor<T> &gamma,
+        const Tensor<T> &inv_rms, const Tensor<T> &dst, Index axis);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,42 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/rope.hh
+ * Rotary position embedding of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous in-place rotary position embedding
+template<typename T>
+void rope_async(T base, Index position, const Tensor<T> &x);
+
+// Blocking version of in-place rotary position embedding
+template<typename T>
+void rope(T base, Index position, const Tensor<T> &x);
+
+// Asynchronous backward of in-place rotary position embedding
+template<typename T>
+void rope_backward_async(T base, Index position, const Tensor<T> &dx);
+
+// Blocking version of backward of in-place rotary position embedding
+template<typename T>
+void rope_backward(T base, Index position, const Tensor<T> &dx);
+
+} // namespace tensor
+} // namespace nntile
+
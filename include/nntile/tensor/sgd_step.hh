@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/sgd_step.hh
+ * Fused SGD step with momentum for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous tensor-wise fused SGD step with momentum
+template<typename T>
+void sgd_step_async(Index num_iter, T momentum, T dampening, T lr,
+        T weight_decay, bool nesterov, const Tensor<T> &grad,
+        const Tensor<T> &velocity, const Tensor<T> &p);
+
+// Blocking version of tensor-wise fused SGD step with momentum
+template<typename T>
+void sgd_step(Index num_iter, T momentum, T dampening, T lr, T weight_decay,
+        bool nesterov, const Tensor<T> &grad, const Tensor<T> &velocity,
+        const Tensor<T> &p);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/softmax_crossentropy.hh
+ * Fused loss and gradient of softmax cross-entropy for tensors
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-14
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous fused loss and gradient of softmax cross-entropy
+template<typename T>
+void softmax_crossentropy_async(T scale, const Tensor<T> &maxsumexp,
+        const Tensor<T> &src, const Tensor<Index> &labels,
+        const Tensor<T> &dst, const Tensor<T> &val, Index label_offset);
+
+// Blocking fused loss and gradient of softmax cross-entropy
+template<typename T>
+void softmax_crossentropy(T scale, const Tensor<T> &maxsumexp,
+        const Tensor<T> &src, const Tensor<Index> &labels,
+        const Tensor<T> &dst, const Tensor<T> &val, Index label_offset);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/softmax_online.hh
+ * Online softmax along an axis of a tensor
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Tensor<T> online softmax along an axis, that needs no maxsumexp tensor
+template<typename T>
+void softmax_online_async(T alpha, const Tensor<T> &dst, Index axis);
+
+// Tensor<T> online softmax along an axis, that needs no maxsumexp tensor
+template<typename T>
+void softmax_online(T alpha, const Tensor<T> &dst, Index axis);
+
+} // namespace tensor
+} // namespace nntile
+
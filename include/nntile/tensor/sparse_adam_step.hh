@@ -0,0 +1,40 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/sparse_adam_step.hh
+ * Fused Adam step on marked columns of tensors
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-13
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous tensor-wise sparse Adam step
+template<typename T>
+void sparse_adam_step_async(T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        const Tensor<bool_t> &cols, const Tensor<Index> &cols_iter,
+        const Tensor<T> &grad, const Tensor<T> &first_moment,
+        const Tensor<T> &second_moment, const Tensor<T> &p);
+
+// Blocking version of tensor-wise sparse Adam step
+template<typename T>
+void sparse_adam_step(T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        const Tensor<bool_t> &cols, const Tensor<Index> &cols_iter,
+        const Tensor<T> &grad, const Tensor<T> &first_moment,
+        const Tensor<T> &second_moment, const Tensor<T> &p);
+
+} // namespace tensor
+} // namespace nntile
+
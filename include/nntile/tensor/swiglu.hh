@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/swiglu.hh
+ * Tensor wrappers for SiLU-gated product
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Tensor-wise SiLU-gated product dst = SiLU(gate) * up
+template<typename T>
+void swiglu_async(const Tensor<T> &gate, const Tensor<T> &up,
+        const Tensor<T> &dst);
+
+template<typename T>
+void swiglu(const Tensor<T> &gate, const Tensor<T> &up, const Tensor<T> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/swiglu_backward.hh
+ * Tensor wrappers for backward of SiLU-gated product
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Tensor-wise backward of SiLU-gated product
+template<typename T>
+void swiglu_backward_async(const Tensor<T> &gate, const Tensor<T> &up,
+        const Tensor<T> &dst_grad, const Tensor<T> &gate_grad,
+        const Tensor<T> &up_grad);
+
+template<typename T>
+void swiglu_backward(const Tensor<T> &gate, const Tensor<T> &up,
+        const Tensor<T> &dst_grad, const Tensor<T> &gate_grad,
+        const Tensor<T> &up_grad);
+
+} // namespace tensor
+} // namespace nntile
+
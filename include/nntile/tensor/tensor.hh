@@ -17,15 +17,12 @@
 #include <cstdlib>
 #include <nntile/tensor/traits.hh>
 #include <nntile/tile/tile.hh>
-//#include <starpu_mpi.h>
 #include <starpu.h>
 #include <nntile/starpu/accumulate.hh>
 #include <nntile/starpu/accumulate_hypot.hh>
 #include <nntile/starpu/accumulate_maxsumexp.hh>
 #include <nntile/starpu/clear.hh>
 
-#define starpu_mpi_tag_t int64_t
-
 namespace nntile
 {
 namespace tensor
@@ -38,6 +35,13 @@ static std::ostream &operator<<(std::ostream &cout, fp16_t val)
     return cout;
 }
 
+// Overload for printing bf16_t
+static std::ostream &operator<<(std::ostream &cout, bf16_t val)
+{
+    cout << static_cast<fp32_t>(val);
+    return cout;
+}
+
 //! Many-dimensional tensor, presented by a set of subtensors (tiles)
 //
 // This is the main data storage class, that assumes a tensor as a set of
@@ -46,12 +50,25 @@ template<typename T>
 class Tensor: public TensorTraits
 {
 public:
-    //! Traits of all tiles
+    //! Axes, where the leftover tile differs from the base tile
+    std::vector<Index> leftover_axes;
+    //! Traits of distinct shapes of tiles
+    /*! Only tiles, that are the last along the leftover axes, differ from
+     * the base tile, so there are at most 2^leftover_axes.size() shapes of
+     * tiles. A shape is encoded by a mask of leftover axes, along which the
+     * tile is the last one (see get_tile_traits()), while traits of tiles
+     * are not stored per tile, as it takes memory and construction time
+     * for large grids.
+     * */
     std::vector<tile::TileTraits> tile_traits;
     //! StarPU handles of all tiles
     std::vector<starpu::VariableHandle> tile_handles;
     //! Distribution of tiles
     std::vector<int> tile_distr;
+    //! CUDA devices, that own tiles, or empty if tiles are not pinned
+    std::vector<int> tile_devices;
+    //! NUMA nodes, that own tiles, or empty if tiles are not placed
+    std::vector<int> tile_numa;
     //! Next tag to be used
     starpu_mpi_tag_t next_tag;
     //! Constructor
@@ -67,27 +84,201 @@ public:
             throw std::runtime_error("Wrong distribution");
         }
         // Register tiles
-        tile_traits.reserve(grid.nelems);
+        _init_tile_traits();
         tile_handles.reserve(grid.nelems);
         for(Index i = 0; i < grid.nelems; ++i)
         {
-            // At first check if last tag is less than maximal tag
-            // Get tile index
-            const auto tile_index = grid.linear_to_index(i);
-            // Get shape of corresponding tile
-            const auto tile_shape = TensorTraits::get_tile_shape(tile_index);
-            // Generate traits for the tile
-            tile_traits.emplace_back(tile_shape);
             // Set StarPU-managed handle
-            tile_handles.emplace_back(sizeof(T)*tile_traits[i].nelems,
+            tile_handles.emplace_back(sizeof(T)*get_tile_traits(i).nelems,
                     STARPU_R);
+#ifdef NNTILE_USE_MPI
             // Register tile with MPI
-            //starpu_mpi_data_register(
-            //        static_cast<starpu_data_handle_t>(tile_handles[i]),
-            //        last_tag, distribution[i]);
-            //++last_tag;
+            starpu_mpi_data_register(
+                    static_cast<starpu_data_handle_t>(tile_handles[i]),
+                    last_tag, distribution[i]);
+            ++last_tag;
+#endif // NNTILE_USE_MPI
         }
         next_tag = last_tag;
+        _set_default_name();
+    }
+    //! Constructor out of user buffers of local tiles
+    /*! Tiles, owned by the current MPI node, are registered with provided
+     * contiguous buffers in CPU RAM without copying. Buffers shall outlive
+     * the tensor, as values of tiles are written back into the buffers
+     * when the tensor is unregistered. Pointers for tiles, owned by other
+     * MPI nodes, are ignored and may be nullptr.
+     * */
+    explicit Tensor(const TensorTraits &traits,
+            const std::vector<int> &distribution,
+            starpu_mpi_tag_t &last_tag, const std::vector<T *> &tile_ptrs):
+        TensorTraits(traits),
+        tile_distr(distribution)
+    {
+        // Check distribution and buffers
+        if(distribution.size() != grid.nelems)
+        {
+            throw std::runtime_error("Wrong distribution");
+        }
+        if(tile_ptrs.size() != grid.nelems)
+        {
+            throw std::runtime_error("Wrong number of tile buffers");
+        }
+        int mpi_rank = starpu_mpi_world_rank();
+        // Register tiles
+        _init_tile_traits();
+        tile_handles.reserve(grid.nelems);
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            Index tile_nelems = get_tile_traits(i).nelems;
+            if(distribution[i] == mpi_rank)
+            {
+                if(tile_ptrs[i] == nullptr)
+                {
+                    throw std::runtime_error("Buffer of a local tile is "
+                            "nullptr");
+                }
+                // Set user-managed handle
+                tile_handles.emplace_back(tile_ptrs[i],
+                        sizeof(T)*tile_nelems, STARPU_RW);
+            }
+            else
+            {
+                // Set StarPU-managed handle
+                tile_handles.emplace_back(sizeof(T)*tile_nelems, STARPU_R);
+            }
+#ifdef NNTILE_USE_MPI
+            // Register tile with MPI
+            starpu_mpi_data_register(
+                    static_cast<starpu_data_handle_t>(tile_handles[i]),
+                    last_tag, distribution[i]);
+            ++last_tag;
+#endif // NNTILE_USE_MPI
+        }
+        next_tag = last_tag;
+        _set_default_name();
+    }
+    //! Constructor of a view, that shares tiles of another tensor
+    /*! The i-th tile of the view is the tile src_tiles[i] of the source
+     * tensor, that shall be of the same shape. Nothing is copied or
+     * registered, so StarPU orders tasks on the view and on the source
+     * tensor as usual, and unregistering the view only drops references to
+     * the tiles. It is used by pages of a paged KV-cache.
+     * */
+    explicit Tensor(const TensorTraits &traits, const Tensor<T> &src,
+            const std::vector<Index> &src_tiles):
+        TensorTraits(traits),
+        next_tag(src.next_tag)
+    {
+        if(src_tiles.size() != grid.nelems)
+        {
+            throw std::runtime_error("Wrong number of tiles");
+        }
+        _init_tile_traits();
+        tile_handles.reserve(grid.nelems);
+        tile_distr.reserve(grid.nelems);
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            Index j = src_tiles[i];
+            if(j < 0 or j >= src.grid.nelems)
+            {
+                throw std::runtime_error("Tile offset is out of bounds");
+            }
+            if(get_tile_traits(i).shape != src.get_tile_traits(j).shape)
+            {
+                throw std::runtime_error("Shape of a tile of the view "
+                        "differs from the source tile");
+            }
+            tile_handles.push_back(src.tile_handles[j]);
+            tile_distr.push_back(src.tile_distr[j]);
+            if(not src.tile_devices.empty())
+            {
+                tile_devices.push_back(src.tile_devices[j]);
+            }
+            if(not src.tile_numa.empty())
+            {
+                tile_numa.push_back(src.tile_numa[j]);
+            }
+        }
+    }
+    //! Constructor out of already registered tiles
+    /*! Handles are shared and not registered again, e.g. parts of
+     * partitioned tiles of another tensor (see TensorPartition).
+     * */
+    explicit Tensor(const TensorTraits &traits,
+            const std::vector<starpu::VariableHandle> &handles,
+            const std::vector<int> &distribution,
+            starpu_mpi_tag_t next_tag_):
+        TensorTraits(traits),
+        tile_handles(handles),
+        tile_distr(distribution),
+        next_tag(next_tag_)
+    {
+        if(handles.size() != grid.nelems or distribution.size() != grid.nelems)
+        {
+            throw std::runtime_error("Wrong number of tiles");
+        }
+        _init_tile_traits();
+    }
+    //! Constructor of a tile-aligned slice, that shares tiles of a tensor
+    /*! The view consists of tiles with indices from tile_start to
+     * tile_start+tile_shape-1 of the source tensor, e.g. a range of heads,
+     * sequences of a batch or a window of a KV-cache. It has the same base
+     * tile as the source tensor, so only the last tile along each axis of
+     * the source tensor may be a leftover.
+     * */
+    explicit Tensor(const Tensor<T> &src,
+            const std::vector<Index> &tile_start,
+            const std::vector<Index> &tile_shape):
+        Tensor(_slice_traits(src, tile_start, tile_shape), src,
+                _slice_tiles(src, tile_start, tile_shape))
+    {
+    }
+    // Traits of a tile-aligned slice
+    static TensorTraits _slice_traits(const TensorTraits &src,
+            const std::vector<Index> &tile_start,
+            const std::vector<Index> &tile_shape)
+    {
+        if(tile_start.size() != src.ndim or tile_shape.size() != src.ndim)
+        {
+            throw std::runtime_error("Wrong dimensionality");
+        }
+        std::vector<Index> shape(src.ndim);
+        for(Index i = 0; i < src.ndim; ++i)
+        {
+            Index end = tile_start[i] + tile_shape[i];
+            if(tile_start[i] < 0 or tile_shape[i] <= 0
+                    or end > src.grid.shape[i])
+            {
+                throw std::runtime_error("Tiles of the slice are out of "
+                        "bounds");
+            }
+            shape[i] = tile_shape[i] * src.basetile_shape[i];
+            // The last tile of the source tensor may be a leftover
+            if(end == src.grid.shape[i])
+            {
+                shape[i] += src.leftover_shape[i] - src.basetile_shape[i];
+            }
+        }
+        return TensorTraits(shape, src.basetile_shape);
+    }
+    // Linear offsets of tiles of a tile-aligned slice in the source tensor
+    static std::vector<Index> _slice_tiles(const TensorTraits &src,
+            const std::vector<Index> &tile_start,
+            const std::vector<Index> &tile_shape)
+    {
+        tile::TileTraits slice_grid(tile_shape);
+        std::vector<Index> tiles(slice_grid.nelems);
+        for(Index i = 0; i < slice_grid.nelems; ++i)
+        {
+            auto index = slice_grid.linear_to_index(i);
+            for(Index j = 0; j < src.ndim; ++j)
+            {
+                index[j] += tile_start[j];
+            }
+            tiles[i] = src.grid.index_to_linear(index);
+        }
+        return tiles;
     }
     tile::Tile<T> get_tile(Index linear_offset) const
     {
@@ -95,24 +286,35 @@ public:
         {
             throw std::runtime_error("Tile offset is out of bounds");
         }
-        return tile::Tile<T>(tile_traits[linear_offset],
+        return tile::Tile<T>(get_tile_traits(linear_offset),
                 tile_handles[linear_offset]);
     }
     tile::Tile<T> get_tile(const std::vector<Index> &tile_index) const
     {
         Index linear_offset = grid.index_to_linear(tile_index);
-        return tile::Tile<T>(tile_traits[linear_offset],
+        return tile::Tile<T>(get_tile_traits(linear_offset),
                 tile_handles[linear_offset]);
     }
     const tile::TileTraits &get_tile_traits(Index linear_offset) const
     {
-        return tile_traits[linear_offset];
+        Index mask = 0;
+        for(Index j = 0; j < leftover_axes.size(); ++j)
+        {
+            Index axis = leftover_axes[j];
+            Index tile_index = linear_offset / grid.stride[axis]
+                % grid.shape[axis];
+            if(tile_index == grid.shape[axis]-1)
+            {
+                mask |= Index(1) << j;
+            }
+        }
+        return tile_traits[mask];
     }
     const tile::TileTraits &get_tile_traits(
             const std::vector<Index> &tile_index) const
     {
         Index linear_offset = grid.index_to_linear(tile_index);
-        return tile_traits[linear_offset];
+        return get_tile_traits(linear_offset);
     }
     const starpu::Handle &get_tile_handle(Index linear_offset) const
     {
@@ -132,24 +334,165 @@ public:
             tile_handles[i].unregister();
         }
     }
+    //! Unregister underlying handles without blocking the calling thread
+    /*! See starpu::Handle::unregister_submit() for details.
+     * */
+    void unregister_submit()
+    {
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            tile_handles[i].unregister_submit();
+        }
+    }
+    //! Set name of the tensor for memory tracking and tracing
+    /*! All the tiles are tracked under the same name, so that memory usage
+     * is reported per tensor. Traced tasks refer to tiles by the name with a
+     * tile index (see starpu::trace).
+     * */
+    void set_name(const std::string &name) const
+    {
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            auto handle = static_cast<starpu_data_handle_t>(tile_handles[i]);
+            starpu::MemoryTracker::set_name(handle, name);
+            std::string tile_name = name + "[";
+            auto tile_index = grid.linear_to_index(i);
+            for(Index j = 0; j < ndim; ++j)
+            {
+                tile_name += (j > 0 ? "," : "")
+                    + std::to_string(tile_index[j]);
+            }
+            starpu::trace::set_name(handle, tile_name+"]");
+        }
+    }
+    // Traits of distinct shapes of tiles
+    void _init_tile_traits()
+    {
+        for(Index i = 0; i < ndim; ++i)
+        {
+            if(leftover_shape[i] != basetile_shape[i])
+            {
+                leftover_axes.push_back(i);
+            }
+        }
+        Index nshapes = Index(1) << leftover_axes.size();
+        tile_traits.reserve(nshapes);
+        for(Index mask = 0; mask < nshapes; ++mask)
+        {
+            std::vector<Index> tile_shape(basetile_shape);
+            for(Index j = 0; j < leftover_axes.size(); ++j)
+            {
+                if((mask >> j) & 1)
+                {
+                    tile_shape[leftover_axes[j]] =
+                        leftover_shape[leftover_axes[j]];
+                }
+            }
+            tile_traits.emplace_back(tile_shape);
+        }
+    }
+    // Unnamed tensors are tracked under a unique name
+    void _set_default_name() const
+    {
+        if(starpu::MemoryTracker::is_enabled())
+        {
+            set_name(starpu::MemoryTracker::get_default_name("tensor"));
+        }
+    }
     //! Invalidate tensor values
+    /*! All the tasks, submitted before this call, will see proper data, while
+     * all the buffers of the tiles will be deallocated after these tasks are
+     * finished. Next task shall overwrite the tensor before reading it. Only
+     * tiles, owned by the current MPI node, are invalidated.
+     * */
     void invalidate_submit() const
     {
+        int mpi_rank = starpu_mpi_world_rank();
         for(Index i = 0; i < grid.nelems; ++i)
         {
-            auto tmp = static_cast<starpu_data_handle_t>(get_tile_handle(i));
-            // Deactivate invalidate_submit
-            //starpu_data_invalidate_submit(tmp);
+            const auto &tile_handle = get_tile_handle(i);
+            if(tile_handle.mpi_get_rank() == mpi_rank)
+            {
+                auto tmp = static_cast<starpu_data_handle_t>(tile_handle);
+                starpu_data_invalidate_submit(tmp);
+            }
         }
     }
     //! Advice to evict data from GPU
+    /*! Tells StarPU that the tensor will not be used in the near future, so
+     * that its copies on CUDA devices are evicted first in a case of memory
+     * pressure. Only tiles, owned by the current MPI node and not pinned to
+     * devices, are advised.
+     * */
     void wont_use() const
     {
+        int mpi_rank = starpu_mpi_world_rank();
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            if(not tile_devices.empty() and tile_devices[i] >= 0)
+            {
+                continue;
+            }
+            const auto &tile_handle = get_tile_handle(i);
+            if(tile_handle.mpi_get_rank() == mpi_rank)
+            {
+                auto tmp = static_cast<starpu_data_handle_t>(tile_handle);
+                starpu_data_wont_use(tmp);
+            }
+        }
+    }
+    //! Offload tiles into host memory asynchronously
+    /*! Submits transfers of tiles, owned by the current MPI node, into host
+     * memory right away and advises to evict their copies on CUDA devices
+     * (see wont_use), so that the devices get memory back in a case of
+     * memory pressure without waiting for write-backs. Host memory of StarPU
+     * is pinned with CUDA enabled, so the transfers overlap with
+     * computations. Tiles, pinned to devices, are skipped.
+     * */
+    void offload_async() const
+    {
+        int mpi_rank = starpu_mpi_world_rank();
         for(Index i = 0; i < grid.nelems; ++i)
         {
-            auto tmp = static_cast<starpu_data_handle_t>(get_tile_handle(i));
-            // Deactivate wont_use
-            //starpu_data_wont_use(tmp);
+            if(not tile_devices.empty() and tile_devices[i] >= 0)
+            {
+                continue;
+            }
+            const auto &tile_handle = get_tile_handle(i);
+            if(tile_handle.mpi_get_rank() == mpi_rank)
+            {
+                auto tmp = static_cast<starpu_data_handle_t>(tile_handle);
+                starpu_data_prefetch_on_node(tmp, STARPU_MAIN_RAM, 1);
+                starpu_data_wont_use(tmp);
+            }
+        }
+    }
+    //! Prefetch tiles into a memory node asynchronously
+    /*! Hints StarPU that the tensor will be used soon, so that transfers of
+     * its tiles overlap with computations. Negative node means memory of
+     * the device, that owns a tile (see set_device_distribution), or of the
+     * only CUDA device. Only tiles, owned by the current MPI node, are
+     * prefetched.
+     * */
+    void prefetch_async(int node=-1) const
+    {
+        int mpi_rank = starpu_mpi_world_rank();
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            const auto &tile_handle = get_tile_handle(i);
+            if(tile_handle.mpi_get_rank() != mpi_rank)
+            {
+                continue;
+            }
+            auto tmp = static_cast<starpu_data_handle_t>(tile_handle);
+            if(node >= 0)
+            {
+                starpu_data_prefetch_on_node(tmp, node, 1);
+            }
+            else
+            {
+                starpu::scheduler::prefetch_on_device(tmp);
+            }
         }
     }
     //! Flush tensor from MPI caches
@@ -157,8 +500,147 @@ public:
     {
         for(Index i = 0; i < grid.nelems; ++i)
         {
-            auto tmp = static_cast<starpu_data_handle_t>(get_tile_handle(i));
-            //starpu_mpi_cache_flush(MPI_COMM_WORLD, tmp);
+            get_tile_handle(i).mpi_flush();
+        }
+    }
+    //! Change distribution of tiles over MPI nodes
+    /*! Tiles, that change their owners, are migrated to the new owners by
+     * StarPU-MPI. All nodes shall call it with the same distribution, as
+     * for the constructor. It is intended for placement of tensors of a model
+     * right after its construction, e.g., for tensor or pipeline
+     * parallelism.
+     * */
+    void set_distribution(const std::vector<int> &distribution)
+    {
+        if(distribution.size() != grid.nelems)
+        {
+            throw std::runtime_error("Wrong distribution");
+        }
+#ifdef NNTILE_USE_MPI
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            if(distribution[i] != tile_distr[i])
+            {
+                starpu_mpi_data_migrate(MPI_COMM_WORLD,
+                        static_cast<starpu_data_handle_t>(tile_handles[i]),
+                        distribution[i]);
+            }
+        }
+#endif // NNTILE_USE_MPI
+        tile_distr = distribution;
+    }
+    //! Pin tiles to CUDA devices
+    /*! Device distribution is similar to the distribution of tiles over MPI
+     * nodes, it can be generated by distributions::block_cyclic with the
+     * number of devices as the maximal rank or by distributions::local_cyclic.
+     * Tasks, that update a tile, run on its device with the locality-aware
+     * scheduler (see starpu::scheduler), and tiles, owned by the current MPI
+     * node, are prefetched into memory of their devices. Pinned tiles, e.g.,
+     * weights, stay on their devices, as wont_use() skips them.
+     * */
+    void set_device_distribution(const std::vector<int> &devices)
+    {
+        if(devices.size() != grid.nelems)
+        {
+            throw std::runtime_error("Wrong device distribution");
+        }
+        int mpi_rank = starpu_mpi_world_rank();
+        tile_devices = devices;
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            const auto &tile_handle = get_tile_handle(i);
+            auto tmp = static_cast<starpu_data_handle_t>(tile_handle);
+            starpu::scheduler::set_device(tmp, devices[i]);
+            if(tile_handle.mpi_get_rank() == mpi_rank)
+            {
+                starpu::scheduler::prefetch_on_device(tmp);
+            }
+        }
+    }
+    //! Place tiles on NUMA nodes
+    /*! NUMA distribution is similar to the distribution of tiles over MPI
+     * nodes and CUDA devices, it can be generated by
+     * distributions::block_cyclic with the number of NUMA nodes
+     * (starpu::scheduler::get_nnuma) as the maximal rank or by
+     * distributions::local_cyclic. This requires StarPU to be initialized
+     * with NUMA support (see starpu::Config). Tiles, owned by the current
+     * MPI node, are prefetched into memory of their NUMA nodes, and tasks,
+     * that update a tile on CPU, run on CPU workers of its NUMA node with
+     * the locality-aware scheduler (see starpu::scheduler). Data-aware
+     * StarPU schedulers (e.g., dmda) follow the prefetched copies by
+     * themselves.
+     * */
+    void set_numa_distribution(const std::vector<int> &numa)
+    {
+        if(numa.size() != grid.nelems)
+        {
+            throw std::runtime_error("Wrong NUMA distribution");
+        }
+        int mpi_rank = starpu_mpi_world_rank();
+        tile_numa = numa;
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            const auto &tile_handle = get_tile_handle(i);
+            auto tmp = static_cast<starpu_data_handle_t>(tile_handle);
+            starpu::scheduler::set_numa(tmp, numa[i]);
+            if(tile_handle.mpi_get_rank() == mpi_rank)
+            {
+                starpu::scheduler::prefetch_on_numa(tmp);
+            }
+        }
+    }
+    //! Allow or forbid eviction of tiles to disk
+    /*! By default, no data is evicted to the disk memory node (see
+     * starpu::Config::attach_disk). Cold tensors, e.g., parameters and states
+     * of an optimizer, that are used once per step, shall be allowed to spill
+     * to make room in host RAM for hot data.
+     * */
+    void set_spill(bool allowed=true) const
+    {
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            const auto &tmp =
+                    static_cast<starpu_data_handle_t>(get_tile_handle(i));
+            starpu_data_set_ooc_flag(tmp, allowed ? 1 : 0);
+        }
+    }
+    //! Set precision of transfers of tiles between MPI nodes
+    /*! Tiles of single precision tensors, that tolerate rounding in flight,
+     * e.g., activations and gradients, are sent between MPI nodes as "fp16"
+     * (with CUDA only) or "bf16" values, while "fp32" turns compression
+     * off (see starpu::transfer_dtype). The owner of a tile keeps the exact
+     * values. All nodes shall call it with the same precision.
+     * */
+    void set_transfer_dtype(const std::string &dtype) const
+    {
+        using starpu::transfer_dtype::Dtype;
+        if(not std::is_same_v<T, fp32_t>)
+        {
+            throw std::runtime_error("Only fp32_t tensors support lossy "
+                    "transfers");
+        }
+        Dtype value;
+        if(dtype == "fp32")
+        {
+            value = Dtype::FP32;
+        }
+        else if(dtype == "fp16")
+        {
+            value = Dtype::FP16;
+        }
+        else if(dtype == "bf16")
+        {
+            value = Dtype::BF16;
+        }
+        else
+        {
+            throw std::runtime_error("Unknown precision of transfers");
+        }
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            const auto &tmp =
+                    static_cast<starpu_data_handle_t>(get_tile_handle(i));
+            starpu::transfer_dtype::set(tmp, value);
         }
     }
     //! Set reduction function for addition
@@ -166,7 +648,8 @@ public:
     {
         for(Index i = 0; i < grid.nelems; ++i)
         {
-            auto tmp = static_cast<starpu_data_handle_t>(get_tile_handle(i));
+            const auto &tmp =
+                    static_cast<starpu_data_handle_t>(get_tile_handle(i));
             starpu_data_set_reduction_methods(tmp,
                     nntile::starpu::accumulate::codelet<T>(),
                     &nntile::starpu::clear::codelet);
@@ -177,7 +660,8 @@ public:
     {
         for(Index i = 0; i < grid.nelems; ++i)
         {
-            auto tmp = static_cast<starpu_data_handle_t>(get_tile_handle(i));
+            const auto &tmp =
+                    static_cast<starpu_data_handle_t>(get_tile_handle(i));
             starpu_data_set_reduction_methods(tmp,
                     nntile::starpu::accumulate_hypot::codelet<T>(),
                     &nntile::starpu::clear::codelet);
@@ -188,7 +672,8 @@ public:
     {
         for(Index i = 0; i < grid.nelems; ++i)
         {
-            auto tmp = static_cast<starpu_data_handle_t>(get_tile_handle(i));
+            const auto &tmp =
+                    static_cast<starpu_data_handle_t>(get_tile_handle(i));
             starpu_data_set_reduction_methods(tmp,
                     nntile::starpu::accumulate_maxsumexp::codelet<T>(),
                     &nntile::starpu::clear::codelet);
@@ -201,7 +686,8 @@ public:
         {
             throw std::runtime_error("Only scalar tensors can be printed");
         }
-        auto handle = static_cast<starpu_data_handle_t>(get_tile_handle(0));
+        const auto &handle =
+                static_cast<starpu_data_handle_t>(get_tile_handle(0));
         void **args = reinterpret_cast<void **>(std::malloc(sizeof(*args)));
         *args = reinterpret_cast<void *>(handle);
         int ret = starpu_data_acquire_cb(handle, STARPU_R,
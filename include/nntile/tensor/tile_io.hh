@@ -0,0 +1,95 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/tile_io.hh
+ * Writing and reading tiles of Tensor<T> to/from files
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-14
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <nntile/starpu/tile_io.hh>
+#include <string>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void write_tiles_async(const Tensor<T> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template<typename T>
+void write_tiles(const Tensor<T> &src, const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template<typename T>
+void read_tiles_async(const Tensor<T> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template<typename T>
+void read_tiles(const Tensor<T> &dst, const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template<typename T>
+void stage_tiles_async(const Tensor<T> &src, const Tensor<T> &dst);
+
+template<typename T>
+void write_tiles_acquire(const Tensor<T> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template<typename T>
+void load_strided_async(const Tensor<T> &dst, const void *src,
+        starpu::tile_io::src_type_t src_type,
+        const std::vector<Index> &src_stride);
+
+//! Flat binary file of tokens of a tokenized dataset mapped into memory
+/*! Tokens of all documents are concatenated into a single array of 16-bit or
+ * 32-bit unsigned integers or 64-bit integers without any header, e.g., as
+ * produced by numpy.ndarray.tofile. The file is mapped into memory, so that
+ * corpora of many gigabytes open instantly and only the pages of sampled
+ * windows are read from disk. The file shall stay open until all the tasks,
+ * that read it, are done.
+ * */
+class TokenFile
+{
+    const void *data;
+    Index nbytes;
+public:
+    //! Type of tokens
+    starpu::tile_io::token_type_t token_type;
+    //! Number of tokens in the file
+    Index ntokens;
+    //! Map a file into memory
+    TokenFile(const std::string &path,
+            starpu::tile_io::token_type_t token_type);
+    TokenFile(const TokenFile &) = delete;
+    TokenFile &operator=(const TokenFile &) = delete;
+    //! Unmap the file
+    ~TokenFile();
+    //! Unmap the file without waiting for destructor
+    void close();
+    //! Pointer to the first token
+    const void *get_data() const
+    {
+        return data;
+    }
+};
+
+void load_tokens_async(const TokenFile &file, unsigned long long seed,
+        Index step, Index shift, const Tensor<Index> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
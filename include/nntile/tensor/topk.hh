@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/topk.hh
+ * Largest values and their indices along an axis of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-11
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void topk_async(const Tensor<T> &src, const Tensor<T> &values,
+        const Tensor<Index> &indices, Index axis, Index size);
+
+template<typename T>
+void topk(const Tensor<T> &src, const Tensor<T> &values,
+        const Tensor<Index> &indices, Index axis, Index size);
+
+} // namespace tensor
+} // namespace nntile
+
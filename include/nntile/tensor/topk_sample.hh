@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/topk_sample.hh
+ * Sampling of tokens among the largest logits of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-11
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void topk_sample_async(const Tensor<T> &values, const Tensor<Index> &indices,
+        const Tensor<Index> &ids, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed);
+
+template<typename T>
+void topk_sample(const Tensor<T> &values, const Tensor<Index> &indices,
+        const Tensor<Index> &ids, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,84 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/tree_reduction.hh
+ * Explicit tree reduction of partial results into a tile of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#pragma once
+
+#include <nntile/starpu/config.hh>
+#include <map>
+#include <vector>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Value of redux argument, that asks for an explicit tree reduction
+/*! Tensor operations, that accumulate many source tiles into a single
+ * destination tile (sum_slice, norm_slice and maxsumexp), accept redux=0
+ * for a sequential chain of tasks, redux=1 for STARPU_REDUX and
+ * redux=redux_tree for TreeReduction.
+ * */
+constexpr int redux_tree = 2;
+
+//! Value of redux argument, that an operation actually uses
+/*! It is the given value, unless the deterministic mode of reductions is
+ * enabled (see starpu::Config::deterministic_enable()). Then STARPU_REDUX
+ * (redux=1) is replaced by redux_tree, if the operation supports tree
+ * reduction for its type, and by a sequential chain of tasks (redux=0)
+ * otherwise.
+ * */
+int redux_mode(int redux, bool tree_supported);
+
+//! Binary tree reduction of partial results into a destination tile
+/*! Every contribution is computed into its own temporary partial result
+ * on the node, that owns the corresponding source tile. Partial results
+ * of each node are combined in a binary tree by the accumulation codelet,
+ * and roots of nodes are combined in a binary tree over nodes. Then the
+ * final result is accumulated into the destination tile. Unlike
+ * STARPU_REDUX, levels of the tree run in parallel on all workers, and
+ * only partial results of the size of the destination tile are sent
+ * between nodes instead of source tiles.
+ * */
+class TreeReduction
+{
+public:
+    //! Codelet, that accumulates the first argument into the second one
+    using accumulate_t = void (*)(starpu::HandleRef, starpu::HandleRef);
+private:
+    //! Destination tile
+    starpu::Handle dst;
+    //! Size of the destination tile in bytes
+    std::size_t size;
+    //! Accumulation codelet
+    accumulate_t accumulate;
+    //! Rank of the current MPI node
+    int mpi_rank;
+    //! Partial results grouped by MPI nodes
+    std::map<int, std::vector<starpu::VariableHandle>> partials;
+public:
+    //! Constructor for a destination tile
+    TreeReduction(starpu::Handle dst_, std::size_t size_,
+            accumulate_t accumulate_);
+    //! Get a new partial result, that shall be computed on a given node
+    /*! Partial result is uninitialized, so the first task, that computes it,
+     * shall overwrite it. Tasks shall be submitted only on the given node.
+     * */
+    starpu::Handle get_partial(int rank);
+    //! Submit tree reduction of all partial results into destination tile
+    void submit();
+};
+
+} // namespace tensor
+} // namespace nntile
+
@@ -50,6 +50,8 @@
 #include <nntile/tile/sum_slice.hh>
 #include <nntile/tile/sum_fiber.hh>
 #include <nntile/tile/norm_slice.hh>
+#include <nntile/tile/layer_norm.hh>
+#include <nntile/tile/layer_norm_backward.hh>
 #include <nntile/tile/pow.hh>
 #include <nntile/tile/maxsumexp.hh>
 #include <nntile/tile/softmax.hh>
@@ -71,6 +73,8 @@
 #include <nntile/tile/add_scalar.hh>
 #include <nntile/tile/fp32_to_fp16.hh>
 #include <nntile/tile/fp16_to_fp32.hh>
+#include <nntile/tile/fp32_to_bf16.hh>
+#include <nntile/tile/bf16_to_fp32.hh>
 #include <nntile/tile/mask_scalar.hh>
 #include <nntile/tile/hypot.hh>
 #include <nntile/tile/adam_step.hh>
@@ -0,0 +1,30 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tile/bf16_to_fp32.hh
+ * Convert bf16_t array into fp32_t array
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-31
+ * */
+
+#pragma once
+
+#include <nntile/tile/tile.hh>
+
+namespace nntile
+{
+namespace tile
+{
+
+void bf16_to_fp32_async(const Tile<bf16_t> &src, const Tile<fp32_t> &dst);
+
+void bf16_to_fp32(const Tile<bf16_t> &src, const Tile<fp32_t> &dst);
+
+} // namespace tile
+} // namespace nntile
+
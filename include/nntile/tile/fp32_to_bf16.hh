@@ -0,0 +1,30 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tile/fp32_to_bf16.hh
+ * Convert fp32_t array into bf16_t array
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-31
+ * */
+
+#pragma once
+
+#include <nntile/tile/tile.hh>
+
+namespace nntile
+{
+namespace tile
+{
+
+void fp32_to_bf16_async(const Tile<fp32_t> &src, const Tile<bf16_t> &dst);
+
+void fp32_to_bf16(const Tile<fp32_t> &src, const Tile<bf16_t> &dst);
+
+} // namespace tile
+} // namespace nntile
+
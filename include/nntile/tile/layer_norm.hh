@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tile/layer_norm.hh
+ * Fused layer normalization of Tile<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-05
+ * */
+
+#pragma once
+
+#include <nntile/tile/tile.hh>
+
+namespace nntile
+{
+namespace tile
+{
+
+template<typename T>
+void layer_norm_async(T eps, const Tile<T> &src, const Tile<T> &gamma,
+        const Tile<T> &beta, const Tile<T> &mean, const Tile<T> &inv_stddev,
+        const Tile<T> &dst, Index axis);
+
+template<typename T>
+void layer_norm(T eps, const Tile<T> &src, const Tile<T> &gamma,
+        const Tile<T> &beta, const Tile<T> &mean, const Tile<T> &inv_stddev,
+        const Tile<T> &dst, Index axis);
+
+} // namespace tile
+} // namespace nntile
+
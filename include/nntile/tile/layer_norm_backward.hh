@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tile/layer_norm_backward.hh
+ * Backward of fused layer normalization of Tile<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-05
+ * */
+
+#pragma once
+
+#include <nntile/tile/tile.hh>
+
+namespace nntile
+{
+namespace tile
+{
+
+template<typename T>
+void layer_norm_backward_async(const Tile<T> &src, const Tile<T> &dst_grad,
+        const Tile<T> &gamma, const Tile<T> &mean, const Tile<T> &inv_stddev,
+        const Tile<T> &src_grad, const Tile<T> &gamma_grad,
+        const Tile<T> &beta_grad, Index axis);
+
+template<typename T>
+void layer_norm_backward(const Tile<T> &src, const Tile<T> &dst_grad,
+        const Tile<T> &gamma, const Tile<T> &mean, const Tile<T> &inv_stddev,
+        const Tile<T> &src_grad, const Tile<T> &gamma_grad,
+        const Tile<T> &beta_grad, Index axis);
+
+} // namespace tile
+} // namespace nntile
+
@@ -153,19 +153,34 @@ public:
      *      assuming Fortran-order storage of tile elements.
      * */
     std::vector<Index> linear_to_index(Index linear_offset) const
+    {
+        std::vector<Index> index;
+        linear_to_index(linear_offset, index);
+        return index;
+    }
+    //! Coordinate of a tile element into a provided buffer
+    /*! The same as the above function, but the buffer is reused if it
+     * already has a proper size, so loops over tiles of a tensor do not
+     * allocate memory for every tile.
+     *
+     * @param[in] linear_offset: Linear memory offset in range [0,nelems)
+     * @param[out] index: Coordinate of the corresponding element
+     * */
+    void linear_to_index(Index linear_offset, std::vector<Index> &index)
+        const
     {
         // Check bounds
         if(linear_offset < 0 or linear_offset >= nelems)
         {
             throw std::runtime_error("Index out of bounds");
         }
+        index.resize(ndim);
         // Scalar case
         if(ndim == 0)
         {
-            return std::vector<Index>();
+            return;
         }
         // Other cases
-        std::vector<Index> index(ndim);
         for(Index i = ndim-1; i >= 1; --i)
         {
             const Index div = linear_offset / stride[i];
@@ -173,7 +188,26 @@ public:
             index[i] = div;
         }
         index[0] = linear_offset;
-        return index;
+    }
+    //! Advance coordinate to the next element in Fortran order
+    /*! Incremental counterpart of linear_to_index(), that updates the
+     * coordinate in place without any division.
+     *
+     * @param[inout] index: Coordinate of an element of the tile
+     * @returns False if the last element was passed, in which case the
+     *      coordinate wraps around to the first element.
+     * */
+    bool next_index(std::vector<Index> &index) const
+    {
+        for(Index i = 0; i < ndim; ++i)
+        {
+            if(++index[i] < shape[i])
+            {
+                return true;
+            }
+            index[i] = 0;
+        }
+        return false;
     }
     //! Check if tile contains given coordinate
     bool contains_index(const std::vector<Index> &index) const
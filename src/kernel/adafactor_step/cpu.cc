@@ -0,0 +1,112 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/adafactor_step/cpu.cc
+ * Fused Adafactor step on buffers on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/adafactor_step/cpu.hh"
+#include "nntile/kernel/simd.hh"
+#include "nntile/kernel/parallel.hh"
+#include <algorithm>
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace adafactor_step
+{
+
+template<typename T>
+void cpu(Index num_iter, Index m, Index k, Index n, T beta_2, T eps, T lr,
+        T weight_decay, const T *row, const T *col, const T *mean,
+        const T *grad, T *p)
+    noexcept
+//! Fused Adafactor step on buffers
+/*! Parameters of shape (m, k, n) are updated with second moments, that are
+ * factored into moving averages of means of squared gradients over rows and
+ * over columns and their common mean:
+ *      v[i,l,j] = row[i] * col[j] / mean[0] / (1-beta_2^num_iter),
+ *      p[i,l,j] = (1-lr*weight_decay)*p[i,l,j]
+ *          - lr*grad[i,l,j] / (sqrt(v[i,l,j])+eps),
+ * i.e., weight decay is decoupled. If col is nullptr, second moments are
+ * not factored and row of m*k*n elements keeps all of them, while mean is
+ * not used. Loops are auto-vectorized for the instruction set of CPU
+ * kernels, and columns are split among threads, allowed by
+ * nntile::kernel::parallel::set_num_threads().
+ *
+ * @param[in] num_iter: Current iteration number, starting from 1
+ * @param[in] m: Size of the first mode of buffers
+ * @param[in] k: Size of the middle mode of buffers
+ * @param[in] n: Size of the last mode of buffers
+ * @param[in] beta_2: Parameter for moving average of second moments
+ * @param[in] eps: Small scalar to avoid division by zero
+ * @param[in] lr: Learning rate
+ * @param[in] weight_decay: Coefficient of decoupled weight decay
+ * @param[in] row: Moving averages of means over all modes but the first
+ * @param[in] col: Moving averages of means over all modes but the last
+ * @param[in] mean: Mean of row
+ * @param[in] grad: Input buffer of gradients
+ * @param[inout] p: Buffer of parameters
+ * */
+{
+    using Y = compute_t<T>;
+    const Y bias = 1 / (1 - std::pow(Y(beta_2), Y(num_iter)));
+    const Y eps_ = eps, lr_ = lr, decay = 1 - lr*weight_decay;
+    // Zero mean means zero gradients, that do not change parameters
+    Y mean_inv = 0;
+    if(col != nullptr and mean[0] != T(0))
+    {
+        mean_inv = 1 / Y(mean[0]);
+    }
+    // Chunks of at least 16K elements are processed by a single thread
+    Index grain = std::max<Index>(1, 16384/std::max<Index>(m, 1));
+    parallel::parallel_for(k*n, grain, [&](Index begin, Index end)
+    {
+        for(Index c = begin; c < end; ++c)
+        {
+            const Y factor = (col == nullptr) ? bias
+                : bias * Y(col[c/k]) * mean_inv;
+            const T *row_ = (col == nullptr) ? row + c*m : row;
+            const T *grad_ = grad + c*m;
+            T *p_ = p + c*m;
+            simd::dispatch([&]() NNTILE_SIMD_LOOP
+            {
+                for(Index i = 0; i < m; ++i)
+                {
+                    Y v = Y(row_[i]) * factor;
+                    p_[i] = decay*Y(p_[i])
+                        - lr_*Y(grad_[i])/(std::sqrt(v)+eps_);
+                }
+            });
+        }
+    });
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index num_iter, Index m, Index k, Index n, fp32_t beta_2,
+        fp32_t eps, fp32_t lr, fp32_t weight_decay, const fp32_t *row,
+        const fp32_t *col, const fp32_t *mean, const fp32_t *grad,
+        fp32_t *p)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index num_iter, Index m, Index k, Index n, fp64_t beta_2,
+        fp64_t eps, fp64_t lr, fp64_t weight_decay, const fp64_t *row,
+        const fp64_t *col, const fp64_t *mean, const fp64_t *grad,
+        fp64_t *p)
+    noexcept;
+
+} // namespace adafactor_step
+} // namespace kernel
+} // namespace nntile
+
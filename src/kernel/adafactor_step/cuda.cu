@@ -0,0 +1,84 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/adafactor_step/cuda.cu
+ * Fused Adafactor step on buffers on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/adafactor_step/cuda.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace adafactor_step
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, Index k, Index n, T bias, T eps, T lr, T decay,
+        const T *row, const T *col, const T *mean, const T *grad, T *p)
+{
+    Index idx = threadIdx.x + static_cast<Index>(blockIdx.x)*blockDim.x;
+    if(idx >= m*k*n)
+    {
+        return;
+    }
+    T v;
+    if(col == nullptr)
+    {
+        v = row[idx] * bias;
+    }
+    else
+    {
+        // Zero mean means zero gradients, that do not change parameters
+        T mean_val = mean[0];
+        T mean_inv = (mean_val != T(0)) ? T(1)/mean_val : T(0);
+        v = row[idx%m] * col[idx/(m*k)] * mean_inv * bias;
+    }
+    p[idx] = decay*p[idx] - lr*grad[idx]/(::sqrt(v)+eps);
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index num_iter, Index m, Index k, Index n,
+        T beta_2, T eps, T lr, T weight_decay, const T *row, const T *col,
+        const T *mean, const T *grad, T *p)
+    noexcept
+//! Fused Adafactor step on buffers
+/*! See nntile::kernel::adafactor_step::cpu for the description of
+ * operations and parameters.
+ * */
+{
+    Index nelems = m * k * n;
+    dim3 blocks((nelems+255)/256), threads(256);
+    T bias = 1 / (1 - ::pow(beta_2, T(num_iter)));
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, k, n, bias, eps, lr,
+            1-lr*weight_decay, row, col, mean, grad, p);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index num_iter, Index m, Index k,
+        Index n, fp32_t beta_2, fp32_t eps, fp32_t lr, fp32_t weight_decay,
+        const fp32_t *row, const fp32_t *col, const fp32_t *mean,
+        const fp32_t *grad, fp32_t *p)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index num_iter, Index m, Index k,
+        Index n, fp64_t beta_2, fp64_t eps, fp64_t lr, fp64_t weight_decay,
+        const fp64_t *row, const fp64_t *col, const fp64_t *mean,
+        const fp64_t *grad, fp64_t *p)
+    noexcept;
+
+} // namespace adafactor_step
+} // namespace kernel
+} // namespace nntile
+
@@ -14,6 +14,8 @@
  * */
 
 #include "nntile/kernel/adam_step/cpu.hh"
+#include "nntile/kernel/simd.hh"
+#include "nntile/kernel/parallel.hh"
 #include <cmath>
 
 namespace nntile
@@ -23,64 +25,177 @@ namespace kernel
 namespace adam_step
 {
 
+//! Scalar factors of a step
 template<typename T>
-void cpu(Index num_iter, Index num_elems, T beta_1, T beta_2, T eps, T lr, T weight_decay,
-         T* grad, T* first_moment, T* second_moment, T* p)
+struct Factors
+{
+    T alpha, beta, beta_1, sqrt_beta_2, sqrt_1_beta_2, eps, lr, weight_decay;
+};
+
+template<typename T>
+static void cpu_scalar(Index num_iter, Index num_elems, const Factors<T> &c,
+        const T *grad, T *first_moment, T *second_moment, T *p)
     noexcept
-//! Fused Adam step on buffers
-/*!
- * 
- * @param[in] num_iter: current iteration number
- * @param[in] num_elems: Number of elements in buffers
- * @param[in] beta_1: parameter for moving average of first moments
- * @param[in] beta_2: parameter for moving average of second moments
- * @param[in] eps: small scalar to avoid division by zero
- * @param[in] lr: learning rate
- * @param[in] weight_decay: coefficient for l2 regularizer
- * @param[in] grad: Input buffer stored gradient, can be updated if weight_decay > 0
- * @param[in] first_moment: Input buffer stored first moments
- * @param[in] second_moment: Input buffer stored square root of second moments for stability
- * @param[inout] p: Input buffers with parameter that are updated in the end
- * */
+//! Fused Adam step on buffers without vectorization
 {
-    T alpha = lr / (1 - ::pow(beta_1, num_iter));
-    T beta = 1.0 / std::sqrt(1 - std::pow(beta_2, num_iter));
-    // Cycle over buffers
+    const T weight_decay = c.weight_decay;
     for(Index i = 0; i < num_elems; ++i)
     {
         // Read values (param+grad) from RAM only once
         T p_val = p[i], grad_val = grad[i];
-        if (weight_decay != 0)
+        if(weight_decay != 0)
         {
             grad_val += weight_decay * p_val;
         }
-        // Read values (first+second moments) from RAM no more than once and
-        // update them in the RAM immediately
+        // Read values (first+second moments) from RAM no more than once
+        // and update them in the RAM immediately
         T f_val, s_val;
         if(num_iter == 1)
         {
-            f_val = (1. - beta_1) * grad_val;
+            f_val = (1. - c.beta_1) * grad_val;
             first_moment[i] = f_val;
-            s_val = std::sqrt(1-beta_2) * std::fabs(grad_val);
+            s_val = c.sqrt_1_beta_2 * std::fabs(grad_val);
             second_moment[i] = s_val;
         }
         else
         {
             f_val = first_moment[i];
             s_val = second_moment[i];
-            f_val = beta_1*f_val + (1-beta_1)*grad_val;
+            f_val = c.beta_1*f_val + (1-c.beta_1)*grad_val;
             first_moment[i] = f_val;
-            s_val = std::hypot(std::sqrt(beta_2)*s_val,
-                    std::sqrt(1-beta_2)*grad_val);
+            s_val = std::hypot(c.sqrt_beta_2*s_val, c.sqrt_1_beta_2*grad_val);
             second_moment[i] = s_val;
         }
         // Update parameters using only data in registers
-        T denom = s_val*beta + eps;
-        //T denom = ::sqrt(s_val * beta) + eps;
-        p[i] = p_val - alpha*f_val/denom;
+        T denom = s_val*c.beta + c.eps;
+        p[i] = p_val - c.alpha*f_val/denom;
     }
 }
 
+#ifdef NNTILE_KERNEL_SIMD_X86
+template<typename T, int W>
+static NNTILE_SIMD_INLINE void cpu_simd(Index num_iter, Index num_elems,
+        const Factors<T> &c, const T *grad, T *first_moment,
+        T *second_moment, T *p)
+    noexcept
+//! Fused Adam step on buffers with vectors of W elements
+{
+    using V = typename simd::Vec<T, W>::type;
+    const T weight_decay = c.weight_decay;
+    Index i = 0;
+    for(; i+W <= num_elems; i += W)
+    {
+        V p_val = simd::load<T, W>(p+i), grad_val = simd::load<T, W>(grad+i);
+        if(weight_decay != 0)
+        {
+            grad_val += weight_decay * p_val;
+        }
+        V f_val, s_val;
+        // Moments are not read at the first iteration, as they are not
+        // initialized yet
+        if(num_iter == 1)
+        {
+            f_val = (1-c.beta_1) * grad_val;
+            s_val = c.sqrt_1_beta_2 * simd::abs<T, W>(grad_val);
+        }
+        else
+        {
+            f_val = c.beta_1*simd::load<T, W>(first_moment+i)
+                + (1-c.beta_1)*grad_val;
+            s_val = simd::hypot<T, W>(
+                    c.sqrt_beta_2*simd::load<T, W>(second_moment+i),
+                    c.sqrt_1_beta_2*grad_val);
+        }
+        simd::store<T, W>(f_val, first_moment+i);
+        simd::store<T, W>(s_val, second_moment+i);
+        V denom = s_val*c.beta + c.eps;
+        simd::store<T, W>(p_val - c.alpha*f_val/denom, p+i);
+    }
+    // Remaining elements
+    cpu_scalar<T>(num_iter, num_elems-i, c, grad+i, first_moment+i,
+            second_moment+i, p+i);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX2 void cpu_avx2(Index num_iter,
+        Index num_elems, const Factors<T> &c, const T *grad, T *first_moment,
+        T *second_moment, T *p)
+    noexcept
+{
+    cpu_simd<T, 32/sizeof(T)>(num_iter, num_elems, c, grad, first_moment,
+            second_moment, p);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX512 void cpu_avx512(Index num_iter,
+        Index num_elems, const Factors<T> &c, const T *grad, T *first_moment,
+        T *second_moment, T *p)
+    noexcept
+{
+    cpu_simd<T, 64/sizeof(T)>(num_iter, num_elems, c, grad, first_moment,
+            second_moment, p);
+}
+#endif // NNTILE_KERNEL_SIMD_X86
+
+template<typename T>
+void cpu(Index num_iter, Index num_elems, T beta_1, T beta_2, T eps, T lr, T weight_decay,
+         T* grad, T* first_moment, T* second_moment, T* p)
+    noexcept
+//! Fused Adam step on buffers
+/*! Vectorized AVX2 or AVX-512 implementation is used if it is supported by
+ * the CPU and allowed by nntile::kernel::simd::set_level(). It differs from
+ * the scalar one by a few ulp due to the vectorized hypotenuse. Buffers are
+ * split among threads, allowed by nntile::kernel::parallel::set_num_threads().
+ *
+ * @param[in] num_iter: current iteration number
+ * @param[in] num_elems: Number of elements in buffers
+ * @param[in] beta_1: parameter for moving average of first moments
+ * @param[in] beta_2: parameter for moving average of second moments
+ * @param[in] eps: small scalar to avoid division by zero
+ * @param[in] lr: learning rate
+ * @param[in] weight_decay: coefficient for l2 regularizer
+ * @param[in] grad: Input buffer stored gradient, can be updated if weight_decay > 0
+ * @param[in] first_moment: Input buffer stored first moments
+ * @param[in] second_moment: Input buffer stored square root of second moments for stability
+ * @param[inout] p: Input buffers with parameter that are updated in the end
+ * */
+{
+    Factors<T> c;
+    c.alpha = lr / (1 - ::pow(beta_1, num_iter));
+    c.beta = 1.0 / std::sqrt(1 - std::pow(beta_2, num_iter));
+    c.beta_1 = beta_1;
+    c.sqrt_beta_2 = std::sqrt(beta_2);
+    c.sqrt_1_beta_2 = std::sqrt(1-beta_2);
+    c.eps = eps;
+    c.lr = lr;
+    c.weight_decay = weight_decay;
+#ifdef NNTILE_KERNEL_SIMD_X86
+    simd::Level level = simd::get_level();
+#endif // NNTILE_KERNEL_SIMD_X86
+    // Chunks of at least 16K elements are processed by a single thread
+    parallel::parallel_for(num_elems, 16384, [&](Index begin, Index end)
+    {
+        Index size = end - begin;
+#ifdef NNTILE_KERNEL_SIMD_X86
+        switch(level)
+        {
+            case simd::Level::AVX512:
+                cpu_avx512<T>(num_iter, size, c, grad+begin,
+                        first_moment+begin, second_moment+begin, p+begin);
+                return;
+            case simd::Level::AVX2:
+                cpu_avx2<T>(num_iter, size, c, grad+begin,
+                        first_moment+begin, second_moment+begin, p+begin);
+                return;
+            default:
+                break;
+        }
+#endif // NNTILE_KERNEL_SIMD_X86
+        cpu_scalar<T>(num_iter, size, c, grad+begin, first_moment+begin,
+                second_moment+begin, p+begin);
+    });
+}
+
 // Explicit instantiation
 template
 void cpu<fp32_t>(Index num_iter, Index num_elems, fp32_t beta_1, fp32_t beta_2, fp32_t eps,
@@ -14,6 +14,7 @@
  * */
 
 #include "nntile/kernel/add/cpu.hh"
+#include "nntile/kernel/simd.hh"
 
 namespace nntile
 {
@@ -28,7 +29,7 @@ void cpu(Index nelems, T alpha, const T* src, T beta, T* dst)
 //! Add of two buffers on CPU
 /*! Performs the following operation:
  *      dst[i] = alpha*src[i] + beta*dst[i],
- * where alpha and beta are non-zero scalars.
+ * where alpha and beta are scalars. If beta is zero, dst is not read.
  *
  * @param[in] nelems: Size of the src and dst tensors
  * @param[in] alpha: Scalar multiplier for the src tensor
@@ -37,10 +38,28 @@ void cpu(Index nelems, T alpha, const T* src, T beta, T* dst)
  * @param[inout] dst: Destination of the add operation
  * */
 {
-    for(Index i = 0; i < nelems; ++i)
+    using Y = compute_t<T>;
+    const Y alpha_ = alpha, beta_ = beta;
+    constexpr Y zero = 0;
+    // Loops are auto-vectorized for the instruction set of CPU kernels
+    simd::dispatch([&]() NNTILE_SIMD_LOOP
     {
-        dst[i] = alpha*src[i] + beta*dst[i];
-    }
+        if(beta_ == zero)
+        {
+            for(Index i = 0; i < nelems; ++i)
+            {
+                dst[i] = alpha_ * static_cast<Y>(src[i]);
+            }
+        }
+        else
+        {
+            for(Index i = 0; i < nelems; ++i)
+            {
+                dst[i] = alpha_*static_cast<Y>(src[i])
+                    + beta_*static_cast<Y>(dst[i]);
+            }
+        }
+    });
 }
 
 // Explicit instantiation
@@ -54,6 +73,16 @@ void cpu<fp64_t>(Index nelems, fp64_t alpha, const fp64_t* src, fp64_t beta,
         fp64_t* dst)
     noexcept;
 
+template
+void cpu<bf16_t>(Index nelems, bf16_t alpha, const bf16_t* src, bf16_t beta,
+        bf16_t* dst)
+    noexcept;
+
+template
+void cpu<fp16_t>(Index nelems, fp16_t alpha, const fp16_t* src, fp16_t beta,
+        fp16_t* dst)
+    noexcept;
+
 } // namespace add
 } // namespace kernel
 } // namespace nntile
@@ -16,6 +16,7 @@
 
 #include "nntile/kernel/add/cuda.hh"
 #include <cuda_fp16.h>
+#include <type_traits>
 
 namespace nntile
 {
@@ -30,7 +31,7 @@ void cuda_kernel(Index nelems, T alpha, const T* src, T beta, T* dst)
 //! Add two buffers on CUDA
 /*! Performs the following operation:
  *      dst[i] = alpha*src[i] + beta*dst[i],
- * where alpha and beta are non-zero scalars.
+ * where alpha and beta are scalars. If beta is zero, dst is not read.
  *
  * @param[in] nelems: Size of the src and dst tensors
  * @param[in] alpha: Scalar multiplier for the src tensor
@@ -39,10 +40,50 @@ void cuda_kernel(Index nelems, T alpha, const T* src, T beta, T* dst)
  * @param[inout] dst: Destination of the add operation
  * */
 {
+    using Y = compute_t<T>;
     int i = threadIdx.x + blockIdx.x*blockDim.x;
+    const Y alpha_ = alpha, beta_ = beta;
+    constexpr Y zero = 0;
     if(i < nelems)
     {
-        dst[i] = alpha*src[i] + beta*dst[i];
+        if(beta_ == zero)
+        {
+            dst[i] = alpha_ * static_cast<Y>(src[i]);
+        }
+        else
+        {
+            dst[i] = alpha_*static_cast<Y>(src[i])
+                + beta_*static_cast<Y>(dst[i]);
+        }
+    }
+}
+
+static __global__
+void cuda_kernel_half2(Index npairs, fp32_t alpha, const __half2 *src,
+        fp32_t beta, __half2 *dst)
+//! Add two fp16 buffers on CUDA, two values per thread
+/*! Values are loaded and stored as __half2 pairs and are computed in fp32.
+ *
+ * @param[in] npairs: Number of pairs of values in the src and dst tensors
+ * @param[in] alpha: Scalar multiplier for the src tensor
+ * @param[in] src: Source tensor
+ * @param[in] beta: Scalar multiplier for the dst tensor
+ * @param[inout] dst: Destination of the add operation
+ * */
+{
+    int i = threadIdx.x + blockIdx.x*blockDim.x;
+    if(i < npairs)
+    {
+        float2 val = __half22float2(src[i]);
+        val.x *= alpha;
+        val.y *= alpha;
+        if(beta != 0)
+        {
+            float2 old = __half22float2(dst[i]);
+            val.x += beta * old.x;
+            val.y += beta * old.y;
+        }
+        dst[i] = __floats2half2_rn(val.x, val.y);
     }
 }
 
@@ -53,7 +94,7 @@ void cuda(cudaStream_t stream, Index nelems, T alpha, const T *src, T beta,
 //! Add two buffers on CUDA
 /*! Performs the following operation:
  *      dst[i] = alpha*src[i] + beta*dst[i],
- * where alpha and beta are non-zero scalars.
+ * where alpha and beta are scalars. If beta is zero, dst is not read.
  *
  * @param[in] nelems: Size of the src and dst tensors
  * @param[in] alpha: Scalar multiplier for the src tensor
@@ -62,9 +103,31 @@ void cuda(cudaStream_t stream, Index nelems, T alpha, const T *src, T beta,
  * @param[inout] dst: Destination of the add operation
  * */
 {
-    dim3 blocks((nelems+255)/256), threads(256);
-    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(nelems, alpha, src, beta,
-            dst);
+    dim3 threads(256);
+    // Buffers of StarPU are aligned, so fp16 values are processed by pairs
+    if constexpr(std::is_same_v<T, fp16_t>)
+    {
+        Index npairs = nelems / 2;
+        if(npairs > 0)
+        {
+            dim3 blocks((npairs+255)/256);
+            (cuda_kernel_half2)<<<blocks, threads, 0, stream>>>(npairs,
+                    alpha, reinterpret_cast<const __half2 *>(src), beta,
+                    reinterpret_cast<__half2 *>(dst));
+        }
+        // The last value of an odd number of values
+        if(nelems % 2 == 1)
+        {
+            (cuda_kernel<T>)<<<1, 1, 0, stream>>>(1, alpha, src+nelems-1,
+                    beta, dst+nelems-1);
+        }
+    }
+    else
+    {
+        dim3 blocks((nelems+255)/256);
+        (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(nelems, alpha, src,
+                beta, dst);
+    }
 }
 
 // Explicit instantiation
@@ -78,22 +141,15 @@ void cuda<fp64_t>(cudaStream_t stream, Index nelems, fp64_t alpha,
         const fp64_t *src, fp64_t beta, fp64_t *dst)
     noexcept;
 
-// Explicit instantiation of cuda function for fp16 type
-void cuda16(cudaStream_t stream, Index nelems, fp32_t alpha, const fp16_t *src, fp32_t beta,
-        fp16_t *dst)
-    noexcept
-//! Add two buffers on CUDA in half precission, see in destiction in original template
-{
-
-    dim3 blocks((nelems+255)/256), threads(256);
-    __half alpha_half = __float2half(alpha);
-    __half beta_half = __float2half(beta); 
-    const __half *src_half = reinterpret_cast<const __half *>(src);
-    __half *dst_half = reinterpret_cast<__half *>(dst);
-    (cuda_kernel<__half>)<<<blocks, threads, 0, stream>>>(nelems, alpha_half, src_half, beta_half,
-            dst_half);
-}
+template
+void cuda<bf16_t>(cudaStream_t stream, Index nelems, bf16_t alpha,
+        const bf16_t *src, bf16_t beta, bf16_t *dst)
+    noexcept;
 
+template
+void cuda<fp16_t>(cudaStream_t stream, Index nelems, fp16_t alpha,
+        const fp16_t *src, fp16_t beta, fp16_t *dst)
+    noexcept;
 
 } // namespace add
 } // namespace kernel
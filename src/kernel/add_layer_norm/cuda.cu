@@ -0,0 +1,181 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/add_layer_norm/cuda.cu
+ * Fused residual addition and layer normalization on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/add_layer_norm/cuda.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace add_layer_norm
+{
+
+// Number of threads in a CUDA block
+static constexpr int BLOCK = 256;
+
+// Smaller first modes are processed by a block per normalized fiber, while
+// larger ones are processed by a thread per fiber with coalesced reads
+static constexpr Index M_THREAD = 32;
+
+template<typename T>
+static __global__
+void cuda_kernel_block(Index m, Index n, Index k, T eps, const T *src1,
+        const T *src2, const T *gamma, const T *beta, T *sum, T *mean,
+        T *inv_stddev, T *dst)
+//! Addition and layer normalization, where a block processes a fiber
+/*! Every thread adds and applies Welford updates to a strided part of the
+ * fiber and partial results are merged by the Chan et al. formula in shared
+ * memory. Normalization reads the sum back from the same thread, that wrote
+ * it, so no extra synchronization is needed.
+ * */
+{
+    __shared__ T count_shared[BLOCK], mean_shared[BLOCK], ssq_shared[BLOCK];
+    const int tid = threadIdx.x;
+    for(Index c = blockIdx.x; c < m*n; c += gridDim.x)
+    {
+        const Index i0 = c % m, i2 = c / m;
+        const Index offset = i2*m*k + i0;
+        // Welford updates by a single thread
+        T count = 0, avg = 0, ssq = 0;
+        for(Index i1 = tid; i1 < k; i1 += BLOCK)
+        {
+            const T val = src1[offset+i1*m] + src2[offset+i1*m];
+            sum[offset+i1*m] = val;
+            count += T(1);
+            const T delta = val - avg;
+            avg += delta / count;
+            ssq += delta * (val-avg);
+        }
+        count_shared[tid] = count;
+        mean_shared[tid] = avg;
+        ssq_shared[tid] = ssq;
+        __syncthreads();
+        // Merge partial results
+        for(int s = BLOCK/2; s > 0; s /= 2)
+        {
+            if(tid < s)
+            {
+                const T count_b = count_shared[tid+s];
+                if(count_b > T(0))
+                {
+                    const T count_a = count_shared[tid];
+                    const T count_ab = count_a + count_b;
+                    const T delta = mean_shared[tid+s] - mean_shared[tid];
+                    mean_shared[tid] += delta * count_b / count_ab;
+                    ssq_shared[tid] += ssq_shared[tid+s]
+                        + delta*delta*count_a*count_b/count_ab;
+                    count_shared[tid] = count_ab;
+                }
+            }
+            __syncthreads();
+        }
+        const T avg_total = mean_shared[0];
+        const T inv = T(1) / ::sqrt(ssq_shared[0]/T(k)+eps);
+        if(tid == 0)
+        {
+            mean[c] = avg_total;
+            inv_stddev[c] = inv;
+        }
+        // Normalize, scale and shift
+        for(Index i1 = tid; i1 < k; i1 += BLOCK)
+        {
+            dst[offset+i1*m] = (sum[offset+i1*m]-avg_total)*inv*gamma[i1]
+                + beta[i1];
+        }
+        // Shared memory is reused by the next fiber
+        __syncthreads();
+    }
+}
+
+template<typename T>
+static __global__
+void cuda_kernel_thread(Index m, Index n, Index k, T eps, const T *src1,
+        const T *src2, const T *gamma, const T *beta, T *sum, T *mean,
+        T *inv_stddev, T *dst)
+//! Addition and layer normalization, where a thread processes a fiber
+{
+    const Index stride = Index(blockDim.x) * gridDim.x;
+    for(Index c = threadIdx.x + Index(blockIdx.x)*blockDim.x; c < m*n;
+            c += stride)
+    {
+        const Index i0 = c % m, i2 = c / m;
+        const Index offset = i2*m*k + i0;
+        T avg = 0, ssq = 0;
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const T val = src1[offset+i1*m] + src2[offset+i1*m];
+            sum[offset+i1*m] = val;
+            const T delta = val - avg;
+            avg += delta / T(i1+1);
+            ssq += delta * (val-avg);
+        }
+        const T inv = T(1) / ::sqrt(ssq/T(k)+eps);
+        mean[c] = avg;
+        inv_stddev[c] = inv;
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            dst[offset+i1*m] = (sum[offset+i1*m]-avg)*inv*gamma[i1]
+                + beta[i1];
+        }
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, T eps,
+        const T *src1, const T *src2, const T *gamma, const T *beta, T *sum,
+        T *mean, T *inv_stddev, T *dst)
+    noexcept
+//! Fused residual addition and layer normalization on CUDA
+/*! Parameters are the same as of nntile::kernel::add_layer_norm::cpu().
+ * */
+{
+    if(m == 0 or n == 0 or k == 0)
+    {
+        return;
+    }
+    dim3 threads(BLOCK);
+    if(m < M_THREAD)
+    {
+        dim3 blocks(std::min(m*n, Index(65535)));
+        (cuda_kernel_block<T>)<<<blocks, threads, 0, stream>>>(m, n, k, eps,
+                src1, src2, gamma, beta, sum, mean, inv_stddev, dst);
+    }
+    else
+    {
+        dim3 blocks(std::min((m*n+BLOCK-1)/BLOCK, Index(65535)));
+        (cuda_kernel_thread<T>)<<<blocks, threads, 0, stream>>>(m, n, k,
+                eps, src1, src2, gamma, beta, sum, mean, inv_stddev, dst);
+    }
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k, fp32_t eps,
+        const fp32_t *src1, const fp32_t *src2, const fp32_t *gamma,
+        const fp32_t *beta, fp32_t *sum, fp32_t *mean, fp32_t *inv_stddev,
+        fp32_t *dst)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k, fp64_t eps,
+        const fp64_t *src1, const fp64_t *src2, const fp64_t *gamma,
+        const fp64_t *beta, fp64_t *sum, fp64_t *mean, fp64_t *inv_stddev,
+        fp64_t *dst)
+    noexcept;
+
+} // namespace add_layer_norm
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,147 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/add_layer_norm_backward/cpu.cc
+ * Backward of fused residual addition and layer normalization on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/add_layer_norm_backward/cpu.hh"
+#include <vector>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace add_layer_norm_backward
+{
+
+template<typename T>
+void cpu(Index m, Index n, Index k, const T *sum, const T *dst_grad,
+        const T *gamma, const T *mean, const T *inv_stddev,
+        const T *sum_grad, T *src1_grad, T *src2_grad, T *gamma_grad,
+        T *beta_grad)
+    noexcept
+//! Backward of fused residual addition and layer normalization on CPU
+/*! Normalized sum xhat = (sum-mean)*inv_stddev is recomputed from sum, mean
+ * and inv_stddev, that are produced by nntile::kernel::add_layer_norm::cpu().
+ * Total gradient of the sum is the gradient of the residual connection
+ * sum_grad plus the gradient through the normalization, and it is
+ * accumulated into gradients of both inputs at once:
+ *      g[i,l,j] = dst_grad[i,l,j] * gamma[l]
+ *      total[i,l,j] = sum_grad[i,l,j] + inv_stddev[i,j] * (g[i,l,j]
+ *          - sum_t g[i,t,j]/k - xhat[i,l,j]*sum_t g[i,t,j]*xhat[i,t,j]/k)
+ *      src1_grad[i,l,j] += total[i,l,j]
+ *      src2_grad[i,l,j] += total[i,l,j]
+ *      gamma_grad[l] += sum_{i,j} dst_grad[i,l,j]*xhat[i,l,j]
+ *      beta_grad[l] += sum_{i,j} dst_grad[i,l,j]
+ *
+ * @param[in] m: Size of the first mode of sum, mean and inv_stddev
+ * @param[in] n: Size of the last mode of sum, mean and inv_stddev
+ * @param[in] k: Size of the middle mode of sum, that is normalized
+ * @param[in] sum: Sum of inputs of forward pass as a contiguous m-by-k-by-n
+ *      array
+ * @param[in] dst_grad: Gradient of output as a contiguous m-by-k-by-n array
+ * @param[in] gamma: Scaling factors of size k
+ * @param[in] mean: Contiguous m-by-n array of means
+ * @param[in] inv_stddev: Contiguous m-by-n array of inverses of standard
+ *      deviations
+ * @param[in] sum_grad: Gradient of the sum, that flows through the residual
+ *      connection, as a contiguous m-by-k-by-n array
+ * @param[inout] src1_grad: Gradient of the first input as a contiguous
+ *      m-by-k-by-n array
+ * @param[inout] src2_grad: Gradient of the second input as a contiguous
+ *      m-by-k-by-n array
+ * @param[inout] gamma_grad: Gradient of gamma of size k
+ * @param[inout] beta_grad: Gradient of beta of size k
+ * */
+{
+    constexpr T zero = 0.0;
+    const T inv_k = T(1.0) / T(k);
+    // Sums of g and g*xhat along the middle axis for a single slice
+    std::vector<T> sum_g(m), sum_gx(m);
+    // Cycle over the last mode
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        const Index offset = i2 * m * k;
+        const T *mean_slice = mean + i2*m;
+        const T *inv_stddev_slice = inv_stddev + i2*m;
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            sum_g[i0] = zero;
+            sum_gx[i0] = zero;
+        }
+        // Accumulate sums and gradients of gamma and beta
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const T *sum_fiber = sum + offset + i1*m;
+            const T *dst_grad_fiber = dst_grad + offset + i1*m;
+            const T gamma_val = gamma[i1];
+            T gamma_grad_val = zero, beta_grad_val = zero;
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                const T xhat = (sum_fiber[i0]-mean_slice[i0])
+                    * inv_stddev_slice[i0];
+                const T dy = dst_grad_fiber[i0];
+                const T g = dy * gamma_val;
+                sum_g[i0] += g;
+                sum_gx[i0] += g * xhat;
+                gamma_grad_val += dy * xhat;
+                beta_grad_val += dy;
+            }
+            gamma_grad[i1] += gamma_grad_val;
+            beta_grad[i1] += beta_grad_val;
+        }
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            sum_g[i0] *= inv_k;
+            sum_gx[i0] *= inv_k;
+        }
+        // Accumulate gradients of both inputs
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const T *sum_fiber = sum + offset + i1*m;
+            const T *dst_grad_fiber = dst_grad + offset + i1*m;
+            const T *sum_grad_fiber = sum_grad + offset + i1*m;
+            T *src1_grad_fiber = src1_grad + offset + i1*m;
+            T *src2_grad_fiber = src2_grad + offset + i1*m;
+            const T gamma_val = gamma[i1];
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                const T xhat = (sum_fiber[i0]-mean_slice[i0])
+                    * inv_stddev_slice[i0];
+                const T g = dst_grad_fiber[i0] * gamma_val;
+                const T total = sum_grad_fiber[i0] + inv_stddev_slice[i0]
+                    * (g-sum_g[i0]-xhat*sum_gx[i0]);
+                src1_grad_fiber[i0] += total;
+                src2_grad_fiber[i0] += total;
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, const fp32_t *sum,
+        const fp32_t *dst_grad, const fp32_t *gamma, const fp32_t *mean,
+        const fp32_t *inv_stddev, const fp32_t *sum_grad, fp32_t *src1_grad,
+        fp32_t *src2_grad, fp32_t *gamma_grad, fp32_t *beta_grad)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, const fp64_t *sum,
+        const fp64_t *dst_grad, const fp64_t *gamma, const fp64_t *mean,
+        const fp64_t *inv_stddev, const fp64_t *sum_grad, fp64_t *src1_grad,
+        fp64_t *src2_grad, fp64_t *gamma_grad, fp64_t *beta_grad)
+    noexcept;
+
+} // namespace add_layer_norm_backward
+} // namespace kernel
+} // namespace nntile
+
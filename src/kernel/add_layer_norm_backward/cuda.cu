@@ -0,0 +1,206 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/add_layer_norm_backward/cuda.cu
+ * Backward of fused residual addition and layer normalization on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/add_layer_norm_backward/cuda.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace add_layer_norm_backward
+{
+
+// Number of threads in a CUDA block
+static constexpr int BLOCK = 256;
+
+// Smaller first modes are processed by a block per normalized fiber, while
+// larger ones are processed by a thread per fiber with coalesced reads
+static constexpr Index M_THREAD = 32;
+
+// Maximal number of parts of the last mode for gradients of gamma and beta
+static constexpr Index N_SPLIT = 32;
+
+template<typename T>
+static __global__
+void cuda_kernel_block(Index m, Index n, Index k, const T *sum,
+        const T *dst_grad, const T *gamma, const T *mean,
+        const T *inv_stddev, const T *sum_grad, T *src1_grad, T *src2_grad)
+//! Gradients of inputs, where a block of threads processes a fiber
+{
+    __shared__ T sum_g_shared[BLOCK], sum_gx_shared[BLOCK];
+    const int tid = threadIdx.x;
+    const T inv_k = T(1) / T(k);
+    for(Index c = blockIdx.x; c < m*n; c += gridDim.x)
+    {
+        const Index i0 = c % m, i2 = c / m;
+        const Index offset = i2*m*k + i0;
+        const T avg = mean[c], inv = inv_stddev[c];
+        T sum_g = 0, sum_gx = 0;
+        for(Index i1 = tid; i1 < k; i1 += BLOCK)
+        {
+            const T xhat = (sum[offset+i1*m]-avg) * inv;
+            const T g = dst_grad[offset+i1*m] * gamma[i1];
+            sum_g += g;
+            sum_gx += g * xhat;
+        }
+        sum_g_shared[tid] = sum_g;
+        sum_gx_shared[tid] = sum_gx;
+        __syncthreads();
+        for(int s = BLOCK/2; s > 0; s /= 2)
+        {
+            if(tid < s)
+            {
+                sum_g_shared[tid] += sum_g_shared[tid+s];
+                sum_gx_shared[tid] += sum_gx_shared[tid+s];
+            }
+            __syncthreads();
+        }
+        const T mean_g = sum_g_shared[0] * inv_k;
+        const T mean_gx = sum_gx_shared[0] * inv_k;
+        for(Index i1 = tid; i1 < k; i1 += BLOCK)
+        {
+            const Index e = offset + i1*m;
+            const T xhat = (sum[e]-avg) * inv;
+            const T g = dst_grad[e] * gamma[i1];
+            const T total = sum_grad[e] + inv*(g-mean_g-xhat*mean_gx);
+            src1_grad[e] += total;
+            src2_grad[e] += total;
+        }
+        // Shared memory is reused by the next fiber
+        __syncthreads();
+    }
+}
+
+template<typename T>
+static __global__
+void cuda_kernel_thread(Index m, Index n, Index k, const T *sum,
+        const T *dst_grad, const T *gamma, const T *mean,
+        const T *inv_stddev, const T *sum_grad, T *src1_grad, T *src2_grad)
+//! Gradients of inputs, where a thread processes a fiber
+{
+    const Index stride = Index(blockDim.x) * gridDim.x;
+    const T inv_k = T(1) / T(k);
+    for(Index c = threadIdx.x + Index(blockIdx.x)*blockDim.x; c < m*n;
+            c += stride)
+    {
+        const Index i0 = c % m, i2 = c / m;
+        const Index offset = i2*m*k + i0;
+        const T avg = mean[c], inv = inv_stddev[c];
+        T sum_g = 0, sum_gx = 0;
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const T xhat = (sum[offset+i1*m]-avg) * inv;
+            const T g = dst_grad[offset+i1*m] * gamma[i1];
+            sum_g += g;
+            sum_gx += g * xhat;
+        }
+        const T mean_g = sum_g * inv_k, mean_gx = sum_gx * inv_k;
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const Index e = offset + i1*m;
+            const T xhat = (sum[e]-avg) * inv;
+            const T g = dst_grad[e] * gamma[i1];
+            const T total = sum_grad[e] + inv*(g-mean_g-xhat*mean_gx);
+            src1_grad[e] += total;
+            src2_grad[e] += total;
+        }
+    }
+}
+
+template<typename T>
+static __global__
+void cuda_kernel_gamma_beta(Index m, Index n, Index k, const T *sum,
+        const T *dst_grad, const T *mean, const T *inv_stddev,
+        T *gamma_grad, T *beta_grad)
+//! Gradients of gamma and beta
+/*! A thread accumulates a part of the last mode for a single element of the
+ * first two modes, so that reads are coalesced, and adds the result
+ * atomically.
+ * */
+{
+    const Index e = threadIdx.x + Index(blockIdx.x)*blockDim.x;
+    if(e >= m*k)
+    {
+        return;
+    }
+    const Index i0 = e % m, i1 = e / m;
+    T gamma_grad_val = 0, beta_grad_val = 0;
+    for(Index i2 = blockIdx.y; i2 < n; i2 += gridDim.y)
+    {
+        const Index c = i2*m + i0;
+        const T dy = dst_grad[i2*m*k+e];
+        gamma_grad_val += dy * (sum[i2*m*k+e]-mean[c]) * inv_stddev[c];
+        beta_grad_val += dy;
+    }
+    atomicAdd(&gamma_grad[i1], gamma_grad_val);
+    atomicAdd(&beta_grad[i1], beta_grad_val);
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, const T *sum,
+        const T *dst_grad, const T *gamma, const T *mean,
+        const T *inv_stddev, const T *sum_grad, T *src1_grad, T *src2_grad,
+        T *gamma_grad, T *beta_grad)
+    noexcept
+//! Backward of fused residual addition and layer normalization on CUDA
+/*! Parameters are the same as of
+ * nntile::kernel::add_layer_norm_backward::cpu().
+ * */
+{
+    if(m == 0 or n == 0 or k == 0)
+    {
+        return;
+    }
+    dim3 threads(BLOCK);
+    if(m < M_THREAD)
+    {
+        dim3 blocks(std::min(m*n, Index(65535)));
+        (cuda_kernel_block<T>)<<<blocks, threads, 0, stream>>>(m, n, k, sum,
+                dst_grad, gamma, mean, inv_stddev, sum_grad, src1_grad,
+                src2_grad);
+    }
+    else
+    {
+        dim3 blocks(std::min((m*n+BLOCK-1)/BLOCK, Index(65535)));
+        (cuda_kernel_thread<T>)<<<blocks, threads, 0, stream>>>(m, n, k, sum,
+                dst_grad, gamma, mean, inv_stddev, sum_grad, src1_grad,
+                src2_grad);
+    }
+    dim3 blocks_gamma((m*k+BLOCK-1)/BLOCK, std::min(n, N_SPLIT));
+    (cuda_kernel_gamma_beta<T>)<<<blocks_gamma, threads, 0, stream>>>(m, n,
+            k, sum, dst_grad, mean, inv_stddev, gamma_grad, beta_grad);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k,
+        const fp32_t *sum, const fp32_t *dst_grad, const fp32_t *gamma,
+        const fp32_t *mean, const fp32_t *inv_stddev, const fp32_t *sum_grad,
+        fp32_t *src1_grad, fp32_t *src2_grad, fp32_t *gamma_grad,
+        fp32_t *beta_grad)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k,
+        const fp64_t *sum, const fp64_t *dst_grad, const fp64_t *gamma,
+        const fp64_t *mean, const fp64_t *inv_stddev, const fp64_t *sum_grad,
+        fp64_t *src1_grad, fp64_t *src2_grad, fp64_t *gamma_grad,
+        fp64_t *beta_grad)
+    noexcept;
+
+} // namespace add_layer_norm_backward
+} // namespace kernel
+} // namespace nntile
+
@@ -14,6 +14,7 @@
  * */
 
 #include "nntile/kernel/add/cpu.hh"
+#include "nntile/kernel/simd.hh"
 
 namespace nntile
 {
@@ -34,10 +35,14 @@ void cpu(Index num_elements, T alpha, T beta, T* dst)
  * @param[inout] dst: Destination of the add_scalar operation
  * */
 {
-    for (Index i = 0; i < num_elements; ++i)
+    // Loops are auto-vectorized for the instruction set of CPU kernels
+    simd::dispatch([&]() NNTILE_SIMD_LOOP
     {
-        dst[i] = alpha + beta * dst[i];
-    }
+        for (Index i = 0; i < num_elements; ++i)
+        {
+            dst[i] = alpha + beta * dst[i];
+        }
+    });
 }
 
 // Explicit instantiation
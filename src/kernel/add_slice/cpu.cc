@@ -21,59 +21,86 @@ namespace kernel
 namespace add_slice
 {
 
-template<typename T>
-void cpu(Index m, Index n, Index k, T alpha, const T *src, T beta, T *dst)
-    noexcept
-//! Per-element addition of a tensor and a broadcasted slice on CPU
-/*! Performs the following operations:
- *      dst[i,l,j] = beta*dst[i,l,j] + alpha*src[i,j]
- *
- * @param[in] m: Size of the first mode of src and dst tensors
- * @param[in] n: Size of the last mode of src and dst tensors
- * @param[in] k: Size of the middle mode of dst tensor
- * @param[in] alpha: Scalar factor for src
- * @param[in] src: Input contiguous m-by-n array
- * @param[in] beta: Scaling factor for dst
- * @param[inout] dst: Input and output contiguous m-by-k-by-n array
+//! Addition of a broadcasted slice with a compile-time first mode
+/*! If M is non-zero, it is the size of the first mode, which makes the
+ * innermost loop over the contiguous first mode fully known to the
+ * compiler, so it is unrolled and vectorized. Zero M means a runtime size.
  * */
+template<Index M, typename T>
+static void cpu_m(Index m_, Index n, Index k, T alpha, const T *src, T beta,
+        T *dst)
+    noexcept
 {
+    const Index m = (M > 0) ? M : m_;
     const Index mk = m * k;
     constexpr T zero = 0.0;
     // Cycle over column of the output buffer dst
     for(Index i2 = 0; i2 < n; ++i2)
     {
-        // Cycle over row of the output buffer dst
-        for(Index i1 = 0; i1 < m; ++i1)
+        // Slice to add and the corresponding part of the output
+        const T *src_slice = src + i2*m;
+        T *dst_slice = dst + i2*mk;
+        // Cycle over output fibers along the middle mode
+        for(Index i0 = 0; i0 < k; ++i0)
         {
-            // Pointer to a corresponding fiber of the output array dst
-            T *dst_fiber = dst + i2*mk + i1;
-            // Value to add to the output fiber
-            const T src_val = alpha * src[i2*m+i1];
+            T *dst_fiber = dst_slice + i0*m;
             // Overwrite or update output depending on beta
             if(beta == zero)
             {
-                // Cycle over output fiber elements
-                for(Index i0 = 0; i0 < k; ++i0)
+                for(Index i1 = 0; i1 < m; ++i1)
                 {
-                    // Set output value
-                    dst_fiber[i0*m] = src_val;
+                    dst_fiber[i1] = alpha * src_slice[i1];
                 }
             }
             else
             {
-                // Cycle over output fiber elements
-                for(Index i0 = 0; i0 < k; ++i0)
+                for(Index i1 = 0; i1 < m; ++i1)
                 {
-                    // Read value from the output
-                    T &dst_val = dst_fiber[i0*m];
-                    // And update it
-                    dst_val = beta*dst_val + src_val;
+                    dst_fiber[i1] = beta*dst_fiber[i1] + alpha*src_slice[i1];
                 }
             }
         }
     }
 }
 
+template<typename T>
+void cpu(Index m, Index n, Index k, T alpha, const T *src, T beta, T *dst)
+    noexcept
+//! Per-element addition of a tensor and a broadcasted slice on CPU
+/*! Performs the following operations:
+ *      dst[i,l,j] = beta*dst[i,l,j] + alpha*src[i,j]
+ *
+ * Common sizes of the first mode, e.g., head size of attention, are
+ * dispatched to specialized loops.
+ *
+ * @param[in] m: Size of the first mode of src and dst tensors
+ * @param[in] n: Size of the last mode of src and dst tensors
+ * @param[in] k: Size of the middle mode of dst tensor
+ * @param[in] alpha: Scalar factor for src
+ * @param[in] src: Input contiguous m-by-n array
+ * @param[in] beta: Scaling factor for dst
+ * @param[inout] dst: Input and output contiguous m-by-k-by-n array
+ * */
+{
+    switch(m)
+    {
+        case 16:
+            cpu_m<16, T>(m, n, k, alpha, src, beta, dst);
+            break;
+        case 32:
+            cpu_m<32, T>(m, n, k, alpha, src, beta, dst);
+            break;
+        case 64:
+            cpu_m<64, T>(m, n, k, alpha, src, beta, dst);
+            break;
+        case 128:
+            cpu_m<128, T>(m, n, k, alpha, src, beta, dst);
+            break;
+        default:
+            cpu_m<0, T>(m, n, k, alpha, src, beta, dst);
+    }
+}
+
 // Explicit instantiation
 template
 void cpu<fp32_t>(Index m, Index n, Index k, fp32_t alpha, const fp32_t *src,
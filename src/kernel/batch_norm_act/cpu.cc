@@ -0,0 +1,113 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/batch_norm_act/cpu.cc
+ * Batch normalization followed by an activation on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/batch_norm_act/cpu.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace batch_norm_act
+{
+
+// Normalize fibers and apply the activation to every element
+template<typename T, typename F>
+static void apply(Index m, Index n, Index k, const T *src, const T *mean,
+        const T *inv_stddev, const T *gamma, const T *beta, T *dst, F func)
+{
+    // Cycle over the last mode
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        // Cycle over features, normalization is an affine transformation
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const T scale = inv_stddev[i1] * gamma[i1];
+            const T shift = beta[i1] - mean[i1]*scale;
+            const T *src_fiber = src + (i2*k+i1)*m;
+            T *dst_fiber = dst + (i2*k+i1)*m;
+            // Cycle over the first mode
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                dst_fiber[i0] = func(src_fiber[i0]*scale + shift);
+            }
+        }
+    }
+}
+
+template<typename T>
+void cpu(Index m, Index n, Index k, activation_t act, const T *src,
+        const T *mean, const T *inv_stddev, const T *gamma, const T *beta,
+        T *dst)
+    noexcept
+//! Batch normalization followed by an activation on CPU
+/*! Normalizes input with the provided statistics of features, applies an
+ * elementwise affine transformation and the activation in a single pass:
+ *      y[i,l,j] = (src[i,l,j]-mean[l]) * inv_stddev[l] * gamma[l] + beta[l]
+ *      dst[i,l,j] = act(y[i,l,j])
+ * Values before the activation are not stored, as the backward pass
+ * recomputes them from the input and the statistics.
+ *
+ * @param[in] m: Size of the first mode of src and dst arrays
+ * @param[in] n: Size of the last mode of src and dst arrays
+ * @param[in] k: Size of the middle mode of src and dst arrays, that is the
+ *      number of features
+ * @param[in] act: Activation, applied after normalization
+ * @param[in] src: Input contiguous m-by-k-by-n array
+ * @param[in] mean: Mean values of features of size k
+ * @param[in] inv_stddev: Inverse standard deviations of features of size k
+ * @param[in] gamma: Scaling factors of features of size k
+ * @param[in] beta: Biases of features of size k
+ * @param[out] dst: Output contiguous m-by-k-by-n array
+ * */
+{
+    // Constants
+    constexpr T pi = 3.141592653589793238462643383279502884L,
+        zero = 0, one = 1, f1 = T{0.044715};
+    // Square root is not constexpr by standard, proceed with a static const
+    static const T sqrt_pi = std::sqrt(pi), sqrt_2 = std::sqrt(T{2}),
+        f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1;
+    switch(act)
+    {
+        case activation_t::RELU:
+            apply(m, n, k, src, mean, inv_stddev, gamma, beta, dst,
+                    [](T y){ return std::fmax(y, zero); });
+            break;
+        case activation_t::GELUTANH:
+            apply(m, n, k, src, mean, inv_stddev, gamma, beta, dst,
+                    [](T y){ return y / (one+std::exp(y*(f3+f4*y*y))); });
+            break;
+        default:
+            apply(m, n, k, src, mean, inv_stddev, gamma, beta, dst,
+                    [](T y){ return y; });
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, activation_t act,
+        const fp32_t *src, const fp32_t *mean, const fp32_t *inv_stddev,
+        const fp32_t *gamma, const fp32_t *beta, fp32_t *dst)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, activation_t act,
+        const fp64_t *src, const fp64_t *mean, const fp64_t *inv_stddev,
+        const fp64_t *gamma, const fp64_t *beta, fp64_t *dst)
+    noexcept;
+
+} // namespace batch_norm_act
+} // namespace kernel
+} // namespace nntile
+
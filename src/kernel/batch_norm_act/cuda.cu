@@ -0,0 +1,94 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/batch_norm_act/cuda.cu
+ * Batch normalization followed by an activation on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/batch_norm_act/cuda.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace batch_norm_act
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, Index n, Index k, activation_t act, const T *src,
+        const T *mean, const T *inv_stddev, const T *gamma, const T *beta,
+        T *dst)
+{
+    // Constants
+    constexpr T pi = 3.141592653589793238462643383279502884L,
+        zero = 0, one = 1, f1 = T{0.044715};
+    // Square root is not constexpr by standard, proceed with a const
+    const T sqrt_pi = sqrt(pi), sqrt_2 = sqrt(T{2.0}),
+        f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1;
+    const Index nelems = m * n * k;
+    for(Index i = threadIdx.x + Index(blockIdx.x)*blockDim.x; i < nelems;
+            i += Index(gridDim.x)*blockDim.x)
+    {
+        const Index l = (i/m) % k;
+        const T scale = inv_stddev[l] * gamma[l];
+        T y = (src[i]-mean[l])*scale + beta[l];
+        // The same activation is applied by all threads
+        if(act == activation_t::RELU)
+        {
+            y = fmax(y, zero);
+        }
+        else if(act == activation_t::GELUTANH)
+        {
+            y = y / (one+exp(y*(f3+f4*y*y)));
+        }
+        dst[i] = y;
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, activation_t act,
+        const T *src, const T *mean, const T *inv_stddev, const T *gamma,
+        const T *beta, T *dst)
+    noexcept
+//! Batch normalization followed by an activation on CUDA
+/*! Parameters are the same as of nntile::kernel::batch_norm_act::cpu().
+ * */
+{
+    Index nelems = m * n * k;
+    if(nelems == 0)
+    {
+        return;
+    }
+    dim3 blocks(std::min((nelems+255)/256, Index(65535))), threads(256);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, n, k, act, src,
+            mean, inv_stddev, gamma, beta, dst);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k,
+        activation_t act, const fp32_t *src, const fp32_t *mean,
+        const fp32_t *inv_stddev, const fp32_t *gamma, const fp32_t *beta,
+        fp32_t *dst)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k,
+        activation_t act, const fp64_t *src, const fp64_t *mean,
+        const fp64_t *inv_stddev, const fp64_t *gamma, const fp64_t *beta,
+        fp64_t *dst)
+    noexcept;
+
+} // namespace batch_norm_act
+} // namespace kernel
+} // namespace nntile
+
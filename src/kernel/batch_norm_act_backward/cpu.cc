@@ -0,0 +1,145 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/batch_norm_act_backward/cpu.cc
+ * Backward of an activation, that follows batch normalization, on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/batch_norm_act_backward/cpu.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace batch_norm_act_backward
+{
+
+// Gradients over output of normalization and their sums over fibers
+template<typename T, typename F>
+static void apply(Index m, Index n, Index k, const T *src, const T *mean,
+        const T *inv_stddev, const T *gamma, const T *beta,
+        const T *dst_grad, T *y_grad, T *sum_grad, T *sum_grad_xhat, F dfunc)
+{
+    constexpr T zero = 0;
+    // Cycle over the last mode and features to read contiguous fibers
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const T mean_val = mean[i1], inv_stddev_val = inv_stddev[i1],
+                  gamma_val = gamma[i1], beta_val = beta[i1];
+            T sum = zero, sum_xhat = zero;
+            Index offset = (i2*k+i1) * m;
+            const T *src_fiber = src + offset;
+            const T *dst_grad_fiber = dst_grad + offset;
+            T *y_grad_fiber = y_grad + offset;
+            // Cycle over the first mode
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                T xhat = (src_fiber[i0]-mean_val) * inv_stddev_val;
+                T grad = dst_grad_fiber[i0] * dfunc(xhat*gamma_val+beta_val);
+                y_grad_fiber[i0] = grad;
+                sum += grad;
+                sum_xhat += grad * xhat;
+            }
+            sum_grad[i1] += sum;
+            sum_grad_xhat[i1] += sum_xhat;
+        }
+    }
+}
+
+template<typename T>
+void cpu(Index m, Index n, Index k, activation_t act, const T *src,
+        const T *mean, const T *inv_stddev, const T *gamma, const T *beta,
+        const T *dst_grad, T *y_grad, T *sum_grad, T *sum_grad_xhat)
+    noexcept
+//! Backward of an activation, that follows batch normalization, on CPU
+/*! Recomputes output of normalization from the input and the stored
+ * statistics, computes gradient over it and accumulates its sums, that are
+ * gradients of biases and scaling factors of features:
+ *      xhat[i,l,j] = (src[i,l,j]-mean[l]) * inv_stddev[l]
+ *      y_grad[i,l,j] = dst_grad[i,l,j] * act'(xhat[i,l,j]*gamma[l]+beta[l])
+ *      sum_grad[l] = sum_grad[l] + sum_{i,j} y_grad[i,l,j]
+ *      sum_grad_xhat[l] = sum_grad_xhat[l]
+ *          + sum_{i,j} y_grad[i,l,j]*xhat[i,l,j]
+ *
+ * @param[in] m: Size of the first mode of src, dst_grad and y_grad arrays
+ * @param[in] n: Size of the last mode of src, dst_grad and y_grad arrays
+ * @param[in] k: Size of the middle mode of src, dst_grad and y_grad arrays,
+ *      that is the number of features
+ * @param[in] act: Activation, applied after normalization
+ * @param[in] src: Input of normalization as a contiguous m-by-k-by-n array
+ * @param[in] mean: Mean values of features of size k
+ * @param[in] inv_stddev: Inverse standard deviations of features of size k
+ * @param[in] gamma: Scaling factors of features of size k
+ * @param[in] beta: Biases of features of size k
+ * @param[in] dst_grad: Gradient over output of the activation
+ * @param[out] y_grad: Gradient over output of normalization
+ * @param[inout] sum_grad: Accumulated sums of y_grad of size k
+ * @param[inout] sum_grad_xhat: Accumulated sums of y_grad*xhat of size k
+ * */
+{
+    // Constants
+    constexpr T pi = 3.141592653589793238462643383279502884L,
+        zero = 0, one = 1, f1 = T{0.044715};
+    // Square root is not constexpr by standard, proceed with a static const
+    static const T sqrt_pi = std::sqrt(pi), sqrt_2 = std::sqrt(T{2}),
+        f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1, f5 = T{3}*f4;
+    switch(act)
+    {
+        case activation_t::RELU:
+            apply(m, n, k, src, mean, inv_stddev, gamma, beta, dst_grad,
+                    y_grad, sum_grad, sum_grad_xhat,
+                    [](T y){ return y > zero ? one : zero; });
+            break;
+        case activation_t::GELUTANH:
+            apply(m, n, k, src, mean, inv_stddev, gamma, beta, dst_grad,
+                    y_grad, sum_grad, sum_grad_xhat,
+                    [](T z)
+                    {
+                        T z2 = z * z;
+                        T y1 = z * (f3 + f4*z2);
+                        T y2 = z * (f3 + f5*z2);
+                        T expy1 = std::exp(y1);
+                        if(std::isinf(expy1))
+                        {
+                            return zero;
+                        }
+                        T inv_expy1p1 = one / (expy1 + one);
+                        return (one-y2*(one-inv_expy1p1)) * inv_expy1p1;
+                    });
+            break;
+        default:
+            apply(m, n, k, src, mean, inv_stddev, gamma, beta, dst_grad,
+                    y_grad, sum_grad, sum_grad_xhat,
+                    [](T){ return one; });
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, activation_t act,
+        const fp32_t *src, const fp32_t *mean, const fp32_t *inv_stddev,
+        const fp32_t *gamma, const fp32_t *beta, const fp32_t *dst_grad,
+        fp32_t *y_grad, fp32_t *sum_grad, fp32_t *sum_grad_xhat)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, activation_t act,
+        const fp64_t *src, const fp64_t *mean, const fp64_t *inv_stddev,
+        const fp64_t *gamma, const fp64_t *beta, const fp64_t *dst_grad,
+        fp64_t *y_grad, fp64_t *sum_grad, fp64_t *sum_grad_xhat)
+    noexcept;
+
+} // namespace batch_norm_act_backward
+} // namespace kernel
+} // namespace nntile
+
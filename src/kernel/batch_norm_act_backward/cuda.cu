@@ -0,0 +1,159 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/batch_norm_act_backward/cuda.cu
+ * Backward of an activation, that follows batch normalization, on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/batch_norm_act_backward/cuda.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace batch_norm_act_backward
+{
+
+// Number of threads in a CUDA block
+static constexpr int BLOCK = 256;
+
+// Maximal number of parts of the last mode, processed by different threads
+static constexpr Index N_SPLIT = 32;
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, Index n, Index k, activation_t act, const T *src,
+        const T *mean, const T *inv_stddev, const T *gamma, const T *beta,
+        const T *dst_grad, T *y_grad, T *sum_grad, T *sum_grad_xhat)
+//! Gradient over output of normalization and its sums
+/*! A thread processes a part of the last mode for a single element of the
+ * first two modes, so that reads are coalesced. If all the threads of a block
+ * correspond to the same feature, their sums are reduced in shared memory,
+ * otherwise every thread adds its sums atomically.
+ * */
+{
+    __shared__ T sum_shared[BLOCK], sum_xhat_shared[BLOCK];
+    // Constants
+    constexpr T pi = 3.141592653589793238462643383279502884L,
+        zero = 0, one = 1, f1 = T{0.044715};
+    // Square root is not constexpr by standard, proceed with a const
+    const T sqrt_pi = sqrt(pi), sqrt_2 = sqrt(T{2.0}),
+        f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1, f5 = T{3}*f4;
+    const int tid = threadIdx.x;
+    const Index mk = m * k;
+    const Index e_first = Index(blockIdx.x) * BLOCK, e = e_first + tid;
+    T sum = zero, sum_xhat = zero;
+    if(e < mk)
+    {
+        const Index l = e / m;
+        const T mean_val = mean[l], inv_stddev_val = inv_stddev[l],
+              gamma_val = gamma[l], beta_val = beta[l];
+        for(Index i2 = blockIdx.y; i2 < n; i2 += gridDim.y)
+        {
+            const Index i = i2*mk + e;
+            T xhat = (src[i]-mean_val) * inv_stddev_val;
+            T z = xhat*gamma_val + beta_val;
+            // The same activation is applied by all threads
+            T dact = one;
+            if(act == activation_t::RELU)
+            {
+                dact = z > zero ? one : zero;
+            }
+            else if(act == activation_t::GELUTANH)
+            {
+                T z2 = z * z;
+                T y1 = z * (f3 + f4*z2);
+                T y2 = z * (f3 + f5*z2);
+                T expy1 = exp(y1);
+                dact = zero;
+                if(not isinf(expy1))
+                {
+                    T inv_expy1p1 = one / (expy1 + one);
+                    dact = (one-y2*(one-inv_expy1p1)) * inv_expy1p1;
+                }
+            }
+            T grad = dst_grad[i] * dact;
+            y_grad[i] = grad;
+            sum += grad;
+            sum_xhat += grad * xhat;
+        }
+    }
+    // This condition is the same for all the threads of the block
+    const Index e_last = e_first + BLOCK - 1;
+    if(e_last < mk and e_first/m == e_last/m)
+    {
+        sum_shared[tid] = sum;
+        sum_xhat_shared[tid] = sum_xhat;
+        __syncthreads();
+        for(int s = BLOCK/2; s > 0; s /= 2)
+        {
+            if(tid < s)
+            {
+                sum_shared[tid] += sum_shared[tid+s];
+                sum_xhat_shared[tid] += sum_xhat_shared[tid+s];
+            }
+            __syncthreads();
+        }
+        if(tid == 0)
+        {
+            atomicAdd(&sum_grad[e_first/m], sum_shared[0]);
+            atomicAdd(&sum_grad_xhat[e_first/m], sum_xhat_shared[0]);
+        }
+    }
+    else if(e < mk)
+    {
+        atomicAdd(&sum_grad[e/m], sum);
+        atomicAdd(&sum_grad_xhat[e/m], sum_xhat);
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, activation_t act,
+        const T *src, const T *mean, const T *inv_stddev, const T *gamma,
+        const T *beta, const T *dst_grad, T *y_grad, T *sum_grad,
+        T *sum_grad_xhat)
+    noexcept
+//! Backward of an activation, that follows batch normalization, on CUDA
+/*! Parameters are the same as of
+ * nntile::kernel::batch_norm_act_backward::cpu().
+ * */
+{
+    if(m == 0 or n == 0 or k == 0)
+    {
+        return;
+    }
+    dim3 blocks((m*k+BLOCK-1)/BLOCK, std::min(n, N_SPLIT)), threads(BLOCK);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, n, k, act, src, mean,
+            inv_stddev, gamma, beta, dst_grad, y_grad, sum_grad,
+            sum_grad_xhat);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k,
+        activation_t act, const fp32_t *src, const fp32_t *mean,
+        const fp32_t *inv_stddev, const fp32_t *gamma, const fp32_t *beta,
+        const fp32_t *dst_grad, fp32_t *y_grad, fp32_t *sum_grad,
+        fp32_t *sum_grad_xhat)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k,
+        activation_t act, const fp64_t *src, const fp64_t *mean,
+        const fp64_t *inv_stddev, const fp64_t *gamma, const fp64_t *beta,
+        const fp64_t *dst_grad, fp64_t *y_grad, fp64_t *sum_grad,
+        fp64_t *sum_grad_xhat)
+    noexcept;
+
+} // namespace batch_norm_act_backward
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,95 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/batch_norm_backward/cpu.cc
+ * Backward of batch normalization with stored statistics on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/batch_norm_backward/cpu.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace batch_norm_backward
+{
+
+template<typename T>
+void cpu(Index m, Index n, Index k, T alpha, const T *src, const T *mean,
+        const T *inv_stddev, const T *gamma, const T *sum_grad,
+        const T *sum_grad_xhat, T *grad)
+    noexcept
+//! Backward of batch normalization with stored statistics on CPU
+/*! Converts gradient over output of normalization into gradient over its
+ * input inplace, where statistics of features were computed over all the
+ * elements of a batch:
+ *      xhat[i,l,j] = (src[i,l,j]-mean[l]) * inv_stddev[l]
+ *      grad[i,l,j] = gamma[l] * inv_stddev[l] * (grad[i,l,j]
+ *          - alpha*(sum_grad[l]+xhat[i,l,j]*sum_grad_xhat[l]))
+ * Sums over the whole batch are computed by
+ * nntile::kernel::batch_norm_act_backward::cpu() and alpha is the inverse of
+ * the number of elements of the batch per feature.
+ *
+ * @param[in] m: Size of the first mode of src and grad arrays
+ * @param[in] n: Size of the last mode of src and grad arrays
+ * @param[in] k: Size of the middle mode of src and grad arrays, that is the
+ *      number of features
+ * @param[in] alpha: Inverse of the number of elements of a feature
+ * @param[in] src: Input of normalization as a contiguous m-by-k-by-n array
+ * @param[in] mean: Mean values of features of size k
+ * @param[in] inv_stddev: Inverse standard deviations of features of size k
+ * @param[in] gamma: Scaling factors of features of size k
+ * @param[in] sum_grad: Sums of gradient over output of size k
+ * @param[in] sum_grad_xhat: Sums of gradient over output, multiplied by the
+ *      normalized input, of size k
+ * @param[inout] grad: Gradient over output of normalization on input and
+ *      gradient over its input on output
+ * */
+{
+    // Cycle over the last mode
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        // Cycle over features
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const T mean_val = mean[i1], inv_stddev_val = inv_stddev[i1];
+            const T scale = gamma[i1] * inv_stddev_val;
+            const T shift = alpha * sum_grad[i1];
+            const T slope = alpha * sum_grad_xhat[i1];
+            Index offset = (i2*k+i1) * m;
+            const T *src_fiber = src + offset;
+            T *grad_fiber = grad + offset;
+            // Cycle over the first mode
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                T xhat = (src_fiber[i0]-mean_val) * inv_stddev_val;
+                grad_fiber[i0] = scale * (grad_fiber[i0]-shift-xhat*slope);
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, fp32_t alpha, const fp32_t *src,
+        const fp32_t *mean, const fp32_t *inv_stddev, const fp32_t *gamma,
+        const fp32_t *sum_grad, const fp32_t *sum_grad_xhat, fp32_t *grad)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, fp64_t alpha, const fp64_t *src,
+        const fp64_t *mean, const fp64_t *inv_stddev, const fp64_t *gamma,
+        const fp64_t *sum_grad, const fp64_t *sum_grad_xhat, fp64_t *grad)
+    noexcept;
+
+} // namespace batch_norm_backward
+} // namespace kernel
+} // namespace nntile
+
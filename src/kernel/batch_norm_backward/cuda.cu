@@ -0,0 +1,80 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/batch_norm_backward/cuda.cu
+ * Backward of batch normalization with stored statistics on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/batch_norm_backward/cuda.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace batch_norm_backward
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, Index n, Index k, T alpha, const T *src,
+        const T *mean, const T *inv_stddev, const T *gamma,
+        const T *sum_grad, const T *sum_grad_xhat, T *grad)
+{
+    const Index nelems = m * n * k;
+    for(Index i = threadIdx.x + Index(blockIdx.x)*blockDim.x; i < nelems;
+            i += Index(gridDim.x)*blockDim.x)
+    {
+        const Index l = (i/m) % k;
+        const T inv_stddev_val = inv_stddev[l];
+        T xhat = (src[i]-mean[l]) * inv_stddev_val;
+        grad[i] = gamma[l] * inv_stddev_val * (grad[i]
+                - alpha*(sum_grad[l]+xhat*sum_grad_xhat[l]));
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, T alpha,
+        const T *src, const T *mean, const T *inv_stddev, const T *gamma,
+        const T *sum_grad, const T *sum_grad_xhat, T *grad)
+    noexcept
+//! Backward of batch normalization with stored statistics on CUDA
+/*! Parameters are the same as of nntile::kernel::batch_norm_backward::cpu().
+ * */
+{
+    Index nelems = m * n * k;
+    if(nelems == 0)
+    {
+        return;
+    }
+    dim3 blocks(std::min((nelems+255)/256, Index(65535))), threads(256);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, n, k, alpha, src,
+            mean, inv_stddev, gamma, sum_grad, sum_grad_xhat, grad);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k,
+        fp32_t alpha, const fp32_t *src, const fp32_t *mean,
+        const fp32_t *inv_stddev, const fp32_t *gamma,
+        const fp32_t *sum_grad, const fp32_t *sum_grad_xhat, fp32_t *grad)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k,
+        fp64_t alpha, const fp64_t *src, const fp64_t *mean,
+        const fp64_t *inv_stddev, const fp64_t *gamma,
+        const fp64_t *sum_grad, const fp64_t *sum_grad_xhat, fp64_t *grad)
+    noexcept;
+
+} // namespace batch_norm_backward
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,41 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/bf16_to_fp32/cpu.cc
+ * Convert bf16_t array into fp32_t array on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-31
+ * */
+
+#include "nntile/kernel/bf16_to_fp32/cpu.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace bf16_to_fp32
+{
+
+void cpu(Index nelems, const bf16_t *src, fp32_t *dst)
+    noexcept
+/*!
+ * @params[in] nelems: Number of elements in a buffer
+ * @params[in] src: Input array
+ * @params[out] dst: Output array
+ * */
+{
+    for(Index i = 0; i < nelems; ++i)
+    {
+        dst[i] = src[i];
+    }
+}
+
+} // namespace bf16_to_fp32
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,52 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/bf16_to_fp32/cuda.cu
+ * Convert bf16_t array into fp32_t array on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-31
+ * */
+
+#include "nntile/kernel/bf16_to_fp32/cuda.hh"
+#include <cuda_bf16.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace bf16_to_fp32
+{
+
+static __global__
+void cuda_kernel(Index nelems, const __nv_bfloat16 *src, fp32_t *dst)
+{
+    int i = threadIdx.x + blockIdx.x*blockDim.x;
+    if(i < nelems)
+    {
+        dst[i] = __bfloat162float(src[i]);
+    }
+}
+
+void cuda(cudaStream_t stream, Index nelems, const bf16_t *src, fp32_t *dst)
+    noexcept
+/*!
+ * @params[in] nelems: Number of elements in a buffer
+ * @params[in] src: Input array
+ * @params[out] dst: Output array
+ * */
+{
+    dim3 blocks((nelems+255)/256), threads(256);
+    const __nv_bfloat16 *src_bf16 =
+        reinterpret_cast<const __nv_bfloat16 *>(src);
+    (cuda_kernel)<<<blocks, threads, 0, stream>>>(nelems, src_bf16, dst);
+}
+
+} // namespace bf16_to_fp32
+} // namespace kernel
+} // namespace nntile
+
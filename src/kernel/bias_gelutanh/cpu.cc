@@ -0,0 +1,90 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/bias_gelutanh/cpu.cc
+ * Bias addition followed by approximate GeLU on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#include "nntile/kernel/bias_gelutanh/cpu.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace bias_gelutanh
+{
+
+template<typename T>
+void cpu(Index m, Index n, Index k, const T *bias, T *src, T *dst)
+    noexcept
+//! Bias addition followed by approximate GeLU on CPU
+/*! Adds a broadcasted fiber to an input array and applies the same
+ * approximation of the GeLU function as nntile::kernel::gelutanh::cpu():
+ *      src[i,l,j] = src[i,l,j] + bias[l]
+ *      dst[i,l,j] = AGeLU(src[i,l,j])
+ * Input array keeps values before the activation for the backward pass.
+ *
+ * @param[in] m: Size of the first mode of src and dst arrays
+ * @param[in] n: Size of the last mode of src and dst arrays
+ * @param[in] k: Size of the middle mode of src and dst arrays and the only
+ *      mode of bias
+ * @param[in] bias: Input contiguous vector with k elements
+ * @param[inout] src: Input and output contiguous m-by-k-by-n array
+ * @param[out] dst: Output contiguous m-by-k-by-n array
+ * */
+{
+    // Constants
+    constexpr T pi = 3.141592653589793238462643383279502884L,
+        one = 1, f1 = T{0.044715};
+    // Square root is not constexpr by standard, proceed with a static const
+    static const T sqrt_pi = std::sqrt(pi), sqrt_2 = std::sqrt(T{2}),
+        f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1;
+    // Cycle over the last mode
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        // Cycle over the bias
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const T bias_val = bias[i1];
+            T *src_fiber = src + (i2*k+i1)*m;
+            T *dst_fiber = dst + (i2*k+i1)*m;
+            // Cycle over the first mode
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                T z = src_fiber[i0] + bias_val;
+                src_fiber[i0] = z;
+                T y1 = f4 * z * z;
+                T y2 = f3 + y1;
+                T c = y1 - (y2-f3);
+                y2 *= z;
+                c *= z;
+                T y3 = one + std::exp(c)*std::exp(y2);
+                dst_fiber[i0] = z / y3;
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, const fp32_t *bias, fp32_t *src,
+        fp32_t *dst)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, const fp64_t *bias, fp64_t *src,
+        fp64_t *dst)
+    noexcept;
+
+} // namespace bias_gelutanh
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,78 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/bias_gelutanh/cuda.cu
+ * Bias addition followed by approximate GeLU on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#include "nntile/kernel/bias_gelutanh/cuda.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace bias_gelutanh
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, Index n, Index k, const T *bias, T *src, T *dst)
+{
+    // Constants
+    constexpr T pi = 3.141592653589793238462643383279502884L,
+        one = 1, f1 = T{0.044715};
+    // Square root is not constexpr by standard, proceed with a static const
+    const T sqrt_pi = sqrt(pi), sqrt_2 = sqrt(T{2.0}),
+        f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1;
+    const Index nelems = m * n * k;
+    for(Index i = threadIdx.x + Index(blockIdx.x)*blockDim.x; i < nelems;
+            i += Index(gridDim.x)*blockDim.x)
+    {
+        T z = src[i] + bias[(i/m)%k];
+        src[i] = z;
+        T y = z * (f3 + f4*z*z);
+        dst[i] = z / (one+exp(y));
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, const T *bias,
+        T *src, T *dst)
+    noexcept
+//! Bias addition followed by approximate GeLU on CUDA
+/*! Parameters are the same as of nntile::kernel::bias_gelutanh::cpu().
+ * */
+{
+    Index nelems = m * n * k;
+    if(nelems == 0)
+    {
+        return;
+    }
+    dim3 blocks(std::min((nelems+255)/256, Index(65535))), threads(256);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, n, k, bias, src,
+            dst);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k,
+        const fp32_t *bias, fp32_t *src, fp32_t *dst)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k,
+        const fp64_t *bias, fp64_t *src, fp64_t *dst)
+    noexcept;
+
+} // namespace bias_gelutanh
+} // namespace kernel
+} // namespace nntile
+
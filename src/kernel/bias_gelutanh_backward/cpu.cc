@@ -0,0 +1,99 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/bias_gelutanh_backward/cpu.cc
+ * Backward of bias addition followed by approximate GeLU on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#include "nntile/kernel/bias_gelutanh_backward/cpu.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace bias_gelutanh_backward
+{
+
+template<typename T>
+void cpu(Index m, Index n, Index k, const T *src, const T *dst_grad,
+        T *src_grad, T *bias_grad)
+    noexcept
+//! Backward of bias addition followed by approximate GeLU on CPU
+/*! Computes gradient over input of the activation, that is also the gradient
+ * over output of the bias addition, and accumulates its sums over slices
+ * into gradient of the bias:
+ *      src_grad[i,l,j] = dst_grad[i,l,j] * AGeLU'(src[i,l,j])
+ *      bias_grad[l] = bias_grad[l] + sum_{i,j} src_grad[i,l,j]
+ *
+ * @param[in] m: Size of the first mode of src, dst_grad and src_grad arrays
+ * @param[in] n: Size of the last mode of src, dst_grad and src_grad arrays
+ * @param[in] k: Size of the middle mode of src, dst_grad and src_grad arrays
+ *      and the only mode of bias_grad
+ * @param[in] src: Input of the activation as a contiguous m-by-k-by-n array
+ * @param[in] dst_grad: Gradient over output of the activation
+ * @param[out] src_grad: Gradient over input of the activation
+ * @param[inout] bias_grad: Gradient over bias of size k
+ * */
+{
+    // Constants
+    constexpr T pi = 3.141592653589793238462643383279502884L,
+        zero = 0, one = 1, f1 = T{0.044715};
+    // Square root is not constexpr by standard, proceed with a static const
+    static const T sqrt_pi = std::sqrt(pi), sqrt_2 = std::sqrt(T{2}),
+        f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1, f5 = T{3}*f4;
+    // Cycle over the last mode and the bias to read contiguous fibers
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            T sum = zero;
+            Index offset = (i2*k+i1) * m;
+            const T *src_fiber = src + offset;
+            const T *dst_grad_fiber = dst_grad + offset;
+            T *src_grad_fiber = src_grad + offset;
+            // Cycle over the first mode
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                T z = src_fiber[i0];
+                T z2 = z * z;
+                T y1 = z * (f3 + f4*z2);
+                T y2 = z * (f3 + f5*z2);
+                T expy1 = std::exp(y1);
+                T grad = zero;
+                if(not std::isinf(expy1))
+                {
+                    T inv_expy1p1 = one / (expy1 + one);
+                    grad = (one-y2*(one-inv_expy1p1)) * inv_expy1p1
+                        * dst_grad_fiber[i0];
+                }
+                src_grad_fiber[i0] = grad;
+                sum += grad;
+            }
+            bias_grad[i1] += sum;
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, const fp32_t *src,
+        const fp32_t *dst_grad, fp32_t *src_grad, fp32_t *bias_grad)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, const fp64_t *src,
+        const fp64_t *dst_grad, fp64_t *src_grad, fp64_t *bias_grad)
+    noexcept;
+
+} // namespace bias_gelutanh_backward
+} // namespace kernel
+} // namespace nntile
+
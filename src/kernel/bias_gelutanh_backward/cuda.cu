@@ -0,0 +1,132 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/bias_gelutanh_backward/cuda.cu
+ * Backward of bias addition followed by approximate GeLU on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#include "nntile/kernel/bias_gelutanh_backward/cuda.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace bias_gelutanh_backward
+{
+
+// Number of threads in a CUDA block
+static constexpr int BLOCK = 256;
+
+// Maximal number of parts of the last mode, processed by different threads
+static constexpr Index N_SPLIT = 32;
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, Index n, Index k, const T *src, const T *dst_grad,
+        T *src_grad, T *bias_grad)
+//! Gradients of input and bias
+/*! A thread processes a part of the last mode for a single element of the
+ * first two modes, so that reads are coalesced. If all the threads of a block
+ * correspond to the same element of bias, their sums are reduced in shared
+ * memory, otherwise every thread adds its sum atomically.
+ * */
+{
+    __shared__ T sum_shared[BLOCK];
+    // Constants
+    constexpr T pi = 3.141592653589793238462643383279502884L,
+        zero = 0, one = 1, f1 = T{0.044715};
+    // Square root is not constexpr by standard, proceed with a static const
+    const T sqrt_pi = sqrt(pi), sqrt_2 = sqrt(T{2.0}),
+        f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1, f5 = T{3}*f4;
+    const int tid = threadIdx.x;
+    const Index mk = m * k;
+    const Index e_first = Index(blockIdx.x) * BLOCK, e = e_first + tid;
+    T sum = zero;
+    if(e < mk)
+    {
+        for(Index i2 = blockIdx.y; i2 < n; i2 += gridDim.y)
+        {
+            const Index i = i2*mk + e;
+            T z = src[i];
+            T z2 = z * z;
+            T y1 = z * (f3 + f4*z2);
+            T y2 = z * (f3 + f5*z2);
+            T expy1 = exp(y1);
+            T grad = zero;
+            if(not isinf(expy1))
+            {
+                T inv_expy1p1 = one / (expy1 + one);
+                grad = (one-y2*(one-inv_expy1p1)) * inv_expy1p1 * dst_grad[i];
+            }
+            src_grad[i] = grad;
+            sum += grad;
+        }
+    }
+    // This condition is the same for all the threads of the block
+    const Index e_last = e_first + BLOCK - 1;
+    if(e_last < mk and e_first/m == e_last/m)
+    {
+        sum_shared[tid] = sum;
+        __syncthreads();
+        for(int s = BLOCK/2; s > 0; s /= 2)
+        {
+            if(tid < s)
+            {
+                sum_shared[tid] += sum_shared[tid+s];
+            }
+            __syncthreads();
+        }
+        if(tid == 0)
+        {
+            atomicAdd(&bias_grad[e_first/m], sum_shared[0]);
+        }
+    }
+    else if(e < mk)
+    {
+        atomicAdd(&bias_grad[e/m], sum);
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, const T *src,
+        const T *dst_grad, T *src_grad, T *bias_grad)
+    noexcept
+//! Backward of bias addition followed by approximate GeLU on CUDA
+/*! Parameters are the same as of
+ * nntile::kernel::bias_gelutanh_backward::cpu().
+ * */
+{
+    if(m == 0 or n == 0 or k == 0)
+    {
+        return;
+    }
+    dim3 blocks((m*k+BLOCK-1)/BLOCK, std::min(n, N_SPLIT)), threads(BLOCK);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, n, k, src, dst_grad,
+            src_grad, bias_grad);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k,
+        const fp32_t *src, const fp32_t *dst_grad, fp32_t *src_grad,
+        fp32_t *bias_grad)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k,
+        const fp64_t *src, const fp64_t *dst_grad, fp64_t *src_grad,
+        fp64_t *bias_grad)
+    noexcept;
+
+} // namespace bias_gelutanh_backward
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,67 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/clip_scale/cpu.cc
+ * Learning rate and scale of gradients for clipping by a global norm on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/clip_scale/cpu.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace clip_scale
+{
+
+template<typename T>
+void cpu(T lr, T max_norm, const T *norm, T *scalars)
+    noexcept
+//! Learning rate and scale of gradients for clipping on CPU
+/*! Performs the following operation:
+ *      scalars[0] = lr,
+ *      scalars[1] = min(1, max_norm/(norm[0]+1e-6)),
+ * as torch.nn.utils.clip_grad_norm_ does. Non-positive max_norm disables
+ * clipping. The result is read by nntile::kernel::multi_adam_step.
+ *
+ * @param[in] lr: Learning rate of the current step
+ * @param[in] max_norm: Maximal global norm of gradients
+ * @param[in] norm: Global norm of gradients
+ * @param[out] scalars: Learning rate and scale of gradients
+ * */
+{
+    T scale = 1;
+    if(max_norm > 0)
+    {
+        T coef = max_norm / (norm[0]+T(1e-6));
+        if(coef < scale)
+        {
+            scale = coef;
+        }
+    }
+    scalars[0] = lr;
+    scalars[1] = scale;
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(fp32_t lr, fp32_t max_norm, const fp32_t *norm,
+        fp32_t *scalars)
+    noexcept;
+
+template
+void cpu<fp64_t>(fp64_t lr, fp64_t max_norm, const fp64_t *norm,
+        fp64_t *scalars)
+    noexcept;
+
+} // namespace clip_scale
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,66 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/clip_scale/cuda.cu
+ * Learning rate and scale of gradients for clipping by a global norm on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/clip_scale/cuda.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace clip_scale
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(T lr, T max_norm, const T *norm, T *scalars)
+{
+    T scale = 1;
+    if(max_norm > 0)
+    {
+        T coef = max_norm / (norm[0]+T(1e-6));
+        if(coef < scale)
+        {
+            scale = coef;
+        }
+    }
+    scalars[0] = lr;
+    scalars[1] = scale;
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, T lr, T max_norm, const T *norm, T *scalars)
+    noexcept
+//! Learning rate and scale of gradients for clipping on CUDA
+/*! The norm stays on the device, so a single thread computes the result.
+ * Parameters are the same as of nntile::kernel::clip_scale::cpu().
+ * */
+{
+    (cuda_kernel<T>)<<<1, 1, 0, stream>>>(lr, max_norm, norm, scalars);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, fp32_t lr, fp32_t max_norm,
+        const fp32_t *norm, fp32_t *scalars)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, fp64_t lr, fp64_t max_norm,
+        const fp64_t *norm, fp64_t *scalars)
+    noexcept;
+
+} // namespace clip_scale
+} // namespace kernel
+} // namespace nntile
+
@@ -9,7 +9,7 @@
  *
  * @version 1.0.0
  * @author Aleksandr Mikhalev
- * @date 2023-09-14
+ * @date 2024-01-29
  * */
 
 #include <algorithm>
@@ -20,64 +20,298 @@ namespace nntile {
 namespace kernel {
 namespace conv2d {
 
+// Every CUDA block computes a BLOCK-by-BLOCK tile of dst
+static constexpr int BLOCK = 16;
+
+// Kernel is processed by KTILE-by-KTILE chunks
+static constexpr int KTILE = 16;
+
+// Size of a patch of src, that is needed for a tile of dst and a kernel chunk
+static constexpr int PATCH = BLOCK + KTILE - 1;
+
+// Threads of a block load a kernel chunk element-wise
+static_assert(BLOCK == KTILE, "Kernel chunk must match CUDA block");
+
+template <typename T, bool FLIP>
+static __global__ void cuda_kernel(Index offset_n, Index offset_m,
+        Index batch, Index src_n, Index src_m, const T *src, Index kernel_n,
+        Index kernel_m, const T *kernel, Index dst_n, Index dst_m, T *dst)
+//! Implicit GEMM 2D-Convolution on CUDA
+/*! A chunk of kernel and a corresponding patch of src are loaded into shared
+ * memory, so that every element of src is read from global memory only once
+ * per chunk instead of once per output element. Out of bounds elements of the
+ * patch are zeros, therefore the inner loop has no bounds checks. If FLIP
+ * is set, kernel is flipped along both axes.
+ * */
+{
+    __shared__ T kernel_chunk[KTILE][KTILE];
+    __shared__ T src_patch[PATCH][PATCH];
+    const int tx = threadIdx.x, ty = threadIdx.y, tid = ty*BLOCK + tx;
+    const Index d1_block = Index(blockIdx.y) * BLOCK;
+    const Index d2_block = Index(blockIdx.x) * BLOCK;
+    const Index d1 = d1_block + ty, d2 = d2_block + tx;
+    for(Index b = blockIdx.z; b < batch; b += gridDim.z)
+    {
+        const T *src_b = src + b*src_n*src_m;
+        const T *kernel_b = kernel + b*kernel_n*kernel_m;
+        T res = 0;
+        for(Index j1_chunk = 0; j1_chunk < kernel_n; j1_chunk += KTILE)
+        {
+            // First row of src patch
+            const Index i1_patch = d1_block + offset_n - j1_chunk - KTILE + 1;
+            // Skip the chunk if the patch is out of src (uniform in block)
+            if(i1_patch >= src_n or i1_patch+PATCH <= 0)
+            {
+                continue;
+            }
+            for(Index j2_chunk = 0; j2_chunk < kernel_m; j2_chunk += KTILE)
+            {
+                const Index i2_patch = d2_block + offset_m - j2_chunk
+                    - KTILE + 1;
+                if(i2_patch >= src_m or i2_patch+PATCH <= 0)
+                {
+                    continue;
+                }
+                // Load kernel chunk
+                Index j1 = j1_chunk + ty, j2 = j2_chunk + tx;
+                if(FLIP)
+                {
+                    j1 = kernel_n - 1 - j1;
+                    j2 = kernel_m - 1 - j2;
+                }
+                kernel_chunk[ty][tx] = (j1 >= 0 and j1 < kernel_n and j2 >= 0
+                        and j2 < kernel_m) ? kernel_b[j1*kernel_m+j2] : T(0);
+                // Load src patch
+                for(int p = tid; p < PATCH*PATCH; p += BLOCK*BLOCK)
+                {
+                    int p1 = p / PATCH, p2 = p % PATCH;
+                    Index i1 = i1_patch + p1, i2 = i2_patch + p2;
+                    src_patch[p1][p2] = (i1 >= 0 and i1 < src_n and i2 >= 0
+                            and i2 < src_m) ? src_b[i1*src_m+i2] : T(0);
+                }
+                __syncthreads();
+                // src row i1 = d1+offset_n-j1 is a row ty+KTILE-1-a of patch
+                for(int a = 0; a < KTILE; ++a)
+                {
+                    for(int c = 0; c < KTILE; ++c)
+                    {
+                        res += src_patch[ty+KTILE-1-a][tx+KTILE-1-c]
+                            * kernel_chunk[a][c];
+                    }
+                }
+                __syncthreads();
+            }
+        }
+        if(d1 < dst_n and d2 < dst_m)
+        {
+            dst[(b*dst_n+d1)*dst_m+d2] += res;
+        }
+    }
+}
+
+template <typename T, bool FLIP>
+static __global__ void cuda_winograd_kernel(Index offset_n, Index offset_m,
+        Index batch, Index src_n, Index src_m, const T *src, const T *kernel,
+        Index dst_n, Index dst_m, T *dst)
+//! 2D-Convolution with a 3-by-3 kernel through Winograd F(2x2,3x3) on CUDA
+/*! Every thread computes a 2-by-2 tile of dst out of a 4-by-4 patch of src
+ * as A^T [U * (B^T d B)] A, see nntile::kernel::conv2d::cpu_winograd().
+ * Transformed kernel U is computed once per block in shared memory. If FLIP
+ * is set, kernel is flipped along both axes.
+ * */
+{
+    __shared__ T u[4][4];
+    const int tx = threadIdx.x, ty = threadIdx.y;
+    const Index d1 = 2 * (Index(blockIdx.y)*BLOCK + ty);
+    const Index d2 = 2 * (Index(blockIdx.x)*BLOCK + tx);
+    const Index i1 = d1 + offset_n - 2, i2 = d2 + offset_m - 2;
+    for(Index b = blockIdx.z; b < batch; b += gridDim.z)
+    {
+        // Row a of U = G g G^T of the flipped kernel g[a][c]=kernel[2-a][2-c]
+        if(ty == 0 and tx < 4)
+        {
+            const T *kernel_b = kernel + b*9;
+            T gg[3];
+            for(int c = 0; c < 3; ++c)
+            {
+                T g0 = FLIP ? kernel_b[c] : kernel_b[8-c];
+                T g1 = FLIP ? kernel_b[3+c] : kernel_b[5-c];
+                T g2 = FLIP ? kernel_b[6+c] : kernel_b[2-c];
+                gg[c] = tx == 0 ? g0 : tx == 1 ? T(0.5)*(g0+g1+g2)
+                    : tx == 2 ? T(0.5)*(g0-g1+g2) : g2;
+            }
+            u[tx][0] = gg[0];
+            u[tx][1] = T(0.5) * (gg[0]+gg[1]+gg[2]);
+            u[tx][2] = T(0.5) * (gg[0]-gg[1]+gg[2]);
+            u[tx][3] = gg[2];
+        }
+        __syncthreads();
+        if(d1 < dst_n and d2 < dst_m)
+        {
+            const T *src_b = src + b*src_n*src_m;
+            T d[4][4];
+            for(int a = 0; a < 4; ++a)
+            {
+                for(int c = 0; c < 4; ++c)
+                {
+                    bool inside = i1+a >= 0 and i1+a < src_n and i2+c >= 0
+                        and i2+c < src_m;
+                    d[a][c] = inside ? src_b[(i1+a)*src_m+i2+c] : T(0);
+                }
+            }
+            // Rows of B^T d
+            T t[4][4];
+            for(int c = 0; c < 4; ++c)
+            {
+                t[0][c] = d[0][c] - d[2][c];
+                t[1][c] = d[1][c] + d[2][c];
+                t[2][c] = d[2][c] - d[1][c];
+                t[3][c] = d[1][c] - d[3][c];
+            }
+            // Element-wise product of U and B^T d B
+            T m[4][4];
+            for(int a = 0; a < 4; ++a)
+            {
+                m[a][0] = u[a][0] * (t[a][0]-t[a][2]);
+                m[a][1] = u[a][1] * (t[a][1]+t[a][2]);
+                m[a][2] = u[a][2] * (t[a][2]-t[a][1]);
+                m[a][3] = u[a][3] * (t[a][1]-t[a][3]);
+            }
+            // Output tile A^T m A
+            for(int r = 0; r < 2 and d1+r < dst_n; ++r)
+            {
+                T s[4];
+                for(int c = 0; c < 4; ++c)
+                {
+                    s[c] = r == 0 ? m[0][c]+m[1][c]+m[2][c]
+                        : m[1][c]-m[2][c]-m[3][c];
+                }
+                T *dst_row = dst + (b*dst_n+d1+r)*dst_m + d2;
+                dst_row[0] += s[0] + s[1] + s[2];
+                if(d2+1 < dst_m)
+                {
+                    dst_row[1] += s[1] - s[2] - s[3];
+                }
+            }
+        }
+        // Shared kernel is overwritten by the next batch element
+        __syncthreads();
+    }
+}
+
+// Launch a CUDA kernel for a window of convolution
+template <typename T, bool FLIP>
+static void launch(cudaStream_t stream, Index offset_n, Index offset_m,
+        Index batch, Index src_n, Index src_m, const T *src, Index kernel_n,
+        Index kernel_m, const T *kernel, Index dst_n, Index dst_m, T *dst)
+    noexcept
+{
+    if(batch == 0 or dst_n == 0 or dst_m == 0)
+    {
+        return;
+    }
+    dim3 threads(BLOCK, BLOCK);
+    if(kernel_n == 3 and kernel_m == 3)
+    {
+        // Every thread computes a 2-by-2 tile of dst
+        Index ntiles_n = (dst_n+1) / 2, ntiles_m = (dst_m+1) / 2;
+        dim3 blocks((ntiles_m+BLOCK-1)/BLOCK, (ntiles_n+BLOCK-1)/BLOCK,
+                std::min(batch, Index(65535)));
+        (cuda_winograd_kernel<T, FLIP>)<<<blocks, threads, 0, stream>>>(
+                offset_n, offset_m, batch, src_n, src_m, src, kernel, dst_n,
+                dst_m, dst);
+        return;
+    }
+    dim3 blocks((dst_m+BLOCK-1)/BLOCK, (dst_n+BLOCK-1)/BLOCK,
+            std::min(batch, Index(65535)));
+    (cuda_kernel<T, FLIP>)<<<blocks, threads, 0, stream>>>(offset_n,
+            offset_m, batch, src_n, src_m, src, kernel_n, kernel_m, kernel,
+            dst_n, dst_m, dst);
+}
+
 template <typename T>
-static __global__ void cuda_kernel(Index nx, Index ny, const T* src, Index mx,
-								   Index my, const T* kernel, T* dst)
-//! Compute full discrete linear convolution of two 2-dimensional arrays on
-//! CUDA.
-/*!@param[in] nx: Size of the first axis of src array
- * @param[in] ny: Size of the second axis of src array
- * @param[in] src: Input contiguous nx-by-ny array
- * @param[in] mx: Size of the first axis of kernel array
- * @param[in] my: Size of the second axis of kernel array
- * @param[in] kernel: Input contiguous mx-by-my array
- * @param[out] dst: Output contiguous (nx+my)-by-(ny+my) array
+void cuda(cudaStream_t stream, Index offset_n, Index offset_m, Index batch,
+        Index src_n, Index src_m, const T *src, Index kernel_n,
+        Index kernel_m, const T *kernel, Index dst_n, Index dst_m, T *dst)
+    noexcept
+//! Compute a window of full discrete linear convolution on CUDA
+/*! This is a host function that launches an implicit GEMM kernel, which
+ * computes dst[b,d1,d2] += sum src[b,i1,i2]*kernel[b,j1,j2] over all
+ * i1+j1=d1+offset_n and i2+j2=d2+offset_m. 3-by-3 kernels use Winograd
+ * F(2x2,3x3) instead. Parameters are the same as of
+ * nntile::kernel::conv2d::cpu().
  * */
 {
-  Index i0 = threadIdx.x + blockIdx.x * blockDim.x,
-        i1 = threadIdx.y + blockIdx.y * blockDim.y;
-  if (i1 >= nx+mx-1 || i0 >= ny+my-1)
-    return;
-  T res = 0;
-  for(Index j0=i0-my+1; j0 <= i0; j0++) {
-  	for(Index j1=i1-mx+1; j1 <= i1; j1++) {
-  		res += src[j1 * ny + j0] * kernel[(i1-j1) * my + (i0-j0)];
-  	}
-  }
-  dst[i1 * (my+ny-1) + i0] = res;
+    launch<T, false>(stream, offset_n, offset_m, batch, src_n, src_m, src,
+            kernel_n, kernel_m, kernel, dst_n, dst_m, dst);
+}
 
+template <typename T>
+void cuda_backward_input(cudaStream_t stream, Index offset_n, Index offset_m,
+        Index batch, Index dst_n, Index dst_m, const T *dst_grad,
+        Index kernel_n, Index kernel_m, const T *kernel, Index src_n,
+        Index src_m, T *src_grad) noexcept
+//! Gradient of a window of 2D-Convolution over src on CUDA
+/*! Convolution of dst_grad with the flipped kernel by the same CUDA kernels
+ * as of cuda(). Parameters are the same as of
+ * nntile::kernel::conv2d::cpu_backward_input().
+ * */
+{
+    launch<T, true>(stream, kernel_n-1-offset_n, kernel_m-1-offset_m, batch,
+            dst_n, dst_m, dst_grad, kernel_n, kernel_m, kernel, src_n, src_m,
+            src_grad);
 }
 
 template <typename T>
-void cuda(cudaStream_t stream, Index nx, Index ny, const T* src, Index mx,
-          Index my, const T* kernel, T* dst) noexcept
-//! Per-element addition of a tensor and a broadcasted slice on CUDA
-/*! This is a host function that does the following operations:
- *      dst[i,l,j] = beta*dst[i,l,j] + alpha*src[i,j]
- *
- * @param[in] m: Size of the first mode of src and dst tensors
- * @param[in] n: Size of the last mode of src and dst tensors
- * @param[in] k: Size of the middle mode of dst tensor
- * @param[in] alpha: Scalar factor for src
- * @param[in] src: Input contiguous m-by-n array
- * @param[in] beta: Scaling factor for dst
- * @param[inout] dst: Input and output contiguous m-by-k-by-n array
+void cuda_backward_weight(cudaStream_t stream, Index offset_n,
+        Index offset_m, Index batch, Index src_n, Index src_m, const T *src,
+        Index dst_n, Index dst_m, const T *dst_grad, Index kernel_n,
+        Index kernel_m, T *kernel_grad) noexcept
+//! Gradient of a window of 2D-Convolution over kernel on CUDA
+/*! Convolution of dst_grad with the flipped src by the same CUDA kernels as
+ * of cuda(). Parameters are the same as of
+ * nntile::kernel::conv2d::cpu_backward_weight().
  * */
 {
-  // Both source and destination are Fortran-contiguous
-  dim3 threads(std::min(int(ny), 8), std::min(int(nx), 8));
-  dim3 blocks((ny + threads.x - 1) / threads.x, (nx + threads.y - 1) / threads.y);
-  (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(nx, ny, src, mx, my, kernel, dst);
+    launch<T, true>(stream, src_n-1-offset_n, src_m-1-offset_m, batch, dst_n,
+            dst_m, dst_grad, src_n, src_m, src, kernel_n, kernel_m,
+            kernel_grad);
 }
 
 // Explicit instantiation
-template void cuda<fp32_t>(cudaStream_t stream, Index nx, Index ny,
-                           const fp32_t* src, Index mx, Index my,
-                           const fp32_t* kernel, fp32_t* dst) noexcept;
+template void cuda<fp32_t>(cudaStream_t stream, Index offset_n,
+        Index offset_m, Index batch, Index src_n, Index src_m,
+        const fp32_t *src, Index kernel_n, Index kernel_m,
+        const fp32_t *kernel, Index dst_n, Index dst_m, fp32_t *dst)
+    noexcept;
+
+template void cuda<fp64_t>(cudaStream_t stream, Index offset_n,
+        Index offset_m, Index batch, Index src_n, Index src_m,
+        const fp64_t *src, Index kernel_n, Index kernel_m,
+        const fp64_t *kernel, Index dst_n, Index dst_m, fp64_t *dst)
+    noexcept;
+
+template void cuda_backward_input<fp32_t>(cudaStream_t stream,
+        Index offset_n, Index offset_m, Index batch, Index dst_n, Index dst_m,
+        const fp32_t *dst_grad, Index kernel_n, Index kernel_m,
+        const fp32_t *kernel, Index src_n, Index src_m, fp32_t *src_grad)
+    noexcept;
+
+template void cuda_backward_input<fp64_t>(cudaStream_t stream,
+        Index offset_n, Index offset_m, Index batch, Index dst_n, Index dst_m,
+        const fp64_t *dst_grad, Index kernel_n, Index kernel_m,
+        const fp64_t *kernel, Index src_n, Index src_m, fp64_t *src_grad)
+    noexcept;
+
+template void cuda_backward_weight<fp32_t>(cudaStream_t stream,
+        Index offset_n, Index offset_m, Index batch, Index src_n, Index src_m,
+        const fp32_t *src, Index dst_n, Index dst_m, const fp32_t *dst_grad,
+        Index kernel_n, Index kernel_m, fp32_t *kernel_grad) noexcept;
 
-template void cuda<fp64_t>(cudaStream_t stream, Index nx, Index ny,
-                           const fp64_t* src, Index mx, Index my,
-                           const fp64_t* kernel, fp64_t* dst) noexcept;
+template void cuda_backward_weight<fp64_t>(cudaStream_t stream,
+        Index offset_n, Index offset_m, Index batch, Index src_n, Index src_m,
+        const fp64_t *src, Index dst_n, Index dst_m, const fp64_t *dst_grad,
+        Index kernel_n, Index kernel_m, fp64_t *kernel_grad) noexcept;
 
 }  // namespace conv2d
 }  // namespace kernel
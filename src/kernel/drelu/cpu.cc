@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/drelu/cpu.hh"
+#include "nntile/kernel/simd.hh"
 #include <cmath>
 
 namespace nntile
@@ -31,18 +32,22 @@ void cpu(Index nelems, T *data)
  * */
 {
     constexpr T one = 1.0, zero = 0.0;
-    for(Index i = 0; i < nelems; ++i)
+    // Loops are auto-vectorized for the instruction set of CPU kernels
+    simd::dispatch([&]() NNTILE_SIMD_LOOP
     {
-        T &z = data[i];
-        if(z > zero)
+        for(Index i = 0; i < nelems; ++i)
         {
-            z = one;
+            T &z = data[i];
+            if(z > zero)
+            {
+                z = one;
+            }
+            else
+            {
+                z = zero;
+            }
         }
-        else
-        {
-            z = zero;
-        }
-    }
+    });
 }
 
 // Explicit instantiation
@@ -0,0 +1,81 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/dropout/cpu.cc
+ * Dropout operation on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/dropout/cpu.hh"
+#include "nntile/kernel/dropout/mask.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace dropout
+{
+
+template<typename T>
+void cpu(Index nelems, unsigned long long seed, Index sequence, T p,
+        const T *src, T beta, T *dst)
+    noexcept
+//! Dropout of a buffer with regenerated mask on CPU
+/*! Performs dst[i] = beta*dst[i] + mask[i]*src[i]/(1-p), where mask[i] is
+ * zero with probability p. Mask is defined only by seed, sequence and index
+ * i, so a backward pass regenerates the same mask instead of reading it.
+ * Buffers src and dst may coincide. If beta is zero, dst is not read.
+ *
+ * @param[in] nelems: Number of elements in both buffers
+ * @param[in] seed: Seed of the random generator
+ * @param[in] sequence: Index of random sequence of buffer, e.g., of a tile
+ * @param[in] p: Probability to zero out an element, 0 <= p < 1
+ * @param[in] src: Input buffer
+ * @param[in] beta: Scalar factor of dst
+ * @param[inout] dst: Output buffer
+ * */
+{
+    constexpr T zero = 0.0, one = 1.0;
+    const T scale = one / (one-p);
+    const uint32_t thresh = threshold(p);
+    bool keep[4];
+    for(Index i = 0; i < nelems; i += 4)
+    {
+        mask4(seed, i/4, sequence, thresh, keep);
+        Index end = i+4 < nelems ? i+4 : nelems;
+        for(Index j = i; j < end; ++j)
+        {
+            T val = keep[j-i] ? scale*src[j] : zero;
+            if(beta == zero)
+            {
+                dst[j] = val;
+            }
+            else
+            {
+                dst[j] = beta*dst[j] + val;
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index nelems, unsigned long long seed, Index sequence,
+        fp32_t p, const fp32_t *src, fp32_t beta, fp32_t *dst)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index nelems, unsigned long long seed, Index sequence,
+        fp64_t p, const fp64_t *src, fp64_t beta, fp64_t *dst)
+    noexcept;
+
+} // namespace dropout
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,95 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/dropout/cuda.cu
+ * Dropout operation on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/dropout/cuda.hh"
+#include "nntile/kernel/dropout/mask.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace dropout
+{
+
+// Each thread processes a group of 4 elements, that share Philox output
+template<typename T>
+static __global__
+void cuda_kernel(Index nelems, unsigned long long seed, Index sequence,
+        T scale, uint32_t thresh, const T *src, T beta, T *dst)
+{
+    constexpr T zero = 0.0;
+    Index group = threadIdx.x + Index(blockIdx.x)*blockDim.x;
+    Index i = 4 * group;
+    if(i < nelems)
+    {
+        bool keep[4];
+        mask4(seed, group, sequence, thresh, keep);
+        Index end = i+4 < nelems ? i+4 : nelems;
+        for(Index j = i; j < end; ++j)
+        {
+            T val = keep[j-i] ? scale*src[j] : zero;
+            if(beta == zero)
+            {
+                dst[j] = val;
+            }
+            else
+            {
+                dst[j] = beta*dst[j] + val;
+            }
+        }
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index nelems, unsigned long long seed,
+        Index sequence, T p, const T *src, T beta, T *dst)
+    noexcept
+//! Dropout of a buffer with regenerated mask on CUDA
+/*! Performs dst[i] = beta*dst[i] + mask[i]*src[i]/(1-p), where mask[i] is
+ * zero with probability p. The mask is the same, as the one of CPU
+ * implementation. Buffers src and dst may coincide.
+ *
+ * @param[in] nelems: Number of elements in both buffers
+ * @param[in] seed: Seed of the random generator
+ * @param[in] sequence: Index of random sequence of buffer, e.g., of a tile
+ * @param[in] p: Probability to zero out an element, 0 <= p < 1
+ * @param[in] src: Input buffer
+ * @param[in] beta: Scalar factor of dst
+ * @param[inout] dst: Output buffer
+ * */
+{
+    constexpr T one = 1.0;
+    Index ngroups = (nelems+3) / 4;
+    dim3 blocks((ngroups+255)/256), threads(256);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(nelems, seed, sequence,
+            one/(one-p), threshold(p), src, beta, dst);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index nelems, unsigned long long seed,
+        Index sequence, fp32_t p, const fp32_t *src, fp32_t beta,
+        fp32_t *dst)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index nelems, unsigned long long seed,
+        Index sequence, fp64_t p, const fp64_t *src, fp64_t beta,
+        fp64_t *dst)
+    noexcept;
+
+} // namespace dropout
+} // namespace kernel
+} // namespace nntile
+
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/embedding/cpu.hh"
+#include <algorithm>
 
 namespace nntile
 {
@@ -23,37 +24,111 @@ namespace embedding
 
 template<typename T>
 void cpu(Index m, Index n, Index k, Index k_start, Index k_size,
-        const Index *index, const T *vocab, T *embed)
+        Index vocab_start, Index vocab_size, const Index *index,
+        const T *vocab, T *embed)
     noexcept
 //! Fill embedding from vocabulary
 /*! Fill provided m-by-k-by-n output tensor embed:
- *      embed[i, k_start:k_start+k_size, j] = vocab[:, index[i, j]]
+ *      embed[i, k_start:k_start+k_size, j] = vocab[:, index[i, j]-vocab_start]
+ *
+ * Tokens out of range [vocab_start, vocab_start+vocab_size), which belong to
+ * other shards of vocabulary, are skipped and their embeddings are not
+ * touched.
  *
  * @param[in] m: Size of the first mode of index and embed tensors
  * @param[in] n: Size of the last mode of index and embed tensors
  * @param[in] k: Size of the middle mode of embed tensor
  * @param[in] k_start: Offset of the middle mode of embed tensor
  * @param[in] k_size: Size of the first mode of vocab tensor
+ * @param[in] vocab_start: The first token of the vocab tensor
+ * @param[in] vocab_size: Size of the last mode of vocab tensor
  * @param[in] index: Tokens (indices of embeddings)
- * @param[in] vocab: Vocabulary of embeddings. It is a contiguous matrix of shape
- *      (k_size, vocab_size) but vocab_size is not passed as a parameter.
+ * @param[in] vocab: Vocabulary of embeddings. It is a contiguous matrix of
+ *      shape (k_size, vocab_size).
  * @param[inout] embed: Output tensor to be filled with embeddings
  * */
 {
+    // Row of vocabulary for a token or nullptr if it is not in the shard
+    auto vocab_row = [=](Index token) -> const T *
+    {
+        token -= vocab_start;
+        if(token < 0 or token >= vocab_size)
+        {
+            return nullptr;
+        }
+        return vocab + k_size*token;
+    };
+    // Every row of vocabulary is contiguous in the output, if m is 1
+    if(m == 1)
+    {
+        for(Index i2 = 0; i2 < n; ++i2)
+        {
+            // Prefetch the next row, as rows are scattered over vocabulary
+            if(i2+1 < n and vocab_row(index[i2+1]))
+            {
+                __builtin_prefetch(vocab_row(index[i2+1]));
+            }
+            const T *vocab_slice = vocab_row(index[i2]);
+            if(vocab_slice)
+            {
+                std::copy(vocab_slice, vocab_slice+k_size,
+                        embed + i2*k + k_start);
+            }
+        }
+        return;
+    }
+    // Tokens are gathered by blocks of consecutive rows of output buffer, so
+    // that every element of the middle axis of a block is written
+    // contiguously, while rows of vocabulary of the block are read
+    // sequentially
+    constexpr Index block_m = 16;
+    const T *vocab_slices[block_m];
+    Index ntokens = m * n;
     // Cycle over column of output buffer
     for(Index i2 = 0; i2 < n; ++i2)
     {
-        // Cycle over row of output buffer
-        for(Index i1 = 0; i1 < m; ++i1)
+        // Cycle over blocks of rows of output buffer
+        for(Index i1_start = 0; i1_start < m; i1_start += block_m)
         {
-            // Input slice of vocabulary
-            const T *vocab_slice = vocab + k_size*index[i2*m+i1];
+            Index i1_size = std::min(block_m, m-i1_start);
+            Index token = i2*m + i1_start;
+            bool full_block = true;
+            for(Index b = 0; b < i1_size; ++b)
+            {
+                // Input slice of vocabulary
+                vocab_slices[b] = vocab_row(index[token+b]);
+                full_block = full_block and vocab_slices[b];
+                // Prefetch a row of the next block of tokens
+                if(token+block_m+b < ntokens
+                        and vocab_row(index[token+block_m+b]))
+                {
+                    __builtin_prefetch(vocab_row(index[token+block_m+b]));
+                }
+            }
             // Output slice to be updated
-            T *embed_slice = embed + (i2*k+k_start)*m + i1;
-            // Cycle over slice over middle axis of output buffer
+            T *embed_slice = embed + (i2*k+k_start)*m + i1_start;
+            // Cycle over slice over middle axis of output buffer. Tokens of
+            // other shards are checked only if the block contains them.
             for(Index i0 = 0; i0 < k_size; ++i0)
             {
-                embed_slice[i0*m] = vocab_slice[i0];
+                T *embed_fiber = embed_slice + i0*m;
+                if(full_block)
+                {
+                    for(Index b = 0; b < i1_size; ++b)
+                    {
+                        embed_fiber[b] = vocab_slices[b][i0];
+                    }
+                }
+                else
+                {
+                    for(Index b = 0; b < i1_size; ++b)
+                    {
+                        if(vocab_slices[b])
+                        {
+                            embed_fiber[b] = vocab_slices[b][i0];
+                        }
+                    }
+                }
             }
         }
     }
@@ -62,12 +137,14 @@ void cpu(Index m, Index n, Index k, Index k_start, Index k_size,
 // Explicit instantiation
 template
 void cpu<fp32_t>(Index m, Index n, Index k, Index k_start, Index k_size,
-        const Index *index, const fp32_t *vocab, fp32_t *embed)
+        Index vocab_start, Index vocab_size, const Index *index,
+        const fp32_t *vocab, fp32_t *embed)
     noexcept;
 
 template
 void cpu<fp64_t>(Index m, Index n, Index k, Index k_start, Index k_size,
-        const Index *index, const fp64_t *vocab, fp64_t *embed)
+        Index vocab_start, Index vocab_size, const Index *index,
+        const fp64_t *vocab, fp64_t *embed)
     noexcept;
 
 } // namespace embedding
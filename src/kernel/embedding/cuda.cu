@@ -22,76 +22,146 @@ namespace kernel
 namespace embedding
 {
 
-template<typename T>
+template<typename T, int TILE>
 static __global__
 void cuda_kernel(Index m, Index n, Index k, Index k_start, Index k_size,
-        const Index *index, const T *vocab, T *embed)
+        Index vocab_start, Index vocab_size, const Index *index,
+        const T *vocab, T *embed)
 //! Fill embedding from vocabulary
 /*! Fill provided m-by-k-by-n output tensor embed:
- *      embed[i, k_start:k_start+k_size, j] = vocab[:, index[i, j]]
+ *      embed[i, k_start:k_start+k_size, j] = vocab[:, index[i, j]-vocab_start]
+ *
+ * A block of threads gathers TILE tokens and TILE elements of their
+ * embeddings. Rows of vocabulary are read into shared memory with
+ * consecutive threads reading consecutive elements of a row, and the tile
+ * is written transposed with consecutive threads writing consecutive
+ * tokens, so that both reads and writes are coalesced.
  *
  * @param[in] m: Size of the first mode of index and embed tensors
  * @param[in] n: Size of the last mode of index and embed tensors
  * @param[in] k: Size of the middle mode of embed tensor
  * @param[in] k_start: Offset of the middle mode of embed tensor
  * @param[in] k_size: Size of the first mode of vocab tensor
+ * @param[in] vocab_start: The first token of the vocab tensor
+ * @param[in] vocab_size: Size of the last mode of vocab tensor
  * @param[in] index: Tokens (indices of embeddings)
- * @param[in] vocab: Vocabulary of embeddings. It is a contiguous matrix of shape
- *      (k_size, vocab_size) but vocab_size is not passed as a parameter.
+ * @param[in] vocab: Vocabulary of embeddings. It is a contiguous matrix of
+ *      shape (k_size, vocab_size).
  * @param[inout] embed: Output tensor to be filled with embeddings
  * */
 {
-    Index i0 = threadIdx.x + blockIdx.x*blockDim.x,
-          i1 = threadIdx.y + blockIdx.y*blockDim.y,
-          i2 = threadIdx.z + blockIdx.z*blockDim.z;
-    if(i2 < k_size and i1 < n and i0 < m)
+    // Padding avoids bank conflicts of the transposed access
+    __shared__ T tile[TILE][TILE+1];
+    Index i2_start = Index(blockIdx.x) * TILE,
+          i0_start = Index(blockIdx.y) * TILE;
+    for(Index i1 = blockIdx.z; i1 < n; i1 += gridDim.z)
     {
-            // Input slice of vocabulary
-            const T *vocab_slice = vocab + k_size*index[i1*m+i0];
-            // Output value to be updated
-            embed[(i1*k+k_start+i2)*m + i0] = vocab_slice[i2];
+        // Read rows of vocabulary
+        for(int j = threadIdx.y; j < TILE; j += blockDim.y)
+        {
+            Index i2 = i2_start + threadIdx.x, i0 = i0_start + j;
+            if(i2 < k_size and i0 < m)
+            {
+                Index token = index[i1*m+i0] - vocab_start;
+                if(token >= 0 and token < vocab_size)
+                {
+                    tile[j][threadIdx.x] = vocab[k_size*token + i2];
+                }
+            }
+        }
+        __syncthreads();
+        // Write the transposed tile
+        for(int j = threadIdx.y; j < TILE; j += blockDim.y)
+        {
+            Index i2 = i2_start + j, i0 = i0_start + threadIdx.x;
+            Index token = (i0 < m) ? index[i1*m+i0]-vocab_start : -1;
+            if(i2 < k_size and token >= 0 and token < vocab_size)
+            {
+                embed[(i1*k+k_start+i2)*m + i0] = tile[threadIdx.x][j];
+            }
+        }
+        __syncthreads();
+    }
+}
+
+template<typename T>
+static __global__
+void cuda_kernel_rows(Index n, Index k, Index k_start, Index k_size,
+        Index vocab_start, Index vocab_size, const Index *index,
+        const T *vocab, T *embed)
+//! Fill embedding from vocabulary, if m is 1
+/*! Rows of vocabulary are contiguous in the output, so they are copied by
+ * consecutive threads.
+ * */
+{
+    for(Index i1 = blockIdx.x; i1 < n; i1 += gridDim.x)
+    {
+        Index token = index[i1] - vocab_start;
+        if(token < 0 or token >= vocab_size)
+        {
+            continue;
+        }
+        const T *vocab_slice = vocab + k_size*token;
+        T *embed_slice = embed + i1*k + k_start;
+        for(Index i2 = threadIdx.x; i2 < k_size; i2 += blockDim.x)
+        {
+            embed_slice[i2] = vocab_slice[i2];
+        }
     }
 }
 
 template<typename T>
 void cuda(cudaStream_t stream, Index m, Index n, Index k, Index k_start,
-        Index k_size, const Index *index, const T *vocab, T *embed)
+        Index k_size, Index vocab_start, Index vocab_size,
+        const Index *index, const T *vocab, T *embed)
     noexcept
 //! Fill embedding from vocabulary
 /*! Fill provided m-by-k-by-n output tensor embed:
- *      embed[i, k_start:k_start+k_size, j] = vocab[:, index[i, j]]
+ *      embed[i, k_start:k_start+k_size, j] = vocab[:, index[i, j]-vocab_start]
+ *
+ * Tokens of other shards of vocabulary are skipped.
  *
  * @param[in] m: Size of the first mode of index and embed tensors
  * @param[in] n: Size of the last mode of index and embed tensors
  * @param[in] k: Size of the middle mode of embed tensor
  * @param[in] k_start: Offset of the middle mode of embed tensor
  * @param[in] k_size: Size of the first mode of vocab tensor
+ * @param[in] vocab_start: The first token of the vocab tensor
+ * @param[in] vocab_size: Size of the last mode of vocab tensor
  * @param[in] index: Tokens (indices of embeddings)
- * @param[in] vocab: Vocabulary of embeddings. It is a contiguous matrix of shape
- *      (k_size, vocab_size) but vocab_size is not passed as a parameter.
+ * @param[in] vocab: Vocabulary of embeddings. It is a contiguous matrix of
+ *      shape (k_size, vocab_size).
  * @param[inout] embed: Output tensor to be filled with embeddings
  * */
 {
     // Both source and destination are Fortran-contiguous
-    dim3 threads(std::min(int(m), 8), std::min(int(n), 8),
-            std::min(int(k_size), 16));
-    dim3 blocks((m+threads.x-1)/threads.x, (n+threads.y-1)/threads.y,
-            (k_size+threads.z-1)/threads.z);
-    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, n, k, k_start, k_size,
-            index, vocab, embed);
+    if(m == 1)
+    {
+        dim3 threads(std::min(int(k_size), 256));
+        dim3 blocks(std::min(n, Index(65535)));
+        (cuda_kernel_rows<T>)<<<blocks, threads, 0, stream>>>(n, k, k_start,
+                k_size, vocab_start, vocab_size, index, vocab, embed);
+        return;
+    }
+    constexpr int TILE = 32;
+    dim3 threads(TILE, 8);
+    dim3 blocks((k_size+TILE-1)/TILE, (m+TILE-1)/TILE,
+            std::min(n, Index(65535)));
+    (cuda_kernel<T, TILE>)<<<blocks, threads, 0, stream>>>(m, n, k, k_start,
+            k_size, vocab_start, vocab_size, index, vocab, embed);
 }
 
 // Explicit instantiation
 template
 void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k,
-        Index k_start, Index k_size, const Index *index, const fp32_t *vocab,
-        fp32_t *embed)
+        Index k_start, Index k_size, Index vocab_start, Index vocab_size,
+        const Index *index, const fp32_t *vocab, fp32_t *embed)
     noexcept;
 
 template
 void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k,
-        Index k_start, Index k_size, const Index *index, const fp64_t *vocab,
-        fp64_t *embed)
+        Index k_start, Index k_size, Index vocab_start, Index vocab_size,
+        const Index *index, const fp64_t *vocab, fp64_t *embed)
     noexcept;
 
 } // namespace embedding
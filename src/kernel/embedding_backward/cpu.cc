@@ -9,10 +9,11 @@
  *
  * @version 1.0.0
  * @author Aleksandr Mikhalev
- * @date 2023-04-21
+ * @date 2024-02-12
  * */
 
 #include "nntile/kernel/embedding_backward/cpu.hh"
+#include <algorithm>
 
 namespace nntile
 {
@@ -23,31 +24,65 @@ namespace embedding_backward
 
 template<typename T>
 void cpu(Index m, Index n, Index k, Index k_start, Index k_size,
-        const Index *index, const T *embed, T *vocab)
+        Index vocab_start, Index vocab_size, const Index *index,
+        const T *embed, T *vocab, Index *tmp)
     noexcept
 //! Accumulate gradients of embeddings into vocabulary
 /*! Does the following operation:
- *      vocab[:, index[i, j]] += embed[i, k_start:k_start+k_size, j]
+ *      vocab[:, index[i, j]-vocab_start] +=
+ *          embed[i, k_start:k_start+k_size, j]
+ *
+ * Positions of tokens are sorted by tokens (and by positions for the same
+ * token), so that each column of vocab is updated by all its tokens at once
+ * in a deterministic order, instead of scattered updates of the whole
+ * vocab. Tokens out of range [vocab_start, vocab_start+vocab_size), which
+ * belong to other shards of vocabulary, are skipped.
  *
  * @param[in] m: Size of the first mode of index and embed tensors
  * @param[in] n: Size of the last mode of index and embed tensors
  * @param[in] k: Size of the middle mode of embed tensor
  * @param[in] k_start: Offset of the middle mode of embed tensor
  * @param[in] k_size: Size of the first mode of vocab tensor
+ * @param[in] vocab_start: The first token of the vocab tensor
+ * @param[in] vocab_size: Size of the last mode of vocab tensor
  * @param[in] index: Tokens (indices of embeddings)
  * @param[out] embed: Tensor of gradients of embeddings
  * @param[inout] vocab: Gradient of vocabulary. It is a contiguous matrix of
- *      shape (k_size, vocab_size) but vocab_size is not passed as a parameter.
+ *      shape (k_size, vocab_size).
+ * @param[scratch] tmp: Buffer for m*n sorted positions of tokens
  * */
 {
-    // Cycle over column of embed buffer
-    for(Index i2 = 0; i2 < n; ++i2)
+    Index ntokens = m * n;
+    for(Index i = 0; i < ntokens; ++i)
+    {
+        tmp[i] = i;
+    }
+    std::sort(tmp, tmp+ntokens, [index](Index a, Index b)
+            {
+                return index[a] < index[b]
+                    or (index[a] == index[b] and a < b);
+            });
+    // Cycle over segments of the same token
+    for(Index seg_start = 0, seg_end; seg_start < ntokens;
+            seg_start = seg_end)
     {
-        // Cycle over row of embed buffer
-        for(Index i1 = 0; i1 < m; ++i1)
+        Index token = index[tmp[seg_start]];
+        seg_end = seg_start + 1;
+        while(seg_end < ntokens and index[tmp[seg_end]] == token)
+        {
+            ++seg_end;
+        }
+        // Skip tokens of other shards
+        if(token < vocab_start or token >= vocab_start+vocab_size)
+        {
+            continue;
+        }
+        // Output slice of vocabulary
+        T *vocab_slice = vocab + k_size*(token-vocab_start);
+        // Cycle over all positions of the token
+        for(Index i = seg_start; i < seg_end; ++i)
         {
-            // Output slice of vocabulary
-            T *vocab_slice = vocab + k_size*index[i2*m+i1];
+            Index i1 = tmp[i] % m, i2 = tmp[i] / m;
             // Input slice of embedding
             const T *embed_slice = embed + (i2*k+k_start)*m + i1;
             // Cycle over slice of output vocab
@@ -62,12 +97,14 @@ void cpu(Index m, Index n, Index k, Index k_start, Index k_size,
 // Explicit instantiation
 template
 void cpu<fp32_t>(Index m, Index n, Index k, Index k_start, Index k_size,
-        const Index *index, const fp32_t *embed, fp32_t *vocab)
+        Index vocab_start, Index vocab_size, const Index *index,
+        const fp32_t *embed, fp32_t *vocab, Index *tmp)
     noexcept;
 
 template
 void cpu<fp64_t>(Index m, Index n, Index k, Index k_start, Index k_size,
-        const Index *index, const fp64_t *embed, fp64_t *vocab)
+        Index vocab_start, Index vocab_size, const Index *index,
+        const fp64_t *embed, fp64_t *vocab, Index *tmp)
     noexcept;
 
 } // namespace embedding_backward
@@ -9,7 +9,7 @@
  *
  * @version 1.0.0
  * @author Aleksandr Mikhalev
- * @date 2023-07-02
+ * @date 2024-02-12
  * */
 
 #include "nntile/kernel/embedding_backward/cuda.hh"
@@ -21,73 +21,129 @@ namespace kernel
 namespace embedding_backward
 {
 
+static constexpr int BLOCK = 256;
+
+static __global__
+void cuda_sort_kernel(Index ntokens, const Index *index, Index *tmp)
+//! Sort positions of tokens by tokens and positions
+/*! Rank of each position is a number of positions with smaller (token,
+ * position) pairs. Tokens are loaded by chunks into shared memory.
+ * */
+{
+    __shared__ Index chunk[BLOCK];
+    Index i = threadIdx.x + blockIdx.x*Index(blockDim.x);
+    Index token = (i < ntokens) ? index[i] : 0;
+    Index rank = 0;
+    for(Index chunk_start = 0; chunk_start < ntokens; chunk_start += BLOCK)
+    {
+        Index j = chunk_start + threadIdx.x;
+        if(j < ntokens)
+        {
+            chunk[threadIdx.x] = index[j];
+        }
+        __syncthreads();
+        Index chunk_size = ::min(Index(BLOCK), ntokens-chunk_start);
+        for(Index jj = 0; jj < chunk_size; ++jj)
+        {
+            Index other = chunk[jj];
+            rank += (other < token)
+                or (other == token and chunk_start+jj < i);
+        }
+        __syncthreads();
+    }
+    if(i < ntokens)
+    {
+        tmp[rank] = i;
+    }
+}
+
 template<typename T>
 static __global__
-void cuda_kernel(Index m, Index n, Index k, Index k_start, Index k_size,
-        const Index *index, const T *embed, T *vocab)
-//! Accumulate gradients of embeddings into vocabulary
-/*! Does the following operation:
- *      vocab[:, index[i, j]] += embed[i, k_start:k_start+k_size, j]
- *
- * @param[in] m: Size of the first mode of index and embed tensors
- * @param[in] n: Size of the last mode of index and embed tensors
- * @param[in] k: Size of the middle mode of embed tensor
- * @param[in] k_start: Offset of the middle mode of embed tensor
- * @param[in] k_size: Size of the first mode of vocab tensor
- * @param[in] index: Tokens (indices of embeddings)
- * @param[out] embed: Tensor of gradients of embeddings
- * @param[inout] vocab: Gradient of vocabulary. It is a contiguous matrix of
- *      shape (k_size, vocab_size) but vocab_size is not passed as a parameter.
+void cuda_kernel(Index m, Index k, Index k_start, Index k_size,
+        Index vocab_start, Index vocab_size, Index ntokens,
+        const Index *index, const T *embed, T *vocab, const Index *tmp)
+//! Accumulate gradients of embeddings for a segment of the same token
+/*! Only the first sorted position of each token does the work, so that each
+ * column of vocab is updated exactly once without atomics. Tokens of other
+ * shards of vocabulary are skipped.
  * */
 {
-    Index i2 = threadIdx.x + blockIdx.x*blockDim.x;
-    Index i0 = blockIdx.y, i1 = blockIdx.z;
-    if(i2 < k_size)
+    Index i = blockIdx.x;
+    Index i0 = threadIdx.x + blockIdx.y*Index(blockDim.x);
+    if(i0 >= k_size)
     {
-        // Output slice of vocabulary
-        T *vocab_slice = vocab + k_size*index[i1*m+i0];
-        // Update value of embedding
-        atomicAdd(&vocab_slice[i2], embed[(i1*k+k_start+i2)*m + i0]);
+        return;
     }
+    Index token = index[tmp[i]];
+    if(i > 0 and index[tmp[i-1]] == token)
+    {
+        return;
+    }
+    if(token < vocab_start or token >= vocab_start+vocab_size)
+    {
+        return;
+    }
+    T sum = 0;
+    for(; i < ntokens and index[tmp[i]] == token; ++i)
+    {
+        Index i1 = tmp[i] % m, i2 = tmp[i] / m;
+        sum += embed[(i2*k+k_start+i0)*m + i1];
+    }
+    vocab[k_size*(token-vocab_start)+i0] += sum;
 }
 
 template<typename T>
 void cuda(cudaStream_t stream, Index m, Index n, Index k, Index k_start,
-        Index k_size, const Index *index, const T *embed, T *vocab)
+        Index k_size, Index vocab_start, Index vocab_size,
+        const Index *index, const T *embed, T *vocab, Index *tmp)
     noexcept
 //! Accumulate gradients of embeddings into vocabulary
 /*! Does the following operation:
- *      vocab[:, index[i, j]] += embed[i, k_start:k_start+k_size, j]
+ *      vocab[:, index[i, j]-vocab_start] +=
+ *          embed[i, k_start:k_start+k_size, j]
+ *
+ * Positions of tokens are sorted at first, then gradients of the same token
+ * are reduced and each column of vocab is written once. It is deterministic
+ * and does not need atomic operations. Tokens of other shards of vocabulary
+ * are skipped.
  *
  * @param[in] m: Size of the first mode of index and embed tensors
  * @param[in] n: Size of the last mode of index and embed tensors
  * @param[in] k: Size of the middle mode of embed tensor
  * @param[in] k_start: Offset of the middle mode of embed tensor
  * @param[in] k_size: Size of the first mode of vocab tensor
+ * @param[in] vocab_start: The first token of the vocab tensor
+ * @param[in] vocab_size: Size of the last mode of vocab tensor
  * @param[in] index: Tokens (indices of embeddings)
  * @param[out] embed: Tensor of gradients of embeddings
  * @param[inout] vocab: Gradient of vocabulary. It is a contiguous matrix of
- *      shape (k_size, vocab_size) but vocab_size is not passed as a parameter.
+ *      shape (k_size, vocab_size).
+ * @param[scratch] tmp: Buffer for m*n sorted positions of tokens
  * */
 {
+    Index ntokens = m * n;
+    dim3 threads_sort(BLOCK, 1, 1);
+    dim3 blocks_sort((ntokens+BLOCK-1)/BLOCK, 1, 1);
+    (cuda_sort_kernel)<<<blocks_sort, threads_sort, 0, stream>>>(ntokens,
+            index, tmp);
     // Both source and destination are Fortran-contiguous
-    dim3 threads(256, 1, 1);
-    dim3 blocks((k_size+255)/256, m, n);
-    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, n, k, k_start, k_size,
-            index, embed, vocab);
+    dim3 threads(BLOCK, 1, 1);
+    dim3 blocks(ntokens, (k_size+BLOCK-1)/BLOCK, 1);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, k, k_start, k_size,
+            vocab_start, vocab_size, ntokens, index, embed, vocab, tmp);
 }
 
 // Explicit instantiation
 template
 void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k,
-        Index k_start, Index k_size, const Index *index, const fp32_t *embed,
-        fp32_t *vocab)
+        Index k_start, Index k_size, Index vocab_start, Index vocab_size,
+        const Index *index, const fp32_t *embed, fp32_t *vocab, Index *tmp)
     noexcept;
 
 template
 void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k,
-        Index k_start, Index k_size, const Index *index, const fp64_t *embed,
-        fp64_t *vocab)
+        Index k_start, Index k_size, Index vocab_start, Index vocab_size,
+        const Index *index, const fp64_t *embed, fp64_t *vocab, Index *tmp)
     noexcept;
 
 } // namespace embedding_backward
@@ -0,0 +1,90 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/embedding_pos/cpu.cc
+ * Embeddings of tokens and positions on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/embedding_pos/cpu.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace embedding_pos
+{
+
+template<typename T>
+void cpu(Index m, Index n, Index k, Index k_start, Index k_size,
+        Index pos_size, const Index *index, const Index *pos, const T *vocab,
+        const T *pos_vocab, T *embed)
+    noexcept
+//! Fill embedding from vocabulary and add positional embedding
+/*! Fill provided m-by-k-by-n output tensor embed:
+ *      embed[i, k_start:k_start+k_size, j] = vocab[:, index[i, j]]
+ *          + pos_vocab[:, pos[(i+j*m) % pos_size]]
+ *
+ * Positions are repeated over the trailing modes of index, e.g., the same
+ * positions of a sequence are used by all sequences of a batch, so the
+ * broadcast over the batch happens here and not in a separate pass.
+ *
+ * @param[in] m: Size of the first mode of index and embed tensors
+ * @param[in] n: Size of the last mode of index and embed tensors
+ * @param[in] k: Size of the middle mode of embed tensor
+ * @param[in] k_start: Offset of the middle mode of embed tensor
+ * @param[in] k_size: Size of the first mode of vocab and pos_vocab tensors
+ * @param[in] pos_size: Number of positions, that divides m*n
+ * @param[in] index: Tokens (indices of embeddings)
+ * @param[in] pos: Positions (indices of positional embeddings)
+ * @param[in] vocab: Vocabulary of embeddings. It is a contiguous matrix of
+ *      shape (k_size, vocab_size) but vocab_size is not passed as a parameter.
+ * @param[in] pos_vocab: Positional embeddings. It is a contiguous matrix of
+ *      shape (k_size, max_positions).
+ * @param[out] embed: Output tensor to be filled with embeddings
+ * */
+{
+    // Cycle over column of output buffer
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        // Cycle over row of output buffer
+        for(Index i1 = 0; i1 < m; ++i1)
+        {
+            Index token = i2*m + i1;
+            // Input slices of vocabulary and positional embeddings
+            const T *vocab_slice = vocab + k_size*index[token];
+            const T *pos_slice = pos_vocab + k_size*pos[token%pos_size];
+            // Output slice to be updated
+            T *embed_slice = embed + (i2*k+k_start)*m + i1;
+            // Cycle over slice over middle axis of output buffer
+            for(Index i0 = 0; i0 < k_size; ++i0)
+            {
+                embed_slice[i0*m] = vocab_slice[i0] + pos_slice[i0];
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, Index k_start, Index k_size,
+        Index pos_size, const Index *index, const Index *pos,
+        const fp32_t *vocab, const fp32_t *pos_vocab, fp32_t *embed)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, Index k_start, Index k_size,
+        Index pos_size, const Index *index, const Index *pos,
+        const fp64_t *vocab, const fp64_t *pos_vocab, fp64_t *embed)
+    noexcept;
+
+} // namespace embedding_pos
+} // namespace kernel
+} // namespace nntile
+
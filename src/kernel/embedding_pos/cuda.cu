@@ -0,0 +1,94 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/embedding_pos/cuda.cu
+ * Embeddings of tokens and positions on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/embedding_pos/cuda.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace embedding_pos
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, Index n, Index k, Index k_start, Index k_size,
+        Index pos_size, const Index *index, const Index *pos, const T *vocab,
+        const T *pos_vocab, T *embed)
+{
+    Index i0 = threadIdx.x + blockIdx.x*blockDim.x,
+          i1 = threadIdx.y + blockIdx.y*blockDim.y,
+          i2 = threadIdx.z + blockIdx.z*blockDim.z;
+    if(i2 < k_size and i1 < n and i0 < m)
+    {
+        Index token = i1*m + i0;
+        embed[(i1*k+k_start+i2)*m + i0] = vocab[k_size*index[token]+i2]
+            + pos_vocab[k_size*pos[token%pos_size]+i2];
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, Index k_start,
+        Index k_size, Index pos_size, const Index *index, const Index *pos,
+        const T *vocab, const T *pos_vocab, T *embed)
+    noexcept
+//! Fill embedding from vocabulary and add positional embedding
+/*! Fill provided m-by-k-by-n output tensor embed:
+ *      embed[i, k_start:k_start+k_size, j] = vocab[:, index[i, j]]
+ *          + pos_vocab[:, pos[(i+j*m) % pos_size]]
+ *
+ * @param[in] m: Size of the first mode of index and embed tensors
+ * @param[in] n: Size of the last mode of index and embed tensors
+ * @param[in] k: Size of the middle mode of embed tensor
+ * @param[in] k_start: Offset of the middle mode of embed tensor
+ * @param[in] k_size: Size of the first mode of vocab and pos_vocab tensors
+ * @param[in] pos_size: Number of positions, that divides m*n
+ * @param[in] index: Tokens (indices of embeddings)
+ * @param[in] pos: Positions (indices of positional embeddings)
+ * @param[in] vocab: Vocabulary of embeddings. It is a contiguous matrix of
+ *      shape (k_size, vocab_size) but vocab_size is not passed as a parameter.
+ * @param[in] pos_vocab: Positional embeddings. It is a contiguous matrix of
+ *      shape (k_size, max_positions).
+ * @param[out] embed: Output tensor to be filled with embeddings
+ * */
+{
+    // Both source and destination are Fortran-contiguous
+    dim3 threads(std::min(int(m), 8), std::min(int(n), 8),
+            std::min(int(k_size), 16));
+    dim3 blocks((m+threads.x-1)/threads.x, (n+threads.y-1)/threads.y,
+            (k_size+threads.z-1)/threads.z);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, n, k, k_start, k_size,
+            pos_size, index, pos, vocab, pos_vocab, embed);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k,
+        Index k_start, Index k_size, Index pos_size, const Index *index,
+        const Index *pos, const fp32_t *vocab, const fp32_t *pos_vocab,
+        fp32_t *embed)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k,
+        Index k_start, Index k_size, Index pos_size, const Index *index,
+        const Index *pos, const fp64_t *vocab, const fp64_t *pos_vocab,
+        fp64_t *embed)
+    noexcept;
+
+} // namespace embedding_pos
+} // namespace kernel
+} // namespace nntile
+
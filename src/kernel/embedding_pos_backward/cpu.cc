@@ -0,0 +1,114 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/embedding_pos_backward/cpu.cc
+ * Backward of embeddings of tokens and positions on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/embedding_pos_backward/cpu.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace embedding_pos_backward
+{
+
+template<typename T>
+void cpu(Index m, Index n, Index k, Index k_start, Index k_size,
+        Index pos_size, const Index *index, const Index *pos, const T *embed,
+        T *vocab, T *pos_vocab, Index *tmp)
+    noexcept
+//! Accumulate gradients of embeddings into vocabulary and positions
+/*! Does the following operation:
+ *      vocab[:, index[i, j]] += embed[i, k_start:k_start+k_size, j]
+ *      pos_vocab[:, pos[(i+j*m) % pos_size]] +=
+ *          embed[i, k_start:k_start+k_size, j]
+ *
+ * Positions of tokens are sorted by tokens as in embedding_backward, and
+ * gradient of each token is read once and added into both tables. Order of
+ * updates of positional embeddings is defined by the sort, so the result is
+ * deterministic.
+ *
+ * @param[in] m: Size of the first mode of index and embed tensors
+ * @param[in] n: Size of the last mode of index and embed tensors
+ * @param[in] k: Size of the middle mode of embed tensor
+ * @param[in] k_start: Offset of the middle mode of embed tensor
+ * @param[in] k_size: Size of the first mode of vocab and pos_vocab tensors
+ * @param[in] pos_size: Number of positions, that divides m*n
+ * @param[in] index: Tokens (indices of embeddings)
+ * @param[in] pos: Positions (indices of positional embeddings)
+ * @param[in] embed: Tensor of gradients of embeddings
+ * @param[inout] vocab: Gradient of vocabulary. It is a contiguous matrix of
+ *      shape (k_size, vocab_size) but vocab_size is not passed as a parameter.
+ * @param[inout] pos_vocab: Gradient of positional embeddings. It is a
+ *      contiguous matrix of shape (k_size, max_positions).
+ * @param[scratch] tmp: Buffer for m*n+pos_size indices
+ * */
+{
+    Index ntokens = m * n;
+    for(Index i = 0; i < ntokens; ++i)
+    {
+        tmp[i] = i;
+    }
+    std::sort(tmp, tmp+ntokens, [index](Index a, Index b)
+            {
+                return index[a] < index[b]
+                    or (index[a] == index[b] and a < b);
+            });
+    // Cycle over segments of the same token
+    for(Index seg_start = 0, seg_end; seg_start < ntokens;
+            seg_start = seg_end)
+    {
+        Index token = index[tmp[seg_start]];
+        seg_end = seg_start + 1;
+        while(seg_end < ntokens and index[tmp[seg_end]] == token)
+        {
+            ++seg_end;
+        }
+        // Output slice of vocabulary
+        T *vocab_slice = vocab + k_size*token;
+        // Cycle over all positions of the token
+        for(Index i = seg_start; i < seg_end; ++i)
+        {
+            Index i1 = tmp[i] % m, i2 = tmp[i] / m;
+            // Input slice of embedding
+            const T *embed_slice = embed + (i2*k+k_start)*m + i1;
+            // Output slice of positional embeddings
+            T *pos_slice = pos_vocab + k_size*pos[tmp[i]%pos_size];
+            // Cycle over slices of outputs
+            for(Index i0 = 0; i0 < k_size; ++i0)
+            {
+                T val = embed_slice[i0*m];
+                vocab_slice[i0] += val;
+                pos_slice[i0] += val;
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, Index k_start, Index k_size,
+        Index pos_size, const Index *index, const Index *pos,
+        const fp32_t *embed, fp32_t *vocab, fp32_t *pos_vocab, Index *tmp)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, Index k_start, Index k_size,
+        Index pos_size, const Index *index, const Index *pos,
+        const fp64_t *embed, fp64_t *vocab, fp64_t *pos_vocab, Index *tmp)
+    noexcept;
+
+} // namespace embedding_pos_backward
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,180 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/embedding_pos_backward/cuda.cu
+ * Backward of embeddings of tokens and positions on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/embedding_pos_backward/cuda.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace embedding_pos_backward
+{
+
+static constexpr int BLOCK = 256;
+
+static __global__
+void cuda_sort_kernel(Index nelems, const Index *index, Index *tmp)
+//! Sort positions of indices by indices and positions
+/*! Rank of each position is a number of positions with smaller (index,
+ * position) pairs. Indices are loaded by chunks into shared memory.
+ * */
+{
+    __shared__ Index chunk[BLOCK];
+    Index i = threadIdx.x + blockIdx.x*Index(blockDim.x);
+    Index token = (i < nelems) ? index[i] : 0;
+    Index rank = 0;
+    for(Index chunk_start = 0; chunk_start < nelems; chunk_start += BLOCK)
+    {
+        Index j = chunk_start + threadIdx.x;
+        if(j < nelems)
+        {
+            chunk[threadIdx.x] = index[j];
+        }
+        __syncthreads();
+        Index chunk_size = ::min(Index(BLOCK), nelems-chunk_start);
+        for(Index jj = 0; jj < chunk_size; ++jj)
+        {
+            Index other = chunk[jj];
+            rank += (other < token)
+                or (other == token and chunk_start+jj < i);
+        }
+        __syncthreads();
+    }
+    if(i < nelems)
+    {
+        tmp[rank] = i;
+    }
+}
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, Index k, Index k_start, Index k_size,
+        Index ntokens, Index pos_size, const Index *index, const Index *pos,
+        const T *embed, T *vocab, T *pos_vocab, const Index *tmp)
+//! Accumulate gradients for a segment of the same token or position
+/*! Blocks along the first grid dimension take sorted tokens, other blocks
+ * take sorted positions. Only the first sorted entry of each token or
+ * position does the work, so that each column of output is updated exactly
+ * once without atomics. Every position is shared by ntokens/pos_size
+ * tokens.
+ * */
+{
+    Index i = blockIdx.x;
+    Index i0 = threadIdx.x + blockIdx.y*Index(blockDim.x);
+    if(i0 >= k_size)
+    {
+        return;
+    }
+    T sum = 0;
+    if(i < ntokens)
+    {
+        Index token = index[tmp[i]];
+        if(i > 0 and index[tmp[i-1]] == token)
+        {
+            return;
+        }
+        for(; i < ntokens and index[tmp[i]] == token; ++i)
+        {
+            Index i1 = tmp[i] % m, i2 = tmp[i] / m;
+            sum += embed[(i2*k+k_start+i0)*m + i1];
+        }
+        vocab[k_size*token+i0] += sum;
+    }
+    else
+    {
+        const Index *pos_tmp = tmp + ntokens;
+        i -= ntokens;
+        Index p = pos[pos_tmp[i]];
+        if(i > 0 and pos[pos_tmp[i-1]] == p)
+        {
+            return;
+        }
+        for(; i < pos_size and pos[pos_tmp[i]] == p; ++i)
+        {
+            for(Index t = pos_tmp[i]; t < ntokens; t += pos_size)
+            {
+                Index i1 = t % m, i2 = t / m;
+                sum += embed[(i2*k+k_start+i0)*m + i1];
+            }
+        }
+        pos_vocab[k_size*p+i0] += sum;
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, Index k_start,
+        Index k_size, Index pos_size, const Index *index, const Index *pos,
+        const T *embed, T *vocab, T *pos_vocab, Index *tmp)
+    noexcept
+//! Accumulate gradients of embeddings into vocabulary and positions
+/*! Does the following operation:
+ *      vocab[:, index[i, j]] += embed[i, k_start:k_start+k_size, j]
+ *      pos_vocab[:, pos[(i+j*m) % pos_size]] +=
+ *          embed[i, k_start:k_start+k_size, j]
+ *
+ * Tokens and positions are sorted at first, then gradients of the same
+ * token or position are reduced and each column of outputs is written once
+ * by a single launch. It is deterministic and does not need atomic
+ * operations.
+ *
+ * @param[in] m: Size of the first mode of index and embed tensors
+ * @param[in] n: Size of the last mode of index and embed tensors
+ * @param[in] k: Size of the middle mode of embed tensor
+ * @param[in] k_start: Offset of the middle mode of embed tensor
+ * @param[in] k_size: Size of the first mode of vocab and pos_vocab tensors
+ * @param[in] pos_size: Number of positions, that divides m*n
+ * @param[in] index: Tokens (indices of embeddings)
+ * @param[in] pos: Positions (indices of positional embeddings)
+ * @param[in] embed: Tensor of gradients of embeddings
+ * @param[inout] vocab: Gradient of vocabulary. It is a contiguous matrix of
+ *      shape (k_size, vocab_size) but vocab_size is not passed as a parameter.
+ * @param[inout] pos_vocab: Gradient of positional embeddings. It is a
+ *      contiguous matrix of shape (k_size, max_positions).
+ * @param[scratch] tmp: Buffer for m*n+pos_size indices
+ * */
+{
+    Index ntokens = m * n;
+    dim3 threads_sort(BLOCK, 1, 1);
+    dim3 blocks_sort((ntokens+BLOCK-1)/BLOCK, 1, 1);
+    (cuda_sort_kernel)<<<blocks_sort, threads_sort, 0, stream>>>(ntokens,
+            index, tmp);
+    dim3 blocks_sort_pos((pos_size+BLOCK-1)/BLOCK, 1, 1);
+    (cuda_sort_kernel)<<<blocks_sort_pos, threads_sort, 0, stream>>>(
+            pos_size, pos, tmp+ntokens);
+    // Both source and destination are Fortran-contiguous
+    dim3 threads(BLOCK, 1, 1);
+    dim3 blocks(ntokens+pos_size, (k_size+BLOCK-1)/BLOCK, 1);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, k, k_start, k_size,
+            ntokens, pos_size, index, pos, embed, vocab, pos_vocab, tmp);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k,
+        Index k_start, Index k_size, Index pos_size, const Index *index,
+        const Index *pos, const fp32_t *embed, fp32_t *vocab,
+        fp32_t *pos_vocab, Index *tmp)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k,
+        Index k_start, Index k_size, Index pos_size, const Index *index,
+        const Index *pos, const fp64_t *embed, fp64_t *vocab,
+        fp64_t *pos_vocab, Index *tmp)
+    noexcept;
+
+} // namespace embedding_pos_backward
+} // namespace kernel
+} // namespace nntile
+
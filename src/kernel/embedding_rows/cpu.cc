@@ -0,0 +1,47 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/embedding_rows/cpu.cc
+ * Mark rows of vocabulary, used by tokens, on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-13
+ * */
+
+#include "nntile/kernel/embedding_rows/cpu.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace embedding_rows
+{
+
+void cpu(Index ntokens, const Index *index, bool_t *rows)
+    noexcept
+//! Mark rows of vocabulary, used by tokens, on CPU
+/*! Does the following operation:
+ *      rows[index[i]] = true
+ *
+ * Rows, that are not used by any token, are not changed, so that the mask
+ * accumulates over several calls until it is cleared.
+ *
+ * @params[in] ntokens: Number of tokens
+ * @params[in] index: Tokens (indices of rows of vocabulary)
+ * @params[inout] rows: Mask of used rows of vocabulary
+ * */
+{
+    for(Index i = 0; i < ntokens; ++i)
+    {
+        rows[index[i]] = bool_t(true);
+    }
+}
+
+} // namespace embedding_rows
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,56 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/embedding_rows/cuda.cu
+ * Mark rows of vocabulary, used by tokens, on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-13
+ * */
+
+#include "nntile/kernel/embedding_rows/cuda.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace embedding_rows
+{
+
+static __global__
+void cuda_kernel(Index ntokens, const Index *index, bool_t *rows)
+{
+    Index i = threadIdx.x + blockIdx.x*blockDim.x;
+    if(i < ntokens)
+    {
+        rows[index[i]] = bool_t(true);
+    }
+}
+
+void cuda(cudaStream_t stream, Index ntokens, const Index *index,
+        bool_t *rows)
+    noexcept
+//! Mark rows of vocabulary, used by tokens, on CUDA
+/*! Does the following operation:
+ *      rows[index[i]] = true
+ *
+ * Rows, that are not used by any token, are not changed, so that the mask
+ * accumulates over several calls until it is cleared.
+ *
+ * @params[in] ntokens: Number of tokens
+ * @params[in] index: Tokens (indices of rows of vocabulary)
+ * @params[inout] rows: Mask of used rows of vocabulary
+ * */
+{
+    dim3 blocks((ntokens+255)/256), threads(256);
+    (cuda_kernel)<<<blocks, threads, 0, stream>>>(ntokens, index, rows);
+}
+
+} // namespace embedding_rows
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,67 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/fill_padding/cpu.cc
+ * Fill padding of a tile beyond a logical extent along an axis on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/fill_padding/cpu.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace fill_padding
+{
+
+template<typename T>
+void cpu(Index m, Index n, Index k, Index k_start, T val, T *data)
+    noexcept
+//! Fill padding of a tile along an axis on CPU
+/*! Data is viewed as an array of shape [m,k,n]. Elements with an index
+ * along the middle axis of at least k_start, that are beyond a logical
+ * extent of a padded tensor, are set to the provided value.
+ *
+ * @param[in] m: Size of the first mode of data
+ * @param[in] n: Size of the last mode of data
+ * @param[in] k: Size of the middle mode of data
+ * @param[in] k_start: Start of padding along the middle mode
+ * @param[in] val: Value of padding
+ * @param[inout] data: Input buffer, which padding is overwritten
+ * */
+{
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i1 = k_start; i1 < k; ++i1)
+        {
+            T *dst = data + (i2*k+i1)*m;
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                dst[i0] = val;
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, Index k_start, fp32_t val,
+        fp32_t *data)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, Index k_start, fp64_t val,
+        fp64_t *data)
+    noexcept;
+
+} // namespace fill_padding
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,74 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/fill_padding/cuda.cu
+ * Fill padding of a tile beyond a logical extent along an axis on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/fill_padding/cuda.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace fill_padding
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, Index n, Index k, Index k_start, T val, T *data)
+{
+    Index i = threadIdx.x + blockIdx.x*blockDim.x;
+    Index k_pad = k - k_start;
+    if(i < m*k_pad*n)
+    {
+        Index i0 = i % m, i1 = i / m % k_pad + k_start, i2 = i / (m*k_pad);
+        data[(i2*k+i1)*m+i0] = val;
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, Index k_start,
+        T val, T *data)
+    noexcept
+//! Fill padding of a tile along an axis on CUDA
+/*! Data is viewed as an array of shape [m,k,n]. Elements with an index
+ * along the middle axis of at least k_start, that are beyond a logical
+ * extent of a padded tensor, are set to the provided value.
+ *
+ * @param[in] m: Size of the first mode of data
+ * @param[in] n: Size of the last mode of data
+ * @param[in] k: Size of the middle mode of data
+ * @param[in] k_start: Start of padding along the middle mode
+ * @param[in] val: Value of padding
+ * @param[inout] data: Input buffer, which padding is overwritten
+ * */
+{
+    Index nelems = m * (k-k_start) * n;
+    dim3 blocks((nelems+255)/256), threads(256);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, n, k, k_start, val,
+            data);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k,
+        Index k_start, fp32_t val, fp32_t *data)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k,
+        Index k_start, fp64_t val, fp64_t *data)
+    noexcept;
+
+} // namespace fill_padding
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,238 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/flash_attention/cpu.cc
+ * Fused single-pass flash attention forward on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#include "nntile/kernel/flash_attention/cpu.hh"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_attention
+{
+
+template<typename T>
+void cpu(Index seq, Index head, Index batch, Index n_batch, Index kv_group,
+        const T *K, const T *Q, const bool_t *mask, const T *V, T *maxsumexp,
+        T *A)
+    noexcept
+//! Fused attention forward update for a pair of key and query tiles on CPU
+/*! Updates attention output with contribution of given tiles of keys and
+ * values without storing a seq by seq matrix of attention weights. Input A
+ * and maxsumexp represent softmax-weighted sum of values over keys, that
+ * were processed before, and they are updated in an online manner:
+ *      S[k,q,b] = 1/sqrt(head) * sum_h K[h,k,b] * Q[h,q,b],
+ *      S[k,q,b] = -inf if !mask[k,q],
+ *      m = max(maxsumexp[0,q,b], max_k S[k,q,b]),
+ *      l = maxsumexp[1,q,b]*exp(maxsumexp[0,q,b]-m)
+ *          + sum_k exp(S[k,q,b]-m),
+ *      A[:,q,b] = (A[:,q,b]*maxsumexp[1,q,b]*exp(maxsumexp[0,q,b]-m)
+ *          + sum_k exp(S[k,q,b]-m)*V[:,k,b]) / l,
+ *      maxsumexp[0,q,b] = m,
+ *      maxsumexp[1,q,b] = l.
+ * Zero value of maxsumexp[1,q,b] means no keys were processed yet. After all
+ * tiles of keys are processed, maxsumexp is the same as the one computed by
+ * flash_maxsumexp operation and A is the final attention output.
+ *
+ * Queries and keys are processed by blocks, that fit into the cache: scores
+ * of a block of queries against a block of keys are accumulated with
+ * contiguous inner loops over a transposed copy of keys, and the online
+ * softmax state is merged once per block of keys. Output is kept
+ * unnormalized while the tile of keys is processed and is normalized once
+ * at the end.
+ *
+ * @param[in] seq: Size of sequence of the key and query tiles
+ * @param[in] head: Size of head
+ * @param[in] batch: Number of independent batches (batch times heads)
+ * @param[in] n_batch: Number of batches of sequences, heads are the slower
+ *      index of a batch
+ * @param[in] kv_group: Number of heads of queries per head of keys and
+ *      values, that is greater than 1 for grouped-query attention
+ * @param[in] K: Keys of shape [head, seq, batch/kv_group]
+ * @param[in] Q: Queries of shape [head, seq, batch]
+ * @param[in] mask: Mask of shape [seq, seq], false entries are skipped.
+ *      Null pointer stands for a causal mask, that is not stored: mask[k,q]
+ *      is true if and only if k <= q.
+ * @param[in] V: Values of shape [head, seq, batch/kv_group]
+ * @param[inout] maxsumexp: Running max and sum of exponents of shape
+ *      [2, seq, batch]
+ * @param[inout] A: Running attention output of shape [head, seq, batch]
+ * */
+{
+    constexpr T zero = 0.0, one = 1.0;
+    constexpr T neg_inf = -std::numeric_limits<T>::infinity();
+    // Sizes of blocks of queries and keys
+    constexpr Index q_block = 16, k_block = 64;
+    const T scale = one / std::sqrt(T(head));
+    const Index ld = head * seq;
+    // Transposed keys, so that scores of a query against a block of keys are
+    // updated by contiguous loops
+    std::vector<T> K_t(ld);
+    // Scores of a block of queries against a block of keys and running
+    // state of the block of queries
+    T score[q_block*k_block], max[q_block], sum[q_block];
+    bool unnormalized[q_block];
+    for(Index b = 0; b < batch; ++b)
+    {
+        // Head h of queries uses head h/kv_group of keys and values
+        const Index b_kv = b%n_batch + n_batch*(b/(n_batch*kv_group));
+        const T *K_b = K + b_kv*ld, *Q_b = Q + b*ld, *V_b = V + b_kv*ld;
+        T *A_b = A + b*ld, *maxsumexp_b = maxsumexp + 2*b*seq;
+        for(Index k = 0; k < seq; ++k)
+        {
+            for(Index h = 0; h < head; ++h)
+            {
+                K_t[h*seq+k] = K_b[k*head+h];
+            }
+        }
+        for(Index q0 = 0; q0 < seq; q0 += q_block)
+        {
+            const Index qb = std::min(q_block, seq-q0);
+            for(Index i = 0; i < qb; ++i)
+            {
+                max[i] = maxsumexp_b[2*(q0+i)];
+                sum[i] = maxsumexp_b[2*(q0+i)+1];
+                unnormalized[i] = false;
+            }
+            // Keys after the last query of the block are skipped by a
+            // causal mask
+            const Index k_stop = mask ? seq : q0+qb;
+            for(Index k0 = 0; k0 < k_stop; k0 += k_block)
+            {
+                const Index kb = std::min(k_block, k_stop-k0);
+                // Get scores
+                for(Index i = 0; i < qb; ++i)
+                {
+                    const T *Q_q = Q_b + (q0+i)*head;
+                    T *score_q = score + i*k_block;
+                    for(Index k = 0; k < kb; ++k)
+                    {
+                        score_q[k] = zero;
+                    }
+                    for(Index h = 0; h < head; ++h)
+                    {
+                        const T Q_h = Q_q[h];
+                        const T *K_h = &K_t[h*seq+k0];
+                        for(Index k = 0; k < kb; ++k)
+                        {
+                            score_q[k] += Q_h * K_h[k];
+                        }
+                    }
+                }
+                // Update running state of every query
+                for(Index i = 0; i < qb; ++i)
+                {
+                    const Index q = q0 + i;
+                    T *score_q = score + i*k_block;
+                    T block_max = neg_inf;
+                    for(Index k = 0; k < kb; ++k)
+                    {
+                        const Index key = k0 + k;
+                        bool valid = mask ? bool(mask[q*seq+key]) : key <= q;
+                        score_q[k] = valid ? scale*score_q[k] : neg_inf;
+                        if(block_max < score_q[k])
+                        {
+                            block_max = score_q[k];
+                        }
+                    }
+                    // Nothing to update if all keys are masked out
+                    if(block_max == neg_inf)
+                    {
+                        continue;
+                    }
+                    T *A_q = A_b + q*head;
+                    if(sum[i] == zero)
+                    {
+                        // No keys were processed yet
+                        max[i] = block_max;
+                        for(Index h = 0; h < head; ++h)
+                        {
+                            A_q[h] = zero;
+                        }
+                    }
+                    else
+                    {
+                        // Rescale previous state
+                        T factor = unnormalized[i] ? one : sum[i];
+                        if(max[i] < block_max)
+                        {
+                            T weight = std::exp(max[i]-block_max);
+                            factor *= weight;
+                            sum[i] *= weight;
+                            max[i] = block_max;
+                        }
+                        if(factor != one)
+                        {
+                            for(Index h = 0; h < head; ++h)
+                            {
+                                A_q[h] *= factor;
+                            }
+                        }
+                    }
+                    unnormalized[i] = true;
+                    for(Index k = 0; k < kb; ++k)
+                    {
+                        const T weight = std::exp(score_q[k]-max[i]);
+                        sum[i] += weight;
+                        if(weight != zero)
+                        {
+                            const T *V_k = V_b + (k0+k)*head;
+                            for(Index h = 0; h < head; ++h)
+                            {
+                                A_q[h] += weight * V_k[h];
+                            }
+                        }
+                    }
+                }
+            }
+            // Normalize output and store running state
+            for(Index i = 0; i < qb; ++i)
+            {
+                if(!unnormalized[i])
+                {
+                    continue;
+                }
+                T *A_q = A_b + (q0+i)*head;
+                const T inv_sum = one / sum[i];
+                for(Index h = 0; h < head; ++h)
+                {
+                    A_q[h] *= inv_sum;
+                }
+                maxsumexp_b[2*(q0+i)] = max[i];
+                maxsumexp_b[2*(q0+i)+1] = sum[i];
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index seq, Index head, Index batch, Index n_batch,
+        Index kv_group, const fp32_t *K, const fp32_t *Q, const bool_t *mask,
+        const fp32_t *V, fp32_t *maxsumexp, fp32_t *A)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index seq, Index head, Index batch, Index n_batch,
+        Index kv_group, const fp64_t *K, const fp64_t *Q, const bool_t *mask,
+        const fp64_t *V, fp64_t *maxsumexp, fp64_t *A)
+    noexcept;
+
+} // namespace flash_attention
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,193 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/flash_attention/cuda.cu
+ * Fused single-pass flash attention forward on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#include "nntile/kernel/flash_attention/cuda.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_attention
+{
+
+// Each CUDA block processes a block of queries of a single batch with one
+// thread per query. Queries, current block of keys and values and
+// unnormalized accumulator of output live in shared memory, stored as
+// [head, block] arrays so that threads of a warp access different banks.
+template<typename T>
+static __global__
+void cuda_kernel(Index seq, Index head, Index block, Index n_batch,
+        Index kv_group, T scale, const T *K, const T *Q, const bool_t *mask,
+        const T *V, T *maxsumexp, T *A)
+{
+    extern __shared__ __align__(sizeof(double)) unsigned char shared_raw[];
+    T *Q_shared = reinterpret_cast<T *>(shared_raw);
+    T *K_shared = Q_shared + block*head;
+    T *V_shared = K_shared + block*head;
+    T *A_shared = V_shared + block*head;
+    const Index b = blockIdx.y, q_start = blockIdx.x*block,
+          tid = threadIdx.x, q = q_start + tid, ld = head*seq;
+    const Index q_size = (seq-q_start < block) ? seq-q_start : block;
+    // Head h of queries uses head h/kv_group of keys and values
+    const Index b_kv = b%n_batch + n_batch*(b/(n_batch*kv_group));
+    const T *K_b = K + b_kv*ld, *Q_b = Q + b*ld, *V_b = V + b_kv*ld;
+    T *A_b = A + b*ld, *maxsumexp_b = maxsumexp + 2*b*seq;
+    // Load queries, consecutive threads read consecutive elements
+    for(Index i = tid; i < q_size*head; i += blockDim.x)
+    {
+        Index j = i / head, h = i - j*head;
+        Q_shared[h*block+j] = Q_b[q_start*head+i];
+    }
+    // Load running state, accumulator is kept unnormalized
+    constexpr T zero = 0.0, one = 1.0;
+    T max_val = -INFINITY, sum_val = zero;
+    if(q < seq)
+    {
+        sum_val = maxsumexp_b[2*q+1];
+        if(sum_val != zero)
+        {
+            max_val = maxsumexp_b[2*q];
+        }
+        for(Index h = 0; h < head; ++h)
+        {
+            A_shared[h*block+tid] = A_b[q*head+h] * sum_val;
+        }
+    }
+    // Single pass over keys and values, keys after the last query of the
+    // block are skipped by a causal mask
+    const Index k_end = mask ? seq : q_start+q_size;
+    for(Index k_start = 0; k_start < k_end; k_start += block)
+    {
+        const Index k_size = (seq-k_start < block) ? seq-k_start : block;
+        __syncthreads();
+        for(Index i = tid; i < k_size*head; i += blockDim.x)
+        {
+            Index j = i / head, h = i - j*head;
+            K_shared[h*block+j] = K_b[k_start*head+i];
+            V_shared[h*block+j] = V_b[k_start*head+i];
+        }
+        __syncthreads();
+        if(q >= seq)
+        {
+            continue;
+        }
+        const bool_t *mask_q = mask ? mask + q*seq + k_start : nullptr;
+        for(Index j = 0; j < k_size; ++j)
+        {
+            if(mask_q ? !mask_q[j] : k_start+j > q)
+            {
+                continue;
+            }
+            T s = zero;
+            for(Index h = 0; h < head; ++h)
+            {
+                s += K_shared[h*block+j] * Q_shared[h*block+tid];
+            }
+            s *= scale;
+            // Online softmax update
+            if(max_val < s)
+            {
+                T ratio = ::exp(max_val-s);
+                sum_val = sum_val*ratio + one;
+                for(Index h = 0; h < head; ++h)
+                {
+                    A_shared[h*block+tid] = A_shared[h*block+tid]*ratio
+                        + V_shared[h*block+j];
+                }
+                max_val = s;
+            }
+            else
+            {
+                T weight = ::exp(s-max_val);
+                sum_val += weight;
+                for(Index h = 0; h < head; ++h)
+                {
+                    A_shared[h*block+tid] += weight * V_shared[h*block+j];
+                }
+            }
+        }
+    }
+    // Store normalized output and new state
+    if(q < seq and sum_val != zero)
+    {
+        T inv_sum = one / sum_val;
+        for(Index h = 0; h < head; ++h)
+        {
+            A_b[q*head+h] = A_shared[h*block+tid] * inv_sum;
+        }
+        maxsumexp_b[2*q] = max_val;
+        maxsumexp_b[2*q+1] = sum_val;
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index seq, Index head, Index batch,
+        Index n_batch, Index kv_group, const T *K, const T *Q,
+        const bool_t *mask, const T *V, T *maxsumexp, T *A)
+    noexcept
+//! Fused attention forward update for a pair of key and query tiles on CUDA
+/*! See kernel::flash_attention::cpu for the description of the operation.
+ * Keys and values are read exactly once per block of queries and no seq by
+ * seq buffer of attention weights is stored in the global memory.
+ *
+ * @param[in] seq: Size of sequence of the key and query tiles
+ * @param[in] head: Size of head
+ * @param[in] batch: Number of independent batches (batch times heads)
+ * @param[in] n_batch: Number of batches of sequences, heads are the slower
+ *      index of a batch
+ * @param[in] kv_group: Number of heads of queries per head of keys and
+ *      values, that is greater than 1 for grouped-query attention
+ * @param[in] K: Keys of shape [head, seq, batch/kv_group]
+ * @param[in] Q: Queries of shape [head, seq, batch]
+ * @param[in] mask: Mask of shape [seq, seq], false entries are skipped.
+ *      Null pointer stands for a causal mask, see cpu version.
+ * @param[in] V: Values of shape [head, seq, batch/kv_group]
+ * @param[inout] maxsumexp: Running max and sum of exponents of shape
+ *      [2, seq, batch]
+ * @param[inout] A: Running attention output of shape [head, seq, batch]
+ * */
+{
+    // Queries, keys, values and accumulator must fit into 48KB of shared
+    // memory available to a block without opt-in
+    constexpr Index max_shared = 48 * 1024;
+    Index block = 64;
+    while(block > 1 and 4*block*head*Index(sizeof(T)) > max_shared)
+    {
+        block /= 2;
+    }
+    Index shared = 4 * block * head * sizeof(T);
+    T scale = T(1.0) / std::sqrt(T(head));
+    dim3 blocks((seq+block-1)/block, batch), threads(block);
+    (cuda_kernel<T>)<<<blocks, threads, shared, stream>>>(seq, head, block,
+            n_batch, kv_group, scale, K, Q, mask, V, maxsumexp, A);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index seq, Index head, Index batch,
+        Index n_batch, Index kv_group, const fp32_t *K, const fp32_t *Q,
+        const bool_t *mask, const fp32_t *V, fp32_t *maxsumexp, fp32_t *A)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index seq, Index head, Index batch,
+        Index n_batch, Index kv_group, const fp64_t *K, const fp64_t *Q,
+        const bool_t *mask, const fp64_t *V, fp64_t *maxsumexp, fp64_t *A)
+    noexcept;
+
+} // namespace flash_attention
+} // namespace kernel
+} // namespace nntile
+
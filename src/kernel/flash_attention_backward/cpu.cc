@@ -0,0 +1,128 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/flash_attention_backward/cpu.cc
+ * Fused single-pass flash attention backward on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#include "nntile/kernel/flash_attention_backward/cpu.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_attention_backward
+{
+
+template<typename T>
+void cpu(Index seq, Index head, Index batch, const T *K, const T *Q,
+        const bool_t *mask, const T *maxsumexp, const T *dA, const T *V,
+        const T *sumprod_slice, T *dQ, T *dK, T *dV)
+    noexcept
+//! Fused attention backward for a pair of key and query tiles on CPU
+/*! Accumulates gradients of keys, queries and values, recomputing attention
+ * weights P on the fly instead of reading them from a seq by seq buffer:
+ *      P[k,q,b] = exp(1/sqrt(head)*sum_h K[h,k,b]*Q[h,q,b]
+ *          - maxsumexp[0,q,b]) / maxsumexp[1,q,b] if mask[k,q] else 0,
+ *      dP[k,q,b] = sum_h V[h,k,b] * dA[h,q,b],
+ *      dS[k,q,b] = P[k,q,b] * (dP[k,q,b]-sumprod_slice[q,b]),
+ *      dV[:,k,b] += sum_q P[k,q,b] * dA[:,q,b],
+ *      dQ[:,q,b] += 1/sqrt(head) * sum_k dS[k,q,b] * K[:,k,b],
+ *      dK[:,k,b] += 1/sqrt(head) * sum_q dS[k,q,b] * Q[:,q,b].
+ * Here maxsumexp is the final one, computed over all tiles of keys, and
+ * sumprod_slice[q,b] = sum_h A[h,q,b] * dA[h,q,b] for attention output A.
+ *
+ * @param[in] seq: Size of sequence of the key and query tiles
+ * @param[in] head: Size of head
+ * @param[in] batch: Number of independent batches (batch times heads)
+ * @param[in] K: Keys of shape [head, seq, batch]
+ * @param[in] Q: Queries of shape [head, seq, batch]
+ * @param[in] mask: Mask of shape [seq, seq], false entries are skipped.
+ *      Null pointer stands for a causal mask, that is not stored: mask[k,q]
+ *      is true if and only if k <= q.
+ * @param[in] maxsumexp: Max and sum of exponents of shape [2, seq, batch]
+ * @param[in] dA: Gradient of attention output of shape [head, seq, batch]
+ * @param[in] V: Values of shape [head, seq, batch]
+ * @param[in] sumprod_slice: Sums of products of A and dA of shape
+ *      [seq, batch]
+ * @param[inout] dQ: Gradient of queries of shape [head, seq, batch]
+ * @param[inout] dK: Gradient of keys of shape [head, seq, batch]
+ * @param[inout] dV: Gradient of values of shape [head, seq, batch]
+ * */
+{
+    constexpr T zero = 0.0, one = 1.0;
+    const T scale = one / std::sqrt(T(head));
+    const Index ld = head * seq;
+    for(Index b = 0; b < batch; ++b)
+    {
+        const T *K_b = K + b*ld, *Q_b = Q + b*ld, *V_b = V + b*ld,
+              *dA_b = dA + b*ld, *maxsumexp_b = maxsumexp + 2*b*seq,
+              *sumprod_slice_b = sumprod_slice + b*seq;
+        T *dQ_b = dQ + b*ld, *dK_b = dK + b*ld, *dV_b = dV + b*ld;
+        for(Index q = 0; q < seq; ++q)
+        {
+            const T max = maxsumexp_b[2*q], sum = maxsumexp_b[2*q+1];
+            // Skip queries that have no keys at all
+            if(sum == zero)
+            {
+                continue;
+            }
+            const T inv_sum = one / sum, sumprod = sumprod_slice_b[q];
+            const T *Q_q = Q_b + q*head, *dA_q = dA_b + q*head;
+            T *dQ_q = dQ_b + q*head;
+            // Keys after the query are skipped by a causal mask
+            const Index k_end = mask ? seq : q+1;
+            for(Index k = 0; k < k_end; ++k)
+            {
+                if(mask and !mask[q*seq+k])
+                {
+                    continue;
+                }
+                const T *K_k = K_b + k*head, *V_k = V_b + k*head;
+                T *dK_k = dK_b + k*head, *dV_k = dV_b + k*head;
+                T s = zero, dp = zero;
+                for(Index h = 0; h < head; ++h)
+                {
+                    s += K_k[h] * Q_q[h];
+                    dp += V_k[h] * dA_q[h];
+                }
+                const T p = std::exp(scale*s-max) * inv_sum;
+                const T ds = scale * p * (dp-sumprod);
+                for(Index h = 0; h < head; ++h)
+                {
+                    dV_k[h] += p * dA_q[h];
+                    dQ_q[h] += ds * K_k[h];
+                    dK_k[h] += ds * Q_q[h];
+                }
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index seq, Index head, Index batch, const fp32_t *K,
+        const fp32_t *Q, const bool_t *mask, const fp32_t *maxsumexp,
+        const fp32_t *dA, const fp32_t *V, const fp32_t *sumprod_slice,
+        fp32_t *dQ, fp32_t *dK, fp32_t *dV)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index seq, Index head, Index batch, const fp64_t *K,
+        const fp64_t *Q, const bool_t *mask, const fp64_t *maxsumexp,
+        const fp64_t *dA, const fp64_t *V, const fp64_t *sumprod_slice,
+        fp64_t *dQ, fp64_t *dK, fp64_t *dV)
+    noexcept;
+
+} // namespace flash_attention_backward
+} // namespace kernel
+} // namespace nntile
+
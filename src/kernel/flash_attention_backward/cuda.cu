@@ -0,0 +1,283 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/flash_attention_backward/cuda.cu
+ * Fused single-pass flash attention backward on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#include "nntile/kernel/flash_attention_backward/cuda.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_attention_backward
+{
+
+// Gradient of queries: each CUDA block processes a block of queries of a
+// single batch with one thread per query and iterates over all the keys.
+// Shared memory arrays are stored as [head, block].
+template<typename T>
+static __global__
+void cuda_kernel_dq(Index seq, Index head, Index block, T scale, const T *K,
+        const T *Q, const bool_t *mask, const T *maxsumexp, const T *dA,
+        const T *V, const T *sumprod_slice, T *dQ)
+{
+    extern __shared__ __align__(sizeof(double)) unsigned char shared_raw[];
+    T *Q_shared = reinterpret_cast<T *>(shared_raw);
+    T *dA_shared = Q_shared + block*head;
+    T *K_shared = dA_shared + block*head;
+    T *V_shared = K_shared + block*head;
+    T *dQ_shared = V_shared + block*head;
+    const Index b = blockIdx.y, q_start = blockIdx.x*block,
+          tid = threadIdx.x, q = q_start + tid, ld = head*seq;
+    const Index q_size = (seq-q_start < block) ? seq-q_start : block;
+    const T *K_b = K + b*ld, *Q_b = Q + b*ld, *V_b = V + b*ld,
+          *dA_b = dA + b*ld, *maxsumexp_b = maxsumexp + 2*b*seq,
+          *sumprod_slice_b = sumprod_slice + b*seq;
+    T *dQ_b = dQ + b*ld;
+    for(Index i = tid; i < q_size*head; i += blockDim.x)
+    {
+        Index j = i / head, h = i - j*head;
+        Q_shared[h*block+j] = Q_b[q_start*head+i];
+        dA_shared[h*block+j] = dA_b[q_start*head+i];
+    }
+    constexpr T zero = 0.0, one = 1.0;
+    T max_val = zero, inv_sum = zero, sumprod = zero;
+    // Queries without any keys get no gradient
+    bool active = false;
+    if(q < seq)
+    {
+        T sum_val = maxsumexp_b[2*q+1];
+        if(sum_val != zero)
+        {
+            active = true;
+            max_val = maxsumexp_b[2*q];
+            inv_sum = one / sum_val;
+            sumprod = sumprod_slice_b[q];
+        }
+        for(Index h = 0; h < head; ++h)
+        {
+            dQ_shared[h*block+tid] = zero;
+        }
+    }
+    // Keys after the last query of the block are skipped by a causal mask
+    const Index k_end = mask ? seq : q_start+q_size;
+    for(Index k_start = 0; k_start < k_end; k_start += block)
+    {
+        const Index k_size = (seq-k_start < block) ? seq-k_start : block;
+        __syncthreads();
+        for(Index i = tid; i < k_size*head; i += blockDim.x)
+        {
+            Index j = i / head, h = i - j*head;
+            K_shared[h*block+j] = K_b[k_start*head+i];
+            V_shared[h*block+j] = V_b[k_start*head+i];
+        }
+        __syncthreads();
+        if(!active)
+        {
+            continue;
+        }
+        const bool_t *mask_q = mask ? mask + q*seq + k_start : nullptr;
+        for(Index j = 0; j < k_size; ++j)
+        {
+            if(mask_q ? !mask_q[j] : k_start+j > q)
+            {
+                continue;
+            }
+            T s = zero, dp = zero;
+            for(Index h = 0; h < head; ++h)
+            {
+                s += K_shared[h*block+j] * Q_shared[h*block+tid];
+                dp += V_shared[h*block+j] * dA_shared[h*block+tid];
+            }
+            T p = ::exp(scale*s-max_val) * inv_sum;
+            T ds = scale * p * (dp-sumprod);
+            for(Index h = 0; h < head; ++h)
+            {
+                dQ_shared[h*block+tid] += ds * K_shared[h*block+j];
+            }
+        }
+    }
+    if(active)
+    {
+        for(Index h = 0; h < head; ++h)
+        {
+            dQ_b[q*head+h] += dQ_shared[h*block+tid];
+        }
+    }
+}
+
+// Gradients of keys and values: each CUDA block processes a block of keys of
+// a single batch with one thread per key and iterates over all the queries.
+// Shared memory arrays are stored as [head, block].
+template<typename T>
+static __global__
+void cuda_kernel_dkdv(Index seq, Index head, Index block, T scale,
+        const T *K, const T *Q, const bool_t *mask, const T *maxsumexp,
+        const T *dA, const T *V, const T *sumprod_slice, T *dK, T *dV)
+{
+    extern __shared__ __align__(sizeof(double)) unsigned char shared_raw[];
+    T *K_shared = reinterpret_cast<T *>(shared_raw);
+    T *V_shared = K_shared + block*head;
+    T *Q_shared = V_shared + block*head;
+    T *dA_shared = Q_shared + block*head;
+    T *dK_shared = dA_shared + block*head;
+    T *dV_shared = dK_shared + block*head;
+    T *max_shared = dV_shared + block*head;
+    T *inv_sum_shared = max_shared + block;
+    T *sumprod_shared = inv_sum_shared + block;
+    const Index b = blockIdx.y, k_start = blockIdx.x*block,
+          tid = threadIdx.x, k = k_start + tid, ld = head*seq;
+    const Index k_size = (seq-k_start < block) ? seq-k_start : block;
+    const T *K_b = K + b*ld, *Q_b = Q + b*ld, *V_b = V + b*ld,
+          *dA_b = dA + b*ld, *maxsumexp_b = maxsumexp + 2*b*seq,
+          *sumprod_slice_b = sumprod_slice + b*seq;
+    T *dK_b = dK + b*ld, *dV_b = dV + b*ld;
+    for(Index i = tid; i < k_size*head; i += blockDim.x)
+    {
+        Index j = i / head, h = i - j*head;
+        K_shared[h*block+j] = K_b[k_start*head+i];
+        V_shared[h*block+j] = V_b[k_start*head+i];
+    }
+    constexpr T zero = 0.0, one = 1.0;
+    if(k < seq)
+    {
+        for(Index h = 0; h < head; ++h)
+        {
+            dK_shared[h*block+tid] = zero;
+            dV_shared[h*block+tid] = zero;
+        }
+    }
+    // Queries before the first key of the block are skipped by a causal
+    // mask
+    for(Index q_start = mask ? 0 : k_start; q_start < seq; q_start += block)
+    {
+        const Index q_size = (seq-q_start < block) ? seq-q_start : block;
+        __syncthreads();
+        for(Index i = tid; i < q_size*head; i += blockDim.x)
+        {
+            Index j = i / head, h = i - j*head;
+            Q_shared[h*block+j] = Q_b[q_start*head+i];
+            dA_shared[h*block+j] = dA_b[q_start*head+i];
+        }
+        if(tid < q_size)
+        {
+            Index q = q_start + tid;
+            T sum_val = maxsumexp_b[2*q+1];
+            max_shared[tid] = maxsumexp_b[2*q];
+            inv_sum_shared[tid] = (sum_val == zero) ? zero : one/sum_val;
+            sumprod_shared[tid] = sumprod_slice_b[q];
+        }
+        __syncthreads();
+        if(k >= seq)
+        {
+            continue;
+        }
+        for(Index j = 0; j < q_size; ++j)
+        {
+            if((mask ? !mask[(q_start+j)*seq+k] : q_start+j < k)
+                    or inv_sum_shared[j] == zero)
+            {
+                continue;
+            }
+            T s = zero, dp = zero;
+            for(Index h = 0; h < head; ++h)
+            {
+                s += K_shared[h*block+tid] * Q_shared[h*block+j];
+                dp += V_shared[h*block+tid] * dA_shared[h*block+j];
+            }
+            T p = ::exp(scale*s-max_shared[j]) * inv_sum_shared[j];
+            T ds = scale * p * (dp-sumprod_shared[j]);
+            for(Index h = 0; h < head; ++h)
+            {
+                dV_shared[h*block+tid] += p * dA_shared[h*block+j];
+                dK_shared[h*block+tid] += ds * Q_shared[h*block+j];
+            }
+        }
+    }
+    if(k < seq)
+    {
+        for(Index h = 0; h < head; ++h)
+        {
+            dK_b[k*head+h] += dK_shared[h*block+tid];
+            dV_b[k*head+h] += dV_shared[h*block+tid];
+        }
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index seq, Index head, Index batch, const T *K,
+        const T *Q, const bool_t *mask, const T *maxsumexp, const T *dA,
+        const T *V, const T *sumprod_slice, T *dQ, T *dK, T *dV)
+    noexcept
+//! Fused attention backward for a pair of key and query tiles on CUDA
+/*! See kernel::flash_attention_backward::cpu for the description of the
+ * operation. Attention weights are recomputed in shared memory by two
+ * kernels: the first one accumulates gradient of queries, and the second one
+ * accumulates gradients of keys and values. This way no atomic operations
+ * and no seq by seq buffers in the global memory are needed.
+ *
+ * @param[in] seq: Size of sequence of the key and query tiles
+ * @param[in] head: Size of head
+ * @param[in] batch: Number of independent batches (batch times heads)
+ * @param[in] K: Keys of shape [head, seq, batch]
+ * @param[in] Q: Queries of shape [head, seq, batch]
+ * @param[in] mask: Mask of shape [seq, seq], false entries are skipped.
+ *      Null pointer stands for a causal mask, see cpu version.
+ * @param[in] maxsumexp: Max and sum of exponents of shape [2, seq, batch]
+ * @param[in] dA: Gradient of attention output of shape [head, seq, batch]
+ * @param[in] V: Values of shape [head, seq, batch]
+ * @param[in] sumprod_slice: Sums of products of A and dA of shape
+ *      [seq, batch]
+ * @param[inout] dQ: Gradient of queries of shape [head, seq, batch]
+ * @param[inout] dK: Gradient of keys of shape [head, seq, batch]
+ * @param[inout] dV: Gradient of values of shape [head, seq, batch]
+ * */
+{
+    // All the shared arrays must fit into 48KB of shared memory available to
+    // a block without opt-in
+    constexpr Index max_shared = 48 * 1024;
+    Index block = 64;
+    while(block > 1 and (6*head+3)*block*Index(sizeof(T)) > max_shared)
+    {
+        block /= 2;
+    }
+    T scale = T(1.0) / std::sqrt(T(head));
+    dim3 blocks((seq+block-1)/block, batch), threads(block);
+    Index shared_dq = 5 * block * head * sizeof(T);
+    (cuda_kernel_dq<T>)<<<blocks, threads, shared_dq, stream>>>(seq, head,
+            block, scale, K, Q, mask, maxsumexp, dA, V, sumprod_slice, dQ);
+    Index shared_dkdv = (6*head+3) * block * sizeof(T);
+    (cuda_kernel_dkdv<T>)<<<blocks, threads, shared_dkdv, stream>>>(seq,
+            head, block, scale, K, Q, mask, maxsumexp, dA, V, sumprod_slice,
+            dK, dV);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index seq, Index head, Index batch,
+        const fp32_t *K, const fp32_t *Q, const bool_t *mask,
+        const fp32_t *maxsumexp, const fp32_t *dA, const fp32_t *V,
+        const fp32_t *sumprod_slice, fp32_t *dQ, fp32_t *dK, fp32_t *dV)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index seq, Index head, Index batch,
+        const fp64_t *K, const fp64_t *Q, const bool_t *mask,
+        const fp64_t *maxsumexp, const fp64_t *dA, const fp64_t *V,
+        const fp64_t *sumprod_slice, fp64_t *dQ, fp64_t *dK, fp64_t *dV)
+    noexcept;
+
+} // namespace flash_attention_backward
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,177 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/flash_attention_dequant/cpu.cc
+ * Fused attention over quantized keys and values on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/flash_attention_dequant/cpu.hh"
+#include <cmath>
+#include <vector>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_attention_dequant
+{
+
+template<typename Q>
+void cpu(Index k_seq, Index q_seq, Index head, Index batch, Index n_batch,
+        Index kv_group, Index mask_stride, const Q *K, const fp32_t *K_scale,
+        const fp32_t *query, const bool_t *mask, const Q *V,
+        const fp32_t *V_scale, fp32_t *maxsumexp, fp32_t *A)
+    noexcept
+//! Fused attention update for quantized tiles of keys and values on CPU
+/*! The same online softmax update as the one of
+ * nntile::kernel::flash_attention::cpu(), but keys and values are stored
+ * in 8-bit types with a scale per token and head, as produced by
+ * nntile::kernel::quantize::cpu() with groups of size head:
+ *      K[h,k,b] = K_scale[k,b] * K_q[h,k,b],
+ *      V[h,k,b] = V_scale[k,b] * V_q[h,k,b].
+ * Scales are applied once per score and once per weight of a value, so keys
+ * and values are never dequantized into memory. Tiles of keys and queries
+ * may be of different lengths, e.g., a tile of KV-cache and new tokens.
+ *
+ * @param[in] k_seq: Size of sequence of the key and value tiles
+ * @param[in] q_seq: Size of sequence of the query tile
+ * @param[in] head: Size of head
+ * @param[in] batch: Number of independent batches (batch times heads)
+ * @param[in] n_batch: Number of batches of sequences, heads are the slower
+ *      index of a batch
+ * @param[in] kv_group: Number of heads of queries per head of keys and
+ *      values, that is greater than 1 for grouped-query attention
+ * @param[in] mask_stride: Stride of mask between batches of sequences,
+ *      zero if all the sequences share the same mask
+ * @param[in] K: Quantized keys of shape [head, k_seq, batch/kv_group]
+ * @param[in] K_scale: Scales of keys of shape [k_seq, batch/kv_group]
+ * @param[in] query: Queries of shape [head, q_seq, batch]
+ * @param[in] mask: Mask of shape [k_seq, q_seq] for every batch of
+ *      sequences, false entries are skipped
+ * @param[in] V: Quantized values of shape [head, k_seq, batch/kv_group]
+ * @param[in] V_scale: Scales of values of shape [k_seq, batch/kv_group]
+ * @param[inout] maxsumexp: Running max and sum of exponents of shape
+ *      [2, q_seq, batch]
+ * @param[inout] A: Running attention output of shape [head, q_seq, batch]
+ * */
+{
+    constexpr fp32_t zero = 0.0, one = 1.0;
+    const fp32_t scale = one / std::sqrt(fp32_t(head));
+    const Index k_ld = head * k_seq, q_ld = head * q_seq;
+    // Scores of a single query against the tile of keys
+    std::vector<fp32_t> score(k_seq);
+    for(Index b = 0; b < batch; ++b)
+    {
+        // Head h of queries uses head h/kv_group of keys and values
+        const Index b_kv = b%n_batch + n_batch*(b/(n_batch*kv_group));
+        const Q *K_b = K + b_kv*k_ld, *V_b = V + b_kv*k_ld;
+        const fp32_t *K_scale_b = K_scale + b_kv*k_seq,
+              *V_scale_b = V_scale + b_kv*k_seq, *query_b = query + b*q_ld;
+        const bool_t *mask_b = mask + (b%n_batch)*mask_stride;
+        fp32_t *A_b = A + b*q_ld, *maxsumexp_b = maxsumexp + 2*b*q_seq;
+        for(Index q = 0; q < q_seq; ++q)
+        {
+            const fp32_t *query_q = query_b + q*head;
+            const bool_t *mask_q = mask_b + q*k_seq;
+            fp32_t *A_q = A_b + q*head;
+            // Get scores and their maximum
+            bool any_valid = false;
+            fp32_t block_max = zero;
+            for(Index k = 0; k < k_seq; ++k)
+            {
+                if(!mask_q[k])
+                {
+                    continue;
+                }
+                const Q *K_k = K_b + k*head;
+                fp32_t s = zero;
+                for(Index h = 0; h < head; ++h)
+                {
+                    s += static_cast<fp32_t>(K_k[h]) * query_q[h];
+                }
+                s *= scale * K_scale_b[k];
+                score[k] = s;
+                if(!any_valid or block_max < s)
+                {
+                    block_max = s;
+                }
+                any_valid = true;
+            }
+            // Nothing to update if all keys are masked out
+            if(!any_valid)
+            {
+                continue;
+            }
+            // Rescale previous state
+            fp32_t old_max = maxsumexp_b[2*q], old_sum = maxsumexp_b[2*q+1];
+            fp32_t new_max = block_max, old_weight = zero;
+            if(old_sum != zero)
+            {
+                if(new_max < old_max)
+                {
+                    new_max = old_max;
+                }
+                old_weight = old_sum * std::exp(old_max-new_max);
+            }
+            fp32_t new_sum = old_weight;
+            for(Index k = 0; k < k_seq; ++k)
+            {
+                if(mask_q[k])
+                {
+                    score[k] = std::exp(score[k]-new_max);
+                    new_sum += score[k];
+                }
+            }
+            // Update output
+            const fp32_t inv_sum = one / new_sum;
+            const fp32_t old_scale = old_weight * inv_sum;
+            for(Index h = 0; h < head; ++h)
+            {
+                A_q[h] *= old_scale;
+            }
+            for(Index k = 0; k < k_seq; ++k)
+            {
+                if(mask_q[k])
+                {
+                    const Q *V_k = V_b + k*head;
+                    const fp32_t weight = score[k] * inv_sum * V_scale_b[k];
+                    for(Index h = 0; h < head; ++h)
+                    {
+                        A_q[h] += weight * static_cast<fp32_t>(V_k[h]);
+                    }
+                }
+            }
+            maxsumexp_b[2*q] = new_max;
+            maxsumexp_b[2*q+1] = new_sum;
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<std::int8_t>(Index k_seq, Index q_seq, Index head, Index batch,
+        Index n_batch, Index kv_group, Index mask_stride,
+        const std::int8_t *K, const fp32_t *K_scale, const fp32_t *query,
+        const bool_t *mask, const std::int8_t *V, const fp32_t *V_scale,
+        fp32_t *maxsumexp, fp32_t *A)
+    noexcept;
+
+template
+void cpu<fp8_e4m3_t>(Index k_seq, Index q_seq, Index head, Index batch,
+        Index n_batch, Index kv_group, Index mask_stride,
+        const fp8_e4m3_t *K, const fp32_t *K_scale, const fp32_t *query,
+        const bool_t *mask, const fp8_e4m3_t *V, const fp32_t *V_scale,
+        fp32_t *maxsumexp, fp32_t *A)
+    noexcept;
+
+} // namespace flash_attention_dequant
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,190 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/flash_attention_dequant/cuda.cu
+ * Fused attention over quantized keys and values on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/flash_attention_dequant/cuda.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_attention_dequant
+{
+
+//! Number of threads of a block, that shall be a power of 2
+static constexpr int nthreads = 128;
+
+// Each CUDA block processes a single query of a single batch, as there are
+// only a few new tokens during decoding, while the tile of KV-cache is long.
+// Threads compute scores of consecutive keys of a chunk, and then the same
+// threads go through elements of the head to accumulate dequantized values
+// of the chunk, so that reads of both keys and values are not repeated.
+template<typename Q>
+static __global__
+void cuda_kernel(Index k_seq, Index q_seq, Index head, Index n_batch,
+        Index kv_group, Index mask_stride, fp32_t scale, const Q *K,
+        const fp32_t *K_scale, const fp32_t *query, const bool_t *mask,
+        const Q *V, const fp32_t *V_scale, fp32_t *maxsumexp, fp32_t *A)
+{
+    extern __shared__ fp32_t shared[];
+    fp32_t *query_shared = shared;
+    fp32_t *acc = query_shared + head;
+    fp32_t *weight = acc + head;
+    fp32_t *reduce = weight + nthreads;
+    const Index q = blockIdx.x, b = blockIdx.y, tid = threadIdx.x;
+    const Index k_ld = head * k_seq, q_ld = head * q_seq;
+    // Head h of queries uses head h/kv_group of keys and values
+    const Index b_kv = b%n_batch + n_batch*(b/(n_batch*kv_group));
+    const Q *K_b = K + b_kv*k_ld, *V_b = V + b_kv*k_ld;
+    const fp32_t *K_scale_b = K_scale + b_kv*k_seq,
+          *V_scale_b = V_scale + b_kv*k_seq;
+    const bool_t *mask_q = mask + (b%n_batch)*mask_stride + q*k_seq;
+    fp32_t *A_q = A + b*q_ld + q*head,
+           *maxsumexp_q = maxsumexp + 2*(b*q_seq+q);
+    // Load query and running state, accumulator is kept unnormalized. Every
+    // thread owns the same elements of the accumulator till the end.
+    constexpr fp32_t zero = 0.0, one = 1.0;
+    fp32_t sum_val = maxsumexp_q[1];
+    fp32_t max_val = (sum_val != zero) ? maxsumexp_q[0] : -INFINITY;
+    for(Index h = tid; h < head; h += nthreads)
+    {
+        query_shared[h] = query[b*q_ld+q*head+h];
+        acc[h] = A_q[h] * sum_val;
+    }
+    for(Index k_start = 0; k_start < k_seq; k_start += nthreads)
+    {
+        const Index k = k_start + tid;
+        const Index k_size = (k_seq-k_start < nthreads) ? k_seq-k_start
+            : nthreads;
+        __syncthreads();
+        // Dequantized score of a key
+        fp32_t s = -INFINITY;
+        if(k < k_seq and mask_q[k])
+        {
+            const Q *K_k = K_b + k*head;
+            s = zero;
+            for(Index h = 0; h < head; ++h)
+            {
+                s += static_cast<fp32_t>(K_k[h]) * query_shared[h];
+            }
+            s *= scale * K_scale_b[k];
+        }
+        // Maximum over the chunk of keys
+        reduce[tid] = s;
+        __syncthreads();
+        for(int stride = nthreads/2; stride > 0; stride /= 2)
+        {
+            if(tid < stride and reduce[tid] < reduce[tid+stride])
+            {
+                reduce[tid] = reduce[tid+stride];
+            }
+            __syncthreads();
+        }
+        const fp32_t chunk_max = reduce[0];
+        __syncthreads();
+        // All the threads skip a fully masked chunk
+        if(chunk_max == -INFINITY)
+        {
+            continue;
+        }
+        const fp32_t new_max = (max_val < chunk_max) ? chunk_max : max_val;
+        const fp32_t p = (s == -INFINITY) ? zero : ::exp(s-new_max);
+        weight[tid] = (k < k_seq) ? p*V_scale_b[k] : zero;
+        reduce[tid] = p;
+        __syncthreads();
+        for(int stride = nthreads/2; stride > 0; stride /= 2)
+        {
+            if(tid < stride)
+            {
+                reduce[tid] += reduce[tid+stride];
+            }
+            __syncthreads();
+        }
+        const fp32_t ratio = ::exp(max_val-new_max);
+        sum_val = sum_val*ratio + reduce[0];
+        max_val = new_max;
+        // Consecutive threads read consecutive elements of values
+        for(Index h = tid; h < head; h += nthreads)
+        {
+            fp32_t a = acc[h] * ratio;
+            for(Index j = 0; j < k_size; ++j)
+            {
+                a += weight[j] * static_cast<fp32_t>(V_b[(k_start+j)*head+h]);
+            }
+            acc[h] = a;
+        }
+    }
+    // Store normalized output and new state
+    if(sum_val != zero)
+    {
+        const fp32_t inv_sum = one / sum_val;
+        for(Index h = tid; h < head; h += nthreads)
+        {
+            A_q[h] = acc[h] * inv_sum;
+        }
+        if(tid == 0)
+        {
+            maxsumexp_q[0] = max_val;
+            maxsumexp_q[1] = sum_val;
+        }
+    }
+}
+
+template<typename Q>
+void cuda(cudaStream_t stream, Index k_seq, Index q_seq, Index head,
+        Index batch, Index n_batch, Index kv_group, Index mask_stride,
+        const Q *K, const fp32_t *K_scale, const fp32_t *query,
+        const bool_t *mask, const Q *V, const fp32_t *V_scale,
+        fp32_t *maxsumexp, fp32_t *A)
+    noexcept
+//! Fused attention update for quantized tiles of keys and values on CUDA
+/*! See kernel::flash_attention_dequant::cpu for the description of the
+ * operation. Keys and values are dequantized in registers, so the amount of
+ * data read from the KV-cache is 4 times smaller than that of the single
+ * precision flash attention.
+ * */
+{
+    if(q_seq == 0 or batch == 0)
+    {
+        return;
+    }
+    Index shared = (2*head+2*nthreads) * sizeof(fp32_t);
+    fp32_t scale = fp32_t(1.0) / std::sqrt(fp32_t(head));
+    dim3 blocks(q_seq, batch), threads(nthreads);
+    (cuda_kernel<Q>)<<<blocks, threads, shared, stream>>>(k_seq, q_seq, head,
+            n_batch, kv_group, mask_stride, scale, K, K_scale, query, mask, V,
+            V_scale, maxsumexp, A);
+}
+
+// Explicit instantiation
+template
+void cuda<std::int8_t>(cudaStream_t stream, Index k_seq, Index q_seq,
+        Index head, Index batch, Index n_batch, Index kv_group,
+        Index mask_stride, const std::int8_t *K, const fp32_t *K_scale,
+        const fp32_t *query, const bool_t *mask, const std::int8_t *V,
+        const fp32_t *V_scale, fp32_t *maxsumexp, fp32_t *A)
+    noexcept;
+
+template
+void cuda<fp8_e4m3_t>(cudaStream_t stream, Index k_seq, Index q_seq,
+        Index head, Index batch, Index n_batch, Index kv_group,
+        Index mask_stride, const fp8_e4m3_t *K, const fp32_t *K_scale,
+        const fp32_t *query, const bool_t *mask, const fp8_e4m3_t *V,
+        const fp32_t *V_scale, fp32_t *maxsumexp, fp32_t *A)
+    noexcept;
+
+} // namespace flash_attention_dequant
+} // namespace kernel
+} // namespace nntile
+
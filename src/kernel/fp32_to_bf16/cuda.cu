@@ -0,0 +1,51 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/fp32_to_bf16/cuda.cu
+ * Convert fp32_t array into bf16_t array on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-31
+ * */
+
+#include "nntile/kernel/fp32_to_bf16/cuda.hh"
+#include <cuda_bf16.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace fp32_to_bf16
+{
+
+static __global__
+void cuda_kernel(Index nelems, const fp32_t *src, __nv_bfloat16 *dst)
+{
+    int i = threadIdx.x + blockIdx.x*blockDim.x;
+    if(i < nelems)
+    {
+        dst[i] = __float2bfloat16(src[i]);
+    }
+}
+
+void cuda(cudaStream_t stream, Index nelems, const fp32_t *src, bf16_t *dst)
+    noexcept
+/*!
+ * @params[in] nelems: Number of elements in a buffer
+ * @params[in] src: Input array
+ * @params[out] dst: Output array
+ * */
+{
+    dim3 blocks((nelems+255)/256), threads(256);
+    __nv_bfloat16 *dst_bf16 = reinterpret_cast<__nv_bfloat16 *>(dst);
+    (cuda_kernel)<<<blocks, threads, 0, stream>>>(nelems, src, dst_bf16);
+}
+
+} // namespace fp32_to_bf16
+} // namespace kernel
+} // namespace nntile
+
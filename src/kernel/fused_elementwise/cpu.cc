@@ -0,0 +1,167 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/fused_elementwise/cpu.cc
+ * Chain of elementwise operations on CPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/fused_elementwise/cpu.hh"
+#include <algorithm>
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace fused_elementwise
+{
+
+// Number of elements of every buffer, processed by all the operations at
+// once. Chunks of all the buffers stay in L1 cache between operations.
+static constexpr Index CHUNK = 512;
+
+//! Apply a single operation to a chunk of buffers
+template<typename T>
+static void apply(Index n, const op_t<T> &op, const T *src, T *dst)
+    noexcept
+{
+    constexpr T zero = 0;
+    const T alpha = op.alpha, beta = op.beta;
+    switch(op.code)
+    {
+        case opcode_t::ADD:
+            if(alpha == zero and beta == zero)
+            {
+                std::fill(dst, dst+n, zero);
+            }
+            else if(alpha == zero)
+            {
+                for(Index i = 0; i < n; ++i)
+                {
+                    dst[i] = beta * dst[i];
+                }
+            }
+            else if(beta == zero)
+            {
+                for(Index i = 0; i < n; ++i)
+                {
+                    dst[i] = alpha * src[i];
+                }
+            }
+            else
+            {
+                for(Index i = 0; i < n; ++i)
+                {
+                    dst[i] = alpha*src[i] + beta*dst[i];
+                }
+            }
+            break;
+        case opcode_t::PROD:
+            for(Index i = 0; i < n; ++i)
+            {
+                dst[i] = src[i] * dst[i];
+            }
+            break;
+        case opcode_t::SCAL:
+            for(Index i = 0; i < n; ++i)
+            {
+                dst[i] = alpha * src[i];
+            }
+            break;
+        case opcode_t::ADD_SCALAR:
+            if(beta == zero)
+            {
+                std::fill(dst, dst+n, alpha);
+            }
+            else
+            {
+                for(Index i = 0; i < n; ++i)
+                {
+                    dst[i] = alpha + beta*dst[i];
+                }
+            }
+            break;
+        case opcode_t::HYPOT:
+            if(alpha == zero and beta == zero)
+            {
+                std::fill(dst, dst+n, zero);
+            }
+            else if(alpha == zero)
+            {
+                for(Index i = 0; i < n; ++i)
+                {
+                    dst[i] = std::fabs(beta * dst[i]);
+                }
+            }
+            else if(beta == zero)
+            {
+                for(Index i = 0; i < n; ++i)
+                {
+                    dst[i] = std::fabs(alpha * src[i]);
+                }
+            }
+            else
+            {
+                for(Index i = 0; i < n; ++i)
+                {
+                    dst[i] = std::hypot(alpha*src[i], beta*dst[i]);
+                }
+            }
+            break;
+        case opcode_t::SQRT:
+            for(Index i = 0; i < n; ++i)
+            {
+                dst[i] = std::sqrt(src[i]);
+            }
+            break;
+    }
+}
+
+template<typename T>
+void cpu(Index nelems, const program_t<T> &program, T * const *buffers)
+    noexcept
+//! Apply a program of elementwise operations to CPU buffers
+/*! Operations are applied in order, as if every operation was called on
+ * entire buffers. Since all of them are elementwise, buffers are traversed
+ * by chunks instead, and all the operations are applied to a chunk before
+ * moving to the next one. Therefore, each buffer is read and written from
+ * the main memory only once, no matter how many operations use it.
+ *
+ * @param[in] nelems: Number of elements of every buffer
+ * @param[in] program: Program of operations over indices of buffers
+ * @param[inout] buffers: Array of program.nbuffers pointers to buffers
+ * */
+{
+    for(Index start = 0; start < nelems; start += CHUNK)
+    {
+        Index n = std::min(CHUNK, nelems-start);
+        for(int k = 0; k < program.nops; ++k)
+        {
+            const op_t<T> &op = program.ops[k];
+            apply<T>(n, op, buffers[op.src]+start, buffers[op.dst]+start);
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index nelems, const program_t<fp32_t> &program,
+        fp32_t * const *buffers)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index nelems, const program_t<fp64_t> &program,
+        fp64_t * const *buffers)
+    noexcept;
+
+} // namespace fused_elementwise
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,147 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/fused_elementwise/cuda.cu
+ * Chain of elementwise operations on CUDA buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/fused_elementwise/cuda.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace fused_elementwise
+{
+
+//! Pointers to buffers with masks of loaded and stored buffers
+template<typename T>
+struct BufferList
+{
+    T *ptr[MAX_BUFFERS];
+    unsigned load;
+    unsigned store;
+};
+
+//! Apply a single operation to values of buffers
+template<typename T>
+static __device__
+T apply(const op_t<T> &op, T src, T dst)
+{
+    constexpr T zero = 0;
+    switch(op.code)
+    {
+        case opcode_t::ADD:
+            if(op.alpha == zero)
+            {
+                return (op.beta == zero) ? zero : op.beta*dst;
+            }
+            return (op.beta == zero) ? op.alpha*src
+                : op.alpha*src + op.beta*dst;
+        case opcode_t::PROD:
+            return src * dst;
+        case opcode_t::SCAL:
+            return op.alpha * src;
+        case opcode_t::ADD_SCALAR:
+            return (op.beta == zero) ? op.alpha : op.alpha + op.beta*dst;
+        case opcode_t::HYPOT:
+            if(op.alpha == zero)
+            {
+                return (op.beta == zero) ? zero : ::fabs(op.beta*dst);
+            }
+            if(op.beta == zero)
+            {
+                return ::fabs(op.alpha*src);
+            }
+            return ::hypot(op.alpha*src, op.beta*dst);
+        default:
+            return ::sqrt(src);
+    }
+}
+
+template<typename T>
+static __global__
+void cuda_kernel(Index nelems, program_t<T> program, BufferList<T> list)
+{
+    // Every thread keeps values of all buffers for its element, so that
+    // each buffer is loaded and stored at most once
+    const Index stride = Index(blockDim.x) * gridDim.x;
+    for(Index i = threadIdx.x + Index(blockIdx.x)*blockDim.x; i < nelems;
+            i += stride)
+    {
+        T val[MAX_BUFFERS];
+        for(int j = 0; j < program.nbuffers; ++j)
+        {
+            if(list.load & (1u<<j))
+            {
+                val[j] = list.ptr[j][i];
+            }
+        }
+        for(int k = 0; k < program.nops; ++k)
+        {
+            const op_t<T> &op = program.ops[k];
+            val[op.dst] = apply<T>(op, val[op.src], val[op.dst]);
+        }
+        for(int j = 0; j < program.nbuffers; ++j)
+        {
+            if(list.store & (1u<<j))
+            {
+                list.ptr[j][i] = val[j];
+            }
+        }
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index nelems, const program_t<T> &program,
+        T * const *buffers)
+    noexcept
+//! Apply a program of elementwise operations to CUDA buffers
+/*! Parameters are the same as of nntile::kernel::fused_elementwise::cpu(),
+ * while the array of pointers is in the host memory. The program and the
+ * pointers are passed as a kernel parameter, which is limited by 4KB.
+ * */
+{
+    if(nelems == 0)
+    {
+        return;
+    }
+    BufferList<T> list;
+    bool load[MAX_BUFFERS], store[MAX_BUFFERS];
+    get_access<T>(program, load, store);
+    list.load = 0;
+    list.store = 0;
+    for(int j = 0; j < program.nbuffers; ++j)
+    {
+        list.ptr[j] = buffers[j];
+        list.load |= unsigned(load[j]) << j;
+        list.store |= unsigned(store[j]) << j;
+    }
+    dim3 threads(256);
+    dim3 blocks(std::min((nelems+255)/256, Index(65535)));
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(nelems, program, list);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index nelems,
+        const program_t<fp32_t> &program, fp32_t * const *buffers)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index nelems,
+        const program_t<fp64_t> &program, fp64_t * const *buffers)
+    noexcept;
+
+} // namespace fused_elementwise
+} // namespace kernel
+} // namespace nntile
+
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/gelu/cpu.hh"
+#include "nntile/kernel/simd.hh"
 #include <cmath>
 
 namespace nntile
@@ -22,26 +23,90 @@ namespace kernel
 namespace gelu
 {
 
+template<typename T>
+static void cpu_scalar(Index nelems, T *data)
+    noexcept
+//! Inplace GeLU operation without vectorization
+{
+    constexpr T mone = -1, pt5 = 0.5;
+    const T f1 = mone / std::sqrt(T{2.0});
+    for(Index i = 0; i < nelems; ++i)
+    {
+        T z = data[i];
+        T y = std::erfc(f1 * z);
+        data[i] = (pt5 * z) * y;
+    }
+}
+
+#ifdef NNTILE_KERNEL_SIMD_X86
+template<typename T, int W>
+static NNTILE_SIMD_INLINE void cpu_simd(Index nelems, T *data)
+    noexcept
+//! Inplace GeLU operation with vectors of W elements
+/*! Uses nntile::kernel::simd::erfc(), so the result is within 6 ulp of the
+ * scalar version, unless erfc(-z/sqrt(2)) is not a normalized number.
+ * */
+{
+    using V = typename simd::Vec<T, W>::type;
+    constexpr T mone = -1, pt5 = 0.5;
+    const T f1 = mone / std::sqrt(T{2.0});
+    Index i = 0;
+    for(; i+W <= nelems; i += W)
+    {
+        V z = simd::load<T, W>(data+i);
+        V y = simd::erfc<T, W>(f1 * z);
+        simd::store<T, W>((pt5*z) * y, data+i);
+    }
+    // Remaining elements
+    cpu_scalar<T>(nelems-i, data+i);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX2 void cpu_avx2(Index nelems, T *data)
+    noexcept
+{
+    cpu_simd<T, 32/sizeof(T)>(nelems, data);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX512 void cpu_avx512(Index nelems, T *data)
+    noexcept
+{
+    cpu_simd<T, 64/sizeof(T)>(nelems, data);
+}
+#endif // NNTILE_KERNEL_SIMD_X86
+
 template<typename T>
 void cpu(Index nelems, T *data)
     noexcept
 //! Inplace GeLU operation performed on CPU
-/*! Uses very slow std::erfc() function, so consider using approximated version
- * nntile::kernel::cpu::gelutanh(). Does the following per-element operation:
+/*! Does the following per-element operation:
  * GeLU(z) = 0.5 z erfc(-z/sqrt(2))
  *
+ * Vectorized AVX2 or AVX-512 implementation is used if it is supported by
+ * the CPU and allowed by nntile::kernel::simd::set_level(). It relies on a
+ * polynomial approximation of erfc and is within 6 ulp of the scalar
+ * version, that uses very slow std::erfc() function. Consider using
+ * approximated version nntile::kernel::gelutanh::cpu() otherwise.
+ *
  * @params[in] nelems: Number of elements in a buffer
  * @params[inout] data: Buffer to apply GeLU
  * */
 {
-    constexpr T mone = -1, pt5 = 0.5;
-    const T f1 = mone / std::sqrt(T{2.0});
-    for(Index i = 0; i < nelems; ++i)
+#ifdef NNTILE_KERNEL_SIMD_X86
+    switch(simd::get_level())
     {
-        T z = data[i];
-        T y = std::erfc(f1 * z);
-        data[i] = (pt5 * z) * y;
+        case simd::Level::AVX512:
+            cpu_avx512<T>(nelems, data);
+            return;
+        case simd::Level::AVX2:
+            cpu_avx2<T>(nelems, data);
+            return;
+        default:
+            break;
     }
+#endif // NNTILE_KERNEL_SIMD_X86
+    cpu_scalar<T>(nelems, data);
 }
 
 // Explicit instantiation
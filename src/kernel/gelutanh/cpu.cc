@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/gelutanh/cpu.hh"
+#include "nntile/kernel/simd.hh"
 #include <cmath>
 
 namespace nntile
@@ -23,20 +24,9 @@ namespace gelutanh
 {
 
 template<typename T>
-void cpu(Index nelems, const T *src, T *dst)
+static void cpu_scalar(Index nelems, const T *src, T *dst)
     noexcept
-//! Approximate GeLU operation on CPU
-/*! Applies the following approximation of the GeLU function:
- * GeLU(z) \approx AGeLU(z)
- * AGeLU(z) \approx 0.5z(1+tanh(sqrt(2/pi)(z+0.044715z^3))),
- * which is actually implemented as
- * f(z) = -2 sqrt(2/pi) z (1+0.044715z^2)
- * AGeLU(z) = z / (1+exp(f(z))
- *
- * @params[in] nelems: Number of elements in a buffer
- * @params[in] src: Input buffer to apply GeLU
- * @params[out] dst: Output buffer to apply GeLU
- * */
+//! Approximate GeLU operation without vectorization
 {
     // Constants
     constexpr T pi = 3.141592653589793238462643383279502884L,
@@ -59,6 +49,91 @@ void cpu(Index nelems, const T *src, T *dst)
     }
 }
 
+#ifdef NNTILE_KERNEL_SIMD_X86
+template<typename T, int W>
+static NNTILE_SIMD_INLINE void cpu_simd(Index nelems, const T *src, T *dst)
+    noexcept
+//! Approximate GeLU operation with vectors of W elements
+/*! The same operations as in the scalar version with the vectorized
+ * exponent. Both versions round the argument f(z) of the exponent, possibly
+ * in a different way due to fused multiply-add operations, so the result is
+ * within 6+2|f(z)| ulp of the scalar version.
+ * */
+{
+    using V = typename simd::Vec<T, W>::type;
+    constexpr T pi = 3.141592653589793238462643383279502884L,
+        one = 1, f1 = T{0.044715};
+    static const T sqrt_pi = std::sqrt(pi), sqrt_2 = std::sqrt(T{2}),
+        f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1;
+    Index i = 0;
+    for(; i+W <= nelems; i += W)
+    {
+        V z = simd::load<T, W>(src+i);
+        V y1 = f4 * z * z;
+        V y2 = f3 + y1;
+        V c = y1 - (y2-f3);
+        y2 *= z;
+        c *= z;
+        V y3 = one + simd::exp<T, W>(c)*simd::exp<T, W>(y2);
+        simd::store<T, W>(z/y3, dst+i);
+    }
+    // Remaining elements
+    cpu_scalar<T>(nelems-i, src+i, dst+i);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX2 void cpu_avx2(Index nelems, const T *src,
+        T *dst)
+    noexcept
+{
+    cpu_simd<T, 32/sizeof(T)>(nelems, src, dst);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX512 void cpu_avx512(Index nelems, const T *src,
+        T *dst)
+    noexcept
+{
+    cpu_simd<T, 64/sizeof(T)>(nelems, src, dst);
+}
+#endif // NNTILE_KERNEL_SIMD_X86
+
+template<typename T>
+void cpu(Index nelems, const T *src, T *dst)
+    noexcept
+//! Approximate GeLU operation on CPU
+/*! Applies the following approximation of the GeLU function:
+ * GeLU(z) \approx AGeLU(z)
+ * AGeLU(z) \approx 0.5z(1+tanh(sqrt(2/pi)(z+0.044715z^3))),
+ * which is actually implemented as
+ * f(z) = -2 sqrt(2/pi) z (1+0.044715z^2)
+ * AGeLU(z) = z / (1+exp(f(z))
+ *
+ * Vectorized AVX2 or AVX-512 implementation is used if it is supported by
+ * the CPU and allowed by nntile::kernel::simd::set_level(). Its result is
+ * within 6+2|f(z)| ulp of the scalar version.
+ *
+ * @params[in] nelems: Number of elements in a buffer
+ * @params[in] src: Input buffer to apply GeLU
+ * @params[out] dst: Output buffer to apply GeLU
+ * */
+{
+#ifdef NNTILE_KERNEL_SIMD_X86
+    switch(simd::get_level())
+    {
+        case simd::Level::AVX512:
+            cpu_avx512<T>(nelems, src, dst);
+            return;
+        case simd::Level::AVX2:
+            cpu_avx2<T>(nelems, src, dst);
+            return;
+        default:
+            break;
+    }
+#endif // NNTILE_KERNEL_SIMD_X86
+    cpu_scalar<T>(nelems, src, dst);
+}
+
 // Explicit instantiation
 template
 void cpu<fp32_t>(Index nelems, const fp32_t *src, fp32_t *dst)
@@ -14,7 +14,9 @@
  * */
 
 #include "nntile/kernel/gelutanh_backward/cpu.hh"
+#include "nntile/kernel/simd.hh"
 #include <cmath>
+#include <limits>
 
 namespace nntile
 {
@@ -24,18 +26,9 @@ namespace gelutanh_backward
 {
 
 template<typename T>
-void cpu(Index nelems, const T *x, const T *dy, T *dx)
+static void cpu_scalar(Index nelems, const T *x, const T *dy, T *dx)
     noexcept
-//! Backward of approximate GeLU operation on CPU
-/*! Applies the following derivative of approximation of the GeLU function:
- * dx[i] = dx[i] + dy[i]*GeLUtanh'(x[i])
- * GeLUtanh'(z) = (1-(zf'(z)-1)exp(f(z))) / (1+exp(f(z)))^2
- *
- * @params[in] nelems: Number of elements in a buffer
- * @params[in] x: Input value for forward approximate GeLU
- * @params[in] dy: Gradient over output of forward approximate GeLU
- * @params[inout] dx: Gradient over input of forward approximate GeLU
- * */
+//! Backward of approximate GeLU operation without vectorization
 {
     // Constants
     constexpr T pi = 3.141592653589793238462643383279502884L,
@@ -58,6 +51,91 @@ void cpu(Index nelems, const T *x, const T *dy, T *dx)
     }
 }
 
+#ifdef NNTILE_KERNEL_SIMD_X86
+template<typename T, int W>
+static NNTILE_SIMD_INLINE void cpu_simd(Index nelems, const T *x,
+        const T *dy, T *dx)
+    noexcept
+//! Backward of approximate GeLU operation with vectors of W elements
+/*! The derivative is computed as in nntile::kernel::dgelutanh::cpu_simd().
+ * */
+{
+    using V = typename simd::Vec<T, W>::type;
+    constexpr T pi = 3.141592653589793238462643383279502884L,
+        one = 1, f1 = T{0.044715};
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    static const T sqrt_pi = std::sqrt(pi), sqrt_2 = std::sqrt(T{2}),
+        f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1, f5 = T{3}*f4;
+    Index i = 0;
+    for(; i+W <= nelems; i += W)
+    {
+        V z = simd::load<T, W>(x+i);
+        V z2 = z * z;
+        V y1 = z * (f3 + f4*z2);
+        V y2 = z * (f3 + f5*z2);
+        V expy1 = simd::exp<T, W>(y1);
+        V inv_expy1p1 = one / (expy1 + one);
+        V grad = (one-y2*(one-inv_expy1p1)) * inv_expy1p1
+            * simd::load<T, W>(dy+i);
+        V res = simd::load<T, W>(dx+i);
+        res = expy1 == inf ? res : res+grad;
+        simd::store<T, W>(res, dx+i);
+    }
+    // Remaining elements
+    cpu_scalar<T>(nelems-i, x+i, dy+i, dx+i);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX2 void cpu_avx2(Index nelems, const T *x,
+        const T *dy, T *dx)
+    noexcept
+{
+    cpu_simd<T, 32/sizeof(T)>(nelems, x, dy, dx);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX512 void cpu_avx512(Index nelems, const T *x,
+        const T *dy, T *dx)
+    noexcept
+{
+    cpu_simd<T, 64/sizeof(T)>(nelems, x, dy, dx);
+}
+#endif // NNTILE_KERNEL_SIMD_X86
+
+template<typename T>
+void cpu(Index nelems, const T *x, const T *dy, T *dx)
+    noexcept
+//! Backward of approximate GeLU operation on CPU
+/*! Applies the following derivative of approximation of the GeLU function:
+ * dx[i] = dx[i] + dy[i]*GeLUtanh'(x[i])
+ * GeLUtanh'(z) = (1-(zf'(z)-1)exp(f(z))) / (1+exp(f(z)))^2
+ *
+ * Vectorized AVX2 or AVX-512 implementation is used if it is supported by
+ * the CPU and allowed by nntile::kernel::simd::set_level(). Its derivative
+ * is as accurate as in nntile::kernel::dgelutanh::cpu().
+ *
+ * @params[in] nelems: Number of elements in a buffer
+ * @params[in] x: Input value for forward approximate GeLU
+ * @params[in] dy: Gradient over output of forward approximate GeLU
+ * @params[inout] dx: Gradient over input of forward approximate GeLU
+ * */
+{
+#ifdef NNTILE_KERNEL_SIMD_X86
+    switch(simd::get_level())
+    {
+        case simd::Level::AVX512:
+            cpu_avx512<T>(nelems, x, dy, dx);
+            return;
+        case simd::Level::AVX2:
+            cpu_avx2<T>(nelems, x, dy, dx);
+            return;
+        default:
+            break;
+    }
+#endif // NNTILE_KERNEL_SIMD_X86
+    cpu_scalar<T>(nelems, x, dy, dx);
+}
+
 // Explicit instantiation
 template
 void cpu<fp32_t>(Index nelems, const fp32_t *x, const fp32_t *dy, fp32_t *dx)
@@ -37,16 +37,17 @@ void cpu(Index nelems, T *data)
  * @params[inout] data: Buffer to apply GeLU
  * */
 {
+    using Y = compute_t<T>;
     // Constants
-    constexpr T pi = 3.141592653589793238462643383279502884L,
-        one = 1, pt5 = 0.5, f1 = T{0.044715};
+    constexpr Y pi = 3.141592653589793238462643383279502884L,
+        one = 1, pt5 = 0.5, f1 = Y{0.044715};
     // Square root is not constexpr by standard, proceed with a static const
-    static const T sqrt_pi = std::sqrt(pi), sqrt_2 = std::sqrt(T{2}),
-        f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1;
+    static const Y sqrt_pi = std::sqrt(pi), sqrt_2 = std::sqrt(Y{2}),
+        f2 = sqrt_2/sqrt_pi, f3 = -Y{2}*f2, f4 = f3*f1;
     for(Index i = 0; i < nelems; ++i)
     {
-        T z = data[i];
-        T y = z * (f3 + f4*z*z);
+        Y z = data[i];
+        Y y = z * (f3 + f4*z*z);
         data[i] = z / (one+std::exp(y));
     }
 }
@@ -60,6 +61,14 @@ template
 void cpu<fp64_t>(Index nelems, fp64_t *data)
     noexcept;
 
+template
+void cpu<bf16_t>(Index nelems, bf16_t *data)
+    noexcept;
+
+template
+void cpu<fp16_t>(Index nelems, fp16_t *data)
+    noexcept;
+
 } // namespace gelutanh_inplace
 } // namespace kernel
 } // namespace nntile
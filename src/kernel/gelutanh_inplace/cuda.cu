@@ -25,17 +25,18 @@ template<typename T>
 static __global__
 void cuda_kernel(Index nelems, T *data)
 {
+    using Y = compute_t<T>;
     int i = threadIdx.x + blockIdx.x*blockDim.x;
     // Constants
-    constexpr T pi = 3.141592653589793238462643383279502884L,
-        one = 1, f1 = T{0.044715};
+    constexpr Y pi = 3.141592653589793238462643383279502884L,
+        one = 1, f1 = Y{0.044715};
     // Square root is not constexpr by standard, proceed with a static const
-    const T sqrt_pi = sqrt(pi), sqrt_2 = sqrt(T{2}),
-        f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1;
+    const Y sqrt_pi = sqrt(pi), sqrt_2 = sqrt(Y{2}),
+        f2 = sqrt_2/sqrt_pi, f3 = -Y{2}*f2, f4 = f3*f1;
     if(i < nelems)
     {
-        T z = data[i];
-        T y = z * (f3 + f4*z*z);
+        Y z = data[i];
+        Y y = z * (f3 + f4*z*z);
         data[i] = z / (one+::exp(y));
     }
 }
@@ -66,6 +67,14 @@ template
 void cuda<fp64_t>(cudaStream_t stream, Index nelems, fp64_t *data)
     noexcept;
 
+template
+void cuda<bf16_t>(cudaStream_t stream, Index nelems, bf16_t *data)
+    noexcept;
+
+template
+void cuda<fp16_t>(cudaStream_t stream, Index nelems, fp16_t *data)
+    noexcept;
+
 } // namespace gelutanh_inplace
 } // namespace kernel
 } // namespace nntile
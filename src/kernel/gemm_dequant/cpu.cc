@@ -0,0 +1,122 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/gemm_dequant/cpu.cc
+ * Gemm with dequantization of 8-bit weights on the fly on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/gemm_dequant/cpu.hh"
+#include "nntile/kernel/parallel.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace gemm_dequant
+{
+
+//! Number of rows of A, that are dequantized at once
+static constexpr Index block = 256;
+
+template<typename Q>
+static void cpu_range(Index m, Index nrows, Index n, Index k, Index group,
+        fp32_t alpha, const Q *A, const fp32_t *scale, const fp32_t *B,
+        fp32_t beta, fp32_t *C)
+    noexcept
+//! Gemm for rows [0,nrows) of leading dimension m
+{
+    fp32_t col[block];
+    for(Index i0 = 0; i0 < nrows; i0 += block)
+    {
+        Index rows = std::min(block, nrows-i0);
+        // C = beta*C, zero beta does not read C
+        for(Index j = 0; j < n; ++j)
+        {
+            fp32_t *C_col = C + j*m + i0;
+            for(Index i = 0; i < rows; ++i)
+            {
+                C_col[i] = (beta == 0) ? 0 : beta*C_col[i];
+            }
+        }
+        // Rank-1 updates by dequantized columns of A, so that each weight is
+        // read and converted only once
+        for(Index l = 0; l < k; ++l)
+        {
+            const Q *A_col = A + l*m + i0;
+            const fp32_t *scale_col = scale + (l/group)*m + i0;
+            for(Index i = 0; i < rows; ++i)
+            {
+                col[i] = alpha * scale_col[i] * static_cast<fp32_t>(A_col[i]);
+            }
+            for(Index j = 0; j < n; ++j)
+            {
+                const fp32_t B_val = B[j*k+l];
+                fp32_t *C_col = C + j*m + i0;
+                for(Index i = 0; i < rows; ++i)
+                {
+                    C_col[i] += col[i] * B_val;
+                }
+            }
+        }
+    }
+}
+
+template<typename Q>
+void cpu(Index m, Index n, Index k, Index group, fp32_t alpha, const Q *A,
+        const fp32_t *scale, const fp32_t *B, fp32_t beta, fp32_t *C)
+    noexcept
+//! Gemm with dequantization of 8-bit weights on the fly on CPU
+/*! Multiplies a quantized matrix by a single precision one:
+ *      C = alpha * (scale .* A) @ B + beta * C
+ * where scales are shared by groups of consecutive elements of rows of A,
+ * as produced by nntile::kernel::quantize::cpu():
+ *      (scale .* A)[i,l] = scale[i,l/group] * A[i,l]
+ * Weights are never dequantized into memory, so the amount of data read
+ * from A is 4 times smaller than that of an ordinary single precision gemm,
+ * which bounds performance for a small n (e.g., during decoding).
+ *
+ * @param[in] m: Number of rows of A and C
+ * @param[in] n: Number of columns of B and C
+ * @param[in] k: Number of columns of A and rows of B
+ * @param[in] group: Size of groups of scales, that shall divide k
+ * @param[in] alpha: Scalar multiplier of the product
+ * @param[in] A: Input contiguous m-by-k quantized array
+ * @param[in] scale: Input contiguous m-by-(k/group) array of scales
+ * @param[in] B: Input contiguous k-by-n array
+ * @param[in] beta: Scalar multiplier of C
+ * @param[inout] C: Input and output contiguous m-by-n array
+ * */
+{
+    // Rows are split between threads of parallel workers
+    parallel::parallel_for(m, block, [&](Index begin, Index end)
+    {
+        cpu_range<Q>(m, end-begin, n, k, group, alpha, A+begin,
+                scale+begin, B, beta, C+begin);
+    });
+}
+
+// Explicit instantiation
+template
+void cpu<std::int8_t>(Index m, Index n, Index k, Index group, fp32_t alpha,
+        const std::int8_t *A, const fp32_t *scale, const fp32_t *B,
+        fp32_t beta, fp32_t *C)
+    noexcept;
+
+template
+void cpu<fp8_e4m3_t>(Index m, Index n, Index k, Index group, fp32_t alpha,
+        const fp8_e4m3_t *A, const fp32_t *scale, const fp32_t *B,
+        fp32_t beta, fp32_t *C)
+    noexcept;
+
+} // namespace gemm_dequant
+} // namespace kernel
+} // namespace nntile
+
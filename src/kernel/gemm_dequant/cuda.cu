@@ -0,0 +1,132 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/gemm_dequant/cuda.cu
+ * Gemm with dequantization of 8-bit weights on the fly on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/gemm_dequant/cuda.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace gemm_dequant
+{
+
+//! Number of columns of C, that are accumulated by a single thread
+static constexpr int ncols = 8;
+
+template<typename Q>
+static __global__
+void cuda_kernel(Index m, Index n, Index k, Index group, Index j_offset,
+        fp32_t alpha, const Q *A, const fp32_t *scale, const fp32_t *B,
+        fp32_t beta, fp32_t *C)
+//! A single thread computes up to ncols elements of a single row of C
+/*! Neighbouring threads go through neighbouring rows, so that reads of A
+ * and scale are coalesced, while all threads of a block read the same
+ * elements of B.
+ * */
+{
+    Index i = threadIdx.x + Index(blockIdx.x)*blockDim.x;
+    Index j0 = j_offset + Index(blockIdx.y)*ncols;
+    if(i >= m)
+    {
+        return;
+    }
+    Index nj = n - j0;
+    fp32_t acc[ncols];
+#pragma unroll
+    for(int j = 0; j < ncols; ++j)
+    {
+        acc[j] = 0;
+    }
+    const fp32_t *B_block = B + j0*k;
+    for(Index g = 0; g < k; g += group)
+    {
+        // Scale is applied once per group
+        fp32_t part[ncols];
+#pragma unroll
+        for(int j = 0; j < ncols; ++j)
+        {
+            part[j] = 0;
+        }
+        for(Index l = g; l < g+group; ++l)
+        {
+            fp32_t a = static_cast<fp32_t>(A[l*m+i]);
+#pragma unroll
+            for(int j = 0; j < ncols; ++j)
+            {
+                if(j < nj)
+                {
+                    part[j] += a * B_block[j*k+l];
+                }
+            }
+        }
+        fp32_t s = scale[(g/group)*m+i];
+#pragma unroll
+        for(int j = 0; j < ncols; ++j)
+        {
+            acc[j] += s * part[j];
+        }
+    }
+#pragma unroll
+    for(int j = 0; j < ncols; ++j)
+    {
+        if(j < nj)
+        {
+            fp32_t &C_val = C[(j0+j)*m+i];
+            C_val = (beta == 0) ? alpha*acc[j] : alpha*acc[j]+beta*C_val;
+        }
+    }
+}
+
+template<typename Q>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, Index group,
+        fp32_t alpha, const Q *A, const fp32_t *scale, const fp32_t *B,
+        fp32_t beta, fp32_t *C)
+    noexcept
+//! Gemm with dequantization of 8-bit weights on the fly on CUDA
+/*! Parameters are the same as of nntile::kernel::gemm_dequant::cpu().
+ * */
+{
+    if(m == 0 or n == 0)
+    {
+        return;
+    }
+    // Blocks of columns are split between launches, as gridDim.y is limited
+    Index nblocks = (n+ncols-1) / ncols;
+    for(Index b = 0; b < nblocks; b += 65535)
+    {
+        dim3 blocks((m+255)/256, std::min(nblocks-b, Index(65535))),
+             threads(256);
+        (cuda_kernel<Q>)<<<blocks, threads, 0, stream>>>(m, n, k, group,
+                b*ncols, alpha, A, scale, B, beta, C);
+    }
+}
+
+// Explicit instantiation
+template
+void cuda<std::int8_t>(cudaStream_t stream, Index m, Index n, Index k,
+        Index group, fp32_t alpha, const std::int8_t *A, const fp32_t *scale,
+        const fp32_t *B, fp32_t beta, fp32_t *C)
+    noexcept;
+
+template
+void cuda<fp8_e4m3_t>(cudaStream_t stream, Index m, Index n, Index k,
+        Index group, fp32_t alpha, const fp8_e4m3_t *A, const fp32_t *scale,
+        const fp32_t *B, fp32_t beta, fp32_t *C)
+    noexcept;
+
+} // namespace gemm_dequant
+} // namespace kernel
+} // namespace nntile
+
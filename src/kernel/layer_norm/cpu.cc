@@ -0,0 +1,113 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/layer_norm/cpu.cc
+ * Fused layer normalization on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-05
+ * */
+
+#include "nntile/kernel/layer_norm/cpu.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace layer_norm
+{
+
+template<typename T>
+void cpu(Index m, Index n, Index k, T eps, const T *src, const T *gamma,
+        const T *beta, T *mean, T *inv_stddev, T *dst)
+    noexcept
+//! Fused layer normalization along middle axis on CPU
+/*! For a provided m-by-k-by-n input array src computes mean and inverse of
+ * standard deviation along the middle axis by the Welford algorithm, which
+ * needs only a single pass through src, and then normalizes src:
+ *      mean[i,j] = sum_l src[i,l,j] / k
+ *      var[i,j] = sum_l (src[i,l,j]-mean[i,j])^2 / k
+ *      inv_stddev[i,j] = 1 / sqrt(var[i,j]+eps)
+ *      dst[i,l,j] = (src[i,l,j]-mean[i,j])*inv_stddev[i,j]*gamma[l] + beta[l]
+ *
+ * @param[in] m: Size of the first mode of src, dst, mean and inv_stddev
+ * @param[in] n: Size of the last mode of src, dst, mean and inv_stddev
+ * @param[in] k: Size of the middle mode of src and dst, that is normalized
+ * @param[in] eps: Regularization parameter for variance. eps > 0
+ * @param[in] src: Input contiguous m-by-k-by-n array
+ * @param[in] gamma: Scaling factors of size k
+ * @param[in] beta: Shifts of size k
+ * @param[out] mean: Output contiguous m-by-n array of means
+ * @param[out] inv_stddev: Output contiguous m-by-n array of inverses of
+ *      standard deviations
+ * @param[out] dst: Output contiguous m-by-k-by-n array
+ * */
+{
+    constexpr T zero = 0.0, one = 1.0;
+    // Cycle over the last mode
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        const T *src_slice = src + i2*m*k;
+        T *dst_slice = dst + i2*m*k;
+        T *mean_slice = mean + i2*m;
+        // inv_stddev holds sum of squares of deviations until normalization
+        T *ssq_slice = inv_stddev + i2*m;
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            mean_slice[i0] = zero;
+            ssq_slice[i0] = zero;
+        }
+        // Welford updates, that read contiguous rows of the slice
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const T *src_fiber = src_slice + i1*m;
+            const T inv_count = one / T(i1+1);
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                const T val = src_fiber[i0];
+                const T delta = val - mean_slice[i0];
+                mean_slice[i0] += delta * inv_count;
+                ssq_slice[i0] += delta * (val-mean_slice[i0]);
+            }
+        }
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            ssq_slice[i0] = one / std::sqrt(ssq_slice[i0]/T(k)+eps);
+        }
+        // Normalize, scale and shift
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const T *src_fiber = src_slice + i1*m;
+            T *dst_fiber = dst_slice + i1*m;
+            const T gamma_val = gamma[i1], beta_val = beta[i1];
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                dst_fiber[i0] = (src_fiber[i0]-mean_slice[i0])
+                    * ssq_slice[i0] * gamma_val + beta_val;
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, fp32_t eps, const fp32_t *src,
+        const fp32_t *gamma, const fp32_t *beta, fp32_t *mean,
+        fp32_t *inv_stddev, fp32_t *dst)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, fp64_t eps, const fp64_t *src,
+        const fp64_t *gamma, const fp64_t *beta, fp64_t *mean,
+        fp64_t *inv_stddev, fp64_t *dst)
+    noexcept;
+
+} // namespace layer_norm
+} // namespace kernel
+} // namespace nntile
+
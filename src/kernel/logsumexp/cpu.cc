@@ -14,6 +14,7 @@
  * */
 
 #include "nntile/kernel/logsumexp/cpu.hh"
+#include "nntile/kernel/simd.hh"
 #include <cmath>
 
 namespace nntile
@@ -24,7 +25,7 @@ namespace logsumexp
 {
 
 template<typename T>
-void cpu(Index nelems, const T *maxsumexp, T *logsumexp)
+static void cpu_scalar(Index nelems, const T *maxsumexp, T *logsumexp)
     noexcept
 {
     for(Index i = 0; i < nelems; ++i) 
@@ -33,6 +34,71 @@ void cpu(Index nelems, const T *maxsumexp, T *logsumexp)
     }
 }
 
+#ifdef NNTILE_KERNEL_SIMD_X86
+template<typename T, int W>
+static NNTILE_SIMD_INLINE void cpu_simd(Index nelems, const T *maxsumexp,
+        T *logsumexp)
+    noexcept
+{
+    using V = typename simd::Vec<T, W>::type;
+    Index i = 0;
+    for(; i+W <= nelems; i += W)
+    {
+        // Split interleaved maximums and sums
+        T max[W], sum[W];
+        for(Index j = 0; j < W; ++j)
+        {
+            max[j] = maxsumexp[2*(i+j)];
+            sum[j] = maxsumexp[2*(i+j)+1];
+        }
+        V res = simd::load<T, W>(max)
+            + simd::log<T, W>(simd::load<T, W>(sum));
+        simd::store<T, W>(res, logsumexp+i);
+    }
+    cpu_scalar<T>(nelems-i, maxsumexp+2*i, logsumexp+i);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX2 void cpu_avx2(Index nelems,
+        const T *maxsumexp, T *logsumexp)
+    noexcept
+{
+    cpu_simd<T, 32/sizeof(T)>(nelems, maxsumexp, logsumexp);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX512 void cpu_avx512(Index nelems,
+        const T *maxsumexp, T *logsumexp)
+    noexcept
+{
+    cpu_simd<T, 64/sizeof(T)>(nelems, maxsumexp, logsumexp);
+}
+#endif // NNTILE_KERNEL_SIMD_X86
+
+template<typename T>
+void cpu(Index nelems, const T *maxsumexp, T *logsumexp)
+    noexcept
+//! Logarithms of sums of exponents from maximums and sums of exponents
+/*! Vectorized AVX2 or AVX-512 implementation is used if it is supported by
+ * the CPU and allowed by nntile::kernel::simd::set_level().
+ * */
+{
+#ifdef NNTILE_KERNEL_SIMD_X86
+    switch(simd::get_level())
+    {
+        case simd::Level::AVX512:
+            cpu_avx512<T>(nelems, maxsumexp, logsumexp);
+            return;
+        case simd::Level::AVX2:
+            cpu_avx2<T>(nelems, maxsumexp, logsumexp);
+            return;
+        default:
+            break;
+    }
+#endif // NNTILE_KERNEL_SIMD_X86
+    cpu_scalar<T>(nelems, maxsumexp, logsumexp);
+}
+
 // Explicit instantiation
 template
 void cpu<fp32_t>(Index nelems, const fp32_t *maxsumexp, fp32_t *logsumexp)
@@ -13,7 +13,11 @@
  * */
 
 #include "nntile/kernel/maxsumexp/cpu.hh"
+#include "nntile/kernel/simd.hh"
+#include "nntile/kernel/parallel.hh"
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace nntile
 {
@@ -23,32 +27,89 @@ namespace maxsumexp
 {
 
 template<typename T>
-void cpu(Index m, Index n, Index k, const T *src, T *maxsumexp)
+static inline void update(T val, T &max, T &sum, T &c)
     noexcept
-//! Max and sum of exponents along middle axis
-/*! For a provided m-by-k-by-n input array src compute maximums and sums of
- * exponents of slices along second axis with k elements, resulting in
- * 2-by-m-by-n output array maxsumexp.
- *
- * Mnemonically, the following operations are performed:
- *      old[0,i,j] = maxsumexp[0,i,j]
- *      old[1,i,j] = maxsumexp[1,i,j]
- *      maxsumexp[0,i,j] = max(old[0,i,j], max(src[i,:,j]))
- *      maxsumexp[1,i,j] = old[1,i,j]*exp(old[0,i,j]-maxsumexp[0,i,j])
- *          + sum(exp(src[i,:,j]-maxsumexp[0,i,j])))
- *
- * @param[in] m: Size of the first mode of src and the second mode of sumnorm
- *      arrays.
- * @param[in] n: Size of the last mode of src and sumnorm arrays
- * @param[in] k: Size of the middle mode of src array
- * @param[in] src: Input contiguous m-by-k-by-n array
- * @param[inout] maxsumexp: Output contiguous 2-by-m-by-n array, that
- *      accumulates maximums and sums of exponents of slices along middle axis.
- * */
+//! Update max and compensated sum of exponents by a single value
+{
+    constexpr T one = 1;
+    T y, t;
+    // Ignore -inf value, which comes from mask
+    if(std::isinf(val))
+    {
+        return;
+    }
+    // Update max and sum of exponents
+    if(max < val)
+    {
+        //sum = sum*std::exp(max-val) + one;
+        T tmp = std::exp(max-val);
+        y = one - c*tmp;
+        sum *= tmp;
+        t = sum + y;
+        c = (t-sum) - y;
+        sum = t;
+        max = val;
+    }
+    else
+    {
+        //sum += std::exp(val-max);
+        y = std::exp(val-max) - c;
+        t = sum + y;
+        c = (t-sum) - y;
+        sum = t;
+    }
+}
+
+template<typename T>
+static inline void save(compute_t<T> max, compute_t<T> sum, compute_t<T> c,
+        T *maxsumexp)
+    noexcept
+//! Accumulate max and compensated sum of exponents of a slice into output
 {
+    using Y = compute_t<T>;
+    constexpr Y zero = 0;
+    Y y;
+    // Do nothing if all elements are masked out
+    if(std::isinf(max))
+    {
+        return;
+    }
+    Y sum_old = maxsumexp[1];
+    // If old sum is zero then just overwrite it with current sum
+    if(sum_old == zero)
+    {
+        maxsumexp[0] = max;
+        maxsumexp[1] = sum;
+    }
+    // Update non-zero initial sum
+    else
+    {
+        Y max_old = maxsumexp[0];
+        if(max_old < max)
+        {
+            maxsumexp[0] = max;
+            y = sum_old*std::exp(max_old-max) - c;
+            maxsumexp[1] = sum + y;
+        }
+        else
+        {
+            Y tmp = std::exp(max-max_old);
+            y = sum_old - c*tmp;
+            sum *= tmp;
+            maxsumexp[1] = sum + y;
+        }
+    }
+}
+
+template<typename T>
+static void cpu_scalar(Index m, Index n, Index k, const T *src, T *maxsumexp)
+    noexcept
+//! Max and sum of exponents along middle axis without vectorization
+{
+    using Y = compute_t<T>;
     const Index mk = m * k;
     Index dst_offset = 0;
-    constexpr T zero = 0, one = 1;
+    constexpr Y zero = 0, one = 1;
     // Cycle over row of output buffer
     for(Index i2 = 0; i2 < n; ++i2)
     {
@@ -58,77 +119,227 @@ void cpu(Index m, Index n, Index k, const T *src, T *maxsumexp)
             // Get max and sum of exponents of a corresponding slice
             const T *src_slice = src + i2*mk + i1;
             // Init max and sum with the first value
-            T max = src_slice[0];
-            T sum = one, c = zero, y, t;
+            Y max = src_slice[0];
+            Y sum = one, c = zero;
             // Cycle over slice of input buffer
             for(Index i0 = 1; i0 < k; ++i0)
             {
-                // Read value from source
-                T val = src_slice[i0*m];
-                // Ignore -inf value, which comes from mask
-                if(std::isinf(val))
-                {
-                    continue;
-                }
-                // Update max and sum of exponents
-                if(max < val)
-                {
-                    //sum = sum*std::exp(max-val) + one;
-                    T tmp = std::exp(max-val);
-                    y = one - c*tmp;
-                    sum *= tmp;
-                    t = sum + y;
-                    c = (t-sum) - y;
-                    sum = t;
-                    max = val;
-                }
-                else
-                {
-                    //sum += std::exp(val-max);
-                    y = std::exp(val-max) - c;
-                    t = sum + y;
-                    c = (t-sum) - y;
-                    sum = t;
-                }
+                update<Y>(src_slice[i0*m], max, sum, c);
+            }
+            // Save result
+            save<T>(max, sum, c, maxsumexp+dst_offset);
+            dst_offset += 2;
+        }
+    }
+}
+
+#ifdef NNTILE_KERNEL_SIMD_X86
+template<typename T, int W>
+static NNTILE_SIMD_INLINE void update_simd(
+        const typename simd::Vec<T, W>::type &val,
+        typename simd::Vec<T, W>::type &max,
+        typename simd::Vec<T, W>::type &sum,
+        typename simd::Vec<T, W>::type &c)
+    noexcept
+//! Branch-free vector version of update()
+/*! Both branches of update() are merged into sum = sum*scale + add, where
+ * only a single exponent exp(-|val-max|) is computed. Masked out (infinite)
+ * values leave accumulators unchanged.
+ * */
+{
+    using V = typename simd::Vec<T, W>::type;
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    const V one = simd::broadcast<T, W>(1);
+    // Masks are neither combined nor returned from helper functions, as
+    // compilers tend to scalarize such code for AVX-512. Instead, infinite
+    // values are replaced by the current maximum, which is never greater
+    auto skip = simd::abs<T, W>(val) == inf;
+    V v = skip ? max : val;
+    auto greater = max < v;
+    V exp = simd::exp<T, W>(greater ? max-v : v-max);
+    V scale = greater ? exp : one;
+    V add = greater ? one : exp;
+    V y = add - c*scale;
+    V s = sum * scale;
+    V t = s + y;
+    V c_new = (t-s) - y;
+    // Infinite values leave accumulators unchanged
+    sum = skip ? sum : t;
+    c = skip ? c : c_new;
+    max = greater ? v : max;
+}
+
+template<typename T, int W>
+static NNTILE_SIMD_INLINE void cpu_simd(Index m, Index n, Index k,
+        const T *src, T *maxsumexp)
+    noexcept
+//! Max and sum of exponents along middle axis with vectors of W elements
+/*! W slices along the contiguous first mode are reduced at once. If the first
+ * mode is trivial, the middle mode is contiguous and W partial reductions
+ * along it are done instead, which are merged at the end.
+ * */
+{
+    using V = typename simd::Vec<T, W>::type;
+    const Index mk = m * k;
+    const V one = simd::broadcast<T, W>(1);
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        const T *src_slice = src + i2*mk;
+        T *dst_slice = maxsumexp + 2*m*i2;
+        // Vectorize along the middle mode
+        if(m == 1)
+        {
+            if(k < 2*W)
+            {
+                cpu_scalar<T>(1, 1, k, src_slice, dst_slice);
+                continue;
+            }
+            V max_vec = simd::load<T, W>(src_slice), sum_vec = one, c_vec{};
+            Index i0 = W;
+            for(; i0+W <= k; i0 += W)
+            {
+                update_simd<T, W>(simd::load<T, W>(src_slice+i0), max_vec,
+                        sum_vec, c_vec);
+            }
+            // Merge partial results
+            T max_part[W], sum_part[W], c_part[W];
+            simd::store<T, W>(max_vec, max_part);
+            simd::store<T, W>(sum_vec, sum_part);
+            simd::store<T, W>(c_vec, c_part);
+            T max = max_part[0];
+            for(Index j = 1; j < W; ++j)
+            {
+                max = max < max_part[j] ? max_part[j] : max;
             }
-            // Save result, do nothing if all elements are masked out
+            T sum = 0, c = 0;
             if(not std::isinf(max))
             {
-                T sum_old = maxsumexp[dst_offset+1];
-                // If old sum is zero then just overwrite it with current sum
-                if(sum_old == zero)
-                {
-                    maxsumexp[dst_offset] = max;
-                    maxsumexp[dst_offset+1] = sum;
-                }
-                // Update non-zero initial sum
-                else
+                for(Index j = 0; j < W; ++j)
                 {
-                    T max_old = maxsumexp[dst_offset];
-                    if(max_old < max)
-                    {
-                        maxsumexp[dst_offset] = max;
-                        maxsumexp[dst_offset+1] = sum_old*std::exp(max_old-max)
-                            + sum;
-                        y = sum_old*std::exp(max_old-max) - c;
-                        maxsumexp[dst_offset+1] = sum + y;
-                    }
-                    else
-                    {
-                        maxsumexp[dst_offset+1] = sum*std::exp(max-max_old)
-                            + sum_old;
-                        T tmp = std::exp(max-max_old);
-                        y = sum_old - c*tmp;
-                        sum *= tmp;
-                        maxsumexp[dst_offset+1] = sum + y;
-                    }
+                    // Partial sums of fully masked out lanes are ignored here
+                    sum += (sum_part[j]-c_part[j])
+                        * std::exp(max_part[j]-max);
                 }
             }
-            dst_offset += 2;
+            // Remaining elements
+            for(; i0 < k; ++i0)
+            {
+                update<T>(src_slice[i0], max, sum, c);
+            }
+            save<T>(max, sum, c, dst_slice);
+            continue;
+        }
+        // Vectorize along the first mode
+        Index i1 = 0;
+        for(; i1+W <= m; i1 += W)
+        {
+            V max_vec = simd::load<T, W>(src_slice+i1), sum_vec = one, c_vec{};
+            for(Index i0 = 1; i0 < k; ++i0)
+            {
+                update_simd<T, W>(simd::load<T, W>(src_slice+i0*m+i1),
+                        max_vec, sum_vec, c_vec);
+            }
+            T max[W], sum[W], c[W];
+            simd::store<T, W>(max_vec, max);
+            simd::store<T, W>(sum_vec, sum);
+            simd::store<T, W>(c_vec, c);
+            for(Index j = 0; j < W; ++j)
+            {
+                save<T>(max[j], sum[j], c[j], dst_slice+2*(i1+j));
+            }
+        }
+        // Remaining elements of the first mode
+        for(; i1 < m; ++i1)
+        {
+            T max = src_slice[i1], sum = 1, c = 0;
+            for(Index i0 = 1; i0 < k; ++i0)
+            {
+                update<T>(src_slice[i0*m+i1], max, sum, c);
+            }
+            save<T>(max, sum, c, dst_slice+2*i1);
         }
     }
 }
 
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX2 void cpu_avx2(Index m, Index n, Index k,
+        const T *src, T *maxsumexp)
+    noexcept
+{
+    cpu_simd<T, 32/sizeof(T)>(m, n, k, src, maxsumexp);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX512 void cpu_avx512(Index m, Index n, Index k,
+        const T *src, T *maxsumexp)
+    noexcept
+{
+    cpu_simd<T, 64/sizeof(T)>(m, n, k, src, maxsumexp);
+}
+#endif // NNTILE_KERNEL_SIMD_X86
+
+template<typename T>
+static void cpu_range(Index m, Index n, Index k, const T *src, T *maxsumexp)
+    noexcept
+//! Max and sum of exponents on a range of slices
+{
+#ifdef NNTILE_KERNEL_SIMD_X86
+    if constexpr(std::is_same_v<T, compute_t<T>>)
+    {
+        switch(simd::get_level())
+        {
+            case simd::Level::AVX512:
+                cpu_avx512<T>(m, n, k, src, maxsumexp);
+                return;
+            case simd::Level::AVX2:
+                cpu_avx2<T>(m, n, k, src, maxsumexp);
+                return;
+            default:
+                break;
+        }
+    }
+#endif // NNTILE_KERNEL_SIMD_X86
+    cpu_scalar<T>(m, n, k, src, maxsumexp);
+}
+
+template<typename T>
+void cpu(Index m, Index n, Index k, const T *src, T *maxsumexp)
+    noexcept
+//! Max and sum of exponents along middle axis
+/*! For a provided m-by-k-by-n input array src compute maximums and sums of
+ * exponents of slices along second axis with k elements, resulting in
+ * 2-by-m-by-n output array maxsumexp.
+ *
+ * Mnemonically, the following operations are performed:
+ *      old[0,i,j] = maxsumexp[0,i,j]
+ *      old[1,i,j] = maxsumexp[1,i,j]
+ *      maxsumexp[0,i,j] = max(old[0,i,j], max(src[i,:,j]))
+ *      maxsumexp[1,i,j] = old[1,i,j]*exp(old[0,i,j]-maxsumexp[0,i,j])
+ *          + sum(exp(src[i,:,j]-maxsumexp[0,i,j])))
+ *
+ * Vectorized AVX2 or AVX-512 implementation is used if it is supported by
+ * the CPU and allowed by nntile::kernel::simd::set_level(). BF16 input is
+ * processed in single precision without vectorization. Slices along the
+ * last axis are split among threads, allowed by
+ * nntile::kernel::parallel::set_num_threads().
+ *
+ * @param[in] m: Size of the first mode of src and the second mode of sumnorm
+ *      arrays.
+ * @param[in] n: Size of the last mode of src and sumnorm arrays
+ * @param[in] k: Size of the middle mode of src array
+ * @param[in] src: Input contiguous m-by-k-by-n array
+ * @param[inout] maxsumexp: Output contiguous 2-by-m-by-n array, that
+ *      accumulates maximums and sums of exponents of slices along middle axis.
+ * */
+{
+    // Chunks of at least 64K elements are processed by a single thread
+    Index grain = 65536 / std::max<Index>(m*k, 1);
+    parallel::parallel_for(n, grain, [&](Index begin, Index end)
+    {
+        cpu_range<T>(m, end-begin, k, src+m*k*begin, maxsumexp+2*m*begin);
+    });
+}
+
 // Explicit instantiation
 template
 void cpu<fp32_t>(Index m, Index n, Index k, const fp32_t *src,
@@ -140,6 +351,16 @@ void cpu<fp64_t>(Index m, Index n, Index k, const fp64_t *src,
         fp64_t *maxsumexp)
     noexcept;
 
+template
+void cpu<bf16_t>(Index m, Index n, Index k, const bf16_t *src,
+        bf16_t *maxsumexp)
+    noexcept;
+
+template
+void cpu<fp16_t>(Index m, Index n, Index k, const fp16_t *src,
+        fp16_t *maxsumexp)
+    noexcept;
+
 } // namespace maxsumexp
 } // namespace kernel
 } // namespace nntile
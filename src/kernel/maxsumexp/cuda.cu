@@ -13,6 +13,7 @@
  * @date 2023-11-06
  * */
 
+#include <algorithm>
 #include <iostream>
 
 #include "nntile/kernel/maxsumexp/cuda.hh"
@@ -31,7 +32,8 @@ void cuda_kernel(Index m, Index m_per_block, Index n, Index n_per_block,
 {
     Index i1_block = blockIdx.y, i2_block = blockIdx.z,
           i0_start = threadIdx.x, i0_step = blockDim.x;
-    constexpr T zero = 0.0, one = 1.0;
+    using Y = compute_t<T>;
+    constexpr Y zero = 0.0, one = 1.0;
     if(i0_start < k)
     {
         for(Index i1 = i1_block*m_per_block;
@@ -43,13 +45,13 @@ void cuda_kernel(Index m, Index m_per_block, Index n, Index n_per_block,
                 // Get max and sum of exponents of a corresponding slice
                 const T *src_slice = src + i2*mk + i1;
                 // Init max and sum
-                T max_val = src_slice[i0_start*m];
-                T sum_val = one;
+                Y max_val = src_slice[i0_start*m];
+                Y sum_val = one;
                 // Cycle over slice of input buffer
                 for(Index i0 = i0_start+i0_step; i0 < k; i0 += i0_step)
                 {
                     // Read value from source
-                    T val = src_slice[i0*m];
+                    Y val = src_slice[i0*m];
                     // Ignore -inf value, which comes from mask
                     if(::isinf(val))
                     {
@@ -67,8 +69,8 @@ void cuda_kernel(Index m, Index m_per_block, Index n, Index n_per_block,
                     }
                 }
                 // Per-block of threads max and sum of exponents
-                volatile __shared__ T block_max_val;
-                __shared__ T block_sum_val;
+                volatile __shared__ Y block_max_val;
+                __shared__ Y block_sum_val;
                 // Init shared values in the i0_start==0 thread
                 if(i0_start == 0)
                 {
@@ -100,8 +102,8 @@ void cuda_kernel(Index m, Index m_per_block, Index n, Index n_per_block,
                     Index dst_offset = i1 + i2*m;
                     // Now max_val is finite, we need to accumulate sum of exponents
                     // with the data in global memory
-                    T max_output;
-                    T sum_output = maxsumexp[2*dst_offset+1];
+                    Y max_output;
+                    Y sum_output = maxsumexp[2*dst_offset+1];
                     // If data was not yet initialised, just overwrite it
                     if(sum_output == zero)
                     {
@@ -161,6 +163,14 @@ template void LaunchMaxSumExp1<fp64_t>(cudaStream_t stream, Index m, Index n,
                                        Index k, const fp64_t *src,
                                        fp64_t *maxsumexp) noexcept;
 
+template void LaunchMaxSumExp1<bf16_t>(cudaStream_t stream, Index m, Index n,
+                                       Index k, const bf16_t *src,
+                                       bf16_t *maxsumexp) noexcept;
+
+template void LaunchMaxSumExp1<fp16_t>(cudaStream_t stream, Index m, Index n,
+                                       Index k, const fp16_t *src,
+                                       fp16_t *maxsumexp) noexcept;
+
 extern __shared__ float extent[]; // User-managed cache on device.
 
 size_t constexpr kMaxBlockSize = 512;
@@ -437,10 +447,137 @@ template void LaunchMaxSumExp3<fp64_t>(cudaStream_t stream, Index m, Index n,
                                        Index k, const fp64_t *src,
                                        fp64_t *dst) noexcept;
 
+//! Combine max and sum of exponents with another pair.
+template <typename Y>
+__device__ void CombineMaxSumExp(Y &max_val, Y &sum_val, Y max_other,
+                                 Y sum_other) {
+    if (sum_other == Y(0)) {
+        return;
+    }
+    if (sum_val == Y(0)) {
+        max_val = max_other;
+        sum_val = sum_other;
+    } else if (max_val < max_other) {
+        sum_val = sum_val * ::exp(max_val - max_other) + sum_other;
+        max_val = max_other;
+    } else {
+        sum_val += sum_other * ::exp(max_other - max_val);
+    }
+}
+
+//! Coalesced kernel for strided slices.
+//
+//  A block of threads is a 32-by-kBlockK tile, whose rows are 32 consecutive
+//  slices and whose columns stride over the middle axis, so that consecutive
+//  threads of a warp read consecutive elements of memory. Partial maximums
+//  and sums of exponents are combined over columns in shared memory.
+template <typename T, int kBlockK>
+__global__ void MaxSumExpCoalesced(Index m, Index n, Index k,
+                                   T const *__restrict__ src,
+                                   T *__restrict__ maxsumexp) {
+    using Y = compute_t<T>;
+    __shared__ Y block_max[kBlockK][32];
+    __shared__ Y block_sum[kBlockK][32];
+    Index i0 = threadIdx.x + blockIdx.x * 32;
+    for (Index i2 = blockIdx.y; i2 < n; i2 += gridDim.y) {
+        // Online max and sum of exponents, -inf values come from mask
+        Y max_val = -INFINITY, sum_val = 0;
+        if (i0 < m) {
+            T const *src_slice = src + i2 * m * k + i0;
+            for (Index i1 = threadIdx.y; i1 < k; i1 += kBlockK) {
+                Y val = src_slice[i1 * m];
+                if (::isinf(val)) {
+                    continue;
+                }
+                if (max_val < val) {
+                    sum_val = sum_val * ::exp(max_val - val) + Y(1);
+                    max_val = val;
+                } else {
+                    sum_val += ::exp(val - max_val);
+                }
+            }
+        }
+        block_max[threadIdx.y][threadIdx.x] = max_val;
+        block_sum[threadIdx.y][threadIdx.x] = sum_val;
+        __syncthreads();
+#pragma unroll
+        for (int s = kBlockK / 2; s > 0; s /= 2) {
+            if (threadIdx.y < s) {
+                CombineMaxSumExp(block_max[threadIdx.y][threadIdx.x],
+                                 block_sum[threadIdx.y][threadIdx.x],
+                                 block_max[threadIdx.y + s][threadIdx.x],
+                                 block_sum[threadIdx.y + s][threadIdx.x]);
+            }
+            __syncthreads();
+        }
+        // Accumulate with the output, that is not initialized if its sum of
+        // exponents is zero
+        if (threadIdx.y == 0 && i0 < m) {
+            Index dst_offset = i0 + i2 * m;
+            Y max_output = maxsumexp[2 * dst_offset];
+            Y sum_output = maxsumexp[2 * dst_offset + 1];
+            CombineMaxSumExp(max_output, sum_output,
+                             block_max[0][threadIdx.x],
+                             block_sum[0][threadIdx.x]);
+            if (sum_output != Y(0)) {
+                maxsumexp[2 * dst_offset] = max_output;
+                maxsumexp[2 * dst_offset + 1] = sum_output;
+            }
+        }
+    }
+}
+
+template <typename T, int kBlockK>
+static void LaunchMaxSumExpCoalescedBlock(cudaStream_t stream, Index m,
+                                          Index n, Index k, T const *src,
+                                          T *maxsumexp) {
+    dim3 threads(32, kBlockK);
+    dim3 blocks((m + 31) / 32, std::min(n, Index(65535)));
+    (MaxSumExpCoalesced<T, kBlockK>)<<<blocks, threads, 0, stream>>>(
+        m, n, k, src, maxsumexp);
+}
+
+template <typename T>
+void LaunchMaxSumExpCoalesced(cudaStream_t stream, Index m, Index n, Index k,
+                              T const *src, T *maxsumexp) noexcept {
+    // The number of threads along the middle axis depends on its size
+    if (k >= 64) {
+        LaunchMaxSumExpCoalescedBlock<T, 8>(stream, m, n, k, src, maxsumexp);
+    } else {
+        LaunchMaxSumExpCoalescedBlock<T, 2>(stream, m, n, k, src, maxsumexp);
+    }
+}
+
+template void LaunchMaxSumExpCoalesced<fp32_t>(cudaStream_t stream, Index m,
+                                               Index n, Index k,
+                                               const fp32_t *src,
+                                               fp32_t *maxsumexp) noexcept;
+
+template void LaunchMaxSumExpCoalesced<fp64_t>(cudaStream_t stream, Index m,
+                                               Index n, Index k,
+                                               const fp64_t *src,
+                                               fp64_t *maxsumexp) noexcept;
+
+template void LaunchMaxSumExpCoalesced<bf16_t>(cudaStream_t stream, Index m,
+                                               Index n, Index k,
+                                               const bf16_t *src,
+                                               bf16_t *maxsumexp) noexcept;
+
+template void LaunchMaxSumExpCoalesced<fp16_t>(cudaStream_t stream, Index m,
+                                               Index n, Index k,
+                                               const fp16_t *src,
+                                               fp16_t *maxsumexp) noexcept;
+
 template <typename T>
 void cuda(cudaStream_t stream, Index m, Index n, Index k, const T *src,
           T *maxsumexp) noexcept {
-    LaunchMaxSumExp1(stream, m, n, k, src, maxsumexp);
+    // Reads of the reference kernel are strided by m, so wide slices are
+    // processed by the coalesced kernel
+    if (m >= 32 && n > 0) {
+        LaunchMaxSumExpCoalesced(stream, m, n, k, src, maxsumexp);
+    } else {
+        LaunchMaxSumExp1(stream, m, n, k, src, maxsumexp);
+    }
 }
 
 template void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k,
@@ -449,5 +586,11 @@ template void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k,
 template void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k,
                            const fp64_t *src, fp64_t *maxsumexp) noexcept;
 
+template void cuda<bf16_t>(cudaStream_t stream, Index m, Index n, Index k,
+                           const bf16_t *src, bf16_t *maxsumexp) noexcept;
+
+template void cuda<fp16_t>(cudaStream_t stream, Index m, Index n, Index k,
+                           const fp16_t *src, fp16_t *maxsumexp) noexcept;
+
 } // namespace nntile::kernel::maxsumexp
 
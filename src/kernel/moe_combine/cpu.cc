@@ -0,0 +1,102 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/moe_combine/cpu.cc
+ * Weighted scatter of buffers of experts into tokens on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/moe_combine/cpu.hh"
+#include "nntile/kernel/parallel.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace moe_combine
+{
+
+template<typename T>
+void cpu(Index m, Index seq, Index seq_start, Index seq_size,
+        Index batch_start, Index batch_size, Index capacity, Index n_experts,
+        Index expert, const Index *slots, const T *probs, const T *src,
+        T *dst)
+    noexcept
+//! Accumulate a buffer of an expert into tokens of a tile
+/*! For every slot c of the expert, that holds a token t of the tile:
+ *      dst[:, t] += probs[expert, t] * src[:, c],
+ * where weights probs are optional (nullptr means 1).
+ *
+ * Tokens are linear indices t = s + seq*b of positions s within sequences b
+ * of a batch. Slots of the expert with tokens of other tiles are skipped.
+ *
+ * @param[in] m: Size of the first mode of tokens
+ * @param[in] seq: Length of sequences
+ * @param[in] seq_start: Position of the first token of the tile
+ * @param[in] seq_size: Number of positions of the tile
+ * @param[in] batch_start: Sequence of the first token of the tile
+ * @param[in] batch_size: Number of sequences of the tile
+ * @param[in] capacity: Number of slots of an expert
+ * @param[in] n_experts: Number of experts
+ * @param[in] expert: Index of the expert
+ * @param[in] slots: Contiguous capacity-by-n_experts array of tokens of
+ *      experts, see moe_route
+ * @param[in] probs: Contiguous n_experts-by-seq_size-by-batch_size array of
+ *      weights of experts or nullptr
+ * @param[in] src: Contiguous m-by-capacity buffer of the expert
+ * @param[inout] dst: Contiguous m-by-seq_size-by-batch_size tile of tokens
+ * */
+{
+    const Index *expert_slots = slots + expert*capacity;
+    // Tokens of slots of an expert are distinct
+    parallel::parallel_for(capacity, 16, [&](Index begin, Index end)
+    {
+        for(Index c = begin; c < end; ++c)
+        {
+            Index t = expert_slots[c];
+            if(t < 0)
+            {
+                continue;
+            }
+            Index s = t%seq - seq_start, b = t/seq - batch_start;
+            if(s < 0 or s >= seq_size or b < 0 or b >= batch_size)
+            {
+                continue;
+            }
+            Index local = s + b*seq_size;
+            T w = (probs == nullptr) ? T{1} : probs[local*n_experts+expert];
+            const T *src_col = src + c*m;
+            T *dst_col = dst + local*m;
+            for(Index i = 0; i < m; ++i)
+            {
+                dst_col[i] += w * src_col[i];
+            }
+        }
+    });
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index seq, Index seq_start, Index seq_size,
+        Index batch_start, Index batch_size, Index capacity, Index n_experts,
+        Index expert, const Index *slots, const fp32_t *probs,
+        const fp32_t *src, fp32_t *dst)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index seq, Index seq_start, Index seq_size,
+        Index batch_start, Index batch_size, Index capacity, Index n_experts,
+        Index expert, const Index *slots, const fp64_t *probs,
+        const fp64_t *src, fp64_t *dst)
+    noexcept;
+
+} // namespace moe_combine
+} // namespace kernel
+} // namespace nntile
+
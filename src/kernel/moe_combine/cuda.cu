@@ -0,0 +1,111 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/moe_combine/cuda.cu
+ * Weighted scatter of buffers of experts into tokens on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/moe_combine/cuda.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace moe_combine
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, Index seq, Index seq_start, Index seq_size,
+        Index batch_start, Index batch_size, Index capacity, Index n_experts,
+        Index expert, const Index *slots, const T *probs, const T *src,
+        T *dst)
+{
+    Index i = threadIdx.x + blockIdx.x*blockDim.x,
+          c = threadIdx.y + blockIdx.y*blockDim.y;
+    if(i < m and c < capacity)
+    {
+        const Index *expert_slots = slots + expert*capacity;
+        Index t = expert_slots[c];
+        if(t < 0)
+        {
+            return;
+        }
+        Index s = t%seq - seq_start, b = t/seq - batch_start;
+        if(s < 0 or s >= seq_size or b < 0 or b >= batch_size)
+        {
+            return;
+        }
+        Index local = s + b*seq_size;
+        T w = (probs == nullptr) ? T{1} : probs[local*n_experts+expert];
+        dst[local*m+i] += w * src[c*m+i];
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index seq, Index seq_start,
+        Index seq_size, Index batch_start, Index batch_size, Index capacity,
+        Index n_experts, Index expert, const Index *slots, const T *probs,
+        const T *src, T *dst)
+    noexcept
+//! Accumulate a buffer of an expert into tokens of a tile
+/*! For every slot c of the expert, that holds a token t of the tile:
+ *      dst[:, t] += probs[expert, t] * src[:, c],
+ * where weights probs are optional (nullptr means 1).
+ *
+ * Tokens are linear indices t = s + seq*b of positions s within sequences b
+ * of a batch. Slots of the expert with tokens of other tiles are skipped.
+ *
+ * @param[in] m: Size of the first mode of tokens
+ * @param[in] seq: Length of sequences
+ * @param[in] seq_start: Position of the first token of the tile
+ * @param[in] seq_size: Number of positions of the tile
+ * @param[in] batch_start: Sequence of the first token of the tile
+ * @param[in] batch_size: Number of sequences of the tile
+ * @param[in] capacity: Number of slots of an expert
+ * @param[in] n_experts: Number of experts
+ * @param[in] expert: Index of the expert
+ * @param[in] slots: Contiguous capacity-by-n_experts array of tokens of
+ *      experts, see moe_route
+ * @param[in] probs: Contiguous n_experts-by-seq_size-by-batch_size array of
+ *      weights of experts or nullptr
+ * @param[in] src: Contiguous m-by-capacity buffer of the expert
+ * @param[inout] dst: Contiguous m-by-seq_size-by-batch_size tile of tokens
+ * */
+{
+    // One thread per element of a slot
+    dim3 threads(std::min(int(m), 32), std::min(int(capacity), 8));
+    dim3 blocks((m+threads.x-1)/threads.x,
+            (capacity+threads.y-1)/threads.y);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, seq, seq_start,
+            seq_size, batch_start, batch_size, capacity, n_experts, expert,
+            slots, probs, src, dst);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index seq, Index seq_start,
+        Index seq_size, Index batch_start, Index batch_size, Index capacity,
+        Index n_experts, Index expert, const Index *slots, const fp32_t *probs,
+        const fp32_t *src, fp32_t *dst)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index seq, Index seq_start,
+        Index seq_size, Index batch_start, Index batch_size, Index capacity,
+        Index n_experts, Index expert, const Index *slots, const fp64_t *probs,
+        const fp64_t *src, fp64_t *dst)
+    noexcept;
+
+} // namespace moe_combine
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,116 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/moe_combine_backward/cuda.cu
+ * Gradient of weights of experts, that combine tokens on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/moe_combine_backward/cuda.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace moe_combine_backward
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, Index seq, Index seq_start, Index seq_size,
+        Index batch_start, Index batch_size, Index capacity, Index n_experts,
+        Index expert, const Index *slots, const T *dst_grad,
+        const T *src, T *probs_grad)
+{
+    Index c = threadIdx.x + blockIdx.x*blockDim.x;
+    if(c < capacity)
+    {
+        const Index *expert_slots = slots + expert*capacity;
+        Index t = expert_slots[c];
+        if(t < 0)
+        {
+            return;
+        }
+        Index s = t%seq - seq_start, b = t/seq - batch_start;
+        if(s < 0 or s >= seq_size or b < 0 or b >= batch_size)
+        {
+            return;
+        }
+        Index local = s + b*seq_size;
+        const T *src_col = src + c*m;
+        const T *dst_grad_col = dst_grad + local*m;
+        T sum{0};
+        for(Index i = 0; i < m; ++i)
+        {
+            sum += dst_grad_col[i] * src_col[i];
+        }
+        probs_grad[local*n_experts+expert] += sum;
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index seq, Index seq_start,
+        Index seq_size, Index batch_start, Index batch_size, Index capacity,
+        Index n_experts, Index expert, const Index *slots, const T *dst_grad,
+        const T *src, T *probs_grad)
+    noexcept
+//! Accumulate gradient of weights of an expert for tokens of a tile
+/*! For every slot c of the expert, that holds a token t of the tile:
+ *      probs_grad[expert, t] += dot(dst_grad[:, t], src[:, c]),
+ * which is the gradient of weights of moe_combine.
+ *
+ * Tokens are linear indices t = s + seq*b of positions s within sequences b
+ * of a batch. Slots of the expert with tokens of other tiles are skipped.
+ *
+ * @param[in] m: Size of the first mode of tokens
+ * @param[in] seq: Length of sequences
+ * @param[in] seq_start: Position of the first token of the tile
+ * @param[in] seq_size: Number of positions of the tile
+ * @param[in] batch_start: Sequence of the first token of the tile
+ * @param[in] batch_size: Number of sequences of the tile
+ * @param[in] capacity: Number of slots of an expert
+ * @param[in] n_experts: Number of experts
+ * @param[in] expert: Index of the expert
+ * @param[in] slots: Contiguous capacity-by-n_experts array of tokens of
+ *      experts, see moe_route
+ * @param[in] dst_grad: Contiguous m-by-seq_size-by-batch_size tile of
+ *      gradients of combined tokens
+ * @param[in] src: Contiguous m-by-capacity buffer of the expert
+ * @param[inout] probs_grad: Contiguous n_experts-by-seq_size-by-batch_size
+ *      array of gradients of weights of experts
+ * */
+{
+    // One thread per slot
+    dim3 threads(std::min(int(capacity), 256));
+    dim3 blocks((capacity+threads.x-1)/threads.x);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, seq, seq_start,
+            seq_size, batch_start, batch_size, capacity, n_experts, expert,
+            slots, dst_grad, src, probs_grad);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index seq, Index seq_start,
+        Index seq_size, Index batch_start, Index batch_size, Index capacity,
+        Index n_experts, Index expert, const Index *slots,
+        const fp32_t *dst_grad, const fp32_t *src, fp32_t *probs_grad)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index seq, Index seq_start,
+        Index seq_size, Index batch_start, Index batch_size, Index capacity,
+        Index n_experts, Index expert, const Index *slots,
+        const fp64_t *dst_grad, const fp64_t *src, fp64_t *probs_grad)
+    noexcept;
+
+} // namespace moe_combine_backward
+} // namespace kernel
+} // namespace nntile
+
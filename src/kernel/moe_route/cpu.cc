@@ -0,0 +1,91 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/moe_route/cpu.cc
+ * Routing of tokens to experts with a limited capacity on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/moe_route/cpu.hh"
+#include <algorithm>
+#include <vector>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace moe_route
+{
+
+template<typename T>
+void cpu(Index k, Index n_tokens, Index n_experts, Index capacity,
+        const Index *experts, Index *slots, T *load)
+    noexcept
+//! Place tokens into slots of experts, that they are routed to
+/*! Every token is routed to k experts, given by contiguous k-by-n_tokens
+ * array experts. Every expert processes at most capacity tokens, so tokens
+ * take free slots of an expert in order of their choices: first choices of
+ * all the tokens go first, then the second choices and so on. Within a
+ * choice tokens go in order. Tokens, that do not fit into the capacity of
+ * an expert, are dropped by the expert. Negative experts are skipped.
+ *
+ * @param[in] k: Number of experts of a token
+ * @param[in] n_tokens: Number of tokens
+ * @param[in] n_experts: Number of experts
+ * @param[in] capacity: Number of slots of an expert
+ * @param[in] experts: Experts of tokens, e.g. indices of the top-k gating
+ * @param[out] slots: Contiguous capacity-by-n_experts array of tokens of
+ *      experts. Free slots are set to -1.
+ * @param[out] load: Fraction of choices of every expert before tokens are
+ *      dropped, that is used by load-balancing loss
+ * */
+{
+    for(Index i = 0; i < capacity*n_experts; ++i)
+    {
+        slots[i] = -1;
+    }
+    std::vector<Index> count(n_experts, 0);
+    for(Index j = 0; j < k; ++j)
+    {
+        for(Index t = 0; t < n_tokens; ++t)
+        {
+            Index e = experts[t*k+j];
+            if(e < 0 or e >= n_experts)
+            {
+                continue;
+            }
+            if(count[e] < capacity)
+            {
+                slots[e*capacity+count[e]] = t;
+            }
+            ++count[e];
+        }
+    }
+    const Index n_choices = std::max(k*n_tokens, Index(1));
+    for(Index e = 0; e < n_experts; ++e)
+    {
+        load[e] = static_cast<T>(double(count[e]) / double(n_choices));
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index k, Index n_tokens, Index n_experts, Index capacity,
+        const Index *experts, Index *slots, fp32_t *load)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index k, Index n_tokens, Index n_experts, Index capacity,
+        const Index *experts, Index *slots, fp64_t *load)
+    noexcept;
+
+} // namespace moe_route
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,238 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/multi_adam_step/cpu.cc
+ * Fused Adam and AdamW steps on many CPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-02
+ * */
+
+#include "nntile/kernel/multi_adam_step/cpu.hh"
+#include "nntile/kernel/simd.hh"
+#include "nntile/kernel/parallel.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace multi_adam_step
+{
+
+//! Scalar factors of a step, shared by all buffers
+template<typename T>
+struct Factors
+{
+    T alpha, beta, beta_1, sqrt_beta_2, sqrt_1_beta_2, eps;
+    //! Weight decay of gradients (Adam) and scaling of parameters (AdamW)
+    T grad_decay, p_scale;
+    //! Scale of gradients, e.g., for clipping by a global norm
+    T grad_scale;
+};
+
+template<typename T>
+static void cpu_scalar(Index num_elems, Index num_iter, const Factors<T> &c,
+        const T *grad, T *first_moment, T *second_moment, T *p)
+    noexcept
+{
+    for(Index i = 0; i < num_elems; ++i)
+    {
+        T p_val = p[i]*c.p_scale;
+        T grad_val = grad[i]*c.grad_scale + c.grad_decay*p[i];
+        T f_val, s_val;
+        if(num_iter == 1)
+        {
+            f_val = (1-c.beta_1) * grad_val;
+            s_val = c.sqrt_1_beta_2 * std::fabs(grad_val);
+        }
+        else
+        {
+            f_val = c.beta_1*first_moment[i] + (1-c.beta_1)*grad_val;
+            s_val = std::hypot(c.sqrt_beta_2*second_moment[i],
+                    c.sqrt_1_beta_2*grad_val);
+        }
+        first_moment[i] = f_val;
+        second_moment[i] = s_val;
+        p[i] = p_val - c.alpha*f_val/(s_val*c.beta+c.eps);
+    }
+}
+
+#ifdef NNTILE_KERNEL_SIMD_X86
+template<typename T, int W>
+static NNTILE_SIMD_INLINE void cpu_simd(Index num_elems, Index num_iter,
+        const Factors<T> &c, const T *grad, T *first_moment,
+        T *second_moment, T *p)
+    noexcept
+{
+    using V = typename simd::Vec<T, W>::type;
+    Index i = 0;
+    // Moments are not read at the first iteration, as they are not
+    // initialized yet
+    if(num_iter == 1)
+    {
+        for(; i+W <= num_elems; i += W)
+        {
+            V p_val = simd::load<T, W>(p+i);
+            V grad_val = simd::load<T, W>(grad+i)*c.grad_scale
+                + c.grad_decay*p_val;
+            V f_val = (1-c.beta_1) * grad_val;
+            V s_val = c.sqrt_1_beta_2 * simd::abs<T, W>(grad_val);
+            simd::store<T, W>(f_val, first_moment+i);
+            simd::store<T, W>(s_val, second_moment+i);
+            p_val = p_val*c.p_scale - c.alpha*f_val/(s_val*c.beta+c.eps);
+            simd::store<T, W>(p_val, p+i);
+        }
+    }
+    else
+    {
+        for(; i+W <= num_elems; i += W)
+        {
+            V p_val = simd::load<T, W>(p+i);
+            V grad_val = simd::load<T, W>(grad+i)*c.grad_scale
+                + c.grad_decay*p_val;
+            V f_val = c.beta_1*simd::load<T, W>(first_moment+i)
+                + (1-c.beta_1)*grad_val;
+            V s_val = simd::hypot<T, W>(
+                    c.sqrt_beta_2*simd::load<T, W>(second_moment+i),
+                    c.sqrt_1_beta_2*grad_val);
+            simd::store<T, W>(f_val, first_moment+i);
+            simd::store<T, W>(s_val, second_moment+i);
+            p_val = p_val*c.p_scale - c.alpha*f_val/(s_val*c.beta+c.eps);
+            simd::store<T, W>(p_val, p+i);
+        }
+    }
+    cpu_scalar<T>(num_elems-i, num_iter, c, grad+i, first_moment+i,
+            second_moment+i, p+i);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX2 void cpu_avx2(Index num_elems,
+        Index num_iter, const Factors<T> &c, const T *grad, T *first_moment,
+        T *second_moment, T *p)
+    noexcept
+{
+    cpu_simd<T, 32/sizeof(T)>(num_elems, num_iter, c, grad, first_moment,
+            second_moment, p);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX512 void cpu_avx512(Index num_elems,
+        Index num_iter, const Factors<T> &c, const T *grad, T *first_moment,
+        T *second_moment, T *p)
+    noexcept
+{
+    cpu_simd<T, 64/sizeof(T)>(num_elems, num_iter, c, grad, first_moment,
+            second_moment, p);
+}
+#endif // NNTILE_KERNEL_SIMD_X86
+
+template<typename T>
+void cpu(Index ntensors, const Index *num_elems, Index num_iter, T beta_1,
+        T beta_2, T eps, T lr, T weight_decay, bool decoupled,
+        T * const *grad, T * const *first_moment, T * const *second_moment,
+        T * const *p, const T *scalars)
+    noexcept
+//! Fused Adam or AdamW step on many buffers on CPU
+/*! Every buffer is updated as by nntile::kernel::adam_step::cpu() or by
+ * nntile::kernel::adamw_step::cpu(), while scalar factors of the step are
+ * computed only once. Weight decay is applied through factors, so loops
+ * have no branches. Vectorized AVX2 or AVX-512 implementation is used if
+ * it is supported by the CPU and allowed by nntile::kernel::simd::set_level().
+ * It differs from the scalar one by a few ulp due to the vectorized
+ * hypotenuse. Each buffer is split among threads, allowed by
+ * nntile::kernel::parallel::set_num_threads().
+ *
+ * @param[in] ntensors: Number of buffers of each kind
+ * @param[in] num_elems: Number of elements in each of buffers
+ * @param[in] num_iter: current iteration number
+ * @param[in] beta_1: parameter for moving average of first moments
+ * @param[in] beta_2: parameter for moving average of second moments
+ * @param[in] eps: small scalar to avoid division by zero
+ * @param[in] lr: learning rate
+ * @param[in] weight_decay: coefficient for l2 regularizer
+ * @param[in] decoupled: AdamW (true) or Adam (false) weight decay
+ * @param[in] grad: Input buffers of gradients
+ * @param[inout] first_moment: Buffers of first moments
+ * @param[inout] second_moment: Buffers of square roots of second moments
+ * @param[inout] p: Buffers of parameters, that are updated in the end
+ * @param[in] scalars: Optional learning rate and scale of gradients, that
+ *      replace lr and scale gradients before weight decay (see
+ *      nntile::kernel::clip_scale::cpu())
+ * */
+{
+    Factors<T> c;
+    c.grad_scale = 1;
+    if(scalars != nullptr)
+    {
+        lr = scalars[0];
+        c.grad_scale = scalars[1];
+    }
+    c.alpha = lr / (1 - std::pow(beta_1, num_iter));
+    c.beta = 1.0 / std::sqrt(1 - std::pow(beta_2, num_iter));
+    c.beta_1 = beta_1;
+    c.sqrt_beta_2 = std::sqrt(beta_2);
+    c.sqrt_1_beta_2 = std::sqrt(1-beta_2);
+    c.eps = eps;
+    c.grad_decay = decoupled ? T(0) : weight_decay;
+    c.p_scale = decoupled ? 1 - lr*weight_decay : T(1);
+#ifdef NNTILE_KERNEL_SIMD_X86
+    simd::Level level = simd::get_level();
+#endif // NNTILE_KERNEL_SIMD_X86
+    // Cycle over buffers, each of them is split among threads in chunks of
+    // at least 16K elements
+    for(Index j = 0; j < ntensors; ++j)
+    {
+        parallel::parallel_for(num_elems[j], 16384,
+                [&](Index begin, Index end)
+        {
+            Index size = end - begin;
+#ifdef NNTILE_KERNEL_SIMD_X86
+            switch(level)
+            {
+                case simd::Level::AVX512:
+                    cpu_avx512<T>(size, num_iter, c, grad[j]+begin,
+                            first_moment[j]+begin, second_moment[j]+begin,
+                            p[j]+begin);
+                    return;
+                case simd::Level::AVX2:
+                    cpu_avx2<T>(size, num_iter, c, grad[j]+begin,
+                            first_moment[j]+begin, second_moment[j]+begin,
+                            p[j]+begin);
+                    return;
+                default:
+                    break;
+            }
+#endif // NNTILE_KERNEL_SIMD_X86
+            cpu_scalar<T>(size, num_iter, c, grad[j]+begin,
+                    first_moment[j]+begin, second_moment[j]+begin,
+                    p[j]+begin);
+        });
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index ntensors, const Index *num_elems, Index num_iter,
+        fp32_t beta_1, fp32_t beta_2, fp32_t eps, fp32_t lr,
+        fp32_t weight_decay, bool decoupled, fp32_t * const *grad,
+        fp32_t * const *first_moment, fp32_t * const *second_moment,
+        fp32_t * const *p, const fp32_t *scalars)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index ntensors, const Index *num_elems, Index num_iter,
+        fp64_t beta_1, fp64_t beta_2, fp64_t eps, fp64_t lr,
+        fp64_t weight_decay, bool decoupled, fp64_t * const *grad,
+        fp64_t * const *first_moment, fp64_t * const *second_moment,
+        fp64_t * const *p, const fp64_t *scalars)
+    noexcept;
+
+} // namespace multi_adam_step
+} // namespace kernel
+} // namespace nntile
+
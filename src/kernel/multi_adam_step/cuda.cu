@@ -0,0 +1,167 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/multi_adam_step/cuda.cu
+ * Fused Adam and AdamW steps on many CUDA buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-02
+ * */
+
+#include "nntile/kernel/multi_adam_step/cuda.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace multi_adam_step
+{
+
+// Maximal number of buffers of each kind, processed by a single launch. All
+// the pointers are passed as a kernel parameter, which is limited by 4KB.
+static constexpr int MAX_TENSORS = 96;
+
+//! Pointers to buffers and their offsets within the concatenation of buffers
+template<typename T>
+struct TensorList
+{
+    T *grad[MAX_TENSORS];
+    T *first_moment[MAX_TENSORS];
+    T *second_moment[MAX_TENSORS];
+    T *p[MAX_TENSORS];
+    Index offset[MAX_TENSORS+1];
+    int ntensors;
+};
+
+template<typename T>
+static __global__
+void cuda_kernel(TensorList<T> list, Index num_iter, T beta_1, T eps,
+        T weight_decay, bool decoupled, T lr, T bias_1, T beta,
+        T sqrt_beta_2, T sqrt_1_beta_2, const T *scalars)
+{
+    // Learning rate and scale of gradients may be computed on the device
+    T grad_scale = 1;
+    if(scalars != nullptr)
+    {
+        lr = scalars[0];
+        grad_scale = scalars[1];
+    }
+    const T alpha = lr * bias_1;
+    const T p_scale = 1 - lr*weight_decay;
+    // Grid-stride loop over the concatenation of buffers. Indices of a thread
+    // only grow, so the buffer is found by a forward search.
+    const Index total = list.offset[list.ntensors];
+    const Index stride = Index(blockDim.x) * gridDim.x;
+    int j = 0;
+    for(Index k = threadIdx.x + Index(blockIdx.x)*blockDim.x; k < total;
+            k += stride)
+    {
+        while(k >= list.offset[j+1])
+        {
+            ++j;
+        }
+        const Index i = k - list.offset[j];
+        T *first_moment = list.first_moment[j];
+        T *second_moment = list.second_moment[j];
+        T *p = list.p[j];
+        T p_val = p[i], grad_val = list.grad[j][i]*grad_scale;
+        if(weight_decay != 0)
+        {
+            if(decoupled)
+            {
+                p_val *= p_scale;
+            }
+            else
+            {
+                grad_val += weight_decay * p_val;
+            }
+        }
+        T f_val, s_val;
+        if(num_iter == 1)
+        {
+            f_val = (1-beta_1) * grad_val;
+            s_val = sqrt_1_beta_2 * ::fabs(grad_val);
+        }
+        else
+        {
+            f_val = beta_1*first_moment[i] + (1-beta_1)*grad_val;
+            s_val = ::hypot(sqrt_beta_2*second_moment[i],
+                    sqrt_1_beta_2*grad_val);
+        }
+        first_moment[i] = f_val;
+        second_moment[i] = s_val;
+        p[i] = p_val - alpha*f_val/(s_val*beta+eps);
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index ntensors, const Index *num_elems,
+        Index num_iter, T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        bool decoupled, T * const *grad, T * const *first_moment,
+        T * const *second_moment, T * const *p, const T *scalars)
+    noexcept
+//! Fused Adam or AdamW step on many buffers on CUDA
+/*! All the buffers are processed by a single kernel launch for every
+ * MAX_TENSORS of them. Parameters are the same as of
+ * nntile::kernel::multi_adam_step::cpu(), while arrays of pointers and
+ * numbers of elements are in the host memory, while scalars are in the
+ * device memory.
+ * */
+{
+    const T bias_1 = 1 / (1-::pow(beta_1, num_iter));
+    const T beta = 1 / ::sqrt(1 - ::pow(beta_2, num_iter));
+    const T sqrt_beta_2 = ::sqrt(beta_2), sqrt_1_beta_2 = ::sqrt(1-beta_2);
+    TensorList<T> list;
+    for(Index start = 0; start < ntensors; start += MAX_TENSORS)
+    {
+        list.ntensors = std::min(ntensors-start, Index(MAX_TENSORS));
+        list.offset[0] = 0;
+        for(int j = 0; j < list.ntensors; ++j)
+        {
+            list.grad[j] = grad[start+j];
+            list.first_moment[j] = first_moment[start+j];
+            list.second_moment[j] = second_moment[start+j];
+            list.p[j] = p[start+j];
+            list.offset[j+1] = list.offset[j] + num_elems[start+j];
+        }
+        const Index total = list.offset[list.ntensors];
+        if(total == 0)
+        {
+            continue;
+        }
+        dim3 threads(256);
+        dim3 blocks(std::min((total+255)/256, Index(65535)));
+        (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(list, num_iter,
+                beta_1, eps, weight_decay, decoupled, lr, bias_1, beta,
+                sqrt_beta_2, sqrt_1_beta_2, scalars);
+    }
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index ntensors,
+        const Index *num_elems, Index num_iter, fp32_t beta_1, fp32_t beta_2,
+        fp32_t eps, fp32_t lr, fp32_t weight_decay, bool decoupled,
+        fp32_t * const *grad, fp32_t * const *first_moment,
+        fp32_t * const *second_moment, fp32_t * const *p,
+        const fp32_t *scalars)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index ntensors,
+        const Index *num_elems, Index num_iter, fp64_t beta_1, fp64_t beta_2,
+        fp64_t eps, fp64_t lr, fp64_t weight_decay, bool decoupled,
+        fp64_t * const *grad, fp64_t * const *first_moment,
+        fp64_t * const *second_moment, fp64_t * const *p,
+        const fp64_t *scalars)
+    noexcept;
+
+} // namespace multi_adam_step
+} // namespace kernel
+} // namespace nntile
+
@@ -80,6 +80,151 @@ void cuda_kernel(Index m, Index n, Index k, Index mk, T alpha, const T *src,
     }
 }
 
+//! Norms of strided fibers (m>=32) with coalesced loads
+/*! A block of threads is a 32-by-BLOCK_K tile, whose rows are 32 consecutive
+ * fibers and whose columns stride over the middle axis. Consecutive threads
+ * of a warp read consecutive elements of memory. Partial norms are combined
+ * by hypot over columns in the shared memory.
+ * */
+template<typename T, int BLOCK_K>
+static __global__
+void cuda_kernel_coalesced(Index m, Index n, Index k, T alpha, const T *src,
+        T beta, T *dst)
+{
+    constexpr T zero = 0;
+    __shared__ T block_norm[BLOCK_K][32];
+    Index i0 = threadIdx.x + blockIdx.x*32;
+    for(Index i1 = blockIdx.y; i1 < n; i1 += gridDim.y)
+    {
+        // Cycle over fiber elements and accumulate the norm
+        T norm = zero;
+        if(i0 < m)
+        {
+            const T *src_fiber = src + i1*m*k + i0;
+            for(Index i2 = threadIdx.y; i2 < k; i2 += BLOCK_K)
+            {
+                norm = ::hypot(norm, src_fiber[i2*m]);
+            }
+        }
+        // Reduce over columns of the block
+        block_norm[threadIdx.y][threadIdx.x] = norm;
+        __syncthreads();
+#pragma unroll
+        for(int s = BLOCK_K/2; s > 0; s /= 2)
+        {
+            if(threadIdx.y < s)
+            {
+                block_norm[threadIdx.y][threadIdx.x] = ::hypot(
+                        block_norm[threadIdx.y][threadIdx.x],
+                        block_norm[threadIdx.y+s][threadIdx.x]);
+            }
+            __syncthreads();
+        }
+        // Update output value the same way as the generic kernel
+        if(threadIdx.y == 0 and i0 < m)
+        {
+            T &result = dst[i1*m+i0];
+            norm = block_norm[0][threadIdx.x];
+            if(beta == zero)
+            {
+                result = ::fabs(alpha) * norm;
+            }
+            else if(norm > zero)
+            {
+                result = ::hypot(beta*result, alpha*norm);
+            }
+        }
+    }
+}
+
+//! Norms of contiguous fibers (m=1) by a block of BLOCK threads per fiber
+/*! The block size is a template parameter, so the loop over the fiber has a
+ * constant stride and reductions over warps are unrolled by the compiler.
+ * Partial norms are combined by hypot, which avoids overflow and underflow.
+ * */
+template<typename T, int BLOCK>
+static __global__
+void cuda_kernel_m1(Index n, Index k, T alpha, const T *src, T beta, T *dst)
+{
+    constexpr T zero = 0;
+    constexpr int NWARPS = BLOCK / 32;
+    __shared__ T warp_norm[NWARPS];
+    for(Index i1 = blockIdx.x; i1 < n; i1 += gridDim.x)
+    {
+        // Pointer to a corresponding fiber of the source array src
+        const T *src_fiber = src + i1*k;
+        // Cycle over fiber elements and accumulate the norm
+        T norm = zero;
+#pragma unroll 4
+        for(Index i2 = threadIdx.x; i2 < k; i2 += BLOCK)
+        {
+            norm = ::hypot(norm, src_fiber[i2]);
+        }
+        // Reduce within a warp
+#pragma unroll
+        for(int offset = 16; offset > 0; offset /= 2)
+        {
+            norm = ::hypot(norm, __shfl_down_sync(0xffffffff, norm, offset));
+        }
+        // Reduce over warps
+        if constexpr (NWARPS > 1)
+        {
+            if(threadIdx.x % 32 == 0)
+            {
+                warp_norm[threadIdx.x/32] = norm;
+            }
+            __syncthreads();
+            if(threadIdx.x < 32)
+            {
+                norm = (threadIdx.x < NWARPS) ? warp_norm[threadIdx.x] : zero;
+#pragma unroll
+                for(int offset = NWARPS/2; offset > 0; offset /= 2)
+                {
+                    norm = ::hypot(norm,
+                            __shfl_down_sync(0xffffffff, norm, offset));
+                }
+            }
+            // Shared memory is reused by the next fiber
+            __syncthreads();
+        }
+        // Update output value the same way as the generic kernel
+        if(threadIdx.x == 0)
+        {
+            T &result = dst[i1];
+            if(beta == zero)
+            {
+                result = ::fabs(alpha) * norm;
+            }
+            else if(norm > zero)
+            {
+                result = ::hypot(beta*result, alpha*norm);
+            }
+        }
+    }
+}
+
+//! Launch a variant of kernel, specialized by the block size
+template<typename T, int BLOCK>
+static void launch_m1(cudaStream_t stream, Index n, Index k, T alpha,
+        const T *src, T beta, T *dst)
+{
+    dim3 threads(BLOCK);
+    dim3 blocks(std::min(n, Index(65535)));
+    (cuda_kernel_m1<T, BLOCK>)<<<blocks, threads, 0, stream>>>(n, k, alpha,
+            src, beta, dst);
+}
+
+//! Launch a coalesced variant of kernel, specialized by the block size
+template<typename T, int BLOCK_K>
+static void launch_coalesced(cudaStream_t stream, Index m, Index n, Index k,
+        T alpha, const T *src, T beta, T *dst)
+{
+    dim3 threads(32, BLOCK_K);
+    dim3 blocks((m+31)/32, std::min(n, Index(65535)));
+    (cuda_kernel_coalesced<T, BLOCK_K>)<<<blocks, threads, 0, stream>>>(m, n,
+            k, alpha, src, beta, dst);
+}
+
 template<typename T>
 void cuda(cudaStream_t stream, Index m, Index n, Index k, T alpha,
         const T *src, T beta, T *dst)
@@ -101,6 +246,38 @@ void cuda(cudaStream_t stream, Index m, Index n, Index k, T alpha,
  *      accumulates norms along middle axis.
  * */
 {
+    // Long contiguous fibers are reduced by variants, specialized on the
+    // block size, which is chosen by the length of fibers
+    if(m == 1 and k >= 32 and n > 0)
+    {
+        if(k >= 2048)
+        {
+            launch_m1<T, 256>(stream, n, k, alpha, src, beta, dst);
+        }
+        else if(k >= 256)
+        {
+            launch_m1<T, 128>(stream, n, k, alpha, src, beta, dst);
+        }
+        else
+        {
+            launch_m1<T, 32>(stream, n, k, alpha, src, beta, dst);
+        }
+        return;
+    }
+    // Wide slices are reduced with coalesced loads, while the number of
+    // threads along the middle axis is chosen by its size
+    if(m >= 32 and n > 0)
+    {
+        if(k >= 64)
+        {
+            launch_coalesced<T, 8>(stream, m, n, k, alpha, src, beta, dst);
+        }
+        else
+        {
+            launch_coalesced<T, 2>(stream, m, n, k, alpha, src, beta, dst);
+        }
+        return;
+    }
     // Both source and destination are Fortran-contiguous
     dim3 threads(std::min(int(m), 8), std::min(int(n), 8),
             std::min(int(k), 16));
@@ -0,0 +1,153 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/nrm2/cpu.cc
+ * Euclidean norm of a buffer accumulated into a scalar by hypot on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/nrm2/cpu.hh"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace nrm2
+{
+
+//! Sum of squares of a buffer, divided by a scale if SCALED is true
+/*! Every block of elements is summed by independent partial sums, which
+ * compilers turn into vector instructions, and sums of blocks are added
+ * together to keep the rounding error small.
+ * */
+template<typename T, bool SCALED>
+static T sum_squares(Index nelems, const T *src, T scale)
+{
+    constexpr T zero = 0;
+    constexpr int LANES = 16;
+    constexpr Index BLOCK = 1024;
+    T ssq = zero;
+    for(Index i = 0; i < nelems; i += BLOCK)
+    {
+        Index block_end = std::min(nelems, i+BLOCK);
+        T partial[LANES] = {zero};
+        Index j = i;
+        for(; j+LANES <= block_end; j += LANES)
+        {
+            for(int l = 0; l < LANES; ++l)
+            {
+                T val = SCALED ? src[j+l]/scale : src[j+l];
+                partial[l] += val * val;
+            }
+        }
+        for(; j < block_end; ++j)
+        {
+            T val = SCALED ? src[j]/scale : src[j];
+            partial[0] += val * val;
+        }
+        T block_ssq = zero;
+        for(int l = 0; l < LANES; ++l)
+        {
+            block_ssq += partial[l];
+        }
+        ssq += block_ssq;
+    }
+    return ssq;
+}
+
+//! Norm of a buffer by two passes, that do not overflow or underflow
+/*! The first pass finds the maximal absolute value and the second one sums
+ * squares of values divided by it. Infinities and NaNs are propagated as by
+ * the reference BLAS.
+ * */
+template<typename T>
+static T norm_scaled(Index nelems, const T *src, T ssq)
+{
+    constexpr T zero = 0;
+    T scale = zero;
+    for(Index i = 0; i < nelems; ++i)
+    {
+        scale = std::max(scale, std::fabs(src[i]));
+    }
+    // Zero buffer or NaN, that is propagated by the unscaled sum
+    if(scale == zero)
+    {
+        return ssq;
+    }
+    if(std::isinf(scale))
+    {
+        return scale;
+    }
+    return scale * std::sqrt(sum_squares<T, true>(nelems, src, scale));
+}
+
+template<typename T>
+void cpu(Index nelems, T alpha, const T *src, T beta, T *dst)
+    noexcept
+//! Accumulate Euclidean norm of a buffer into a scalar on CPU
+/*! Performs the following operation:
+ *      dst[0] = hypot(alpha*norm(src), beta*dst[0]),
+ * where dst[0] is not read if beta is zero. Squares are summed directly in
+ * a single vectorized pass, which is valid while the sum stays far from
+ * both ends of the range of normal values. Otherwise the norm is recomputed
+ * by a slower two-pass algorithm, which happens only for very large or very
+ * small values, zeros, infinities and NaNs.
+ *
+ * @param[in] nelems: Number of elements of the src buffer
+ * @param[in] alpha: Scalar multiplier for the norm of src
+ * @param[in] src: Input buffer
+ * @param[in] beta: Scalar multiplier for the dst value
+ * @param[inout] dst: Scalar to accumulate the norm
+ * */
+{
+    constexpr T zero = 0;
+    // Smallest sum of squares, whose terms are not damaged by underflow
+    constexpr T ssq_min = std::numeric_limits<T>::min()
+        / std::numeric_limits<T>::epsilon();
+    constexpr T ssq_max = std::numeric_limits<T>::max();
+    T ssq = sum_squares<T, false>(nelems, src, T(1));
+    T norm;
+    // This condition is false for NaN
+    if(ssq >= ssq_min and ssq <= ssq_max)
+    {
+        norm = std::sqrt(ssq);
+    }
+    else
+    {
+        norm = norm_scaled(nelems, src, ssq);
+    }
+    norm *= std::fabs(alpha);
+    if(beta == zero)
+    {
+        dst[0] = norm;
+    }
+    else
+    {
+        dst[0] = std::hypot(norm, beta*dst[0]);
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index nelems, fp32_t alpha, const fp32_t *src, fp32_t beta,
+        fp32_t *dst)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index nelems, fp64_t alpha, const fp64_t *src, fp64_t beta,
+        fp64_t *dst)
+    noexcept;
+
+} // namespace nrm2
+} // namespace kernel
+} // namespace nntile
+
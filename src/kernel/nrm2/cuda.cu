@@ -0,0 +1,200 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/nrm2/cuda.cu
+ * Euclidean norm of a buffer accumulated into a scalar by hypot on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/nrm2/cuda.hh"
+#include <limits>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace nrm2
+{
+
+//! Reduce a value over a block by warp shuffles and the shared memory
+/*! Result is valid only in the first thread of the block. Combination is
+ * either sum or hypot, depending on the template parameter.
+ * */
+template<typename T, int BLOCK, bool HYPOT>
+static __device__
+T block_reduce(T val, T *shared)
+{
+    constexpr T zero = 0;
+    constexpr int NWARPS = BLOCK / 32;
+#pragma unroll
+    for(int offset = 16; offset > 0; offset /= 2)
+    {
+        T other = __shfl_down_sync(0xffffffff, val, offset);
+        val = HYPOT ? ::hypot(val, other) : val+other;
+    }
+    if constexpr (NWARPS > 1)
+    {
+        if(threadIdx.x % 32 == 0)
+        {
+            shared[threadIdx.x/32] = val;
+        }
+        __syncthreads();
+        if(threadIdx.x < 32)
+        {
+            val = (threadIdx.x < NWARPS) ? shared[threadIdx.x] : zero;
+#pragma unroll
+            for(int offset = NWARPS/2; offset > 0; offset /= 2)
+            {
+                T other = __shfl_down_sync(0xffffffff, val, offset);
+                val = HYPOT ? ::hypot(val, other) : val+other;
+            }
+        }
+        // Shared memory can be reused after this barrier
+        __syncthreads();
+    }
+    return val;
+}
+
+//! Norms of parts of a buffer, one part per block
+/*! Threads of all blocks stride over the buffer with coalesced loads and
+ * sum squares directly. If the sum of a block is out of the safe range, the
+ * block recomputes norms of elements of its threads by two passes and
+ * combines them by hypot. Norm of the part of a block is stored in work.
+ * */
+template<typename T, int BLOCK>
+static __global__
+void cuda_kernel_blocks(Index nelems, const T *src, T ssq_min, T ssq_max,
+        T *work)
+{
+    constexpr T zero = 0;
+    __shared__ T shared[BLOCK/32];
+    __shared__ bool fallback;
+    Index start = threadIdx.x + Index(blockIdx.x)*BLOCK,
+          step = Index(BLOCK) * gridDim.x;
+    T ssq = zero;
+    for(Index i = start; i < nelems; i += step)
+    {
+        T val = src[i];
+        ssq += val * val;
+    }
+    ssq = block_reduce<T, BLOCK, false>(ssq, shared);
+    if(threadIdx.x == 0)
+    {
+        // This condition is true for NaN
+        fallback = not (ssq >= ssq_min and ssq <= ssq_max);
+        if(not fallback)
+        {
+            work[blockIdx.x] = ::sqrt(ssq);
+        }
+    }
+    __syncthreads();
+    if(not fallback)
+    {
+        return;
+    }
+    // Two passes over elements of a thread
+    T scale = zero;
+    for(Index i = start; i < nelems; i += step)
+    {
+        scale = ::fmax(scale, ::fabs(src[i]));
+    }
+    T norm = scale;
+    if(scale != zero and not isinf(scale))
+    {
+        T scaled_ssq = zero;
+        for(Index i = start; i < nelems; i += step)
+        {
+            T val = src[i] / scale;
+            scaled_ssq += val * val;
+        }
+        norm = scale * ::sqrt(scaled_ssq);
+    }
+    norm = block_reduce<T, BLOCK, true>(norm, shared);
+    if(threadIdx.x == 0)
+    {
+        // NaN of the direct sum is propagated if all values are zero or NaN
+        work[blockIdx.x] = (norm == zero) ? ssq : norm;
+    }
+}
+
+//! Combine norms of parts and accumulate the result into dst by hypot
+template<typename T, int BLOCK>
+static __global__
+void cuda_kernel_finalize(T alpha, T beta, T *dst, Index nwork,
+        const T *work)
+{
+    constexpr T zero = 0;
+    __shared__ T shared[BLOCK/32];
+    T norm = zero;
+    for(Index i = threadIdx.x; i < nwork; i += BLOCK)
+    {
+        norm = ::hypot(norm, work[i]);
+    }
+    norm = block_reduce<T, BLOCK, true>(norm, shared);
+    if(threadIdx.x == 0)
+    {
+        norm *= ::fabs(alpha);
+        if(beta == zero)
+        {
+            dst[0] = norm;
+        }
+        else
+        {
+            dst[0] = ::hypot(norm, beta*dst[0]);
+        }
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index nelems, T alpha, const T *src, T beta,
+        T *dst, Index nwork, T *work)
+    noexcept
+//! Accumulate Euclidean norm of a buffer into a scalar on CUDA
+/*! Performs the same operation as nntile::kernel::nrm2::cpu(). The buffer
+ * is split among nwork blocks of threads, that store norms of their parts
+ * into the temporary buffer work, and the second kernel combines them in a
+ * fixed order, so the result is deterministic.
+ *
+ * @param[in] nelems: Number of elements of the src buffer
+ * @param[in] alpha: Scalar multiplier for the norm of src
+ * @param[in] src: Input buffer
+ * @param[in] beta: Scalar multiplier for the dst value
+ * @param[inout] dst: Scalar to accumulate the norm
+ * @param[in] nwork: Number of blocks of threads and size of work
+ * @param[out] work: Temporary buffer for norms of parts of src
+ * */
+{
+    constexpr int BLOCK = 256;
+    // Safe range of the direct sum of squares, as in the CPU kernel
+    constexpr T ssq_min = std::numeric_limits<T>::min()
+        / std::numeric_limits<T>::epsilon();
+    constexpr T ssq_max = std::numeric_limits<T>::max();
+    (cuda_kernel_blocks<T, BLOCK>)<<<nwork, BLOCK, 0, stream>>>(nelems, src,
+            ssq_min, ssq_max, work);
+    (cuda_kernel_finalize<T, BLOCK>)<<<1, BLOCK, 0, stream>>>(alpha, beta,
+            dst, nwork, work);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index nelems, fp32_t alpha,
+        const fp32_t *src, fp32_t beta, fp32_t *dst, Index nwork,
+        fp32_t *work)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index nelems, fp64_t alpha,
+        const fp64_t *src, fp64_t beta, fp64_t *dst, Index nwork,
+        fp64_t *work)
+    noexcept;
+
+} // namespace nrm2
+} // namespace kernel
+} // namespace nntile
+
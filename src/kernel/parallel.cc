@@ -0,0 +1,62 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/parallel.cc
+ * Intra-task parallelism of CPU kernels with OpenMP
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/parallel.hh"
+#ifdef NNTILE_USE_OPENMP
+#   include <omp.h>
+#endif // NNTILE_USE_OPENMP
+
+namespace nntile
+{
+namespace kernel
+{
+namespace parallel
+{
+
+//! Number of threads allowed for the current thread
+static thread_local int num_threads = 1;
+
+//! Get number of threads for CPU kernels called by the current thread
+int get_num_threads()
+    noexcept
+{
+#ifdef NNTILE_USE_OPENMP
+    return num_threads;
+#else // NNTILE_USE_OPENMP
+    return 1;
+#endif // NNTILE_USE_OPENMP
+}
+
+//! Set number of threads for CPU kernels called by the current thread
+/*! The value is also passed to OpenMP, so that multi-threaded BLAS built
+ * with OpenMP uses the same number of threads.
+ *
+ * @param[in] nthreads: Number of threads, values below 1 are replaced by 1
+ * @return Previous number of threads
+ * */
+int set_num_threads(int nthreads)
+    noexcept
+{
+    int old = num_threads;
+    num_threads = nthreads < 1 ? 1 : nthreads;
+#ifdef NNTILE_USE_OPENMP
+    omp_set_num_threads(num_threads);
+#endif // NNTILE_USE_OPENMP
+    return old;
+}
+
+} // namespace parallel
+} // namespace kernel
+} // namespace nntile
+
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/prod/cpu.hh"
+#include "nntile/kernel/simd.hh"
 
 namespace nntile
 {
@@ -32,11 +33,16 @@ void cpu(Index nelems, const T *src, T *dst)
  * @param[inout] dst: Input buffers that contains output in the end
  * */
 {
-    // Cycle over buffers
-    for(Index i = 0; i < nelems; ++i)
+    using Y = compute_t<T>;
+    // Loops are auto-vectorized for the instruction set of CPU kernels
+    simd::dispatch([&]() NNTILE_SIMD_LOOP
     {
-        dst[i] *= src[i];
-    }
+        // Cycle over buffers
+        for(Index i = 0; i < nelems; ++i)
+        {
+            dst[i] = static_cast<Y>(dst[i]) * static_cast<Y>(src[i]);
+        }
+    });
 }
 
 // Explicit instantiation
@@ -48,6 +54,14 @@ template
 void cpu<fp64_t>(Index nelems, const fp64_t *src, fp64_t *dst)
     noexcept;
 
+template
+void cpu<bf16_t>(Index nelems, const bf16_t *src, bf16_t *dst)
+    noexcept;
+
+template
+void cpu<fp16_t>(Index nelems, const fp16_t *src, fp16_t *dst)
+    noexcept;
+
 } // namespace prod
 } // namespace kernel
 } // namespace nntile
@@ -25,10 +25,11 @@ template<typename T>
 static __global__
 void cuda_kernel(Index nelems, const T *src, T *dst)
 {
+    using Y = compute_t<T>;
     int i = threadIdx.x + blockIdx.x*blockDim.x;
     if(i < nelems)
     {
-        dst[i] *= src[i];
+        dst[i] = static_cast<Y>(dst[i]) * static_cast<Y>(src[i]);
     }
 }
 
@@ -58,6 +59,16 @@ void cuda<fp64_t>(cudaStream_t stream, Index nelems, const fp64_t *src,
         fp64_t *dst)
     noexcept;
 
+template
+void cuda<bf16_t>(cudaStream_t stream, Index nelems, const bf16_t *src,
+        bf16_t *dst)
+    noexcept;
+
+template
+void cuda<fp16_t>(cudaStream_t stream, Index nelems, const fp16_t *src,
+        fp16_t *dst)
+    noexcept;
+
 } // namespace prod
 } // namespace kernel
 } // namespace nntile
@@ -21,6 +21,35 @@ namespace kernel
 namespace prod_fiber
 {
 
+//! Product with a broadcasted fiber with a compile-time first mode
+/*! If M is non-zero, it is the size of the first mode, which makes the
+ * innermost loop fully known to the compiler. Zero M means a runtime size.
+ * */
+template<Index M, typename T>
+static void cpu_m(Index m_, Index n, Index k, T alpha, const T *src, T *dst)
+    noexcept
+{
+    const Index m = (M > 0) ? M : m_;
+    // Cycle over the third axis of output buffer, so that the output is
+    // traversed contiguously
+    for(Index i1 = 0; i1 < n; ++i1)
+    {
+        // Cycle over input src vector
+        for(Index i2 = 0; i2 < k; ++i2)
+        {
+            const T src_val = alpha * src[i2];
+            // Output fiber to be updated
+            T *dst_fiber = dst + (i1*k+i2)*m;
+            // Cycle over the output fiber
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                // Update output value
+                dst_fiber[i0] *= src_val;
+            }
+        }
+    }
+}
+
 template<typename T>
 void cpu(Index m, Index n, Index k, T alpha, const T *src, T *dst)
     noexcept
@@ -28,6 +57,8 @@ void cpu(Index m, Index n, Index k, T alpha, const T *src, T *dst)
 /*! Performs the following operations:
  *      dst[i,l,j] = alpha * dst[i,l,j] * src[l]
  *
+ * Common sizes of the first mode are dispatched to specialized loops.
+ *
  * @param[in] m: Size of the first mode of dst tensor
  * @param[in] n: Size of the last mode of dst tensor
  * @param[in] k: Size of the middle mode of dst tensor and the only mode of src
@@ -37,22 +68,22 @@ void cpu(Index m, Index n, Index k, T alpha, const T *src, T *dst)
  * @param[inout] dst: Input and output contiguous m-by-k-by-n array
  * */
 {
-    // Cycle over input src vector
-    for(Index i2 = 0; i2 < k; ++i2)
+    switch(m)
     {
-        const T src_val = alpha * src[i2];
-        // Cycle over the third axis of output buffer
-        for(Index i1 = 0; i1 < n; ++i1)
-        {
-            // Output fiber to be updated
-            T *dst_fiber = dst + (i1*k+i2)*m;
-            // Cycle over the output fiber
-            for(Index i0 = 0; i0 < m; ++i0)
-            {
-                // Update output value
-                dst_fiber[i0] *= src_val;
-            }
-        }
+        case 16:
+            cpu_m<16, T>(m, n, k, alpha, src, dst);
+            break;
+        case 32:
+            cpu_m<32, T>(m, n, k, alpha, src, dst);
+            break;
+        case 64:
+            cpu_m<64, T>(m, n, k, alpha, src, dst);
+            break;
+        case 128:
+            cpu_m<128, T>(m, n, k, alpha, src, dst);
+            break;
+        default:
+            cpu_m<0, T>(m, n, k, alpha, src, dst);
     }
 }
 
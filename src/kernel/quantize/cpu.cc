@@ -0,0 +1,125 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/quantize/cpu.cc
+ * Quantization of weights into 8-bit types with per-group scales on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/quantize/cpu.hh"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace quantize
+{
+
+//! Largest quantized value by modulus
+template<typename Q>
+static constexpr fp32_t qmax = 0;
+
+template<>
+constexpr fp32_t qmax<std::int8_t> = 127;
+
+template<>
+constexpr fp32_t qmax<fp8_e4m3_t> = 448;
+
+//! Round a value, that is already scaled into the range of Q
+template<typename Q>
+static inline Q round(fp32_t x)
+    noexcept
+{
+    if constexpr(std::is_same_v<Q, std::int8_t>)
+    {
+        // Scaled values may exceed 127 only by a rounding error
+        return static_cast<Q>(std::clamp(std::nearbyint(x), -qmax<Q>,
+                    qmax<Q>));
+    }
+    else
+    {
+        return Q(x);
+    }
+}
+
+template<typename Q>
+void cpu(Index m, Index k, Index group, const fp32_t *src, Q *dst,
+        fp32_t *scale)
+    noexcept
+//! Quantization of weights into 8-bit types with per-group scales on CPU
+/*! Each row of a column-major m-by-k matrix is split into groups of
+ * consecutive elements. All the elements of a group share the same scale,
+ * so that the largest element by modulus becomes the largest value of Q:
+ *      scale[i,g] = max(abs(src[i,g*group:(g+1)*group])) / qmax
+ *      dst[i,l] = round(src[i,l] / scale[i,l/group])
+ * where qmax is 127 for int8 and 448 for FP8 E4M3. Rows of zeros get zero
+ * scales. Per-channel quantization corresponds to group=k.
+ *
+ * @param[in] m: Number of rows of src and dst
+ * @param[in] k: Number of columns of src and dst
+ * @param[in] group: Size of groups, that shall divide k
+ * @param[in] src: Input contiguous m-by-k array
+ * @param[out] dst: Output contiguous m-by-k array
+ * @param[out] scale: Output contiguous m-by-(k/group) array of scales
+ * */
+{
+    for(Index g = 0; g < k/group; ++g)
+    {
+        const fp32_t *src_group = src + g*group*m;
+        Q *dst_group = dst + g*group*m;
+        fp32_t *scale_fiber = scale + g*m;
+        // Largest absolute values of rows of the group
+        for(Index i = 0; i < m; ++i)
+        {
+            scale_fiber[i] = 0;
+        }
+        for(Index l = 0; l < group; ++l)
+        {
+            for(Index i = 0; i < m; ++i)
+            {
+                scale_fiber[i] = std::max(scale_fiber[i],
+                        std::abs(src_group[l*m+i]));
+            }
+        }
+        // Quantize, the conversion is done once per weight, so division is
+        // not replaced by a multiplication
+        for(Index l = 0; l < group; ++l)
+        {
+            for(Index i = 0; i < m; ++i)
+            {
+                fp32_t amax = scale_fiber[i];
+                fp32_t x = (amax > 0) ? src_group[l*m+i]*qmax<Q>/amax : 0;
+                dst_group[l*m+i] = round<Q>(x);
+            }
+        }
+        for(Index i = 0; i < m; ++i)
+        {
+            scale_fiber[i] /= qmax<Q>;
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<std::int8_t>(Index m, Index k, Index group, const fp32_t *src,
+        std::int8_t *dst, fp32_t *scale)
+    noexcept;
+
+template
+void cpu<fp8_e4m3_t>(Index m, Index k, Index group, const fp32_t *src,
+        fp8_e4m3_t *dst, fp32_t *scale)
+    noexcept;
+
+} // namespace quantize
+} // namespace kernel
+} // namespace nntile
+
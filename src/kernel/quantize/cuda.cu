@@ -0,0 +1,108 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/quantize/cuda.cu
+ * Quantization of weights into 8-bit types with per-group scales on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/quantize/cuda.hh"
+#include <algorithm>
+#include <type_traits>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace quantize
+{
+
+//! Largest quantized value by modulus
+template<typename Q>
+static constexpr fp32_t qmax = 0;
+
+template<>
+constexpr fp32_t qmax<std::int8_t> = 127;
+
+template<>
+constexpr fp32_t qmax<fp8_e4m3_t> = 448;
+
+template<typename Q>
+static __global__
+void cuda_kernel(Index m, Index group, Index g_offset, const fp32_t *src,
+        Q *dst, fp32_t *scale)
+//! A single thread quantizes a single group of a single row
+{
+    Index i = threadIdx.x + Index(blockIdx.x)*blockDim.x;
+    Index g = g_offset + blockIdx.y;
+    if(i >= m)
+    {
+        return;
+    }
+    const fp32_t *src_group = src + g*group*m + i;
+    Q *dst_group = dst + g*group*m + i;
+    fp32_t amax = 0;
+    for(Index l = 0; l < group; ++l)
+    {
+        amax = ::fmaxf(amax, ::fabsf(src_group[l*m]));
+    }
+    for(Index l = 0; l < group; ++l)
+    {
+        fp32_t x = (amax > 0) ? src_group[l*m]*qmax<Q>/amax : 0;
+        if constexpr(std::is_same_v<Q, std::int8_t>)
+        {
+            dst_group[l*m] = static_cast<Q>(::fminf(::fmaxf(::rintf(x),
+                            -qmax<Q>), qmax<Q>));
+        }
+        else
+        {
+            dst_group[l*m] = Q(x);
+        }
+    }
+    scale[g*m+i] = amax / qmax<Q>;
+}
+
+template<typename Q>
+void cuda(cudaStream_t stream, Index m, Index k, Index group,
+        const fp32_t *src, Q *dst, fp32_t *scale)
+    noexcept
+//! Quantization of weights into 8-bit types with per-group scales on CUDA
+/*! Parameters are the same as of nntile::kernel::quantize::cpu().
+ * */
+{
+    Index ngroups = k / group;
+    if(m == 0 or ngroups == 0)
+    {
+        return;
+    }
+    // Groups are split between launches, as gridDim.y is limited
+    for(Index g = 0; g < ngroups; g += 65535)
+    {
+        dim3 blocks((m+255)/256, std::min(ngroups-g, Index(65535))),
+             threads(256);
+        (cuda_kernel<Q>)<<<blocks, threads, 0, stream>>>(m, group, g, src,
+                dst, scale);
+    }
+}
+
+// Explicit instantiation
+template
+void cuda<std::int8_t>(cudaStream_t stream, Index m, Index k, Index group,
+        const fp32_t *src, std::int8_t *dst, fp32_t *scale)
+    noexcept;
+
+template
+void cuda<fp8_e4m3_t>(cudaStream_t stream, Index m, Index k, Index group,
+        const fp32_t *src, fp8_e4m3_t *dst, fp32_t *scale)
+    noexcept;
+
+} // namespace quantize
+} // namespace kernel
+} // namespace nntile
+
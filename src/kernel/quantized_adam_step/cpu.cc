@@ -0,0 +1,143 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/quantized_adam_step/cpu.cc
+ * Fused Adam step with block-wise 8-bit moments on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/quantized_adam_step/cpu.hh"
+#include "nntile/kernel/parallel.hh"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace quantized_adam_step
+{
+
+//! Largest values of types of moments
+static constexpr fp32_t first_qmax = 127, second_qmax = 448;
+
+void cpu(Index num_iter, Index num_elems, Index block, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t lr, fp32_t weight_decay,
+        bool decoupled, const fp32_t *grad, std::int8_t *first_moment,
+        fp32_t *first_scale, fp8_e4m3_t *second_moment, fp32_t *second_scale,
+        fp32_t *p)
+    noexcept
+//! Fused Adam or AdamW step with block-wise 8-bit moments on CPU
+/*! Buffers are split into blocks of consecutive elements, the last block
+ * may be incomplete. Each block of moments is stored with its own scale, so
+ * that the largest element of the block by modulus becomes the largest
+ * value of the type: first moments are stored in int8, and square roots of
+ * second moments (see kernel::adam_step) are stored in FP8 E4M3, as they
+ * span a much wider range. A block is dequantized, updated the same way as
+ * by kernel::adam_step (or kernel::adamw_step if decoupled is true) and
+ * quantized back with a new scale, while parameters are updated with the
+ * moments before their quantization. Blocks are split among threads,
+ * allowed by nntile::kernel::parallel::set_num_threads().
+ *
+ * @param[in] num_iter: Current iteration number, starting from 1. Moments
+ *      and their scales are not read at the first iteration.
+ * @param[in] num_elems: Number of elements in buffers
+ * @param[in] block: Number of elements of a block
+ * @param[in] beta_1: Parameter for moving average of first moments
+ * @param[in] beta_2: Parameter for moving average of second moments
+ * @param[in] eps: Small scalar to avoid division by zero
+ * @param[in] lr: Learning rate
+ * @param[in] weight_decay: Coefficient of l2 regularizer
+ * @param[in] decoupled: Whether weight decay is decoupled as in AdamW
+ * @param[in] grad: Input buffer of gradients
+ * @param[inout] first_moment: Quantized first moments
+ * @param[inout] first_scale: Scales of blocks of first moments
+ * @param[inout] second_moment: Quantized square roots of second moments
+ * @param[inout] second_scale: Scales of blocks of second moments
+ * @param[inout] p: Buffer of parameters
+ * */
+{
+    const fp32_t alpha = lr / (1 - std::pow(beta_1, num_iter));
+    const fp32_t beta = 1 / std::sqrt(1 - std::pow(beta_2, num_iter));
+    const fp32_t sqrt_beta_2 = std::sqrt(beta_2);
+    const fp32_t sqrt_1_beta_2 = std::sqrt(1-beta_2);
+    Index nblocks = (num_elems+block-1) / block;
+    // Chunks of at least 16K elements are processed by a single thread
+    parallel::parallel_for(nblocks, std::max<Index>(1, 16384/block),
+            [&](Index begin, Index end)
+    {
+        // Updated moments of a block before quantization
+        std::vector<fp32_t> f(block), s(block);
+        for(Index b = begin; b < end; ++b)
+        {
+            Index offset = b * block;
+            Index size = std::min(block, num_elems-offset);
+            fp32_t f_max = 0, s_max = 0;
+            fp32_t f_scale = 0, s_scale = 0;
+            if(num_iter != 1)
+            {
+                f_scale = first_scale[b];
+                s_scale = second_scale[b];
+            }
+            for(Index i = 0; i < size; ++i)
+            {
+                Index j = offset + i;
+                fp32_t p_val = p[j], grad_val = grad[j];
+                if(weight_decay != 0)
+                {
+                    if(decoupled)
+                    {
+                        p_val *= 1 - lr*weight_decay;
+                    }
+                    else
+                    {
+                        grad_val += weight_decay * p_val;
+                    }
+                }
+                fp32_t f_val, s_val;
+                if(num_iter == 1)
+                {
+                    f_val = (1-beta_1) * grad_val;
+                    s_val = sqrt_1_beta_2 * std::fabs(grad_val);
+                }
+                else
+                {
+                    f_val = beta_1*f_scale*first_moment[j]
+                        + (1-beta_1)*grad_val;
+                    s_val = std::hypot(
+                            sqrt_beta_2*s_scale*fp32_t(second_moment[j]),
+                            sqrt_1_beta_2*grad_val);
+                }
+                f[i] = f_val;
+                s[i] = s_val;
+                f_max = std::max(f_max, std::fabs(f_val));
+                s_max = std::max(s_max, s_val);
+                p[j] = p_val - alpha*f_val/(s_val*beta+eps);
+            }
+            // Quantize the block with new scales
+            for(Index i = 0; i < size; ++i)
+            {
+                fp32_t x = (f_max > 0) ? f[i]*first_qmax/f_max : 0;
+                first_moment[offset+i] = static_cast<std::int8_t>(
+                        std::clamp(std::nearbyint(x), -first_qmax,
+                            first_qmax));
+                fp32_t y = (s_max > 0) ? s[i]*second_qmax/s_max : 0;
+                second_moment[offset+i] = fp8_e4m3_t(y);
+            }
+            first_scale[b] = f_max / first_qmax;
+            second_scale[b] = s_max / second_qmax;
+        }
+    });
+}
+
+} // namespace quantized_adam_step
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,147 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/quantized_adam_step/cuda.cu
+ * Fused Adam step with block-wise 8-bit moments on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/quantized_adam_step/cuda.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace quantized_adam_step
+{
+
+//! Largest values of types of moments
+static constexpr fp32_t first_qmax = 127, second_qmax = 448;
+
+//! Number of threads, that process a single block of moments
+static constexpr int nthreads = 256;
+
+static __global__
+void cuda_kernel(Index num_iter, Index num_elems, Index block,
+        fp32_t beta_1, fp32_t sqrt_beta_2, fp32_t sqrt_1_beta_2, fp32_t eps,
+        fp32_t lr, fp32_t weight_decay, bool decoupled, fp32_t alpha,
+        fp32_t beta, const fp32_t *grad, std::int8_t *first_moment,
+        fp32_t *first_scale, fp8_e4m3_t *second_moment, fp32_t *second_scale,
+        fp32_t *p)
+//! A CUDA block of threads processes a single block of moments
+{
+    // Updated moments of the block before quantization
+    extern __shared__ fp32_t buf[];
+    fp32_t *f = buf, *s = buf + block;
+    __shared__ fp32_t f_max[nthreads], s_max[nthreads];
+    Index b = blockIdx.x;
+    Index offset = b * block;
+    Index size = ::min(block, num_elems-offset);
+    int tid = threadIdx.x;
+    fp32_t f_scale = 0, s_scale = 0;
+    if(num_iter != 1)
+    {
+        f_scale = first_scale[b];
+        s_scale = second_scale[b];
+    }
+    fp32_t f_amax = 0, s_amax = 0;
+    for(Index i = tid; i < size; i += nthreads)
+    {
+        Index j = offset + i;
+        fp32_t p_val = p[j], grad_val = grad[j];
+        if(weight_decay != 0)
+        {
+            if(decoupled)
+            {
+                p_val *= 1 - lr*weight_decay;
+            }
+            else
+            {
+                grad_val += weight_decay * p_val;
+            }
+        }
+        fp32_t f_val, s_val;
+        if(num_iter == 1)
+        {
+            f_val = (1-beta_1) * grad_val;
+            s_val = sqrt_1_beta_2 * ::fabsf(grad_val);
+        }
+        else
+        {
+            f_val = beta_1*f_scale*first_moment[j] + (1-beta_1)*grad_val;
+            s_val = ::hypotf(sqrt_beta_2*s_scale*fp32_t(second_moment[j]),
+                    sqrt_1_beta_2*grad_val);
+        }
+        f[i] = f_val;
+        s[i] = s_val;
+        f_amax = ::fmaxf(f_amax, ::fabsf(f_val));
+        s_amax = ::fmaxf(s_amax, s_val);
+        p[j] = p_val - alpha*f_val/(s_val*beta+eps);
+    }
+    // Largest values of the block
+    f_max[tid] = f_amax;
+    s_max[tid] = s_amax;
+    __syncthreads();
+    for(int k = nthreads/2; k > 0; k /= 2)
+    {
+        if(tid < k)
+        {
+            f_max[tid] = ::fmaxf(f_max[tid], f_max[tid+k]);
+            s_max[tid] = ::fmaxf(s_max[tid], s_max[tid+k]);
+        }
+        __syncthreads();
+    }
+    f_amax = f_max[0];
+    s_amax = s_max[0];
+    // Quantize the block with new scales
+    for(Index i = tid; i < size; i += nthreads)
+    {
+        fp32_t x = (f_amax > 0) ? f[i]*first_qmax/f_amax : 0;
+        first_moment[offset+i] = static_cast<std::int8_t>(::fminf(::fmaxf(
+                        ::rintf(x), -first_qmax), first_qmax));
+        fp32_t y = (s_amax > 0) ? s[i]*second_qmax/s_amax : 0;
+        second_moment[offset+i] = fp8_e4m3_t(y);
+    }
+    if(tid == 0)
+    {
+        first_scale[b] = f_amax / first_qmax;
+        second_scale[b] = s_amax / second_qmax;
+    }
+}
+
+void cuda(cudaStream_t stream, Index num_iter, Index num_elems, Index block,
+        fp32_t beta_1, fp32_t beta_2, fp32_t eps, fp32_t lr,
+        fp32_t weight_decay, bool decoupled, const fp32_t *grad,
+        std::int8_t *first_moment, fp32_t *first_scale,
+        fp8_e4m3_t *second_moment, fp32_t *second_scale, fp32_t *p)
+    noexcept
+//! Fused Adam or AdamW step with block-wise 8-bit moments on CUDA
+/*! Parameters are the same as of nntile::kernel::quantized_adam_step::cpu().
+ * Updated moments of a block are kept in shared memory, so the block shall
+ * not exceed 4096 elements.
+ * */
+{
+    Index nblocks = (num_elems+block-1) / block;
+    if(nblocks == 0)
+    {
+        return;
+    }
+    fp32_t alpha = lr / (1 - ::pow(beta_1, num_iter));
+    fp32_t beta = 1 / ::sqrt(1 - ::pow(beta_2, num_iter));
+    std::size_t shared = 2 * block * sizeof(fp32_t);
+    cuda_kernel<<<nblocks, nthreads, shared, stream>>>(num_iter, num_elems,
+            block, beta_1, ::sqrt(beta_2), ::sqrt(1-beta_2), eps, lr,
+            weight_decay, decoupled, alpha, beta, grad, first_moment,
+            first_scale, second_moment, second_scale, p);
+}
+
+} // namespace quantized_adam_step
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,185 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/randn/cuda.cu
+ * Randn operation on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/randn/cuda.hh"
+#include "../external/random.h" // from external
+
+namespace nntile
+{
+namespace kernel
+{
+namespace randn
+{
+
+//! Jump over n normal numbers, the same as CORE_rnd64_jump
+static __device__
+unsigned long long rnd64_jump(unsigned long long n, unsigned long long seed)
+{
+    unsigned long long a_k = Rnd64_A, c_k = Rnd64_C, ran = seed;
+    // Each normal number requires 2 uniform random numbers
+    for(n <<= 1; n; n >>= 1)
+    {
+        if(n & 1)
+        {
+            ran = a_k*ran + c_k;
+        }
+        c_k *= a_k + 1;
+        a_k *= a_k;
+    }
+    return ran;
+}
+
+//! Uniform random number, the same as CORE_slaran and CORE_dlaran
+template<typename T>
+static __device__
+T laran(unsigned long long &ran)
+{
+    // RndD_Mul is exactly 2^-64, so it is the same as RndF_Mul in fp32_t
+    T value = T(ran) * T(RndD_Mul);
+    ran = Rnd64_A*ran + Rnd64_C;
+    return value;
+}
+
+//! Normal random number by Box-Muller transform, as on CPU
+template<typename T>
+static __device__
+T chameleon_randn(unsigned long long seed, T mean, T stddev)
+{
+    constexpr T two=2.0, twopi=6.2831853071795864769252867663;
+    T t1 = laran<T>(seed);
+    T t2 = laran<T>(seed) * twopi;
+    T t3 = ::sqrt(-two*::log(t1)) * ::cos(t2);
+    return stddev*t3 + mean;
+}
+
+template<typename T>
+static __global__
+void cuda_kernel(Index ndim, Index nelems, unsigned long long seed, T mean,
+        T stddev, const Index *start, const Index *shape,
+        const Index *underlying_shape, const Index *stride, T *data)
+{
+    Index i = threadIdx.x + blockIdx.x*Index(blockDim.x);
+    if(i >= nelems)
+    {
+        return;
+    }
+    // Offsets of the element in the underlying and the output arrays
+    Index offset = 0, data_offset = 0, underlying_stride = 1;
+    for(Index k = 0; k < ndim; ++k)
+    {
+        Index index = i % shape[k];
+        i /= shape[k];
+        offset += (start[k]+index) * underlying_stride;
+        underlying_stride *= underlying_shape[k];
+        data_offset += index * stride[k];
+    }
+    data[data_offset] = chameleon_randn<T>(rnd64_jump(offset, seed), mean,
+            stddev);
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index ndim, Index nelems,
+        unsigned long long seed, T mean, T stddev, const Index *start,
+        const Index *shape, const Index *underlying_shape, T *data,
+        const Index *stride, Index *tmp_index)
+    noexcept
+//! Fill manydimensional array with random normally distributed numbers
+/*! Generates the same random sequence, as kernel::randn::cpu does, so that
+ * tiles are initialized right on a GPU independently of a worker, that
+ * executes the task. Each CUDA thread jumps to its element of the
+ * underlying array with a logarithmic number of steps of the generator.
+ * The results can differ from the CPU ones only by rounding errors of the
+ * device math functions.
+ *
+ * @param[in] stream: CUDA stream
+ * @param[in] ndim: Number of dimensions of the output array
+ * @param[in] nelems: Number of elements of the output array
+ * @param[in] seed: Random seed for the entire underlying array
+ * @param[in] mean: Average value of the normal distribution
+ * @param[in] stddev: Standard deviation of the normal distribution
+ * @param[in] start: Starting index of a subarray to generate. Contains ndim
+ *      values in host memory.
+ * @param[in] shape: Shape of the output array. Contains ndim values in host
+ *      memory.
+ * @param[in] underlying_shape: Shape of the underlying array. Contains ndim
+ *      values in host memory.
+ * @param[out] data: The output array memory buffer
+ * @param[in] stride: Strides of the output array. Contains ndim values in
+ *      host memory.
+ * @param[scratch] tmp_index: Temporary buffer in device memory, that
+ *      receives start, shape, underlying_shape and stride. Contains 4*ndim
+ *      values.
+ * */
+{
+    std::size_t size = ndim * sizeof(*tmp_index);
+    cudaMemcpyAsync(tmp_index, start, size, cudaMemcpyHostToDevice, stream);
+    cudaMemcpyAsync(tmp_index+ndim, shape, size, cudaMemcpyHostToDevice,
+            stream);
+    cudaMemcpyAsync(tmp_index+2*ndim, underlying_shape, size,
+            cudaMemcpyHostToDevice, stream);
+    cudaMemcpyAsync(tmp_index+3*ndim, stride, size, cudaMemcpyHostToDevice,
+            stream);
+    dim3 blocks((nelems+255)/256), threads(256);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(ndim, nelems, seed, mean,
+            stddev, tmp_index, tmp_index+ndim, tmp_index+2*ndim,
+            tmp_index+3*ndim, data);
+}
+
+template<typename T>
+static __global__
+void cuda_kernel_ndim0(unsigned long long seed, T mean, T stddev, T *data)
+{
+    *data = chameleon_randn<T>(seed, mean, stddev);
+}
+
+template<typename T>
+void cuda_ndim0(cudaStream_t stream, unsigned long long seed, T mean,
+        T stddev, T *data)
+    noexcept
+//! Fill a scalar with a random normally distributed number on CUDA
+{
+    (cuda_kernel_ndim0<T>)<<<1, 1, 0, stream>>>(seed, mean, stddev, data);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index ndim, Index nelems,
+        unsigned long long seed, fp32_t mean, fp32_t stddev,
+        const Index *start, const Index *shape,
+        const Index *underlying_shape, fp32_t *data, const Index *stride,
+        Index *tmp_index)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index ndim, Index nelems,
+        unsigned long long seed, fp64_t mean, fp64_t stddev,
+        const Index *start, const Index *shape,
+        const Index *underlying_shape, fp64_t *data, const Index *stride,
+        Index *tmp_index)
+    noexcept;
+
+template
+void cuda_ndim0<fp32_t>(cudaStream_t stream, unsigned long long seed,
+        fp32_t mean, fp32_t stddev, fp32_t *data)
+    noexcept;
+
+template
+void cuda_ndim0<fp64_t>(cudaStream_t stream, unsigned long long seed,
+        fp64_t mean, fp64_t stddev, fp64_t *data)
+    noexcept;
+
+} // namespace randn
+} // namespace kernel
+} // namespace nntile
+
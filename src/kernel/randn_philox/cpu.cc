@@ -0,0 +1,303 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/randn_philox/cpu.cc
+ * Randn operation by a counter-based Philox generator on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/randn_philox/cpu.hh"
+#include "nntile/kernel/randn_philox/philox.hh"
+#include "nntile/kernel/simd.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace randn_philox
+{
+
+template<typename T>
+static void fiber_scalar(Index nelems, unsigned long long seed, Index offset,
+        T mean, T stddev, T *data, Index stride)
+    noexcept
+//! Fill a fiber of contiguous elements of the underlying array
+{
+    for(Index i = 0; i < nelems; ++i)
+    {
+        data[i*stride] = philox_randn(seed, offset+i, mean, stddev);
+    }
+}
+
+#ifdef NNTILE_KERNEL_SIMD_X86
+//! Vectors of W words of Philox generator
+template<int W>
+struct Words
+{
+    typedef std::uint32_t type __attribute__((vector_size(W*4)));
+    typedef std::uint64_t wide __attribute__((vector_size(W*8)));
+};
+
+//! Philox4x32-10 for W counters at once, the same as philox4x32_10()
+template<int W>
+static NNTILE_SIMD_INLINE void philox_vec(typename Words<W>::type ctr[4],
+        std::uint32_t key0, std::uint32_t key1)
+    noexcept
+{
+    using U = typename Words<W>::type;
+    using U2 = typename Words<W>::wide;
+    constexpr std::uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+    constexpr std::uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+    for(int round = 0; round < 10; ++round)
+    {
+        U2 prod0 = __builtin_convertvector(ctr[0], U2) * M0;
+        U2 prod1 = __builtin_convertvector(ctr[2], U2) * M1;
+        U hi0 = __builtin_convertvector(prod0 >> 32, U);
+        U lo0 = __builtin_convertvector(prod0, U);
+        U hi1 = __builtin_convertvector(prod1 >> 32, U);
+        U lo1 = __builtin_convertvector(prod1, U);
+        ctr[0] = hi1 ^ ctr[1] ^ key0;
+        ctr[1] = lo1;
+        ctr[2] = hi0 ^ ctr[3] ^ key1;
+        ctr[3] = lo0;
+        key0 += W0;
+        key1 += W1;
+    }
+}
+
+//! Normal numbers of W consecutive elements, the same as philox_randn()
+/*! Box-Muller transform relies on vectorized log and cos, so results differ
+ * from philox_randn() by a few ulp.
+ * */
+template<typename T, int W>
+static NNTILE_SIMD_INLINE typename simd::Vec<T, W>::type randn_vec(
+        unsigned long long seed, Index offset, T mean, T stddev)
+    noexcept
+{
+    using V = typename simd::Vec<T, W>::type;
+    using I = typename simd::Vec<T, W>::itype;
+    using U = typename Words<W>::type;
+    using U2 = typename Words<W>::wide;
+    constexpr T twopi = 6.2831853071795864769252867663;
+    // Counters of consecutive elements of the first random sequence
+    U2 counter;
+    for(int i = 0; i < W; ++i)
+    {
+        counter[i] = offset + i;
+    }
+    U ctr[4] = {__builtin_convertvector(counter, U),
+        __builtin_convertvector(counter >> 32, U), U{}, U{}};
+    philox_vec<W>(ctr, std::uint32_t(seed), std::uint32_t(seed >> 32));
+    V t1, t2;
+    if constexpr(sizeof(T) == 4)
+    {
+        // Uniform numbers in (0,1) and in [0,1) with 24 random bits
+        constexpr T scale = 1.0f / 16777216.0f;
+        t1 = (__builtin_convertvector((I)(ctr[0]>>8), V)+T(0.5)) * scale;
+        t2 = __builtin_convertvector((I)(ctr[1]>>8), V) * scale * twopi;
+    }
+    else
+    {
+        // Uniform numbers in (0,1) and in [0,1) with 53 random bits, that are
+        // assembled from 32-bit words converted exactly by adding them to
+        // the mantissa of 2^52
+        constexpr T scale = 1.0 / 9007199254740992.0;
+        constexpr std::uint64_t two52_bits = 0x4330000000000000;
+        constexpr T two52 = 4503599627370496.0;
+        auto to_fp64 = [&](const U &x) NNTILE_SIMD_LOOP
+        {
+            return (V)(__builtin_convertvector(x, U2) | two52_bits) - two52;
+        };
+        V u1 = to_fp64(ctr[1])*T(2097152) + to_fp64(ctr[0]>>11);
+        V u2 = to_fp64(ctr[3])*T(2097152) + to_fp64(ctr[2]>>11);
+        t1 = (u1+T(0.5)) * scale;
+        t2 = u2 * scale * twopi;
+    }
+    V t3 = simd::sqrt<T, W>(T(-2)*simd::log<T, W>(t1))
+        * simd::cos<T, W>(t2);
+    return stddev*t3 + mean;
+}
+
+template<typename T, int W>
+static NNTILE_SIMD_INLINE void fiber_simd(Index nelems,
+        unsigned long long seed, Index offset, T mean, T stddev, T *data,
+        Index stride)
+    noexcept
+//! Fill a fiber of contiguous elements with vectors of W elements
+/*! Remaining elements are also computed by a vector, so that every element
+ * of the underlying array gets the same value regardless of a subarray it
+ * belongs to.
+ * */
+{
+    using V = typename simd::Vec<T, W>::type;
+    for(Index i = 0; i < nelems; i += W)
+    {
+        V res = randn_vec<T, W>(seed, offset+i, mean, stddev);
+        if(stride == 1 and i+W <= nelems)
+        {
+            simd::store<T, W>(res, data+i);
+            continue;
+        }
+        T tmp[W];
+        simd::store<T, W>(res, tmp);
+        Index nvals = std::min<Index>(W, nelems-i);
+        for(Index j = 0; j < nvals; ++j)
+        {
+            data[(i+j)*stride] = tmp[j];
+        }
+    }
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX2 void fiber_avx2(Index nelems,
+        unsigned long long seed, Index offset, T mean, T stddev, T *data,
+        Index stride)
+    noexcept
+{
+    fiber_simd<T, 32/sizeof(T)>(nelems, seed, offset, mean, stddev, data,
+            stride);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX512 void fiber_avx512(Index nelems,
+        unsigned long long seed, Index offset, T mean, T stddev, T *data,
+        Index stride)
+    noexcept
+{
+    fiber_simd<T, 64/sizeof(T)>(nelems, seed, offset, mean, stddev, data,
+            stride);
+}
+#endif // NNTILE_KERNEL_SIMD_X86
+
+template<typename T>
+static void fiber(Index nelems, unsigned long long seed, Index offset,
+        T mean, T stddev, T *data, Index stride)
+    noexcept
+//! Fill a fiber by the instruction set used by CPU kernels
+{
+#ifdef NNTILE_KERNEL_SIMD_X86
+    switch(simd::get_level())
+    {
+        case simd::Level::AVX512:
+            fiber_avx512<T>(nelems, seed, offset, mean, stddev, data,
+                    stride);
+            return;
+        case simd::Level::AVX2:
+            fiber_avx2<T>(nelems, seed, offset, mean, stddev, data, stride);
+            return;
+        default:
+            break;
+    }
+#endif // NNTILE_KERNEL_SIMD_X86
+    fiber_scalar<T>(nelems, seed, offset, mean, stddev, data, stride);
+}
+
+template<typename T>
+void cpu(Index ndim, Index nelems, unsigned long long seed,
+        T mean, T stddev, const Index *start, const Index *shape,
+        const Index *underlying_shape, T *data, const Index *stride,
+        Index *tmp_index)
+    noexcept
+//! Fill manydimensional array with random normal numbers by Philox
+/*! The output is generated as if it is a part of another many-dimensional
+ * underlying array, just like kernel::randn::cpu does: output is
+ * underlying[start:start+shape]. Unlike linear congruential generator of
+ * kernel::randn, each element of the underlying array is a function of its
+ * linear offset and the seed only, so there is no need to jump over skipped
+ * elements and all the elements are generated independently. Vectorized
+ * AVX2 or AVX-512 implementation is used if it is supported by the CPU and
+ * allowed by nntile::kernel::simd::set_level(). Its results differ from
+ * the scalar philox_randn() by a few ulp due to vectorized math functions,
+ * while they do not depend on the shape of a generated subarray.
+ *
+ * @param[in] ndim: Number of dimensions of the output array. Zero value
+ *      means a scalar output.
+ * @param[in] nelems: Number of elements of the output array
+ * @param[in] seed: Random seed for the entire underlying array
+ * @param[in] mean: Average value of the normal distribution
+ * @param[in] stddev: Standard deviation of the normal distribution
+ * @param[in] start: Starting index of a subarray to generate. Contains ndim
+ *      values.
+ * @param[in] shape: Shape of the output array. Contains ndim values.
+ * @param[in] underlying_shape: Shape of the underlying array. Contains ndim
+ *      values.
+ * @param[out] data: The output array memory buffer
+ * @param[in] stride: Strides of the output array. Contains ndim values.
+ * @param[scratch] tmp_index: Temporary buffer for indexing purposes. Contains
+ *      ndim values.
+ * */
+{
+    // 0-dimensional tensor is just a scalar
+    if(ndim == 0)
+    {
+        fiber<T>(1, seed, 0, mean, stddev, data, 1);
+        return;
+    }
+    // Offset of the first element to generate in the underlying array
+    Index offset = start[ndim-1];
+    for(Index i = ndim-2; i >= 0; --i)
+    {
+        offset = start[i] + offset*underlying_shape[i];
+    }
+    // View tile as a matrix of shape (shape[0], prod(shape[1:ndim]))
+    Index nrows = shape[0], ncols = nelems / nrows;
+    // Init temporary index
+    for(Index i = 0; i < ndim; ++i)
+    {
+        tmp_index[i] = 0;
+    }
+    for(Index j = 0; j < ncols; ++j)
+    {
+        // Elements of a column are contiguous in the underlying array
+        fiber<T>(nrows, seed, offset, mean, stddev, data, stride[0]);
+        if(j == ncols-1)
+        {
+            break;
+        }
+        // Move to the first element of the next column
+        ++tmp_index[1];
+        Index k = 1;
+        Index underlying_stride = underlying_shape[0];
+        data += stride[1];
+        offset += underlying_stride;
+        while(tmp_index[k] == shape[k])
+        {
+            // Reset out-of-bound index and increment the next one
+            tmp_index[k] = 0;
+            data -= stride[k] * shape[k];
+            offset -= underlying_stride * shape[k];
+            underlying_stride *= underlying_shape[k];
+            ++k;
+            ++tmp_index[k];
+            data += stride[k];
+            offset += underlying_stride;
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index ndim, Index nelems, unsigned long long seed,
+        fp32_t mean, fp32_t stddev, const Index *start, const Index *shape,
+        const Index *underlying_shape, fp32_t *data, const Index *stride,
+        Index *tmp_index)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index ndim, Index nelems, unsigned long long seed,
+        fp64_t mean, fp64_t stddev, const Index *start, const Index *shape,
+        const Index *underlying_shape, fp64_t *data, const Index *stride,
+        Index *tmp_index)
+    noexcept;
+
+} // namespace randn_philox
+} // namespace kernel
+} // namespace nntile
+
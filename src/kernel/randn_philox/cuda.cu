@@ -0,0 +1,115 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/randn_philox/cuda.cu
+ * Randn operation by a counter-based Philox generator on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/randn_philox/cuda.hh"
+#include "nntile/kernel/randn_philox/philox.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace randn_philox
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index ndim, Index nelems, unsigned long long seed, T mean,
+        T stddev, const Index *start, const Index *shape,
+        const Index *underlying_shape, const Index *stride, T *data)
+{
+    Index i = threadIdx.x + blockIdx.x*Index(blockDim.x);
+    if(i >= nelems)
+    {
+        return;
+    }
+    // Offsets of the element in the underlying and the output arrays
+    Index offset = 0, data_offset = 0, underlying_stride = 1;
+    for(Index k = 0; k < ndim; ++k)
+    {
+        Index index = i % shape[k];
+        i /= shape[k];
+        offset += (start[k]+index) * underlying_stride;
+        underlying_stride *= underlying_shape[k];
+        data_offset += index * stride[k];
+    }
+    data[data_offset] = philox_randn(seed, offset, mean, stddev);
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index ndim, Index nelems,
+        unsigned long long seed, T mean, T stddev, const Index *start,
+        const Index *shape, const Index *underlying_shape, T *data,
+        const Index *stride, Index *tmp_index)
+    noexcept
+//! Fill manydimensional array with random normal numbers by Philox on CUDA
+/*! Generates exactly the same output as kernel::randn_philox::cpu does, as
+ * each element depends only on its offset in the underlying array and the
+ * seed. Each CUDA thread generates a single element.
+ *
+ * @param[in] stream: CUDA stream
+ * @param[in] ndim: Number of dimensions of the output array. Zero value
+ *      means a scalar output.
+ * @param[in] nelems: Number of elements of the output array
+ * @param[in] seed: Random seed for the entire underlying array
+ * @param[in] mean: Average value of the normal distribution
+ * @param[in] stddev: Standard deviation of the normal distribution
+ * @param[in] start: Starting index of a subarray to generate. Contains ndim
+ *      values in host memory.
+ * @param[in] shape: Shape of the output array. Contains ndim values in host
+ *      memory.
+ * @param[in] underlying_shape: Shape of the underlying array. Contains ndim
+ *      values in host memory.
+ * @param[out] data: The output array memory buffer
+ * @param[in] stride: Strides of the output array. Contains ndim values in
+ *      host memory.
+ * @param[scratch] tmp_index: Temporary buffer in device memory, that
+ *      receives start, shape, underlying_shape and stride. Contains 4*ndim
+ *      values.
+ * */
+{
+    std::size_t size = ndim * sizeof(*tmp_index);
+    cudaMemcpyAsync(tmp_index, start, size, cudaMemcpyHostToDevice, stream);
+    cudaMemcpyAsync(tmp_index+ndim, shape, size, cudaMemcpyHostToDevice,
+            stream);
+    cudaMemcpyAsync(tmp_index+2*ndim, underlying_shape, size,
+            cudaMemcpyHostToDevice, stream);
+    cudaMemcpyAsync(tmp_index+3*ndim, stride, size, cudaMemcpyHostToDevice,
+            stream);
+    dim3 blocks((nelems+255)/256), threads(256);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(ndim, nelems, seed, mean,
+            stddev, tmp_index, tmp_index+ndim, tmp_index+2*ndim,
+            tmp_index+3*ndim, data);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index ndim, Index nelems,
+        unsigned long long seed, fp32_t mean, fp32_t stddev,
+        const Index *start, const Index *shape,
+        const Index *underlying_shape, fp32_t *data, const Index *stride,
+        Index *tmp_index)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index ndim, Index nelems,
+        unsigned long long seed, fp64_t mean, fp64_t stddev,
+        const Index *start, const Index *shape,
+        const Index *underlying_shape, fp64_t *data, const Index *stride,
+        Index *tmp_index)
+    noexcept;
+
+} // namespace randn_philox
+} // namespace kernel
+} // namespace nntile
+
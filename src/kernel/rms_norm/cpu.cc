@@ -0,0 +1,250 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/rms_norm/cpu.cc
+ * Root mean square layer normalization on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/rms_norm/cpu.hh"
+#include "nntile/kernel/simd.hh"
+#include "nntile/kernel/parallel.hh"
+#include <algorithm>
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace rms_norm
+{
+
+template<typename T>
+static void cpu_fibers(Index m, Index i0_begin, Index k, T eps,
+        const T *src_slice, const T *gamma, T *inv_rms_slice, T *dst_slice)
+    noexcept
+//! Normalize fibers i0_begin..m-1 of a single slice without vectorization
+{
+    constexpr T zero = 0.0, one = 1.0;
+    // inv_rms holds sum of squares until normalization
+    for(Index i0 = i0_begin; i0 < m; ++i0)
+    {
+        inv_rms_slice[i0] = zero;
+    }
+    // Read contiguous rows of the slice
+    for(Index i1 = 0; i1 < k; ++i1)
+    {
+        const T *src_fiber = src_slice + i1*m;
+        for(Index i0 = i0_begin; i0 < m; ++i0)
+        {
+            inv_rms_slice[i0] += src_fiber[i0] * src_fiber[i0];
+        }
+    }
+    for(Index i0 = i0_begin; i0 < m; ++i0)
+    {
+        inv_rms_slice[i0] = one / std::sqrt(inv_rms_slice[i0]/T(k)+eps);
+    }
+    for(Index i1 = 0; i1 < k; ++i1)
+    {
+        const T *src_fiber = src_slice + i1*m;
+        T *dst_fiber = dst_slice + i1*m;
+        const T gamma_val = gamma[i1];
+        for(Index i0 = i0_begin; i0 < m; ++i0)
+        {
+            dst_fiber[i0] = src_fiber[i0] * inv_rms_slice[i0] * gamma_val;
+        }
+    }
+}
+
+template<typename T>
+static void cpu_scalar(Index m, Index n, Index k, T eps, const T *src,
+        const T *gamma, T *inv_rms, T *dst)
+    noexcept
+//! Root mean square layer normalization without vectorization
+{
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        cpu_fibers<T>(m, 0, k, eps, src+i2*m*k, gamma, inv_rms+i2*m,
+                dst+i2*m*k);
+    }
+}
+
+#ifdef NNTILE_KERNEL_SIMD_X86
+template<typename T, int W>
+static NNTILE_SIMD_INLINE void cpu_simd(Index m, Index n, Index k, T eps,
+        const T *src, const T *gamma, T *inv_rms, T *dst)
+    noexcept
+//! Root mean square layer normalization with vectors of W elements
+/*! Rows of a slice along the contiguous first mode are read by vectors, so
+ * that sums of squares of W fibers are accumulated at once. If the first mode
+ * is trivial, the middle mode is contiguous and it is vectorized instead.
+ * */
+{
+    using V = typename simd::Vec<T, W>::type;
+    const Index mk = m * k;
+    const V one = simd::broadcast<T, W>(1);
+    const V inv_k = simd::broadcast<T, W>(T(1)/T(k));
+    const V eps_vec = simd::broadcast<T, W>(eps);
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        const T *src_slice = src + i2*mk;
+        T *dst_slice = dst + i2*mk;
+        T *inv_rms_slice = inv_rms + i2*m;
+        // Vectorize along the middle mode
+        if(m == 1)
+        {
+            V ssq_vec{};
+            Index i1 = 0;
+            for(; i1+W <= k; i1 += W)
+            {
+                const V val = simd::load<T, W>(src_slice+i1);
+                ssq_vec += val * val;
+            }
+            T ssq_part[W];
+            simd::store<T, W>(ssq_vec, ssq_part);
+            T ssq = 0;
+            for(Index j = 0; j < W; ++j)
+            {
+                ssq += ssq_part[j];
+            }
+            for(Index i = i1; i < k; ++i)
+            {
+                ssq += src_slice[i] * src_slice[i];
+            }
+            const T inv = T(1) / std::sqrt(ssq/T(k)+eps);
+            inv_rms_slice[0] = inv;
+            const V inv_vec = simd::broadcast<T, W>(inv);
+            for(i1 = 0; i1+W <= k; i1 += W)
+            {
+                const V val = simd::load<T, W>(src_slice+i1);
+                const V gamma_vec = simd::load<T, W>(gamma+i1);
+                simd::store<T, W>(val*inv_vec*gamma_vec, dst_slice+i1);
+            }
+            for(; i1 < k; ++i1)
+            {
+                dst_slice[i1] = src_slice[i1] * inv * gamma[i1];
+            }
+            continue;
+        }
+        // Vectorize along the first mode
+        Index i0 = 0;
+        for(; i0+W <= m; i0 += W)
+        {
+            V ssq_vec{};
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                const V val = simd::load<T, W>(src_slice+i1*m+i0);
+                ssq_vec += val * val;
+            }
+            const V inv_vec = one / simd::sqrt<T, W>(ssq_vec*inv_k+eps_vec);
+            simd::store<T, W>(inv_vec, inv_rms_slice+i0);
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                const V val = simd::load<T, W>(src_slice+i1*m+i0);
+                simd::store<T, W>(val*inv_vec*gamma[i1],
+                        dst_slice+i1*m+i0);
+            }
+        }
+        // Remaining fibers of the slice
+        if(i0 < m)
+        {
+            cpu_fibers<T>(m, i0, k, eps, src_slice, gamma, inv_rms_slice,
+                    dst_slice);
+        }
+    }
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX2 void cpu_avx2(Index m, Index n, Index k,
+        T eps, const T *src, const T *gamma, T *inv_rms, T *dst)
+    noexcept
+{
+    cpu_simd<T, 32/sizeof(T)>(m, n, k, eps, src, gamma, inv_rms, dst);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX512 void cpu_avx512(Index m, Index n, Index k,
+        T eps, const T *src, const T *gamma, T *inv_rms, T *dst)
+    noexcept
+{
+    cpu_simd<T, 64/sizeof(T)>(m, n, k, eps, src, gamma, inv_rms, dst);
+}
+#endif // NNTILE_KERNEL_SIMD_X86
+
+template<typename T>
+static void cpu_range(Index m, Index n, Index k, T eps, const T *src,
+        const T *gamma, T *inv_rms, T *dst)
+    noexcept
+//! Root mean square layer normalization of a range of slices
+{
+#ifdef NNTILE_KERNEL_SIMD_X86
+    switch(simd::get_level())
+    {
+        case simd::Level::AVX512:
+            cpu_avx512<T>(m, n, k, eps, src, gamma, inv_rms, dst);
+            return;
+        case simd::Level::AVX2:
+            cpu_avx2<T>(m, n, k, eps, src, gamma, inv_rms, dst);
+            return;
+        default:
+            break;
+    }
+#endif // NNTILE_KERNEL_SIMD_X86
+    cpu_scalar<T>(m, n, k, eps, src, gamma, inv_rms, dst);
+}
+
+template<typename T>
+void cpu(Index m, Index n, Index k, T eps, const T *src, const T *gamma,
+        T *inv_rms, T *dst)
+    noexcept
+//! Root mean square layer normalization along middle axis on CPU
+/*! For a provided m-by-k-by-n input array src computes inverse of root mean
+ * square along the middle axis and normalizes src in a single task:
+ *      inv_rms[i,j] = 1 / sqrt(sum_l src[i,l,j]^2 / k + eps)
+ *      dst[i,l,j] = src[i,l,j] * inv_rms[i,j] * gamma[l]
+ * Vectorized AVX2 or AVX-512 implementation is used if it is supported by
+ * the CPU and allowed by nntile::kernel::simd::set_level(). Slices along
+ * the last axis are split among threads, allowed by
+ * nntile::kernel::parallel::set_num_threads().
+ *
+ * @param[in] m: Size of the first mode of src, dst and inv_rms
+ * @param[in] n: Size of the last mode of src, dst and inv_rms
+ * @param[in] k: Size of the middle mode of src and dst, that is normalized
+ * @param[in] eps: Regularization parameter for mean square. eps > 0
+ * @param[in] src: Input contiguous m-by-k-by-n array
+ * @param[in] gamma: Scaling factors of size k
+ * @param[out] inv_rms: Output contiguous m-by-n array of inverses of root
+ *      mean squares
+ * @param[out] dst: Output contiguous m-by-k-by-n array
+ * */
+{
+    // Chunks of at least 64K elements are processed by a single thread
+    Index grain = 65536 / std::max<Index>(m*k, 1);
+    parallel::parallel_for(n, grain, [&](Index begin, Index end)
+    {
+        cpu_range<T>(m, end-begin, k, eps, src+m*k*begin, gamma,
+                inv_rms+m*begin, dst+m*k*begin);
+    });
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, fp32_t eps, const fp32_t *src,
+        const fp32_t *gamma, fp32_t *inv_rms, fp32_t *dst)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, fp64_t eps, const fp64_t *src,
+        const fp64_t *gamma, fp64_t *inv_rms, fp64_t *dst)
+    noexcept;
+
+} // namespace rms_norm
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,145 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/rms_norm/cuda.cu
+ * Root mean square layer normalization on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/rms_norm/cuda.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace rms_norm
+{
+
+// Number of threads in a CUDA block
+static constexpr int BLOCK = 256;
+
+// Smaller first modes are processed by a block per normalized fiber, while
+// larger ones are processed by a thread per fiber with coalesced reads
+static constexpr Index M_THREAD = 32;
+
+template<typename T>
+static __global__
+void cuda_kernel_block(Index m, Index n, Index k, T eps, const T *src,
+        const T *gamma, T *inv_rms, T *dst)
+//! Root mean square layer normalization, where a block processes a fiber
+/*! Every thread accumulates squares of a strided part of the fiber and
+ * partial sums are reduced in shared memory.
+ * */
+{
+    __shared__ T ssq_shared[BLOCK];
+    const int tid = threadIdx.x;
+    for(Index c = blockIdx.x; c < m*n; c += gridDim.x)
+    {
+        const Index i0 = c % m, i2 = c / m;
+        const Index offset = i2*m*k + i0;
+        T ssq = 0;
+        for(Index i1 = tid; i1 < k; i1 += BLOCK)
+        {
+            const T val = src[offset+i1*m];
+            ssq += val * val;
+        }
+        ssq_shared[tid] = ssq;
+        __syncthreads();
+        for(int s = BLOCK/2; s > 0; s /= 2)
+        {
+            if(tid < s)
+            {
+                ssq_shared[tid] += ssq_shared[tid+s];
+            }
+            __syncthreads();
+        }
+        const T inv = T(1) / ::sqrt(ssq_shared[0]/T(k)+eps);
+        if(tid == 0)
+        {
+            inv_rms[c] = inv;
+        }
+        for(Index i1 = tid; i1 < k; i1 += BLOCK)
+        {
+            dst[offset+i1*m] = src[offset+i1*m] * inv * gamma[i1];
+        }
+        // Shared memory is reused by the next fiber
+        __syncthreads();
+    }
+}
+
+template<typename T>
+static __global__
+void cuda_kernel_thread(Index m, Index n, Index k, T eps, const T *src,
+        const T *gamma, T *inv_rms, T *dst)
+//! Root mean square layer normalization, where a thread processes a fiber
+{
+    const Index stride = Index(blockDim.x) * gridDim.x;
+    for(Index c = threadIdx.x + Index(blockIdx.x)*blockDim.x; c < m*n;
+            c += stride)
+    {
+        const Index i0 = c % m, i2 = c / m;
+        const Index offset = i2*m*k + i0;
+        T ssq = 0;
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const T val = src[offset+i1*m];
+            ssq += val * val;
+        }
+        const T inv = T(1) / ::sqrt(ssq/T(k)+eps);
+        inv_rms[c] = inv;
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            dst[offset+i1*m] = src[offset+i1*m] * inv * gamma[i1];
+        }
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, T eps,
+        const T *src, const T *gamma, T *inv_rms, T *dst)
+    noexcept
+//! Root mean square layer normalization along middle axis on CUDA
+/*! Parameters are the same as of nntile::kernel::rms_norm::cpu().
+ * */
+{
+    if(m == 0 or n == 0 or k == 0)
+    {
+        return;
+    }
+    dim3 threads(BLOCK);
+    if(m < M_THREAD)
+    {
+        dim3 blocks(std::min(m*n, Index(65535)));
+        (cuda_kernel_block<T>)<<<blocks, threads, 0, stream>>>(m, n, k, eps,
+                src, gamma, inv_rms, dst);
+    }
+    else
+    {
+        dim3 blocks(std::min((m*n+BLOCK-1)/BLOCK, Index(65535)));
+        (cuda_kernel_thread<T>)<<<blocks, threads, 0, stream>>>(m, n, k,
+                eps, src, gamma, inv_rms, dst);
+    }
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k, fp32_t eps,
+        const fp32_t *src, const fp32_t *gamma, fp32_t *inv_rms, fp32_t *dst)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k, fp64_t eps,
+        const fp64_t *src, const fp64_t *gamma, fp64_t *inv_rms, fp64_t *dst)
+    noexcept;
+
+} // namespace rms_norm
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,309 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/rms_norm_backward/cpu.cc
+ * Backward of root mean square layer normalization on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/rms_norm_backward/cpu.hh"
+#include "nntile/kernel/simd.hh"
+#include <vector>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace rms_norm_backward
+{
+
+template<typename T>
+static void cpu_scalar(Index m, Index n, Index k, const T *src,
+        const T *dst_grad, const T *gamma, const T *inv_rms, T *src_grad,
+        T *gamma_grad)
+    noexcept
+//! Backward of root mean square layer normalization without vectorization
+{
+    constexpr T zero = 0.0;
+    const T inv_k = T(1.0) / T(k);
+    // Sums of g*xhat along the middle axis for a single slice
+    std::vector<T> sum_gx(m);
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        const Index offset = i2 * m * k;
+        const T *inv_rms_slice = inv_rms + i2*m;
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            sum_gx[i0] = zero;
+        }
+        // Accumulate sums and gradient of gamma
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const T *src_fiber = src + offset + i1*m;
+            const T *dst_grad_fiber = dst_grad + offset + i1*m;
+            const T gamma_val = gamma[i1];
+            T gamma_grad_val = zero;
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                const T xhat = src_fiber[i0] * inv_rms_slice[i0];
+                const T dy = dst_grad_fiber[i0];
+                sum_gx[i0] += dy * gamma_val * xhat;
+                gamma_grad_val += dy * xhat;
+            }
+            gamma_grad[i1] += gamma_grad_val;
+        }
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            sum_gx[i0] *= inv_k;
+        }
+        // Accumulate gradient of input
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const T *src_fiber = src + offset + i1*m;
+            const T *dst_grad_fiber = dst_grad + offset + i1*m;
+            T *src_grad_fiber = src_grad + offset + i1*m;
+            const T gamma_val = gamma[i1];
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                const T inv = inv_rms_slice[i0];
+                const T xhat = src_fiber[i0] * inv;
+                const T g = dst_grad_fiber[i0] * gamma_val;
+                src_grad_fiber[i0] += inv * (g-xhat*sum_gx[i0]);
+            }
+        }
+    }
+}
+
+#ifdef NNTILE_KERNEL_SIMD_X86
+//! Sum of elements of a vector
+template<typename T, int W>
+static NNTILE_SIMD_INLINE T sum_lanes(const typename simd::Vec<T, W>::type &x)
+    noexcept
+{
+    T part[W];
+    simd::store<T, W>(x, part);
+    T res = 0;
+    for(Index j = 0; j < W; ++j)
+    {
+        res += part[j];
+    }
+    return res;
+}
+
+template<typename T, int W>
+static NNTILE_SIMD_INLINE void cpu_simd(Index m, Index n, Index k,
+        const T *src, const T *dst_grad, const T *gamma, const T *inv_rms,
+        T *src_grad, T *gamma_grad)
+    noexcept
+//! Backward of root mean square layer normalization with vectors
+/*! Rows of a slice along the contiguous first mode are processed by vectors
+ * of W elements and the gradient of gamma of a row is reduced over lanes
+ * once per row. If the first mode is trivial, the middle mode is contiguous
+ * and it is vectorized instead, so that gamma_grad is updated by vectors.
+ * */
+{
+    using V = typename simd::Vec<T, W>::type;
+    const T inv_k = T(1.0) / T(k);
+    const Index m_vec = m - m%W;
+    std::vector<T> sum_gx(m);
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        const Index offset = i2 * m * k;
+        const T *inv_rms_slice = inv_rms + i2*m;
+        const T *src_slice = src + offset;
+        const T *dst_grad_slice = dst_grad + offset;
+        T *src_grad_slice = src_grad + offset;
+        // Vectorize along the middle mode
+        if(m == 1)
+        {
+            const T inv = inv_rms_slice[0];
+            V sum_vec{};
+            Index i1 = 0;
+            for(; i1+W <= k; i1 += W)
+            {
+                const V xhat = simd::load<T, W>(src_slice+i1) * inv;
+                const V dy = simd::load<T, W>(dst_grad_slice+i1);
+                const V gamma_vec = simd::load<T, W>(gamma+i1);
+                sum_vec += dy * gamma_vec * xhat;
+                simd::store<T, W>(simd::load<T, W>(gamma_grad+i1)+dy*xhat,
+                        gamma_grad+i1);
+            }
+            T sum = sum_lanes<T, W>(sum_vec);
+            for(; i1 < k; ++i1)
+            {
+                const T xhat = src_slice[i1] * inv;
+                sum += dst_grad_slice[i1] * gamma[i1] * xhat;
+                gamma_grad[i1] += dst_grad_slice[i1] * xhat;
+            }
+            sum *= inv_k;
+            for(i1 = 0; i1+W <= k; i1 += W)
+            {
+                const V xhat = simd::load<T, W>(src_slice+i1) * inv;
+                const V g = simd::load<T, W>(dst_grad_slice+i1)
+                    * simd::load<T, W>(gamma+i1);
+                const V dx = simd::load<T, W>(src_grad_slice+i1)
+                    + inv*(g-xhat*sum);
+                simd::store<T, W>(dx, src_grad_slice+i1);
+            }
+            for(; i1 < k; ++i1)
+            {
+                const T xhat = src_slice[i1] * inv;
+                const T g = dst_grad_slice[i1] * gamma[i1];
+                src_grad_slice[i1] += inv * (g-xhat*sum);
+            }
+            continue;
+        }
+        // Vectorize along the first mode
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            sum_gx[i0] = T(0);
+        }
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const T *src_fiber = src_slice + i1*m;
+            const T *dst_grad_fiber = dst_grad_slice + i1*m;
+            const T gamma_val = gamma[i1];
+            V gamma_grad_vec{};
+            Index i0 = 0;
+            for(; i0 < m_vec; i0 += W)
+            {
+                const V xhat = simd::load<T, W>(src_fiber+i0)
+                    * simd::load<T, W>(inv_rms_slice+i0);
+                const V dy = simd::load<T, W>(dst_grad_fiber+i0);
+                const V dyx = dy * xhat;
+                simd::store<T, W>(simd::load<T, W>(&sum_gx[i0])+dyx*gamma_val,
+                        &sum_gx[i0]);
+                gamma_grad_vec += dyx;
+            }
+            T gamma_grad_val = sum_lanes<T, W>(gamma_grad_vec);
+            for(; i0 < m; ++i0)
+            {
+                const T dyx = dst_grad_fiber[i0] * src_fiber[i0]
+                    * inv_rms_slice[i0];
+                sum_gx[i0] += dyx * gamma_val;
+                gamma_grad_val += dyx;
+            }
+            gamma_grad[i1] += gamma_grad_val;
+        }
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            sum_gx[i0] *= inv_k;
+        }
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            const T *src_fiber = src_slice + i1*m;
+            const T *dst_grad_fiber = dst_grad_slice + i1*m;
+            T *src_grad_fiber = src_grad_slice + i1*m;
+            const T gamma_val = gamma[i1];
+            Index i0 = 0;
+            for(; i0 < m_vec; i0 += W)
+            {
+                const V inv = simd::load<T, W>(inv_rms_slice+i0);
+                const V xhat = simd::load<T, W>(src_fiber+i0) * inv;
+                const V g = simd::load<T, W>(dst_grad_fiber+i0) * gamma_val;
+                const V dx = simd::load<T, W>(src_grad_fiber+i0)
+                    + inv*(g-xhat*simd::load<T, W>(&sum_gx[i0]));
+                simd::store<T, W>(dx, src_grad_fiber+i0);
+            }
+            for(; i0 < m; ++i0)
+            {
+                const T inv = inv_rms_slice[i0];
+                const T xhat = src_fiber[i0] * inv;
+                const T g = dst_grad_fiber[i0] * gamma_val;
+                src_grad_fiber[i0] += inv * (g-xhat*sum_gx[i0]);
+            }
+        }
+    }
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX2 void cpu_avx2(Index m, Index n, Index k,
+        const T *src, const T *dst_grad, const T *gamma, const T *inv_rms,
+        T *src_grad, T *gamma_grad)
+    noexcept
+{
+    cpu_simd<T, 32/sizeof(T)>(m, n, k, src, dst_grad, gamma, inv_rms,
+            src_grad, gamma_grad);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX512 void cpu_avx512(Index m, Index n, Index k,
+        const T *src, const T *dst_grad, const T *gamma, const T *inv_rms,
+        T *src_grad, T *gamma_grad)
+    noexcept
+{
+    cpu_simd<T, 64/sizeof(T)>(m, n, k, src, dst_grad, gamma, inv_rms,
+            src_grad, gamma_grad);
+}
+#endif // NNTILE_KERNEL_SIMD_X86
+
+template<typename T>
+void cpu(Index m, Index n, Index k, const T *src, const T *dst_grad,
+        const T *gamma, const T *inv_rms, T *src_grad, T *gamma_grad)
+    noexcept
+//! Backward of root mean square layer normalization along middle axis
+/*! Normalized input xhat = src*inv_rms is recomputed from src and inv_rms,
+ * that are produced by nntile::kernel::rms_norm::cpu(). Gradients are
+ * accumulated as follows:
+ *      g[i,l,j] = dst_grad[i,l,j] * gamma[l]
+ *      src_grad[i,l,j] += inv_rms[i,j] * (g[i,l,j]
+ *          - xhat[i,l,j]*sum_t g[i,t,j]*xhat[i,t,j]/k)
+ *      gamma_grad[l] += sum_{i,j} dst_grad[i,l,j]*xhat[i,l,j]
+ * Vectorized AVX2 or AVX-512 implementation is used if it is supported by
+ * the CPU and allowed by nntile::kernel::simd::set_level(). The kernel is
+ * sequential, as all the slices contribute to the same gradient of gamma.
+ *
+ * @param[in] m: Size of the first mode of src and inv_rms
+ * @param[in] n: Size of the last mode of src and inv_rms
+ * @param[in] k: Size of the middle mode of src, that is normalized
+ * @param[in] src: Input of forward pass as a contiguous m-by-k-by-n array
+ * @param[in] dst_grad: Gradient of output as a contiguous m-by-k-by-n array
+ * @param[in] gamma: Scaling factors of size k
+ * @param[in] inv_rms: Contiguous m-by-n array of inverses of root mean
+ *      squares
+ * @param[inout] src_grad: Gradient of input as a contiguous m-by-k-by-n array
+ * @param[inout] gamma_grad: Gradient of gamma of size k
+ * */
+{
+#ifdef NNTILE_KERNEL_SIMD_X86
+    switch(simd::get_level())
+    {
+        case simd::Level::AVX512:
+            cpu_avx512<T>(m, n, k, src, dst_grad, gamma, inv_rms, src_grad,
+                    gamma_grad);
+            return;
+        case simd::Level::AVX2:
+            cpu_avx2<T>(m, n, k, src, dst_grad, gamma, inv_rms, src_grad,
+                    gamma_grad);
+            return;
+        default:
+            break;
+    }
+#endif // NNTILE_KERNEL_SIMD_X86
+    cpu_scalar<T>(m, n, k, src, dst_grad, gamma, inv_rms, src_grad,
+            gamma_grad);
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, const fp32_t *src,
+        const fp32_t *dst_grad, const fp32_t *gamma, const fp32_t *inv_rms,
+        fp32_t *src_grad, fp32_t *gamma_grad)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, const fp64_t *src,
+        const fp64_t *dst_grad, const fp64_t *gamma, const fp64_t *inv_rms,
+        fp64_t *src_grad, fp64_t *gamma_grad)
+    noexcept;
+
+} // namespace rms_norm_backward
+} // namespace kernel
+} // namespace nntile
+
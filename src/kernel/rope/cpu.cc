@@ -0,0 +1,105 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/rope/cpu.cc
+ * Rotary position embedding on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/rope/cpu.hh"
+#include <cmath>
+#include <vector>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace rope
+{
+
+template<typename T>
+void cpu(Index m, Index n, Index k, Index head_size, Index offset_m,
+        Index offset_n, T base, bool inverse, T *data)
+    noexcept
+//! In-place rotary position embedding on CPU
+/*! Rotates every pair of consecutive elements along the first mode of data
+ * by an angle, that is proportional to the position along the second mode:
+ *      data[2p,j,l] = c*data[2p,j,l] - s*data[2p+1,j,l]
+ *      data[2p+1,j,l] = s*data[2p,j,l] + c*data[2p+1,j,l],
+ * where c and s are cosine and sine of
+ *      (offset_n+j) * base^(-(offset_m+2p)/head_size).
+ * Inverse rotation (by the negated angle) is the backward of the forward
+ * one, as rotations are orthogonal. Pairs are interleaved as in the
+ * original implementation of RoPE, so weights of models with rotated halves
+ * of heads shall be permuted accordingly.
+ *
+ * Cosines and sines are computed in double precision once for all the
+ * positions and pairs of the window and reused for all the fibers along the
+ * last mode.
+ *
+ * @param[in] m: Size of the first mode of data, shall be even
+ * @param[in] n: Size of the second mode of data (positions)
+ * @param[in] k: Size of the last mode of data
+ * @param[in] head_size: Size of the whole head, that defines frequencies
+ * @param[in] offset_m: Even offset of the window along the first mode
+ * @param[in] offset_n: Position of the first element along the second mode
+ * @param[in] base: Base of frequencies, e.g. 10000
+ * @param[in] inverse: Rotate by negated angles
+ * @param[inout] data: Input and output contiguous m-by-n-by-k array
+ * */
+{
+    const Index npairs = m / 2, mn = m * n;
+    // Table of cosines and sines for all positions and pairs
+    std::vector<T> table(2*npairs*n);
+    const double log_base = std::log(double(base));
+    for(Index p = 0; p < npairs; ++p)
+    {
+        double freq = std::exp(-log_base * double(offset_m+2*p)
+                / double(head_size));
+        for(Index j = 0; j < n; ++j)
+        {
+            double angle = double(offset_n+j) * freq;
+            table[2*(j*npairs+p)] = std::cos(angle);
+            table[2*(j*npairs+p)+1] = inverse ? -std::sin(angle)
+                : std::sin(angle);
+        }
+    }
+    // Cycle over fibers along the last mode
+    for(Index l = 0; l < k; ++l)
+    {
+        for(Index j = 0; j < n; ++j)
+        {
+            T *x = data + l*mn + j*m;
+            const T *cs = &table[2*j*npairs];
+            for(Index p = 0; p < npairs; ++p)
+            {
+                const T c = cs[2*p], s = cs[2*p+1];
+                const T x0 = x[2*p], x1 = x[2*p+1];
+                x[2*p] = c*x0 - s*x1;
+                x[2*p+1] = s*x0 + c*x1;
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, Index head_size, Index offset_m,
+        Index offset_n, fp32_t base, bool inverse, fp32_t *data)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, Index head_size, Index offset_m,
+        Index offset_n, fp64_t base, bool inverse, fp64_t *data)
+    noexcept;
+
+} // namespace rope
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,93 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/rope/cuda.cu
+ * Rotary position embedding on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/rope/cuda.hh"
+#include <algorithm>
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace rope
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index npairs, Index n, Index k, Index mn, Index head_size,
+        Index offset_m, Index offset_n, double log_base, bool inverse,
+        T *data)
+//! In-place rotary position embedding on CUDA
+/*! Every thread computes cosine and sine of its pair and position once and
+ * rotates the corresponding pairs of a subset of fibers along the last mode.
+ * See kernel::rope::cpu for the description of the operation.
+ * */
+{
+    Index p = threadIdx.x + blockIdx.x*blockDim.x,
+          j = threadIdx.y + blockIdx.y*blockDim.y;
+    if(p < npairs and j < n)
+    {
+        double freq = exp(-log_base * double(offset_m+2*p)
+                / double(head_size));
+        double s, c;
+        sincos(double(offset_n+j)*freq, &s, &c);
+        const T cv = c, sv = inverse ? -s : s;
+        T *x = data + j*2*npairs + 2*p;
+        for(Index l = blockIdx.z; l < k; l += gridDim.z)
+        {
+            const T x0 = x[l*mn], x1 = x[l*mn+1];
+            x[l*mn] = cv*x0 - sv*x1;
+            x[l*mn+1] = sv*x0 + cv*x1;
+        }
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, Index head_size,
+        Index offset_m, Index offset_n, T base, bool inverse, T *data)
+    noexcept
+//! In-place rotary position embedding on CUDA
+/*! See kernel::rope::cpu for the description of arguments.
+ * */
+{
+    Index npairs = m / 2;
+    if(npairs == 0 or n == 0 or k == 0)
+    {
+        return;
+    }
+    dim3 threads(std::min(int(npairs), 32), std::min(int(n), 8));
+    dim3 blocks((npairs+threads.x-1)/threads.x, (n+threads.y-1)/threads.y,
+            std::min(int(k), 64));
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(npairs, n, k, m*n,
+            head_size, offset_m, offset_n, std::log(double(base)), inverse,
+            data);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k,
+        Index head_size, Index offset_m, Index offset_n, fp32_t base,
+        bool inverse, fp32_t *data)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k,
+        Index head_size, Index offset_m, Index offset_n, fp64_t base,
+        bool inverse, fp64_t *data)
+    noexcept;
+
+} // namespace rope
+} // namespace kernel
+} // namespace nntile
+
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/scal/cpu.hh"
+#include "nntile/kernel/simd.hh"
 
 namespace nntile
 {
@@ -35,10 +36,14 @@ void cpu(Index nelems, T alpha, const T* src, T* dst)
  *      ignored, its content is overwritten on exit.
  * */
 {
-    for(Index i = 0; i < nelems; ++i)
+    // Loops are auto-vectorized for the instruction set of CPU kernels
+    simd::dispatch([&]() NNTILE_SIMD_LOOP
     {
-        dst[i] = alpha * src[i];
-    }
+        for(Index i = 0; i < nelems; ++i)
+        {
+            dst[i] = alpha * src[i];
+        }
+    });
 }
 
 // Explicit instantiation
@@ -0,0 +1,115 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/sgd_step/cpu.cc
+ * Fused SGD step with momentum on buffers on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/sgd_step/cpu.hh"
+#include "nntile/kernel/simd.hh"
+#include "nntile/kernel/parallel.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace sgd_step
+{
+
+template<typename T>
+void cpu(Index num_iter, Index num_elems, T momentum, T dampening, T lr,
+        T weight_decay, bool nesterov, const T *grad, T *velocity, T *p)
+    noexcept
+//! Fused SGD step with momentum on buffers
+/*! Performs the following operations in a single pass over buffers:
+ *      g = grad[i] + weight_decay*p[i],
+ *      velocity[i] = g, if num_iter is 1,
+ *      velocity[i] = momentum*velocity[i] + (1-dampening)*g, otherwise,
+ *      g = g + momentum*velocity[i], if nesterov is true,
+ *      g = velocity[i], otherwise,
+ *      p[i] = p[i] - lr*g.
+ * If momentum is zero, velocity is not accessed and can be nullptr. Loops
+ * are auto-vectorized for the instruction set of CPU kernels, and buffers
+ * are split among threads, allowed by
+ * nntile::kernel::parallel::set_num_threads().
+ *
+ * @param[in] num_iter: current iteration number, starting from 1
+ * @param[in] num_elems: Number of elements in buffers
+ * @param[in] momentum: Momentum factor
+ * @param[in] dampening: Dampening of gradients in velocity
+ * @param[in] lr: Learning rate
+ * @param[in] weight_decay: Coefficient of l2 regularizer
+ * @param[in] nesterov: Whether to use Nesterov momentum
+ * @param[in] grad: Input buffer of gradients, that is not updated
+ * @param[inout] velocity: Buffer of velocity, not read at the first
+ *      iteration
+ * @param[inout] p: Buffer of parameters
+ * */
+{
+    constexpr T zero = 0, one = 1;
+    const T damp = one - dampening;
+    // Chunks of at least 16K elements are processed by a single thread
+    parallel::parallel_for(num_elems, 16384, [&](Index begin, Index end)
+    {
+        const T *g_ = grad + begin;
+        T *p_ = p + begin;
+        T *v_ = velocity + (velocity != nullptr ? begin : 0);
+        Index size = end - begin;
+        simd::dispatch([&]() NNTILE_SIMD_LOOP
+        {
+            if(momentum == zero)
+            {
+                for(Index i = 0; i < size; ++i)
+                {
+                    T g = g_[i] + weight_decay*p_[i];
+                    p_[i] -= lr * g;
+                }
+            }
+            // Velocity is not read at the first iteration
+            else if(num_iter == 1)
+            {
+                for(Index i = 0; i < size; ++i)
+                {
+                    T g = g_[i] + weight_decay*p_[i];
+                    v_[i] = g;
+                    p_[i] -= lr * (nesterov ? g+momentum*g : g);
+                }
+            }
+            else
+            {
+                for(Index i = 0; i < size; ++i)
+                {
+                    T g = g_[i] + weight_decay*p_[i];
+                    T v = momentum*v_[i] + damp*g;
+                    v_[i] = v;
+                    p_[i] -= lr * (nesterov ? g+momentum*v : v);
+                }
+            }
+        });
+    });
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index num_iter, Index num_elems, fp32_t momentum,
+        fp32_t dampening, fp32_t lr, fp32_t weight_decay, bool nesterov,
+        const fp32_t *grad, fp32_t *velocity, fp32_t *p)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index num_iter, Index num_elems, fp64_t momentum,
+        fp64_t dampening, fp64_t lr, fp64_t weight_decay, bool nesterov,
+        const fp64_t *grad, fp64_t *velocity, fp64_t *p)
+    noexcept;
+
+} // namespace sgd_step
+} // namespace kernel
+} // namespace nntile
+
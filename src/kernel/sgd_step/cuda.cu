@@ -0,0 +1,92 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/sgd_step/cuda.cu
+ * Fused SGD step with momentum on buffers on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/sgd_step/cuda.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace sgd_step
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index num_iter, Index num_elems, T momentum, T damp, T lr,
+        T weight_decay, bool nesterov, const T *grad, T *velocity, T *p)
+{
+    Index i = threadIdx.x + static_cast<Index>(blockIdx.x)*blockDim.x;
+    if(i < num_elems)
+    {
+        T p_val = p[i];
+        T g = grad[i] + weight_decay*p_val;
+        if(momentum != T(0))
+        {
+            // Velocity is not read at the first iteration
+            T v = g;
+            if(num_iter != 1)
+            {
+                v = momentum*velocity[i] + damp*g;
+            }
+            velocity[i] = v;
+            g = nesterov ? g+momentum*v : v;
+        }
+        p[i] = p_val - lr*g;
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index num_iter, Index num_elems, T momentum,
+        T dampening, T lr, T weight_decay, bool nesterov, const T *grad,
+        T *velocity, T *p)
+    noexcept
+//! Fused SGD step with momentum on buffers
+/*! See nntile::kernel::sgd_step::cpu for the description of operations.
+ *
+ * @param[in] num_iter: current iteration number, starting from 1
+ * @param[in] num_elems: Number of elements in buffers
+ * @param[in] momentum: Momentum factor
+ * @param[in] dampening: Dampening of gradients in velocity
+ * @param[in] lr: Learning rate
+ * @param[in] weight_decay: Coefficient of l2 regularizer
+ * @param[in] nesterov: Whether to use Nesterov momentum
+ * @param[in] grad: Input buffer of gradients, that is not updated
+ * @param[inout] velocity: Buffer of velocity, not read at the first
+ *      iteration
+ * @param[inout] p: Buffer of parameters
+ * */
+{
+    dim3 blocks((num_elems+255)/256), threads(256);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(num_iter, num_elems,
+            momentum, T(1)-dampening, lr, weight_decay, nesterov, grad,
+            velocity, p);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index num_iter, Index num_elems,
+        fp32_t momentum, fp32_t dampening, fp32_t lr, fp32_t weight_decay,
+        bool nesterov, const fp32_t *grad, fp32_t *velocity, fp32_t *p)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index num_iter, Index num_elems,
+        fp64_t momentum, fp64_t dampening, fp64_t lr, fp64_t weight_decay,
+        bool nesterov, const fp64_t *grad, fp64_t *velocity, fp64_t *p)
+    noexcept;
+
+} // namespace sgd_step
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,132 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/simd.cc
+ * Run-time selection of vectorized CPU kernels
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-26
+ * */
+
+#include "nntile/kernel/simd.hh"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace simd
+{
+
+//! Detect the widest instruction set supported by the CPU
+static Level detect()
+    noexcept
+{
+#ifdef NNTILE_KERNEL_SIMD_X86
+    // This may be called during static initialization
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f"))
+    {
+        return Level::AVX512;
+    }
+    if(__builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma"))
+    {
+        return Level::AVX2;
+    }
+#endif // NNTILE_KERNEL_SIMD_X86
+    return Level::NONE;
+}
+
+static const Level supported_level = detect();
+
+//! Instruction set requested by NNTILE_CPU_SIMD environment variable
+/*! Values none, avx2 and avx512 restrict kernels of a binary, that is
+ * shared by different nodes, e.g., to compare them. A level, that is not
+ * supported by the CPU, is replaced by the widest supported one.
+ * */
+static Level initial_level()
+    noexcept
+{
+    const char *name = std::getenv("NNTILE_CPU_SIMD");
+    if(name == nullptr)
+    {
+        return supported_level;
+    }
+    Level level;
+    if(std::strcmp(name, "none") == 0)
+    {
+        level = Level::NONE;
+    }
+    else if(std::strcmp(name, "avx2") == 0)
+    {
+        level = Level::AVX2;
+    }
+    else if(std::strcmp(name, "avx512") == 0)
+    {
+        level = Level::AVX512;
+    }
+    else
+    {
+        std::cerr << "Unknown NNTILE_CPU_SIMD=" << name << " is ignored\n";
+        return supported_level;
+    }
+    if(static_cast<int>(level) > static_cast<int>(supported_level))
+    {
+        level = supported_level;
+    }
+    return level;
+}
+
+static std::atomic<Level> current_level(initial_level());
+
+//! Get instruction set used by CPU kernels
+Level get_level()
+    noexcept
+{
+    return current_level.load(std::memory_order_relaxed);
+}
+
+//! Restrict instruction set used by CPU kernels
+/*! Mostly for testing and benchmarking purposes. A level, that is not
+ * supported by the CPU, is replaced by the widest supported one.
+ *
+ * @param[in] level: Requested instruction set
+ * @return Instruction set that will be used
+ * */
+Level set_level(Level level)
+    noexcept
+{
+    if(static_cast<int>(level) > static_cast<int>(supported_level))
+    {
+        level = supported_level;
+    }
+    current_level.store(level, std::memory_order_relaxed);
+    return level;
+}
+
+//! Name of an instruction set
+const char *level_name(Level level)
+    noexcept
+{
+    switch(level)
+    {
+        case Level::AVX512:
+            return "avx512";
+        case Level::AVX2:
+            return "avx2";
+        default:
+            return "none";
+    }
+}
+
+} // namespace simd
+} // namespace kernel
+} // namespace nntile
+
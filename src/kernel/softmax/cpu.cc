@@ -13,7 +13,11 @@
  * */
 
 #include "nntile/kernel/softmax/cpu.hh"
+#include "nntile/kernel/simd.hh"
+#include "nntile/kernel/parallel.hh"
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace nntile
 {
@@ -23,20 +27,10 @@ namespace softmax
 {
 
 template<typename T>
-void cpu(Index m, Index n, Index k, const T *maxsumexp, const T *src, T alpha,
-        T *dst)
+static void cpu_scalar(Index m, Index n, Index k, const T *maxsumexp,
+        const T *src, T alpha, T *dst)
     noexcept
-//! Compute softmax on a buffer along middle axis
-/*! 
- *
- * @param[in] m: Size of the first mode of dst and sumnorm arrays
- * @param[in] n: Size of the last mode of dst and sumnorm arrays
- * @param[in] k: Size of the middle mode of dst array
- * @param[in] maxsumexp: Maximums and sums of exponents of slices
- * @param[in] src: Contiguous input array
- * @param[in] alpha: Scalar multiplier for the output
- * @param[out] dst: Contiguous output array
- * */
+//! Compute softmax on a buffer along middle axis without vectorization
 {
     Index src_dst_offset = 0;
     constexpr T zero = 0.0;
@@ -72,6 +66,149 @@ void cpu(Index m, Index n, Index k, const T *maxsumexp, const T *src, T alpha,
     }
 }
 
+#ifdef NNTILE_KERNEL_SIMD_X86
+template<typename T, int W>
+static NNTILE_SIMD_INLINE void cpu_simd(Index m, Index n, Index k,
+        const T *maxsumexp, const T *src, T alpha, T *dst)
+    noexcept
+//! Compute softmax on a buffer along middle axis with vectors of W elements
+/*! Masked out (infinite) values are zeroed by a blend instead of a branch.
+ * Slices along the contiguous first mode are processed by vectors, while the
+ * same W maximums and scaling factors are reused for all k slices. If the
+ * first mode is trivial, the middle mode is contiguous and it is vectorized
+ * instead.
+ * */
+{
+    using V = typename simd::Vec<T, W>::type;
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    const Index mk = m * k;
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        const T *maxsumexp_slice = maxsumexp + 2*m*i2;
+        const T *src_slice = src + i2*mk;
+        T *dst_slice = dst + i2*mk;
+        // Vectorize along the middle mode
+        if(m == 1)
+        {
+            const T max = maxsumexp_slice[0];
+            const T scale = alpha / maxsumexp_slice[1];
+            const V max_vec = simd::broadcast<T, W>(max);
+            const V scale_vec = simd::broadcast<T, W>(scale);
+            Index i1 = 0;
+            for(; i1+W <= k; i1 += W)
+            {
+                V val = simd::load<T, W>(src_slice+i1);
+                V res = simd::exp<T, W>(val-max_vec) * scale_vec;
+                res = simd::abs<T, W>(val) == inf ? V{} : res;
+                simd::store<T, W>(res, dst_slice+i1);
+            }
+            // Remaining elements
+            cpu_scalar<T>(1, 1, k-i1, maxsumexp_slice, src_slice+i1, alpha,
+                    dst_slice+i1);
+            continue;
+        }
+        // Vectorize along the first mode
+        Index i0 = 0;
+        for(; i0+W <= m; i0 += W)
+        {
+            T max[W], scale[W];
+            for(Index j = 0; j < W; ++j)
+            {
+                max[j] = maxsumexp_slice[2*(i0+j)];
+                scale[j] = alpha / maxsumexp_slice[2*(i0+j)+1];
+            }
+            const V max_vec = simd::load<T, W>(max);
+            const V scale_vec = simd::load<T, W>(scale);
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                V val = simd::load<T, W>(src_slice+i1*m+i0);
+                V res = simd::exp<T, W>(val-max_vec) * scale_vec;
+                res = simd::abs<T, W>(val) == inf ? V{} : res;
+                simd::store<T, W>(res, dst_slice+i1*m+i0);
+            }
+        }
+        // Remaining elements of the first mode
+        for(; i0 < m; ++i0)
+        {
+            const T max = maxsumexp_slice[2*i0];
+            const T sum = maxsumexp_slice[2*i0+1];
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                T val = src_slice[i1*m+i0];
+                dst_slice[i1*m+i0] = std::isinf(val) ? T(0)
+                    : alpha * std::exp(val-max) / sum;
+            }
+        }
+    }
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX2 void cpu_avx2(Index m, Index n, Index k,
+        const T *maxsumexp, const T *src, T alpha, T *dst)
+    noexcept
+{
+    cpu_simd<T, 32/sizeof(T)>(m, n, k, maxsumexp, src, alpha, dst);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX512 void cpu_avx512(Index m, Index n, Index k,
+        const T *maxsumexp, const T *src, T alpha, T *dst)
+    noexcept
+{
+    cpu_simd<T, 64/sizeof(T)>(m, n, k, maxsumexp, src, alpha, dst);
+}
+#endif // NNTILE_KERNEL_SIMD_X86
+
+template<typename T>
+static void cpu_range(Index m, Index n, Index k, const T *maxsumexp,
+        const T *src, T alpha, T *dst)
+    noexcept
+//! Softmax on a range of slices
+{
+#ifdef NNTILE_KERNEL_SIMD_X86
+    switch(simd::get_level())
+    {
+        case simd::Level::AVX512:
+            cpu_avx512<T>(m, n, k, maxsumexp, src, alpha, dst);
+            return;
+        case simd::Level::AVX2:
+            cpu_avx2<T>(m, n, k, maxsumexp, src, alpha, dst);
+            return;
+        default:
+            break;
+    }
+#endif // NNTILE_KERNEL_SIMD_X86
+    cpu_scalar<T>(m, n, k, maxsumexp, src, alpha, dst);
+}
+
+template<typename T>
+void cpu(Index m, Index n, Index k, const T *maxsumexp, const T *src, T alpha,
+        T *dst)
+    noexcept
+//! Compute softmax on a buffer along middle axis
+/*! Vectorized AVX2 or AVX-512 implementation is used if it is supported by
+ * the CPU and allowed by nntile::kernel::simd::set_level(). Slices along
+ * the last axis are split among threads, allowed by
+ * nntile::kernel::parallel::set_num_threads().
+ *
+ * @param[in] m: Size of the first mode of dst and sumnorm arrays
+ * @param[in] n: Size of the last mode of dst and sumnorm arrays
+ * @param[in] k: Size of the middle mode of dst array
+ * @param[in] maxsumexp: Maximums and sums of exponents of slices
+ * @param[in] src: Contiguous input array
+ * @param[in] alpha: Scalar multiplier for the output
+ * @param[out] dst: Contiguous output array
+ * */
+{
+    // Chunks of at least 64K elements are processed by a single thread
+    Index grain = 65536 / std::max<Index>(m*k, 1);
+    parallel::parallel_for(n, grain, [&](Index begin, Index end)
+    {
+        cpu_range<T>(m, end-begin, k, maxsumexp+2*m*begin, src+m*k*begin,
+                alpha, dst+m*k*begin);
+    });
+}
+
 // Explicit instantiation
 template
 void cpu<fp32_t>(Index m, Index n, Index k, const fp32_t *maxsumexp,
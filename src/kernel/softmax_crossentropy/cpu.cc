@@ -0,0 +1,112 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/softmax_crossentropy/cpu.cc
+ * Fused loss and gradient of softmax cross-entropy on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-14
+ * */
+
+#include "nntile/kernel/softmax_crossentropy/cpu.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace softmax_crossentropy
+{
+
+template<typename T>
+void cpu(Index n_labels, Index n_outputs, Index label_start, T scale,
+        const T *maxsumexp, const T *src, const Index *labels, T *dst,
+        T *val)
+    noexcept
+//! Fused loss and gradient of softmax cross-entropy on CPU
+/*!
+ * Logits src are a chunk of labels [label_start, label_start+n_labels) of
+ * a full matrix of logits, and maxsumexp holds maximums and sums of
+ * exponents over all the labels (not only over the chunk) for each of
+ * n_outputs columns. Mnemonically, the following operations are performed:
+ * for every i in [0, n_outputs)
+ *      lse = maxsumexp[0, i] + log(maxsumexp[1, i])
+ *      dst[:, i] = scale * exp(src[:, i]-lse)
+ *      if labels[i] is within the chunk:
+ *          dst[labels[i]-label_start, i] -= scale
+ *          val += scale * (lse-src[labels[i]-label_start, i])
+ *
+ * Therefore, all the chunks together produce the loss and its gradient
+ * with a single read of logits after the maxsumexp pass. Infinite logits
+ * (masked out outputs) get zero probability.
+ *
+ * @param[in] n_labels: Number of labels within the chunk
+ * @param[in] n_outputs: Number of outputs (columns)
+ * @param[in] label_start: Index of the first label of the chunk
+ * @param[in] scale: Scalar multiplier of the loss and the gradient
+ * @param[in] maxsumexp: Maximums and sums of exponents of size 2 times
+ *      n_outputs
+ * @param[in] src: Chunk of logits of size n_labels times n_outputs stored
+ *      continuously in Fortran order
+ * @param[in] labels: Array of size n_outputs with correct labels
+ * @param[out] dst: Gradient of the loss with respect to src
+ * @param[inout] val: Scalar that accumulates the loss
+ * */
+{
+    constexpr T zero = 0.0;
+    // Kahan summation of the loss
+    T sum = zero, c = zero, y, t;
+    for(Index i = 0; i < n_outputs; ++i)
+    {
+        const T max = maxsumexp[2*i];
+        const T lse = max + std::log(maxsumexp[2*i+1]);
+        const T *src_slice = src + i*n_labels;
+        T *dst_slice = dst + i*n_labels;
+        // Probabilities by a single pass over the chunk
+        for(Index j = 0; j < n_labels; ++j)
+        {
+            T src_val = src_slice[j];
+            if(not std::isinf(src_val))
+            {
+                dst_slice[j] = scale * std::exp(src_val-lse);
+            }
+            else
+            {
+                dst_slice[j] = zero;
+            }
+        }
+        // Correct label belongs to the chunk
+        Index label = labels[i] - label_start;
+        if(label >= 0 and label < n_labels)
+        {
+            dst_slice[label] -= scale;
+            y = (lse-src_slice[label]) - c;
+            t = sum + y;
+            c = (t-sum) - y;
+            sum = t;
+        }
+    }
+    *val = (*val-scale*c) + scale*sum;
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index n_labels, Index n_outputs, Index label_start,
+        fp32_t scale, const fp32_t *maxsumexp, const fp32_t *src,
+        const Index *labels, fp32_t *dst, fp32_t *val)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index n_labels, Index n_outputs, Index label_start,
+        fp64_t scale, const fp64_t *maxsumexp, const fp64_t *src,
+        const Index *labels, fp64_t *dst, fp64_t *val)
+    noexcept;
+
+} // namespace softmax_crossentropy
+} // namespace kernel
+} // namespace nntile
+
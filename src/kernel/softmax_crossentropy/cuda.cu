@@ -0,0 +1,108 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/softmax_crossentropy/cuda.cu
+ * Fused loss and gradient of softmax cross-entropy on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-14
+ * */
+
+#include "nntile/kernel/softmax_crossentropy/cuda.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace softmax_crossentropy
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index n_labels, Index label_start, T scale,
+        const T *maxsumexp, const T *src, const Index *labels, T *dst,
+        T *val)
+//! Each block processes a slice of a single column
+{
+    Index i = blockIdx.x;
+    Index j = threadIdx.x + blockIdx.y*Index(blockDim.x);
+    if(j >= n_labels)
+    {
+        return;
+    }
+    const T max = maxsumexp[2*i];
+    const T lse = max + ::log(maxsumexp[2*i+1]);
+    Index offset = i*n_labels + j;
+    T src_val = src[offset];
+    T dst_val = ::isinf(src_val) ? T(0) : scale*::exp(src_val-lse);
+    // Correct label is processed by a single thread
+    if(labels[i]-label_start == j)
+    {
+        dst_val -= scale;
+        atomicAdd(val, scale*(lse-src_val));
+    }
+    dst[offset] = dst_val;
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index n_labels, Index n_outputs,
+        Index label_start, T scale, const T *maxsumexp, const T *src,
+        const Index *labels, T *dst, T *val)
+    noexcept
+//! Fused loss and gradient of softmax cross-entropy on CUDA
+/*!
+ * Logits src are a chunk of labels [label_start, label_start+n_labels) of
+ * a full matrix of logits, and maxsumexp holds maximums and sums of
+ * exponents over all the labels (not only over the chunk) for each of
+ * n_outputs columns. Mnemonically, the following operations are performed:
+ * for every i in [0, n_outputs)
+ *      lse = maxsumexp[0, i] + log(maxsumexp[1, i])
+ *      dst[:, i] = scale * exp(src[:, i]-lse)
+ *      if labels[i] is within the chunk:
+ *          dst[labels[i]-label_start, i] -= scale
+ *          val += scale * (lse-src[labels[i]-label_start, i])
+ *
+ * Therefore, all the chunks together produce the loss and its gradient
+ * with a single read of logits after the maxsumexp pass. Infinite logits
+ * (masked out outputs) get zero probability.
+ *
+ * @param[in] n_labels: Number of labels within the chunk
+ * @param[in] n_outputs: Number of outputs (columns)
+ * @param[in] label_start: Index of the first label of the chunk
+ * @param[in] scale: Scalar multiplier of the loss and the gradient
+ * @param[in] maxsumexp: Maximums and sums of exponents of size 2 times
+ *      n_outputs
+ * @param[in] src: Chunk of logits of size n_labels times n_outputs stored
+ *      continuously in Fortran order
+ * @param[in] labels: Array of size n_outputs with correct labels
+ * @param[out] dst: Gradient of the loss with respect to src
+ * @param[inout] val: Scalar that accumulates the loss
+ * */
+{
+    // Number of outputs may exceed the limit of the second grid dimension
+    dim3 blocks(n_outputs, (n_labels+255)/256), threads(256);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(n_labels, label_start,
+            scale, maxsumexp, src, labels, dst, val);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index n_labels, Index n_outputs,
+        Index label_start, fp32_t scale, const fp32_t *maxsumexp,
+        const fp32_t *src, const Index *labels, fp32_t *dst, fp32_t *val)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index n_labels, Index n_outputs,
+        Index label_start, fp64_t scale, const fp64_t *maxsumexp,
+        const fp64_t *src, const Index *labels, fp64_t *dst, fp64_t *val)
+    noexcept;
+
+} // namespace softmax_crossentropy
+} // namespace kernel
+} // namespace nntile
+
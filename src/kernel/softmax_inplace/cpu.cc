@@ -13,7 +13,9 @@
  * */
 
 #include "nntile/kernel/softmax_inplace/cpu.hh"
+#include "nntile/kernel/simd.hh"
 #include <cmath>
+#include <limits>
 
 namespace nntile
 {
@@ -23,21 +25,14 @@ namespace softmax_inplace
 {
 
 template<typename T>
-void cpu(Index m, Index n, Index k, const T *maxsumexp, T alpha, T *dst)
+static void cpu_scalar(Index m, Index n, Index k, const T *maxsumexp, T alpha,
+        T *dst)
     noexcept
-//! Compute softmax on a buffer along middle axis
-/*! 
- *
- * @param[in] m: Size of the first mode of dst and sumnorm arrays
- * @param[in] n: Size of the last mode of dst and sumnorm arrays
- * @param[in] k: Size of the middle mode of dst array
- * @param[in] maxsumexp: Maximums and sums of exponents of slices
- * @param[in] alpha: Scalar multiplier for the output
- * @param[in] dst: Contiguous output array
- * */
+//! Compute softmax on a buffer along middle axis without vectorization
 {
+    using Y = compute_t<T>;
     Index dst_offset = 0;
-    constexpr T zero = 0.0;
+    constexpr Y zero = 0.0;
     // Outer loop by the last mode of dst and sumnorm arrays
     for(Index i2 = 0; i2 < n; ++i2)
     {
@@ -49,18 +44,18 @@ void cpu(Index m, Index n, Index k, const T *maxsumexp, T alpha, T *dst)
             for(Index i0 = 0; i0 < m; ++i0)
             {
                 // Value-to-update
-                T &val = dst[dst_offset];
+                Y val = dst[dst_offset];
                 // Max and sum of exponents
-                const T max = maxsumexp[src_offset];
-                const T sum = maxsumexp[src_offset+1];
+                const Y max = maxsumexp[src_offset];
+                const Y sum = maxsumexp[src_offset+1];
                 // Update value
                 if(not std::isinf(val))
                 {
-                    val = alpha * std::exp(val-max) / sum;
+                    dst[dst_offset] = Y(alpha) * std::exp(val-max) / sum;
                 }
                 else
                 {
-                    val = zero;
+                    dst[dst_offset] = zero;
                 }
                 // Update pointers
                 ++dst_offset;
@@ -70,6 +65,127 @@ void cpu(Index m, Index n, Index k, const T *maxsumexp, T alpha, T *dst)
     }
 }
 
+#ifdef NNTILE_KERNEL_SIMD_X86
+template<typename T, int W>
+static NNTILE_SIMD_INLINE void cpu_simd(Index m, Index n, Index k,
+        const T *maxsumexp, T alpha, T *dst)
+    noexcept
+//! Compute softmax on a buffer along middle axis with vectors of W elements
+/*! The same as nntile::kernel::softmax::cpu_simd() with src == dst.
+ * */
+{
+    using V = typename simd::Vec<T, W>::type;
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    const Index mk = m * k;
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        const T *maxsumexp_slice = maxsumexp + 2*m*i2;
+        T *dst_slice = dst + i2*mk;
+        // Vectorize along the middle mode
+        if(m == 1)
+        {
+            const T max = maxsumexp_slice[0];
+            const T scale = alpha / maxsumexp_slice[1];
+            const V max_vec = simd::broadcast<T, W>(max);
+            const V scale_vec = simd::broadcast<T, W>(scale);
+            Index i1 = 0;
+            for(; i1+W <= k; i1 += W)
+            {
+                V val = simd::load<T, W>(dst_slice+i1);
+                V res = simd::exp<T, W>(val-max_vec) * scale_vec;
+                res = simd::abs<T, W>(val) == inf ? V{} : res;
+                simd::store<T, W>(res, dst_slice+i1);
+            }
+            // Remaining elements
+            cpu_scalar<T>(1, 1, k-i1, maxsumexp_slice, alpha, dst_slice+i1);
+            continue;
+        }
+        // Vectorize along the first mode
+        Index i0 = 0;
+        for(; i0+W <= m; i0 += W)
+        {
+            T max[W], scale[W];
+            for(Index j = 0; j < W; ++j)
+            {
+                max[j] = maxsumexp_slice[2*(i0+j)];
+                scale[j] = alpha / maxsumexp_slice[2*(i0+j)+1];
+            }
+            const V max_vec = simd::load<T, W>(max);
+            const V scale_vec = simd::load<T, W>(scale);
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                V val = simd::load<T, W>(dst_slice+i1*m+i0);
+                V res = simd::exp<T, W>(val-max_vec) * scale_vec;
+                res = simd::abs<T, W>(val) == inf ? V{} : res;
+                simd::store<T, W>(res, dst_slice+i1*m+i0);
+            }
+        }
+        // Remaining elements of the first mode
+        for(; i0 < m; ++i0)
+        {
+            const T max = maxsumexp_slice[2*i0];
+            const T sum = maxsumexp_slice[2*i0+1];
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                T &val = dst_slice[i1*m+i0];
+                val = std::isinf(val) ? T(0) : alpha * std::exp(val-max) / sum;
+            }
+        }
+    }
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX2 void cpu_avx2(Index m, Index n, Index k,
+        const T *maxsumexp, T alpha, T *dst)
+    noexcept
+{
+    cpu_simd<T, 32/sizeof(T)>(m, n, k, maxsumexp, alpha, dst);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX512 void cpu_avx512(Index m, Index n, Index k,
+        const T *maxsumexp, T alpha, T *dst)
+    noexcept
+{
+    cpu_simd<T, 64/sizeof(T)>(m, n, k, maxsumexp, alpha, dst);
+}
+#endif // NNTILE_KERNEL_SIMD_X86
+
+template<typename T>
+void cpu(Index m, Index n, Index k, const T *maxsumexp, T alpha, T *dst)
+    noexcept
+//! Compute softmax on a buffer along middle axis
+/*! Vectorized AVX2 or AVX-512 implementation is used if it is supported by
+ * the CPU and allowed by nntile::kernel::simd::set_level(). BF16 values are
+ * processed in single precision without vectorization.
+ *
+ * @param[in] m: Size of the first mode of dst and sumnorm arrays
+ * @param[in] n: Size of the last mode of dst and sumnorm arrays
+ * @param[in] k: Size of the middle mode of dst array
+ * @param[in] maxsumexp: Maximums and sums of exponents of slices
+ * @param[in] alpha: Scalar multiplier for the output
+ * @param[in] dst: Contiguous output array
+ * */
+{
+#ifdef NNTILE_KERNEL_SIMD_X86
+    if constexpr(std::is_same_v<T, compute_t<T>>)
+    {
+        switch(simd::get_level())
+        {
+            case simd::Level::AVX512:
+                cpu_avx512<T>(m, n, k, maxsumexp, alpha, dst);
+                return;
+            case simd::Level::AVX2:
+                cpu_avx2<T>(m, n, k, maxsumexp, alpha, dst);
+                return;
+            default:
+                break;
+        }
+    }
+#endif // NNTILE_KERNEL_SIMD_X86
+    cpu_scalar<T>(m, n, k, maxsumexp, alpha, dst);
+}
+
 // Explicit instantiation
 template
 void cpu<fp32_t>(Index m, Index n, Index k, const fp32_t *maxsumexp,
@@ -81,6 +197,16 @@ void cpu<fp64_t>(Index m, Index n, Index k, const fp64_t *maxsumexp,
         fp64_t alpha, fp64_t *dst)
     noexcept;
 
+template
+void cpu<bf16_t>(Index m, Index n, Index k, const bf16_t *maxsumexp,
+        bf16_t alpha, bf16_t *dst)
+    noexcept;
+
+template
+void cpu<fp16_t>(Index m, Index n, Index k, const fp16_t *maxsumexp,
+        fp16_t alpha, fp16_t *dst)
+    noexcept;
+
 } // namespace softmax_inplace
 } // namespace kernel
 } // namespace nntile
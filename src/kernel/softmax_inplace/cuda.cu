@@ -29,7 +29,8 @@ void cuda_kernel(Index m, Index m_per_block, Index n, Index n_per_block,
 {
     Index i0_block = blockIdx.y, i1_block = blockIdx.z,
           i2_start = threadIdx.x, i2_step = blockDim.x;
-    constexpr T zero = 0.0;
+    using Y = compute_t<T>;
+    constexpr Y zero = 0.0;
     for(Index i0 = i0_block*m_per_block;
             i0 < (i0_block+1)*m_per_block and i0 < m; ++i0)
     {
@@ -39,7 +40,7 @@ void cuda_kernel(Index m, Index m_per_block, Index n, Index n_per_block,
             Index dst_offset = i1*k*m + i0;
             T *dst_slice = dst + dst_offset;
             // Max and sum of exponents
-            __shared__ T max, sum;
+            __shared__ Y max, sum;
             if(i2_start == 0)
             {
                 Index src_offset = m*i1 + i0;
@@ -50,15 +51,15 @@ void cuda_kernel(Index m, Index m_per_block, Index n, Index n_per_block,
             for(Index i2 = i2_start; i2 < k; i2 += i2_step)
             {
                 // Value-to-update
-                T &val = dst_slice[i2*m];
+                Y val = dst_slice[i2*m];
                 // Update value
                 if(not ::isinf(val))
                 {
-                    val = alpha * ::exp(val-max) / sum;
+                    dst_slice[i2*m] = Y(alpha) * ::exp(val-max) / sum;
                 }
                 else
                 {
-                    val = zero;
+                    dst_slice[i2*m] = zero;
                 }
             }
         }
@@ -109,6 +110,16 @@ void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k,
         const fp64_t *maxsumexp, fp64_t alpha, fp64_t *dst)
     noexcept;
 
+template
+void cuda<bf16_t>(cudaStream_t stream, Index m, Index n, Index k,
+        const bf16_t *maxsumexp, bf16_t alpha, bf16_t *dst)
+    noexcept;
+
+template
+void cuda<fp16_t>(cudaStream_t stream, Index m, Index n, Index k,
+        const fp16_t *maxsumexp, fp16_t alpha, fp16_t *dst)
+    noexcept;
+
 } // namespace softmax_inplace
 } // namespace kernel
 } // namespace nntile
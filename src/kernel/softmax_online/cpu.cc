@@ -0,0 +1,123 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/softmax_online/cpu.cc
+ * Online softmax along the middle axis of several buffers on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/softmax_online/cpu.hh"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace softmax_online
+{
+
+template<typename T>
+void cpu(Index m, Index n, Index ntiles, const Index *k, T alpha,
+        T * const *dst)
+    noexcept
+//! Online softmax along the middle axis of several buffers
+/*! Buffers dst[0], ..., dst[ntiles-1] of shapes m-by-k[j]-by-n are
+ * concatenated along the middle axis and softmax is computed along it
+ * inplace: dst[i0,:,i2] = alpha * exp(dst[i0,:,i2]-max) / sum. Maximums and
+ * sums of exponents are updated by a single pass over all the buffers,
+ * while a slice of all the buffers usually stays in cache for the second
+ * pass, so that no maxsumexp tensor is needed. Infinite values, which come
+ * from mask, are turned into zeros.
+ *
+ * @param[in] m: Size of the first mode of buffers
+ * @param[in] n: Size of the last mode of buffers
+ * @param[in] ntiles: Number of buffers
+ * @param[in] k: Sizes of the middle mode of buffers
+ * @param[in] alpha: Scalar multiplier for the output
+ * @param[inout] dst: Contiguous buffers
+ * */
+{
+    using Y = compute_t<T>;
+    constexpr Y zero = 0.0, one = 1.0;
+    constexpr Y inf = std::numeric_limits<Y>::infinity();
+    std::vector<Y> max(m), scale(m);
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        std::fill(max.begin(), max.end(), -inf);
+        std::fill(scale.begin(), scale.end(), zero);
+        // Max and sum of exponents by a single pass
+        for(Index j = 0; j < ntiles; ++j)
+        {
+            const T *src = dst[j] + i2*m*k[j];
+            for(Index i1 = 0; i1 < k[j]; ++i1)
+            {
+                for(Index i0 = 0; i0 < m; ++i0)
+                {
+                    const Y val = src[i1*m+i0];
+                    if(std::isinf(val))
+                    {
+                        continue;
+                    }
+                    if(max[i0] < val)
+                    {
+                        scale[i0] = scale[i0]*std::exp(max[i0]-val) + one;
+                        max[i0] = val;
+                    }
+                    else
+                    {
+                        scale[i0] += std::exp(val-max[i0]);
+                    }
+                }
+            }
+        }
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            scale[i0] = Y(alpha) / scale[i0];
+        }
+        // Normalize
+        for(Index j = 0; j < ntiles; ++j)
+        {
+            T *slice = dst[j] + i2*m*k[j];
+            for(Index i1 = 0; i1 < k[j]; ++i1)
+            {
+                for(Index i0 = 0; i0 < m; ++i0)
+                {
+                    const Y val = slice[i1*m+i0];
+                    if(std::isinf(val))
+                    {
+                        slice[i1*m+i0] = zero;
+                    }
+                    else
+                    {
+                        slice[i1*m+i0] = std::exp(val-max[i0]) * scale[i0];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index ntiles, const Index *k,
+        fp32_t alpha, fp32_t * const *dst)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index ntiles, const Index *k,
+        fp64_t alpha, fp64_t * const *dst)
+    noexcept;
+
+} // namespace softmax_online
+} // namespace kernel
+} // namespace nntile
+
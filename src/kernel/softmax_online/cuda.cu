@@ -0,0 +1,226 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/softmax_online/cuda.cu
+ * Online softmax along the middle axis of several buffers on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/softmax_online/cuda.hh"
+#include "nntile/kernel/softmax_online.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace softmax_online
+{
+
+// Values of a slice are cached in shared memory, if they fit into it
+static constexpr Index MAX_SHARED = 48 * 1024;
+
+//! Pointers to buffers and their offsets within the concatenation of buffers
+template<typename T>
+struct TileList
+{
+    T *dst[MAX_TILES];
+    Index offset[MAX_TILES+1];
+    int ntiles;
+};
+
+template<typename Y>
+static __device__
+void combine(Y &max, Y &sum, Y max2, Y sum2)
+//! Combine max and sum of exponents with another pair
+{
+    if(sum2 == Y(0))
+    {
+        return;
+    }
+    if(sum == Y(0))
+    {
+        max = max2;
+        sum = sum2;
+    }
+    else if(max < max2)
+    {
+        sum = sum*::exp(max-max2) + sum2;
+        max = max2;
+    }
+    else
+    {
+        sum += sum2*::exp(max2-max);
+    }
+}
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, Index m_per_block, Index n, Index n_per_block,
+        TileList<T> list, T alpha, bool cache)
+{
+    Index i0_block = blockIdx.y, i2_block = blockIdx.z,
+          i1_start = threadIdx.x, i1_step = blockDim.x;
+    using Y = compute_t<T>;
+    constexpr Y zero = 0.0, one = 1.0;
+    extern __shared__ __align__(sizeof(double)) unsigned char shared_raw[];
+    // Partial maximums and sums of exponents of threads, followed by cached
+    // values of a slice
+    Y *max_shared = reinterpret_cast<Y *>(shared_raw);
+    Y *sum_shared = max_shared + i1_step;
+    Y *cache_shared = sum_shared + i1_step;
+    const Index k = list.offset[list.ntiles];
+    for(Index i0 = i0_block*m_per_block;
+            i0 < (i0_block+1)*m_per_block and i0 < m; ++i0)
+    {
+        for(Index i2 = i2_block*n_per_block;
+                i2 < (i2_block+1)*n_per_block and i2 < n; ++i2)
+        {
+            // Online max and sum of exponents of values of a thread.
+            // Indices of a thread only grow, so the buffer is found by a
+            // forward search.
+            Y max = -INFINITY, sum = zero;
+            int j = 0;
+            for(Index i1 = i1_start; i1 < k; i1 += i1_step)
+            {
+                while(i1 >= list.offset[j+1])
+                {
+                    ++j;
+                }
+                Index k_j = list.offset[j+1] - list.offset[j];
+                Y val = list.dst[j][(i2*k_j+i1-list.offset[j])*m+i0];
+                if(cache)
+                {
+                    cache_shared[i1] = val;
+                }
+                if(::isinf(val))
+                {
+                    continue;
+                }
+                if(max < val)
+                {
+                    sum = sum*::exp(max-val) + one;
+                    max = val;
+                }
+                else
+                {
+                    sum += ::exp(val-max);
+                }
+            }
+            // Reduce over threads of the block
+            max_shared[i1_start] = max;
+            sum_shared[i1_start] = sum;
+            __syncthreads();
+            for(Index s = i1_step/2; s > 0; s /= 2)
+            {
+                if(i1_start < s)
+                {
+                    combine(max_shared[i1_start], sum_shared[i1_start],
+                            max_shared[i1_start+s], sum_shared[i1_start+s]);
+                }
+                __syncthreads();
+            }
+            max = max_shared[0];
+            const Y scale = Y(alpha) / sum_shared[0];
+            __syncthreads();
+            // Normalize values, that are read from cache if possible
+            j = 0;
+            for(Index i1 = i1_start; i1 < k; i1 += i1_step)
+            {
+                while(i1 >= list.offset[j+1])
+                {
+                    ++j;
+                }
+                Index k_j = list.offset[j+1] - list.offset[j];
+                T *dst = list.dst[j] + (i2*k_j+i1-list.offset[j])*m + i0;
+                Y val = cache ? cache_shared[i1] : Y(*dst);
+                if(::isinf(val))
+                {
+                    *dst = zero;
+                }
+                else
+                {
+                    *dst = ::exp(val-max) * scale;
+                }
+            }
+        }
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index ntiles,
+        const Index *k, T alpha, T * const *dst)
+    noexcept
+//! Online softmax along the middle axis of several buffers on CUDA
+/*! All the buffers are processed by a single kernel launch, so ntiles shall
+ * not exceed MAX_TILES. A block of threads is assigned to a slice of all
+ * the buffers. Values of the slice are cached in shared memory during the
+ * pass, that computes max and sum of exponents, if they fit, so that every
+ * value is read from the global memory only once. Parameters are the same
+ * as of nntile::kernel::softmax_online::cpu(), while arrays of pointers and
+ * sizes are in the host memory.
+ * */
+{
+    using Y = compute_t<T>;
+    TileList<T> list;
+    list.ntiles = ntiles;
+    list.offset[0] = 0;
+    for(int j = 0; j < ntiles; ++j)
+    {
+        list.dst[j] = dst[j];
+        list.offset[j+1] = list.offset[j] + k[j];
+    }
+    const Index k_total = list.offset[ntiles];
+    if(k_total == 0)
+    {
+        return;
+    }
+    // Power of 2 threads for the reduction
+    int nthreads = 32;
+    while(nthreads < 256 and nthreads < k_total)
+    {
+        nthreads *= 2;
+    }
+    dim3 threads(nthreads, 1, 1), blocks(1, m, n);
+    Index m_per_block = 1, n_per_block = 1;
+    if(m > 65535)
+    {
+        m_per_block = (m+65534) / 65535;
+        blocks.y = (m+m_per_block-1) / m_per_block;
+    }
+    if(n > 65535)
+    {
+        n_per_block = (n+65534) / 65535;
+        blocks.z = (n+n_per_block-1) / n_per_block;
+    }
+    Index shared = 2 * nthreads * sizeof(Y);
+    bool cache = shared + k_total*sizeof(Y) <= MAX_SHARED;
+    if(cache)
+    {
+        shared += k_total * sizeof(Y);
+    }
+    (cuda_kernel<T>)<<<blocks, threads, shared, stream>>>(m, m_per_block, n,
+            n_per_block, list, alpha, cache);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index ntiles,
+        const Index *k, fp32_t alpha, fp32_t * const *dst)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index ntiles,
+        const Index *k, fp64_t alpha, fp64_t * const *dst)
+    noexcept;
+
+} // namespace softmax_online
+} // namespace kernel
+} // namespace nntile
+
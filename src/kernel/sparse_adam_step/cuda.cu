@@ -0,0 +1,127 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/sparse_adam_step/cuda.cu
+ * Fused Adam step on marked columns of CUDA buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-13
+ * */
+
+#include "nntile/kernel/sparse_adam_step/cuda.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace sparse_adam_step
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        const bool_t *cols, Index *cols_iter, const T *grad, T *first_moment,
+        T *second_moment, T *p)
+//! Each block updates a single column
+{
+    Index j = blockIdx.x;
+    if(!cols[j])
+    {
+        return;
+    }
+    // Bias correction of the column
+    Index num_iter = cols_iter[j] + 1;
+    T alpha = lr / (1-::pow(beta_1, T(num_iter)));
+    T beta = 1 / ::sqrt(1-::pow(beta_2, T(num_iter)));
+    // Cycle over the column
+    for(Index i = j*m+threadIdx.x; i < (j+1)*m; i += blockDim.x)
+    {
+        T p_val = p[i], grad_val = grad[i];
+        if(weight_decay != 0)
+        {
+            grad_val += weight_decay * p_val;
+        }
+        T f_val, s_val;
+        if(num_iter == 1)
+        {
+            f_val = (1-beta_1) * grad_val;
+            s_val = ::sqrt(1-beta_2) * ::fabs(grad_val);
+        }
+        else
+        {
+            f_val = beta_1*first_moment[i] + (1-beta_1)*grad_val;
+            s_val = ::hypot(::sqrt(beta_2)*second_moment[i],
+                    ::sqrt(1-beta_2)*grad_val);
+        }
+        first_moment[i] = f_val;
+        second_moment[i] = s_val;
+        p[i] = p_val - alpha*f_val/(s_val*beta+eps);
+    }
+    // Counter is updated after all the threads read it
+    __syncthreads();
+    if(threadIdx.x == 0)
+    {
+        cols_iter[j] = num_iter;
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, T beta_1, T beta_2, T eps,
+        T lr, T weight_decay, const bool_t *cols, Index *cols_iter,
+        const T *grad, T *first_moment, T *second_moment, T *p)
+    noexcept
+//! Fused Adam step on marked columns of CUDA buffers
+/*!
+ * Parameters are an m-by-n matrix, that corresponds to a tile of embedding
+ * vocabulary, where each of n columns is an embedding of a single token.
+ * Only columns j, where cols[j] is true, are updated. Columns, that are
+ * not marked, keep their values and moments, as if the step was not done
+ * for them at all. Counter cols_iter[j] is a number of steps, that were done
+ * for column j, and bias correction terms depend on it instead of a global
+ * iteration number. Moments of column j are initialized by the first step
+ * of the column (when cols_iter[j] is zero).
+ *
+ * @param[in] m: Number of rows of buffers
+ * @param[in] n: Number of columns of buffers
+ * @param[in] beta_1: parameter for moving average of first moments
+ * @param[in] beta_2: parameter for moving average of second moments
+ * @param[in] eps: small scalar to avoid division by zero
+ * @param[in] lr: learning rate
+ * @param[in] weight_decay: coefficient for l2 regularizer
+ * @param[in] cols: Mask of columns to be updated
+ * @param[inout] cols_iter: Numbers of steps done for each column
+ * @param[in] grad: Input buffer stored gradient
+ * @param[inout] first_moment: Buffer stored first moments
+ * @param[inout] second_moment: Buffer stored square root of second moments
+ * @param[inout] p: Buffer with parameters, that are updated in the end
+ * */
+{
+    dim3 blocks(n), threads(m < 256 ? m : 256);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, beta_1, beta_2, eps,
+            lr, weight_decay, cols, cols_iter, grad, first_moment,
+            second_moment, p);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t lr, fp32_t weight_decay,
+        const bool_t *cols, Index *cols_iter, const fp32_t *grad,
+        fp32_t *first_moment, fp32_t *second_moment, fp32_t *p)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, fp64_t beta_1,
+        fp64_t beta_2, fp64_t eps, fp64_t lr, fp64_t weight_decay,
+        const bool_t *cols, Index *cols_iter, const fp64_t *grad,
+        fp64_t *first_moment, fp64_t *second_moment, fp64_t *p)
+    noexcept;
+
+} // namespace sparse_adam_step
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,263 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/strassen/cuda.cu
+ * Strassen multiplication operation on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/strassen/cuda.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace strassen
+{
+
+// Overloaded call to cuBLAS GEMM
+static inline
+void gemm(cublasHandle_t handle, cublasOperation_t transA,
+        cublasOperation_t transB, int m, int n, int k, fp32_t alpha,
+        const fp32_t *A, int ldA, const fp32_t *B, int ldB, fp32_t beta,
+        fp32_t *C, int ldC)
+    noexcept
+{
+    cublasSgemm(handle, transA, transB, m, n, k, &alpha, A, ldA, B, ldB,
+            &beta, C, ldC);
+}
+
+// Overloaded call to cuBLAS GEMM
+static inline
+void gemm(cublasHandle_t handle, cublasOperation_t transA,
+        cublasOperation_t transB, int m, int n, int k, fp64_t alpha,
+        const fp64_t *A, int ldA, const fp64_t *B, int ldB, fp64_t beta,
+        fp64_t *C, int ldC)
+    noexcept
+{
+    cublasDgemm(handle, transA, transB, m, n, k, &alpha, A, ldA, B, ldB,
+            &beta, C, ldC);
+}
+
+// Overloaded call to cuBLAS GEAM, that gets C = alpha*op(A) + beta*op(B)
+static inline
+void geam(cublasHandle_t handle, cublasOperation_t transA,
+        cublasOperation_t transB, int m, int n, fp32_t alpha,
+        const fp32_t *A, int ldA, fp32_t beta, const fp32_t *B, int ldB,
+        fp32_t *C, int ldC)
+    noexcept
+{
+    cublasSgeam(handle, transA, transB, m, n, &alpha, A, ldA, &beta, B, ldB,
+            C, ldC);
+}
+
+// Overloaded call to cuBLAS GEAM, that gets C = alpha*op(A) + beta*op(B)
+static inline
+void geam(cublasHandle_t handle, cublasOperation_t transA,
+        cublasOperation_t transB, int m, int n, fp64_t alpha,
+        const fp64_t *A, int ldA, fp64_t beta, const fp64_t *B, int ldB,
+        fp64_t *C, int ldC)
+    noexcept
+{
+    cublasDgeam(handle, transA, transB, m, n, &alpha, A, ldA, &beta, B, ldB,
+            C, ldC);
+}
+
+// Pointer to element (i,j) of op(A)
+template<typename T>
+static inline
+const T *sub(cublasOperation_t trans, const T *A, int ld, int i, int j)
+    noexcept
+{
+    if(trans == CUBLAS_OP_N)
+    {
+        return A + i + Index(j)*ld;
+    }
+    return A + j + Index(i)*ld;
+}
+
+// Recursive Strassen-Winograd multiplication C = alpha*op(A)*op(B)+beta*C
+/*! Each level splits matrices into 2-by-2 blocks and gets 7 products of
+ * blocks, 8 additions of blocks of op(A) and op(B) and 6 updates of blocks
+ * of C by cuBLAS GEAM. Additions with op(A) and op(B) transpose blocks on
+ * the fly, so transposed inputs need no extra copy. The last row and column
+ * of odd sizes are peeled off and updated by plain GEMM calls. Data of C
+ * may be uninitialized if beta is zero.
+ * */
+template<typename T>
+static
+void strassen(cublasHandle_t handle, cublasOperation_t transA,
+        cublasOperation_t transB, int m, int n, int k, T alpha, const T *A,
+        int ldA, const T *B, int ldB, T beta, T *C, int ldC, T *work,
+        int nlevels)
+    noexcept
+{
+    int mh = m / 2, nh = n / 2, kh = k / 2;
+    if(nlevels == 0 or mh == 0 or nh == 0 or kh == 0)
+    {
+        gemm(handle, transA, transB, m, n, k, alpha, A, ldA, B, ldB, beta,
+                C, ldC);
+        return;
+    }
+    constexpr T one = 1.0, zero = 0.0;
+    constexpr cublasOperation_t N = CUBLAS_OP_N;
+    // Sums of blocks of op(A) and op(B), two products and workspace of
+    // deeper levels
+    T *X = work, *Y = X + Index(mh)*kh, *W = Y + Index(kh)*nh,
+      *P = W + Index(mh)*nh, *next = P + Index(mh)*nh;
+    // Blocks of op(A), op(B) and C
+    const T *A11 = sub(transA, A, ldA, 0, 0),
+          *A12 = sub(transA, A, ldA, 0, kh),
+          *A21 = sub(transA, A, ldA, mh, 0),
+          *A22 = sub(transA, A, ldA, mh, kh);
+    const T *B11 = sub(transB, B, ldB, 0, 0),
+          *B12 = sub(transB, B, ldB, 0, nh),
+          *B21 = sub(transB, B, ldB, kh, 0),
+          *B22 = sub(transB, B, ldB, kh, nh);
+    T *C11 = C, *C12 = C + Index(nh)*ldC, *C21 = C + mh,
+      *C22 = C + mh + Index(nh)*ldC;
+    // W = A11*B11
+    strassen(handle, transA, transB, mh, nh, kh, one, A11, ldA, B11, ldB,
+            zero, W, mh, next, nlevels-1);
+    // C11 = beta*C11 + alpha*W + alpha*A12*B21
+    geam(handle, N, N, mh, nh, alpha, W, mh, beta, C11, ldC, C11, ldC);
+    strassen(handle, transA, transB, mh, nh, kh, alpha, A12, ldA, B21, ldB,
+            one, C11, ldC, next, nlevels-1);
+    // X = A21+A22, Y = B12-B11, P = X*Y
+    geam(handle, transA, transA, mh, kh, one, A21, ldA, one, A22, ldA, X,
+            mh);
+    geam(handle, transB, transB, kh, nh, one, B12, ldB, -one, B11, ldB, Y,
+            kh);
+    strassen(handle, N, N, mh, nh, kh, one, X, mh, Y, kh, zero, P, mh, next,
+            nlevels-1);
+    // X = X-A11, Y = B22-Y, W = W + X*Y
+    geam(handle, N, transA, mh, kh, one, X, mh, -one, A11, ldA, X, mh);
+    geam(handle, transB, N, kh, nh, one, B22, ldB, -one, Y, kh, Y, kh);
+    strassen(handle, N, N, mh, nh, kh, one, X, mh, Y, kh, one, W, mh, next,
+            nlevels-1);
+    // C12 = beta*C12 + alpha*(W+P), C22 = beta*C22 + alpha*P
+    geam(handle, N, N, mh, nh, alpha, W, mh, beta, C12, ldC, C12, ldC);
+    geam(handle, N, N, mh, nh, alpha, P, mh, one, C12, ldC, C12, ldC);
+    geam(handle, N, N, mh, nh, alpha, P, mh, beta, C22, ldC, C22, ldC);
+    // X = A12-X, C12 = C12 + alpha*X*B22
+    geam(handle, transA, N, mh, kh, one, A12, ldA, -one, X, mh, X, mh);
+    strassen(handle, N, transB, mh, nh, kh, alpha, X, mh, B22, ldB, one, C12,
+            ldC, next, nlevels-1);
+    // Y = Y-B21, C21 = beta*C21 - alpha*A22*Y
+    geam(handle, N, transB, kh, nh, one, Y, kh, -one, B21, ldB, Y, kh);
+    strassen(handle, transA, N, mh, nh, kh, -alpha, A22, ldA, Y, kh, beta,
+            C21, ldC, next, nlevels-1);
+    // X = A11-A21, Y = B22-B12, W = W + X*Y
+    geam(handle, transA, transA, mh, kh, one, A11, ldA, -one, A21, ldA, X,
+            mh);
+    geam(handle, transB, transB, kh, nh, one, B22, ldB, -one, B12, ldB, Y,
+            kh);
+    strassen(handle, N, N, mh, nh, kh, one, X, mh, Y, kh, one, W, mh, next,
+            nlevels-1);
+    // C21 = C21 + alpha*W, C22 = C22 + alpha*W
+    geam(handle, N, N, mh, nh, alpha, W, mh, one, C21, ldC, C21, ldC);
+    geam(handle, N, N, mh, nh, alpha, W, mh, one, C22, ldC, C22, ldC);
+    // Peel off the last column of op(A) and the last row of op(B)
+    if(k > 2*kh)
+    {
+        gemm(handle, transA, transB, 2*mh, 2*nh, 1, alpha,
+                sub(transA, A, ldA, 0, k-1), ldA,
+                sub(transB, B, ldB, k-1, 0), ldB, one, C, ldC);
+    }
+    // Peel off the last row of C
+    if(m > 2*mh)
+    {
+        gemm(handle, transA, transB, 1, n, k, alpha,
+                sub(transA, A, ldA, m-1, 0), ldA, B, ldB, beta, C+m-1, ldC);
+    }
+    // Peel off the last column of C without its last element
+    if(n > 2*nh)
+    {
+        gemm(handle, transA, transB, 2*mh, 1, k, alpha, A, ldA,
+                sub(transB, B, ldB, 0, n-1), ldB, beta, C+Index(n-1)*ldC,
+                ldC);
+    }
+}
+
+//! Strassen-Winograd multiplication of contiguous matrices on CUDA
+/*! Computes C = alpha*op(A)*op(B) + beta*C with nlevels levels of
+ * recursion. Matrices are stored without padding, so leading dimensions are
+ * defined by shapes of op(A), op(B) and C.
+ *
+ * @param[in] handle: cuBLAS handle with a stream already set
+ * @param[in] transA: Transposition flag for the matrix A
+ * @param[in] transB: Transposition flag for the matrix B
+ * @param[in] m: Number of rows of op(A) and C
+ * @param[in] n: Number of columns of op(B) and C
+ * @param[in] k: Number of columns of op(A) and number of rows of op(B)
+ * @param[in] alpha: Alpha multiplier
+ * @param[in] A: Input matrix A
+ * @param[in] B: Input matrix B
+ * @param[in] beta: Beta multiplier
+ * @param[inout] C: Output matrix C
+ * @param[out] work: Workspace of at least workspace_size(m, n, k, nlevels)
+ *      elements
+ * @param[in] nlevels: Maximal number of levels of recursion
+ * */
+template<typename T>
+void cuda(cublasHandle_t handle, TransOp transA, TransOp transB, Index m,
+        Index n, Index k, T alpha, const T *A, const T *B, T beta, T *C,
+        T *work, int nlevels)
+    noexcept
+{
+    // It is OK to convert values as it was checked during task submission
+    int M = m, N = n, K = k, ldA, ldB;
+    cublasOperation_t transA_, transB_;
+    switch(transA.value)
+    {
+        case TransOp::NoTrans:
+            transA_ = CUBLAS_OP_N;
+            ldA = M;
+            break;
+        // This parameter was already checked in gemm_check_opA_opB
+        //case TransOp::Trans:
+        default:
+            transA_ = CUBLAS_OP_T;
+            ldA = K;
+    }
+    switch(transB.value)
+    {
+        case TransOp::NoTrans:
+            transB_ = CUBLAS_OP_N;
+            ldB = K;
+            break;
+        // This parameter was already checked in gemm_check_opA_opB
+        //case TransOp::Trans:
+        default:
+            transB_ = CUBLAS_OP_T;
+            ldB = N;
+    }
+    // alpha and beta parameters are on CPU host
+    cublasSetPointerMode(handle, CUBLAS_POINTER_MODE_HOST);
+    strassen<T>(handle, transA_, transB_, M, N, K, alpha, A, ldA, B, ldB,
+            beta, C, M, work, nlevels);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cublasHandle_t handle, TransOp transA, TransOp transB,
+        Index m, Index n, Index k, fp32_t alpha, const fp32_t *A,
+        const fp32_t *B, fp32_t beta, fp32_t *C, fp32_t *work, int nlevels)
+    noexcept;
+
+template
+void cuda<fp64_t>(cublasHandle_t handle, TransOp transA, TransOp transB,
+        Index m, Index n, Index k, fp64_t alpha, const fp64_t *A,
+        const fp64_t *B, fp64_t beta, fp64_t *C, fp64_t *work, int nlevels)
+    noexcept;
+
+} // namespace strassen
+} // namespace kernel
+} // namespace nntile
+
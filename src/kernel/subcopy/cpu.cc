@@ -10,10 +10,11 @@
  * @version 1.0.0
  * @author Aleksandr Mikhalev
  * @author Aleksandr Katrutsa
- * @date 2023-09-01
+ * @date 2024-02-15
  * */
 
 #include "nntile/kernel/subcopy/cpu.hh"
+#include <cstring>
 
 namespace nntile
 {
@@ -28,11 +29,14 @@ void cpu(Index ndim, const Index *src_start, const Index *src_stride,
         const Index *dst_stride, T *dst, Index *tmp_index)
     noexcept
 //! Complex copying of one multidimensional array into another
-/*! This function is not meant for a performant implementation, as its sole
- * purpose is an easy data redistribution. It helps, for example, in case of
- * converting between a single contiguous array on a single node (e.g., a
- * Python numpy or torch array) and a distributed allocation on many nodes
- * (e.g., nntile data distribution).
+/*! It helps, for example, in case of converting between a single contiguous
+ * array on a single node (e.g., a Python numpy or torch array) and a
+ * distributed allocation on many nodes (e.g., nntile data distribution), or
+ * between different tilings of the same tensor.
+ * Leading dimensions, that are contiguous both in the source and in the
+ * destination, are merged into a single row, and rows are copied with
+ * std::memcpy. Therefore, a copy of a contiguous chunk costs a single
+ * memcpy and a copy of a strided block costs one memcpy per column.
  * A simple memory copy shall be treated with a help of starpu_data_cpy()
  * function.
  *
@@ -51,59 +55,57 @@ void cpu(Index ndim, const Index *src_start, const Index *src_stride,
  *      values.
  * */
 {
-    // Map temporary buffer into source index and destination index
-    Index *src_index = tmp_index;
-    Index *dst_index = tmp_index + ndim;
-    // Get number of elements to copy and init source and target indexes for
-    // the first element to copy
+    // Get number of elements to copy and offsets of the first element
     Index nelems = 1;
+    Index src_offset = 0, dst_offset = 0;
     for(Index i = 0; i < ndim; ++i)
     {
         nelems *= copy_shape[i];
-        src_index[i] = src_start[i];
-        dst_index[i] = dst_start[i];
-    }
-    // Get offsets for both source and target elements
-    Index src_offset = src_start[0]; // src_stride[0] = 1
-    Index dst_offset = dst_start[0]; // src_stride[0] = 1
-    for(Index i = 1; i < ndim; ++i)
-    {
         src_offset += src_start[i] * src_stride[i];
         dst_offset += dst_start[i] * dst_stride[i];
     }
-    // Copy source into destination
-    dst[dst_offset] = src[src_offset];
-    // Get source and target offsets for the next element to copy
-    ++src_offset;
-    ++dst_offset;
-    for(Index i = 1; i < nelems; ++i)
+    if(nelems == 0)
     {
-        // Update indexes of source and target positions
-        ++src_index[0];
-        ++dst_index[0];
-        // Get index and offset of the next source
-        Index j = 0;
-        while(src_index[j] == src_start[j]+copy_shape[j])
+        return;
+    }
+    // Merge leading dimensions, that are contiguous in both arrays, into a
+    // single row of elements
+    Index row = 1, dim = 0;
+    while(dim < ndim and src_stride[dim] == row and dst_stride[dim] == row)
+    {
+        row *= copy_shape[dim];
+        ++dim;
+    }
+    // Index of the current row within the copied area
+    Index *index = tmp_index;
+    for(Index i = dim; i < ndim; ++i)
+    {
+        index[i] = 0;
+    }
+    Index nrows = nelems / row;
+    for(Index i = 0; i < nrows; ++i)
+    {
+        // Copy source row into destination
+        std::memcpy(dst+dst_offset, src+src_offset, row*sizeof(T));
+        if(i == nrows-1)
         {
-            src_index[j] = src_start[j];
-            ++j;
-            ++src_index[j];
-            src_offset += src_stride[j] - copy_shape[j-1]*src_stride[j-1];
+            break;
         }
-        // Get index and offset of the next target
-        j = 0;
-        while(dst_index[j] == dst_start[j]+copy_shape[j])
+        // Get index and offsets of the next row
+        Index j = dim;
+        ++index[j];
+        src_offset += src_stride[j];
+        dst_offset += dst_stride[j];
+        while(index[j] == copy_shape[j])
         {
-            dst_index[j] = dst_start[j];
+            src_offset -= copy_shape[j] * src_stride[j];
+            dst_offset -= copy_shape[j] * dst_stride[j];
+            index[j] = 0;
             ++j;
-            ++dst_index[j];
-            dst_offset += dst_stride[j] - copy_shape[j-1]*dst_stride[j-1];
+            ++index[j];
+            src_offset += src_stride[j];
+            dst_offset += dst_stride[j];
         }
-        // Copy source into destination
-        dst[dst_offset] = src[src_offset];
-        // Update offsets for the next copy
-        ++src_offset;
-        ++dst_offset;
     }
 }
 
@@ -114,6 +116,12 @@ void cpu<fp16_t>(Index ndim, const Index *src_start, const Index *src_stride,
         const Index *dst_stride, fp16_t *dst, Index *tmp_index)
     noexcept;
 
+template
+void cpu<bf16_t>(Index ndim, const Index *src_start, const Index *src_stride,
+        const Index *copy_shape, const bf16_t *src, const Index *dst_start,
+        const Index *dst_stride, bf16_t *dst, Index *tmp_index)
+    noexcept;
+
 template
 void cpu<fp32_t>(Index ndim, const Index *src_start, const Index *src_stride,
         const Index *copy_shape, const fp32_t *src, const Index *dst_start,
@@ -138,6 +146,20 @@ void cpu<bool_t>(Index ndim, const Index *src_start, const Index *src_stride,
         const Index *dst_stride, bool_t *dst, Index *tmp_index)
     noexcept;
 
+template
+void cpu<std::int8_t>(Index ndim, const Index *src_start,
+        const Index *src_stride, const Index *copy_shape,
+        const std::int8_t *src, const Index *dst_start,
+        const Index *dst_stride, std::int8_t *dst, Index *tmp_index)
+    noexcept;
+
+template
+void cpu<fp8_e4m3_t>(Index ndim, const Index *src_start,
+        const Index *src_stride, const Index *copy_shape,
+        const fp8_e4m3_t *src, const Index *dst_start, const Index *dst_stride,
+        fp8_e4m3_t *dst, Index *tmp_index)
+    noexcept;
+
 } // namespace subcopy
 } // namespace kernel
 } // namespace nntile
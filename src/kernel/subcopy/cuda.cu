@@ -0,0 +1,242 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/subcopy/cuda.cu
+ * Copy subarray based on contiguous indices on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/subcopy/cuda.hh"
+#include <cstdint>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace subcopy
+{
+
+//! Maximal number of dimensions, handled by a single launch of cuda_kernel
+constexpr Index max_ndim = 16;
+
+//! Shape and strides of a copy, passed to cuda_kernel by value
+struct layout_t
+{
+    Index ndim;
+    Index shape[max_ndim];
+    Index src_stride[max_ndim];
+    Index dst_stride[max_ndim];
+};
+
+// Each thread copies a single element, elements are copied as raw words
+template<typename W>
+static __global__
+void cuda_kernel(Index nelems, layout_t layout, const W *src, W *dst)
+{
+    Index i = threadIdx.x + Index(blockIdx.x)*blockDim.x;
+    if(i < nelems)
+    {
+        Index src_offset = 0, dst_offset = 0;
+        for(Index j = 0; j < layout.ndim; ++j)
+        {
+            Index k = i % layout.shape[j];
+            i /= layout.shape[j];
+            src_offset += k * layout.src_stride[j];
+            dst_offset += k * layout.dst_stride[j];
+        }
+        dst[dst_offset] = src[src_offset];
+    }
+}
+
+//! Unsigned integer of a given size to copy elements as raw words
+template<std::size_t Size>
+struct word;
+
+template<>
+struct word<1>
+{
+    using type = std::uint8_t;
+};
+
+template<>
+struct word<2>
+{
+    using type = std::uint16_t;
+};
+
+template<>
+struct word<4>
+{
+    using type = std::uint32_t;
+};
+
+template<>
+struct word<8>
+{
+    using type = std::uint64_t;
+};
+
+template<typename T>
+void cuda(cudaStream_t stream, Index ndim, const Index *src_start,
+        const Index *src_stride, const Index *copy_shape, const T *src,
+        const Index *dst_start, const Index *dst_stride, T *dst)
+    noexcept
+//! Complex copying of one multidimensional array into another on CUDA
+/*! Leading dimensions, that are contiguous both in the source and in the
+ * destination, are merged into a single row. A single row is copied by
+ * cudaMemcpyAsync and rows with a single outer dimension are copied by
+ * cudaMemcpy2DAsync, so that the most common copies between tilings of
+ * matrices run at memory bandwidth. Other copies are done by a kernel, that
+ * handles up to max_ndim dimensions per launch, while the remaining outer
+ * dimensions are looped over on host. All the arrays of indices are in host
+ * memory.
+ *
+ * @param[in] stream: CUDA stream
+ * @param[in] ndim: Dimensionality of underlying arrays
+ * @param[in] src_start: Start element to copy from source array. Contains ndim
+ *      values.
+ * @param[in] src_stride: Strides of the source array. Contains ndim values.
+ * @param[in] copy_shape: Shape of array to copy. Contains ndim values.
+ * @param[in] src: Pointer to input data in device memory
+ * @param[in] dst_start: Start element to copy to destination array. Contains
+ *      ndim values.
+ * @param[in] dst_stride: Strides of the destination array. Contains ndim
+ *      values.
+ * @param[inout] dst: Pointer to output data in device memory
+ * */
+{
+    // Get number of elements to copy and offsets of the first element
+    Index nelems = 1;
+    Index src_offset = 0, dst_offset = 0;
+    for(Index i = 0; i < ndim; ++i)
+    {
+        nelems *= copy_shape[i];
+        src_offset += src_start[i] * src_stride[i];
+        dst_offset += dst_start[i] * dst_stride[i];
+    }
+    if(nelems == 0)
+    {
+        return;
+    }
+    src += src_offset;
+    dst += dst_offset;
+    // Merge leading dimensions, that are contiguous in both arrays, into a
+    // single row of elements
+    Index row = 1, dim = 0;
+    while(dim < ndim and src_stride[dim] == row and dst_stride[dim] == row)
+    {
+        row *= copy_shape[dim];
+        ++dim;
+    }
+    // Single contiguous row
+    if(dim == ndim)
+    {
+        cudaMemcpyAsync(dst, src, row*sizeof(T), cudaMemcpyDeviceToDevice,
+                stream);
+        return;
+    }
+    // Rows with a single outer dimension
+    if(dim == ndim-1)
+    {
+        cudaMemcpy2DAsync(dst, dst_stride[dim]*sizeof(T), src,
+                src_stride[dim]*sizeof(T), row*sizeof(T), copy_shape[dim],
+                cudaMemcpyDeviceToDevice, stream);
+        return;
+    }
+    // Generic case. Merged row goes as the first dimension of the layout.
+    layout_t layout;
+    layout.shape[0] = row;
+    layout.src_stride[0] = 1;
+    layout.dst_stride[0] = 1;
+    layout.ndim = 1;
+    Index launch_nelems = row;
+    while(dim < ndim and layout.ndim < max_ndim)
+    {
+        layout.shape[layout.ndim] = copy_shape[dim];
+        layout.src_stride[layout.ndim] = src_stride[dim];
+        layout.dst_stride[layout.ndim] = dst_stride[dim];
+        launch_nelems *= copy_shape[dim];
+        ++layout.ndim;
+        ++dim;
+    }
+    using W = typename word<sizeof(T)>::type;
+    dim3 blocks((launch_nelems+255)/256), threads(256);
+    // Remaining outer dimensions are looped over on host
+    Index nlaunches = nelems / launch_nelems;
+    for(Index i = 0; i < nlaunches; ++i)
+    {
+        Index k = i, launch_src_offset = 0, launch_dst_offset = 0;
+        for(Index j = dim; j < ndim; ++j)
+        {
+            launch_src_offset += (k % copy_shape[j]) * src_stride[j];
+            launch_dst_offset += (k % copy_shape[j]) * dst_stride[j];
+            k /= copy_shape[j];
+        }
+        (cuda_kernel<W>)<<<blocks, threads, 0, stream>>>(launch_nelems,
+                layout,
+                reinterpret_cast<const W *>(src+launch_src_offset),
+                reinterpret_cast<W *>(dst+launch_dst_offset));
+    }
+}
+
+// Explicit instantiation
+template
+void cuda<fp16_t>(cudaStream_t stream, Index ndim, const Index *src_start,
+        const Index *src_stride, const Index *copy_shape, const fp16_t *src,
+        const Index *dst_start, const Index *dst_stride, fp16_t *dst)
+    noexcept;
+
+template
+void cuda<bf16_t>(cudaStream_t stream, Index ndim, const Index *src_start,
+        const Index *src_stride, const Index *copy_shape, const bf16_t *src,
+        const Index *dst_start, const Index *dst_stride, bf16_t *dst)
+    noexcept;
+
+template
+void cuda<fp32_t>(cudaStream_t stream, Index ndim, const Index *src_start,
+        const Index *src_stride, const Index *copy_shape, const fp32_t *src,
+        const Index *dst_start, const Index *dst_stride, fp32_t *dst)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index ndim, const Index *src_start,
+        const Index *src_stride, const Index *copy_shape, const fp64_t *src,
+        const Index *dst_start, const Index *dst_stride, fp64_t *dst)
+    noexcept;
+
+template
+void cuda<Index>(cudaStream_t stream, Index ndim, const Index *src_start,
+        const Index *src_stride, const Index *copy_shape, const Index *src,
+        const Index *dst_start, const Index *dst_stride, Index *dst)
+    noexcept;
+
+template
+void cuda<bool_t>(cudaStream_t stream, Index ndim, const Index *src_start,
+        const Index *src_stride, const Index *copy_shape, const bool_t *src,
+        const Index *dst_start, const Index *dst_stride, bool_t *dst)
+    noexcept;
+
+template
+void cuda<std::int8_t>(cudaStream_t stream, Index ndim,
+        const Index *src_start, const Index *src_stride,
+        const Index *copy_shape, const std::int8_t *src,
+        const Index *dst_start, const Index *dst_stride, std::int8_t *dst)
+    noexcept;
+
+template
+void cuda<fp8_e4m3_t>(cudaStream_t stream, Index ndim,
+        const Index *src_start, const Index *src_stride,
+        const Index *copy_shape, const fp8_e4m3_t *src,
+        const Index *dst_start, const Index *dst_stride, fp8_e4m3_t *dst)
+    noexcept;
+
+} // namespace subcopy
+} // namespace kernel
+} // namespace nntile
+
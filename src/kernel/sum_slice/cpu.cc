@@ -42,8 +42,9 @@ void cpu(Index m, Index n, Index k, T alpha, const T *src, T beta, T *dst)
  *      sums over fibers along middle axis
  * */
 {
+    using Y = compute_t<T>;
     const Index mk = m * k;
-    constexpr T zero = 0;
+    constexpr Y zero = 0;
     // Cycle over column of the output buffer dst
     for(Index i2 = 0; i2 < n; ++i2)
     {
@@ -53,7 +54,7 @@ void cpu(Index m, Index n, Index k, T alpha, const T *src, T beta, T *dst)
             // Pointer to a corresponding fiber of the source array src
             const T *src_fiber = src + i2*mk + i1;
             // Init sum over the fiber
-            T sum = zero, c = zero, y, t;
+            Y sum = zero, c = zero, y, t;
             // Output value
             T &result = dst[i2*m+i1];
             // Cycle over fiber elements and accumulate the sum
@@ -89,6 +90,16 @@ void cpu<fp64_t>(Index m, Index n, Index k, fp64_t alpha, const fp64_t *src,
         fp64_t beta, fp64_t *dst)
     noexcept;
 
+template
+void cpu<bf16_t>(Index m, Index n, Index k, bf16_t alpha, const bf16_t *src,
+        bf16_t beta, bf16_t *dst)
+    noexcept;
+
+template
+void cpu<fp16_t>(Index m, Index n, Index k, fp16_t alpha, const fp16_t *src,
+        fp16_t beta, fp16_t *dst)
+    noexcept;
+
 } // namespace sum_slice
 } // namespace kernel
 } // namespace nntile
@@ -31,19 +31,20 @@ void cuda_kernel(Index m, Index n, Index k, Index mk, T alpha, const T *src,
     Index i0 = threadIdx.x + blockIdx.x*blockDim.x,
           i1 = threadIdx.y + blockIdx.y*blockDim.y;
     Index i2_start = threadIdx.z, i2_step = blockDim.z;
-    constexpr T zero = 0;
+    using Y = compute_t<T>;
+    constexpr Y zero = 0;
     if(i0 < m and i1 < n)
     {
         // Pointer to a corresponding fiber of the source array src
         const T *src_fiber = src + i1*mk + i0;
         // Init sum over the fiber
-        T sum = zero;
+        Y sum = zero;
         // Cycle over fiber elements and accumulate the sum
         for(Index i2 = i2_start; i2 < k; i2 += i2_step)
         {
             sum += src_fiber[i2*m];
         }
-        __shared__ T block_sum[64];
+        __shared__ Y block_sum[64];
         if(i2_start == 0)
         {
             block_sum[threadIdx.x+blockDim.x*threadIdx.y] = zero;
@@ -69,6 +70,152 @@ void cuda_kernel(Index m, Index n, Index k, Index mk, T alpha, const T *src,
     }
 }
 
+//! Sums over strided fibers (m>=32) with coalesced loads
+/*! A block of threads is a 32-by-BLOCK_K tile, whose rows are 32 consecutive
+ * fibers and whose columns stride over the middle axis. Consecutive threads
+ * of a warp read consecutive elements of memory, while the generic kernel
+ * reads only 8 consecutive elements per warp. Partial sums are reduced over
+ * columns in the shared memory.
+ * */
+template<typename T, int BLOCK_K>
+static __global__
+void cuda_kernel_coalesced(Index m, Index n, Index k, T alpha, const T *src,
+        T beta, T *dst)
+{
+    using Y = compute_t<T>;
+    constexpr Y zero = 0;
+    __shared__ Y block_sum[BLOCK_K][32];
+    Index i0 = threadIdx.x + blockIdx.x*32;
+    for(Index i1 = blockIdx.y; i1 < n; i1 += gridDim.y)
+    {
+        // Cycle over fiber elements and accumulate the sum
+        Y sum = zero;
+        if(i0 < m)
+        {
+            const T *src_fiber = src + i1*m*k + i0;
+            for(Index i2 = threadIdx.y; i2 < k; i2 += BLOCK_K)
+            {
+                sum += static_cast<Y>(src_fiber[i2*m]);
+            }
+        }
+        // Reduce over columns of the block
+        block_sum[threadIdx.y][threadIdx.x] = sum;
+        __syncthreads();
+#pragma unroll
+        for(int s = BLOCK_K/2; s > 0; s /= 2)
+        {
+            if(threadIdx.y < s)
+            {
+                block_sum[threadIdx.y][threadIdx.x] +=
+                    block_sum[threadIdx.y+s][threadIdx.x];
+            }
+            __syncthreads();
+        }
+        // Update output value
+        if(threadIdx.y == 0 and i0 < m)
+        {
+            T &result = dst[i1*m+i0];
+            sum = block_sum[0][threadIdx.x];
+            if(beta == zero)
+            {
+                result = alpha * sum;
+            }
+            else
+            {
+                result = beta*result + alpha*sum;
+            }
+        }
+    }
+}
+
+//! Sums over contiguous fibers (m=1) by a block of BLOCK threads per fiber
+/*! The block size is a template parameter, so the loop over the fiber has a
+ * constant stride and reductions over warps are unrolled by the compiler.
+ * Loads of a warp are coalesced, as the fiber is contiguous.
+ * */
+template<typename T, int BLOCK>
+static __global__
+void cuda_kernel_m1(Index n, Index k, T alpha, const T *src, T beta, T *dst)
+{
+    using Y = compute_t<T>;
+    constexpr Y zero = 0;
+    constexpr int NWARPS = BLOCK / 32;
+    __shared__ Y warp_sum[NWARPS];
+    for(Index i1 = blockIdx.x; i1 < n; i1 += gridDim.x)
+    {
+        // Pointer to a corresponding fiber of the source array src
+        const T *src_fiber = src + i1*k;
+        // Cycle over fiber elements and accumulate the sum
+        Y sum = zero;
+#pragma unroll 4
+        for(Index i2 = threadIdx.x; i2 < k; i2 += BLOCK)
+        {
+            sum += static_cast<Y>(src_fiber[i2]);
+        }
+        // Reduce within a warp
+#pragma unroll
+        for(int offset = 16; offset > 0; offset /= 2)
+        {
+            sum += __shfl_down_sync(0xffffffff, sum, offset);
+        }
+        // Reduce over warps
+        if constexpr (NWARPS > 1)
+        {
+            if(threadIdx.x % 32 == 0)
+            {
+                warp_sum[threadIdx.x/32] = sum;
+            }
+            __syncthreads();
+            if(threadIdx.x < 32)
+            {
+                sum = (threadIdx.x < NWARPS) ? warp_sum[threadIdx.x] : zero;
+#pragma unroll
+                for(int offset = NWARPS/2; offset > 0; offset /= 2)
+                {
+                    sum += __shfl_down_sync(0xffffffff, sum, offset);
+                }
+            }
+            // Shared memory is reused by the next fiber
+            __syncthreads();
+        }
+        // Update output value
+        if(threadIdx.x == 0)
+        {
+            T &result = dst[i1];
+            if(beta == zero)
+            {
+                result = alpha * sum;
+            }
+            else
+            {
+                result = beta*result + alpha*sum;
+            }
+        }
+    }
+}
+
+//! Launch a variant of kernel, specialized by the block size
+template<typename T, int BLOCK>
+static void launch_m1(cudaStream_t stream, Index n, Index k, T alpha,
+        const T *src, T beta, T *dst)
+{
+    dim3 threads(BLOCK);
+    dim3 blocks(std::min(n, Index(65535)));
+    (cuda_kernel_m1<T, BLOCK>)<<<blocks, threads, 0, stream>>>(n, k, alpha,
+            src, beta, dst);
+}
+
+//! Launch a coalesced variant of kernel, specialized by the block size
+template<typename T, int BLOCK_K>
+static void launch_coalesced(cudaStream_t stream, Index m, Index n, Index k,
+        T alpha, const T *src, T beta, T *dst)
+{
+    dim3 threads(32, BLOCK_K);
+    dim3 blocks((m+31)/32, std::min(n, Index(65535)));
+    (cuda_kernel_coalesced<T, BLOCK_K>)<<<blocks, threads, 0, stream>>>(m, n,
+            k, alpha, src, beta, dst);
+}
+
 template<typename T>
 void cuda(cudaStream_t stream, Index m, Index n, Index k, T alpha,
         const T *src, T beta, T *dst)
@@ -89,6 +236,38 @@ void cuda(cudaStream_t stream, Index m, Index n, Index k, T alpha,
  *      sums over fibers along middle axis.
  * */
 {
+    // Long contiguous fibers are reduced by variants, specialized on the
+    // block size, which is chosen by the length of fibers
+    if(m == 1 and k >= 32 and n > 0)
+    {
+        if(k >= 2048)
+        {
+            launch_m1<T, 256>(stream, n, k, alpha, src, beta, dst);
+        }
+        else if(k >= 256)
+        {
+            launch_m1<T, 128>(stream, n, k, alpha, src, beta, dst);
+        }
+        else
+        {
+            launch_m1<T, 32>(stream, n, k, alpha, src, beta, dst);
+        }
+        return;
+    }
+    // Wide slices are reduced with coalesced loads, while the number of
+    // threads along the middle axis is chosen by its size
+    if(m >= 32 and n > 0)
+    {
+        if(k >= 64)
+        {
+            launch_coalesced<T, 8>(stream, m, n, k, alpha, src, beta, dst);
+        }
+        else
+        {
+            launch_coalesced<T, 2>(stream, m, n, k, alpha, src, beta, dst);
+        }
+        return;
+    }
     // Both source and destination are Fortran-contiguous
     dim3 threads(std::min(int(m), 8), std::min(int(n), 8),
             std::min(int(k), 16));
@@ -108,6 +287,16 @@ void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k, fp64_t alpha,
         const fp64_t *src, fp64_t beta, fp64_t *dst)
     noexcept;
 
+template
+void cuda<bf16_t>(cudaStream_t stream, Index m, Index n, Index k, bf16_t alpha,
+        const bf16_t *src, bf16_t beta, bf16_t *dst)
+    noexcept;
+
+template
+void cuda<fp16_t>(cudaStream_t stream, Index m, Index n, Index k, fp16_t alpha,
+        const fp16_t *src, fp16_t beta, fp16_t *dst)
+    noexcept;
+
 } // namespace sum_slice
 } // namespace kernel
 } // namespace nntile
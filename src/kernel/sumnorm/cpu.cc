@@ -22,6 +22,104 @@ namespace kernel
 namespace sumnorm
 {
 
+//! Update of scaled sum of squares by a single value
+template<typename T>
+static inline void update(T val, T &sum, T &scale, T &ssq)
+{
+    constexpr T zero = 0, one = 1;
+    // Nothing to update in case of 0
+    if(val == zero)
+    {
+        return;
+    }
+    // Update sum, scale and scaled sum of squares
+    sum += val;
+    T absval = std::fabs(val);
+    if(absval > scale)
+    {
+        T tmp = scale / absval;
+        scale = absval;
+        ssq = ssq*tmp*tmp + one;
+    }
+    else
+    {
+        T tmp = absval / scale;
+        ssq += tmp*tmp;
+    }
+}
+
+//! Sum and norm along middle axis with a compile-time first mode
+/*! If M is non-zero, it is the size of the first mode. Then accumulators of
+ * all M slices are kept in local arrays and the source is traversed
+ * contiguously, with the innermost loop of M iterations known to the
+ * compiler. Each slice is accumulated in the same order as in the generic
+ * case (M is zero), so both give the same result.
+ * */
+template<Index M, typename T>
+static void cpu_m(Index m, Index n, Index k, const T *src, T *sumnorm)
+    noexcept
+{
+    constexpr T one = 1;
+    if constexpr (M == 0)
+    {
+        const Index mk = m * k;
+        Index dst_offset = 0;
+        // Cycle over row of output buffer
+        for(Index i2 = 0; i2 < n; ++i2)
+        {
+            // Cycle over column of output buffer
+            for(Index i1 = 0; i1 < m; ++i1)
+            {
+                // Get sum and norm of a corresponding slice
+                const T *src_slice = src + i2*mk + i1;
+                // Init sum and norm
+                // Norm is computed with help of scaled sum of squares
+                T sum = sumnorm[dst_offset];
+                T scale = sumnorm[dst_offset+1];
+                T ssq = one;
+                // Cycle over slice of input buffer
+                for(Index i0 = 0; i0 < k; ++i0)
+                {
+                    update<T>(src_slice[i0*m], sum, scale, ssq);
+                }
+                // Save result. Due to roundings an average value may become
+                // larger than a root-mean-square value, which is impossible
+                // for precise numbers
+                sumnorm[dst_offset] = sum;
+                sumnorm[dst_offset+1] = scale * std::sqrt(ssq);
+                dst_offset += 2;
+            }
+        }
+    }
+    else
+    {
+        for(Index i2 = 0; i2 < n; ++i2)
+        {
+            T *dst = sumnorm + 2*i2*M;
+            T sum[M], scale[M], ssq[M];
+            for(Index i1 = 0; i1 < M; ++i1)
+            {
+                sum[i1] = dst[2*i1];
+                scale[i1] = dst[2*i1+1];
+                ssq[i1] = one;
+            }
+            for(Index i0 = 0; i0 < k; ++i0)
+            {
+                const T *src_fiber = src + (i2*k+i0)*M;
+                for(Index i1 = 0; i1 < M; ++i1)
+                {
+                    update<T>(src_fiber[i1], sum[i1], scale[i1], ssq[i1]);
+                }
+            }
+            for(Index i1 = 0; i1 < M; ++i1)
+            {
+                dst[2*i1] = sum[i1];
+                dst[2*i1+1] = scale[i1] * std::sqrt(ssq[i1]);
+            }
+        }
+    }
+}
+
 template<typename T>
 void cpu(Index m, Index n, Index k, const T *src, T *sumnorm)
     noexcept
@@ -46,56 +144,26 @@ void cpu(Index m, Index n, Index k, const T *src, T *sumnorm)
  * @param[in] src: Input contiguous m-by-k-by-n array
  * @param[inout] sumnorm: Output contiguous 2-by-m-by-n array, that accumulates
  *      sums and norms of slices along middle axis.
+ *
+ * Common sizes of the first mode are dispatched to specialized loops.
  * */
 {
-    const Index mk = m * k;
-    Index dst_offset = 0;
-    constexpr T zero = 0, one = 1;
-    // Cycle over row of output buffer
-    for(Index i2 = 0; i2 < n; ++i2)
+    switch(m)
     {
-        // Cycle over column of output buffer
-        for(Index i1 = 0; i1 < m; ++i1)
-        {
-            // Get sum and norm of a corresponding slice
-            const T *src_slice = src + i2*mk + i1;
-            // Init sum and norm
-            // Norm is computed with help of scaled sum of squares
-            T sum = sumnorm[dst_offset];
-            T scale = sumnorm[dst_offset+1];
-            T ssq = one;
-            // Cycle over slice of input buffer
-            for(Index i0 = 0; i0 < k; ++i0)
-            {
-                // Read value from source
-                T val = src_slice[i0*m];
-                // Nothing to update in case of 0
-                if(val == zero)
-                {
-                    continue;
-                }
-                // Update sum, scale and scaled sum of squares
-                sum += val;
-                T absval = std::fabs(val);
-                if(absval > scale)
-                {
-                    T tmp = scale / absval;
-                    scale = absval;
-                    ssq = ssq*tmp*tmp + one;
-                }
-                else
-                {
-                    T tmp = absval / scale;
-                    ssq += tmp*tmp;
-                }
-            }
-            // Save result. Due to roundings an average value may become larger
-            // than a root-mean-square value, which is impossible for precise
-            // numbers
-            sumnorm[dst_offset] = sum;
-            sumnorm[dst_offset+1] = scale * std::sqrt(ssq);
-            dst_offset += 2;
-        }
+        case 16:
+            cpu_m<16, T>(m, n, k, src, sumnorm);
+            break;
+        case 32:
+            cpu_m<32, T>(m, n, k, src, sumnorm);
+            break;
+        case 64:
+            cpu_m<64, T>(m, n, k, src, sumnorm);
+            break;
+        case 128:
+            cpu_m<128, T>(m, n, k, src, sumnorm);
+            break;
+        default:
+            cpu_m<0, T>(m, n, k, src, sumnorm);
     }
 }
 
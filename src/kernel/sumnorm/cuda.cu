@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/sumnorm/cuda.hh"
+#include <algorithm>
 
 namespace nntile
 {
@@ -77,6 +78,174 @@ void cuda_kernel(Index m, Index n, Index k, Index mk, const T *src,
     }
 }
 
+template<typename T>
+static __device__
+void update_slice(T val, T &sum, T &scale, T &ssq)
+//! Update sum, scale and scaled sum of squares by a single value
+{
+    constexpr T zero = 0, one = 1;
+    // Nothing to update in case of 0
+    if(val == zero)
+    {
+        return;
+    }
+    sum += val;
+    T absval = ::fabs(val);
+    if(absval > scale)
+    {
+        T tmp = scale / absval;
+        scale = absval;
+        ssq = ssq*tmp*tmp + one;
+    }
+    else
+    {
+        T tmp = absval / scale;
+        ssq += tmp*tmp;
+    }
+}
+
+template<typename T>
+static __device__
+void update_output(T sum, T norm, T *sumnorm)
+//! Accumulate sum and norm of a slice into the output
+{
+    sumnorm[0] += sum;
+    sumnorm[1] = ::hypot(sumnorm[1], norm);
+}
+
+//! Sums and norms of contiguous slices (m=1) by a block per slice
+/*! Threads of a block stride over a slice with coalesced loads. Partial sums
+ * are reduced by warp shuffles, while partial norms are combined by hypot,
+ * which avoids overflow and underflow.
+ * */
+template<typename T, int BLOCK>
+static __global__
+void cuda_kernel_m1(Index n, Index k, const T *src, T *sumnorm)
+{
+    constexpr T zero = 0, one = 1;
+    constexpr int NWARPS = BLOCK / 32;
+    __shared__ T warp_sum[NWARPS], warp_norm[NWARPS];
+    for(Index i2 = blockIdx.x; i2 < n; i2 += gridDim.x)
+    {
+        // Cycle over slice of input buffer
+        const T *src_slice = src + i2*k;
+        T sum = zero, scale = zero, ssq = one;
+        for(Index i0 = threadIdx.x; i0 < k; i0 += BLOCK)
+        {
+            update_slice(src_slice[i0], sum, scale, ssq);
+        }
+        T norm = scale * ::sqrt(ssq);
+        // Reduce within a warp
+#pragma unroll
+        for(int offset = 16; offset > 0; offset /= 2)
+        {
+            sum += __shfl_down_sync(0xffffffff, sum, offset);
+            norm = ::hypot(norm, __shfl_down_sync(0xffffffff, norm, offset));
+        }
+        // Reduce over warps
+        if constexpr (NWARPS > 1)
+        {
+            if(threadIdx.x % 32 == 0)
+            {
+                warp_sum[threadIdx.x/32] = sum;
+                warp_norm[threadIdx.x/32] = norm;
+            }
+            __syncthreads();
+            if(threadIdx.x < 32)
+            {
+                sum = (threadIdx.x < NWARPS) ? warp_sum[threadIdx.x] : zero;
+                norm = (threadIdx.x < NWARPS) ? warp_norm[threadIdx.x] : zero;
+#pragma unroll
+                for(int offset = NWARPS/2; offset > 0; offset /= 2)
+                {
+                    sum += __shfl_down_sync(0xffffffff, sum, offset);
+                    norm = ::hypot(norm,
+                            __shfl_down_sync(0xffffffff, norm, offset));
+                }
+            }
+            // Shared memory is reused by the next slice
+            __syncthreads();
+        }
+        if(threadIdx.x == 0)
+        {
+            update_output(sum, norm, sumnorm+2*i2);
+        }
+    }
+}
+
+//! Sums and norms of strided slices (m>=32) with coalesced loads
+/*! A block of threads is a 32-by-BLOCK_K tile, whose rows are 32 consecutive
+ * slices and whose columns stride over the middle axis, so that lanes of a
+ * warp read consecutive elements of memory. Partial results are reduced over
+ * columns in the shared memory.
+ * */
+template<typename T, int BLOCK_K>
+static __global__
+void cuda_kernel_coalesced(Index m, Index n, Index k, const T *src,
+        T *sumnorm)
+{
+    constexpr T zero = 0, one = 1;
+    __shared__ T block_sum[BLOCK_K][32], block_norm[BLOCK_K][32];
+    Index i1 = threadIdx.x + blockIdx.x*32;
+    for(Index i2 = blockIdx.y; i2 < n; i2 += gridDim.y)
+    {
+        // Cycle over slice of input buffer
+        T sum = zero, scale = zero, ssq = one;
+        if(i1 < m)
+        {
+            const T *src_slice = src + i2*m*k + i1;
+            for(Index i0 = threadIdx.y; i0 < k; i0 += BLOCK_K)
+            {
+                update_slice(src_slice[i0*m], sum, scale, ssq);
+            }
+        }
+        // Reduce over columns of the block
+        block_sum[threadIdx.y][threadIdx.x] = sum;
+        block_norm[threadIdx.y][threadIdx.x] = scale * ::sqrt(ssq);
+        __syncthreads();
+#pragma unroll
+        for(int s = BLOCK_K/2; s > 0; s /= 2)
+        {
+            if(threadIdx.y < s)
+            {
+                block_sum[threadIdx.y][threadIdx.x] +=
+                    block_sum[threadIdx.y+s][threadIdx.x];
+                block_norm[threadIdx.y][threadIdx.x] = ::hypot(
+                        block_norm[threadIdx.y][threadIdx.x],
+                        block_norm[threadIdx.y+s][threadIdx.x]);
+            }
+            __syncthreads();
+        }
+        if(threadIdx.y == 0 and i1 < m)
+        {
+            update_output(block_sum[0][threadIdx.x],
+                    block_norm[0][threadIdx.x], sumnorm+2*(i1+i2*m));
+        }
+    }
+}
+
+//! Launch a variant of kernel, specialized by the block size
+template<typename T, int BLOCK>
+static void launch_m1(cudaStream_t stream, Index n, Index k, const T *src,
+        T *sumnorm)
+{
+    dim3 threads(BLOCK);
+    dim3 blocks(std::min(n, Index(65535)));
+    (cuda_kernel_m1<T, BLOCK>)<<<blocks, threads, 0, stream>>>(n, k, src,
+            sumnorm);
+}
+
+//! Launch a coalesced variant of kernel, specialized by the block size
+template<typename T, int BLOCK_K>
+static void launch_coalesced(cudaStream_t stream, Index m, Index n, Index k,
+        const T *src, T *sumnorm)
+{
+    dim3 threads(32, BLOCK_K);
+    dim3 blocks((m+31)/32, std::min(n, Index(65535)));
+    (cuda_kernel_coalesced<T, BLOCK_K>)<<<blocks, threads, 0, stream>>>(m, n,
+            k, src, sumnorm);
+}
+
 template<typename T>
 void cuda(cudaStream_t stream, Index m, Index n, Index k, const T *src,
         T *sumnorm)
@@ -104,6 +273,41 @@ void cuda(cudaStream_t stream, Index m, Index n, Index k, const T *src,
  *      sums and norms of slices along middle axis.
  * */
 {
+    if(n == 0)
+    {
+        return;
+    }
+    // Long contiguous slices are reduced by warp shuffles, while the block
+    // size is chosen by the length of slices
+    if(m == 1 and k >= 32)
+    {
+        if(k >= 2048)
+        {
+            launch_m1<T, 256>(stream, n, k, src, sumnorm);
+        }
+        else if(k >= 256)
+        {
+            launch_m1<T, 128>(stream, n, k, src, sumnorm);
+        }
+        else
+        {
+            launch_m1<T, 32>(stream, n, k, src, sumnorm);
+        }
+        return;
+    }
+    // Wide slices are reduced with coalesced loads
+    if(m >= 32)
+    {
+        if(k >= 64)
+        {
+            launch_coalesced<T, 8>(stream, m, n, k, src, sumnorm);
+        }
+        else
+        {
+            launch_coalesced<T, 2>(stream, m, n, k, src, sumnorm);
+        }
+        return;
+    }
     // Source is an m-by-n matrix and destination is an m-by-k-by-n tensor
     // Both source and destination are Fortran-contiguous
     dim3 blocks(16, 16), threads(8, 4);
@@ -22,75 +22,177 @@ namespace kernel
 namespace sumprod_fiber
 {
 
+// Target number of blocks of threads to occupy all the multiprocessors
+static constexpr Index TARGET_BLOCKS = 256;
+
+// Number of warps per block for long fibers and number of columns of a tile
+// for short fibers
+static constexpr int NWARPS = 8, BLOCK_N = 8;
+
 template<typename T>
 static __global__
-void cuda_kernel(Index m, Index n, Index k, T alpha, const T *src1,
-        const T *src2, T beta, T *dst)
-//! Sums over slices into a fiber of a product of two tensors on CPU
-/*! For two provided m-by-k-by-n input arrays src1 and src2 compute sums of
- * per-element product of corresponding slices along the first and the third
- * axes with m and n elements respectively, resulting in output vector dst with
- * k elements.
- * Mnemonically, the following operations are performed:
- *      dst[l] = beta*dst[l] + alpha*sum_ij(src1[i,l,j] * src2[i,l,j])
- *      
- * @param[in] m: Size of the first mode of src1 and src2 tensors
- * @param[in] n: Size of the last mode of src1 and src2 tensors
- * @param[in] k: Size of the middle mode of src1 and src2 tensors and of the
- *      only mode of dst tensor
- * @param[in] alpha: Scaling factor for src1*src2
- * @param[in] src1: Input contiguous m-by-k-by-n array
- * @param[in] src2: Input contiguous m-by-k-by-n array
- * @param[in] beta: Scaling factor for dst
- * @param[inout] dst: Output contiguous vector with k elements, that
- *      accumulates sums along the first and the last axes of per-element
- *      products of src1 and src2.
- * */
+void cuda_kernel_scale(Index k, T beta, T *dst)
+//! Scale output fiber before partial sums are accumulated atomically
 {
     Index i2 = threadIdx.x + blockIdx.x*blockDim.x;
-    Index i0_start = threadIdx.y, i0_step = blockDim.y;
-    Index i1_start = threadIdx.z, i1_step = blockDim.z;
     constexpr T zero = 0;
-    // Init sum of product of the slices
-    T sum = zero;
     if(i2 < k)
     {
-        // Cycle over column of src1 and src2
-        for(Index i1 = i1_start; i1 < n; i1 += i1_step)
+        if(beta == zero)
+        {
+            dst[i2] = zero;
+        }
+        else
+        {
+            dst[i2] *= beta;
+        }
+    }
+}
+
+template<typename T>
+static __device__
+void update_output(bool split, T alpha, T sum, T beta, T &result)
+//! Write output directly or accumulate a partial sum atomically
+{
+    constexpr T zero = 0;
+    if(split)
+    {
+        atomicAdd(&result, alpha*sum);
+    }
+    else if(beta == zero)
+    {
+        result = alpha * sum;
+    }
+    else
+    {
+        result = beta*result + alpha*sum;
+    }
+}
+
+//! Sums over slices with long contiguous fibers (m>=32)
+/*! A block of NWARPS warps reduces a slice for a single output element,
+ * lanes of a warp read consecutive elements of a fiber, while warps stride
+ * over the last axis. Partial sums are reduced by warp shuffles and then by
+ * the first warp. If the last axis is split among gridDim.y blocks, partial
+ * sums are accumulated atomically into a prescaled output.
+ * */
+template<typename T>
+static __global__
+void cuda_kernel_warp(Index m, Index n, Index k, T alpha, const T *src1,
+        const T *src2, T beta, T *dst)
+{
+    constexpr T zero = 0;
+    __shared__ T warp_sum[NWARPS];
+    const bool split = gridDim.y > 1;
+    for(Index i2 = blockIdx.x; i2 < k; i2 += gridDim.x)
+    {
+        // Cycle over fibers of inputs
+        T sum = zero;
+        for(Index i1 = threadIdx.y + blockIdx.y*NWARPS; i1 < n;
+                i1 += NWARPS*gridDim.y)
         {
-            // Get corresponding fibers of both sources
             const T *src1_fiber = src1 + (i1*k+i2)*m;
             const T *src2_fiber = src2 + (i1*k+i2)*m;
-            // Cycle over fibers of inputs
-            for(Index i0 = i0_start; i0 < m; i0 += i0_step)
+            for(Index i0 = threadIdx.x; i0 < m; i0 += 32)
             {
-                // Update sum
                 sum += src1_fiber[i0] * src2_fiber[i0];
             }
         }
+        // Reduce within a warp
+#pragma unroll
+        for(int offset = 16; offset > 0; offset /= 2)
+        {
+            sum += __shfl_down_sync(0xffffffff, sum, offset);
+        }
+        // Reduce over warps
+        if constexpr (NWARPS > 1)
+        {
+            if(threadIdx.x == 0)
+            {
+                warp_sum[threadIdx.y] = sum;
+            }
+            __syncthreads();
+            if(threadIdx.y == 0)
+            {
+                sum = (threadIdx.x < NWARPS) ? warp_sum[threadIdx.x] : zero;
+#pragma unroll
+                for(int offset = NWARPS/2; offset > 0; offset /= 2)
+                {
+                    sum += __shfl_down_sync(0xffffffff, sum, offset);
+                }
+            }
+            // Shared memory is reused by the next output element
+            __syncthreads();
+        }
+        // Update output value
+        if(threadIdx.x == 0 and threadIdx.y == 0)
+        {
+            update_output(split, alpha, sum, beta, dst[i2]);
+        }
     }
-    __shared__ T block_sum[2];
-    if(i1_start == 0 and i0_start == 0)
+}
+
+//! Sums over slices with short fibers (m<32)
+/*! A block of threads is a 32-by-BLOCK_N tile, whose rows are 32 consecutive
+ * output elements and whose columns stride over the last axis. Lanes of a
+ * warp read consecutive fibers, that are contiguous for m=1. Partial sums
+ * are reduced over columns in the shared memory. If the last axis is split
+ * among gridDim.y blocks, partial sums are accumulated atomically into a
+ * prescaled output.
+ * */
+template<typename T>
+static __global__
+void cuda_kernel_tile(Index m, Index n, Index k, T alpha, const T *src1,
+        const T *src2, T beta, T *dst)
+{
+    constexpr T zero = 0;
+    __shared__ T block_sum[BLOCK_N][32];
+    Index i2 = threadIdx.x + blockIdx.x*32;
+    // Cycle over fibers of inputs
+    T sum = zero;
+    if(i2 < k)
     {
-        block_sum[threadIdx.x] = zero;
+        for(Index i1 = threadIdx.y + blockIdx.y*BLOCK_N; i1 < n;
+                i1 += BLOCK_N*gridDim.y)
+        {
+            const T *src1_fiber = src1 + (i1*k+i2)*m;
+            const T *src2_fiber = src2 + (i1*k+i2)*m;
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                sum += src1_fiber[i0] * src2_fiber[i0];
+            }
+        }
     }
+    // Reduce over columns of the block
+    block_sum[threadIdx.y][threadIdx.x] = sum;
     __syncthreads();
-    atomicAdd(&block_sum[threadIdx.x], sum);
-    __syncthreads();
-    // Update output value
-    if(i1_start == 0 and i0_start == 0 and i2 < k)
+#pragma unroll
+    for(int s = BLOCK_N/2; s > 0; s /= 2)
     {
-        // Output value
-        T &result = dst[i2];
-        if(beta == zero)
+        if(threadIdx.y < s)
         {
-            result = alpha * block_sum[threadIdx.x];
-        }
-        else
-        {
-            result = beta*result + alpha*block_sum[threadIdx.x];
+            block_sum[threadIdx.y][threadIdx.x] +=
+                block_sum[threadIdx.y+s][threadIdx.x];
         }
+        __syncthreads();
     }
+    // Update output value
+    if(threadIdx.y == 0 and i2 < k)
+    {
+        update_output(gridDim.y > 1, alpha, block_sum[0][threadIdx.x], beta,
+                dst[i2]);
+    }
+}
+
+//! Number of blocks along the last axis for a two-stage reduction
+/*! The last axis is split only if there are not enough output elements to
+ * occupy the device, while every thread keeps at least 16 fibers.
+ * */
+static Index get_nsplit(Index n, Index rows, Index blocks)
+{
+    Index nsplit = (TARGET_BLOCKS+blocks-1) / blocks;
+    nsplit = std::min(nsplit, (n+16*rows-1) / (16*rows));
+    return std::max(std::min(nsplit, Index(65535)), Index(1));
 }
 
 template<typename T>
@@ -118,11 +220,41 @@ void cuda(cudaStream_t stream, Index m, Index n, Index k, T alpha,
  *      products of src1 and src2.
  * */
 {
-    // Both source and destination are Fortran-contiguous
-    dim3 threads(2, std::min(int(m), 32), std::min(int(n), 32));
-    dim3 blocks((k+threads.x-1)/threads.x, 1, 1);
-    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, n, k, alpha, src1,
-            src2, beta, dst);
+    if(k == 0)
+    {
+        return;
+    }
+    // Long fibers are reduced by warps, while short fibers are reduced by
+    // columns of tiles
+    dim3 threads, blocks;
+    if(m >= 32)
+    {
+        threads = dim3(32, NWARPS);
+        blocks = dim3(std::min(k, Index(65535)));
+        blocks.y = get_nsplit(n, NWARPS, blocks.x);
+    }
+    else
+    {
+        threads = dim3(32, BLOCK_N);
+        blocks = dim3((k+31)/32);
+        blocks.y = get_nsplit(n, BLOCK_N, blocks.x);
+    }
+    // Two-stage reduction accumulates partial sums into prescaled output
+    if(blocks.y > 1 and beta != T(1))
+    {
+        (cuda_kernel_scale<T>)<<<(k+255)/256, 256, 0, stream>>>(k, beta,
+                dst);
+    }
+    if(m >= 32)
+    {
+        (cuda_kernel_warp<T>)<<<blocks, threads, 0, stream>>>(m, n, k,
+                alpha, src1, src2, beta, dst);
+    }
+    else
+    {
+        (cuda_kernel_tile<T>)<<<blocks, threads, 0, stream>>>(m, n, k,
+                alpha, src1, src2, beta, dst);
+    }
 }
 
 // Explicit instantiation
@@ -70,6 +70,75 @@ void cuda_kernel(Index m, Index n, Index k, Index mk, T alpha, const T *src1,
     }
 }
 
+//! Sums of products of strided fibers (m>=32) with coalesced loads
+/*! A block of threads is a 32-by-BLOCK_K tile, whose rows are 32 consecutive
+ * fibers and whose columns stride over the middle axis. Consecutive threads
+ * of a warp read consecutive elements of memory, while the generic kernel
+ * reads only 8 consecutive elements per warp. Partial sums are reduced over
+ * columns in the shared memory.
+ * */
+template<typename T, int BLOCK_K>
+static __global__
+void cuda_kernel_coalesced(Index m, Index n, Index k, T alpha, const T *src1,
+        const T *src2, T beta, T *dst)
+{
+    constexpr T zero = 0;
+    __shared__ T block_sum[BLOCK_K][32];
+    Index i0 = threadIdx.x + blockIdx.x*32;
+    for(Index i1 = blockIdx.y; i1 < n; i1 += gridDim.y)
+    {
+        // Cycle over fibers of inputs
+        T sum = zero;
+        if(i0 < m)
+        {
+            const T *src1_fiber = src1 + i1*m*k + i0;
+            const T *src2_fiber = src2 + i1*m*k + i0;
+            for(Index i2 = threadIdx.y; i2 < k; i2 += BLOCK_K)
+            {
+                sum += src1_fiber[i2*m] * src2_fiber[i2*m];
+            }
+        }
+        // Reduce over columns of the block
+        block_sum[threadIdx.y][threadIdx.x] = sum;
+        __syncthreads();
+#pragma unroll
+        for(int s = BLOCK_K/2; s > 0; s /= 2)
+        {
+            if(threadIdx.y < s)
+            {
+                block_sum[threadIdx.y][threadIdx.x] +=
+                    block_sum[threadIdx.y+s][threadIdx.x];
+            }
+            __syncthreads();
+        }
+        // Update output value
+        if(threadIdx.y == 0 and i0 < m)
+        {
+            T &result = dst[i1*m+i0];
+            sum = block_sum[0][threadIdx.x];
+            if(beta == zero)
+            {
+                result = alpha * sum;
+            }
+            else
+            {
+                result = beta*result + alpha*sum;
+            }
+        }
+    }
+}
+
+//! Launch a coalesced variant of kernel, specialized by the block size
+template<typename T, int BLOCK_K>
+static void launch_coalesced(cudaStream_t stream, Index m, Index n, Index k,
+        T alpha, const T *src1, const T *src2, T beta, T *dst)
+{
+    dim3 threads(32, BLOCK_K);
+    dim3 blocks((m+31)/32, std::min(n, Index(65535)));
+    (cuda_kernel_coalesced<T, BLOCK_K>)<<<blocks, threads, 0, stream>>>(m, n,
+            k, alpha, src1, src2, beta, dst);
+}
+
 template<typename T>
 void cuda(cudaStream_t stream, Index m, Index n, Index k, T alpha,
         const T *src1, const T *src2, T beta, T *dst)
@@ -92,6 +161,22 @@ void cuda(cudaStream_t stream, Index m, Index n, Index k, T alpha,
  *      sums along middle axis of per-element products of src1 and src2.
  * */
 {
+    // Wide slices are reduced with coalesced loads, while the number of
+    // threads along the middle axis is chosen by its size
+    if(m >= 32 and n > 0)
+    {
+        if(k >= 64)
+        {
+            launch_coalesced<T, 8>(stream, m, n, k, alpha, src1, src2, beta,
+                    dst);
+        }
+        else
+        {
+            launch_coalesced<T, 2>(stream, m, n, k, alpha, src1, src2, beta,
+                    dst);
+        }
+        return;
+    }
     // Both source and destination are Fortran-contiguous
     dim3 threads(std::min(int(m), 8), std::min(int(n), 8), 16);
     dim3 blocks((m+threads.x-1)/threads.x, (n+threads.y-1)/threads.y, 1);
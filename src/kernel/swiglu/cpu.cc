@@ -0,0 +1,64 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/swiglu/cpu.cc
+ * SiLU-gated product of buffers on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/swiglu/cpu.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace swiglu
+{
+
+template<typename T>
+void cpu(Index nelems, const T *gate, const T *up, T *dst)
+    noexcept
+//! SiLU-gated product of buffers on CPU
+/*! Does the following per-element operation:
+ * dst[i] = SiLU(gate[i]) * up[i]
+ * SiLU(z) = z / (1+exp(-z))
+ *
+ * Input buffers are outputs of two up-projections of a gated MLP, so a
+ * separate activation pass over the gate and a separate product are fused.
+ *
+ * @params[in] nelems: Number of elements in buffers
+ * @params[in] gate: Input buffer of the gate
+ * @params[in] up: Input buffer of the up-projection
+ * @params[out] dst: Output buffer
+ * */
+{
+    constexpr T one = 1;
+    for(Index i = 0; i < nelems; ++i)
+    {
+        T z = gate[i];
+        dst[i] = z / (one+std::exp(-z)) * up[i];
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index nelems, const fp32_t *gate, const fp32_t *up,
+        fp32_t *dst)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index nelems, const fp64_t *gate, const fp64_t *up,
+        fp64_t *dst)
+    noexcept;
+
+} // namespace swiglu
+} // namespace kernel
+} // namespace nntile
+
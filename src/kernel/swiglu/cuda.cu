@@ -0,0 +1,70 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/swiglu/cuda.cu
+ * SiLU-gated product of buffers on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/swiglu/cuda.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace swiglu
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index nelems, const T *gate, const T *up, T *dst)
+{
+    int i = threadIdx.x + blockIdx.x*blockDim.x;
+    constexpr T one = 1;
+    if(i < nelems)
+    {
+        T z = gate[i];
+        dst[i] = z / (one+exp(-z)) * up[i];
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index nelems, const T *gate, const T *up,
+        T *dst)
+    noexcept
+//! SiLU-gated product of buffers on CUDA
+/*! Does the following per-element operation:
+ * dst[i] = SiLU(gate[i]) * up[i]
+ * SiLU(z) = z / (1+exp(-z))
+ *
+ * @params[in] nelems: Number of elements in buffers
+ * @params[in] gate: Input buffer of the gate
+ * @params[in] up: Input buffer of the up-projection
+ * @params[out] dst: Output buffer
+ * */
+{
+    dim3 blocks((nelems+255)/256), threads(256);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(nelems, gate, up, dst);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index nelems, const fp32_t *gate,
+        const fp32_t *up, fp32_t *dst)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index nelems, const fp64_t *gate,
+        const fp64_t *up, fp64_t *dst)
+    noexcept;
+
+} // namespace swiglu
+} // namespace kernel
+} // namespace nntile
+
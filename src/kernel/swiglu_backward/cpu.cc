@@ -0,0 +1,69 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/swiglu_backward/cpu.cc
+ * Backward of SiLU-gated product of buffers on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/swiglu_backward/cpu.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace swiglu_backward
+{
+
+template<typename T>
+void cpu(Index nelems, const T *gate, const T *up, const T *dst_grad,
+        T *gate_grad, T *up_grad)
+    noexcept
+//! Backward of SiLU-gated product of buffers on CPU
+/*! Accumulates gradients of both inputs of dst = SiLU(gate)*up in a single
+ * pass:
+ * gate_grad[i] = gate_grad[i] + dst_grad[i]*up[i]*SiLU'(gate[i])
+ * up_grad[i] = up_grad[i] + dst_grad[i]*SiLU(gate[i])
+ * SiLU'(z) = s(z) * (1+z*(1-s(z))), where s(z) = 1/(1+exp(-z))
+ *
+ * @params[in] nelems: Number of elements in buffers
+ * @params[in] gate: Input buffer of the gate
+ * @params[in] up: Input buffer of the up-projection
+ * @params[in] dst_grad: Gradient of the output buffer
+ * @params[inout] gate_grad: Gradient of the gate
+ * @params[inout] up_grad: Gradient of the up-projection
+ * */
+{
+    constexpr T one = 1;
+    for(Index i = 0; i < nelems; ++i)
+    {
+        T z = gate[i];
+        T s = one / (one+std::exp(-z));
+        T dy = dst_grad[i];
+        gate_grad[i] += dy * up[i] * s * (one+z*(one-s));
+        up_grad[i] += dy * z * s;
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index nelems, const fp32_t *gate, const fp32_t *up,
+        const fp32_t *dst_grad, fp32_t *gate_grad, fp32_t *up_grad)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index nelems, const fp64_t *gate, const fp64_t *up,
+        const fp64_t *dst_grad, fp64_t *gate_grad, fp64_t *up_grad)
+    noexcept;
+
+} // namespace swiglu_backward
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,152 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/topk/cpu.cc
+ * Largest values and their indices along middle axis on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-11
+ * */
+
+#include "nntile/kernel/topk/cpu.hh"
+#include "nntile/kernel/parallel.hh"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace topk
+{
+
+template<typename Y>
+static inline bool better(Y val, Index idx, Y other_val, Index other_idx)
+    noexcept
+//! Order of candidates: larger values go first, ties go to smaller indices
+{
+    return val > other_val or (val == other_val and idx < other_idx);
+}
+
+template<typename T>
+void cpu(Index m, Index n, Index k, Index nk, Index offset, Index size,
+        bool init, const T *src, T *values, Index *indices)
+    noexcept
+//! Accumulate nk largest values and their indices along middle axis
+/*! For every slice src[i,:,j] of a contiguous m-by-k-by-n array the nk
+ * largest values are merged with candidates values[:,i,j] and
+ * indices[:,i,j], which are sorted in descending order of values. An index
+ * of an element of a slice is its position along the middle axis plus
+ * offset, so that tiles of a tensor along the axis are accumulated into the
+ * same candidates in any order. Ties are resolved in favor of smaller
+ * indices, NaN values are skipped. If there are less than nk candidates,
+ * the rest of them get index -1 and value -inf.
+ *
+ * @param[in] m: Size of the first mode of src array
+ * @param[in] n: Size of the last mode of src array
+ * @param[in] k: Size of the middle mode of src array
+ * @param[in] nk: Number of candidates of a slice
+ * @param[in] offset: Index of the first element of a slice
+ * @param[in] size: Elements with indices not less than size are skipped,
+ *      for example, padding of vocabulary
+ * @param[in] init: Whether input candidates are ignored and overwritten
+ * @param[in] src: Input contiguous m-by-k-by-n array
+ * @param[inout] values: Contiguous nk-by-m-by-n array of values of
+ *      candidates
+ * @param[inout] indices: Contiguous nk-by-m-by-n array of indices of
+ *      candidates
+ * */
+{
+    using Y = compute_t<T>;
+    constexpr Y ninf = -std::numeric_limits<Y>::infinity();
+    const Index mk = m * k;
+    const Index k_end = std::min(k, std::max(size-offset, Index(0)));
+    parallel::parallel_for(m*n, 1, [&](Index begin, Index end)
+    {
+        std::vector<Y> val(nk);
+        std::vector<Index> idx(nk);
+        for(Index col = begin; col < end; ++col)
+        {
+            Index i1 = col % m, i2 = col / m;
+            const T *src_slice = src + i2*mk + i1;
+            T *val_slice = values + col*nk;
+            Index *idx_slice = indices + col*nk;
+            // Valid input candidates form a prefix
+            Index cnt = 0;
+            if(not init)
+            {
+                while(cnt < nk and idx_slice[cnt] >= 0)
+                {
+                    val[cnt] = static_cast<Y>(val_slice[cnt]);
+                    idx[cnt] = idx_slice[cnt];
+                    ++cnt;
+                }
+            }
+            for(Index i0 = 0; i0 < k_end; ++i0)
+            {
+                Y v = static_cast<Y>(src_slice[i0*m]);
+                Index g = offset + i0;
+                if(std::isnan(v) or (cnt == nk
+                            and not better(v, g, val[nk-1], idx[nk-1])))
+                {
+                    continue;
+                }
+                // Insert into sorted candidates, the last one is dropped
+                Index j = (cnt < nk) ? cnt++ : nk-1;
+                for(; j > 0 and better(v, g, val[j-1], idx[j-1]); --j)
+                {
+                    val[j] = val[j-1];
+                    idx[j] = idx[j-1];
+                }
+                val[j] = v;
+                idx[j] = g;
+            }
+            for(Index j = 0; j < cnt; ++j)
+            {
+                val_slice[j] = static_cast<T>(val[j]);
+                idx_slice[j] = idx[j];
+            }
+            for(Index j = cnt; j < nk; ++j)
+            {
+                val_slice[j] = static_cast<T>(ninf);
+                idx_slice[j] = -1;
+            }
+        }
+    });
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, Index nk, Index offset,
+        Index size, bool init, const fp32_t *src, fp32_t *values,
+        Index *indices)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, Index nk, Index offset,
+        Index size, bool init, const fp64_t *src, fp64_t *values,
+        Index *indices)
+    noexcept;
+
+template
+void cpu<bf16_t>(Index m, Index n, Index k, Index nk, Index offset,
+        Index size, bool init, const bf16_t *src, bf16_t *values,
+        Index *indices)
+    noexcept;
+
+template
+void cpu<fp16_t>(Index m, Index n, Index k, Index nk, Index offset,
+        Index size, bool init, const fp16_t *src, fp16_t *values,
+        Index *indices)
+    noexcept;
+
+} // namespace topk
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,186 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/topk/cuda.cu
+ * Largest values and their indices along middle axis on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-11
+ * */
+
+#include "nntile/kernel/topk/cuda.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace topk
+{
+
+template<typename Y>
+static __device__ bool better(Y val, Index idx, Y other_val,
+        Index other_idx)
+//! Order of candidates, a candidate with negative index is the worst
+{
+    if(other_idx < 0)
+    {
+        return idx >= 0;
+    }
+    return idx >= 0 and (val > other_val
+            or (val == other_val and idx < other_idx));
+}
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, Index n, Index k, Index nk, Index offset,
+        Index k_end, bool init, const T *src, T *values, Index *indices)
+//! A block of threads finds candidates of a single slice one by one
+/*! Every round each thread proposes its best element, that is worse than
+ * the winner of the previous round, and the block picks the best proposal.
+ * Input candidates are kept in shared memory, as they are overwritten.
+ * */
+{
+    using Y = compute_t<T>;
+    extern __shared__ Index shared[];
+    Index *old_idx = shared;
+    Index *red_idx = old_idx + nk;
+    Y *old_val = reinterpret_cast<Y *>(red_idx + blockDim.x);
+    Y *red_val = old_val + nk;
+    const Index tid = threadIdx.x, nthreads = blockDim.x;
+    for(Index col = blockIdx.x; col < m*n; col += gridDim.x)
+    {
+        Index i1 = col % m, i2 = col / m;
+        const T *src_slice = src + i2*m*k + i1;
+        T *val_slice = values + col*nk;
+        Index *idx_slice = indices + col*nk;
+        for(Index j = tid; j < nk; j += nthreads)
+        {
+            old_idx[j] = init ? -1 : idx_slice[j];
+            old_val[j] = init ? Y(0) : static_cast<Y>(val_slice[j]);
+        }
+        __syncthreads();
+        Y last_val = 0;
+        Index last_idx = -1;
+        for(Index r = 0; r < nk; ++r)
+        {
+            Y best_val = 0;
+            Index best_idx = -1;
+            for(Index i0 = tid; i0 < k_end; i0 += nthreads)
+            {
+                Y v = static_cast<Y>(src_slice[i0*m]);
+                Index g = offset + i0;
+                if(::isnan(v) or (r > 0
+                            and not better(last_val, last_idx, v, g)))
+                {
+                    continue;
+                }
+                if(better(v, g, best_val, best_idx))
+                {
+                    best_val = v;
+                    best_idx = g;
+                }
+            }
+            for(Index j = tid; j < nk; j += nthreads)
+            {
+                Y v = old_val[j];
+                Index g = old_idx[j];
+                if(r > 0 and not better(last_val, last_idx, v, g))
+                {
+                    continue;
+                }
+                if(better(v, g, best_val, best_idx))
+                {
+                    best_val = v;
+                    best_idx = g;
+                }
+            }
+            red_val[tid] = best_val;
+            red_idx[tid] = best_idx;
+            __syncthreads();
+            // Number of threads is a power of two
+            for(Index s = nthreads/2; s > 0; s /= 2)
+            {
+                if(tid < s and better(red_val[tid+s], red_idx[tid+s],
+                            red_val[tid], red_idx[tid]))
+                {
+                    red_val[tid] = red_val[tid+s];
+                    red_idx[tid] = red_idx[tid+s];
+                }
+                __syncthreads();
+            }
+            last_val = red_val[0];
+            last_idx = red_idx[0];
+            __syncthreads();
+            if(tid == 0)
+            {
+                val_slice[r] = static_cast<T>(last_idx >= 0 ? last_val
+                        : Y(-INFINITY));
+                idx_slice[r] = last_idx;
+            }
+            // All the threads see the same winner, there are no more
+            // candidates, once it is invalid
+            if(last_idx < 0)
+            {
+                for(Index j = r+1+tid; j < nk; j += nthreads)
+                {
+                    val_slice[j] = static_cast<T>(Y(-INFINITY));
+                    idx_slice[j] = -1;
+                }
+                break;
+            }
+        }
+        __syncthreads();
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index k, Index nk,
+        Index offset, Index size, bool init, const T *src, T *values,
+        Index *indices)
+    noexcept
+//! Accumulate nk largest values and their indices along middle axis
+/*! See kernel::topk::cpu for the description of arguments.
+ * */
+{
+    using Y = compute_t<T>;
+    Index k_end = std::min(k, std::max(size-offset, Index(0)));
+    dim3 threads(256), blocks(std::min<Index>(m*n, 65535));
+    size_t smem = (nk+threads.x) * (sizeof(Index)+sizeof(Y));
+    (cuda_kernel<T>)<<<blocks, threads, smem, stream>>>(m, n, k, nk, offset,
+            k_end, init, src, values, indices);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index k, Index nk,
+        Index offset, Index size, bool init, const fp32_t *src,
+        fp32_t *values, Index *indices)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index k, Index nk,
+        Index offset, Index size, bool init, const fp64_t *src,
+        fp64_t *values, Index *indices)
+    noexcept;
+
+template
+void cuda<bf16_t>(cudaStream_t stream, Index m, Index n, Index k, Index nk,
+        Index offset, Index size, bool init, const bf16_t *src,
+        bf16_t *values, Index *indices)
+    noexcept;
+
+template
+void cuda<fp16_t>(cudaStream_t stream, Index m, Index n, Index k, Index nk,
+        Index offset, Index size, bool init, const fp16_t *src,
+        fp16_t *values, Index *indices)
+    noexcept;
+
+} // namespace topk
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,131 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/topk_sample/cpu.cc
+ * Sampling of tokens among the largest logits on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-11
+ * */
+
+#include "nntile/kernel/topk_sample/cpu.hh"
+#include "nntile/kernel/randn_philox/philox.hh"
+#include <algorithm>
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace topk_sample
+{
+
+template<typename T>
+void cpu(Index nk, Index n, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed, Index sequence, const T *values,
+        const Index *indices, Index *ids)
+    noexcept
+//! Sample ids of tokens among candidates with the largest logits
+/*! Candidates of every column are the output of kernel::topk: nk logits in
+ * descending order and their indices, where invalid candidates have
+ * negative indices. A candidate is chosen with probability
+ * softmax(values/temperature) restricted to the smallest prefix of
+ * candidates, whose probability is at least top_p (nucleus sampling). Zero
+ * temperature means greedy choice of the first candidate. A column without
+ * valid candidates gets id -1.
+ *
+ * Uniform random number of a column j is generated by Philox from the seed
+ * with counter (j, sequence), so that independent tiles use different
+ * sequences.
+ *
+ * @param[in] nk: Number of candidates of a column
+ * @param[in] n: Number of columns
+ * @param[in] temperature: Temperature of softmax
+ * @param[in] top_p: Probability of the nucleus, 1 disables it
+ * @param[in] seed: Seed of random numbers
+ * @param[in] sequence: Index of a random sequence
+ * @param[in] values: Contiguous nk-by-n array of logits of candidates
+ * @param[in] indices: Contiguous nk-by-n array of ids of candidates
+ * @param[out] ids: Array of n chosen ids
+ * */
+{
+    using Y = compute_t<T>;
+    for(Index j = 0; j < n; ++j)
+    {
+        const T *val = values + j*nk;
+        const Index *idx = indices + j*nk;
+        if(temperature <= 0 or nk == 1 or idx[0] < 0)
+        {
+            ids[j] = idx[0];
+            continue;
+        }
+        // Unnormalized probabilities of the nucleus
+        Y v0 = static_cast<Y>(val[0]), total = 0;
+        Index cnt = 0;
+        while(cnt < nk and idx[cnt] >= 0)
+        {
+            total += std::exp((static_cast<Y>(val[cnt])-v0) / temperature);
+            ++cnt;
+        }
+        Y mass = 0;
+        Index last = 0;
+        for(; last < cnt; ++last)
+        {
+            mass += std::exp((static_cast<Y>(val[last])-v0) / temperature);
+            if(mass >= top_p*total)
+            {
+                break;
+            }
+        }
+        last = std::min(last, cnt-1);
+        // Uniform random number in (0,1) with 24 random bits
+        uint32_t ctr[4];
+        randn_philox::philox_words(seed, j, sequence, ctr);
+        Y u = (Y(ctr[0]>>8)+Y(0.5)) / Y(16777216) * mass;
+        Index l = 0;
+        Y cum = 0;
+        for(; l < last; ++l)
+        {
+            cum += std::exp((static_cast<Y>(val[l])-v0) / temperature);
+            if(u < cum)
+            {
+                break;
+            }
+        }
+        ids[j] = idx[l];
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index nk, Index n, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed, Index sequence, const fp32_t *values,
+        const Index *indices, Index *ids)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index nk, Index n, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed, Index sequence, const fp64_t *values,
+        const Index *indices, Index *ids)
+    noexcept;
+
+template
+void cpu<bf16_t>(Index nk, Index n, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed, Index sequence, const bf16_t *values,
+        const Index *indices, Index *ids)
+    noexcept;
+
+template
+void cpu<fp16_t>(Index nk, Index n, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed, Index sequence, const fp16_t *values,
+        const Index *indices, Index *ids)
+    noexcept;
+
+} // namespace topk_sample
+} // namespace kernel
+} // namespace nntile
+
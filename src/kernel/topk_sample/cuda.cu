@@ -0,0 +1,123 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/topk_sample/cuda.cu
+ * Sampling of tokens among the largest logits on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-11
+ * */
+
+#include "nntile/kernel/topk_sample/cuda.hh"
+#include "nntile/kernel/randn_philox/philox.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace topk_sample
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index nk, Index n, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed, Index sequence, const T *values,
+        const Index *indices, Index *ids)
+//! A single thread samples a single column
+{
+    using Y = compute_t<T>;
+    Index j = threadIdx.x + Index(blockIdx.x)*blockDim.x;
+    if(j >= n)
+    {
+        return;
+    }
+    const T *val = values + j*nk;
+    const Index *idx = indices + j*nk;
+    if(temperature <= 0 or nk == 1 or idx[0] < 0)
+    {
+        ids[j] = idx[0];
+        return;
+    }
+    // Unnormalized probabilities of the nucleus
+    Y v0 = static_cast<Y>(val[0]), total = 0;
+    Index cnt = 0;
+    while(cnt < nk and idx[cnt] >= 0)
+    {
+        total += ::exp((static_cast<Y>(val[cnt])-v0) / temperature);
+        ++cnt;
+    }
+    Y mass = 0;
+    Index last = 0;
+    for(; last < cnt; ++last)
+    {
+        mass += ::exp((static_cast<Y>(val[last])-v0) / temperature);
+        if(mass >= top_p*total)
+        {
+            break;
+        }
+    }
+    last = ::min(last, cnt-1);
+    // Uniform random number in (0,1) with 24 random bits
+    uint32_t ctr[4];
+    randn_philox::philox_words(seed, j, sequence, ctr);
+    Y u = (Y(ctr[0]>>8)+Y(0.5)) / Y(16777216) * mass;
+    Index l = 0;
+    Y cum = 0;
+    for(; l < last; ++l)
+    {
+        cum += ::exp((static_cast<Y>(val[l])-v0) / temperature);
+        if(u < cum)
+        {
+            break;
+        }
+    }
+    ids[j] = idx[l];
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index nk, Index n, fp32_t temperature,
+        fp32_t top_p, unsigned long long seed, Index sequence,
+        const T *values, const Index *indices, Index *ids)
+    noexcept
+//! Sample ids of tokens among candidates with the largest logits
+/*! See kernel::topk_sample::cpu for the description of arguments.
+ * */
+{
+    dim3 threads(256), blocks((n+255)/256);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(nk, n, temperature,
+            top_p, seed, sequence, values, indices, ids);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index nk, Index n,
+        fp32_t temperature, fp32_t top_p, unsigned long long seed,
+        Index sequence, const fp32_t *values, const Index *indices, Index *ids)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index nk, Index n,
+        fp32_t temperature, fp32_t top_p, unsigned long long seed,
+        Index sequence, const fp64_t *values, const Index *indices, Index *ids)
+    noexcept;
+
+template
+void cuda<bf16_t>(cudaStream_t stream, Index nk, Index n,
+        fp32_t temperature, fp32_t top_p, unsigned long long seed,
+        Index sequence, const bf16_t *values, const Index *indices, Index *ids)
+    noexcept;
+
+template
+void cuda<fp16_t>(cudaStream_t stream, Index nk, Index n,
+        fp32_t temperature, fp32_t top_p, unsigned long long seed,
+        Index sequence, const fp16_t *values, const Index *indices, Index *ids)
+    noexcept;
+
+} // namespace topk_sample
+} // namespace kernel
+} // namespace nntile
+
@@ -9,10 +9,12 @@
  *
  * @version 1.0.0
  * @author Aleksandr Mikhalev
- * @date 2023-07-20
+ * @date 2024-02-15
  * */
 
 #include "nntile/kernel/transpose/cpu.hh"
+#include "nntile/kernel/simd.hh"
+#include <algorithm>
 
 namespace nntile
 {
@@ -21,11 +23,142 @@ namespace kernel
 namespace transpose
 {
 
+//! Size of square blocks, that fit into L1 cache together with their images
+constexpr Index block_size = 64;
+
+//! Transpose a part of a block without vectorization
+template<typename T>
+static void block_scalar(Index m, Index n, T alpha, const T *src, T *dst,
+        Index nrows, Index ncols)
+    noexcept
+{
+    for(Index i = 0; i < nrows; ++i)
+    {
+        for(Index j = 0; j < ncols; ++j)
+        {
+            dst[i*n+j] = alpha * src[i+j*m];
+        }
+    }
+}
+
+//! Transpose blocks one by one with a given routine for a single block
+template<typename T, typename F>
+static void blocked(Index m, Index n, T alpha, const T *src, T *dst,
+        F block)
+    noexcept
+{
+    for(Index j = 0; j < n; j += block_size)
+    {
+        Index ncols = std::min(block_size, n-j);
+        for(Index i = 0; i < m; i += block_size)
+        {
+            Index nrows = std::min(block_size, m-i);
+            block(m, n, alpha, src+i+j*m, dst+i*n+j, nrows, ncols);
+        }
+    }
+}
+
+template<typename T>
+static void cpu_scalar(Index m, Index n, T alpha, const T *src, T *dst)
+    noexcept
+{
+    blocked<T>(m, n, alpha, src, dst, block_scalar<T>);
+}
+
+#ifdef NNTILE_KERNEL_SIMD_X86
+//! Transpose 8x8 block in registers
+static inline NNTILE_SIMD_TARGET_AVX2 void micro_avx2(Index m, Index n,
+        fp32_t alpha, const fp32_t *src, fp32_t *dst)
+    noexcept
+{
+    __m256 r0 = _mm256_loadu_ps(src), r1 = _mm256_loadu_ps(src+m),
+           r2 = _mm256_loadu_ps(src+2*m), r3 = _mm256_loadu_ps(src+3*m),
+           r4 = _mm256_loadu_ps(src+4*m), r5 = _mm256_loadu_ps(src+5*m),
+           r6 = _mm256_loadu_ps(src+6*m), r7 = _mm256_loadu_ps(src+7*m);
+    // Interleave pairs of columns
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpackhi_ps(r0, r1),
+           t2 = _mm256_unpacklo_ps(r2, r3), t3 = _mm256_unpackhi_ps(r2, r3),
+           t4 = _mm256_unpacklo_ps(r4, r5), t5 = _mm256_unpackhi_ps(r4, r5),
+           t6 = _mm256_unpacklo_ps(r6, r7), t7 = _mm256_unpackhi_ps(r6, r7);
+    // Gather quadruples of columns
+    r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    r4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    r5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    r6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    r7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+    // Swap 128-bit halves
+    __m256 a = _mm256_set1_ps(alpha);
+    _mm256_storeu_ps(dst, a*_mm256_permute2f128_ps(r0, r4, 0x20));
+    _mm256_storeu_ps(dst+n, a*_mm256_permute2f128_ps(r1, r5, 0x20));
+    _mm256_storeu_ps(dst+2*n, a*_mm256_permute2f128_ps(r2, r6, 0x20));
+    _mm256_storeu_ps(dst+3*n, a*_mm256_permute2f128_ps(r3, r7, 0x20));
+    _mm256_storeu_ps(dst+4*n, a*_mm256_permute2f128_ps(r0, r4, 0x31));
+    _mm256_storeu_ps(dst+5*n, a*_mm256_permute2f128_ps(r1, r5, 0x31));
+    _mm256_storeu_ps(dst+6*n, a*_mm256_permute2f128_ps(r2, r6, 0x31));
+    _mm256_storeu_ps(dst+7*n, a*_mm256_permute2f128_ps(r3, r7, 0x31));
+}
+
+//! Transpose 4x4 block in registers
+static inline NNTILE_SIMD_TARGET_AVX2 void micro_avx2(Index m, Index n,
+        fp64_t alpha, const fp64_t *src, fp64_t *dst)
+    noexcept
+{
+    __m256d r0 = _mm256_loadu_pd(src), r1 = _mm256_loadu_pd(src+m),
+            r2 = _mm256_loadu_pd(src+2*m), r3 = _mm256_loadu_pd(src+3*m);
+    // Interleave pairs of columns
+    __m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1),
+            t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+    // Swap 128-bit halves
+    __m256d a = _mm256_set1_pd(alpha);
+    _mm256_storeu_pd(dst, a*_mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(dst+n, a*_mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(dst+2*n, a*_mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(dst+3*n, a*_mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+//! Transpose a part of a block by 32-byte micro-blocks in registers
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX2 void block_avx2(Index m, Index n, T alpha,
+        const T *src, T *dst, Index nrows, Index ncols)
+    noexcept
+{
+    constexpr Index W = 32 / sizeof(T);
+    Index i = 0;
+    for(; i+W <= nrows; i += W)
+    {
+        Index j = 0;
+        for(; j+W <= ncols; j += W)
+        {
+            micro_avx2(m, n, alpha, src+i+j*m, dst+i*n+j);
+        }
+        block_scalar<T>(m, n, alpha, src+i+j*m, dst+i*n+j, W, ncols-j);
+    }
+    block_scalar<T>(m, n, alpha, src+i, dst+i*n, nrows-i, ncols);
+}
+
+template<typename T>
+static NNTILE_SIMD_TARGET_AVX2 void cpu_avx2(Index m, Index n, T alpha,
+        const T *src, T *dst)
+    noexcept
+{
+    blocked<T>(m, n, alpha, src, dst, block_avx2<T>);
+}
+#endif // NNTILE_KERNEL_SIMD_X86
+
 template<typename T>
 void cpu(Index m, Index n, T alpha, const T* src, T* dst)
     noexcept
 //! Transpose buffers on CPU
 /*! dst[i,j] = alpha * src[j,i]
+ *
+ * Buffers are processed by square blocks, so that both the source block and
+ * the destination block stay in L1 cache. With AVX2 blocks are transposed
+ * by 32-byte micro-blocks (8x8 for fp32_t and 4x4 for fp64_t) entirely in
+ * registers. AVX-512 uses the same micro-blocks, as the transpose is bound
+ * by memory bandwidth.
  *
  * @param[in] m: Number of rows of src and columns of dst
  * @param[in] n: Number of columns of src and rows of dst
@@ -34,11 +167,51 @@ void cpu(Index m, Index n, T alpha, const T* src, T* dst)
  * @param[out] dst: Destination of the add operation
  * */
 {
-    for(Index i = 0; i < m; ++i)
+#ifdef NNTILE_KERNEL_SIMD_X86
+    if(simd::get_level() != simd::Level::NONE)
+    {
+        cpu_avx2<T>(m, n, alpha, src, dst);
+        return;
+    }
+#endif // NNTILE_KERNEL_SIMD_X86
+    cpu_scalar<T>(m, n, alpha, src, dst);
+}
+
+template<typename T>
+void cpu_inplace(Index n, T alpha, T *data)
+    noexcept
+//! Transpose square buffer inplace on CPU
+/*! data[i,j] = alpha * data[j,i]
+ *
+ * Pairs of blocks, that are symmetric with respect to the diagonal, are
+ * swapped one by one, so that both of them stay in L1 cache.
+ *
+ * @param[in] n: Number of rows and columns of data
+ * @param[in] alpha: Scalar multiplier
+ * @param[inout] data: Square buffer
+ * */
+{
+    for(Index j0 = 0; j0 < n; j0 += block_size)
     {
-        for(Index j = 0; j < n; ++j)
+        Index j1 = std::min(j0+block_size, n);
+        for(Index i0 = 0; i0 <= j0; i0 += block_size)
         {
-            dst[i*n+j] = alpha * src[i+j*m];
+            Index i1 = std::min(i0+block_size, n);
+            for(Index j = j0; j < j1; ++j)
+            {
+                // Only the upper triangle of a diagonal block is swapped
+                Index i_end = std::min(i1, j);
+                for(Index i = i0; i < i_end; ++i)
+                {
+                    T upper = data[i+j*n];
+                    data[i+j*n] = alpha * data[j+i*n];
+                    data[j+i*n] = alpha * upper;
+                }
+                if(i0 == j0)
+                {
+                    data[j+j*n] *= alpha;
+                }
+            }
         }
     }
 }
@@ -54,6 +227,14 @@ void cpu<fp64_t>(Index m, Index n, fp64_t alpha, const fp64_t* src,
         fp64_t* dst)
     noexcept;
 
+template
+void cpu_inplace<fp32_t>(Index n, fp32_t alpha, fp32_t *data)
+    noexcept;
+
+template
+void cpu_inplace<fp64_t>(Index n, fp64_t alpha, fp64_t *data)
+    noexcept;
+
 } // namespace tranpose
 } // namespace kernel
 } // namespace nntile
@@ -9,7 +9,7 @@
  *
  * @version 1.0.0
  * @author Aleksandr Mikhalev
- * @date 2023-09-14
+ * @date 2024-02-15
  * */
 
 #include "nntile/kernel/transpose/cuda.hh"
@@ -22,11 +22,23 @@ namespace kernel
 namespace transpose
 {
 
+//! Size of square tiles, transposed through shared memory
+constexpr int tile_size = 32;
+//! Number of rows of a tile, processed by each row of threads
+constexpr int tile_rows = 8;
+//! Maximal number of blocks in the second dimension of a grid
+constexpr Index max_grid_y = 65535;
+
 template<typename T>
 static __global__
 void cuda_kernel(Index m, Index n, T alpha, const T* src, T* dst)
-//! Transpose buffers on CPU
+//! Transpose buffers on CUDA by tiles in shared memory
 /*! dst[i,j] = alpha * src[j,i]
+ *
+ * Columns of a tile of src are read and columns of a tile of dst are
+ * written by warps, so that both reads and writes are coalesced. The tile
+ * in shared memory has an extra column, so that transposed accesses to it
+ * hit different banks.
  *
  * @param[in] m: Number of rows of src and columns of dst
  * @param[in] n: Number of columns of src and rows of dst
@@ -35,19 +47,41 @@ void cuda_kernel(Index m, Index n, T alpha, const T* src, T* dst)
  * @param[out] dst: Destination of the add operation
  * */
 {
-    Index i = threadIdx.x + blockIdx.x*blockDim.x;
-    Index j = i / m;
-    i = i - j*m;
-    if(i < m and j < n)
+    __shared__ T tile[tile_size][tile_size+1];
+    Index i0 = Index(blockIdx.x) * tile_size;
+    Index ntiles_n = (n+tile_size-1) / tile_size;
+    for(Index jb = blockIdx.y; jb < ntiles_n; jb += gridDim.y)
     {
-        dst[i*n+j] = alpha * src[i+j*m];
+        Index j0 = jb * tile_size;
+        // Read tile of src
+        Index i = i0 + threadIdx.x;
+        for(int k = threadIdx.y; k < tile_size; k += tile_rows)
+        {
+            Index j = j0 + k;
+            if(i < m and j < n)
+            {
+                tile[k][threadIdx.x] = src[i+j*m];
+            }
+        }
+        __syncthreads();
+        // Write transposed tile into dst
+        Index j = j0 + threadIdx.x;
+        for(int k = threadIdx.y; k < tile_size; k += tile_rows)
+        {
+            Index i = i0 + k;
+            if(i < m and j < n)
+            {
+                dst[i*n+j] = alpha * tile[threadIdx.x][k];
+            }
+        }
+        __syncthreads();
     }
 }
 
 template<typename T>
 void cuda(cudaStream_t stream, Index m, Index n, T alpha, const T* src, T* dst)
     noexcept
-//! Transpose buffers on CPU
+//! Transpose buffers on CUDA
 /*! dst[i,j] = alpha * src[j,i]
  *
  * @param[in] m: Number of rows of src and columns of dst
@@ -58,11 +92,91 @@ void cuda(cudaStream_t stream, Index m, Index n, T alpha, const T* src, T* dst)
  * */
 {
     // Both source and destination are Fortran-contiguous
-    dim3 threads(32);
-    dim3 blocks((m*n+threads.x-1)/threads.x);
+    if(m == 0 or n == 0)
+    {
+        return;
+    }
+    Index ntiles_m = (m+tile_size-1) / tile_size;
+    Index ntiles_n = (n+tile_size-1) / tile_size;
+    dim3 threads(tile_size, tile_rows);
+    dim3 blocks(ntiles_m, std::min(ntiles_n, max_grid_y));
     (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, n, alpha, src, dst);
 }
 
+template<typename T>
+static __global__
+void cuda_inplace_kernel(Index n, T alpha, T *data)
+//! Transpose square buffer inplace on CUDA by pairs of tiles
+/*! Each block swaps a pair of tiles, that are symmetric with respect to the
+ * diagonal, through shared memory. Blocks below the diagonal do nothing.
+ * */
+{
+    __shared__ T upper[tile_size][tile_size+1], lower[tile_size][tile_size+1];
+    Index ntiles = (n+tile_size-1) / tile_size;
+    for(Index jb = blockIdx.y; jb < ntiles; jb += gridDim.y)
+    {
+        Index ib = blockIdx.x;
+        if(ib > jb)
+        {
+            continue;
+        }
+        Index i0 = ib * tile_size, j0 = jb * tile_size;
+        // Read both tiles, they coincide for a diagonal block
+        for(int k = threadIdx.y; k < tile_size; k += tile_rows)
+        {
+            Index i = i0 + threadIdx.x, j = j0 + k;
+            if(i < n and j < n)
+            {
+                upper[k][threadIdx.x] = data[i+j*n];
+            }
+            i = j0 + threadIdx.x;
+            j = i0 + k;
+            if(i < n and j < n)
+            {
+                lower[k][threadIdx.x] = data[i+j*n];
+            }
+        }
+        __syncthreads();
+        // Write transposed tiles into swapped places
+        for(int k = threadIdx.y; k < tile_size; k += tile_rows)
+        {
+            Index i = i0 + threadIdx.x, j = j0 + k;
+            if(i < n and j < n)
+            {
+                data[i+j*n] = alpha * lower[threadIdx.x][k];
+            }
+            i = j0 + threadIdx.x;
+            j = i0 + k;
+            if(i < n and j < n)
+            {
+                data[i+j*n] = alpha * upper[threadIdx.x][k];
+            }
+        }
+        __syncthreads();
+    }
+}
+
+template<typename T>
+void cuda_inplace(cudaStream_t stream, Index n, T alpha, T *data)
+    noexcept
+//! Transpose square buffer inplace on CUDA
+/*! data[i,j] = alpha * data[j,i]
+ *
+ * @param[in] n: Number of rows and columns of data
+ * @param[in] alpha: Scalar multiplier
+ * @param[inout] data: Square buffer
+ * */
+{
+    if(n == 0)
+    {
+        return;
+    }
+    Index ntiles = (n+tile_size-1) / tile_size;
+    dim3 threads(tile_size, tile_rows);
+    dim3 blocks(ntiles, std::min(ntiles, max_grid_y));
+    (cuda_inplace_kernel<T>)<<<blocks, threads, 0, stream>>>(n, alpha, data);
+}
+
 // Explicit instantiation
 template
 void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, fp32_t alpha,
@@ -74,6 +188,16 @@ void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, fp64_t alpha,
         const fp64_t* src, fp64_t* dst)
     noexcept;
 
+template
+void cuda_inplace<fp32_t>(cudaStream_t stream, Index n, fp32_t alpha,
+        fp32_t *data)
+    noexcept;
+
+template
+void cuda_inplace<fp64_t>(cudaStream_t stream, Index n, fp64_t alpha,
+        fp64_t *data)
+    noexcept;
+
 } // namespace tranpose
 } // namespace kernel
 } // namespace nntile
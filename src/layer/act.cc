@@ -0,0 +1,99 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/layer/act.cc
+ * Elementwise activation layer
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/layer/act.hh"
+#include "nntile/tensor/copy.hh"
+#include "nntile/tensor/gelu.hh"
+#include "nntile/tensor/gelu_backward.hh"
+#include "nntile/tensor/gelutanh.hh"
+#include "nntile/tensor/gelutanh_backward.hh"
+#include "nntile/tensor/relu_forward.hh"
+#include "nntile/tensor/relu_backward.hh"
+
+namespace nntile
+{
+namespace layer
+{
+
+template<typename T>
+Act<T>::Act(const Moments<T> &x_, const Moments<T> &y_,
+        const std::string &funcname):
+    x(x_), y(y_)
+{
+    if(funcname == "relu")
+    {
+        func = ReLU;
+    }
+    else if(funcname == "gelu")
+    {
+        func = GeLU;
+    }
+    else if(funcname == "gelutanh")
+    {
+        func = GeLUTanh;
+    }
+    else
+    {
+        throw std::runtime_error("Unsupported activation " + funcname);
+    }
+}
+
+template<typename T>
+void Act<T>::forward_async() const
+{
+    switch(func)
+    {
+        case ReLU:
+            tensor::relu_forward_async<T>(x.value, y.value);
+            break;
+        case GeLU:
+            tensor::copy_async<T>(x.value, y.value);
+            tensor::gelu_async<T>(y.value);
+            break;
+        case GeLUTanh:
+            tensor::gelutanh_async<T>(x.value, y.value);
+    }
+    x.value.wont_use();
+    y.value.wont_use();
+}
+
+template<typename T>
+void Act<T>::backward_async() const
+{
+    switch(func)
+    {
+        case ReLU:
+            tensor::relu_backward_async<T>(x.value, y.grad, x.grad);
+            break;
+        case GeLU:
+            tensor::gelu_backward_async<T>(x.value, y.grad, x.grad);
+            break;
+        case GeLUTanh:
+            tensor::gelutanh_backward_async<T>(x.value, y.grad, x.grad);
+    }
+    x.value.wont_use();
+    x.grad.wont_use();
+    y.grad.wont_use();
+}
+
+// Explicit instantiations
+template
+class Act<fp32_t>;
+
+template
+class Act<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
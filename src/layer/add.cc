@@ -0,0 +1,60 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/layer/add.cc
+ * Sum of two tensors
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/layer/add.hh"
+#include "nntile/tensor/add.hh"
+#include "nntile/tensor/copy.hh"
+
+namespace nntile
+{
+namespace layer
+{
+
+template<typename T>
+Add<T>::Add(const Moments<T> &x_, const Moments<T> &y_,
+        const Moments<T> &res_):
+    x(x_), y(y_), res(res_)
+{
+}
+
+template<typename T>
+void Add<T>::forward_async() const
+{
+    tensor::copy_async<T>(x.value, res.value);
+    tensor::add_async<T>(1, y.value, 1, res.value);
+    x.value.wont_use();
+    y.value.wont_use();
+    res.value.wont_use();
+}
+
+template<typename T>
+void Add<T>::backward_async() const
+{
+    tensor::add_async<T>(1, res.grad, 1, x.grad);
+    tensor::add_async<T>(1, res.grad, 1, y.grad);
+    x.grad.wont_use();
+    y.grad.wont_use();
+    res.grad.wont_use();
+}
+
+// Explicit instantiations
+template
+class Add<fp32_t>;
+
+template
+class Add<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
@@ -0,0 +1,93 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/layer/add_layer_norm.cc
+ * Residual connection fused with layer normalization
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/layer/add_layer_norm.hh"
+#include "nntile/tensor/add_layer_norm.hh"
+#include "nntile/tensor/add_layer_norm_backward.hh"
+
+namespace nntile
+{
+namespace layer
+{
+
+template<typename T>
+AddLayerNorm<T>::AddLayerNorm(const Moments<T> &x_, const Moments<T> &r_,
+        const Moments<T> &res_, const Moments<T> &y_,
+        const Moments<T> &gamma_, const Moments<T> &beta_,
+        const tensor::Tensor<T> &mean_, const tensor::Tensor<T> &inv_stddev_,
+        Index axis_, T eps_, int redux_):
+    x(x_), r(r_), res(res_), y(y_), gamma(gamma_), beta(beta_), mean(mean_),
+    inv_stddev(inv_stddev_), axis(axis_), eps(eps_), redux(redux_)
+{
+    if(axis < 0 or axis >= x.value.ndim)
+    {
+        throw std::runtime_error("axis < 0 or axis >= x.value.ndim");
+    }
+    // Fused kernels get statistics of a fiber by a single task
+    if(x.value.grid.shape[axis] != 1)
+    {
+        throw std::runtime_error("x.value.grid.shape[axis] != 1");
+    }
+}
+
+template<typename T>
+void AddLayerNorm<T>::forward_async() const
+{
+    // Sum inputs and normalize the sum by a single pass
+    tensor::add_layer_norm_async<T>(eps, x.value, r.value, gamma.value,
+            beta.value, res.value, mean, inv_stddev, y.value, axis);
+    // Statistics are needed only by the backward
+    mean.wont_use();
+    inv_stddev.wont_use();
+    // Inputs, outputs, gamma and beta can be offloaded from GPU
+    x.value.wont_use();
+    r.value.wont_use();
+    gamma.value.wont_use();
+    beta.value.wont_use();
+    res.value.wont_use();
+    y.value.wont_use();
+}
+
+template<typename T>
+void AddLayerNorm<T>::backward_async() const
+{
+    // Gradient of the residual sum is accumulated into both inputs together
+    // with the gradient through the normalization
+    tensor::add_layer_norm_backward_async<T>(res.value, y.grad, gamma.value,
+            mean, inv_stddev, res.grad, x.grad, r.grad, gamma.grad,
+            beta.grad, axis, redux);
+    // mean and inv_stddev can be deleted
+    mean.invalidate_submit();
+    inv_stddev.invalidate_submit();
+    // All the other tensors can be offloaded from GPU
+    res.value.wont_use();
+    y.grad.wont_use();
+    gamma.value.wont_use();
+    res.grad.wont_use();
+    x.grad.wont_use();
+    r.grad.wont_use();
+    gamma.grad.wont_use();
+    beta.grad.wont_use();
+}
+
+// Explicit instantiations
+template
+class AddLayerNorm<fp32_t>;
+
+template
+class AddLayerNorm<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
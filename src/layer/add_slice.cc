@@ -0,0 +1,66 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/layer/add_slice.cc
+ * Sum of a tensor and a broadcasted slice
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/layer/add_slice.hh"
+#include "nntile/tensor/add.hh"
+#include "nntile/tensor/add_slice.hh"
+#include "nntile/tensor/copy.hh"
+#include "nntile/tensor/sum_slice.hh"
+
+namespace nntile
+{
+namespace layer
+{
+
+template<typename T>
+AddSlice<T>::AddSlice(const Moments<T> &x_, const Moments<T> &y_,
+        const Moments<T> &u_, Index axis_, int redux_):
+    x(x_), y(y_), u(u_), axis(axis_), redux(redux_)
+{
+    if(y.value.ndim+1 != x.value.ndim)
+    {
+        throw std::runtime_error("y.value.ndim+1 != x.value.ndim");
+    }
+}
+
+template<typename T>
+void AddSlice<T>::forward_async() const
+{
+    tensor::copy_async<T>(x.value, u.value);
+    tensor::add_slice_async<T>(1, y.value, 1, u.value, axis);
+    x.value.wont_use();
+    y.value.wont_use();
+    u.value.wont_use();
+}
+
+template<typename T>
+void AddSlice<T>::backward_async() const
+{
+    tensor::add_async<T>(1, u.grad, 1, x.grad);
+    tensor::sum_slice_async<T>(1, u.grad, 1, y.grad, axis, redux);
+    x.grad.wont_use();
+    y.grad.wont_use();
+    u.grad.wont_use();
+}
+
+// Explicit instantiations
+template
+class AddSlice<fp32_t>;
+
+template
+class AddSlice<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
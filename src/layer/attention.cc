@@ -0,0 +1,279 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/layer/attention.cc
+ * Multi-head attention layer
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/layer/attention.hh"
+#include "nntile/starpu/scheduler.hh"
+#include "nntile/tensor/add_fiber.hh"
+#include "nntile/tensor/add_slice.hh"
+#include "nntile/tensor/clear.hh"
+#include "nntile/tensor/gemm.hh"
+#include "nntile/tensor/mask_scalar.hh"
+#include "nntile/tensor/maxsumexp.hh"
+#include "nntile/tensor/prod.hh"
+#include "nntile/tensor/softmax_inplace.hh"
+#include "nntile/tensor/sum_fiber.hh"
+#include "nntile/tensor/sumprod_slice.hh"
+#include "nntile/tensor/transpose.hh"
+#include <cmath>
+#include <limits>
+
+namespace nntile
+{
+namespace layer
+{
+
+namespace
+{
+
+constexpr TransOp opN(TransOp::NoTrans), opT(TransOp::Trans);
+
+// Queries, keys or values of all the heads
+template<typename T>
+void project_async(const Moments<T> &x, const Moments<T> &w,
+        const Moments<T> &proj_transposed, const Moments<T> &proj,
+        const std::optional<Moments<T>> &bias, int redux)
+{
+    // gemm (n_head, head_size, n_emb) by (n_emb, n_seq, n_batch) into
+    // (n_head, head_size, n_seq, n_batch)
+    tensor::gemm_async<T, T>(1, opN, w.value, opN, x.value, 0,
+            proj_transposed.value, 1, 0, redux);
+    // Rotate axes into (head_size, n_seq, n_batch, n_head)
+    tensor::transpose_async<T>(1, proj_transposed.value, proj.value, 1);
+    x.value.wont_use();
+    proj_transposed.value.invalidate_submit();
+    w.value.wont_use();
+    if(bias)
+    {
+        // batched add_fiber (head_size, batch=n_head) into
+        // (head_size, n_seq, n_batch, batch=n_head)
+        tensor::add_fiber_async<T>(1, bias->value, 1, proj.value, 0, 1);
+        bias->value.wont_use();
+    }
+}
+
+// Backward of project_async
+template<typename T>
+void project_backward_async(const Moments<T> &x, const Moments<T> &w,
+        const Moments<T> &proj_transposed, const Moments<T> &proj,
+        const std::optional<Moments<T>> &bias, int redux)
+{
+    // Gradients over W and bias are off the critical path
+    int background = starpu::scheduler::priority_background_get();
+    if(bias)
+    {
+        starpu::scheduler::PriorityScope scope(background);
+        tensor::sum_fiber_async<T>(1, proj.grad, 1, bias->grad, 0, 1, redux);
+        bias->grad.wont_use();
+    }
+    // Rotate axes (head_size, n_seq, n_batch, n_head) into
+    // (n_head, head_size, n_seq, n_batch)
+    tensor::transpose_async<T>(1, proj.grad, proj_transposed.grad, 3);
+    proj.grad.invalidate_submit();
+    // dX += einsum('jkl,jkmn->lmn', W, dProj_transposed)
+    tensor::gemm_async<T, T>(1, opT, w.value, opN, proj_transposed.grad, 1,
+            x.grad, 2, 0, redux);
+    w.value.wont_use();
+    x.grad.wont_use();
+    // dW += einsum('jkmn,lmn->jkl', dProj_transposed, X)
+    {
+        starpu::scheduler::PriorityScope scope(background);
+        tensor::gemm_async<T, T>(1, opN, proj_transposed.grad, opT, x.value,
+                1, w.grad, 2, 0, redux);
+        w.grad.wont_use();
+    }
+    x.value.wont_use();
+    proj_transposed.grad.invalidate_submit();
+}
+
+} // namespace
+
+template<typename T>
+Attention<T>::Attention(const Moments<T> &x_q_, const Moments<T> &x_k_,
+        const Moments<T> &x_v_, const Moments<T> &y_,
+        const Moments<T> &w_q_, const Moments<T> &w_k_,
+        const Moments<T> &w_v_, const Moments<T> &w_,
+        const Moments<T> &q_transposed_, const Moments<T> &q_,
+        const Moments<T> &k_transposed_, const Moments<T> &k_,
+        const Moments<T> &v_transposed_, const Moments<T> &v_,
+        const Moments<T> &a_, const tensor::Tensor<T> &a_maxsumexp_,
+        const tensor::Tensor<T> &a_sumprod_slice_, const Moments<T> &b_,
+        const Moments<T> &b_transposed_,
+        const std::optional<Moments<T>> &in_proj_bias_q_,
+        const std::optional<Moments<T>> &in_proj_bias_k_,
+        const std::optional<Moments<T>> &in_proj_bias_v_,
+        const std::optional<Moments<T>> &out_proj_bias_,
+        const std::optional<tensor::Tensor<bool_t>> &mask_, int redux_):
+    x_q(x_q_), x_k(x_k_), x_v(x_v_), y(y_), w_q(w_q_), w_k(w_k_),
+    w_v(w_v_), w(w_), q_transposed(q_transposed_), q(q_),
+    k_transposed(k_transposed_), k(k_), v_transposed(v_transposed_), v(v_),
+    a(a_), b(b_), b_transposed(b_transposed_), a_maxsumexp(a_maxsumexp_),
+    a_sumprod_slice(a_sumprod_slice_), in_proj_bias_q(in_proj_bias_q_),
+    in_proj_bias_k(in_proj_bias_k_), in_proj_bias_v(in_proj_bias_v_),
+    out_proj_bias(out_proj_bias_), mask(mask_), redux(redux_)
+{
+    if(q.value.ndim != 4)
+    {
+        throw std::runtime_error("q.value.ndim != 4");
+    }
+    if(a.value.ndim != 4)
+    {
+        throw std::runtime_error("a.value.ndim != 4");
+    }
+    if(mask and mask->ndim > a.value.ndim)
+    {
+        throw std::runtime_error("mask->ndim > a.value.ndim");
+    }
+    head_size = q.value.shape[0];
+}
+
+template<typename T>
+void Attention<T>::forward_async() const
+{
+    project_async<T>(x_q, w_q, q_transposed, q, in_proj_bias_q, redux);
+    project_async<T>(x_k, w_k, k_transposed, k, in_proj_bias_k, redux);
+    project_async<T>(x_v, w_v, v_transposed, v, in_proj_bias_v, redux);
+    attend_async();
+    // Rotate axes (head_size, n_seq, n_batch, n_head) into
+    // (n_head, head_size, n_seq, n_batch)
+    tensor::transpose_async<T>(1, b.value, b_transposed.value, 3);
+    // Y = einsum('jkl,klmn->jmn', W, B_transposed)
+    tensor::gemm_async<T, T>(1, opN, w.value, opN, b_transposed.value, 0,
+            y.value, 2, 0, redux);
+    w.value.wont_use();
+    if(keep_b)
+    {
+        b.value.wont_use();
+    }
+    else
+    {
+        b.value.invalidate_submit();
+    }
+    b_transposed.value.wont_use();
+    if(out_proj_bias)
+    {
+        tensor::add_fiber_async<T>(1, out_proj_bias->value, 1, y.value, 0, 0);
+        out_proj_bias->value.wont_use();
+    }
+    y.value.wont_use();
+}
+
+template<typename T>
+void Attention<T>::backward_async() const
+{
+    // Gradients over parameters are off the critical path
+    {
+        starpu::scheduler::PriorityScope scope(
+                starpu::scheduler::priority_background_get());
+        if(out_proj_bias)
+        {
+            tensor::sum_fiber_async<T>(1, y.grad, 1, out_proj_bias->grad, 0,
+                    0, redux);
+            out_proj_bias->grad.wont_use();
+        }
+        // dW += einsum('jmn,klmn->jkl', dY, B_transposed)
+        tensor::gemm_async<T, T>(1, opN, y.grad, opT, b_transposed.value, 1,
+                w.grad, 2, 0, redux);
+        b_transposed.value.invalidate_submit();
+        w.grad.wont_use();
+    }
+    // dB_transposed = einsum('jkl,jmn->klmn', W, dY)
+    tensor::gemm_async<T, T>(1, opT, w.value, opN, y.grad, 0,
+            b_transposed.grad, 1, 0, redux);
+    w.value.wont_use();
+    y.grad.wont_use();
+    tensor::transpose_async<T>(1, b_transposed.grad, b.grad, 1);
+    b_transposed.grad.invalidate_submit();
+    backward_attend_async();
+    project_backward_async<T>(x_v, w_v, v_transposed, v, in_proj_bias_v,
+            redux);
+    project_backward_async<T>(x_k, w_k, k_transposed, k, in_proj_bias_k,
+            redux);
+    project_backward_async<T>(x_q, w_q, q_transposed, q, in_proj_bias_q,
+            redux);
+}
+
+template<typename T>
+void Attention<T>::attend_async() const
+{
+    T scale = T(1) / std::sqrt(T(head_size));
+    // A = 1.0/sqrt(head_size) * einsum('jklb,jmlb->kmlb', K, Q)
+    tensor::gemm_async<T, T>(scale, opT, k.value, opN, q.value, 0, a.value,
+            1, 2, redux);
+    tensor::clear_async<T>(a_maxsumexp);
+    q.value.wont_use();
+    k.value.wont_use();
+    // A = softmax(A, axis=0) over unmasked elements
+    if(mask)
+    {
+        tensor::mask_scalar_async<T>(*mask,
+                -std::numeric_limits<T>::infinity(), a.value,
+                a.value.ndim-mask->ndim);
+        mask->wont_use();
+    }
+    tensor::maxsumexp_async<T>(a.value, a_maxsumexp, 0, redux);
+    tensor::softmax_inplace_async<T>(a_maxsumexp, 1, a.value, 0);
+    a_maxsumexp.invalidate_submit();
+    // B = einsum('jklb,kmlb->jmlb', V, A)
+    tensor::gemm_async<T, T>(1, opN, v.value, opN, a.value, 0, b.value, 1, 2,
+            redux);
+    v.value.wont_use();
+    a.value.wont_use();
+}
+
+template<typename T>
+void Attention<T>::backward_attend_async() const
+{
+    T scale = T(1) / std::sqrt(T(head_size));
+    // dA = einsum('jklb,jmlb->kmlb', V, dB)
+    tensor::gemm_async<T, T>(1, opT, v.value, opN, b.grad, 0, a.grad, 1, 2,
+            redux);
+    v.value.invalidate_submit();
+    // dV = einsum('jmlb,kmlb->jklb', dB, A)
+    tensor::gemm_async<T, T>(1, opN, b.grad, opT, a.value, 0, v.grad, 1, 2,
+            redux);
+    b.grad.invalidate_submit();
+    // Backward for A = softmax(A, axis=0)
+    tensor::sumprod_slice_async<T>(1, a.value, a.grad, 0, a_sumprod_slice, 0,
+            redux);
+    tensor::add_slice_async<T>(-1, a_sumprod_slice, 1, a.grad, 0);
+    a_sumprod_slice.invalidate_submit();
+    tensor::prod_async<T>(a.value, a.grad);
+    a.value.invalidate_submit();
+    if(mask)
+    {
+        tensor::mask_scalar_async<T>(*mask, 0, a.grad,
+                a.grad.ndim-mask->ndim);
+        mask->wont_use();
+    }
+    // dK = 1.0/sqrt(head_size) * einsum('jmlb,kmlb->jklb', Q, dA)
+    tensor::gemm_async<T, T>(scale, opN, q.value, opT, a.grad, 0, k.grad, 1,
+            2, redux);
+    q.value.invalidate_submit();
+    // dQ = 1.0/sqrt(head_size) * einsum('jklb,kmlb->jmlb', K, dA)
+    tensor::gemm_async<T, T>(scale, opN, k.value, opN, a.grad, 0, q.grad, 1,
+            2, redux);
+    k.value.invalidate_submit();
+    a.grad.invalidate_submit();
+}
+
+// Explicit instantiations
+template
+class Attention<fp32_t>;
+
+template
+class Attention<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
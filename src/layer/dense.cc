@@ -0,0 +1,158 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/layer/dense.cc
+ * Fully connected layer with an optional bias
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/layer/dense.hh"
+#include "nntile/starpu/scheduler.hh"
+#include "nntile/tensor/add_fiber.hh"
+#include "nntile/tensor/gemm.hh"
+#include "nntile/tensor/sum_fiber.hh"
+
+namespace nntile
+{
+namespace layer
+{
+
+template<typename T>
+Dense<T>::Dense(char side_, const TransOp &trans_x_, const Moments<T> &x_,
+        const Moments<T> &y_, const Moments<T> &w_,
+        const std::optional<Moments<T>> &b_, Index ndim_,
+        bool x_grad_required_, int redux_, bool w_grad_required_,
+        bool b_grad_required_):
+    side(side_), trans_x(trans_x_), x(x_), y(y_), w(w_), b(b_),
+    ndim(ndim_), x_grad_required(x_grad_required_), redux(redux_),
+    w_grad_required(w_grad_required_), b_grad_required(b_grad_required_)
+{
+    if(side != 'L' and side != 'R')
+    {
+        throw std::runtime_error("side != 'L' and side != 'R'");
+    }
+    if(ndim <= 0)
+    {
+        throw std::runtime_error("ndim <= 0");
+    }
+}
+
+template<typename T>
+void Dense<T>::forward_async() const
+{
+    constexpr TransOp opN(TransOp::NoTrans);
+    if(side == 'L')
+    {
+        // Y = einsum('ij,jk->ik', op(X), W)
+        tensor::gemm_async<T, T>(1, trans_x, x.value, opN, w.value, 0,
+                y.value, ndim, 0, redux);
+        if(b)
+        {
+            tensor::add_fiber_async<T>(1, b->value, 1, y.value,
+                    y.value.ndim-1, 0);
+        }
+    }
+    else
+    {
+        // Y = einsum('ij,jk->ik', W, op(X))
+        tensor::gemm_async<T, T>(1, opN, w.value, trans_x, x.value, 0,
+                y.value, ndim, 0, redux);
+        if(b)
+        {
+            tensor::add_fiber_async<T>(1, b->value, 1, y.value, 0, 0);
+        }
+    }
+    w.value.wont_use();
+    x.value.wont_use();
+    y.value.wont_use();
+    if(b)
+    {
+        b->value.wont_use();
+    }
+}
+
+template<typename T>
+void Dense<T>::backward_async() const
+{
+    constexpr TransOp opN(TransOp::NoTrans), opT(TransOp::Trans);
+    bool notrans_x = trans_x.value == TransOp::NoTrans;
+    // Gradients over W and bias are off the critical path, so they give way
+    // to the gradient over X
+    Index gemm_ndim = x.value.ndim - ndim;
+    {
+        starpu::scheduler::PriorityScope background(
+                starpu::scheduler::priority_background_get());
+        if(w_grad_required and side == 'L')
+        {
+            // dW += einsum('ij,ik->jk', op(X), dY)
+            tensor::gemm_async<T, T>(1, notrans_x ? opT : opN, x.value, opN,
+                    y.grad, 1, w.grad, gemm_ndim, 0, redux);
+            w.grad.wont_use();
+        }
+        else if(w_grad_required)
+        {
+            // dW += einsum('ik,jk->ij', dY, op(X))
+            tensor::gemm_async<T, T>(1, opN, y.grad, notrans_x ? opT : opN,
+                    x.value, 1, w.grad, gemm_ndim, 0, redux);
+            w.grad.wont_use();
+        }
+        if(b and b_grad_required)
+        {
+            Index b_axis = side == 'L' ? y.value.ndim-1 : 0;
+            tensor::sum_fiber_async<T>(1, y.grad, 1, b->grad, b_axis, 0,
+                    redux);
+            b->grad.wont_use();
+        }
+    }
+    // Gradient over X
+    if(x_grad_required)
+    {
+        gemm_ndim = w.value.ndim - ndim;
+        if(side == 'L' and notrans_x)
+        {
+            // dX += einsum('ik,jk->ij', dY, W)
+            tensor::gemm_async<T, T>(1, opN, y.grad, opT, w.value, 1, x.grad,
+                    gemm_ndim, 0, redux);
+        }
+        else if(side == 'L')
+        {
+            // dX^T += einsum('ik,jk->ij', W, dY)
+            tensor::gemm_async<T, T>(1, opN, w.value, opT, y.grad, 1, x.grad,
+                    gemm_ndim, 0, redux);
+        }
+        else if(notrans_x)
+        {
+            // dX += einsum('ij,ik->jk', W, dY)
+            tensor::gemm_async<T, T>(1, opT, w.value, opN, y.grad, 1, x.grad,
+                    gemm_ndim, 0, redux);
+        }
+        else
+        {
+            // dX^T += einsum('ij,ik->jk', dY, W)
+            tensor::gemm_async<T, T>(1, opT, y.grad, opN, w.value, 1, x.grad,
+                    gemm_ndim, 0, redux);
+        }
+        x.grad.wont_use();
+    }
+    x.value.wont_use();
+    y.value.wont_use();
+    y.grad.wont_use();
+    w.value.wont_use();
+}
+
+// Explicit instantiations
+template
+class Dense<fp32_t>;
+
+template
+class Dense<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
@@ -0,0 +1,77 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/layer/embedding.cc
+ * Embedding layer
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/layer/embedding.hh"
+#include "nntile/tensor/clear.hh"
+#include "nntile/tensor/embedding.hh"
+#include "nntile/tensor/embedding_backward.hh"
+#include "nntile/tensor/embedding_rows.hh"
+
+namespace nntile
+{
+namespace layer
+{
+
+template<typename T>
+Embedding<T>::Embedding(const tensor::Tensor<Index> &x_,
+        const Moments<T> &y_, const Moments<T> &w_, Index axis_,
+        const std::optional<tensor::Tensor<bool_t>> &rows_):
+    x(x_), y(y_), w(w_), axis(axis_), rows(rows_)
+{
+    if(axis < 0 or axis >= y.value.ndim)
+    {
+        throw std::runtime_error("axis < 0 or axis >= y.value.ndim");
+    }
+    if(w.value.ndim != 2)
+    {
+        throw std::runtime_error("w.value.ndim != 2");
+    }
+}
+
+template<typename T>
+void Embedding<T>::forward_async() const
+{
+    tensor::clear_async<T>(y.value);
+    tensor::embedding_async<T>(x, w.value, y.value, axis);
+    x.wont_use();
+    w.value.wont_use();
+    y.value.wont_use();
+}
+
+template<typename T>
+void Embedding<T>::backward_async() const
+{
+    // Reduction is not used, as each embedding_backward is a sparse
+    // operation, while reduction plays with a full dense vocabulary
+    tensor::embedding_backward_async<T>(x, y.grad, w.grad, axis, 0);
+    if(rows)
+    {
+        tensor::embedding_rows_async(x, *rows);
+        rows->wont_use();
+    }
+    x.wont_use();
+    y.grad.wont_use();
+    w.grad.wont_use();
+}
+
+// Explicit instantiations
+template
+class Embedding<fp32_t>;
+
+template
+class Embedding<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
@@ -0,0 +1,126 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/layer/flash_attention.cc
+ * Multi-head attention layer with flash-like softmax
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/layer/flash_attention.hh"
+#include "nntile/tensor/clear.hh"
+#include "nntile/tensor/flash_attention.hh"
+#include "nntile/tensor/flash_attention_backward.hh"
+#include "nntile/tensor/flash_maxsumexp.hh"
+#include "nntile/tensor/flash_softmax_gemm.hh"
+#include "nntile/tensor/flash_softmax_gemm_backward.hh"
+
+namespace nntile
+{
+namespace layer
+{
+
+template<typename T>
+FlashAttention<T>::FlashAttention(const Moments<T> &x_q_,
+        const Moments<T> &x_k_, const Moments<T> &x_v_, const Moments<T> &y_,
+        const Moments<T> &w_q_, const Moments<T> &w_k_,
+        const Moments<T> &w_v_, const Moments<T> &w_,
+        const Moments<T> &q_transposed_, const Moments<T> &q_,
+        const Moments<T> &k_transposed_, const Moments<T> &k_,
+        const Moments<T> &v_transposed_, const Moments<T> &v_,
+        const Moments<T> &a_, const tensor::Tensor<T> &a_maxsumexp_,
+        const tensor::Tensor<T> &a_sumprod_slice_, const Moments<T> &b_,
+        const Moments<T> &b_transposed_,
+        const std::optional<Moments<T>> &in_proj_bias_q_,
+        const std::optional<Moments<T>> &in_proj_bias_k_,
+        const std::optional<Moments<T>> &in_proj_bias_v_,
+        const std::optional<Moments<T>> &out_proj_bias_,
+        const tensor::Tensor<bool_t> &mask_, bool fused_, int redux_):
+    Attention<T>(x_q_, x_k_, x_v_, y_, w_q_, w_k_, w_v_, w_, q_transposed_,
+            q_, k_transposed_, k_, v_transposed_, v_, a_, a_maxsumexp_,
+            a_sumprod_slice_, b_, b_transposed_, in_proj_bias_q_,
+            in_proj_bias_k_, in_proj_bias_v_, out_proj_bias_, mask_, redux_),
+    fused(fused_)
+{
+    // Fused backward recomputes attention weights out of B
+    this->keep_b = fused;
+}
+
+template<typename T>
+void FlashAttention<T>::attend_async() const
+{
+    const auto &q = this->q, &k = this->k, &v = this->v, &a = this->a,
+        &b = this->b;
+    const auto &mask = *this->mask;
+    const auto &a_maxsumexp = this->a_maxsumexp;
+    if(fused)
+    {
+        // Single pass over K and V with online softmax, that also
+        // produces A_maxsumexp for the backward
+        tensor::flash_attention_async<T>(q.value, k.value, v.value, mask,
+                a_maxsumexp, b.value, mask_layout);
+        q.value.wont_use();
+        k.value.wont_use();
+        a_maxsumexp.wont_use();
+    }
+    else
+    {
+        tensor::clear_async<T>(a_maxsumexp);
+        tensor::flash_maxsumexp_async<T>(q.value, k.value, mask,
+                a_maxsumexp, a.value, this->redux, 0, mask_layout);
+        q.value.wont_use();
+        k.value.wont_use();
+        tensor::flash_softmax_gemm_async<T>(q.value, k.value, v.value, mask,
+                a_maxsumexp, b.value, a.value, this->redux, 0, T(0), 0,
+                mask_layout);
+        // A_maxsumexp is reused by backward, so it can only be offloaded
+        a_maxsumexp.wont_use();
+    }
+    v.value.wont_use();
+    a.value.wont_use();
+}
+
+template<typename T>
+void FlashAttention<T>::backward_attend_async() const
+{
+    const auto &q = this->q, &k = this->k, &v = this->v, &a = this->a,
+        &b = this->b;
+    const auto &mask = *this->mask;
+    if(fused)
+    {
+        // Single-pass fused backward recomputes attention weights
+        tensor::flash_attention_backward_async<T>(q.value, q.grad, k.value,
+                k.grad, v.value, v.grad, mask, this->a_maxsumexp, b.value,
+                b.grad, this->a_sumprod_slice, this->redux, mask_layout);
+        b.value.invalidate_submit();
+    }
+    else
+    {
+        tensor::clear_async<T>(this->a_sumprod_slice);
+        tensor::flash_softmax_gemm_backward_async<T>(q.value, q.grad,
+                k.value, k.grad, v.value, v.grad, mask, this->a_maxsumexp,
+                b.grad, a.value, a.grad, this->a_sumprod_slice, this->redux,
+                0, T(0), 0, mask_layout);
+    }
+    v.value.invalidate_submit();
+    b.grad.invalidate_submit();
+    q.value.invalidate_submit();
+    k.value.invalidate_submit();
+    a.grad.invalidate_submit();
+}
+
+// Explicit instantiations
+template
+class FlashAttention<fp32_t>;
+
+template
+class FlashAttention<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
@@ -0,0 +1,86 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/layer/layer_norm.cc
+ * Layer normalization by fused kernels
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/layer/layer_norm.hh"
+#include "nntile/tensor/layer_norm.hh"
+#include "nntile/tensor/layer_norm_backward.hh"
+
+namespace nntile
+{
+namespace layer
+{
+
+template<typename T>
+LayerNorm<T>::LayerNorm(const Moments<T> &x_, const Moments<T> &y_,
+        const Moments<T> &gamma_, const Moments<T> &beta_,
+        const tensor::Tensor<T> &mean_, const tensor::Tensor<T> &inv_stddev_,
+        Index axis_, T eps_, int redux_):
+    x(x_), y(y_), gamma(gamma_), beta(beta_), mean(mean_),
+    inv_stddev(inv_stddev_), axis(axis_), eps(eps_), redux(redux_)
+{
+    if(axis < 0 or axis >= x.value.ndim)
+    {
+        throw std::runtime_error("axis < 0 or axis >= x.value.ndim");
+    }
+    // Fused kernels get statistics of a fiber by a single task
+    if(x.value.grid.shape[axis] != 1)
+    {
+        throw std::runtime_error("x.value.grid.shape[axis] != 1");
+    }
+}
+
+template<typename T>
+void LayerNorm<T>::forward_async() const
+{
+    // Normalize, scale and shift input by a single pass
+    tensor::layer_norm_async<T>(eps, x.value, gamma.value, beta.value, mean,
+            inv_stddev, y.value, axis);
+    // Statistics are needed only by the backward
+    mean.wont_use();
+    inv_stddev.wont_use();
+    // X, gamma, beta and Y can be offloaded from GPU
+    x.value.wont_use();
+    gamma.value.wont_use();
+    beta.value.wont_use();
+    y.value.wont_use();
+}
+
+template<typename T>
+void LayerNorm<T>::backward_async() const
+{
+    // Normalized input is recomputed from X, mean and inv_stddev
+    tensor::layer_norm_backward_async<T>(x.value, y.grad, gamma.value, mean,
+            inv_stddev, x.grad, gamma.grad, beta.grad, axis, redux);
+    // mean and inv_stddev can be deleted
+    mean.invalidate_submit();
+    inv_stddev.invalidate_submit();
+    // X, dY, gamma and all the gradients can be offloaded from GPU
+    x.value.wont_use();
+    y.grad.wont_use();
+    gamma.value.wont_use();
+    x.grad.wont_use();
+    gamma.grad.wont_use();
+    beta.grad.wont_use();
+}
+
+// Explicit instantiations
+template
+class LayerNorm<fp32_t>;
+
+template
+class LayerNorm<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
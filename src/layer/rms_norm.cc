@@ -0,0 +1,81 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/layer/rms_norm.cc
+ * Root mean square layer normalization
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/layer/rms_norm.hh"
+#include "nntile/tensor/rms_norm.hh"
+#include "nntile/tensor/rms_norm_backward.hh"
+
+namespace nntile
+{
+namespace layer
+{
+
+template<typename T>
+RMSNorm<T>::RMSNorm(const Moments<T> &x_, const Moments<T> &y_,
+        const Moments<T> &gamma_, const tensor::Tensor<T> &inv_rms_,
+        Index axis_, T eps_, int redux_):
+    x(x_), y(y_), gamma(gamma_), inv_rms(inv_rms_), axis(axis_), eps(eps_),
+    redux(redux_)
+{
+    if(axis < 0 or axis >= x.value.ndim)
+    {
+        throw std::runtime_error("axis < 0 or axis >= x.value.ndim");
+    }
+    // Kernels get root mean square of a fiber by a single task
+    if(x.value.grid.shape[axis] != 1)
+    {
+        throw std::runtime_error("x.value.grid.shape[axis] != 1");
+    }
+}
+
+template<typename T>
+void RMSNorm<T>::forward_async() const
+{
+    // Normalize and scale input by a single task per tile
+    tensor::rms_norm_async<T>(eps, x.value, gamma.value, inv_rms, y.value,
+            axis);
+    // Inverses of root mean squares are needed only by the backward
+    inv_rms.wont_use();
+    // X, gamma and Y can be offloaded from GPU
+    x.value.wont_use();
+    gamma.value.wont_use();
+    y.value.wont_use();
+}
+
+template<typename T>
+void RMSNorm<T>::backward_async() const
+{
+    // Normalized input is recomputed from X and inv_rms
+    tensor::rms_norm_backward_async<T>(x.value, y.grad, gamma.value, inv_rms,
+            x.grad, gamma.grad, axis, redux);
+    // inv_rms can be deleted
+    inv_rms.invalidate_submit();
+    // X, dY, gamma and all the gradients can be offloaded from GPU
+    x.value.wont_use();
+    y.grad.wont_use();
+    gamma.value.wont_use();
+    x.grad.wont_use();
+    gamma.grad.wont_use();
+}
+
+// Explicit instantiations
+template
+class RMSNorm<fp32_t>;
+
+template
+class RMSNorm<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
@@ -0,0 +1,53 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/layer/sequential.cc
+ * Chain of layers, that is submitted by a single call
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/layer/sequential.hh"
+#include "nntile/starpu/scheduler.hh"
+
+namespace nntile
+{
+namespace layer
+{
+
+template<typename T>
+void Sequential<T>::forward_async() const
+{
+    for(const auto &layer: layers)
+    {
+        layer->forward_async();
+    }
+}
+
+template<typename T>
+void Sequential<T>::backward_async(int first_priority) const
+{
+    int priority = starpu::scheduler::priority_get();
+    for(Index i = layers.size()-1; i >= 0; --i)
+    {
+        starpu::scheduler::priority_set(first_priority+i);
+        layers[i]->backward_async();
+    }
+    starpu::scheduler::priority_set(priority);
+}
+
+// Explicit instantiations
+template
+class Sequential<fp32_t>;
+
+template
+class Sequential<fp64_t>;
+
+} // namespace layer
+} // namespace nntile
+
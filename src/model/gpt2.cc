@@ -0,0 +1,298 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/model/gpt2.cc
+ * GPT2 model, that is submitted from C++
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/model/gpt2.hh"
+#include "nntile/layer/add_layer_norm.hh"
+#include "nntile/layer/add_slice.hh"
+#include "nntile/layer/embedding.hh"
+#include "nntile/layer/flash_attention.hh"
+#include "nntile/starpu/scheduler.hh"
+#include "nntile/tensor/clear.hh"
+#include "nntile/tensor/fill.hh"
+
+namespace nntile
+{
+namespace model
+{
+
+namespace
+{
+
+// Tensor, whose tiles are owned by MPI node 0
+template<typename T>
+tensor::Tensor<T> new_tensor(const std::vector<Index> &shape,
+        const std::vector<Index> &basetile, starpu_mpi_tag_t &last_tag)
+{
+    tensor::TensorTraits traits(shape, basetile);
+    std::vector<int> distr(traits.grid.nelems, 0);
+    return tensor::Tensor<T>(traits, distr, last_tag);
+}
+
+// Set every element of local tiles to a function of its global index
+template<typename T, typename F>
+void set_elems(const tensor::Tensor<T> &x, F func)
+{
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < x.grid.nelems; ++i)
+    {
+        auto tile = x.get_tile(i);
+        if(tile.mpi_get_rank() != mpi_rank)
+        {
+            continue;
+        }
+        auto tile_index = x.grid.linear_to_index(i);
+        auto tile_local = tile.acquire(STARPU_W);
+        for(Index j = 0; j < tile.nelems; ++j)
+        {
+            auto index = tile.linear_to_index(j);
+            for(Index k = 0; k < x.ndim; ++k)
+            {
+                index[k] += tile_index[k] * x.basetile_shape[k];
+            }
+            tile_local[j] = func(index);
+        }
+        tile_local.release();
+    }
+}
+
+} // namespace
+
+template<typename T>
+GPT2<T>::GPT2(const GPT2Config &config_, Index seq_len, Index seq_len_tile,
+        Index batch_size, Index batch_size_tile, starpu_mpi_tag_t &last_tag):
+    config(config_),
+    input_ids(new_tensor<Index>({seq_len, batch_size},
+                {seq_len_tile, batch_size_tile}, last_tag)),
+    positional_ids(new_tensor<Index>({seq_len}, {seq_len_tile}, last_tag)),
+    mask(new_tensor<bool_t>({seq_len, seq_len}, {seq_len_tile, seq_len_tile},
+                last_tag))
+{
+    using layer::Moments;
+    const auto &c = config;
+    if(c.embed_dim % c.n_head != 0)
+    {
+        throw std::runtime_error("c.embed_dim % c.n_head != 0");
+    }
+    const Index E = c.embed_dim, Et = c.embed_dim_tile, S = seq_len,
+          St = seq_len_tile, B = batch_size, Bt = batch_size_tile,
+          H = c.n_head, Ht = c.n_head_tile, hs = E / H, I = c.inner_dim,
+          It = c.inner_dim_tile, V = c.vocab_size;
+    const T eps = c.layer_norm_epsilon;
+    auto new_moments = [&last_tag](const std::vector<Index> &shape,
+            const std::vector<Index> &basetile)
+    {
+        auto value = new_tensor<T>(shape, basetile, last_tag);
+        auto grad = new_tensor<T>(shape, basetile, last_tag);
+        return Moments<T>{value, grad};
+    };
+    auto new_param = [&](const std::vector<Index> &shape,
+            const std::vector<Index> &basetile)
+    {
+        params.push_back(new_moments(shape, basetile));
+        return params.back();
+    };
+    auto new_activation = [&](const std::vector<Index> &shape,
+            const std::vector<Index> &basetile)
+    {
+        activations.push_back(new_moments(shape, basetile));
+        return activations.back();
+    };
+    auto new_tmp = [&](const std::vector<Index> &shape,
+            const std::vector<Index> &basetile)
+    {
+        tmps.push_back(new_tensor<T>(shape, basetile, last_tag));
+        return tmps.back();
+    };
+    auto new_tmp_moments = [&](const std::vector<Index> &shape,
+            const std::vector<Index> &basetile)
+    {
+        auto value = new_tmp(shape, basetile);
+        auto grad = new_tmp(shape, basetile);
+        return Moments<T>{value, grad};
+    };
+    auto append = [this](layer::Module<T> *layer)
+    {
+        layers.append(std::shared_ptr<layer::Module<T>>(layer));
+    };
+    // Layer normalization of the last activation with parameters
+    auto layer_norm = [&]()
+    {
+        auto x = activations.back();
+        auto gamma = new_param({E}, {Et});
+        auto beta = new_param({E}, {Et});
+        tensor::fill_async<T>(1, gamma.value);
+        tensor::clear_async<T>(beta.value);
+        auto mean = new_tmp({S, B}, {St, Bt});
+        auto inv_stddev = new_tmp({S, B}, {St, Bt});
+        auto y = new_activation({E, S, B}, {Et, St, Bt});
+        append(new layer::LayerNorm<T>(x, y, gamma, beta, mean, inv_stddev,
+                    0, eps, c.redux));
+    };
+    // Fully connected layer of the last activation
+    auto dense = [&](Index n, Index n_tile, Index m, Index m_tile,
+            bool bias)
+    {
+        constexpr TransOp opN(TransOp::NoTrans);
+        auto x = activations.back();
+        auto w = new_param({n, m}, {n_tile, m_tile});
+        std::optional<Moments<T>> b;
+        if(bias)
+        {
+            b = new_param({n}, {n_tile});
+        }
+        auto y = new_activation({n, S, B}, {n_tile, St, Bt});
+        append(new layer::Dense<T>('R', opN, x, y, w, b, 1, true, c.redux));
+    };
+    // Token and positional embeddings
+    auto wte_w = new_param({E, V}, {c.vocab_embed_dim_tile, V});
+    auto wte_y = new_activation({E, S, B}, {Et, St, Bt});
+    append(new layer::Embedding<T>(input_ids, wte_y, wte_w, 0));
+    auto wpe_w = new_param({E, c.max_position_embeddings},
+            {c.vocab_embed_dim_tile, c.max_position_embeddings});
+    auto wpe_y = new_activation({E, S}, {Et, St});
+    append(new layer::Embedding<T>(positional_ids, wpe_y, wpe_w, 0));
+    auto embed = new_activation({E, S, B}, {Et, St, Bt});
+    append(new layer::AddSlice<T>(wte_y, wpe_y, embed, 2, c.redux));
+    for(Index i = 0; i < c.num_hidden_layers; ++i)
+    {
+        auto block_input = activations.back();
+        layer_norm();
+        // Self attention with biases
+        auto x = activations.back();
+        auto w_q = new_param({H, hs, E}, {Ht, hs, Et});
+        auto w_k = new_param({H, hs, E}, {Ht, hs, Et});
+        auto w_v = new_param({H, hs, E}, {Ht, hs, Et});
+        auto bias_q = new_param({hs, H}, {hs, Ht});
+        auto bias_k = new_param({hs, H}, {hs, Ht});
+        auto bias_v = new_param({hs, H}, {hs, Ht});
+        auto w = new_param({E, H, hs}, {Et, Ht, hs});
+        auto out_bias = new_param({E}, {Et});
+        auto q_transposed = new_tmp_moments({H, hs, S, B},
+                {Ht, hs, St, Bt});
+        auto q = new_tmp_moments({hs, S, B, H}, {hs, St, Bt, Ht});
+        auto k_transposed = new_tmp_moments({H, hs, S, B},
+                {Ht, hs, St, Bt});
+        auto k = new_tmp_moments({hs, S, B, H}, {hs, St, Bt, Ht});
+        auto v_transposed = new_tmp_moments({H, hs, S, B},
+                {Ht, hs, St, Bt});
+        auto v = new_tmp_moments({hs, S, B, H}, {hs, St, Bt, Ht});
+        auto a = new_tmp_moments({S, S, B, H}, {St, St, Bt, Ht});
+        auto a_maxsumexp = new_tmp({2, S, B, H}, {2, St, Bt, Ht});
+        auto a_sumprod_slice = new_tmp({S, B, H}, {St, Bt, Ht});
+        auto b = new_tmp_moments({hs, S, B, H}, {hs, St, Bt, Ht});
+        auto b_transposed = new_tmp_moments({H, hs, S, B},
+                {Ht, hs, St, Bt});
+        auto y = new_activation({E, S, B}, {Et, St, Bt});
+        if(c.flashattention)
+        {
+            append(new layer::FlashAttention<T>(x, x, x, y, w_q, w_k, w_v, w,
+                        q_transposed, q, k_transposed, k, v_transposed, v,
+                        a, a_maxsumexp, a_sumprod_slice, b, b_transposed,
+                        bias_q, bias_k, bias_v, out_bias, mask,
+                        c.flashattention_fused, c.redux));
+        }
+        else
+        {
+            append(new layer::Attention<T>(x, x, x, y, w_q, w_k, w_v, w,
+                        q_transposed, q, k_transposed, k, v_transposed, v,
+                        a, a_maxsumexp, a_sumprod_slice, b, b_transposed,
+                        bias_q, bias_k, bias_v, out_bias, mask, c.redux));
+        }
+        // Residual connection fused with the following normalization
+        auto attn_res = new_activation({E, S, B}, {Et, St, Bt});
+        auto gamma = new_param({E}, {Et});
+        auto beta = new_param({E}, {Et});
+        tensor::fill_async<T>(1, gamma.value);
+        tensor::clear_async<T>(beta.value);
+        auto mean = new_tmp({S, B}, {St, Bt});
+        auto inv_stddev = new_tmp({S, B}, {St, Bt});
+        auto mlp_x = new_activation({E, S, B}, {Et, St, Bt});
+        append(new layer::AddLayerNorm<T>(block_input, y, attn_res, mlp_x,
+                    gamma, beta, mean, inv_stddev, 0, eps, c.redux));
+        // Feed-forward network
+        dense(I, It, E, Et, true);
+        auto act_x = activations.back();
+        auto act_y = new_activation({I, S, B}, {It, St, Bt});
+        append(new layer::Act<T>(act_x, act_y, c.activation_function));
+        dense(E, Et, I, It, true);
+        auto mlp_y = activations.back();
+        auto mlp_res = new_activation({E, S, B}, {Et, St, Bt});
+        append(new layer::Add<T>(attn_res, mlp_y, mlp_res));
+    }
+    layer_norm();
+    // Logits of all the tokens
+    dense(V, V, E, Et, false);
+    // Positions of tokens and the causal mask
+    set_elems(positional_ids, [](const std::vector<Index> &index)
+            {
+                return index[0];
+            });
+    set_elems(mask, [](const std::vector<Index> &index)
+            {
+                return index[0] <= index[1];
+            });
+}
+
+template<typename T>
+void GPT2<T>::backward_async() const
+{
+    int priority = starpu::scheduler::priority_get();
+    layers.backward_async(priority);
+}
+
+template<typename T>
+void GPT2<T>::clear_gradients_async() const
+{
+    for(const auto &p: params)
+    {
+        tensor::clear_async<T>(p.grad);
+    }
+    for(const auto &x: activations)
+    {
+        tensor::clear_async<T>(x.grad);
+    }
+}
+
+template<typename T>
+void GPT2<T>::unregister()
+{
+    input_ids.unregister();
+    positional_ids.unregister();
+    mask.unregister();
+    for(auto &p: params)
+    {
+        p.value.unregister();
+        p.grad.unregister();
+    }
+    for(auto &x: activations)
+    {
+        x.value.unregister();
+        x.grad.unregister();
+    }
+    for(auto &t: tmps)
+    {
+        t.unregister();
+    }
+}
+
+// Explicit instantiations
+template
+class GPT2<fp32_t>;
+
+template
+class GPT2<fp64_t>;
+
+} // namespace model
+} // namespace nntile
+
@@ -103,19 +103,21 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Handle src, Handle dst)
+void submit(HandleRef src, HandleRef dst)
 //! Insert accumulate_maxsumexp task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
  * throws an std::runtime_error() exception.
  * */
 {
+    fp64_t nflops = 3 * starpu_data_get_size(
+            static_cast<starpu_data_handle_t>(dst)) / sizeof(T);
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             //STARPU_RW|STARPU_COMMUTE, static_cast<starpu_data_handle_t>(dst),
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            // STARPU_FLOPS, nflops,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -126,10 +128,10 @@ void submit(Handle src, Handle dst)
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Handle src, Handle dst);
+void submit<fp32_t>(HandleRef src, HandleRef dst);
 
 template
-void submit<fp64_t>(Handle src, Handle dst);
+void submit<fp64_t>(HandleRef src, HandleRef dst);
 
 } // namespace accumulate_maxsumexp
 } // namespace starpu
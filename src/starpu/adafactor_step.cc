@@ -0,0 +1,196 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/adafactor_step.cc
+ * Fused Adafactor step with StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/adafactor_step.hh"
+#include "nntile/kernel/adafactor_step.hh"
+#include "nntile/kernel/parallel.hh"
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for one step of Adafactor optimizer
+namespace adafactor_step
+{
+
+//! Apply Adafactor step on StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces, factors of columns and their mean are present only
+    // for factored second moments
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *row = interfaces[0]->get_ptr<T>();
+    const T *col = nullptr, *mean = nullptr;
+    int next = 1;
+    if(args->factored)
+    {
+        col = interfaces[1]->get_ptr<T>();
+        mean = interfaces[2]->get_ptr<T>();
+        next = 3;
+    }
+    const T *grad = interfaces[next]->get_ptr<T>();
+    T *p = interfaces[next+1]->get_ptr<T>();
+    // Use all threads of a parallel worker
+    kernel::parallel::Scope threads(starpu_combined_worker_get_size());
+    // Launch kernel
+    kernel::adafactor_step::cpu<T>(args->num_iter, args->m, args->k,
+            args->n, args->beta_2, args->eps, args->lr, args->weight_decay,
+            row, col, mean, grad, p);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Apply Adafactor step on StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces, factors of columns and their mean are present only
+    // for factored second moments
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *row = interfaces[0]->get_ptr<T>();
+    const T *col = nullptr, *mean = nullptr;
+    int next = 1;
+    if(args->factored)
+    {
+        col = interfaces[1]->get_ptr<T>();
+        mean = interfaces[2]->get_ptr<T>();
+        next = 3;
+    }
+    const T *grad = interfaces[next]->get_ptr<T>();
+    T *p = interfaces[next+1]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::adafactor_step::cuda<T>(stream, args->num_iter, args->m,
+            args->k, args->n, args->beta_2, args->eps, args->lr,
+            args->weight_decay, row, col, mean, grad, p);
+}
+#endif // NNTILE_USE_CUDA
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_adafactor_step_fp32",
+            nullptr,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_adafactor_step_fp64",
+            nullptr,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    // CPU implementations may use all threads of parallel workers
+    codelet_fp32.set_parallel();
+    codelet_fp64.set_parallel();
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index num_iter, Index m, Index k, Index n, T beta_2, T eps,
+        T lr, T weight_decay, HandleRef row, HandleRef col, HandleRef mean,
+        HandleRef grad, HandleRef p)
+//! Insert task of a fused Adafactor step
+/*! Second moments are factored if col is not empty, otherwise mean is not
+ * used either.
+ * */
+{
+    // Codelet arguments
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
+    args->num_iter = num_iter;
+    args->m = m;
+    args->k = k;
+    args->n = n;
+    args->beta_2 = beta_2;
+    args->eps = eps;
+    args->lr = lr;
+    args->weight_decay = weight_decay;
+    args->factored = static_cast<starpu_data_handle_t>(col) != nullptr;
+    fp64_t nflops = 8 * m * k * n;
+    // Submit task
+    int ret;
+    if(args->factored)
+    {
+        ret = task_insert(codelet<T>(),
+                STARPU_R, static_cast<starpu_data_handle_t>(row),
+                STARPU_R, static_cast<starpu_data_handle_t>(col),
+                STARPU_R, static_cast<starpu_data_handle_t>(mean),
+                STARPU_R, static_cast<starpu_data_handle_t>(grad),
+                STARPU_RW, static_cast<starpu_data_handle_t>(p),
+                STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+                STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+                STARPU_FLOPS, nflops,
+                0);
+    }
+    else
+    {
+        ret = task_insert(codelet<T>(),
+                STARPU_R, static_cast<starpu_data_handle_t>(row),
+                STARPU_R, static_cast<starpu_data_handle_t>(grad),
+                STARPU_RW, static_cast<starpu_data_handle_t>(p),
+                STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+                STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+                STARPU_FLOPS, nflops,
+                0);
+    }
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in adafactor_step task submission");
+    }
+}
+
+// Explicit instantiaion
+template
+void submit<fp32_t>(Index num_iter, Index m, Index k, Index n,
+        fp32_t beta_2, fp32_t eps, fp32_t lr, fp32_t weight_decay,
+        HandleRef row, HandleRef col, HandleRef mean, HandleRef grad,
+        HandleRef p);
+
+template
+void submit<fp64_t>(Index num_iter, Index m, Index k, Index n,
+        fp64_t beta_2, fp64_t eps, fp64_t lr, fp64_t weight_decay,
+        HandleRef row, HandleRef col, HandleRef mean, HandleRef grad,
+        HandleRef p);
+
+} // namespace adafactor_step
+} // namespace starpu
+} // namespace nntile
+
@@ -15,6 +15,7 @@
 
 #include "nntile/starpu/adam_step.hh"
 #include "nntile/kernel/adam_step.hh"
+#include "nntile/kernel/parallel.hh"
 #include <cstdlib>
 
 namespace nntile
@@ -38,6 +39,8 @@ void cpu(void *buffers[], void *cl_args)
     T *first_moments = interfaces[1]->get_ptr<T>();
     T *second_moments = interfaces[2]->get_ptr<T>();
     T* p = interfaces[3]->get_ptr<T>();
+    // Use all threads of a parallel worker
+    kernel::parallel::Scope threads(starpu_combined_worker_get_size());
     // Launch kernel
     kernel::adam_step::cpu<T>(args->num_iter, args->num_elems, args->beta_1, args->beta_2,
                               args->eps, args->lr, args->weight_decay, grad, first_moments, second_moments, p);
@@ -87,6 +90,9 @@ void init()
             {}
 #endif // NNTILE_USE_CUDA
             );
+    // CPU implementations may use all threads of parallel workers
+    codelet_fp32.set_parallel();
+    codelet_fp64.set_parallel();
 }
 
 void restrict_where(uint32_t where)
@@ -103,10 +109,11 @@ void restore_where()
 
 template<typename T>
 void submit(Index num_iter, Index num_elems, T beta_1, T beta_2, T eps, T lr, T weight_decay,
-            Handle grad, Handle first_moment, Handle second_moment, Handle p)
+            HandleRef grad, HandleRef first_moment, HandleRef second_moment,
+            HandleRef p)
 {
     // Codelet arguments
-    args_t<T>* args = (args_t<T>*)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->num_iter = num_iter;
     args->num_elems = num_elems;
     args->beta_1 = beta_1;
@@ -114,7 +121,7 @@ void submit(Index num_iter, Index num_elems, T beta_1, T beta_2, T eps, T lr, T
     args->eps = eps;
     args->lr = lr;
     args->weight_decay = weight_decay;
-    //fp64_t nflops = 5 * nelems;
+    fp64_t nflops = 15 * num_elems;
     // Submit task
     enum starpu_data_access_mode moments_mode;
     if (num_iter == 1)
@@ -125,12 +132,14 @@ void submit(Index num_iter, Index num_elems, T beta_1, T beta_2, T eps, T lr, T
     {
         moments_mode = STARPU_RW;
     }
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(grad),
             moments_mode, static_cast<starpu_data_handle_t>(first_moment),
             moments_mode, static_cast<starpu_data_handle_t>(second_moment),
             STARPU_RW, static_cast<starpu_data_handle_t>(p),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -143,12 +152,14 @@ void submit(Index num_iter, Index num_elems, T beta_1, T beta_2, T eps, T lr, T
 template
 void submit<fp32_t>(Index num_iter, Index num_elems, fp32_t beta_1, fp32_t beta_2,
             fp32_t eps, fp32_t lr, fp32_t weight_decay,
-            Handle grad, Handle first_moment, Handle second_moment, Handle p);
+            HandleRef grad, HandleRef first_moment, HandleRef second_moment,
+            HandleRef p);
 
 template
 void submit<fp64_t>(Index num_iter, Index num_elems, fp64_t beta_1, fp64_t beta_2,
             fp64_t eps, fp64_t lr, fp64_t weight_decay,
-            Handle grad, Handle first_moment, Handle second_moment, Handle p);
+            HandleRef grad, HandleRef first_moment, HandleRef second_moment,
+            HandleRef p);
 
 } // namespace adam_step
 } // namespace starpu
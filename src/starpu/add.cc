@@ -19,6 +19,7 @@
 #include "nntile/starpu/clear.hh"
 #include "nntile/starpu/scal_inplace.hh"
 #include <cstdlib>
+#include <type_traits>
 
 namespace nntile
 {
@@ -76,7 +77,7 @@ uint32_t footprint(struct starpu_task *task)
     return hash;
 }
 
-Codelet codelet_fp32, codelet_fp64;
+Codelet codelet_fp32, codelet_fp64, codelet_bf16, codelet_fp16;
 
 void init()
 {
@@ -96,6 +97,24 @@ void init()
             {cuda<fp64_t>}
 #else // NNTILE_USE_CUDA
             {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_bf16.init("nntile_add_bf16",
+            footprint<bf16_t>,
+            {cpu<bf16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<bf16_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp16.init("nntile_add_fp16",
+            footprint<fp16_t>,
+            {cpu<fp16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp16_t>}
+#else // NNTILE_USE_CUDA
+            {}
 #endif // NNTILE_USE_CUDA
             );
 }
@@ -104,38 +123,50 @@ void restrict_where(uint32_t where)
 {
     codelet_fp32.restrict_where(where);
     codelet_fp64.restrict_where(where);
+    codelet_bf16.restrict_where(where);
+    codelet_fp16.restrict_where(where);
 }
 
 void restore_where()
 {
     codelet_fp32.restore_where();
     codelet_fp64.restore_where();
+    codelet_bf16.restore_where();
+    codelet_fp16.restore_where();
 }
 
 template<typename T>
-void submit(Index nelems, T alpha, Handle src, T beta, Handle dst)
+void submit(Index nelems, T alpha, HandleRef src, T beta, HandleRef dst)
 //! Insert add task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
  * throws an std::runtime_error() exception.
  * */
 {
-    constexpr T zero = 0, one = 1;
-    // If beta is zero this function reduces to scal
-    if(beta == zero)
-    {
-        scal::submit<T>(nelems, alpha, src, dst);
-        return;
-    }
-    // If beta is non-zero and alpha is zero then reduce to scal_inplace
-    if(alpha == zero)
+    constexpr compute_t<T> zero = 0, one = 1;
+    // Types without scal codelets (bf16_t and fp16_t) use add itself
+    if constexpr(std::is_same_v<T, compute_t<T>>)
     {
-        scal_inplace::submit<T>(nelems, beta, dst);
-        return;
+        // If beta is zero this function reduces to scal
+        if(beta == zero)
+        {
+            scal::submit<T>(nelems, alpha, src, dst);
+            return;
+        }
+        // If beta is non-zero and alpha is zero then reduce to scal_inplace
+        if(alpha == zero)
+        {
+            scal_inplace::submit<T>(nelems, beta, dst);
+            return;
+        }
     }
     // Access mode for the dst handle
     enum starpu_data_access_mode dst_mode;
-    if(beta == one)
+    if(beta == zero)
+    {
+        dst_mode = STARPU_W;
+    }
+    else if(beta == one)
     {
         dst_mode = Config::STARPU_RW_COMMUTE;
     }
@@ -144,16 +175,19 @@ void submit(Index nelems, T alpha, Handle src, T beta, Handle dst)
         dst_mode = STARPU_RW;
     }
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->nelems = nelems;
     args->alpha = alpha;
     args->beta = beta;
+    fp64_t nflops = 3 * nelems;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
-            dst_mode, static_cast<starpu_data_handle_t>(dst), 0);
-            // STARPU_FLOPS, nflops);
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            dst_mode, static_cast<starpu_data_handle_t>(dst),
+            STARPU_FLOPS, nflops,
+            0);
     // Check submission
     if(ret != 0)
     {
@@ -163,12 +197,20 @@ void submit(Index nelems, T alpha, Handle src, T beta, Handle dst)
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index nelems, fp32_t alpha, Handle src, fp32_t beta,
-        Handle dst);
+void submit<fp32_t>(Index nelems, fp32_t alpha, HandleRef src, fp32_t beta,
+        HandleRef dst);
+
+template
+void submit<fp64_t>(Index nelems, fp64_t alpha, HandleRef src, fp64_t beta,
+        HandleRef dst);
+
+template
+void submit<bf16_t>(Index nelems, bf16_t alpha, HandleRef src, bf16_t beta,
+        HandleRef dst);
 
 template
-void submit<fp64_t>(Index nelems, fp64_t alpha, Handle src, fp64_t beta,
-        Handle dst);
+void submit<fp16_t>(Index nelems, fp16_t alpha, HandleRef src, fp16_t beta,
+        HandleRef dst);
 
 } // namespace add
 } // namespace starpu
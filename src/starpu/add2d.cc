@@ -106,8 +106,9 @@ void restore_where()
 }
 
 template <typename T>
-void submit(Index nx, Index ny, T alpha, Handle src, Index offset_src,
-            Index ld_src, T beta, Handle dst, Index offset_dst, Index ld_dst)
+void submit(Index nx, Index ny, T alpha, HandleRef src, Index offset_src,
+            Index ld_src, T beta, HandleRef dst, Index offset_dst,
+            Index ld_dst)
 //! Insert add2d task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -138,7 +139,7 @@ void submit(Index nx, Index ny, T alpha, Handle src, Index offset_src,
     //     dst_mode = STARPU_RW;
     // }
     //  Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->nx = nx;
     args->ny = ny;
     args->alpha = alpha;
@@ -147,12 +148,17 @@ void submit(Index nx, Index ny, T alpha, Handle src, Index offset_src,
     args->beta = beta;
     args->offset_dst = offset_dst;
     args->ld_dst = ld_dst;
+    fp64_t nflops = 3 * nx * ny;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(), STARPU_R,
+    int ret = task_insert(codelet<T>(), STARPU_R,
                                  static_cast<starpu_data_handle_t>(src),
-                                 STARPU_CL_ARGS, args, sizeof(*args), STARPU_RW,
-                                 static_cast<starpu_data_handle_t>(dst), 0);
-    // STARPU_FLOPS, nflops);
+                                 STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+                                 STARPU_CALLBACK_WITH_ARG_NFREE,
+                                 ArgsPool::release, args,
+                                 STARPU_RW,
+                                 static_cast<starpu_data_handle_t>(dst),
+            STARPU_FLOPS, nflops,
+            0);
     // Check submission
     if(ret != 0)
     {
@@ -161,13 +167,13 @@ void submit(Index nx, Index ny, T alpha, Handle src, Index offset_src,
 }
 
 // Explicit instantiation
-template void submit<fp32_t>(Index nx, Index ny, fp32_t alpha, Handle src,
+template void submit<fp32_t>(Index nx, Index ny, fp32_t alpha, HandleRef src,
                              Index offset_src, Index ld_src, fp32_t beta,
-                             Handle dst, Index offset_dst, Index ld_dst);
+                             HandleRef dst, Index offset_dst, Index ld_dst);
 
-template void submit<fp64_t>(Index nx, Index ny, fp64_t alpha, Handle src,
+template void submit<fp64_t>(Index nx, Index ny, fp64_t alpha, HandleRef src,
                              Index offset_src, Index ld_src, fp64_t beta,
-                             Handle dst, Index offset_dst, Index ld_dst);
+                             HandleRef dst, Index offset_dst, Index ld_dst);
 
 } // namespace add2d
 } // namespace starpu
@@ -113,8 +113,8 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index m, Index n, Index k, Index batch, T alpha, Handle src,
-        T beta, Handle dst)
+void submit(Index m, Index n, Index k, Index batch, T alpha, HandleRef src,
+        T beta, HandleRef dst)
 //! Insert add_fiber task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -137,7 +137,7 @@ void submit(Index m, Index n, Index k, Index batch, T alpha, Handle src,
         dst_mode = STARPU_RW;
     }
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->m = m;
     args->n = n;
     args->k = k;
@@ -146,9 +146,10 @@ void submit(Index m, Index n, Index k, Index batch, T alpha, Handle src,
     args->beta = beta;
     fp64_t nflops = batch * k * (2*m*n+1);
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             dst_mode, static_cast<starpu_data_handle_t>(dst),
             STARPU_FLOPS, nflops,
             0);
@@ -162,11 +163,11 @@ void submit(Index m, Index n, Index k, Index batch, T alpha, Handle src,
 // Explicit instantiation
 template
 void submit<fp32_t>(Index m, Index n, Index k, Index batch, fp32_t alpha,
-        Handle src, fp32_t beta, Handle dst);
+        HandleRef src, fp32_t beta, HandleRef dst);
 
 template
 void submit<fp64_t>(Index m, Index n, Index k, Index batch, fp64_t alpha,
-        Handle src, fp64_t beta, Handle dst);
+        HandleRef src, fp64_t beta, HandleRef dst);
 
 } // namespace add_fiber
 } // namespace starpu
@@ -0,0 +1,178 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/add_layer_norm.cc
+ * Fused residual addition and layer normalization of StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/add_layer_norm.hh"
+#include "nntile/kernel/add_layer_norm.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for add_layer_norm operation
+namespace add_layer_norm
+{
+
+//! StarPU wrapper for kernel::add_layer_norm::cpu<T>
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src1 = interfaces[0]->get_ptr<T>();
+    const T *src2 = interfaces[1]->get_ptr<T>();
+    const T *gamma = interfaces[2]->get_ptr<T>();
+    const T *beta = interfaces[3]->get_ptr<T>();
+    T *sum = interfaces[4]->get_ptr<T>();
+    T *mean = interfaces[5]->get_ptr<T>();
+    T *inv_stddev = interfaces[6]->get_ptr<T>();
+    T *dst = interfaces[7]->get_ptr<T>();
+    // Launch kernel
+    kernel::add_layer_norm::cpu<T>(args->m, args->n, args->k, args->eps,
+            src1, src2, gamma, beta, sum, mean, inv_stddev, dst);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! StarPU wrapper for kernel::add_layer_norm::cuda<T>
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src1 = interfaces[0]->get_ptr<T>();
+    const T *src2 = interfaces[1]->get_ptr<T>();
+    const T *gamma = interfaces[2]->get_ptr<T>();
+    const T *beta = interfaces[3]->get_ptr<T>();
+    T *sum = interfaces[4]->get_ptr<T>();
+    T *mean = interfaces[5]->get_ptr<T>();
+    T *inv_stddev = interfaces[6]->get_ptr<T>();
+    T *dst = interfaces[7]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::add_layer_norm::cuda<T>(stream, args->m, args->n, args->k,
+            args->eps, src1, src2, gamma, beta, sum, mean, inv_stddev, dst);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for add_layer_norm tasks
+template<typename T>
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(task->cl_arg);
+    // Apply hash over parameters m, n and k
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    hash = starpu_hash_crc32c_be_n(&args->k, sizeof(args->k), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_add_layer_norm_fp32",
+            footprint<fp32_t>,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_add_layer_norm_fp64",
+            footprint<fp64_t>,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index m, Index n, Index k, T eps, HandleRef src1, HandleRef src2,
+        HandleRef gamma, HandleRef beta, HandleRef sum, HandleRef mean,
+        HandleRef inv_stddev, HandleRef dst)
+//! Insert add_layer_norm task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
+    args->m = m;
+    args->n = n;
+    args->k = k;
+    args->eps = eps;
+    fp64_t nflops = 10 * m * n * k;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(src1),
+            STARPU_R, static_cast<starpu_data_handle_t>(src2),
+            STARPU_R, static_cast<starpu_data_handle_t>(gamma),
+            STARPU_R, static_cast<starpu_data_handle_t>(beta),
+            STARPU_W, static_cast<starpu_data_handle_t>(sum),
+            STARPU_W, static_cast<starpu_data_handle_t>(mean),
+            STARPU_W, static_cast<starpu_data_handle_t>(inv_stddev),
+            STARPU_W, static_cast<starpu_data_handle_t>(dst),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in add_layer_norm task submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index m, Index n, Index k, fp32_t eps, HandleRef src1,
+        HandleRef src2, HandleRef gamma, HandleRef beta, HandleRef sum,
+        HandleRef mean, HandleRef inv_stddev, HandleRef dst);
+
+template
+void submit<fp64_t>(Index m, Index n, Index k, fp64_t eps, HandleRef src1,
+        HandleRef src2, HandleRef gamma, HandleRef beta, HandleRef sum,
+        HandleRef mean, HandleRef inv_stddev, HandleRef dst);
+
+} // namespace add_layer_norm
+} // namespace starpu
+} // namespace nntile
+
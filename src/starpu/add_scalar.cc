@@ -108,7 +108,7 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index num_elements, T alpha, T beta, Handle dst)
+void submit(Index num_elements, T alpha, T beta, HandleRef dst)
 //! Insert add_scalar task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -116,15 +116,18 @@ void submit(Index num_elements, T alpha, T beta, Handle dst)
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->num_elements = num_elements;
     args->alpha = alpha;
     args->beta = beta;
+    fp64_t nflops = 2 * num_elements;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
-            STARPU_CL_ARGS, args, sizeof(*args),
-            STARPU_RW, static_cast<starpu_data_handle_t>(dst), 0);
-            // STARPU_FLOPS, nflops);
+    int ret = task_insert(codelet<T>(),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_RW, static_cast<starpu_data_handle_t>(dst),
+            STARPU_FLOPS, nflops,
+            0);
     // Check submission
     if(ret != 0)
     {
@@ -134,10 +137,12 @@ void submit(Index num_elements, T alpha, T beta, Handle dst)
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index num_elements, fp32_t alpha, fp32_t beta, Handle dst);
+void submit<fp32_t>(Index num_elements, fp32_t alpha, fp32_t beta,
+        HandleRef dst);
 
 template
-void submit<fp64_t>(Index num_elements, fp64_t alpha, fp64_t beta, Handle dst);
+void submit<fp64_t>(Index num_elements, fp64_t alpha, fp64_t beta,
+        HandleRef dst);
 
 } // namespace add_scalar
 } // namespace starpu
@@ -34,10 +34,13 @@ void cpu(void *buffers[], void *cl_args)
     // Get interfaces
     auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
     const T *src = interfaces[0]->get_ptr<T>();
-    T *dst = interfaces[1]->get_ptr<T>();
-    // Launch kernel
-    kernel::add_slice::cpu<T>(args->m, args->n, args->k, args->alpha, src,
-            args->beta, dst);
+    // Launch kernel for every destination tile
+    for(Index i = 1; i <= args->ndst; ++i)
+    {
+        T *dst = interfaces[i]->get_ptr<T>();
+        kernel::add_slice::cpu<T>(args->m, args->n, args->k, args->alpha,
+                src, args->beta, dst);
+    }
 }
 
 #ifdef NNTILE_USE_CUDA
@@ -51,12 +54,15 @@ void cuda(void *buffers[], void *cl_args)
     // Get interfaces
     auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
     const T *src = interfaces[0]->get_ptr<T>();
-    T *dst = interfaces[1]->get_ptr<T>();
     // Get CUDA stream
     cudaStream_t stream = starpu_cuda_get_local_stream();
-    // Launch kernel
-    kernel::add_slice::cuda<T>(stream, args->m, args->n, args->k, args->alpha,
-            src, args->beta, dst);
+    // Launch kernel for every destination tile
+    for(Index i = 1; i <= args->ndst; ++i)
+    {
+        T *dst = interfaces[i]->get_ptr<T>();
+        kernel::add_slice::cuda<T>(stream, args->m, args->n, args->k,
+                args->alpha, src, args->beta, dst);
+    }
 }
 #endif // NNTILE_USE_CUDA
 
@@ -67,11 +73,12 @@ uint32_t footprint(struct starpu_task *task)
 {
     // Get arguments
     auto args = reinterpret_cast<args_t<T> *>(task->cl_arg);
-    // Apply hash over parameters m, n and k
+    // Apply hash over parameters m, n, k and ndst
     uint32_t hash = 0;
     hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
     hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
     hash = starpu_hash_crc32c_be_n(&args->k, sizeof(args->k), hash);
+    hash = starpu_hash_crc32c_be_n(&args->ndst, sizeof(args->ndst), hash);
     return hash;
 }
 
@@ -111,42 +118,85 @@ void restore_where()
     codelet_fp64.restore_where();
 }
 
+// Access mode for destination tiles
 template<typename T>
-void submit(Index m, Index n, Index k, T alpha, Handle src, T beta, Handle dst)
-//! Insert add_slice task into StarPU pool of tasks
-/*! No argument checking is performed. All the inputs are packed and passed to
- * starpu_task_insert() function. If task submission fails, this routines
- * throws an std::runtime_error() exception.
- * */
+static enum starpu_data_access_mode dst_mode(T beta)
 {
-    // Access mode for the dst handle
     constexpr T zero = 0, one = 1;
-    enum starpu_data_access_mode dst_mode;
     if(beta == zero)
     {
-        dst_mode = STARPU_W;
+        return STARPU_W;
     }
     else if(beta == one)
     {
-        dst_mode = Config::STARPU_RW_COMMUTE;
-    }
-    else
-    {
-        dst_mode = STARPU_RW;
+        return Config::STARPU_RW_COMMUTE;
     }
+    return STARPU_RW;
+}
+
+template<typename T>
+void submit(Index m, Index n, Index k, T alpha, HandleRef src, T beta,
+        HandleRef dst)
+//! Insert add_slice task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->m = m;
     args->n = n;
     args->k = k;
+    args->ndst = 1;
     args->alpha = alpha;
     args->beta = beta;
     fp64_t nflops = m * n * (2*k+1);
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
-            dst_mode, static_cast<starpu_data_handle_t>(dst),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            dst_mode<T>(beta), static_cast<starpu_data_handle_t>(dst),
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in add_slice task submission");
+    }
+}
+
+template<typename T>
+void submit(Index m, Index n, Index k, T alpha, HandleRef src, T beta,
+        const std::vector<Handle> &dst)
+//! Insert a single add_slice task for several destination tiles
+/*! All the destination tiles are of the same shape and share the source
+ * tile, which amortizes overhead of a task over several tiny tiles.
+ * */
+{
+    // Codelet arguments
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
+    args->m = m;
+    args->n = n;
+    args->k = k;
+    args->ndst = dst.size();
+    args->alpha = alpha;
+    args->beta = beta;
+    fp64_t nflops = m * n * (2*k+1) * args->ndst;
+    std::vector<starpu_data_descr> descrs(dst.size()+1);
+    descrs[0].handle = static_cast<starpu_data_handle_t>(src);
+    descrs[0].mode = STARPU_R;
+    for(Index i = 0; i < dst.size(); ++i)
+    {
+        descrs[i+1].handle = static_cast<starpu_data_handle_t>(dst[i]);
+        descrs[i+1].mode = dst_mode<T>(beta);
+    }
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_DATA_MODE_ARRAY, descrs.data(), int(descrs.size()),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             STARPU_FLOPS, nflops,
             0);
     // Check submission
@@ -158,12 +208,20 @@ void submit(Index m, Index n, Index k, T alpha, Handle src, T beta, Handle dst)
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index m, Index n, Index k, fp32_t alpha, Handle src,
-        fp32_t beta, Handle dst);
+void submit<fp32_t>(Index m, Index n, Index k, fp32_t alpha, HandleRef src,
+        fp32_t beta, HandleRef dst);
+
+template
+void submit<fp64_t>(Index m, Index n, Index k, fp64_t alpha, HandleRef src,
+        fp64_t beta, HandleRef dst);
+
+template
+void submit<fp32_t>(Index m, Index n, Index k, fp32_t alpha, HandleRef src,
+        fp32_t beta, const std::vector<Handle> &dst);
 
 template
-void submit<fp64_t>(Index m, Index n, Index k, fp64_t alpha, Handle src,
-        fp64_t beta, Handle dst);
+void submit<fp64_t>(Index m, Index n, Index k, fp64_t alpha, HandleRef src,
+        fp64_t beta, const std::vector<Handle> &dst);
 
 } // namespace add_slice
 } // namespace starpu
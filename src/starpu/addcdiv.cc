@@ -100,21 +100,23 @@ void restore_where()
 }
 
 template<typename T>
-void submit(T val, T eps, Index nelems, Handle nom, Handle denom, Handle src)
+void submit(T val, T eps, Index nelems, HandleRef nom, HandleRef denom,
+        HandleRef src)
 {
     // Codelet arguments
-    args_t<T>* args = (args_t<T>*)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->val = val;
     args->eps = eps;
     args->nelems = nelems;
-    //fp64_t nflops = 5 * nelems;
+    fp64_t nflops = 4 * nelems;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(nom),
             STARPU_R, static_cast<starpu_data_handle_t>(denom),
             STARPU_RW, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
-            //STARPU_FLOPS, nflops,
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -125,12 +127,12 @@ void submit(T val, T eps, Index nelems, Handle nom, Handle denom, Handle src)
 
 // Explicit instantiaion
 template
-void submit<fp32_t>(fp32_t val, fp32_t eps, Index nelems, Handle nom,
-        Handle denom, Handle src);
+void submit<fp32_t>(fp32_t val, fp32_t eps, Index nelems, HandleRef nom,
+        HandleRef denom, HandleRef src);
 
 template
-void submit<fp64_t>(fp64_t val, fp64_t eps, Index nelems, Handle nom,
-        Handle denom, Handle src);
+void submit<fp64_t>(fp64_t val, fp64_t eps, Index nelems, HandleRef nom,
+        HandleRef denom, HandleRef src);
 
 } // namespace addcdiv
 } // namespace starpu
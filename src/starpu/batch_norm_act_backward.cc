@@ -0,0 +1,202 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/batch_norm_act_backward.cc
+ * Backward of an activation, that follows batch normalization, of StarPU
+ * buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/batch_norm_act_backward.hh"
+#include "nntile/kernel/batch_norm_act_backward.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for batch_norm_act_backward operation
+namespace batch_norm_act_backward
+{
+
+//! StarPU wrapper for kernel::batch_norm_act_backward::cpu<T>
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src = interfaces[0]->get_ptr<T>();
+    const T *mean = interfaces[1]->get_ptr<T>();
+    const T *inv_stddev = interfaces[2]->get_ptr<T>();
+    const T *gamma = interfaces[3]->get_ptr<T>();
+    const T *beta = interfaces[4]->get_ptr<T>();
+    const T *dst_grad = interfaces[5]->get_ptr<T>();
+    T *y_grad = interfaces[6]->get_ptr<T>();
+    T *sum_grad = interfaces[7]->get_ptr<T>();
+    T *sum_grad_xhat = interfaces[8]->get_ptr<T>();
+    // Launch kernel
+    kernel::batch_norm_act_backward::cpu<T>(args->m, args->n, args->k,
+            args->act, src, mean, inv_stddev, gamma, beta, dst_grad, y_grad,
+            sum_grad, sum_grad_xhat);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! StarPU wrapper for kernel::batch_norm_act_backward::cuda<T>
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src = interfaces[0]->get_ptr<T>();
+    const T *mean = interfaces[1]->get_ptr<T>();
+    const T *inv_stddev = interfaces[2]->get_ptr<T>();
+    const T *gamma = interfaces[3]->get_ptr<T>();
+    const T *beta = interfaces[4]->get_ptr<T>();
+    const T *dst_grad = interfaces[5]->get_ptr<T>();
+    T *y_grad = interfaces[6]->get_ptr<T>();
+    T *sum_grad = interfaces[7]->get_ptr<T>();
+    T *sum_grad_xhat = interfaces[8]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::batch_norm_act_backward::cuda<T>(stream, args->m, args->n,
+            args->k, args->act, src, mean, inv_stddev, gamma, beta, dst_grad,
+            y_grad, sum_grad, sum_grad_xhat);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for batch_norm_act_backward tasks
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    // Apply hash over parameters m, n, k and activation
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    hash = starpu_hash_crc32c_be_n(&args->k, sizeof(args->k), hash);
+    hash = starpu_hash_crc32c_be_n(&args->act, sizeof(args->act), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_batch_norm_act_backward_fp32",
+            footprint,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_batch_norm_act_backward_fp64",
+            footprint,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index m, Index n, Index k, activation_t act, HandleRef src,
+        HandleRef mean, HandleRef inv_stddev, HandleRef gamma, HandleRef beta,
+        HandleRef dst_grad, HandleRef y_grad, HandleRef sum_grad,
+        HandleRef sum_grad_xhat, int redux)
+//! Insert batch_norm_act_backward task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t *args = ArgsPool::allocate<args_t>();
+    args->m = m;
+    args->n = n;
+    args->k = k;
+    args->act = act;
+    fp64_t nflops = 20 * m * n * k;
+    // Access mode for sums, that are accumulated by tasks of all the tiles of
+    // src
+    enum starpu_data_access_mode sum_mode;
+    if(redux != 0)
+    {
+        sum_mode = STARPU_REDUX;
+    }
+    else
+    {
+        sum_mode = Config::STARPU_RW_COMMUTE;
+    }
+    // Number of buffers exceeds the number of arguments of the default list
+    starpu_data_descr descrs[9] = {
+        {static_cast<starpu_data_handle_t>(src), STARPU_R},
+        {static_cast<starpu_data_handle_t>(mean), STARPU_R},
+        {static_cast<starpu_data_handle_t>(inv_stddev), STARPU_R},
+        {static_cast<starpu_data_handle_t>(gamma), STARPU_R},
+        {static_cast<starpu_data_handle_t>(beta), STARPU_R},
+        {static_cast<starpu_data_handle_t>(dst_grad), STARPU_R},
+        {static_cast<starpu_data_handle_t>(y_grad), STARPU_W},
+        {static_cast<starpu_data_handle_t>(sum_grad), sum_mode},
+        {static_cast<starpu_data_handle_t>(sum_grad_xhat), sum_mode}};
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_DATA_MODE_ARRAY, descrs, 9,
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in batch_norm_act_backward task "
+                "submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index m, Index n, Index k, activation_t act,
+        HandleRef src, HandleRef mean, HandleRef inv_stddev, HandleRef gamma,
+        HandleRef beta, HandleRef dst_grad, HandleRef y_grad,
+        HandleRef sum_grad, HandleRef sum_grad_xhat, int redux);
+
+template
+void submit<fp64_t>(Index m, Index n, Index k, activation_t act,
+        HandleRef src, HandleRef mean, HandleRef inv_stddev, HandleRef gamma,
+        HandleRef beta, HandleRef dst_grad, HandleRef y_grad,
+        HandleRef sum_grad, HandleRef sum_grad_xhat, int redux);
+
+} // namespace batch_norm_act_backward
+} // namespace starpu
+} // namespace nntile
+
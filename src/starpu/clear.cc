@@ -85,10 +85,10 @@ void restore_where()
 }
 
 //! Insert task to clear buffer
-void submit(Handle data)
+void submit(HandleRef data)
 {
     // Submit task
-    int ret = starpu_task_insert(&codelet,
+    int ret = task_insert(&codelet,
             STARPU_W, static_cast<starpu_data_handle_t>(data),
             0);
     // Check submission
@@ -0,0 +1,138 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/clip_scale.cc
+ * Learning rate and scale of gradients for clipping on StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/clip_scale.hh"
+#include "nntile/kernel/clip_scale.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for clip_scale operation
+namespace clip_scale
+{
+
+//! Apply clip_scale operation for StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *norm = interfaces[0]->get_ptr<T>();
+    T *scalars = interfaces[1]->get_ptr<T>();
+    // Launch kernel
+    kernel::clip_scale::cpu<T>(args->lr, args->max_norm, norm, scalars);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Apply clip_scale operation for StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *norm = interfaces[0]->get_ptr<T>();
+    T *scalars = interfaces[1]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::clip_scale::cuda<T>(stream, args->lr, args->max_norm, norm,
+            scalars);
+}
+#endif // NNTILE_USE_CUDA
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_clip_scale_fp32",
+            nullptr,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_clip_scale_fp64",
+            nullptr,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(T lr, T max_norm, HandleRef norm, HandleRef scalars)
+//! Insert clip_scale task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
+    args->lr = lr;
+    args->max_norm = max_norm;
+    fp64_t nflops = 2;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(norm),
+            STARPU_W, static_cast<starpu_data_handle_t>(scalars),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in clip_scale task submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(fp32_t lr, fp32_t max_norm, HandleRef norm,
+        HandleRef scalars);
+
+template
+void submit<fp64_t>(fp64_t lr, fp64_t max_norm, HandleRef norm,
+        HandleRef scalars);
+
+} // namespace clip_scale
+} // namespace starpu
+} // namespace nntile
+
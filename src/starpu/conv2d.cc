@@ -59,8 +59,9 @@ void cuda(void *buffers[], void *cl_args)
     // Get CUDA stream
     cudaStream_t stream = starpu_cuda_get_local_stream();
     // Launch kernel
-    kernel::conv2d::cuda<T>(stream, args->nx, args->ny, src, args->mx, args->my,
-            kernel, dst);
+    kernel::conv2d::cuda<T>(stream, args->offset_n, args->offset_m,
+            args->batch, args->src_n, args->src_m, src, args->kernel_n,
+            args->kernel_m, kernel, args->dst_n, args->dst_m, dst);
 }
 #endif // NNTILE_USE_CUDA
 
@@ -118,8 +119,8 @@ void restore_where()
 
 template <typename T>
 void submit(Index offset_n, Index offset_m, Index batch, Index src_n,
-            Index src_m, Handle src, Index kernel_n, Index kernel_m,
-            Handle kernel, Index dst_n, Index dst_m, Handle dst)
+            Index src_m, HandleRef src, Index kernel_n, Index kernel_m,
+            HandleRef kernel, Index dst_n, Index dst_m, HandleRef dst)
 //! Insert conv2d task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -127,7 +128,7 @@ void submit(Index offset_n, Index offset_m, Index batch, Index src_n,
  * */
 {
     // Codelet arguments
-    args_t *args = (args_t *)std::malloc(sizeof(*args));
+    args_t *args = ArgsPool::allocate<args_t>();
     args->offset_n = offset_n;
     args->offset_m = offset_m;
     args->batch = batch;
@@ -139,10 +140,11 @@ void submit(Index offset_n, Index offset_m, Index batch, Index src_n,
     args->dst_m = dst_m;
     fp64_t nflops = src_n * src_m * dst_n * dst_m * batch;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_R, static_cast<starpu_data_handle_t>(kernel),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
             STARPU_FLOPS, nflops,
             0);
@@ -155,14 +157,14 @@ void submit(Index offset_n, Index offset_m, Index batch, Index src_n,
 
 // Explicit instantiation
 template void submit<fp32_t>(Index offset_n, Index offset_m, Index batch,
-                             Index src_n, Index src_m, Handle src,
-                             Index kernel_n, Index kernel_m, Handle kernel,
-                             Index dst_n, Index dst_m, Handle dst);
+                             Index src_n, Index src_m, HandleRef src,
+                             Index kernel_n, Index kernel_m, HandleRef kernel,
+                             Index dst_n, Index dst_m, HandleRef dst);
 
 template void submit<fp64_t>(Index offset_n, Index offset_m, Index batch,
-                             Index src_n, Index src_m, Handle src,
-                             Index kernel_n, Index kernel_m, Handle kernel,
-                             Index dst_n, Index dst_m, Handle dst);
+                             Index src_n, Index src_m, HandleRef src,
+                             Index kernel_n, Index kernel_m, HandleRef kernel,
+                             Index dst_n, Index dst_m, HandleRef dst);
 
 } // namespace conv2d
 } // namespace starpu
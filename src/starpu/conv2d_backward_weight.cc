@@ -0,0 +1,180 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/conv2d_backward_weight.cc
+ * StarPU wrappers for gradient of 2D-Convolution over kernel
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/conv2d_backward_weight.hh"
+#include "nntile/kernel/conv2d.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for gradient of conv2d over kernel
+namespace conv2d_backward_weight
+{
+
+//! StarPU wrapper for kernel::conv2d::cpu_backward_weight<T>
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src = interfaces[0]->get_ptr<T>();
+    const T *dst_grad = interfaces[1]->get_ptr<T>();
+    T *kernel_grad = interfaces[2]->get_ptr<T>();
+    // Launch kernel
+    kernel::conv2d::cpu_backward_weight<T>(args->offset_n, args->offset_m,
+            args->batch, args->src_n, args->src_m, src, args->dst_n,
+            args->dst_m, dst_grad, args->kernel_n, args->kernel_m,
+            kernel_grad);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! StarPU wrapper for kernel::conv2d::cuda_backward_weight<T>
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src = interfaces[0]->get_ptr<T>();
+    const T *dst_grad = interfaces[1]->get_ptr<T>();
+    T *kernel_grad = interfaces[2]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::conv2d::cuda_backward_weight<T>(stream, args->offset_n,
+            args->offset_m, args->batch, args->src_n, args->src_m, src,
+            args->dst_n, args->dst_m, dst_grad, args->kernel_n, args->kernel_m,
+            kernel_grad);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for conv2d_backward_weight tasks
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    // Apply hash over shapes of all the arrays
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->src_n, sizeof(args->src_n), hash);
+    hash = starpu_hash_crc32c_be_n(&args->src_m, sizeof(args->src_m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->kernel_n, sizeof(args->kernel_n),
+            hash);
+    hash = starpu_hash_crc32c_be_n(&args->kernel_m, sizeof(args->kernel_m),
+            hash);
+    hash = starpu_hash_crc32c_be_n(&args->dst_n, sizeof(args->dst_n), hash);
+    hash = starpu_hash_crc32c_be_n(&args->dst_m, sizeof(args->dst_m), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_conv2d_backward_weight_fp32",
+            footprint,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_conv2d_backward_weight_fp64",
+            footprint,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template <typename T>
+void submit(Index offset_n, Index offset_m, Index batch, Index src_n,
+        Index src_m, HandleRef src, Index dst_n, Index dst_m,
+        HandleRef dst_grad, Index kernel_n, Index kernel_m,
+        HandleRef kernel_grad)
+//! Insert conv2d_backward_weight task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t *args = ArgsPool::allocate<args_t>();
+    args->offset_n = offset_n;
+    args->offset_m = offset_m;
+    args->batch = batch;
+    args->src_n = src_n;
+    args->src_m = src_m;
+    args->kernel_n = kernel_n;
+    args->kernel_m = kernel_m;
+    args->dst_n = dst_n;
+    args->dst_m = dst_m;
+    fp64_t nflops = 2 * batch * src_n * src_m * kernel_n * kernel_m;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(src),
+            STARPU_R, static_cast<starpu_data_handle_t>(dst_grad),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_RW, static_cast<starpu_data_handle_t>(kernel_grad),
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in conv2d_backward_weight task "
+                "submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index offset_n, Index offset_m, Index batch, Index src_n,
+        Index src_m, HandleRef src, Index dst_n, Index dst_m,
+        HandleRef dst_grad, Index kernel_n, Index kernel_m,
+        HandleRef kernel_grad);
+
+template
+void submit<fp64_t>(Index offset_n, Index offset_m, Index batch, Index src_n,
+        Index src_m, HandleRef src, Index dst_n, Index dst_m,
+        HandleRef dst_grad, Index kernel_n, Index kernel_m,
+        HandleRef kernel_grad);
+
+} // namespace conv2d_backward_weight
+} // namespace starpu
+} // namespace nntile
+
@@ -80,7 +80,7 @@ void restore_where()
     codelet.restore_where();
 }
 
-void submit(Handle src, Handle dst)
+void submit(HandleRef src, HandleRef dst)
 //! Insert copy task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -88,7 +88,7 @@ void submit(Handle src, Handle dst)
  * */
 {
     // Submit task
-    int ret = starpu_task_insert(&codelet,
+    int ret = task_insert(&codelet,
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_W, static_cast<starpu_data_handle_t>(dst),
             0);
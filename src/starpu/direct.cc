@@ -0,0 +1,142 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/direct.cc
+ * Direct execution of tasks by the submitting thread
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/config.hh"
+#include <atomic>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace direct
+{
+
+// Submitting threads read the flag, while another thread may toggle it
+static std::atomic<bool> active(false);
+
+void enter()
+{
+    active.store(true, std::memory_order_release);
+}
+
+void exit()
+{
+    active.store(false, std::memory_order_release);
+}
+
+bool is_active()
+{
+    return active.load(std::memory_order_acquire);
+}
+
+//! Mode to acquire a buffer of a task, that is executed directly
+static starpu_data_access_mode acquire_mode(starpu_data_access_mode mode)
+{
+    // Reduction is done into the data itself, as tasks run one by one
+    if((mode & STARPU_REDUX) == STARPU_REDUX)
+    {
+        return STARPU_RW;
+    }
+    if(mode & STARPU_SCRATCH)
+    {
+        return STARPU_W;
+    }
+    return static_cast<starpu_data_access_mode>(mode & STARPU_RW);
+}
+
+//! Check if a task can be executed by the calling thread
+static bool can_execute(starpu_task *task)
+{
+    starpu_codelet *cl = task->cl;
+    // Wrappers, that collect statistics, need task of a worker, and
+    // parallel implementations need a combined worker
+    if(cl == nullptr or Codelet::stats_is_enabled()
+            or cl->type != STARPU_SEQ or cl->can_execute != nullptr)
+    {
+        return false;
+    }
+    if((cl->where & STARPU_CPU) == 0 or cl->cpu_funcs[0] == nullptr)
+    {
+        return false;
+    }
+    // Task may be restricted to other workers (see scheduler::where_set)
+    if(task->where != -1 and (task->where & STARPU_CPU) == 0)
+    {
+        return false;
+    }
+    // The same handle in several buffers would be acquired twice
+    unsigned nbuffers = STARPU_TASK_GET_NBUFFERS(task);
+    for(unsigned i = 0; i < nbuffers; ++i)
+    {
+        for(unsigned j = 0; j < i; ++j)
+        {
+            if(STARPU_TASK_GET_HANDLE(task, i)
+                    == STARPU_TASK_GET_HANDLE(task, j))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int execute(starpu_task *task)
+{
+    if(not can_execute(task))
+    {
+        return starpu_task_submit(task);
+    }
+    // Wait for all the previously submitted tasks, that use the buffers
+    unsigned nbuffers = STARPU_TASK_GET_NBUFFERS(task);
+    std::vector<void *> interfaces(nbuffers);
+    for(unsigned i = 0; i < nbuffers; ++i)
+    {
+        starpu_data_handle_t handle = STARPU_TASK_GET_HANDLE(task, i);
+        int ret = starpu_data_acquire(handle,
+                acquire_mode(STARPU_TASK_GET_MODE(task, i)));
+        if(ret != 0)
+        {
+            for(unsigned j = 0; j < i; ++j)
+            {
+                starpu_data_release(STARPU_TASK_GET_HANDLE(task, j));
+            }
+            // Arguments of the task are released even if it is not run
+            if(task->callback_func != nullptr)
+            {
+                task->callback_func(task->callback_arg);
+            }
+            starpu_task_destroy(task);
+            return ret;
+        }
+        interfaces[i] = starpu_data_get_interface_on_node(handle,
+                STARPU_MAIN_RAM);
+    }
+    task->cl->cpu_funcs[0](interfaces.data(), task->cl_arg);
+    for(unsigned i = 0; i < nbuffers; ++i)
+    {
+        starpu_data_release(STARPU_TASK_GET_HANDLE(task, i));
+    }
+    // Callback releases arguments of the task (see ArgsPool)
+    if(task->callback_func != nullptr)
+    {
+        task->callback_func(task->callback_arg);
+    }
+    starpu_task_destroy(task);
+    return 0;
+}
+
+} // namespace direct
+} // namespace starpu
+} // namespace nntile
+
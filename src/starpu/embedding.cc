@@ -36,7 +36,8 @@ void cpu(void *buffers[], void *cl_args)
     T *embed = interfaces[2]->get_ptr<T>();
     // Get embeddings
     kernel::embedding::cpu<T>(args->m, args->n, args->k, args->k_start,
-            args->k_size, index, vocab, embed);
+            args->k_size, args->vocab_start, args->vocab_size, index, vocab,
+            embed);
 }
 
 #ifdef NNTILE_USE_CUDA
@@ -56,7 +57,8 @@ void cuda(void *buffers[], void *cl_args)
     cudaStream_t stream = starpu_cuda_get_local_stream();
     // Get embeddings
     kernel::embedding::cuda<T>(stream, args->m, args->n, args->k,
-            args->k_start, args->k_size, index, vocab, embed);
+            args->k_start, args->k_size, args->vocab_start, args->vocab_size,
+            index, vocab, embed);
 }
 #endif // NNTILE_USE_CUDA
 
@@ -113,7 +115,8 @@ void restore_where()
 
 template<typename T>
 void submit(Index m, Index n, Index k, Index k_start, Index k_size,
-        Handle index, Handle vocab, Handle embed)
+        Index vocab_start, Index vocab_size, HandleRef index, HandleRef vocab,
+        HandleRef embed)
 //! Insert embedding task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -121,20 +124,23 @@ void submit(Index m, Index n, Index k, Index k_start, Index k_size,
  * */
 {
     // Codelet arguments
-    args_t *args = (args_t *)std::malloc(sizeof(*args));
+    args_t *args = ArgsPool::allocate<args_t>();
     args->m = m;
     args->n = n;
     args->k = k;
     args->k_start = k_start;
     args->k_size = k_size;
+    args->vocab_start = vocab_start;
+    args->vocab_size = vocab_size;
     fp64_t nflops = m * n * k_size;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(index),
             STARPU_R, static_cast<starpu_data_handle_t>(vocab),
             STARPU_RW, static_cast<starpu_data_handle_t>(embed),
             //Config::STARPU_RW_COMMUTE, static_cast<starpu_data_handle_t>(embed),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             STARPU_FLOPS, nflops,
             0);
     // Check submission
@@ -147,11 +153,13 @@ void submit(Index m, Index n, Index k, Index k_start, Index k_size,
 // Explicit instantiation
 template
 void submit<fp32_t>(Index m, Index n, Index k, Index k_start, Index k_size,
-        Handle index, Handle vocab, Handle embed);
+        Index vocab_start, Index vocab_size, HandleRef index, HandleRef vocab,
+        HandleRef embed);
 
 template
 void submit<fp64_t>(Index m, Index n, Index k, Index k_start, Index k_size,
-        Handle index, Handle vocab, Handle embed);
+        Index vocab_start, Index vocab_size, HandleRef index, HandleRef vocab,
+        HandleRef embed);
 
 } // namespace embedding
 } // namespace starpu
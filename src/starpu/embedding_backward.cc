@@ -34,9 +34,11 @@ void cpu(void *buffers[], void *cl_args)
     const Index *index = interfaces[0]->get_ptr<Index>();
     const T *embed = interfaces[1]->get_ptr<T>();
     T *vocab = interfaces[2]->get_ptr<T>();
+    Index *tmp = interfaces[3]->get_ptr<Index>();
     // Accumulate vocab gradients
     kernel::embedding_backward::cpu<T>(args->m, args->n, args->k,
-            args->k_start, args->k_size, index, embed, vocab);
+            args->k_start, args->k_size, args->vocab_start, args->vocab_size,
+            index, embed, vocab, tmp);
 }
 
 #ifdef NNTILE_USE_CUDA
@@ -52,11 +54,13 @@ void cuda(void *buffers[], void *cl_args)
     const Index *index = interfaces[0]->get_ptr<Index>();
     const T *embed = interfaces[1]->get_ptr<T>();
     T *vocab = interfaces[2]->get_ptr<T>();
+    Index *tmp = interfaces[3]->get_ptr<Index>();
     // Get CUDA stream
     cudaStream_t stream = starpu_cuda_get_local_stream();
     // Accumulate vocab gradients
     kernel::embedding_backward::cuda<T>(stream, args->m, args->n, args->k,
-            args->k_start, args->k_size, index, embed, vocab);
+            args->k_start, args->k_size, args->vocab_start, args->vocab_size,
+            index, embed, vocab, tmp);
 }
 #endif // NNTILE_USE_CUDA
 
@@ -113,20 +117,24 @@ void restore_where()
 
 template<typename T>
 void submit(Index m, Index n, Index k, Index k_start, Index k_size,
-        Handle index, Handle embed, Handle vocab, int redux)
+        Index vocab_start, Index vocab_size, HandleRef index, HandleRef embed,
+        HandleRef vocab, HandleRef tmp, int redux)
 //! Insert embedding_backward task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
- * throws an std::runtime_error() exception.
+ * throws an std::runtime_error() exception. Scratch buffer tmp shall hold at
+ * least m*n indices.
  * */
 {
     // Codelet arguments
-    args_t *args = (args_t *)std::malloc(sizeof(*args));
+    args_t *args = ArgsPool::allocate<args_t>();
     args->m = m;
     args->n = n;
     args->k = k;
     args->k_start = k_start;
     args->k_size = k_size;
+    args->vocab_start = vocab_start;
+    args->vocab_size = vocab_size;
     fp64_t nflops = m * n * k_size;
     // Access mode for the output vocab handle
     enum starpu_data_access_mode vocab_mode;
@@ -140,11 +148,13 @@ void submit(Index m, Index n, Index k, Index k_start, Index k_size,
         vocab_mode = Config::STARPU_RW_COMMUTE;
     }
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(index),
             STARPU_R, static_cast<starpu_data_handle_t>(embed),
             vocab_mode, static_cast<starpu_data_handle_t>(vocab),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_SCRATCH, static_cast<starpu_data_handle_t>(tmp),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             STARPU_FLOPS, nflops,
             0);
     // Check submission
@@ -158,11 +168,13 @@ void submit(Index m, Index n, Index k, Index k_start, Index k_size,
 // Explicit instantiation
 template
 void submit<fp32_t>(Index m, Index n, Index k, Index k_start, Index k_size,
-        Handle index, Handle embed, Handle vocab, int redux);
+        Index vocab_start, Index vocab_size, HandleRef index, HandleRef embed,
+        HandleRef vocab, HandleRef tmp, int redux);
 
 template
 void submit<fp64_t>(Index m, Index n, Index k, Index k_start, Index k_size,
-        Handle index, Handle embed, Handle vocab, int redux);
+        Index vocab_start, Index vocab_size, HandleRef index, HandleRef embed,
+        HandleRef vocab, HandleRef tmp, int redux);
 
 } // namespace embedding_backward
 } // namespace starpu
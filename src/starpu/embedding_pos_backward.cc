@@ -0,0 +1,188 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/embedding_pos_backward.cc
+ * Backward of embeddings of tokens and positions within StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/embedding_pos_backward.hh"
+#include "nntile/kernel/embedding_pos_backward.hh"
+
+namespace nntile
+{
+namespace starpu
+{
+namespace embedding_pos_backward
+{
+
+//! Accumulate gradients of both tables within StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const Index *index = interfaces[0]->get_ptr<Index>();
+    const Index *pos = interfaces[1]->get_ptr<Index>();
+    const T *embed = interfaces[2]->get_ptr<T>();
+    T *vocab = interfaces[3]->get_ptr<T>();
+    T *pos_vocab = interfaces[4]->get_ptr<T>();
+    Index *tmp = interfaces[5]->get_ptr<Index>();
+    // Accumulate gradients
+    kernel::embedding_pos_backward::cpu<T>(args->m, args->n, args->k,
+            args->k_start, args->k_size, args->pos_size, index, pos, embed,
+            vocab, pos_vocab, tmp);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Accumulate gradients of both tables within StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const Index *index = interfaces[0]->get_ptr<Index>();
+    const Index *pos = interfaces[1]->get_ptr<Index>();
+    const T *embed = interfaces[2]->get_ptr<T>();
+    T *vocab = interfaces[3]->get_ptr<T>();
+    T *pos_vocab = interfaces[4]->get_ptr<T>();
+    Index *tmp = interfaces[5]->get_ptr<Index>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Accumulate gradients
+    kernel::embedding_pos_backward::cuda<T>(stream, args->m, args->n,
+            args->k, args->k_start, args->k_size, args->pos_size, index, pos,
+            embed, vocab, pos_vocab, tmp);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for tasks that depends only on cl_arg
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    // Apply hash over parameters m, n, k, k_size and pos_size
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    hash = starpu_hash_crc32c_be_n(&args->k, sizeof(args->k), hash);
+    hash = starpu_hash_crc32c_be_n(&args->k_size, sizeof(args->k_size), hash);
+    hash = starpu_hash_crc32c_be_n(&args->pos_size, sizeof(args->pos_size),
+            hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_embedding_pos_backward_fp32",
+            footprint,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_embedding_pos_backward_fp64",
+            footprint,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index m, Index n, Index k, Index k_start, Index k_size,
+        Index pos_size, HandleRef index, HandleRef pos, HandleRef embed,
+        HandleRef vocab, HandleRef pos_vocab, HandleRef tmp, int redux)
+//! Insert embedding_pos_backward task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception. Scratch buffer tmp shall hold at
+ * least m*n+pos_size indices.
+ * */
+{
+    // Codelet arguments
+    args_t *args = ArgsPool::allocate<args_t>();
+    args->m = m;
+    args->n = n;
+    args->k = k;
+    args->k_start = k_start;
+    args->k_size = k_size;
+    args->pos_size = pos_size;
+    fp64_t nflops = 2 * m * n * k_size;
+    // Access mode for the output vocab handles
+    enum starpu_data_access_mode vocab_mode;
+    if(redux != 0)
+    {
+        vocab_mode = STARPU_REDUX;
+    }
+    else
+    {
+        vocab_mode = Config::STARPU_RW_COMMUTE;
+    }
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(index),
+            STARPU_R, static_cast<starpu_data_handle_t>(pos),
+            STARPU_R, static_cast<starpu_data_handle_t>(embed),
+            vocab_mode, static_cast<starpu_data_handle_t>(vocab),
+            vocab_mode, static_cast<starpu_data_handle_t>(pos_vocab),
+            STARPU_SCRATCH, static_cast<starpu_data_handle_t>(tmp),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in embedding_pos_backward task "
+                "submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index m, Index n, Index k, Index k_start, Index k_size,
+        Index pos_size, HandleRef index, HandleRef pos, HandleRef embed,
+        HandleRef vocab, HandleRef pos_vocab, HandleRef tmp, int redux);
+
+template
+void submit<fp64_t>(Index m, Index n, Index k, Index k_start, Index k_size,
+        Index pos_size, HandleRef index, HandleRef pos, HandleRef embed,
+        HandleRef vocab, HandleRef pos_vocab, HandleRef tmp, int redux);
+
+} // namespace embedding_pos_backward
+} // namespace starpu
+} // namespace nntile
+
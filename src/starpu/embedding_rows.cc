@@ -0,0 +1,103 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/embedding_rows.cc
+ * Mark rows of vocabulary, used by tokens, within StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-13
+ * */
+
+#include "nntile/starpu/embedding_rows.hh"
+#include "nntile/kernel/embedding_rows.hh"
+
+namespace nntile
+{
+namespace starpu
+{
+namespace embedding_rows
+{
+
+//! Mark used rows of vocabulary within a StarPU buffer on CPU
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // No arguments
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    Index ntokens = interfaces[0]->elemsize / sizeof(Index);
+    const Index *index = interfaces[0]->get_ptr<Index>();
+    bool_t *rows = interfaces[1]->get_ptr<bool_t>();
+    // Launch kernel
+    kernel::embedding_rows::cpu(ntokens, index, rows);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Mark used rows of vocabulary within a StarPU buffer on CUDA
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // No arguments
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    Index ntokens = interfaces[0]->elemsize / sizeof(Index);
+    const Index *index = interfaces[0]->get_ptr<Index>();
+    bool_t *rows = interfaces[1]->get_ptr<bool_t>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::embedding_rows::cuda(stream, ntokens, index, rows);
+}
+#endif // NNTILE_USE_CUDA
+
+Codelet codelet;
+
+void init()
+{
+    codelet.init("nntile_embedding_rows",
+            nullptr,
+            {cpu},
+#ifdef NNTILE_USE_CUDA
+            {cuda}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet.restore_where();
+}
+
+//! Insert task to mark rows of vocabulary, used by tokens
+/*! Tasks, that mark rows for different tiles of tokens, commute, as they
+ * only set entries of the mask to true.
+ * */
+void submit(HandleRef index, HandleRef rows)
+{
+    // Submit task
+    int ret = task_insert(&codelet,
+            STARPU_R, static_cast<starpu_data_handle_t>(index),
+            Config::STARPU_RW_COMMUTE, static_cast<starpu_data_handle_t>(rows),
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in embedding_rows task submission");
+    }
+}
+
+} // namespace embedding_rows
+} // namespace starpu
+} // namespace nntile
+
@@ -91,7 +91,7 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index nelems, T val, Handle data)
+void submit(Index nelems, T val, HandleRef data)
 //! Insert fill task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -99,13 +99,14 @@ void submit(Index nelems, T val, Handle data)
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->nelems = nelems;
     args->val = val;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_W, static_cast<starpu_data_handle_t>(data),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             0);
     // Check submission
     if(ret != 0)
@@ -116,10 +117,10 @@ void submit(Index nelems, T val, Handle data)
 
 // Explicit instantiaion
 template
-void submit<fp32_t>(Index nelems, fp32_t val, Handle data);
+void submit<fp32_t>(Index nelems, fp32_t val, HandleRef data);
 
 template
-void submit<fp64_t>(Index nelems, fp64_t val, Handle data);
+void submit<fp64_t>(Index nelems, fp64_t val, HandleRef data);
 
 } // namespace fill
 } // namespace starpu
@@ -0,0 +1,186 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/flash_attention.cc
+ * Fused single-pass flash attention forward
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#include "nntile/starpu/flash_attention.hh"
+#include "nntile/kernel/flash_attention.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace flash_attention
+{
+
+//! Fused attention forward update for StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *K = interfaces[0]->get_ptr<T>();
+    const T *Q = interfaces[1]->get_ptr<T>();
+    const T *V = interfaces[2]->get_ptr<T>();
+    T *maxsumexp = interfaces[3]->get_ptr<T>();
+    T *A = interfaces[4]->get_ptr<T>();
+    // Causal mask is not passed at all
+    const bool_t *mask = args->mask_causal ? nullptr
+        : interfaces[5]->get_ptr<bool_t>();
+    // Launch kernel
+    kernel::flash_attention::cpu<T>(args->seq, args->head, args->batch,
+            args->n_batch, args->kv_group, K, Q, mask, V, maxsumexp, A);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Fused attention forward update for StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *K = interfaces[0]->get_ptr<T>();
+    const T *Q = interfaces[1]->get_ptr<T>();
+    const T *V = interfaces[2]->get_ptr<T>();
+    T *maxsumexp = interfaces[3]->get_ptr<T>();
+    T *A = interfaces[4]->get_ptr<T>();
+    // Causal mask is not passed at all
+    const bool_t *mask = args->mask_causal ? nullptr
+        : interfaces[5]->get_ptr<bool_t>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::flash_attention::cuda<T>(stream, args->seq, args->head,
+            args->batch, args->n_batch, args->kv_group, K, Q, mask, V,
+            maxsumexp, A);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for flash_attention tasks
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    // Apply hash over parameters seq, head, batch, kv_group and mask_causal
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->seq, sizeof(args->seq), hash);
+    hash = starpu_hash_crc32c_be_n(&args->head, sizeof(args->head), hash);
+    hash = starpu_hash_crc32c_be_n(&args->batch, sizeof(args->batch), hash);
+    hash = starpu_hash_crc32c_be_n(&args->kv_group, sizeof(args->kv_group),
+            hash);
+    hash = starpu_hash_crc32c_be_n(&args->mask_causal,
+            sizeof(args->mask_causal), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_flash_attention_fp32",
+            footprint,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_flash_attention_fp64",
+            footprint,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index seq, Index head, Index batch, HandleRef K, HandleRef Q,
+        HandleRef mask, HandleRef V, HandleRef maxsumexp, HandleRef A,
+        Index n_batch, Index kv_group, int mask_causal)
+//! Insert flash_attention task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception. Handle of the mask is not used
+ * for a causal tile of mask, that is generated by the kernel.
+ * */
+{
+    // Codelet arguments
+    args_t *args = ArgsPool::allocate<args_t>();
+    args->seq = seq;
+    args->head = head;
+    args->batch = batch;
+    args->n_batch = n_batch;
+    args->kv_group = kv_group;
+    args->mask_causal = mask_causal;
+    // Tasks for different tiles of keys update the same running maxsumexp
+    // and output in any order. Mask is the last buffer, if any.
+    fp64_t nflops = 4 * seq * seq * head * batch;
+    starpu_data_descr descrs[6] = {
+        {static_cast<starpu_data_handle_t>(K), STARPU_R},
+        {static_cast<starpu_data_handle_t>(Q), STARPU_R},
+        {static_cast<starpu_data_handle_t>(V), STARPU_R},
+        {static_cast<starpu_data_handle_t>(maxsumexp),
+            Config::STARPU_RW_COMMUTE},
+        {static_cast<starpu_data_handle_t>(A), Config::STARPU_RW_COMMUTE},
+        {static_cast<starpu_data_handle_t>(mask), STARPU_R}};
+    int ret = task_insert(codelet<T>(),
+            STARPU_DATA_MODE_ARRAY, descrs, mask_causal ? 5 : 6,
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in flash_attention task submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index seq, Index head, Index batch, HandleRef K,
+        HandleRef Q, HandleRef mask, HandleRef V, HandleRef maxsumexp,
+        HandleRef A, Index n_batch, Index kv_group, int mask_causal);
+
+template
+void submit<fp64_t>(Index seq, Index head, Index batch, HandleRef K,
+        HandleRef Q, HandleRef mask, HandleRef V, HandleRef maxsumexp,
+        HandleRef A, Index n_batch, Index kv_group, int mask_causal);
+
+} // namespace flash_attention
+} // namespace starpu
+} // namespace nntile
+
@@ -0,0 +1,198 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/flash_attention_backward.cc
+ * Fused single-pass flash attention backward
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#include "nntile/starpu/flash_attention_backward.hh"
+#include "nntile/kernel/flash_attention_backward.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace flash_attention_backward
+{
+
+//! Fused attention backward for StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *K = interfaces[0]->get_ptr<T>();
+    const T *Q = interfaces[1]->get_ptr<T>();
+    const T *maxsumexp = interfaces[2]->get_ptr<T>();
+    const T *dA = interfaces[3]->get_ptr<T>();
+    const T *V = interfaces[4]->get_ptr<T>();
+    const T *sumprod_slice = interfaces[5]->get_ptr<T>();
+    T *dQ = interfaces[6]->get_ptr<T>();
+    T *dK = interfaces[7]->get_ptr<T>();
+    T *dV = interfaces[8]->get_ptr<T>();
+    // Causal mask is not passed at all
+    const bool_t *mask = args->mask_causal ? nullptr
+        : interfaces[9]->get_ptr<bool_t>();
+    // Launch kernel
+    kernel::flash_attention_backward::cpu<T>(args->seq, args->head,
+            args->batch, K, Q, mask, maxsumexp, dA, V, sumprod_slice, dQ, dK,
+            dV);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Fused attention backward for StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *K = interfaces[0]->get_ptr<T>();
+    const T *Q = interfaces[1]->get_ptr<T>();
+    const T *maxsumexp = interfaces[2]->get_ptr<T>();
+    const T *dA = interfaces[3]->get_ptr<T>();
+    const T *V = interfaces[4]->get_ptr<T>();
+    const T *sumprod_slice = interfaces[5]->get_ptr<T>();
+    T *dQ = interfaces[6]->get_ptr<T>();
+    T *dK = interfaces[7]->get_ptr<T>();
+    T *dV = interfaces[8]->get_ptr<T>();
+    // Causal mask is not passed at all
+    const bool_t *mask = args->mask_causal ? nullptr
+        : interfaces[9]->get_ptr<bool_t>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::flash_attention_backward::cuda<T>(stream, args->seq, args->head,
+            args->batch, K, Q, mask, maxsumexp, dA, V, sumprod_slice, dQ, dK,
+            dV);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for flash_attention_backward tasks
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    // Apply hash over parameters seq, head, batch and mask_causal
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->seq, sizeof(args->seq), hash);
+    hash = starpu_hash_crc32c_be_n(&args->head, sizeof(args->head), hash);
+    hash = starpu_hash_crc32c_be_n(&args->batch, sizeof(args->batch), hash);
+    hash = starpu_hash_crc32c_be_n(&args->mask_causal,
+            sizeof(args->mask_causal), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_flash_attention_backward_fp32",
+            footprint,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_flash_attention_backward_fp64",
+            footprint,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index seq, Index head, Index batch, HandleRef K, HandleRef Q,
+        HandleRef mask, HandleRef maxsumexp, HandleRef dA, HandleRef V,
+        HandleRef sumprod_slice, HandleRef dQ, HandleRef dK, HandleRef dV,
+        int mask_causal)
+//! Insert flash_attention_backward task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception. Handle of the mask is not used
+ * for a causal tile of mask, that is generated by the kernel.
+ * */
+{
+    // Codelet arguments
+    args_t *args = ArgsPool::allocate<args_t>();
+    args->seq = seq;
+    args->head = head;
+    args->batch = batch;
+    args->mask_causal = mask_causal;
+    // Gradients are accumulated in any order. Mask is the last buffer, if
+    // any.
+    fp64_t nflops = 10 * seq * seq * head * batch;
+    starpu_data_descr descrs[10] = {
+        {static_cast<starpu_data_handle_t>(K), STARPU_R},
+        {static_cast<starpu_data_handle_t>(Q), STARPU_R},
+        {static_cast<starpu_data_handle_t>(maxsumexp), STARPU_R},
+        {static_cast<starpu_data_handle_t>(dA), STARPU_R},
+        {static_cast<starpu_data_handle_t>(V), STARPU_R},
+        {static_cast<starpu_data_handle_t>(sumprod_slice), STARPU_R},
+        {static_cast<starpu_data_handle_t>(dQ), Config::STARPU_RW_COMMUTE},
+        {static_cast<starpu_data_handle_t>(dK), Config::STARPU_RW_COMMUTE},
+        {static_cast<starpu_data_handle_t>(dV), Config::STARPU_RW_COMMUTE},
+        {static_cast<starpu_data_handle_t>(mask), STARPU_R}};
+    int ret = task_insert(codelet<T>(),
+            STARPU_DATA_MODE_ARRAY, descrs, mask_causal ? 9 : 10,
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in flash_attention_backward task "
+                "submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index seq, Index head, Index batch, HandleRef K,
+        HandleRef Q, HandleRef mask, HandleRef maxsumexp, HandleRef dA,
+        HandleRef V, HandleRef sumprod_slice, HandleRef dQ, HandleRef dK,
+        HandleRef dV, int mask_causal);
+
+template
+void submit<fp64_t>(Index seq, Index head, Index batch, HandleRef K,
+        HandleRef Q, HandleRef mask, HandleRef maxsumexp, HandleRef dA,
+        HandleRef V, HandleRef sumprod_slice, HandleRef dQ, HandleRef dK,
+        HandleRef dV, int mask_causal);
+
+} // namespace flash_attention_backward
+} // namespace starpu
+} // namespace nntile
+
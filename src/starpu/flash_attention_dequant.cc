@@ -0,0 +1,193 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/flash_attention_dequant.cc
+ * Fused attention over quantized keys and values for StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/flash_attention_dequant.hh"
+#include "nntile/kernel/flash_attention_dequant.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for attention over quantized KV-cache
+namespace flash_attention_dequant
+{
+
+//! StarPU wrapper for kernel::flash_attention_dequant::cpu<Q>
+template<typename Q>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const Q *K = interfaces[0]->get_ptr<Q>();
+    const fp32_t *K_scale = interfaces[1]->get_ptr<fp32_t>();
+    const fp32_t *query = interfaces[2]->get_ptr<fp32_t>();
+    const Q *V = interfaces[3]->get_ptr<Q>();
+    const fp32_t *V_scale = interfaces[4]->get_ptr<fp32_t>();
+    fp32_t *maxsumexp = interfaces[5]->get_ptr<fp32_t>();
+    fp32_t *A = interfaces[6]->get_ptr<fp32_t>();
+    const bool_t *mask = interfaces[7]->get_ptr<bool_t>();
+    // Launch kernel
+    kernel::flash_attention_dequant::cpu<Q>(args->k_seq, args->q_seq,
+            args->head, args->batch, args->n_batch, args->kv_group,
+            args->mask_stride, K, K_scale, query, mask, V, V_scale,
+            maxsumexp, A);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! StarPU wrapper for kernel::flash_attention_dequant::cuda<Q>
+template<typename Q>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const Q *K = interfaces[0]->get_ptr<Q>();
+    const fp32_t *K_scale = interfaces[1]->get_ptr<fp32_t>();
+    const fp32_t *query = interfaces[2]->get_ptr<fp32_t>();
+    const Q *V = interfaces[3]->get_ptr<Q>();
+    const fp32_t *V_scale = interfaces[4]->get_ptr<fp32_t>();
+    fp32_t *maxsumexp = interfaces[5]->get_ptr<fp32_t>();
+    fp32_t *A = interfaces[6]->get_ptr<fp32_t>();
+    const bool_t *mask = interfaces[7]->get_ptr<bool_t>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::flash_attention_dequant::cuda<Q>(stream, args->k_seq,
+            args->q_seq, args->head, args->batch, args->n_batch,
+            args->kv_group, args->mask_stride, K, K_scale, query, mask, V,
+            V_scale, maxsumexp, A);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for flash_attention_dequant tasks
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    // Apply hash over parameters k_seq, q_seq, head, batch and kv_group
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->k_seq, sizeof(args->k_seq), hash);
+    hash = starpu_hash_crc32c_be_n(&args->q_seq, sizeof(args->q_seq), hash);
+    hash = starpu_hash_crc32c_be_n(&args->head, sizeof(args->head), hash);
+    hash = starpu_hash_crc32c_be_n(&args->batch, sizeof(args->batch), hash);
+    hash = starpu_hash_crc32c_be_n(&args->kv_group, sizeof(args->kv_group),
+            hash);
+    return hash;
+}
+
+Codelet codelet_int8, codelet_fp8_e4m3;
+
+void init()
+{
+    codelet_int8.init("nntile_flash_attention_dequant_int8",
+            footprint,
+            {cpu<std::int8_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<std::int8_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp8_e4m3.init("nntile_flash_attention_dequant_fp8_e4m3",
+            footprint,
+            {cpu<fp8_e4m3_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp8_e4m3_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_int8.restrict_where(where);
+    codelet_fp8_e4m3.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_int8.restore_where();
+    codelet_fp8_e4m3.restore_where();
+}
+
+template<typename Q>
+void submit(Index k_seq, Index q_seq, Index head, Index batch, HandleRef K,
+        HandleRef K_scale, HandleRef query, HandleRef mask, HandleRef V,
+        HandleRef V_scale, HandleRef maxsumexp, HandleRef A, Index n_batch,
+        Index kv_group, Index mask_stride)
+//! Insert flash_attention_dequant task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t *args = ArgsPool::allocate<args_t>();
+    args->k_seq = k_seq;
+    args->q_seq = q_seq;
+    args->head = head;
+    args->batch = batch;
+    args->n_batch = n_batch;
+    args->kv_group = kv_group;
+    args->mask_stride = mask_stride;
+    // Tasks for different tiles of keys update the same running maxsumexp
+    // and output in any order
+    fp64_t nflops = 4 * k_seq * q_seq * head * batch;
+    int ret = task_insert(codelet<Q>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(K),
+            STARPU_R, static_cast<starpu_data_handle_t>(K_scale),
+            STARPU_R, static_cast<starpu_data_handle_t>(query),
+            STARPU_R, static_cast<starpu_data_handle_t>(V),
+            STARPU_R, static_cast<starpu_data_handle_t>(V_scale),
+            Config::STARPU_RW_COMMUTE,
+            static_cast<starpu_data_handle_t>(maxsumexp),
+            Config::STARPU_RW_COMMUTE, static_cast<starpu_data_handle_t>(A),
+            STARPU_R, static_cast<starpu_data_handle_t>(mask),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in flash_attention_dequant task "
+                "submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<std::int8_t>(Index k_seq, Index q_seq, Index head, Index batch,
+        HandleRef K, HandleRef K_scale, HandleRef query, HandleRef mask,
+        HandleRef V, HandleRef V_scale, HandleRef maxsumexp, HandleRef A,
+        Index n_batch, Index kv_group, Index mask_stride);
+
+template
+void submit<fp8_e4m3_t>(Index k_seq, Index q_seq, Index head, Index batch,
+        HandleRef K, HandleRef K_scale, HandleRef query, HandleRef mask,
+        HandleRef V, HandleRef V_scale, HandleRef maxsumexp, HandleRef A,
+        Index n_batch, Index kv_group, Index mask_stride);
+
+} // namespace flash_attention_dequant
+} // namespace starpu
+} // namespace nntile
+
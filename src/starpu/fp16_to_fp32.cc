@@ -80,14 +80,15 @@ void restore_where()
     codelet.restore_where();
 }
 
-void submit(Index nelems, Handle src, Handle dst)
+void submit(Index nelems, HandleRef src, HandleRef dst)
 {
-    Index *nelems_ = new Index{nelems};
+    Index *nelems_ = ArgsPool::allocate<Index>(nelems);
     //fp64_t nflops = 5 * nelems;
-    int ret = starpu_task_insert(&codelet,
+    int ret = task_insert(&codelet,
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_W, static_cast<starpu_data_handle_t>(dst),
-            STARPU_CL_ARGS, nelems_, sizeof(*nelems_),
+            STARPU_CL_ARGS_NFREE, nelems_, sizeof(*nelems_),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, nelems_,
             //STARPU_FLOPS, nflops,
             0);
     // Check submission
@@ -0,0 +1,212 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/fused_elementwise.cc
+ * Chain of elementwise operations on StarPU buffers by a single task
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/starpu/fused_elementwise.hh"
+#include "nntile/kernel/fused_elementwise.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for a chain of elementwise operations
+namespace fused_elementwise
+{
+
+using kernel::fused_elementwise::MAX_BUFFERS;
+using kernel::fused_elementwise::program_t;
+
+//! Apply a program of elementwise operations on StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    T *ptr[MAX_BUFFERS];
+    for(int j = 0; j < args->program.nbuffers; ++j)
+    {
+        ptr[j] = interfaces[j]->get_ptr<T>();
+    }
+    // Launch kernel
+    kernel::fused_elementwise::cpu<T>(args->nelems, args->program, ptr);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Apply a program of elementwise operations on StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    T *ptr[MAX_BUFFERS];
+    for(int j = 0; j < args->program.nbuffers; ++j)
+    {
+        ptr[j] = interfaces[j]->get_ptr<T>();
+    }
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::fused_elementwise::cuda<T>(stream, args->nelems, args->program,
+            ptr);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for fused tasks depends on size of buffers and operations
+template<typename T>
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(task->cl_arg);
+    const program_t<T> &program = args->program;
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->nelems, sizeof(args->nelems), hash);
+    for(int k = 0; k < program.nops; ++k)
+    {
+        hash = starpu_hash_crc32c_be_n(&program.ops[k].code,
+                sizeof(program.ops[k].code), hash);
+    }
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_fused_elementwise_fp32",
+            footprint<fp32_t>,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_fused_elementwise_fp64",
+            footprint<fp64_t>,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index nelems, const program_t<T> &program,
+        const std::vector<Handle> &buffers)
+//! Insert a task with a program of elementwise operations into StarPU pool
+/*! Access mode of each buffer is derived from the program: buffers, that
+ * are only read, are accessed in the STARPU_R mode, buffers that are
+ * written before being read are accessed in the STARPU_W mode, and all the
+ * other buffers are accessed in the STARPU_RW mode. Unused buffers are not
+ * passed to the task at all.
+ * */
+{
+    if(buffers.size() != std::size_t(program.nbuffers))
+    {
+        throw std::runtime_error("Wrong number of buffers in "
+                "fused_elementwise");
+    }
+    if(program.nops == 0)
+    {
+        return;
+    }
+    // Renumber buffers, so that only the used ones are passed to the task
+    bool load[MAX_BUFFERS], store[MAX_BUFFERS];
+    kernel::fused_elementwise::get_access<T>(program, load, store);
+    int index[MAX_BUFFERS];
+    std::vector<starpu_data_descr> descrs;
+    for(int j = 0; j < program.nbuffers; ++j)
+    {
+        index[j] = -1;
+        if(not load[j] and not store[j])
+        {
+            continue;
+        }
+        index[j] = descrs.size();
+        descrs.emplace_back();
+        descrs.back().handle = static_cast<starpu_data_handle_t>(buffers[j]);
+        if(not store[j])
+        {
+            descrs.back().mode = STARPU_R;
+        }
+        else if(not load[j])
+        {
+            descrs.back().mode = STARPU_W;
+        }
+        else
+        {
+            descrs.back().mode = STARPU_RW;
+        }
+    }
+    // Codelet arguments
+    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args->nelems = nelems;
+    args->program = program;
+    args->program.nbuffers = descrs.size();
+    for(int k = 0; k < program.nops; ++k)
+    {
+        // Sources, that are not read, may be unused buffers
+        auto &op = args->program.ops[k];
+        op.dst = index[op.dst];
+        op.src = (index[op.src] >= 0) ? index[op.src] : op.dst;
+    }
+    fp64_t nflops = 3 * program.nops * nelems;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_DATA_MODE_ARRAY, descrs.data(), int(descrs.size()),
+            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in fused_elementwise task "
+                "submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index nelems, const program_t<fp32_t> &program,
+        const std::vector<Handle> &buffers);
+
+template
+void submit<fp64_t>(Index nelems, const program_t<fp64_t> &program,
+        const std::vector<Handle> &buffers);
+
+} // namespace fused_elementwise
+} // namespace starpu
+} // namespace nntile
+
@@ -92,14 +92,15 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index nelems, Handle data)
+void submit(Index nelems, HandleRef data)
 {
-    Index *nelems_ = new Index{nelems};
-    //fp64_t nflops = 5 * nelems;
-    int ret = starpu_task_insert(codelet<T>(),
+    Index *nelems_ = ArgsPool::allocate<Index>(nelems);
+    fp64_t nflops = 10 * nelems;
+    int ret = task_insert(codelet<T>(),
             STARPU_RW, static_cast<starpu_data_handle_t>(data),
-            STARPU_CL_ARGS, nelems_, sizeof(*nelems_),
-            //STARPU_FLOPS, nflops,
+            STARPU_CL_ARGS_NFREE, nelems_, sizeof(*nelems_),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, nelems_,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -110,10 +111,10 @@ void submit(Index nelems, Handle data)
 
 // Explicit instantiaion
 template
-void submit<fp32_t>(Index nelems, Handle data);
+void submit<fp32_t>(Index nelems, HandleRef data);
 
 template
-void submit<fp64_t>(Index nelems, Handle data);
+void submit<fp64_t>(Index nelems, HandleRef data);
 
 } // namespace gelu
 } // namespace starpu
@@ -94,17 +94,17 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index nelems, Handle src, Handle dst)
+void submit(Index nelems, HandleRef src, HandleRef dst)
 {
     // Codelet arguments
-    Index *nelems_ = (Index *)std::malloc(sizeof(*nelems_));
-    *nelems_ = nelems;
-    //fp64_t nflops = 5 * nelems;
-    int ret = starpu_task_insert(codelet<T>(),
+    Index *nelems_ = ArgsPool::allocate<Index>(nelems);
+    fp64_t nflops = 10 * nelems;
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_W, static_cast<starpu_data_handle_t>(dst),
-            STARPU_CL_ARGS, nelems_, sizeof(*nelems_),
-            //STARPU_FLOPS, nflops,
+            STARPU_CL_ARGS_NFREE, nelems_, sizeof(*nelems_),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, nelems_,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -115,10 +115,10 @@ void submit(Index nelems, Handle src, Handle dst)
 
 // Explicit instantiaion
 template
-void submit<fp32_t>(Index nelems, Handle src, Handle dst);
+void submit<fp32_t>(Index nelems, HandleRef src, HandleRef dst);
 
 template
-void submit<fp64_t>(Index nelems, Handle src, Handle dst);
+void submit<fp64_t>(Index nelems, HandleRef src, HandleRef dst);
 
 } // namespace gelutanh
 } // namespace starpu
@@ -54,7 +54,7 @@ void cuda(void *buffers[], void *cl_args)
 }
 #endif // NNTILE_USE_CUDA
 
-Codelet codelet_fp32, codelet_fp64;
+Codelet codelet_fp32, codelet_fp64, codelet_bf16, codelet_fp16;
 
 void init()
 {
@@ -74,6 +74,24 @@ void init()
             {cuda<fp64_t>}
 #else // NNTILE_USE_CUDA
             {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_bf16.init("nntile_gelutanh_inplace_bf16",
+            nullptr,
+            {cpu<bf16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<bf16_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp16.init("nntile_gelutanh_inplace_fp16",
+            nullptr,
+            {cpu<fp16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp16_t>}
+#else // NNTILE_USE_CUDA
+            {}
 #endif // NNTILE_USE_CUDA
             );
 }
@@ -82,23 +100,28 @@ void restrict_where(uint32_t where)
 {
     codelet_fp32.restrict_where(where);
     codelet_fp64.restrict_where(where);
+    codelet_bf16.restrict_where(where);
+    codelet_fp16.restrict_where(where);
 }
 
 void restore_where()
 {
     codelet_fp32.restore_where();
     codelet_fp64.restore_where();
+    codelet_bf16.restore_where();
+    codelet_fp16.restore_where();
 }
 
 template<typename T>
-void submit(Index nelems, Handle data)
+void submit(Index nelems, HandleRef data)
 {
-    Index *nelems_ = new Index{nelems};
-    //fp64_t nflops = 5 * nelems;
-    int ret = starpu_task_insert(codelet<T>(),
+    Index *nelems_ = ArgsPool::allocate<Index>(nelems);
+    fp64_t nflops = 10 * nelems;
+    int ret = task_insert(codelet<T>(),
             STARPU_RW, static_cast<starpu_data_handle_t>(data),
-            STARPU_CL_ARGS, nelems_, sizeof(*nelems_),
-            //STARPU_FLOPS, nflops,
+            STARPU_CL_ARGS_NFREE, nelems_, sizeof(*nelems_),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, nelems_,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -109,10 +132,16 @@ void submit(Index nelems, Handle data)
 
 // Explicit instantiaion
 template
-void submit<fp32_t>(Index nelems, Handle data);
+void submit<fp32_t>(Index nelems, HandleRef data);
+
+template
+void submit<fp64_t>(Index nelems, HandleRef data);
+
+template
+void submit<bf16_t>(Index nelems, HandleRef data);
 
 template
-void submit<fp64_t>(Index nelems, Handle data);
+void submit<fp16_t>(Index nelems, HandleRef data);
 
 } // namespace gelutanh_inplace
 } // namespace starpu
@@ -0,0 +1,184 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/gemm_dequant.cc
+ * Gemm with dequantization of 8-bit weights on the fly on StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/starpu/gemm_dequant.hh"
+#include "nntile/kernel/gemm_dequant.hh"
+#include "nntile/kernel/parallel.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for gemm with quantized weights
+namespace gemm_dequant
+{
+
+//! StarPU wrapper for kernel::gemm_dequant::cpu<Q>
+template<typename Q>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const Q *A = interfaces[0]->get_ptr<Q>();
+    const fp32_t *scale = interfaces[1]->get_ptr<fp32_t>();
+    const fp32_t *B = interfaces[2]->get_ptr<fp32_t>();
+    fp32_t *C = interfaces[3]->get_ptr<fp32_t>();
+    // Use all threads of a parallel worker
+    kernel::parallel::Scope threads(starpu_combined_worker_get_size());
+    // Launch kernel
+    kernel::gemm_dequant::cpu<Q>(args->m, args->n, args->k, args->group,
+            args->alpha, A, scale, B, args->beta, C);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! StarPU wrapper for kernel::gemm_dequant::cuda<Q>
+template<typename Q>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const Q *A = interfaces[0]->get_ptr<Q>();
+    const fp32_t *scale = interfaces[1]->get_ptr<fp32_t>();
+    const fp32_t *B = interfaces[2]->get_ptr<fp32_t>();
+    fp32_t *C = interfaces[3]->get_ptr<fp32_t>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::gemm_dequant::cuda<Q>(stream, args->m, args->n, args->k,
+            args->group, args->alpha, A, scale, B, args->beta, C);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for gemm_dequant tasks
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    // Apply hash over parameters m, n, k and group
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    hash = starpu_hash_crc32c_be_n(&args->k, sizeof(args->k), hash);
+    hash = starpu_hash_crc32c_be_n(&args->group, sizeof(args->group), hash);
+    return hash;
+}
+
+Codelet codelet_int8, codelet_fp8_e4m3;
+
+void init()
+{
+    codelet_int8.init("nntile_gemm_dequant_int8",
+            footprint,
+            {cpu<std::int8_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<std::int8_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp8_e4m3.init("nntile_gemm_dequant_fp8_e4m3",
+            footprint,
+            {cpu<fp8_e4m3_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp8_e4m3_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    // CPU implementations may use all threads of parallel workers
+    codelet_int8.set_parallel();
+    codelet_fp8_e4m3.set_parallel();
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_int8.restrict_where(where);
+    codelet_fp8_e4m3.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_int8.restore_where();
+    codelet_fp8_e4m3.restore_where();
+}
+
+template<typename Q>
+void submit(Index m, Index n, Index k, Index group, fp32_t alpha, HandleRef A,
+        HandleRef scale, HandleRef B, fp32_t beta, HandleRef C)
+//! Insert gemm_dequant task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Access mode for C, zero beta does not read C, while accumulation of
+    // products of tiles commutes as in gemm
+    enum starpu_data_access_mode C_mode;
+    if(beta == 0)
+    {
+        C_mode = STARPU_W;
+    }
+    else
+    {
+        C_mode = Config::STARPU_RW_COMMUTE;
+    }
+    // Codelet arguments
+    args_t *args = ArgsPool::allocate<args_t>();
+    args->m = m;
+    args->n = n;
+    args->k = k;
+    args->group = group;
+    args->alpha = alpha;
+    args->beta = beta;
+    fp64_t nflops = 2 * m * n * k;
+    // Submit task
+    int ret = task_insert(codelet<Q>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(A),
+            STARPU_R, static_cast<starpu_data_handle_t>(scale),
+            STARPU_R, static_cast<starpu_data_handle_t>(B),
+            C_mode, static_cast<starpu_data_handle_t>(C),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in gemm_dequant task submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<std::int8_t>(Index m, Index n, Index k, Index group,
+        fp32_t alpha, HandleRef A, HandleRef scale, HandleRef B, fp32_t beta,
+        HandleRef C);
+
+template
+void submit<fp8_e4m3_t>(Index m, Index n, Index k, Index group,
+        fp32_t alpha, HandleRef A, HandleRef scale, HandleRef B, fp32_t beta,
+        HandleRef C);
+
+} // namespace gemm_dequant
+} // namespace starpu
+} // namespace nntile
+
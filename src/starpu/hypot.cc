@@ -99,7 +99,7 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index nelems, T alpha, Handle src, T beta, Handle dst)
+void submit(Index nelems, T alpha, HandleRef src, T beta, HandleRef dst)
 //! Insert hypot task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -137,16 +137,19 @@ void submit(Index nelems, T alpha, Handle src, T beta, Handle dst)
         dst_mode = STARPU_RW;
     }
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->nelems = nelems;
     args->alpha = alpha;
     args->beta = beta;
+    fp64_t nflops = 6 * nelems;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
-            dst_mode, static_cast<starpu_data_handle_t>(dst), 0);
-            // STARPU_FLOPS, nflops);
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            dst_mode, static_cast<starpu_data_handle_t>(dst),
+            STARPU_FLOPS, nflops,
+            0);
     // Check submission
     if(ret != 0)
     {
@@ -156,12 +159,12 @@ void submit(Index nelems, T alpha, Handle src, T beta, Handle dst)
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index nelems, fp32_t alpha, Handle src, fp32_t beta,
-        Handle dst);
+void submit<fp32_t>(Index nelems, fp32_t alpha, HandleRef src, fp32_t beta,
+        HandleRef dst);
 
 template
-void submit<fp64_t>(Index nelems, fp64_t alpha, Handle src, fp64_t beta,
-        Handle dst);
+void submit<fp64_t>(Index nelems, fp64_t alpha, HandleRef src, fp64_t beta,
+        HandleRef dst);
 
 } // namespace hypot
 } // namespace starpu
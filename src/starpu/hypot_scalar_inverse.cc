@@ -95,7 +95,7 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index nelems, T eps, T alpha, Handle dst)
+void submit(Index nelems, T eps, T alpha, HandleRef dst)
 //! Insert hypot_scalar_inverse task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -103,14 +103,17 @@ void submit(Index nelems, T eps, T alpha, Handle dst)
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->nelems = nelems;
     args->eps = eps;
     args->alpha = alpha;
+    fp64_t nflops = 4 * nelems;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -121,10 +124,10 @@ void submit(Index nelems, T eps, T alpha, Handle dst)
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index nelems, fp32_t eps, fp32_t alpha, Handle dst);
+void submit<fp32_t>(Index nelems, fp32_t eps, fp32_t alpha, HandleRef dst);
 
 template
-void submit<fp64_t>(Index nelems, fp64_t eps, fp64_t alpha, Handle dst);
+void submit<fp64_t>(Index nelems, fp64_t eps, fp64_t alpha, HandleRef dst);
 
 } // namespace hypot_scalar_inverse
 } // namespace starpu
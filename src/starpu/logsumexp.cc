@@ -93,7 +93,7 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index nelems, Handle maxsumexp, Handle logsumexp)
+void submit(Index nelems, HandleRef maxsumexp, HandleRef logsumexp)
 //! Insert logsumexp task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -101,14 +101,15 @@ void submit(Index nelems, Handle maxsumexp, Handle logsumexp)
  * */
 {
     // Codelet arguments
-    Index *nelems_ = (Index *)std::malloc(sizeof(*nelems_));
-    *nelems_ = nelems;
+    Index *nelems_ = ArgsPool::allocate<Index>(nelems);
+    fp64_t nflops = 2 * nelems;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(maxsumexp),
-            STARPU_CL_ARGS, nelems_, sizeof(*nelems_),
+            STARPU_CL_ARGS_NFREE, nelems_, sizeof(*nelems_),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, nelems_,
             STARPU_W, static_cast<starpu_data_handle_t>(logsumexp),
-            //STARPU_FLOPS, nflops,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -119,10 +120,10 @@ void submit(Index nelems, Handle maxsumexp, Handle logsumexp)
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index nelems, Handle maxsumexp, Handle logsumexp);
+void submit<fp32_t>(Index nelems, HandleRef maxsumexp, HandleRef logsumexp);
 
 template
-void submit<fp64_t>(Index nelems, Handle maxsumexp, Handle logsumexp);
+void submit<fp64_t>(Index nelems, HandleRef maxsumexp, HandleRef logsumexp);
 
 } // namespace logsumexp
 } // namespace starpu
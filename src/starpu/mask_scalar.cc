@@ -110,7 +110,7 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index nrows, Index ncols, Handle mask, T val, Handle data)
+void submit(Index nrows, Index ncols, HandleRef mask, T val, HandleRef data)
 //! Insert mask_scalar task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -118,15 +118,16 @@ void submit(Index nrows, Index ncols, Handle mask, T val, Handle data)
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->nrows = nrows;
     args->ncols = ncols;
     args->val = val;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_RW, static_cast<starpu_data_handle_t>(data),
             STARPU_R, static_cast<starpu_data_handle_t>(mask),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             0);
     // Check submission
     if(ret != 0)
@@ -137,12 +138,12 @@ void submit(Index nrows, Index ncols, Handle mask, T val, Handle data)
 
 // Explicit instantiaion
 template
-void submit<fp32_t>(Index nrows, Index ncols, Handle mask, fp32_t val,
-        Handle data);
+void submit<fp32_t>(Index nrows, Index ncols, HandleRef mask, fp32_t val,
+        HandleRef data);
 
 template
-void submit<fp64_t>(Index nrows, Index ncols, Handle mask, fp64_t val,
-        Handle data);
+void submit<fp64_t>(Index nrows, Index ncols, HandleRef mask, fp64_t val,
+        HandleRef data);
 
 } // namespace mask_scalar
 } // namespace starpu
@@ -14,6 +14,7 @@
 
 #include "nntile/starpu/maxsumexp.hh"
 #include "nntile/kernel/maxsumexp.hh"
+#include "nntile/kernel/parallel.hh"
 #include <cstdlib>
 
 namespace nntile
@@ -34,6 +35,8 @@ void cpu(void *buffers[], void *cl_args)
     auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
     const T *src = interfaces[0]->get_ptr<T>();
     T *dst = interfaces[1]->get_ptr<T>();
+    // Use all threads of a parallel worker
+    kernel::parallel::Scope threads(starpu_combined_worker_get_size());
     // Launch kernel
     kernel::maxsumexp::cpu<T>(args->m, args->n, args->k, src, dst);
 }
@@ -73,7 +76,7 @@ uint32_t footprint(struct starpu_task *task)
     return hash;
 }
 
-Codelet codelet_fp32, codelet_fp64;
+Codelet codelet_fp32, codelet_fp64, codelet_bf16, codelet_fp16;
 
 void init()
 {
@@ -95,22 +98,49 @@ void init()
             {}
 #endif // NNTILE_USE_CUDA
             );
+    codelet_bf16.init("nntile_maxsumexp_bf16",
+            footprint,
+            {cpu<bf16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<bf16_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp16.init("nntile_maxsumexp_fp16",
+            footprint,
+            {cpu<fp16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp16_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    // CPU implementations may use all threads of parallel workers
+    codelet_fp32.set_parallel();
+    codelet_fp64.set_parallel();
+    codelet_bf16.set_parallel();
+    codelet_fp16.set_parallel();
 }
 
 void restrict_where(uint32_t where)
 {
     codelet_fp32.restrict_where(where);
     codelet_fp64.restrict_where(where);
+    codelet_bf16.restrict_where(where);
+    codelet_fp16.restrict_where(where);
 }
 
 void restore_where()
 {
     codelet_fp32.restore_where();
     codelet_fp64.restore_where();
+    codelet_bf16.restore_where();
+    codelet_fp16.restore_where();
 }
 
 template<typename T>
-void submit(Index m, Index n, Index k, Handle src, Handle dst, int redux)
+void submit(Index m, Index n, Index k, HandleRef src, HandleRef dst, int redux)
 //! Insert maxsumexp task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -118,11 +148,11 @@ void submit(Index m, Index n, Index k, Handle src, Handle dst, int redux)
  * */
 {
     // Codelet arguments
-    args_t *args = (args_t *)std::malloc(sizeof(*args));
+    args_t *args = ArgsPool::allocate<args_t>();
     args->m = m;
     args->n = n;
     args->k = k;
-    //fp64_t nflops = m * n * k;
+    fp64_t nflops = 3 * m * n * k;
     // Access mode for the dst handle
     enum starpu_data_access_mode dst_mode;
     if(redux != 0)
@@ -135,11 +165,12 @@ void submit(Index m, Index n, Index k, Handle src, Handle dst, int redux)
         dst_mode = Config::STARPU_RW_COMMUTE;
     }
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             dst_mode, static_cast<starpu_data_handle_t>(dst),
-            //STARPU_FLOPS, nflops,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -150,11 +181,19 @@ void submit(Index m, Index n, Index k, Handle src, Handle dst, int redux)
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index m, Index n, Index k, Handle src, Handle dst,
+void submit<fp32_t>(Index m, Index n, Index k, HandleRef src, HandleRef dst,
+        int redux);
+
+template
+void submit<fp64_t>(Index m, Index n, Index k, HandleRef src, HandleRef dst,
+        int redux);
+
+template
+void submit<bf16_t>(Index m, Index n, Index k, HandleRef src, HandleRef dst,
         int redux);
 
 template
-void submit<fp64_t>(Index m, Index n, Index k, Handle src, Handle dst,
+void submit<fp16_t>(Index m, Index n, Index k, HandleRef src, HandleRef dst,
         int redux);
 
 } // namespace maxsumexp
@@ -0,0 +1,206 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/moe_dispatch.cc
+ * StarPU wrappers for gather of tokens into buffers of experts
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/moe_dispatch.hh"
+#include "nntile/kernel/moe_dispatch.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for gather of tokens into buffers of experts
+namespace moe_dispatch
+{
+
+//! Gather tokens of a tile into a buffer of an expert on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const Index *slots = interfaces[0]->get_ptr<Index>();
+    const T *probs = args->weighted ? interfaces[1]->get_ptr<T>()
+        : nullptr;
+    const T *src = interfaces[args->weighted ? 2 : 1]->get_ptr<T>();
+    T *dst = interfaces[args->weighted ? 3 : 2]->get_ptr<T>();
+    // Launch kernel
+    kernel::moe_dispatch::cpu<T>(args->m, args->seq, args->seq_start,
+            args->seq_size, args->batch_start, args->batch_size,
+            args->capacity, args->n_experts, args->expert, slots, probs, src,
+            dst);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Gather tokens of a tile into a buffer of an expert on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const Index *slots = interfaces[0]->get_ptr<Index>();
+    const T *probs = args->weighted ? interfaces[1]->get_ptr<T>()
+        : nullptr;
+    const T *src = interfaces[args->weighted ? 2 : 1]->get_ptr<T>();
+    T *dst = interfaces[args->weighted ? 3 : 2]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::moe_dispatch::cuda<T>(stream, args->m, args->seq, args->seq_start,
+            args->seq_size, args->batch_start, args->batch_size,
+            args->capacity, args->n_experts, args->expert, slots, probs, src,
+            dst);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for moe_dispatch tasks
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    // Apply hash over parameters m, seq_size, batch_size and capacity
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->seq_size, sizeof(args->seq_size),
+            hash);
+    hash = starpu_hash_crc32c_be_n(&args->batch_size,
+            sizeof(args->batch_size), hash);
+    hash = starpu_hash_crc32c_be_n(&args->capacity, sizeof(args->capacity),
+            hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_moe_dispatch_fp32",
+            footprint,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_moe_dispatch_fp64",
+            footprint,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index m, Index seq, Index seq_start, Index seq_size,
+        Index batch_start, Index batch_size, Index capacity, Index n_experts,
+        Index expert, HandleRef slots, HandleRef probs, HandleRef src,
+        HandleRef dst)
+//! Insert moe_dispatch task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ *
+ * Slots of tokens of other tiles are not touched, so that tasks over all the
+ * tiles of tokens commute. Empty handle of probs means unit weights.
+ * */
+{
+    // Codelet arguments
+    args_t *args = ArgsPool::allocate<args_t>();
+    args->m = m;
+    args->seq = seq;
+    args->seq_start = seq_start;
+    args->seq_size = seq_size;
+    args->batch_start = batch_start;
+    args->batch_size = batch_size;
+    args->capacity = capacity;
+    args->n_experts = n_experts;
+    args->expert = expert;
+    args->weighted = static_cast<starpu_data_handle_t>(probs)
+        != nullptr;
+    fp64_t nflops = 2 * m * capacity;
+    // Tasks over different tiles accumulate into the same output
+    enum starpu_data_access_mode dst_mode = Config::STARPU_RW_COMMUTE;
+    // Submit task
+    int ret;
+    if(args->weighted)
+    {
+        ret = task_insert(codelet<T>(),
+                STARPU_R, static_cast<starpu_data_handle_t>(slots),
+                STARPU_R, static_cast<starpu_data_handle_t>(probs),
+                STARPU_R, static_cast<starpu_data_handle_t>(src),
+                dst_mode, static_cast<starpu_data_handle_t>(dst),
+                STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+                STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+                STARPU_FLOPS, nflops,
+                0);
+    }
+    else
+    {
+        ret = task_insert(codelet<T>(),
+                STARPU_R, static_cast<starpu_data_handle_t>(slots),
+                STARPU_R, static_cast<starpu_data_handle_t>(src),
+                dst_mode, static_cast<starpu_data_handle_t>(dst),
+                STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+                STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+                STARPU_FLOPS, nflops,
+                0);
+    }
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in moe_dispatch task "
+                "submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index m, Index seq, Index seq_start, Index seq_size,
+        Index batch_start, Index batch_size, Index capacity, Index n_experts,
+        Index expert, HandleRef slots, HandleRef probs, HandleRef src,
+        HandleRef dst);
+
+template
+void submit<fp64_t>(Index m, Index seq, Index seq_start, Index seq_size,
+        Index batch_start, Index batch_size, Index capacity, Index n_experts,
+        Index expert, HandleRef slots, HandleRef probs, HandleRef src,
+        HandleRef dst);
+
+} // namespace moe_dispatch
+} // namespace starpu
+} // namespace nntile
+
@@ -0,0 +1,133 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/moe_route.cc
+ * StarPU wrappers for routing of tokens to experts
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/moe_route.hh"
+#include "nntile/kernel/moe_route.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for routing of tokens to experts
+namespace moe_route
+{
+
+//! Assign tokens to slots of experts on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const Index *experts = interfaces[0]->get_ptr<Index>();
+    Index *slots = interfaces[1]->get_ptr<Index>();
+    T *load = interfaces[2]->get_ptr<T>();
+    // Launch kernel
+    kernel::moe_route::cpu<T>(args->k, args->n_tokens, args->n_experts,
+            args->capacity, experts, slots, load);
+}
+
+//! Footprint for moe_route tasks
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    // Apply hash over parameters k, n_tokens and n_experts
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->k, sizeof(args->k), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n_tokens, sizeof(args->n_tokens),
+            hash);
+    hash = starpu_hash_crc32c_be_n(&args->n_experts, sizeof(args->n_experts),
+            hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    // Routing is a short sequential pass, that is done on CPU
+    codelet_fp32.init("nntile_moe_route_fp32",
+            footprint,
+            {cpu<fp32_t>},
+            {}
+            );
+    codelet_fp64.init("nntile_moe_route_fp64",
+            footprint,
+            {cpu<fp64_t>},
+            {}
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index k, Index n_tokens, Index n_experts, Index capacity,
+        HandleRef experts, HandleRef slots, HandleRef load)
+//! Insert moe_route task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t *args = ArgsPool::allocate<args_t>();
+    args->k = k;
+    args->n_tokens = n_tokens;
+    args->n_experts = n_experts;
+    args->capacity = capacity;
+    fp64_t nflops = k * n_tokens;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(experts),
+            STARPU_W, static_cast<starpu_data_handle_t>(slots),
+            STARPU_W, static_cast<starpu_data_handle_t>(load),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in moe_route task submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index k, Index n_tokens, Index n_experts, Index capacity,
+        HandleRef experts, HandleRef slots, HandleRef load);
+
+template
+void submit<fp64_t>(Index k, Index n_tokens, Index n_experts, Index capacity,
+        HandleRef experts, HandleRef slots, HandleRef load);
+
+} // namespace moe_route
+} // namespace starpu
+} // namespace nntile
+
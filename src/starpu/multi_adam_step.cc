@@ -0,0 +1,253 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/multi_adam_step.cc
+ * Fused Adam and AdamW steps on many StarPU buffers by a single task
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-02
+ * */
+
+#include "nntile/starpu/multi_adam_step.hh"
+#include "nntile/kernel/multi_adam_step.hh"
+#include "nntile/kernel/parallel.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for one step of Adam or AdamW on many buffers
+namespace multi_adam_step
+{
+
+// Buffers of a task are grad, first_moment, second_moment and p of the first
+// tensor, followed by the same buffers of the second tensor and so on. An
+// optional buffer with learning rate and scale of gradients is the last one.
+static constexpr int NBUFFERS_PER_TENSOR = 4;
+
+// Get pointers to buffers and their sizes
+template<typename T>
+static void get_buffers(Index ntensors, void *buffers[],
+        std::vector<Index> &num_elems, std::vector<T *> &grad,
+        std::vector<T *> &first_moment, std::vector<T *> &second_moment,
+        std::vector<T *> &p)
+{
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    num_elems.resize(ntensors);
+    grad.resize(ntensors);
+    first_moment.resize(ntensors);
+    second_moment.resize(ntensors);
+    p.resize(ntensors);
+    for(Index j = 0; j < ntensors; ++j)
+    {
+        auto tensor_interfaces = interfaces + NBUFFERS_PER_TENSOR*j;
+        num_elems[j] = tensor_interfaces[0]->elemsize / sizeof(T);
+        grad[j] = tensor_interfaces[0]->get_ptr<T>();
+        first_moment[j] = tensor_interfaces[1]->get_ptr<T>();
+        second_moment[j] = tensor_interfaces[2]->get_ptr<T>();
+        p[j] = tensor_interfaces[3]->get_ptr<T>();
+    }
+}
+
+// Get pointer to learning rate and scale of gradients, if they are given
+template<typename T>
+static const T *get_scalars(const args_t<T> *args, void *buffers[])
+{
+    if(not args->scaled)
+    {
+        return nullptr;
+    }
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    Index ntensors = args->ntensors;
+    return interfaces[NBUFFERS_PER_TENSOR*ntensors]->get_ptr<T>();
+}
+
+//! Apply Adam or AdamW step on StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    std::vector<Index> num_elems;
+    std::vector<T *> grad, first_moment, second_moment, p;
+    get_buffers<T>(args->ntensors, buffers, num_elems, grad, first_moment,
+            second_moment, p);
+    const T *scalars = get_scalars<T>(args, buffers);
+    // Use all threads of a parallel worker
+    kernel::parallel::Scope threads(starpu_combined_worker_get_size());
+    // Launch kernel
+    kernel::multi_adam_step::cpu<T>(args->ntensors, num_elems.data(),
+            args->num_iter, args->beta_1, args->beta_2, args->eps, args->lr,
+            args->weight_decay, args->decoupled, grad.data(),
+            first_moment.data(), second_moment.data(), p.data(), scalars);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Apply Adam or AdamW step on StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    std::vector<Index> num_elems;
+    std::vector<T *> grad, first_moment, second_moment, p;
+    get_buffers<T>(args->ntensors, buffers, num_elems, grad, first_moment,
+            second_moment, p);
+    const T *scalars = get_scalars<T>(args, buffers);
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::multi_adam_step::cuda<T>(stream, args->ntensors,
+            num_elems.data(), args->num_iter, args->beta_1, args->beta_2,
+            args->eps, args->lr, args->weight_decay, args->decoupled,
+            grad.data(), first_moment.data(), second_moment.data(),
+            p.data(), scalars);
+}
+#endif // NNTILE_USE_CUDA
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_multi_adam_step_fp32",
+            nullptr,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_multi_adam_step_fp64",
+            nullptr,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    // CPU implementations may use all threads of parallel workers
+    codelet_fp32.set_parallel();
+    codelet_fp64.set_parallel();
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index num_iter, T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        bool decoupled, const std::vector<Handle> &grad,
+        const std::vector<Handle> &first_moment,
+        const std::vector<Handle> &second_moment,
+        const std::vector<Handle> &p, HandleRef scalars)
+{
+    Index ntensors = p.size();
+    if(grad.size() != ntensors or first_moment.size() != ntensors
+            or second_moment.size() != ntensors)
+    {
+        throw std::runtime_error("Different number of buffers in "
+                "multi_adam_step");
+    }
+    if(ntensors == 0)
+    {
+        return;
+    }
+    // Codelet arguments
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
+    args->ntensors = ntensors;
+    args->num_iter = num_iter;
+    args->beta_1 = beta_1;
+    args->beta_2 = beta_2;
+    args->eps = eps;
+    args->lr = lr;
+    args->weight_decay = weight_decay;
+    args->decoupled = decoupled;
+    args->scaled = static_cast<starpu_data_handle_t>(scalars) != nullptr;
+    // Moments are only written at the first iteration
+    enum starpu_data_access_mode moments_mode;
+    if(num_iter == 1)
+    {
+        moments_mode = STARPU_W;
+    }
+    else
+    {
+        moments_mode = STARPU_RW;
+    }
+    std::vector<starpu_data_descr> descrs(NBUFFERS_PER_TENSOR*ntensors);
+    fp64_t nflops = 0;
+    for(Index j = 0; j < ntensors; ++j)
+    {
+        nflops += 15 * starpu_data_get_size(
+                static_cast<starpu_data_handle_t>(p[j])) / sizeof(T);
+        auto tensor_descrs = &descrs[NBUFFERS_PER_TENSOR*j];
+        tensor_descrs[0].handle = static_cast<starpu_data_handle_t>(grad[j]);
+        tensor_descrs[0].mode = STARPU_R;
+        tensor_descrs[1].handle = static_cast<starpu_data_handle_t>(
+                first_moment[j]);
+        tensor_descrs[1].mode = moments_mode;
+        tensor_descrs[2].handle = static_cast<starpu_data_handle_t>(
+                second_moment[j]);
+        tensor_descrs[2].mode = moments_mode;
+        tensor_descrs[3].handle = static_cast<starpu_data_handle_t>(p[j]);
+        tensor_descrs[3].mode = STARPU_RW;
+    }
+    if(args->scaled)
+    {
+        descrs.emplace_back();
+        descrs.back().handle = static_cast<starpu_data_handle_t>(scalars);
+        descrs.back().mode = STARPU_R;
+    }
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_DATA_MODE_ARRAY, descrs.data(), int(descrs.size()),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in multi_adam_step task submission");
+    }
+}
+
+// Explicit instantiaion
+template
+void submit<fp32_t>(Index num_iter, fp32_t beta_1, fp32_t beta_2, fp32_t eps,
+        fp32_t lr, fp32_t weight_decay, bool decoupled,
+        const std::vector<Handle> &grad,
+        const std::vector<Handle> &first_moment,
+        const std::vector<Handle> &second_moment,
+        const std::vector<Handle> &p, HandleRef scalars);
+
+template
+void submit<fp64_t>(Index num_iter, fp64_t beta_1, fp64_t beta_2, fp64_t eps,
+        fp64_t lr, fp64_t weight_decay, bool decoupled,
+        const std::vector<Handle> &grad,
+        const std::vector<Handle> &first_moment,
+        const std::vector<Handle> &second_moment,
+        const std::vector<Handle> &p, HandleRef scalars);
+
+} // namespace multi_adam_step
+} // namespace starpu
+} // namespace nntile
+
@@ -116,8 +116,8 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index m, Index n, Index k, Index l, T eps, Handle gamma_beta,
-        Handle sumnorm, Handle dst)
+void submit(Index m, Index n, Index k, Index l, T eps, HandleRef gamma_beta,
+        HandleRef sumnorm, HandleRef dst)
 //! Insert normalize task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -125,21 +125,21 @@ void submit(Index m, Index n, Index k, Index l, T eps, Handle gamma_beta,
  * */
 {
     // Codelet arguments
-    auto args = new args_t<T>
-    {
-        .m = m,
-        .n = n,
-        .k = k,
-        .l = l,
-        .eps = eps
-    };
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>(args_t<T>{
+            .m = m,
+            .n = n,
+            .k = k,
+            .l = l,
+            .eps = eps
+            });
     fp64_t nflops = 14 * m * n * k;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(gamma_beta),
             STARPU_R, static_cast<starpu_data_handle_t>(sumnorm),
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             STARPU_FLOPS, nflops,
             0);
     // Check submission
@@ -152,11 +152,11 @@ void submit(Index m, Index n, Index k, Index l, T eps, Handle gamma_beta,
 // Explicit instantiation
 template
 void submit<fp32_t>(Index m, Index n, Index k, Index l, fp32_t eps,
-        Handle gamma_beta, Handle sumnorm, Handle dst);
+        HandleRef gamma_beta, HandleRef sumnorm, HandleRef dst);
 
 template
 void submit<fp64_t>(Index m, Index n, Index k, Index l, fp64_t eps,
-        Handle gamma_beta, Handle sumnorm, Handle dst);
+        HandleRef gamma_beta, HandleRef sumnorm, HandleRef dst);
 
 } // namespace normalize
 } // namespace starpu
@@ -0,0 +1,173 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/nrm2.cc
+ * NRM2 operation for StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-01-31
+ * */
+
+#include "nntile/starpu/nrm2.hh"
+#include "nntile/kernel/nrm2.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace nrm2
+{
+
+//! NRM2 for contiguous buffers through StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src = interfaces[0]->get_ptr<T>();
+    T *dst = interfaces[1]->get_ptr<T>();
+    // Launch kernel
+    kernel::nrm2::cpu<T>(args->nelems, args->alpha, src, args->beta, dst);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! NRM2 for contiguous buffers through StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src = interfaces[0]->get_ptr<T>();
+    T *dst = interfaces[1]->get_ptr<T>();
+    T *work = interfaces[2]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::nrm2::cuda<T>(stream, args->nelems, args->alpha, src,
+            args->beta, dst, args->nwork, work);
+}
+#endif //NNTILE_USE_CUDA
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_nrm2_fp32",
+            nullptr,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_nrm2_fp64",
+            nullptr,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index nelems, T alpha, HandleRef src, T beta, HandleRef dst)
+//! Insert nrm2 task into StarPU pool of tasks
+/*! Norm of src is accumulated into dst by hypot, so that the following
+ * accumulation into a total norm is fused into the same task. CUDA
+ * implementation gets a temporary buffer for norms of parts of src, one
+ * part per 8192 elements but not more than 256 parts. If task submission
+ * fails, this routines throws an std::runtime_error() exception.
+ * */
+{
+    constexpr T zero = 0, one = 1;
+    // Access mode for the dst handle
+    enum starpu_data_access_mode dst_mode;
+    if(beta == one)
+    {
+        dst_mode = Config::STARPU_RW_COMMUTE;
+    }
+    else if(beta == zero)
+    {
+        dst_mode = STARPU_W;
+    }
+    else
+    {
+        dst_mode = STARPU_RW;
+    }
+    // Codelet arguments
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
+    args->nelems = nelems;
+    args->alpha = alpha;
+    args->beta = beta;
+    args->nwork = std::clamp<Index>((nelems+8191)/8192, 1, 256);
+    fp64_t nflops = 2 * nelems;
+    // Temporary buffer is allocated by StarPU on the worker
+    VariableHandle work(sizeof(T)*args->nwork, STARPU_SCRATCH);
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(src),
+            dst_mode, static_cast<starpu_data_handle_t>(dst),
+            STARPU_SCRATCH, static_cast<starpu_data_handle_t>(work),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in nrm2 task submission");
+    }
+}
+
+template<typename T>
+void submit(Index nelems, HandleRef src, HandleRef dst)
+{
+    submit<T>(nelems, 1.0, src, 0.0, dst);
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index nelems, fp32_t alpha, HandleRef src, fp32_t beta,
+        HandleRef dst);
+
+template
+void submit<fp64_t>(Index nelems, fp64_t alpha, HandleRef src, fp64_t beta,
+        HandleRef dst);
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index nelems, HandleRef src, HandleRef dst);
+
+template
+void submit<fp64_t>(Index nelems, HandleRef src, HandleRef dst);
+
+} // namespace nrm2
+} // namespace starpu
+} // namespace nntile
+
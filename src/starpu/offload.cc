@@ -0,0 +1,84 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/offload.cc
+ * Submission of tasks to CPU workers only
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/starpu/offload.hh"
+#include <stdexcept>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace offload
+{
+
+//! Scheduling context with CPU workers, if it is created
+static unsigned sched_ctx = STARPU_NMAX_SCHED_CTXS;
+
+//! Scheduling context, that was active before enter()
+static unsigned prev_sched_ctx = STARPU_NMAX_SCHED_CTXS;
+
+static bool active = false;
+
+void enter()
+{
+    if(active)
+    {
+        throw std::runtime_error("Offload is already active");
+    }
+    if(sched_ctx == STARPU_NMAX_SCHED_CTXS)
+    {
+        int ids[STARPU_NMAXWORKERS];
+        int n = starpu_worker_get_ids_by_type(STARPU_CPU_WORKER, ids,
+                STARPU_NMAXWORKERS);
+        if(n <= 0)
+        {
+            return;
+        }
+        sched_ctx = starpu_sched_ctx_create(ids, n, "nntile_offload",
+                STARPU_SCHED_CTX_POLICY_NAME, "eager", 0);
+    }
+    prev_sched_ctx = starpu_sched_ctx_get_context();
+    starpu_sched_ctx_set_context(&sched_ctx);
+    active = true;
+}
+
+void exit()
+{
+    if(not active)
+    {
+        return;
+    }
+    starpu_sched_ctx_set_context(&prev_sched_ctx);
+    active = false;
+}
+
+bool is_active()
+{
+    return active;
+}
+
+void shutdown()
+{
+    exit();
+    if(sched_ctx != STARPU_NMAX_SCHED_CTXS)
+    {
+        starpu_sched_ctx_delete(sched_ctx);
+        sched_ctx = STARPU_NMAX_SCHED_CTXS;
+    }
+}
+
+} // namespace offload
+} // namespace starpu
+} // namespace nntile
+
@@ -92,7 +92,7 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index nelems, T alpha, T exp, Handle data)
+void submit(Index nelems, T alpha, T exp, HandleRef data)
 //! Insert pow task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -100,14 +100,17 @@ void submit(Index nelems, T alpha, T exp, Handle data)
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->nelems = nelems;
     args->alpha = alpha;
     args->exp = exp;
+    fp64_t nflops = 2 * nelems;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_RW, static_cast<starpu_data_handle_t>(data),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -118,10 +121,10 @@ void submit(Index nelems, T alpha, T exp, Handle data)
 
 // Explicit instantiaion
 template
-void submit<fp32_t>(Index nelems, fp32_t alpha, fp32_t exp, Handle data);
+void submit<fp32_t>(Index nelems, fp32_t alpha, fp32_t exp, HandleRef data);
 
 template
-void submit<fp64_t>(Index nelems, fp64_t alpha, fp64_t exp, Handle data);
+void submit<fp64_t>(Index nelems, fp64_t alpha, fp64_t exp, HandleRef data);
 
 } // namespace pow
 } // namespace starpu
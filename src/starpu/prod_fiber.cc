@@ -112,7 +112,7 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index m, Index n, Index k, T alpha, Handle src, Handle dst)
+void submit(Index m, Index n, Index k, T alpha, HandleRef src, HandleRef dst)
 //! Insert prod_fiber task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -120,16 +120,17 @@ void submit(Index m, Index n, Index k, T alpha, Handle src, Handle dst)
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->m = m;
     args->n = n;
     args->k = k;
     args->alpha = alpha;
     fp64_t nflops = m * n * k;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
             STARPU_FLOPS, nflops,
             0);
@@ -142,12 +143,12 @@ void submit(Index m, Index n, Index k, T alpha, Handle src, Handle dst)
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index m, Index n, Index k, fp32_t alpha, Handle src,
-        Handle dst);
+void submit<fp32_t>(Index m, Index n, Index k, fp32_t alpha, HandleRef src,
+        HandleRef dst);
 
 template
-void submit<fp64_t>(Index m, Index n, Index k, fp64_t alpha, Handle src,
-        Handle dst);
+void submit<fp64_t>(Index m, Index n, Index k, fp64_t alpha, HandleRef src,
+        HandleRef dst);
 
 } // namespace prod_fiber
 } // namespace starpu
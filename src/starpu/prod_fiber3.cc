@@ -114,8 +114,8 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index m, Index n, Index k, T alpha, Handle src1, Handle src2,
-        Handle dst)
+void submit(Index m, Index n, Index k, T alpha, HandleRef src1, HandleRef src2,
+        HandleRef dst)
 //! Insert prod_fiber3 task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -123,17 +123,18 @@ void submit(Index m, Index n, Index k, T alpha, Handle src1, Handle src2,
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->m = m;
     args->n = n;
     args->k = k;
     args->alpha = alpha;
     fp64_t nflops = m * n * k;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src1),
             STARPU_R, static_cast<starpu_data_handle_t>(src2),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             STARPU_W, static_cast<starpu_data_handle_t>(dst),
             STARPU_FLOPS, nflops,
             0);
@@ -146,12 +147,12 @@ void submit(Index m, Index n, Index k, T alpha, Handle src1, Handle src2,
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index m, Index n, Index k, fp32_t alpha, Handle src1,
-        Handle src2, Handle dst);
+void submit<fp32_t>(Index m, Index n, Index k, fp32_t alpha, HandleRef src1,
+        HandleRef src2, HandleRef dst);
 
 template
-void submit<fp64_t>(Index m, Index n, Index k, fp64_t alpha, Handle src1,
-        Handle src2, Handle dst);
+void submit<fp64_t>(Index m, Index n, Index k, fp64_t alpha, HandleRef src1,
+        HandleRef src2, HandleRef dst);
 
 } // namespace prod_fiber3
 } // namespace starpu
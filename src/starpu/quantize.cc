@@ -0,0 +1,158 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/quantize.cc
+ * Quantization of weights into 8-bit types with per-group scales on StarPU
+ * buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/starpu/quantize.hh"
+#include "nntile/kernel/quantize.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for quantization of weights
+namespace quantize
+{
+
+//! StarPU wrapper for kernel::quantize::cpu<Q>
+template<typename Q>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const fp32_t *src = interfaces[0]->get_ptr<fp32_t>();
+    Q *dst = interfaces[1]->get_ptr<Q>();
+    fp32_t *scale = interfaces[2]->get_ptr<fp32_t>();
+    // Launch kernel
+    kernel::quantize::cpu<Q>(args->m, args->k, args->group, src, dst, scale);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! StarPU wrapper for kernel::quantize::cuda<Q>
+template<typename Q>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const fp32_t *src = interfaces[0]->get_ptr<fp32_t>();
+    Q *dst = interfaces[1]->get_ptr<Q>();
+    fp32_t *scale = interfaces[2]->get_ptr<fp32_t>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::quantize::cuda<Q>(stream, args->m, args->k, args->group, src,
+            dst, scale);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for quantize tasks
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    // Apply hash over parameters m, k and group
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->k, sizeof(args->k), hash);
+    hash = starpu_hash_crc32c_be_n(&args->group, sizeof(args->group), hash);
+    return hash;
+}
+
+Codelet codelet_int8, codelet_fp8_e4m3;
+
+void init()
+{
+    codelet_int8.init("nntile_quantize_int8",
+            footprint,
+            {cpu<std::int8_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<std::int8_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp8_e4m3.init("nntile_quantize_fp8_e4m3",
+            footprint,
+            {cpu<fp8_e4m3_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp8_e4m3_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_int8.restrict_where(where);
+    codelet_fp8_e4m3.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_int8.restore_where();
+    codelet_fp8_e4m3.restore_where();
+}
+
+template<typename Q>
+void submit(Index m, Index k, Index group, HandleRef src, HandleRef dst,
+        HandleRef scale)
+//! Insert quantize task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t *args = ArgsPool::allocate<args_t>();
+    args->m = m;
+    args->k = k;
+    args->group = group;
+    fp64_t nflops = 3 * m * k;
+    // Submit task
+    int ret = task_insert(codelet<Q>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(src),
+            STARPU_W, static_cast<starpu_data_handle_t>(dst),
+            STARPU_W, static_cast<starpu_data_handle_t>(scale),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in quantize task submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<std::int8_t>(Index m, Index k, Index group, HandleRef src,
+        HandleRef dst, HandleRef scale);
+
+template
+void submit<fp8_e4m3_t>(Index m, Index k, Index group, HandleRef src,
+        HandleRef dst, HandleRef scale);
+
+} // namespace quantize
+} // namespace starpu
+} // namespace nntile
+
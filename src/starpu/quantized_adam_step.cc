@@ -0,0 +1,155 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/quantized_adam_step.cc
+ * Fused Adam step with block-wise 8-bit moments with StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/quantized_adam_step.hh"
+#include "nntile/kernel/quantized_adam_step.hh"
+#include "nntile/kernel/parallel.hh"
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for one step of Adam optimizer with 8-bit moments
+namespace quantized_adam_step
+{
+
+//! Apply Adam step with 8-bit moments on StarPU buffers on CPU
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const fp32_t *grad = interfaces[0]->get_ptr<fp32_t>();
+    auto first_moment = interfaces[1]->get_ptr<std::int8_t>();
+    fp32_t *first_scale = interfaces[2]->get_ptr<fp32_t>();
+    auto second_moment = interfaces[3]->get_ptr<fp8_e4m3_t>();
+    fp32_t *second_scale = interfaces[4]->get_ptr<fp32_t>();
+    fp32_t *p = interfaces[5]->get_ptr<fp32_t>();
+    // Use all threads of a parallel worker
+    kernel::parallel::Scope threads(starpu_combined_worker_get_size());
+    // Launch kernel
+    kernel::quantized_adam_step::cpu(args->num_iter, args->num_elems,
+            args->block, args->beta_1, args->beta_2, args->eps, args->lr,
+            args->weight_decay, args->decoupled, grad, first_moment,
+            first_scale, second_moment, second_scale, p);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Apply Adam step with 8-bit moments on StarPU buffers on CUDA
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const fp32_t *grad = interfaces[0]->get_ptr<fp32_t>();
+    auto first_moment = interfaces[1]->get_ptr<std::int8_t>();
+    fp32_t *first_scale = interfaces[2]->get_ptr<fp32_t>();
+    auto second_moment = interfaces[3]->get_ptr<fp8_e4m3_t>();
+    fp32_t *second_scale = interfaces[4]->get_ptr<fp32_t>();
+    fp32_t *p = interfaces[5]->get_ptr<fp32_t>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::quantized_adam_step::cuda(stream, args->num_iter,
+            args->num_elems, args->block, args->beta_1, args->beta_2,
+            args->eps, args->lr, args->weight_decay, args->decoupled, grad,
+            first_moment, first_scale, second_moment, second_scale, p);
+}
+#endif // NNTILE_USE_CUDA
+
+Codelet codelet;
+
+void init()
+{
+    codelet.init("nntile_quantized_adam_step",
+            nullptr,
+            {cpu},
+#ifdef NNTILE_USE_CUDA
+            {cuda}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    // CPU implementation may use all threads of parallel workers
+    codelet.set_parallel();
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet.restore_where();
+}
+
+void submit(Index num_iter, Index num_elems, Index block, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t lr, fp32_t weight_decay,
+        bool decoupled, HandleRef grad, HandleRef first_moment,
+        HandleRef first_scale, HandleRef second_moment,
+        HandleRef second_scale, HandleRef p)
+//! Insert task of a fused Adam step with 8-bit moments
+/*! Moments and their scales are only written at the first iteration.
+ * */
+{
+    // Codelet arguments
+    args_t *args = ArgsPool::allocate<args_t>();
+    args->num_iter = num_iter;
+    args->num_elems = num_elems;
+    args->block = block;
+    args->beta_1 = beta_1;
+    args->beta_2 = beta_2;
+    args->eps = eps;
+    args->lr = lr;
+    args->weight_decay = weight_decay;
+    args->decoupled = decoupled;
+    fp64_t nflops = 20 * num_elems;
+    // Submit task
+    enum starpu_data_access_mode moments_mode;
+    if(num_iter == 1)
+    {
+        moments_mode = STARPU_W;
+    }
+    else
+    {
+        moments_mode = STARPU_RW;
+    }
+    int ret = task_insert(&codelet,
+            STARPU_R, static_cast<starpu_data_handle_t>(grad),
+            moments_mode, static_cast<starpu_data_handle_t>(first_moment),
+            moments_mode, static_cast<starpu_data_handle_t>(first_scale),
+            moments_mode, static_cast<starpu_data_handle_t>(second_moment),
+            moments_mode, static_cast<starpu_data_handle_t>(second_scale),
+            STARPU_RW, static_cast<starpu_data_handle_t>(p),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in quantized_adam_step task "
+                "submission");
+    }
+}
+
+} // namespace quantized_adam_step
+} // namespace starpu
+} // namespace nntile
+
@@ -61,6 +61,52 @@ void cpu_ndim0(void *buffers[], void *cl_args)
     kernel::randn::cpu_ndim0<T>(*seed_ptr, *mean_ptr, *stddev_ptr, data);
 }
 
+#ifdef NNTILE_USE_CUDA
+//! Randn operation on StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    const Index *ndim_ptr, *nelems_ptr, *start, *shape, *stride,
+          *underlying_shape;
+    const unsigned long long *seed_ptr;
+    const T *mean_ptr, *stddev_ptr;
+    Config::unpack_args_ptr(cl_args, ndim_ptr, nelems_ptr, seed_ptr, mean_ptr,
+            stddev_ptr, start, shape, stride, underlying_shape);
+    // Get interfaces
+    Index ndim = *ndim_ptr;
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    T *data = interfaces[0]->get_ptr<T>();
+    Index *tmp_index = interfaces[1]->get_ptr<Index>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel, that copies shapes from arguments into scratch buffer
+    kernel::randn::cuda<T>(stream, ndim, *nelems_ptr, *seed_ptr, *mean_ptr,
+            *stddev_ptr, start, shape, underlying_shape, data, stride,
+            tmp_index);
+}
+
+//! Randn operation on StarPU buffers for ndim=0 on CUDA
+template<typename T>
+void cuda_ndim0(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    const unsigned long long *seed_ptr;
+    const T *mean_ptr, *stddev_ptr;
+    Config::unpack_args_ptr(cl_args, seed_ptr, mean_ptr, stddev_ptr);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    T *data = interfaces[0]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::randn::cuda_ndim0<T>(stream, *seed_ptr, *mean_ptr, *stddev_ptr,
+            data);
+}
+#endif // NNTILE_USE_CUDA
+
 //! Footprint for randn tasks that depend on shape
 template<typename T>
 static
@@ -85,19 +131,39 @@ void init()
     codelet_fp32.init("nntile_randn_fp32",
             footprint<fp32_t>,
             {cpu<fp32_t>},
-            {});
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
     codelet_fp64.init("nntile_randn_fp64",
             footprint<fp64_t>,
             {cpu<fp64_t>},
-            {});
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
     codelet_fp32_ndim0.init("nntile_randn_fp32",
             nullptr,
             {cpu_ndim0<fp32_t>},
-            {});
+#ifdef NNTILE_USE_CUDA
+            {cuda_ndim0<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
     codelet_fp64_ndim0.init("nntile_randn_fp64",
             nullptr,
             {cpu_ndim0<fp64_t>},
-            {});
+#ifdef NNTILE_USE_CUDA
+            {cuda_ndim0<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
 }
 
 void restrict_where(uint32_t where)
@@ -116,19 +182,23 @@ void restore_where()
     codelet_fp64_ndim0.restore_where();
 }
 
+//! Insert randn task into StarPU pool of tasks
+/*! @param[in] tmp_index: Scratch buffer of at least 4*ndim indices, as CUDA
+ *      implementation copies shapes into it
+ * */
 template<typename T>
 void submit(Index ndim, Index nelems, unsigned long long seed,
         T mean, T stddev, const std::vector<Index> &start,
         const std::vector<Index> &shape, const std::vector<Index> &stride,
-        const std::vector<Index> &underlying_shape, Handle data,
-        Handle tmp_index)
+        const std::vector<Index> &underlying_shape, HandleRef data,
+        HandleRef tmp_index)
 {
     fp64_t nflops = 2 * nelems;
     // Submit task
     int ret;
     if(ndim > 0)
     {
-        ret = starpu_task_insert(codelet<T>(),
+        ret = task_insert(codelet<T>(),
                 STARPU_VALUE, &ndim, sizeof(ndim),
                 STARPU_VALUE, &nelems, sizeof(nelems),
                 STARPU_VALUE, &seed, sizeof(seed),
@@ -146,7 +216,7 @@ void submit(Index ndim, Index nelems, unsigned long long seed,
     }
     else
     {
-        ret = starpu_task_insert(codelet_ndim0<T>(),
+        ret = task_insert(codelet_ndim0<T>(),
                 STARPU_VALUE, &seed, sizeof(seed),
                 STARPU_VALUE, &mean, sizeof(mean),
                 STARPU_VALUE, &stddev, sizeof(stddev),
@@ -166,15 +236,15 @@ template
 void submit<fp32_t>(Index ndim, Index nelems, unsigned long long seed,
         fp32_t mean, fp32_t stddev, const std::vector<Index> &start,
         const std::vector<Index> &shape, const std::vector<Index> &stride,
-        const std::vector<Index> &underlying_shape, Handle data,
-        Handle tmp_index);
+        const std::vector<Index> &underlying_shape, HandleRef data,
+        HandleRef tmp_index);
 
 template
 void submit<fp64_t>(Index ndim, Index nelems, unsigned long long seed,
         fp64_t mean, fp64_t stddev, const std::vector<Index> &start,
         const std::vector<Index> &shape, const std::vector<Index> &stride,
-        const std::vector<Index> &underlying_shape, Handle data,
-        Handle tmp_index);
+        const std::vector<Index> &underlying_shape, HandleRef data,
+        HandleRef tmp_index);
 
 } // namespace randn
 } // namespace starpu
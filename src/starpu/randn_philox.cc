@@ -0,0 +1,182 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/randn_philox.cc
+ * Randn operation by a counter-based Philox generator on StarPU buffer
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/starpu/randn_philox.hh"
+#include "nntile/kernel/randn_philox.hh"
+
+namespace nntile
+{
+namespace starpu
+{
+namespace randn_philox
+{
+
+//! Randn operation by Philox generator on StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    const Index *ndim_ptr, *nelems_ptr, *start, *shape, *stride,
+          *underlying_shape;
+    const unsigned long long *seed_ptr;
+    const T *mean_ptr, *stddev_ptr;
+    Config::unpack_args_ptr(cl_args, ndim_ptr, nelems_ptr, seed_ptr, mean_ptr,
+            stddev_ptr, start, shape, stride, underlying_shape);
+    // Get interfaces
+    Index ndim = *ndim_ptr;
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    T *data = interfaces[0]->get_ptr<T>();
+    Index *tmp_index = interfaces[1]->get_ptr<Index>();
+    // Launch kernel
+    kernel::randn_philox::cpu<T>(ndim, *nelems_ptr, *seed_ptr, *mean_ptr,
+            *stddev_ptr, start, shape, underlying_shape, data, stride,
+            tmp_index);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Randn operation by Philox generator on StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    const Index *ndim_ptr, *nelems_ptr, *start, *shape, *stride,
+          *underlying_shape;
+    const unsigned long long *seed_ptr;
+    const T *mean_ptr, *stddev_ptr;
+    Config::unpack_args_ptr(cl_args, ndim_ptr, nelems_ptr, seed_ptr, mean_ptr,
+            stddev_ptr, start, shape, stride, underlying_shape);
+    // Get interfaces
+    Index ndim = *ndim_ptr;
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    T *data = interfaces[0]->get_ptr<T>();
+    Index *tmp_index = interfaces[1]->get_ptr<Index>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel, that copies shapes from arguments into scratch buffer
+    kernel::randn_philox::cuda<T>(stream, ndim, *nelems_ptr, *seed_ptr,
+            *mean_ptr, *stddev_ptr, start, shape, underlying_shape, data,
+            stride, tmp_index);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for randn tasks that depend on shape
+template<typename T>
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    const Index *ndim_ptr, *nelems_ptr, *start, *shape, *stride,
+          *underlying_shape;
+    const unsigned long long *seed_ptr;
+    const T *mean_ptr, *stddev_ptr;
+    Config::unpack_args_ptr(task->cl_arg, ndim_ptr, nelems_ptr, seed_ptr,
+            mean_ptr, stddev_ptr, start, shape, stride, underlying_shape);
+    std::size_t shape_size = *ndim_ptr * sizeof(*shape);
+    // Apply hash over parameter copy_shape
+    return starpu_hash_crc32c_be_n(shape, shape_size, 0);
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_randn_philox_fp32",
+            footprint<fp32_t>,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_randn_philox_fp64",
+            footprint<fp64_t>,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+//! Insert task of random generation by Philox generator
+/*! Unlike randn::submit, the same codelet serves 0-dimensional tiles, as
+ * the kernel does not need to jump over generated elements.
+ *
+ * @param[in] tmp_index: Scratch buffer of at least 4*ndim indices
+ * */
+template<typename T>
+void submit(Index ndim, Index nelems, unsigned long long seed,
+        T mean, T stddev, const std::vector<Index> &start,
+        const std::vector<Index> &shape, const std::vector<Index> &stride,
+        const std::vector<Index> &underlying_shape, HandleRef data,
+        HandleRef tmp_index)
+{
+    fp64_t nflops = 2 * nelems;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_VALUE, &ndim, sizeof(ndim),
+            STARPU_VALUE, &nelems, sizeof(nelems),
+            STARPU_VALUE, &seed, sizeof(seed),
+            STARPU_VALUE, &mean, sizeof(mean),
+            STARPU_VALUE, &stddev, sizeof(stddev),
+            STARPU_VALUE, start.data(), ndim*sizeof(Index),
+            STARPU_VALUE, shape.data(), ndim*sizeof(Index),
+            STARPU_VALUE, stride.data(), ndim*sizeof(Index),
+            STARPU_VALUE, underlying_shape.data(), ndim*sizeof(Index),
+            STARPU_W, static_cast<starpu_data_handle_t>(data),
+            STARPU_SCRATCH, static_cast<starpu_data_handle_t>(tmp_index),
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in randn_philox task submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index ndim, Index nelems, unsigned long long seed,
+        fp32_t mean, fp32_t stddev, const std::vector<Index> &start,
+        const std::vector<Index> &shape, const std::vector<Index> &stride,
+        const std::vector<Index> &underlying_shape, HandleRef data,
+        HandleRef tmp_index);
+
+template
+void submit<fp64_t>(Index ndim, Index nelems, unsigned long long seed,
+        fp64_t mean, fp64_t stddev, const std::vector<Index> &start,
+        const std::vector<Index> &shape, const std::vector<Index> &stride,
+        const std::vector<Index> &underlying_shape, HandleRef data,
+        HandleRef tmp_index);
+
+} // namespace randn_philox
+} // namespace starpu
+} // namespace nntile
+
@@ -96,15 +96,17 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index nelems, Handle x, Handle dy, Handle dx)
+void submit(Index nelems, HandleRef x, HandleRef dy, HandleRef dx)
 {
-    Index *nelems_ = (Index *)std::malloc(sizeof(*nelems_));
-    *nelems_ = nelems;
-    int ret = starpu_task_insert(codelet<T>(),
+    Index *nelems_ = ArgsPool::allocate<Index>(nelems);
+    fp64_t nflops = nelems;
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(x),
             STARPU_R, static_cast<starpu_data_handle_t>(dy),
             STARPU_RW, static_cast<starpu_data_handle_t>(dx),
-            STARPU_CL_ARGS, nelems_, sizeof(*nelems_),
+            STARPU_CL_ARGS_NFREE, nelems_, sizeof(*nelems_),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, nelems_,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -115,38 +117,42 @@ void submit(Index nelems, Handle x, Handle dy, Handle dx)
 
 // Explicit instantiaion
 template
-void submit<fp32_t>(Index nelems, Handle x, Handle dy, Handle dx);
+void submit<fp32_t>(Index nelems, HandleRef x, HandleRef dy, HandleRef dx);
 
 template
-void submit<fp64_t>(Index nelems, Handle x, Handle dy, Handle dx);
+void submit<fp64_t>(Index nelems, HandleRef x, HandleRef dy, HandleRef dx);
 
 template<typename T>
-void submit_mpi(Index nelems, Handle x, Handle dy, Handle dx, int exec_rank)
+void submit_mpi(Index nelems, HandleRef x, HandleRef dy, HandleRef dx,
+        int exec_rank)
 {
     // Build a task with initializing data transfers
-//    struct starpu_task *task = starpu_mpi_task_build(MPI_COMM_WORLD,
-//            codelet<T>(),
-//            STARPU_R, static_cast<starpu_data_handle_t>(x),
-//            STARPU_R, static_cast<starpu_data_handle_t>(dy),
-//            STARPU_RW, static_cast<starpu_data_handle_t>(dx),
-//            STARPU_EXECUTE_ON_NODE, exec_rank,
-//            0);
+#ifdef NNTILE_USE_MPI
+    struct starpu_task *task = starpu_mpi_task_build(MPI_COMM_WORLD,
+            codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(x),
+            STARPU_R, static_cast<starpu_data_handle_t>(dy),
+            STARPU_RW, static_cast<starpu_data_handle_t>(dx),
+            STARPU_EXECUTE_ON_NODE, exec_rank,
+            0);
+#else // NNTILE_USE_MPI
     struct starpu_task *task = starpu_task_build(
             codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(x),
             STARPU_R, static_cast<starpu_data_handle_t>(dy),
             STARPU_RW, static_cast<starpu_data_handle_t>(dx),
             0);
+#endif // NNTILE_USE_MPI
     // Only execution node will have non-nullptr task
     if(task)
     {
         // Define codelet arguments
-        Index *nelems_ = (Index *)std::malloc(sizeof(*nelems_));
+        Index *nelems_ = ArgsPool::allocate<Index>(nelems);
         task->cl_arg = nelems_;
         task->cl_arg_size = sizeof(*nelems_);
-        task->cl_arg_free = 1;
-        // Set codelet arguments
-        *nelems_ = nelems;
+        task->callback_func = ArgsPool::release;
+        task->callback_arg = nelems_;
+        task->flops = nelems;
         // Submit task to the DAG
         int ret = starpu_task_submit(task);
         // Check submission
@@ -156,24 +162,25 @@ void submit_mpi(Index nelems, Handle x, Handle dy, Handle dx, int exec_rank)
                     "submission");
         }
     }
+#ifdef NNTILE_USE_MPI
     // Data transfers after the task
-//    starpu_mpi_task_post_build(MPI_COMM_WORLD,
-//            codelet<T>(),
-//            STARPU_R, static_cast<starpu_data_handle_t>(x),
-//            STARPU_R, static_cast<starpu_data_handle_t>(dy),
-//            STARPU_RW, static_cast<starpu_data_handle_t>(dx),
-//            STARPU_EXECUTE_ON_NODE, exec_rank,
-//            0);
-
+    starpu_mpi_task_post_build(MPI_COMM_WORLD,
+            codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(x),
+            STARPU_R, static_cast<starpu_data_handle_t>(dy),
+            STARPU_RW, static_cast<starpu_data_handle_t>(dx),
+            STARPU_EXECUTE_ON_NODE, exec_rank,
+            0);
+#endif // NNTILE_USE_MPI
 }
 
 // Explicit instantiaion
 template
-void submit_mpi<fp32_t>(Index nelems, Handle x, Handle dy, Handle dx,
+void submit_mpi<fp32_t>(Index nelems, HandleRef x, HandleRef dy, HandleRef dx,
         int exec_rank);
 
 template
-void submit_mpi<fp64_t>(Index nelems, Handle x, Handle dy, Handle dx,
+void submit_mpi<fp64_t>(Index nelems, HandleRef x, HandleRef dy, HandleRef dx,
         int exec_rank);
 
 } // namespace relu_backward
@@ -0,0 +1,182 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/rms_norm_backward.cc
+ * Backward of root mean square layer normalization of StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/rms_norm_backward.hh"
+#include "nntile/kernel/rms_norm_backward.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for rms_norm_backward operation
+namespace rms_norm_backward
+{
+
+//! StarPU wrapper for kernel::rms_norm_backward::cpu<T>
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src = interfaces[0]->get_ptr<T>();
+    const T *dst_grad = interfaces[1]->get_ptr<T>();
+    const T *gamma = interfaces[2]->get_ptr<T>();
+    const T *inv_rms = interfaces[3]->get_ptr<T>();
+    T *src_grad = interfaces[4]->get_ptr<T>();
+    T *gamma_grad = interfaces[5]->get_ptr<T>();
+    // Launch kernel
+    kernel::rms_norm_backward::cpu<T>(args->m, args->n, args->k, src,
+            dst_grad, gamma, inv_rms, src_grad, gamma_grad);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! StarPU wrapper for kernel::rms_norm_backward::cuda<T>
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src = interfaces[0]->get_ptr<T>();
+    const T *dst_grad = interfaces[1]->get_ptr<T>();
+    const T *gamma = interfaces[2]->get_ptr<T>();
+    const T *inv_rms = interfaces[3]->get_ptr<T>();
+    T *src_grad = interfaces[4]->get_ptr<T>();
+    T *gamma_grad = interfaces[5]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::rms_norm_backward::cuda<T>(stream, args->m, args->n, args->k,
+            src, dst_grad, gamma, inv_rms, src_grad, gamma_grad);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for rms_norm_backward tasks
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    // Apply hash over parameters m, n and k
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    hash = starpu_hash_crc32c_be_n(&args->k, sizeof(args->k), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_rms_norm_backward_fp32",
+            footprint,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_rms_norm_backward_fp64",
+            footprint,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index m, Index n, Index k, HandleRef src, HandleRef dst_grad,
+        HandleRef gamma, HandleRef inv_rms, HandleRef src_grad,
+        HandleRef gamma_grad, int redux)
+//! Insert rms_norm_backward task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t *args = ArgsPool::allocate<args_t>();
+    args->m = m;
+    args->n = n;
+    args->k = k;
+    fp64_t nflops = 10 * m * n * k;
+    // Access mode for gradient of gamma, that is accumulated by tasks of all
+    // the tiles of src
+    enum starpu_data_access_mode param_mode;
+    if(redux != 0)
+    {
+        param_mode = STARPU_REDUX;
+    }
+    else
+    {
+        param_mode = Config::STARPU_RW_COMMUTE;
+    }
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(src),
+            STARPU_R, static_cast<starpu_data_handle_t>(dst_grad),
+            STARPU_R, static_cast<starpu_data_handle_t>(gamma),
+            STARPU_R, static_cast<starpu_data_handle_t>(inv_rms),
+            STARPU_RW, static_cast<starpu_data_handle_t>(src_grad),
+            param_mode, static_cast<starpu_data_handle_t>(gamma_grad),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in rms_norm_backward task "
+                "submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index m, Index n, Index k, HandleRef src,
+        HandleRef dst_grad, HandleRef gamma, HandleRef inv_rms,
+        HandleRef src_grad, HandleRef gamma_grad, int redux);
+
+template
+void submit<fp64_t>(Index m, Index n, Index k, HandleRef src,
+        HandleRef dst_grad, HandleRef gamma, HandleRef inv_rms,
+        HandleRef src_grad, HandleRef gamma_grad, int redux);
+
+} // namespace rms_norm_backward
+} // namespace starpu
+} // namespace nntile
+
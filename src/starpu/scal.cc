@@ -96,7 +96,7 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index nelems, T alpha, Handle src, Handle dst)
+void submit(Index nelems, T alpha, HandleRef src, HandleRef dst)
 //! Insert scal task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -111,15 +111,17 @@ void submit(Index nelems, T alpha, Handle src, Handle dst)
         return;
     }
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->nelems = nelems;
     args->alpha = alpha;
+    fp64_t nflops = nelems;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_W, static_cast<starpu_data_handle_t>(dst),
-            STARPU_CL_ARGS, args, sizeof(*args),
-            // STARPU_FLOPS, nflops,
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -130,10 +132,10 @@ void submit(Index nelems, T alpha, Handle src, Handle dst)
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index nelems, fp32_t alpha, Handle src, Handle dst);
+void submit<fp32_t>(Index nelems, fp32_t alpha, HandleRef src, HandleRef dst);
 
 template
-void submit<fp64_t>(Index nelems, fp64_t alpha, Handle src, Handle dst);
+void submit<fp64_t>(Index nelems, fp64_t alpha, HandleRef src, HandleRef dst);
 
 } // namespace scal
 } // namespace starpu
@@ -0,0 +1,475 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/scheduler.cc
+ * Locality-aware StarPU scheduler with priorities
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/starpu/scheduler.hh"
+#include "nntile/starpu/trace.hh"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace scheduler
+{
+
+//! Queue of tasks ordered by priorities, equal priorities keep FIFO order
+using queue_t = std::multimap<int, starpu_task *, std::greater<int>>;
+
+//! Data of the scheduling policy for a scheduling context
+struct sched_data_t
+{
+    std::mutex mutex;
+    //! Queues of tasks pinned to workers
+    std::vector<queue_t> queues;
+    //! Shared queue for tasks without an owner
+    queue_t shared;
+    //! All workers of the context
+    std::vector<int> workers;
+    //! CUDA workers of the context
+    std::vector<int> cuda_workers;
+    //! Queues of tasks for CPU workers of NUMA nodes
+    std::vector<queue_t> numa_queues;
+    //! NUMA node of each CPU worker of the context or -1
+    std::vector<int> worker_numa;
+};
+
+//! Priority of tasks being submitted
+static std::atomic<int> current_priority = STARPU_DEFAULT_PRIO;
+
+//! Priority of tasks off the critical path
+static std::atomic<int> background_priority = STARPU_DEFAULT_PRIO - 1;
+
+//! Kinds of workers for tasks being submitted, zero means any
+static std::atomic<uint32_t> current_where = 0;
+
+// Owner device and NUMA node of a data handle are packed into its user
+// data: the lower half keeps the device and the upper half keeps the NUMA
+// node. Both are shifted by one, as zero means the owner is not set.
+static constexpr int owner_shift = 4 * sizeof(std::uintptr_t);
+static constexpr std::uintptr_t owner_mask =
+    (std::uintptr_t(1) << owner_shift) - 1;
+
+//! Get both owners of a data handle
+static std::uintptr_t get_owners(starpu_data_handle_t handle)
+{
+    return reinterpret_cast<std::uintptr_t>(
+            starpu_data_get_user_data(handle));
+}
+
+//! Set both owners of a data handle
+static void set_owners(starpu_data_handle_t handle, std::uintptr_t value)
+{
+    starpu_data_set_user_data(handle, reinterpret_cast<void *>(value));
+}
+
+void set_device(starpu_data_handle_t handle, int device)
+{
+    std::uintptr_t value = (device < 0) ? 0 : device+1;
+    set_owners(handle, (get_owners(handle) & ~owner_mask) | value);
+}
+
+int get_device(starpu_data_handle_t handle)
+{
+    return static_cast<int>(get_owners(handle) & owner_mask) - 1;
+}
+
+void set_numa(starpu_data_handle_t handle, int numa)
+{
+    std::uintptr_t value = (numa < 0) ? 0 : numa+1;
+    set_owners(handle, (get_owners(handle) & owner_mask)
+            | (value << owner_shift));
+}
+
+int get_numa(starpu_data_handle_t handle)
+{
+    return static_cast<int>(get_owners(handle) >> owner_shift) - 1;
+}
+
+//! Get CUDA workers of the whole StarPU instance
+static std::vector<int> get_cuda_workers()
+{
+    int ids[STARPU_NMAXWORKERS];
+    int n = starpu_worker_get_ids_by_type(STARPU_CUDA_WORKER, ids,
+            STARPU_NMAXWORKERS);
+    return std::vector<int>(ids, ids+std::max(n, 0));
+}
+
+int get_ndevices()
+{
+    return get_cuda_workers().size();
+}
+
+int get_device_node(starpu_data_handle_t handle)
+{
+    int device = get_device(handle);
+    auto cuda_workers = get_cuda_workers();
+    if(device < 0 and cuda_workers.size() == 1)
+    {
+        device = 0;
+    }
+    if(device < 0 or cuda_workers.empty())
+    {
+        return -1;
+    }
+    int workerid = cuda_workers[device % cuda_workers.size()];
+    return starpu_worker_get_memory_node(workerid);
+}
+
+void prefetch_on_device(starpu_data_handle_t handle)
+{
+    int node = get_device_node(handle);
+    if(node < 0)
+    {
+        return;
+    }
+    starpu_data_prefetch_on_node(handle, node, 1);
+}
+
+//! Get memory nodes of NUMA nodes of the whole StarPU instance
+static std::vector<unsigned> get_numa_memory_nodes()
+{
+    std::vector<unsigned> nodes;
+    unsigned nnodes = starpu_memory_nodes_get_count();
+    for(unsigned node = 0; node < nnodes; ++node)
+    {
+        if(starpu_node_get_kind(node) == STARPU_CPU_RAM)
+        {
+            nodes.push_back(node);
+        }
+    }
+    return nodes;
+}
+
+int get_nnuma()
+{
+    return get_numa_memory_nodes().size();
+}
+
+void prefetch_on_numa(starpu_data_handle_t handle)
+{
+    int numa = get_numa(handle);
+    auto nodes = get_numa_memory_nodes();
+    if(numa < 0 or nodes.empty())
+    {
+        return;
+    }
+    starpu_data_prefetch_on_node(handle, nodes[numa % nodes.size()], 1);
+}
+
+void priority_set(int priority)
+{
+    current_priority = priority;
+}
+
+int priority_get()
+{
+    return current_priority;
+}
+
+void priority_background_set(int priority)
+{
+    background_priority = priority;
+}
+
+int priority_background_get()
+{
+    return background_priority;
+}
+
+void where_set(uint32_t where)
+{
+    current_where = where;
+}
+
+uint32_t where_get()
+{
+    return current_where;
+}
+
+//! Get the first buffer, that is written by a task
+static starpu_data_handle_t get_output(starpu_task *task)
+{
+    unsigned nbuffers = STARPU_TASK_GET_NBUFFERS(task);
+    for(unsigned i = 0; i < nbuffers; ++i)
+    {
+        auto mode = STARPU_TASK_GET_MODE(task, i);
+        if((mode & STARPU_W) or (mode & STARPU_REDUX))
+        {
+            return STARPU_TASK_GET_HANDLE(task, i);
+        }
+    }
+    return nullptr;
+}
+
+//! Pop the first task of a queue, that can be executed by a worker
+static starpu_task *pop_from(queue_t &queue, int workerid)
+{
+    for(auto it = queue.begin(); it != queue.end(); ++it)
+    {
+        unsigned nimpl;
+        if(starpu_worker_can_execute_task_first_impl(workerid, it->second,
+                    &nimpl))
+        {
+            starpu_task *task = it->second;
+            starpu_task_set_implementation(task, nimpl);
+            queue.erase(it);
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+static void init_sched(unsigned sched_ctx_id)
+{
+    auto data = new sched_data_t;
+    data->queues.resize(STARPU_NMAXWORKERS);
+    data->worker_numa.resize(STARPU_NMAXWORKERS, -1);
+    starpu_sched_ctx_set_policy_data(sched_ctx_id, data);
+}
+
+static void deinit_sched(unsigned sched_ctx_id)
+{
+    auto data = static_cast<sched_data_t *>(
+            starpu_sched_ctx_get_policy_data(sched_ctx_id));
+    delete data;
+}
+
+static void add_workers(unsigned sched_ctx_id, int *workerids,
+        unsigned nworkers)
+{
+    auto data = static_cast<sched_data_t *>(
+            starpu_sched_ctx_get_policy_data(sched_ctx_id));
+    auto numa_nodes = get_numa_memory_nodes();
+    std::lock_guard<std::mutex> lock(data->mutex);
+    data->numa_queues.resize(numa_nodes.size());
+    for(unsigned i = 0; i < nworkers; ++i)
+    {
+        data->workers.push_back(workerids[i]);
+        switch(starpu_worker_get_type(workerids[i]))
+        {
+            case STARPU_CUDA_WORKER:
+                data->cuda_workers.push_back(workerids[i]);
+                break;
+            case STARPU_CPU_WORKER:
+            {
+                unsigned node = starpu_worker_get_memory_node(workerids[i]);
+                auto it = std::find(numa_nodes.begin(), numa_nodes.end(),
+                        node);
+                if(it != numa_nodes.end())
+                {
+                    data->worker_numa[workerids[i]] = it - numa_nodes.begin();
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+static void remove_workers(unsigned sched_ctx_id, int *workerids,
+        unsigned nworkers)
+{
+    auto data = static_cast<sched_data_t *>(
+            starpu_sched_ctx_get_policy_data(sched_ctx_id));
+    std::lock_guard<std::mutex> lock(data->mutex);
+    for(unsigned i = 0; i < nworkers; ++i)
+    {
+        for(auto list: {&data->workers, &data->cuda_workers})
+        {
+            list->erase(std::remove(list->begin(), list->end(),
+                        workerids[i]), list->end());
+        }
+        data->worker_numa[workerids[i]] = -1;
+    }
+}
+
+//! Set priority of a submitted task, unless it was set explicitly
+static void submit_hook(starpu_task *task)
+{
+    if(task->priority == STARPU_DEFAULT_PRIO)
+    {
+        task->priority = current_priority;
+    }
+    trace::submit_hook(task);
+}
+
+static int push_task(starpu_task *task)
+{
+    auto data = static_cast<sched_data_t *>(
+            starpu_sched_ctx_get_policy_data(task->sched_ctx));
+    int workerid = -1;
+    std::vector<int> workers;
+    {
+        std::lock_guard<std::mutex> lock(data->mutex);
+        starpu_data_handle_t output = get_output(task);
+        int ncuda = data->cuda_workers.size();
+        if(output and ncuda > 0)
+        {
+            int device = get_device(output);
+            // The first write assigns the owner with the shortest queue
+            if(device < 0)
+            {
+                device = 0;
+                for(int i = 1; i < ncuda; ++i)
+                {
+                    if(data->queues[data->cuda_workers[i]].size()
+                            < data->queues[data->cuda_workers[device]].size())
+                    {
+                        device = i;
+                    }
+                }
+                set_device(output, device);
+            }
+            int owner = data->cuda_workers[device % ncuda];
+            unsigned nimpl;
+            if(starpu_worker_can_execute_task_first_impl(owner, task, &nimpl))
+            {
+                workerid = owner;
+            }
+        }
+        int numa = output ? get_numa(output) : -1;
+        int nnuma = data->numa_queues.size();
+        if(workerid >= 0)
+        {
+            data->queues[workerid].emplace(task->priority, task);
+        }
+        // Tasks, that are not queued to a CUDA worker, go to CPU workers of
+        // the NUMA node of their output, so that the output is allocated
+        // and updated in the memory of the node
+        else if(numa >= 0 and nnuma > 0)
+        {
+            data->numa_queues[numa % nnuma].emplace(task->priority, task);
+        }
+        else
+        {
+            data->shared.emplace(task->priority, task);
+        }
+        starpu_push_task_end(task);
+        workers = data->workers;
+    }
+    // Owner gets the task, while other workers may need it for stealing
+    for(int worker: workers)
+    {
+        starpu_wake_worker_relax_light(worker);
+    }
+    return 0;
+}
+
+static starpu_task *pop_task(unsigned sched_ctx_id)
+{
+    auto data = static_cast<sched_data_t *>(
+            starpu_sched_ctx_get_policy_data(sched_ctx_id));
+    int workerid = starpu_worker_get_id_check();
+    std::lock_guard<std::mutex> lock(data->mutex);
+    starpu_task *task = pop_from(data->queues[workerid], workerid);
+    if(task)
+    {
+        return task;
+    }
+    // CPU worker prefers tasks of its NUMA node
+    int numa = data->worker_numa[workerid];
+    if(numa >= 0)
+    {
+        task = pop_from(data->numa_queues[numa], workerid);
+        if(task)
+        {
+            return task;
+        }
+    }
+    task = pop_from(data->shared, workerid);
+    if(task)
+    {
+        return task;
+    }
+    // Tasks of other NUMA nodes are taken instead of idling
+    for(auto &queue: data->numa_queues)
+    {
+        task = pop_from(queue, workerid);
+        if(task)
+        {
+            return task;
+        }
+    }
+    if(starpu_worker_get_type(workerid) != STARPU_CUDA_WORKER)
+    {
+        return task;
+    }
+    // Steal from the longest queue of another CUDA worker
+    int victim = -1;
+    std::size_t victim_size = 1;
+    for(int worker: data->cuda_workers)
+    {
+        if(worker != workerid and data->queues[worker].size() > victim_size)
+        {
+            victim = worker;
+            victim_size = data->queues[worker].size();
+        }
+    }
+    if(victim >= 0)
+    {
+        task = pop_from(data->queues[victim], workerid);
+    }
+    return task;
+}
+
+//! Fill in the policy structure
+static struct starpu_sched_policy make_policy()
+{
+    struct starpu_sched_policy policy;
+    std::memset(&policy, 0, sizeof(policy));
+    policy.init_sched = init_sched;
+    policy.deinit_sched = deinit_sched;
+    policy.add_workers = add_workers;
+    policy.remove_workers = remove_workers;
+    policy.submit_hook = submit_hook;
+    policy.push_task = push_task;
+    policy.pop_task = pop_task;
+    policy.policy_name = name;
+    policy.policy_description = "NNTile locality-aware scheduler with "
+        "priorities";
+    policy.worker_type = STARPU_WORKER_LIST;
+    return policy;
+}
+
+struct starpu_sched_policy policy = make_policy();
+
+void apply_priorities(const char *policy_name)
+{
+    if(policy_name == nullptr)
+    {
+        return;
+    }
+    starpu_sched_policy **policies = starpu_sched_get_predefined_policies();
+    for(; *policies != nullptr; ++policies)
+    {
+        if(std::strcmp((*policies)->policy_name, policy_name) == 0
+                and (*policies)->submit_hook == nullptr)
+        {
+            (*policies)->submit_hook = submit_hook;
+        }
+    }
+}
+
+} // namespace scheduler
+} // namespace starpu
+} // namespace nntile
+
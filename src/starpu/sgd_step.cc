@@ -0,0 +1,196 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/sgd_step.cc
+ * Fused SGD step with momentum with StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/sgd_step.hh"
+#include "nntile/kernel/sgd_step.hh"
+#include "nntile/kernel/parallel.hh"
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for one step of SGD optimizer with momentum
+namespace sgd_step
+{
+
+//! Apply SGD step on StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces, velocity is present only with momentum
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *grad = interfaces[0]->get_ptr<T>();
+    T *velocity = nullptr, *p;
+    if(args->momentum != T(0))
+    {
+        velocity = interfaces[1]->get_ptr<T>();
+        p = interfaces[2]->get_ptr<T>();
+    }
+    else
+    {
+        p = interfaces[1]->get_ptr<T>();
+    }
+    // Use all threads of a parallel worker
+    kernel::parallel::Scope threads(starpu_combined_worker_get_size());
+    // Launch kernel
+    kernel::sgd_step::cpu<T>(args->num_iter, args->num_elems, args->momentum,
+            args->dampening, args->lr, args->weight_decay, args->nesterov,
+            grad, velocity, p);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Apply SGD step on StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces, velocity is present only with momentum
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *grad = interfaces[0]->get_ptr<T>();
+    T *velocity = nullptr, *p;
+    if(args->momentum != T(0))
+    {
+        velocity = interfaces[1]->get_ptr<T>();
+        p = interfaces[2]->get_ptr<T>();
+    }
+    else
+    {
+        p = interfaces[1]->get_ptr<T>();
+    }
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::sgd_step::cuda<T>(stream, args->num_iter, args->num_elems,
+            args->momentum, args->dampening, args->lr, args->weight_decay,
+            args->nesterov, grad, velocity, p);
+}
+#endif // NNTILE_USE_CUDA
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_sgd_step_fp32",
+            nullptr,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_sgd_step_fp64",
+            nullptr,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    // CPU implementations may use all threads of parallel workers
+    codelet_fp32.set_parallel();
+    codelet_fp64.set_parallel();
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index num_iter, Index num_elems, T momentum, T dampening, T lr,
+        T weight_decay, bool nesterov, HandleRef grad, HandleRef velocity,
+        HandleRef p)
+//! Insert task of a fused SGD step
+/*! Velocity is not accessed if momentum is zero, and it is only written at
+ * the first iteration.
+ * */
+{
+    // Codelet arguments
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
+    args->num_iter = num_iter;
+    args->num_elems = num_elems;
+    args->momentum = momentum;
+    args->dampening = dampening;
+    args->lr = lr;
+    args->weight_decay = weight_decay;
+    args->nesterov = nesterov;
+    fp64_t nflops = 7 * num_elems;
+    // Submit task
+    int ret;
+    if(momentum != T(0))
+    {
+        enum starpu_data_access_mode velocity_mode;
+        if(num_iter == 1)
+        {
+            velocity_mode = STARPU_W;
+        }
+        else
+        {
+            velocity_mode = STARPU_RW;
+        }
+        ret = task_insert(codelet<T>(),
+                STARPU_R, static_cast<starpu_data_handle_t>(grad),
+                velocity_mode, static_cast<starpu_data_handle_t>(velocity),
+                STARPU_RW, static_cast<starpu_data_handle_t>(p),
+                STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+                STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+                STARPU_FLOPS, nflops,
+                0);
+    }
+    else
+    {
+        ret = task_insert(codelet<T>(),
+                STARPU_R, static_cast<starpu_data_handle_t>(grad),
+                STARPU_RW, static_cast<starpu_data_handle_t>(p),
+                STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+                STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+                STARPU_FLOPS, nflops,
+                0);
+    }
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in sgd_step task submission");
+    }
+}
+
+// Explicit instantiaion
+template
+void submit<fp32_t>(Index num_iter, Index num_elems, fp32_t momentum,
+        fp32_t dampening, fp32_t lr, fp32_t weight_decay, bool nesterov,
+        HandleRef grad, HandleRef velocity, HandleRef p);
+
+template
+void submit<fp64_t>(Index num_iter, Index num_elems, fp64_t momentum,
+        fp64_t dampening, fp64_t lr, fp64_t weight_decay, bool nesterov,
+        HandleRef grad, HandleRef velocity, HandleRef p);
+
+} // namespace sgd_step
+} // namespace starpu
+} // namespace nntile
+
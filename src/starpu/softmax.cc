@@ -14,6 +14,7 @@
 
 #include "nntile/starpu/softmax.hh"
 #include "nntile/kernel/softmax.hh"
+#include "nntile/kernel/parallel.hh"
 #include <cstdlib>
 
 namespace nntile
@@ -35,6 +36,8 @@ void cpu(void *buffers[], void *cl_args)
     const T *maxsumexp = interfaces[0]->get_ptr<T>();
     const T *src = interfaces[1]->get_ptr<T>();
     T *dst = interfaces[2]->get_ptr<T>();
+    // Use all threads of a parallel worker
+    kernel::parallel::Scope threads(starpu_combined_worker_get_size());
     // Launch kernel
     kernel::softmax::cpu<T>(args->m, args->n, args->k, maxsumexp, src,
             args->alpha, dst);
@@ -100,6 +103,9 @@ void init()
             {}
 #endif // NNTILE_USE_CUDA
             );
+    // CPU implementations may use all threads of parallel workers
+    codelet_fp32.set_parallel();
+    codelet_fp64.set_parallel();
 }
 
 void restrict_where(uint32_t where)
@@ -115,8 +121,8 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index m, Index n, Index k, Handle maxsumexp, Handle src, T alpha,
-        Handle dst)
+void submit(Index m, Index n, Index k, HandleRef maxsumexp, HandleRef src,
+        T alpha, HandleRef dst)
 //! Insert softmax task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -124,18 +130,20 @@ void submit(Index m, Index n, Index k, Handle maxsumexp, Handle src, T alpha,
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->m = m;
     args->n = n;
     args->k = k;
     args->alpha = alpha;
+    fp64_t nflops = 3 * m * n * k;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(maxsumexp),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_W, static_cast<starpu_data_handle_t>(dst),
-            STARPU_CL_ARGS, args, sizeof(*args),
-            //STARPU_FLOPS, nflops,
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -146,12 +154,12 @@ void submit(Index m, Index n, Index k, Handle maxsumexp, Handle src, T alpha,
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index m, Index n, Index k, Handle maxsumexp, Handle src,
-        fp32_t alpha, Handle dst);
+void submit<fp32_t>(Index m, Index n, Index k, HandleRef maxsumexp,
+        HandleRef src, fp32_t alpha, HandleRef dst);
 
 template
-void submit<fp64_t>(Index m, Index n, Index k, Handle maxsumexp, Handle src,
-        fp64_t alpha, Handle dst);
+void submit<fp64_t>(Index m, Index n, Index k, HandleRef maxsumexp,
+        HandleRef src, fp64_t alpha, HandleRef dst);
 
 } // namespace softmax
 } // namespace starpu
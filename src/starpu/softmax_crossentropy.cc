@@ -0,0 +1,170 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/softmax_crossentropy.cc
+ * Fused loss and gradient of softmax cross-entropy on StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-14
+ * */
+
+#include "nntile/starpu/softmax_crossentropy.hh"
+#include "nntile/kernel/softmax_crossentropy.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace softmax_crossentropy
+{
+
+//! Fused softmax cross-entropy of StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *maxsumexp = interfaces[0]->get_ptr<T>();
+    const T *src = interfaces[1]->get_ptr<T>();
+    const Index *labels = interfaces[2]->get_ptr<Index>();
+    T *dst = interfaces[3]->get_ptr<T>();
+    T *val = interfaces[4]->get_ptr<T>();
+    // Launch kernel
+    kernel::softmax_crossentropy::cpu<T>(args->n_labels, args->n_outputs,
+            args->label_start, args->scale, maxsumexp, src, labels, dst, val);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Fused softmax cross-entropy of StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *maxsumexp = interfaces[0]->get_ptr<T>();
+    const T *src = interfaces[1]->get_ptr<T>();
+    const Index *labels = interfaces[2]->get_ptr<Index>();
+    T *dst = interfaces[3]->get_ptr<T>();
+    T *val = interfaces[4]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::softmax_crossentropy::cuda<T>(stream, args->n_labels,
+            args->n_outputs, args->label_start, args->scale, maxsumexp, src,
+            labels, dst, val);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for fused softmax cross-entropy tasks
+template<typename T>
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(task->cl_arg);
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->n_labels, sizeof(args->n_labels),
+            hash);
+    hash = starpu_hash_crc32c_be_n(&args->n_outputs, sizeof(args->n_outputs),
+            hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_softmax_crossentropy_fp32",
+            footprint<fp32_t>,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_softmax_crossentropy_fp64",
+            footprint<fp64_t>,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index n_labels, Index n_outputs, Index label_start, T scale,
+        HandleRef maxsumexp, HandleRef src, HandleRef labels, HandleRef dst,
+        HandleRef val)
+//! Insert fused softmax cross-entropy task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
+    args->n_labels = n_labels;
+    args->n_outputs = n_outputs;
+    args->label_start = label_start;
+    args->scale = scale;
+    fp64_t nflops = 3 * n_labels * n_outputs;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(maxsumexp),
+            STARPU_R, static_cast<starpu_data_handle_t>(src),
+            STARPU_R, static_cast<starpu_data_handle_t>(labels),
+            STARPU_W, static_cast<starpu_data_handle_t>(dst),
+            STARPU_RW | STARPU_COMMUTE, static_cast<starpu_data_handle_t>(val),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in softmax_crossentropy task "
+                "submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index n_labels, Index n_outputs, Index label_start,
+        fp32_t scale, HandleRef maxsumexp, HandleRef src, HandleRef labels,
+        HandleRef dst, HandleRef val);
+
+template
+void submit<fp64_t>(Index n_labels, Index n_outputs, Index label_start,
+        fp64_t scale, HandleRef maxsumexp, HandleRef src, HandleRef labels,
+        HandleRef dst, HandleRef val);
+
+} // namespace softmax_crossentropy
+} // namespace starpu
+} // namespace nntile
+
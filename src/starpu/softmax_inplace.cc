@@ -75,7 +75,7 @@ uint32_t footprint(struct starpu_task *task)
     return hash;
 }
 
-Codelet codelet_fp32, codelet_fp64;
+Codelet codelet_fp32, codelet_fp64, codelet_bf16, codelet_fp16;
 
 void init()
 {
@@ -95,6 +95,24 @@ void init()
             {cuda<fp64_t>}
 #else // NNTILE_USE_CUDA
             {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_bf16.init("nntile_softmax_inplace_bf16",
+            footprint<bf16_t>,
+            {cpu<bf16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<bf16_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp16.init("nntile_softmax_inplace_fp16",
+            footprint<fp16_t>,
+            {cpu<fp16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp16_t>}
+#else // NNTILE_USE_CUDA
+            {}
 #endif // NNTILE_USE_CUDA
             );
 }
@@ -103,16 +121,21 @@ void restrict_where(uint32_t where)
 {
     codelet_fp32.restrict_where(where);
     codelet_fp64.restrict_where(where);
+    codelet_bf16.restrict_where(where);
+    codelet_fp16.restrict_where(where);
 }
 
 void restore_where()
 {
     codelet_fp32.restore_where();
     codelet_fp64.restore_where();
+    codelet_bf16.restore_where();
+    codelet_fp16.restore_where();
 }
 
 template<typename T>
-void submit(Index m, Index n, Index k, Handle maxsumexp, T alpha, Handle dst)
+void submit(Index m, Index n, Index k, HandleRef maxsumexp, T alpha,
+        HandleRef dst)
 //! Insert softmax_inplace task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -120,17 +143,19 @@ void submit(Index m, Index n, Index k, Handle maxsumexp, T alpha, Handle dst)
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->m = m;
     args->n = n;
     args->k = k;
     args->alpha = alpha;
+    fp64_t nflops = 3 * m * n * k;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(maxsumexp),
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
-            STARPU_CL_ARGS, args, sizeof(*args),
-            //STARPU_FLOPS, nflops,
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -141,12 +166,20 @@ void submit(Index m, Index n, Index k, Handle maxsumexp, T alpha, Handle dst)
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index m, Index n, Index k, Handle maxsumexp, fp32_t alpha,
-        Handle dst);
+void submit<fp32_t>(Index m, Index n, Index k, HandleRef maxsumexp,
+        fp32_t alpha, HandleRef dst);
+
+template
+void submit<fp64_t>(Index m, Index n, Index k, HandleRef maxsumexp,
+        fp64_t alpha, HandleRef dst);
+
+template
+void submit<bf16_t>(Index m, Index n, Index k, HandleRef maxsumexp,
+        bf16_t alpha, HandleRef dst);
 
 template
-void submit<fp64_t>(Index m, Index n, Index k, Handle maxsumexp, fp64_t alpha,
-        Handle dst);
+void submit<fp16_t>(Index m, Index n, Index k, HandleRef maxsumexp,
+        fp16_t alpha, HandleRef dst);
 
 } // namespace softmax_inplace
 } // namespace starpu
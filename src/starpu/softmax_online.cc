@@ -0,0 +1,186 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/softmax_online.cc
+ * Online softmax along the middle axis of several StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/softmax_online.hh"
+#include "nntile/kernel/softmax_online.hh"
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for online softmax over several buffers
+namespace softmax_online
+{
+
+// Get pointers to buffers and sizes of their middle modes
+template<typename T>
+static void get_buffers(const args_t<T> *args, void *buffers[],
+        std::vector<Index> &k, std::vector<T *> &dst)
+{
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    Index ntiles = args->ntiles;
+    k.resize(ntiles);
+    dst.resize(ntiles);
+    for(Index j = 0; j < ntiles; ++j)
+    {
+        k[j] = interfaces[j]->elemsize / (sizeof(T)*args->m*args->n);
+        dst[j] = interfaces[j]->get_ptr<T>();
+    }
+}
+
+//! Online softmax along middle axis of StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    std::vector<Index> k;
+    std::vector<T *> dst;
+    get_buffers<T>(args, buffers, k, dst);
+    // Launch kernel
+    kernel::softmax_online::cpu<T>(args->m, args->n, args->ntiles, k.data(),
+            args->alpha, dst.data());
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Online softmax along middle axis of StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    std::vector<Index> k;
+    std::vector<T *> dst;
+    get_buffers<T>(args, buffers, k, dst);
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::softmax_online::cuda<T>(stream, args->m, args->n, args->ntiles,
+            k.data(), args->alpha, dst.data());
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for softmax_online tasks that depends only on m, n and k
+template<typename T>
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(task->cl_arg);
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    hash = starpu_hash_crc32c_be_n(&args->k, sizeof(args->k), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_softmax_online_fp32",
+            footprint<fp32_t>,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_softmax_online_fp64",
+            footprint<fp64_t>,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index m, Index n, T alpha, const std::vector<Handle> &dst)
+//! Insert softmax_online task into StarPU pool of tasks
+/*! Buffers of dst are concatenated along the middle axis, while sizes of
+ * their middle modes are derived from sizes of buffers. If task submission
+ * fails, this routines throws an std::runtime_error() exception.
+ * */
+{
+    Index ntiles = dst.size();
+    if(ntiles == 0)
+    {
+        return;
+    }
+    if(ntiles > kernel::softmax_online::MAX_TILES)
+    {
+        throw std::runtime_error("Too many buffers in softmax_online");
+    }
+    // Codelet arguments
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
+    args->m = m;
+    args->n = n;
+    args->k = 0;
+    args->ntiles = ntiles;
+    args->alpha = alpha;
+    std::vector<starpu_data_descr> descrs(ntiles);
+    for(Index j = 0; j < ntiles; ++j)
+    {
+        descrs[j].handle = static_cast<starpu_data_handle_t>(dst[j]);
+        descrs[j].mode = STARPU_RW;
+        args->k += starpu_data_get_size(descrs[j].handle) / (sizeof(T)*m*n);
+    }
+    fp64_t nflops = 4 * m * n * args->k;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_DATA_MODE_ARRAY, descrs.data(), int(descrs.size()),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in softmax_online task submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index m, Index n, fp32_t alpha,
+        const std::vector<Handle> &dst);
+
+template
+void submit<fp64_t>(Index m, Index n, fp64_t alpha,
+        const std::vector<Handle> &dst);
+
+} // namespace softmax_online
+} // namespace starpu
+} // namespace nntile
+
@@ -0,0 +1,177 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/sparse_adam_step.cc
+ * Fused Adam step on marked columns of StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-13
+ * */
+
+#include "nntile/starpu/sparse_adam_step.hh"
+#include "nntile/kernel/sparse_adam_step.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for one step of lazy Adam optimizer
+namespace sparse_adam_step
+{
+
+//! Apply sparse Adam step on StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const bool_t *cols = interfaces[0]->get_ptr<bool_t>();
+    Index *cols_iter = interfaces[1]->get_ptr<Index>();
+    const T *grad = interfaces[2]->get_ptr<T>();
+    T *first_moment = interfaces[3]->get_ptr<T>();
+    T *second_moment = interfaces[4]->get_ptr<T>();
+    T *p = interfaces[5]->get_ptr<T>();
+    // Launch kernel
+    kernel::sparse_adam_step::cpu<T>(args->m, args->n, args->beta_1,
+            args->beta_2, args->eps, args->lr, args->weight_decay, cols,
+            cols_iter, grad, first_moment, second_moment, p);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Apply sparse Adam step on StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const bool_t *cols = interfaces[0]->get_ptr<bool_t>();
+    Index *cols_iter = interfaces[1]->get_ptr<Index>();
+    const T *grad = interfaces[2]->get_ptr<T>();
+    T *first_moment = interfaces[3]->get_ptr<T>();
+    T *second_moment = interfaces[4]->get_ptr<T>();
+    T *p = interfaces[5]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::sparse_adam_step::cuda<T>(stream, args->m, args->n, args->beta_1,
+            args->beta_2, args->eps, args->lr, args->weight_decay, cols,
+            cols_iter, grad, first_moment, second_moment, p);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for sparse Adam tasks that depends only on m and n
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<fp32_t> *>(task->cl_arg);
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_sparse_adam_step_fp32",
+            footprint,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_sparse_adam_step_fp64",
+            footprint,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index m, Index n, T beta_1, T beta_2, T eps, T lr,
+        T weight_decay, HandleRef cols, HandleRef cols_iter, HandleRef grad,
+        HandleRef first_moment, HandleRef second_moment, HandleRef p)
+//! Insert sparse Adam step task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
+    args->m = m;
+    args->n = n;
+    args->beta_1 = beta_1;
+    args->beta_2 = beta_2;
+    args->eps = eps;
+    args->lr = lr;
+    args->weight_decay = weight_decay;
+    // Upper bound, as only marked columns are updated
+    fp64_t nflops = 15 * m * n;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(cols),
+            STARPU_RW, static_cast<starpu_data_handle_t>(cols_iter),
+            STARPU_R, static_cast<starpu_data_handle_t>(grad),
+            STARPU_RW, static_cast<starpu_data_handle_t>(first_moment),
+            STARPU_RW, static_cast<starpu_data_handle_t>(second_moment),
+            STARPU_RW, static_cast<starpu_data_handle_t>(p),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in sparse_adam_step task submission");
+    }
+}
+
+// Explicit instantiaion
+template
+void submit<fp32_t>(Index m, Index n, fp32_t beta_1, fp32_t beta_2,
+        fp32_t eps, fp32_t lr, fp32_t weight_decay, HandleRef cols,
+        HandleRef cols_iter, HandleRef grad, HandleRef first_moment,
+        HandleRef second_moment, HandleRef p);
+
+template
+void submit<fp64_t>(Index m, Index n, fp64_t beta_1, fp64_t beta_2,
+        fp64_t eps, fp64_t lr, fp64_t weight_decay, HandleRef cols,
+        HandleRef cols_iter, HandleRef grad, HandleRef first_moment,
+        HandleRef second_moment, HandleRef p);
+
+} // namespace sparse_adam_step
+} // namespace starpu
+} // namespace nntile
+
@@ -10,7 +10,7 @@
  * @version 1.0.0
  * @author Aleksandr Mikhalev
  * @author Aleksandr Katrutsa
- * @date 2023-09-01
+ * @date 2024-02-15
  * */
 
 #include "nntile/starpu/subcopy.hh"
@@ -23,7 +23,7 @@ namespace starpu
 namespace subcopy
 {
 
-//! Complex copying through StarPU buffers is available only on CPU
+//! Complex copying through StarPU buffers on CPU
 template<typename T>
 void cpu(void *buffers[], void *cl_args)
     noexcept
@@ -43,6 +43,29 @@ void cpu(void *buffers[], void *cl_args)
             copy_shape, src, dst_start, dst_stride, dst, tmp_index);
 }
 
+#ifdef NNTILE_USE_CUDA
+//! Complex copying through StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    const Index *ndim_ptr, *src_start, *src_stride, *copy_shape, *dst_start,
+          *dst_stride;
+    Config::unpack_args_ptr(cl_args, ndim_ptr, src_start, src_stride,
+            copy_shape, dst_start, dst_stride);
+    // Get interfaces, temporary index buffer is not needed on CUDA
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src = interfaces[0]->get_ptr<T>();
+    T *dst = interfaces[1]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::subcopy::cuda<T>(stream, *ndim_ptr, src_start, src_stride,
+            copy_shape, src, dst_start, dst_stride, dst);
+}
+#endif // NNTILE_USE_CUDA
+
 //! Footprint for copy tasks that depend on copy shape
 static
 uint32_t footprint(struct starpu_task *task)
@@ -57,54 +80,107 @@ uint32_t footprint(struct starpu_task *task)
     return starpu_hash_crc32c_be_n(copy_shape, copy_shape_size, 0);
 }
 
-Codelet codelet_fp16, codelet_fp32, codelet_fp64, codelet_int64,
-        codelet_bool;
+Codelet codelet_fp16, codelet_bf16, codelet_fp32, codelet_fp64,
+        codelet_int64, codelet_bool, codelet_int8, codelet_fp8_e4m3;
 
 void init()
 {
     codelet_fp16.init("nntile_subcopy_fp16",
             footprint,
-            {cpu<fp32_t>},
+            {cpu<fp16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp16_t>}
+#else // NNTILE_USE_CUDA
             {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_bf16.init("nntile_subcopy_bf16",
+            footprint,
+            {cpu<bf16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<bf16_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
             );
     codelet_fp32.init("nntile_subcopy_fp32",
             footprint,
             {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
             {}
+#endif // NNTILE_USE_CUDA
             );
     codelet_fp64.init("nntile_subcopy_fp64",
             footprint,
             {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
             {}
+#endif // NNTILE_USE_CUDA
             );
     codelet_int64.init("nntile_subcopy_int64",
             footprint,
             {cpu<Index>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<Index>}
+#else // NNTILE_USE_CUDA
             {}
+#endif // NNTILE_USE_CUDA
             );
     codelet_bool.init("nntile_subcopy_bool",
             footprint,
             {cpu<bool_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<bool_t>}
+#else // NNTILE_USE_CUDA
             {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_int8.init("nntile_subcopy_int8",
+            footprint,
+            {cpu<std::int8_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<std::int8_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp8_e4m3.init("nntile_subcopy_fp8_e4m3",
+            footprint,
+            {cpu<fp8_e4m3_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp8_e4m3_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
             );
 }
 
 void restrict_where(uint32_t where)
 {
     codelet_fp16.restrict_where(where);
+    codelet_bf16.restrict_where(where);
     codelet_fp32.restrict_where(where);
     codelet_fp64.restrict_where(where);
     codelet_int64.restrict_where(where);
     codelet_bool.restrict_where(where);
+    codelet_int8.restrict_where(where);
+    codelet_fp8_e4m3.restrict_where(where);
 }
 
 void restore_where()
 {
     codelet_fp16.restore_where();
+    codelet_bf16.restore_where();
     codelet_fp32.restore_where();
     codelet_fp64.restore_where();
     codelet_int64.restore_where();
     codelet_bool.restore_where();
+    codelet_int8.restore_where();
+    codelet_fp8_e4m3.restore_where();
 }
 
 template<typename T>
@@ -112,12 +188,12 @@ void submit(Index ndim, const std::vector<Index> &src_start,
         const std::vector<Index> &src_stride,
         const std::vector<Index> &dst_start,
         const std::vector<Index> &dst_stride,
-        const std::vector<Index> &copy_shape, Handle src, Handle dst,
-        Handle tmp_index, starpu_data_access_mode mode)
+        const std::vector<Index> &copy_shape, HandleRef src, HandleRef dst,
+        HandleRef tmp_index, starpu_data_access_mode mode)
 {
     constexpr fp64_t zero_flops = 0;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_VALUE, &(ndim), sizeof(ndim),
             STARPU_VALUE, &(src_start[0]), ndim*sizeof(src_start[0]),
             STARPU_VALUE, &(src_stride[0]), ndim*sizeof(src_stride[0]),
@@ -142,40 +218,64 @@ void submit<fp16_t>(Index ndim, const std::vector<Index> &src_start,
         const std::vector<Index> &src_stride,
         const std::vector<Index> &dst_start,
         const std::vector<Index> &dst_stride,
-        const std::vector<Index> &copy_shape, Handle src, Handle dst,
-        Handle tmp_index, starpu_data_access_mode mode);
+        const std::vector<Index> &copy_shape, HandleRef src, HandleRef dst,
+        HandleRef tmp_index, starpu_data_access_mode mode);
+
+template
+void submit<bf16_t>(Index ndim, const std::vector<Index> &src_start,
+        const std::vector<Index> &src_stride,
+        const std::vector<Index> &dst_start,
+        const std::vector<Index> &dst_stride,
+        const std::vector<Index> &copy_shape, HandleRef src, HandleRef dst,
+        HandleRef tmp_index, starpu_data_access_mode mode);
 
 template
 void submit<fp32_t>(Index ndim, const std::vector<Index> &src_start,
         const std::vector<Index> &src_stride,
         const std::vector<Index> &dst_start,
         const std::vector<Index> &dst_stride,
-        const std::vector<Index> &copy_shape, Handle src, Handle dst,
-        Handle tmp_index, starpu_data_access_mode mode);
+        const std::vector<Index> &copy_shape, HandleRef src, HandleRef dst,
+        HandleRef tmp_index, starpu_data_access_mode mode);
 
 template
 void submit<fp64_t>(Index ndim, const std::vector<Index> &src_start,
         const std::vector<Index> &src_stride,
         const std::vector<Index> &dst_start,
         const std::vector<Index> &dst_stride,
-        const std::vector<Index> &copy_shape, Handle src, Handle dst,
-        Handle tmp_index, starpu_data_access_mode mode);
+        const std::vector<Index> &copy_shape, HandleRef src, HandleRef dst,
+        HandleRef tmp_index, starpu_data_access_mode mode);
 
 template
 void submit<Index>(Index ndim, const std::vector<Index> &src_start,
         const std::vector<Index> &src_stride,
         const std::vector<Index> &dst_start,
         const std::vector<Index> &dst_stride,
-        const std::vector<Index> &copy_shape, Handle src, Handle dst,
-        Handle tmp_index, starpu_data_access_mode mode);
+        const std::vector<Index> &copy_shape, HandleRef src, HandleRef dst,
+        HandleRef tmp_index, starpu_data_access_mode mode);
 
 template
 void submit<bool_t>(Index ndim, const std::vector<Index> &src_start,
         const std::vector<Index> &src_stride,
         const std::vector<Index> &dst_start,
         const std::vector<Index> &dst_stride,
-        const std::vector<Index> &copy_shape, Handle src, Handle dst,
-        Handle tmp_index, starpu_data_access_mode mode);
+        const std::vector<Index> &copy_shape, HandleRef src, HandleRef dst,
+        HandleRef tmp_index, starpu_data_access_mode mode);
+
+template
+void submit<std::int8_t>(Index ndim, const std::vector<Index> &src_start,
+        const std::vector<Index> &src_stride,
+        const std::vector<Index> &dst_start,
+        const std::vector<Index> &dst_stride,
+        const std::vector<Index> &copy_shape, HandleRef src, HandleRef dst,
+        HandleRef tmp_index, starpu_data_access_mode mode);
+
+template
+void submit<fp8_e4m3_t>(Index ndim, const std::vector<Index> &src_start,
+        const std::vector<Index> &src_stride,
+        const std::vector<Index> &dst_start,
+        const std::vector<Index> &dst_stride,
+        const std::vector<Index> &copy_shape, HandleRef src, HandleRef dst,
+        HandleRef tmp_index, starpu_data_access_mode mode);
 
 } // namespace subcopy
 } // namespace starpu
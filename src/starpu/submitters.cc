@@ -0,0 +1,209 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/submitters.cc
+ * Pool of threads, that submit tasks of tensor operations
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/submitters.hh"
+#include <starpu_mpi.h>
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace submitters
+{
+
+//! Minimal number of iterations per thread
+static constexpr Index min_per_thread = 16;
+
+//! Pool of threads, waiting for ranges of the current loop
+class Pool
+{
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable start_cv, done_cv;
+    //! Body and bounds of ranges of the current loop
+    const std::function<void(Index)> *body = nullptr;
+    std::vector<Index> bounds;
+    //! Loop counter, that wakes up threads
+    Index generation = 0;
+    //! Number of ranges, that are not finished yet
+    Index pending = 0;
+    //! The first exception of any range
+    std::exception_ptr error;
+    bool stop = false;
+    // Run a range of the current loop
+    void run(Index part)
+    {
+        try
+        {
+            for(Index i = bounds[part]; i < bounds[part+1]; ++i)
+            {
+                (*body)(i);
+            }
+        }
+        catch(...)
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            if(not error)
+            {
+                error = std::current_exception();
+            }
+        }
+    }
+    // Body of a pooled thread, that runs range part+1 of every loop, that
+    // starts after a given one
+    void loop(Index part, Index seen);
+public:
+    //! Serializes loops, as there is a single current loop
+    std::mutex loop_mutex;
+    ~Pool()
+    {
+        resize(0);
+    }
+    Index size() const
+    {
+        return threads.size();
+    }
+    //! Stop all the threads and start a given number of new ones
+    void resize(Index nthreads);
+    //! Run a loop split into ranges by bounds on the calling thread and
+    //! bounds.size()-2 pooled threads
+    void run_all(const std::function<void(Index)> &body_,
+            std::vector<Index> bounds_);
+};
+
+//! Marks threads, that currently run a body of a loop
+static thread_local bool in_loop = false;
+
+void Pool::loop(Index part, Index seen)
+{
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            start_cv.wait(lock, [&]{return stop or generation != seen;});
+            if(stop)
+            {
+                return;
+            }
+            seen = generation;
+            // Threads without a range of the current loop wait for the next
+            if(part+2 >= static_cast<Index>(bounds.size()))
+            {
+                continue;
+            }
+        }
+        in_loop = true;
+        run(part+1);
+        in_loop = false;
+        const std::lock_guard<std::mutex> lock(mutex);
+        if(--pending == 0)
+        {
+            done_cv.notify_one();
+        }
+    }
+}
+
+void Pool::resize(Index nthreads)
+{
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    start_cv.notify_all();
+    for(auto &thread: threads)
+    {
+        thread.join();
+    }
+    threads.clear();
+    stop = false;
+    for(Index i = 0; i < nthreads; ++i)
+    {
+        threads.emplace_back(&Pool::loop, this, i, generation);
+    }
+}
+
+void Pool::run_all(const std::function<void(Index)> &body_,
+        std::vector<Index> bounds_)
+{
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        body = &body_;
+        bounds = std::move(bounds_);
+        pending = bounds.size() - 2;
+        error = nullptr;
+        ++generation;
+    }
+    start_cv.notify_all();
+    in_loop = true;
+    run(0);
+    in_loop = false;
+    std::unique_lock<std::mutex> lock(mutex);
+    done_cv.wait(lock, [&]{return pending == 0;});
+    body = nullptr;
+    if(error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+static Pool pool;
+
+void set_nthreads(int nthreads)
+{
+    if(nthreads < 1)
+    {
+        throw std::runtime_error("nthreads < 1");
+    }
+    const std::lock_guard<std::mutex> lock(pool.loop_mutex);
+    pool.resize(nthreads-1);
+}
+
+int get_nthreads()
+{
+    return pool.size() + 1;
+}
+
+void parallel_for(Index n, const std::function<void(Index)> &body)
+{
+    Index nparts = std::min<Index>(pool.size()+1, n/min_per_thread);
+    std::unique_lock<std::mutex> lock(pool.loop_mutex, std::defer_lock);
+    if(nparts <= 1 or in_loop or starpu_mpi_world_size() > 1
+            or not lock.try_lock())
+    {
+        for(Index i = 0; i < n; ++i)
+        {
+            body(i);
+        }
+        return;
+    }
+    // Pool could be resized before the lock
+    nparts = std::min<Index>(pool.size()+1, nparts);
+    std::vector<Index> bounds(nparts+1);
+    for(Index part = 0; part <= nparts; ++part)
+    {
+        bounds[part] = n * part / nparts;
+    }
+    pool.run_all(body, std::move(bounds));
+}
+
+} // namespace submitters
+} // namespace starpu
+} // namespace nntile
+
@@ -117,20 +117,23 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index n_labels, Index n_outputs, T val, Handle labels, Handle dst)
+void submit(Index n_labels, Index n_outputs, T val, HandleRef labels,
+        HandleRef dst)
 {
     // Codelet arguments
-    args_t<T>* args = (args_t<T>*)malloc(sizeof(args_t<T>));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->n_labels = n_labels;
     args->n_outputs = n_outputs;
     args->value = val;
+    fp64_t nflops = n_outputs;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(labels),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
             //Config::STARPU_RW_COMMUTE, static_cast<starpu_data_handle_t>(dst),
-            //STARPU_FLOPS, nflops,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -142,12 +145,12 @@ void submit(Index n_labels, Index n_outputs, T val, Handle labels, Handle dst)
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index n_labels, Index n_outputs, fp32_t val, Handle labels,
-        Handle dst);
+void submit<fp32_t>(Index n_labels, Index n_outputs, fp32_t val,
+        HandleRef labels, HandleRef dst);
 
 template
-void submit<fp64_t>(Index n_labels, Index n_outputs, fp64_t val, Handle labels,
-        Handle dst);
+void submit<fp64_t>(Index n_labels, Index n_outputs, fp64_t val,
+        HandleRef labels, HandleRef dst);
 
 } // namespace subtract_indexed_outputs
 } // namespace starpu
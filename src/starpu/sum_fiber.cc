@@ -112,8 +112,8 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index m, Index n, Index k, Index batch, T alpha, Handle src,
-        T beta, Handle dst, int redux)
+void submit(Index m, Index n, Index k, Index batch, T alpha, HandleRef src,
+        T beta, HandleRef dst, int redux)
 //! Insert sum_fiber task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -144,18 +144,21 @@ void submit(Index m, Index n, Index k, Index batch, T alpha, Handle src,
         dst_mode = STARPU_RW;
     }
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->m = m;
     args->n = n;
     args->k = k;
     args->batch = batch;
     args->alpha = alpha;
     args->beta = beta;
+    fp64_t nflops = m * n * k * batch;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             dst_mode, static_cast<starpu_data_handle_t>(dst),
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -167,11 +170,11 @@ void submit(Index m, Index n, Index k, Index batch, T alpha, Handle src,
 // Explicit instantiation
 template
 void submit<fp32_t>(Index m, Index n, Index k, Index batch, fp32_t alpha,
-        Handle src, fp32_t beta, Handle dst, int redux);
+        HandleRef src, fp32_t beta, HandleRef dst, int redux);
 
 template
 void submit<fp64_t>(Index m, Index n, Index k, Index batch, fp64_t alpha,
-        Handle src, fp64_t beta, Handle dst, int redux);
+        HandleRef src, fp64_t beta, HandleRef dst, int redux);
 
 } // namespace sum_fiber
 } // namespace starpu
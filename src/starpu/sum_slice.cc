@@ -75,7 +75,7 @@ uint32_t footprint(struct starpu_task *task)
     return hash;
 }
 
-Codelet codelet_fp32, codelet_fp64;
+Codelet codelet_fp32, codelet_fp64, codelet_bf16, codelet_fp16;
 
 void init()
 {
@@ -95,6 +95,24 @@ void init()
             {cuda<fp64_t>}
 #else // NNTILE_USE_CUDA
             {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_bf16.init("nntile_sum_slice_bf16",
+            footprint<bf16_t>,
+            {cpu<bf16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<bf16_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp16.init("nntile_sum_slice_fp16",
+            footprint<fp16_t>,
+            {cpu<fp16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp16_t>}
+#else // NNTILE_USE_CUDA
+            {}
 #endif // NNTILE_USE_CUDA
             );
 }
@@ -103,17 +121,21 @@ void restrict_where(uint32_t where)
 {
     codelet_fp32.restrict_where(where);
     codelet_fp64.restrict_where(where);
+    codelet_bf16.restrict_where(where);
+    codelet_fp16.restrict_where(where);
 }
 
 void restore_where()
 {
     codelet_fp32.restore_where();
     codelet_fp64.restore_where();
+    codelet_bf16.restore_where();
+    codelet_fp16.restore_where();
 }
 
 template<typename T>
-void submit(Index m, Index n, Index k, T alpha, Handle src, T beta,
-        Handle dst, int redux)
+void submit(Index m, Index n, Index k, T alpha, HandleRef src, T beta,
+        HandleRef dst, int redux)
 //! Insert sum_slice task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -121,7 +143,7 @@ void submit(Index m, Index n, Index k, T alpha, Handle src, T beta,
  * */
 {
     // Access mode for the dst handle
-    constexpr T zero = 0, one = 1;
+    constexpr compute_t<T> zero = 0, one = 1;
     enum starpu_data_access_mode dst_mode;
     if(beta == zero)
     {
@@ -144,7 +166,7 @@ void submit(Index m, Index n, Index k, T alpha, Handle src, T beta,
         dst_mode = STARPU_RW;
     }
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->m = m;
     args->n = n;
     args->k = k;
@@ -152,9 +174,10 @@ void submit(Index m, Index n, Index k, T alpha, Handle src, T beta,
     args->beta = beta;
     fp64_t nflops = m * n * (k+2);
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             dst_mode, static_cast<starpu_data_handle_t>(dst),
             STARPU_FLOPS, nflops,
             0);
@@ -167,12 +190,20 @@ void submit(Index m, Index n, Index k, T alpha, Handle src, T beta,
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index m, Index n, Index k, fp32_t alpha, Handle src,
-        fp32_t beta, Handle dst, int redux);
+void submit<fp32_t>(Index m, Index n, Index k, fp32_t alpha, HandleRef src,
+        fp32_t beta, HandleRef dst, int redux);
+
+template
+void submit<fp64_t>(Index m, Index n, Index k, fp64_t alpha, HandleRef src,
+        fp64_t beta, HandleRef dst, int redux);
+
+template
+void submit<bf16_t>(Index m, Index n, Index k, bf16_t alpha, HandleRef src,
+        bf16_t beta, HandleRef dst, int redux);
 
 template
-void submit<fp64_t>(Index m, Index n, Index k, fp64_t alpha, Handle src,
-        fp64_t beta, Handle dst, int redux);
+void submit<fp16_t>(Index m, Index n, Index k, fp16_t alpha, HandleRef src,
+        fp16_t beta, HandleRef dst, int redux);
 
 } // namespace sum_slice
 } // namespace starpu
@@ -109,7 +109,7 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index m, Index n, Index k, Handle src, Handle dst)
+void submit(Index m, Index n, Index k, HandleRef src, HandleRef dst)
 //! Insert sumnorm task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -117,19 +117,19 @@ void submit(Index m, Index n, Index k, Handle src, Handle dst)
  * */
 {
     // Codelet arguments
-    auto args = new args_t
-    {
-        .m = m,
-        .n = n,
-        .k = k
-    };
-    //fp64_t nflops = m * n * k;
+    args_t *args = ArgsPool::allocate<args_t>(args_t{
+            .m = m,
+            .n = n,
+            .k = k
+            });
+    fp64_t nflops = 3 * m * n * k;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             Config::STARPU_RW_COMMUTE, static_cast<starpu_data_handle_t>(dst),
-            //STARPU_FLOPS, nflops,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -140,10 +140,10 @@ void submit(Index m, Index n, Index k, Handle src, Handle dst)
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index m, Index n, Index k, Handle src, Handle dst);
+void submit<fp32_t>(Index m, Index n, Index k, HandleRef src, HandleRef dst);
 
 template
-void submit<fp64_t>(Index m, Index n, Index k, Handle src, Handle dst);
+void submit<fp64_t>(Index m, Index n, Index k, HandleRef src, HandleRef dst);
 
 } // namespace sumnorm
 } // namespace starpu
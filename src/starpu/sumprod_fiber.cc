@@ -114,8 +114,8 @@ void restore_where()
 }
 
 template<typename T>
-void submit(Index m, Index n, Index k, T alpha, Handle src1, Handle src2,
-        T beta, Handle dst, int redux)
+void submit(Index m, Index n, Index k, T alpha, HandleRef src1, HandleRef src2,
+        T beta, HandleRef dst, int redux)
 //! Insert sumprod_fiber task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -146,7 +146,7 @@ void submit(Index m, Index n, Index k, T alpha, Handle src1, Handle src2,
         dst_mode = STARPU_RW;
     }
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->m = m;
     args->n = n;
     args->k = k;
@@ -154,10 +154,11 @@ void submit(Index m, Index n, Index k, T alpha, Handle src1, Handle src2,
     args->beta = beta;
     fp64_t nflops = k * (2*m*n);
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
         STARPU_R, static_cast<starpu_data_handle_t>(src1),
         STARPU_R, static_cast<starpu_data_handle_t>(src2),
-        STARPU_CL_ARGS, args, sizeof(*args),
+        STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+        STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
         dst_mode, static_cast<starpu_data_handle_t>(dst),
         STARPU_FLOPS, nflops,
         0);
@@ -170,12 +171,12 @@ void submit(Index m, Index n, Index k, T alpha, Handle src1, Handle src2,
 
 // Explicit instantiation
 template
-void submit<fp32_t>(Index m, Index n, Index k, fp32_t alpha, Handle src1,
-        Handle src2, fp32_t beta, Handle dst, int redux);
+void submit<fp32_t>(Index m, Index n, Index k, fp32_t alpha, HandleRef src1,
+        HandleRef src2, fp32_t beta, HandleRef dst, int redux);
 
 template
-void submit<fp64_t>(Index m, Index n, Index k, fp64_t alpha, Handle src1,
-        Handle src2, fp64_t beta, Handle dst, int redux);
+void submit<fp64_t>(Index m, Index n, Index k, fp64_t alpha, HandleRef src1,
+        HandleRef src2, fp64_t beta, HandleRef dst, int redux);
 
 } // namespace sumprod_fiber
 } // namespace starpu
@@ -0,0 +1,145 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/swiglu_backward.cc
+ * Backward of SiLU-gated product of StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/swiglu_backward.hh"
+#include "nntile/kernel/swiglu_backward.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for swiglu_backward operation
+namespace swiglu_backward
+{
+
+//! StarPU wrapper for kernel::swiglu_backward::cpu<T>
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    Index nelems = reinterpret_cast<Index *>(cl_args)[0];
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *gate = interfaces[0]->get_ptr<T>();
+    const T *up = interfaces[1]->get_ptr<T>();
+    const T *dst_grad = interfaces[2]->get_ptr<T>();
+    T *gate_grad = interfaces[3]->get_ptr<T>();
+    T *up_grad = interfaces[4]->get_ptr<T>();
+    // Launch kernel
+    kernel::swiglu_backward::cpu<T>(nelems, gate, up, dst_grad, gate_grad,
+            up_grad);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! StarPU wrapper for kernel::swiglu_backward::cuda<T>
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    Index nelems = reinterpret_cast<Index *>(cl_args)[0];
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *gate = interfaces[0]->get_ptr<T>();
+    const T *up = interfaces[1]->get_ptr<T>();
+    const T *dst_grad = interfaces[2]->get_ptr<T>();
+    T *gate_grad = interfaces[3]->get_ptr<T>();
+    T *up_grad = interfaces[4]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::swiglu_backward::cuda<T>(stream, nelems, gate, up, dst_grad,
+            gate_grad, up_grad);
+}
+#endif // NNTILE_USE_CUDA
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_swiglu_backward_fp32",
+            nullptr,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_swiglu_backward_fp64",
+            nullptr,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index nelems, HandleRef gate, HandleRef up, HandleRef dst_grad,
+        HandleRef gate_grad, HandleRef up_grad)
+//! Insert swiglu_backward task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    Index *nelems_ = ArgsPool::allocate<Index>(nelems);
+    fp64_t nflops = 12 * nelems;
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(gate),
+            STARPU_R, static_cast<starpu_data_handle_t>(up),
+            STARPU_R, static_cast<starpu_data_handle_t>(dst_grad),
+            STARPU_RW, static_cast<starpu_data_handle_t>(gate_grad),
+            STARPU_RW, static_cast<starpu_data_handle_t>(up_grad),
+            STARPU_CL_ARGS_NFREE, nelems_, sizeof(*nelems_),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, nelems_,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in swiglu_backward task submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index nelems, HandleRef gate, HandleRef up,
+        HandleRef dst_grad, HandleRef gate_grad, HandleRef up_grad);
+
+template
+void submit<fp64_t>(Index nelems, HandleRef gate, HandleRef up,
+        HandleRef dst_grad, HandleRef gate_grad, HandleRef up_grad);
+
+} // namespace swiglu_backward
+} // namespace starpu
+} // namespace nntile
+
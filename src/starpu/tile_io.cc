@@ -0,0 +1,645 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/tile_io.cc
+ * StarPU wrappers for writing and reading tiles to/from files
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-14
+ * */
+
+#include "nntile/starpu/tile_io.hh"
+#include "nntile/kernel/randn_philox/philox.hh"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for writing and reading tiles to/from files
+namespace tile_io
+{
+
+//! Number of failed reads and writes
+static std::atomic<Index> nerrors{0};
+
+//! Path of a file, that follows the arguments
+static std::string get_path(const args_t *args)
+{
+    return std::string(reinterpret_cast<const char *>(args+1),
+            args->path_size);
+}
+
+//! Write bytes into an existing file at a given offset
+/*! @returns 0 on success or errno of the failed call otherwise
+ * */
+int write_file(const std::string &path, const void *src, Index offset,
+        Index nbytes)
+{
+    int fd = ::open(path.c_str(), O_WRONLY);
+    if(fd < 0)
+    {
+        return errno;
+    }
+    const char *ptr = reinterpret_cast<const char *>(src);
+    Index done = 0;
+    int err = 0;
+    while(done < nbytes)
+    {
+        ssize_t ret = ::pwrite(fd, ptr+done, nbytes-done, offset+done);
+        if(ret <= 0)
+        {
+            err = ret < 0 ? errno : EIO;
+            break;
+        }
+        done += ret;
+    }
+    ::close(fd);
+    return err;
+}
+
+//! Read bytes from a file at a given offset
+/*! @returns 0 on success or errno of the failed call otherwise. Reading
+ * past the end of the file is an error.
+ * */
+int read_file(const std::string &path, void *dst, Index offset,
+        Index nbytes)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        return errno;
+    }
+    char *ptr = reinterpret_cast<char *>(dst);
+    Index done = 0;
+    int err = 0;
+    while(done < nbytes)
+    {
+        ssize_t ret = ::pread(fd, ptr+done, nbytes-done, offset+done);
+        if(ret <= 0)
+        {
+            err = ret < 0 ? errno : EIO;
+            break;
+        }
+        done += ret;
+    }
+    ::close(fd);
+    return err;
+}
+
+//! Write StarPU buffer into a file at a given offset on CPU
+/*! The file shall already exist. Failures are counted and reported by
+ * get_nerrors(), as codelets cannot throw exceptions.
+ * */
+void cpu_write(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const void *src = interfaces[0]->get_ptr<void>();
+    std::string path = get_path(args);
+    int err = write_file(path, src, args->offset, args->nbytes);
+    if(err != 0)
+    {
+        std::cerr << "[nntile] failed to write " << args->nbytes
+            << " bytes at offset " << args->offset << " of " << path
+            << ": " << std::strerror(err) << "\n";
+        ++nerrors;
+    }
+}
+
+//! Read StarPU buffer from a file at a given offset on CPU
+/*! Failures are counted and reported by get_nerrors(), as codelets cannot
+ * throw exceptions.
+ * */
+void cpu_read(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    void *dst = interfaces[0]->get_ptr<void>();
+    std::string path = get_path(args);
+    int err = read_file(path, dst, args->offset, args->nbytes);
+    if(err != 0)
+    {
+        std::cerr << "[nntile] failed to read " << args->nbytes
+            << " bytes at offset " << args->offset << " of " << path
+            << ": " << std::strerror(err) << "\n";
+        ++nerrors;
+    }
+}
+
+//! Copy StarPU buffer into a staging buffer on CPU
+/*! As the codelet has no CUDA implementation, StarPU fetches the source
+ * into RAM right before the copy, so both the device-to-host transfer and
+ * the copy are a part of the task graph.
+ * */
+void cpu_stage(void *buffers[], void *cl_args)
+    noexcept
+{
+    // No arguments
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    std::size_t size = interfaces[0]->elemsize;
+    const void *src = interfaces[0]->get_ptr<void>();
+    void *dst = interfaces[1]->get_ptr<void>();
+    std::memcpy(dst, src, size);
+}
+
+//! Copy StarPU buffer into host memory and mark it as ready on CPU
+/*! The ticket is stored into the flag only after the copy, so a reader on
+ * another thread sees the value as soon as it sees the ticket.
+ * */
+void cpu_readback(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<readback_args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    std::size_t size = interfaces[0]->elemsize;
+    const void *src = interfaces[0]->get_ptr<void>();
+    std::memcpy(args->dst, src, size);
+    args->ready->store(args->ticket, std::memory_order_release);
+}
+
+//! Size of an element of a host array in bytes
+Index src_type_size(src_type_t src_type)
+{
+    switch(src_type)
+    {
+        case src_type_t::fp64:
+            return sizeof(fp64_t);
+        case src_type_t::fp32:
+            return sizeof(fp32_t);
+        case src_type_t::fp16:
+            return sizeof(fp16_t);
+        case src_type_t::bf16:
+            return sizeof(bf16_t);
+    }
+    throw std::runtime_error("Wrong src_type");
+}
+
+//! Copy strided array of type Src into a contiguous Fortran-order tile
+template<typename Src, typename T>
+static void load_strided(Index ndim, const Index *shape, const Index *stride,
+        const Src *src, T *dst)
+{
+    using Y = compute_t<T>;
+    Index nrows = ndim > 0 ? shape[0] : 1;
+    Index ncols = 1;
+    for(Index j = 1; j < ndim; ++j)
+    {
+        ncols *= shape[j];
+    }
+    std::vector<Index> col_index(ndim, 0);
+    for(Index k = 0; k < ncols; ++k)
+    {
+        Index offset = 0;
+        for(Index j = 1; j < ndim; ++j)
+        {
+            offset += col_index[j] * stride[j];
+        }
+        const Src *col = src + offset;
+        T *dst_col = dst + k*nrows;
+        Index row_stride = ndim > 0 ? stride[0] : 0;
+        for(Index i = 0; i < nrows; ++i)
+        {
+            dst_col[i] = T(static_cast<Y>(
+                        static_cast<compute_t<Src>>(col[i*row_stride])));
+        }
+        // Get index of the next column
+        for(Index j = 1; j < ndim; ++j)
+        {
+            ++col_index[j];
+            if(col_index[j] < shape[j])
+            {
+                break;
+            }
+            col_index[j] = 0;
+        }
+    }
+}
+
+//! Convert strided host array into StarPU buffer on CPU
+/*! The host array, e.g. a memory-mapped file, shall stay alive until the
+ * task is finished.
+ * */
+template<typename T>
+void cpu_load(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<load_args_t *>(cl_args);
+    auto shape = reinterpret_cast<const Index *>(args+1);
+    auto stride = shape + args->ndim;
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    T *dst = interfaces[0]->get_ptr<T>();
+    switch(args->src_type)
+    {
+        case src_type_t::fp64:
+            load_strided(args->ndim, shape, stride,
+                    reinterpret_cast<const fp64_t *>(args->src), dst);
+            break;
+        case src_type_t::fp32:
+            load_strided(args->ndim, shape, stride,
+                    reinterpret_cast<const fp32_t *>(args->src), dst);
+            break;
+        case src_type_t::fp16:
+            load_strided(args->ndim, shape, stride,
+                    reinterpret_cast<const fp16_t *>(args->src), dst);
+            break;
+        case src_type_t::bf16:
+            load_strided(args->ndim, shape, stride,
+                    reinterpret_cast<const bf16_t *>(args->src), dst);
+            break;
+    }
+}
+
+//! Size of a token in bytes
+Index token_type_size(token_type_t token_type)
+{
+    switch(token_type)
+    {
+        case token_type_t::uint16:
+            return sizeof(std::uint16_t);
+        case token_type_t::uint32:
+            return sizeof(std::uint32_t);
+        case token_type_t::int64:
+            return sizeof(std::int64_t);
+    }
+    throw std::runtime_error("Wrong token_type");
+}
+
+//! Copy windows of tokens of type Src into a seq_size-by-batch_size tile
+template<typename Src>
+static void load_tokens(const tokens_args_t *args, const Src *tokens,
+        Index *dst)
+{
+    namespace philox = kernel::randn_philox;
+    Index nwindows = args->ntokens - args->seq_len;
+    for(Index j = 0; j < args->batch_size; ++j)
+    {
+        // Start of a window depends only on the seed, the step and the
+        // index of a sequence, so that all tiles of a sequence agree
+        uint32_t ctr[4];
+        philox::philox_words(args->seed, args->batch_start+j, args->step,
+                ctr);
+        uint64_t word = uint64_t{ctr[0]} | uint64_t{ctr[1]}<<32;
+        Index start = word % uint64_t(nwindows);
+        const Src *src = tokens + start + args->seq_start + args->shift;
+        Index *dst_col = dst + j*args->seq_size;
+        for(Index i = 0; i < args->seq_size; ++i)
+        {
+            dst_col[i] = src[i];
+        }
+    }
+}
+
+//! Copy random windows of tokens of a host array into StarPU buffer on CPU
+/*! Every sequence of a batch is a window of seq_len+1 consecutive tokens,
+ * that starts at a random position. Inputs are the first seq_len tokens
+ * of windows (shift=0), while labels are the last seq_len tokens of the same
+ * windows (shift=1). The host array, e.g. a memory-mapped file, shall stay
+ * alive until the task is finished.
+ * */
+void cpu_tokens(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<tokens_args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    Index *dst = interfaces[0]->get_ptr<Index>();
+    switch(args->token_type)
+    {
+        case token_type_t::uint16:
+            load_tokens(args,
+                    reinterpret_cast<const std::uint16_t *>(args->tokens),
+                    dst);
+            break;
+        case token_type_t::uint32:
+            load_tokens(args,
+                    reinterpret_cast<const std::uint32_t *>(args->tokens),
+                    dst);
+            break;
+        case token_type_t::int64:
+            load_tokens(args,
+                    reinterpret_cast<const std::int64_t *>(args->tokens),
+                    dst);
+            break;
+    }
+}
+
+//! Footprint for tile_io tasks that depends only on the number of bytes
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->nbytes, sizeof(args->nbytes),
+            hash);
+    return hash;
+}
+
+Codelet codelet_write, codelet_read, codelet_stage, codelet_readback,
+        codelet_tokens;
+
+Codelet codelet_load_fp32, codelet_load_fp64, codelet_load_bf16,
+        codelet_load_fp16;
+
+void init()
+{
+    // Files are accessed only from CPU
+    codelet_write.init("nntile_tile_io_write",
+            footprint,
+            {cpu_write},
+            {}
+            );
+    codelet_read.init("nntile_tile_io_read",
+            footprint,
+            {cpu_read},
+            {}
+            );
+    codelet_stage.init("nntile_tile_io_stage",
+            nullptr,
+            {cpu_stage},
+            {}
+            );
+    codelet_readback.init("nntile_tile_io_readback",
+            nullptr,
+            {cpu_readback},
+            {}
+            );
+    codelet_tokens.init("nntile_tile_io_tokens",
+            nullptr,
+            {cpu_tokens},
+            {}
+            );
+    codelet_load_fp32.init("nntile_tile_io_load_fp32",
+            nullptr,
+            {cpu_load<fp32_t>},
+            {}
+            );
+    codelet_load_fp64.init("nntile_tile_io_load_fp64",
+            nullptr,
+            {cpu_load<fp64_t>},
+            {}
+            );
+    codelet_load_bf16.init("nntile_tile_io_load_bf16",
+            nullptr,
+            {cpu_load<bf16_t>},
+            {}
+            );
+    codelet_load_fp16.init("nntile_tile_io_load_fp16",
+            nullptr,
+            {cpu_load<fp16_t>},
+            {}
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_write.restrict_where(where);
+    codelet_read.restrict_where(where);
+    codelet_stage.restrict_where(where);
+    codelet_readback.restrict_where(where);
+    codelet_tokens.restrict_where(where);
+    codelet_load_fp32.restrict_where(where);
+    codelet_load_fp64.restrict_where(where);
+    codelet_load_bf16.restrict_where(where);
+    codelet_load_fp16.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_write.restore_where();
+    codelet_read.restore_where();
+    codelet_stage.restore_where();
+    codelet_readback.restore_where();
+    codelet_tokens.restore_where();
+    codelet_load_fp32.restore_where();
+    codelet_load_fp64.restore_where();
+    codelet_load_bf16.restore_where();
+    codelet_load_fp16.restore_where();
+}
+
+//! Pack offset, size and path into a single buffer of arguments
+static args_t *pack_args(const std::string &path, Index offset,
+        Index nbytes, size_t &args_size)
+{
+    args_size = sizeof(args_t) + path.size();
+    args_t *args = (args_t *)std::malloc(args_size);
+    args->offset = offset;
+    args->nbytes = nbytes;
+    args->path_size = path.size();
+    std::memcpy(args+1, path.data(), path.size());
+    return args;
+}
+
+void submit_write(HandleRef src, const std::string &path, Index offset,
+        Index nbytes)
+//! Insert task, that writes a buffer into a file, into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ *
+ * The buffer is only read, so tasks, that read the same data, are not
+ * delayed, while the following updates of the data wait for the write.
+ * */
+{
+    size_t args_size;
+    args_t *args = pack_args(path, offset, nbytes, args_size);
+    // Submit task
+    int ret = task_insert(&codelet_write,
+            STARPU_R, static_cast<starpu_data_handle_t>(src),
+            STARPU_CL_ARGS, args, args_size,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in tile_io write task submission");
+    }
+}
+
+void submit_read(HandleRef dst, const std::string &path, Index offset,
+        Index nbytes)
+//! Insert task, that reads a buffer from a file, into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    size_t args_size;
+    args_t *args = pack_args(path, offset, nbytes, args_size);
+    // Submit task
+    int ret = task_insert(&codelet_read,
+            STARPU_W, static_cast<starpu_data_handle_t>(dst),
+            STARPU_CL_ARGS, args, args_size,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in tile_io read task submission");
+    }
+}
+
+void submit_stage(HandleRef src, HandleRef dst)
+//! Insert task, that copies a buffer into a staging buffer in RAM
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Submit task
+    int ret = task_insert(&codelet_stage,
+            STARPU_R, static_cast<starpu_data_handle_t>(src),
+            STARPU_W, static_cast<starpu_data_handle_t>(dst),
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in tile_io stage task submission");
+    }
+}
+
+void submit_readback(HandleRef src, void *dst, std::atomic<Index> *ready,
+        Index ticket)
+//! Insert task, that copies a buffer into host memory, into StarPU pool
+/*! No argument checking is performed. The task has the lowest priority, so
+ * it does not delay computations, and it only reads the buffer, so the
+ * following tasks, that read the same data, are not delayed either. When
+ * the copy is done, the ticket is stored into the ready flag. If task
+ * submission fails, this routines throws an std::runtime_error() exception.
+ * */
+{
+    readback_args_t *args = (readback_args_t *)std::malloc(sizeof(*args));
+    args->dst = dst;
+    args->ready = ready;
+    args->ticket = ticket;
+    // Submit task
+    int ret = task_insert(&codelet_readback,
+            STARPU_R, static_cast<starpu_data_handle_t>(src),
+            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_PRIORITY, STARPU_MIN_PRIO,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in tile_io readback task submission");
+    }
+}
+
+template<typename T>
+void submit_load(const void *src, src_type_t src_type,
+        const std::vector<Index> &shape, const std::vector<Index> &stride,
+        HandleRef dst)
+//! Insert task, that converts a strided host array into a buffer
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    Index ndim = shape.size();
+    size_t args_size = sizeof(load_args_t) + 2*ndim*sizeof(Index);
+    auto args = (load_args_t *)std::malloc(args_size);
+    args->src = src;
+    args->src_type = src_type;
+    args->ndim = ndim;
+    auto args_shape = reinterpret_cast<Index *>(args+1);
+    std::copy(shape.begin(), shape.end(), args_shape);
+    std::copy(stride.begin(), stride.end(), args_shape+ndim);
+    // Submit task
+    int ret = task_insert(codelet_load<T>(),
+            STARPU_W, static_cast<starpu_data_handle_t>(dst),
+            STARPU_CL_ARGS, args, args_size,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in tile_io load task submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit_load<fp32_t>(const void *src, src_type_t src_type,
+        const std::vector<Index> &shape, const std::vector<Index> &stride,
+        HandleRef dst);
+
+template
+void submit_load<fp64_t>(const void *src, src_type_t src_type,
+        const std::vector<Index> &shape, const std::vector<Index> &stride,
+        HandleRef dst);
+
+template
+void submit_load<bf16_t>(const void *src, src_type_t src_type,
+        const std::vector<Index> &shape, const std::vector<Index> &stride,
+        HandleRef dst);
+
+template
+void submit_load<fp16_t>(const void *src, src_type_t src_type,
+        const std::vector<Index> &shape, const std::vector<Index> &stride,
+        HandleRef dst);
+
+void submit_tokens(const void *tokens, token_type_t token_type,
+        Index ntokens, Index seq_len, Index seq_start, Index seq_size,
+        Index batch_start, Index batch_size, unsigned long long seed,
+        Index step, Index shift, HandleRef dst)
+//! Insert task, that copies random windows of tokens into a buffer
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    auto args = (tokens_args_t *)std::malloc(sizeof(tokens_args_t));
+    args->tokens = tokens;
+    args->token_type = token_type;
+    args->ntokens = ntokens;
+    args->seq_len = seq_len;
+    args->seq_start = seq_start;
+    args->seq_size = seq_size;
+    args->batch_start = batch_start;
+    args->batch_size = batch_size;
+    args->seed = seed;
+    args->step = step;
+    args->shift = shift;
+    // Submit task
+    int ret = task_insert(&codelet_tokens,
+            STARPU_W, static_cast<starpu_data_handle_t>(dst),
+            STARPU_CL_ARGS, args, sizeof(*args),
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in tile_io tokens task submission");
+    }
+}
+
+//! Number of failed reads and writes since the previous call
+Index get_nerrors()
+{
+    return nerrors.exchange(0);
+}
+
+} // namespace tile_io
+} // namespace starpu
+} // namespace nntile
+
@@ -0,0 +1,219 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/topk.cc
+ * StarPU wrappers for the largest values and their indices along an axis
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-11
+ * */
+
+#include "nntile/starpu/topk.hh"
+#include "nntile/kernel/topk.hh"
+#include "nntile/kernel/parallel.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for search of the largest values along an axis
+namespace topk
+{
+
+//! Largest values and their indices along middle axis of StarPU buffer on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src = interfaces[0]->get_ptr<T>();
+    T *values = interfaces[1]->get_ptr<T>();
+    Index *indices = interfaces[2]->get_ptr<Index>();
+    // Use all threads of a parallel worker
+    kernel::parallel::Scope threads(starpu_combined_worker_get_size());
+    // Launch kernel
+    kernel::topk::cpu<T>(args->m, args->n, args->k, args->nk, args->offset,
+            args->size, args->init, src, values, indices);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Largest values and their indices along middle axis of StarPU buffer on
+//! CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src = interfaces[0]->get_ptr<T>();
+    T *values = interfaces[1]->get_ptr<T>();
+    Index *indices = interfaces[2]->get_ptr<Index>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::topk::cuda<T>(stream, args->m, args->n, args->k, args->nk,
+            args->offset, args->size, args->init, src, values, indices);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for topk tasks that depends only on m, n, k and nk
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    // Apply hash over parameters m, n, k and nk
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    hash = starpu_hash_crc32c_be_n(&args->k, sizeof(args->k), hash);
+    hash = starpu_hash_crc32c_be_n(&args->nk, sizeof(args->nk), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64, codelet_bf16, codelet_fp16;
+
+void init()
+{
+    codelet_fp32.init("nntile_topk_fp32",
+            footprint,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_topk_fp64",
+            footprint,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_bf16.init("nntile_topk_bf16",
+            footprint,
+            {cpu<bf16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<bf16_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp16.init("nntile_topk_fp16",
+            footprint,
+            {cpu<fp16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp16_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    // CPU implementations may use all threads of parallel workers
+    codelet_fp32.set_parallel();
+    codelet_fp64.set_parallel();
+    codelet_bf16.set_parallel();
+    codelet_fp16.set_parallel();
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+    codelet_bf16.restrict_where(where);
+    codelet_fp16.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+    codelet_bf16.restore_where();
+    codelet_fp16.restore_where();
+}
+
+template<typename T>
+void submit(Index m, Index n, Index k, Index nk, Index offset, Index size,
+        bool init, HandleRef src, HandleRef values, HandleRef indices)
+//! Insert topk task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ *
+ * A task with init=true overwrites candidates, so that the following tasks
+ * over other tiles of the same slices accumulate into them in any order.
+ * */
+{
+    // Codelet arguments
+    args_t *args = ArgsPool::allocate<args_t>();
+    args->m = m;
+    args->n = n;
+    args->k = k;
+    args->nk = nk;
+    args->offset = offset;
+    args->size = size;
+    args->init = init;
+    fp64_t nflops = m * n * k;
+    // Access mode for the candidates
+    enum starpu_data_access_mode dst_mode;
+    if(init)
+    {
+        dst_mode = STARPU_W;
+    }
+    else
+    {
+        dst_mode = Config::STARPU_RW_COMMUTE;
+    }
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(src),
+            dst_mode, static_cast<starpu_data_handle_t>(values),
+            dst_mode, static_cast<starpu_data_handle_t>(indices),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in topk task submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index m, Index n, Index k, Index nk, Index offset,
+        Index size, bool init, HandleRef src, HandleRef values,
+        HandleRef indices);
+
+template
+void submit<fp64_t>(Index m, Index n, Index k, Index nk, Index offset,
+        Index size, bool init, HandleRef src, HandleRef values,
+        HandleRef indices);
+
+template
+void submit<bf16_t>(Index m, Index n, Index k, Index nk, Index offset,
+        Index size, bool init, HandleRef src, HandleRef values,
+        HandleRef indices);
+
+template
+void submit<fp16_t>(Index m, Index n, Index k, Index nk, Index offset,
+        Index size, bool init, HandleRef src, HandleRef values,
+        HandleRef indices);
+
+} // namespace topk
+} // namespace starpu
+} // namespace nntile
+
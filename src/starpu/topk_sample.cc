@@ -0,0 +1,195 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/topk_sample.cc
+ * StarPU wrappers for sampling of tokens among the largest logits
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-11
+ * */
+
+#include "nntile/starpu/topk_sample.hh"
+#include "nntile/kernel/topk_sample.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for sampling of tokens among the largest logits
+namespace topk_sample
+{
+
+//! Sampling of tokens among candidates of StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *values = interfaces[0]->get_ptr<T>();
+    const Index *indices = interfaces[1]->get_ptr<Index>();
+    Index *ids = interfaces[2]->get_ptr<Index>();
+    // Launch kernel
+    kernel::topk_sample::cpu<T>(args->nk, args->n, args->temperature,
+            args->top_p, args->seed, args->sequence, values, indices, ids);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Sampling of tokens among candidates of StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *values = interfaces[0]->get_ptr<T>();
+    const Index *indices = interfaces[1]->get_ptr<Index>();
+    Index *ids = interfaces[2]->get_ptr<Index>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::topk_sample::cuda<T>(stream, args->nk, args->n,
+            args->temperature, args->top_p, args->seed, args->sequence,
+            values, indices, ids);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for topk_sample tasks that depends only on nk and n
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->nk, sizeof(args->nk), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64, codelet_bf16, codelet_fp16;
+
+void init()
+{
+    codelet_fp32.init("nntile_topk_sample_fp32",
+            footprint,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_topk_sample_fp64",
+            footprint,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_bf16.init("nntile_topk_sample_bf16",
+            footprint,
+            {cpu<bf16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<bf16_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp16.init("nntile_topk_sample_fp16",
+            footprint,
+            {cpu<fp16_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp16_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+    codelet_bf16.restrict_where(where);
+    codelet_fp16.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+    codelet_bf16.restore_where();
+    codelet_fp16.restore_where();
+}
+
+template<typename T>
+void submit(Index nk, Index n, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed, Index sequence, HandleRef values,
+        HandleRef indices, HandleRef ids)
+//! Insert topk_sample task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t *args = ArgsPool::allocate<args_t>();
+    args->nk = nk;
+    args->n = n;
+    args->temperature = temperature;
+    args->top_p = top_p;
+    args->seed = seed;
+    args->sequence = sequence;
+    fp64_t nflops = 3 * nk * n;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(values),
+            STARPU_R, static_cast<starpu_data_handle_t>(indices),
+            STARPU_W, static_cast<starpu_data_handle_t>(ids),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in topk_sample task submission");
+    }
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index nk, Index n, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed, Index sequence, HandleRef values,
+        HandleRef indices, HandleRef ids);
+
+template
+void submit<fp64_t>(Index nk, Index n, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed, Index sequence, HandleRef values,
+        HandleRef indices, HandleRef ids);
+
+template
+void submit<bf16_t>(Index nk, Index n, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed, Index sequence, HandleRef values,
+        HandleRef indices, HandleRef ids);
+
+template
+void submit<fp16_t>(Index nk, Index n, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed, Index sequence, HandleRef values,
+        HandleRef indices, HandleRef ids);
+
+} // namespace topk_sample
+} // namespace starpu
+} // namespace nntile
+
@@ -121,21 +121,24 @@ void restore_where()
 }
 
 template<typename T>
-void submit(T alpha, Index n_labels, Index n_outputs, Handle logsumexp, Handle src,
-        Handle class_labels, Handle val)
+void submit(T alpha, Index n_labels, Index n_outputs, HandleRef logsumexp,
+        HandleRef src, HandleRef class_labels, HandleRef val)
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->alpha = alpha;
     args->n_labels = n_labels;
     args->n_outputs = n_outputs;
+    fp64_t nflops = 2 * n_outputs;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(logsumexp),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_R, static_cast<starpu_data_handle_t>(class_labels),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
             STARPU_RW | STARPU_COMMUTE, static_cast<starpu_data_handle_t>(val),
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -146,12 +149,14 @@ void submit(T alpha, Index n_labels, Index n_outputs, Handle logsumexp, Handle s
 
 // Explicit instantiation
 template
-void submit<fp32_t>(fp32_t alpha, Index n_labels, Index n_outputs, Handle logsumexp,
-        Handle src, Handle class_labels, Handle val);
+void submit<fp32_t>(fp32_t alpha, Index n_labels, Index n_outputs,
+        HandleRef logsumexp, HandleRef src, HandleRef class_labels,
+        HandleRef val);
 
 template
-void submit<fp64_t>(fp64_t alpha, Index n_labels, Index n_outputs, Handle logsumexp,
-        Handle src, Handle class_labels, Handle val);
+void submit<fp64_t>(fp64_t alpha, Index n_labels, Index n_outputs,
+        HandleRef logsumexp, HandleRef src, HandleRef class_labels,
+        HandleRef val);
 
 } // namespace total_sum_accum
 } // namespace starpu
@@ -0,0 +1,262 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/trace.cc
+ * Timeline of StarPU tasks with names of layers and tensors
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/trace.hh"
+#include "nntile/starpu/config.hh"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace trace
+{
+
+//! Task, which is submitted but not yet finished
+struct pending_t
+{
+    starpu_task *task;
+    //! Callback of the task, that is replaced by the callback of tracing
+    void (*callback_func)(void *);
+    void *callback_arg;
+    unsigned callback_arg_free;
+    Event event;
+};
+
+static std::atomic<bool> enabled = false;
+
+//! Mutex for the scope, names of handles and recorded events
+static std::mutex mutex;
+
+static std::string current_scope;
+
+static std::unordered_map<starpu_data_handle_t, std::string> names;
+
+static std::vector<Event> events;
+
+void enable()
+{
+    starpu_profiling_status_set(STARPU_PROFILING_ENABLE);
+    enabled = true;
+}
+
+void disable()
+{
+    enabled = false;
+}
+
+bool is_enabled()
+{
+    return enabled;
+}
+
+void clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    events.clear();
+}
+
+void scope_set(const std::string &scope)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    current_scope = scope;
+}
+
+std::string scope_get()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return current_scope;
+}
+
+void set_name(starpu_data_handle_t handle, const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    names[handle] = name;
+}
+
+void untrack(starpu_data_handle_t handle)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    names.erase(handle);
+}
+
+//! Record timing of a finished task and call its own callback
+static void callback(void *arg)
+{
+    auto pending = static_cast<pending_t *>(arg);
+    auto info = pending->task->profiling_info;
+    // Tasks, submitted before profiling is enabled, have no timing
+    if(info != nullptr)
+    {
+        auto &event = pending->event;
+        event.workerid = info->workerid;
+        event.submit_us = starpu_timing_timespec_to_us(&info->submit_time);
+        event.fetch_us = starpu_timing_timespec_delay_us(
+                &info->acquire_data_start_time,
+                &info->acquire_data_end_time);
+        event.start_us = starpu_timing_timespec_to_us(&info->start_time);
+        event.end_us = starpu_timing_timespec_to_us(&info->end_time);
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push_back(std::move(event));
+    }
+    if(pending->callback_func != nullptr)
+    {
+        pending->callback_func(pending->callback_arg);
+    }
+    if(pending->callback_arg_free != 0)
+    {
+        std::free(pending->callback_arg);
+    }
+    delete pending;
+}
+
+void submit_hook(starpu_task *task)
+{
+    // Tasks without a codelet only manage dependencies
+    if(not enabled or task->cl == nullptr)
+    {
+        return;
+    }
+    auto pending = new pending_t{task, task->callback_func,
+        task->callback_arg, task->callback_arg_free, {}};
+    auto &event = pending->event;
+    event.name = starpu_task_get_name(task);
+    event.priority = task->priority;
+    event.flops = task->flops;
+    unsigned nbuffers = STARPU_TASK_GET_NBUFFERS(task);
+    event.data.reserve(nbuffers);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        event.scope = current_scope;
+        for(unsigned i = 0; i < nbuffers; ++i)
+        {
+            auto handle = STARPU_TASK_GET_HANDLE(task, i);
+            auto it = names.find(handle);
+            std::string name = (it != names.end()) ? it->second : "";
+            if(STARPU_TASK_GET_MODE(task, i) & STARPU_W)
+            {
+                name = "*" + name;
+            }
+            event.data.push_back(name);
+        }
+    }
+    task->callback_func = callback;
+    task->callback_arg = pending;
+    task->callback_arg_free = 0;
+}
+
+std::vector<Event> get_events()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return events;
+}
+
+//! Quoted string with JSON escapes
+static std::string quote(const std::string &str)
+{
+    std::string result = "\"";
+    for(char c: str)
+    {
+        switch(c)
+        {
+            case '"':
+                result += "\\\"";
+                break;
+            case '\\':
+                result += "\\\\";
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20)
+                {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    result += buf;
+                }
+                else
+                {
+                    result += c;
+                }
+        }
+    }
+    return result + "\"";
+}
+
+void export_json(const std::string &path)
+{
+    std::vector<Event> copy = get_events();
+    std::ofstream file(path);
+    if(not file)
+    {
+        throw std::runtime_error("Failed to open trace file " + path);
+    }
+    int rank = starpu_mpi_world_rank();
+    double origin = std::numeric_limits<double>::infinity();
+    for(const auto &event: copy)
+    {
+        origin = std::min(origin, event.start_us);
+    }
+    file.precision(3);
+    file << std::fixed << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+        << ",\"args\":{\"name\":\"MPI rank " << rank << "\"}}";
+    // Tracks of workers are named after workers
+    int nworkers = starpu_worker_get_count();
+    for(int i = 0; i < nworkers; ++i)
+    {
+        char worker_name[64];
+        starpu_worker_get_name(i, worker_name, sizeof(worker_name));
+        file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << rank
+            << ",\"tid\":" << i << ",\"args\":{\"name\":"
+            << quote(worker_name) << "}}";
+    }
+    for(const auto &event: copy)
+    {
+        file << ",\n{\"name\":" << quote(event.name) << ",\"cat\":"
+            << quote(event.scope.empty() ? "task" : event.scope)
+            << ",\"ph\":\"X\",\"pid\":" << rank << ",\"tid\":"
+            << event.workerid << ",\"ts\":" << event.start_us-origin
+            << ",\"dur\":" << event.end_us-event.start_us
+            << ",\"args\":{\"scope\":" << quote(event.scope)
+            << ",\"priority\":" << event.priority << ",\"flops\":"
+            << event.flops << ",\"fetch_us\":" << event.fetch_us
+            << ",\"wait_us\":" << event.start_us-event.submit_us
+            << ",\"data\":[";
+        for(std::size_t i = 0; i < event.data.size(); ++i)
+        {
+            file << (i > 0 ? "," : "") << quote(event.data[i]);
+        }
+        file << "]}}";
+    }
+    file << "\n]}\n";
+    if(not file)
+    {
+        throw std::runtime_error("Failed to write trace file " + path);
+    }
+}
+
+} // namespace trace
+} // namespace starpu
+} // namespace nntile
+
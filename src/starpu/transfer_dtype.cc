@@ -0,0 +1,161 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/transfer_dtype.cc
+ * Lossy precision of transfers of data handles between MPI nodes
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/transfer_dtype.hh"
+#include "nntile/starpu/config.hh"
+#include "nntile/starpu/fp32_to_fp16.hh"
+#include "nntile/starpu/fp16_to_fp32.hh"
+#include "nntile/starpu/fp32_to_bf16.hh"
+#include "nntile/starpu/bf16_to_fp32.hh"
+#include <unordered_map>
+#include <mutex>
+#include <stdexcept>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace transfer_dtype
+{
+
+//! Precisions of handles with compressed transfers
+static std::unordered_map<starpu_data_handle_t, Dtype> dtypes;
+
+//! Guard for dtypes
+static std::mutex mutex;
+
+void set(starpu_data_handle_t handle, Dtype dtype)
+{
+    if(starpu_data_get_interface_id(handle) != STARPU_VARIABLE_INTERFACE_ID
+            or starpu_variable_get_elemsize(handle) % sizeof(fp32_t) != 0)
+    {
+        throw std::runtime_error("Transfer precision is supported only for "
+                "variables of fp32_t values");
+    }
+#ifndef NNTILE_USE_CUDA
+    if(dtype == Dtype::FP16)
+    {
+        throw std::runtime_error("Conversion into fp16_t requires CUDA");
+    }
+#endif // NNTILE_USE_CUDA
+    std::lock_guard<std::mutex> lock(mutex);
+    if(dtype == Dtype::FP32)
+    {
+        dtypes.erase(handle);
+    }
+    else
+    {
+        dtypes[handle] = dtype;
+    }
+}
+
+Dtype get(starpu_data_handle_t handle)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = dtypes.find(handle);
+    return it == dtypes.end() ? Dtype::FP32 : it->second;
+}
+
+void untrack(starpu_data_handle_t handle)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    dtypes.erase(handle);
+}
+
+#ifdef NNTILE_USE_MPI
+//! Get MPI tag for a temporary compressed buffer
+/*! Temporaries cycle through a range in the upper half of tags, that
+ * follows the range of partial results of tensor::TreeReduction. All nodes
+ * transfer the same handles in the same order, so they get the same tags
+ * for the same temporaries.
+ * */
+static starpu_mpi_tag_t transfer_tag()
+{
+    constexpr starpu_mpi_tag_t ntags = starpu_mpi_tag_t(1) << 32;
+    constexpr starpu_mpi_tag_t first = (starpu_mpi_tag_t(1) << 62) + ntags;
+    static starpu_mpi_tag_t next = 0;
+    starpu_mpi_tag_t tag = first + next;
+    next = (next+1) % ntags;
+    return tag;
+}
+#endif // NNTILE_USE_MPI
+
+bool transfer(starpu_data_handle_t handle, int dst_rank, int mpi_rank)
+{
+    Dtype dtype = get(handle);
+    if(dtype == Dtype::FP32)
+    {
+        return false;
+    }
+#ifdef NNTILE_USE_MPI
+    int src_rank = starpu_mpi_data_get_rank(handle);
+    if(src_rank == dst_rank)
+    {
+        return true;
+    }
+    // Tag is taken on all nodes to keep them in sync
+    starpu_mpi_tag_t tag = transfer_tag();
+    if(mpi_rank != src_rank and mpi_rank != dst_rank)
+    {
+        return true;
+    }
+    Index nelems = starpu_variable_get_elemsize(handle) / sizeof(fp32_t);
+    // Temporary data is allocated by StarPU only where it is used
+    VariableHandle tmp(nelems*sizeof(fp16_t), STARPU_SCRATCH);
+    auto tmp_handle = static_cast<starpu_data_handle_t>(tmp);
+    starpu_mpi_data_register(tmp_handle, tag, src_rank);
+    int ret;
+    if(mpi_rank == src_rank)
+    {
+        if(dtype == Dtype::FP16)
+        {
+            fp32_to_fp16::submit(nelems, HandleRef(handle), tmp);
+        }
+        else
+        {
+            fp32_to_bf16::submit(nelems, HandleRef(handle), tmp);
+        }
+        ret = starpu_mpi_isend_detached(tmp_handle, dst_rank, tag,
+                MPI_COMM_WORLD, nullptr, nullptr);
+        if(ret != 0)
+        {
+            throw std::runtime_error("Error in starpu_mpi_isend_detached");
+        }
+    }
+    else
+    {
+        ret = starpu_mpi_irecv_detached(tmp_handle, src_rank, tag,
+                MPI_COMM_WORLD, nullptr, nullptr);
+        if(ret != 0)
+        {
+            throw std::runtime_error("Error in starpu_mpi_irecv_detached");
+        }
+        // Local copy of the handle is overwritten by the received values
+        if(dtype == Dtype::FP16)
+        {
+            fp16_to_fp32::submit(nelems, tmp, HandleRef(handle));
+        }
+        else
+        {
+            bf16_to_fp32::submit(nelems, tmp, HandleRef(handle));
+        }
+    }
+#endif // NNTILE_USE_MPI
+    return true;
+}
+
+} // namespace transfer_dtype
+} // namespace starpu
+} // namespace nntile
+
@@ -39,6 +39,20 @@ void cpu(void *buffers[], void *cl_args)
     kernel::transpose::cpu<T>(args->m, args->n, args->alpha, src, dst);
 }
 
+//! Apply inplace transpose for a square StarPU buffer on CPU
+template<typename T>
+void cpu_inplace(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    T *data = interfaces[0]->get_ptr<T>();
+    // Launch kernel
+    kernel::transpose::cpu_inplace<T>(args->n, args->alpha, data);
+}
+
 #ifdef NNTILE_USE_CUDA
 //! Apply transpose for StarPU buffers on CUDA
 template<typename T>
@@ -57,6 +71,22 @@ void cuda(void *buffers[], void *cl_args)
     kernel::transpose::cuda<T>(stream, args->m, args->n, args->alpha, src,
             dst);
 }
+
+//! Apply inplace transpose for a square StarPU buffer on CUDA
+template<typename T>
+void cuda_inplace(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    T *data = interfaces[0]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::transpose::cuda_inplace<T>(stream, args->n, args->alpha, data);
+}
 #endif // NNTILE_USE_CUDA
 
 //! Footprint for transpose tasks
@@ -72,7 +102,8 @@ uint32_t footprint(struct starpu_task *task)
     return hash;
 }
 
-Codelet codelet_fp32, codelet_fp64;
+Codelet codelet_fp32, codelet_fp64, codelet_inplace_fp32,
+        codelet_inplace_fp64;
 
 void init()
 {
@@ -92,6 +123,24 @@ void init()
             {cuda<fp64_t>}
 #else // NNTILE_USE_CUDA
             {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_inplace_fp32.init("nntile_transpose_inplace_fp32",
+            footprint<fp32_t>,
+            {cpu_inplace<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda_inplace<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_inplace_fp64.init("nntile_transpose_inplace_fp64",
+            footprint<fp64_t>,
+            {cpu_inplace<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda_inplace<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
 #endif // NNTILE_USE_CUDA
             );
 }
@@ -100,16 +149,20 @@ void restrict_where(uint32_t where)
 {
     codelet_fp32.restrict_where(where);
     codelet_fp64.restrict_where(where);
+    codelet_inplace_fp32.restrict_where(where);
+    codelet_inplace_fp64.restrict_where(where);
 }
 
 void restore_where()
 {
     codelet_fp32.restore_where();
     codelet_fp64.restore_where();
+    codelet_inplace_fp32.restore_where();
+    codelet_inplace_fp64.restore_where();
 }
 
 template<typename T>
-void submit(Index m, Index n, T alpha, Handle src, Handle dst)
+void submit(Index m, Index n, T alpha, HandleRef src, HandleRef dst)
 //! Insert transpose task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
@@ -117,16 +170,18 @@ void submit(Index m, Index n, T alpha, Handle src, Handle dst)
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
     args->m = m;
     args->n = n;
     args->alpha = alpha;
+    fp64_t nflops = m * n;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_W, static_cast<starpu_data_handle_t>(dst),
-            STARPU_CL_ARGS, args, sizeof(*args),
-            // STARPU_FLOPS, nflops);
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
             0);
     // Check submission
     if(ret != 0)
@@ -135,12 +190,49 @@ void submit(Index m, Index n, T alpha, Handle src, Handle dst)
     }
 }
 
+template<typename T>
+void submit_inplace(Index n, T alpha, HandleRef data)
+//! Insert inplace transpose task of a square buffer into StarPU pool
+/*! It avoids a separate output buffer, when a square tile is transposed
+ * into itself. Throws an std::runtime_error() exception if task submission
+ * fails.
+ * */
+{
+    // Codelet arguments
+    args_t<T> *args = ArgsPool::allocate<args_t<T>>();
+    args->m = n;
+    args->n = n;
+    args->alpha = alpha;
+    fp64_t nflops = n * n;
+    // Submit task
+    int ret = task_insert(codelet_inplace<T>(),
+            STARPU_RW, static_cast<starpu_data_handle_t>(data),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, ArgsPool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    if(ret != 0)
+    {
+        throw std::runtime_error("Error in transpose_inplace task "
+                "submission");
+    }
+}
+
 // Explicit instantiation
 template
-void submit<fp32_t>(Index m, Index n, fp32_t alpha, Handle src, Handle dst);
+void submit<fp32_t>(Index m, Index n, fp32_t alpha, HandleRef src,
+        HandleRef dst);
+
+template
+void submit<fp64_t>(Index m, Index n, fp64_t alpha, HandleRef src,
+        HandleRef dst);
+
+template
+void submit_inplace<fp32_t>(Index n, fp32_t alpha, HandleRef data);
 
 template
-void submit<fp64_t>(Index m, Index n, fp64_t alpha, Handle src, Handle dst);
+void submit_inplace<fp64_t>(Index n, fp64_t alpha, HandleRef data);
 
 } // namespace transpose
 } // namespace starpu
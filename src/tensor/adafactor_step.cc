@@ -0,0 +1,181 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/adafactor_step.cc
+ * Fused Adafactor step for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/adafactor_step.hh"
+#include "nntile/starpu/adafactor_step.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void adafactor_step_async(Index num_iter, T beta_2, T eps, T lr,
+        T weight_decay, const Tensor<T> &row, const Tensor<T> &col,
+        const Tensor<T> &mean, const Tensor<T> &grad, const Tensor<T> &p)
+//! Asynchronous tensor-wise fused Adafactor step
+/*! Second moments of parameters with at least 2 dimensions are factored
+ * over the first and the last dimensions (see kernel::adafactor_step).
+ * Moving averages of their factors are updated beforehand, e.g., by
+ * sumprod_fiber of gradients along the first and the last axes, and their
+ * common mean by sum_slice of row. Second moments of other parameters are
+ * not factored, then row has the same shape as p, while col and mean are
+ * not used.
+ *
+ * @param[in] num_iter: Current iteration number, starting from 1
+ * @param[in] beta_2: Parameter for moving average of second moments
+ * @param[in] eps: Small scalar to avoid division by zero
+ * @param[in] lr: Learning rate
+ * @param[in] weight_decay: Coefficient of decoupled weight decay
+ * @param[in] row: Moving average of means of squared gradients over all
+ *      dimensions but the first one
+ * @param[in] col: Moving average of means of squared gradients over all
+ *      dimensions but the last one
+ * @param[in] mean: Mean of row, a scalar
+ * @param[in] grad: Gradient of parameters
+ * @param[inout] p: Parameters
+ * */
+{
+    // Check shapes
+    if(p.shape != grad.shape or p.basetile_shape != grad.basetile_shape)
+    {
+        throw std::runtime_error("Parameter shape is not equal to gradient "
+                "shape");
+    }
+    if(num_iter < 1)
+    {
+        throw std::runtime_error("num_iter < 1");
+    }
+    bool factored = p.ndim >= 2;
+    Index last = p.ndim - 1;
+    if(factored)
+    {
+        if(row.ndim != 1)
+        {
+            throw std::runtime_error("row.ndim != 1");
+        }
+        if(row.shape[0] != p.shape[0]
+                or row.basetile_shape[0] != p.basetile_shape[0])
+        {
+            throw std::runtime_error("row.shape[0] != p.shape[0] or "
+                    "row.basetile_shape[0] != p.basetile_shape[0]");
+        }
+        if(col.ndim != 1)
+        {
+            throw std::runtime_error("col.ndim != 1");
+        }
+        if(col.shape[0] != p.shape[last]
+                or col.basetile_shape[0] != p.basetile_shape[last])
+        {
+            throw std::runtime_error("col.shape[0] != p.shape[last] or "
+                    "col.basetile_shape[0] != p.basetile_shape[last]");
+        }
+        if(mean.ndim != 0)
+        {
+            throw std::runtime_error("mean.ndim != 0");
+        }
+    }
+    else if(row.shape != p.shape or row.basetile_shape != p.basetile_shape)
+    {
+        throw std::runtime_error("Parameter shape is not equal to row "
+                "shape");
+    }
+    // Actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    std::vector<Index> tile_index;
+    for(Index i = 0; i < p.grid.nelems; ++i)
+    {
+        // Get handles of corresponding tiles
+        const auto &p_tile_handle = p.get_tile_handle(i);
+        const auto &grad_tile_handle = grad.get_tile_handle(i);
+        p.grid.linear_to_index(i, tile_index);
+        const auto &traits = p.get_tile_traits(i);
+        starpu::HandleRef row_tile_handle, col_tile_handle, mean_tile_handle;
+        Index m = traits.nelems, k = 1, n = 1;
+        if(factored)
+        {
+            row_tile_handle = row.get_tile_handle(tile_index[0]);
+            col_tile_handle = col.get_tile_handle(tile_index[last]);
+            mean_tile_handle = mean.get_tile_handle(0);
+            m = traits.shape[0];
+            n = traits.shape[last];
+            k = traits.nelems / (m*n);
+        }
+        else
+        {
+            row_tile_handle = row.get_tile_handle(i);
+        }
+        // MPI rank of the destination tile
+        int p_tile_rank = p_tile_handle.mpi_get_rank();
+        // Transfer data
+        row_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        if(factored)
+        {
+            col_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+            mean_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        }
+        grad_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        // Execute only on destination node
+        if(mpi_rank == p_tile_rank)
+        {
+            starpu::adafactor_step::submit<T>(num_iter, m, k, n, beta_2, eps,
+                    lr, weight_decay, row_tile_handle, col_tile_handle,
+                    mean_tile_handle, grad_tile_handle, p_tile_handle);
+        }
+        // Flush cache for the output tile on every node
+        p_tile_handle.mpi_flush();
+    }
+}
+
+template<typename T>
+void adafactor_step(Index num_iter, T beta_2, T eps, T lr, T weight_decay,
+        const Tensor<T> &row, const Tensor<T> &col, const Tensor<T> &mean,
+        const Tensor<T> &grad, const Tensor<T> &p)
+//! Blocking version of tensor-wise fused Adafactor step
+{
+    adafactor_step_async<T>(num_iter, beta_2, eps, lr, weight_decay, row,
+            col, mean, grad, p);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void adafactor_step_async<fp32_t>(Index num_iter, fp32_t beta_2, fp32_t eps,
+        fp32_t lr, fp32_t weight_decay, const Tensor<fp32_t> &row,
+        const Tensor<fp32_t> &col, const Tensor<fp32_t> &mean,
+        const Tensor<fp32_t> &grad, const Tensor<fp32_t> &p);
+
+template
+void adafactor_step_async<fp64_t>(Index num_iter, fp64_t beta_2, fp64_t eps,
+        fp64_t lr, fp64_t weight_decay, const Tensor<fp64_t> &row,
+        const Tensor<fp64_t> &col, const Tensor<fp64_t> &mean,
+        const Tensor<fp64_t> &grad, const Tensor<fp64_t> &p);
+
+// Explicit instantiation
+template
+void adafactor_step<fp32_t>(Index num_iter, fp32_t beta_2, fp32_t eps,
+        fp32_t lr, fp32_t weight_decay, const Tensor<fp32_t> &row,
+        const Tensor<fp32_t> &col, const Tensor<fp32_t> &mean,
+        const Tensor<fp32_t> &grad, const Tensor<fp32_t> &p);
+
+template
+void adafactor_step<fp64_t>(Index num_iter, fp64_t beta_2, fp64_t eps,
+        fp64_t lr, fp64_t weight_decay, const Tensor<fp64_t> &row,
+        const Tensor<fp64_t> &col, const Tensor<fp64_t> &mean,
+        const Tensor<fp64_t> &grad, const Tensor<fp64_t> &p);
+
+} // namespace tensor
+} // namespace nntile
+
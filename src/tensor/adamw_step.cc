@@ -48,10 +48,11 @@ void adamw_step_async(Index num_iter, T beta_1, T beta_2, T eps, T lr, T weight_
     for(Index i = 0; i < p.grid.nelems; ++i)
     {
         // Get handle for corresponding tiles of src and dst
-        auto p_tile_handle = p.get_tile_handle(i);
-        auto grad_tile_handle = grad.get_tile_handle(i);
-        auto first_moment_tile_handle = first_moment.get_tile_handle(i);
-        auto second_moment_tile_handle = second_moment.get_tile_handle(i);
+        const auto &p_tile_handle = p.get_tile_handle(i);
+        const auto &grad_tile_handle = grad.get_tile_handle(i);
+        const auto &first_moment_tile_handle = first_moment.get_tile_handle(i);
+        const auto &second_moment_tile_handle =
+                second_moment.get_tile_handle(i);
         // MPI rank of the destination tile
         int p_tile_rank = p_tile_handle.mpi_get_rank();
         int grad_tile_rank = grad_tile_handle.mpi_get_rank();
@@ -64,7 +65,7 @@ void adamw_step_async(Index num_iter, T beta_1, T beta_2, T eps, T lr, T weight_
         // Execute only on destination node
         if(mpi_rank == p_tile_rank)
         {
-            auto traits = p.get_tile_traits(i);
+            const auto &traits = p.get_tile_traits(i);
             starpu::adamw_step::submit<T>(num_iter, traits.nelems, beta_1, beta_2, eps, lr, weight_decay,
                                          grad_tile_handle, first_moment_tile_handle,
                                          second_moment_tile_handle, p_tile_handle);
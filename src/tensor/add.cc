@@ -53,8 +53,8 @@ void add_async(T alpha, const Tensor<T> &src, T beta, const Tensor<T> &dst)
     for(Index i = 0; i < src.grid.nelems; ++i)
     {
         // Get handle for corresponding tiles of src and dst
-        auto src_tile_handle = src.get_tile_handle(i);
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         // MPI rank of the destination tile
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Transfer data
@@ -62,7 +62,7 @@ void add_async(T alpha, const Tensor<T> &src, T beta, const Tensor<T> &dst)
         // Execute only on destination node
         if(mpi_rank == dst_tile_rank)
         {
-            auto traits = src.get_tile_traits(i);
+            const auto &traits = src.get_tile_traits(i);
             starpu::add::submit<T>(traits.nelems, alpha, src_tile_handle, beta,
                     dst_tile_handle);
         }
@@ -89,6 +89,14 @@ template
 void add_async<fp64_t>(fp64_t alpha, const Tensor<fp64_t> &src, fp64_t beta,
         const Tensor<fp64_t> &dst);
 
+template
+void add_async<bf16_t>(bf16_t alpha, const Tensor<bf16_t> &src, bf16_t beta,
+        const Tensor<bf16_t> &dst);
+
+template
+void add_async<fp16_t>(fp16_t alpha, const Tensor<fp16_t> &src, fp16_t beta,
+        const Tensor<fp16_t> &dst);
+
 // Explicit instantiation of template
 template
 void add<fp32_t>(fp32_t alpha, const Tensor<fp32_t> &src, fp32_t beta,
@@ -98,5 +106,13 @@ template
 void add<fp64_t>(fp64_t alpha, const Tensor<fp64_t> &src, fp64_t beta,
         const Tensor<fp64_t> &dst);
 
+template
+void add<bf16_t>(bf16_t alpha, const Tensor<bf16_t> &src, bf16_t beta,
+        const Tensor<bf16_t> &dst);
+
+template
+void add<fp16_t>(fp16_t alpha, const Tensor<fp16_t> &src, fp16_t beta,
+        const Tensor<fp16_t> &dst);
+
 } // namespace tensor
 } // namespace nntile
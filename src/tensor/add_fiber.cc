@@ -79,11 +79,12 @@ void add_fiber_async(T alpha, const Tensor<T> &src, T beta,
     // Apply per-tile add_fiber asynchronously as needed
     int mpi_rank = starpu_mpi_world_rank();
     int ret;
+    std::vector<Index> dst_tile_index;
     for(Index i = 0; i < dst.grid.nelems; ++i)
     {
-        auto dst_tile_index = dst.grid.linear_to_index(i);
-        auto dst_tile_traits = dst.get_tile_traits(i);
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        dst.grid.linear_to_index(i, dst_tile_index);
+        const auto &dst_tile_traits = dst.get_tile_traits(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Get corresponding src tile
         std::vector<Index> src_tile_index(src.ndim);
@@ -92,8 +93,8 @@ void add_fiber_async(T alpha, const Tensor<T> &src, T beta,
         {
             src_tile_index[j+1] = dst_tile_index[dst.ndim-batch_ndim+j];
         }
-        auto src_tile_handle = src.get_tile_handle(src_tile_index);
-        auto src_tile_traits = src.get_tile_traits(src_tile_index);
+        const auto &src_tile_handle = src.get_tile_handle(src_tile_index);
+        const auto &src_tile_traits = src.get_tile_traits(src_tile_index);
         int src_tile_rank = src_tile_handle.mpi_get_rank();
         // Transfer data
         src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
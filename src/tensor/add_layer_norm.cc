@@ -0,0 +1,289 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/add_layer_norm.cc
+ * Fused residual addition and layer normalization of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/add_layer_norm.hh"
+#include "nntile/starpu/add_layer_norm.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Fused residual addition and layer normalization along a given axis
+/*! Computes sum = src1 + src2, that is used by the next residual connection,
+ * and normalizes it the same way as layer_norm_async() by a single task per
+ * tile, so the inputs are read only once. The axis shall not be split into
+ * tiles. Tiles of sum, mean and inv_stddev shall be owned by the same node as
+ * corresponding tiles of dst.
+ *
+ * @param[in] eps: Regularization parameter for variance
+ * @param[in] src1: First input tensor
+ * @param[in] src2: Second input tensor
+ * @param[in] gamma: Scaling factors of size src1.shape[axis]
+ * @param[in] beta: Shifts of size src1.shape[axis]
+ * @param[out] sum: Sum of inputs
+ * @param[out] mean: Means of fibers of sum along the axis
+ * @param[out] inv_stddev: Inverses of standard deviations of fibers of sum
+ * @param[out] dst: Normalized, scaled and shifted sum
+ * @param[in] axis: Axis of normalization
+ * */
+template<typename T>
+void add_layer_norm_async(T eps, const Tensor<T> &src1, const Tensor<T> &src2,
+        const Tensor<T> &gamma, const Tensor<T> &beta, const Tensor<T> &sum,
+        const Tensor<T> &mean, const Tensor<T> &inv_stddev,
+        const Tensor<T> &dst, Index axis)
+{
+    // Check dimensions
+    if(src1.ndim != src2.ndim)
+    {
+        throw std::runtime_error("src1.ndim != src2.ndim");
+    }
+    if(src1.ndim != sum.ndim)
+    {
+        throw std::runtime_error("src1.ndim != sum.ndim");
+    }
+    if(src1.ndim != dst.ndim)
+    {
+        throw std::runtime_error("src1.ndim != dst.ndim");
+    }
+    if(src1.ndim-1 != mean.ndim)
+    {
+        throw std::runtime_error("src1.ndim-1 != mean.ndim");
+    }
+    if(src1.ndim-1 != inv_stddev.ndim)
+    {
+        throw std::runtime_error("src1.ndim-1 != inv_stddev.ndim");
+    }
+    if(gamma.ndim != 1)
+    {
+        throw std::runtime_error("gamma.ndim != 1");
+    }
+    if(beta.ndim != 1)
+    {
+        throw std::runtime_error("beta.ndim != 1");
+    }
+    // Treat special case of src1.ndim=0
+    if(src1.ndim == 0)
+    {
+        throw std::runtime_error("Scalar input makes no sense");
+    }
+    Index ndim = src1.ndim;
+    // Check axis
+    if(axis < 0)
+    {
+        throw std::runtime_error("axis < 0");
+    }
+    if(axis >= ndim)
+    {
+        throw std::runtime_error("axis >= src1.ndim");
+    }
+    // Check shapes
+    if(src1.shape != src2.shape)
+    {
+        throw std::runtime_error("src1.shape != src2.shape");
+    }
+    if(src1.basetile_shape != src2.basetile_shape)
+    {
+        throw std::runtime_error("src1.basetile_shape != "
+                "src2.basetile_shape");
+    }
+    if(src1.shape != sum.shape)
+    {
+        throw std::runtime_error("src1.shape != sum.shape");
+    }
+    if(src1.basetile_shape != sum.basetile_shape)
+    {
+        throw std::runtime_error("src1.basetile_shape != sum.basetile_shape");
+    }
+    if(src1.shape != dst.shape)
+    {
+        throw std::runtime_error("src1.shape != dst.shape");
+    }
+    if(src1.basetile_shape != dst.basetile_shape)
+    {
+        throw std::runtime_error("src1.basetile_shape != dst.basetile_shape");
+    }
+    if(mean.shape != inv_stddev.shape)
+    {
+        throw std::runtime_error("mean.shape != inv_stddev.shape");
+    }
+    if(mean.basetile_shape != inv_stddev.basetile_shape)
+    {
+        throw std::runtime_error("mean.basetile_shape != "
+                "inv_stddev.basetile_shape");
+    }
+    for(Index i = 0; i < axis; i++)
+    {
+        if(src1.shape[i] != mean.shape[i])
+        {
+            throw std::runtime_error("src1.shape[i] != mean.shape[i]");
+        }
+        if(src1.basetile_shape[i] != mean.basetile_shape[i])
+        {
+            throw std::runtime_error("src1.basetile_shape[i] != "
+                    "mean.basetile_shape[i]");
+        }
+    }
+    for(Index i = axis+1; i < ndim; i++)
+    {
+        if(src1.shape[i] != mean.shape[i-1])
+        {
+            throw std::runtime_error("src1.shape[i] != mean.shape[i-1]");
+        }
+        if(src1.basetile_shape[i] != mean.basetile_shape[i-1])
+        {
+            throw std::runtime_error("src1.basetile_shape[i] != "
+                    "mean.basetile_shape[i-1]");
+        }
+    }
+    if(src1.basetile_shape[axis] != src1.shape[axis])
+    {
+        throw std::runtime_error("src1.basetile_shape[axis] != "
+                "src1.shape[axis]");
+    }
+    if(src1.shape[axis] != gamma.shape[0])
+    {
+        throw std::runtime_error("src1.shape[axis] != gamma.shape[0]");
+    }
+    if(gamma.basetile_shape[0] != gamma.shape[0])
+    {
+        throw std::runtime_error("gamma.basetile_shape[0] != "
+                "gamma.shape[0]");
+    }
+    if(src1.shape[axis] != beta.shape[0])
+    {
+        throw std::runtime_error("src1.shape[axis] != beta.shape[0]");
+    }
+    if(beta.basetile_shape[0] != beta.shape[0])
+    {
+        throw std::runtime_error("beta.basetile_shape[0] != beta.shape[0]");
+    }
+    // Do actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    const auto &gamma_tile_handle = gamma.get_tile_handle(0);
+    const auto &beta_tile_handle = beta.get_tile_handle(0);
+    std::vector<Index> mean_tile_index;
+    for(Index i = 0; i < mean.grid.nelems; ++i)
+    {
+        const auto &mean_tile_handle = mean.get_tile_handle(i);
+        const auto &inv_stddev_tile_handle = inv_stddev.get_tile_handle(i);
+        // Obtain index of the only corresponding source tile
+        mean.grid.linear_to_index(i, mean_tile_index);
+        std::vector<Index> src_tile_index(ndim);
+        for(Index j = 0, k = 0; j < ndim; ++j)
+        {
+            if(j == axis)
+            {
+                src_tile_index[axis] = 0;
+                continue;
+            }
+            src_tile_index[j] = mean_tile_index[k];
+            ++k;
+        }
+        Index src_tile_offset = src1.grid.index_to_linear(src_tile_index);
+        const auto &src1_tile_handle = src1.get_tile_handle(src_tile_offset);
+        const auto &src2_tile_handle = src2.get_tile_handle(src_tile_offset);
+        const auto &sum_tile_handle = sum.get_tile_handle(src_tile_offset);
+        const auto &dst_tile_handle = dst.get_tile_handle(src_tile_offset);
+        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+        // All the outputs are computed by a single task
+        if(sum_tile_handle.mpi_get_rank() != dst_tile_rank)
+        {
+            throw std::runtime_error("Tiles of sum and dst are owned by "
+                    "different nodes");
+        }
+        if(mean_tile_handle.mpi_get_rank() != dst_tile_rank)
+        {
+            throw std::runtime_error("Tiles of mean and dst are owned by "
+                    "different nodes");
+        }
+        if(inv_stddev_tile_handle.mpi_get_rank() != dst_tile_rank)
+        {
+            throw std::runtime_error("Tiles of inv_stddev and dst are owned "
+                    "by different nodes");
+        }
+        // Transfer data
+        src1_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        src2_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        gamma_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        beta_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == dst_tile_rank)
+        {
+            // Get sizes
+            const auto &src_tile_traits =
+                src1.get_tile_traits(src_tile_offset);
+            Index m, n, k;
+            m = src_tile_traits.stride[axis];
+            n = src_tile_traits.matrix_shape[axis+1][1];
+            k = src_tile_traits.shape[axis];
+            // Insert task
+            starpu::add_layer_norm::submit<T>(m, n, k, eps,
+                    src1_tile_handle, src2_tile_handle, gamma_tile_handle,
+                    beta_tile_handle, sum_tile_handle, mean_tile_handle,
+                    inv_stddev_tile_handle, dst_tile_handle);
+        }
+        // Flush cache for the output tiles on every node
+        sum_tile_handle.mpi_flush();
+        mean_tile_handle.mpi_flush();
+        inv_stddev_tile_handle.mpi_flush();
+        dst_tile_handle.mpi_flush();
+    }
+}
+
+template<typename T>
+void add_layer_norm(T eps, const Tensor<T> &src1, const Tensor<T> &src2,
+        const Tensor<T> &gamma, const Tensor<T> &beta, const Tensor<T> &sum,
+        const Tensor<T> &mean, const Tensor<T> &inv_stddev,
+        const Tensor<T> &dst, Index axis)
+{
+    add_layer_norm_async<T>(eps, src1, src2, gamma, beta, sum, mean,
+            inv_stddev, dst, axis);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void add_layer_norm_async<fp32_t>(fp32_t eps, const Tensor<fp32_t> &src1,
+        const Tensor<fp32_t> &src2, const Tensor<fp32_t> &gamma,
+        const Tensor<fp32_t> &beta, const Tensor<fp32_t> &sum,
+        const Tensor<fp32_t> &mean, const Tensor<fp32_t> &inv_stddev,
+        const Tensor<fp32_t> &dst, Index axis);
+
+template
+void add_layer_norm_async<fp64_t>(fp64_t eps, const Tensor<fp64_t> &src1,
+        const Tensor<fp64_t> &src2, const Tensor<fp64_t> &gamma,
+        const Tensor<fp64_t> &beta, const Tensor<fp64_t> &sum,
+        const Tensor<fp64_t> &mean, const Tensor<fp64_t> &inv_stddev,
+        const Tensor<fp64_t> &dst, Index axis);
+
+// Explicit instantiation
+template
+void add_layer_norm<fp32_t>(fp32_t eps, const Tensor<fp32_t> &src1,
+        const Tensor<fp32_t> &src2, const Tensor<fp32_t> &gamma,
+        const Tensor<fp32_t> &beta, const Tensor<fp32_t> &sum,
+        const Tensor<fp32_t> &mean, const Tensor<fp32_t> &inv_stddev,
+        const Tensor<fp32_t> &dst, Index axis);
+
+template
+void add_layer_norm<fp64_t>(fp64_t eps, const Tensor<fp64_t> &src1,
+        const Tensor<fp64_t> &src2, const Tensor<fp64_t> &gamma,
+        const Tensor<fp64_t> &beta, const Tensor<fp64_t> &sum,
+        const Tensor<fp64_t> &mean, const Tensor<fp64_t> &inv_stddev,
+        const Tensor<fp64_t> &dst, Index axis);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,341 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/add_layer_norm_backward.cc
+ * Backward of fused residual addition and layer normalization of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/add_layer_norm_backward.hh"
+#include "nntile/tensor/tree_reduction.hh"
+#include "nntile/starpu/add_layer_norm_backward.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Backward of fused residual addition and layer normalization
+/*! Total gradient of the sum, that is the gradient sum_grad of the residual
+ * connection plus the gradient through the normalization, is accumulated
+ * into src1_grad and src2_grad by a single task per tile. Gradients of gamma
+ * and beta are accumulated as well. The axis shall not be split into tiles.
+ * Every task updates gradients of gamma and beta, so their tiles shall be
+ * owned by the same node as all the tiles of src1_grad and src2_grad.
+ *
+ * @param[in] sum: Sum of inputs, computed by the forward pass
+ * @param[in] dst_grad: Gradient of output of the forward pass
+ * @param[in] gamma: Scaling factors of size sum.shape[axis]
+ * @param[in] mean: Means, computed by the forward pass
+ * @param[in] inv_stddev: Inverses of standard deviations, computed by the
+ *      forward pass
+ * @param[in] sum_grad: Gradient of the sum through the residual connection
+ * @param[inout] src1_grad: Gradient of the first input
+ * @param[inout] src2_grad: Gradient of the second input
+ * @param[inout] gamma_grad: Gradient of gamma
+ * @param[inout] beta_grad: Gradient of beta
+ * @param[in] axis: Axis of normalization
+ * @param[in] redux: Whether to use STARPU_REDUX for gamma_grad and beta_grad
+ * */
+template<typename T>
+void add_layer_norm_backward_async(const Tensor<T> &sum,
+        const Tensor<T> &dst_grad, const Tensor<T> &gamma,
+        const Tensor<T> &mean, const Tensor<T> &inv_stddev,
+        const Tensor<T> &sum_grad, const Tensor<T> &src1_grad,
+        const Tensor<T> &src2_grad, const Tensor<T> &gamma_grad,
+        const Tensor<T> &beta_grad, Index axis, int redux)
+{
+    // Check dimensions
+    if(sum.ndim != dst_grad.ndim)
+    {
+        throw std::runtime_error("sum.ndim != dst_grad.ndim");
+    }
+    if(sum.ndim != sum_grad.ndim)
+    {
+        throw std::runtime_error("sum.ndim != sum_grad.ndim");
+    }
+    if(sum.ndim != src1_grad.ndim)
+    {
+        throw std::runtime_error("sum.ndim != src1_grad.ndim");
+    }
+    if(sum.ndim != src2_grad.ndim)
+    {
+        throw std::runtime_error("sum.ndim != src2_grad.ndim");
+    }
+    if(sum.ndim-1 != mean.ndim)
+    {
+        throw std::runtime_error("sum.ndim-1 != mean.ndim");
+    }
+    if(sum.ndim-1 != inv_stddev.ndim)
+    {
+        throw std::runtime_error("sum.ndim-1 != inv_stddev.ndim");
+    }
+    if(gamma.ndim != 1)
+    {
+        throw std::runtime_error("gamma.ndim != 1");
+    }
+    if(gamma_grad.ndim != 1)
+    {
+        throw std::runtime_error("gamma_grad.ndim != 1");
+    }
+    if(beta_grad.ndim != 1)
+    {
+        throw std::runtime_error("beta_grad.ndim != 1");
+    }
+    // Treat special case of sum.ndim=0
+    if(sum.ndim == 0)
+    {
+        throw std::runtime_error("Scalar input makes no sense");
+    }
+    Index ndim = sum.ndim;
+    // Check axis
+    if(axis < 0)
+    {
+        throw std::runtime_error("axis < 0");
+    }
+    if(axis >= ndim)
+    {
+        throw std::runtime_error("axis >= sum.ndim");
+    }
+    // Check shapes
+    if(sum.shape != dst_grad.shape)
+    {
+        throw std::runtime_error("sum.shape != dst_grad.shape");
+    }
+    if(sum.basetile_shape != dst_grad.basetile_shape)
+    {
+        throw std::runtime_error("sum.basetile_shape != "
+                "dst_grad.basetile_shape");
+    }
+    if(sum.shape != sum_grad.shape)
+    {
+        throw std::runtime_error("sum.shape != sum_grad.shape");
+    }
+    if(sum.basetile_shape != sum_grad.basetile_shape)
+    {
+        throw std::runtime_error("sum.basetile_shape != "
+                "sum_grad.basetile_shape");
+    }
+    if(sum.shape != src1_grad.shape)
+    {
+        throw std::runtime_error("sum.shape != src1_grad.shape");
+    }
+    if(sum.basetile_shape != src1_grad.basetile_shape)
+    {
+        throw std::runtime_error("sum.basetile_shape != "
+                "src1_grad.basetile_shape");
+    }
+    if(sum.shape != src2_grad.shape)
+    {
+        throw std::runtime_error("sum.shape != src2_grad.shape");
+    }
+    if(sum.basetile_shape != src2_grad.basetile_shape)
+    {
+        throw std::runtime_error("sum.basetile_shape != "
+                "src2_grad.basetile_shape");
+    }
+    if(mean.shape != inv_stddev.shape)
+    {
+        throw std::runtime_error("mean.shape != inv_stddev.shape");
+    }
+    if(mean.basetile_shape != inv_stddev.basetile_shape)
+    {
+        throw std::runtime_error("mean.basetile_shape != "
+                "inv_stddev.basetile_shape");
+    }
+    for(Index i = 0; i < axis; i++)
+    {
+        if(sum.shape[i] != mean.shape[i])
+        {
+            throw std::runtime_error("sum.shape[i] != mean.shape[i]");
+        }
+        if(sum.basetile_shape[i] != mean.basetile_shape[i])
+        {
+            throw std::runtime_error("sum.basetile_shape[i] != "
+                    "mean.basetile_shape[i]");
+        }
+    }
+    for(Index i = axis+1; i < ndim; i++)
+    {
+        if(sum.shape[i] != mean.shape[i-1])
+        {
+            throw std::runtime_error("sum.shape[i] != mean.shape[i-1]");
+        }
+        if(sum.basetile_shape[i] != mean.basetile_shape[i-1])
+        {
+            throw std::runtime_error("sum.basetile_shape[i] != "
+                    "mean.basetile_shape[i-1]");
+        }
+    }
+    if(sum.basetile_shape[axis] != sum.shape[axis])
+    {
+        throw std::runtime_error("sum.basetile_shape[axis] != "
+                "sum.shape[axis]");
+    }
+    if(sum.shape[axis] != gamma.shape[0])
+    {
+        throw std::runtime_error("sum.shape[axis] != gamma.shape[0]");
+    }
+    if(gamma.basetile_shape[0] != gamma.shape[0])
+    {
+        throw std::runtime_error("gamma.basetile_shape[0] != "
+                "gamma.shape[0]");
+    }
+    if(gamma.shape != gamma_grad.shape)
+    {
+        throw std::runtime_error("gamma.shape != gamma_grad.shape");
+    }
+    if(gamma.basetile_shape != gamma_grad.basetile_shape)
+    {
+        throw std::runtime_error("gamma.basetile_shape != "
+                "gamma_grad.basetile_shape");
+    }
+    if(gamma.shape != beta_grad.shape)
+    {
+        throw std::runtime_error("gamma.shape != beta_grad.shape");
+    }
+    if(gamma.basetile_shape != beta_grad.basetile_shape)
+    {
+        throw std::runtime_error("gamma.basetile_shape != "
+                "beta_grad.basetile_shape");
+    }
+    // Do actual calculations
+    // Deterministic mode replaces STARPU_REDUX by a sequential chain
+    redux = redux_mode(redux, false);
+    int mpi_rank = starpu_mpi_world_rank();
+    const auto &gamma_tile_handle = gamma.get_tile_handle(0);
+    const auto &gamma_grad_tile_handle = gamma_grad.get_tile_handle(0);
+    const auto &beta_grad_tile_handle = beta_grad.get_tile_handle(0);
+    int gamma_grad_tile_rank = gamma_grad_tile_handle.mpi_get_rank();
+    if(beta_grad_tile_handle.mpi_get_rank() != gamma_grad_tile_rank)
+    {
+        throw std::runtime_error("Tiles of gamma_grad and beta_grad are "
+                "owned by different nodes");
+    }
+    for(Index i = 0; i < sum.grid.nelems; ++i)
+    {
+        const auto &src1_grad_tile_handle = src1_grad.get_tile_handle(i);
+        const auto &src2_grad_tile_handle = src2_grad.get_tile_handle(i);
+        int src1_grad_tile_rank = src1_grad_tile_handle.mpi_get_rank();
+        // Gradients of both inputs, gamma and beta are updated by the same
+        // task
+        if(src2_grad_tile_handle.mpi_get_rank() != src1_grad_tile_rank)
+        {
+            throw std::runtime_error("Tiles of src1_grad and src2_grad are "
+                    "owned by different nodes");
+        }
+        if(src1_grad_tile_rank != gamma_grad_tile_rank)
+        {
+            throw std::runtime_error("Tiles of src1_grad and gamma_grad are "
+                    "owned by different nodes");
+        }
+        // Obtain index of the corresponding tile of statistics
+        auto src_tile_index = sum.grid.linear_to_index(i);
+        std::vector<Index> mean_tile_index(ndim-1);
+        for(Index j = 0, k = 0; j < ndim; ++j)
+        {
+            if(j == axis)
+            {
+                continue;
+            }
+            mean_tile_index[k] = src_tile_index[j];
+            ++k;
+        }
+        Index mean_tile_offset = mean.grid.index_to_linear(mean_tile_index);
+        const auto &sum_tile_handle = sum.get_tile_handle(i);
+        const auto &dst_grad_tile_handle = dst_grad.get_tile_handle(i);
+        const auto &sum_grad_tile_handle = sum_grad.get_tile_handle(i);
+        const auto &mean_tile_handle = mean.get_tile_handle(mean_tile_offset);
+        const auto &inv_stddev_tile_handle = inv_stddev.get_tile_handle(
+                mean_tile_offset);
+        // Transfer data
+        sum_tile_handle.mpi_transfer(src1_grad_tile_rank, mpi_rank);
+        dst_grad_tile_handle.mpi_transfer(src1_grad_tile_rank, mpi_rank);
+        gamma_tile_handle.mpi_transfer(src1_grad_tile_rank, mpi_rank);
+        mean_tile_handle.mpi_transfer(src1_grad_tile_rank, mpi_rank);
+        inv_stddev_tile_handle.mpi_transfer(src1_grad_tile_rank, mpi_rank);
+        sum_grad_tile_handle.mpi_transfer(src1_grad_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == src1_grad_tile_rank)
+        {
+            // Get sizes
+            const auto &src_tile_traits = sum.get_tile_traits(i);
+            Index m, n, k;
+            m = src_tile_traits.stride[axis];
+            n = src_tile_traits.matrix_shape[axis+1][1];
+            k = src_tile_traits.shape[axis];
+            // Insert task
+            starpu::add_layer_norm_backward::submit<T>(m, n, k,
+                    sum_tile_handle, dst_grad_tile_handle, gamma_tile_handle,
+                    mean_tile_handle, inv_stddev_tile_handle,
+                    sum_grad_tile_handle, src1_grad_tile_handle,
+                    src2_grad_tile_handle, gamma_grad_tile_handle,
+                    beta_grad_tile_handle, redux);
+        }
+        // Flush cache for the output tiles on every node
+        src1_grad_tile_handle.mpi_flush();
+        src2_grad_tile_handle.mpi_flush();
+    }
+    // Flush cache for the accumulated outputs on every node
+    gamma_grad_tile_handle.mpi_flush();
+    beta_grad_tile_handle.mpi_flush();
+}
+
+template<typename T>
+void add_layer_norm_backward(const Tensor<T> &sum, const Tensor<T> &dst_grad,
+        const Tensor<T> &gamma, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &sum_grad,
+        const Tensor<T> &src1_grad, const Tensor<T> &src2_grad,
+        const Tensor<T> &gamma_grad, const Tensor<T> &beta_grad, Index axis,
+        int redux)
+{
+    add_layer_norm_backward_async<T>(sum, dst_grad, gamma, mean, inv_stddev,
+            sum_grad, src1_grad, src2_grad, gamma_grad, beta_grad, axis,
+            redux);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void add_layer_norm_backward_async<fp32_t>(const Tensor<fp32_t> &sum,
+        const Tensor<fp32_t> &dst_grad, const Tensor<fp32_t> &gamma,
+        const Tensor<fp32_t> &mean, const Tensor<fp32_t> &inv_stddev,
+        const Tensor<fp32_t> &sum_grad, const Tensor<fp32_t> &src1_grad,
+        const Tensor<fp32_t> &src2_grad, const Tensor<fp32_t> &gamma_grad,
+        const Tensor<fp32_t> &beta_grad, Index axis, int redux);
+
+template
+void add_layer_norm_backward_async<fp64_t>(const Tensor<fp64_t> &sum,
+        const Tensor<fp64_t> &dst_grad, const Tensor<fp64_t> &gamma,
+        const Tensor<fp64_t> &mean, const Tensor<fp64_t> &inv_stddev,
+        const Tensor<fp64_t> &sum_grad, const Tensor<fp64_t> &src1_grad,
+        const Tensor<fp64_t> &src2_grad, const Tensor<fp64_t> &gamma_grad,
+        const Tensor<fp64_t> &beta_grad, Index axis, int redux);
+
+// Explicit instantiation
+template
+void add_layer_norm_backward<fp32_t>(const Tensor<fp32_t> &sum,
+        const Tensor<fp32_t> &dst_grad, const Tensor<fp32_t> &gamma,
+        const Tensor<fp32_t> &mean, const Tensor<fp32_t> &inv_stddev,
+        const Tensor<fp32_t> &sum_grad, const Tensor<fp32_t> &src1_grad,
+        const Tensor<fp32_t> &src2_grad, const Tensor<fp32_t> &gamma_grad,
+        const Tensor<fp32_t> &beta_grad, Index axis, int redux);
+
+template
+void add_layer_norm_backward<fp64_t>(const Tensor<fp64_t> &sum,
+        const Tensor<fp64_t> &dst_grad, const Tensor<fp64_t> &gamma,
+        const Tensor<fp64_t> &mean, const Tensor<fp64_t> &inv_stddev,
+        const Tensor<fp64_t> &sum_grad, const Tensor<fp64_t> &src1_grad,
+        const Tensor<fp64_t> &src2_grad, const Tensor<fp64_t> &gamma_grad,
+        const Tensor<fp64_t> &beta_grad, Index axis, int redux);
+
+} // namespace tensor
+} // namespace nntile
+
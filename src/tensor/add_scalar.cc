@@ -35,13 +35,13 @@ void add_scalar_async(T alpha, T beta, const Tensor<T> &dst)
     for(Index i = 0; i < dst.grid.nelems; ++i)
     {
         // Get handle for corresponding tiles of src and dst
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         // MPI rank of the destination tile
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Execute only on destination node
         if(mpi_rank == dst_tile_rank)
         {
-            auto traits = dst.get_tile_traits(i);
+            const auto &traits = dst.get_tile_traits(i);
             starpu::add_scalar::submit<T>(traits.nelems, alpha, beta,
                     dst_tile_handle);
         }
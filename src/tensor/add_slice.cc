@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/tensor/add_slice.hh"
+#include "nntile/tensor/aggregate.hh"
 #include "nntile/starpu/add_slice.hh"
 
 namespace nntile
@@ -75,15 +76,16 @@ void add_slice_async(T alpha, const Tensor<T> &src, T beta,
     }
     // Apply per-tile add_slice asynchronously as needed
     int mpi_rank = starpu_mpi_world_rank();
-    int ret;
+    Index aggregate_nelems = get_aggregate_nelems();
+    std::vector<Index> src_tile_index;
     for(Index i = 0; i < src.grid.nelems; ++i)
     {
         // Index of current source tile
-        auto src_tile_index = src.grid.linear_to_index(i);
+        src.grid.linear_to_index(i, src_tile_index);
         // Source tile traits
-        auto src_tile_traits = src.get_tile_traits(i);
+        const auto &src_tile_traits = src.get_tile_traits(i);
         // Source tile handle
-        auto src_tile_handle = src.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
         // Set fixed indices of current destination tile
         std::vector<Index> dst_tile_index(dst.ndim);
         for(Index j = 0; j < axis; ++j)
@@ -94,6 +96,29 @@ void add_slice_async(T alpha, const Tensor<T> &src, T beta,
         {
             dst_tile_index[j] = src_tile_index[j-1];
         }
+        // Local destination tiles of the same shape, that share the source
+        // tile, are aggregated into a single task
+        std::vector<starpu::Handle> group;
+        Index m = 0, n = 0, k = 0, group_nelems = 0;
+        auto submit_group = [&]()
+        {
+            if(group.size() == 1)
+            {
+                starpu::add_slice::submit<T>(m, n, k, alpha, src_tile_handle,
+                        beta, group[0]);
+            }
+            else if(group.size() > 1)
+            {
+                starpu::add_slice::submit<T>(m, n, k, alpha, src_tile_handle,
+                        beta, group);
+            }
+            for(const auto &handle: group)
+            {
+                handle.mpi_flush();
+            }
+            group.clear();
+            group_nelems = 0;
+        };
         // Loop through all necessary destination tiles
         for(Index j = 0; j < dst.grid.shape[axis]; ++j)
         {
@@ -102,28 +127,34 @@ void add_slice_async(T alpha, const Tensor<T> &src, T beta,
             // Get linear offset from index
             Index dst_tile_offset = dst.grid.index_to_linear(dst_tile_index);
             // Get destination tile handle
-            auto dst_tile_handle = dst.get_tile_handle(dst_tile_offset);
+            const auto &dst_tile_handle = dst.get_tile_handle(dst_tile_offset);
             // MPI rank of the destination tile
             int dst_tile_rank = dst_tile_handle.mpi_get_rank();
             // Transfer data
             src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
             // Execute on destination node
-            if(mpi_rank == dst_tile_rank)
+            if(mpi_rank != dst_tile_rank)
             {
-                // Get destination tile traits
-                auto dst_tile_traits = dst.get_tile_traits(dst_tile_offset);
-                // Reshape inputs: src_tile -> (m,n), dst_tile -> (m,k,n)
-                Index m, n, k;
-                m = dst_tile_traits.stride[axis];
-                n = dst_tile_traits.matrix_shape[axis+1][1];
-                k = dst_tile_traits.shape[axis];
-                // Insert corresponding task
-                starpu::add_slice::submit<T>(m, n, k, alpha, src_tile_handle,
-                        beta, dst_tile_handle);
+                // Flush cache for the output tile on every node
+                dst_tile_handle.mpi_flush();
+                continue;
+            }
+            // Get destination tile traits
+            const auto &dst_tile_traits = dst.get_tile_traits(dst_tile_offset);
+            // Only the last tile along the axis may be of a different shape
+            if(dst_tile_traits.shape[axis] != k
+                    or group_nelems+dst_tile_traits.nelems > aggregate_nelems)
+            {
+                submit_group();
             }
-            // Flush cache for the output tile on every node
-            dst_tile_handle.mpi_flush();
+            // Reshape inputs: src_tile -> (m,n), dst_tile -> (m,k,n)
+            m = dst_tile_traits.stride[axis];
+            n = dst_tile_traits.matrix_shape[axis+1][1];
+            k = dst_tile_traits.shape[axis];
+            group.push_back(dst_tile_handle);
+            group_nelems += dst_tile_traits.nelems;
         }
+        submit_group();
     }
 }
 
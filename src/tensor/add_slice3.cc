@@ -89,14 +89,15 @@ void add_slice3_async(T alpha, const Tensor<T> &src1, T beta,
     // Apply per-tile add_slice3 asynchronously as needed
     int mpi_rank = starpu_mpi_world_rank();
     int ret;
+    std::vector<Index> src1_tile_index;
     for(Index i = 0; i < src1.grid.nelems; ++i)
     {
         // Index of current source tile
-        auto src1_tile_index = src1.grid.linear_to_index(i);
+        src1.grid.linear_to_index(i, src1_tile_index);
         // Source tile traits
-        auto src1_tile_traits = src1.get_tile_traits(i);
+        const auto &src1_tile_traits = src1.get_tile_traits(i);
         // Source tile handle
-        auto src1_tile_handle = src1.get_tile_handle(i);
+        const auto &src1_tile_handle = src1.get_tile_handle(i);
         // Set fixed indices of current destination tile
         std::vector<Index> dst_tile_index(dst.ndim);
         for(Index j = 0; j < axis; ++j)
@@ -115,9 +116,10 @@ void add_slice3_async(T alpha, const Tensor<T> &src1, T beta,
             // Get linear offset from index
             Index dst_tile_offset = dst.grid.index_to_linear(dst_tile_index);
             // Get destination tile handle
-            auto dst_tile_handle = dst.get_tile_handle(dst_tile_offset);
+            const auto &dst_tile_handle = dst.get_tile_handle(dst_tile_offset);
             // Get src2 tile handle
-            auto src2_tile_handle = src2.get_tile_handle(dst_tile_offset);
+            const auto &src2_tile_handle =
+                    src2.get_tile_handle(dst_tile_offset);
             // MPI rank of the destination tile
             int dst_tile_rank = dst_tile_handle.mpi_get_rank();
             // Transfer data
@@ -127,7 +129,8 @@ void add_slice3_async(T alpha, const Tensor<T> &src1, T beta,
             if(mpi_rank == dst_tile_rank)
             {
                 // Get destination tile traits
-                auto dst_tile_traits = dst.get_tile_traits(dst_tile_offset);
+                const auto &dst_tile_traits =
+                    dst.get_tile_traits(dst_tile_offset);
                 // Reshape inputs: src_tile -> (m,n), dst_tile -> (m,k,n)
                 Index m, n, k;
                 m = dst_tile_traits.stride[axis];
@@ -39,9 +39,9 @@ void addcdiv_async(T val, T eps, const Tensor<T> &nom, const Tensor<T> &denom,
     for(Index i = 0; i < src.grid.nelems; ++i)
     {
         // Get handle for corresponding tiles of src and dst
-        auto src_tile_handle = src.get_tile_handle(i);
-        auto nom_tile_handle = nom.get_tile_handle(i);
-        auto denom_tile_handle = denom.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &nom_tile_handle = nom.get_tile_handle(i);
+        const auto &denom_tile_handle = denom.get_tile_handle(i);
         // MPI rank of the destination tile
         int nom_tile_rank = nom_tile_handle.mpi_get_rank();
         int denom_tile_rank = denom_tile_handle.mpi_get_rank();
@@ -52,7 +52,7 @@ void addcdiv_async(T val, T eps, const Tensor<T> &nom, const Tensor<T> &denom,
         // Execute only on destination node
         if(mpi_rank == src_tile_rank)
         {
-            auto traits = src.get_tile_traits(i);
+            const auto &traits = src.get_tile_traits(i);
             starpu::addcdiv::submit<T>(val, eps, traits.nelems, nom_tile_handle, 
                                        denom_tile_handle, src_tile_handle);
         }
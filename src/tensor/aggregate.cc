@@ -0,0 +1,44 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/aggregate.cc
+ * Aggregation of tiny tiles into tasks
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/aggregate.hh"
+#include <atomic>
+#include <stdexcept>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Tiles of less than 8192 elements take a few microseconds to process,
+// which is comparable to overhead of a task
+static std::atomic<Index> aggregate_nelems = 8192;
+
+void set_aggregate_nelems(Index nelems)
+{
+    if(nelems < 0)
+    {
+        throw std::runtime_error("nelems < 0");
+    }
+    aggregate_nelems = nelems;
+}
+
+Index get_aggregate_nelems()
+{
+    return aggregate_nelems;
+}
+
+} // namespace tensor
+} // namespace nntile
+
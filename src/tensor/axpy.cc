@@ -46,7 +46,7 @@ void axpy_async(const Tensor<T> &alpha, const Tensor<T> &src,
     int mpi_size = starpu_mpi_world_size();
     int mpi_rank = starpu_mpi_world_rank();
     // Scatter alpha
-    auto alpha_handle = alpha.get_tile_handle(0);
+    const auto &alpha_handle = alpha.get_tile_handle(0);
     int alpha_rank = alpha_handle.mpi_get_rank();
     if(mpi_rank == alpha_rank)
     {
@@ -67,8 +67,8 @@ void axpy_async(const Tensor<T> &alpha, const Tensor<T> &src,
     for(Index i = 0; i < src.grid.nelems; ++i)
     {
         // Get handle for corresponding tiles of src and dst
-        auto src_tile_handle = src.get_tile_handle(i);
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         // MPI rank of the destination tile
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Transfer data
@@ -76,7 +76,7 @@ void axpy_async(const Tensor<T> &alpha, const Tensor<T> &src,
         // Execute only on destination node
         if(mpi_rank == dst_tile_rank)
         {
-            auto traits = src.get_tile_traits(i);
+            const auto &traits = src.get_tile_traits(i);
             starpu::axpy::submit<T>(alpha_handle, traits.nelems,
                     src_tile_handle, dst_tile_handle);
         }
@@ -138,8 +138,8 @@ void axpy_async(T alpha, const Tensor<T> &src, const Tensor<T> &dst)
     for(Index i = 0; i < src.grid.nelems; ++i)
     {
         // Get handle for corresponding tiles of src and dst
-        auto src_tile_handle = src.get_tile_handle(i);
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         // MPI rank of the destination tile
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Transfer data
@@ -147,7 +147,7 @@ void axpy_async(T alpha, const Tensor<T> &src, const Tensor<T> &dst)
         // Execute only on destination node
         if(mpi_rank == dst_tile_rank)
         {
-            auto traits = src.get_tile_traits(i);
+            const auto &traits = src.get_tile_traits(i);
             starpu::axpy::submit<T>(alpha, traits.nelems,
                     src_tile_handle, dst_tile_handle);
         }
@@ -0,0 +1,181 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/batch_norm_act.cc
+ * Batch normalization followed by an activation of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/batch_norm_act.hh"
+#include "nntile/starpu/batch_norm_act.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Check shapes of tensors for batch normalization and its backward
+/*! Parameter is any of per-feature vectors: statistics, scaling factors,
+ * biases or sums of gradients.
+ * */
+void batch_norm_act_check(const TensorTraits &param, const TensorTraits &src,
+        const TensorTraits &dst, Index axis)
+{
+    // Check dimensions
+    if(src.ndim != dst.ndim)
+    {
+        throw std::runtime_error("src.ndim != dst.ndim");
+    }
+    if(param.ndim != 1)
+    {
+        throw std::runtime_error("param.ndim != 1");
+    }
+    // Treat special case of src.ndim=0
+    if(src.ndim == 0)
+    {
+        throw std::runtime_error("Scalar input makes no sense");
+    }
+    // Check axis
+    if(axis < 0)
+    {
+        throw std::runtime_error("axis < 0");
+    }
+    if(axis >= src.ndim)
+    {
+        throw std::runtime_error("axis >= src.ndim");
+    }
+    // Check shapes
+    if(src.shape != dst.shape)
+    {
+        throw std::runtime_error("src.shape != dst.shape");
+    }
+    if(src.basetile_shape != dst.basetile_shape)
+    {
+        throw std::runtime_error("src.basetile_shape != dst.basetile_shape");
+    }
+    if(param.shape[0] != src.shape[axis])
+    {
+        throw std::runtime_error("param.shape[0] != src.shape[axis]");
+    }
+    if(param.basetile_shape[0] != src.basetile_shape[axis])
+    {
+        throw std::runtime_error("param.basetile_shape[0] != "
+                "src.basetile_shape[axis]");
+    }
+}
+
+//! Tensor-wise batch normalization followed by an activation
+/*! Normalizes src along all axes except the given one with the provided
+ * statistics, applies scaling factors and biases of features and the
+ * activation in a single pass over data:
+ *      dst = act((src-mean)*inv_stddev*gamma + beta)
+ * Statistics are either computed over the current batch during training or
+ * running statistics are used for inference. Output before the activation is
+ * not stored, as batch_norm_act_backward recomputes it.
+ *
+ * @param[in] src: Input tensor
+ * @param[in] mean: Mean values of features of size src.shape[axis]
+ * @param[in] inv_stddev: Inverse standard deviations of features
+ * @param[in] gamma: Scaling factors of features
+ * @param[in] beta: Biases of features
+ * @param[out] dst: Output of the activation
+ * @param[in] axis: Axis of features
+ * @param[in] act: Activation, applied after normalization
+ * */
+template<typename T>
+void batch_norm_act_async(const Tensor<T> &src, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &gamma,
+        const Tensor<T> &beta, const Tensor<T> &dst, Index axis,
+        activation_t act)
+{
+    // Check inputs (throw exception in case of an error)
+    batch_norm_act_check(mean, src, dst, axis);
+    batch_norm_act_check(inv_stddev, src, dst, axis);
+    batch_norm_act_check(gamma, src, dst, axis);
+    batch_norm_act_check(beta, src, dst, axis);
+    // Do actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    std::vector<Index> dst_tile_index;
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
+        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+        dst.grid.linear_to_index(i, dst_tile_index);
+        Index j = dst_tile_index[axis];
+        const auto &mean_tile_handle = mean.get_tile_handle(j);
+        const auto &inv_stddev_tile_handle = inv_stddev.get_tile_handle(j);
+        const auto &gamma_tile_handle = gamma.get_tile_handle(j);
+        const auto &beta_tile_handle = beta.get_tile_handle(j);
+        // Transfer data
+        src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        mean_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        inv_stddev_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        gamma_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        beta_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == dst_tile_rank)
+        {
+            // Get sizes
+            const auto &dst_tile_traits = dst.get_tile_traits(i);
+            Index m, n, k;
+            m = dst_tile_traits.stride[axis];
+            n = dst_tile_traits.matrix_shape[axis+1][1];
+            k = dst_tile_traits.shape[axis];
+            // Insert task
+            starpu::batch_norm_act::submit<T>(m, n, k, act, src_tile_handle,
+                    mean_tile_handle, inv_stddev_tile_handle,
+                    gamma_tile_handle, beta_tile_handle, dst_tile_handle);
+        }
+        // Flush cache for the output tile on every node
+        dst_tile_handle.mpi_flush();
+    }
+}
+
+template<typename T>
+void batch_norm_act(const Tensor<T> &src, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &gamma,
+        const Tensor<T> &beta, const Tensor<T> &dst, Index axis,
+        activation_t act)
+{
+    batch_norm_act_async<T>(src, mean, inv_stddev, gamma, beta, dst, axis,
+            act);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void batch_norm_act_async<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &mean, const Tensor<fp32_t> &inv_stddev,
+        const Tensor<fp32_t> &gamma, const Tensor<fp32_t> &beta,
+        const Tensor<fp32_t> &dst, Index axis, activation_t act);
+
+template
+void batch_norm_act_async<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &mean, const Tensor<fp64_t> &inv_stddev,
+        const Tensor<fp64_t> &gamma, const Tensor<fp64_t> &beta,
+        const Tensor<fp64_t> &dst, Index axis, activation_t act);
+
+// Explicit instantiation
+template
+void batch_norm_act<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &mean, const Tensor<fp32_t> &inv_stddev,
+        const Tensor<fp32_t> &gamma, const Tensor<fp32_t> &beta,
+        const Tensor<fp32_t> &dst, Index axis, activation_t act);
+
+template
+void batch_norm_act<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &mean, const Tensor<fp64_t> &inv_stddev,
+        const Tensor<fp64_t> &gamma, const Tensor<fp64_t> &beta,
+        const Tensor<fp64_t> &dst, Index axis, activation_t act);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,176 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/batch_norm_act_backward.cc
+ * Backward of an activation, that follows batch normalization, of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/batch_norm_act_backward.hh"
+#include "nntile/tensor/tree_reduction.hh"
+#include "nntile/starpu/batch_norm_act_backward.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Tensor-wise backward of an activation, that follows batch normalization
+/*! Output of normalization is recomputed from src and the statistics, that
+ * were used by batch_norm_act, and gradient over it is stored into y_grad.
+ * Sums of y_grad and of y_grad multiplied by the normalized input along all
+ * axes except the given one are accumulated into sum_grad and sum_grad_xhat
+ * in the same task. They are gradients of biases and scaling factors of
+ * features and they are needed by batch_norm_backward. Tiles of y_grad shall
+ * be owned by the same nodes as the corresponding tiles of sum_grad and
+ * sum_grad_xhat.
+ *
+ * @param[in] src: Input of normalization
+ * @param[in] mean: Mean values of features of size src.shape[axis]
+ * @param[in] inv_stddev: Inverse standard deviations of features
+ * @param[in] gamma: Scaling factors of features
+ * @param[in] beta: Biases of features
+ * @param[in] dst_grad: Gradient of output of the activation
+ * @param[out] y_grad: Gradient of output of normalization
+ * @param[inout] sum_grad: Accumulated sums of y_grad
+ * @param[inout] sum_grad_xhat: Accumulated sums of y_grad multiplied by the
+ *      normalized input
+ * @param[in] axis: Axis of features
+ * @param[in] act: Activation, applied after normalization
+ * @param[in] redux: Whether to use STARPU_REDUX for the sums
+ * */
+template<typename T>
+void batch_norm_act_backward_async(const Tensor<T> &src,
+        const Tensor<T> &mean, const Tensor<T> &inv_stddev,
+        const Tensor<T> &gamma, const Tensor<T> &beta,
+        const Tensor<T> &dst_grad, const Tensor<T> &y_grad,
+        const Tensor<T> &sum_grad, const Tensor<T> &sum_grad_xhat,
+        Index axis, activation_t act, int redux)
+{
+    // Check inputs (throw exception in case of an error)
+    batch_norm_act_check(mean, src, dst_grad, axis);
+    batch_norm_act_check(inv_stddev, src, dst_grad, axis);
+    batch_norm_act_check(gamma, src, dst_grad, axis);
+    batch_norm_act_check(beta, src, dst_grad, axis);
+    batch_norm_act_check(sum_grad, src, y_grad, axis);
+    batch_norm_act_check(sum_grad_xhat, src, y_grad, axis);
+    // Do actual calculations
+    // Deterministic mode replaces STARPU_REDUX by a sequential chain
+    redux = redux_mode(redux, false);
+    int mpi_rank = starpu_mpi_world_rank();
+    std::vector<Index> src_tile_index;
+    for(Index i = 0; i < src.grid.nelems; ++i)
+    {
+        src.grid.linear_to_index(i, src_tile_index);
+        Index j = src_tile_index[axis];
+        const auto &sum_grad_tile_handle = sum_grad.get_tile_handle(j);
+        const auto &sum_grad_xhat_tile_handle =
+            sum_grad_xhat.get_tile_handle(j);
+        int sum_grad_tile_rank = sum_grad_tile_handle.mpi_get_rank();
+        const auto &y_grad_tile_handle = y_grad.get_tile_handle(i);
+        // Gradient and both sums are updated by the same task
+        if(y_grad_tile_handle.mpi_get_rank() != sum_grad_tile_rank
+                or sum_grad_xhat_tile_handle.mpi_get_rank()
+                != sum_grad_tile_rank)
+        {
+            throw std::runtime_error("Tiles of y_grad, sum_grad and "
+                    "sum_grad_xhat are owned by different nodes");
+        }
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_grad_tile_handle = dst_grad.get_tile_handle(i);
+        const auto &mean_tile_handle = mean.get_tile_handle(j);
+        const auto &inv_stddev_tile_handle = inv_stddev.get_tile_handle(j);
+        const auto &gamma_tile_handle = gamma.get_tile_handle(j);
+        const auto &beta_tile_handle = beta.get_tile_handle(j);
+        // Transfer data
+        src_tile_handle.mpi_transfer(sum_grad_tile_rank, mpi_rank);
+        dst_grad_tile_handle.mpi_transfer(sum_grad_tile_rank, mpi_rank);
+        mean_tile_handle.mpi_transfer(sum_grad_tile_rank, mpi_rank);
+        inv_stddev_tile_handle.mpi_transfer(sum_grad_tile_rank, mpi_rank);
+        gamma_tile_handle.mpi_transfer(sum_grad_tile_rank, mpi_rank);
+        beta_tile_handle.mpi_transfer(sum_grad_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == sum_grad_tile_rank)
+        {
+            // Get sizes
+            const auto &src_tile_traits = src.get_tile_traits(i);
+            Index m, n, k;
+            m = src_tile_traits.stride[axis];
+            n = src_tile_traits.matrix_shape[axis+1][1];
+            k = src_tile_traits.shape[axis];
+            // Insert task
+            starpu::batch_norm_act_backward::submit<T>(m, n, k, act,
+                    src_tile_handle, mean_tile_handle,
+                    inv_stddev_tile_handle, gamma_tile_handle,
+                    beta_tile_handle, dst_grad_tile_handle,
+                    y_grad_tile_handle, sum_grad_tile_handle,
+                    sum_grad_xhat_tile_handle, redux);
+        }
+        // Flush cache for the output tile on every node
+        y_grad_tile_handle.mpi_flush();
+    }
+    // Flush cache for the accumulated outputs on every node
+    for(Index i = 0; i < sum_grad.grid.nelems; ++i)
+    {
+        sum_grad.get_tile_handle(i).mpi_flush();
+        sum_grad_xhat.get_tile_handle(i).mpi_flush();
+    }
+}
+
+template<typename T>
+void batch_norm_act_backward(const Tensor<T> &src, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &gamma,
+        const Tensor<T> &beta, const Tensor<T> &dst_grad,
+        const Tensor<T> &y_grad, const Tensor<T> &sum_grad,
+        const Tensor<T> &sum_grad_xhat, Index axis, activation_t act,
+        int redux)
+{
+    batch_norm_act_backward_async<T>(src, mean, inv_stddev, gamma, beta,
+            dst_grad, y_grad, sum_grad, sum_grad_xhat, axis, act, redux);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void batch_norm_act_backward_async<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &mean, const Tensor<fp32_t> &inv_stddev,
+        const Tensor<fp32_t> &gamma, const Tensor<fp32_t> &beta,
+        const Tensor<fp32_t> &dst_grad, const Tensor<fp32_t> &y_grad,
+        const Tensor<fp32_t> &sum_grad, const Tensor<fp32_t> &sum_grad_xhat,
+        Index axis, activation_t act, int redux);
+
+template
+void batch_norm_act_backward_async<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &mean, const Tensor<fp64_t> &inv_stddev,
+        const Tensor<fp64_t> &gamma, const Tensor<fp64_t> &beta,
+        const Tensor<fp64_t> &dst_grad, const Tensor<fp64_t> &y_grad,
+        const Tensor<fp64_t> &sum_grad, const Tensor<fp64_t> &sum_grad_xhat,
+        Index axis, activation_t act, int redux);
+
+// Explicit instantiation
+template
+void batch_norm_act_backward<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &mean, const Tensor<fp32_t> &inv_stddev,
+        const Tensor<fp32_t> &gamma, const Tensor<fp32_t> &beta,
+        const Tensor<fp32_t> &dst_grad, const Tensor<fp32_t> &y_grad,
+        const Tensor<fp32_t> &sum_grad, const Tensor<fp32_t> &sum_grad_xhat,
+        Index axis, activation_t act, int redux);
+
+template
+void batch_norm_act_backward<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &mean, const Tensor<fp64_t> &inv_stddev,
+        const Tensor<fp64_t> &gamma, const Tensor<fp64_t> &beta,
+        const Tensor<fp64_t> &dst_grad, const Tensor<fp64_t> &y_grad,
+        const Tensor<fp64_t> &sum_grad, const Tensor<fp64_t> &sum_grad_xhat,
+        Index axis, activation_t act, int redux);
+
+} // namespace tensor
+} // namespace nntile
+
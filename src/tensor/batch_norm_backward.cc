@@ -0,0 +1,149 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/batch_norm_backward.cc
+ * Backward of batch normalization with stored statistics of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/batch_norm_backward.hh"
+#include "nntile/tensor/batch_norm_act.hh"
+#include "nntile/starpu/batch_norm_backward.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Tensor-wise backward of batch normalization with stored statistics
+/*! Converts gradient of output of normalization, computed by
+ * batch_norm_act_backward, into gradient of its input inplace. Statistics
+ * were computed over all the elements of src except the axis of features,
+ * and sum_grad and sum_grad_xhat shall be complete sums over the same
+ * elements.
+ *
+ * @param[in] src: Input of normalization
+ * @param[in] mean: Mean values of features of size src.shape[axis]
+ * @param[in] inv_stddev: Inverse standard deviations of features
+ * @param[in] gamma: Scaling factors of features
+ * @param[in] sum_grad: Sums of gradient of output of normalization
+ * @param[in] sum_grad_xhat: Sums of gradient of output of normalization,
+ *      multiplied by the normalized input
+ * @param[inout] grad: Gradient of output of normalization on input and
+ *      gradient of its input on output
+ * @param[in] axis: Axis of features
+ * */
+template<typename T>
+void batch_norm_backward_async(const Tensor<T> &src, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &gamma,
+        const Tensor<T> &sum_grad, const Tensor<T> &sum_grad_xhat,
+        const Tensor<T> &grad, Index axis)
+{
+    // Check inputs (throw exception in case of an error)
+    batch_norm_act_check(mean, src, grad, axis);
+    batch_norm_act_check(inv_stddev, src, grad, axis);
+    batch_norm_act_check(gamma, src, grad, axis);
+    batch_norm_act_check(sum_grad, src, grad, axis);
+    batch_norm_act_check(sum_grad_xhat, src, grad, axis);
+    // Inverse of the number of elements of a single feature
+    Index batch = src.nelems / src.shape[axis];
+    if(batch == 0)
+    {
+        return;
+    }
+    T alpha = T(1) / T(batch);
+    // Do actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    std::vector<Index> grad_tile_index;
+    for(Index i = 0; i < grad.grid.nelems; ++i)
+    {
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &grad_tile_handle = grad.get_tile_handle(i);
+        int grad_tile_rank = grad_tile_handle.mpi_get_rank();
+        grad.grid.linear_to_index(i, grad_tile_index);
+        Index j = grad_tile_index[axis];
+        const auto &mean_tile_handle = mean.get_tile_handle(j);
+        const auto &inv_stddev_tile_handle = inv_stddev.get_tile_handle(j);
+        const auto &gamma_tile_handle = gamma.get_tile_handle(j);
+        const auto &sum_grad_tile_handle = sum_grad.get_tile_handle(j);
+        const auto &sum_grad_xhat_tile_handle =
+            sum_grad_xhat.get_tile_handle(j);
+        // Transfer data
+        src_tile_handle.mpi_transfer(grad_tile_rank, mpi_rank);
+        mean_tile_handle.mpi_transfer(grad_tile_rank, mpi_rank);
+        inv_stddev_tile_handle.mpi_transfer(grad_tile_rank, mpi_rank);
+        gamma_tile_handle.mpi_transfer(grad_tile_rank, mpi_rank);
+        sum_grad_tile_handle.mpi_transfer(grad_tile_rank, mpi_rank);
+        sum_grad_xhat_tile_handle.mpi_transfer(grad_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == grad_tile_rank)
+        {
+            // Get sizes
+            const auto &grad_tile_traits = grad.get_tile_traits(i);
+            Index m, n, k;
+            m = grad_tile_traits.stride[axis];
+            n = grad_tile_traits.matrix_shape[axis+1][1];
+            k = grad_tile_traits.shape[axis];
+            // Insert task
+            starpu::batch_norm_backward::submit<T>(m, n, k, alpha,
+                    src_tile_handle, mean_tile_handle,
+                    inv_stddev_tile_handle, gamma_tile_handle,
+                    sum_grad_tile_handle, sum_grad_xhat_tile_handle,
+                    grad_tile_handle);
+        }
+        // Flush cache for the output tile on every node
+        grad_tile_handle.mpi_flush();
+    }
+}
+
+template<typename T>
+void batch_norm_backward(const Tensor<T> &src, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &gamma,
+        const Tensor<T> &sum_grad, const Tensor<T> &sum_grad_xhat,
+        const Tensor<T> &grad, Index axis)
+{
+    batch_norm_backward_async<T>(src, mean, inv_stddev, gamma, sum_grad,
+            sum_grad_xhat, grad, axis);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void batch_norm_backward_async<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &mean, const Tensor<fp32_t> &inv_stddev,
+        const Tensor<fp32_t> &gamma, const Tensor<fp32_t> &sum_grad,
+        const Tensor<fp32_t> &sum_grad_xhat, const Tensor<fp32_t> &grad,
+        Index axis);
+
+template
+void batch_norm_backward_async<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &mean, const Tensor<fp64_t> &inv_stddev,
+        const Tensor<fp64_t> &gamma, const Tensor<fp64_t> &sum_grad,
+        const Tensor<fp64_t> &sum_grad_xhat, const Tensor<fp64_t> &grad,
+        Index axis);
+
+// Explicit instantiation
+template
+void batch_norm_backward<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &mean, const Tensor<fp32_t> &inv_stddev,
+        const Tensor<fp32_t> &gamma, const Tensor<fp32_t> &sum_grad,
+        const Tensor<fp32_t> &sum_grad_xhat, const Tensor<fp32_t> &grad,
+        Index axis);
+
+template
+void batch_norm_backward<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &mean, const Tensor<fp64_t> &inv_stddev,
+        const Tensor<fp64_t> &gamma, const Tensor<fp64_t> &sum_grad,
+        const Tensor<fp64_t> &sum_grad_xhat, const Tensor<fp64_t> &grad,
+        Index axis);
+
+} // namespace tensor
+} // namespace nntile
+
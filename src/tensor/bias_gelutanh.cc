@@ -0,0 +1,154 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/bias_gelutanh.cc
+ * Bias addition followed by approximate GeLU of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#include "nntile/tensor/bias_gelutanh.hh"
+#include "nntile/starpu/bias_gelutanh.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Check shapes of tensors for bias_gelutanh and bias_gelutanh_backward
+void bias_gelutanh_check(const TensorTraits &bias, const TensorTraits &src,
+        const TensorTraits &dst, Index axis)
+{
+    // Check dimensions
+    if(src.ndim != dst.ndim)
+    {
+        throw std::runtime_error("src.ndim != dst.ndim");
+    }
+    if(bias.ndim != 1)
+    {
+        throw std::runtime_error("bias.ndim != 1");
+    }
+    // Treat special case of src.ndim=0
+    if(src.ndim == 0)
+    {
+        throw std::runtime_error("Scalar input makes no sense");
+    }
+    // Check axis
+    if(axis < 0)
+    {
+        throw std::runtime_error("axis < 0");
+    }
+    if(axis >= src.ndim)
+    {
+        throw std::runtime_error("axis >= src.ndim");
+    }
+    // Check shapes
+    if(src.shape != dst.shape)
+    {
+        throw std::runtime_error("src.shape != dst.shape");
+    }
+    if(src.basetile_shape != dst.basetile_shape)
+    {
+        throw std::runtime_error("src.basetile_shape != dst.basetile_shape");
+    }
+    if(bias.shape[0] != src.shape[axis])
+    {
+        throw std::runtime_error("bias.shape[0] != src.shape[axis]");
+    }
+    if(bias.basetile_shape[0] != src.basetile_shape[axis])
+    {
+        throw std::runtime_error("bias.basetile_shape[0] != "
+                "src.basetile_shape[axis]");
+    }
+}
+
+//! Tensor-wise bias addition followed by approximate GeLU
+/*! Bias is added to src inplace, so that src keeps an input of the
+ * activation for the backward pass, while dst gets the activation. Tiles of
+ * src and dst shall be owned by the same nodes.
+ *
+ * @param[in] bias: Bias of size src.shape[axis]
+ * @param[inout] src: Input, that gets the bias
+ * @param[out] dst: Output of the activation
+ * @param[in] axis: Axis of src, along which the bias is applied
+ * */
+template<typename T>
+void bias_gelutanh_async(const Tensor<T> &bias, const Tensor<T> &src,
+        const Tensor<T> &dst, Index axis)
+{
+    // Check inputs (throw exception in case of an error)
+    bias_gelutanh_check(bias, src, dst, axis);
+    // Do actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    std::vector<Index> src_tile_index;
+    for(Index i = 0; i < src.grid.nelems; ++i)
+    {
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
+        int src_tile_rank = src_tile_handle.mpi_get_rank();
+        // Input of the activation and its output are updated by the same
+        // task
+        if(dst_tile_handle.mpi_get_rank() != src_tile_rank)
+        {
+            throw std::runtime_error("Tiles of src and dst are owned by "
+                    "different nodes");
+        }
+        src.grid.linear_to_index(i, src_tile_index);
+        const auto &bias_tile_handle =
+                bias.get_tile_handle(src_tile_index[axis]);
+        // Transfer data
+        bias_tile_handle.mpi_transfer(src_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == src_tile_rank)
+        {
+            // Get sizes
+            const auto &src_tile_traits = src.get_tile_traits(i);
+            Index m, n, k;
+            m = src_tile_traits.stride[axis];
+            n = src_tile_traits.matrix_shape[axis+1][1];
+            k = src_tile_traits.shape[axis];
+            // Insert task
+            starpu::bias_gelutanh::submit<T>(m, n, k, bias_tile_handle,
+                    src_tile_handle, dst_tile_handle);
+        }
+        // Flush cache for the output tiles on every node
+        src_tile_handle.mpi_flush();
+        dst_tile_handle.mpi_flush();
+    }
+}
+
+template<typename T>
+void bias_gelutanh(const Tensor<T> &bias, const Tensor<T> &src,
+        const Tensor<T> &dst, Index axis)
+{
+    bias_gelutanh_async<T>(bias, src, dst, axis);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void bias_gelutanh_async<fp32_t>(const Tensor<fp32_t> &bias,
+        const Tensor<fp32_t> &src, const Tensor<fp32_t> &dst, Index axis);
+
+template
+void bias_gelutanh_async<fp64_t>(const Tensor<fp64_t> &bias,
+        const Tensor<fp64_t> &src, const Tensor<fp64_t> &dst, Index axis);
+
+// Explicit instantiation
+template
+void bias_gelutanh<fp32_t>(const Tensor<fp32_t> &bias,
+        const Tensor<fp32_t> &src, const Tensor<fp32_t> &dst, Index axis);
+
+template
+void bias_gelutanh<fp64_t>(const Tensor<fp64_t> &bias,
+        const Tensor<fp64_t> &src, const Tensor<fp64_t> &dst, Index axis);
+
+} // namespace tensor
+} // namespace nntile
+
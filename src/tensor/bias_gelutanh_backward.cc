@@ -0,0 +1,136 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/bias_gelutanh_backward.cc
+ * Backward of bias addition followed by approximate GeLU of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#include "nntile/tensor/bias_gelutanh_backward.hh"
+#include "nntile/tensor/tree_reduction.hh"
+#include "nntile/tensor/bias_gelutanh.hh"
+#include "nntile/starpu/bias_gelutanh_backward.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Tensor-wise backward of bias addition followed by approximate GeLU
+/*! Gradient of input of the activation is stored into src_grad, that is also
+ * a gradient of input of bias addition, and it is summed along the axis into
+ * bias_grad in the same task. Tiles of src_grad shall be owned by the same
+ * nodes as the corresponding tiles of bias_grad.
+ *
+ * @param[in] src: Input of the activation, computed by the forward pass
+ * @param[in] dst_grad: Gradient of output of the activation
+ * @param[out] src_grad: Gradient of input of the activation
+ * @param[inout] bias_grad: Gradient of bias, that is accumulated
+ * @param[in] axis: Axis of src, along which the bias was applied
+ * @param[in] redux: Whether to use STARPU_REDUX for bias_grad
+ * */
+template<typename T>
+void bias_gelutanh_backward_async(const Tensor<T> &src,
+        const Tensor<T> &dst_grad, const Tensor<T> &src_grad,
+        const Tensor<T> &bias_grad, Index axis, int redux)
+{
+    // Check inputs (throw exception in case of an error)
+    bias_gelutanh_check(bias_grad, src, dst_grad, axis);
+    if(src.shape != src_grad.shape)
+    {
+        throw std::runtime_error("src.shape != src_grad.shape");
+    }
+    if(src.basetile_shape != src_grad.basetile_shape)
+    {
+        throw std::runtime_error("src.basetile_shape != "
+                "src_grad.basetile_shape");
+    }
+    // Do actual calculations
+    // Deterministic mode replaces STARPU_REDUX by a sequential chain
+    redux = redux_mode(redux, false);
+    int mpi_rank = starpu_mpi_world_rank();
+    std::vector<Index> src_tile_index;
+    for(Index i = 0; i < src.grid.nelems; ++i)
+    {
+        src.grid.linear_to_index(i, src_tile_index);
+        const auto &bias_grad_tile_handle = bias_grad.get_tile_handle(
+                src_tile_index[axis]);
+        int bias_grad_tile_rank = bias_grad_tile_handle.mpi_get_rank();
+        const auto &src_grad_tile_handle = src_grad.get_tile_handle(i);
+        // Gradients of input and bias are updated by the same task
+        if(src_grad_tile_handle.mpi_get_rank() != bias_grad_tile_rank)
+        {
+            throw std::runtime_error("Tiles of src_grad and bias_grad are "
+                    "owned by different nodes");
+        }
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_grad_tile_handle = dst_grad.get_tile_handle(i);
+        // Transfer data
+        src_tile_handle.mpi_transfer(bias_grad_tile_rank, mpi_rank);
+        dst_grad_tile_handle.mpi_transfer(bias_grad_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == bias_grad_tile_rank)
+        {
+            // Get sizes
+            const auto &src_tile_traits = src.get_tile_traits(i);
+            Index m, n, k;
+            m = src_tile_traits.stride[axis];
+            n = src_tile_traits.matrix_shape[axis+1][1];
+            k = src_tile_traits.shape[axis];
+            // Insert task
+            starpu::bias_gelutanh_backward::submit<T>(m, n, k,
+                    src_tile_handle, dst_grad_tile_handle,
+                    src_grad_tile_handle, bias_grad_tile_handle, redux);
+        }
+        // Flush cache for the output tile on every node
+        src_grad_tile_handle.mpi_flush();
+    }
+    // Flush cache for the accumulated outputs on every node
+    for(Index i = 0; i < bias_grad.grid.nelems; ++i)
+    {
+        bias_grad.get_tile_handle(i).mpi_flush();
+    }
+}
+
+template<typename T>
+void bias_gelutanh_backward(const Tensor<T> &src, const Tensor<T> &dst_grad,
+        const Tensor<T> &src_grad, const Tensor<T> &bias_grad, Index axis,
+        int redux)
+{
+    bias_gelutanh_backward_async<T>(src, dst_grad, src_grad, bias_grad, axis,
+            redux);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void bias_gelutanh_backward_async<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &dst_grad, const Tensor<fp32_t> &src_grad,
+        const Tensor<fp32_t> &bias_grad, Index axis, int redux);
+
+template
+void bias_gelutanh_backward_async<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &dst_grad, const Tensor<fp64_t> &src_grad,
+        const Tensor<fp64_t> &bias_grad, Index axis, int redux);
+
+// Explicit instantiation
+template
+void bias_gelutanh_backward<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &dst_grad, const Tensor<fp32_t> &src_grad,
+        const Tensor<fp32_t> &bias_grad, Index axis, int redux);
+
+template
+void bias_gelutanh_backward<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &dst_grad, const Tensor<fp64_t> &src_grad,
+        const Tensor<fp64_t> &bias_grad, Index axis, int redux);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,304 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/block_sparse.cc
+ * Operations on block-sparse tensors, that skip absent tiles
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/block_sparse.hh"
+#include "nntile/tensor/gemm.hh"
+#include "nntile/starpu/gemm.hh"
+#include "nntile/starpu/copy.hh"
+#include "nntile/starpu/clear.hh"
+#include "nntile/starpu/scal_inplace.hh"
+#include "nntile/starpu/submitters.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous copy of present tiles of block-sparse tensors
+/*! Present tiles of the destination tensor get values of the same tiles of
+ * the source tensor or zeros, if the source tile is absent. Values of tiles,
+ * that are absent in the destination tensor, are dropped. Any of tensors
+ * may be dense, so that it converts dense tensors into block-sparse ones
+ * and back, or changes the layout of a block-sparse tensor.
+ *
+ * @param[in] src: Source tensor
+ * @param[inout] dst: Destination tensor
+ * */
+template<typename T>
+void copy_block_sparse_async(const Tensor<T> &src, const Tensor<T> &dst)
+{
+    // Check shapes and tiles
+    if(src.shape != dst.shape)
+    {
+        throw std::runtime_error("src.shape != dst.shape");
+    }
+    if(src.basetile_shape != dst.basetile_shape)
+    {
+        throw std::runtime_error("src.basetile_shape != dst.basetile_shape");
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
+        if(dst_tile_handle.handle == nullptr)
+        {
+            continue;
+        }
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+        if(src_tile_handle.handle == nullptr)
+        {
+            if(mpi_rank == dst_tile_rank)
+            {
+                starpu::clear::submit(dst_tile_handle);
+            }
+        }
+        else
+        {
+            // Transfer source tile to dest node
+            src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+            // Execute on destination node
+            if(mpi_rank == dst_tile_rank)
+            {
+                starpu::copy::submit(src_tile_handle, dst_tile_handle);
+            }
+        }
+        // Flush cache for the output tile on every node
+        dst_tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking copy of present tiles of block-sparse tensors
+/*! See copy_block_sparse_async() for details.
+ *
+ * @param[in] src: Source tensor
+ * @param[inout] dst: Destination tensor
+ * */
+template<typename T>
+void copy_block_sparse(const Tensor<T> &src, const Tensor<T> &dst)
+{
+    copy_block_sparse_async<T>(src, dst);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+//! Asynchronous tensor-wise gemm, that skips absent tiles
+/*! Computes the same as gemm_async, where any of tensors may be a
+ * BlockSparseTensor. Products of tiles are submitted only for pairs of
+ * present tiles of A and B, so the number of tasks and FLOPs scale with
+ * density of the block-sparse operand, e.g., a pruned weight in a forward
+ * pass of a linear layer or in a backward pass over its input. Only present
+ * tiles of C are computed, so the gradient over a block-sparse weight keeps
+ * its layout. Present tiles of C without any products of present tiles are
+ * scaled by beta.
+ *
+ * @param[in] alpha: Alpha multiplier
+ * @param[in] transA: Transposition flag for the tensor A
+ * @param[in] A: Input tensor A
+ * @param[in] transB: Transposition flag for the tensor B
+ * @param[in] B: Input tensor B
+ * @param[in] beta: Beta multiplier
+ * @param[inout] C: Output tensor C
+ * @param[in] ndim: Number of dimensions used in gemm contraction
+ * @param[in] batch_ndim: Number of last dimensions used for batching of gemms
+ * @param[in] redux: Whether or not to use STARPU_REDUX
+ * */
+template<typename T>
+void gemm_block_sparse_async(T alpha, const TransOp &transA,
+        const Tensor<T> &A, const TransOp &transB, const Tensor<T> &B,
+        T beta, const Tensor<T> &C, Index ndim, Index batch_ndim, int redux)
+{
+    // Check inputs (throw exception in case of an error)
+    gemm_check(transA, A, transB, B, C, ndim, batch_ndim);
+    // Sizes of A, B and C as simple matrices (grids of tiles) for gemm
+    int mpi_rank = starpu_mpi_world_rank();
+    constexpr T zero = 0, one = 1;
+    Index m = C.grid.matrix_shape[A.ndim-batch_ndim-ndim][0];
+    Index batch = C.grid.matrix_shape[C.ndim-batch_ndim][1];
+    Index n = C.grid.matrix_shape[A.ndim-batch_ndim-ndim][1] / batch;
+    Index k;
+    std::array<Index, 2> opA_stride, opB_stride;
+    switch(transA.value)
+    {
+        case TransOp::NoTrans:
+            k = A.grid.matrix_shape[A.ndim-batch_ndim-ndim][1] / batch;
+            opA_stride = {1, m};
+            break;
+        case TransOp::Trans:
+            k = A.grid.matrix_shape[ndim][0];
+            opA_stride = {k, 1};
+            break;
+    }
+    switch(transB.value)
+    {
+        case TransOp::NoTrans:
+            opB_stride = {1, k};
+            break;
+        case TransOp::Trans:
+            opB_stride = {n, 1};
+            break;
+    }
+    // All the tasks of a tile of C are submitted by the same thread in order
+    auto submit_tile = [&](Index C_tile_offset)
+    {
+        const auto &C_tile_handle = C.get_tile_handle(C_tile_offset);
+        if(C_tile_handle.handle == nullptr)
+        {
+            return;
+        }
+        Index i = C_tile_offset % m;
+        Index j = C_tile_offset / m % n;
+        Index b = C_tile_offset / (m*n);
+        const auto &C_tile_traits = C.get_tile_traits(C_tile_offset);
+        int C_tile_rank = C_tile_handle.mpi_get_rank();
+        Index tile_m = C_tile_traits.matrix_shape[
+            A.ndim-batch_ndim-ndim][0];
+        Index tile_batch = C_tile_traits.matrix_shape[
+            C.ndim-batch_ndim][1];
+        Index tile_n = C_tile_traits.matrix_shape[
+            A.ndim-batch_ndim-ndim][1] / tile_batch;
+        Index A_tile_offset = opA_stride[0]*i + b*m*k;
+        Index B_tile_offset = opB_stride[1]*j + b*n*k;
+        // C(i,j,b) = a*opA(i,l,b)*opB(l,j,b) + b*C(i,j,b) for the first
+        // pair of present tiles and C(i,j,b) += a*opA(i,l,b)*opB(l,j,b) for
+        // the others
+        bool first = true;
+        for(Index l = 0; l < k; ++l, A_tile_offset += opA_stride[1],
+                B_tile_offset += opB_stride[0])
+        {
+            const auto &A_tile_handle = A.get_tile_handle(A_tile_offset);
+            const auto &B_tile_handle = B.get_tile_handle(B_tile_offset);
+            if(A_tile_handle.handle == nullptr
+                    or B_tile_handle.handle == nullptr)
+            {
+                continue;
+            }
+            // Transfer tiles A and B on node with tile C
+            A_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+            B_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+            // Execute on node with tile C
+            if(mpi_rank == C_tile_rank)
+            {
+                Index tile_k;
+                const auto &A_tile_traits = A.get_tile_traits(A_tile_offset);
+                switch(transA.value)
+                {
+                    case TransOp::NoTrans:
+                        tile_k = A_tile_traits.matrix_shape[
+                            A.ndim-batch_ndim-ndim][1] / tile_batch;
+                        break;
+                        // This parameter was already checked
+                        //case TransOp::Trans:
+                    default:
+                        tile_k = A_tile_traits.matrix_shape[ndim][0];
+                        break;
+                }
+                starpu::gemm::submit<T, T>(transA, transB, tile_m, tile_n,
+                        tile_k, tile_batch, alpha, A_tile_handle,
+                        B_tile_handle, first ? beta : one, C_tile_handle,
+                        redux);
+            }
+            first = false;
+        }
+        // Tile of C without products is only scaled
+        if(first and mpi_rank == C_tile_rank)
+        {
+            if(beta == zero)
+            {
+                starpu::clear::submit(C_tile_handle);
+            }
+            else if(beta != one)
+            {
+                starpu::scal_inplace::submit<T>(beta, C_tile_traits.nelems,
+                        C_tile_handle);
+            }
+        }
+        // Flush cache for the output tile on every node
+        C_tile_handle.mpi_flush();
+    };
+    starpu::submitters::parallel_for(C.grid.nelems, submit_tile);
+}
+
+//! Blocking version of tensor-wise gemm, that skips absent tiles
+/*! See gemm_block_sparse_async() for details.
+ *
+ * @param[in] alpha: Alpha multiplier
+ * @param[in] transA: Transposition flag for the tensor A
+ * @param[in] A: Input tensor A
+ * @param[in] transB: Transposition flag for the tensor B
+ * @param[in] B: Input tensor B
+ * @param[in] beta: Beta multiplier
+ * @param[inout] C: Output tensor C
+ * @param[in] ndim: Number of dimensions used in gemm contraction
+ * @param[in] batch_ndim: Number of last dimensions used for batching of gemms
+ * @param[in] redux: Whether or not to use STARPU_REDUX
+ * */
+template<typename T>
+void gemm_block_sparse(T alpha, const TransOp &transA, const Tensor<T> &A,
+        const TransOp &transB, const Tensor<T> &B, T beta,
+        const Tensor<T> &C, Index ndim, Index batch_ndim, int redux)
+{
+    gemm_block_sparse_async<T>(alpha, transA, A, transB, B, beta, C, ndim,
+            batch_ndim, redux);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void copy_block_sparse_async<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &dst);
+
+template
+void copy_block_sparse_async<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &dst);
+
+// Explicit instantiation
+template
+void copy_block_sparse<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &dst);
+
+template
+void copy_block_sparse<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &dst);
+
+// Explicit instantiation
+template
+void gemm_block_sparse_async<fp32_t>(fp32_t alpha, const TransOp &transA,
+        const Tensor<fp32_t> &A, const TransOp &transB,
+        const Tensor<fp32_t> &B, fp32_t beta, const Tensor<fp32_t> &C,
+        Index ndim, Index batch_ndim, int redux);
+
+template
+void gemm_block_sparse_async<fp64_t>(fp64_t alpha, const TransOp &transA,
+        const Tensor<fp64_t> &A, const TransOp &transB,
+        const Tensor<fp64_t> &B, fp64_t beta, const Tensor<fp64_t> &C,
+        Index ndim, Index batch_ndim, int redux);
+
+// Explicit instantiation
+template
+void gemm_block_sparse<fp32_t>(fp32_t alpha, const TransOp &transA,
+        const Tensor<fp32_t> &A, const TransOp &transB,
+        const Tensor<fp32_t> &B, fp32_t beta, const Tensor<fp32_t> &C,
+        Index ndim, Index batch_ndim, int redux);
+
+template
+void gemm_block_sparse<fp64_t>(fp64_t alpha, const TransOp &transA,
+        const Tensor<fp64_t> &A, const TransOp &transB,
+        const Tensor<fp64_t> &B, fp64_t beta, const Tensor<fp64_t> &C,
+        Index ndim, Index batch_ndim, int redux);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -26,7 +26,7 @@ void clear_async(const Tensor<T> &dst)
     int mpi_rank = starpu_mpi_world_rank();
     for(Index i = 0; i < dst.grid.nelems; ++i)
     {
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         if(mpi_rank == dst_tile_rank)
         {
@@ -55,6 +55,12 @@ void clear_async<fp64_t>(const Tensor<fp64_t> &dst);
 template
 void clear_async<fp16_t>(const Tensor<fp16_t> &dst);
 
+template
+void clear_async<bf16_t>(const Tensor<bf16_t> &dst);
+
+template
+void clear_async<bool_t>(const Tensor<bool_t> &dst);
+
 // Explicit instantiation
 template
 void clear<fp32_t>(const Tensor<fp32_t> &dst);
@@ -65,6 +71,12 @@ void clear<fp64_t>(const Tensor<fp64_t> &dst);
 template
 void clear<fp16_t>(const Tensor<fp16_t> &dst);
 
+template
+void clear<bf16_t>(const Tensor<bf16_t> &dst);
+
+template
+void clear<bool_t>(const Tensor<bool_t> &dst);
+
 } // namespace tensor
 } // namespace nntile
 
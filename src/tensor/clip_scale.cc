@@ -0,0 +1,103 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/clip_scale.cc
+ * Learning rate and scale of gradients for clipping for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/clip_scale.hh"
+#include "nntile/starpu/clip_scale.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous learning rate and scale of gradients for clipping
+/*! Writes lr and min(1, max_norm/(norm+1e-6)) into a tensor of two
+ * elements, that is read by multi_adam_step_scaled_async(). Neither the
+ * norm nor the result is read back to the host, so the learning rate of
+ * every step is only an argument of a task.
+ *
+ * @param[in] lr: Learning rate of the current step
+ * @param[in] max_norm: Maximal global norm of gradients, non-positive value
+ *      disables clipping
+ * @param[in] norm: Scalar tensor with the global norm of gradients, e.g.,
+ *      computed by global_nrm2_async()
+ * @param[out] scalars: Single-tile tensor of shape [2]
+ * */
+template<typename T>
+void clip_scale_async(T lr, T max_norm, const Tensor<T> &norm,
+        const Tensor<T> &scalars)
+{
+    // Check dimensions
+    if(norm.ndim != 0)
+    {
+        throw std::runtime_error("norm.ndim != 0");
+    }
+    if(scalars.ndim != 1)
+    {
+        throw std::runtime_error("scalars.ndim != 1");
+    }
+    if(scalars.shape[0] != 2)
+    {
+        throw std::runtime_error("scalars.shape[0] != 2");
+    }
+    if(scalars.basetile_shape[0] != 2)
+    {
+        throw std::runtime_error("scalars.basetile_shape[0] != 2");
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    const auto &norm_tile_handle = norm.get_tile_handle(0);
+    const auto &scalars_tile_handle = scalars.get_tile_handle(0);
+    int scalars_tile_rank = scalars_tile_handle.mpi_get_rank();
+    // Transfer data
+    norm_tile_handle.mpi_transfer(scalars_tile_rank, mpi_rank);
+    // Execute only on destination node
+    if(mpi_rank == scalars_tile_rank)
+    {
+        starpu::clip_scale::submit<T>(lr, max_norm, norm_tile_handle,
+                scalars_tile_handle);
+    }
+    // Flush cache for the output tile on every node
+    scalars_tile_handle.mpi_flush();
+}
+
+//! Blocking version of learning rate and scale of gradients for clipping
+template<typename T>
+void clip_scale(T lr, T max_norm, const Tensor<T> &norm,
+        const Tensor<T> &scalars)
+{
+    clip_scale_async<T>(lr, max_norm, norm, scalars);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void clip_scale_async<fp32_t>(fp32_t lr, fp32_t max_norm,
+        const Tensor<fp32_t> &norm, const Tensor<fp32_t> &scalars);
+
+template
+void clip_scale_async<fp64_t>(fp64_t lr, fp64_t max_norm,
+        const Tensor<fp64_t> &norm, const Tensor<fp64_t> &scalars);
+
+// Explicit instantiation
+template
+void clip_scale<fp32_t>(fp32_t lr, fp32_t max_norm,
+        const Tensor<fp32_t> &norm, const Tensor<fp32_t> &scalars);
+
+template
+void clip_scale<fp64_t>(fp64_t lr, fp64_t max_norm,
+        const Tensor<fp64_t> &norm, const Tensor<fp64_t> &scalars);
+
+} // namespace tensor
+} // namespace nntile
+
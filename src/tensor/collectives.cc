@@ -0,0 +1,378 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/collectives.cc
+ * Hierarchical collective operations over replicas of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/collectives.hh"
+#include "nntile/starpu/add.hh"
+#include "nntile/starpu/copy.hh"
+#include <stdexcept>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Check if all the tensors are of the same shape and basetile
+template<typename T>
+static void collective_check(const std::vector<Tensor<T>> &tensors)
+{
+    if(tensors.empty())
+    {
+        throw std::runtime_error("tensors.size() == 0");
+    }
+    for(const auto &t: tensors)
+    {
+        if(t.shape != tensors[0].shape)
+        {
+            throw std::runtime_error("tensors[i].shape != tensors[0].shape");
+        }
+        if(t.basetile_shape != tensors[0].basetile_shape)
+        {
+            throw std::runtime_error("tensors[i].basetile_shape != "
+                    "tensors[0].basetile_shape");
+        }
+    }
+}
+
+//! Split copies of a tile into groups by nodes of their ranks
+/*! Groups are ordered by the first appearance of their nodes and copies
+ * within a group keep their order, so the first copy leads the first group.
+ * Ranks are placed onto nodes by consecutive blocks of ranks_per_node ranks
+ * (the default placement of mpirun), and zero places all the ranks onto a
+ * single node, i.e., disables hierarchy.
+ * */
+static std::vector<std::vector<starpu::Handle>> collective_groups(
+        const std::vector<starpu::Handle> &handles, Index ranks_per_node)
+{
+    std::vector<std::vector<starpu::Handle>> groups;
+    std::vector<int> nodes;
+    for(const auto &h: handles)
+    {
+        int node = 0;
+        if(ranks_per_node > 0)
+        {
+            node = h.mpi_get_rank() / ranks_per_node;
+        }
+        Index g = 0;
+        while(g < nodes.size() and nodes[g] != node)
+        {
+            ++g;
+        }
+        if(g == nodes.size())
+        {
+            nodes.push_back(node);
+            groups.emplace_back();
+        }
+        groups[g].push_back(h);
+    }
+    return groups;
+}
+
+//! Leaders of groups of copies of a tile
+static std::vector<starpu::Handle> collective_leaders(
+        const std::vector<std::vector<starpu::Handle>> &groups)
+{
+    std::vector<starpu::Handle> leaders;
+    for(const auto &g: groups)
+    {
+        leaders.push_back(g[0]);
+    }
+    return leaders;
+}
+
+//! Binary tree sum of copies of a tile into the first one
+template<typename T>
+static void tree_reduce(const std::vector<starpu::Handle> &handles,
+        Index nelems)
+{
+    int mpi_rank = starpu_mpi_world_rank();
+    Index n = handles.size();
+    for(Index step = 1; step < n; step *= 2)
+    {
+        for(Index i = 0; i+step < n; i += 2*step)
+        {
+            const auto &src = handles[i+step], &dst = handles[i];
+            int dst_rank = dst.mpi_get_rank();
+            src.mpi_transfer(dst_rank, mpi_rank);
+            if(mpi_rank == dst_rank)
+            {
+                starpu::add::submit<T>(nelems, T(1), src, T(1), dst);
+            }
+            src.mpi_flush();
+        }
+    }
+}
+
+//! Binary tree copy of the first copy of a tile into the other ones
+static void tree_broadcast(const std::vector<starpu::Handle> &handles)
+{
+    int mpi_rank = starpu_mpi_world_rank();
+    Index n = handles.size(), step = 1;
+    while(step < n)
+    {
+        step *= 2;
+    }
+    while(step > 1)
+    {
+        step /= 2;
+        for(Index i = 0; i+step < n; i += 2*step)
+        {
+            const auto &src = handles[i], &dst = handles[i+step];
+            int dst_rank = dst.mpi_get_rank();
+            src.mpi_transfer(dst_rank, mpi_rank);
+            if(mpi_rank == dst_rank)
+            {
+                starpu::copy::submit(src, dst);
+            }
+            dst.mpi_flush();
+        }
+    }
+}
+
+//! Copies of the same tile of all the tensors
+template<typename T>
+static std::vector<starpu::Handle> collective_tile(
+        const std::vector<Tensor<T>> &tensors, Index i)
+{
+    std::vector<starpu::Handle> handles;
+    for(const auto &t: tensors)
+    {
+        handles.push_back(t.get_tile_handle(i));
+    }
+    return handles;
+}
+
+//! Hierarchical broadcast of the first copy of a tile
+static void hierarchical_broadcast(const std::vector<starpu::Handle> &handles,
+        Index ranks_per_node)
+{
+    auto groups = collective_groups(handles, ranks_per_node);
+    // Only leaders of nodes receive the tile through the network
+    tree_broadcast(collective_leaders(groups));
+    for(const auto &g: groups)
+    {
+        tree_broadcast(g);
+    }
+}
+
+//! Hierarchical sum of all copies of a tile into the first one
+template<typename T>
+static void hierarchical_reduce(const std::vector<starpu::Handle> &handles,
+        Index nelems, Index ranks_per_node)
+{
+    auto groups = collective_groups(handles, ranks_per_node);
+    // Copies are summed within nodes, and only their sums are sent through
+    // the network
+    for(const auto &g: groups)
+    {
+        tree_reduce<T>(g, nelems);
+    }
+    tree_reduce<T>(collective_leaders(groups), nelems);
+}
+
+//! Asynchronous broadcast of the first tensor into the other ones
+/*! Every tile is sent by a binary tree over leaders of nodes (the first
+ * tensors of every node in the given order), and then by binary trees
+ * within nodes. So a tile crosses the network only once per node, while
+ * transfers between ranks of a node go through shared memory or between
+ * devices by StarPU-MPI. Tiles of different tensors are usually placed on
+ * their own ranks, e.g., replicas of data-parallel training.
+ *
+ * @param[inout] tensors: The first tensor is the source, the other ones
+ *      are overwritten
+ * @param[in] ranks_per_node: Number of consecutive MPI ranks on every node.
+ *      Zero disables hierarchy.
+ * */
+template<typename T>
+void broadcast_async(const std::vector<Tensor<T>> &tensors,
+        Index ranks_per_node)
+{
+    collective_check(tensors);
+    for(Index i = 0; i < tensors[0].grid.nelems; ++i)
+    {
+        hierarchical_broadcast(collective_tile(tensors, i), ranks_per_node);
+    }
+}
+
+//! Blocking broadcast of the first tensor into the other ones
+template<typename T>
+void broadcast(const std::vector<Tensor<T>> &tensors, Index ranks_per_node)
+{
+    broadcast_async<T>(tensors, ranks_per_node);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+//! Asynchronous sum of all the tensors into the first one
+/*! Every tile is summed by binary trees within nodes, and then sums of
+ * nodes are summed by a binary tree over their leaders (see
+ * broadcast_async). Values of all the tensors except the first one are
+ * destroyed.
+ *
+ * @param[inout] tensors: The first tensor gets the sum of all the tensors
+ * @param[in] ranks_per_node: Number of consecutive MPI ranks on every node.
+ *      Zero disables hierarchy.
+ * */
+template<typename T>
+void reduce_async(const std::vector<Tensor<T>> &tensors,
+        Index ranks_per_node)
+{
+    collective_check(tensors);
+    for(Index i = 0; i < tensors[0].grid.nelems; ++i)
+    {
+        auto handles = collective_tile(tensors, i);
+        hierarchical_reduce<T>(handles, tensors[0].get_tile_traits(i).nelems,
+                ranks_per_node);
+        handles[0].mpi_flush();
+    }
+}
+
+//! Blocking sum of all the tensors into the first one
+template<typename T>
+void reduce(const std::vector<Tensor<T>> &tensors, Index ranks_per_node)
+{
+    reduce_async<T>(tensors, ranks_per_node);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+//! Asynchronous sum of all the tensors into all of them
+/*! Hierarchical reduce, followed by hierarchical broadcast of every tile
+ * (see reduce_async and broadcast_async). Tiles are processed one by one,
+ * so that the broadcast of a tile overlaps with the reduction of the next
+ * tiles.
+ *
+ * @param[inout] tensors: All the tensors get their sum
+ * @param[in] ranks_per_node: Number of consecutive MPI ranks on every node.
+ *      Zero disables hierarchy.
+ * */
+template<typename T>
+void allreduce_async(const std::vector<Tensor<T>> &tensors,
+        Index ranks_per_node)
+{
+    collective_check(tensors);
+    for(Index i = 0; i < tensors[0].grid.nelems; ++i)
+    {
+        auto handles = collective_tile(tensors, i);
+        hierarchical_reduce<T>(handles, tensors[0].get_tile_traits(i).nelems,
+                ranks_per_node);
+        hierarchical_broadcast(handles, ranks_per_node);
+    }
+}
+
+//! Blocking sum of all the tensors into all of them
+template<typename T>
+void allreduce(const std::vector<Tensor<T>> &tensors, Index ranks_per_node)
+{
+    allreduce_async<T>(tensors, ranks_per_node);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+//! Asynchronous copy of a distributed tensor into all the replicas
+/*! Every tile of the source is broadcast from its rank into the same tile
+ * of all the replicas (see broadcast_async), e.g., to gather a sharded
+ * tensor on every rank of tensor-parallel layers.
+ *
+ * @param[in] src: Source tensor, distributed over any ranks
+ * @param[inout] dst: Replicas of the same shape and basetile as src
+ * @param[in] ranks_per_node: Number of consecutive MPI ranks on every node.
+ *      Zero disables hierarchy.
+ * */
+template<typename T>
+void allgather_async(const Tensor<T> &src, const std::vector<Tensor<T>> &dst,
+        Index ranks_per_node)
+{
+    std::vector<Tensor<T>> tensors{src};
+    tensors.insert(tensors.end(), dst.begin(), dst.end());
+    broadcast_async<T>(tensors, ranks_per_node);
+}
+
+//! Blocking copy of a distributed tensor into all the replicas
+template<typename T>
+void allgather(const Tensor<T> &src, const std::vector<Tensor<T>> &dst,
+        Index ranks_per_node)
+{
+    allgather_async<T>(src, dst, ranks_per_node);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void broadcast_async<fp32_t>(const std::vector<Tensor<fp32_t>> &tensors,
+        Index ranks_per_node);
+
+template
+void broadcast_async<fp64_t>(const std::vector<Tensor<fp64_t>> &tensors,
+        Index ranks_per_node);
+
+template
+void broadcast<fp32_t>(const std::vector<Tensor<fp32_t>> &tensors,
+        Index ranks_per_node);
+
+template
+void broadcast<fp64_t>(const std::vector<Tensor<fp64_t>> &tensors,
+        Index ranks_per_node);
+
+template
+void reduce_async<fp32_t>(const std::vector<Tensor<fp32_t>> &tensors,
+        Index ranks_per_node);
+
+template
+void reduce_async<fp64_t>(const std::vector<Tensor<fp64_t>> &tensors,
+        Index ranks_per_node);
+
+template
+void reduce<fp32_t>(const std::vector<Tensor<fp32_t>> &tensors,
+        Index ranks_per_node);
+
+template
+void reduce<fp64_t>(const std::vector<Tensor<fp64_t>> &tensors,
+        Index ranks_per_node);
+
+template
+void allreduce_async<fp32_t>(const std::vector<Tensor<fp32_t>> &tensors,
+        Index ranks_per_node);
+
+template
+void allreduce_async<fp64_t>(const std::vector<Tensor<fp64_t>> &tensors,
+        Index ranks_per_node);
+
+template
+void allreduce<fp32_t>(const std::vector<Tensor<fp32_t>> &tensors,
+        Index ranks_per_node);
+
+template
+void allreduce<fp64_t>(const std::vector<Tensor<fp64_t>> &tensors,
+        Index ranks_per_node);
+
+template
+void allgather_async<fp32_t>(const Tensor<fp32_t> &src,
+        const std::vector<Tensor<fp32_t>> &dst, Index ranks_per_node);
+
+template
+void allgather_async<fp64_t>(const Tensor<fp64_t> &src,
+        const std::vector<Tensor<fp64_t>> &dst, Index ranks_per_node);
+
+template
+void allgather<fp32_t>(const Tensor<fp32_t> &src,
+        const std::vector<Tensor<fp32_t>> &dst, Index ranks_per_node);
+
+template
+void allgather<fp64_t>(const Tensor<fp64_t> &src,
+        const std::vector<Tensor<fp64_t>> &dst, Index ranks_per_node);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,476 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/contract.cc
+ * Contraction of two tensors, described by einsum-like subscripts
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/contract.hh"
+#include "nntile/tensor/permute.hh"
+#include "nntile/tensor/gemm.hh"
+#include <cctype>
+#include <memory>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Masks of tensors, where a mode appears
+constexpr int in_A = 1, in_B = 2, in_C = 4;
+
+//! Get subscripts of a single tensor and check them
+static std::string contract_subscripts(const std::string &subscripts,
+        std::size_t begin, std::size_t end, const TensorTraits &X)
+{
+    std::string x = subscripts.substr(begin, end-begin);
+    if(x.size() != X.ndim)
+    {
+        throw std::runtime_error("Number of subscripts of a tensor differs "
+                "from its number of dimensions");
+    }
+    for(std::size_t i = 0; i < x.size(); ++i)
+    {
+        if(not std::isalpha(static_cast<unsigned char>(x[i])))
+        {
+            throw std::runtime_error("Subscripts shall be letters");
+        }
+        if(x.find(x[i]) != i)
+        {
+            throw std::runtime_error("Subscripts of a tensor shall not "
+                    "repeat");
+        }
+    }
+    return x;
+}
+
+//! Subsequence of labels, that appear in given tensors
+static std::string contract_select(const std::string &labels,
+        const std::vector<int> &where, int mask)
+{
+    std::string result;
+    for(char l: labels)
+    {
+        if(where[l] == mask)
+        {
+            result += l;
+        }
+    }
+    return result;
+}
+
+//! Check if labels consist of blocks [group1, group2, batch]
+/*! Modes of a group are those, that appear in tensors with a given mask.
+ * Orders of modes of the blocks are returned on success.
+ * */
+static bool contract_split(const std::string &labels,
+        const std::vector<int> &where, int mask1, int mask2,
+        std::string &order1, std::string &order2, std::string &order_batch)
+{
+    order1.clear();
+    order2.clear();
+    order_batch.clear();
+    int block = 0;
+    for(char l: labels)
+    {
+        int mask = where[l];
+        if(mask == mask1 and block == 0)
+        {
+            order1 += l;
+        }
+        else if(mask == mask2 and block <= 1)
+        {
+            block = 1;
+            order2 += l;
+        }
+        else if(mask == (in_A | in_B | in_C))
+        {
+            block = 2;
+            order_batch += l;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//! Axes of labels in the order of a layout
+static std::vector<Index> contract_perm(const std::string &labels,
+        const std::string &layout)
+{
+    std::vector<Index> perm(layout.size());
+    for(std::size_t i = 0; i < layout.size(); ++i)
+    {
+        perm[i] = labels.find(layout[i]);
+    }
+    return perm;
+}
+
+//! Plan a contraction with the least amount of permuted data
+/*! Subscripts are given as "ik,kj->ij": the first and the second groups of
+ * letters label axes of A and B, and letters after the arrow label axes of
+ * C. Modes of both A and B, that are absent in C, are contracted, modes of
+ * all three tensors are batch ones, and other modes of C come from either A
+ * or B. A mode shall appear in at least two tensors, and a mode shall have
+ * the same shape and base tile in all tensors.
+ *
+ * All ways to map the contraction onto gemm are tried: either A or B is the
+ * first operand, each operand is either transposed or not, or is permuted
+ * into a temporary tensor. Tensors, that are kept, define orders of modes
+ * within groups, and the plan that permutes the least number of elements is
+ * returned. If C is permuted, its result is permuted back into C, and the
+ * initial value of C is permuted as well if read_C is true.
+ *
+ * @param[in] subscripts: Labels of axes of A, B and C
+ * @param[in] A: Traits of the first input tensor
+ * @param[in] B: Traits of the second input tensor
+ * @param[in] C: Traits of the output tensor
+ * @param[in] read_C: Whether initial value of C is used, i.e. beta != 0
+ * */
+ContractPlan contract_plan(const std::string &subscripts,
+        const TensorTraits &A, const TensorTraits &B, const TensorTraits &C,
+        bool read_C)
+{
+    // Parse subscripts
+    std::size_t comma = subscripts.find(','),
+        arrow = subscripts.find("->");
+    if(comma == std::string::npos or arrow == std::string::npos
+            or arrow < comma)
+    {
+        throw std::runtime_error("Subscripts shall be of the form "
+                "\"ik,kj->ij\"");
+    }
+    std::string a = contract_subscripts(subscripts, 0, comma, A),
+        b = contract_subscripts(subscripts, comma+1, arrow, B),
+        c = contract_subscripts(subscripts, arrow+2, subscripts.size(), C);
+    // Find tensors of modes and check their shapes
+    std::vector<int> where(128, 0);
+    std::vector<Index> shape(128), basetile(128);
+    const std::string *labels[3] = {&a, &b, &c};
+    const TensorTraits *traits[3] = {&A, &B, &C};
+    for(int t = 0; t < 3; ++t)
+    {
+        for(Index i = 0; i < traits[t]->ndim; ++i)
+        {
+            char l = (*labels[t])[i];
+            if(where[l] == 0)
+            {
+                shape[l] = traits[t]->shape[i];
+                basetile[l] = traits[t]->basetile_shape[i];
+            }
+            else if(shape[l] != traits[t]->shape[i]
+                    or basetile[l] != traits[t]->basetile_shape[i])
+            {
+                throw std::runtime_error("Shapes or base tiles of the same "
+                        "mode differ");
+            }
+            where[l] |= 1 << t;
+        }
+    }
+    for(const auto &x: labels)
+    {
+        for(char l: *x)
+        {
+            if(where[l] == in_A or where[l] == in_B or where[l] == in_C)
+            {
+                throw std::runtime_error("A mode shall appear in at least "
+                        "two tensors");
+            }
+        }
+    }
+    ContractPlan best;
+    Index best_cost = -1;
+    for(int swap = 0; swap < 2; ++swap)
+    {
+        // Operands of gemm and masks of their modes
+        const std::string &x = swap ? b : a, &y = swap ? a : b;
+        Index x_nelems = swap ? B.nelems : A.nelems,
+              y_nelems = swap ? A.nelems : B.nelems;
+        int mask_m = (swap ? in_B : in_A) | in_C,
+            mask_n = (swap ? in_A : in_B) | in_C,
+            mask_k = in_A | in_B, mask_batch = in_A | in_B | in_C;
+        // Every operand is used as is (0), transposed (1) or permuted (-1)
+        for(int keep_x: {0, 1, -1})
+        {
+            for(int keep_y: {0, 1, -1})
+            {
+                for(int keep_c: {0, -1})
+                {
+                    // Orders of modes M, N, K and batch ones
+                    std::string order[4], o1, o2, ob;
+                    bool fixed[4] = {false, false, false, false}, ok = true;
+                    auto unify = [&](int group, const std::string &value)
+                    {
+                        if(fixed[group] and order[group] != value)
+                        {
+                            ok = false;
+                        }
+                        order[group] = value;
+                        fixed[group] = true;
+                    };
+                    if(keep_x == 0 and contract_split(x, where, mask_m,
+                                mask_k, o1, o2, ob))
+                    {
+                        unify(0, o1);
+                        unify(2, o2);
+                        unify(3, ob);
+                    }
+                    else if(keep_x == 1 and contract_split(x, where, mask_k,
+                                mask_m, o1, o2, ob))
+                    {
+                        unify(2, o1);
+                        unify(0, o2);
+                        unify(3, ob);
+                    }
+                    else if(keep_x != -1)
+                    {
+                        continue;
+                    }
+                    if(keep_y == 0 and contract_split(y, where, mask_k,
+                                mask_n, o1, o2, ob))
+                    {
+                        unify(2, o1);
+                        unify(1, o2);
+                        unify(3, ob);
+                    }
+                    else if(keep_y == 1 and contract_split(y, where, mask_n,
+                                mask_k, o1, o2, ob))
+                    {
+                        unify(1, o1);
+                        unify(2, o2);
+                        unify(3, ob);
+                    }
+                    else if(keep_y != -1)
+                    {
+                        continue;
+                    }
+                    if(keep_c == 0 and contract_split(c, where, mask_m,
+                                mask_n, o1, o2, ob))
+                    {
+                        unify(0, o1);
+                        unify(1, o2);
+                        unify(3, ob);
+                    }
+                    else if(keep_c != -1)
+                    {
+                        continue;
+                    }
+                    if(not ok)
+                    {
+                        continue;
+                    }
+                    Index cost = 0;
+                    if(keep_x == -1)
+                    {
+                        cost += x_nelems;
+                    }
+                    if(keep_y == -1)
+                    {
+                        cost += y_nelems;
+                    }
+                    if(keep_c == -1)
+                    {
+                        cost += read_C ? 2*C.nelems : C.nelems;
+                    }
+                    if(best_cost >= 0 and cost >= best_cost)
+                    {
+                        continue;
+                    }
+                    // Orders, that are not fixed by kept tensors
+                    if(not fixed[0])
+                    {
+                        order[0] = contract_select(x, where, mask_m);
+                    }
+                    if(not fixed[1])
+                    {
+                        order[1] = contract_select(y, where, mask_n);
+                    }
+                    if(not fixed[2])
+                    {
+                        order[2] = contract_select(x, where, mask_k);
+                    }
+                    if(not fixed[3])
+                    {
+                        order[3] = contract_select(x, where, mask_batch);
+                    }
+                    best_cost = cost;
+                    best.swap = swap;
+                    best.trans_first = TransOp(keep_x == 1 ? TransOp::Trans
+                            : TransOp::NoTrans);
+                    best.trans_second = TransOp(keep_y == 1 ? TransOp::Trans
+                            : TransOp::NoTrans);
+                    best.ndim = order[2].size();
+                    best.batch_ndim = order[3].size();
+                    std::vector<Index> perm_x, perm_y;
+                    if(keep_x == -1)
+                    {
+                        perm_x = contract_perm(x, order[0]+order[2]+order[3]);
+                    }
+                    if(keep_y == -1)
+                    {
+                        perm_y = contract_perm(y, order[2]+order[1]+order[3]);
+                    }
+                    best.perm_A = swap ? perm_y : perm_x;
+                    best.perm_B = swap ? perm_x : perm_y;
+                    best.perm_C.clear();
+                    if(keep_c == -1)
+                    {
+                        best.perm_C = contract_perm(c,
+                                order[0]+order[1]+order[3]);
+                    }
+                    best.nelems_moved = cost;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+//! Temporary tensor with permuted axes of a given tensor
+/*! Tiles of the temporary tensor are owned by owners of the corresponding
+ * tiles of the given tensor, so that a permutation does not communicate.
+ * */
+template<typename T>
+static std::unique_ptr<Tensor<T>> contract_tmp(const Tensor<T> &src,
+        const std::vector<Index> &perm, starpu_mpi_tag_t &last_tag)
+{
+    std::vector<Index> shape(src.ndim), basetile(src.ndim),
+        src_tile_index(src.ndim);
+    for(Index i = 0; i < src.ndim; ++i)
+    {
+        shape[i] = src.shape[perm[i]];
+        basetile[i] = src.basetile_shape[perm[i]];
+    }
+    TensorTraits traits(shape, basetile);
+    std::vector<int> distr(traits.grid.nelems);
+    for(Index i = 0; i < traits.grid.nelems; ++i)
+    {
+        auto tile_index = traits.grid.linear_to_index(i);
+        for(Index j = 0; j < src.ndim; ++j)
+        {
+            src_tile_index[perm[j]] = tile_index[j];
+        }
+        distr[i] = src.tile_distr[src.grid.index_to_linear(src_tile_index)];
+    }
+    return std::make_unique<Tensor<T>>(traits, distr, last_tag);
+}
+
+//! Asynchronous contraction C = alpha*contract(A,B) + beta*C
+/*! The contraction is mapped onto a single gemm by contract_plan(), and
+ * operands, that do not fit layouts of gemm, are permuted into temporary
+ * tensors, which take tags starting from last_tag. Temporary tensors are
+ * unregistered as soon as tasks on them are completed.
+ *
+ * @param[in] alpha: Scalar factor of the contraction
+ * @param[in] A: The first input tensor
+ * @param[in] B: The second input tensor
+ * @param[in] beta: Scalar factor of C
+ * @param[inout] C: Output tensor
+ * @param[in] subscripts: Labels of axes of A, B and C (see contract_plan)
+ * @param[inout] last_tag: The first tag for temporary tensors on input, and
+ *      the next free tag on output
+ * @param[in] redux: Whether the gemm uses STARPU_REDUX for C
+ * */
+template<typename T>
+void contract_async(T alpha, const Tensor<T> &A, const Tensor<T> &B, T beta,
+        const Tensor<T> &C, const std::string &subscripts,
+        starpu_mpi_tag_t &last_tag, int redux)
+{
+    auto plan = contract_plan(subscripts, A, B, C, beta != T(0));
+    std::unique_ptr<Tensor<T>> A_tmp, B_tmp, C_tmp;
+    const Tensor<T> *A_gemm = &A, *B_gemm = &B, *C_gemm = &C;
+    if(not plan.perm_A.empty())
+    {
+        A_tmp = contract_tmp(A, plan.perm_A, last_tag);
+        permute_async<T>(A, *A_tmp, plan.perm_A);
+        A_gemm = A_tmp.get();
+    }
+    if(not plan.perm_B.empty())
+    {
+        B_tmp = contract_tmp(B, plan.perm_B, last_tag);
+        permute_async<T>(B, *B_tmp, plan.perm_B);
+        B_gemm = B_tmp.get();
+    }
+    if(not plan.perm_C.empty())
+    {
+        C_tmp = contract_tmp(C, plan.perm_C, last_tag);
+        if(beta != T(0))
+        {
+            permute_async<T>(C, *C_tmp, plan.perm_C);
+        }
+        C_gemm = C_tmp.get();
+    }
+    const Tensor<T> &first = plan.swap ? *B_gemm : *A_gemm,
+          &second = plan.swap ? *A_gemm : *B_gemm;
+    gemm_async<T, T>(alpha, plan.trans_first, first, plan.trans_second,
+            second, beta, *C_gemm, plan.ndim, plan.batch_ndim, redux);
+    if(C_tmp)
+    {
+        // Inverse permutation puts the result back into axes of C
+        std::vector<Index> perm_inv(C.ndim);
+        for(Index i = 0; i < C.ndim; ++i)
+        {
+            perm_inv[plan.perm_C[i]] = i;
+        }
+        permute_async<T>(*C_tmp, C, perm_inv);
+        C_tmp->unregister_submit();
+    }
+    if(A_tmp)
+    {
+        A_tmp->unregister_submit();
+    }
+    if(B_tmp)
+    {
+        B_tmp->unregister_submit();
+    }
+}
+
+//! Blocking version of contraction C = alpha*contract(A,B) + beta*C
+template<typename T>
+void contract(T alpha, const Tensor<T> &A, const Tensor<T> &B, T beta,
+        const Tensor<T> &C, const std::string &subscripts,
+        starpu_mpi_tag_t &last_tag, int redux)
+{
+    contract_async<T>(alpha, A, B, beta, C, subscripts, last_tag, redux);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void contract_async<fp32_t>(fp32_t alpha, const Tensor<fp32_t> &A,
+        const Tensor<fp32_t> &B, fp32_t beta, const Tensor<fp32_t> &C,
+        const std::string &subscripts, starpu_mpi_tag_t &last_tag,
+        int redux);
+
+template
+void contract_async<fp64_t>(fp64_t alpha, const Tensor<fp64_t> &A,
+        const Tensor<fp64_t> &B, fp64_t beta, const Tensor<fp64_t> &C,
+        const std::string &subscripts, starpu_mpi_tag_t &last_tag,
+        int redux);
+
+// Explicit instantiation
+template
+void contract<fp32_t>(fp32_t alpha, const Tensor<fp32_t> &A,
+        const Tensor<fp32_t> &B, fp32_t beta, const Tensor<fp32_t> &C,
+        const std::string &subscripts, starpu_mpi_tag_t &last_tag,
+        int redux);
+
+template
+void contract<fp64_t>(fp64_t alpha, const Tensor<fp64_t> &A,
+        const Tensor<fp64_t> &B, fp64_t beta, const Tensor<fp64_t> &C,
+        const std::string &subscripts, starpu_mpi_tag_t &last_tag,
+        int redux);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -73,7 +73,7 @@ void conv2d_async(const Tensor<T> &src, const Tensor<T> &kernel,
             for(Index dst_j = 0; dst_j < dst_m; ++dst_j)
             {
                 Index dst_index = dst_j + dst_i * dst_m + b * dst_n * dst_m;
-                auto dst_tile_handle = dst.get_tile_handle(dst_index);
+                const auto &dst_tile_handle = dst.get_tile_handle(dst_index);
                 starpu::clear::submit(dst_tile_handle);
             }
         }
@@ -86,7 +86,7 @@ void conv2d_async(const Tensor<T> &src, const Tensor<T> &kernel,
             for(Index src_j = 0; src_j < src_m; ++src_j)
             {
                 Index src_index = src_j + src_i * src_m + b * src_n * src_m;
-                auto src_tile_handle = src.get_tile_handle(src_index);
+                const auto &src_tile_handle = src.get_tile_handle(src_index);
 
                 Index tile_batch_current =
                     src.get_tile_traits(src_index)
@@ -0,0 +1,190 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/conv2d_backward_input.cc
+ * Tensor wrappers for gradient of 2D-Convolution over its input
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/conv2d_backward_input.hh"
+#include "nntile/starpu/conv2d_backward_input.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Tensor<T> gradient of 2D-Convolution over its input
+/*! Tensors are 3-dimensional with the contiguous second axis of a
+ * convolution first and the batch axis last, as in conv2d_async. Gradient is
+ * accumulated into src_grad. Tasks are submitted only for triples of tiles,
+ * whose windows overlap, and are executed by owners of tiles of src_grad.
+ *
+ * @param[in] dst_grad: Gradient of the output of 2D-Convolution
+ * @param[in] kernel: Kernel of 2D-Convolution
+ * @param[inout] src_grad: Gradient of the input of 2D-Convolution
+ * */
+template<typename T>
+void conv2d_backward_input_async(const Tensor<T> &dst_grad,
+        const Tensor<T> &kernel, const Tensor<T> &src_grad)
+{
+    // Check dimensions
+    if(dst_grad.ndim != 3)
+    {
+        throw std::runtime_error("dst_grad.ndim != 3");
+    }
+    if(kernel.ndim != 3)
+    {
+        throw std::runtime_error("kernel.ndim != 3");
+    }
+    if(src_grad.ndim != 3)
+    {
+        throw std::runtime_error("src_grad.ndim != 3");
+    }
+    // Check batch axis
+    if(dst_grad.shape[2] != src_grad.shape[2])
+    {
+        throw std::runtime_error("dst_grad.shape[2] != src_grad.shape[2]");
+    }
+    if(kernel.shape[2] != src_grad.shape[2])
+    {
+        throw std::runtime_error("kernel.shape[2] != src_grad.shape[2]");
+    }
+    if(dst_grad.basetile_shape[2] != src_grad.basetile_shape[2])
+    {
+        throw std::runtime_error("dst_grad.basetile_shape[2] != "
+                "src_grad.basetile_shape[2]");
+    }
+    if(kernel.basetile_shape[2] != src_grad.basetile_shape[2])
+    {
+        throw std::runtime_error("kernel.basetile_shape[2] != "
+                "src_grad.basetile_shape[2]");
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index b = 0; b < src_grad.grid.shape[2]; ++b)
+    {
+        for(Index src_i = 0; src_i < src_grad.grid.shape[1]; ++src_i)
+        {
+            for(Index src_j = 0; src_j < src_grad.grid.shape[0]; ++src_j)
+            {
+                std::vector<Index> src_index{src_j, src_i, b};
+                const auto &src_traits = src_grad.get_tile_traits(src_index);
+                auto src_tile_handle = src_grad.get_tile_handle(src_index);
+                int src_tile_rank = src_tile_handle.mpi_get_rank();
+                Index batch = src_traits.shape[2];
+                Index src_n = src_traits.shape[1];
+                Index src_m = src_traits.shape[0];
+                Index src_offset_n = src_i * src_grad.basetile_shape[1];
+                Index src_offset_m = src_j * src_grad.basetile_shape[0];
+                for(Index kernel_i = 0; kernel_i < kernel.grid.shape[1];
+                        ++kernel_i)
+                {
+                    for(Index kernel_j = 0; kernel_j < kernel.grid.shape[0];
+                            ++kernel_j)
+                    {
+                        std::vector<Index> kernel_index{kernel_j, kernel_i,
+                            b};
+                        const auto &kernel_traits = kernel.get_tile_traits(
+                                kernel_index);
+                        auto kernel_tile_handle = kernel.get_tile_handle(
+                                kernel_index);
+                        Index kernel_n = kernel_traits.shape[1];
+                        Index kernel_m = kernel_traits.shape[0];
+                        Index kernel_offset_n = kernel_i
+                            * kernel.basetile_shape[1];
+                        Index kernel_offset_m = kernel_j
+                            * kernel.basetile_shape[0];
+                        for(Index dst_i = 0; dst_i < dst_grad.grid.shape[1];
+                                ++dst_i)
+                        {
+                            for(Index dst_j = 0;
+                                    dst_j < dst_grad.grid.shape[0]; ++dst_j)
+                            {
+                                std::vector<Index> dst_index{dst_j, dst_i,
+                                    b};
+                                const auto &dst_traits =
+                                    dst_grad.get_tile_traits(dst_index);
+                                Index dst_n = dst_traits.shape[1];
+                                Index dst_m = dst_traits.shape[0];
+                                Index offset_n = dst_i
+                                    * dst_grad.basetile_shape[1]
+                                    - src_offset_n - kernel_offset_n;
+                                Index offset_m = dst_j
+                                    * dst_grad.basetile_shape[0]
+                                    - src_offset_m - kernel_offset_m;
+                                // Skip tiles, that do not overlap
+                                if(src_n+kernel_n-2 < offset_n
+                                        or offset_n+dst_n-1 < 0
+                                        or src_m+kernel_m-2 < offset_m
+                                        or offset_m+dst_m-1 < 0)
+                                {
+                                    continue;
+                                }
+                                auto dst_tile_handle =
+                                    dst_grad.get_tile_handle(dst_index);
+                                // Transfer data
+                                dst_tile_handle.mpi_transfer(src_tile_rank,
+                                        mpi_rank);
+                                kernel_tile_handle.mpi_transfer(
+                                        src_tile_rank, mpi_rank);
+                                // Execute on destination node
+                                if(mpi_rank == src_tile_rank)
+                                {
+                                    starpu::conv2d_backward_input::submit<T>(
+                                            offset_n, offset_m, batch, dst_n,
+                                            dst_m, dst_tile_handle, kernel_n,
+                                            kernel_m, kernel_tile_handle,
+                                            src_n, src_m, src_tile_handle);
+                                }
+                            }
+                        }
+                    }
+                }
+                // Flush cache for the output tile on every node
+                src_tile_handle.mpi_flush();
+            }
+        }
+    }
+}
+
+//! Blocking version of conv2d_backward_input_async<T>
+/*! @param[in] dst_grad: Gradient of the output of 2D-Convolution
+ * @param[in] kernel: Kernel of 2D-Convolution
+ * @param[inout] src_grad: Gradient of the input of 2D-Convolution
+ * */
+template<typename T>
+void conv2d_backward_input(const Tensor<T> &dst_grad,
+        const Tensor<T> &kernel, const Tensor<T> &src_grad)
+{
+    conv2d_backward_input_async<T>(dst_grad, kernel, src_grad);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void conv2d_backward_input_async<fp32_t>(const Tensor<fp32_t> &dst_grad,
+        const Tensor<fp32_t> &kernel, const Tensor<fp32_t> &src_grad);
+
+template
+void conv2d_backward_input_async<fp64_t>(const Tensor<fp64_t> &dst_grad,
+        const Tensor<fp64_t> &kernel, const Tensor<fp64_t> &src_grad);
+
+// Explicit instantiation
+template
+void conv2d_backward_input<fp32_t>(const Tensor<fp32_t> &dst_grad,
+        const Tensor<fp32_t> &kernel, const Tensor<fp32_t> &src_grad);
+
+template
+void conv2d_backward_input<fp64_t>(const Tensor<fp64_t> &dst_grad,
+        const Tensor<fp64_t> &kernel, const Tensor<fp64_t> &src_grad);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -44,8 +44,8 @@ void copy_async(const Tensor<T> &src, const Tensor<T> &dst)
     int ret;
     for(Index i = 0; i < src.grid.nelems; ++i)
     {
-        auto src_tile_handle = src.get_tile_handle(i);
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Transfer source tile to dest node
         src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
@@ -56,8 +56,8 @@ void copy_intersection_async(const Tensor<T> &src,
     // Treat special case of ndim=0
     if(src.ndim == 0)
     {
-        auto src_tile_handle = src.get_tile_handle(0);
-        auto dst_tile_handle = dst.get_tile_handle(0);
+        const auto &src_tile_handle = src.get_tile_handle(0);
+        const auto &dst_tile_handle = dst.get_tile_handle(0);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Transfer source tile to dest node
         src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
@@ -83,8 +83,8 @@ void copy_intersection_async(const Tensor<T> &src,
     {
         for(Index i = 0; i < src.grid.nelems; ++i)
         {
-            auto src_tile_handle = src.get_tile_handle(i);
-            auto dst_tile_handle = dst.get_tile_handle(i);
+            const auto &src_tile_handle = src.get_tile_handle(i);
+            const auto &dst_tile_handle = dst.get_tile_handle(i);
             int dst_tile_rank = dst_tile_handle.mpi_get_rank();
             // Transfer source tile to dest node
             src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
@@ -150,8 +150,8 @@ void copy_intersection_async(const Tensor<T> &src,
     for(Index i = 0; i < dst_ntiles; ++i)
     {
         Index dst_tile_offset = dst.grid.index_to_linear(dst_tile_index);
-        auto dst_tile_traits = dst.get_tile_traits(dst_tile_offset);
-        auto dst_tile_handle = dst.get_tile_handle(dst_tile_offset);
+        const auto &dst_tile_traits = dst.get_tile_traits(dst_tile_offset);
+        const auto &dst_tile_handle = dst.get_tile_handle(dst_tile_offset);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Total number of source tiles that copy something to the destination
         // tile
@@ -253,9 +253,9 @@ void copy_intersection_async(const Tensor<T> &src,
         // All the properties of the first source tile to copy from
         Index src_first_tile_offset = src.grid.index_to_linear( 
                 src_tile_index_begin);
-        auto src_first_tile_traits = src.get_tile_traits(
+        const auto &src_first_tile_traits = src.get_tile_traits(
                 src_first_tile_offset);
-        auto src_first_tile_handle = src.get_tile_handle(
+        const auto &src_first_tile_handle = src.get_tile_handle(
                 src_first_tile_offset);
         // Transfer first source tile to dest node
         src_first_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
@@ -365,13 +365,14 @@ void copy_intersection_async(const Tensor<T> &src,
                 // Get all the parameters for the complex copy
                 Index src_tile_offset = src.grid.index_to_linear(
                         src_tile_index);
-                auto src_tile_handle = src.get_tile_handle(src_tile_offset);
+                const auto &src_tile_handle =
+                        src.get_tile_handle(src_tile_offset);
                 // Transfer source tile to dest node
                 src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
                 // Execute on dest node
                 if(mpi_rank == dst_tile_rank)
                 {
-                    auto src_tile_traits = src.get_tile_traits(
+                    const auto &src_tile_traits = src.get_tile_traits(
                             src_tile_offset);
                     starpu::subcopy::submit<T>(ndim, src_tile_start,
                             src_tile_traits.stride, dst_tile_start,
@@ -437,6 +438,31 @@ void copy_intersection_async<Index>(const Tensor<Index> &src,
         const std::vector<Index> &src_offset, const Tensor<Index> &dst,
         const std::vector<Index> &dst_offset);
 
+template
+void copy_intersection_async<fp16_t>(const Tensor<fp16_t> &src,
+        const std::vector<Index> &src_offset, const Tensor<fp16_t> &dst,
+        const std::vector<Index> &dst_offset);
+
+template
+void copy_intersection_async<bf16_t>(const Tensor<bf16_t> &src,
+        const std::vector<Index> &src_offset, const Tensor<bf16_t> &dst,
+        const std::vector<Index> &dst_offset);
+
+template
+void copy_intersection_async<bool_t>(const Tensor<bool_t> &src,
+        const std::vector<Index> &src_offset, const Tensor<bool_t> &dst,
+        const std::vector<Index> &dst_offset);
+
+template
+void copy_intersection_async<std::int8_t>(const Tensor<std::int8_t> &src,
+        const std::vector<Index> &src_offset, const Tensor<std::int8_t> &dst,
+        const std::vector<Index> &dst_offset);
+
+template
+void copy_intersection_async<fp8_e4m3_t>(const Tensor<fp8_e4m3_t> &src,
+        const std::vector<Index> &src_offset, const Tensor<fp8_e4m3_t> &dst,
+        const std::vector<Index> &dst_offset);
+
 // Explicit instantiation
 template
 void copy_intersection<fp32_t>(const Tensor<fp32_t> &src,
@@ -453,6 +479,31 @@ void copy_intersection<Index>(const Tensor<Index> &src,
         const std::vector<Index> &src_offset, const Tensor<Index> &dst,
         const std::vector<Index> &dst_offset);
 
+template
+void copy_intersection<fp16_t>(const Tensor<fp16_t> &src,
+        const std::vector<Index> &src_offset, const Tensor<fp16_t> &dst,
+        const std::vector<Index> &dst_offset);
+
+template
+void copy_intersection<bf16_t>(const Tensor<bf16_t> &src,
+        const std::vector<Index> &src_offset, const Tensor<bf16_t> &dst,
+        const std::vector<Index> &dst_offset);
+
+template
+void copy_intersection<bool_t>(const Tensor<bool_t> &src,
+        const std::vector<Index> &src_offset, const Tensor<bool_t> &dst,
+        const std::vector<Index> &dst_offset);
+
+template
+void copy_intersection<std::int8_t>(const Tensor<std::int8_t> &src,
+        const std::vector<Index> &src_offset, const Tensor<std::int8_t> &dst,
+        const std::vector<Index> &dst_offset);
+
+template
+void copy_intersection<fp8_e4m3_t>(const Tensor<fp8_e4m3_t> &src,
+        const std::vector<Index> &src_offset, const Tensor<fp8_e4m3_t> &dst,
+        const std::vector<Index> &dst_offset);
+
 } // namespace tensor
 } // namespace nntile
 
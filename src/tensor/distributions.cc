@@ -14,6 +14,7 @@
 
 #include "nntile/tensor/distributions.hh"
 #include "nntile/tile/traits.hh"
+#include <map>
 
 namespace nntile
 {
@@ -40,10 +41,11 @@ std::vector<int> block_cyclic(const std::vector<Index> &tensor_grid,
     const tile::TileTraits traits(tensor_grid);
     // Define nodes/ranks for all tiles in a block-cyclic manner
     std::vector<int> ranks(traits.nelems, -1);
+    std::vector<Index> index;
     for(Index i = 0; i < traits.nelems; ++i)
     {
         // Get index of a tile in the tensor
-        auto index = traits.linear_to_index(i);
+        traits.linear_to_index(i, index);
         // Get index within mpi grid/stamp
         for(Index j = 0; j < ndim; ++j)
         {
@@ -60,6 +62,32 @@ std::vector<int> block_cyclic(const std::vector<Index> &tensor_grid,
     return ranks;
 }
 
+//! Distribute tiles of every MPI node cyclically over its CUDA devices
+/*! Tiles, owned by the same MPI node, get devices 0, 1, ..., ndevices-1,
+ * 0, 1, ... in the order of their linear indices, so that every node
+ * balances its tiles over its own devices.
+ *
+ * @param[in] distribution: MPI ranks of tiles
+ * @param[in] ndevices: Number of CUDA devices on every MPI node
+ * */
+std::vector<int> local_cyclic(const std::vector<int> &distribution,
+        int ndevices)
+{
+    if(ndevices <= 0)
+    {
+        throw std::runtime_error("ndevices <= 0");
+    }
+    std::vector<int> devices(distribution.size());
+    std::map<int, int> next_device;
+    for(std::size_t i = 0; i < distribution.size(); ++i)
+    {
+        int &device = next_device[distribution[i]];
+        devices[i] = device;
+        device = (device+1) % ndevices;
+    }
+    return devices;
+}
+
 } // namespace distributions
 } // namespace tensor
 } // namespace nntile
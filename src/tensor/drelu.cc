@@ -29,12 +29,12 @@ void drelu_async(const Tensor<T> &A)
     int mpi_rank = starpu_mpi_world_rank();
     for(Index i = 0; i < A.grid.nelems; ++i)
     {
-        auto tile_handle = A.get_tile_handle(i);
+        const auto &tile_handle = A.get_tile_handle(i);
         int tile_rank = tile_handle.mpi_get_rank();
         // Execute only on node-owner
         if(mpi_rank == tile_rank)
         {
-            auto tile_traits = A.get_tile_traits(i);
+            const auto &tile_traits = A.get_tile_traits(i);
             starpu::drelu::submit<T>(tile_traits.nelems, tile_handle);
         }
         // Flush cache for the output tile on every node
@@ -0,0 +1,116 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/dropout.cc
+ * Dropout operation with regenerated mask for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/tensor/dropout.hh"
+#include "nntile/starpu/dropout.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Tensor-wise dropout operation
+/*! Performs dst = beta*dst + mask*src/(1-p), where each element of the mask
+ * is zero with probability p. Mask of a tile is generated from the seed and
+ * the linear index of the tile, so that the same seed gives the same mask
+ * for the same tiling. This way a backward pass regenerates the mask of the
+ * forward pass instead of storing it.
+ *
+ * @param[in] seed: Seed of the random generator
+ * @param[in] p: Probability to zero out an element, 0 <= p < 1
+ * @param[in] src: Input tensor
+ * @param[in] beta: Scalar factor of dst
+ * @param[inout] dst: Output tensor
+ * */
+template<typename T>
+void dropout_async(unsigned long long seed, T p, const Tensor<T> &src,
+        T beta, const Tensor<T> &dst)
+{
+    // Check probability
+    if(p < 0 or p >= 1)
+    {
+        throw std::runtime_error("p < 0 or p >= 1");
+    }
+    // Check dimensions
+    if(dst.ndim != src.ndim)
+    {
+        throw std::runtime_error("dst.ndim != src.ndim");
+    }
+    // Check shapes of tensors
+    for(Index i = 0; i < dst.ndim; ++i)
+    {
+        if(dst.shape[i] != src.shape[i])
+        {
+            throw std::runtime_error("dst.shape[i] != src.shape[i]");
+        }
+        if(dst.basetile_shape[i] != src.basetile_shape[i])
+        {
+            throw std::runtime_error("dst.basetile_shape[i] != "
+                    "src.basetile_shape[i]");
+        }
+    }
+    // Apply per-tile dropout asynchronously as needed
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < src.grid.nelems; ++i)
+    {
+        // Get handle for corresponding tiles of src and dst
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
+        // MPI rank of the destination tile
+        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+        // Transfer data
+        src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        // Execute only on destination node
+        if(mpi_rank == dst_tile_rank)
+        {
+            const auto &traits = src.get_tile_traits(i);
+            starpu::dropout::submit<T>(traits.nelems, seed, i, p,
+                    src_tile_handle, beta, dst_tile_handle);
+        }
+        // Flush cache for the output tile on every node
+        dst_tile_handle.mpi_flush();
+    }
+}
+
+//! Tensor-wise dropout operation
+template<typename T>
+void dropout(unsigned long long seed, T p, const Tensor<T> &src, T beta,
+        const Tensor<T> &dst)
+{
+    dropout_async<T>(seed, p, src, beta, dst);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation of template
+template
+void dropout_async<fp32_t>(unsigned long long seed, fp32_t p,
+        const Tensor<fp32_t> &src, fp32_t beta, const Tensor<fp32_t> &dst);
+
+template
+void dropout_async<fp64_t>(unsigned long long seed, fp64_t p,
+        const Tensor<fp64_t> &src, fp64_t beta, const Tensor<fp64_t> &dst);
+
+// Explicit instantiation of template
+template
+void dropout<fp32_t>(unsigned long long seed, fp32_t p,
+        const Tensor<fp32_t> &src, fp32_t beta, const Tensor<fp32_t> &dst);
+
+template
+void dropout<fp64_t>(unsigned long long seed, fp64_t p,
+        const Tensor<fp64_t> &src, fp64_t beta, const Tensor<fp64_t> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -14,7 +14,10 @@
 
 #include "nntile/tensor/embedding.hh"
 #include "nntile/starpu/embedding.hh"
+#include "nntile/tensor/tree_reduction.hh"
 #include "nntile/starpu/clear.hh"
+#include "nntile/starpu/accumulate.hh"
+#include <map>
 
 namespace nntile
 {
@@ -68,14 +71,20 @@ void embedding_async(const Tensor<Index> &index, const Tensor<T> &vocab,
         throw std::runtime_error("embed.basetile_shape[axis] % "
                 "vocab.basetile_shape[0] != 0");
     }
-    // Actual calculations
+    // Actual calculations. Vocabulary may be split into shards along the
+    // last axis, and every lookup is executed by the owner of a tile of
+    // vocabulary, so that only gathered embeddings are sent over network.
+    // Embeddings, gathered on other nodes, are accumulated into the output
+    // tile by a tree reduction of partial results of the size of the output
+    // tile.
     int mpi_rank = starpu_mpi_world_rank();
+    std::vector<Index> embed_tile_index, vocab_tile_index(2);
     for(Index i = 0; i < embed.grid.nelems; ++i)
     {
-        auto embed_tile_handle = embed.get_tile_handle(i);
-        auto embed_tile_traits = embed.get_tile_traits(i);
+        const auto &embed_tile_handle = embed.get_tile_handle(i);
+        const auto &embed_tile_traits = embed.get_tile_traits(i);
         int embed_tile_rank = embed_tile_handle.mpi_get_rank();
-        auto embed_tile_index = embed.grid.linear_to_index(i);
+        embed.grid.linear_to_index(i, embed_tile_index);
         // Clear output tile at first
         if(mpi_rank == embed_tile_rank)
         {
@@ -91,8 +100,13 @@ void embedding_async(const Tensor<Index> &index, const Tensor<T> &vocab,
         {
             index_tile_index[j] = embed_tile_index[j+1];
         }
-        auto index_tile_handle = index.get_tile_handle(index_tile_index);
-        int index_tile_rank = index_tile_handle.mpi_get_rank();
+        const auto &index_tile_handle =
+                index.get_tile_handle(index_tile_index);
+        // Partial results of other nodes, if vocabulary is distributed
+        TreeReduction tree(embed_tile_handle,
+                sizeof(T)*embed_tile_traits.nelems,
+                starpu::accumulate::submit<T>);
+        std::map<int, starpu::Handle> partials;
         // Number of vocab tiles per single embed tile
         Index vocab_per_embed = (embed_tile_traits.shape[axis]-1)
             / vocab.basetile_shape[0] + 1;
@@ -102,17 +116,50 @@ void embedding_async(const Tensor<Index> &index, const Tensor<T> &vocab,
         Index vocab_end = vocab_start + vocab_per_embed;
         for(Index j = vocab_start; j < vocab_end; ++j)
         {
-            auto vocab_tile_handle = vocab.get_tile_handle(j);
-            auto vocab_tile_traits = vocab.get_tile_traits(j);
-            Index m, n, k, k_start, k_size;
-            m = embed_tile_traits.stride[axis];
-            n = embed_tile_traits.matrix_shape[axis+1][1];
-            k = embed_tile_traits.shape[axis];
-            k_start = (j-vocab_start) * vocab.basetile_shape[0];
-            k_size = vocab_tile_traits.shape[0];
-            starpu::embedding::submit<T>(m, n, k, k_start, k_size,
-                    index_tile_handle, vocab_tile_handle, embed_tile_handle);
+            vocab_tile_index[0] = j;
+            // Cycle over shards of vocabulary
+            for(Index s = 0; s < vocab.grid.shape[1]; ++s)
+            {
+                vocab_tile_index[1] = s;
+                const auto &vocab_tile_handle =
+                    vocab.get_tile_handle(vocab_tile_index);
+                const auto &vocab_tile_traits =
+                    vocab.get_tile_traits(vocab_tile_index);
+                int vocab_tile_rank = vocab_tile_handle.mpi_get_rank();
+                // Output tile is updated directly on its own node
+                starpu::Handle dst_handle = embed_tile_handle;
+                if(vocab_tile_rank != embed_tile_rank)
+                {
+                    auto it = partials.find(vocab_tile_rank);
+                    if(it == partials.end())
+                    {
+                        auto partial = tree.get_partial(vocab_tile_rank);
+                        if(mpi_rank == vocab_tile_rank)
+                        {
+                            starpu::clear::submit(partial);
+                        }
+                        it = partials.emplace(vocab_tile_rank, partial).first;
+                    }
+                    dst_handle = it->second;
+                }
+                // Transfer tokens to the owner of the vocab tile
+                index_tile_handle.mpi_transfer(vocab_tile_rank, mpi_rank);
+                if(mpi_rank != vocab_tile_rank)
+                {
+                    continue;
+                }
+                Index m, n, k, k_start, k_size;
+                m = embed_tile_traits.stride[axis];
+                n = embed_tile_traits.matrix_shape[axis+1][1];
+                k = embed_tile_traits.shape[axis];
+                k_start = (j-vocab_start) * vocab.basetile_shape[0];
+                k_size = vocab_tile_traits.shape[0];
+                starpu::embedding::submit<T>(m, n, k, k_start, k_size,
+                        s*vocab.basetile_shape[1], vocab_tile_traits.shape[1],
+                        index_tile_handle, vocab_tile_handle, dst_handle);
+            }
         }
+        tree.submit();
         // Flush cache for the output tile on every node
         embed_tile_handle.mpi_flush();
     }
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/tensor/embedding_backward.hh"
+#include "nntile/tensor/tree_reduction.hh"
 #include "nntile/starpu/embedding_backward.hh"
 
 namespace nntile
@@ -67,15 +68,24 @@ void embedding_backward_async(const Tensor<Index> &index,
         throw std::runtime_error("embed.basetile_shape[axis] % "
                 "vocab.basetile_shape[0] != 0");
     }
+    // Scratch buffer for sorted positions of tokens of a single tile
+    Index tile_ntokens = 1;
+    for(Index i = 0; i < index.ndim; ++i)
+    {
+        tile_ntokens *= index.basetile_shape[i];
+    }
+    starpu::VariableHandle tmp(sizeof(Index)*tile_ntokens, STARPU_SCRATCH);
     // Actual calculations
+    // Deterministic mode replaces STARPU_REDUX by a sequential chain
+    redux = redux_mode(redux, false);
     int mpi_rank = starpu_mpi_world_rank();
     // Cycle over embedding tiles
+    std::vector<Index> embed_tile_index, vocab_tile_index(2);
     for(Index i = 0; i < embed.grid.nelems; ++i)
     {
-        auto embed_tile_handle = embed.get_tile_handle(i);
-        auto embed_tile_traits = embed.get_tile_traits(i);
-        int embed_tile_rank = embed_tile_handle.mpi_get_rank();
-        auto embed_tile_index = embed.grid.linear_to_index(i);
+        const auto &embed_tile_handle = embed.get_tile_handle(i);
+        const auto &embed_tile_traits = embed.get_tile_traits(i);
+        embed.grid.linear_to_index(i, embed_tile_index);
         // Get corresponding index tile
         std::vector<Index> index_tile_index(index.ndim);
         for(Index j = 0; j < axis; ++j)
@@ -86,8 +96,8 @@ void embedding_backward_async(const Tensor<Index> &index,
         {
             index_tile_index[j] = embed_tile_index[j+1];
         }
-        auto index_tile_handle = index.get_tile_handle(index_tile_index);
-        int index_tile_rank = index_tile_handle.mpi_get_rank();
+        const auto &index_tile_handle =
+                index.get_tile_handle(index_tile_index);
         // Number of vocab tiles per single embed tile
         Index vocab_per_embed = (embed_tile_traits.shape[axis]-1)
             / vocab.basetile_shape[0] + 1;
@@ -97,17 +107,34 @@ void embedding_backward_async(const Tensor<Index> &index,
         Index vocab_end = vocab_start + vocab_per_embed;
         for(Index j = vocab_start; j < vocab_end; ++j)
         {
-            auto vocab_tile_handle = vocab.get_tile_handle(j);
-            auto vocab_tile_traits = vocab.get_tile_traits(j);
-            Index m, n, k, k_start, k_size;
-            m = embed_tile_traits.stride[axis];
-            n = embed_tile_traits.matrix_shape[axis+1][1];
-            k = embed_tile_traits.shape[axis];
-            k_start = (j-vocab_start) * vocab.basetile_shape[0];
-            k_size = vocab_tile_traits.shape[0];
-            starpu::embedding_backward::submit<T>(m, n, k, k_start, k_size,
-                    index_tile_handle, embed_tile_handle, vocab_tile_handle,
-                    redux);
+            vocab_tile_index[0] = j;
+            // Gradients are accumulated by owners of shards of vocabulary,
+            // which receive only tokens and gradients of embeddings
+            for(Index s = 0; s < vocab.grid.shape[1]; ++s)
+            {
+                vocab_tile_index[1] = s;
+                const auto &vocab_tile_handle =
+                    vocab.get_tile_handle(vocab_tile_index);
+                const auto &vocab_tile_traits =
+                    vocab.get_tile_traits(vocab_tile_index);
+                int vocab_tile_rank = vocab_tile_handle.mpi_get_rank();
+                index_tile_handle.mpi_transfer(vocab_tile_rank, mpi_rank);
+                embed_tile_handle.mpi_transfer(vocab_tile_rank, mpi_rank);
+                if(mpi_rank != vocab_tile_rank)
+                {
+                    continue;
+                }
+                Index m, n, k, k_start, k_size;
+                m = embed_tile_traits.stride[axis];
+                n = embed_tile_traits.matrix_shape[axis+1][1];
+                k = embed_tile_traits.shape[axis];
+                k_start = (j-vocab_start) * vocab.basetile_shape[0];
+                k_size = vocab_tile_traits.shape[0];
+                starpu::embedding_backward::submit<T>(m, n, k, k_start,
+                        k_size, s*vocab.basetile_shape[1],
+                        vocab_tile_traits.shape[1], index_tile_handle,
+                        embed_tile_handle, vocab_tile_handle, tmp, redux);
+            }
         }
     }
     // Flush cache for the output tile on every node
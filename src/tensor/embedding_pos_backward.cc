@@ -0,0 +1,228 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/embedding_pos_backward.cc
+ * Backward of embeddings of tokens and positions
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/embedding_pos_backward.hh"
+#include "nntile/tensor/tree_reduction.hh"
+#include "nntile/starpu/embedding_pos_backward.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Tensor-wise backward of embeddings of tokens and positions
+/*! Gradient of embeddings is read once and accumulated into gradients of
+ * both vocabularies by the same task.
+ *
+ * @param[in] index: Tokens (indices of embeddings)
+ * @param[in] pos: Positions of tokens, see embedding_pos_async
+ * @param[in] embed: Gradient of output embeddings
+ * @param[inout] vocab: Gradient of vocabulary of embeddings of tokens
+ * @param[inout] pos_vocab: Gradient of vocabulary of positional embeddings
+ * @param[in] axis: Mode of embed, that corresponds to embeddings
+ * @param[in] redux: Whether to use STARPU_REDUX for gradients
+ * */
+template<typename T>
+void embedding_pos_backward_async(const Tensor<Index> &index,
+        const Tensor<Index> &pos, const Tensor<T> &embed,
+        const Tensor<T> &vocab, const Tensor<T> &pos_vocab, Index axis,
+        int redux)
+{
+    // Check dimensions
+    if(index.ndim+1 != embed.ndim)
+    {
+        throw std::runtime_error("index.ndim+1 != embed.ndim");
+    }
+    if(pos.ndim > index.ndim)
+    {
+        throw std::runtime_error("pos.ndim > index.ndim");
+    }
+    if(vocab.ndim != 2)
+    {
+        throw std::runtime_error("vocab.ndim != 2");
+    }
+    if(pos_vocab.ndim != 2)
+    {
+        throw std::runtime_error("pos_vocab.ndim != 2");
+    }
+    // Check shapes
+    for(Index i = 0; i < axis; ++i)
+    {
+        if(index.shape[i] != embed.shape[i])
+        {
+            throw std::runtime_error("index.shape[i] != embed.shape[i]");
+        }
+        if(index.basetile_shape[i] != embed.basetile_shape[i])
+        {
+            throw std::runtime_error("index.basetile_shape[i] != "
+                    "embed.basetile_shape[i]");
+        }
+    }
+    for(Index i = axis; i < index.ndim; ++i)
+    {
+        if(index.shape[i] != embed.shape[i+1])
+        {
+            throw std::runtime_error("index.shape[i] != embed.shape[i+1]");
+        }
+        if(index.basetile_shape[i] != embed.basetile_shape[i+1])
+        {
+            throw std::runtime_error("index.basetile_shape[i] != "
+                    "embed.basetile_shape[i+1]");
+        }
+    }
+    // Positions are the same for all trailing modes of index
+    for(Index i = 0; i < pos.ndim; ++i)
+    {
+        if(pos.shape[i] != index.shape[i])
+        {
+            throw std::runtime_error("pos.shape[i] != index.shape[i]");
+        }
+        if(pos.basetile_shape[i] != index.basetile_shape[i])
+        {
+            throw std::runtime_error("pos.basetile_shape[i] != "
+                    "index.basetile_shape[i]");
+        }
+    }
+    if(embed.shape[axis] != vocab.shape[0])
+    {
+        throw std::runtime_error("embed.shape[axis] != vocab.shape[0]");
+    }
+    if(embed.basetile_shape[axis] % vocab.basetile_shape[0] != 0)
+    {
+        throw std::runtime_error("embed.basetile_shape[axis] % "
+                "vocab.basetile_shape[0] != 0");
+    }
+    if(pos_vocab.shape[0] != vocab.shape[0])
+    {
+        throw std::runtime_error("pos_vocab.shape[0] != vocab.shape[0]");
+    }
+    if(pos_vocab.basetile_shape[0] != vocab.basetile_shape[0])
+    {
+        throw std::runtime_error("pos_vocab.basetile_shape[0] != "
+                "vocab.basetile_shape[0]");
+    }
+    // Scratch buffer for sorted tokens and positions of a single tile
+    Index tile_ntokens = 1;
+    for(Index i = 0; i < index.ndim; ++i)
+    {
+        tile_ntokens *= index.basetile_shape[i];
+    }
+    Index tile_npos = 1;
+    for(Index i = 0; i < pos.ndim; ++i)
+    {
+        tile_npos *= pos.basetile_shape[i];
+    }
+    starpu::VariableHandle tmp(sizeof(Index)*(tile_ntokens+tile_npos),
+            STARPU_SCRATCH);
+    // Actual calculations
+    // Deterministic mode replaces STARPU_REDUX by a sequential chain
+    redux = redux_mode(redux, false);
+    std::vector<Index> embed_tile_index;
+    for(Index i = 0; i < embed.grid.nelems; ++i)
+    {
+        const auto &embed_tile_handle = embed.get_tile_handle(i);
+        const auto &embed_tile_traits = embed.get_tile_traits(i);
+        embed.grid.linear_to_index(i, embed_tile_index);
+        // Get corresponding index and pos tiles
+        std::vector<Index> index_tile_index(index.ndim);
+        for(Index j = 0; j < axis; ++j)
+        {
+            index_tile_index[j] = embed_tile_index[j];
+        }
+        for(Index j = axis; j < index.ndim; ++j)
+        {
+            index_tile_index[j] = embed_tile_index[j+1];
+        }
+        const auto &index_tile_handle =
+                index.get_tile_handle(index_tile_index);
+        std::vector<Index> pos_tile_index(index_tile_index.begin(),
+                index_tile_index.begin()+pos.ndim);
+        const auto &pos_tile_handle = pos.get_tile_handle(pos_tile_index);
+        Index pos_size = pos.get_tile_traits(pos_tile_index).nelems;
+        // Number of vocab tiles per single embed tile
+        Index vocab_per_embed = (embed_tile_traits.shape[axis]-1)
+            / vocab.basetile_shape[0] + 1;
+        // Find corresponding vocab tiles
+        Index vocab_start = embed_tile_index[axis] * embed.basetile_shape[axis]
+            / vocab.basetile_shape[0];
+        Index vocab_end = vocab_start + vocab_per_embed;
+        for(Index j = vocab_start; j < vocab_end; ++j)
+        {
+            const auto &vocab_tile_handle = vocab.get_tile_handle(j);
+            const auto &pos_vocab_tile_handle = pos_vocab.get_tile_handle(j);
+            const auto &vocab_tile_traits = vocab.get_tile_traits(j);
+            Index m, n, k, k_start, k_size;
+            m = embed_tile_traits.stride[axis];
+            n = embed_tile_traits.matrix_shape[axis+1][1];
+            k = embed_tile_traits.shape[axis];
+            k_start = (j-vocab_start) * vocab.basetile_shape[0];
+            k_size = vocab_tile_traits.shape[0];
+            starpu::embedding_pos_backward::submit<T>(m, n, k, k_start,
+                    k_size, pos_size, index_tile_handle, pos_tile_handle,
+                    embed_tile_handle, vocab_tile_handle,
+                    pos_vocab_tile_handle, tmp, redux);
+        }
+    }
+    // Flush cache for the output tiles on every node
+    for(Index i = 0; i < vocab.grid.nelems; ++i)
+    {
+        vocab.get_tile_handle(i).mpi_flush();
+    }
+    for(Index i = 0; i < pos_vocab.grid.nelems; ++i)
+    {
+        pos_vocab.get_tile_handle(i).mpi_flush();
+    }
+}
+
+template<typename T>
+void embedding_pos_backward(const Tensor<Index> &index,
+        const Tensor<Index> &pos, const Tensor<T> &embed,
+        const Tensor<T> &vocab, const Tensor<T> &pos_vocab, Index axis,
+        int redux)
+{
+    embedding_pos_backward_async<T>(index, pos, embed, vocab, pos_vocab, axis,
+            redux);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void embedding_pos_backward_async<fp32_t>(const Tensor<Index> &index,
+        const Tensor<Index> &pos, const Tensor<fp32_t> &embed,
+        const Tensor<fp32_t> &vocab, const Tensor<fp32_t> &pos_vocab,
+        Index axis, int redux);
+
+template
+void embedding_pos_backward_async<fp64_t>(const Tensor<Index> &index,
+        const Tensor<Index> &pos, const Tensor<fp64_t> &embed,
+        const Tensor<fp64_t> &vocab, const Tensor<fp64_t> &pos_vocab,
+        Index axis, int redux);
+
+// Explicit instantiation
+template
+void embedding_pos_backward<fp32_t>(const Tensor<Index> &index,
+        const Tensor<Index> &pos, const Tensor<fp32_t> &embed,
+        const Tensor<fp32_t> &vocab, const Tensor<fp32_t> &pos_vocab,
+        Index axis, int redux);
+
+template
+void embedding_pos_backward<fp64_t>(const Tensor<Index> &index,
+        const Tensor<Index> &pos, const Tensor<fp64_t> &embed,
+        const Tensor<fp64_t> &vocab, const Tensor<fp64_t> &pos_vocab,
+        Index axis, int redux);
+
+} // namespace tensor
+} // namespace nntile
+
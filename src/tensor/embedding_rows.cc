@@ -0,0 +1,80 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/embedding_rows.cc
+ * Mark rows of vocabulary, used by tokens, as a tensor operation
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-13
+ * */
+
+#include "nntile/tensor/embedding_rows.hh"
+#include "nntile/starpu/embedding_rows.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+void embedding_rows_async(const Tensor<Index> &index,
+        const Tensor<bool_t> &rows)
+//! Tensor-wise marking of rows of vocabulary, used by tokens
+/*! Sets rows[index[i]] to true for all the tokens. Other entries of rows are
+ * not changed, so rows shall be cleared before the first call. Mask rows is
+ * used by sparse updates of vocabulary, as only rows, that are marked, get
+ * nonzero gradients from embedding_backward.
+ *
+ * @param[in] index: Tokens
+ * @param[inout] rows: Mask of used rows of vocabulary, that is not tiled
+ * */
+{
+    // Check dimensions
+    if(rows.ndim != 1)
+    {
+        throw std::runtime_error("rows.ndim != 1");
+    }
+    // Check shapes
+    if(rows.grid.nelems != 1)
+    {
+        throw std::runtime_error("rows.grid.nelems != 1");
+    }
+    // Actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    const auto &rows_tile_handle = rows.get_tile_handle(0);
+    int rows_tile_rank = rows_tile_handle.mpi_get_rank();
+    for(Index i = 0; i < index.grid.nelems; ++i)
+    {
+        const auto &index_tile_handle = index.get_tile_handle(i);
+        // Transfer tokens to the owner of the mask
+        index_tile_handle.mpi_transfer(rows_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == rows_tile_rank)
+        {
+            starpu::embedding_rows::submit(index_tile_handle,
+                    rows_tile_handle);
+        }
+    }
+    // Flush cache for the output tile on every node
+    rows_tile_handle.mpi_flush();
+}
+
+void embedding_rows(const Tensor<Index> &index, const Tensor<bool_t> &rows)
+//! Tensor-wise marking of rows of vocabulary, used by tokens
+/*! Blocking version of embedding_rows_async.
+ *
+ * @param[in] index: Tokens
+ * @param[inout] rows: Mask of used rows of vocabulary, that is not tiled
+ * */
+{
+    embedding_rows_async(index, rows);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,156 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/fill_padding.cc
+ * Fill padding of a tensor beyond its logical shape
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/fill_padding.hh"
+#include "nntile/starpu/fill_padding.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Shape of a padded tensor, which tiles are all of the base tile shape
+/*! Leftover tiles on edges of a grid run kernels of odd sizes, that are
+ * badly aligned for SIMD and tensor cores and have their own performance
+ * models. A tensor of a padded shape consists of uniform tiles only, while
+ * its logical shape is kept by the user. Padding shall be set to zero for
+ * matrix multiplications, sums and norms, and to -infinity along an axis
+ * of softmax or maxsumexp, so that results on the logical part do not
+ * depend on padding (see fill_padding_async()).
+ *
+ * @param[in] shape: Logical shape of a tensor
+ * @param[in] basetile_shape: Shape of tiles of the padded tensor
+ * */
+std::vector<Index> padded_shape(const std::vector<Index> &shape,
+        const std::vector<Index> &basetile_shape)
+{
+    if(shape.size() != basetile_shape.size())
+    {
+        throw std::runtime_error("shape.size() != basetile_shape.size()");
+    }
+    std::vector<Index> padded(shape.size());
+    for(Index i = 0; i < shape.size(); ++i)
+    {
+        if(shape[i] <= 0 or basetile_shape[i] <= 0)
+        {
+            throw std::runtime_error("Shape and base tile shape shall be "
+                    "positive");
+        }
+        padded[i] = (shape[i]-1)/basetile_shape[i]*basetile_shape[i]
+            + basetile_shape[i];
+    }
+    return padded;
+}
+
+//! Asynchronous fill of padding of a tensor beyond its logical shape
+/*! Every element of A with an index, that is not less than a logical shape
+ * along at least one axis, is set to val. Only tiles, that intersect the
+ * padding, are touched.
+ *
+ * @param[in] val: Value of padding
+ * @param[in] logical_shape: Logical shape of A
+ * @param[inout] A: Padded tensor
+ * */
+template<typename T>
+void fill_padding_async(T val, const std::vector<Index> &logical_shape,
+        const Tensor<T> &A)
+{
+    // Check logical shape
+    if(logical_shape.size() != A.ndim)
+    {
+        throw std::runtime_error("logical_shape.size() != A.ndim");
+    }
+    for(Index axis = 0; axis < A.ndim; ++axis)
+    {
+        if(logical_shape[axis] < 0 or logical_shape[axis] > A.shape[axis])
+        {
+            throw std::runtime_error("Logical shape is out of bounds");
+        }
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    // Padding along each axis is filled separately, as padding of tiles
+    // along an axis is a contiguous range of the middle mode of the tile
+    std::vector<Index> tile_index;
+    for(Index axis = 0; axis < A.ndim; ++axis)
+    {
+        if(logical_shape[axis] == A.shape[axis])
+        {
+            continue;
+        }
+        for(Index i = 0; i < A.grid.nelems; ++i)
+        {
+            A.grid.linear_to_index(i, tile_index);
+            const auto &tile_traits = A.get_tile_traits(i);
+            Index k = tile_traits.shape[axis];
+            Index k_start = logical_shape[axis]
+                - tile_index[axis]*A.basetile_shape[axis];
+            // Skip tiles within the logical shape along the axis
+            if(k_start >= k)
+            {
+                continue;
+            }
+            if(k_start < 0)
+            {
+                k_start = 0;
+            }
+            const auto &tile_handle = A.get_tile_handle(i);
+            // Execute only on node-owner
+            if(mpi_rank == tile_handle.mpi_get_rank())
+            {
+                Index m = tile_traits.stride[axis];
+                Index n = tile_traits.matrix_shape[axis+1][1];
+                starpu::fill_padding::submit<T>(m, n, k, k_start, val,
+                        tile_handle);
+            }
+            // Flush cache for the output tile on every node
+            tile_handle.mpi_flush();
+        }
+    }
+}
+
+//! Blocking fill of padding of a tensor beyond its logical shape
+/*! @param[in] val: Value of padding
+ * @param[in] logical_shape: Logical shape of A
+ * @param[inout] A: Padded tensor
+ * */
+template<typename T>
+void fill_padding(T val, const std::vector<Index> &logical_shape,
+        const Tensor<T> &A)
+{
+    fill_padding_async<T>(val, logical_shape, A);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void fill_padding_async<fp32_t>(fp32_t val,
+        const std::vector<Index> &logical_shape, const Tensor<fp32_t> &A);
+
+template
+void fill_padding_async<fp64_t>(fp64_t val,
+        const std::vector<Index> &logical_shape, const Tensor<fp64_t> &A);
+
+// Explicit instantiation
+template
+void fill_padding<fp32_t>(fp32_t val,
+        const std::vector<Index> &logical_shape, const Tensor<fp32_t> &A);
+
+template
+void fill_padding<fp64_t>(fp64_t val,
+        const std::vector<Index> &logical_shape, const Tensor<fp64_t> &A);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,547 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/flash_attention.cc
+ * Fused single-pass flash attention forward
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#include "nntile/tensor/flash_attention.hh"
+#include "nntile/tensor/mask_tiles.hh"
+#include "nntile/starpu/flash_attention.hh"
+#include "nntile/starpu/clear.hh"
+#include "nntile/starpu/copy.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+#ifdef NNTILE_USE_MPI
+//! Get MPI tag for a copy of a tile of keys or values in a ring
+/*! Copies cycle through their own range in the upper half of tags, right
+ * after the range of temporaries of transfer_dtype. All nodes submit the same
+ * tasks in the same order, so they get the same tags for the same copies.
+ * */
+static starpu_mpi_tag_t ring_tag()
+{
+    constexpr starpu_mpi_tag_t ntags = starpu_mpi_tag_t(1) << 32;
+    constexpr starpu_mpi_tag_t first = (starpu_mpi_tag_t(1) << 62)
+        + 2*ntags;
+    static starpu_mpi_tag_t next = 0;
+    starpu_mpi_tag_t tag = first + next;
+    next = (next+1) % ntags;
+    return tag;
+}
+#endif // NNTILE_USE_MPI
+
+//! Check shapes of inputs of fused attention forward
+/*! @returns number of heads of queries per a head of keys and values
+ * */
+template<typename T>
+static Index check_shapes(const Tensor<T> &Q, const Tensor<T> &K,
+        const Tensor<T> &V, const Tensor<bool_t> &mask,
+        const Tensor<T> &maxsumexp, const Tensor<T> &dst)
+{
+    // Check dimensions
+    if(Q.ndim != 4)
+    {
+        throw std::runtime_error("Q.ndim != 4");
+    }
+    if(dst.shape != Q.shape or dst.basetile_shape != Q.basetile_shape)
+    {
+        throw std::runtime_error("Q and dst must have the same shape and "
+                "basetile_shape");
+    }
+    if(V.shape != K.shape or V.basetile_shape != K.basetile_shape)
+    {
+        throw std::runtime_error("K and V must have the same shape and "
+                "basetile_shape");
+    }
+    if(K.ndim != 4)
+    {
+        throw std::runtime_error("K.ndim != 4");
+    }
+    for(Index i = 0; i < 3; ++i)
+    {
+        if(K.shape[i] != Q.shape[i])
+        {
+            throw std::runtime_error("K.shape[i] != Q.shape[i]");
+        }
+        if(K.basetile_shape[i] != Q.basetile_shape[i])
+        {
+            throw std::runtime_error("K.basetile_shape[i] != "
+                    "Q.basetile_shape[i]");
+        }
+    }
+    // Tiles of queries contain all the heads, that share tiles of keys
+    if(Q.shape[3] % K.shape[3] != 0)
+    {
+        throw std::runtime_error("Q.shape[3] % K.shape[3] != 0");
+    }
+    Index kv_group = Q.shape[3] / K.shape[3];
+    if(K.basetile_shape[3]*kv_group != Q.basetile_shape[3])
+    {
+        throw std::runtime_error("K.basetile_shape[3]*kv_group != "
+                "Q.basetile_shape[3]");
+    }
+    if(Q.basetile_shape[0] != Q.shape[0])
+    {
+        throw std::runtime_error("Q.basetile_shape[0] != Q.shape[0]");
+    }
+    if(Q.shape[1] % Q.basetile_shape[1] != 0)
+    {
+        throw std::runtime_error("Q.shape[1] % Q.basetile_shape[1] != 0");
+    }
+    if(mask.ndim != 2)
+    {
+        throw std::runtime_error("mask.ndim != 2");
+    }
+    if(mask.shape[0] != Q.shape[1] or mask.shape[1] != Q.shape[1])
+    {
+        throw std::runtime_error("mask.shape != [Q.shape[1], Q.shape[1]]");
+    }
+    if(mask.basetile_shape[0] != Q.basetile_shape[1]
+            or mask.basetile_shape[1] != Q.basetile_shape[1])
+    {
+        throw std::runtime_error("mask.basetile_shape != "
+                "[Q.basetile_shape[1], Q.basetile_shape[1]]");
+    }
+    if(maxsumexp.ndim != 4)
+    {
+        throw std::runtime_error("maxsumexp.ndim != 4");
+    }
+    if(maxsumexp.shape[0] != 2 or maxsumexp.basetile_shape[0] != 2)
+    {
+        throw std::runtime_error("maxsumexp.shape[0] != 2 or "
+                "maxsumexp.basetile_shape[0] != 2");
+    }
+    for(Index i = 1; i < 4; ++i)
+    {
+        if(maxsumexp.shape[i] != Q.shape[i])
+        {
+            throw std::runtime_error("maxsumexp.shape[i] != Q.shape[i]");
+        }
+        if(maxsumexp.basetile_shape[i] != Q.basetile_shape[i])
+        {
+            throw std::runtime_error("maxsumexp.basetile_shape[i] != "
+                    "Q.basetile_shape[i]");
+        }
+    }
+    return kv_group;
+}
+
+template<typename T>
+void flash_attention_async(const Tensor<T> &Q, const Tensor<T> &K,
+        const Tensor<T> &V, const Tensor<bool_t> &mask,
+        const Tensor<T> &maxsumexp, const Tensor<T> &dst,
+        const std::vector<MaskTile> &layout)
+//! Tensor-wise fused attention forward
+/*! Computes dst = V @ softmax(mask(K^T @ Q / sqrt(head))) with a single pass
+ * over tiles of keys and values for each tile of queries, using online
+ * softmax. No seq by seq temporary tensor is needed. Both maxsumexp and dst
+ * are overwritten; on exit maxsumexp contains the same values as the ones
+ * computed by flash_maxsumexp, so that it can be reused for the backward.
+ * Keys and values may have fewer heads, than queries (grouped-query
+ * attention): head h of queries uses head h/(n_head/n_head_kv) of keys and
+ * values.
+ *
+ * @param[in] Q: Queries of shape [head, seq, batch, n_head]
+ * @param[in] K: Keys of shape [head, seq, batch, n_head_kv]
+ * @param[in] V: Values of shape [head, seq, batch, n_head_kv]
+ * @param[in] mask: Mask of shape [seq, seq], false entries are skipped
+ * @param[out] maxsumexp: Max and sum of exponents of shape
+ *      [2, seq, batch, n_head]
+ * @param[out] dst: Output of shape [head, seq, batch, n_head]
+ * @param[in] layout: Block-sparse layout of mask, see mask_layout()
+ * */
+{
+    Index kv_group = check_shapes<T>(Q, K, V, mask, maxsumexp, dst);
+    // Do actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    Index head = Q.shape[0];
+    Index seq = Q.basetile_shape[1];
+    // Pairs of tiles with an empty tile of mask are skipped by all nodes
+    auto mask_kinds = mask_layout(mask, layout);
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        // Output tiles are updated on the node, that owns dst tile
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
+        const auto &maxsumexp_tile_handle = maxsumexp.get_tile_handle(i);
+        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+        if(maxsumexp_tile_handle.mpi_get_rank() != dst_tile_rank)
+        {
+            throw std::runtime_error("maxsumexp and dst tiles must be owned "
+                    "by the same node");
+        }
+        const auto &dst_tile_traits = dst.get_tile_traits(i);
+        Index batch = dst_tile_traits.shape[2] * dst_tile_traits.shape[3];
+        const auto &q_tile_handle = Q.get_tile_handle(i);
+        q_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        // Reset running state
+        if(mpi_rank == dst_tile_rank)
+        {
+            starpu::clear::submit(maxsumexp_tile_handle);
+            starpu::clear::submit(dst_tile_handle);
+        }
+        // Accumulate contributions of all tiles of keys and values. Grids of
+        // K, V and mask differ from the grid of dst only along sequence
+        // axes, so linear offsets of their tiles are computed directly
+        const Index q_seq = i % dst.grid.shape[1];
+        const Index kv_offset = (i/dst.grid.shape[1]) * K.grid.stride[2];
+        const Index mask_offset = q_seq * mask.grid.stride[1];
+        for(Index j = 0; j < K.grid.shape[1]; ++j)
+        {
+            auto mask_kind = mask_kinds[mask_offset+j];
+            if(mask_kind == MaskTile::empty)
+            {
+                continue;
+            }
+            // Causal tile of mask is generated by the kernel
+            int mask_causal = mask_kind == MaskTile::causal;
+            const Index kv_linear = kv_offset + j*K.grid.stride[1];
+            const auto &k_tile_handle = K.get_tile_handle(kv_linear);
+            const auto &v_tile_handle = V.get_tile_handle(kv_linear);
+            const auto &mask_tile_handle =
+                    mask.get_tile_handle(mask_offset+j);
+            k_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+            v_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+            if(!mask_causal)
+            {
+                mask_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+            }
+            if(mpi_rank == dst_tile_rank)
+            {
+                starpu::flash_attention::submit<T>(seq, head, batch,
+                        k_tile_handle, q_tile_handle, mask_tile_handle,
+                        v_tile_handle, maxsumexp_tile_handle,
+                        dst_tile_handle, dst_tile_traits.shape[2],
+                        kv_group, mask_causal);
+            }
+        }
+        // Flush cache for the output tiles on every node
+        dst_tile_handle.mpi_flush();
+        maxsumexp_tile_handle.mpi_flush();
+    }
+}
+
+template<typename T>
+void flash_attention(const Tensor<T> &Q, const Tensor<T> &K,
+        const Tensor<T> &V, const Tensor<bool_t> &mask,
+        const Tensor<T> &maxsumexp, const Tensor<T> &dst,
+        const std::vector<MaskTile> &layout)
+//! Blocking version of tensor-wise fused attention forward
+/*! Computes dst = V @ softmax(mask(K^T @ Q / sqrt(head))).
+ *
+ * @param[in] Q: Queries of shape [head, seq, batch, n_head]
+ * @param[in] K: Keys of shape [head, seq, batch, n_head_kv]
+ * @param[in] V: Values of shape [head, seq, batch, n_head_kv]
+ * @param[in] mask: Mask of shape [seq, seq], false entries are skipped
+ * @param[out] maxsumexp: Max and sum of exponents of shape
+ *      [2, seq, batch, n_head]
+ * @param[out] dst: Output of shape [head, seq, batch, n_head]
+ * @param[in] layout: Block-sparse layout of mask, see mask_layout()
+ * */
+{
+    flash_attention_async<T>(Q, K, V, mask, maxsumexp, dst, layout);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+template<typename T>
+void flash_attention_ring_async(const Tensor<T> &Q, const Tensor<T> &K,
+        const Tensor<T> &V, const Tensor<bool_t> &mask,
+        const Tensor<T> &maxsumexp, const Tensor<T> &dst,
+        const std::vector<MaskTile> &layout)
+//! Tensor-wise fused attention forward, parallel over sequence
+/*! Computes the same as flash_attention_async(), but tiles of queries, dst
+ * and maxsumexp stay on their nodes, while tiles of keys and values travel
+ * over a ring of nodes, that own tiles of dst of the same batch and head.
+ * Each node receives a tile of keys and values from its neighbour in the
+ * ring, forwards it to the next one and accumulates its contribution into
+ * its own tiles of dst with online softmax. Steps of the ring are submitted
+ * one after another for all tiles of keys and values, so that the first
+ * step only uses local tiles, while tiles of the next step are in flight.
+ * Every node keeps only the tiles of the current and the next step, so the
+ * sequence length is limited by the total memory of all nodes, not by the
+ * memory of a single one. Nodes, that do not need a tile of keys and values
+ * due to the mask, are skipped by the ring.
+ *
+ * @param[in] Q: Queries of shape [head, seq, batch, n_head]
+ * @param[in] K: Keys of shape [head, seq, batch, n_head_kv]
+ * @param[in] V: Values of shape [head, seq, batch, n_head_kv]
+ * @param[in] mask: Mask of shape [seq, seq], false entries are skipped
+ * @param[out] maxsumexp: Max and sum of exponents of shape
+ *      [2, seq, batch, n_head]
+ * @param[out] dst: Output of shape [head, seq, batch, n_head]
+ * @param[in] layout: Block-sparse layout of mask, see mask_layout()
+ * */
+{
+    Index kv_group = check_shapes<T>(Q, K, V, mask, maxsumexp, dst);
+    int mpi_rank = starpu_mpi_world_rank();
+    Index head = Q.shape[0];
+    Index seq = Q.basetile_shape[1];
+    Index nseq = dst.grid.shape[1];
+    auto mask_kinds = mask_layout(mask, layout);
+    // Reset running state of all output tiles
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
+        const auto &maxsumexp_tile_handle = maxsumexp.get_tile_handle(i);
+        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+        if(maxsumexp_tile_handle.mpi_get_rank() != dst_tile_rank)
+        {
+            throw std::runtime_error("maxsumexp and dst tiles must be owned "
+                    "by the same node");
+        }
+        Q.get_tile_handle(i).mpi_transfer(dst_tile_rank, mpi_rank);
+        if(mpi_rank == dst_tile_rank)
+        {
+            starpu::clear::submit(maxsumexp_tile_handle);
+            starpu::clear::submit(dst_tile_handle);
+        }
+    }
+    // Every pair of batch and head tiles is a separate ring
+    std::vector<Index> tile_index(4, 0), mask_tile_index(2);
+    for(Index bh = 0; bh < dst.grid.shape[2]*dst.grid.shape[3]; ++bh)
+    {
+        tile_index[2] = bh % dst.grid.shape[2];
+        tile_index[3] = bh / dst.grid.shape[2];
+        // Nodes of the ring in order of tiles of queries they own
+        std::vector<int> ring;
+        std::vector<Index> ring_pos(nseq);
+        for(Index i = 0; i < nseq; ++i)
+        {
+            tile_index[1] = i;
+            int rank = dst.get_tile_handle(tile_index).mpi_get_rank();
+            Index pos = 0;
+            while(pos < Index(ring.size()) and ring[pos] != rank)
+            {
+                ++pos;
+            }
+            if(pos == Index(ring.size()))
+            {
+                ring.push_back(rank);
+            }
+            ring_pos[i] = pos;
+        }
+        Index nring = ring.size();
+        // Current copies of tiles of keys and values and the nodes, that
+        // still need them, in order of the ring
+        std::vector<starpu::Handle> k_copy(nseq), v_copy(nseq);
+        std::vector<std::vector<Index>> visits(nseq);
+        for(Index j = 0; j < nseq; ++j)
+        {
+            tile_index[1] = j;
+            k_copy[j] = K.get_tile_handle(tile_index);
+            v_copy[j] = V.get_tile_handle(tile_index);
+            // The ring starts at the owner of the tile of keys, if possible
+            int k_rank = k_copy[j].mpi_get_rank();
+            Index start = 0;
+            while(start < nring and ring[start] != k_rank)
+            {
+                ++start;
+            }
+            start = start % nring;
+            std::vector<bool> needed(nring, false);
+            mask_tile_index[0] = j;
+            for(Index i = 0; i < nseq; ++i)
+            {
+                mask_tile_index[1] = i;
+                if(mask_kinds[mask.grid.index_to_linear(mask_tile_index)]
+                        != MaskTile::empty)
+                {
+                    needed[ring_pos[i]] = true;
+                }
+            }
+            for(Index s = 0; s < nring; ++s)
+            {
+                Index pos = (start+s) % nring;
+                if(needed[pos])
+                {
+                    visits[j].push_back(pos);
+                }
+            }
+        }
+        // Steps of the ring
+        for(Index s = 0; s < nring; ++s)
+        {
+            for(Index j = 0; j < nseq; ++j)
+            {
+                if(s >= Index(visits[j].size()))
+                {
+                    continue;
+                }
+                int rank = ring[visits[j][s]];
+                bool forward = s+1 < Index(visits[j].size());
+                // Bring tiles to the node of the current step. Unless this
+                // is the last step, a copy is owned by the node, so that
+                // the next node receives it from its neighbour.
+                starpu::Handle *copies[2] = {&k_copy[j], &v_copy[j]};
+                for(auto copy: copies)
+                {
+                    if(copy->mpi_get_rank() == rank)
+                    {
+                        continue;
+                    }
+                    copy->mpi_transfer(rank, mpi_rank);
+                    if(not forward)
+                    {
+                        continue;
+                    }
+                    tile_index[1] = j;
+                    std::size_t size = K.get_tile_traits(tile_index).nelems
+                        * sizeof(T);
+                    starpu::VariableHandle tmp(size, STARPU_SCRATCH);
+#ifdef NNTILE_USE_MPI
+                    starpu_mpi_data_register(
+                            static_cast<starpu_data_handle_t>(tmp),
+                            ring_tag(), rank);
+#endif // NNTILE_USE_MPI
+                    if(mpi_rank == rank)
+                    {
+                        starpu::copy::submit(*copy, tmp);
+                    }
+                    // Previous copy is not needed on this node anymore
+                    copy->mpi_flush();
+                    *copy = tmp;
+                }
+                // Accumulate into all the tiles of dst of the node
+                mask_tile_index[0] = j;
+                for(Index i = 0; i < nseq; ++i)
+                {
+                    if(ring[ring_pos[i]] != rank)
+                    {
+                        continue;
+                    }
+                    mask_tile_index[1] = i;
+                    auto mask_kind = mask_kinds[mask.grid.index_to_linear(
+                            mask_tile_index)];
+                    if(mask_kind == MaskTile::empty)
+                    {
+                        continue;
+                    }
+                    int mask_causal = mask_kind == MaskTile::causal;
+                    const auto &mask_tile_handle =
+                            mask.get_tile_handle(mask_tile_index);
+                    if(!mask_causal)
+                    {
+                        mask_tile_handle.mpi_transfer(rank, mpi_rank);
+                    }
+                    tile_index[1] = i;
+                    if(mpi_rank == rank)
+                    {
+                        const auto &dst_tile_traits = dst.get_tile_traits(
+                                tile_index);
+                        Index batch = dst_tile_traits.shape[2]
+                            * dst_tile_traits.shape[3];
+                        starpu::flash_attention::submit<T>(seq, head, batch,
+                                k_copy[j], Q.get_tile_handle(tile_index),
+                                mask_tile_handle, v_copy[j],
+                                maxsumexp.get_tile_handle(tile_index),
+                                dst.get_tile_handle(tile_index),
+                                dst_tile_traits.shape[2], kv_group,
+                                mask_causal);
+                    }
+                }
+                // Copy of the last step is used only by its node
+                if(not forward)
+                {
+                    k_copy[j].mpi_flush();
+                    v_copy[j].mpi_flush();
+                }
+            }
+        }
+    }
+    // Flush cache for the output tiles on every node
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        dst.get_tile_handle(i).mpi_flush();
+        maxsumexp.get_tile_handle(i).mpi_flush();
+    }
+}
+
+template<typename T>
+void flash_attention_ring(const Tensor<T> &Q, const Tensor<T> &K,
+        const Tensor<T> &V, const Tensor<bool_t> &mask,
+        const Tensor<T> &maxsumexp, const Tensor<T> &dst,
+        const std::vector<MaskTile> &layout)
+//! Blocking version of tensor-wise fused attention forward over a ring
+/*! Computes dst = V @ softmax(mask(K^T @ Q / sqrt(head))).
+ *
+ * @param[in] Q: Queries of shape [head, seq, batch, n_head]
+ * @param[in] K: Keys of shape [head, seq, batch, n_head_kv]
+ * @param[in] V: Values of shape [head, seq, batch, n_head_kv]
+ * @param[in] mask: Mask of shape [seq, seq], false entries are skipped
+ * @param[out] maxsumexp: Max and sum of exponents of shape
+ *      [2, seq, batch, n_head]
+ * @param[out] dst: Output of shape [head, seq, batch, n_head]
+ * @param[in] layout: Block-sparse layout of mask, see mask_layout()
+ * */
+{
+    flash_attention_ring_async<T>(Q, K, V, mask, maxsumexp, dst, layout);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void flash_attention_async<fp32_t>(const Tensor<fp32_t> &Q,
+        const Tensor<fp32_t> &K, const Tensor<fp32_t> &V,
+        const Tensor<bool_t> &mask, const Tensor<fp32_t> &maxsumexp,
+        const Tensor<fp32_t> &dst, const std::vector<MaskTile> &layout);
+
+template
+void flash_attention_async<fp64_t>(const Tensor<fp64_t> &Q,
+        const Tensor<fp64_t> &K, const Tensor<fp64_t> &V,
+        const Tensor<bool_t> &mask, const Tensor<fp64_t> &maxsumexp,
+        const Tensor<fp64_t> &dst, const std::vector<MaskTile> &layout);
+
+// Explicit instantiation
+template
+void flash_attention<fp32_t>(const Tensor<fp32_t> &Q,
+        const Tensor<fp32_t> &K, const Tensor<fp32_t> &V,
+        const Tensor<bool_t> &mask, const Tensor<fp32_t> &maxsumexp,
+        const Tensor<fp32_t> &dst, const std::vector<MaskTile> &layout);
+
+template
+void flash_attention<fp64_t>(const Tensor<fp64_t> &Q,
+        const Tensor<fp64_t> &K, const Tensor<fp64_t> &V,
+        const Tensor<bool_t> &mask, const Tensor<fp64_t> &maxsumexp,
+        const Tensor<fp64_t> &dst, const std::vector<MaskTile> &layout);
+
+// Explicit instantiation
+template
+void flash_attention_ring_async<fp32_t>(const Tensor<fp32_t> &Q,
+        const Tensor<fp32_t> &K, const Tensor<fp32_t> &V,
+        const Tensor<bool_t> &mask, const Tensor<fp32_t> &maxsumexp,
+        const Tensor<fp32_t> &dst, const std::vector<MaskTile> &layout);
+
+template
+void flash_attention_ring_async<fp64_t>(const Tensor<fp64_t> &Q,
+        const Tensor<fp64_t> &K, const Tensor<fp64_t> &V,
+        const Tensor<bool_t> &mask, const Tensor<fp64_t> &maxsumexp,
+        const Tensor<fp64_t> &dst, const std::vector<MaskTile> &layout);
+
+// Explicit instantiation
+template
+void flash_attention_ring<fp32_t>(const Tensor<fp32_t> &Q,
+        const Tensor<fp32_t> &K, const Tensor<fp32_t> &V,
+        const Tensor<bool_t> &mask, const Tensor<fp32_t> &maxsumexp,
+        const Tensor<fp32_t> &dst, const std::vector<MaskTile> &layout);
+
+template
+void flash_attention_ring<fp64_t>(const Tensor<fp64_t> &Q,
+        const Tensor<fp64_t> &K, const Tensor<fp64_t> &V,
+        const Tensor<bool_t> &mask, const Tensor<fp64_t> &maxsumexp,
+        const Tensor<fp64_t> &dst, const std::vector<MaskTile> &layout);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,287 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/flash_attention_backward.cc
+ * Fused single-pass flash attention backward
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#include "nntile/tensor/flash_attention_backward.hh"
+#include "nntile/tensor/mask_tiles.hh"
+#include "nntile/tensor/sumprod_slice.hh"
+#include "nntile/starpu/flash_attention_backward.hh"
+#include "nntile/starpu/clear.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void flash_attention_backward_async(const Tensor<T> &Q, const Tensor<T> &dQ,
+        const Tensor<T> &K, const Tensor<T> &dK, const Tensor<T> &V,
+        const Tensor<T> &dV, const Tensor<bool_t> &mask,
+        const Tensor<T> &maxsumexp, const Tensor<T> &dst,
+        const Tensor<T> &dst_grad, const Tensor<T> &sumprod_slice, int redux,
+        const std::vector<MaskTile> &layout)
+//! Tensor-wise fused attention backward
+/*! Computes gradients dQ, dK and dV of dst = V @ softmax(mask(K^T @ Q /
+ * sqrt(head))) with a single pass over all pairs of tiles of queries and
+ * keys. Attention weights are recomputed from maxsumexp, produced by
+ * flash_attention, and no seq by seq temporary tensor is needed. Gradients
+ * are overwritten. Tasks are executed on the node, that owns the dK tile,
+ * therefore all tiles of dQ, dK and dV of the same batch and head must be
+ * owned by the same node.
+ *
+ * @param[in] Q: Queries of shape [head, seq, batch, n_head]
+ * @param[out] dQ: Gradient of queries
+ * @param[in] K: Keys of shape [head, seq, batch, n_head]
+ * @param[out] dK: Gradient of keys
+ * @param[in] V: Values of shape [head, seq, batch, n_head]
+ * @param[out] dV: Gradient of values
+ * @param[in] mask: Mask of shape [seq, seq], false entries are skipped
+ * @param[in] maxsumexp: Max and sum of exponents of shape
+ *      [2, seq, batch, n_head] as computed by flash_attention
+ * @param[in] dst: Output of flash_attention
+ * @param[in] dst_grad: Gradient of the output
+ * @param[out] sumprod_slice: Temporary tensor of shape [seq, batch, n_head]
+ * @param[in] redux: Whether to use STARPU_REDUX for sumprod_slice
+ * @param[in] layout: Block-sparse layout of mask, see mask_layout()
+ * */
+{
+    // Check dimensions
+    if(Q.ndim != 4)
+    {
+        throw std::runtime_error("Q.ndim != 4");
+    }
+    if(dQ.shape != Q.shape or K.shape != Q.shape or dK.shape != Q.shape
+            or V.shape != Q.shape or dV.shape != Q.shape
+            or dst.shape != Q.shape or dst_grad.shape != Q.shape)
+    {
+        throw std::runtime_error("Q, dQ, K, dK, V, dV, dst and dst_grad must "
+                "have the same shape");
+    }
+    if(dQ.basetile_shape != Q.basetile_shape
+            or K.basetile_shape != Q.basetile_shape
+            or dK.basetile_shape != Q.basetile_shape
+            or V.basetile_shape != Q.basetile_shape
+            or dV.basetile_shape != Q.basetile_shape
+            or dst.basetile_shape != Q.basetile_shape
+            or dst_grad.basetile_shape != Q.basetile_shape)
+    {
+        throw std::runtime_error("Q, dQ, K, dK, V, dV, dst and dst_grad must "
+                "have the same basetile_shape");
+    }
+    if(Q.basetile_shape[0] != Q.shape[0])
+    {
+        throw std::runtime_error("Q.basetile_shape[0] != Q.shape[0]");
+    }
+    if(Q.shape[1] % Q.basetile_shape[1] != 0)
+    {
+        throw std::runtime_error("Q.shape[1] % Q.basetile_shape[1] != 0");
+    }
+    if(mask.ndim != 2)
+    {
+        throw std::runtime_error("mask.ndim != 2");
+    }
+    if(mask.shape[0] != Q.shape[1] or mask.shape[1] != Q.shape[1])
+    {
+        throw std::runtime_error("mask.shape != [Q.shape[1], Q.shape[1]]");
+    }
+    if(mask.basetile_shape[0] != Q.basetile_shape[1]
+            or mask.basetile_shape[1] != Q.basetile_shape[1])
+    {
+        throw std::runtime_error("mask.basetile_shape != "
+                "[Q.basetile_shape[1], Q.basetile_shape[1]]");
+    }
+    if(maxsumexp.ndim != 4)
+    {
+        throw std::runtime_error("maxsumexp.ndim != 4");
+    }
+    if(maxsumexp.shape[0] != 2 or maxsumexp.basetile_shape[0] != 2)
+    {
+        throw std::runtime_error("maxsumexp.shape[0] != 2 or "
+                "maxsumexp.basetile_shape[0] != 2");
+    }
+    for(Index i = 1; i < 4; ++i)
+    {
+        if(maxsumexp.shape[i] != Q.shape[i])
+        {
+            throw std::runtime_error("maxsumexp.shape[i] != Q.shape[i]");
+        }
+        if(maxsumexp.basetile_shape[i] != Q.basetile_shape[i])
+        {
+            throw std::runtime_error("maxsumexp.basetile_shape[i] != "
+                    "Q.basetile_shape[i]");
+        }
+    }
+    // sumprod_slice[q,b] = sum_h dst[h,q,b] * dst_grad[h,q,b], shapes of
+    // sumprod_slice are checked by the sumprod_slice operation itself
+    sumprod_slice_async<T>(1.0, dst, dst_grad, 0.0, sumprod_slice, 0, redux);
+    // Do actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    Index head = Q.shape[0];
+    Index seq = Q.basetile_shape[1];
+    // Pairs of tiles with an empty tile of mask contribute nothing
+    auto mask_kinds = mask_layout(mask, layout);
+    // Clear gradients at first
+    for(Index i = 0; i < dK.grid.nelems; ++i)
+    {
+        const auto &dQ_tile_handle = dQ.get_tile_handle(i);
+        const auto &dK_tile_handle = dK.get_tile_handle(i);
+        const auto &dV_tile_handle = dV.get_tile_handle(i);
+        int dK_tile_rank = dK_tile_handle.mpi_get_rank();
+        if(dQ_tile_handle.mpi_get_rank() != dK_tile_rank
+                or dV_tile_handle.mpi_get_rank() != dK_tile_rank)
+        {
+            throw std::runtime_error("dQ, dK and dV tiles must be owned by "
+                    "the same node");
+        }
+        if(mpi_rank == dK_tile_rank)
+        {
+            starpu::clear::submit(dQ_tile_handle);
+            starpu::clear::submit(dK_tile_handle);
+            starpu::clear::submit(dV_tile_handle);
+        }
+    }
+    // Cycle over all tiles of keys and values
+    std::vector<Index> kv_tile_index;
+    for(Index i = 0; i < dK.grid.nelems; ++i)
+    {
+        const auto &dK_tile_handle = dK.get_tile_handle(i);
+        const auto &dV_tile_handle = dV.get_tile_handle(i);
+        int dK_tile_rank = dK_tile_handle.mpi_get_rank();
+        dK.grid.linear_to_index(i, kv_tile_index);
+        const auto &kv_tile_traits = dK.get_tile_traits(i);
+        Index batch = kv_tile_traits.shape[2] * kv_tile_traits.shape[3];
+        const auto &k_tile_handle = K.get_tile_handle(i);
+        const auto &v_tile_handle = V.get_tile_handle(i);
+        k_tile_handle.mpi_transfer(dK_tile_rank, mpi_rank);
+        v_tile_handle.mpi_transfer(dK_tile_rank, mpi_rank);
+        // Cycle over all tiles of queries of the same batch and head
+        std::vector<Index> q_tile_index(kv_tile_index), mask_tile_index(2),
+            sumprod_slice_tile_index(3);
+        mask_tile_index[0] = kv_tile_index[1];
+        sumprod_slice_tile_index[1] = kv_tile_index[2];
+        sumprod_slice_tile_index[2] = kv_tile_index[3];
+        for(Index j = 0; j < Q.grid.shape[1]; ++j)
+        {
+            q_tile_index[1] = j;
+            mask_tile_index[1] = j;
+            auto mask_kind = mask_kinds[mask.grid.index_to_linear(
+                    mask_tile_index)];
+            if(mask_kind == MaskTile::empty)
+            {
+                continue;
+            }
+            // Causal tile of mask is generated by the kernel
+            int mask_causal = mask_kind == MaskTile::causal;
+            sumprod_slice_tile_index[0] = j;
+            const auto &q_tile_handle = Q.get_tile_handle(q_tile_index);
+            const auto &dQ_tile_handle = dQ.get_tile_handle(q_tile_index);
+            const auto &dst_grad_tile_handle = dst_grad.get_tile_handle(
+                    q_tile_index);
+            const auto &maxsumexp_tile_handle = maxsumexp.get_tile_handle(
+                    q_tile_index);
+            const auto &mask_tile_handle =
+                    mask.get_tile_handle(mask_tile_index);
+            const auto &sumprod_slice_tile_handle =
+                    sumprod_slice.get_tile_handle(
+                    sumprod_slice_tile_index);
+            if(dQ_tile_handle.mpi_get_rank() != dK_tile_rank)
+            {
+                throw std::runtime_error("dQ, dK and dV tiles must be owned "
+                        "by the same node");
+            }
+            q_tile_handle.mpi_transfer(dK_tile_rank, mpi_rank);
+            dst_grad_tile_handle.mpi_transfer(dK_tile_rank, mpi_rank);
+            maxsumexp_tile_handle.mpi_transfer(dK_tile_rank, mpi_rank);
+            if(!mask_causal)
+            {
+                mask_tile_handle.mpi_transfer(dK_tile_rank, mpi_rank);
+            }
+            sumprod_slice_tile_handle.mpi_transfer(dK_tile_rank, mpi_rank);
+            if(mpi_rank == dK_tile_rank)
+            {
+                starpu::flash_attention_backward::submit<T>(seq, head, batch,
+                        k_tile_handle, q_tile_handle, mask_tile_handle,
+                        maxsumexp_tile_handle, dst_grad_tile_handle,
+                        v_tile_handle, sumprod_slice_tile_handle,
+                        dQ_tile_handle, dK_tile_handle, dV_tile_handle,
+                        mask_causal);
+            }
+        }
+        // Flush cache for the output tiles on every node
+        dK_tile_handle.mpi_flush();
+        dV_tile_handle.mpi_flush();
+    }
+    for(Index i = 0; i < dQ.grid.nelems; ++i)
+    {
+        dQ.get_tile_handle(i).mpi_flush();
+    }
+}
+
+template<typename T>
+void flash_attention_backward(const Tensor<T> &Q, const Tensor<T> &dQ,
+        const Tensor<T> &K, const Tensor<T> &dK, const Tensor<T> &V,
+        const Tensor<T> &dV, const Tensor<bool_t> &mask,
+        const Tensor<T> &maxsumexp, const Tensor<T> &dst,
+        const Tensor<T> &dst_grad, const Tensor<T> &sumprod_slice, int redux,
+        const std::vector<MaskTile> &layout)
+//! Blocking version of tensor-wise fused attention backward
+/*! See flash_attention_backward_async for the description of arguments.
+ * */
+{
+    flash_attention_backward_async<T>(Q, dQ, K, dK, V, dV, mask, maxsumexp,
+            dst, dst_grad, sumprod_slice, redux, layout);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void flash_attention_backward_async<fp32_t>(const Tensor<fp32_t> &Q,
+        const Tensor<fp32_t> &dQ, const Tensor<fp32_t> &K,
+        const Tensor<fp32_t> &dK, const Tensor<fp32_t> &V,
+        const Tensor<fp32_t> &dV, const Tensor<bool_t> &mask,
+        const Tensor<fp32_t> &maxsumexp, const Tensor<fp32_t> &dst,
+        const Tensor<fp32_t> &dst_grad, const Tensor<fp32_t> &sumprod_slice,
+        int redux, const std::vector<MaskTile> &layout);
+
+template
+void flash_attention_backward_async<fp64_t>(const Tensor<fp64_t> &Q,
+        const Tensor<fp64_t> &dQ, const Tensor<fp64_t> &K,
+        const Tensor<fp64_t> &dK, const Tensor<fp64_t> &V,
+        const Tensor<fp64_t> &dV, const Tensor<bool_t> &mask,
+        const Tensor<fp64_t> &maxsumexp, const Tensor<fp64_t> &dst,
+        const Tensor<fp64_t> &dst_grad, const Tensor<fp64_t> &sumprod_slice,
+        int redux, const std::vector<MaskTile> &layout);
+
+// Explicit instantiation
+template
+void flash_attention_backward<fp32_t>(const Tensor<fp32_t> &Q,
+        const Tensor<fp32_t> &dQ, const Tensor<fp32_t> &K,
+        const Tensor<fp32_t> &dK, const Tensor<fp32_t> &V,
+        const Tensor<fp32_t> &dV, const Tensor<bool_t> &mask,
+        const Tensor<fp32_t> &maxsumexp, const Tensor<fp32_t> &dst,
+        const Tensor<fp32_t> &dst_grad, const Tensor<fp32_t> &sumprod_slice,
+        int redux, const std::vector<MaskTile> &layout);
+
+template
+void flash_attention_backward<fp64_t>(const Tensor<fp64_t> &Q,
+        const Tensor<fp64_t> &dQ, const Tensor<fp64_t> &K,
+        const Tensor<fp64_t> &dK, const Tensor<fp64_t> &V,
+        const Tensor<fp64_t> &dV, const Tensor<bool_t> &mask,
+        const Tensor<fp64_t> &maxsumexp, const Tensor<fp64_t> &dst,
+        const Tensor<fp64_t> &dst_grad, const Tensor<fp64_t> &sumprod_slice,
+        int redux, const std::vector<MaskTile> &layout);
+
+} // namespace tensor
+} // namespace nntile
+
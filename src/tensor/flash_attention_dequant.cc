@@ -0,0 +1,306 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/flash_attention_dequant.cc
+ * Fused attention over quantized keys and values for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/flash_attention_dequant.hh"
+#include "nntile/starpu/flash_attention_dequant.hh"
+#include "nntile/starpu/clear.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename Q>
+void flash_attention_dequant_async(const Tensor<fp32_t> &query,
+        const Tensor<Q> &K, const Tensor<fp32_t> &K_scale,
+        const Tensor<Q> &V, const Tensor<fp32_t> &V_scale,
+        const Tensor<bool_t> &mask, const Tensor<fp32_t> &maxsumexp,
+        const Tensor<fp32_t> &dst)
+//! Tensor-wise fused attention over quantized keys and values
+/*! Computes dst = V @ softmax(mask(K^T @ query / sqrt(head))) with a single
+ * pass over tiles of keys and values as flash_attention_async() does, but
+ * keys and values are 8-bit tensors, e.g., a quantized KV-cache, that are
+ * dequantized on the fly. Scales are shared by all the elements of a head
+ * of a token, as produced by quantize_async() along the axis 0 with groups
+ * of the size of a head. The number of keys may differ from the number of
+ * queries. Mask of shape [k_seq, q_seq, batch] sets keys of every sequence
+ * separately.
+ *
+ * @param[in] query: Queries of shape [head, q_seq, batch, n_head]
+ * @param[in] K: Quantized keys of shape [head, k_seq, batch, n_head_kv]
+ * @param[in] K_scale: Scales of keys of shape [1, k_seq, batch, n_head_kv]
+ * @param[in] V: Quantized values of shape [head, k_seq, batch, n_head_kv]
+ * @param[in] V_scale: Scales of values of shape [1, k_seq, batch,
+ *      n_head_kv]
+ * @param[in] mask: Mask of shape [k_seq, q_seq] or [k_seq, q_seq, batch],
+ *      false entries are skipped
+ * @param[out] maxsumexp: Max and sum of exponents of shape
+ *      [2, q_seq, batch, n_head]
+ * @param[out] dst: Output of shape [head, q_seq, batch, n_head]
+ * */
+{
+    // Check dimensions
+    if(query.ndim != 4)
+    {
+        throw std::runtime_error("query.ndim != 4");
+    }
+    if(dst.shape != query.shape
+            or dst.basetile_shape != query.basetile_shape)
+    {
+        throw std::runtime_error("query and dst must have the same shape and "
+                "basetile_shape");
+    }
+    if(K.ndim != 4)
+    {
+        throw std::runtime_error("K.ndim != 4");
+    }
+    if(V.shape != K.shape or V.basetile_shape != K.basetile_shape)
+    {
+        throw std::runtime_error("K and V must have the same shape and "
+                "basetile_shape");
+    }
+    if(K_scale.shape != V_scale.shape
+            or K_scale.basetile_shape != V_scale.basetile_shape)
+    {
+        throw std::runtime_error("K_scale and V_scale must have the same "
+                "shape and basetile_shape");
+    }
+    // A head is a single group of scales
+    if(query.basetile_shape[0] != query.shape[0])
+    {
+        throw std::runtime_error("query.basetile_shape[0] != "
+                "query.shape[0]");
+    }
+    if(K.shape[0] != query.shape[0] or K.basetile_shape[0] != K.shape[0])
+    {
+        throw std::runtime_error("K.shape[0] != query.shape[0] or "
+                "K.basetile_shape[0] != K.shape[0]");
+    }
+    if(K_scale.ndim != 4)
+    {
+        throw std::runtime_error("K_scale.ndim != 4");
+    }
+    if(K_scale.shape[0] != 1 or K_scale.basetile_shape[0] != 1)
+    {
+        throw std::runtime_error("K_scale.shape[0] != 1 or "
+                "K_scale.basetile_shape[0] != 1");
+    }
+    for(Index i = 1; i < 4; ++i)
+    {
+        if(K_scale.shape[i] != K.shape[i])
+        {
+            throw std::runtime_error("K_scale.shape[i] != K.shape[i]");
+        }
+        if(K_scale.basetile_shape[i] != K.basetile_shape[i])
+        {
+            throw std::runtime_error("K_scale.basetile_shape[i] != "
+                    "K.basetile_shape[i]");
+        }
+    }
+    if(K.shape[2] != query.shape[2])
+    {
+        throw std::runtime_error("K.shape[2] != query.shape[2]");
+    }
+    if(K.basetile_shape[2] != query.basetile_shape[2])
+    {
+        throw std::runtime_error("K.basetile_shape[2] != "
+                "query.basetile_shape[2]");
+    }
+    // Tiles of queries contain all the heads, that share tiles of keys
+    if(query.shape[3] % K.shape[3] != 0)
+    {
+        throw std::runtime_error("query.shape[3] % K.shape[3] != 0");
+    }
+    Index kv_group = query.shape[3] / K.shape[3];
+    if(K.basetile_shape[3]*kv_group != query.basetile_shape[3])
+    {
+        throw std::runtime_error("K.basetile_shape[3]*kv_group != "
+                "query.basetile_shape[3]");
+    }
+    if(mask.ndim != 2 and mask.ndim != 3)
+    {
+        throw std::runtime_error("mask.ndim != 2 and mask.ndim != 3");
+    }
+    if(mask.shape[0] != K.shape[1] or mask.shape[1] != query.shape[1])
+    {
+        throw std::runtime_error("mask.shape[:2] != [K.shape[1], "
+                "query.shape[1]]");
+    }
+    if(mask.basetile_shape[0] != K.basetile_shape[1]
+            or mask.basetile_shape[1] != query.basetile_shape[1])
+    {
+        throw std::runtime_error("mask.basetile_shape[:2] != "
+                "[K.basetile_shape[1], query.basetile_shape[1]]");
+    }
+    if(mask.ndim == 3 and (mask.shape[2] != query.shape[2]
+                or mask.basetile_shape[2] != query.basetile_shape[2]))
+    {
+        throw std::runtime_error("mask.shape[2] != query.shape[2] or "
+                "mask.basetile_shape[2] != query.basetile_shape[2]");
+    }
+    if(maxsumexp.ndim != 4)
+    {
+        throw std::runtime_error("maxsumexp.ndim != 4");
+    }
+    if(maxsumexp.shape[0] != 2 or maxsumexp.basetile_shape[0] != 2)
+    {
+        throw std::runtime_error("maxsumexp.shape[0] != 2 or "
+                "maxsumexp.basetile_shape[0] != 2");
+    }
+    for(Index i = 1; i < 4; ++i)
+    {
+        if(maxsumexp.shape[i] != query.shape[i])
+        {
+            throw std::runtime_error("maxsumexp.shape[i] != "
+                    "query.shape[i]");
+        }
+        if(maxsumexp.basetile_shape[i] != query.basetile_shape[i])
+        {
+            throw std::runtime_error("maxsumexp.basetile_shape[i] != "
+                    "query.basetile_shape[i]");
+        }
+    }
+    // Do actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    Index head = query.shape[0];
+    std::vector<Index> dst_tile_index;
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        // Output tiles are updated on the node, that owns dst tile
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
+        const auto &maxsumexp_tile_handle = maxsumexp.get_tile_handle(i);
+        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+        if(maxsumexp_tile_handle.mpi_get_rank() != dst_tile_rank)
+        {
+            throw std::runtime_error("maxsumexp and dst tiles must be owned "
+                    "by the same node");
+        }
+        dst.grid.linear_to_index(i, dst_tile_index);
+        const auto &dst_tile_traits = dst.get_tile_traits(i);
+        Index q_seq = dst_tile_traits.shape[1];
+        Index n_batch = dst_tile_traits.shape[2];
+        Index batch = n_batch * dst_tile_traits.shape[3];
+        const auto &q_tile_handle = query.get_tile_handle(i);
+        q_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        // Reset running state
+        if(mpi_rank == dst_tile_rank)
+        {
+            starpu::clear::submit(maxsumexp_tile_handle);
+            starpu::clear::submit(dst_tile_handle);
+        }
+        // Accumulate contributions of all tiles of keys and values
+        std::vector<Index> kv_tile_index(dst_tile_index),
+            mask_tile_index(mask.ndim);
+        mask_tile_index[1] = dst_tile_index[1];
+        if(mask.ndim == 3)
+        {
+            mask_tile_index[2] = dst_tile_index[2];
+        }
+        for(Index j = 0; j < K.grid.shape[1]; ++j)
+        {
+            kv_tile_index[1] = j;
+            mask_tile_index[0] = j;
+            const auto &kv_tile_traits = K.get_tile_traits(kv_tile_index);
+            Index k_seq = kv_tile_traits.shape[1];
+            // Every sequence of a 3-dimensional mask has its own tile slice
+            Index mask_stride = (mask.ndim == 3) ? k_seq*q_seq : 0;
+            const auto &k_tile_handle = K.get_tile_handle(kv_tile_index);
+            const auto &k_scale_tile_handle =
+                    K_scale.get_tile_handle(kv_tile_index);
+            const auto &v_tile_handle = V.get_tile_handle(kv_tile_index);
+            const auto &v_scale_tile_handle =
+                    V_scale.get_tile_handle(kv_tile_index);
+            const auto &mask_tile_handle =
+                    mask.get_tile_handle(mask_tile_index);
+            k_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+            k_scale_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+            v_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+            v_scale_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+            mask_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+            if(mpi_rank == dst_tile_rank)
+            {
+                starpu::flash_attention_dequant::submit<Q>(k_seq, q_seq,
+                        head, batch, k_tile_handle, k_scale_tile_handle,
+                        q_tile_handle, mask_tile_handle, v_tile_handle,
+                        v_scale_tile_handle, maxsumexp_tile_handle,
+                        dst_tile_handle, n_batch, kv_group, mask_stride);
+            }
+        }
+        // Flush cache for the output tiles on every node
+        dst_tile_handle.mpi_flush();
+        maxsumexp_tile_handle.mpi_flush();
+    }
+}
+
+template<typename Q>
+void flash_attention_dequant(const Tensor<fp32_t> &query,
+        const Tensor<Q> &K, const Tensor<fp32_t> &K_scale,
+        const Tensor<Q> &V, const Tensor<fp32_t> &V_scale,
+        const Tensor<bool_t> &mask, const Tensor<fp32_t> &maxsumexp,
+        const Tensor<fp32_t> &dst)
+//! Blocking version of fused attention over quantized keys and values
+/*! Computes dst = V @ softmax(mask(K^T @ query / sqrt(head))).
+ *
+ * @param[in] query: Queries of shape [head, q_seq, batch, n_head]
+ * @param[in] K: Quantized keys of shape [head, k_seq, batch, n_head_kv]
+ * @param[in] K_scale: Scales of keys of shape [1, k_seq, batch, n_head_kv]
+ * @param[in] V: Quantized values of shape [head, k_seq, batch, n_head_kv]
+ * @param[in] V_scale: Scales of values of shape [1, k_seq, batch,
+ *      n_head_kv]
+ * @param[in] mask: Mask of shape [k_seq, q_seq] or [k_seq, q_seq, batch],
+ *      false entries are skipped
+ * @param[out] maxsumexp: Max and sum of exponents of shape
+ *      [2, q_seq, batch, n_head]
+ * @param[out] dst: Output of shape [head, q_seq, batch, n_head]
+ * */
+{
+    flash_attention_dequant_async<Q>(query, K, K_scale, V, V_scale, mask,
+            maxsumexp, dst);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void flash_attention_dequant_async<std::int8_t>(const Tensor<fp32_t> &query,
+        const Tensor<std::int8_t> &K, const Tensor<fp32_t> &K_scale,
+        const Tensor<std::int8_t> &V, const Tensor<fp32_t> &V_scale,
+        const Tensor<bool_t> &mask, const Tensor<fp32_t> &maxsumexp,
+        const Tensor<fp32_t> &dst);
+
+template
+void flash_attention_dequant_async<fp8_e4m3_t>(const Tensor<fp32_t> &query,
+        const Tensor<fp8_e4m3_t> &K, const Tensor<fp32_t> &K_scale,
+        const Tensor<fp8_e4m3_t> &V, const Tensor<fp32_t> &V_scale,
+        const Tensor<bool_t> &mask, const Tensor<fp32_t> &maxsumexp,
+        const Tensor<fp32_t> &dst);
+
+// Explicit instantiation
+template
+void flash_attention_dequant<std::int8_t>(const Tensor<fp32_t> &query,
+        const Tensor<std::int8_t> &K, const Tensor<fp32_t> &K_scale,
+        const Tensor<std::int8_t> &V, const Tensor<fp32_t> &V_scale,
+        const Tensor<bool_t> &mask, const Tensor<fp32_t> &maxsumexp,
+        const Tensor<fp32_t> &dst);
+
+template
+void flash_attention_dequant<fp8_e4m3_t>(const Tensor<fp32_t> &query,
+        const Tensor<fp8_e4m3_t> &K, const Tensor<fp32_t> &K_scale,
+        const Tensor<fp8_e4m3_t> &V, const Tensor<fp32_t> &V_scale,
+        const Tensor<bool_t> &mask, const Tensor<fp32_t> &maxsumexp,
+        const Tensor<fp32_t> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
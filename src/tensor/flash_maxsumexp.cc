@@ -13,7 +13,9 @@
  * */
 
 #include "nntile/tensor/flash_maxsumexp.hh"
+#include "nntile/tensor/mask_tiles.hh"
 #include "nntile/starpu/flash_maxsumexp.hh"
+#include "nntile/starpu/submitters.hh"
 #include <cmath>
 #include <limits>
 
@@ -26,7 +28,8 @@ namespace tensor
 template<typename T>
 void flash_maxsumexp_async(const Tensor<T> &Q, const Tensor<T> &K,
         const Tensor<bool_t> &mask, const Tensor<T> &maxsumexp,
-        const Tensor<T> &tmp, int redux, int fp32_fast_tf32)
+        const Tensor<T> &tmp, int redux, int fp32_fast_tf32,
+        const std::vector<MaskTile> &layout)
 {
 //    // Check dimensions
 //    if(src.ndim != dst.ndim)
@@ -86,43 +89,69 @@ void flash_maxsumexp_async(const Tensor<T> &Q, const Tensor<T> &K,
     Index n_seq_tile = Q.basetile_shape[1];
     Index n_batch_tile = Q.basetile_shape[2];
     Index n_head_tile = Q.basetile_shape[3];
-    for(Index i = 0; i < maxsumexp.grid.nelems; ++i)
+    // Grouped-query attention: every head of K serves kv_group heads of Q
+    if(Q.shape[3] % K.shape[3] != 0)
+    {
+        throw std::runtime_error("Q.shape[3] % K.shape[3] != 0");
+    }
+    Index kv_group = Q.shape[3] / K.shape[3];
+    if(K.basetile_shape[3]*kv_group != n_head_tile)
+    {
+        throw std::runtime_error("K.basetile_shape[3]*kv_group != "
+                "Q.basetile_shape[3]");
+    }
+    // Pairs of tiles with an empty tile of mask are skipped
+    auto mask_kinds = mask_layout(mask, layout);
+    // Every tile of maxsumexp is accumulated by tasks, that are submitted by
+    // the same thread in order
+    auto submit_tile = [&](Index i)
     {
         // Destination tile on dest node must be already prepared (cleared)
-        auto maxsumexp_tile_handle = maxsumexp.get_tile_handle(i);
-        // Obtain indices of applicable source tiles
-        auto maxsumexp_tile_index = maxsumexp.grid.linear_to_index(i);
-        std::vector<Index> tmp_tile_index(maxsumexp_tile_index),
-            q_tile_index(maxsumexp_tile_index),
-            k_tile_index(maxsumexp_tile_index),
-            mask_tile_index(2);
-        auto q_tile_handle = Q.get_tile_handle(q_tile_index);
-        mask_tile_index[1] = maxsumexp_tile_index[1];
+        const auto &maxsumexp_tile_handle = maxsumexp.get_tile_handle(i);
+        // Tiles of Q and maxsumexp share the same grid, while grids of K,
+        // tmp and mask differ only along sequence axes. Linear offsets of
+        // applicable tiles are computed directly, so that no index is
+        // allocated for every task
+        const Index q_seq = i % maxsumexp.grid.shape[1];
+        const Index batch_head = i / maxsumexp.grid.shape[1];
+        const auto &q_tile_handle = Q.get_tile_handle(i);
+        const Index k_offset = batch_head * K.grid.stride[2];
+        const Index tmp_offset = q_seq*tmp.grid.stride[1]
+            + batch_head*tmp.grid.stride[2];
+        const Index mask_offset = q_seq * mask.grid.stride[1];
         // Launch kernel for each appropriate tile of K to accumulate maxsumexp
         // result
         for(Index j = 0; j < K.grid.shape[1]; ++j)
         {
-            tmp_tile_index[0] = j;
-            k_tile_index[1] = j;
-            mask_tile_index[0] = j;
-            auto tmp_tile_handle = tmp.get_tile_handle(tmp_tile_index);
-            auto k_tile_handle = K.get_tile_handle(k_tile_index);
-            auto mask_tile_handle = mask.get_tile_handle(mask_tile_index);
+            auto mask_kind = mask_kinds[mask_offset+j];
+            if(mask_kind == MaskTile::empty)
+            {
+                continue;
+            }
+            const auto &tmp_tile_handle = tmp.get_tile_handle(tmp_offset+j);
+            const auto &k_tile_handle = K.get_tile_handle(
+                    k_offset+j*K.grid.stride[1]);
+            const auto &mask_tile_handle =
+                    mask.get_tile_handle(mask_offset+j);
             // Insert tasks
             starpu::flash_maxsumexp::submit<T>(n_seq_tile, head_size,
                     n_batch_tile*n_head_tile, k_tile_handle, q_tile_handle,
                     mask_tile_handle, maxsumexp_tile_handle, tmp_tile_handle,
-                    redux=0, fp32_fast_tf32=fp32_fast_tf32);
+                    0, fp32_fast_tf32, n_batch_tile, kv_group,
+                    mask_kind == MaskTile::full);
         }
-    }
+    };
+    starpu::submitters::parallel_for(maxsumexp.grid.nelems, submit_tile);
 }
 
 template<typename T>
 void flash_maxsumexp(const Tensor<T> &Q, const Tensor<T> &K,
         const Tensor<bool_t> &mask, const Tensor<T> &maxsumexp,
-        const Tensor<T> &tmp, int redux, int fp32_fast_tf32)
+        const Tensor<T> &tmp, int redux, int fp32_fast_tf32,
+        const std::vector<MaskTile> &layout)
 {
-    flash_maxsumexp_async<T>(Q, K, mask, maxsumexp, tmp, redux, fp32_fast_tf32);
+    flash_maxsumexp_async<T>(Q, K, mask, maxsumexp, tmp, redux, fp32_fast_tf32,
+            layout);
     starpu_task_wait_for_all();
     starpu_mpi_wait_for_all(MPI_COMM_WORLD);
 }
@@ -131,23 +160,27 @@ void flash_maxsumexp(const Tensor<T> &Q, const Tensor<T> &K,
 template
 void flash_maxsumexp_async(const Tensor<fp32_t> &Q, const Tensor<fp32_t> &K,
         const Tensor<bool_t> &mask, const Tensor<fp32_t> &maxsumexp,
-        const Tensor<fp32_t> &tmp, int redux, int fp32_fast_tf32);
+        const Tensor<fp32_t> &tmp, int redux, int fp32_fast_tf32,
+        const std::vector<MaskTile> &layout);
 
 template
 void flash_maxsumexp_async(const Tensor<fp64_t> &Q, const Tensor<fp64_t> &K,
         const Tensor<bool_t> &mask, const Tensor<fp64_t> &maxsumexp,
-        const Tensor<fp64_t> &tmp, int redux, int fp32_fast_tf32);
+        const Tensor<fp64_t> &tmp, int redux, int fp32_fast_tf32,
+        const std::vector<MaskTile> &layout);
 
 // Explicit instantiation
 template
 void flash_maxsumexp(const Tensor<fp32_t> &Q, const Tensor<fp32_t> &K,
         const Tensor<bool_t> &mask, const Tensor<fp32_t> &maxsumexp,
-        const Tensor<fp32_t> &tmp, int redux, int fp32_fast_tf32);
+        const Tensor<fp32_t> &tmp, int redux, int fp32_fast_tf32,
+        const std::vector<MaskTile> &layout);
 
 template
 void flash_maxsumexp(const Tensor<fp64_t> &Q, const Tensor<fp64_t> &K,
         const Tensor<bool_t> &mask, const Tensor<fp64_t> &maxsumexp,
-        const Tensor<fp64_t> &tmp, int redux, int fp32_fast_tf32);
+        const Tensor<fp64_t> &tmp, int redux, int fp32_fast_tf32,
+        const std::vector<MaskTile> &layout);
 
 } // namespace tensor
 } // namespace nntile
@@ -13,10 +13,12 @@
  * */
 
 #include "nntile/tensor/flash_softmax_gemm.hh"
+#include "nntile/tensor/mask_tiles.hh"
 #include "nntile/starpu/flash_softmax_gemm.hh"
 #include "nntile/starpu/gemm.hh"
 #include "nntile/starpu/mask_scalar.hh"
 #include "nntile/starpu/softmax_inplace.hh"
+#include "nntile/starpu/submitters.hh"
 #include <cmath>
 #include <limits>
 
@@ -29,7 +31,8 @@ template<typename T>
 void flash_softmax_gemm_async(const Tensor<T> &Q, const Tensor<T> &K,
         const Tensor<T> &V, const Tensor<bool_t> &mask,
         const Tensor<T> &maxsumexp, const Tensor<T> &dst,
-        const Tensor<T> &tmp, int redux, int fp32_fast_tf32)
+        const Tensor<T> &tmp, int redux, int fp32_fast_tf32, T dropout_p,
+        unsigned long long seed, const std::vector<MaskTile> &layout)
 {
 //    // Check dimensions
 //    if(src.ndim != dst.ndim)
@@ -89,53 +92,83 @@ void flash_softmax_gemm_async(const Tensor<T> &Q, const Tensor<T> &K,
     Index n_seq_tile = Q.basetile_shape[1];
     Index n_batch_tile = Q.basetile_shape[2];
     Index n_head_tile = Q.basetile_shape[3];
-    for(Index i = 0; i < maxsumexp.grid.nelems; ++i)
+    // Grouped-query attention: every head of K and V serves kv_group heads
+    // of Q
+    if(Q.shape[3] % K.shape[3] != 0)
+    {
+        throw std::runtime_error("Q.shape[3] % K.shape[3] != 0");
+    }
+    Index kv_group = Q.shape[3] / K.shape[3];
+    if(K.basetile_shape[3]*kv_group != n_head_tile)
+    {
+        throw std::runtime_error("K.basetile_shape[3]*kv_group != "
+                "Q.basetile_shape[3]");
+    }
+    if(V.shape[3] != K.shape[3] or V.basetile_shape[3] != K.basetile_shape[3])
+    {
+        throw std::runtime_error("V and K have different heads");
+    }
+    // Pairs of tiles with an empty tile of mask are skipped
+    auto mask_kinds = mask_layout(mask, layout);
+    // Every tile of dst is accumulated by tasks, that are submitted by the
+    // same thread in order
+    auto submit_tile = [&](Index i)
     {
         // Destination tile on dest node must be already prepared (cleared)
-        auto maxsumexp_tile_handle = maxsumexp.get_tile_handle(i);
-        // Obtain indices of applicable source tiles
-        auto maxsumexp_tile_index = maxsumexp.grid.linear_to_index(i);
-        std::vector<Index> tmp_tile_index(maxsumexp_tile_index),
-            q_tile_index(maxsumexp_tile_index),
-            k_tile_index(maxsumexp_tile_index),
-            v_tile_index(maxsumexp_tile_index),
-            dst_tile_index(maxsumexp_tile_index),
-            mask_tile_index(2);
-        auto q_tile_handle = Q.get_tile_handle(q_tile_index);
-        auto dst_tile_handle = dst.get_tile_handle(dst_tile_index);
-        mask_tile_index[1] = maxsumexp_tile_index[1];
+        const auto &maxsumexp_tile_handle = maxsumexp.get_tile_handle(i);
+        // Tiles of Q, dst and maxsumexp share the same grid, while grids of
+        // K, V, tmp and mask differ only along sequence axes. Linear offsets
+        // of applicable tiles are computed directly, so that no index is
+        // allocated for every task
+        const Index q_seq = i % maxsumexp.grid.shape[1];
+        const Index batch_head = i / maxsumexp.grid.shape[1];
+        const auto &q_tile_handle = Q.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
+        const Index kv_offset = batch_head * K.grid.stride[2];
+        const Index tmp_offset = q_seq*tmp.grid.stride[1]
+            + batch_head*tmp.grid.stride[2];
+        const Index mask_offset = q_seq * mask.grid.stride[1];
         // Clear destination buffer at first
         starpu::clear::submit(dst_tile_handle);
         // Launch kernel for each appropriate tile of K and V to accumulate
         // result into destination tensor
         for(Index j = 0; j < K.grid.shape[1]; ++j)
         {
-            tmp_tile_index[0] = j;
-            k_tile_index[1] = j;
-            v_tile_index[1] = j;
-            mask_tile_index[0] = j;
-            auto tmp_tile_handle = tmp.get_tile_handle(tmp_tile_index);
-            auto k_tile_handle = K.get_tile_handle(k_tile_index);
-            auto v_tile_handle = V.get_tile_handle(v_tile_index);
-            auto mask_tile_handle = mask.get_tile_handle(mask_tile_index);
+            auto mask_kind = mask_kinds[mask_offset+j];
+            if(mask_kind == MaskTile::empty)
+            {
+                continue;
+            }
+            const Index tmp_linear = tmp_offset + j;
+            const auto &tmp_tile_handle = tmp.get_tile_handle(tmp_linear);
+            const auto &k_tile_handle = K.get_tile_handle(
+                    kv_offset+j*K.grid.stride[1]);
+            const auto &v_tile_handle = V.get_tile_handle(
+                    kv_offset+j*V.grid.stride[1]);
+            const auto &mask_tile_handle =
+                    mask.get_tile_handle(mask_offset+j);
             // Insert a fused task
             starpu::flash_softmax_gemm::submit<T>(
                     n_seq_tile, head_size, n_batch_tile*n_head_tile,
                     k_tile_handle, q_tile_handle, mask_tile_handle,
                     maxsumexp_tile_handle, v_tile_handle, dst_tile_handle,
-                    tmp_tile_handle, redux=0, fp32_fast_tf32=fp32_fast_tf32);
+                    tmp_tile_handle, 0, fp32_fast_tf32, dropout_p, seed,
+                    tmp_linear, n_batch_tile,
+                    kv_group, mask_kind == MaskTile::full);
         }
-    }
+    };
+    starpu::submitters::parallel_for(maxsumexp.grid.nelems, submit_tile);
 }
 
 template<typename T>
 void flash_softmax_gemm(const Tensor<T> &Q, const Tensor<T> &K,
         const Tensor<T> &V, const Tensor<bool_t> &mask,
         const Tensor<T> &maxsumexp, const Tensor<T> &dst,
-        const Tensor<T> &tmp, int redux, int fp32_fast_tf32)
+        const Tensor<T> &tmp, int redux, int fp32_fast_tf32, T dropout_p,
+        unsigned long long seed, const std::vector<MaskTile> &layout)
 {
     flash_softmax_gemm_async<T>(Q, K, V, mask, maxsumexp, dst, tmp, redux,
-            fp32_fast_tf32);
+            fp32_fast_tf32, dropout_p, seed, layout);
     starpu_task_wait_for_all();
     starpu_mpi_wait_for_all(MPI_COMM_WORLD);
 }
@@ -145,26 +178,34 @@ template
 void flash_softmax_gemm_async(const Tensor<fp32_t> &Q, const Tensor<fp32_t> &K,
         const Tensor<fp32_t> &V, const Tensor<bool_t> &mask,
         const Tensor<fp32_t> &maxsumexp, const Tensor<fp32_t> &dst,
-        const Tensor<fp32_t> &tmp, int redux, int fp32_fast_tf32);
+        const Tensor<fp32_t> &tmp, int redux, int fp32_fast_tf32,
+        fp32_t dropout_p, unsigned long long seed,
+        const std::vector<MaskTile> &layout);
 
 template
 void flash_softmax_gemm_async(const Tensor<fp64_t> &Q, const Tensor<fp64_t> &K,
         const Tensor<fp64_t> &V, const Tensor<bool_t> &mask,
         const Tensor<fp64_t> &maxsumexp, const Tensor<fp64_t> &dst,
-        const Tensor<fp64_t> &tmp, int redux, int fp32_fast_tf32);
+        const Tensor<fp64_t> &tmp, int redux, int fp32_fast_tf32,
+        fp64_t dropout_p, unsigned long long seed,
+        const std::vector<MaskTile> &layout);
 
 // Explicit instantiation
 template
 void flash_softmax_gemm(const Tensor<fp32_t> &Q, const Tensor<fp32_t> &K,
         const Tensor<fp32_t> &V, const Tensor<bool_t> &mask,
         const Tensor<fp32_t> &maxsumexp, const Tensor<fp32_t> &dst,
-        const Tensor<fp32_t> &tmp, int redux, int fp32_fast_tf32);
+        const Tensor<fp32_t> &tmp, int redux, int fp32_fast_tf32,
+        fp32_t dropout_p, unsigned long long seed,
+        const std::vector<MaskTile> &layout);
 
 template
 void flash_softmax_gemm(const Tensor<fp64_t> &Q, const Tensor<fp64_t> &K,
         const Tensor<fp64_t> &V, const Tensor<bool_t> &mask,
         const Tensor<fp64_t> &maxsumexp, const Tensor<fp64_t> &dst,
-        const Tensor<fp64_t> &tmp, int redux, int fp32_fast_tf32);
+        const Tensor<fp64_t> &tmp, int redux, int fp32_fast_tf32,
+        fp64_t dropout_p, unsigned long long seed,
+        const std::vector<MaskTile> &layout);
 
 } // namespace tensor
 } // namespace nntile
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/tensor/flash_softmax_gemm_backward.hh"
+#include "nntile/tensor/mask_tiles.hh"
 #include "nntile/starpu/flash_softmax_gemm_backward_sumprod_slice.hh"
 #include "nntile/starpu/flash_softmax_gemm_backward_dq_dk.hh"
 #include <cmath>
@@ -29,7 +30,9 @@ void flash_softmax_gemm_backward_async(const Tensor<T> &Q, const Tensor<T> &dQ,
         const Tensor<T> &dV, const Tensor<bool_t> &mask,
         const Tensor<T> &maxsumexp, const Tensor<T> &dst_grad,
         const Tensor<T> &tmp, const Tensor<T> &tmp_grad,
-        const Tensor<T> &tmp_sumprod_slice, int redux, int fp32_fast_tf32)
+        const Tensor<T> &tmp_sumprod_slice, int redux, int fp32_fast_tf32,
+        T dropout_p, unsigned long long seed,
+        const std::vector<MaskTile> &layout)
 {
 //    // Check dimensions
 //    if(src.ndim != dst.ndim)
@@ -83,19 +86,28 @@ void flash_softmax_gemm_backward_async(const Tensor<T> &Q, const Tensor<T> &dQ,
 //                    "dst.basetile_shape[i]");
 //        }
 //    }
+    // Grouped-query attention is supported only in the forward pass
+    if(K.shape != Q.shape or V.shape != Q.shape)
+    {
+        throw std::runtime_error("Backward requires the same number of heads "
+                "of Q, K and V");
+    }
     // Do actual calculations
     int ret;
     Index head_size = Q.shape[0];
     Index n_seq_tile = Q.basetile_shape[1];
     Index n_batch_tile = Q.basetile_shape[2];
     Index n_head_tile = Q.basetile_shape[3];
+    // Pairs of tiles with an empty tile of mask contribute nothing
+    auto mask_kinds = mask_layout(mask, layout);
     // Cycle for all tiles of dV tensor
+    std::vector<Index> dV_tile_index;
     for(Index i = 0; i < dV.grid.nelems; ++i)
     {
-        auto dQ_tile_handle = dQ.get_tile_handle(i);
-        auto dK_tile_handle = dK.get_tile_handle(i);
-        auto dV_tile_handle = dV.get_tile_handle(i);
-        auto dV_tile_index = dV.grid.linear_to_index(i);
+        const auto &dQ_tile_handle = dQ.get_tile_handle(i);
+        const auto &dK_tile_handle = dK.get_tile_handle(i);
+        const auto &dV_tile_handle = dV.get_tile_handle(i);
+        dV.grid.linear_to_index(i, dV_tile_index);
         // Indices of all required tensors
         std::vector<Index> tmp_tile_index(dV_tile_index),
             q_tile_index(dV_tile_index), dq_tile_index(dV_tile_index),
@@ -104,8 +116,8 @@ void flash_softmax_gemm_backward_async(const Tensor<T> &Q, const Tensor<T> &dQ,
             mask_tile_index(2), maxsumexp_tile_index(dV_tile_index),
             tmp_grad_tile_index(dV_tile_index),
             tmp_sumprod_slice_tile_index(3);
-        auto k_tile_handle = K.get_tile_handle(k_tile_index);
-        auto v_tile_handle = V.get_tile_handle(v_tile_index);
+        const auto &k_tile_handle = K.get_tile_handle(k_tile_index);
+        const auto &v_tile_handle = V.get_tile_handle(v_tile_index);
         tmp_tile_index[0] = dV_tile_index[1];
         tmp_grad_tile_index[0] = dV_tile_index[1];
         tmp_sumprod_slice_tile_index[1] = dV_tile_index[2];
@@ -124,18 +136,24 @@ void flash_softmax_gemm_backward_async(const Tensor<T> &Q, const Tensor<T> &dQ,
             q_tile_index[1] = j;
             dst_grad_tile_index[1] = j;
             mask_tile_index[1] = j;
+            if(mask_kinds[mask.grid.index_to_linear(mask_tile_index)]
+                    == MaskTile::empty)
+            {
+                continue;
+            }
             maxsumexp_tile_index[1] = j;
             tmp_sumprod_slice_tile_index[0] = j;
-            auto tmp_tile_handle = tmp.get_tile_handle(tmp_tile_index);
-            auto tmp_grad_tile_handle = tmp_grad.get_tile_handle(
+            const auto &tmp_tile_handle = tmp.get_tile_handle(tmp_tile_index);
+            const auto &tmp_grad_tile_handle = tmp_grad.get_tile_handle(
                     tmp_grad_tile_index);
             auto tmp_sumprod_slice_tile_handle = tmp_sumprod_slice
                 .get_tile_handle(tmp_sumprod_slice_tile_index);
-            auto q_tile_handle = Q.get_tile_handle(q_tile_index);
-            auto dst_grad_tile_handle = dst_grad.get_tile_handle(
+            const auto &q_tile_handle = Q.get_tile_handle(q_tile_index);
+            const auto &dst_grad_tile_handle = dst_grad.get_tile_handle(
                     dst_grad_tile_index);
-            auto mask_tile_handle = mask.get_tile_handle(mask_tile_index);
-            auto maxsumexp_tile_handle = maxsumexp.get_tile_handle(
+            const auto &mask_tile_handle =
+                    mask.get_tile_handle(mask_tile_index);
+            const auto &maxsumexp_tile_handle = maxsumexp.get_tile_handle(
                     maxsumexp_tile_index);
             // Insert a fused task
             starpu::flash_softmax_gemm_backward_sumprod_slice::submit<T>(
@@ -144,14 +162,15 @@ void flash_softmax_gemm_backward_async(const Tensor<T> &Q, const Tensor<T> &dQ,
                     maxsumexp_tile_handle, dst_grad_tile_handle, v_tile_handle,
                     dV_tile_handle, tmp_sumprod_slice_tile_handle,
                     tmp_tile_handle, tmp_grad_tile_handle, redux=0,
-                    fp32_fast_tf32=fp32_fast_tf32);
+                    fp32_fast_tf32=fp32_fast_tf32, dropout_p, seed,
+                    tmp.grid.index_to_linear(tmp_tile_index));
         }
     }
     // Cycle for all tiles of dK/dV tensor
     for(Index i = 0; i < dV.grid.nelems; ++i)
     {
-        auto dK_tile_handle = dK.get_tile_handle(i);
-        auto dV_tile_index = dV.grid.linear_to_index(i);
+        const auto &dK_tile_handle = dK.get_tile_handle(i);
+        dV.grid.linear_to_index(i, dV_tile_index);
         // Indices of all required tensors
         std::vector<Index> tmp_tile_index(dV_tile_index),
             q_tile_index(dV_tile_index), dq_tile_index(dV_tile_index),
@@ -160,8 +179,8 @@ void flash_softmax_gemm_backward_async(const Tensor<T> &Q, const Tensor<T> &dQ,
             mask_tile_index(2), maxsumexp_tile_index(dV_tile_index),
             tmp_grad_tile_index(dV_tile_index),
             tmp_sumprod_slice_tile_index(3);
-        auto k_tile_handle = K.get_tile_handle(k_tile_index);
-        auto v_tile_handle = V.get_tile_handle(v_tile_index);
+        const auto &k_tile_handle = K.get_tile_handle(k_tile_index);
+        const auto &v_tile_handle = V.get_tile_handle(v_tile_index);
         tmp_tile_index[0] = dV_tile_index[1];
         tmp_grad_tile_index[0] = dV_tile_index[1];
         tmp_sumprod_slice_tile_index[1] = dV_tile_index[2];
@@ -174,21 +193,27 @@ void flash_softmax_gemm_backward_async(const Tensor<T> &Q, const Tensor<T> &dQ,
             q_tile_index[1] = j;
             dst_grad_tile_index[1] = j;
             mask_tile_index[1] = j;
+            if(mask_kinds[mask.grid.index_to_linear(mask_tile_index)]
+                    == MaskTile::empty)
+            {
+                continue;
+            }
             maxsumexp_tile_index[1] = j;
             tmp_sumprod_slice_tile_index[0] = j;
             dq_tile_index[1] = j;
-            auto tmp_tile_handle = tmp.get_tile_handle(tmp_tile_index);
-            auto tmp_grad_tile_handle = tmp_grad.get_tile_handle(
+            const auto &tmp_tile_handle = tmp.get_tile_handle(tmp_tile_index);
+            const auto &tmp_grad_tile_handle = tmp_grad.get_tile_handle(
                     tmp_grad_tile_index);
             auto tmp_sumprod_slice_tile_handle = tmp_sumprod_slice
                 .get_tile_handle(tmp_sumprod_slice_tile_index);
-            auto q_tile_handle = Q.get_tile_handle(q_tile_index);
-            auto dst_grad_tile_handle = dst_grad.get_tile_handle(
+            const auto &q_tile_handle = Q.get_tile_handle(q_tile_index);
+            const auto &dst_grad_tile_handle = dst_grad.get_tile_handle(
                     dst_grad_tile_index);
-            auto mask_tile_handle = mask.get_tile_handle(mask_tile_index);
-            auto maxsumexp_tile_handle = maxsumexp.get_tile_handle(
+            const auto &mask_tile_handle =
+                    mask.get_tile_handle(mask_tile_index);
+            const auto &maxsumexp_tile_handle = maxsumexp.get_tile_handle(
                     maxsumexp_tile_index);
-            auto dQ_tile_handle = dQ.get_tile_handle(dq_tile_index);
+            const auto &dQ_tile_handle = dQ.get_tile_handle(dq_tile_index);
             // Insert a fused task
             starpu::flash_softmax_gemm_backward_dq_dk::submit<T>(
                     n_seq_tile, head_size, n_batch_tile*n_head_tile,
@@ -196,7 +221,8 @@ void flash_softmax_gemm_backward_async(const Tensor<T> &Q, const Tensor<T> &dQ,
                     maxsumexp_tile_handle, dst_grad_tile_handle, v_tile_handle,
                     tmp_sumprod_slice_tile_handle, dQ_tile_handle, dK_tile_handle,
                     tmp_tile_handle, tmp_grad_tile_handle, redux=0,
-                    fp32_fast_tf32=fp32_fast_tf32);
+                    fp32_fast_tf32=fp32_fast_tf32, dropout_p, seed,
+                    tmp.grid.index_to_linear(tmp_tile_index));
         }
     }
 }
@@ -207,10 +233,13 @@ void flash_softmax_gemm_backward(const Tensor<T> &Q, const Tensor<T> &dQ,
         const Tensor<T> &dV, const Tensor<bool_t> &mask,
         const Tensor<T> &maxsumexp, const Tensor<T> &dst_grad,
         const Tensor<T> &tmp, const Tensor<T> &tmp_grad,
-        const Tensor<T> &tmp_sumprod_slice, int redux, int fp32_fast_tf32)
+        const Tensor<T> &tmp_sumprod_slice, int redux, int fp32_fast_tf32,
+        T dropout_p, unsigned long long seed,
+        const std::vector<MaskTile> &layout)
 {
     flash_softmax_gemm_backward_async<T>(Q, dQ, K, dK, V, dV, mask, maxsumexp,
-            dst_grad, tmp, tmp_grad, tmp_sumprod_slice, redux, fp32_fast_tf32);
+            dst_grad, tmp, tmp_grad, tmp_sumprod_slice, redux, fp32_fast_tf32,
+            dropout_p, seed, layout);
     starpu_task_wait_for_all();
     starpu_mpi_wait_for_all(MPI_COMM_WORLD);
 }
@@ -222,7 +251,9 @@ void flash_softmax_gemm_backward_async(const Tensor<fp32_t> &Q, const Tensor<fp3
         const Tensor<fp32_t> &dV, const Tensor<bool_t> &mask,
         const Tensor<fp32_t> &maxsumexp, const Tensor<fp32_t> &dst_grad,
         const Tensor<fp32_t> &tmp, const Tensor<fp32_t> &tmp_grad,
-        const Tensor<fp32_t> &tmp_sumprod_slice, int redux, int fp32_fast_tf32);
+        const Tensor<fp32_t> &tmp_sumprod_slice, int redux, int fp32_fast_tf32,
+        fp32_t dropout_p, unsigned long long seed,
+        const std::vector<MaskTile> &layout);
 
 template
 void flash_softmax_gemm_backward_async(const Tensor<fp64_t> &Q, const Tensor<fp64_t> &dQ,
@@ -230,7 +261,9 @@ void flash_softmax_gemm_backward_async(const Tensor<fp64_t> &Q, const Tensor<fp6
         const Tensor<fp64_t> &dV, const Tensor<bool_t> &mask,
         const Tensor<fp64_t> &maxsumexp, const Tensor<fp64_t> &dst_grad,
         const Tensor<fp64_t> &tmp, const Tensor<fp64_t> &tmp_grad,
-        const Tensor<fp64_t> &tmp_sumprod_slice, int redux, int fp32_fast_tf32);
+        const Tensor<fp64_t> &tmp_sumprod_slice, int redux, int fp32_fast_tf32,
+        fp64_t dropout_p, unsigned long long seed,
+        const std::vector<MaskTile> &layout);
 
 // Explicit instantiation
 template
@@ -239,7 +272,9 @@ void flash_softmax_gemm_backward(const Tensor<fp32_t> &Q, const Tensor<fp32_t> &
         const Tensor<fp32_t> &dV, const Tensor<bool_t> &mask,
         const Tensor<fp32_t> &maxsumexp, const Tensor<fp32_t> &dst_grad,
         const Tensor<fp32_t> &tmp, const Tensor<fp32_t> &tmp_grad,
-        const Tensor<fp32_t> &tmp_sumprod_slice, int redux, int fp32_fast_tf32);
+        const Tensor<fp32_t> &tmp_sumprod_slice, int redux, int fp32_fast_tf32,
+        fp32_t dropout_p, unsigned long long seed,
+        const std::vector<MaskTile> &layout);
 
 template
 void flash_softmax_gemm_backward(const Tensor<fp64_t> &Q, const Tensor<fp64_t> &dQ,
@@ -247,7 +282,9 @@ void flash_softmax_gemm_backward(const Tensor<fp64_t> &Q, const Tensor<fp64_t> &
         const Tensor<fp64_t> &dV, const Tensor<bool_t> &mask,
         const Tensor<fp64_t> &maxsumexp, const Tensor<fp64_t> &dst_grad,
         const Tensor<fp64_t> &tmp, const Tensor<fp64_t> &tmp_grad,
-        const Tensor<fp64_t> &tmp_sumprod_slice, int redux, int fp32_fast_tf32);
+        const Tensor<fp64_t> &tmp_sumprod_slice, int redux, int fp32_fast_tf32,
+        fp64_t dropout_p, unsigned long long seed,
+        const std::vector<MaskTile> &layout);
 
 } // namespace tensor
 } // namespace nntile
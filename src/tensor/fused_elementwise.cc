@@ -0,0 +1,169 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/fused_elementwise.cc
+ * Chain of elementwise operations on Tensor<T> by a single task per tile
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/tensor/fused_elementwise.hh"
+#include "nntile/starpu/fused_elementwise.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+using kernel::fused_elementwise::MAX_BUFFERS;
+using kernel::fused_elementwise::MAX_OPS;
+
+//! Asynchronous chain of elementwise operations by a single task per tile
+/*! Operations are applied in order, as if they were submitted one by one,
+ * e.g., by add_async, prod_async or hypot_async. Instead, a single task
+ * per tile applies all of them, so the tile is read and written only once.
+ * All the tensors shall have the same shape and basetile. Tiles, that are
+ * written by the operations, shall belong to the same MPI rank.
+ *
+ * @param[in] ops: Operations over indices of tensors in buffers
+ * @param[inout] buffers: Tensors, that are read or written by operations
+ * */
+template<typename T>
+void fused_elementwise_async(
+        const std::vector<kernel::fused_elementwise::op_t<T>> &ops,
+        const std::vector<Tensor<T>> &buffers)
+{
+    // Check inputs
+    if(ops.size() > MAX_OPS)
+    {
+        throw std::runtime_error("Too many operations in fused_elementwise");
+    }
+    if(buffers.size() > MAX_BUFFERS)
+    {
+        throw std::runtime_error("Too many buffers in fused_elementwise");
+    }
+    if(ops.empty())
+    {
+        return;
+    }
+    for(std::size_t j = 1; j < buffers.size(); ++j)
+    {
+        if(buffers[j].shape != buffers[0].shape)
+        {
+            throw std::runtime_error("buffers[j].shape != buffers[0].shape");
+        }
+        if(buffers[j].basetile_shape != buffers[0].basetile_shape)
+        {
+            throw std::runtime_error("buffers[j].basetile_shape != "
+                    "buffers[0].basetile_shape");
+        }
+    }
+    kernel::fused_elementwise::program_t<T> program;
+    program.nops = ops.size();
+    program.nbuffers = buffers.size();
+    for(int k = 0; k < program.nops; ++k)
+    {
+        if(ops[k].src < 0 or ops[k].src >= program.nbuffers
+                or ops[k].dst < 0 or ops[k].dst >= program.nbuffers)
+        {
+            throw std::runtime_error("Wrong buffer index in "
+                    "fused_elementwise");
+        }
+        program.ops[k] = ops[k];
+    }
+    bool load[MAX_BUFFERS], store[MAX_BUFFERS];
+    kernel::fused_elementwise::get_access<T>(program, load, store);
+    int mpi_rank = starpu_mpi_world_rank();
+    std::vector<starpu::Handle> tile_handles(program.nbuffers);
+    for(Index i = 0; i < buffers[0].grid.nelems; ++i)
+    {
+        // Tiles are updated on the node, that owns written tiles
+        int tile_rank = -1;
+        for(int j = 0; j < program.nbuffers; ++j)
+        {
+            tile_handles[j] = buffers[j].get_tile_handle(i);
+            if(not store[j])
+            {
+                continue;
+            }
+            int rank = tile_handles[j].mpi_get_rank();
+            if(tile_rank == -1)
+            {
+                tile_rank = rank;
+            }
+            else if(tile_rank != rank)
+            {
+                throw std::runtime_error("Written tiles of fused_elementwise "
+                        "belong to different MPI ranks");
+            }
+        }
+        // Transfer data
+        for(int j = 0; j < program.nbuffers; ++j)
+        {
+            if(load[j] and not store[j])
+            {
+                tile_handles[j].mpi_transfer(tile_rank, mpi_rank);
+            }
+        }
+        // Execute only on destination node
+        if(mpi_rank == tile_rank)
+        {
+            auto traits = buffers[0].get_tile_traits(i);
+            starpu::fused_elementwise::submit<T>(traits.nelems, program,
+                    tile_handles);
+        }
+        // Flush cache for the output tiles on every node
+        for(int j = 0; j < program.nbuffers; ++j)
+        {
+            if(store[j])
+            {
+                tile_handles[j].mpi_flush();
+            }
+        }
+    }
+}
+
+//! Blocking version of chain of elementwise operations
+/*! @param[in] ops: Operations over indices of tensors in buffers
+ * @param[inout] buffers: Tensors, that are read or written by operations
+ * */
+template<typename T>
+void fused_elementwise(
+        const std::vector<kernel::fused_elementwise::op_t<T>> &ops,
+        const std::vector<Tensor<T>> &buffers)
+{
+    fused_elementwise_async<T>(ops, buffers);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void fused_elementwise_async<fp32_t>(
+        const std::vector<kernel::fused_elementwise::op_t<fp32_t>> &ops,
+        const std::vector<Tensor<fp32_t>> &buffers);
+
+template
+void fused_elementwise_async<fp64_t>(
+        const std::vector<kernel::fused_elementwise::op_t<fp64_t>> &ops,
+        const std::vector<Tensor<fp64_t>> &buffers);
+
+// Explicit instantiation
+template
+void fused_elementwise<fp32_t>(
+        const std::vector<kernel::fused_elementwise::op_t<fp32_t>> &ops,
+        const std::vector<Tensor<fp32_t>> &buffers);
+
+template
+void fused_elementwise<fp64_t>(
+        const std::vector<kernel::fused_elementwise::op_t<fp64_t>> &ops,
+        const std::vector<Tensor<fp64_t>> &buffers);
+
+} // namespace tensor
+} // namespace nntile
+
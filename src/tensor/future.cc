@@ -0,0 +1,123 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/future.cc
+ * Future of values of tensors, that waits only for their tasks
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/future.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Arguments of the callback of an acquired tile
+struct await_args_t
+{
+    starpu_data_handle_t handle;
+    std::shared_ptr<TensorFuture::State> state;
+};
+
+// Release the acquired tile right away and count it as available
+static void await_callback(void *args_)
+{
+    auto args = reinterpret_cast<await_args_t *>(args_);
+    starpu_data_release(args->handle);
+    auto state = std::move(args->state);
+    delete args;
+    if(state->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        // Lock is needed not to lose the notification of a waiting thread
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->ready.notify_all();
+    }
+}
+
+// Acquire local tiles of a tensor for reading without blocking
+template<typename T>
+static void await_submit(const Tensor<T> &src, TensorFuture &future)
+{
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < src.grid.nelems; ++i)
+    {
+        const auto &tile_handle = src.get_tile_handle(i);
+        if(tile_handle.mpi_get_rank() != mpi_rank)
+        {
+            continue;
+        }
+        auto handle = static_cast<starpu_data_handle_t>(tile_handle);
+        future.state->pending.fetch_add(1, std::memory_order_relaxed);
+        auto args = new await_args_t{handle, future.state};
+        int ret = starpu_data_acquire_cb(handle, STARPU_R, await_callback,
+                args);
+        if(ret != 0)
+        {
+            delete args;
+            future.state->pending.fetch_sub(1, std::memory_order_relaxed);
+            throw std::runtime_error("Error in starpu_data_acquire_cb()");
+        }
+    }
+}
+
+//! Get future of values of local tiles of a tensor
+/*! Every local tile is acquired for reading by a callback, that releases
+ * it right away, so the future is ready after all the tasks, that were
+ * submitted to write the tile before this call, are finished.
+ *
+ * @param[in] src: Tensor to wait for
+ * */
+template<typename T>
+TensorFuture await_tensor(const Tensor<T> &src)
+{
+    TensorFuture future;
+    await_submit<T>(src, future);
+    return future;
+}
+
+//! Get future of values of local tiles of several tensors
+/*! See await_tensor() for details.
+ *
+ * @param[in] srcs: Tensors to wait for
+ * */
+template<typename T>
+TensorFuture await_tensors(const std::vector<Tensor<T>> &srcs)
+{
+    TensorFuture future;
+    for(const auto &src: srcs)
+    {
+        await_submit<T>(src, future);
+    }
+    return future;
+}
+
+// Explicit instantiation
+template
+TensorFuture await_tensor<fp32_t>(const Tensor<fp32_t> &src);
+
+template
+TensorFuture await_tensor<fp64_t>(const Tensor<fp64_t> &src);
+
+template
+TensorFuture await_tensor<Index>(const Tensor<Index> &src);
+
+template
+TensorFuture await_tensor<bool_t>(const Tensor<bool_t> &src);
+
+// Explicit instantiation
+template
+TensorFuture await_tensors<fp32_t>(const std::vector<Tensor<fp32_t>> &srcs);
+
+template
+TensorFuture await_tensors<fp64_t>(const std::vector<Tensor<fp64_t>> &srcs);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -43,13 +43,13 @@ void gather_async(const Tensor<T> &src, const Tensor<T> &dst)
     }
     // Treat special case of a source destination tile
     int mpi_rank = starpu_mpi_world_rank();
-    auto dst_tile_handle = dst.get_tile_handle(0);
-    auto dst_tile_traits = dst.get_tile_traits(0);
+    const auto &dst_tile_handle = dst.get_tile_handle(0);
+    const auto &dst_tile_traits = dst.get_tile_traits(0);
     int dst_tile_rank = dst_tile_handle.mpi_get_rank();
     int ret;
     if(src.grid.nelems == 1)
     {
-        auto src_tile_handle = src.get_tile_handle(0);
+        const auto &src_tile_handle = src.get_tile_handle(0);
         // Transfer source tile to dest node
         src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
         // Execute on destination node
@@ -70,13 +70,13 @@ void gather_async(const Tensor<T> &src, const Tensor<T> &dst)
     std::vector<Index> src_tile_start(ndim), dst_tile_start(ndim);
     std::vector<Index> src_tile_index(ndim);
     // Init with the first source tile
-    auto src_first_tile_handle = src.get_tile_handle(0);
+    const auto &src_first_tile_handle = src.get_tile_handle(0);
     // Transfer first source tile to dest node
     src_first_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
     // Execute on dest tile
     if(mpi_rank == dst_tile_rank)
     {
-        auto src_first_tile_traits = src.get_tile_traits(0);
+        const auto &src_first_tile_traits = src.get_tile_traits(0);
         starpu::subcopy::submit<T>(ndim, src_tile_start,
                 src_first_tile_traits.stride, dst_tile_start,
                 dst_tile_traits.stride, src_first_tile_traits.shape,
@@ -94,13 +94,13 @@ void gather_async(const Tensor<T> &src, const Tensor<T> &dst)
             ++k;
             ++src_tile_index[k];
         }
-        auto src_tile_handle = src.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
         // Transfer source tile to dest node
         src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
         // Execute on dest tile
         if(mpi_rank == dst_tile_rank)
         {
-            auto src_tile_traits = src.get_tile_traits(i);
+            const auto &src_tile_traits = src.get_tile_traits(i);
             for(Index k = 0; k < ndim; ++k)
             {
                 dst_tile_start[k] = src_tile_index[k] * src.basetile_shape[k];
@@ -135,6 +135,10 @@ template
 void gather_async<fp16_t>(const Tensor<fp16_t> &src,
         const Tensor<fp16_t> &dst);
 
+template
+void gather_async<bf16_t>(const Tensor<bf16_t> &src,
+        const Tensor<bf16_t> &dst);
+
 template
 void gather_async<fp32_t>(const Tensor<fp32_t> &src,
         const Tensor<fp32_t> &dst);
@@ -151,10 +155,21 @@ template
 void gather_async<bool_t>(const Tensor<bool_t> &src,
         const Tensor<bool_t> &dst);
 
+template
+void gather_async<std::int8_t>(const Tensor<std::int8_t> &src,
+        const Tensor<std::int8_t> &dst);
+
+template
+void gather_async<fp8_e4m3_t>(const Tensor<fp8_e4m3_t> &src,
+        const Tensor<fp8_e4m3_t> &dst);
+
 // Explicit instantiation
 template
 void gather<fp16_t>(const Tensor<fp16_t> &src, const Tensor<fp16_t> &dst);
 
+template
+void gather<bf16_t>(const Tensor<bf16_t> &src, const Tensor<bf16_t> &dst);
+
 template
 void gather<fp32_t>(const Tensor<fp32_t> &src, const Tensor<fp32_t> &dst);
 
@@ -167,6 +182,14 @@ void gather<Index>(const Tensor<Index> &src, const Tensor<Index> &dst);
 template
 void gather<bool_t>(const Tensor<bool_t> &src, const Tensor<bool_t> &dst);
 
+template
+void gather<std::int8_t>(const Tensor<std::int8_t> &src,
+        const Tensor<std::int8_t> &dst);
+
+template
+void gather<fp8_e4m3_t>(const Tensor<fp8_e4m3_t> &src,
+        const Tensor<fp8_e4m3_t> &dst);
+
 } // namespace tensor
 } // namespace nntile
 
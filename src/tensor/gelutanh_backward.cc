@@ -49,15 +49,15 @@ void gelutanh_backward_async(const Tensor<T> &x, const Tensor<T> &dy,
     int mpi_rank = starpu_mpi_world_rank();
     for(Index i = 0; i < x.grid.nelems; ++i)
     {
-        auto x_tile_handle = x.get_tile_handle(i);
-        auto dy_tile_handle = dy.get_tile_handle(i);
-        auto dx_tile_handle = dx.get_tile_handle(i);
+        const auto &x_tile_handle = x.get_tile_handle(i);
+        const auto &dy_tile_handle = dy.get_tile_handle(i);
+        const auto &dx_tile_handle = dx.get_tile_handle(i);
         // Execution node
         int exec_rank = dx_tile_handle.mpi_get_rank();
         // Execution node submission
         if(mpi_rank == exec_rank)
         {
-            auto x_tile_traits = x.get_tile_traits(i);
+            const auto &x_tile_traits = x.get_tile_traits(i);
             starpu::gelutanh_backward::submit_mpi<T>(x_tile_traits.nelems,
                     x_tile_handle, dy_tile_handle, dx_tile_handle, exec_rank);
         }
@@ -29,12 +29,12 @@ void gelutanh_inplace_async(const Tensor<T> &A)
     int mpi_rank = starpu_mpi_world_rank();
     for(Index i = 0; i < A.grid.nelems; ++i)
     {
-        auto tile_handle = A.get_tile_handle(i);
+        const auto &tile_handle = A.get_tile_handle(i);
         int tile_rank = tile_handle.mpi_get_rank();
         // Execute only on node-owner
         if(mpi_rank == tile_rank)
         {
-            auto tile_traits = A.get_tile_traits(i);
+            const auto &tile_traits = A.get_tile_traits(i);
             starpu::gelutanh_inplace::submit<T>(tile_traits.nelems, tile_handle);
         }
         // Flush cache for the output tile on every node
@@ -60,6 +60,12 @@ void gelutanh_inplace_async<fp32_t>(const Tensor<fp32_t> &A);
 template
 void gelutanh_inplace_async<fp64_t>(const Tensor<fp64_t> &A);
 
+template
+void gelutanh_inplace_async<bf16_t>(const Tensor<bf16_t> &A);
+
+template
+void gelutanh_inplace_async<fp16_t>(const Tensor<fp16_t> &A);
+
 // Explicit instantiation
 template
 void gelutanh_inplace<fp32_t>(const Tensor<fp32_t> &A);
@@ -67,6 +73,12 @@ void gelutanh_inplace<fp32_t>(const Tensor<fp32_t> &A);
 template
 void gelutanh_inplace<fp64_t>(const Tensor<fp64_t> &A);
 
+template
+void gelutanh_inplace<bf16_t>(const Tensor<bf16_t> &A);
+
+template
+void gelutanh_inplace<fp16_t>(const Tensor<fp16_t> &A);
+
 } // namespace tensor
 } // namespace nntile
 
@@ -13,13 +13,59 @@
  * */
 
 #include "nntile/tensor/gemm.hh"
+#include "nntile/tensor/tree_reduction.hh"
+#include "nntile/tensor/aggregate.hh"
 #include "nntile/starpu/gemm.hh"
+#include "nntile/starpu/gemm_grouped.hh"
+#include "nntile/starpu/strassen.hh"
+#include "nntile/starpu/accumulate.hh"
+#include "nntile/starpu/submitters.hh"
+#include "nntile/starpu/scheduler.hh"
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
 
 namespace nntile
 {
 namespace tensor
 {
 
+// Split of contracted dimensions is disabled by default
+static std::atomic<Index> gemm_split_k = 0;
+
+void set_gemm_split_k(Index nchains)
+{
+    if(nchains < 0)
+    {
+        throw std::runtime_error("nchains < 0");
+    }
+    gemm_split_k = nchains;
+}
+
+Index get_gemm_split_k()
+{
+    return gemm_split_k;
+}
+
+// Split of tiles of C between CPU and CUDA workers is disabled by default
+static std::atomic<bool> gemm_hetero = false;
+static std::atomic<fp64_t> gemm_hetero_share = 0;
+
+void set_gemm_hetero(bool enable, fp64_t cpu_share)
+{
+    if(not (cpu_share >= 0 and cpu_share < 1))
+    {
+        throw std::runtime_error("cpu_share shall be in range [0,1)");
+    }
+    gemm_hetero = enable;
+    gemm_hetero_share = cpu_share;
+}
+
+bool get_gemm_hetero()
+{
+    return gemm_hetero;
+}
+
 //! Check if dimensionalities of tensors match gemm
 static inline void gemm_check_ndim(const TensorTraits &A,
         const TensorTraits &B, const TensorTraits &C, Index ndim,
@@ -327,31 +373,321 @@ void gemm_check(const TransOp &transA, const TensorTraits &A,
     gemm_check_opB_C(transB, B, C, ndim, batch_ndim);
 }
 
-//! Asynchronous version of tensor-wise gemm operation
-/*! Matrix multiplication for tensors, which are virtually reshaped
- *
- * @param[in] alpha: Alpha multiplier
- * @param[in] transA: Transposition flag for the tensor A
- * @param[in] A: Input tensor A
- * @param[in] transB: Transposition flag for the tensor B
- * @param[in] B: Input tensor B
- * @param[in] beta: Beta multiplier
- * @param[inout] C: Output tensor C
- * @param[in] ndim: Number of dimensions used in gemm contraction
- * @param[in] batch_ndim: Number of last dimensions used for batching of gemms
- * @param[in] redux: Whether or not to use STARPU_REDUX
+// Strassen codelets are implemented only for fp32_t and fp64_t
+template<typename T>
+constexpr bool gemm_strassen_supported = std::is_same_v<T, fp32_t>
+    or std::is_same_v<T, fp64_t>;
+
+// Grouped codelets are implemented only for fp32_t and fp64_t
+template<typename T>
+constexpr bool gemm_grouped_supported = std::is_same_v<T, fp32_t>
+    or std::is_same_v<T, fp64_t>;
+
+//! Submit product of tiles by Strassen codelets or by classic gemm
+/*! Strassen codelets are used only if they are enabled for the tile sizes
+ * (see starpu::strassen::enable) and the compute mode is the default one.
+ * They contain classic gemm as one of their implementations, so the
+ * scheduler chooses between classic and Strassen variants for each tile
+ * shape by calibrated performance models. Tiles of A and B of type T are
+ * multiplied into a tile C of type T_C.
+ * */
+template<typename T, typename T_C, typename T_scal>
+static void gemm_tile_submit(const TransOp &transA, const TransOp &transB,
+        Index m, Index n, Index k, Index batch, T_scal alpha,
+        starpu::Handle A, starpu::Handle B, T_scal beta, starpu::Handle C,
+        starpu::Handle strassen_work, int redux, GemmCompute compute)
+{
+    if constexpr(not std::is_same_v<T, T_C>)
+    {
+        starpu::gemm::submit_mixed<T>(transA, transB, m, n, k, batch, alpha,
+                A, B, beta, C, redux, compute);
+        return;
+    }
+    if constexpr(gemm_strassen_supported<T>)
+    {
+        if(strassen_work.handle and starpu::strassen::use_for(m, n, k)
+                and compute.value == GemmCompute::Default)
+        {
+            starpu::strassen::submit<T, T_scal>(transA, transB, m, n, k,
+                    batch, alpha, A, B, beta, C, strassen_work, redux);
+            return;
+        }
+    }
+    starpu::gemm::submit<T, T_scal>(transA, transB, m, n, k, batch, alpha, A,
+            B, beta, C, redux, compute);
+}
+
+#ifdef NNTILE_USE_MPI
+//! Get MPI tag for parts of tiles of the heterogeneous gemm
+/*! Parts cycle through a range of tags next to the range of TreeReduction,
+ * that does not overlap with tags of tensors.
+ * */
+static starpu_mpi_tag_t &gemm_hetero_tag()
+{
+    constexpr starpu_mpi_tag_t first = (starpu_mpi_tag_t(1) << 62)
+        + (starpu_mpi_tag_t(1) << 32);
+    constexpr starpu_mpi_tag_t ntags = starpu_mpi_tag_t(1) << 32;
+    static starpu_mpi_tag_t last_tag = first;
+    if(last_tag >= first+ntags)
+    {
+        last_tag = first;
+    }
+    return last_tag;
+}
+#endif // NNTILE_USE_MPI
+
+//! Share of columns of tiles of C for CPU workers
+/*! Share is fixed by set_gemm_hetero() or taken from throughputs of all CPU
+ * and CUDA workers, that are predicted by calibrated performance models for
+ * a product of the first tiles. Zero is returned if there are no workers of
+ * one of the kinds or if models are not calibrated yet, so that the
+ * scheduler calibrates them on whole tiles first.
  * */
 template<typename T, typename T_scal>
-void gemm_async(T_scal alpha, const TransOp &transA, const Tensor<T> &A,
-        const TransOp &transB, const Tensor<T> &B, T_scal beta,
-        const Tensor<T> &C, Index ndim, Index batch_ndim, int redux)
+static fp64_t gemm_hetero_cpu_share(const TransOp &transA,
+        const TransOp &transB, Index tile_m, Index tile_n, Index tile_k,
+        starpu::Handle A, starpu::Handle B, starpu::Handle C,
+        GemmCompute compute)
+{
+    fp64_t share = gemm_hetero_share;
+    if(share > 0)
+    {
+        return share;
+    }
+    fp64_t cpu_rate = 0, cuda_rate = 0;
+    int nworkers = starpu_worker_get_count();
+    for(int workerid = 0; workerid < nworkers; ++workerid)
+    {
+        auto type = starpu_worker_get_type(workerid);
+        if(type != STARPU_CPU_WORKER and type != STARPU_CUDA_WORKER)
+        {
+            continue;
+        }
+        double time = starpu::gemm::expected_time<T, T_scal>(workerid,
+                transA, transB, tile_m, tile_n, tile_k, 1, A, B, C, compute);
+        // This condition is true for NaN of an uncalibrated model
+        if(not (time > 0))
+        {
+            return 0;
+        }
+        if(type == STARPU_CPU_WORKER)
+        {
+            cpu_rate += 1.0 / time;
+        }
+        else
+        {
+            cuda_rate += 1.0 / time;
+        }
+    }
+    if(cpu_rate == 0 or cuda_rate == 0)
+    {
+        return 0;
+    }
+    return cpu_rate / (cpu_rate+cuda_rate);
+}
+
+//! Gemm with tiles of C split between CPU and CUDA workers
+/*! Every tile of C and every tile of op(B) of the same column of tiles are
+ * split by StarPU partitioning into two contiguous ranges of columns. The
+ * first range gets a share of columns, proportional to throughput of CPU
+ * workers, and its tasks are restricted to CPU workers, while tasks of the
+ * second range are restricted to CUDA workers. Tiles of A are read whole
+ * by both kinds of workers. Parts are contiguous only for non-transposed B
+ * and tiles of C without batch dimensions. MPI is not supported, as parts
+ * of tiles of B would have to be transferred between nodes. Returns false
+ * if the split is not applicable, so that the ordinary gemm is submitted.
+ * */
+template<typename T, typename T_scal>
+static bool gemm_hetero_async(T_scal alpha, const TransOp &transA,
+        const Tensor<T> &A, const TransOp &transB, const Tensor<T> &B,
+        T_scal beta, const Tensor<T> &C, Index ndim, Index batch_ndim,
+        Index m, Index n, Index k, const std::array<Index, 2> &opA_stride,
+        GemmCompute compute)
+{
+    constexpr T_scal one = 1;
+    // Restrictions of kinds of workers by the caller are kept as they are
+    if(transB.value != TransOp::NoTrans or starpu_mpi_world_size() != 1
+            or starpu::scheduler::where_get() != 0)
+    {
+        return false;
+    }
+    // Products of a tensor by the same tiles cannot partition them
+    if(static_cast<starpu_data_handle_t>(A.get_tile_handle(0))
+            == static_cast<starpu_data_handle_t>(B.get_tile_handle(0)))
+    {
+        return false;
+    }
+    // Base tiles are the first ones
+    const auto &C_first_traits = C.get_tile_traits(0);
+    const auto &A_first_traits = A.get_tile_traits(0);
+    Index tile_batch = C_first_traits.matrix_shape[C.ndim-batch_ndim][1];
+    if(tile_batch != 1)
+    {
+        return false;
+    }
+    Index first_m = C_first_traits.matrix_shape[A.ndim-batch_ndim-ndim][0];
+    Index first_n = C_first_traits.matrix_shape[A.ndim-batch_ndim-ndim][1];
+    Index first_k = (transA.value == TransOp::NoTrans)
+        ? A_first_traits.matrix_shape[A.ndim-batch_ndim-ndim][1]
+        : A_first_traits.matrix_shape[ndim][0];
+    fp64_t share = gemm_hetero_cpu_share<T, T_scal>(transA, transB,
+            first_m, first_n, first_k, A.get_tile_handle(0),
+            B.get_tile_handle(0), C.get_tile_handle(0), compute);
+    if(share <= 0)
+    {
+        return false;
+    }
+    // Number of columns of CPU parts for every column of tiles of C, zero
+    // for columns of tiles, that are too narrow to be split
+    std::vector<Index> ncols_cpu(n);
+    bool any_split = false;
+    for(Index j = 0; j < n; ++j)
+    {
+        Index ncols = C.get_tile_traits(j*m).matrix_shape[
+            A.ndim-batch_ndim-ndim][1];
+        Index ncols_j = static_cast<Index>(share*ncols + 0.5);
+        ncols_cpu[j] = (ncols_j < ncols) ? ncols_j : 0;
+        any_split = any_split or ncols_cpu[j] > 0;
+    }
+    if(not any_split)
+    {
+        return false;
+    }
+    // Plan partitions of tiles of C and B, that are split
+#ifdef NNTILE_USE_MPI
+    starpu_mpi_tag_t &last_tag = gemm_hetero_tag();
+#else // NNTILE_USE_MPI
+    starpu_mpi_tag_t last_tag = 0;
+#endif // NNTILE_USE_MPI
+    std::vector<starpu::VariablePartition> plans;
+    plans.reserve(C.grid.nelems+B.grid.nelems);
+    std::vector<Index> C_plan(C.grid.nelems, -1), B_plan(B.grid.nelems, -1);
+    auto split = [&](const starpu::Handle &handle, Index nrows, Index ncols,
+            Index ncols_j)
+    {
+        std::vector<size_t> bounds = {0, sizeof(T)*nrows*ncols_j,
+            sizeof(T)*nrows*ncols};
+        plans.emplace_back(handle, bounds, last_tag);
+        plans.back().partition_submit();
+        return Index(plans.size()-1);
+    };
+    for(Index C_tile_offset = 0; C_tile_offset < C.grid.nelems;
+            ++C_tile_offset)
+    {
+        Index j = C_tile_offset / m % n;
+        if(ncols_cpu[j] > 0)
+        {
+            const auto &traits = C.get_tile_traits(C_tile_offset);
+            Index index = A.ndim - batch_ndim - ndim;
+            C_plan[C_tile_offset] = split(C.get_tile_handle(C_tile_offset),
+                    traits.matrix_shape[index][0],
+                    traits.matrix_shape[index][1], ncols_cpu[j]);
+        }
+    }
+    for(Index B_tile_offset = 0; B_tile_offset < B.grid.nelems;
+            ++B_tile_offset)
+    {
+        Index j = B_tile_offset / k % n;
+        if(ncols_cpu[j] > 0)
+        {
+            const auto &traits = B.get_tile_traits(B_tile_offset);
+            B_plan[B_tile_offset] = split(B.get_tile_handle(B_tile_offset),
+                    traits.matrix_shape[ndim][0],
+                    traits.matrix_shape[ndim][1], ncols_cpu[j]);
+        }
+    }
+    // Parts are restricted only to kinds of workers, that are present
+    uint32_t where_cpu = starpu_worker_get_count_by_type(STARPU_CPU_WORKER)
+        ? STARPU_CPU : 0;
+    uint32_t where_cuda = starpu_worker_get_count_by_type(STARPU_CUDA_WORKER)
+        ? STARPU_CUDA : 0;
+    // C(i,j,b) = a*opA(i,l,b)*B(l,j,b) + b*C(i,j,b) for l=0 and
+    // C(i,j,b) = a*opA(i,l,b)*B(l,j,b) + C(i,j,b) for l>0
+    for(Index C_tile_offset = 0; C_tile_offset < C.grid.nelems;
+            ++C_tile_offset)
+    {
+        Index i = C_tile_offset % m;
+        Index j = C_tile_offset / m % n;
+        Index b = C_tile_offset / (m*n);
+        const auto &C_tile_traits = C.get_tile_traits(C_tile_offset);
+        Index tile_m = C_tile_traits.matrix_shape[A.ndim-batch_ndim-ndim][0];
+        Index tile_n = C_tile_traits.matrix_shape[A.ndim-batch_ndim-ndim][1];
+        for(Index l = 0; l < k; ++l)
+        {
+            Index A_tile_offset = opA_stride[0]*i + opA_stride[1]*l + b*m*k;
+            Index B_tile_offset = l + j*k + b*n*k;
+            const auto &A_tile_traits = A.get_tile_traits(A_tile_offset);
+            Index tile_k = (transA.value == TransOp::NoTrans)
+                ? A_tile_traits.matrix_shape[A.ndim-batch_ndim-ndim][1]
+                : A_tile_traits.matrix_shape[ndim][0];
+            auto A_tile_handle = A.get_tile_handle(A_tile_offset);
+            T_scal beta_l = (l == 0) ? beta : one;
+            if(C_plan[C_tile_offset] < 0)
+            {
+                starpu::gemm::submit<T, T_scal>(transA, transB, tile_m,
+                        tile_n, tile_k, 1, alpha, A_tile_handle,
+                        B.get_tile_handle(B_tile_offset), beta_l,
+                        C.get_tile_handle(C_tile_offset), 0, compute);
+                continue;
+            }
+            const auto &C_parts = plans[C_plan[C_tile_offset]].parts;
+            const auto &B_parts = plans[B_plan[B_tile_offset]].parts;
+            Index ncols_j = ncols_cpu[j];
+            {
+                starpu::scheduler::WhereScope where(where_cpu);
+                starpu::gemm::submit<T, T_scal>(transA, transB, tile_m,
+                        ncols_j, tile_k, 1, alpha, A_tile_handle, B_parts[0],
+                        beta_l, C_parts[0], 0, compute);
+            }
+            {
+                starpu::scheduler::WhereScope where(where_cuda);
+                starpu::gemm::submit<T, T_scal>(transA, transB, tile_m,
+                        tile_n-ncols_j, tile_k, 1, alpha, A_tile_handle,
+                        B_parts[1], beta_l, C_parts[1], 0, compute);
+            }
+        }
+    }
+    // Switch back to whole tiles and unregister parts after their tasks
+    for(auto &partition: plans)
+    {
+        partition.unpartition_submit();
+        partition.clean();
+    }
+    return true;
+}
+
+//! Tensor-wise gemm of tensors A and B of type T into tensor C of type T_C
+template<typename T, typename T_C, typename T_scal>
+static void gemm_async_impl(T_scal alpha, const TransOp &transA,
+        const Tensor<T> &A, const TransOp &transB, const Tensor<T> &B,
+        T_scal beta, const Tensor<T_C> &C, Index ndim, Index batch_ndim,
+        int redux, GemmCompute compute)
 {
     // Check inputs (throw exception in case of an error)
     gemm_check(transA, A, transB, B, C, ndim, batch_ndim);
     // Sizes of A, B and C as simple matrices (grids of tiles) for gemm
     int mpi_rank = starpu_mpi_world_rank();
     int ret;
-    constexpr T_scal one = 1;
+    constexpr T_scal zero = 0, one = 1;
+    // Partial results are accumulated by a codelet for the type of C
+    constexpr bool tree_supported = std::is_same_v<T_C, compute_t<T_C>>
+        and std::is_same_v<T_C, T_scal>;
+    redux = redux_mode(redux, tree_supported);
+    bool use_tree = (redux == redux_tree);
+    TreeReduction::accumulate_t accumulate = nullptr;
+    if(use_tree)
+    {
+        redux = 0;
+        if constexpr(not tree_supported)
+        {
+            throw std::runtime_error("Tree reduction is not supported for "
+                    "bf16_t and fp16_t");
+        }
+        else
+        {
+            accumulate = starpu::accumulate::submit<T_C>;
+        }
+    }
     Index m = C.grid.matrix_shape[A.ndim-batch_ndim-ndim][0];
     Index batch = C.grid.matrix_shape[C.ndim-batch_ndim][1];
     Index n = C.grid.matrix_shape[A.ndim-batch_ndim-ndim][1] / batch;
@@ -377,99 +713,368 @@ void gemm_async(T_scal alpha, const TransOp &transA, const Tensor<T> &A,
             opB_stride = {n, 1};
             break;
     }
-    // All per-tile starpu gemm calls shall appear here
-    for(Index b = 0; b < batch; ++b)
+    // Number of consecutive contributions to a tile of C, that are
+    // accumulated in the same partial result of the tree reduction
+    Index chain_k = use_tree ? 1 : k;
+    // Contractions with few tiles of C, e.g., gradients over weights, are
+    // split into independent chains over the contracted dimensions
+    if constexpr(tree_supported)
+    {
+        Index split_k = get_gemm_split_k();
+        if(redux == 0 and not use_tree and k > 1
+                and C.grid.nelems < split_k)
+        {
+            Index nchains = std::min(k,
+                    (split_k+C.grid.nelems-1) / C.grid.nelems);
+            chain_k = (k+nchains-1) / nchains;
+            use_tree = true;
+            accumulate = starpu::accumulate::submit<T_C>;
+        }
+    }
+    // Large products are split between CPU and CUDA workers on request
+    if constexpr(std::is_same_v<T, T_C>)
     {
-        for(Index j = 0; j < n; ++j)
+        if(get_gemm_hetero() and redux == 0 and not use_tree
+                and gemm_hetero_async<T, T_scal>(alpha, transA, A, transB,
+                    B, beta, C, ndim, batch_ndim, m, n, k, opA_stride,
+                    compute))
         {
-            for(Index i = 0; i < m; ++i)
+            return;
+        }
+    }
+    // Workspace for Strassen codelets is sized by the first tiles, as they
+    // are not smaller than any other tile
+    starpu::Handle strassen_work;
+    if constexpr(gemm_strassen_supported<T>)
+    {
+        const auto &C_first_traits = C.get_tile_traits(0);
+        const auto &A_first_traits = A.get_tile_traits(0);
+        Index tile_m = C_first_traits.matrix_shape[A.ndim-batch_ndim-ndim][0];
+        Index tile_batch = C_first_traits.matrix_shape[C.ndim-batch_ndim][1];
+        Index tile_n = C_first_traits.matrix_shape[A.ndim-batch_ndim-ndim][1]
+            / tile_batch;
+        Index tile_k;
+        switch(transA.value)
+        {
+            case TransOp::NoTrans:
+                tile_k = A_first_traits.matrix_shape[A.ndim-batch_ndim-ndim][1]
+                    / tile_batch;
+                break;
+            default:
+                tile_k = A_first_traits.matrix_shape[ndim][0];
+                break;
+        }
+        if(starpu::strassen::use_for(tile_m, tile_n, tile_k))
+        {
+            strassen_work = starpu::VariableHandle(sizeof(T)
+                    * starpu::strassen::workspace_size(tile_m, tile_n, tile_k),
+                    STARPU_SCRATCH);
+        }
+    }
+    // All per-tile starpu gemm calls shall appear here. All the tasks of
+    // a tile of C are submitted by the same thread in order.
+    auto submit_tile = [&](Index C_tile_offset)
+    {
+        Index i = C_tile_offset % m;
+        Index j = C_tile_offset / m % n;
+        Index b = C_tile_offset / (m*n);
+        const auto &C_tile_handle = C.get_tile_handle(C_tile_offset);
+        const auto &C_tile_traits = C.get_tile_traits(C_tile_offset);
+        int C_tile_rank = C_tile_handle.mpi_get_rank();
+        Index tile_m = C_tile_traits.matrix_shape[
+            A.ndim-batch_ndim-ndim][0];
+        Index tile_batch = C_tile_traits.matrix_shape[
+            C.ndim-batch_ndim][1];
+        Index tile_n = C_tile_traits.matrix_shape[
+            A.ndim-batch_ndim-ndim][1] / tile_batch;
+        // initialize C(i,j,b) = a*opA(i,0,b)*opB(0,j,b) + b*C(i,j,b)
+        Index A_tile_offset = opA_stride[0]*i + b*m*k;
+        Index B_tile_offset = opB_stride[1]*j + b*n*k;
+        const auto &A_first_tile_handle =
+                A.get_tile_handle(A_tile_offset);
+        const auto &B_first_tile_handle =
+                B.get_tile_handle(B_tile_offset);
+        int A_first_tile_rank = A_first_tile_handle.mpi_get_rank();
+        int B_first_tile_rank = B_first_tile_handle.mpi_get_rank();
+        // Transfer first tile A on node with tile C
+        A_first_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+        // Transfer first tile B on node with tile C
+        B_first_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+        // Execute on node with tile C
+        if(mpi_rank == C_tile_rank)
+        {
+            Index tile_k;
+            const auto &A_first_tile_traits = A.get_tile_traits(
+                    A_tile_offset);
+            switch(transA.value)
+            {
+                case TransOp::NoTrans:
+                    tile_k = A_first_tile_traits.matrix_shape[
+                        A.ndim-batch_ndim-ndim][1] / tile_batch;
+                    break;
+                    // This parameter was already checked
+                    //case TransOp::Trans:
+                default:
+                    tile_k = A_first_tile_traits.matrix_shape[ndim][0];
+                    break;
+            }
+            gemm_tile_submit<T, T_C, T_scal>(transA, transB, tile_m,
+                    tile_n, tile_k, tile_batch, alpha,
+                    A_first_tile_handle, B_first_tile_handle, beta,
+                    C_tile_handle, strassen_work, redux, compute);
+        }
+        TreeReduction tree(C_tile_handle,
+                sizeof(T_C)*C_tile_traits.nelems, accumulate);
+        starpu::Handle dst = C_tile_handle;
+        // all other l>0
+        for(Index l = 1; l < k; ++l)
+        {
+            // accumulate C(i,j,b) = a*opA(i,l,b)*opB(l,j,b) + C(i,j,b)
+            A_tile_offset += opA_stride[1];
+            B_tile_offset += opB_stride[0];
+            const auto &A_tile_handle =
+                    A.get_tile_handle(A_tile_offset);
+            const auto &B_tile_handle =
+                    B.get_tile_handle(B_tile_offset);
+            int A_tile_rank = A_tile_handle.mpi_get_rank();
+            int B_tile_rank = B_tile_handle.mpi_get_rank();
+            // Transfer tile A on node with tile C
+            A_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+            // Transfer tile B on node with tile C
+            B_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+            // Partial result of the tree reduction is computed on
+            // the node with tile C, as it needs the same transfers. Every
+            // chain of contributions starts its own partial result.
+            bool chain_start = (l % chain_k == 0);
+            if(chain_start)
             {
-                Index C_tile_offset = (b*n+j)*m + i;
-                auto C_tile_handle = C.get_tile_handle(C_tile_offset);
-                auto C_tile_traits = C.get_tile_traits(C_tile_offset);
-                int C_tile_rank = C_tile_handle.mpi_get_rank();
-                Index tile_m = C_tile_traits.matrix_shape[
-                    A.ndim-batch_ndim-ndim][0];
-                Index tile_batch = C_tile_traits.matrix_shape[
-                    C.ndim-batch_ndim][1];
-                Index tile_n = C_tile_traits.matrix_shape[
-                    A.ndim-batch_ndim-ndim][1] / tile_batch;
-                // initialize C(i,j,b) = a*opA(i,0,b)*opB(0,j,b) + b*C(i,j,b)
-                Index A_tile_offset = opA_stride[0]*i + b*m*k;
-                Index B_tile_offset = opB_stride[1]*j + b*n*k;
-                auto A_first_tile_handle = A.get_tile_handle(A_tile_offset);
-                auto B_first_tile_handle = B.get_tile_handle(B_tile_offset);
-                int A_first_tile_rank = A_first_tile_handle.mpi_get_rank();
-                int B_first_tile_rank = B_first_tile_handle.mpi_get_rank();
-                // Transfer first tile A on node with tile C
-                A_first_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
-                // Transfer first tile B on node with tile C
-                B_first_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
-                // Execute on node with tile C
+                dst = tree.get_partial(C_tile_rank);
+            }
+            // Execute on node with tile C
+            if(mpi_rank == C_tile_rank)
+            {
+                Index tile_k;
+                const auto &A_tile_traits = A.get_tile_traits(A_tile_offset);
+                switch(transA.value)
+                {
+                    case TransOp::NoTrans:
+                        tile_k = A_tile_traits.matrix_shape[
+                            A.ndim-batch_ndim-ndim][1] / tile_batch;
+                        break;
+                        // This parameter was already checked
+                        //case TransOp::Trans:
+                    default:
+                        tile_k = A_tile_traits.matrix_shape[ndim][0];
+                        break;
+                }
+                gemm_tile_submit<T, T_C, T_scal>(transA, transB,
+                        tile_m, tile_n, tile_k, tile_batch, alpha,
+                        A_tile_handle, B_tile_handle,
+                        chain_start ? zero : one, dst, strassen_work,
+                        redux, compute);
+            }
+        }
+        // Combine partial results of the tree reduction
+        if(use_tree)
+        {
+            tree.submit();
+        }
+        // Flush cache for the output tile on every node
+        C_tile_handle.mpi_flush();
+    };
+    // Tree reduction allocates MPI tags of partial results in order
+    if(use_tree)
+    {
+        for(Index C_tile_offset = 0; C_tile_offset < C.grid.nelems;
+                ++C_tile_offset)
+        {
+            submit_tile(C_tile_offset);
+        }
+        return;
+    }
+    // Consecutive tiles of C of the same shape on the same node, that are
+    // not larger than get_aggregate_nelems() in total, are grouped, so that
+    // every contraction index l of a group is a single grouped task
+    Index aggregate_nelems = get_aggregate_nelems();
+    bool use_groups = gemm_grouped_supported<T> and std::is_same_v<T, T_C>
+        and redux == 0
+        and C.get_tile_traits(0).nelems*2 <= aggregate_nelems;
+    if(not use_groups)
+    {
+        starpu::submitters::parallel_for(C.grid.nelems, submit_tile);
+        return;
+    }
+    // Groups are split in the same way on all nodes, as they decide on MPI
+    // transfers
+    std::vector<std::vector<Index>> groups;
+    Index group_nelems = 0;
+    for(Index C_tile_offset = 0; C_tile_offset < C.grid.nelems;
+            ++C_tile_offset)
+    {
+        const auto &C_tile_traits = C.get_tile_traits(C_tile_offset);
+        int C_tile_rank = C.get_tile_handle(C_tile_offset).mpi_get_rank();
+        if(groups.empty() or group_nelems+C_tile_traits.nelems
+                > aggregate_nelems)
+        {
+            groups.emplace_back();
+            group_nelems = 0;
+        }
+        else
+        {
+            Index first = groups.back()[0];
+            if(C.get_tile_handle(first).mpi_get_rank() != C_tile_rank
+                    or C.get_tile_traits(first).shape != C_tile_traits.shape)
+            {
+                groups.emplace_back();
+                group_nelems = 0;
+            }
+        }
+        groups.back().push_back(C_tile_offset);
+        group_nelems += C_tile_traits.nelems;
+    }
+    auto submit_group = [&](Index group_offset)
+    {
+        const auto &group = groups[group_offset];
+        Index ntiles = group.size();
+        if(ntiles == 1)
+        {
+            submit_tile(group[0]);
+            return;
+        }
+        if constexpr(gemm_grouped_supported<T> and std::is_same_v<T, T_C>)
+        {
+            const auto &C_tile_traits = C.get_tile_traits(group[0]);
+            int C_tile_rank = C.get_tile_handle(group[0]).mpi_get_rank();
+            Index tile_m = C_tile_traits.matrix_shape[
+                A.ndim-batch_ndim-ndim][0];
+            Index tile_batch = C_tile_traits.matrix_shape[
+                C.ndim-batch_ndim][1];
+            Index tile_n = C_tile_traits.matrix_shape[
+                A.ndim-batch_ndim-ndim][1] / tile_batch;
+            std::vector<Index> A_tile_offset(ntiles), B_tile_offset(ntiles);
+            std::vector<starpu::Handle> A_tiles(ntiles), B_tiles(ntiles),
+                C_tiles(ntiles);
+            for(Index t = 0; t < ntiles; ++t)
+            {
+                Index i = group[t] % m;
+                Index j = group[t] / m % n;
+                Index b = group[t] / (m*n);
+                A_tile_offset[t] = opA_stride[0]*i + b*m*k;
+                B_tile_offset[t] = opB_stride[1]*j + b*n*k;
+                C_tiles[t] = C.get_tile_handle(group[t]);
+            }
+            // C(i,j,b) = a*opA(i,l,b)*opB(l,j,b) + b*C(i,j,b) for l=0 and
+            // C(i,j,b) = a*opA(i,l,b)*opB(l,j,b) + C(i,j,b) for l>0
+            for(Index l = 0; l < k; ++l)
+            {
+                for(Index t = 0; t < ntiles; ++t)
+                {
+                    if(l > 0)
+                    {
+                        A_tile_offset[t] += opA_stride[1];
+                        B_tile_offset[t] += opB_stride[0];
+                    }
+                    const auto &A_tile_handle =
+                        A.get_tile_handle(A_tile_offset[t]);
+                    const auto &B_tile_handle =
+                        B.get_tile_handle(B_tile_offset[t]);
+                    // Transfer tiles A and B on node with tiles C
+                    A_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+                    B_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+                    A_tiles[t] = A_tile_handle;
+                    B_tiles[t] = B_tile_handle;
+                }
+                // Execute on node with tiles C
                 if(mpi_rank == C_tile_rank)
                 {
                     Index tile_k;
-                    auto A_first_tile_traits = A.get_tile_traits(
-                            A_tile_offset);
+                    const auto &A_tile_traits =
+                        A.get_tile_traits(A_tile_offset[0]);
                     switch(transA.value)
                     {
                         case TransOp::NoTrans:
-                            tile_k = A_first_tile_traits.matrix_shape[
+                            tile_k = A_tile_traits.matrix_shape[
                                 A.ndim-batch_ndim-ndim][1] / tile_batch;
                             break;
                             // This parameter was already checked
                             //case TransOp::Trans:
                         default:
-                            tile_k = A_first_tile_traits.matrix_shape[ndim][0];
+                            tile_k = A_tile_traits.matrix_shape[ndim][0];
                             break;
                     }
-                    starpu::gemm::submit<T, T_scal>(transA, transB, tile_m,
-                            tile_n,
-                            tile_k, tile_batch, alpha, A_first_tile_handle,
-                            B_first_tile_handle, beta, C_tile_handle, redux);
+                    starpu::gemm_grouped::submit<T>(transA, transB, tile_m,
+                            tile_n, tile_k, tile_batch, alpha, A_tiles,
+                            B_tiles, l == 0 ? beta : one, C_tiles, compute);
                 }
-                // all other l>0
-                for(Index l = 1; l < k; ++l)
-                {
-                    // accumulate C(i,j,b) = a*opA(i,l,b)*opB(l,j,b) + C(i,j,b)
-                    A_tile_offset += opA_stride[1];
-                    B_tile_offset += opB_stride[0];
-                    auto A_tile_handle = A.get_tile_handle(A_tile_offset);
-                    auto B_tile_handle = B.get_tile_handle(B_tile_offset);
-                    int A_tile_rank = A_tile_handle.mpi_get_rank();
-                    int B_tile_rank = B_tile_handle.mpi_get_rank();
-                    // Transfer tile A on node with tile C
-                    A_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
-                    // Transfer tile B on node with tile C
-                    B_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
-                    // Execute on node with tile C
-                    if(mpi_rank == C_tile_rank)
-                    {
-                        Index tile_k;
-                        auto A_tile_traits = A.get_tile_traits(A_tile_offset);
-                        switch(transA.value)
-                        {
-                            case TransOp::NoTrans:
-                                tile_k = A_tile_traits.matrix_shape[
-                                    A.ndim-batch_ndim-ndim][1] / tile_batch;
-                                break;
-                                // This parameter was already checked
-                                //case TransOp::Trans:
-                            default:
-                                tile_k = A_tile_traits.matrix_shape[ndim][0];
-                                break;
-                        }
-                        starpu::gemm::submit<T, T_scal>(transA, transB, tile_m,
-                                tile_n,
-                                tile_k, tile_batch, alpha, A_tile_handle,
-                                B_tile_handle, one, C_tile_handle, redux);
-                    }
-                }
-                // Flush cache for the output tile on every node
+            }
+            // Flush cache for the output tiles on every node
+            for(const auto &C_tile_handle: C_tiles)
+            {
                 C_tile_handle.mpi_flush();
             }
         }
-    }
+    };
+    starpu::submitters::parallel_for(groups.size(), submit_group);
+}
+
+//! Asynchronous version of tensor-wise gemm operation
+/*! Matrix multiplication for tensors, which are virtually reshaped. Products
+ * of tiny tiles of fp32_t and fp64_t tensors are submitted as grouped tasks
+ * of starpu::gemm_grouped, unless reductions are requested (see
+ * set_aggregate_nelems). Products with few tiles of C are split over the
+ * contracted dimensions without reductions (see set_gemm_split_k). Tiles of
+ * C can be split between CPU and CUDA workers (see set_gemm_hetero).
+ *
+ * @param[in] alpha: Alpha multiplier
+ * @param[in] transA: Transposition flag for the tensor A
+ * @param[in] A: Input tensor A
+ * @param[in] transB: Transposition flag for the tensor B
+ * @param[in] B: Input tensor B
+ * @param[in] beta: Beta multiplier
+ * @param[inout] C: Output tensor C
+ * @param[in] ndim: Number of dimensions used in gemm contraction
+ * @param[in] batch_ndim: Number of last dimensions used for batching of gemms
+ * @param[in] redux: Whether or not to use STARPU_REDUX. Value redux_tree
+ *      computes products of tiles of the contracted dimensions into partial
+ *      results in parallel and sums them by TreeReduction in a fixed order.
+ * @param[in] compute: Compute mode on CUDA devices
+ * */
+template<typename T, typename T_scal>
+void gemm_async(T_scal alpha, const TransOp &transA, const Tensor<T> &A,
+        const TransOp &transB, const Tensor<T> &B, T_scal beta,
+        const Tensor<T> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute)
+{
+    gemm_async_impl<T, T, T_scal>(alpha, transA, A, transB, B, beta, C, ndim,
+            batch_ndim, redux, compute);
+}
+
+//! Asynchronous gemm of fp16_t or bf16_t tensors into fp32_t tensor
+/*! Products of half precision tensors A and B are accumulated directly in a
+ * single precision tensor C, e.g., in gradients over weights, that are
+ * summed over many minibatches. This avoids conversions of C into half
+ * precision and back and rounding of C after every accumulation.
+ *
+ * @param[in] alpha: Alpha multiplier
+ * @param[in] transA: Transposition flag for the tensor A
+ * @param[in] A: Input tensor A
+ * @param[in] transB: Transposition flag for the tensor B
+ * @param[in] B: Input tensor B
+ * @param[in] beta: Beta multiplier
+ * @param[inout] C: Output tensor C
+ * @param[in] ndim: Number of dimensions used in gemm contraction
+ * @param[in] batch_ndim: Number of last dimensions used for batching of gemms
+ * @param[in] redux: Whether or not to use STARPU_REDUX or redux_tree
+ * @param[in] compute: Compute mode on CUDA devices
+ * */
+template<typename T>
+void gemm_mixed_async(fp32_t alpha, const TransOp &transA, const Tensor<T> &A,
+        const TransOp &transB, const Tensor<T> &B, fp32_t beta,
+        const Tensor<fp32_t> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute)
+{
+    gemm_async_impl<T, fp32_t, fp32_t>(alpha, transA, A, transB, B, beta, C,
+            ndim, batch_ndim, redux, compute);
 }
 
 //! Blocking version of tensor-wise gemm operation
@@ -484,14 +1089,30 @@ void gemm_async(T_scal alpha, const TransOp &transA, const Tensor<T> &A,
  * @param[inout] C: Output tensor C
  * @param[in] ndim: Number of dimensions used in gemm contraction
  * @param[in] batch_ndim: Number of last dimensions used for batching of gemms
+ * @param[in] redux: Whether or not to use STARPU_REDUX
+ * @param[in] compute: Compute mode on CUDA devices
  * */
 template<typename T, typename T_scal>
 void gemm(T_scal alpha, const TransOp &transA, const Tensor<T> &A,
         const TransOp &transB, const Tensor<T> &B, T_scal beta,
-        const Tensor<T> &C, Index ndim, Index batch_ndim, int redux)
+        const Tensor<T> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute)
 {
     gemm_async<T, T_scal>(alpha, transA, A, transB, B, beta, C, ndim,
-            batch_ndim, redux);
+            batch_ndim, redux, compute);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+//! Blocking gemm of fp16_t or bf16_t tensors into fp32_t tensor
+template<typename T>
+void gemm_mixed(fp32_t alpha, const TransOp &transA, const Tensor<T> &A,
+        const TransOp &transB, const Tensor<T> &B, fp32_t beta,
+        const Tensor<fp32_t> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute)
+{
+    gemm_mixed_async<T>(alpha, transA, A, transB, B, beta, C, ndim,
+            batch_ndim, redux, compute);
     starpu_task_wait_for_all();
     starpu_mpi_wait_for_all(MPI_COMM_WORLD);
 }
@@ -501,38 +1122,86 @@ template
 void gemm_async<fp32_t, fp32_t>(fp32_t alpha, const TransOp &transA,
         const Tensor<fp32_t> &A,
         const TransOp &transB, const Tensor<fp32_t> &B, fp32_t beta,
-        const Tensor<fp32_t> &C, Index ndim, Index batch_ndim, int redux);
+        const Tensor<fp32_t> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute);
 
 template
 void gemm_async<fp64_t, fp64_t>(fp64_t alpha, const TransOp &transA,
         const Tensor<fp64_t> &A,
         const TransOp &transB, const Tensor<fp64_t> &B, fp64_t beta,
-        const Tensor<fp64_t> &C, Index ndim, Index batch_ndim, int redux);
+        const Tensor<fp64_t> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute);
 
 template
 void gemm_async<fp16_t, fp32_t>(fp32_t alpha, const TransOp &transA,
         const Tensor<fp16_t> &A,
         const TransOp &transB, const Tensor<fp16_t> &B, fp32_t beta,
-        const Tensor<fp16_t> &C, Index ndim, Index batch_ndim, int redux);
+        const Tensor<fp16_t> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute);
+
+template
+void gemm_async<bf16_t, fp32_t>(fp32_t alpha, const TransOp &transA,
+        const Tensor<bf16_t> &A,
+        const TransOp &transB, const Tensor<bf16_t> &B, fp32_t beta,
+        const Tensor<bf16_t> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute);
 
 // Explicit instantiation
 template
 void gemm<fp32_t, fp32_t>(fp32_t alpha, const TransOp &transA,
         const Tensor<fp32_t> &A,
         const TransOp &transB, const Tensor<fp32_t> &B, fp32_t beta,
-        const Tensor<fp32_t> &C, Index ndim, Index batch_ndim, int redux);
+        const Tensor<fp32_t> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute);
 
 template
 void gemm<fp64_t, fp64_t>(fp64_t alpha, const TransOp &transA,
         const Tensor<fp64_t> &A,
         const TransOp &transB, const Tensor<fp64_t> &B, fp64_t beta,
-        const Tensor<fp64_t> &C, Index ndim, Index batch_ndim, int redux);
+        const Tensor<fp64_t> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute);
 
 template
 void gemm<fp16_t, fp32_t>(fp32_t alpha, const TransOp &transA,
         const Tensor<fp16_t> &A,
         const TransOp &transB, const Tensor<fp16_t> &B, fp32_t beta,
-        const Tensor<fp16_t> &C, Index ndim, Index batch_ndim, int redux);
+        const Tensor<fp16_t> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute);
+
+template
+void gemm<bf16_t, fp32_t>(fp32_t alpha, const TransOp &transA,
+        const Tensor<bf16_t> &A,
+        const TransOp &transB, const Tensor<bf16_t> &B, fp32_t beta,
+        const Tensor<bf16_t> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute);
+
+template
+void gemm_mixed_async<fp16_t>(fp32_t alpha, const TransOp &transA,
+        const Tensor<fp16_t> &A,
+        const TransOp &transB, const Tensor<fp16_t> &B, fp32_t beta,
+        const Tensor<fp32_t> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute);
+
+template
+void gemm_mixed_async<bf16_t>(fp32_t alpha, const TransOp &transA,
+        const Tensor<bf16_t> &A,
+        const TransOp &transB, const Tensor<bf16_t> &B, fp32_t beta,
+        const Tensor<fp32_t> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute);
+
+template
+void gemm_mixed<fp16_t>(fp32_t alpha, const TransOp &transA,
+        const Tensor<fp16_t> &A,
+        const TransOp &transB, const Tensor<fp16_t> &B, fp32_t beta,
+        const Tensor<fp32_t> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute);
+
+template
+void gemm_mixed<bf16_t>(fp32_t alpha, const TransOp &transA,
+        const Tensor<bf16_t> &A,
+        const TransOp &transB, const Tensor<bf16_t> &B, fp32_t beta,
+        const Tensor<fp32_t> &C, Index ndim, Index batch_ndim, int redux,
+        GemmCompute compute);
 
 } // namespace tensor
 } // namespace nntile
@@ -0,0 +1,195 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/gemm_bias_gelutanh.cc
+ * GEMM with fused bias addition and approximate GeLU of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#include "nntile/tensor/gemm_bias_gelutanh.hh"
+#include "nntile/tensor/gemm.hh"
+#include "nntile/tensor/bias_gelutanh.hh"
+#include "nntile/starpu/gemm_bias_gelutanh.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous tensor-wise gemm with bias and approximate GeLU
+/*! Computes C = alpha*op(A)*op(B) + bias and D = GeLUtanh(C). Tensors are
+ * virtually reshaped into matrices as in gemm_async() without batching, and
+ * the bias is broadcasted along all the axes of C except the given one. C is
+ * kept for the backward pass. Tiles of C and D shall be owned by the same
+ * nodes.
+ *
+ * The bias and the activation are fused into a single task per tile, if the
+ * contraction is not split into tiles and the bias is applied along the only
+ * row or the only column axis of C. Otherwise, gemm_async() is followed by
+ * bias_gelutanh_async().
+ *
+ * @param[in] alpha: Alpha multiplier
+ * @param[in] transA: Transposition flag for the tensor A
+ * @param[in] A: Input tensor A
+ * @param[in] transB: Transposition flag for the tensor B
+ * @param[in] B: Input tensor B
+ * @param[in] bias: Bias of size C.shape[axis]
+ * @param[out] C: Output of gemm with bias
+ * @param[out] D: Output of the activation
+ * @param[in] ndim: Number of dimensions used in gemm contraction
+ * @param[in] axis: Axis of C, along which the bias is applied
+ * @param[in] redux: Whether or not to use STARPU_REDUX for non-fused gemm
+ * */
+template<typename T>
+void gemm_bias_gelutanh_async(T alpha, const TransOp &transA,
+        const Tensor<T> &A, const TransOp &transB, const Tensor<T> &B,
+        const Tensor<T> &bias, const Tensor<T> &C, const Tensor<T> &D,
+        Index ndim, Index axis, int redux)
+{
+    // Check inputs (throw exception in case of an error)
+    gemm_check(transA, A, transB, B, C, ndim, 0);
+    bias_gelutanh_check(bias, C, D, axis);
+    // Sizes of A, B and C as simple matrices (grids of tiles) for gemm
+    Index m = C.grid.matrix_shape[A.ndim-ndim][0];
+    Index n = C.grid.matrix_shape[A.ndim-ndim][1];
+    Index k;
+    switch(transA.value)
+    {
+        case TransOp::NoTrans:
+            k = A.grid.matrix_shape[A.ndim-ndim][1];
+            break;
+        // This parameter was already checked in gemm_check
+        //case TransOp::Trans:
+        default:
+            k = A.grid.matrix_shape[ndim][0];
+    }
+    // Bias is along rows or along columns of C
+    Index bias_axis;
+    if(axis == 0 and A.ndim-ndim == 1)
+    {
+        bias_axis = 0;
+    }
+    else if(axis == C.ndim-1 and B.ndim-ndim == 1)
+    {
+        bias_axis = 1;
+    }
+    else
+    {
+        bias_axis = -1;
+    }
+    // Fall back to separate gemm and bias with activation
+    if(k != 1 or bias_axis == -1)
+    {
+        gemm_async<T, T>(alpha, transA, A, transB, B, T{0}, C, ndim, 0,
+                redux);
+        bias_gelutanh_async<T>(bias, C, D, axis);
+        return;
+    }
+    // Fused tasks: op(A) has a single column of tiles and op(B) has a single
+    // row of tiles
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index j = 0; j < n; ++j)
+    {
+        for(Index i = 0; i < m; ++i)
+        {
+            Index C_tile_offset = j*m + i;
+            const auto &C_tile_handle = C.get_tile_handle(C_tile_offset);
+            const auto &D_tile_handle = D.get_tile_handle(C_tile_offset);
+            int C_tile_rank = C_tile_handle.mpi_get_rank();
+            // Output of gemm with bias and the activation are computed by
+            // the same task
+            if(D_tile_handle.mpi_get_rank() != C_tile_rank)
+            {
+                throw std::runtime_error("Tiles of C and D are owned by "
+                        "different nodes");
+            }
+            const auto &A_tile_handle = A.get_tile_handle(i);
+            const auto &B_tile_handle = B.get_tile_handle(j);
+            const auto &bias_tile_handle = bias.get_tile_handle(
+                    bias_axis == 0 ? i : j);
+            // Transfer data
+            A_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+            B_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+            bias_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+            // Execute on node with tile C
+            if(mpi_rank == C_tile_rank)
+            {
+                const auto &C_tile_traits = C.get_tile_traits(C_tile_offset);
+                const auto &A_tile_traits = A.get_tile_traits(i);
+                Index tile_m = C_tile_traits.matrix_shape[A.ndim-ndim][0];
+                Index tile_n = C_tile_traits.matrix_shape[A.ndim-ndim][1];
+                Index tile_k;
+                switch(transA.value)
+                {
+                    case TransOp::NoTrans:
+                        tile_k = A_tile_traits.matrix_shape[A.ndim-ndim][1];
+                        break;
+                    // This parameter was already checked in gemm_check
+                    //case TransOp::Trans:
+                    default:
+                        tile_k = A_tile_traits.matrix_shape[ndim][0];
+                }
+                starpu::gemm_bias_gelutanh::submit<T>(transA, transB, tile_m,
+                        tile_n, tile_k, bias_axis, alpha, A_tile_handle,
+                        B_tile_handle, bias_tile_handle, C_tile_handle,
+                        D_tile_handle);
+            }
+            // Flush cache for the output tiles on every node
+            C_tile_handle.mpi_flush();
+            D_tile_handle.mpi_flush();
+        }
+    }
+}
+
+//! Blocking version of tensor-wise gemm with bias and approximate GeLU
+template<typename T>
+void gemm_bias_gelutanh(T alpha, const TransOp &transA, const Tensor<T> &A,
+        const TransOp &transB, const Tensor<T> &B, const Tensor<T> &bias,
+        const Tensor<T> &C, const Tensor<T> &D, Index ndim, Index axis,
+        int redux)
+{
+    gemm_bias_gelutanh_async<T>(alpha, transA, A, transB, B, bias, C, D,
+            ndim, axis, redux);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void gemm_bias_gelutanh_async<fp32_t>(fp32_t alpha, const TransOp &transA,
+        const Tensor<fp32_t> &A, const TransOp &transB,
+        const Tensor<fp32_t> &B, const Tensor<fp32_t> &bias,
+        const Tensor<fp32_t> &C, const Tensor<fp32_t> &D, Index ndim,
+        Index axis, int redux);
+
+template
+void gemm_bias_gelutanh_async<fp64_t>(fp64_t alpha, const TransOp &transA,
+        const Tensor<fp64_t> &A, const TransOp &transB,
+        const Tensor<fp64_t> &B, const Tensor<fp64_t> &bias,
+        const Tensor<fp64_t> &C, const Tensor<fp64_t> &D, Index ndim,
+        Index axis, int redux);
+
+// Explicit instantiation
+template
+void gemm_bias_gelutanh<fp32_t>(fp32_t alpha, const TransOp &transA,
+        const Tensor<fp32_t> &A, const TransOp &transB,
+        const Tensor<fp32_t> &B, const Tensor<fp32_t> &bias,
+        const Tensor<fp32_t> &C, const Tensor<fp32_t> &D, Index ndim,
+        Index axis, int redux);
+
+template
+void gemm_bias_gelutanh<fp64_t>(fp64_t alpha, const TransOp &transA,
+        const Tensor<fp64_t> &A, const TransOp &transB,
+        const Tensor<fp64_t> &B, const Tensor<fp64_t> &bias,
+        const Tensor<fp64_t> &C, const Tensor<fp64_t> &D, Index ndim,
+        Index axis, int redux);
+
+} // namespace tensor
+} // namespace nntile
+
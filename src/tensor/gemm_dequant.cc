@@ -0,0 +1,154 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/gemm_dequant.cc
+ * Gemm with dequantization of 8-bit weights on the fly for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/tensor/gemm_dequant.hh"
+#include "nntile/tensor/gemm.hh"
+#include "nntile/tensor/quantize.hh"
+#include "nntile/starpu/gemm_dequant.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous tensor-wise gemm with quantized weights
+/*! Computes C = alpha*dequant(A)*B + beta*C, where A and its scales are
+ * produced by quantize_async() with groups along the first contracted axis
+ * of A (axis A.ndim-ndim). Tensors are virtually reshaped into matrices as
+ * in gemm_async() without transpositions and batching. Tiles of A are
+ * dequantized on the fly by tasks, so quantized weights are read from
+ * memory only once per task.
+ *
+ * @param[in] alpha: Alpha multiplier
+ * @param[in] A: Input quantized tensor A
+ * @param[in] scale: Input scales of groups of A
+ * @param[in] B: Input tensor B
+ * @param[in] beta: Beta multiplier
+ * @param[inout] C: Output tensor C
+ * @param[in] ndim: Number of dimensions used in gemm contraction
+ * */
+template<typename Q>
+void gemm_dequant_async(fp32_t alpha, const Tensor<Q> &A,
+        const Tensor<fp32_t> &scale, const Tensor<fp32_t> &B, fp32_t beta,
+        const Tensor<fp32_t> &C, Index ndim)
+{
+    // Check inputs (throw exception in case of an error)
+    gemm_check(TransOp(TransOp::NoTrans), A, TransOp(TransOp::NoTrans), B, C,
+            ndim, 0);
+    Index axis = A.ndim - ndim;
+    if(scale.ndim != A.ndim)
+    {
+        throw std::runtime_error("scale.ndim != A.ndim");
+    }
+    if(scale.basetile_shape[axis] == 0)
+    {
+        throw std::runtime_error("scale.basetile_shape[A.ndim-ndim] == 0");
+    }
+    Index group = A.basetile_shape[axis] / scale.basetile_shape[axis];
+    quantize_check(A, A, scale, axis, group);
+    // Sizes of A, B and C as simple matrices (grids of tiles) for gemm
+    int mpi_rank = starpu_mpi_world_rank();
+    constexpr fp32_t one = 1;
+    Index m = C.grid.matrix_shape[axis][0];
+    Index n = C.grid.matrix_shape[axis][1];
+    Index k = A.grid.matrix_shape[axis][1];
+    for(Index j = 0; j < n; ++j)
+    {
+        for(Index i = 0; i < m; ++i)
+        {
+            Index C_tile_offset = j*m + i;
+            const auto &C_tile_handle = C.get_tile_handle(C_tile_offset);
+            int C_tile_rank = C_tile_handle.mpi_get_rank();
+            for(Index l = 0; l < k; ++l)
+            {
+                // C(i,j) = a*A(i,l)*B(l,j) + b*C(i,j) for l=0 and
+                // C(i,j) = a*A(i,l)*B(l,j) + C(i,j) for l>0
+                Index A_tile_offset = l*m + i;
+                Index B_tile_offset = j*k + l;
+                const auto &A_tile_handle = A.get_tile_handle(A_tile_offset);
+                const auto &scale_tile_handle = scale.get_tile_handle(
+                        A_tile_offset);
+                const auto &B_tile_handle = B.get_tile_handle(B_tile_offset);
+                // Transfer data
+                A_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+                scale_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+                B_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+                // Execute on node with tile C
+                if(mpi_rank == C_tile_rank)
+                {
+                    const auto &C_tile_traits =
+                        C.get_tile_traits(C_tile_offset);
+                    const auto &A_tile_traits =
+                        A.get_tile_traits(A_tile_offset);
+                    Index tile_m = C_tile_traits.matrix_shape[axis][0];
+                    Index tile_n = C_tile_traits.matrix_shape[axis][1];
+                    Index tile_k = A_tile_traits.matrix_shape[axis][1];
+                    starpu::gemm_dequant::submit<Q>(tile_m, tile_n, tile_k,
+                            group, alpha, A_tile_handle, scale_tile_handle,
+                            B_tile_handle, (l == 0) ? beta : one,
+                            C_tile_handle);
+                }
+            }
+            // Flush cache for the output tile on every node
+            C_tile_handle.mpi_flush();
+        }
+    }
+}
+
+//! Blocking version of tensor-wise gemm with quantized weights
+/*! @param[in] alpha: Alpha multiplier
+ * @param[in] A: Input quantized tensor A
+ * @param[in] scale: Input scales of groups of A
+ * @param[in] B: Input tensor B
+ * @param[in] beta: Beta multiplier
+ * @param[inout] C: Output tensor C
+ * @param[in] ndim: Number of dimensions used in gemm contraction
+ * */
+template<typename Q>
+void gemm_dequant(fp32_t alpha, const Tensor<Q> &A,
+        const Tensor<fp32_t> &scale, const Tensor<fp32_t> &B, fp32_t beta,
+        const Tensor<fp32_t> &C, Index ndim)
+{
+    gemm_dequant_async<Q>(alpha, A, scale, B, beta, C, ndim);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void gemm_dequant_async<std::int8_t>(fp32_t alpha,
+        const Tensor<std::int8_t> &A, const Tensor<fp32_t> &scale,
+        const Tensor<fp32_t> &B, fp32_t beta, const Tensor<fp32_t> &C,
+        Index ndim);
+
+template
+void gemm_dequant_async<fp8_e4m3_t>(fp32_t alpha,
+        const Tensor<fp8_e4m3_t> &A, const Tensor<fp32_t> &scale,
+        const Tensor<fp32_t> &B, fp32_t beta, const Tensor<fp32_t> &C,
+        Index ndim);
+
+// Explicit instantiation
+template
+void gemm_dequant<std::int8_t>(fp32_t alpha, const Tensor<std::int8_t> &A,
+        const Tensor<fp32_t> &scale, const Tensor<fp32_t> &B, fp32_t beta,
+        const Tensor<fp32_t> &C, Index ndim);
+
+template
+void gemm_dequant<fp8_e4m3_t>(fp32_t alpha, const Tensor<fp8_e4m3_t> &A,
+        const Tensor<fp32_t> &scale, const Tensor<fp32_t> &B, fp32_t beta,
+        const Tensor<fp32_t> &C, Index ndim);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/tensor/gemm_ex.hh"
+#include "nntile/tensor/tree_reduction.hh"
 #include "nntile/tensor/gemm.hh"
 #include "nntile/starpu/gemm_ex.hh"
 
@@ -43,6 +44,8 @@ void gemm_ex_async(T alpha, const TransOp &transA, const Tensor<T> &A,
     // Check inputs (throw exception in case of an error)
     gemm_check(transA, A, transB, B, C, ndim, batch_ndim);
     // Sizes of A, B and C as simple matrices (grids of tiles) for gemm
+    // Deterministic mode replaces STARPU_REDUX by a sequential chain
+    redux = redux_mode(redux, false);
     int mpi_rank = starpu_mpi_world_rank();
     int ret;
     constexpr T one = 1;
@@ -79,8 +82,8 @@ void gemm_ex_async(T alpha, const TransOp &transA, const Tensor<T> &A,
             for(Index i = 0; i < m; ++i)
             {
                 Index C_tile_offset = (b*n+j)*m + i;
-                auto C_tile_handle = C.get_tile_handle(C_tile_offset);
-                auto C_tile_traits = C.get_tile_traits(C_tile_offset);
+                const auto &C_tile_handle = C.get_tile_handle(C_tile_offset);
+                const auto &C_tile_traits = C.get_tile_traits(C_tile_offset);
                 int C_tile_rank = C_tile_handle.mpi_get_rank();
                 Index tile_m = C_tile_traits.matrix_shape[
                     A.ndim-batch_ndim-ndim][0];
@@ -91,8 +94,10 @@ void gemm_ex_async(T alpha, const TransOp &transA, const Tensor<T> &A,
                 // initialize C(i,j,b) = a*opA(i,0,b)*opB(0,j,b) + b*C(i,j,b)
                 Index A_tile_offset = opA_stride[0]*i + b*m*k;
                 Index B_tile_offset = opB_stride[1]*j + b*n*k;
-                auto A_first_tile_handle = A.get_tile_handle(A_tile_offset);
-                auto B_first_tile_handle = B.get_tile_handle(B_tile_offset);
+                const auto &A_first_tile_handle =
+                        A.get_tile_handle(A_tile_offset);
+                const auto &B_first_tile_handle =
+                        B.get_tile_handle(B_tile_offset);
                 int A_first_tile_rank = A_first_tile_handle.mpi_get_rank();
                 int B_first_tile_rank = B_first_tile_handle.mpi_get_rank();
                 // Transfer first tile A on node with tile C
@@ -103,7 +108,7 @@ void gemm_ex_async(T alpha, const TransOp &transA, const Tensor<T> &A,
                 if(mpi_rank == C_tile_rank)
                 {
                     Index tile_k;
-                    auto A_first_tile_traits = A.get_tile_traits(
+                    const auto &A_first_tile_traits = A.get_tile_traits(
                             A_tile_offset);
                     switch(transA.value)
                     {
@@ -127,8 +132,10 @@ void gemm_ex_async(T alpha, const TransOp &transA, const Tensor<T> &A,
                     // accumulate C(i,j,b) = a*opA(i,l,b)*opB(l,j,b) + C(i,j,b)
                     A_tile_offset += opA_stride[1];
                     B_tile_offset += opB_stride[0];
-                    auto A_tile_handle = A.get_tile_handle(A_tile_offset);
-                    auto B_tile_handle = B.get_tile_handle(B_tile_offset);
+                    const auto &A_tile_handle =
+                            A.get_tile_handle(A_tile_offset);
+                    const auto &B_tile_handle =
+                            B.get_tile_handle(B_tile_offset);
                     int A_tile_rank = A_tile_handle.mpi_get_rank();
                     int B_tile_rank = B_tile_handle.mpi_get_rank();
                     // Transfer tile A on node with tile C
@@ -139,7 +146,8 @@ void gemm_ex_async(T alpha, const TransOp &transA, const Tensor<T> &A,
                     if(mpi_rank == C_tile_rank)
                     {
                         Index tile_k;
-                        auto A_tile_traits = A.get_tile_traits(A_tile_offset);
+                        const auto &A_tile_traits =
+                            A.get_tile_traits(A_tile_offset);
                         switch(transA.value)
                         {
                             case TransOp::NoTrans:
@@ -0,0 +1,348 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/gemm_summa.cc
+ * Communication-avoiding distributed GEMM (SUMMA and 2.5D) for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/tensor/gemm_summa.hh"
+#include "nntile/tensor/gemm.hh"
+#include "nntile/starpu/gemm.hh"
+#include "nntile/starpu/add.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous distributed gemm with panel broadcasts and replication
+/*! Computes the same as gemm_async, but the order of submission and data
+ * transfers follows SUMMA. The outer loop goes over panels of the
+ * contracted dimension. Tiles of the panel A(:,l) are sent to ranks
+ * owning rows of C, and tiles of the panel B(l,:) to ranks owning columns
+ * of C. StarPU-MPI sends a tile to a rank only once, so with a
+ * block_cyclic distribution of C over a grid of p_r x p_c ranks each tile
+ * of A goes to at most p_c ranks and each tile of B to at most p_r ranks.
+ * Cached copies of a panel are flushed as soon as all tasks of the panel
+ * are submitted, so memory consumed by received tiles is bounded by a
+ * single panel instead of entire A and B, and panels are pipelined by
+ * the runtime system.
+ *
+ * Optional replicas of C enable the 2.5D algorithm. The contracted
+ * dimension is split into c=C_replicas.size()+1 contiguous ranges. The
+ * first range accumulates into C and the other ranges accumulate partial
+ * products into the replicas. Replicas are then reduced into C. If the
+ * replica r is distributed by block_cyclic on its own layer of ranks
+ * (start_rank=r*p_r*p_c), every layer receives only 1/c part of panels,
+ * which reduces bandwidth of A and B transfers by a factor of c at the
+ * cost of one reduction of C. Replicas work as temporaries, their values
+ * are overwritten. With replicas, tiles of C are computed and reduced by
+ * columns of tiles, so that the reduction is pipelined with products.
+ *
+ * @param[in] alpha: Alpha multiplier
+ * @param[in] transA: Transposition flag for the tensor A
+ * @param[in] A: Input tensor A
+ * @param[in] transB: Transposition flag for the tensor B
+ * @param[in] B: Input tensor B
+ * @param[in] beta: Beta multiplier
+ * @param[inout] C: Output tensor C
+ * @param[in] ndim: Number of dimensions used in gemm contraction
+ * @param[in] batch_ndim: Number of last dimensions used for batching of gemms
+ * @param[scratch] C_replicas: Temporary tensors of the same shape and
+ *      basetile as C, distributed over other layers of ranks
+ * @param[in] redux: Whether or not to use STARPU_REDUX
+ * */
+template<typename T>
+void gemm_summa_async(T alpha, const TransOp &transA, const Tensor<T> &A,
+        const TransOp &transB, const Tensor<T> &B, T beta,
+        const Tensor<T> &C, Index ndim, Index batch_ndim,
+        const std::vector<Tensor<T>> &C_replicas, int redux)
+{
+    // Check inputs (throw exception in case of an error)
+    gemm_check(transA, A, transB, B, C, ndim, batch_ndim);
+    for(const auto &R: C_replicas)
+    {
+        if(R.shape != C.shape)
+        {
+            throw std::runtime_error("C_replicas[i].shape != C.shape");
+        }
+        if(R.basetile_shape != C.basetile_shape)
+        {
+            throw std::runtime_error("C_replicas[i].basetile_shape != "
+                    "C.basetile_shape");
+        }
+    }
+    // Sizes of A, B and C as simple matrices (grids of tiles) for gemm
+    int mpi_rank = starpu_mpi_world_rank();
+    constexpr T one = 1, zero = 0;
+    Index m = C.grid.matrix_shape[A.ndim-batch_ndim-ndim][0];
+    Index batch = C.grid.matrix_shape[C.ndim-batch_ndim][1];
+    Index n = C.grid.matrix_shape[A.ndim-batch_ndim-ndim][1] / batch;
+    Index k;
+    std::array<Index, 2> opA_stride, opB_stride;
+    switch(transA.value)
+    {
+        case TransOp::NoTrans:
+            k = A.grid.matrix_shape[A.ndim-batch_ndim-ndim][1] / batch;
+            opA_stride = {1, m};
+            break;
+        case TransOp::Trans:
+            k = A.grid.matrix_shape[ndim][0];
+            opA_stride = {k, 1};
+            break;
+    }
+    switch(transB.value)
+    {
+        case TransOp::NoTrans:
+            opB_stride = {1, k};
+            break;
+        case TransOp::Trans:
+            opB_stride = {n, 1};
+            break;
+    }
+    // Number of layers cannot exceed number of panels, as otherwise some
+    // replicas would not be initialized
+    Index nlayers = std::min<Index>(C_replicas.size()+1, k);
+    // Product of panels of A(i_begin:i_end,l) and B(l,j_begin:j_end)
+    auto submit_panel = [&](Index b, Index l, Index i_begin, Index i_end,
+            Index j_begin, Index j_end)
+    {
+        // Layer, that accumulates the panel, and whether the panel is the
+        // first one of the layer
+        Index layer = l * nlayers / k;
+        bool first = (layer*k+nlayers-1)/nlayers == l;
+        const Tensor<T> &D = (layer == 0) ? C : C_replicas[layer-1];
+        T panel_beta = first ? ((layer == 0) ? beta : zero) : one;
+        for(Index j = j_begin; j < j_end; ++j)
+        {
+            Index B_tile_offset = opB_stride[0]*l + opB_stride[1]*j
+                + b*n*k;
+            const auto &B_tile_handle = B.get_tile_handle(B_tile_offset);
+            for(Index i = i_begin; i < i_end; ++i)
+            {
+                Index D_tile_offset = (b*n+j)*m + i;
+                const auto &D_tile_handle = D.get_tile_handle(D_tile_offset);
+                int D_tile_rank = D_tile_handle.mpi_get_rank();
+                Index A_tile_offset = opA_stride[0]*i + opA_stride[1]*l
+                    + b*m*k;
+                const auto &A_tile_handle = A.get_tile_handle(A_tile_offset);
+                // Transfer tiles of panels, that are sent only once to each
+                // of ranks until they are flushed
+                A_tile_handle.mpi_transfer(D_tile_rank, mpi_rank);
+                B_tile_handle.mpi_transfer(D_tile_rank, mpi_rank);
+                // Execute on node with tile of C or its replica
+                if(mpi_rank == D_tile_rank)
+                {
+                    const auto &D_tile_traits =
+                        D.get_tile_traits(D_tile_offset);
+                    const auto &A_tile_traits =
+                        A.get_tile_traits(A_tile_offset);
+                    Index tile_m = D_tile_traits.matrix_shape[
+                        A.ndim-batch_ndim-ndim][0];
+                    Index tile_batch = D_tile_traits.matrix_shape[
+                        C.ndim-batch_ndim][1];
+                    Index tile_n = D_tile_traits.matrix_shape[
+                        A.ndim-batch_ndim-ndim][1] / tile_batch;
+                    Index tile_k;
+                    switch(transA.value)
+                    {
+                        case TransOp::NoTrans:
+                            tile_k = A_tile_traits.matrix_shape[
+                                A.ndim-batch_ndim-ndim][1] / tile_batch;
+                            break;
+                            // This parameter was already checked
+                            //case TransOp::Trans:
+                        default:
+                            tile_k = A_tile_traits.matrix_shape[ndim][0];
+                            break;
+                    }
+                    starpu::gemm::submit<T, T>(transA, transB, tile_m,
+                            tile_n, tile_k, tile_batch, alpha,
+                            A_tile_handle, B_tile_handle, panel_beta,
+                            D_tile_handle, redux);
+                }
+            }
+        }
+    };
+    // Reduce replicas of a tile into C
+    auto reduce_tile = [&](Index i)
+    {
+        const auto &C_tile_handle = C.get_tile_handle(i);
+        int C_tile_rank = C_tile_handle.mpi_get_rank();
+        for(Index r = 1; r < nlayers; ++r)
+        {
+            const auto &R_tile_handle = C_replicas[r-1].get_tile_handle(i);
+            R_tile_handle.mpi_transfer(C_tile_rank, mpi_rank);
+            if(mpi_rank == C_tile_rank)
+            {
+                const auto &C_tile_traits = C.get_tile_traits(i);
+                starpu::add::submit<T>(C_tile_traits.nelems, one,
+                        R_tile_handle, one, C_tile_handle);
+            }
+            R_tile_handle.mpi_flush();
+        }
+        // Flush cache for the output tile on every node
+        C_tile_handle.mpi_flush();
+    };
+    auto flush_A = [&](Index b, Index l, Index i)
+    {
+        A.get_tile_handle(opA_stride[0]*i + opA_stride[1]*l
+                + b*m*k).mpi_flush();
+    };
+    auto flush_B = [&](Index b, Index l, Index j)
+    {
+        B.get_tile_handle(opB_stride[0]*l + opB_stride[1]*j
+                + b*n*k).mpi_flush();
+    };
+    if(nlayers == 1)
+    {
+        for(Index b = 0; b < batch; ++b)
+        {
+            // Outer loop over panels of the contracted dimension
+            for(Index l = 0; l < k; ++l)
+            {
+                submit_panel(b, l, 0, m, 0, n);
+                // Flush received copies of the panel on every node
+                for(Index i = 0; i < m; ++i)
+                {
+                    flush_A(b, l, i);
+                }
+                for(Index j = 0; j < n; ++j)
+                {
+                    flush_B(b, l, j);
+                }
+            }
+        }
+        for(Index i = 0; i < C.grid.nelems; ++i)
+        {
+            reduce_tile(i);
+        }
+        return;
+    }
+    // With replicas the output is computed by chunks of a single column of
+    // tiles of C (or a single row, if there is only one column), and
+    // replicas of a chunk are reduced right after all its panels are
+    // submitted. Transfers of partial sums of a chunk to ranks of C overlap
+    // with products of the following chunks, as in collective matmul,
+    // instead of starting after the entire gemm. Tiles of the operand, that
+    // is shared by chunks, are kept on ranks until the last chunk of a
+    // batch, so they are still sent only once.
+    bool by_rows = (n == 1);
+    Index nchunks = by_rows ? m : n;
+    for(Index b = 0; b < batch; ++b)
+    {
+        for(Index c = 0; c < nchunks; ++c)
+        {
+            Index i_begin = by_rows ? c : 0, i_end = by_rows ? c+1 : m;
+            Index j_begin = by_rows ? 0 : c, j_end = by_rows ? n : c+1;
+            for(Index l = 0; l < k; ++l)
+            {
+                submit_panel(b, l, i_begin, i_end, j_begin, j_end);
+                // Flush received tiles, that are used only by the chunk
+                if(by_rows)
+                {
+                    flush_A(b, l, c);
+                }
+                else
+                {
+                    flush_B(b, l, c);
+                }
+            }
+            for(Index j = j_begin; j < j_end; ++j)
+            {
+                for(Index i = i_begin; i < i_end; ++i)
+                {
+                    reduce_tile((b*n+j)*m + i);
+                }
+            }
+        }
+        // Flush received tiles, that are shared by all chunks
+        for(Index l = 0; l < k; ++l)
+        {
+            if(by_rows)
+            {
+                for(Index j = 0; j < n; ++j)
+                {
+                    flush_B(b, l, j);
+                }
+            }
+            else
+            {
+                for(Index i = 0; i < m; ++i)
+                {
+                    flush_A(b, l, i);
+                }
+            }
+        }
+    }
+}
+
+//! Blocking version of distributed gemm with panel broadcasts
+/*! Matrix multiplication for tensors, which are virtually reshaped
+ *
+ * @param[in] alpha: Alpha multiplier
+ * @param[in] transA: Transposition flag for the tensor A
+ * @param[in] A: Input tensor A
+ * @param[in] transB: Transposition flag for the tensor B
+ * @param[in] B: Input tensor B
+ * @param[in] beta: Beta multiplier
+ * @param[inout] C: Output tensor C
+ * @param[in] ndim: Number of dimensions used in gemm contraction
+ * @param[in] batch_ndim: Number of last dimensions used for batching of gemms
+ * @param[scratch] C_replicas: Temporary tensors of the same shape and
+ *      basetile as C, distributed over other layers of ranks
+ * @param[in] redux: Whether or not to use STARPU_REDUX
+ * */
+template<typename T>
+void gemm_summa(T alpha, const TransOp &transA, const Tensor<T> &A,
+        const TransOp &transB, const Tensor<T> &B, T beta,
+        const Tensor<T> &C, Index ndim, Index batch_ndim,
+        const std::vector<Tensor<T>> &C_replicas, int redux)
+{
+    gemm_summa_async<T>(alpha, transA, A, transB, B, beta, C, ndim,
+            batch_ndim, C_replicas, redux);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void gemm_summa_async<fp32_t>(fp32_t alpha, const TransOp &transA,
+        const Tensor<fp32_t> &A, const TransOp &transB,
+        const Tensor<fp32_t> &B, fp32_t beta, const Tensor<fp32_t> &C,
+        Index ndim, Index batch_ndim,
+        const std::vector<Tensor<fp32_t>> &C_replicas, int redux);
+
+template
+void gemm_summa_async<fp64_t>(fp64_t alpha, const TransOp &transA,
+        const Tensor<fp64_t> &A, const TransOp &transB,
+        const Tensor<fp64_t> &B, fp64_t beta, const Tensor<fp64_t> &C,
+        Index ndim, Index batch_ndim,
+        const std::vector<Tensor<fp64_t>> &C_replicas, int redux);
+
+// Explicit instantiation
+template
+void gemm_summa<fp32_t>(fp32_t alpha, const TransOp &transA,
+        const Tensor<fp32_t> &A, const TransOp &transB,
+        const Tensor<fp32_t> &B, fp32_t beta, const Tensor<fp32_t> &C,
+        Index ndim, Index batch_ndim,
+        const std::vector<Tensor<fp32_t>> &C_replicas, int redux);
+
+template
+void gemm_summa<fp64_t>(fp64_t alpha, const TransOp &transA,
+        const Tensor<fp64_t> &A, const TransOp &transB,
+        const Tensor<fp64_t> &B, fp64_t beta, const Tensor<fp64_t> &C,
+        Index ndim, Index batch_ndim,
+        const std::vector<Tensor<fp64_t>> &C_replicas, int redux);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,105 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/global_nrm2.cc
+ * Euclidean norm of many tensors as a whole
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/global_nrm2.hh"
+#include "nntile/tensor/tree_reduction.hh"
+#include "nntile/starpu/nrm2.hh"
+#include "nntile/starpu/clear.hh"
+#include "nntile/starpu/accumulate_hypot.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous Euclidean norm of many tensors as a whole
+/*! Norm of every tile is computed on the node, that owns the tile, and
+ * norms of all the tiles of all the tensors are combined by TreeReduction
+ * with accumulate_hypot. For example, a global norm of gradients of all
+ * the parameters of a model stays on the device for gradient clipping
+ * (see clip_scale_async()) without any synchronization with the host.
+ *
+ * @param[in] src: Tensors, whose norm is computed
+ * @param[out] dst: Scalar tensor for the result
+ * */
+template<typename T>
+void global_nrm2_async(const std::vector<Tensor<T>> &src,
+        const Tensor<T> &dst)
+{
+    // Check dimensions
+    if(dst.ndim != 0)
+    {
+        throw std::runtime_error("dst.ndim != 0");
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    const auto &dst_tile_handle = dst.get_tile_handle(0);
+    int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+    // Result is accumulated into the cleared destination
+    if(mpi_rank == dst_tile_rank)
+    {
+        starpu::clear::submit(dst_tile_handle);
+    }
+    TreeReduction tree(dst_tile_handle, sizeof(T),
+            starpu::accumulate_hypot::submit<T>);
+    for(Index j = 0; j < src.size(); ++j)
+    {
+        for(Index i = 0; i < src[j].grid.nelems; ++i)
+        {
+            const auto &src_tile_handle = src[j].get_tile_handle(i);
+            int src_tile_rank = src_tile_handle.mpi_get_rank();
+            // Norm of a tile is computed on the node with the tile
+            auto partial = tree.get_partial(src_tile_rank);
+            if(mpi_rank == src_tile_rank)
+            {
+                auto src_tile_traits = src[j].get_tile_traits(i);
+                starpu::nrm2::submit<T>(src_tile_traits.nelems,
+                        src_tile_handle, partial);
+            }
+        }
+    }
+    tree.submit();
+    // Flush cache for the output tile on every node
+    dst_tile_handle.mpi_flush();
+}
+
+//! Blocking version of Euclidean norm of many tensors as a whole
+template<typename T>
+void global_nrm2(const std::vector<Tensor<T>> &src, const Tensor<T> &dst)
+{
+    global_nrm2_async<T>(src, dst);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void global_nrm2_async<fp32_t>(const std::vector<Tensor<fp32_t>> &src,
+        const Tensor<fp32_t> &dst);
+
+template
+void global_nrm2_async<fp64_t>(const std::vector<Tensor<fp64_t>> &src,
+        const Tensor<fp64_t> &dst);
+
+// Explicit instantiation
+template
+void global_nrm2<fp32_t>(const std::vector<Tensor<fp32_t>> &src,
+        const Tensor<fp32_t> &dst);
+
+template
+void global_nrm2<fp64_t>(const std::vector<Tensor<fp64_t>> &src,
+        const Tensor<fp64_t> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
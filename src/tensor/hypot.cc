@@ -52,8 +52,8 @@ void hypot_async(T alpha, const Tensor<T> &src, T beta, const Tensor<T> &dst)
     for(Index i = 0; i < src.grid.nelems; ++i)
     {
         // Get handle for corresponding tiles of src and dst
-        auto src_tile_handle = src.get_tile_handle(i);
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         // MPI rank of the destination tile
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Transfer data
@@ -61,7 +61,7 @@ void hypot_async(T alpha, const Tensor<T> &src, T beta, const Tensor<T> &dst)
         // Execute only on destination node
         if(mpi_rank == dst_tile_rank)
         {
-            auto traits = src.get_tile_traits(i);
+            const auto &traits = src.get_tile_traits(i);
             starpu::hypot::submit<T>(traits.nelems, alpha, src_tile_handle,
                     beta, dst_tile_handle);
         }
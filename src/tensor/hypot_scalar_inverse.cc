@@ -27,13 +27,13 @@ void hypot_scalar_inverse_async(T eps, T alpha, const Tensor<T> &dst)
     int mpi_rank = starpu_mpi_world_rank();
     for(Index i = 0; i < dst.grid.nelems; ++i)
     {
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         // MPI rank of the destination tile
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Execute only on destination node
         if(mpi_rank == dst_tile_rank)
         {
-            auto traits = dst.get_tile_traits(i);
+            const auto &traits = dst.get_tile_traits(i);
             starpu::hypot_scalar_inverse::submit<T>(traits.nelems, eps, alpha,
                     dst_tile_handle);
         }
@@ -0,0 +1,294 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/layer_norm_backward.cc
+ * Backward of fused layer normalization of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-05
+ * */
+
+#include "nntile/tensor/layer_norm_backward.hh"
+#include "nntile/tensor/tree_reduction.hh"
+#include "nntile/starpu/layer_norm_backward.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Backward of fused layer normalization along a given axis
+/*! Gradients are accumulated into src_grad, gamma_grad and beta_grad. The
+ * axis shall not be split into tiles. Every task updates gradients of gamma
+ * and beta, so their tiles shall be owned by the same node as all the tiles
+ * of src_grad.
+ *
+ * @param[in] src: Input of the forward pass
+ * @param[in] dst_grad: Gradient of output of the forward pass
+ * @param[in] gamma: Scaling factors of size src.shape[axis]
+ * @param[in] mean: Means, computed by the forward pass
+ * @param[in] inv_stddev: Inverses of standard deviations, computed by the
+ *      forward pass
+ * @param[inout] src_grad: Gradient of input
+ * @param[inout] gamma_grad: Gradient of gamma
+ * @param[inout] beta_grad: Gradient of beta
+ * @param[in] axis: Axis of normalization
+ * @param[in] redux: Whether to use STARPU_REDUX for gamma_grad and beta_grad
+ * */
+template<typename T>
+void layer_norm_backward_async(const Tensor<T> &src,
+        const Tensor<T> &dst_grad, const Tensor<T> &gamma,
+        const Tensor<T> &mean, const Tensor<T> &inv_stddev,
+        const Tensor<T> &src_grad, const Tensor<T> &gamma_grad,
+        const Tensor<T> &beta_grad, Index axis, int redux)
+{
+    // Check dimensions
+    if(src.ndim != dst_grad.ndim)
+    {
+        throw std::runtime_error("src.ndim != dst_grad.ndim");
+    }
+    if(src.ndim != src_grad.ndim)
+    {
+        throw std::runtime_error("src.ndim != src_grad.ndim");
+    }
+    if(src.ndim-1 != mean.ndim)
+    {
+        throw std::runtime_error("src.ndim-1 != mean.ndim");
+    }
+    if(src.ndim-1 != inv_stddev.ndim)
+    {
+        throw std::runtime_error("src.ndim-1 != inv_stddev.ndim");
+    }
+    if(gamma.ndim != 1)
+    {
+        throw std::runtime_error("gamma.ndim != 1");
+    }
+    if(gamma_grad.ndim != 1)
+    {
+        throw std::runtime_error("gamma_grad.ndim != 1");
+    }
+    if(beta_grad.ndim != 1)
+    {
+        throw std::runtime_error("beta_grad.ndim != 1");
+    }
+    // Treat special case of src.ndim=0
+    if(src.ndim == 0)
+    {
+        throw std::runtime_error("Scalar input makes no sense");
+    }
+    Index ndim = src.ndim;
+    // Check axis
+    if(axis < 0)
+    {
+        throw std::runtime_error("axis < 0");
+    }
+    if(axis >= ndim)
+    {
+        throw std::runtime_error("axis >= src.ndim");
+    }
+    // Check shapes
+    if(src.shape != dst_grad.shape)
+    {
+        throw std::runtime_error("src.shape != dst_grad.shape");
+    }
+    if(src.basetile_shape != dst_grad.basetile_shape)
+    {
+        throw std::runtime_error("src.basetile_shape != "
+                "dst_grad.basetile_shape");
+    }
+    if(src.shape != src_grad.shape)
+    {
+        throw std::runtime_error("src.shape != src_grad.shape");
+    }
+    if(src.basetile_shape != src_grad.basetile_shape)
+    {
+        throw std::runtime_error("src.basetile_shape != "
+                "src_grad.basetile_shape");
+    }
+    if(mean.shape != inv_stddev.shape)
+    {
+        throw std::runtime_error("mean.shape != inv_stddev.shape");
+    }
+    if(mean.basetile_shape != inv_stddev.basetile_shape)
+    {
+        throw std::runtime_error("mean.basetile_shape != "
+                "inv_stddev.basetile_shape");
+    }
+    for(Index i = 0; i < axis; i++)
+    {
+        if(src.shape[i] != mean.shape[i])
+        {
+            throw std::runtime_error("src.shape[i] != mean.shape[i]");
+        }
+        if(src.basetile_shape[i] != mean.basetile_shape[i])
+        {
+            throw std::runtime_error("src.basetile_shape[i] != "
+                    "mean.basetile_shape[i]");
+        }
+    }
+    for(Index i = axis+1; i < ndim; i++)
+    {
+        if(src.shape[i] != mean.shape[i-1])
+        {
+            throw std::runtime_error("src.shape[i] != mean.shape[i-1]");
+        }
+        if(src.basetile_shape[i] != mean.basetile_shape[i-1])
+        {
+            throw std::runtime_error("src.basetile_shape[i] != "
+                    "mean.basetile_shape[i-1]");
+        }
+    }
+    if(src.basetile_shape[axis] != src.shape[axis])
+    {
+        throw std::runtime_error("src.basetile_shape[axis] != "
+                "src.shape[axis]");
+    }
+    if(src.shape[axis] != gamma.shape[0])
+    {
+        throw std::runtime_error("src.shape[axis] != gamma.shape[0]");
+    }
+    if(gamma.basetile_shape[0] != gamma.shape[0])
+    {
+        throw std::runtime_error("gamma.basetile_shape[0] != "
+                "gamma.shape[0]");
+    }
+    if(gamma.shape != gamma_grad.shape)
+    {
+        throw std::runtime_error("gamma.shape != gamma_grad.shape");
+    }
+    if(gamma.basetile_shape != gamma_grad.basetile_shape)
+    {
+        throw std::runtime_error("gamma.basetile_shape != "
+                "gamma_grad.basetile_shape");
+    }
+    if(gamma.shape != beta_grad.shape)
+    {
+        throw std::runtime_error("gamma.shape != beta_grad.shape");
+    }
+    if(gamma.basetile_shape != beta_grad.basetile_shape)
+    {
+        throw std::runtime_error("gamma.basetile_shape != "
+                "beta_grad.basetile_shape");
+    }
+    // Do actual calculations
+    // Deterministic mode replaces STARPU_REDUX by a sequential chain
+    redux = redux_mode(redux, false);
+    int mpi_rank = starpu_mpi_world_rank();
+    const auto &gamma_tile_handle = gamma.get_tile_handle(0);
+    const auto &gamma_grad_tile_handle = gamma_grad.get_tile_handle(0);
+    const auto &beta_grad_tile_handle = beta_grad.get_tile_handle(0);
+    int gamma_grad_tile_rank = gamma_grad_tile_handle.mpi_get_rank();
+    if(beta_grad_tile_handle.mpi_get_rank() != gamma_grad_tile_rank)
+    {
+        throw std::runtime_error("Tiles of gamma_grad and beta_grad are "
+                "owned by different nodes");
+    }
+    std::vector<Index> src_tile_index;
+    for(Index i = 0; i < src.grid.nelems; ++i)
+    {
+        const auto &src_grad_tile_handle = src_grad.get_tile_handle(i);
+        int src_grad_tile_rank = src_grad_tile_handle.mpi_get_rank();
+        // Gradients of gamma and beta are updated by the same task
+        if(src_grad_tile_rank != gamma_grad_tile_rank)
+        {
+            throw std::runtime_error("Tiles of src_grad and gamma_grad are "
+                    "owned by different nodes");
+        }
+        // Obtain index of the corresponding tile of statistics
+        src.grid.linear_to_index(i, src_tile_index);
+        std::vector<Index> mean_tile_index(ndim-1);
+        for(Index j = 0, k = 0; j < ndim; ++j)
+        {
+            if(j == axis)
+            {
+                continue;
+            }
+            mean_tile_index[k] = src_tile_index[j];
+            ++k;
+        }
+        Index mean_tile_offset = mean.grid.index_to_linear(mean_tile_index);
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_grad_tile_handle = dst_grad.get_tile_handle(i);
+        const auto &mean_tile_handle = mean.get_tile_handle(mean_tile_offset);
+        const auto &inv_stddev_tile_handle = inv_stddev.get_tile_handle(
+                mean_tile_offset);
+        // Transfer data
+        src_tile_handle.mpi_transfer(src_grad_tile_rank, mpi_rank);
+        dst_grad_tile_handle.mpi_transfer(src_grad_tile_rank, mpi_rank);
+        gamma_tile_handle.mpi_transfer(src_grad_tile_rank, mpi_rank);
+        mean_tile_handle.mpi_transfer(src_grad_tile_rank, mpi_rank);
+        inv_stddev_tile_handle.mpi_transfer(src_grad_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == src_grad_tile_rank)
+        {
+            // Get sizes
+            const auto &src_tile_traits = src.get_tile_traits(i);
+            Index m, n, k;
+            m = src_tile_traits.stride[axis];
+            n = src_tile_traits.matrix_shape[axis+1][1];
+            k = src_tile_traits.shape[axis];
+            // Insert task
+            starpu::layer_norm_backward::submit<T>(m, n, k, src_tile_handle,
+                    dst_grad_tile_handle, gamma_tile_handle,
+                    mean_tile_handle, inv_stddev_tile_handle,
+                    src_grad_tile_handle, gamma_grad_tile_handle,
+                    beta_grad_tile_handle, redux);
+        }
+        // Flush cache for the output tile on every node
+        src_grad_tile_handle.mpi_flush();
+    }
+    // Flush cache for the accumulated outputs on every node
+    gamma_grad_tile_handle.mpi_flush();
+    beta_grad_tile_handle.mpi_flush();
+}
+
+template<typename T>
+void layer_norm_backward(const Tensor<T> &src, const Tensor<T> &dst_grad,
+        const Tensor<T> &gamma, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &src_grad,
+        const Tensor<T> &gamma_grad, const Tensor<T> &beta_grad, Index axis,
+        int redux)
+{
+    layer_norm_backward_async<T>(src, dst_grad, gamma, mean, inv_stddev,
+            src_grad, gamma_grad, beta_grad, axis, redux);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void layer_norm_backward_async<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &dst_grad, const Tensor<fp32_t> &gamma,
+        const Tensor<fp32_t> &mean, const Tensor<fp32_t> &inv_stddev,
+        const Tensor<fp32_t> &src_grad, const Tensor<fp32_t> &gamma_grad,
+        const Tensor<fp32_t> &beta_grad, Index axis, int redux);
+
+template
+void layer_norm_backward_async<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &dst_grad, const Tensor<fp64_t> &gamma,
+        const Tensor<fp64_t> &mean, const Tensor<fp64_t> &inv_stddev,
+        const Tensor<fp64_t> &src_grad, const Tensor<fp64_t> &gamma_grad,
+        const Tensor<fp64_t> &beta_grad, Index axis, int redux);
+
+// Explicit instantiation
+template
+void layer_norm_backward<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &dst_grad, const Tensor<fp32_t> &gamma,
+        const Tensor<fp32_t> &mean, const Tensor<fp32_t> &inv_stddev,
+        const Tensor<fp32_t> &src_grad, const Tensor<fp32_t> &gamma_grad,
+        const Tensor<fp32_t> &beta_grad, Index axis, int redux);
+
+template
+void layer_norm_backward<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &dst_grad, const Tensor<fp64_t> &gamma,
+        const Tensor<fp64_t> &mean, const Tensor<fp64_t> &inv_stddev,
+        const Tensor<fp64_t> &src_grad, const Tensor<fp64_t> &gamma_grad,
+        const Tensor<fp64_t> &beta_grad, Index axis, int redux);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -61,11 +61,11 @@ void logsumexp_async(const Tensor<T> &src, const Tensor<T> &dst)
     for(Index i = 0; i < dst.grid.nelems; ++i)
     {
         // Clean up destination tile on dest node
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
-        auto dst_tile_traits = dst.get_tile_traits(i);
+        const auto &dst_tile_traits = dst.get_tile_traits(i);
 
-        auto src_tile_handle = src.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
         // Transfer data
         src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
         // Execute on destination node
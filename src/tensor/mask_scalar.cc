@@ -47,23 +47,24 @@ void mask_scalar_async(const Tensor<bool_t> &mask, T val, const Tensor<T> &A,
     }
     // Run the code
     int mpi_rank = starpu_mpi_world_rank();
+    std::vector<Index> A_tile_index;
     for(Index i = 0; i < A.grid.nelems; ++i)
     {
-        auto A_tile_handle = A.get_tile_handle(i);
-        auto A_tile_index = A.grid.linear_to_index(i);
+        const auto &A_tile_handle = A.get_tile_handle(i);
+        A.grid.linear_to_index(i, A_tile_index);
         int A_tile_rank = A_tile_handle.mpi_get_rank();
         std::vector<Index> mask_tile_index(mask.ndim);
         for(Index j = 0; j < mask.ndim; ++j)
         {
             mask_tile_index[j] = A_tile_index[j];
         }
-        auto mask_tile_handle = mask.get_tile_handle(mask_tile_index);
+        const auto &mask_tile_handle = mask.get_tile_handle(mask_tile_index);
         int mask_tile_rank = mask_tile_handle.mpi_get_rank();
         mask_tile_handle.mpi_transfer(A_tile_rank, mpi_rank);
         // Execute only on node-owner
         if(mpi_rank == A_tile_rank)
         {
-            auto tile_traits = A.get_tile_traits(i);
+            const auto &tile_traits = A.get_tile_traits(i);
             starpu::mask_scalar::submit<T>(
                     tile_traits.matrix_shape[A.ndim-batch_ndim][0], \
                     tile_traits.matrix_shape[A.ndim-batch_ndim][1], \
@@ -0,0 +1,126 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/mask_tiles.cc
+ * Classification of tiles of a boolean mask of attention
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/mask_tiles.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+std::vector<MaskTile> mask_tiles(const Tensor<bool_t> &mask)
+//! Get kinds of all tiles of a mask on every node
+/*! Flash attention operations skip pairs of tiles of keys and queries with
+ * an empty tile of mask and do not apply a full tile of mask at all, e.g.
+ * with a causal mask nearly a half of pairs is skipped. Causal tiles on the
+ * diagonal are generated by the fused flash attention and not read. All the nodes shall
+ * submit the same tasks, so every tile of mask is sent to every node and
+ * read on the host. Mask is small and usually it is set once, so reads do
+ * not wait for any task.
+ *
+ * @param[in] mask: Mask tensor
+ * */
+{
+    int mpi_rank = starpu_mpi_world_rank();
+    int mpi_size = starpu_mpi_world_size();
+    std::vector<MaskTile> kinds(mask.grid.nelems);
+    for(Index i = 0; i < mask.grid.nelems; ++i)
+    {
+        const auto &tile_handle = mask.get_tile_handle(i);
+        for(int rank = 0; rank < mpi_size; ++rank)
+        {
+            tile_handle.mpi_transfer(rank, mpi_rank);
+        }
+    }
+    std::vector<Index> tile_index;
+    for(Index i = 0; i < mask.grid.nelems; ++i)
+    {
+        auto tile = mask.get_tile(i);
+        auto tile_local = tile.acquire(STARPU_R);
+        Index nfalse = 0;
+        for(Index j = 0; j < tile.nelems; ++j)
+        {
+            if(!tile_local[j])
+            {
+                ++nfalse;
+            }
+        }
+        // Square tile on the diagonal may be causal
+        mask.grid.linear_to_index(i, tile_index);
+        bool causal = tile.shape[0] == tile.shape[1]
+            and tile_index[0]*mask.basetile_shape[0]
+            == tile_index[1]*mask.basetile_shape[1];
+        for(Index q = 0; q < tile.shape[1] and causal; ++q)
+        {
+            for(Index k = 0; k < tile.shape[0]; ++k)
+            {
+                if(bool(tile_local[q*tile.shape[0]+k]) != (k <= q))
+                {
+                    causal = false;
+                    break;
+                }
+            }
+        }
+        tile_local.release();
+        if(nfalse == tile.nelems)
+        {
+            kinds[i] = MaskTile::empty;
+        }
+        else if(nfalse == 0)
+        {
+            kinds[i] = MaskTile::full;
+        }
+        else if(causal)
+        {
+            kinds[i] = MaskTile::causal;
+        }
+        else
+        {
+            kinds[i] = MaskTile::partial;
+        }
+        mask.get_tile_handle(i).mpi_flush();
+    }
+    return kinds;
+}
+
+std::vector<MaskTile> mask_layout(const Tensor<bool_t> &mask,
+        const std::vector<MaskTile> &layout)
+//! Get a given block-sparse layout of a mask or kinds of its tiles
+/*! A layout is a kind of every tile of a mask in the order of tiles of the
+ * mask. Sliding-window, dilated or other block-sparse layouts are usually
+ * computed once for a given sequence length and reused by all the layers
+ * and steps, so that the mask is not read on every call. Empty tiles of
+ * the layout are skipped, even if the mask has some true entries there,
+ * and mask is not applied to full tiles. Causal tiles of the layout shall
+ * match the mask, as only the fused flash attention does not read them.
+ *
+ * @param[in] mask: Mask tensor
+ * @param[in] layout: Kinds of all tiles of the mask or an empty vector to
+ *      read the mask by mask_tiles()
+ * */
+{
+    if(layout.empty())
+    {
+        return mask_tiles(mask);
+    }
+    if(layout.size() != mask.grid.nelems)
+    {
+        throw std::runtime_error("layout.size() != mask.grid.nelems");
+    }
+    return layout;
+}
+
+} // namespace tensor
+} // namespace nntile
+
@@ -41,8 +41,8 @@ void maximum_async(const Tensor<T> &src, const Tensor<T> &dst)
     for(Index i = 0; i < src.grid.nelems; ++i)
     {
         // Get handle for corresponding tiles of src and dst
-        auto src_tile_handle = src.get_tile_handle(i);
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         // MPI rank of the destination tile
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Transfer data
@@ -50,7 +50,7 @@ void maximum_async(const Tensor<T> &src, const Tensor<T> &dst)
         // Execute only on destination node
         if(mpi_rank == dst_tile_rank)
         {
-            auto traits = src.get_tile_traits(i);
+            const auto &traits = src.get_tile_traits(i);
             starpu::maximum::submit<T>(traits.nelems, src_tile_handle,
                     dst_tile_handle);
         }
@@ -13,7 +13,11 @@
  * */
 
 #include "nntile/tensor/maxsumexp.hh"
+#include "nntile/tensor/tree_reduction.hh"
 #include "nntile/starpu/maxsumexp.hh"
+#include "nntile/starpu/accumulate_maxsumexp.hh"
+#include "nntile/starpu/clear.hh"
+#include <type_traits>
 
 namespace nntile
 {
@@ -81,13 +85,32 @@ void maxsumexp_async(const Tensor<T> &src, const Tensor<T> &dst, Index axis,
     int mpi_rank = starpu_mpi_world_rank();
     int ret;
     Index ndim = src.ndim;
+    // Tree reduction does not rely on STARPU_REDUX
+    redux = redux_mode(redux, std::is_same_v<T, compute_t<T>>);
+    bool use_tree = (redux == redux_tree);
+    TreeReduction::accumulate_t accumulate = nullptr;
+    if(use_tree)
+    {
+        redux = 0;
+        // There are no accumulation codelets for 16-bit types
+        if constexpr(not std::is_same_v<T, compute_t<T>>)
+        {
+            throw std::runtime_error("Tree reduction is not supported for "
+                    "bf16_t and fp16_t");
+        }
+        else
+        {
+            accumulate = starpu::accumulate_maxsumexp::submit<T>;
+        }
+    }
+    std::vector<Index> dst_tile_index;
     for(Index i = 0; i < dst.grid.nelems; ++i)
     {
         // Destination tile on dest node must be already prepared (cleared)
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Obtain indices of applicable source tiles
-        auto dst_tile_index = dst.grid.linear_to_index(i);
+        dst.grid.linear_to_index(i, dst_tile_index);
         std::vector<Index> src_tile_index(src.ndim);
         for(Index j = 0; j < axis; ++j)
         {
@@ -98,30 +121,68 @@ void maxsumexp_async(const Tensor<T> &src, const Tensor<T> &dst, Index axis,
         {
             src_tile_index[j] = dst_tile_index[j];
         }
+        const auto &dst_tile_traits = dst.get_tile_traits(i);
+        // Source tile, that is accumulated directly into the destination
+        // tile. Tree reduction prefers a tile, that is already on the
+        // destination node
+        Index j_first = 0;
+        if(use_tree)
+        {
+            for(Index j = 0; j < src.grid.shape[axis]; ++j)
+            {
+                src_tile_index[axis] = j;
+                if(src.get_tile_handle(src.grid.index_to_linear(
+                                src_tile_index)).mpi_get_rank()
+                        == dst_tile_rank)
+                {
+                    j_first = j;
+                    break;
+                }
+            }
+        }
+        TreeReduction tree(dst_tile_handle, sizeof(T)*dst_tile_traits.nelems,
+                accumulate);
         // Launch kernel for each appropriate source tile
-        auto dst_tile_traits = dst.get_tile_traits(i);
         for(Index j = 0; j < src.grid.shape[axis]; ++j)
         {
             src_tile_index[axis] = j;
             Index src_tile_offset = src.grid.index_to_linear(src_tile_index);
-            auto src_tile_handle = src.get_tile_handle(src_tile_offset);
+            const auto &src_tile_handle = src.get_tile_handle(src_tile_offset);
             int src_tile_rank = src_tile_handle.mpi_get_rank();
+            // Get sizes
+            const auto &src_tile_traits = src.get_tile_traits(src_tile_offset);
+            Index m, n, k;
+            m = src_tile_traits.stride[axis];
+            n = src_tile_traits.matrix_shape[axis+1][1];
+            k = src_tile_traits.shape[axis];
+            // Partial result of the tree reduction is computed on the node
+            // with the source tile
+            if(use_tree and j != j_first)
+            {
+                auto partial = tree.get_partial(src_tile_rank);
+                if(mpi_rank == src_tile_rank)
+                {
+                    starpu::clear::submit(partial);
+                    starpu::maxsumexp::submit<T>(m, n, k, src_tile_handle,
+                            partial, 0);
+                }
+                continue;
+            }
             // Transfer data
             src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
             // Execute on destination node
             if(mpi_rank == dst_tile_rank)
             {
-                // Get sizes
-                auto src_tile_traits = src.get_tile_traits(src_tile_offset);
-                Index m, n, k;
-                m = src_tile_traits.stride[axis];
-                n = src_tile_traits.matrix_shape[axis+1][1];
-                k = src_tile_traits.shape[axis];
                 // Insert task
                 starpu::maxsumexp::submit<T>(m, n, k, src_tile_handle,
                         dst_tile_handle, redux);
             }
         }
+        // Combine partial results of the tree reduction
+        if(use_tree)
+        {
+            tree.submit();
+        }
         // Flush cache for the output tile on every node
         dst_tile_handle.mpi_flush();
     }
@@ -146,6 +207,14 @@ template
 void maxsumexp_async<fp64_t>(const Tensor<fp64_t> &src,
         const Tensor<fp64_t> &dst, Index axis, int redux);
 
+template
+void maxsumexp_async<bf16_t>(const Tensor<bf16_t> &src,
+        const Tensor<bf16_t> &dst, Index axis, int redux);
+
+template
+void maxsumexp_async<fp16_t>(const Tensor<fp16_t> &src,
+        const Tensor<fp16_t> &dst, Index axis, int redux);
+
 // Explicit instantiation
 template
 void maxsumexp<fp32_t>(const Tensor<fp32_t> &src, const Tensor<fp32_t> &dst,
@@ -155,6 +224,14 @@ template
 void maxsumexp<fp64_t>(const Tensor<fp64_t> &src, const Tensor<fp64_t> &dst,
         Index axis, int redux);
 
+template
+void maxsumexp<bf16_t>(const Tensor<bf16_t> &src, const Tensor<bf16_t> &dst,
+        Index axis, int redux);
+
+template
+void maxsumexp<fp16_t>(const Tensor<fp16_t> &src, const Tensor<fp16_t> &dst,
+        Index axis, int redux);
+
 } // namespace tensor
 } // namespace nntile
 
@@ -0,0 +1,361 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/moe_combine.cc
+ * Weighted scatter of outputs of experts back to tokens
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/moe_combine.hh"
+#include "nntile/starpu/moe_combine.hh"
+#include "nntile/starpu/moe_dispatch.hh"
+#include "nntile/starpu/moe_combine_backward.hh"
+#include "nntile/starpu/clear.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Check that buffers of experts match tokens and slots
+template<typename T>
+static
+void moe_check(const Tensor<Index> &slots, const Tensor<T> &tokens,
+        const Tensor<T> &buf)
+{
+    // Check dimensions
+    if(slots.ndim != 2)
+    {
+        throw std::runtime_error("slots.ndim != 2");
+    }
+    if(tokens.ndim != 3)
+    {
+        throw std::runtime_error("tokens.ndim != 3");
+    }
+    if(buf.ndim != 3)
+    {
+        throw std::runtime_error("buf.ndim != 3");
+    }
+    // Check shapes
+    if(slots.grid.nelems != 1)
+    {
+        throw std::runtime_error("slots.grid.nelems != 1");
+    }
+    if(buf.shape[0] != tokens.shape[0])
+    {
+        throw std::runtime_error("buf.shape[0] != tokens.shape[0]");
+    }
+    if(buf.basetile_shape[0] != tokens.basetile_shape[0])
+    {
+        throw std::runtime_error("buf.basetile_shape[0] != "
+                "tokens.basetile_shape[0]");
+    }
+    if(buf.shape[1] != slots.shape[0])
+    {
+        throw std::runtime_error("buf.shape[1] != slots.shape[0]");
+    }
+    if(buf.basetile_shape[1] != buf.shape[1])
+    {
+        throw std::runtime_error("buf.basetile_shape[1] != buf.shape[1]");
+    }
+    if(buf.shape[2] != slots.shape[1])
+    {
+        throw std::runtime_error("buf.shape[2] != slots.shape[1]");
+    }
+    if(buf.basetile_shape[2] != 1)
+    {
+        throw std::runtime_error("buf.basetile_shape[2] != 1");
+    }
+}
+
+// Check that routing probabilities match tokens
+template<typename T>
+static
+void moe_check_probs(const Tensor<T> &probs, const Tensor<T> &tokens,
+        const Tensor<T> &buf)
+{
+    if(probs.ndim != 3)
+    {
+        throw std::runtime_error("probs.ndim != 3");
+    }
+    if(probs.shape[0] != buf.shape[2])
+    {
+        throw std::runtime_error("probs.shape[0] != buf.shape[2]");
+    }
+    if(probs.basetile_shape[0] != probs.shape[0])
+    {
+        throw std::runtime_error("probs.basetile_shape[0] != "
+                "probs.shape[0]");
+    }
+    for(Index i = 1; i < 3; ++i)
+    {
+        if(probs.shape[i] != tokens.shape[i])
+        {
+            throw std::runtime_error("probs.shape[i] != tokens.shape[i]");
+        }
+        if(probs.basetile_shape[i] != tokens.basetile_shape[i])
+        {
+            throw std::runtime_error("probs.basetile_shape[i] != "
+                    "tokens.basetile_shape[i]");
+        }
+    }
+}
+
+//! Asynchronous weighted scatter of outputs of experts back to tokens
+/*! Output of slot c of expert e, multiplied by the routing probability
+ * probs[e, t] of the token t = slots[c, e], is accumulated into y[:, t].
+ * Tasks are executed by owners of tiles of y.
+ *
+ * @param[in] slots: Single-tile tensor of shape [capacity, n_experts] of
+ *      indices of tokens, produced by moe_route_async
+ * @param[in] probs: Routing probabilities of shape [n_experts, seq, batch]
+ *      with all the experts in a single tile
+ * @param[in] buf: Outputs of experts of shape [embed, capacity, n_experts]
+ *      with a single expert per tile
+ * @param[inout] y: Tokens of shape [embed, seq, batch], that accumulate
+ *      outputs of experts
+ * */
+template<typename T>
+void moe_combine_async(const Tensor<Index> &slots, const Tensor<T> &probs,
+        const Tensor<T> &buf, const Tensor<T> &y)
+{
+    moe_check<T>(slots, y, buf);
+    moe_check_probs<T>(probs, y, buf);
+    int mpi_rank = starpu_mpi_world_rank();
+    auto slots_tile_handle = slots.get_tile_handle(0);
+    Index capacity = slots.shape[0], n_experts = slots.shape[1];
+    std::vector<Index> y_tile_index;
+    for(Index i = 0; i < y.grid.nelems; ++i)
+    {
+        y.grid.linear_to_index(i, y_tile_index);
+        auto y_tile_handle = y.get_tile_handle(i);
+        const auto &y_tile_traits = y.get_tile_traits(i);
+        int y_tile_rank = y_tile_handle.mpi_get_rank();
+        std::vector<Index> probs_tile_index{0, y_tile_index[1],
+            y_tile_index[2]};
+        auto probs_tile_handle = probs.get_tile_handle(probs_tile_index);
+        // Transfer slots and probabilities
+        slots_tile_handle.mpi_transfer(y_tile_rank, mpi_rank);
+        probs_tile_handle.mpi_transfer(y_tile_rank, mpi_rank);
+        // Accumulate outputs of all the experts
+        std::vector<Index> buf_tile_index{y_tile_index[0], 0, 0};
+        for(Index e = 0; e < n_experts; ++e)
+        {
+            buf_tile_index[2] = e;
+            auto buf_tile_handle = buf.get_tile_handle(buf_tile_index);
+            // Transfer data
+            buf_tile_handle.mpi_transfer(y_tile_rank, mpi_rank);
+            // Execute on destination node
+            if(mpi_rank == y_tile_rank)
+            {
+                starpu::moe_combine::submit<T>(y_tile_traits.shape[0],
+                        y.shape[1], y_tile_index[1]*y.basetile_shape[1],
+                        y_tile_traits.shape[1],
+                        y_tile_index[2]*y.basetile_shape[2],
+                        y_tile_traits.shape[2], capacity, n_experts, e,
+                        slots_tile_handle, probs_tile_handle,
+                        buf_tile_handle, y_tile_handle);
+            }
+        }
+        // Flush cache for the output tile on every node
+        y_tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking version of weighted scatter of outputs of experts back to tokens
+/*! @param[in] slots: Indices of tokens in slots of experts
+ * @param[in] probs: Routing probabilities of shape [n_experts, seq, batch]
+ * @param[in] buf: Outputs of experts of shape [embed, capacity, n_experts]
+ * @param[inout] y: Tokens, that accumulate outputs of experts
+ * */
+template<typename T>
+void moe_combine(const Tensor<Index> &slots, const Tensor<T> &probs,
+        const Tensor<T> &buf, const Tensor<T> &y)
+{
+    moe_combine_async<T>(slots, probs, buf, y);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+//! Asynchronous backward of weighted scatter of outputs of experts
+/*! Gradient over the output of a slot is the gradient over its token,
+ * multiplied by the routing probability, while gradient over the routing
+ * probability is the dot product of the gradient over the token and the
+ * output of the slot. Buffers of gradients are overwritten, gradients over
+ * probabilities are accumulated.
+ *
+ * @param[in] slots: Indices of tokens in slots of experts
+ * @param[in] probs: Routing probabilities of shape [n_experts, seq, batch]
+ * @param[in] buf: Outputs of experts of shape [embed, capacity, n_experts]
+ * @param[in] dy: Gradient over tokens of shape [embed, seq, batch]
+ * @param[out] dbuf: Gradient over outputs of experts
+ * @param[inout] dprobs: Gradient over routing probabilities
+ * */
+template<typename T>
+void moe_combine_backward_async(const Tensor<Index> &slots,
+        const Tensor<T> &probs, const Tensor<T> &buf, const Tensor<T> &dy,
+        const Tensor<T> &dbuf, const Tensor<T> &dprobs)
+{
+    moe_check<T>(slots, dy, buf);
+    moe_check<T>(slots, dy, dbuf);
+    moe_check_probs<T>(probs, dy, buf);
+    moe_check_probs<T>(dprobs, dy, buf);
+    int mpi_rank = starpu_mpi_world_rank();
+    auto slots_tile_handle = slots.get_tile_handle(0);
+    Index capacity = slots.shape[0], n_experts = slots.shape[1];
+    // Gradient over outputs of experts on owners of buffers
+    std::vector<Index> dbuf_tile_index;
+    for(Index i = 0; i < dbuf.grid.nelems; ++i)
+    {
+        dbuf.grid.linear_to_index(i, dbuf_tile_index);
+        auto dbuf_tile_handle = dbuf.get_tile_handle(i);
+        const auto &dbuf_tile_traits = dbuf.get_tile_traits(i);
+        int dbuf_tile_rank = dbuf_tile_handle.mpi_get_rank();
+        if(mpi_rank == dbuf_tile_rank)
+        {
+            starpu::clear::submit(dbuf_tile_handle);
+        }
+        slots_tile_handle.mpi_transfer(dbuf_tile_rank, mpi_rank);
+        std::vector<Index> dy_tile_index{dbuf_tile_index[0], 0, 0};
+        for(Index b = 0; b < dy.grid.shape[2]; ++b)
+        {
+            dy_tile_index[2] = b;
+            for(Index s = 0; s < dy.grid.shape[1]; ++s)
+            {
+                dy_tile_index[1] = s;
+                auto dy_tile_handle = dy.get_tile_handle(dy_tile_index);
+                const auto &dy_tile_traits = dy.get_tile_traits(dy_tile_index);
+                std::vector<Index> probs_tile_index{0, s, b};
+                auto probs_tile_handle = probs.get_tile_handle(
+                        probs_tile_index);
+                // Transfer data
+                dy_tile_handle.mpi_transfer(dbuf_tile_rank, mpi_rank);
+                probs_tile_handle.mpi_transfer(dbuf_tile_rank, mpi_rank);
+                // Execute on destination node
+                if(mpi_rank == dbuf_tile_rank)
+                {
+                    starpu::moe_dispatch::submit<T>(
+                            dbuf_tile_traits.shape[0], dy.shape[1],
+                            s*dy.basetile_shape[1], dy_tile_traits.shape[1],
+                            b*dy.basetile_shape[2], dy_tile_traits.shape[2],
+                            capacity, n_experts, dbuf_tile_index[2],
+                            slots_tile_handle, probs_tile_handle,
+                            dy_tile_handle, dbuf_tile_handle);
+                }
+            }
+        }
+        dbuf_tile_handle.mpi_flush();
+    }
+    // Gradient over probabilities on owners of tiles of probabilities
+    std::vector<Index> dprobs_tile_index;
+    for(Index i = 0; i < dprobs.grid.nelems; ++i)
+    {
+        dprobs.grid.linear_to_index(i, dprobs_tile_index);
+        auto dprobs_tile_handle = dprobs.get_tile_handle(i);
+        int dprobs_tile_rank = dprobs_tile_handle.mpi_get_rank();
+        slots_tile_handle.mpi_transfer(dprobs_tile_rank, mpi_rank);
+        std::vector<Index> dy_tile_index{0, dprobs_tile_index[1],
+            dprobs_tile_index[2]};
+        for(Index j = 0; j < dy.grid.shape[0]; ++j)
+        {
+            dy_tile_index[0] = j;
+            auto dy_tile_handle = dy.get_tile_handle(dy_tile_index);
+            const auto &dy_tile_traits = dy.get_tile_traits(dy_tile_index);
+            dy_tile_handle.mpi_transfer(dprobs_tile_rank, mpi_rank);
+            std::vector<Index> buf_tile_index{j, 0, 0};
+            for(Index e = 0; e < n_experts; ++e)
+            {
+                buf_tile_index[2] = e;
+                auto buf_tile_handle = buf.get_tile_handle(buf_tile_index);
+                // Transfer data
+                buf_tile_handle.mpi_transfer(dprobs_tile_rank, mpi_rank);
+                // Execute on destination node
+                if(mpi_rank == dprobs_tile_rank)
+                {
+                    starpu::moe_combine_backward::submit<T>(
+                            dy_tile_traits.shape[0], dy.shape[1],
+                            dy_tile_index[1]*dy.basetile_shape[1],
+                            dy_tile_traits.shape[1],
+                            dy_tile_index[2]*dy.basetile_shape[2],
+                            dy_tile_traits.shape[2], capacity, n_experts, e,
+                            slots_tile_handle, dy_tile_handle,
+                            buf_tile_handle, dprobs_tile_handle);
+                }
+            }
+        }
+        dprobs_tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking version of backward of weighted scatter of outputs of experts
+/*! @param[in] slots: Indices of tokens in slots of experts
+ * @param[in] probs: Routing probabilities of shape [n_experts, seq, batch]
+ * @param[in] buf: Outputs of experts of shape [embed, capacity, n_experts]
+ * @param[in] dy: Gradient over tokens of shape [embed, seq, batch]
+ * @param[out] dbuf: Gradient over outputs of experts
+ * @param[inout] dprobs: Gradient over routing probabilities
+ * */
+template<typename T>
+void moe_combine_backward(const Tensor<Index> &slots, const Tensor<T> &probs,
+        const Tensor<T> &buf, const Tensor<T> &dy, const Tensor<T> &dbuf,
+        const Tensor<T> &dprobs)
+{
+    moe_combine_backward_async<T>(slots, probs, buf, dy, dbuf, dprobs);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void moe_combine_async<fp32_t>(const Tensor<Index> &slots,
+        const Tensor<fp32_t> &probs, const Tensor<fp32_t> &buf,
+        const Tensor<fp32_t> &y);
+
+template
+void moe_combine_async<fp64_t>(const Tensor<Index> &slots,
+        const Tensor<fp64_t> &probs, const Tensor<fp64_t> &buf,
+        const Tensor<fp64_t> &y);
+
+template
+void moe_combine<fp32_t>(const Tensor<Index> &slots,
+        const Tensor<fp32_t> &probs, const Tensor<fp32_t> &buf,
+        const Tensor<fp32_t> &y);
+
+template
+void moe_combine<fp64_t>(const Tensor<Index> &slots,
+        const Tensor<fp64_t> &probs, const Tensor<fp64_t> &buf,
+        const Tensor<fp64_t> &y);
+
+template
+void moe_combine_backward_async<fp32_t>(const Tensor<Index> &slots,
+        const Tensor<fp32_t> &probs, const Tensor<fp32_t> &buf,
+        const Tensor<fp32_t> &dy, const Tensor<fp32_t> &dbuf,
+        const Tensor<fp32_t> &dprobs);
+
+template
+void moe_combine_backward_async<fp64_t>(const Tensor<Index> &slots,
+        const Tensor<fp64_t> &probs, const Tensor<fp64_t> &buf,
+        const Tensor<fp64_t> &dy, const Tensor<fp64_t> &dbuf,
+        const Tensor<fp64_t> &dprobs);
+
+template
+void moe_combine_backward<fp32_t>(const Tensor<Index> &slots,
+        const Tensor<fp32_t> &probs, const Tensor<fp32_t> &buf,
+        const Tensor<fp32_t> &dy, const Tensor<fp32_t> &dbuf,
+        const Tensor<fp32_t> &dprobs);
+
+template
+void moe_combine_backward<fp64_t>(const Tensor<Index> &slots,
+        const Tensor<fp64_t> &probs, const Tensor<fp64_t> &buf,
+        const Tensor<fp64_t> &dy, const Tensor<fp64_t> &dbuf,
+        const Tensor<fp64_t> &dprobs);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,253 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/moe_dispatch.cc
+ * Gather of tokens into buffers of experts
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/moe_dispatch.hh"
+#include "nntile/starpu/moe_dispatch.hh"
+#include "nntile/starpu/moe_combine.hh"
+#include "nntile/starpu/clear.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Check that buffers of experts match tokens and slots
+template<typename T>
+static
+void moe_check(const Tensor<Index> &slots, const Tensor<T> &tokens,
+        const Tensor<T> &buf)
+{
+    // Check dimensions
+    if(slots.ndim != 2)
+    {
+        throw std::runtime_error("slots.ndim != 2");
+    }
+    if(tokens.ndim != 3)
+    {
+        throw std::runtime_error("tokens.ndim != 3");
+    }
+    if(buf.ndim != 3)
+    {
+        throw std::runtime_error("buf.ndim != 3");
+    }
+    // Check shapes
+    if(slots.grid.nelems != 1)
+    {
+        throw std::runtime_error("slots.grid.nelems != 1");
+    }
+    if(buf.shape[0] != tokens.shape[0])
+    {
+        throw std::runtime_error("buf.shape[0] != tokens.shape[0]");
+    }
+    if(buf.basetile_shape[0] != tokens.basetile_shape[0])
+    {
+        throw std::runtime_error("buf.basetile_shape[0] != "
+                "tokens.basetile_shape[0]");
+    }
+    if(buf.shape[1] != slots.shape[0])
+    {
+        throw std::runtime_error("buf.shape[1] != slots.shape[0]");
+    }
+    if(buf.basetile_shape[1] != buf.shape[1])
+    {
+        throw std::runtime_error("buf.basetile_shape[1] != buf.shape[1]");
+    }
+    if(buf.shape[2] != slots.shape[1])
+    {
+        throw std::runtime_error("buf.shape[2] != slots.shape[1]");
+    }
+    if(buf.basetile_shape[2] != 1)
+    {
+        throw std::runtime_error("buf.basetile_shape[2] != 1");
+    }
+}
+
+//! Asynchronous gather of tokens into buffers of experts
+/*! Slot c of expert e gets a copy of the token slots[c, e], empty slots are
+ * zero. Tokens are tiled along the embedding and both sequence axes, while
+ * buffers of experts are tiled along the embedding and the expert axes. A
+ * buffer tile is owned by the node of its expert and collects tokens from
+ * all tiles of tokens with the same embedding block.
+ *
+ * @param[in] slots: Single-tile tensor of shape [capacity, n_experts] of
+ *      indices of tokens, produced by moe_route_async
+ * @param[in] x: Tokens of shape [embed, seq, batch]
+ * @param[out] buf: Buffers of experts of shape [embed, capacity, n_experts]
+ *      with a single expert per tile
+ * */
+template<typename T>
+void moe_dispatch_async(const Tensor<Index> &slots, const Tensor<T> &x,
+        const Tensor<T> &buf)
+{
+    moe_check<T>(slots, x, buf);
+    int mpi_rank = starpu_mpi_world_rank();
+    auto slots_tile_handle = slots.get_tile_handle(0);
+    Index capacity = slots.shape[0], n_experts = slots.shape[1];
+    std::vector<Index> buf_tile_index;
+    for(Index i = 0; i < buf.grid.nelems; ++i)
+    {
+        buf.grid.linear_to_index(i, buf_tile_index);
+        auto buf_tile_handle = buf.get_tile_handle(i);
+        const auto &buf_tile_traits = buf.get_tile_traits(i);
+        int buf_tile_rank = buf_tile_handle.mpi_get_rank();
+        // Empty slots and slots of dropped tokens are zero
+        if(mpi_rank == buf_tile_rank)
+        {
+            starpu::clear::submit(buf_tile_handle);
+        }
+        // Transfer slots
+        slots_tile_handle.mpi_transfer(buf_tile_rank, mpi_rank);
+        // Gather all the tiles of tokens with the same embedding block
+        std::vector<Index> x_tile_index{buf_tile_index[0], 0, 0};
+        for(Index b = 0; b < x.grid.shape[2]; ++b)
+        {
+            x_tile_index[2] = b;
+            for(Index s = 0; s < x.grid.shape[1]; ++s)
+            {
+                x_tile_index[1] = s;
+                auto x_tile_handle = x.get_tile_handle(x_tile_index);
+                const auto &x_tile_traits = x.get_tile_traits(x_tile_index);
+                // Transfer data
+                x_tile_handle.mpi_transfer(buf_tile_rank, mpi_rank);
+                // Execute on destination node
+                if(mpi_rank == buf_tile_rank)
+                {
+                    starpu::moe_dispatch::submit<T>(buf_tile_traits.shape[0],
+                            x.shape[1], s*x.basetile_shape[1],
+                            x_tile_traits.shape[1], b*x.basetile_shape[2],
+                            x_tile_traits.shape[2], capacity, n_experts,
+                            buf_tile_index[2], slots_tile_handle,
+                            starpu::HandleRef(), x_tile_handle,
+                            buf_tile_handle);
+                }
+            }
+        }
+        // Flush cache for the output tile on every node
+        buf_tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking version of gather of tokens into buffers of experts
+/*! @param[in] slots: Indices of tokens in slots of experts
+ * @param[in] x: Tokens of shape [embed, seq, batch]
+ * @param[out] buf: Buffers of experts of shape [embed, capacity, n_experts]
+ * */
+template<typename T>
+void moe_dispatch(const Tensor<Index> &slots, const Tensor<T> &x,
+        const Tensor<T> &buf)
+{
+    moe_dispatch_async<T>(slots, x, buf);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+//! Asynchronous backward of gather of tokens into buffers of experts
+/*! Gradients of slots are accumulated into gradients of their tokens.
+ *
+ * @param[in] slots: Indices of tokens in slots of experts
+ * @param[in] dbuf: Gradient over buffers of experts
+ * @param[inout] dx: Gradient over tokens, that is accumulated
+ * */
+template<typename T>
+void moe_dispatch_backward_async(const Tensor<Index> &slots,
+        const Tensor<T> &dbuf, const Tensor<T> &dx)
+{
+    moe_check<T>(slots, dx, dbuf);
+    int mpi_rank = starpu_mpi_world_rank();
+    auto slots_tile_handle = slots.get_tile_handle(0);
+    Index capacity = slots.shape[0], n_experts = slots.shape[1];
+    std::vector<Index> dx_tile_index;
+    for(Index i = 0; i < dx.grid.nelems; ++i)
+    {
+        dx.grid.linear_to_index(i, dx_tile_index);
+        auto dx_tile_handle = dx.get_tile_handle(i);
+        const auto &dx_tile_traits = dx.get_tile_traits(i);
+        int dx_tile_rank = dx_tile_handle.mpi_get_rank();
+        // Transfer slots
+        slots_tile_handle.mpi_transfer(dx_tile_rank, mpi_rank);
+        // Accumulate gradients of all the experts
+        std::vector<Index> dbuf_tile_index{dx_tile_index[0], 0, 0};
+        for(Index e = 0; e < n_experts; ++e)
+        {
+            dbuf_tile_index[2] = e;
+            auto dbuf_tile_handle = dbuf.get_tile_handle(dbuf_tile_index);
+            // Transfer data
+            dbuf_tile_handle.mpi_transfer(dx_tile_rank, mpi_rank);
+            // Execute on destination node
+            if(mpi_rank == dx_tile_rank)
+            {
+                starpu::moe_combine::submit<T>(dx_tile_traits.shape[0],
+                        dx.shape[1], dx_tile_index[1]*dx.basetile_shape[1],
+                        dx_tile_traits.shape[1],
+                        dx_tile_index[2]*dx.basetile_shape[2],
+                        dx_tile_traits.shape[2], capacity, n_experts, e,
+                        slots_tile_handle, starpu::HandleRef(),
+                        dbuf_tile_handle, dx_tile_handle);
+            }
+        }
+        // Flush cache for the output tile on every node
+        dx_tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking version of backward of gather of tokens into buffers of experts
+/*! @param[in] slots: Indices of tokens in slots of experts
+ * @param[in] dbuf: Gradient over buffers of experts
+ * @param[inout] dx: Gradient over tokens, that is accumulated
+ * */
+template<typename T>
+void moe_dispatch_backward(const Tensor<Index> &slots, const Tensor<T> &dbuf,
+        const Tensor<T> &dx)
+{
+    moe_dispatch_backward_async<T>(slots, dbuf, dx);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void moe_dispatch_async<fp32_t>(const Tensor<Index> &slots,
+        const Tensor<fp32_t> &x, const Tensor<fp32_t> &buf);
+
+template
+void moe_dispatch_async<fp64_t>(const Tensor<Index> &slots,
+        const Tensor<fp64_t> &x, const Tensor<fp64_t> &buf);
+
+template
+void moe_dispatch<fp32_t>(const Tensor<Index> &slots,
+        const Tensor<fp32_t> &x, const Tensor<fp32_t> &buf);
+
+template
+void moe_dispatch<fp64_t>(const Tensor<Index> &slots,
+        const Tensor<fp64_t> &x, const Tensor<fp64_t> &buf);
+
+template
+void moe_dispatch_backward_async<fp32_t>(const Tensor<Index> &slots,
+        const Tensor<fp32_t> &dbuf, const Tensor<fp32_t> &dx);
+
+template
+void moe_dispatch_backward_async<fp64_t>(const Tensor<Index> &slots,
+        const Tensor<fp64_t> &dbuf, const Tensor<fp64_t> &dx);
+
+template
+void moe_dispatch_backward<fp32_t>(const Tensor<Index> &slots,
+        const Tensor<fp32_t> &dbuf, const Tensor<fp32_t> &dx);
+
+template
+void moe_dispatch_backward<fp64_t>(const Tensor<Index> &slots,
+        const Tensor<fp64_t> &dbuf, const Tensor<fp64_t> &dx);
+
+} // namespace tensor
+} // namespace nntile
+
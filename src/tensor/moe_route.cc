@@ -0,0 +1,136 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/moe_route.cc
+ * Routing of tokens to slots of experts
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/moe_route.hh"
+#include "nntile/starpu/moe_route.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous routing of tokens to slots of experts
+/*! Every token is assigned to its k chosen experts in order of priority of
+ * choices: the first choices of all the tokens take free slots of experts
+ * before the second choices and so on. A token, that finds no free slot in
+ * an expert, is dropped by the expert.
+ *
+ * @param[in] experts: Single-tile tensor of shape [k, ...] of indices of
+ *      chosen experts of all the tokens in order of priority
+ * @param[out] slots: Single-tile tensor of shape [capacity, n_experts] of
+ *      indices of tokens or -1 for empty slots
+ * @param[out] load: Single-tile tensor of shape [n_experts] with fractions of
+ *      routed choices of tokens, that are taken by experts
+ * */
+template<typename T>
+void moe_route_async(const Tensor<Index> &experts, const Tensor<Index> &slots,
+        const Tensor<T> &load)
+{
+    // Check dimensions
+    if(experts.ndim < 1)
+    {
+        throw std::runtime_error("experts.ndim < 1");
+    }
+    if(slots.ndim != 2)
+    {
+        throw std::runtime_error("slots.ndim != 2");
+    }
+    if(load.ndim != 1)
+    {
+        throw std::runtime_error("load.ndim != 1");
+    }
+    // Check shapes
+    if(load.shape[0] != slots.shape[1])
+    {
+        throw std::runtime_error("load.shape[0] != slots.shape[1]");
+    }
+    // Routing is done over all the tokens at once
+    if(experts.grid.nelems != 1)
+    {
+        throw std::runtime_error("experts.grid.nelems != 1");
+    }
+    if(slots.grid.nelems != 1)
+    {
+        throw std::runtime_error("slots.grid.nelems != 1");
+    }
+    if(load.grid.nelems != 1)
+    {
+        throw std::runtime_error("load.grid.nelems != 1");
+    }
+    // Do nothing for empty tensors
+    if(experts.nelems == 0)
+    {
+        return;
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    auto experts_tile_handle = experts.get_tile_handle(0);
+    auto slots_tile_handle = slots.get_tile_handle(0);
+    auto load_tile_handle = load.get_tile_handle(0);
+    int dst_tile_rank = slots_tile_handle.mpi_get_rank();
+    // Slots and load are produced by the same task
+    if(load_tile_handle.mpi_get_rank() != dst_tile_rank)
+    {
+        throw std::runtime_error("Tiles of slots and load are owned by "
+                "different nodes");
+    }
+    // Transfer data
+    experts_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+    // Execute on destination node
+    if(mpi_rank == dst_tile_rank)
+    {
+        Index k = experts.shape[0];
+        Index n_tokens = experts.nelems / k;
+        starpu::moe_route::submit<T>(k, n_tokens, slots.shape[1],
+                slots.shape[0], experts_tile_handle, slots_tile_handle,
+                load_tile_handle);
+    }
+    // Flush cache for the output tiles on every node
+    slots_tile_handle.mpi_flush();
+    load_tile_handle.mpi_flush();
+}
+
+//! Blocking version of routing of tokens to slots of experts
+/*! @param[in] experts: Indices of chosen experts of all the tokens
+ * @param[out] slots: Indices of tokens in slots of experts
+ * @param[out] load: Fractions of routed choices, taken by experts
+ * */
+template<typename T>
+void moe_route(const Tensor<Index> &experts, const Tensor<Index> &slots,
+        const Tensor<T> &load)
+{
+    moe_route_async<T>(experts, slots, load);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void moe_route_async<fp32_t>(const Tensor<Index> &experts,
+        const Tensor<Index> &slots, const Tensor<fp32_t> &load);
+
+template
+void moe_route_async<fp64_t>(const Tensor<Index> &experts,
+        const Tensor<Index> &slots, const Tensor<fp64_t> &load);
+
+template
+void moe_route<fp32_t>(const Tensor<Index> &experts,
+        const Tensor<Index> &slots, const Tensor<fp32_t> &load);
+
+template
+void moe_route<fp64_t>(const Tensor<Index> &experts,
+        const Tensor<Index> &slots, const Tensor<fp64_t> &load);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,306 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/multi_adam_step.cc
+ * Fused Adam and AdamW steps for many Tensor<T> at once
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-02
+ * */
+
+#include "nntile/tensor/multi_adam_step.hh"
+#include "nntile/starpu/multi_adam_step.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Fused Adam or AdamW step for many tensors with optional learning rate and
+// scale of gradients in a tensor
+template<typename T>
+static void multi_adam_step_submit(Index num_iter, T beta_1, T beta_2, T eps,
+        T lr, T weight_decay, bool decoupled,
+        const std::vector<Tensor<T>> &grad,
+        const std::vector<Tensor<T>> &first_moment,
+        const std::vector<Tensor<T>> &second_moment,
+        const std::vector<Tensor<T>> &p, const Tensor<T> *scalars,
+        Index max_nelems)
+{
+    Index ntensors = p.size();
+    if(grad.size() != ntensors)
+    {
+        throw std::runtime_error("grad.size() != p.size()");
+    }
+    if(first_moment.size() != ntensors)
+    {
+        throw std::runtime_error("first_moment.size() != p.size()");
+    }
+    if(second_moment.size() != ntensors)
+    {
+        throw std::runtime_error("second_moment.size() != p.size()");
+    }
+    if(max_nelems <= 0)
+    {
+        throw std::runtime_error("max_nelems <= 0");
+    }
+    for(Index j = 0; j < ntensors; ++j)
+    {
+        if(p[j].matrix_shape != grad[j].matrix_shape)
+        {
+            throw std::runtime_error("Parameter shape is not equal to "
+                    "gradient shape");
+        }
+        if(p[j].matrix_shape != first_moment[j].matrix_shape)
+        {
+            throw std::runtime_error("Parameter shape is not equal to "
+                    "first_moment shape");
+        }
+        if(p[j].matrix_shape != second_moment[j].matrix_shape)
+        {
+            throw std::runtime_error("Parameter shape is not equal to "
+                    "second_moment shape");
+        }
+    }
+    starpu::Handle scalars_tile_handle;
+    if(scalars != nullptr)
+    {
+        if(scalars->ndim != 1 or scalars->shape[0] != 2
+                or scalars->basetile_shape[0] != 2)
+        {
+            throw std::runtime_error("scalars shall be a single tile of "
+                    "shape [2]");
+        }
+        scalars_tile_handle = scalars->get_tile_handle(0);
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    // Tiles of the current group
+    std::vector<starpu::Handle> group_grad, group_first_moment,
+        group_second_moment, group_p;
+    Index group_nelems = 0;
+    auto submit_group = [&]()
+    {
+        starpu::multi_adam_step::submit<T>(num_iter, beta_1, beta_2, eps, lr,
+                weight_decay, decoupled, group_grad, group_first_moment,
+                group_second_moment, group_p, scalars_tile_handle);
+        group_grad.clear();
+        group_first_moment.clear();
+        group_second_moment.clear();
+        group_p.clear();
+        group_nelems = 0;
+    };
+    for(Index j = 0; j < ntensors; ++j)
+    {
+        for(Index i = 0; i < p[j].grid.nelems; ++i)
+        {
+            // Get handle for corresponding tiles
+            const auto &p_tile_handle = p[j].get_tile_handle(i);
+            const auto &grad_tile_handle = grad[j].get_tile_handle(i);
+            const auto &first_moment_tile_handle =
+                    first_moment[j].get_tile_handle(i);
+            auto second_moment_tile_handle =
+                second_moment[j].get_tile_handle(i);
+            // MPI rank of the destination tile
+            int p_tile_rank = p_tile_handle.mpi_get_rank();
+            // Transfer data
+            grad_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+            first_moment_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+            second_moment_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+            if(scalars != nullptr)
+            {
+                scalars_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+            }
+            // Execute only on destination node
+            if(mpi_rank == p_tile_rank)
+            {
+                Index tile_nelems = p[j].get_tile_traits(i).nelems;
+                if(group_nelems > 0 and group_nelems+tile_nelems > max_nelems)
+                {
+                    submit_group();
+                }
+                group_grad.push_back(grad_tile_handle);
+                group_first_moment.push_back(first_moment_tile_handle);
+                group_second_moment.push_back(second_moment_tile_handle);
+                group_p.push_back(p_tile_handle);
+                group_nelems += tile_nelems;
+            }
+        }
+    }
+    if(group_nelems > 0)
+    {
+        submit_group();
+    }
+    // Flush cache for the output tiles on every node
+    for(Index j = 0; j < ntensors; ++j)
+    {
+        for(Index i = 0; i < p[j].grid.nelems; ++i)
+        {
+            p[j].get_tile_handle(i).mpi_flush();
+        }
+    }
+}
+
+//! Asynchronous fused Adam or AdamW step for many tensors
+/*! Local tiles of all the parameters are grouped into StarPU tasks, so that
+ * every task updates tiles with no more than max_nelems elements in total. A
+ * tile, that is larger than max_nelems, is updated by a separate task. Such a
+ * grouping reduces the number of tasks and CUDA kernel launches for models
+ * with many small parameters.
+ *
+ * @param[in] num_iter: current iteration number
+ * @param[in] beta_1: parameter for moving average of first moments
+ * @param[in] beta_2: parameter for moving average of second moments
+ * @param[in] eps: small scalar to avoid division by zero
+ * @param[in] lr: learning rate
+ * @param[in] weight_decay: coefficient for l2 regularizer
+ * @param[in] decoupled: AdamW (true) or Adam (false) weight decay
+ * @param[in] grad: Gradients of parameters
+ * @param[inout] first_moment: First moments of parameters
+ * @param[inout] second_moment: Square roots of second moments of parameters
+ * @param[inout] p: Parameters
+ * @param[in] max_nelems: Maximal number of elements updated by a single task
+ * */
+template<typename T>
+void multi_adam_step_async(Index num_iter, T beta_1, T beta_2, T eps, T lr,
+        T weight_decay, bool decoupled, const std::vector<Tensor<T>> &grad,
+        const std::vector<Tensor<T>> &first_moment,
+        const std::vector<Tensor<T>> &second_moment,
+        const std::vector<Tensor<T>> &p, Index max_nelems)
+{
+    multi_adam_step_submit<T>(num_iter, beta_1, beta_2, eps, lr, weight_decay,
+            decoupled, grad, first_moment, second_moment, p, nullptr,
+            max_nelems);
+}
+
+//! Asynchronous fused Adam or AdamW step with scalars in a tensor
+/*! The same as multi_adam_step_async(), but the learning rate is read from
+ * scalars[0] and gradients are multiplied by scalars[1] before weight decay
+ * by tasks. Such scalars are computed on the device by clip_scale_async()
+ * from a global norm of gradients, so gradient clipping and a schedule of
+ * the learning rate need no synchronization with the host.
+ *
+ * @param[in] scalars: Single-tile tensor of shape [2] with the learning rate
+ *      and scale of gradients
+ * */
+template<typename T>
+void multi_adam_step_scaled_async(Index num_iter, T beta_1, T beta_2, T eps,
+        T weight_decay, bool decoupled, const std::vector<Tensor<T>> &grad,
+        const std::vector<Tensor<T>> &first_moment,
+        const std::vector<Tensor<T>> &second_moment,
+        const std::vector<Tensor<T>> &p, const Tensor<T> &scalars,
+        Index max_nelems)
+{
+    multi_adam_step_submit<T>(num_iter, beta_1, beta_2, eps, T(0),
+            weight_decay, decoupled, grad, first_moment, second_moment, p,
+            &scalars, max_nelems);
+}
+
+//! Blocking version of fused Adam or AdamW step for many tensors
+template<typename T>
+void multi_adam_step(Index num_iter, T beta_1, T beta_2, T eps, T lr,
+        T weight_decay, bool decoupled, const std::vector<Tensor<T>> &grad,
+        const std::vector<Tensor<T>> &first_moment,
+        const std::vector<Tensor<T>> &second_moment,
+        const std::vector<Tensor<T>> &p, Index max_nelems)
+{
+    multi_adam_step_async<T>(num_iter, beta_1, beta_2, eps, lr, weight_decay,
+            decoupled, grad, first_moment, second_moment, p, max_nelems);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+//! Blocking version of fused Adam or AdamW step with scalars in a tensor
+template<typename T>
+void multi_adam_step_scaled(Index num_iter, T beta_1, T beta_2, T eps,
+        T weight_decay, bool decoupled, const std::vector<Tensor<T>> &grad,
+        const std::vector<Tensor<T>> &first_moment,
+        const std::vector<Tensor<T>> &second_moment,
+        const std::vector<Tensor<T>> &p, const Tensor<T> &scalars,
+        Index max_nelems)
+{
+    multi_adam_step_scaled_async<T>(num_iter, beta_1, beta_2, eps,
+            weight_decay, decoupled, grad, first_moment, second_moment, p,
+            scalars, max_nelems);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void multi_adam_step_async<fp32_t>(Index num_iter, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t lr, fp32_t weight_decay,
+        bool decoupled, const std::vector<Tensor<fp32_t>> &grad,
+        const std::vector<Tensor<fp32_t>> &first_moment,
+        const std::vector<Tensor<fp32_t>> &second_moment,
+        const std::vector<Tensor<fp32_t>> &p, Index max_nelems);
+
+template
+void multi_adam_step_async<fp64_t>(Index num_iter, fp64_t beta_1,
+        fp64_t beta_2, fp64_t eps, fp64_t lr, fp64_t weight_decay,
+        bool decoupled, const std::vector<Tensor<fp64_t>> &grad,
+        const std::vector<Tensor<fp64_t>> &first_moment,
+        const std::vector<Tensor<fp64_t>> &second_moment,
+        const std::vector<Tensor<fp64_t>> &p, Index max_nelems);
+
+// Explicit instantiation
+template
+void multi_adam_step<fp32_t>(Index num_iter, fp32_t beta_1, fp32_t beta_2,
+        fp32_t eps, fp32_t lr, fp32_t weight_decay, bool decoupled,
+        const std::vector<Tensor<fp32_t>> &grad,
+        const std::vector<Tensor<fp32_t>> &first_moment,
+        const std::vector<Tensor<fp32_t>> &second_moment,
+        const std::vector<Tensor<fp32_t>> &p, Index max_nelems);
+
+template
+void multi_adam_step<fp64_t>(Index num_iter, fp64_t beta_1, fp64_t beta_2,
+        fp64_t eps, fp64_t lr, fp64_t weight_decay, bool decoupled,
+        const std::vector<Tensor<fp64_t>> &grad,
+        const std::vector<Tensor<fp64_t>> &first_moment,
+        const std::vector<Tensor<fp64_t>> &second_moment,
+        const std::vector<Tensor<fp64_t>> &p, Index max_nelems);
+
+// Explicit instantiation
+template
+void multi_adam_step_scaled_async<fp32_t>(Index num_iter, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t weight_decay, bool decoupled,
+        const std::vector<Tensor<fp32_t>> &grad,
+        const std::vector<Tensor<fp32_t>> &first_moment,
+        const std::vector<Tensor<fp32_t>> &second_moment,
+        const std::vector<Tensor<fp32_t>> &p, const Tensor<fp32_t> &scalars,
+        Index max_nelems);
+
+template
+void multi_adam_step_scaled_async<fp64_t>(Index num_iter, fp64_t beta_1,
+        fp64_t beta_2, fp64_t eps, fp64_t weight_decay, bool decoupled,
+        const std::vector<Tensor<fp64_t>> &grad,
+        const std::vector<Tensor<fp64_t>> &first_moment,
+        const std::vector<Tensor<fp64_t>> &second_moment,
+        const std::vector<Tensor<fp64_t>> &p, const Tensor<fp64_t> &scalars,
+        Index max_nelems);
+
+// Explicit instantiation
+template
+void multi_adam_step_scaled<fp32_t>(Index num_iter, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t weight_decay, bool decoupled,
+        const std::vector<Tensor<fp32_t>> &grad,
+        const std::vector<Tensor<fp32_t>> &first_moment,
+        const std::vector<Tensor<fp32_t>> &second_moment,
+        const std::vector<Tensor<fp32_t>> &p, const Tensor<fp32_t> &scalars,
+        Index max_nelems);
+
+template
+void multi_adam_step_scaled<fp64_t>(Index num_iter, fp64_t beta_1,
+        fp64_t beta_2, fp64_t eps, fp64_t weight_decay, bool decoupled,
+        const std::vector<Tensor<fp64_t>> &grad,
+        const std::vector<Tensor<fp64_t>> &first_moment,
+        const std::vector<Tensor<fp64_t>> &second_moment,
+        const std::vector<Tensor<fp64_t>> &p, const Tensor<fp64_t> &scalars,
+        Index max_nelems);
+
+} // namespace tensor
+} // namespace nntile
+
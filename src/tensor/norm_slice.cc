@@ -13,7 +13,9 @@
  * */
 
 #include "nntile/tensor/norm_slice.hh"
+#include "nntile/tensor/tree_reduction.hh"
 #include "nntile/starpu/norm_slice.hh"
+#include "nntile/starpu/accumulate_hypot.hh"
 
 namespace nntile
 {
@@ -72,13 +74,21 @@ void norm_slice_async(T alpha, const Tensor<T> &src, T beta,
     // Do actual calculations
     int mpi_rank = starpu_mpi_world_rank();
     int ret;
-    constexpr T one = 1.0;
+    constexpr T zero = 0.0, one = 1.0;
+    // Tree reduction does not rely on STARPU_REDUX
+    redux = redux_mode(redux, true);
+    bool use_tree = (redux == redux_tree);
+    if(use_tree)
+    {
+        redux = 0;
+    }
+    std::vector<Index> dst_tile_index;
     for(Index i = 0; i < dst.grid.nelems; ++i)
     {
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Obtain indices of applicable source tiles
-        auto dst_tile_index = dst.grid.linear_to_index(i);
+        dst.grid.linear_to_index(i, dst_tile_index);
         std::vector<Index> src_tile_index(src.ndim);
         for(Index j = 0, k = 0; j < src.ndim; ++j)
         {
@@ -90,27 +100,57 @@ void norm_slice_async(T alpha, const Tensor<T> &src, T beta,
             src_tile_index[j] = dst_tile_index[k];
             ++k;
         }
-        auto dst_tile_traits = dst.get_tile_traits(i);
+        const auto &dst_tile_traits = dst.get_tile_traits(i);
+        // Source tile, that initializes the destination tile. Tree
+        // reduction prefers a tile, that is already on the destination node
+        Index j_first = 0;
+        if(use_tree)
+        {
+            for(Index j = 0; j < src.grid.shape[axis]; ++j)
+            {
+                src_tile_index[axis] = j;
+                if(src.get_tile_handle(src.grid.index_to_linear(
+                                src_tile_index)).mpi_get_rank()
+                        == dst_tile_rank)
+                {
+                    j_first = j;
+                    break;
+                }
+            }
+        }
+        TreeReduction tree(dst_tile_handle, sizeof(T)*dst_tile_traits.nelems,
+                starpu::accumulate_hypot::submit<T>);
         // Launch kernel for each appropriate source tile
         for(Index j = 0; j < src.grid.shape[axis]; ++j)
         {
             src_tile_index[axis] = j;
             Index src_tile_offset = src.grid.index_to_linear(src_tile_index);
-            auto src_tile_handle = src.get_tile_handle(src_tile_offset);
+            const auto &src_tile_handle = src.get_tile_handle(src_tile_offset);
             int src_tile_rank = src_tile_handle.mpi_get_rank();
+            const auto &src_tile_traits = src.get_tile_traits(src_tile_offset);
+            Index m, n, k;
+            m = src_tile_traits.stride[axis];
+            n = src_tile_traits.matrix_shape[axis+1][1];
+            k = src_tile_traits.shape[axis];
+            // Partial result of the tree reduction is computed on the node
+            // with the source tile
+            if(use_tree and j != j_first)
+            {
+                auto partial = tree.get_partial(src_tile_rank);
+                if(mpi_rank == src_tile_rank)
+                {
+                    starpu::norm_slice::submit<T>(m, n, k, alpha,
+                            src_tile_handle, zero, partial, 0);
+                }
+                continue;
+            }
             // Transfer data
             src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
             // Execute on destination node
             if(mpi_rank == dst_tile_rank)
             {
-                // Get sizes
-                auto src_tile_traits = src.get_tile_traits(src_tile_offset);
-                Index m, n, k;
-                m = src_tile_traits.stride[axis];
-                n = src_tile_traits.matrix_shape[axis+1][1];
-                k = src_tile_traits.shape[axis];
                 // Insert initial task
-                if(j == 0)
+                if(j == j_first)
                 {
                     starpu::norm_slice::submit<T>(m, n, k, alpha,
                             src_tile_handle, beta, dst_tile_handle, redux);
@@ -123,6 +163,11 @@ void norm_slice_async(T alpha, const Tensor<T> &src, T beta,
                 }
             }
         }
+        // Combine partial results of the tree reduction
+        if(use_tree)
+        {
+            tree.submit();
+        }
         // Flush cache for the output tile on every node
         dst_tile_handle.mpi_flush();
     }
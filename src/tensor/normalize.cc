@@ -103,7 +103,7 @@ void normalize_async(const Tensor<T> &gamma_beta, const Tensor<T> &src,
     // Obtain gamma_beta on every node
     int mpi_rank = starpu_mpi_world_rank();
     int mpi_size = starpu_mpi_world_size();
-    auto gamma_beta_handle = gamma_beta.get_tile_handle(0);
+    const auto &gamma_beta_handle = gamma_beta.get_tile_handle(0);
     int gamma_beta_rank = gamma_beta_handle.mpi_get_rank();
     int ret;
     // Transfer data to all nodes from source node
@@ -125,14 +125,15 @@ void normalize_async(const Tensor<T> &gamma_beta, const Tensor<T> &src,
         gamma_beta_handle.mpi_transfer(mpi_rank, mpi_rank);
     }
     // Apply per-tile normalization asynchronously as needed
+    std::vector<Index> src_tile_index;
     for(Index i = 0; i < src.grid.nelems; ++i)
     {
         // Index of current source tile
-        auto src_tile_index = src.grid.linear_to_index(i);
+        src.grid.linear_to_index(i, src_tile_index);
         // Source tile traits
-        auto src_tile_traits = src.get_tile_traits(i);
+        const auto &src_tile_traits = src.get_tile_traits(i);
         // Source tile handle
-        auto src_tile_handle = src.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
         // Set fixed indices of current destination tile
         std::vector<Index> dst_tile_index(dst.ndim);
         for(Index j = 0; j < axis; ++j)
@@ -151,7 +152,7 @@ void normalize_async(const Tensor<T> &gamma_beta, const Tensor<T> &src,
             // Get linear offset from index
             Index dst_tile_offset = dst.grid.index_to_linear(dst_tile_index);
             // Get destination tile handle
-            auto dst_tile_handle = dst.get_tile_handle(dst_tile_offset);
+            const auto &dst_tile_handle = dst.get_tile_handle(dst_tile_offset);
             // MPI rank of the destination tile
             int dst_tile_rank = dst_tile_handle.mpi_get_rank();
             // Transfer data
@@ -160,7 +161,8 @@ void normalize_async(const Tensor<T> &gamma_beta, const Tensor<T> &src,
             if(mpi_rank == dst_tile_rank)
             {
                 // Get destination tile traits
-                auto dst_tile_traits = dst.get_tile_traits(dst_tile_offset);
+                const auto &dst_tile_traits =
+                    dst.get_tile_traits(dst_tile_offset);
                 // Reshape inputs for simplicity: src -> (2,m,n), dst -> (m,k,n)
                 // dst is a part of (m,l,n) tensor
                 Index m, n, k;
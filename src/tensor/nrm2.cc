@@ -23,6 +23,11 @@ namespace tensor
 {
 
 //! Compute Euclidean norm
+/*! dst = hypot(alpha*norm(src), beta*dst). Norms of tiles on the node with
+ * dst are accumulated into dst by the same tasks, that compute them. Norms
+ * of other tiles are computed into the corresponding tiles of tmp on their
+ * nodes and then accumulated into dst by hypot.
+ * */
 template<typename T>
 void nrm2_async(T alpha, const Tensor<T> &src, T beta, const Tensor<T> &dst,
         const Tensor<T> &tmp)
@@ -52,14 +57,25 @@ void nrm2_async(T alpha, const Tensor<T> &src, T beta, const Tensor<T> &dst,
     int mpi_rank = starpu_mpi_world_rank();
     int ret;
     Index ndim = src.ndim;
-    auto dst_tile_handle = dst.get_tile_handle(0);
+    const auto &dst_tile_handle = dst.get_tile_handle(0);
     auto dst_tile_rank = dst_tile_handle.mpi_get_rank();
     for(Index i = 0; i < src.grid.nelems; ++i)
     {
-        auto src_tile_handle = src.get_tile_handle(i);
-        auto src_tile_traits = src.get_tile_traits(i);
-        auto tmp_tile_handle = tmp.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &src_tile_traits = src.get_tile_traits(i);
+        const auto &tmp_tile_handle = tmp.get_tile_handle(i);
         int src_tile_rank = src_tile_handle.mpi_get_rank();
+        // Norm of a tile on the node with dst is accumulated directly
+        if(src_tile_rank == dst_tile_rank)
+        {
+            if(mpi_rank == dst_tile_rank)
+            {
+                starpu::nrm2::submit<T>(src_tile_traits.nelems, alpha,
+                        src_tile_handle, i == 0 ? beta : T(1.0),
+                        dst_tile_handle);
+            }
+            continue;
+        }
         int tmp_tile_rank = tmp_tile_handle.mpi_get_rank();
         auto tmp_tile_tag = tmp_tile_handle.mpi_get_tag();
         // Flush cache for the output tile on every node
@@ -73,30 +89,34 @@ void nrm2_async(T alpha, const Tensor<T> &src, T beta, const Tensor<T> &dst,
             if(mpi_rank != tmp_tile_rank)
             {
                 // No need to check for cached send, as output was just updated
-                //ret = starpu_mpi_isend_detached(
-                //        static_cast<starpu_data_handle_t>(tmp_tile_handle),
-                //        tmp_tile_rank, tmp_tile_tag, MPI_COMM_WORLD, nullptr,
-                //        nullptr);
-                //if(ret != 0)
-                //{
-                //    throw std::runtime_error("Error in starpu_mpi_isend_"
-                //            "detached");
-                //}
+#ifdef NNTILE_USE_MPI
+                ret = starpu_mpi_isend_detached(
+                        static_cast<starpu_data_handle_t>(tmp_tile_handle),
+                        tmp_tile_rank, tmp_tile_tag, MPI_COMM_WORLD, nullptr,
+                        nullptr);
+                if(ret != 0)
+                {
+                    throw std::runtime_error("Error in starpu_mpi_isend_"
+                            "detached");
+                }
+#endif // NNTILE_USE_MPI
             }
         }
         // Init receive of tmp tile
         else if(mpi_rank == tmp_tile_rank)
         {
             // No need to check for cached recv, as output was just updated
-            //ret = starpu_mpi_irecv_detached(
-            //        static_cast<starpu_data_handle_t>(tmp_tile_handle),
-            //        src_tile_rank, tmp_tile_tag, MPI_COMM_WORLD, nullptr,
-            //        nullptr);
-            //if(ret != 0)
-            //{
-            //    throw std::runtime_error("Error in starpu_mpi_irecv_"
-            //            "detached");
-            //}
+#ifdef NNTILE_USE_MPI
+            ret = starpu_mpi_irecv_detached(
+                    static_cast<starpu_data_handle_t>(tmp_tile_handle),
+                    src_tile_rank, tmp_tile_tag, MPI_COMM_WORLD, nullptr,
+                    nullptr);
+            if(ret != 0)
+            {
+                throw std::runtime_error("Error in starpu_mpi_irecv_"
+                        "detached");
+            }
+#endif // NNTILE_USE_MPI
         }
         // Update total norm
         tmp_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
@@ -0,0 +1,140 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/permute.cc
+ * Permutation of axes of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/permute.hh"
+#include "nntile/starpu/subcopy.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Check if dst is src with permuted axes
+/*! Axis i of dst is axis perm[i] of src, as in numpy.transpose, and base
+ * tiles are permuted the same way.
+ * */
+void permute_check(const TensorTraits &src, const TensorTraits &dst,
+        const std::vector<Index> &perm)
+{
+    if(dst.ndim != src.ndim)
+    {
+        throw std::runtime_error("dst.ndim != src.ndim");
+    }
+    if(perm.size() != src.ndim)
+    {
+        throw std::runtime_error("perm.size() != src.ndim");
+    }
+    std::vector<bool> used(src.ndim, false);
+    for(Index i = 0; i < src.ndim; ++i)
+    {
+        if(perm[i] < 0 or perm[i] >= src.ndim or used[perm[i]])
+        {
+            throw std::runtime_error("perm is not a permutation");
+        }
+        used[perm[i]] = true;
+        if(dst.shape[i] != src.shape[perm[i]])
+        {
+            throw std::runtime_error("dst.shape[i] != src.shape[perm[i]]");
+        }
+        if(dst.basetile_shape[i] != src.basetile_shape[perm[i]])
+        {
+            throw std::runtime_error("dst.basetile_shape[i] != "
+                    "src.basetile_shape[perm[i]]");
+        }
+    }
+}
+
+//! Asynchronous tensor-wise permutation of axes
+/*! Every tile of dst is a tile of src with permuted axes. It is copied by
+ * the subcopy codelet with strides of dst permuted back to axes of src, so
+ * no separate kernel is needed. Tasks are executed on owners of dst tiles.
+ *
+ * @param[in] src: Input tensor
+ * @param[out] dst: Output tensor, axis i of which is axis perm[i] of src
+ * @param[in] perm: Permutation of axes
+ * */
+template<typename T>
+void permute_async(const Tensor<T> &src, const Tensor<T> &dst,
+        const std::vector<Index> &perm)
+{
+    permute_check(src, dst, perm);
+    int mpi_rank = starpu_mpi_world_rank();
+    Index ndim = src.ndim;
+    // Workspace of subcopy codelet
+    starpu::VariableHandle scratch(2*ndim*sizeof(Index), STARPU_SCRATCH);
+    std::vector<Index> start(ndim, 0), src_tile_index(ndim),
+        dst_stride(ndim);
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        auto dst_tile_index = dst.grid.linear_to_index(i);
+        for(Index j = 0; j < ndim; ++j)
+        {
+            src_tile_index[perm[j]] = dst_tile_index[j];
+        }
+        Index src_tile_offset = src.grid.index_to_linear(src_tile_index);
+        const auto &src_tile_handle = src.get_tile_handle(src_tile_offset);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
+        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+        // Transfer data
+        src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        // Execute only on destination node
+        if(mpi_rank == dst_tile_rank)
+        {
+            const auto &src_tile_traits = src.get_tile_traits(
+                    src_tile_offset);
+            const auto &dst_tile_traits = dst.get_tile_traits(i);
+            for(Index j = 0; j < ndim; ++j)
+            {
+                dst_stride[perm[j]] = dst_tile_traits.stride[j];
+            }
+            starpu::subcopy::submit<T>(ndim, start, src_tile_traits.stride,
+                    start, dst_stride, src_tile_traits.shape,
+                    src_tile_handle, dst_tile_handle, scratch, STARPU_W);
+        }
+        // Flush cache for the output tile on every node
+        dst_tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking version of tensor-wise permutation of axes
+template<typename T>
+void permute(const Tensor<T> &src, const Tensor<T> &dst,
+        const std::vector<Index> &perm)
+{
+    permute_async<T>(src, dst, perm);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void permute_async<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &dst, const std::vector<Index> &perm);
+
+template
+void permute_async<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &dst, const std::vector<Index> &perm);
+
+// Explicit instantiation
+template
+void permute<fp32_t>(const Tensor<fp32_t> &src, const Tensor<fp32_t> &dst,
+        const std::vector<Index> &perm);
+
+template
+void permute<fp64_t>(const Tensor<fp64_t> &src, const Tensor<fp64_t> &dst,
+        const std::vector<Index> &perm);
+
+} // namespace tensor
+} // namespace nntile
+
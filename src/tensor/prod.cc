@@ -41,8 +41,8 @@ void prod_async(const Tensor<T> &src, const Tensor<T> &dst)
     for(Index i = 0; i < src.grid.nelems; ++i)
     {
         // Get handle for corresponding tiles of src and dst
-        auto src_tile_handle = src.get_tile_handle(i);
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         // MPI rank of the destination tile
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Transfer data
@@ -50,7 +50,7 @@ void prod_async(const Tensor<T> &src, const Tensor<T> &dst)
         // Execute only on destination node
         if(mpi_rank == dst_tile_rank)
         {
-            auto traits = src.get_tile_traits(i);
+            const auto &traits = src.get_tile_traits(i);
             starpu::prod::submit<T>(traits.nelems, src_tile_handle,
                     dst_tile_handle);
         }
@@ -78,6 +78,12 @@ void prod_async<fp32_t>(const Tensor<fp32_t> &src, const Tensor<fp32_t> &dst);
 template
 void prod_async<fp64_t>(const Tensor<fp64_t> &src, const Tensor<fp64_t> &dst);
 
+template
+void prod_async<bf16_t>(const Tensor<bf16_t> &src, const Tensor<bf16_t> &dst);
+
+template
+void prod_async<fp16_t>(const Tensor<fp16_t> &src, const Tensor<fp16_t> &dst);
+
 // Explicit instantiation
 template
 void prod<fp32_t>(const Tensor<fp32_t> &src, const Tensor<fp32_t> &dst);
@@ -85,6 +91,12 @@ void prod<fp32_t>(const Tensor<fp32_t> &src, const Tensor<fp32_t> &dst);
 template
 void prod<fp64_t>(const Tensor<fp64_t> &src, const Tensor<fp64_t> &dst);
 
+template
+void prod<bf16_t>(const Tensor<bf16_t> &src, const Tensor<bf16_t> &dst);
+
+template
+void prod<fp16_t>(const Tensor<fp16_t> &src, const Tensor<fp16_t> &dst);
+
 } // namespace tensor
 } // namespace nntile
 
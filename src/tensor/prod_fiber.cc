@@ -60,15 +60,16 @@ void prod_fiber_async(const Tensor<T> &src, T alpha, const Tensor<T> &dst,
     // Apply per-tile prod_fiber asynchronously as needed
     int mpi_rank = starpu_mpi_world_rank();
     int ret;
+    std::vector<Index> dst_tile_index;
     for(Index i = 0; i < dst.grid.nelems; ++i)
     {
-        auto dst_tile_index = dst.grid.linear_to_index(i);
-        auto dst_tile_traits = dst.get_tile_traits(i);
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        dst.grid.linear_to_index(i, dst_tile_index);
+        const auto &dst_tile_traits = dst.get_tile_traits(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Get corresponding src tile
         Index j = dst_tile_index[axis];
-        auto src_tile_handle = src.get_tile_handle(j);
+        const auto &src_tile_handle = src.get_tile_handle(j);
         int src_tile_rank = src_tile_handle.mpi_get_rank();
         // Transfer data
         src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
@@ -75,14 +75,15 @@ void prod_slice_async(const Tensor<T> &src, T alpha, const Tensor<T> &dst,
     // Apply per-tile prod_slice asynchronously as needed
     int mpi_rank = starpu_mpi_world_rank();
     int ret;
+    std::vector<Index> src_tile_index;
     for(Index i = 0; i < src.grid.nelems; ++i)
     {
         // Index of current source tile
-        auto src_tile_index = src.grid.linear_to_index(i);
+        src.grid.linear_to_index(i, src_tile_index);
         // Source tile traits
-        auto src_tile_traits = src.get_tile_traits(i);
+        const auto &src_tile_traits = src.get_tile_traits(i);
         // Source tile handle
-        auto src_tile_handle = src.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
         // Set fixed indices of current destination tile
         std::vector<Index> dst_tile_index(dst.ndim);
         for(Index j = 0; j < axis; ++j)
@@ -101,7 +102,7 @@ void prod_slice_async(const Tensor<T> &src, T alpha, const Tensor<T> &dst,
             // Get linear offset from index
             Index dst_tile_offset = dst.grid.index_to_linear(dst_tile_index);
             // Get destination tile handle
-            auto dst_tile_handle = dst.get_tile_handle(dst_tile_offset);
+            const auto &dst_tile_handle = dst.get_tile_handle(dst_tile_offset);
             // MPI rank of the destination tile
             int dst_tile_rank = dst_tile_handle.mpi_get_rank();
             // Transfer data
@@ -110,7 +111,8 @@ void prod_slice_async(const Tensor<T> &src, T alpha, const Tensor<T> &dst,
             if(mpi_rank == dst_tile_rank)
             {
                 // Get destination tile traits
-                auto dst_tile_traits = dst.get_tile_traits(dst_tile_offset);
+                const auto &dst_tile_traits =
+                    dst.get_tile_traits(dst_tile_offset);
                 // Reshape inputs: src_tile -> (m,n), dst_tile -> (m,k,n)
                 Index m, n, k;
                 m = dst_tile_traits.stride[axis];
@@ -0,0 +1,177 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/quantize.cc
+ * Quantization of weights into 8-bit types with per-group scales for
+ * Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/tensor/quantize.hh"
+#include "nntile/starpu/quantize.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Check if tensors match quantize
+/*! Scales have the same shape and basetile as quantized weights, except the
+ * axis of groups, that is divided by the size of groups.
+ * */
+void quantize_check(const TensorTraits &src, const TensorTraits &dst,
+        const TensorTraits &scale, Index axis, Index group)
+{
+    // Check dimensions
+    if(src.ndim != dst.ndim)
+    {
+        throw std::runtime_error("src.ndim != dst.ndim");
+    }
+    if(src.ndim != scale.ndim)
+    {
+        throw std::runtime_error("src.ndim != scale.ndim");
+    }
+    // Check axis and group
+    if(axis < 0)
+    {
+        throw std::runtime_error("axis < 0");
+    }
+    if(axis >= src.ndim)
+    {
+        throw std::runtime_error("axis >= src.ndim");
+    }
+    if(group <= 0)
+    {
+        throw std::runtime_error("group <= 0");
+    }
+    // Groups shall not cross boundaries of tiles
+    if(src.basetile_shape[axis] % group != 0)
+    {
+        throw std::runtime_error("src.basetile_shape[axis] % group != 0");
+    }
+    if(src.shape[axis] % group != 0)
+    {
+        throw std::runtime_error("src.shape[axis] % group != 0");
+    }
+    // Check shapes
+    if(src.shape != dst.shape)
+    {
+        throw std::runtime_error("src.shape != dst.shape");
+    }
+    if(src.basetile_shape != dst.basetile_shape)
+    {
+        throw std::runtime_error("src.basetile_shape != dst.basetile_shape");
+    }
+    for(Index i = 0; i < src.ndim; ++i)
+    {
+        Index factor = (i == axis) ? group : 1;
+        if(scale.shape[i]*factor != src.shape[i])
+        {
+            throw std::runtime_error("Wrong shape of scale");
+        }
+        if(scale.basetile_shape[i]*factor != src.basetile_shape[i])
+        {
+            throw std::runtime_error("Wrong basetile_shape of scale");
+        }
+    }
+}
+
+//! Tensor-wise quantization of weights with per-group scales
+/*! Consecutive elements along the given axis are split into groups, and
+ * each group gets its own scale, so that the largest element by modulus
+ * becomes the largest value of Q (see nntile::kernel::quantize::cpu()).
+ * Per-channel quantization corresponds to group, equal to the basetile
+ * along the axis.
+ *
+ * @param[in] src: Input single precision tensor
+ * @param[out] dst: Output quantized tensor
+ * @param[out] scale: Output scales of groups
+ * @param[in] axis: Axis, along which groups are formed
+ * @param[in] group: Size of groups, that shall divide the basetile
+ * */
+template<typename Q>
+void quantize_async(const Tensor<fp32_t> &src, const Tensor<Q> &dst,
+        const Tensor<fp32_t> &scale, Index axis, Index group)
+{
+    // Check inputs (throw exception in case of an error)
+    quantize_check(src, dst, scale, axis, group);
+    // Do actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < src.grid.nelems; ++i)
+    {
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
+        const auto &scale_tile_handle = scale.get_tile_handle(i);
+        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+        // Quantized weights and their scales are produced by the same task
+        if(scale_tile_handle.mpi_get_rank() != dst_tile_rank)
+        {
+            throw std::runtime_error("Tiles of dst and scale are owned by "
+                    "different nodes");
+        }
+        // Transfer data
+        src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == dst_tile_rank)
+        {
+            // Get sizes
+            const auto &dst_tile_traits = dst.get_tile_traits(i);
+            Index m = dst_tile_traits.stride[axis];
+            Index k = dst_tile_traits.nelems / m;
+            // Insert task
+            starpu::quantize::submit<Q>(m, k, group, src_tile_handle,
+                    dst_tile_handle, scale_tile_handle);
+        }
+        // Flush cache for the output tiles on every node
+        dst_tile_handle.mpi_flush();
+        scale_tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking version of tensor-wise quantization of weights
+/*! @param[in] src: Input single precision tensor
+ * @param[out] dst: Output quantized tensor
+ * @param[out] scale: Output scales of groups
+ * @param[in] axis: Axis, along which groups are formed
+ * @param[in] group: Size of groups, that shall divide the basetile
+ * */
+template<typename Q>
+void quantize(const Tensor<fp32_t> &src, const Tensor<Q> &dst,
+        const Tensor<fp32_t> &scale, Index axis, Index group)
+{
+    quantize_async<Q>(src, dst, scale, axis, group);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void quantize_async<std::int8_t>(const Tensor<fp32_t> &src,
+        const Tensor<std::int8_t> &dst, const Tensor<fp32_t> &scale,
+        Index axis, Index group);
+
+template
+void quantize_async<fp8_e4m3_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp8_e4m3_t> &dst, const Tensor<fp32_t> &scale,
+        Index axis, Index group);
+
+// Explicit instantiation
+template
+void quantize<std::int8_t>(const Tensor<fp32_t> &src,
+        const Tensor<std::int8_t> &dst, const Tensor<fp32_t> &scale,
+        Index axis, Index group);
+
+template
+void quantize<fp8_e4m3_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp8_e4m3_t> &dst, const Tensor<fp32_t> &scale,
+        Index axis, Index group);
+
+} // namespace tensor
+} // namespace nntile
+
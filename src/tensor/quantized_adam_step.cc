@@ -0,0 +1,166 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/quantized_adam_step.cc
+ * Fused Adam step with block-wise 8-bit moments for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/quantized_adam_step.hh"
+#include "nntile/starpu/quantized_adam_step.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+void quantized_adam_step_check(Index block, const TensorTraits &p,
+        const TensorTraits &moment, const TensorTraits &scale)
+//! Check if tensors match quantized_adam_step
+/*! Each tile of moments is split into blocks of consecutive elements.
+ * Scales of blocks of tile index (i_0, ..., i_{d-1}) of p form a single
+ * tile of index (0, i_0, ..., i_{d-1}) of scale, whose shape is
+ * (nblocks, p.grid.shape[0], ..., p.grid.shape[d-1]) with basetile
+ * (nblocks, 1, ..., 1), where nblocks is the number of blocks of a base
+ * tile of p.
+ * */
+{
+    if(block <= 0)
+    {
+        throw std::runtime_error("block <= 0");
+    }
+    // Moments of a block are kept in shared memory of CUDA
+    if(block > 4096)
+    {
+        throw std::runtime_error("block > 4096");
+    }
+    if(p.shape != moment.shape or p.basetile_shape != moment.basetile_shape)
+    {
+        throw std::runtime_error("Parameter shape is not equal to moment "
+                "shape");
+    }
+    if(scale.ndim != p.ndim+1)
+    {
+        throw std::runtime_error("scale.ndim != p.ndim+1");
+    }
+    Index base_nelems = 1;
+    for(Index i = 0; i < p.ndim; ++i)
+    {
+        base_nelems *= p.basetile_shape[i];
+    }
+    Index nblocks = (base_nelems+block-1) / block;
+    if(scale.shape[0] != nblocks or scale.basetile_shape[0] != nblocks)
+    {
+        throw std::runtime_error("scale.shape[0] != nblocks or "
+                "scale.basetile_shape[0] != nblocks");
+    }
+    for(Index i = 0; i < p.ndim; ++i)
+    {
+        if(scale.shape[i+1] != p.grid.shape[i])
+        {
+            throw std::runtime_error("scale.shape[i+1] != p.grid.shape[i]");
+        }
+        if(scale.basetile_shape[i+1] != 1)
+        {
+            throw std::runtime_error("scale.basetile_shape[i+1] != 1");
+        }
+    }
+}
+
+void quantized_adam_step_async(Index num_iter, Index block, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t lr, fp32_t weight_decay,
+        bool decoupled, const Tensor<fp32_t> &grad,
+        const Tensor<std::int8_t> &first_moment,
+        const Tensor<fp32_t> &first_scale,
+        const Tensor<fp8_e4m3_t> &second_moment,
+        const Tensor<fp32_t> &second_scale, const Tensor<fp32_t> &p)
+//! Asynchronous tensor-wise Adam step with block-wise 8-bit moments
+/*! Moments take 2 bytes per parameter instead of 8 bytes of single
+ * precision moments, see kernel::quantized_adam_step for details.
+ *
+ * @param[in] num_iter: Current iteration number, starting from 1
+ * @param[in] block: Number of elements of a block, at most 4096
+ * @param[in] decoupled: Whether weight decay is decoupled as in AdamW
+ * @param[in] grad: Gradient of parameters
+ * @param[inout] first_moment: Quantized first moments
+ * @param[inout] first_scale: Scales of blocks of first moments, see
+ *      quantized_adam_step_check for its shape
+ * @param[inout] second_moment: Quantized square roots of second moments
+ * @param[inout] second_scale: Scales of blocks of second moments
+ * @param[inout] p: Parameters
+ * */
+{
+    // Check shapes
+    if(p.shape != grad.shape or p.basetile_shape != grad.basetile_shape)
+    {
+        throw std::runtime_error("Parameter shape is not equal to gradient "
+                "shape");
+    }
+    quantized_adam_step_check(block, p, first_moment, first_scale);
+    quantized_adam_step_check(block, p, second_moment, second_scale);
+    if(num_iter < 1)
+    {
+        throw std::runtime_error("num_iter < 1");
+    }
+    // Actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < p.grid.nelems; ++i)
+    {
+        // Tiles of scales have the same linear offsets as tiles of p
+        const auto &p_tile_handle = p.get_tile_handle(i);
+        const auto &grad_tile_handle = grad.get_tile_handle(i);
+        const auto &f_tile_handle = first_moment.get_tile_handle(i);
+        const auto &f_scale_tile_handle = first_scale.get_tile_handle(i);
+        const auto &s_tile_handle = second_moment.get_tile_handle(i);
+        const auto &s_scale_tile_handle = second_scale.get_tile_handle(i);
+        // MPI rank of the destination tile
+        int p_tile_rank = p_tile_handle.mpi_get_rank();
+        // Transfer data
+        grad_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        f_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        f_scale_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        s_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        s_scale_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        // Execute only on destination node
+        if(mpi_rank == p_tile_rank)
+        {
+            const auto &traits = p.get_tile_traits(i);
+            starpu::quantized_adam_step::submit(num_iter, traits.nelems,
+                    block, beta_1, beta_2, eps, lr, weight_decay, decoupled,
+                    grad_tile_handle, f_tile_handle, f_scale_tile_handle,
+                    s_tile_handle, s_scale_tile_handle, p_tile_handle);
+        }
+        // Flush cache for the output tiles on every node
+        p_tile_handle.mpi_flush();
+        f_tile_handle.mpi_flush();
+        f_scale_tile_handle.mpi_flush();
+        s_tile_handle.mpi_flush();
+        s_scale_tile_handle.mpi_flush();
+    }
+}
+
+void quantized_adam_step(Index num_iter, Index block, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t lr, fp32_t weight_decay,
+        bool decoupled, const Tensor<fp32_t> &grad,
+        const Tensor<std::int8_t> &first_moment,
+        const Tensor<fp32_t> &first_scale,
+        const Tensor<fp8_e4m3_t> &second_moment,
+        const Tensor<fp32_t> &second_scale, const Tensor<fp32_t> &p)
+//! Blocking version of tensor-wise Adam step with block-wise 8-bit moments
+{
+    quantized_adam_step_async(num_iter, block, beta_1, beta_2, eps, lr,
+            weight_decay, decoupled, grad, first_moment, first_scale,
+            second_moment, second_scale, p);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+} // namespace tensor
+} // namespace nntile
+
@@ -66,7 +66,7 @@ void randn_async(const Tensor<T> &dst, const std::vector<Index> &start,
     // Tackle ndim=0 case
     if(ndim == 0)
     {
-        auto tile_handle = dst.get_tile_handle(0);
+        const auto &tile_handle = dst.get_tile_handle(0);
         int tile_rank = tile_handle.mpi_get_rank();
         if(mpi_rank == tile_rank)
         {
@@ -79,19 +79,19 @@ void randn_async(const Tensor<T> &dst, const std::vector<Index> &start,
         tile_handle.mpi_flush();
         return;
     }
-    // Temporary index
-    starpu::VariableHandle tmp_index(sizeof(Index)*2*ndim, STARPU_SCRATCH);
+    // Temporary index, CUDA implementation needs 4*ndim values
+    starpu::VariableHandle tmp_index(sizeof(Index)*4*ndim, STARPU_SCRATCH);
     // Now do the job
     std::vector<Index> tile_start(start), tile_index(dst.ndim);
     for(Index i = 0; i < dst.grid.nelems; ++i)
     {
         // Get all the info about tile
-        auto tile_handle = dst.get_tile_handle(i);
+        const auto &tile_handle = dst.get_tile_handle(i);
         int tile_rank = tile_handle.mpi_get_rank();
         // Insert task
         if(mpi_rank == tile_rank)
         {
-            auto tile_traits = dst.get_tile_traits(i);
+            const auto &tile_traits = dst.get_tile_traits(i);
             starpu::randn::submit<T>(ndim, tile_traits.nelems, seed, mean,
                     stddev, tile_start, tile_traits.shape, tile_traits.stride,
                     underlying_shape, tile_handle, tmp_index);
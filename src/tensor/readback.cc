@@ -0,0 +1,114 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/readback.cc
+ * Ring buffer in host memory for asynchronous readback of scalar tensors
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/readback.hh"
+#include "nntile/starpu/tile_io.hh"
+#include <thread>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+Readback<T>::Readback(Index capacity_):
+    capacity(capacity_),
+    next_ticket(0)
+{
+    if(capacity <= 0)
+    {
+        throw std::runtime_error("capacity <= 0");
+    }
+    values.resize(capacity);
+    ready.reset(new std::atomic<Index>[capacity]);
+    for(Index i = 0; i < capacity; ++i)
+    {
+        ready[i].store(-1);
+    }
+}
+
+template<typename T>
+Readback<T>::~Readback()
+{
+    Index start = next_ticket > capacity ? next_ticket-capacity : 0;
+    for(Index ticket = start; ticket < next_ticket; ++ticket)
+    {
+        wait(ticket);
+    }
+}
+
+template<typename T>
+Index Readback<T>::submit(const Tensor<T> &src)
+{
+    if(src.ndim != 0)
+    {
+        throw std::runtime_error("src.ndim != 0");
+    }
+    Index ticket = next_ticket;
+    Index slot = ticket % capacity;
+    // Previous value of the slot shall be copied before it is overwritten
+    if(ticket >= capacity)
+    {
+        wait(ticket-capacity);
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    int mpi_size = starpu_mpi_world_size();
+    const auto &src_handle = src.get_tile_handle(0);
+    // Every node gets the value
+    for(int rank = 0; rank < mpi_size; ++rank)
+    {
+        src_handle.mpi_transfer(rank, mpi_rank);
+    }
+    starpu::tile_io::submit_readback(src_handle, &values[slot], &ready[slot],
+            ticket);
+    src_handle.mpi_flush();
+    ++next_ticket;
+    return ticket;
+}
+
+template<typename T>
+bool Readback<T>::is_ready(Index ticket) const
+{
+    if(ticket < 0 or ticket >= next_ticket)
+    {
+        throw std::runtime_error("Ticket is not submitted");
+    }
+    if(ticket+capacity < next_ticket)
+    {
+        throw std::runtime_error("Value of the ticket is overwritten");
+    }
+    return ready[ticket%capacity].load(std::memory_order_acquire) == ticket;
+}
+
+template<typename T>
+T Readback<T>::wait(Index ticket) const
+{
+    // Copies are short tasks, so there is no need to sleep
+    while(not is_ready(ticket))
+    {
+        std::this_thread::yield();
+    }
+    return values[ticket%capacity];
+}
+
+// Explicit instantiation
+template
+class Readback<fp32_t>;
+
+template
+class Readback<fp64_t>;
+
+} // namespace tensor
+} // namespace nntile
+
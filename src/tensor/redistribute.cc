@@ -0,0 +1,90 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/redistribute.cc
+ * Redistribute tensor into another tiling or distribution
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-09
+ * */
+
+#include "nntile/tensor/redistribute.hh"
+#include "nntile/tensor/copy_intersection.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous tensor-wise redistribution operation
+/*! Copies data of the source tensor into the destination tensor of the same
+ * shape, but with possibly different base tile shape and distribution of
+ * tiles over MPI ranks. Every destination tile is assembled on its owner
+ * node directly from the source tiles, that intersect it: a tile is copied
+ * as a whole if tilings match and by subcopy of intersections otherwise. No
+ * data goes through a temporary tensor or host buffer.
+ *
+ * @param[in] src: Source tensor
+ * @param[out] dst: Destination tensor
+ * */
+template<typename T>
+void redistribute_async(const Tensor<T> &src, const Tensor<T> &dst)
+{
+    // Check shapes
+    if(src.shape != dst.shape)
+    {
+        throw std::runtime_error("src.shape != dst.shape");
+    }
+    std::vector<Index> offset(src.ndim, 0);
+    copy_intersection_async<T>(src, offset, dst, offset);
+}
+
+//! Blocking version of tensor-wise redistribution operation
+/*! Copies data of the source tensor into the destination tensor of the same
+ * shape, but with possibly different base tile shape and distribution of
+ * tiles over MPI ranks.
+ *
+ * @param[in] src: Source tensor
+ * @param[out] dst: Destination tensor
+ * */
+template<typename T>
+void redistribute(const Tensor<T> &src, const Tensor<T> &dst)
+{
+    redistribute_async<T>(src, dst);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void redistribute_async<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &dst);
+
+template
+void redistribute_async<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &dst);
+
+template
+void redistribute_async<Index>(const Tensor<Index> &src,
+        const Tensor<Index> &dst);
+
+// Explicit instantiation
+template
+void redistribute<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &dst);
+
+template
+void redistribute<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &dst);
+
+template
+void redistribute<Index>(const Tensor<Index> &src,
+        const Tensor<Index> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -36,15 +36,15 @@ void relu_forward_async(const Tensor<T> &src, const Tensor<T> &dst)
     int mpi_rank = starpu_mpi_world_rank();
     for(Index i = 0; i < src.grid.nelems; ++i)
     {
-        auto src_tile_handle = src.get_tile_handle(i);
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Transfer source tile to dest node
         src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
         // Execute on destination node
         if(mpi_rank == dst_tile_rank)
         {
-            auto dst_tile_traits = dst.get_tile_traits(i);
+            const auto &dst_tile_traits = dst.get_tile_traits(i);
             starpu::relu_forward::submit<T>(dst_tile_traits.nelems,
                     src_tile_handle, dst_tile_handle);
         }
@@ -0,0 +1,200 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/rms_norm.cc
+ * Root mean square layer normalization of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/rms_norm.hh"
+#include "nntile/starpu/rms_norm.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Root mean square layer normalization along a given axis
+/*! Inverse of root mean square of each fiber along the axis and the output
+ * are computed by a single task, therefore the axis shall not be split into
+ * tiles. Tiles of inv_rms shall be owned by the same node as corresponding
+ * tiles of dst.
+ *
+ * @param[in] eps: Regularization parameter for mean square
+ * @param[in] src: Input tensor
+ * @param[in] gamma: Scaling factors of size src.shape[axis]
+ * @param[out] inv_rms: Inverses of root mean squares of fibers of src
+ * @param[out] dst: Normalized and scaled tensor
+ * @param[in] axis: Axis of normalization
+ * */
+template<typename T>
+void rms_norm_async(T eps, const Tensor<T> &src, const Tensor<T> &gamma,
+        const Tensor<T> &inv_rms, const Tensor<T> &dst, Index axis)
+{
+    // Check dimensions
+    if(src.ndim != dst.ndim)
+    {
+        throw std::runtime_error("src.ndim != dst.ndim");
+    }
+    if(src.ndim-1 != inv_rms.ndim)
+    {
+        throw std::runtime_error("src.ndim-1 != inv_rms.ndim");
+    }
+    if(gamma.ndim != 1)
+    {
+        throw std::runtime_error("gamma.ndim != 1");
+    }
+    // Treat special case of src.ndim=0
+    if(src.ndim == 0)
+    {
+        throw std::runtime_error("Scalar input makes no sense");
+    }
+    Index ndim = src.ndim;
+    // Check axis
+    if(axis < 0)
+    {
+        throw std::runtime_error("axis < 0");
+    }
+    if(axis >= ndim)
+    {
+        throw std::runtime_error("axis >= src.ndim");
+    }
+    // Check shapes
+    if(src.shape != dst.shape)
+    {
+        throw std::runtime_error("src.shape != dst.shape");
+    }
+    if(src.basetile_shape != dst.basetile_shape)
+    {
+        throw std::runtime_error("src.basetile_shape != dst.basetile_shape");
+    }
+    for(Index i = 0; i < axis; i++)
+    {
+        if(src.shape[i] != inv_rms.shape[i])
+        {
+            throw std::runtime_error("src.shape[i] != inv_rms.shape[i]");
+        }
+        if(src.basetile_shape[i] != inv_rms.basetile_shape[i])
+        {
+            throw std::runtime_error("src.basetile_shape[i] != "
+                    "inv_rms.basetile_shape[i]");
+        }
+    }
+    for(Index i = axis+1; i < ndim; i++)
+    {
+        if(src.shape[i] != inv_rms.shape[i-1])
+        {
+            throw std::runtime_error("src.shape[i] != inv_rms.shape[i-1]");
+        }
+        if(src.basetile_shape[i] != inv_rms.basetile_shape[i-1])
+        {
+            throw std::runtime_error("src.basetile_shape[i] != "
+                    "inv_rms.basetile_shape[i-1]");
+        }
+    }
+    if(src.basetile_shape[axis] != src.shape[axis])
+    {
+        throw std::runtime_error("src.basetile_shape[axis] != "
+                "src.shape[axis]");
+    }
+    if(src.shape[axis] != gamma.shape[0])
+    {
+        throw std::runtime_error("src.shape[axis] != gamma.shape[0]");
+    }
+    if(gamma.basetile_shape[0] != gamma.shape[0])
+    {
+        throw std::runtime_error("gamma.basetile_shape[0] != "
+                "gamma.shape[0]");
+    }
+    // Do actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    const auto &gamma_tile_handle = gamma.get_tile_handle(0);
+    std::vector<Index> inv_rms_tile_index;
+    for(Index i = 0; i < inv_rms.grid.nelems; ++i)
+    {
+        const auto &inv_rms_tile_handle = inv_rms.get_tile_handle(i);
+        // Obtain index of the only corresponding source tile
+        inv_rms.grid.linear_to_index(i, inv_rms_tile_index);
+        std::vector<Index> src_tile_index(ndim);
+        for(Index j = 0, k = 0; j < ndim; ++j)
+        {
+            if(j == axis)
+            {
+                src_tile_index[axis] = 0;
+                continue;
+            }
+            src_tile_index[j] = inv_rms_tile_index[k];
+            ++k;
+        }
+        Index src_tile_offset = src.grid.index_to_linear(src_tile_index);
+        const auto &src_tile_handle = src.get_tile_handle(src_tile_offset);
+        const auto &dst_tile_handle = dst.get_tile_handle(src_tile_offset);
+        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+        // All the outputs are computed by a single task
+        if(inv_rms_tile_handle.mpi_get_rank() != dst_tile_rank)
+        {
+            throw std::runtime_error("Tiles of inv_rms and dst are owned by "
+                    "different nodes");
+        }
+        // Transfer data
+        src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        gamma_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == dst_tile_rank)
+        {
+            // Get sizes
+            const auto &src_tile_traits = src.get_tile_traits(src_tile_offset);
+            Index m, n, k;
+            m = src_tile_traits.stride[axis];
+            n = src_tile_traits.matrix_shape[axis+1][1];
+            k = src_tile_traits.shape[axis];
+            // Insert task
+            starpu::rms_norm::submit<T>(m, n, k, eps, src_tile_handle,
+                    gamma_tile_handle, inv_rms_tile_handle, dst_tile_handle);
+        }
+        // Flush cache for the output tiles on every node
+        inv_rms_tile_handle.mpi_flush();
+        dst_tile_handle.mpi_flush();
+    }
+}
+
+template<typename T>
+void rms_norm(T eps, const Tensor<T> &src, const Tensor<T> &gamma,
+        const Tensor<T> &inv_rms, const Tensor<T> &dst, Index axis)
+{
+    rms_norm_async<T>(eps, src, gamma, inv_rms, dst, axis);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void rms_norm_async<fp32_t>(fp32_t eps, const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &gamma, const Tensor<fp32_t> &inv_rms,
+        const Tensor<fp32_t> &dst, Index axis);
+
+template
+void rms_norm_async<fp64_t>(fp64_t eps, const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &gamma, const Tensor<fp64_t> &inv_rms,
+        const Tensor<fp64_t> &dst, Index axis);
+
+// Explicit instantiation
+template
+void rms_norm<fp32_t>(fp32_t eps, const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &gamma, const Tensor<fp32_t> &inv_rms,
+        const Tensor<fp32_t> &dst, Index axis);
+
+template
+void rms_norm<fp64_t>(fp64_t eps, const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &gamma, const Tensor<fp64_t> &inv_rms,
+        const Tensor<fp64_t> &dst, Index axis);
+
+} // namespace tensor
+} // namespace nntile
+
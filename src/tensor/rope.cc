@@ -0,0 +1,153 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/rope.cc
+ * Rotary position embedding of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/rope.hh"
+#include "nntile/starpu/rope.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Submit rotations of all the tiles by the owners of tiles
+template<typename T>
+static
+void rope_submit(T base, Index position, bool inverse, const Tensor<T> &x)
+{
+    // Check dimensions and shapes
+    if(x.ndim < 2)
+    {
+        throw std::runtime_error("x.ndim < 2");
+    }
+    if(x.shape[0] % 2 != 0)
+    {
+        throw std::runtime_error("x.shape[0] % 2 != 0");
+    }
+    if(x.basetile_shape[0] % 2 != 0)
+    {
+        throw std::runtime_error("x.basetile_shape[0] % 2 != 0");
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    std::vector<Index> tile_index;
+    for(Index i = 0; i < x.grid.nelems; ++i)
+    {
+        auto tile_handle = x.get_tile_handle(i);
+        int tile_rank = tile_handle.mpi_get_rank();
+        // Execute only on the owner of the tile
+        if(mpi_rank == tile_rank)
+        {
+            x.grid.linear_to_index(i, tile_index);
+            const auto &tile_traits = x.get_tile_traits(i);
+            Index m = tile_traits.shape[0], n = tile_traits.shape[1];
+            Index k = tile_traits.nelems / (m*n);
+            Index offset_m = tile_index[0] * x.basetile_shape[0];
+            Index offset_n = position + tile_index[1]*x.basetile_shape[1];
+            starpu::rope::submit<T>(m, n, k, x.shape[0], offset_m, offset_n,
+                    base, inverse, tile_handle);
+        }
+        // Flush cache for the output tile on every node
+        tile_handle.mpi_flush();
+    }
+}
+
+//! Asynchronous in-place rotary position embedding
+/*! Rotates pairs of consecutive elements along the first axis of x, that is
+ * a concatenation of heads of size x.shape[0], by angles, that are
+ * proportional to positions along the second axis. The remaining axes, e.g.
+ * batch and heads, are independent. No additional tensors are allocated.
+ *
+ * @param[in] base: Base of frequencies, e.g. 10000
+ * @param[in] position: Position of the first element along the second axis
+ * @param[inout] x: Tensor of queries or keys of shape [head_size, n_seq,
+ *      ...] with even head_size and even tiles along the first axis
+ * */
+template<typename T>
+void rope_async(T base, Index position, const Tensor<T> &x)
+{
+    rope_submit<T>(base, position, false, x);
+}
+
+//! Blocking version of in-place rotary position embedding
+/*! @param[in] base: Base of frequencies, e.g. 10000
+ * @param[in] position: Position of the first element along the second axis
+ * @param[inout] x: Tensor of queries or keys
+ * */
+template<typename T>
+void rope(T base, Index position, const Tensor<T> &x)
+{
+    rope_async<T>(base, position, x);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+//! Asynchronous backward of in-place rotary position embedding
+/*! Rotations are orthogonal, so gradient over the input is the gradient over
+ * the output, rotated by the negated angles.
+ *
+ * @param[in] base: Base of frequencies, the same as for rope_async
+ * @param[in] position: Position of the first element along the second axis
+ * @param[inout] dx: Gradient over the output, that turns into the gradient
+ *      over the input
+ * */
+template<typename T>
+void rope_backward_async(T base, Index position, const Tensor<T> &dx)
+{
+    rope_submit<T>(base, position, true, dx);
+}
+
+//! Blocking version of backward of in-place rotary position embedding
+/*! @param[in] base: Base of frequencies, the same as for rope
+ * @param[in] position: Position of the first element along the second axis
+ * @param[inout] dx: Gradient over the output and the input
+ * */
+template<typename T>
+void rope_backward(T base, Index position, const Tensor<T> &dx)
+{
+    rope_backward_async<T>(base, position, dx);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void rope_async<fp32_t>(fp32_t base, Index position, const Tensor<fp32_t> &x);
+
+template
+void rope_async<fp64_t>(fp64_t base, Index position, const Tensor<fp64_t> &x);
+
+template
+void rope<fp32_t>(fp32_t base, Index position, const Tensor<fp32_t> &x);
+
+template
+void rope<fp64_t>(fp64_t base, Index position, const Tensor<fp64_t> &x);
+
+template
+void rope_backward_async<fp32_t>(fp32_t base, Index position,
+        const Tensor<fp32_t> &dx);
+
+template
+void rope_backward_async<fp64_t>(fp64_t base, Index position,
+        const Tensor<fp64_t> &dx);
+
+template
+void rope_backward<fp32_t>(fp32_t base, Index position,
+        const Tensor<fp32_t> &dx);
+
+template
+void rope_backward<fp64_t>(fp64_t base, Index position,
+        const Tensor<fp64_t> &dx);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -28,8 +28,8 @@ void scal_inplace_async(T alpha, const Tensor<T> &data)
     int mpi_rank = starpu_mpi_world_rank();
     for(Index i = 0; i < data.grid.nelems; ++i)
     {
-        auto data_tile_handle = data.get_tile_handle(i);
-        auto data_tile_traits = data.get_tile_traits(i);
+        const auto &data_tile_handle = data.get_tile_handle(i);
+        const auto &data_tile_traits = data.get_tile_traits(i);
         int data_tile_rank = data_tile_handle.mpi_get_rank();
         // Execute on source tile
         if(mpi_rank == data_tile_rank)
@@ -44,13 +44,13 @@ void scatter_async(const Tensor<T> &src, const Tensor<T> &dst)
     }
     // Treat special case of a single destination tile
     int mpi_rank = starpu_mpi_world_rank();
-    auto src_tile_handle = src.get_tile_handle(0);
-    auto src_tile_traits = src.get_tile_traits(0);
+    const auto &src_tile_handle = src.get_tile_handle(0);
+    const auto &src_tile_traits = src.get_tile_traits(0);
     int src_tile_rank = src_tile_handle.mpi_get_rank();
     int ret;
     if(dst.grid.nelems == 1)
     {
-        auto dst_tile_handle = dst.get_tile_handle(0);
+        const auto &dst_tile_handle = dst.get_tile_handle(0);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Transfer source tile to dest node
         src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
@@ -74,14 +74,14 @@ void scatter_async(const Tensor<T> &src, const Tensor<T> &dst)
     std::vector<Index> dst_tile_index(ndim);
     for(Index i = 0; i < dst.grid.nelems; ++i)
     {
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Flush cache for the output tile on every node
         dst_tile_handle.mpi_flush();
         // Execute on source node and then send result
         if(mpi_rank == src_tile_rank)
         {
-            auto dst_tile_traits = dst.get_tile_traits(i);
+            const auto &dst_tile_traits = dst.get_tile_traits(i);
             for(Index k = 0; k < ndim; ++k)
             {
                 src_tile_start[k] = dst_tile_index[k] * dst.basetile_shape[k];
@@ -96,15 +96,17 @@ void scatter_async(const Tensor<T> &src, const Tensor<T> &dst)
             if(mpi_rank != dst_tile_rank)
             {
                 // No need to check for cached send, as output was just updated
-                //ret = starpu_mpi_isend_detached(
-                //        static_cast<starpu_data_handle_t>(dst_tile_handle),
-                //        dst_tile_rank, tile_tag, MPI_COMM_WORLD, nullptr,
-                //        nullptr);
-                //if(ret != 0)
-                //{
-                //    throw std::runtime_error("Error in starpu_mpi_isend_"
-                //            "detached");
-                //}
+#ifdef NNTILE_USE_MPI
+                ret = starpu_mpi_isend_detached(
+                        static_cast<starpu_data_handle_t>(dst_tile_handle),
+                        dst_tile_rank, tile_tag, MPI_COMM_WORLD, nullptr,
+                        nullptr);
+                if(ret != 0)
+                {
+                    throw std::runtime_error("Error in starpu_mpi_isend_"
+                            "detached");
+                }
+#endif // NNTILE_USE_MPI
             }
         }
         // Init receive of source tile for owner of destination tile
@@ -112,15 +114,17 @@ void scatter_async(const Tensor<T> &src, const Tensor<T> &dst)
         {
             auto tile_tag = dst_tile_handle.mpi_get_tag();
             // No need to check for cached recv, as output was just updated
-            //ret = starpu_mpi_irecv_detached(
-            //        static_cast<starpu_data_handle_t>(dst_tile_handle),
-            //        src_tile_rank, tile_tag, MPI_COMM_WORLD, nullptr,
-            //        nullptr);
-            //if(ret != 0)
-            //{
-            //    throw std::runtime_error("Error in starpu_mpi_irecv_"
-            //            "detached");
-            //}
+#ifdef NNTILE_USE_MPI
+            ret = starpu_mpi_irecv_detached(
+                    static_cast<starpu_data_handle_t>(dst_tile_handle),
+                    src_tile_rank, tile_tag, MPI_COMM_WORLD, nullptr,
+                    nullptr);
+            if(ret != 0)
+            {
+                throw std::runtime_error("Error in starpu_mpi_irecv_"
+                        "detached");
+            }
+#endif // NNTILE_USE_MPI
         }
         // Get out if it was the last tile
         if(i == dst.grid.nelems-1)
@@ -159,6 +163,10 @@ template
 void scatter_async<fp16_t>(const Tensor<fp16_t> &src,
         const Tensor<fp16_t> &dst);
 
+template
+void scatter_async<bf16_t>(const Tensor<bf16_t> &src,
+        const Tensor<bf16_t> &dst);
+
 template
 void scatter_async<fp32_t>(const Tensor<fp32_t> &src,
         const Tensor<fp32_t> &dst);
@@ -175,10 +183,21 @@ template
 void scatter_async<bool_t>(const Tensor<bool_t> &src,
         const Tensor<bool_t> &dst);
 
+template
+void scatter_async<std::int8_t>(const Tensor<std::int8_t> &src,
+        const Tensor<std::int8_t> &dst);
+
+template
+void scatter_async<fp8_e4m3_t>(const Tensor<fp8_e4m3_t> &src,
+        const Tensor<fp8_e4m3_t> &dst);
+
 // Explicit instantiation
 template
 void scatter<fp16_t>(const Tensor<fp16_t> &src, const Tensor<fp16_t> &dst);
 
+template
+void scatter<bf16_t>(const Tensor<bf16_t> &src, const Tensor<bf16_t> &dst);
+
 template
 void scatter<fp32_t>(const Tensor<fp32_t> &src, const Tensor<fp32_t> &dst);
 
@@ -191,6 +210,14 @@ void scatter<Index>(const Tensor<Index> &src, const Tensor<Index> &dst);
 template
 void scatter<bool_t>(const Tensor<bool_t> &src, const Tensor<bool_t> &dst);
 
+template
+void scatter<std::int8_t>(const Tensor<std::int8_t> &src,
+        const Tensor<std::int8_t> &dst);
+
+template
+void scatter<fp8_e4m3_t>(const Tensor<fp8_e4m3_t> &src,
+        const Tensor<fp8_e4m3_t> &dst);
+
 } // namespace tensor
 } // namespace nntile
 
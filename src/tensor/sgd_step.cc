@@ -0,0 +1,133 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/sgd_step.cc
+ * Fused SGD step with momentum for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/sgd_step.hh"
+#include "nntile/starpu/sgd_step.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void sgd_step_async(Index num_iter, T momentum, T dampening, T lr,
+        T weight_decay, bool nesterov, const Tensor<T> &grad,
+        const Tensor<T> &velocity, const Tensor<T> &p)
+//! Asynchronous tensor-wise fused SGD step with momentum
+/*! Updates velocity and parameters by a single task per tile (see
+ * kernel::sgd_step), while gradients are left unchanged.
+ *
+ * @param[in] num_iter: Current iteration number, starting from 1. Velocity
+ *      is initialized by gradients at the first iteration.
+ * @param[in] momentum: Momentum factor, velocity is not used if it is zero
+ * @param[in] dampening: Dampening of gradients in velocity
+ * @param[in] lr: Learning rate
+ * @param[in] weight_decay: Coefficient of l2 regularizer
+ * @param[in] nesterov: Whether to use Nesterov momentum
+ * @param[in] grad: Gradient of parameters
+ * @param[inout] velocity: Velocity of parameters
+ * @param[inout] p: Parameters
+ * */
+{
+    // Check shapes
+    if(p.shape != grad.shape or p.basetile_shape != grad.basetile_shape)
+    {
+        throw std::runtime_error("Parameter shape is not equal to gradient "
+                "shape");
+    }
+    if(momentum != T(0) and (p.shape != velocity.shape
+                or p.basetile_shape != velocity.basetile_shape))
+    {
+        throw std::runtime_error("Parameter shape is not equal to velocity "
+                "shape");
+    }
+    if(num_iter < 1)
+    {
+        throw std::runtime_error("num_iter < 1");
+    }
+    // Actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < p.grid.nelems; ++i)
+    {
+        // Get handles of corresponding tiles
+        const auto &p_tile_handle = p.get_tile_handle(i);
+        const auto &grad_tile_handle = grad.get_tile_handle(i);
+        // MPI rank of the destination tile
+        int p_tile_rank = p_tile_handle.mpi_get_rank();
+        // Transfer data
+        grad_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        starpu::HandleRef velocity_tile_handle;
+        if(momentum != T(0))
+        {
+            velocity_tile_handle = velocity.get_tile_handle(i);
+            velocity_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        }
+        // Execute only on destination node
+        if(mpi_rank == p_tile_rank)
+        {
+            const auto &traits = p.get_tile_traits(i);
+            starpu::sgd_step::submit<T>(num_iter, traits.nelems, momentum,
+                    dampening, lr, weight_decay, nesterov, grad_tile_handle,
+                    velocity_tile_handle, p_tile_handle);
+        }
+        // Flush cache for the output tiles on every node
+        p_tile_handle.mpi_flush();
+        if(momentum != T(0))
+        {
+            velocity_tile_handle.mpi_flush();
+        }
+    }
+}
+
+template<typename T>
+void sgd_step(Index num_iter, T momentum, T dampening, T lr, T weight_decay,
+        bool nesterov, const Tensor<T> &grad, const Tensor<T> &velocity,
+        const Tensor<T> &p)
+//! Blocking version of tensor-wise fused SGD step with momentum
+{
+    sgd_step_async<T>(num_iter, momentum, dampening, lr, weight_decay,
+            nesterov, grad, velocity, p);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void sgd_step_async<fp32_t>(Index num_iter, fp32_t momentum,
+        fp32_t dampening, fp32_t lr, fp32_t weight_decay, bool nesterov,
+        const Tensor<fp32_t> &grad, const Tensor<fp32_t> &velocity,
+        const Tensor<fp32_t> &p);
+
+template
+void sgd_step_async<fp64_t>(Index num_iter, fp64_t momentum,
+        fp64_t dampening, fp64_t lr, fp64_t weight_decay, bool nesterov,
+        const Tensor<fp64_t> &grad, const Tensor<fp64_t> &velocity,
+        const Tensor<fp64_t> &p);
+
+// Explicit instantiation
+template
+void sgd_step<fp32_t>(Index num_iter, fp32_t momentum, fp32_t dampening,
+        fp32_t lr, fp32_t weight_decay, bool nesterov,
+        const Tensor<fp32_t> &grad, const Tensor<fp32_t> &velocity,
+        const Tensor<fp32_t> &p);
+
+template
+void sgd_step<fp64_t>(Index num_iter, fp64_t momentum, fp64_t dampening,
+        fp64_t lr, fp64_t weight_decay, bool nesterov,
+        const Tensor<fp64_t> &grad, const Tensor<fp64_t> &velocity,
+        const Tensor<fp64_t> &p);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -93,14 +93,15 @@ void softmax_async(const Tensor<T> &maxsumexp, const Tensor<T> &src,
     int mpi_size = starpu_mpi_world_size();
     int ret;
     // Apply per-tile softmax asynchronously as needed
+    std::vector<Index> maxsumexp_tile_index;
     for(Index i = 0; i < maxsumexp.grid.nelems; ++i)
     {
         // Index of current source tile
-        auto maxsumexp_tile_index = maxsumexp.grid.linear_to_index(i);
+        maxsumexp.grid.linear_to_index(i, maxsumexp_tile_index);
         // Source tile traits
-        auto maxsumexp_tile_traits = maxsumexp.get_tile_traits(i);
+        const auto &maxsumexp_tile_traits = maxsumexp.get_tile_traits(i);
         // Source tile handle
-        auto maxsumexp_tile_handle = maxsumexp.get_tile_handle(i);
+        const auto &maxsumexp_tile_handle = maxsumexp.get_tile_handle(i);
         // Set fixed indices of current destination tile
         std::vector<Index> dst_tile_index(dst.ndim);
         for(Index j = 0; j < axis; ++j)
@@ -119,9 +120,9 @@ void softmax_async(const Tensor<T> &maxsumexp, const Tensor<T> &src,
             // Get linear offset from index
             Index dst_tile_offset = dst.grid.index_to_linear(dst_tile_index);
             // Get destination tile handle
-            auto dst_tile_handle = dst.get_tile_handle(dst_tile_offset);
+            const auto &dst_tile_handle = dst.get_tile_handle(dst_tile_offset);
             // Get source tile handle
-            auto src_tile_handle = src.get_tile_handle(dst_tile_offset);
+            const auto &src_tile_handle = src.get_tile_handle(dst_tile_offset);
             // MPI rank of the destination tile
             int dst_tile_rank = dst_tile_handle.mpi_get_rank();
             // Transfer data
@@ -131,7 +132,8 @@ void softmax_async(const Tensor<T> &maxsumexp, const Tensor<T> &src,
             if(mpi_rank == dst_tile_rank)
             {
                 // Get destination tile traits
-                auto dst_tile_traits = dst.get_tile_traits(dst_tile_offset);
+                const auto &dst_tile_traits =
+                    dst.get_tile_traits(dst_tile_offset);
                 // Reshape inputs for simplicity:
                 //      maxsumexp -> (2,m,n), dst -> (m,k,n)
                 Index m, n, k;
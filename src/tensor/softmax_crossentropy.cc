@@ -0,0 +1,187 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/softmax_crossentropy.cc
+ * Fused loss and gradient of softmax cross-entropy for tensors
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-14
+ * */
+
+#include "nntile/tensor/softmax_crossentropy.hh"
+#include "nntile/starpu/softmax_crossentropy.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void softmax_crossentropy_async(T scale, const Tensor<T> &maxsumexp,
+        const Tensor<T> &src, const Tensor<Index> &labels,
+        const Tensor<T> &dst, const Tensor<T> &val, Index label_offset)
+//! Asynchronous fused loss and gradient of softmax cross-entropy
+/*! Replaces logsumexp, total_sum_accum, softmax and subtract_indexed_outputs
+ * by a single pass over logits, that follows the maxsumexp pass. Logits may
+ * be tiled along the first (vocabulary) axis, so that each task processes
+ * only a chunk of the vocabulary.
+ *
+ * @param[in] scale: Scalar multiplier of the loss and the gradient
+ * @param[in] maxsumexp: Maximums and sums of exponents of logits along the
+ *      first axis
+ * @param[in] src: Logits
+ * @param[in] labels: Correct labels
+ * @param[out] dst: Gradient of the loss with respect to logits
+ * @param[inout] val: Scalar that accumulates the loss. It shall belong to
+ *      the same MPI rank as all tiles of dst.
+ * @param[in] label_offset: Label of the first row of src. It is non-zero
+ *      when src holds only a chunk of the vocabulary, in which case dst is
+ *      the gradient of the loss only for this chunk, while maxsumexp shall
+ *      be accumulated over the entire vocabulary.
+ * */
+{
+    // Check dimensions
+    if(src.ndim != labels.ndim+1)
+    {
+        throw std::runtime_error("src.ndim != labels.ndim+1");
+    }
+    if(src.ndim != maxsumexp.ndim)
+    {
+        throw std::runtime_error("src.ndim != maxsumexp.ndim");
+    }
+    if(val.ndim != 0)
+    {
+        throw std::runtime_error("val.ndim != 0");
+    }
+    // Check shapes
+    if(src.shape != dst.shape)
+    {
+        throw std::runtime_error("src.shape != dst.shape");
+    }
+    if(src.basetile_shape != dst.basetile_shape)
+    {
+        throw std::runtime_error("src.basetile_shape != dst.basetile_shape");
+    }
+    if(maxsumexp.shape[0] != 2)
+    {
+        throw std::runtime_error("maxsumexp.shape[0] != 2");
+    }
+    if(maxsumexp.basetile_shape[0] != 2)
+    {
+        throw std::runtime_error("maxsumexp.basetile_shape[0] != 2");
+    }
+    for(Index i = 0; i < labels.ndim; ++i)
+    {
+        if(labels.shape[i] != src.shape[i+1])
+        {
+            throw std::runtime_error("labels.shape[i] != src.shape[i+1]");
+        }
+        if(labels.basetile_shape[i] != src.basetile_shape[i+1])
+        {
+            throw std::runtime_error("labels.basetile_shape[i] != "
+                    "src.basetile_shape[i+1]");
+        }
+        if(maxsumexp.shape[i+1] != src.shape[i+1])
+        {
+            throw std::runtime_error("maxsumexp.shape[i+1] != "
+                    "src.shape[i+1]");
+        }
+        if(maxsumexp.basetile_shape[i+1] != src.basetile_shape[i+1])
+        {
+            throw std::runtime_error("maxsumexp.basetile_shape[i+1] != "
+                    "src.basetile_shape[i+1]");
+        }
+    }
+    // Do actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    const auto &val_tile_handle = val.get_tile_handle(0);
+    int val_tile_rank = val_tile_handle.mpi_get_rank();
+    std::vector<Index> dst_tile_index;
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
+        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+        if(dst_tile_rank != val_tile_rank)
+        {
+            throw std::runtime_error("Tiles of dst and val shall belong to "
+                    "the same MPI rank");
+        }
+        dst.grid.linear_to_index(i, dst_tile_index);
+        const auto &dst_tile_traits = dst.get_tile_traits(i);
+        // Corresponding tiles of labels and maxsumexp
+        std::vector<Index> labels_tile_index(dst_tile_index.cbegin()+1,
+                dst_tile_index.cend());
+        const auto &labels_tile_handle =
+                labels.get_tile_handle(labels_tile_index);
+        std::vector<Index> maxsumexp_tile_index(dst_tile_index);
+        maxsumexp_tile_index[0] = 0;
+        const auto &maxsumexp_tile_handle = maxsumexp.get_tile_handle(
+                maxsumexp_tile_index);
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        // Transfer data
+        maxsumexp_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        labels_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == dst_tile_rank)
+        {
+            Index n_labels = dst_tile_traits.shape[0];
+            Index n_outputs = dst_tile_traits.nelems / n_labels;
+            Index label_start = label_offset
+                + dst_tile_index[0]*dst.basetile_shape[0];
+            starpu::softmax_crossentropy::submit<T>(n_labels, n_outputs,
+                    label_start, scale, maxsumexp_tile_handle,
+                    src_tile_handle, labels_tile_handle, dst_tile_handle,
+                    val_tile_handle);
+        }
+        // Flush cache for the output tile on every node
+        dst_tile_handle.mpi_flush();
+    }
+    val_tile_handle.mpi_flush();
+}
+
+template<typename T>
+void softmax_crossentropy(T scale, const Tensor<T> &maxsumexp,
+        const Tensor<T> &src, const Tensor<Index> &labels,
+        const Tensor<T> &dst, const Tensor<T> &val, Index label_offset)
+//! Blocking fused loss and gradient of softmax cross-entropy
+{
+    softmax_crossentropy_async<T>(scale, maxsumexp, src, labels, dst, val,
+            label_offset);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void softmax_crossentropy_async<fp32_t>(fp32_t scale,
+        const Tensor<fp32_t> &maxsumexp, const Tensor<fp32_t> &src,
+        const Tensor<Index> &labels, const Tensor<fp32_t> &dst,
+        const Tensor<fp32_t> &val, Index label_offset);
+
+template
+void softmax_crossentropy_async<fp64_t>(fp64_t scale,
+        const Tensor<fp64_t> &maxsumexp, const Tensor<fp64_t> &src,
+        const Tensor<Index> &labels, const Tensor<fp64_t> &dst,
+        const Tensor<fp64_t> &val, Index label_offset);
+
+// Explicit instantiation
+template
+void softmax_crossentropy<fp32_t>(fp32_t scale,
+        const Tensor<fp32_t> &maxsumexp, const Tensor<fp32_t> &src,
+        const Tensor<Index> &labels, const Tensor<fp32_t> &dst,
+        const Tensor<fp32_t> &val, Index label_offset);
+
+template
+void softmax_crossentropy<fp64_t>(fp64_t scale,
+        const Tensor<fp64_t> &maxsumexp, const Tensor<fp64_t> &src,
+        const Tensor<Index> &labels, const Tensor<fp64_t> &dst,
+        const Tensor<fp64_t> &val, Index label_offset);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -81,14 +81,15 @@ void softmax_inplace_async(const Tensor<T> &maxsumexp, T alpha,
     int mpi_size = starpu_mpi_world_size();
     int ret;
     // Apply per-tile softmax_inplace asynchronously as needed
+    std::vector<Index> maxsumexp_tile_index;
     for(Index i = 0; i < maxsumexp.grid.nelems; ++i)
     {
         // Index of current source tile
-        auto maxsumexp_tile_index = maxsumexp.grid.linear_to_index(i);
+        maxsumexp.grid.linear_to_index(i, maxsumexp_tile_index);
         // Source tile traits
-        auto maxsumexp_tile_traits = maxsumexp.get_tile_traits(i);
+        const auto &maxsumexp_tile_traits = maxsumexp.get_tile_traits(i);
         // Source tile handle
-        auto maxsumexp_tile_handle = maxsumexp.get_tile_handle(i);
+        const auto &maxsumexp_tile_handle = maxsumexp.get_tile_handle(i);
         // Set fixed indices of current destination tile
         std::vector<Index> dst_tile_index(dst.ndim);
         for(Index j = 0; j < axis; ++j)
@@ -107,7 +108,7 @@ void softmax_inplace_async(const Tensor<T> &maxsumexp, T alpha,
             // Get linear offset from index
             Index dst_tile_offset = dst.grid.index_to_linear(dst_tile_index);
             // Get destination tile handle
-            auto dst_tile_handle = dst.get_tile_handle(dst_tile_offset);
+            const auto &dst_tile_handle = dst.get_tile_handle(dst_tile_offset);
             // MPI rank of the destination tile
             int dst_tile_rank = dst_tile_handle.mpi_get_rank();
             // Transfer data
@@ -116,7 +117,8 @@ void softmax_inplace_async(const Tensor<T> &maxsumexp, T alpha,
             if(mpi_rank == dst_tile_rank)
             {
                 // Get destination tile traits
-                auto dst_tile_traits = dst.get_tile_traits(dst_tile_offset);
+                const auto &dst_tile_traits =
+                    dst.get_tile_traits(dst_tile_offset);
                 // Reshape inputs for simplicity:
                 //      maxsumexp -> (2,m,n), dst -> (m,k,n)
                 Index m, n, k;
@@ -168,6 +170,14 @@ template
 void softmax_inplace_async<fp64_t>(const Tensor<fp64_t> &maxsumexp,
         fp64_t alpha, const Tensor<fp64_t> &dst, Index axis);
 
+template
+void softmax_inplace_async<bf16_t>(const Tensor<bf16_t> &maxsumexp,
+        bf16_t alpha, const Tensor<bf16_t> &dst, Index axis);
+
+template
+void softmax_inplace_async<fp16_t>(const Tensor<fp16_t> &maxsumexp,
+        fp16_t alpha, const Tensor<fp16_t> &dst, Index axis);
+
 // Explicit instantiation
 template
 void softmax_inplace<fp32_t>(const Tensor<fp32_t> &maxsumexp, fp32_t alpha,
@@ -177,6 +187,14 @@ template
 void softmax_inplace<fp64_t>(const Tensor<fp64_t> &maxsumexp, fp64_t alpha,
         const Tensor<fp64_t> &dst, Index axis);
 
+template
+void softmax_inplace<bf16_t>(const Tensor<bf16_t> &maxsumexp, bf16_t alpha,
+        const Tensor<bf16_t> &dst, Index axis);
+
+template
+void softmax_inplace<fp16_t>(const Tensor<fp16_t> &maxsumexp, fp16_t alpha,
+        const Tensor<fp16_t> &dst, Index axis);
+
 } // namespace tensor
 } // namespace nntile
 
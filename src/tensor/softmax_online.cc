@@ -0,0 +1,125 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/softmax_online.cc
+ * Online softmax along an axis of a tensor
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/softmax_online.hh"
+#include "nntile/starpu/softmax_online.hh"
+#include "nntile/kernel/softmax_online.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous online softmax along an axis
+/*! All the tiles along the axis are updated inplace by a single task, that
+ * computes max and sum of exponents by a single pass over the tiles:
+ * dst = alpha * exp(dst-max) / sum. It replaces a pair of maxsumexp and
+ * softmax_inplace operations with no intermediate tensor. Tiles along the
+ * axis shall belong to the same MPI node and their number shall not exceed
+ * kernel::softmax_online::MAX_TILES.
+ *
+ * @param[in] alpha: Scalar multiplier for the output
+ * @param[inout] dst: Input and output of softmax
+ * @param[in] axis: Axis of softmax
+ * */
+template<typename T>
+void softmax_online_async(T alpha, const Tensor<T> &dst, Index axis)
+{
+    // Check axis
+    if(axis < 0)
+    {
+        throw std::runtime_error("axis < 0");
+    }
+    if(axis >= dst.ndim)
+    {
+        throw std::runtime_error("axis >= dst.ndim");
+    }
+    if(dst.grid.shape[axis] > kernel::softmax_online::MAX_TILES)
+    {
+        throw std::runtime_error("dst.grid.shape[axis] > "
+                "kernel::softmax_online::MAX_TILES");
+    }
+    // Prepare
+    int mpi_rank = starpu_mpi_world_rank();
+    // Loop through the first tiles along the axis
+    std::vector<Index> dst_tile_index;
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        dst.grid.linear_to_index(i, dst_tile_index);
+        if(dst_tile_index[axis] != 0)
+        {
+            continue;
+        }
+        const auto &dst_tile_traits = dst.get_tile_traits(i);
+        int dst_tile_rank = dst.get_tile_handle(i).mpi_get_rank();
+        // Gather handles of all the tiles along the axis
+        std::vector<starpu::Handle> dst_tile_handles;
+        for(Index j = 0; j < dst.grid.shape[axis]; ++j)
+        {
+            dst_tile_index[axis] = j;
+            Index dst_tile_offset = dst.grid.index_to_linear(dst_tile_index);
+            auto dst_tile_handle = dst.get_tile_handle(dst_tile_offset);
+            if(dst_tile_handle.mpi_get_rank() != dst_tile_rank)
+            {
+                throw std::runtime_error("Tiles along the axis belong to "
+                        "different MPI nodes");
+            }
+            dst_tile_handles.push_back(dst_tile_handle);
+        }
+        // Execute on destination node
+        if(mpi_rank == dst_tile_rank)
+        {
+            // Reshape tiles for simplicity: dst -> (m,k,n)
+            Index m = dst_tile_traits.stride[axis];
+            Index n = dst_tile_traits.matrix_shape[axis+1][1];
+            starpu::softmax_online::submit<T>(m, n, alpha, dst_tile_handles);
+        }
+        // Flush cache for the output tiles on every node
+        for(auto &dst_tile_handle: dst_tile_handles)
+        {
+            dst_tile_handle.mpi_flush();
+        }
+    }
+}
+
+//! Blocking version of online softmax along an axis
+template<typename T>
+void softmax_online(T alpha, const Tensor<T> &dst, Index axis)
+{
+    softmax_online_async<T>(alpha, dst, axis);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void softmax_online_async<fp32_t>(fp32_t alpha, const Tensor<fp32_t> &dst,
+        Index axis);
+
+template
+void softmax_online_async<fp64_t>(fp64_t alpha, const Tensor<fp64_t> &dst,
+        Index axis);
+
+// Explicit instantiation
+template
+void softmax_online<fp32_t>(fp32_t alpha, const Tensor<fp32_t> &dst,
+        Index axis);
+
+template
+void softmax_online<fp64_t>(fp64_t alpha, const Tensor<fp64_t> &dst,
+        Index axis);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,184 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/sparse_adam_step.cc
+ * Fused Adam step on marked columns of tensors
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-13
+ * */
+
+#include "nntile/tensor/sparse_adam_step.hh"
+#include "nntile/starpu/sparse_adam_step.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void sparse_adam_step_async(T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        const Tensor<bool_t> &cols, const Tensor<Index> &cols_iter,
+        const Tensor<T> &grad, const Tensor<T> &first_moment,
+        const Tensor<T> &second_moment, const Tensor<T> &p)
+//! Asynchronous tensor-wise sparse Adam step
+/*! Updates only columns of parameters p, that are marked by cols, with
+ * their own bias corrections (see kernel::sparse_adam_step). It is meant
+ * for a vocabulary of embeddings, that is tiled only along the first
+ * dimension, while cols is a mask of used tokens (see embedding_rows).
+ *
+ * @param[in] cols: Mask of columns to be updated, a single tile
+ * @param[inout] cols_iter: Numbers of steps done for each column of each
+ *      tile of p. Its shape is (p.grid.shape[0], p.shape[1]), and each its
+ *      tile corresponds to a tile of p.
+ * @param[in] grad: Gradient of parameters
+ * @param[inout] first_moment: First moments of parameters
+ * @param[inout] second_moment: Square roots of second moments of parameters
+ * @param[inout] p: Parameters
+ * */
+{
+    // Check dimensions
+    if(p.ndim != 2)
+    {
+        throw std::runtime_error("p.ndim != 2");
+    }
+    if(cols.ndim != 1)
+    {
+        throw std::runtime_error("cols.ndim != 1");
+    }
+    if(cols_iter.ndim != 2)
+    {
+        throw std::runtime_error("cols_iter.ndim != 2");
+    }
+    // Check shapes
+    if(p.shape != grad.shape or p.basetile_shape != grad.basetile_shape)
+    {
+        throw std::runtime_error("Parameter shape is not equal to gradient "
+                "shape");
+    }
+    if(p.shape != first_moment.shape
+            or p.basetile_shape != first_moment.basetile_shape)
+    {
+        throw std::runtime_error("Parameter shape is not equal to "
+                "first_moment shape");
+    }
+    if(p.shape != second_moment.shape
+            or p.basetile_shape != second_moment.basetile_shape)
+    {
+        throw std::runtime_error("Parameter shape is not equal to "
+                "second_moment shape");
+    }
+    if(p.basetile_shape[1] != p.shape[1])
+    {
+        throw std::runtime_error("p.basetile_shape[1] != p.shape[1]");
+    }
+    if(cols.shape[0] != p.shape[1])
+    {
+        throw std::runtime_error("cols.shape[0] != p.shape[1]");
+    }
+    if(cols.grid.nelems != 1)
+    {
+        throw std::runtime_error("cols.grid.nelems != 1");
+    }
+    if(cols_iter.shape[0] != p.grid.shape[0])
+    {
+        throw std::runtime_error("cols_iter.shape[0] != p.grid.shape[0]");
+    }
+    if(cols_iter.shape[1] != p.shape[1])
+    {
+        throw std::runtime_error("cols_iter.shape[1] != p.shape[1]");
+    }
+    if(cols_iter.basetile_shape[0] != 1)
+    {
+        throw std::runtime_error("cols_iter.basetile_shape[0] != 1");
+    }
+    if(cols_iter.basetile_shape[1] != p.shape[1])
+    {
+        throw std::runtime_error("cols_iter.basetile_shape[1] != p.shape[1]");
+    }
+    // Actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    const auto &cols_tile_handle = cols.get_tile_handle(0);
+    for(Index i = 0; i < p.grid.nelems; ++i)
+    {
+        // Get handles of corresponding tiles
+        const auto &p_tile_handle = p.get_tile_handle(i);
+        const auto &grad_tile_handle = grad.get_tile_handle(i);
+        const auto &first_moment_tile_handle = first_moment.get_tile_handle(i);
+        const auto &second_moment_tile_handle =
+                second_moment.get_tile_handle(i);
+        const auto &cols_iter_tile_handle = cols_iter.get_tile_handle(i);
+        // MPI rank of the destination tile
+        int p_tile_rank = p_tile_handle.mpi_get_rank();
+        // Transfer data
+        cols_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        cols_iter_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        grad_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        first_moment_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        second_moment_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        // Execute only on destination node
+        if(mpi_rank == p_tile_rank)
+        {
+            const auto &traits = p.get_tile_traits(i);
+            starpu::sparse_adam_step::submit<T>(traits.shape[0],
+                    traits.shape[1], beta_1, beta_2, eps, lr, weight_decay,
+                    cols_tile_handle, cols_iter_tile_handle,
+                    grad_tile_handle, first_moment_tile_handle,
+                    second_moment_tile_handle, p_tile_handle);
+        }
+        // Flush cache for the output tiles on every node
+        p_tile_handle.mpi_flush();
+        cols_iter_tile_handle.mpi_flush();
+    }
+}
+
+template<typename T>
+void sparse_adam_step(T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        const Tensor<bool_t> &cols, const Tensor<Index> &cols_iter,
+        const Tensor<T> &grad, const Tensor<T> &first_moment,
+        const Tensor<T> &second_moment, const Tensor<T> &p)
+//! Blocking version of tensor-wise sparse Adam step
+{
+    sparse_adam_step_async<T>(beta_1, beta_2, eps, lr, weight_decay, cols,
+            cols_iter, grad, first_moment, second_moment, p);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void sparse_adam_step_async<fp32_t>(fp32_t beta_1, fp32_t beta_2, fp32_t eps,
+        fp32_t lr, fp32_t weight_decay, const Tensor<bool_t> &cols,
+        const Tensor<Index> &cols_iter, const Tensor<fp32_t> &grad,
+        const Tensor<fp32_t> &first_moment,
+        const Tensor<fp32_t> &second_moment, const Tensor<fp32_t> &p);
+
+template
+void sparse_adam_step_async<fp64_t>(fp64_t beta_1, fp64_t beta_2, fp64_t eps,
+        fp64_t lr, fp64_t weight_decay, const Tensor<bool_t> &cols,
+        const Tensor<Index> &cols_iter, const Tensor<fp64_t> &grad,
+        const Tensor<fp64_t> &first_moment,
+        const Tensor<fp64_t> &second_moment, const Tensor<fp64_t> &p);
+
+// Explicit instantiation
+template
+void sparse_adam_step<fp32_t>(fp32_t beta_1, fp32_t beta_2, fp32_t eps,
+        fp32_t lr, fp32_t weight_decay, const Tensor<bool_t> &cols,
+        const Tensor<Index> &cols_iter, const Tensor<fp32_t> &grad,
+        const Tensor<fp32_t> &first_moment,
+        const Tensor<fp32_t> &second_moment, const Tensor<fp32_t> &p);
+
+template
+void sparse_adam_step<fp64_t>(fp64_t beta_1, fp64_t beta_2, fp64_t eps,
+        fp64_t lr, fp64_t weight_decay, const Tensor<bool_t> &cols,
+        const Tensor<Index> &cols_iter, const Tensor<fp64_t> &grad,
+        const Tensor<fp64_t> &first_moment,
+        const Tensor<fp64_t> &second_moment, const Tensor<fp64_t> &p);
+
+} // namespace tensor
+} // namespace nntile
+
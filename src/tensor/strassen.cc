@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/tensor/strassen.hh"
+#include "nntile/tensor/tree_reduction.hh"
 #include "nntile/starpu/add.hh"
 #include "nntile/starpu/gemm.hh"
 #include "nntile/starpu/scal.hh"
@@ -401,7 +402,7 @@ void _calculate_quater(
 
                 if(outside_i && Ij1 == 2 || outside_j && iJ1 == 2)
                 {
-                    auto tile_handle = A.get_tile_handle(0);
+                    const auto &tile_handle = A.get_tile_handle(0);
                     starpu::scal::submit<T>(tile_m * tile_k * tile_batch, zero,
                                             tile_handle, quater[b][i][j]);
                 }
@@ -411,7 +412,7 @@ void _calculate_quater(
                         base_A_tile_offset +
                         (Ij1 - 1) * opA_stride[0] * ((m + 1) / 2) +
                         (iJ1 - 1) * opA_stride[1] * ((k + 1) / 2);
-                    auto tile_handle = A.get_tile_handle(tile_offset);
+                    const auto &tile_handle = A.get_tile_handle(tile_offset);
 
                     // Execute
                     starpu::add::submit<T>(tile_m * tile_k * tile_batch, one,
@@ -425,7 +426,7 @@ void _calculate_quater(
                 Index tile_offset = base_A_tile_offset +
                                     (Ij2 - 1) * opA_stride[0] * ((m + 1) / 2) +
                                     (iJ2 - 1) * opA_stride[1] * ((k + 1) / 2);
-                auto tile_handle = A.get_tile_handle(tile_offset);
+                const auto &tile_handle = A.get_tile_handle(tile_offset);
                 starpu::add::submit<T>(tile_m * tile_k * tile_batch, w,
                                        tile_handle, one, quater[b][i][j]);
 
@@ -493,6 +494,8 @@ void strassen_async(T_scal alpha, const TransOp &transA, const Tensor<T> &A,
     // Check inputs (throw exception in case of an error)
     strassen_check(transA, A, transB, B, C, ndim, batch_ndim);
     // Sizes of A, B and C as simple matrices (grids of tiles) for strassen
+    // Deterministic mode replaces STARPU_REDUX by a sequential chain
+    redux = redux_mode(redux, false);
     int mpi_rank = starpu_mpi_world_rank();
     int ret;
     constexpr T one = 1.0, zero = 0.0;
@@ -522,14 +525,14 @@ void strassen_async(T_scal alpha, const TransOp &transA, const Tensor<T> &A,
         break;
     }
 
-    auto C_tile_traits = C.get_tile_traits(0);
+    const auto &C_tile_traits = C.get_tile_traits(0);
     // Getting sizes
     Index tile_m = C_tile_traits.matrix_shape[A.ndim - batch_ndim - ndim][0];
     Index tile_batch = C_tile_traits.matrix_shape[C.ndim - batch_ndim][1];
     Index tile_n =
         C_tile_traits.matrix_shape[A.ndim - batch_ndim - ndim][1] / tile_batch;
     Index tile_k;
-    auto A_first_tile_traits = A.get_tile_traits(0);
+    const auto &A_first_tile_traits = A.get_tile_traits(0);
     switch(transA.value)
     {
     case TransOp::NoTrans:
@@ -629,7 +632,8 @@ void strassen_async(T_scal alpha, const TransOp &transA, const Tensor<T> &A,
                 if(true)
                 {
                     Index C_tile_offset = base_C_tile_offset;
-                    auto C_tile_handle = C.get_tile_handle(C_tile_offset);
+                    const auto &C_tile_handle =
+                            C.get_tile_handle(C_tile_offset);
                     starpu::add::submit<T>(tile_n * tile_m * tile_batch, alpha,
                                            C_tmp[1][b][i][j], beta,
                                            C_tile_handle);
@@ -648,7 +652,8 @@ void strassen_async(T_scal alpha, const TransOp &transA, const Tensor<T> &A,
                 {
                     Index C_tile_offset =
                         base_C_tile_offset + ((n + 1) / 2) * m;
-                    auto C_tile_handle = C.get_tile_handle(C_tile_offset);
+                    const auto &C_tile_handle =
+                            C.get_tile_handle(C_tile_offset);
                     starpu::add::submit<T>(tile_n * tile_m * tile_batch, alpha,
                                            C_tmp[3][b][i][j], beta,
                                            C_tile_handle);
@@ -660,7 +665,8 @@ void strassen_async(T_scal alpha, const TransOp &transA, const Tensor<T> &A,
                 if(!outside_i)
                 {
                     Index C_tile_offset = base_C_tile_offset + ((m + 1) / 2);
-                    auto C_tile_handle = C.get_tile_handle(C_tile_offset);
+                    const auto &C_tile_handle =
+                            C.get_tile_handle(C_tile_offset);
                     starpu::add::submit<T>(tile_n * tile_m * tile_batch, alpha,
                                            C_tmp[2][b][i][j], beta,
                                            C_tile_handle);
@@ -673,7 +679,8 @@ void strassen_async(T_scal alpha, const TransOp &transA, const Tensor<T> &A,
                 {
                     Index C_tile_offset =
                         base_C_tile_offset + ((n + 1) / 2) * m + ((m + 1) / 2);
-                    auto C_tile_handle = C.get_tile_handle(C_tile_offset);
+                    const auto &C_tile_handle =
+                            C.get_tile_handle(C_tile_offset);
                     starpu::add::submit<T>(tile_n * tile_m * tile_batch, alpha,
                                            C_tmp[1][b][i][j], beta,
                                            C_tile_handle);
@@ -49,9 +49,9 @@ void subtract_indexed_outputs_async(T val, const Tensor<Index> &labels,
     int mpi_rank = starpu_mpi_world_rank();
     for(Index i = 0; i < dst.grid.nelems; ++i)
     {
-        auto labels_tile_handle = labels.get_tile_handle(i);
-        auto labels_traits = labels.get_tile_traits(i);
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &labels_tile_handle = labels.get_tile_handle(i);
+        const auto &labels_traits = labels.get_tile_traits(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Transfer data
         labels_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/tensor/sum_fiber.hh"
+#include "nntile/tensor/tree_reduction.hh"
 #include "nntile/starpu/sum_fiber.hh"
 
 namespace nntile
@@ -68,16 +69,19 @@ void sum_fiber_async(T alpha, const Tensor<T> &src, T beta,
         }
     }
     // Do actual calculations
+    // Deterministic mode replaces STARPU_REDUX by a sequential chain
+    redux = redux_mode(redux, false);
     int mpi_rank = starpu_mpi_world_rank();
     int ret;
     Index ndim = src.ndim;
     constexpr T one = 1.0;
+    std::vector<Index> src_tile_index;
     for(Index i = 0; i < src.grid.nelems; ++i)
     {
-        auto src_tile_handle = src.get_tile_handle(i);
-        auto src_tile_traits = src.get_tile_traits(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &src_tile_traits = src.get_tile_traits(i);
         int src_tile_rank = src_tile_handle.mpi_get_rank();
-        auto src_tile_index = src.grid.linear_to_index(i);
+        src.grid.linear_to_index(i, src_tile_index);
         // Get corresponding dst tile
         std::vector<Index> dst_tile_index(dst.ndim);
         dst_tile_index[0] = src_tile_index[axis];
@@ -85,8 +89,8 @@ void sum_fiber_async(T alpha, const Tensor<T> &src, T beta,
         {
             dst_tile_index[j+1] = src_tile_index[src.ndim-batch_ndim+j];
         }
-        auto dst_tile_handle = dst.get_tile_handle(dst_tile_index);
-        auto dst_tile_traits = dst.get_tile_traits(dst_tile_index);
+        const auto &dst_tile_handle = dst.get_tile_handle(dst_tile_index);
+        const auto &dst_tile_traits = dst.get_tile_traits(dst_tile_index);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Transfer data
         src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
@@ -14,8 +14,11 @@
  * */
 
 #include "nntile/tensor/sum_slice.hh"
+#include "nntile/tensor/tree_reduction.hh"
 #include "nntile/starpu/sum_slice.hh"
 #include "nntile/starpu/clear.hh"
+#include "nntile/starpu/accumulate.hh"
+#include <type_traits>
 
 namespace nntile
 {
@@ -68,12 +71,32 @@ void sum_slice_async(T alpha, const Tensor<T> &src, T beta,
     int mpi_rank = starpu_mpi_world_rank();
     int ret;
     Index ndim = src.ndim;
+    const T zero = 0.0, one = 1.0;
+    // Tree reduction does not rely on STARPU_REDUX
+    redux = redux_mode(redux, std::is_same_v<T, compute_t<T>>);
+    bool use_tree = (redux == redux_tree);
+    TreeReduction::accumulate_t accumulate = nullptr;
+    if(use_tree)
+    {
+        redux = 0;
+        // There are no accumulation codelets for 16-bit types
+        if constexpr(not std::is_same_v<T, compute_t<T>>)
+        {
+            throw std::runtime_error("Tree reduction is not supported for "
+                    "bf16_t and fp16_t");
+        }
+        else
+        {
+            accumulate = starpu::accumulate::submit<T>;
+        }
+    }
+    std::vector<Index> dst_tile_index;
     for(Index i = 0; i < dst.grid.nelems; ++i)
     {
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Obtain indices of applicable source tiles
-        auto dst_tile_index = dst.grid.linear_to_index(i);
+        dst.grid.linear_to_index(i, dst_tile_index);
         std::vector<Index> src_tile_index(src.ndim);
         for(Index j = 0, k = 0; j < src.ndim; ++j)
         {
@@ -85,53 +108,66 @@ void sum_slice_async(T alpha, const Tensor<T> &src, T beta,
             src_tile_index[j] = dst_tile_index[k];
             ++k;
         }
-        auto dst_tile_traits = dst.get_tile_traits(i);
-        // Launch for the first tile (init)
+        const auto &dst_tile_traits = dst.get_tile_traits(i);
+        // Source tile, that initializes the destination tile. Tree
+        // reduction prefers a tile, that is already on the destination node
+        Index j_first = 0;
+        if(use_tree)
         {
-            src_tile_index[axis] = 0;
-            Index src_tile_offset = src.grid.index_to_linear(src_tile_index);
-            auto src_tile_handle = src.get_tile_handle(src_tile_offset);
-            int src_tile_rank = src_tile_handle.mpi_get_rank();
-            // Transfer data
-            src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
-            // Execute on destination node
-            if(mpi_rank == dst_tile_rank)
+            for(Index j = 0; j < src.grid.shape[axis]; ++j)
             {
-                // Get sizes
-                auto src_tile_traits = src.get_tile_traits(src_tile_offset);
-                Index m, n, k;
-                m = src_tile_traits.stride[axis];
-                n = src_tile_traits.matrix_shape[axis+1][1];
-                k = src_tile_traits.shape[axis];
-                // Insert task
-                starpu::sum_slice::submit<T>(m, n, k, alpha, src_tile_handle,
-                        beta, dst_tile_handle, redux);
+                src_tile_index[axis] = j;
+                if(src.get_tile_handle(src.grid.index_to_linear(
+                                src_tile_index)).mpi_get_rank()
+                        == dst_tile_rank)
+                {
+                    j_first = j;
+                    break;
+                }
             }
         }
+        TreeReduction tree(dst_tile_handle, sizeof(T)*dst_tile_traits.nelems,
+                accumulate);
         // Launch kernel for each appropriate source tile
-        for(Index j = 1; j < src.grid.shape[axis]; ++j)
+        for(Index j = 0; j < src.grid.shape[axis]; ++j)
         {
             src_tile_index[axis] = j;
             Index src_tile_offset = src.grid.index_to_linear(src_tile_index);
-            auto src_tile_handle = src.get_tile_handle(src_tile_offset);
+            const auto &src_tile_handle = src.get_tile_handle(src_tile_offset);
             int src_tile_rank = src_tile_handle.mpi_get_rank();
+            // Get sizes
+            const auto &src_tile_traits = src.get_tile_traits(src_tile_offset);
+            Index m, n, k;
+            m = src_tile_traits.stride[axis];
+            n = src_tile_traits.matrix_shape[axis+1][1];
+            k = src_tile_traits.shape[axis];
+            // Partial result of the tree reduction is computed on the node
+            // with the source tile
+            if(use_tree and j != j_first)
+            {
+                auto partial = tree.get_partial(src_tile_rank);
+                if(mpi_rank == src_tile_rank)
+                {
+                    starpu::sum_slice::submit<T>(m, n, k, alpha,
+                            src_tile_handle, zero, partial, 0);
+                }
+                continue;
+            }
             // Transfer data
             src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
             // Execute on destination node
             if(mpi_rank == dst_tile_rank)
             {
-                // Get sizes
-                auto src_tile_traits = src.get_tile_traits(src_tile_offset);
-                Index m, n, k;
-                m = src_tile_traits.stride[axis];
-                n = src_tile_traits.matrix_shape[axis+1][1];
-                k = src_tile_traits.shape[axis];
-                // Insert task
-                constexpr T one = 1.0;
+                // The first task initializes the destination tile
                 starpu::sum_slice::submit<T>(m, n, k, alpha, src_tile_handle,
-                        one, dst_tile_handle, redux);
+                        (j == j_first) ? beta : one, dst_tile_handle, redux);
             }
         }
+        // Combine partial results of the tree reduction
+        if(use_tree)
+        {
+            tree.submit();
+        }
         // Flush cache for the output tile on every node
         dst_tile_handle.mpi_flush();
     }
@@ -156,6 +192,14 @@ template
 void sum_slice_async<fp64_t>(fp64_t alpha, const Tensor<fp64_t> &src,
         fp64_t beta, const Tensor<fp64_t> &dst, Index axis, int redux);
 
+template
+void sum_slice_async<bf16_t>(bf16_t alpha, const Tensor<bf16_t> &src,
+        bf16_t beta, const Tensor<bf16_t> &dst, Index axis, int redux);
+
+template
+void sum_slice_async<fp16_t>(fp16_t alpha, const Tensor<fp16_t> &src,
+        fp16_t beta, const Tensor<fp16_t> &dst, Index axis, int redux);
+
 // Explicit instantiation
 template
 void sum_slice<fp32_t>(fp32_t alpha, const Tensor<fp32_t> &src, fp32_t beta,
@@ -165,6 +209,14 @@ template
 void sum_slice<fp64_t>(fp64_t alpha, const Tensor<fp64_t> &src, fp64_t beta,
         const Tensor<fp64_t> &dst, Index axis, int redux);
 
+template
+void sum_slice<bf16_t>(bf16_t alpha, const Tensor<bf16_t> &src, bf16_t beta,
+        const Tensor<bf16_t> &dst, Index axis, int redux);
+
+template
+void sum_slice<fp16_t>(fp16_t alpha, const Tensor<fp16_t> &src, fp16_t beta,
+        const Tensor<fp16_t> &dst, Index axis, int redux);
+
 } // namespace tensor
 } // namespace nntile
 
@@ -81,17 +81,18 @@ void sumnorm_async(const Tensor<T> &src, const Tensor<T> &dst, Index axis)
     int mpi_rank = starpu_mpi_world_rank();
     int ret;
     Index ndim = src.ndim;
+    std::vector<Index> dst_tile_index;
     for(Index i = 0; i < dst.grid.nelems; ++i)
     {
         // Clean up destination tile on dest node
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         if(mpi_rank == dst_tile_rank)
         {
             starpu::clear::submit(dst_tile_handle);
         }
         // Obtain indices of applicable source tiles
-        auto dst_tile_index = dst.grid.linear_to_index(i);
+        dst.grid.linear_to_index(i, dst_tile_index);
         std::vector<Index> src_tile_index(src.ndim);
         for(Index j = 0; j < axis; ++j)
         {
@@ -103,12 +104,12 @@ void sumnorm_async(const Tensor<T> &src, const Tensor<T> &dst, Index axis)
             src_tile_index[j] = dst_tile_index[j];
         }
         // Launch kernel for each appropriate source tile
-        auto dst_tile_traits = dst.get_tile_traits(i);
+        const auto &dst_tile_traits = dst.get_tile_traits(i);
         for(Index j = 0; j < src.grid.shape[axis]; ++j)
         {
             src_tile_index[axis] = j;
             Index src_tile_offset = src.grid.index_to_linear(src_tile_index);
-            auto src_tile_handle = src.get_tile_handle(src_tile_offset);
+            const auto &src_tile_handle = src.get_tile_handle(src_tile_offset);
             int src_tile_rank = src_tile_handle.mpi_get_rank();
             // Transfer data
             src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
@@ -116,7 +117,8 @@ void sumnorm_async(const Tensor<T> &src, const Tensor<T> &dst, Index axis)
             if(mpi_rank == dst_tile_rank)
             {
                 // Get sizes
-                auto src_tile_traits = src.get_tile_traits(src_tile_offset);
+                const auto &src_tile_traits =
+                    src.get_tile_traits(src_tile_offset);
                 Index m, n, k;
                 m = src_tile_traits.stride[axis];
                 n = src_tile_traits.matrix_shape[axis+1][1];
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/tensor/sumprod_fiber.hh"
+#include "nntile/tensor/tree_reduction.hh"
 #include "nntile/starpu/sumprod_fiber.hh"
 
 namespace nntile
@@ -60,23 +61,26 @@ void sumprod_fiber_async(T alpha, const Tensor<T> &src1,
                 "dst.basetile_shape[0]");
     }
     // Do actual calculations
+    // Deterministic mode replaces STARPU_REDUX by a sequential chain
+    redux = redux_mode(redux, false);
     int mpi_rank = starpu_mpi_world_rank();
     int ret;
     Index ndim = src1.ndim;
     constexpr T one = 1.0;
+    std::vector<Index> src_tile_index;
     for(Index i = 0; i < src1.grid.nelems; ++i)
     {
         // Get source tiles
-        auto src1_tile_handle = src1.get_tile_handle(i);
-        auto src2_tile_handle = src2.get_tile_handle(i);
-        auto src_tile_traits = src1.get_tile_traits(i);
+        const auto &src1_tile_handle = src1.get_tile_handle(i);
+        const auto &src2_tile_handle = src2.get_tile_handle(i);
+        const auto &src_tile_traits = src1.get_tile_traits(i);
         int src1_tile_rank = src1_tile_handle.mpi_get_rank();
         int src2_tile_rank = src2_tile_handle.mpi_get_rank();
-        auto src_tile_index = src1.grid.linear_to_index(i);
+        src1.grid.linear_to_index(i, src_tile_index);
         // Get destination tile
         Index j = src_tile_index[axis];
-        auto dst_tile_handle = dst.get_tile_handle(j);
-        auto dst_tile_traits = dst.get_tile_traits(j);
+        const auto &dst_tile_handle = dst.get_tile_handle(j);
+        const auto &dst_tile_traits = dst.get_tile_traits(j);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Transfer data
         src1_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/tensor/sumprod_slice.hh"
+#include "nntile/tensor/tree_reduction.hh"
 #include "nntile/starpu/sumprod_slice.hh"
 
 namespace nntile
@@ -75,16 +76,19 @@ void sumprod_slice_async(T alpha, const Tensor<T> &src1, const Tensor<T> &src2,
         }
     }
     // Do actual calculations
+    // Deterministic mode replaces STARPU_REDUX by a sequential chain
+    redux = redux_mode(redux, false);
     int mpi_rank = starpu_mpi_world_rank();
     int ret;
     Index ndim = src1.ndim;
+    std::vector<Index> dst_tile_index;
     for(Index i = 0; i < dst.grid.nelems; ++i)
     {
         // Get destination tile
-        auto dst_tile_handle = dst.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
         int dst_tile_rank = dst_tile_handle.mpi_get_rank();
         // Obtain indices of applicable source tiles
-        auto dst_tile_index = dst.grid.linear_to_index(i);
+        dst.grid.linear_to_index(i, dst_tile_index);
         std::vector<Index> src_tile_index(src1.ndim);
         for(Index j = 0; j < axis; ++j)
         {
@@ -97,19 +101,20 @@ void sumprod_slice_async(T alpha, const Tensor<T> &src1, const Tensor<T> &src2,
         }
         // Initialize with provided beta only single time
         Index src_tile_offset = src1.grid.index_to_linear(src_tile_index);
-        auto src1_tile_handle = src1.get_tile_handle(src_tile_offset);
+        const auto &src1_tile_handle = src1.get_tile_handle(src_tile_offset);
         int src1_tile_rank = src1_tile_handle.mpi_get_rank();
-        auto src2_tile_handle = src2.get_tile_handle(src_tile_offset);
+        const auto &src2_tile_handle = src2.get_tile_handle(src_tile_offset);
         int src2_tile_rank = src2_tile_handle.mpi_get_rank();
         // Transfer data
         src1_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
         src2_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
         // Execute on destination node
-        auto dst_tile_traits = dst.get_tile_traits(i);
+        const auto &dst_tile_traits = dst.get_tile_traits(i);
         if(mpi_rank == dst_tile_rank)
         {
             // Get sizes
-            auto src_tile_traits = src1.get_tile_traits(src_tile_offset);
+            const auto &src_tile_traits =
+                src1.get_tile_traits(src_tile_offset);
             Index m, n, k;
             m = src_tile_traits.stride[axis];
             n = src_tile_traits.matrix_shape[axis+1][1];
@@ -123,9 +128,11 @@ void sumprod_slice_async(T alpha, const Tensor<T> &src1, const Tensor<T> &src2,
         {
             src_tile_index[axis] = j;
             Index src_tile_offset = src1.grid.index_to_linear(src_tile_index);
-            auto src1_tile_handle = src1.get_tile_handle(src_tile_offset);
+            const auto &src1_tile_handle =
+                    src1.get_tile_handle(src_tile_offset);
             int src1_tile_rank = src1_tile_handle.mpi_get_rank();
-            auto src2_tile_handle = src2.get_tile_handle(src_tile_offset);
+            const auto &src2_tile_handle =
+                    src2.get_tile_handle(src_tile_offset);
             int src2_tile_rank = src2_tile_handle.mpi_get_rank();
             // Transfer data
             src1_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
@@ -134,7 +141,8 @@ void sumprod_slice_async(T alpha, const Tensor<T> &src1, const Tensor<T> &src2,
             if(mpi_rank == dst_tile_rank)
             {
                 // Get sizes
-                auto src_tile_traits = src1.get_tile_traits(src_tile_offset);
+                const auto &src_tile_traits =
+                    src1.get_tile_traits(src_tile_offset);
                 Index m, n, k;
                 m = src_tile_traits.stride[axis];
                 n = src_tile_traits.matrix_shape[axis+1][1];
@@ -0,0 +1,105 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/swiglu.cc
+ * Tensor wrappers for SiLU-gated product
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/swiglu.hh"
+#include "nntile/starpu/swiglu.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous tensor-wise SiLU-gated product dst = SiLU(gate) * up
+/*! Tensors gate and up are outputs of two up-projections of a gated MLP, so
+ * they share shape and tiling, and no intermediate activation is stored.
+ *
+ * @param[in] gate: Input tensor of the gate
+ * @param[in] up: Input tensor of the up-projection
+ * @param[out] dst: Output tensor
+ * */
+template<typename T>
+void swiglu_async(const Tensor<T> &gate, const Tensor<T> &up,
+        const Tensor<T> &dst)
+{
+    // Check shapes
+    if(gate.shape != up.shape)
+    {
+        throw std::runtime_error("gate.shape != up.shape");
+    }
+    if(gate.basetile_shape != up.basetile_shape)
+    {
+        throw std::runtime_error("gate.basetile_shape != up.basetile_shape");
+    }
+    if(gate.shape != dst.shape)
+    {
+        throw std::runtime_error("gate.shape != dst.shape");
+    }
+    if(gate.basetile_shape != dst.basetile_shape)
+    {
+        throw std::runtime_error("gate.basetile_shape != dst.basetile_shape");
+    }
+    // Do actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        const auto &gate_tile_handle = gate.get_tile_handle(i);
+        const auto &up_tile_handle = up.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
+        // Execution node
+        int exec_rank = dst_tile_handle.mpi_get_rank();
+        // Transfer data
+        gate_tile_handle.mpi_transfer(exec_rank, mpi_rank);
+        up_tile_handle.mpi_transfer(exec_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == exec_rank)
+        {
+            const auto &dst_tile_traits = dst.get_tile_traits(i);
+            starpu::swiglu::submit<T>(dst_tile_traits.nelems,
+                    gate_tile_handle, up_tile_handle, dst_tile_handle);
+        }
+        // Flush cache for the output tile on every node
+        dst_tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking version of tensor-wise SiLU-gated product
+template<typename T>
+void swiglu(const Tensor<T> &gate, const Tensor<T> &up, const Tensor<T> &dst)
+{
+    swiglu_async<T>(gate, up, dst);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void swiglu_async<fp32_t>(const Tensor<fp32_t> &gate,
+        const Tensor<fp32_t> &up, const Tensor<fp32_t> &dst);
+
+template
+void swiglu_async<fp64_t>(const Tensor<fp64_t> &gate,
+        const Tensor<fp64_t> &up, const Tensor<fp64_t> &dst);
+
+// Explicit instantiation
+template
+void swiglu<fp32_t>(const Tensor<fp32_t> &gate, const Tensor<fp32_t> &up,
+        const Tensor<fp32_t> &dst);
+
+template
+void swiglu<fp64_t>(const Tensor<fp64_t> &gate, const Tensor<fp64_t> &up,
+        const Tensor<fp64_t> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,144 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/swiglu_backward.cc
+ * Tensor wrappers for backward of SiLU-gated product
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/swiglu_backward.hh"
+#include "nntile/starpu/swiglu_backward.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous tensor-wise backward of SiLU-gated product
+/*! Gradients of both inputs are accumulated by the same task, so tiles of
+ * gate_grad shall be owned by the same nodes as the corresponding tiles of
+ * up_grad.
+ *
+ * @param[in] gate: Input tensor of the gate
+ * @param[in] up: Input tensor of the up-projection
+ * @param[in] dst_grad: Gradient of the output tensor
+ * @param[inout] gate_grad: Gradient of the gate, that is accumulated
+ * @param[inout] up_grad: Gradient of the up-projection, that is accumulated
+ * */
+template<typename T>
+void swiglu_backward_async(const Tensor<T> &gate, const Tensor<T> &up,
+        const Tensor<T> &dst_grad, const Tensor<T> &gate_grad,
+        const Tensor<T> &up_grad)
+{
+    // Check shapes
+    if(gate.shape != up.shape)
+    {
+        throw std::runtime_error("gate.shape != up.shape");
+    }
+    if(gate.basetile_shape != up.basetile_shape)
+    {
+        throw std::runtime_error("gate.basetile_shape != up.basetile_shape");
+    }
+    if(gate.shape != dst_grad.shape)
+    {
+        throw std::runtime_error("gate.shape != dst_grad.shape");
+    }
+    if(gate.basetile_shape != dst_grad.basetile_shape)
+    {
+        throw std::runtime_error("gate.basetile_shape != "
+                "dst_grad.basetile_shape");
+    }
+    if(gate.shape != gate_grad.shape)
+    {
+        throw std::runtime_error("gate.shape != gate_grad.shape");
+    }
+    if(gate.basetile_shape != gate_grad.basetile_shape)
+    {
+        throw std::runtime_error("gate.basetile_shape != "
+                "gate_grad.basetile_shape");
+    }
+    if(gate.shape != up_grad.shape)
+    {
+        throw std::runtime_error("gate.shape != up_grad.shape");
+    }
+    if(gate.basetile_shape != up_grad.basetile_shape)
+    {
+        throw std::runtime_error("gate.basetile_shape != "
+                "up_grad.basetile_shape");
+    }
+    // Do actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < gate.grid.nelems; ++i)
+    {
+        const auto &gate_grad_tile_handle = gate_grad.get_tile_handle(i);
+        const auto &up_grad_tile_handle = up_grad.get_tile_handle(i);
+        // Execution node
+        int exec_rank = gate_grad_tile_handle.mpi_get_rank();
+        if(up_grad_tile_handle.mpi_get_rank() != exec_rank)
+        {
+            throw std::runtime_error("Tiles of gate_grad and up_grad are "
+                    "owned by different nodes");
+        }
+        const auto &gate_tile_handle = gate.get_tile_handle(i);
+        const auto &up_tile_handle = up.get_tile_handle(i);
+        const auto &dst_grad_tile_handle = dst_grad.get_tile_handle(i);
+        // Transfer data
+        gate_tile_handle.mpi_transfer(exec_rank, mpi_rank);
+        up_tile_handle.mpi_transfer(exec_rank, mpi_rank);
+        dst_grad_tile_handle.mpi_transfer(exec_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == exec_rank)
+        {
+            const auto &gate_tile_traits = gate.get_tile_traits(i);
+            starpu::swiglu_backward::submit<T>(gate_tile_traits.nelems,
+                    gate_tile_handle, up_tile_handle, dst_grad_tile_handle,
+                    gate_grad_tile_handle, up_grad_tile_handle);
+        }
+        // Flush cache for the output tiles on every node
+        gate_grad_tile_handle.mpi_flush();
+        up_grad_tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking version of tensor-wise backward of SiLU-gated product
+template<typename T>
+void swiglu_backward(const Tensor<T> &gate, const Tensor<T> &up,
+        const Tensor<T> &dst_grad, const Tensor<T> &gate_grad,
+        const Tensor<T> &up_grad)
+{
+    swiglu_backward_async<T>(gate, up, dst_grad, gate_grad, up_grad);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void swiglu_backward_async<fp32_t>(const Tensor<fp32_t> &gate,
+        const Tensor<fp32_t> &up, const Tensor<fp32_t> &dst_grad,
+        const Tensor<fp32_t> &gate_grad, const Tensor<fp32_t> &up_grad);
+
+template
+void swiglu_backward_async<fp64_t>(const Tensor<fp64_t> &gate,
+        const Tensor<fp64_t> &up, const Tensor<fp64_t> &dst_grad,
+        const Tensor<fp64_t> &gate_grad, const Tensor<fp64_t> &up_grad);
+
+// Explicit instantiation
+template
+void swiglu_backward<fp32_t>(const Tensor<fp32_t> &gate,
+        const Tensor<fp32_t> &up, const Tensor<fp32_t> &dst_grad,
+        const Tensor<fp32_t> &gate_grad, const Tensor<fp32_t> &up_grad);
+
+template
+void swiglu_backward<fp64_t>(const Tensor<fp64_t> &gate,
+        const Tensor<fp64_t> &up, const Tensor<fp64_t> &dst_grad,
+        const Tensor<fp64_t> &gate_grad, const Tensor<fp64_t> &up_grad);
+
+} // namespace tensor
+} // namespace nntile
+
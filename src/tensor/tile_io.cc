@@ -0,0 +1,638 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/tile_io.cc
+ * Writing and reading tiles of Tensor<T> to/from files
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-14
+ * */
+
+#include "nntile/tensor/tile_io.hh"
+#include "nntile/starpu/tile_io.hh"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Check that there is a file and an offset for every tile
+static void tile_io_check(const TensorTraits &traits,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets)
+{
+    if(paths.size() != traits.grid.nelems)
+    {
+        throw std::runtime_error("paths.size() != grid.nelems");
+    }
+    if(offsets.size() != traits.grid.nelems)
+    {
+        throw std::runtime_error("offsets.size() != grid.nelems");
+    }
+    for(Index i = 0; i < traits.grid.nelems; ++i)
+    {
+        if(offsets[i] < 0)
+        {
+            throw std::runtime_error("offsets[i] < 0");
+        }
+    }
+}
+
+//! Asynchronously write tiles of a tensor into files
+/*! Every tile is written by its owner from its handle into paths[i] at
+ * offset offsets[i], so there is no gathering of data and nodes write in
+ * parallel. Files shall exist and be large enough. Tasks only read tiles,
+ * so the following computations, that read the tensor, are not delayed.
+ * Failed writes are reported by starpu::tile_io::get_nerrors().
+ *
+ * @param[in] src: Tensor to write
+ * @param[in] paths: File of every tile, only tiles of the current node use
+ *      them
+ * @param[in] offsets: Offset in bytes of every tile in its file
+ * */
+template<typename T>
+void write_tiles_async(const Tensor<T> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets)
+{
+    tile_io_check(src, paths, offsets);
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < src.grid.nelems; ++i)
+    {
+        const auto &tile_handle = src.get_tile_handle(i);
+        if(tile_handle.mpi_get_rank() != mpi_rank)
+        {
+            continue;
+        }
+        const auto &tile_traits = src.get_tile_traits(i);
+        starpu::tile_io::submit_write(tile_handle, paths[i], offsets[i],
+                sizeof(T)*tile_traits.nelems);
+    }
+}
+
+//! Blocking version of writing of tiles of a tensor into files
+/*! @param[in] src: Tensor to write
+ * @param[in] paths: File of every tile
+ * @param[in] offsets: Offset in bytes of every tile in its file
+ * */
+template<typename T>
+void write_tiles(const Tensor<T> &src, const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets)
+{
+    write_tiles_async<T>(src, paths, offsets);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+//! Asynchronously read tiles of a tensor from files
+/*! Every tile is read by its owner from paths[i] at offset offsets[i]. A
+ * tile may be read from a file, that was written by another node, if the
+ * file system is shared, so a tensor may be loaded with a different
+ * distribution of tiles. Failed reads are reported by
+ * starpu::tile_io::get_nerrors().
+ *
+ * @param[out] dst: Tensor to read
+ * @param[in] paths: File of every tile, only tiles of the current node use
+ *      them
+ * @param[in] offsets: Offset in bytes of every tile in its file
+ * */
+template<typename T>
+void read_tiles_async(const Tensor<T> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets)
+{
+    tile_io_check(dst, paths, offsets);
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        const auto &tile_handle = dst.get_tile_handle(i);
+        if(tile_handle.mpi_get_rank() == mpi_rank)
+        {
+            const auto &tile_traits = dst.get_tile_traits(i);
+            starpu::tile_io::submit_read(tile_handle, paths[i], offsets[i],
+                    sizeof(T)*tile_traits.nelems);
+        }
+        // Flush cache for the output tile on every node
+        tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking version of reading of tiles of a tensor from files
+/*! @param[out] dst: Tensor to read
+ * @param[in] paths: File of every tile
+ * @param[in] offsets: Offset in bytes of every tile in its file
+ * */
+template<typename T>
+void read_tiles(const Tensor<T> &dst, const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets)
+{
+    read_tiles_async<T>(dst, paths, offsets);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+//! Asynchronously copy tiles of a tensor into staging tiles in RAM
+/*! Copies are executed on CPU, so StarPU fetches every source tile into RAM
+ * as a part of the task graph. Following updates of the source wait only for
+ * its copy, so a consistent state of the source is kept by the staging
+ * tensor, while it is written into files by write_tiles_acquire().
+ *
+ * @param[in] src: Source tensor
+ * @param[out] dst: Staging tensor with the same tiles and distribution
+ * */
+template<typename T>
+void stage_tiles_async(const Tensor<T> &src, const Tensor<T> &dst)
+{
+    // Check shapes and tiles
+    if(src.shape != dst.shape)
+    {
+        throw std::runtime_error("src.shape != dst.shape");
+    }
+    if(src.basetile_shape != dst.basetile_shape)
+    {
+        throw std::runtime_error("src.basetile_shape != dst.basetile_shape");
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < src.grid.nelems; ++i)
+    {
+        const auto &src_tile_handle = src.get_tile_handle(i);
+        const auto &dst_tile_handle = dst.get_tile_handle(i);
+        if(src_tile_handle.mpi_get_rank() != dst_tile_handle.mpi_get_rank())
+        {
+            throw std::runtime_error("Distributions of src and dst "
+                    "differ");
+        }
+        if(dst_tile_handle.mpi_get_rank() == mpi_rank)
+        {
+            starpu::tile_io::submit_stage(src_tile_handle, dst_tile_handle);
+        }
+    }
+}
+
+//! Write local tiles of a tensor into files from the calling thread
+/*! Every local tile is acquired in RAM, written and released one by one, so
+ * no StarPU worker is busy with file operations. The function blocks until
+ * all the tasks, that write the tensor, are done, so it is meant to be
+ * called from a separate host thread for a staging tensor of
+ * stage_tiles_async(). Failures throw std::runtime_error.
+ *
+ * @param[in] src: Tensor to write
+ * @param[in] paths: File of every tile, only tiles of the current node use
+ *      them
+ * @param[in] offsets: Offset in bytes of every tile in its file
+ * */
+template<typename T>
+void write_tiles_acquire(const Tensor<T> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets)
+{
+    tile_io_check(src, paths, offsets);
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < src.grid.nelems; ++i)
+    {
+        const auto &tile_handle = src.get_tile_handle(i);
+        if(tile_handle.mpi_get_rank() != mpi_rank)
+        {
+            continue;
+        }
+        const auto &tile_traits = src.get_tile_traits(i);
+        auto tile_local = tile_handle.acquire(STARPU_R);
+        int err = starpu::tile_io::write_file(paths[i], tile_local.get_ptr(),
+                offsets[i], sizeof(T)*tile_traits.nelems);
+        tile_local.release();
+        if(err != 0)
+        {
+            throw std::runtime_error("Failed to write tile into " + paths[i]
+                    + ": " + std::strerror(err));
+        }
+    }
+}
+
+//! Asynchronously convert a strided host array into tiles of a tensor
+/*! Every local tile gets a task, that reads its part of the array, so tiles
+ * are filled in parallel without a temporary copy of the whole tensor. The
+ * array is usually a view of a memory-mapped file, e.g. a transposed or a
+ * sliced tensor of a safetensors file, and it shall stay alive until all
+ * the tasks are done.
+ *
+ * @param[out] dst: Tensor to fill
+ * @param[in] src: Pointer to the first element of the array
+ * @param[in] src_type: Type of elements of the array
+ * @param[in] src_stride: Strides of the array in elements
+ * */
+template<typename T>
+void load_strided_async(const Tensor<T> &dst, const void *src,
+        starpu::tile_io::src_type_t src_type,
+        const std::vector<Index> &src_stride)
+{
+    if(src_stride.size() != dst.ndim)
+    {
+        throw std::runtime_error("src_stride.size() != dst.ndim");
+    }
+    Index elem_size = starpu::tile_io::src_type_size(src_type);
+    int mpi_rank = starpu_mpi_world_rank();
+    std::vector<Index> tile_index;
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        const auto &tile_handle = dst.get_tile_handle(i);
+        if(tile_handle.mpi_get_rank() == mpi_rank)
+        {
+            dst.grid.linear_to_index(i, tile_index);
+            const auto &tile_traits = dst.get_tile_traits(i);
+            // Offset of the first element of the tile within the array
+            Index offset = 0;
+            for(Index j = 0; j < dst.ndim; ++j)
+            {
+                offset += tile_index[j] * dst.basetile_shape[j]
+                    * src_stride[j];
+            }
+            const char *tile_src = reinterpret_cast<const char *>(src)
+                + offset*elem_size;
+            starpu::tile_io::submit_load<T>(tile_src, src_type,
+                    tile_traits.shape, src_stride, tile_handle);
+        }
+        // Flush cache for the output tile on every node
+        tile_handle.mpi_flush();
+    }
+}
+
+//! Map a flat binary file of tokens into memory
+/*! @param[in] path: Path of the file
+ * @param[in] token_type_: Type of tokens of the file
+ * */
+TokenFile::TokenFile(const std::string &path,
+        starpu::tile_io::token_type_t token_type_):
+    data(nullptr), nbytes(0), token_type(token_type_), ntokens(0)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        throw std::runtime_error("Failed to open " + path + ": "
+                + std::strerror(errno));
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0)
+    {
+        int err = errno;
+        ::close(fd);
+        throw std::runtime_error("Failed to stat " + path + ": "
+                + std::strerror(err));
+    }
+    Index token_size = starpu::tile_io::token_type_size(token_type);
+    if(st.st_size == 0 or st.st_size%token_size != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Size of " + path + " is not a positive "
+                "multiple of size of a token");
+    }
+    void *ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    int err = errno;
+    // Mapping stays valid after the file is closed
+    ::close(fd);
+    if(ptr == MAP_FAILED)
+    {
+        throw std::runtime_error("Failed to map " + path + ": "
+                + std::strerror(err));
+    }
+    // Windows are sampled at random positions, so read-ahead is useless
+    madvise(ptr, st.st_size, MADV_RANDOM);
+    data = ptr;
+    nbytes = st.st_size;
+    ntokens = nbytes / token_size;
+}
+
+TokenFile::~TokenFile()
+{
+    close();
+}
+
+void TokenFile::close()
+{
+    if(data != nullptr)
+    {
+        munmap(const_cast<void *>(data), nbytes);
+        data = nullptr;
+        nbytes = 0;
+        ntokens = 0;
+    }
+}
+
+//! Asynchronously load random windows of tokens into a tensor
+/*! Every sequence of a batch, i.e., every column of dst, is a window of
+ * seq_len+1 consecutive tokens of the file, where seq_len is the number of
+ * rows of dst. Positions of windows are drawn from the seed, the step and
+ * the index of a sequence, so inputs (shift=0) and labels (shift=1) of the
+ * same step are the same windows shifted by one token. Every local tile is
+ * filled by its own task directly from the file, so batches of the next
+ * steps are loaded by CPU workers in parallel with computations of the
+ * current step, as soon as the tasks, that read previous contents of dst,
+ * are done.
+ *
+ * @param[in] file: Tokens mapped into memory
+ * @param[in] seed: Seed of random positions of windows
+ * @param[in] step: Index of a batch, e.g., of a training step
+ * @param[in] shift: Offset of sequences within windows, 0 or 1
+ * @param[out] dst: Tensor of shape [seq_len, batch]
+ * */
+void load_tokens_async(const TokenFile &file, unsigned long long seed,
+        Index step, Index shift, const Tensor<Index> &dst)
+{
+    if(dst.ndim != 2)
+    {
+        throw std::runtime_error("dst.ndim != 2");
+    }
+    if(shift != 0 and shift != 1)
+    {
+        throw std::runtime_error("shift != 0 and shift != 1");
+    }
+    Index seq_len = dst.shape[0];
+    if(file.ntokens <= seq_len)
+    {
+        throw std::runtime_error("file.ntokens <= seq_len");
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    std::vector<Index> tile_index;
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        const auto &tile_handle = dst.get_tile_handle(i);
+        if(tile_handle.mpi_get_rank() == mpi_rank)
+        {
+            dst.grid.linear_to_index(i, tile_index);
+            const auto &tile_traits = dst.get_tile_traits(i);
+            starpu::tile_io::submit_tokens(file.get_data(), file.token_type,
+                    file.ntokens, seq_len,
+                    tile_index[0]*dst.basetile_shape[0], tile_traits.shape[0],
+                    tile_index[1]*dst.basetile_shape[1], tile_traits.shape[1],
+                    seed, step, shift, tile_handle);
+        }
+        // Flush cache for the output tile on every node
+        tile_handle.mpi_flush();
+    }
+}
+
+// Explicit instantiation
+template
+void write_tiles_async<fp64_t>(const Tensor<fp64_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void write_tiles<fp64_t>(const Tensor<fp64_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles_async<fp64_t>(const Tensor<fp64_t> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles<fp64_t>(const Tensor<fp64_t> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void write_tiles_async<fp32_t>(const Tensor<fp32_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void write_tiles<fp32_t>(const Tensor<fp32_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles_async<fp32_t>(const Tensor<fp32_t> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles<fp32_t>(const Tensor<fp32_t> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void write_tiles_async<fp16_t>(const Tensor<fp16_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void write_tiles<fp16_t>(const Tensor<fp16_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles_async<fp16_t>(const Tensor<fp16_t> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles<fp16_t>(const Tensor<fp16_t> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void write_tiles_async<bf16_t>(const Tensor<bf16_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void write_tiles<bf16_t>(const Tensor<bf16_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles_async<bf16_t>(const Tensor<bf16_t> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles<bf16_t>(const Tensor<bf16_t> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void write_tiles_async<Index>(const Tensor<Index> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void write_tiles<Index>(const Tensor<Index> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles_async<Index>(const Tensor<Index> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles<Index>(const Tensor<Index> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void write_tiles_async<bool_t>(const Tensor<bool_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void write_tiles<bool_t>(const Tensor<bool_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles_async<bool_t>(const Tensor<bool_t> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles<bool_t>(const Tensor<bool_t> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void write_tiles_async<std::int8_t>(const Tensor<std::int8_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void write_tiles<std::int8_t>(const Tensor<std::int8_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles_async<std::int8_t>(const Tensor<std::int8_t> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles<std::int8_t>(const Tensor<std::int8_t> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void write_tiles_async<fp8_e4m3_t>(const Tensor<fp8_e4m3_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void write_tiles<fp8_e4m3_t>(const Tensor<fp8_e4m3_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles_async<fp8_e4m3_t>(const Tensor<fp8_e4m3_t> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void read_tiles<fp8_e4m3_t>(const Tensor<fp8_e4m3_t> &dst,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void stage_tiles_async<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &dst);
+
+template
+void write_tiles_acquire<fp64_t>(const Tensor<fp64_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void stage_tiles_async<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &dst);
+
+template
+void write_tiles_acquire<fp32_t>(const Tensor<fp32_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void stage_tiles_async<fp16_t>(const Tensor<fp16_t> &src,
+        const Tensor<fp16_t> &dst);
+
+template
+void write_tiles_acquire<fp16_t>(const Tensor<fp16_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void stage_tiles_async<bf16_t>(const Tensor<bf16_t> &src,
+        const Tensor<bf16_t> &dst);
+
+template
+void write_tiles_acquire<bf16_t>(const Tensor<bf16_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void stage_tiles_async<Index>(const Tensor<Index> &src,
+        const Tensor<Index> &dst);
+
+template
+void write_tiles_acquire<Index>(const Tensor<Index> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void stage_tiles_async<bool_t>(const Tensor<bool_t> &src,
+        const Tensor<bool_t> &dst);
+
+template
+void write_tiles_acquire<bool_t>(const Tensor<bool_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void stage_tiles_async<std::int8_t>(const Tensor<std::int8_t> &src,
+        const Tensor<std::int8_t> &dst);
+
+template
+void write_tiles_acquire<std::int8_t>(const Tensor<std::int8_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void stage_tiles_async<fp8_e4m3_t>(const Tensor<fp8_e4m3_t> &src,
+        const Tensor<fp8_e4m3_t> &dst);
+
+template
+void write_tiles_acquire<fp8_e4m3_t>(const Tensor<fp8_e4m3_t> &src,
+        const std::vector<std::string> &paths,
+        const std::vector<Index> &offsets);
+
+template
+void load_strided_async<fp64_t>(const Tensor<fp64_t> &dst, const void *src,
+        starpu::tile_io::src_type_t src_type,
+        const std::vector<Index> &src_stride);
+
+template
+void load_strided_async<fp32_t>(const Tensor<fp32_t> &dst, const void *src,
+        starpu::tile_io::src_type_t src_type,
+        const std::vector<Index> &src_stride);
+
+template
+void load_strided_async<fp16_t>(const Tensor<fp16_t> &dst, const void *src,
+        starpu::tile_io::src_type_t src_type,
+        const std::vector<Index> &src_stride);
+
+template
+void load_strided_async<bf16_t>(const Tensor<bf16_t> &dst, const void *src,
+        starpu::tile_io::src_type_t src_type,
+        const std::vector<Index> &src_stride);
+
+} // namespace tensor
+} // namespace nntile
+
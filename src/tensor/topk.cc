@@ -0,0 +1,225 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/topk.cc
+ * Largest values and their indices along an axis of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-11
+ * */
+
+#include "nntile/tensor/topk.hh"
+#include "nntile/starpu/topk.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Largest values and their indices along given axis
+/*! For every slice of src along the axis, values get the nk largest
+ * elements of the slice in descending order and indices get their
+ * positions along the axis. Ties are resolved in favor of smaller indices.
+ * Tiles of src along the axis are reduced directly into tiles of values and
+ * indices, so that only nk candidates of a slice leave its node. The first
+ * tile initializes candidates and the others are accumulated in any order.
+ * Argmax is the case of nk=1.
+ *
+ * @param[in] src: Input tensor, for example, logits
+ * @param[out] values: Largest values of shape [nk]+src.shape without the
+ *      axis, it shall not be split along the first axis
+ * @param[out] indices: Their indices of the same shape and tiling
+ * @param[in] axis: Axis of reduction
+ * @param[in] size: Only the first size elements along the axis are
+ *      considered, for example, without padding of vocabulary
+ * */
+template<typename T>
+void topk_async(const Tensor<T> &src, const Tensor<T> &values,
+        const Tensor<Index> &indices, Index axis, Index size)
+{
+    // Check dimensions
+    if(src.ndim != values.ndim)
+    {
+        throw std::runtime_error("src.ndim != values.ndim");
+    }
+    if(src.ndim == 0)
+    {
+        throw std::runtime_error("Scalar input makes no sense");
+    }
+    // Check axis and size
+    if(axis < 0)
+    {
+        throw std::runtime_error("axis < 0");
+    }
+    if(axis >= src.ndim)
+    {
+        throw std::runtime_error("axis >= src.ndim");
+    }
+    if(size <= 0)
+    {
+        throw std::runtime_error("size <= 0");
+    }
+    if(size > src.shape[axis])
+    {
+        throw std::runtime_error("size > src.shape[axis]");
+    }
+    // Check shapes of src and values
+    if(values.basetile_shape[0] != values.shape[0])
+    {
+        throw std::runtime_error("values.basetile_shape[0] != "
+                "values.shape[0]");
+    }
+    for(Index i = 0; i < axis; ++i)
+    {
+        if(src.shape[i] != values.shape[i+1])
+        {
+            throw std::runtime_error("src.shape[i] != values.shape[i+1]");
+        }
+        if(src.basetile_shape[i] != values.basetile_shape[i+1])
+        {
+            throw std::runtime_error("src.basetile_shape[i] != "
+                    "values.basetile_shape[i+1]");
+        }
+    }
+    for(Index i = axis+1; i < src.ndim; ++i)
+    {
+        if(src.shape[i] != values.shape[i])
+        {
+            throw std::runtime_error("src.shape[i] != values.shape[i]");
+        }
+        if(src.basetile_shape[i] != values.basetile_shape[i])
+        {
+            throw std::runtime_error("src.basetile_shape[i] != "
+                    "values.basetile_shape[i]");
+        }
+    }
+    // Indices and values are the same
+    if(indices.shape != values.shape)
+    {
+        throw std::runtime_error("indices.shape != values.shape");
+    }
+    if(indices.basetile_shape != values.basetile_shape)
+    {
+        throw std::runtime_error("indices.basetile_shape != "
+                "values.basetile_shape");
+    }
+    // Do actual calculations
+    int mpi_rank = starpu_mpi_world_rank();
+    Index nk = values.shape[0];
+    std::vector<Index> dst_tile_index;
+    for(Index i = 0; i < values.grid.nelems; ++i)
+    {
+        const auto &values_tile_handle = values.get_tile_handle(i);
+        const auto &indices_tile_handle = indices.get_tile_handle(i);
+        int dst_tile_rank = values_tile_handle.mpi_get_rank();
+        // Values and indices are produced by the same tasks
+        if(indices_tile_handle.mpi_get_rank() != dst_tile_rank)
+        {
+            throw std::runtime_error("Tiles of values and indices are owned "
+                    "by different nodes");
+        }
+        // Obtain indices of applicable source tiles
+        values.grid.linear_to_index(i, dst_tile_index);
+        std::vector<Index> src_tile_index(src.ndim);
+        for(Index j = 0; j < axis; ++j)
+        {
+            src_tile_index[j] = dst_tile_index[j+1];
+        }
+        for(Index j = axis+1; j < src.ndim; ++j)
+        {
+            src_tile_index[j] = dst_tile_index[j];
+        }
+        // Launch kernel for each source tile, that has elements before size
+        for(Index j = 0; j*src.basetile_shape[axis] < size; ++j)
+        {
+            src_tile_index[axis] = j;
+            Index src_tile_offset = src.grid.index_to_linear(src_tile_index);
+            const auto &src_tile_handle = src.get_tile_handle(src_tile_offset);
+            // Transfer data
+            src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+            // Execute on destination node
+            if(mpi_rank == dst_tile_rank)
+            {
+                // Get sizes
+                const auto &src_tile_traits =
+                    src.get_tile_traits(src_tile_offset);
+                Index m, n, k;
+                m = src_tile_traits.stride[axis];
+                n = src_tile_traits.matrix_shape[axis+1][1];
+                k = src_tile_traits.shape[axis];
+                // Insert task
+                starpu::topk::submit<T>(m, n, k, nk,
+                        j*src.basetile_shape[axis], size, j == 0,
+                        src_tile_handle, values_tile_handle,
+                        indices_tile_handle);
+            }
+        }
+        // Flush cache for the output tiles on every node
+        values_tile_handle.mpi_flush();
+        indices_tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking version of the largest values and their indices along an axis
+/*! @param[in] src: Input tensor, for example, logits
+ * @param[out] values: Largest values of shape [nk]+src.shape without the
+ *      axis, it shall not be split along the first axis
+ * @param[out] indices: Their indices of the same shape and tiling
+ * @param[in] axis: Axis of reduction
+ * @param[in] size: Only the first size elements along the axis are
+ *      considered
+ * */
+template<typename T>
+void topk(const Tensor<T> &src, const Tensor<T> &values,
+        const Tensor<Index> &indices, Index axis, Index size)
+{
+    topk_async<T>(src, values, indices, axis, size);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void topk_async<fp32_t>(const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &values, const Tensor<Index> &indices,
+        Index axis, Index size);
+
+template
+void topk_async<fp64_t>(const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &values, const Tensor<Index> &indices,
+        Index axis, Index size);
+
+template
+void topk_async<bf16_t>(const Tensor<bf16_t> &src,
+        const Tensor<bf16_t> &values, const Tensor<Index> &indices,
+        Index axis, Index size);
+
+template
+void topk_async<fp16_t>(const Tensor<fp16_t> &src,
+        const Tensor<fp16_t> &values, const Tensor<Index> &indices,
+        Index axis, Index size);
+
+// Explicit instantiation
+template
+void topk<fp32_t>(const Tensor<fp32_t> &src, const Tensor<fp32_t> &values,
+        const Tensor<Index> &indices, Index axis, Index size);
+
+template
+void topk<fp64_t>(const Tensor<fp64_t> &src, const Tensor<fp64_t> &values,
+        const Tensor<Index> &indices, Index axis, Index size);
+
+template
+void topk<bf16_t>(const Tensor<bf16_t> &src, const Tensor<bf16_t> &values,
+        const Tensor<Index> &indices, Index axis, Index size);
+
+template
+void topk<fp16_t>(const Tensor<fp16_t> &src, const Tensor<fp16_t> &values,
+        const Tensor<Index> &indices, Index axis, Index size);
+
+} // namespace tensor
+} // namespace nntile
+
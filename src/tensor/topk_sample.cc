@@ -0,0 +1,173 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/topk_sample.cc
+ * Sampling of tokens among the largest logits of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-11
+ * */
+
+#include "nntile/tensor/topk_sample.hh"
+#include "nntile/starpu/topk_sample.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Sample ids of tokens among candidates with the largest logits
+/*! Candidates are the output of topk_async(): logits in descending order
+ * along the first axis and their ids. Every slice gets an id, sampled with
+ * probability softmax(values/temperature), that is restricted to the
+ * smallest prefix of candidates with probability of at least top_p. Zero
+ * temperature means greedy choice. Random numbers of a tile of ids depend
+ * only on the seed and the index of the tile.
+ *
+ * @param[in] values: Logits of candidates
+ * @param[in] indices: Ids of candidates
+ * @param[out] ids: Chosen ids of shape values.shape[1:]
+ * @param[in] temperature: Temperature of softmax
+ * @param[in] top_p: Probability of the nucleus, 1 disables it
+ * @param[in] seed: Seed of random numbers
+ * */
+template<typename T>
+void topk_sample_async(const Tensor<T> &values, const Tensor<Index> &indices,
+        const Tensor<Index> &ids, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed)
+{
+    // Check dimensions
+    if(values.ndim != ids.ndim+1)
+    {
+        throw std::runtime_error("values.ndim != ids.ndim+1");
+    }
+    // Check shapes
+    if(values.basetile_shape[0] != values.shape[0])
+    {
+        throw std::runtime_error("values.basetile_shape[0] != "
+                "values.shape[0]");
+    }
+    for(Index i = 0; i < ids.ndim; ++i)
+    {
+        if(values.shape[i+1] != ids.shape[i])
+        {
+            throw std::runtime_error("values.shape[i+1] != ids.shape[i]");
+        }
+        if(values.basetile_shape[i+1] != ids.basetile_shape[i])
+        {
+            throw std::runtime_error("values.basetile_shape[i+1] != "
+                    "ids.basetile_shape[i]");
+        }
+    }
+    if(indices.shape != values.shape)
+    {
+        throw std::runtime_error("indices.shape != values.shape");
+    }
+    if(indices.basetile_shape != values.basetile_shape)
+    {
+        throw std::runtime_error("indices.basetile_shape != "
+                "values.basetile_shape");
+    }
+    // Check parameters
+    if(temperature < 0)
+    {
+        throw std::runtime_error("temperature < 0");
+    }
+    if(top_p <= 0 or top_p > 1)
+    {
+        throw std::runtime_error("top_p is not in (0,1]");
+    }
+    // Do actual calculations, tiles of values and ids have the same linear
+    // indices, as values are not split along the first axis
+    int mpi_rank = starpu_mpi_world_rank();
+    Index nk = values.shape[0];
+    for(Index i = 0; i < ids.grid.nelems; ++i)
+    {
+        const auto &values_tile_handle = values.get_tile_handle(i);
+        const auto &indices_tile_handle = indices.get_tile_handle(i);
+        const auto &ids_tile_handle = ids.get_tile_handle(i);
+        int ids_tile_rank = ids_tile_handle.mpi_get_rank();
+        // Transfer data
+        values_tile_handle.mpi_transfer(ids_tile_rank, mpi_rank);
+        indices_tile_handle.mpi_transfer(ids_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == ids_tile_rank)
+        {
+            const auto &ids_tile_traits = ids.get_tile_traits(i);
+            // Insert task
+            starpu::topk_sample::submit<T>(nk, ids_tile_traits.nelems,
+                    temperature, top_p, seed, i, values_tile_handle,
+                    indices_tile_handle, ids_tile_handle);
+        }
+        // Flush cache for the output tile on every node
+        ids_tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking version of sampling of tokens among the largest logits
+/*! @param[in] values: Logits of candidates
+ * @param[in] indices: Ids of candidates
+ * @param[out] ids: Chosen ids of shape values.shape[1:]
+ * @param[in] temperature: Temperature of softmax
+ * @param[in] top_p: Probability of the nucleus, 1 disables it
+ * @param[in] seed: Seed of random numbers
+ * */
+template<typename T>
+void topk_sample(const Tensor<T> &values, const Tensor<Index> &indices,
+        const Tensor<Index> &ids, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed)
+{
+    topk_sample_async<T>(values, indices, ids, temperature, top_p, seed);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void topk_sample_async<fp32_t>(const Tensor<fp32_t> &values,
+        const Tensor<Index> &indices, const Tensor<Index> &ids,
+        fp32_t temperature, fp32_t top_p, unsigned long long seed);
+
+template
+void topk_sample_async<fp64_t>(const Tensor<fp64_t> &values,
+        const Tensor<Index> &indices, const Tensor<Index> &ids,
+        fp32_t temperature, fp32_t top_p, unsigned long long seed);
+
+template
+void topk_sample_async<bf16_t>(const Tensor<bf16_t> &values,
+        const Tensor<Index> &indices, const Tensor<Index> &ids,
+        fp32_t temperature, fp32_t top_p, unsigned long long seed);
+
+template
+void topk_sample_async<fp16_t>(const Tensor<fp16_t> &values,
+        const Tensor<Index> &indices, const Tensor<Index> &ids,
+        fp32_t temperature, fp32_t top_p, unsigned long long seed);
+
+// Explicit instantiation
+template
+void topk_sample<fp32_t>(const Tensor<fp32_t> &values,
+        const Tensor<Index> &indices, const Tensor<Index> &ids,
+        fp32_t temperature, fp32_t top_p, unsigned long long seed);
+
+template
+void topk_sample<fp64_t>(const Tensor<fp64_t> &values,
+        const Tensor<Index> &indices, const Tensor<Index> &ids,
+        fp32_t temperature, fp32_t top_p, unsigned long long seed);
+
+template
+void topk_sample<bf16_t>(const Tensor<bf16_t> &values,
+        const Tensor<Index> &indices, const Tensor<Index> &ids,
+        fp32_t temperature, fp32_t top_p, unsigned long long seed);
+
+template
+void topk_sample<fp16_t>(const Tensor<fp16_t> &values,
+        const Tensor<Index> &indices, const Tensor<Index> &ids,
+        fp32_t temperature, fp32_t top_p, unsigned long long seed);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -68,15 +68,15 @@ void total_sum_accum_async(T alpha, const Tensor<T> &logsumexp, const Tensor<T>
     }
     // Do actual calculations
     int mpi_rank = starpu_mpi_world_rank();
-    auto val_tile_handle = val.get_tile_handle(0);
+    const auto &val_tile_handle = val.get_tile_handle(0);
     int val_tile_rank = val_tile_handle.mpi_get_rank();
     for(Index i = 0; i < labels.grid.nelems; ++i)
     {
         // Clean up destination tile on dest node
-        auto logsumexp_tile_handle = logsumexp.get_tile_handle(i);
-        auto logsumexp_tile_traits = logsumexp.get_tile_traits(i);
-        auto labels_tile_handle = labels.get_tile_handle(i);
-        auto src_tile_handle = src.get_tile_handle(i);
+        const auto &logsumexp_tile_handle = logsumexp.get_tile_handle(i);
+        const auto &logsumexp_tile_traits = logsumexp.get_tile_traits(i);
+        const auto &labels_tile_handle = labels.get_tile_handle(i);
+        const auto &src_tile_handle = src.get_tile_handle(i);
         // Transfer data to exec_rank=val_tile_rank
         src_tile_handle.mpi_transfer(val_tile_rank, mpi_rank);
         logsumexp_tile_handle.mpi_transfer(val_tile_rank, mpi_rank);
@@ -57,8 +57,8 @@ void transpose_async(T alpha, const Tensor<T> &src, const Tensor<T> &dst,
         for(Index j = 0; j < grid_n; ++j)
         {
             // Get handle for corresponding tiles of src and dst
-            auto src_tile_handle = src.get_tile_handle(i+j*grid_m);
-            auto dst_tile_handle = dst.get_tile_handle(i*grid_n+j);
+            const auto &src_tile_handle = src.get_tile_handle(i+j*grid_m);
+            const auto &dst_tile_handle = dst.get_tile_handle(i*grid_n+j);
             // MPI rank of the destination tile
             int dst_tile_rank = dst_tile_handle.mpi_get_rank();
             // Transfer data
@@ -66,7 +66,7 @@ void transpose_async(T alpha, const Tensor<T> &src, const Tensor<T> &dst,
             // Execute only on destination node
             if(mpi_rank == dst_tile_rank)
             {
-                auto traits = src.get_tile_traits(i+j*grid_m);
+                const auto &traits = src.get_tile_traits(i+j*grid_m);
                 starpu::transpose::submit<T>(traits.matrix_shape[ndim][0],
                         traits.matrix_shape[ndim][1], alpha, src_tile_handle,
                         dst_tile_handle);
@@ -0,0 +1,127 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/tree_reduction.cc
+ * Explicit tree reduction of partial results into a tile of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/tensor/tree_reduction.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+int redux_mode(int redux, bool tree_supported)
+{
+    if(redux != 1 or not starpu::Config::deterministic_is_enabled())
+    {
+        return redux;
+    }
+    return tree_supported ? redux_tree : 0;
+}
+
+#ifdef NNTILE_USE_MPI
+//! Get MPI tag for a temporary partial result
+/*! Tags of tensors are allocated from zero upwards by their users, while
+ * temporaries cycle through a separate range in the upper half of tags.
+ * All nodes submit the same tasks in the same order, so they get the same
+ * tags for the same temporaries.
+ * */
+static starpu_mpi_tag_t tree_reduction_tag()
+{
+    constexpr starpu_mpi_tag_t first = starpu_mpi_tag_t(1) << 62;
+    constexpr starpu_mpi_tag_t ntags = starpu_mpi_tag_t(1) << 32;
+    static starpu_mpi_tag_t next = 0;
+    starpu_mpi_tag_t tag = first + next;
+    next = (next+1) % ntags;
+    return tag;
+}
+#endif // NNTILE_USE_MPI
+
+TreeReduction::TreeReduction(starpu::Handle dst_, std::size_t size_,
+        accumulate_t accumulate_):
+    dst(dst_),
+    size(size_),
+    accumulate(accumulate_),
+    mpi_rank(starpu_mpi_world_rank())
+{
+}
+
+starpu::Handle TreeReduction::get_partial(int rank)
+{
+    // Temporary data is allocated by StarPU only where it is used
+    starpu::VariableHandle tmp(size, STARPU_SCRATCH);
+#ifdef NNTILE_USE_MPI
+    starpu_mpi_data_register(static_cast<starpu_data_handle_t>(tmp),
+            tree_reduction_tag(), rank);
+#endif // NNTILE_USE_MPI
+    partials[rank].push_back(tmp);
+    return tmp;
+}
+
+void TreeReduction::submit()
+{
+    // Binary tree over partial results of each node
+    std::vector<starpu::Handle> roots;
+    int dst_rank = dst.mpi_get_rank();
+    for(auto &[rank, handles]: partials)
+    {
+        if(rank == mpi_rank)
+        {
+            for(std::size_t stride = 1; stride < handles.size(); stride *= 2)
+            {
+                for(std::size_t i = 0; i+stride < handles.size();
+                        i += 2*stride)
+                {
+                    accumulate(handles[i+stride], handles[i]);
+                }
+            }
+        }
+        // Root of the node with the destination tile goes first
+        if(rank == dst_rank)
+        {
+            roots.insert(roots.begin(), handles[0]);
+        }
+        else
+        {
+            roots.push_back(handles[0]);
+        }
+    }
+    // Binary tree over nodes
+    for(std::size_t stride = 1; stride < roots.size(); stride *= 2)
+    {
+        for(std::size_t i = 0; i+stride < roots.size(); i += 2*stride)
+        {
+            int rank = roots[i].mpi_get_rank();
+            roots[i+stride].mpi_transfer(rank, mpi_rank);
+            if(mpi_rank == rank)
+            {
+                accumulate(roots[i+stride], roots[i]);
+            }
+            roots[i+stride].mpi_flush();
+        }
+    }
+    // Accumulate the result into the destination tile
+    if(not roots.empty())
+    {
+        roots[0].mpi_transfer(dst_rank, mpi_rank);
+        if(mpi_rank == dst_rank)
+        {
+            accumulate(roots[0], dst);
+        }
+        roots[0].mpi_flush();
+    }
+    partials.clear();
+}
+
+} // namespace tensor
+} // namespace nntile
+
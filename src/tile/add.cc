@@ -64,6 +64,14 @@ template
 void add_async<fp64_t>(fp64_t alpha, const Tile<fp64_t> &src, fp64_t beta,
         const Tile<fp64_t> &dst);
 
+template
+void add_async<bf16_t>(bf16_t alpha, const Tile<bf16_t> &src, bf16_t beta,
+        const Tile<bf16_t> &dst);
+
+template
+void add_async<fp16_t>(fp16_t alpha, const Tile<fp16_t> &src, fp16_t beta,
+        const Tile<fp16_t> &dst);
+
 // Explicit instantiation of template
 template
 void add<fp32_t>(fp32_t alpha, const Tile<fp32_t> &src, fp32_t beta,
@@ -72,6 +80,14 @@ void add<fp32_t>(fp32_t alpha, const Tile<fp32_t> &src, fp32_t beta,
 template
 void add<fp64_t>(fp64_t alpha, const Tile<fp64_t> &src, fp64_t beta,
         const Tile<fp64_t> &dst);
+
+template
+void add<bf16_t>(bf16_t alpha, const Tile<bf16_t> &src, bf16_t beta,
+        const Tile<bf16_t> &dst);
+
+template
+void add<fp16_t>(fp16_t alpha, const Tile<fp16_t> &src, fp16_t beta,
+        const Tile<fp16_t> &dst);
         
 } // namespace tile
 } // namespace nntile
@@ -47,6 +47,12 @@ void gelutanh_inplace_async<fp32_t>(const Tile<fp32_t> &A);
 template
 void gelutanh_inplace_async<fp64_t>(const Tile<fp64_t> &A);
 
+template
+void gelutanh_inplace_async<bf16_t>(const Tile<bf16_t> &A);
+
+template
+void gelutanh_inplace_async<fp16_t>(const Tile<fp16_t> &A);
+
 // Explicit instantiation
 template
 void gelutanh_inplace<fp32_t>(const Tile<fp32_t> &A);
@@ -54,6 +60,12 @@ void gelutanh_inplace<fp32_t>(const Tile<fp32_t> &A);
 template
 void gelutanh_inplace<fp64_t>(const Tile<fp64_t> &A);
 
+template
+void gelutanh_inplace<bf16_t>(const Tile<bf16_t> &A);
+
+template
+void gelutanh_inplace<fp16_t>(const Tile<fp16_t> &A);
+
 } // namespace tile
 } // namespace nntile
 
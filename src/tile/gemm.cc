@@ -345,6 +345,12 @@ void gemm_async<fp16_t, fp32_t>(fp32_t alpha, const TransOp &transA,
         const TransOp &transB, const Tile<fp16_t> &B, fp32_t beta,
         const Tile<fp16_t> &C, Index ndim, Index batch_ndim);
 
+template
+void gemm_async<bf16_t, fp32_t>(fp32_t alpha, const TransOp &transA,
+        const Tile<bf16_t> &A,
+        const TransOp &transB, const Tile<bf16_t> &B, fp32_t beta,
+        const Tile<bf16_t> &C, Index ndim, Index batch_ndim);
+
 // Explicit instantiation
 template
 void gemm<fp32_t, fp32_t>(fp32_t alpha, const TransOp &transA,
@@ -364,6 +370,12 @@ void gemm<fp16_t, fp32_t>(fp32_t alpha, const TransOp &transA,
         const TransOp &transB, const Tile<fp16_t> &B, fp32_t beta,
         const Tile<fp16_t> &C, Index ndim, Index batch_ndim);
 
+template
+void gemm<bf16_t, fp32_t>(fp32_t alpha, const TransOp &transA,
+        const Tile<bf16_t> &A,
+        const TransOp &transB, const Tile<bf16_t> &B, fp32_t beta,
+        const Tile<bf16_t> &C, Index ndim, Index batch_ndim);
+
 } // namespace tile
 } // namespace nntile
 
@@ -0,0 +1,142 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tile/layer_norm.cc
+ * Fused layer normalization of Tile<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-05
+ * */
+
+#include "nntile/tile/layer_norm.hh"
+#include "nntile/starpu/layer_norm.hh"
+
+namespace nntile
+{
+namespace tile
+{
+
+template<typename T>
+void layer_norm_async(T eps, const Tile<T> &src, const Tile<T> &gamma,
+        const Tile<T> &beta, const Tile<T> &mean, const Tile<T> &inv_stddev,
+        const Tile<T> &dst, Index axis)
+{
+    // Check dimensions
+    if(src.ndim != dst.ndim)
+    {
+        throw std::runtime_error("src.ndim != dst.ndim");
+    }
+    if(src.ndim-1 != mean.ndim)
+    {
+        throw std::runtime_error("src.ndim-1 != mean.ndim");
+    }
+    if(src.ndim-1 != inv_stddev.ndim)
+    {
+        throw std::runtime_error("src.ndim-1 != inv_stddev.ndim");
+    }
+    if(gamma.ndim != 1)
+    {
+        throw std::runtime_error("gamma.ndim != 1");
+    }
+    if(beta.ndim != 1)
+    {
+        throw std::runtime_error("beta.ndim != 1");
+    }
+    Index ndim = src.ndim;
+    // Treat special case of ndim=0
+    if(ndim == 0)
+    {
+        throw std::runtime_error("Scalar input makes no sense");
+    }
+    // Check axis
+    if(axis < 0)
+    {
+        throw std::runtime_error("axis < 0");
+    }
+    if(axis >= ndim)
+    {
+        throw std::runtime_error("axis >= ndim");
+    }
+    // Check shapes
+    if(src.shape != dst.shape)
+    {
+        throw std::runtime_error("src.shape != dst.shape");
+    }
+    if(mean.shape != inv_stddev.shape)
+    {
+        throw std::runtime_error("mean.shape != inv_stddev.shape");
+    }
+    for(Index i = 0; i < axis; i++)
+    {
+        if(src.shape[i] != mean.shape[i])
+        {
+            throw std::runtime_error("src.shape[i] != mean.shape[i]");
+        }
+    }
+    for(Index i = axis+1; i < ndim; i++)
+    {
+        if(src.shape[i] != mean.shape[i-1])
+        {
+            throw std::runtime_error("src.shape[i] != mean.shape[i-1]");
+        }
+    }
+    if(src.shape[axis] != gamma.shape[0])
+    {
+        throw std::runtime_error("src.shape[axis] != gamma.shape[0]");
+    }
+    if(src.shape[axis] != beta.shape[0])
+    {
+        throw std::runtime_error("src.shape[axis] != beta.shape[0]");
+    }
+    // Get sizes
+    Index m, n, k;
+    m = src.stride[axis];
+    n = src.matrix_shape[axis+1][1];
+    k = src.shape[axis];
+    // Insert task
+    starpu::layer_norm::submit<T>(m, n, k, eps, src, gamma, beta, mean,
+            inv_stddev, dst);
+}
+
+template<typename T>
+void layer_norm(T eps, const Tile<T> &src, const Tile<T> &gamma,
+        const Tile<T> &beta, const Tile<T> &mean, const Tile<T> &inv_stddev,
+        const Tile<T> &dst, Index axis)
+{
+    layer_norm_async<T>(eps, src, gamma, beta, mean, inv_stddev, dst, axis);
+    starpu_task_wait_for_all();
+}
+
+// Explicit instantiation
+template
+void layer_norm_async<fp32_t>(fp32_t eps, const Tile<fp32_t> &src,
+        const Tile<fp32_t> &gamma, const Tile<fp32_t> &beta,
+        const Tile<fp32_t> &mean, const Tile<fp32_t> &inv_stddev,
+        const Tile<fp32_t> &dst, Index axis);
+
+template
+void layer_norm_async<fp64_t>(fp64_t eps, const Tile<fp64_t> &src,
+        const Tile<fp64_t> &gamma, const Tile<fp64_t> &beta,
+        const Tile<fp64_t> &mean, const Tile<fp64_t> &inv_stddev,
+        const Tile<fp64_t> &dst, Index axis);
+
+// Explicit instantiation
+template
+void layer_norm<fp32_t>(fp32_t eps, const Tile<fp32_t> &src,
+        const Tile<fp32_t> &gamma, const Tile<fp32_t> &beta,
+        const Tile<fp32_t> &mean, const Tile<fp32_t> &inv_stddev,
+        const Tile<fp32_t> &dst, Index axis);
+
+template
+void layer_norm<fp64_t>(fp64_t eps, const Tile<fp64_t> &src,
+        const Tile<fp64_t> &gamma, const Tile<fp64_t> &beta,
+        const Tile<fp64_t> &mean, const Tile<fp64_t> &inv_stddev,
+        const Tile<fp64_t> &dst, Index axis);
+
+} // namespace tile
+} // namespace nntile
+
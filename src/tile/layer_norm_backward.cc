@@ -0,0 +1,165 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tile/layer_norm_backward.cc
+ * Backward of fused layer normalization of Tile<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-05
+ * */
+
+#include "nntile/tile/layer_norm_backward.hh"
+#include "nntile/starpu/layer_norm_backward.hh"
+
+namespace nntile
+{
+namespace tile
+{
+
+template<typename T>
+void layer_norm_backward_async(const Tile<T> &src, const Tile<T> &dst_grad,
+        const Tile<T> &gamma, const Tile<T> &mean, const Tile<T> &inv_stddev,
+        const Tile<T> &src_grad, const Tile<T> &gamma_grad,
+        const Tile<T> &beta_grad, Index axis)
+{
+    // Check dimensions
+    if(src.ndim != dst_grad.ndim)
+    {
+        throw std::runtime_error("src.ndim != dst_grad.ndim");
+    }
+    if(src.ndim != src_grad.ndim)
+    {
+        throw std::runtime_error("src.ndim != src_grad.ndim");
+    }
+    if(src.ndim-1 != mean.ndim)
+    {
+        throw std::runtime_error("src.ndim-1 != mean.ndim");
+    }
+    if(src.ndim-1 != inv_stddev.ndim)
+    {
+        throw std::runtime_error("src.ndim-1 != inv_stddev.ndim");
+    }
+    if(gamma.ndim != 1)
+    {
+        throw std::runtime_error("gamma.ndim != 1");
+    }
+    if(gamma_grad.ndim != 1)
+    {
+        throw std::runtime_error("gamma_grad.ndim != 1");
+    }
+    if(beta_grad.ndim != 1)
+    {
+        throw std::runtime_error("beta_grad.ndim != 1");
+    }
+    Index ndim = src.ndim;
+    // Treat special case of ndim=0
+    if(ndim == 0)
+    {
+        throw std::runtime_error("Scalar input makes no sense");
+    }
+    // Check axis
+    if(axis < 0)
+    {
+        throw std::runtime_error("axis < 0");
+    }
+    if(axis >= ndim)
+    {
+        throw std::runtime_error("axis >= ndim");
+    }
+    // Check shapes
+    if(src.shape != dst_grad.shape)
+    {
+        throw std::runtime_error("src.shape != dst_grad.shape");
+    }
+    if(src.shape != src_grad.shape)
+    {
+        throw std::runtime_error("src.shape != src_grad.shape");
+    }
+    if(mean.shape != inv_stddev.shape)
+    {
+        throw std::runtime_error("mean.shape != inv_stddev.shape");
+    }
+    for(Index i = 0; i < axis; i++)
+    {
+        if(src.shape[i] != mean.shape[i])
+        {
+            throw std::runtime_error("src.shape[i] != mean.shape[i]");
+        }
+    }
+    for(Index i = axis+1; i < ndim; i++)
+    {
+        if(src.shape[i] != mean.shape[i-1])
+        {
+            throw std::runtime_error("src.shape[i] != mean.shape[i-1]");
+        }
+    }
+    if(src.shape[axis] != gamma.shape[0])
+    {
+        throw std::runtime_error("src.shape[axis] != gamma.shape[0]");
+    }
+    if(src.shape[axis] != gamma_grad.shape[0])
+    {
+        throw std::runtime_error("src.shape[axis] != gamma_grad.shape[0]");
+    }
+    if(src.shape[axis] != beta_grad.shape[0])
+    {
+        throw std::runtime_error("src.shape[axis] != beta_grad.shape[0]");
+    }
+    // Get sizes
+    Index m, n, k;
+    m = src.stride[axis];
+    n = src.matrix_shape[axis+1][1];
+    k = src.shape[axis];
+    // Insert task
+    starpu::layer_norm_backward::submit<T>(m, n, k, src, dst_grad, gamma,
+            mean, inv_stddev, src_grad, gamma_grad, beta_grad);
+}
+
+template<typename T>
+void layer_norm_backward(const Tile<T> &src, const Tile<T> &dst_grad,
+        const Tile<T> &gamma, const Tile<T> &mean, const Tile<T> &inv_stddev,
+        const Tile<T> &src_grad, const Tile<T> &gamma_grad,
+        const Tile<T> &beta_grad, Index axis)
+{
+    layer_norm_backward_async<T>(src, dst_grad, gamma, mean, inv_stddev,
+            src_grad, gamma_grad, beta_grad, axis);
+    starpu_task_wait_for_all();
+}
+
+// Explicit instantiation
+template
+void layer_norm_backward_async<fp32_t>(const Tile<fp32_t> &src,
+        const Tile<fp32_t> &dst_grad, const Tile<fp32_t> &gamma,
+        const Tile<fp32_t> &mean, const Tile<fp32_t> &inv_stddev,
+        const Tile<fp32_t> &src_grad, const Tile<fp32_t> &gamma_grad,
+        const Tile<fp32_t> &beta_grad, Index axis);
+
+template
+void layer_norm_backward_async<fp64_t>(const Tile<fp64_t> &src,
+        const Tile<fp64_t> &dst_grad, const Tile<fp64_t> &gamma,
+        const Tile<fp64_t> &mean, const Tile<fp64_t> &inv_stddev,
+        const Tile<fp64_t> &src_grad, const Tile<fp64_t> &gamma_grad,
+        const Tile<fp64_t> &beta_grad, Index axis);
+
+// Explicit instantiation
+template
+void layer_norm_backward<fp32_t>(const Tile<fp32_t> &src,
+        const Tile<fp32_t> &dst_grad, const Tile<fp32_t> &gamma,
+        const Tile<fp32_t> &mean, const Tile<fp32_t> &inv_stddev,
+        const Tile<fp32_t> &src_grad, const Tile<fp32_t> &gamma_grad,
+        const Tile<fp32_t> &beta_grad, Index axis);
+
+template
+void layer_norm_backward<fp64_t>(const Tile<fp64_t> &src,
+        const Tile<fp64_t> &dst_grad, const Tile<fp64_t> &gamma,
+        const Tile<fp64_t> &mean, const Tile<fp64_t> &inv_stddev,
+        const Tile<fp64_t> &src_grad, const Tile<fp64_t> &gamma_grad,
+        const Tile<fp64_t> &beta_grad, Index axis);
+
+} // namespace tile
+} // namespace nntile
+
@@ -89,6 +89,14 @@ template
 void maxsumexp_async<fp64_t>(const Tile<fp64_t> &src, const Tile<fp64_t> &dst,
         Index axis);
 
+template
+void maxsumexp_async<bf16_t>(const Tile<bf16_t> &src, const Tile<bf16_t> &dst,
+        Index axis);
+
+template
+void maxsumexp_async<fp16_t>(const Tile<fp16_t> &src, const Tile<fp16_t> &dst,
+        Index axis);
+
 // Explicit instantiation
 template
 void maxsumexp<fp32_t>(const Tile<fp32_t> &src, const Tile<fp32_t> &dst,
@@ -98,6 +106,14 @@ template
 void maxsumexp<fp64_t>(const Tile<fp64_t> &src, const Tile<fp64_t> &dst,
         Index axis);
 
+template
+void maxsumexp<bf16_t>(const Tile<bf16_t> &src, const Tile<bf16_t> &dst,
+        Index axis);
+
+template
+void maxsumexp<fp16_t>(const Tile<fp16_t> &src, const Tile<fp16_t> &dst,
+        Index axis);
+
 } // namespace tile
 } // namespace nntile
 
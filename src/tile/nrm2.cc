@@ -15,8 +15,6 @@
 #include "nntile/tile/nrm2.hh"
 #include "nntile/starpu/nrm2.hh"
 #include "nntile/starpu/clear.hh"
-#include "nntile/starpu/scal_inplace.hh"
-#include "nntile/starpu/hypot.hh"
 
 namespace nntile
 {
@@ -37,27 +35,15 @@ void nrm2_async(T alpha, const Tile<T> &src, T beta, const Tile<T> &dst,
     {
         throw std::runtime_error("tmp.ndim != 0");
     }
-    // Insert task
-    if(beta == 0.0)
+    // Insert task, that accumulates the norm into dst directly, so tmp is
+    // not used
+    if(beta == 0.0 and alpha == 0.0)
     {
-        if(alpha == 0.0)
-        {
-            starpu::clear::submit(dst);
-        }
-        else
-        {
-            starpu::nrm2::submit<T>(src.nelems, src, dst);
-            if(alpha != 1.0)
-            {
-                starpu::scal_inplace::submit<T>(std::fabs(alpha), dst.nelems,
-                        dst);
-            }
-        }
+        starpu::clear::submit(dst);
     }
     else
     {
-        starpu::nrm2::submit<T>(src.nelems, src, tmp);
-        starpu::hypot::submit<T>(1, alpha, tmp, beta, dst);
+        starpu::nrm2::submit<T>(src.nelems, alpha, src, beta, dst);
     }
 }
 
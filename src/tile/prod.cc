@@ -54,6 +54,12 @@ void prod_async<fp32_t>(const Tile<fp32_t> &src, const Tile<fp32_t> &dst);
 template
 void prod_async<fp64_t>(const Tile<fp64_t> &src, const Tile<fp64_t> &dst);
 
+template
+void prod_async<bf16_t>(const Tile<bf16_t> &src, const Tile<bf16_t> &dst);
+
+template
+void prod_async<fp16_t>(const Tile<fp16_t> &src, const Tile<fp16_t> &dst);
+
 // Explicit instantiation
 template
 void prod<fp32_t>(const Tile<fp32_t> &src, const Tile<fp32_t> &dst);
@@ -61,6 +67,12 @@ void prod<fp32_t>(const Tile<fp32_t> &src, const Tile<fp32_t> &dst);
 template
 void prod<fp64_t>(const Tile<fp64_t> &src, const Tile<fp64_t> &dst);
 
+template
+void prod<bf16_t>(const Tile<bf16_t> &src, const Tile<bf16_t> &dst);
+
+template
+void prod<fp16_t>(const Tile<fp16_t> &src, const Tile<fp16_t> &dst);
+
 } // namespace tile
 } // namespace nntile
 
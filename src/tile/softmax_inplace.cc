@@ -90,6 +90,14 @@ template
 void softmax_inplace_async<fp64_t>(const Tile<fp64_t> &maxsumexp, fp64_t alpha,
         const Tile<fp64_t> &dst, Index axis);
 
+template
+void softmax_inplace_async<bf16_t>(const Tile<bf16_t> &maxsumexp, bf16_t alpha,
+        const Tile<bf16_t> &dst, Index axis);
+
+template
+void softmax_inplace_async<fp16_t>(const Tile<fp16_t> &maxsumexp, fp16_t alpha,
+        const Tile<fp16_t> &dst, Index axis);
+
 // Explicit instantiation
 template
 void softmax_inplace<fp32_t>(const Tile<fp32_t> &maxsumexp, fp32_t alpha,
@@ -99,6 +107,14 @@ template
 void softmax_inplace<fp64_t>(const Tile<fp64_t> &maxsumexp, fp64_t alpha,
         const Tile<fp64_t> &dst, Index axis);
 
+template
+void softmax_inplace<bf16_t>(const Tile<bf16_t> &maxsumexp, bf16_t alpha,
+        const Tile<bf16_t> &dst, Index axis);
+
+template
+void softmax_inplace<fp16_t>(const Tile<fp16_t> &maxsumexp, fp16_t alpha,
+        const Tile<fp16_t> &dst, Index axis);
+
 } // namespace tile
 } // namespace nntile
 
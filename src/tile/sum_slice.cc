@@ -86,6 +86,14 @@ template
 void sum_slice_async<fp64_t>(fp64_t alpha, const Tile<fp64_t> &src,
         fp64_t beta, const Tile<fp64_t> &dst, Index axis);
 
+template
+void sum_slice_async<bf16_t>(bf16_t alpha, const Tile<bf16_t> &src,
+        bf16_t beta, const Tile<bf16_t> &dst, Index axis);
+
+template
+void sum_slice_async<fp16_t>(fp16_t alpha, const Tile<fp16_t> &src,
+        fp16_t beta, const Tile<fp16_t> &dst, Index axis);
+
 // Explicit instantiation
 template
 void sum_slice<fp32_t>(fp32_t alpha, const Tile<fp32_t> &src, fp32_t beta,
@@ -95,6 +103,14 @@ template
 void sum_slice<fp64_t>(fp64_t alpha, const Tile<fp64_t> &src, fp64_t beta,
         const Tile<fp64_t> &dst, Index axis);
 
+template
+void sum_slice<bf16_t>(bf16_t alpha, const Tile<bf16_t> &src, bf16_t beta,
+        const Tile<bf16_t> &dst, Index axis);
+
+template
+void sum_slice<fp16_t>(fp16_t alpha, const Tile<fp16_t> &src, fp16_t beta,
+        const Tile<fp16_t> &dst, Index axis);
+
 } // namespace tile
 } // namespace nntile
 
@@ -0,0 +1,223 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/adafactor_step.cc
+ * Fused Adafactor step with factored second moments
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/adafactor_step.hh"
+#include "nntile/kernel/simd.hh"
+#include "nntile/kernel/parallel.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::adafactor_step;
+
+// Buffers of a parameter of shape (m, k, n)
+template<typename T>
+struct State
+{
+    Index m, k, n;
+    bool factored;
+    std::vector<T> row, col, mean, grad, p;
+    State(Index m_, Index k_, Index n_, bool factored_):
+        m(m_), k(k_), n(n_), factored(factored_),
+        row(factored ? m : m*k*n), col(factored ? n : 0), mean(1),
+        grad(m*k*n), p(m*k*n)
+    {
+        for(Index i = 0; i < row.size(); ++i)
+        {
+            row[i] = T(0.01) * T(i%7+1);
+        }
+        for(Index i = 0; i < col.size(); ++i)
+        {
+            col[i] = T(0.02) * T(i%5+1);
+        }
+        mean[0] = T(0.03);
+        for(Index i = 0; i < p.size(); ++i)
+        {
+            grad[i] = T(2*i+1) / T(i+7) - T(0.5);
+            p[i] = T(i%11) - T(3);
+        }
+    }
+    const T *col_ptr() const
+    {
+        return factored ? &col[0] : nullptr;
+    }
+};
+
+// Reference step with explicit second moments
+template<typename T>
+void reference(Index num_iter, T beta_2, T eps, T lr, T weight_decay,
+        State<T> &state)
+{
+    T bias = 1 / (1 - std::pow(beta_2, T(num_iter)));
+    for(Index j = 0; j < state.n; ++j)
+    for(Index l = 0; l < state.k; ++l)
+    for(Index i = 0; i < state.m; ++i)
+    {
+        Index ind = (j*state.k+l)*state.m + i;
+        T v;
+        if(state.factored)
+        {
+            v = state.row[i] * state.col[j] / state.mean[0] * bias;
+        }
+        else
+        {
+            v = state.row[ind] * bias;
+        }
+        state.p[ind] = (1-lr*weight_decay)*state.p[ind]
+            - lr*state.grad[ind]/(std::sqrt(v)+eps);
+    }
+}
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+T *to_device(const std::vector<T> &host)
+{
+    if(host.size() == 0)
+    {
+        return nullptr;
+    }
+    T *dev;
+    cudaError_t cuda_err = cudaMalloc(&dev, sizeof(T)*host.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev, host.data(), sizeof(T)*host.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    return dev;
+}
+
+template<typename T>
+void to_host(T *dev, std::vector<T> &host)
+{
+    if(dev == nullptr)
+    {
+        return;
+    }
+    cudaError_t cuda_err = cudaMemcpy(host.data(), dev,
+            sizeof(T)*host.size(), cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+
+template<typename T>
+void run_cuda(Index num_iter, T beta_2, T eps, T lr, T weight_decay,
+        State<T> &state)
+{
+    T *row = to_device(state.row), *col = to_device(state.col),
+      *mean = to_device(state.mean), *grad = to_device(state.grad),
+      *p = to_device(state.p);
+    // Init stream
+    cudaStream_t stream;
+    cudaError_t cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, num_iter, state.m, state.k, state.n, beta_2, eps, lr,
+            weight_decay, row, col, mean, grad, p);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    to_host(row, state.row);
+    to_host(col, state.col);
+    to_host(mean, state.mean);
+    to_host(grad, state.grad);
+    to_host(p, state.p);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Compare buffers of two states
+template<typename T>
+void check(const State<T> &state, const State<T> &ref)
+{
+    constexpr T eps = 10 * std::numeric_limits<T>::epsilon();
+    TEST_ASSERT(state.row == ref.row);
+    TEST_ASSERT(state.col == ref.col);
+    TEST_ASSERT(state.grad == ref.grad);
+    for(Index i = 0; i < ref.p.size(); ++i)
+    {
+        TEST_ASSERT(std::abs(state.p[i]-ref.p[i])
+                <= eps*(1+std::abs(ref.p[i])));
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index k, Index n, bool factored, Index num_iter,
+        T weight_decay)
+{
+    const T beta_2 = 0.999, eps = 1e-8, lr = 1e-2;
+    State<T> ref(m, k, n, factored);
+    reference<T>(num_iter, beta_2, eps, lr, weight_decay, ref);
+    // Check low-level CPU kernel with all the supported instruction sets,
+    // sequentially and with buffers split among threads
+    using kernel::simd::Level;
+    for(Level level: {Level::NONE, Level::AVX2, Level::AVX512})
+    for(int nthreads: {1, 4})
+    {
+        if(kernel::simd::set_level(level) != level)
+        {
+            continue;
+        }
+        kernel::parallel::Scope threads(nthreads);
+        State<T> state(m, k, n, factored);
+        std::cout << "Run kernel::adafactor_step::cpu<T> with SIMD level "
+            << static_cast<int>(level) << " and " << nthreads
+            << " threads\n";
+        cpu<T>(num_iter, m, k, n, beta_2, eps, lr, weight_decay,
+                &state.row[0], state.col_ptr(), &state.mean[0],
+                &state.grad[0], &state.p[0]);
+        check(state, ref);
+        std::cout << "OK: kernel::adafactor_step::cpu<T>\n";
+    }
+    kernel::simd::set_level(Level::AVX512);
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    State<T> state_cuda(m, k, n, factored);
+    std::cout << "Run kernel::adafactor_step::cuda<T>\n";
+    run_cuda<T>(num_iter, beta_2, eps, lr, weight_decay, state_cuda);
+    check(state_cuda, ref);
+    std::cout << "OK: kernel::adafactor_step::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+// Check factored and unfactored moments on the first and on a later
+// iteration
+template<typename T>
+void validate_all(Index m, Index k, Index n)
+{
+    for(Index num_iter: {1, 3})
+    for(T weight_decay: {T(0), T(0.1)})
+    {
+        validate<T>(m, k, n, true, num_iter, weight_decay);
+        validate<T>(m, k, n, false, num_iter, weight_decay);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    validate_all<fp32_t>(1, 1, 1);
+    validate_all<fp32_t>(30, 4, 20);
+    // Buffers, that are large enough to be split among threads
+    validate_all<fp32_t>(300, 3, 70);
+    validate_all<fp64_t>(1, 1, 1);
+    validate_all<fp64_t>(30, 4, 20);
+    validate_all<fp64_t>(300, 3, 70);
+    return 0;
+}
+
@@ -171,8 +171,25 @@ void validate(Index nelems, int test_index_a, int test_index_b)
 //#endif // NNTILE_USE_CUDA
 //}
 
+// Throughput on production shapes of tiles of GPT2 in bytes per second
+template<typename T>
+void perf(const char *dtype, Index nelems)
+{
+    std::vector<T> src(nelems, T{0.5}), dst(nelems, T{1});
+    testing::perf_check(std::string("kernel_add_cpu_")+dtype,
+            3.0*sizeof(T)*nelems,
+            [&](){add::cpu<T>(nelems, T{1}, &src[0], T{0.5}, &dst[0]);});
+}
+
 int main(int argc, char **argv)
 {
+    // Residual connection of GPT2 of 1024 tokens by 768 features
+    if(testing::perf_mode(argc, argv))
+    {
+        perf<fp32_t>("fp32", 1024*768);
+        perf<fp64_t>("fp64", 1024*768);
+        return 0;
+    }
     const Index test_nelems[] = { 0, 3, 999 };
     for(Index j = 0; j < 3; ++j)
     {
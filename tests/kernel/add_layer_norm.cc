@@ -0,0 +1,213 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/add_layer_norm.cc
+ * Fused residual addition and layer normalization
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/add_layer_norm.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::add_layer_norm;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, Index k, T eps, const std::vector<T> &src1,
+        const std::vector<T> &src2, const std::vector<T> &gamma,
+        const std::vector<T> &beta, std::vector<T> &sum, std::vector<T> &mean,
+        std::vector<T> &inv_stddev, std::vector<T> &dst)
+{
+    // Copy to device
+    T *dev_src1, *dev_src2, *dev_gamma, *dev_beta, *dev_sum, *dev_mean,
+      *dev_inv_stddev, *dev_dst;
+    cudaError_t cuda_err = cudaMalloc(&dev_src1, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_src2, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_gamma, sizeof(T)*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_beta, sizeof(T)*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_sum, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_mean, sizeof(T)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_inv_stddev, sizeof(T)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src1, &src1[0], sizeof(T)*m*n*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src2, &src2[0], sizeof(T)*m*n*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_gamma, &gamma[0], sizeof(T)*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_beta, &beta[0], sizeof(T)*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, m, n, k, eps, dev_src1, dev_src2, dev_gamma, dev_beta,
+            dev_sum, dev_mean, dev_inv_stddev, dev_dst);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&sum[0], dev_sum, sizeof(T)*m*n*k,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&mean[0], dev_mean, sizeof(T)*m*n,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&inv_stddev[0], dev_inv_stddev, sizeof(T)*m*n,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(T)*m*n*k,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src1);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src2);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_gamma);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_beta);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_sum);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_mean);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_inv_stddev);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check result against the reference, rounding errors grow with k
+template<typename T>
+void check(Index k, const std::vector<T> &val, const std::vector<double> &ref)
+{
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    const double tol = 10 * eps * (k+10);
+    for(Index i = 0; i < val.size(); ++i)
+    {
+        TEST_ASSERT(std::abs(val[i]-ref[i]) <= tol*(1+std::abs(ref[i])));
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k)
+{
+    const T eps = 1e-5;
+    // Init test input with a large common shift of each fiber
+    std::vector<T> src1(m*n*k), src2(m*n*k), gamma(k), beta(k);
+    for(Index i = 0; i < src1.size(); ++i)
+    {
+        src1[i] = T(100) + T(i%13)/T(7) - T((i/7)%5);
+        src2[i] = T(i%5)/T(3) - T((i/3)%7)/T(4);
+    }
+    for(Index i = 0; i < k; ++i)
+    {
+        gamma[i] = T(1) + T(i%3)/T(2);
+        beta[i] = T(i%5) - T(2);
+    }
+    // Get reference result by definition in double precision, the sum is
+    // rounded to T as it is stored by the kernel
+    std::vector<double> sum_ref(m*n*k), mean_ref(m*n), inv_stddev_ref(m*n),
+        dst_ref(m*n*k);
+    for(Index i = 0; i < src1.size(); ++i)
+    {
+        sum_ref[i] = T(src1[i]+src2[i]);
+    }
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            double sum = 0, ssq = 0;
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                sum += sum_ref[(i2*k+i1)*m+i0];
+            }
+            double avg = sum / k;
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                double diff = sum_ref[(i2*k+i1)*m+i0] - avg;
+                ssq += diff * diff;
+            }
+            double inv = 1.0 / std::sqrt(ssq/k+eps);
+            mean_ref[i2*m+i0] = avg;
+            inv_stddev_ref[i2*m+i0] = inv;
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                dst_ref[(i2*k+i1)*m+i0] = (sum_ref[(i2*k+i1)*m+i0]-avg)
+                    * inv * gamma[i1] + beta[i1];
+            }
+        }
+    }
+    // Check low-level CPU kernel
+    std::vector<T> sum(m*n*k), mean(m*n), inv_stddev(m*n), dst(m*n*k);
+    std::cout << "Run kernel::add_layer_norm::cpu<T>\n";
+    cpu<T>(m, n, k, eps, &src1[0], &src2[0], &gamma[0], &beta[0], &sum[0],
+            &mean[0], &inv_stddev[0], &dst[0]);
+    for(Index i = 0; i < sum.size(); ++i)
+    {
+        TEST_ASSERT(sum[i] == sum_ref[i]);
+    }
+    check(k, mean, mean_ref);
+    check(k, inv_stddev, inv_stddev_ref);
+    check(k, dst, dst_ref);
+    std::cout << "OK: kernel::add_layer_norm::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> sum_cuda(m*n*k), mean_cuda(m*n), inv_stddev_cuda(m*n),
+        dst_cuda(m*n*k);
+    std::cout << "Run kernel::add_layer_norm::cuda<T>\n";
+    run_cuda<T>(m, n, k, eps, src1, src2, gamma, beta, sum_cuda, mean_cuda,
+            inv_stddev_cuda, dst_cuda);
+    for(Index i = 0; i < sum_cuda.size(); ++i)
+    {
+        TEST_ASSERT(sum_cuda[i] == sum_ref[i]);
+    }
+    check(k, mean_cuda, mean_ref);
+    check(k, inv_stddev_cuda, inv_stddev_ref);
+    check(k, dst_cuda, dst_ref);
+    std::cout << "OK: kernel::add_layer_norm::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    // Single-element fibers, a block per fiber and a thread per fiber on CUDA
+    validate<fp32_t>(1, 3, 1);
+    validate<fp32_t>(1, 9, 700);
+    validate<fp32_t>(3, 5, 20);
+    validate<fp32_t>(40, 3, 50);
+    validate<fp64_t>(1, 3, 1);
+    validate<fp64_t>(1, 9, 700);
+    validate<fp64_t>(3, 5, 20);
+    validate<fp64_t>(40, 3, 50);
+    return 0;
+}
+
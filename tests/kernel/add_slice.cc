@@ -129,6 +129,41 @@ void validate(Index m, Index n, Index k)
 #endif // NNTILE_USE_CUDA
 }
 
+// Compare specialized and generic loops against a reference
+template<typename T>
+void validate_dispatch(Index m, Index n, Index k, T beta)
+{
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    const T alpha = -2.0;
+    std::vector<T> src(m*n), dst(m*n*k);
+    for(Index i = 0; i < m*n; ++i)
+    {
+        src[i] = T(i%7) - T{3};
+    }
+    for(Index i = 0; i < m*n*k; ++i)
+    {
+        dst[i] = T(i%5) / T{4};
+    }
+    std::vector<T> dst_save(dst);
+    std::cout << "Run kernel::add_slice::cpu<T> with m=" << m << "\n";
+    cpu<T>(m, n, k, alpha, &src[0], beta, &dst[0]);
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                Index i = (i2*k+i1)*m + i0;
+                T a = alpha * src[i2*m+i0], b = beta * dst_save[i];
+                T val_ref = b + a;
+                TEST_ASSERT(std::abs(dst[i]-val_ref)
+                        <= 10*eps*(std::abs(a)+std::abs(b)));
+            }
+        }
+    }
+    std::cout << "OK: kernel::add_slice::cpu<T> with m=" << m << "\n";
+}
+
 int main(int argc, char **argv)
 {
     validate<fp32_t>(1, 9, 10);
@@ -139,6 +174,14 @@ int main(int argc, char **argv)
     validate<fp64_t>(8, 9, 1);
     validate<fp64_t>(8, 1, 10);
     validate<fp64_t>(4, 7, 8);
+    // Sizes of the first mode with specialized loops
+    for(Index m: {15, 16, 32, 64, 128})
+    {
+        validate_dispatch<fp32_t>(m, 3, 5, 0.0);
+        validate_dispatch<fp32_t>(m, 3, 5, 3.0);
+        validate_dispatch<fp64_t>(m, 2, 4, 0.0);
+        validate_dispatch<fp64_t>(m, 2, 4, -1.5);
+    }
 
     return 0;
 }
@@ -0,0 +1,163 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/batch_norm_act.cc
+ * Batch normalization followed by an activation
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/batch_norm_act.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::batch_norm_act;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+T *to_device(const std::vector<T> &host)
+{
+    T *dev;
+    cudaError_t cuda_err = cudaMalloc(&dev, sizeof(T)*host.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev, host.data(), sizeof(T)*host.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    return dev;
+}
+
+template<typename T>
+void to_host(T *dev, std::vector<T> &host)
+{
+    cudaError_t cuda_err = cudaMemcpy(host.data(), dev,
+            sizeof(T)*host.size(), cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+
+template<typename T>
+void run_cuda(Index m, Index n, Index k, activation_t act,
+        const std::vector<T> &src, const std::vector<T> &mean,
+        const std::vector<T> &inv_stddev, const std::vector<T> &gamma,
+        const std::vector<T> &beta, std::vector<T> &dst)
+{
+    // Copy to device
+    T *dev_src = to_device(src), *dev_mean = to_device(mean),
+      *dev_inv_stddev = to_device(inv_stddev), *dev_gamma = to_device(gamma),
+      *dev_beta = to_device(beta), *dev_dst = to_device(dst);
+    // Init stream
+    cudaStream_t stream;
+    cudaError_t cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, m, n, k, act, dev_src, dev_mean, dev_inv_stddev,
+            dev_gamma, dev_beta, dev_dst);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    to_host(dev_dst, dst);
+    std::vector<T> tmp(k);
+    to_host(dev_mean, tmp);
+    to_host(dev_inv_stddev, tmp);
+    to_host(dev_gamma, tmp);
+    to_host(dev_beta, tmp);
+    tmp.resize(m*n*k);
+    to_host(dev_src, tmp);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check result against the reference
+template<typename T>
+void check(const std::vector<T> &val, const std::vector<double> &ref)
+{
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    for(Index i = 0; i < val.size(); ++i)
+    {
+        TEST_ASSERT(std::abs(val[i]-ref[i]) <= 50*eps*(1+std::abs(ref[i])));
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k, activation_t act)
+{
+    constexpr double pi = 3.141592653589793238462643383279502884L;
+    const double f = std::sqrt(2.0/pi);
+    // Init test input
+    std::vector<T> src(m*n*k), mean(k), inv_stddev(k), gamma(k), beta(k),
+        dst(m*n*k);
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        src[i] = T(i%23)/T(4) - T((i/3)%13)/T(2);
+    }
+    for(Index i = 0; i < k; ++i)
+    {
+        mean[i] = T(i%5)/T(2) - T(1);
+        inv_stddev[i] = T(1) / T(i%3+1);
+        gamma[i] = T(i%7)/T(4) - T(0.5);
+        // Biases keep inputs of the activation away from its kink at zero
+        beta[i] = T(i%4)/T(3) - T(0.55);
+    }
+    // Get reference result in double precision
+    std::vector<double> dst_ref(m*n*k);
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        Index l = (i/m) % k;
+        double y = (double(src[i])-mean[l]) * inv_stddev[l] * gamma[l]
+            + beta[l];
+        if(act == activation_t::RELU)
+        {
+            y = std::max(y, 0.0);
+        }
+        else if(act == activation_t::GELUTANH)
+        {
+            y = 0.5 * y * (1.0+std::tanh(f*(y+0.044715*y*y*y)));
+        }
+        dst_ref[i] = y;
+    }
+    // Check low-level CPU kernel
+    std::vector<T> dst_cpu(dst);
+    std::cout << "Run kernel::batch_norm_act::cpu<T>\n";
+    cpu<T>(m, n, k, act, &src[0], &mean[0], &inv_stddev[0], &gamma[0],
+            &beta[0], &dst_cpu[0]);
+    check(dst_cpu, dst_ref);
+    std::cout << "OK: kernel::batch_norm_act::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> dst_cuda(dst);
+    std::cout << "Run kernel::batch_norm_act::cuda<T>\n";
+    run_cuda<T>(m, n, k, act, src, mean, inv_stddev, gamma, beta, dst_cuda);
+    check(dst_cuda, dst_ref);
+    std::cout << "OK: kernel::batch_norm_act::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    // Features along rows and along columns of a matrix for all activations
+    for(auto act: {activation_t::NONE, activation_t::RELU,
+            activation_t::GELUTANH})
+    {
+        validate<fp32_t>(1, 300, 70, act);
+        validate<fp32_t>(600, 50, 3, act);
+        validate<fp32_t>(7, 9, 11, act);
+        validate<fp64_t>(1, 300, 70, act);
+        validate<fp64_t>(600, 50, 3, act);
+        validate<fp64_t>(7, 9, 11, act);
+    }
+    return 0;
+}
+
@@ -0,0 +1,189 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/batch_norm_act_backward.cc
+ * Backward of an activation, that follows batch normalization
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/batch_norm_act_backward.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::batch_norm_act_backward;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+T *to_device(const std::vector<T> &host)
+{
+    T *dev;
+    cudaError_t cuda_err = cudaMalloc(&dev, sizeof(T)*host.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev, host.data(), sizeof(T)*host.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    return dev;
+}
+
+template<typename T>
+void to_host(T *dev, std::vector<T> &host)
+{
+    cudaError_t cuda_err = cudaMemcpy(host.data(), dev,
+            sizeof(T)*host.size(), cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+
+template<typename T>
+void run_cuda(Index m, Index n, Index k, activation_t act,
+        std::vector<T> &src, std::vector<T> &mean,
+        std::vector<T> &inv_stddev, std::vector<T> &gamma,
+        std::vector<T> &beta, std::vector<T> &dst_grad,
+        std::vector<T> &y_grad, std::vector<T> &sum_grad,
+        std::vector<T> &sum_grad_xhat)
+{
+    // Copy to device
+    T *dev_src = to_device(src), *dev_mean = to_device(mean),
+      *dev_inv_stddev = to_device(inv_stddev), *dev_gamma = to_device(gamma),
+      *dev_beta = to_device(beta), *dev_dst_grad = to_device(dst_grad),
+      *dev_y_grad = to_device(y_grad), *dev_sum_grad = to_device(sum_grad),
+      *dev_sum_grad_xhat = to_device(sum_grad_xhat);
+    // Init stream
+    cudaStream_t stream;
+    cudaError_t cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, m, n, k, act, dev_src, dev_mean, dev_inv_stddev,
+            dev_gamma, dev_beta, dev_dst_grad, dev_y_grad, dev_sum_grad,
+            dev_sum_grad_xhat);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy results and deallocate device memory, inputs are not changed
+    to_host(dev_src, src);
+    to_host(dev_mean, mean);
+    to_host(dev_inv_stddev, inv_stddev);
+    to_host(dev_gamma, gamma);
+    to_host(dev_beta, beta);
+    to_host(dev_dst_grad, dst_grad);
+    to_host(dev_y_grad, y_grad);
+    to_host(dev_sum_grad, sum_grad);
+    to_host(dev_sum_grad_xhat, sum_grad_xhat);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check result against the reference, rounding errors grow with size of sums
+template<typename T>
+void check(Index size, const std::vector<T> &val,
+        const std::vector<double> &ref)
+{
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    const double tol = 10 * eps * (size+10);
+    for(Index i = 0; i < val.size(); ++i)
+    {
+        TEST_ASSERT(std::abs(val[i]-ref[i]) <= tol*(1+std::abs(ref[i])));
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k, activation_t act)
+{
+    constexpr double pi = 3.141592653589793238462643383279502884L;
+    const double f = std::sqrt(2.0/pi);
+    // Init test input
+    std::vector<T> src(m*n*k), mean(k), inv_stddev(k), gamma(k), beta(k),
+        dst_grad(m*n*k), y_grad(m*n*k), sum_grad(k), sum_grad_xhat(k);
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        src[i] = T(i%23)/T(4) - T((i/3)%13)/T(2);
+        dst_grad[i] = T(i%5)/T(3) - T((i/3)%7)/T(4);
+    }
+    for(Index i = 0; i < k; ++i)
+    {
+        mean[i] = T(i%5)/T(2) - T(1);
+        inv_stddev[i] = T(1) / T(i%3+1);
+        gamma[i] = T(i%7)/T(4) - T(0.5);
+        // Biases keep inputs of the activation away from its kink at zero
+        beta[i] = T(i%4)/T(3) - T(0.55);
+        sum_grad[i] = T(i%4) - T(1);
+        sum_grad_xhat[i] = T(i%3) - T(1);
+    }
+    // Get reference result in double precision
+    std::vector<double> y_grad_ref(m*n*k),
+        sum_grad_ref(sum_grad.begin(), sum_grad.end()),
+        sum_grad_xhat_ref(sum_grad_xhat.begin(), sum_grad_xhat.end());
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        Index l = (i/m) % k;
+        double xhat = (double(src[i])-mean[l]) * inv_stddev[l];
+        double z = xhat*gamma[l] + beta[l];
+        double dact = 1.0;
+        if(act == activation_t::RELU)
+        {
+            dact = z > 0 ? 1.0 : 0.0;
+        }
+        else if(act == activation_t::GELUTANH)
+        {
+            double th = std::tanh(f * (z+0.044715*z*z*z));
+            dact = 0.5*(1.0+th) + 0.5*z*(1.0-th*th)*f*(1.0+3*0.044715*z*z);
+        }
+        y_grad_ref[i] = dact * dst_grad[i];
+        sum_grad_ref[l] += y_grad_ref[i];
+        sum_grad_xhat_ref[l] += y_grad_ref[i] * xhat;
+    }
+    // Check low-level CPU kernel
+    std::vector<T> y_grad_cpu(y_grad), sum_grad_cpu(sum_grad),
+        sum_grad_xhat_cpu(sum_grad_xhat);
+    std::cout << "Run kernel::batch_norm_act_backward::cpu<T>\n";
+    cpu<T>(m, n, k, act, &src[0], &mean[0], &inv_stddev[0], &gamma[0],
+            &beta[0], &dst_grad[0], &y_grad_cpu[0], &sum_grad_cpu[0],
+            &sum_grad_xhat_cpu[0]);
+    check(1, y_grad_cpu, y_grad_ref);
+    check(m*n, sum_grad_cpu, sum_grad_ref);
+    check(m*n, sum_grad_xhat_cpu, sum_grad_xhat_ref);
+    std::cout << "OK: kernel::batch_norm_act_backward::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> y_grad_cuda(y_grad), sum_grad_cuda(sum_grad),
+        sum_grad_xhat_cuda(sum_grad_xhat);
+    std::cout << "Run kernel::batch_norm_act_backward::cuda<T>\n";
+    run_cuda<T>(m, n, k, act, src, mean, inv_stddev, gamma, beta, dst_grad,
+            y_grad_cuda, sum_grad_cuda, sum_grad_xhat_cuda);
+    check(1, y_grad_cuda, y_grad_ref);
+    check(m*n, sum_grad_cuda, sum_grad_ref);
+    check(m*n, sum_grad_xhat_cuda, sum_grad_xhat_ref);
+    std::cout << "OK: kernel::batch_norm_act_backward::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    // Features along rows and along columns of a matrix, including fibers
+    // that are reduced in shared memory of CUDA blocks
+    for(auto act: {activation_t::NONE, activation_t::RELU,
+            activation_t::GELUTANH})
+    {
+        validate<fp32_t>(1, 300, 70, act);
+        validate<fp32_t>(600, 50, 3, act);
+        validate<fp32_t>(7, 9, 11, act);
+        validate<fp64_t>(1, 300, 70, act);
+        validate<fp64_t>(600, 50, 3, act);
+        validate<fp64_t>(7, 9, 11, act);
+    }
+    return 0;
+}
+
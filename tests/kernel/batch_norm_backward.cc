@@ -0,0 +1,153 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/batch_norm_backward.cc
+ * Backward of batch normalization with stored statistics
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/batch_norm_backward.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::batch_norm_backward;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+T *to_device(const std::vector<T> &host)
+{
+    T *dev;
+    cudaError_t cuda_err = cudaMalloc(&dev, sizeof(T)*host.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev, host.data(), sizeof(T)*host.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    return dev;
+}
+
+template<typename T>
+void to_host(T *dev, std::vector<T> &host)
+{
+    cudaError_t cuda_err = cudaMemcpy(host.data(), dev,
+            sizeof(T)*host.size(), cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+
+template<typename T>
+void run_cuda(Index m, Index n, Index k, T alpha, std::vector<T> &src,
+        std::vector<T> &mean, std::vector<T> &inv_stddev,
+        std::vector<T> &gamma, std::vector<T> &sum_grad,
+        std::vector<T> &sum_grad_xhat, std::vector<T> &grad)
+{
+    // Copy to device
+    T *dev_src = to_device(src), *dev_mean = to_device(mean),
+      *dev_inv_stddev = to_device(inv_stddev), *dev_gamma = to_device(gamma),
+      *dev_sum_grad = to_device(sum_grad),
+      *dev_sum_grad_xhat = to_device(sum_grad_xhat),
+      *dev_grad = to_device(grad);
+    // Init stream
+    cudaStream_t stream;
+    cudaError_t cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, m, n, k, alpha, dev_src, dev_mean, dev_inv_stddev,
+            dev_gamma, dev_sum_grad, dev_sum_grad_xhat, dev_grad);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy results and deallocate device memory, inputs are not changed
+    to_host(dev_src, src);
+    to_host(dev_mean, mean);
+    to_host(dev_inv_stddev, inv_stddev);
+    to_host(dev_gamma, gamma);
+    to_host(dev_sum_grad, sum_grad);
+    to_host(dev_sum_grad_xhat, sum_grad_xhat);
+    to_host(dev_grad, grad);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check result against the reference
+template<typename T>
+void check(const std::vector<T> &val, const std::vector<double> &ref)
+{
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    for(Index i = 0; i < val.size(); ++i)
+    {
+        TEST_ASSERT(std::abs(val[i]-ref[i]) <= 50*eps*(1+std::abs(ref[i])));
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k)
+{
+    // Init test input
+    std::vector<T> src(m*n*k), mean(k), inv_stddev(k), gamma(k), sum_grad(k),
+        sum_grad_xhat(k), grad(m*n*k);
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        src[i] = T(i%23)/T(4) - T((i/3)%13)/T(2);
+        grad[i] = T(i%5)/T(3) - T((i/3)%7)/T(4);
+    }
+    for(Index i = 0; i < k; ++i)
+    {
+        mean[i] = T(i%5)/T(2) - T(1);
+        inv_stddev[i] = T(1) / T(i%3+1);
+        gamma[i] = T(i%7)/T(4) - T(0.5);
+        sum_grad[i] = T(i%4)*T(m*n)/T(3) - T(1);
+        sum_grad_xhat[i] = T(i%3)*T(m*n)/T(5) - T(1);
+    }
+    T alpha = T(1) / T(m*n);
+    // Get reference result in double precision
+    std::vector<double> grad_ref(m*n*k);
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        Index l = (i/m) % k;
+        double xhat = (double(src[i])-mean[l]) * inv_stddev[l];
+        grad_ref[i] = double(gamma[l]) * inv_stddev[l] * (grad[i]
+                - double(alpha)*(sum_grad[l]+xhat*sum_grad_xhat[l]));
+    }
+    // Check low-level CPU kernel
+    std::vector<T> grad_cpu(grad);
+    std::cout << "Run kernel::batch_norm_backward::cpu<T>\n";
+    cpu<T>(m, n, k, alpha, &src[0], &mean[0], &inv_stddev[0], &gamma[0],
+            &sum_grad[0], &sum_grad_xhat[0], &grad_cpu[0]);
+    check(grad_cpu, grad_ref);
+    std::cout << "OK: kernel::batch_norm_backward::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> grad_cuda(grad);
+    std::cout << "Run kernel::batch_norm_backward::cuda<T>\n";
+    run_cuda<T>(m, n, k, alpha, src, mean, inv_stddev, gamma, sum_grad,
+            sum_grad_xhat, grad_cuda);
+    check(grad_cuda, grad_ref);
+    std::cout << "OK: kernel::batch_norm_backward::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    // Features along rows and along columns of a matrix
+    validate<fp32_t>(1, 300, 70);
+    validate<fp32_t>(600, 50, 3);
+    validate<fp32_t>(7, 9, 11);
+    validate<fp64_t>(1, 300, 70);
+    validate<fp64_t>(600, 50, 3);
+    validate<fp64_t>(7, 9, 11);
+    return 0;
+}
+
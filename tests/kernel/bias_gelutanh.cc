@@ -0,0 +1,135 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/bias_gelutanh.cc
+ * Bias addition followed by approximate GeLU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#include "nntile/kernel/bias_gelutanh.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::bias_gelutanh;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, Index k, const std::vector<T> &bias,
+        std::vector<T> &src, std::vector<T> &dst)
+{
+    // Copy to device
+    T *dev_bias, *dev_src, *dev_dst;
+    cudaError_t cuda_err = cudaMalloc(&dev_bias, sizeof(T)*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_src, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_bias, &bias[0], sizeof(T)*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*m*n*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, m, n, k, dev_bias, dev_src, dev_dst);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&src[0], dev_src, sizeof(T)*m*n*k,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(T)*m*n*k,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_bias);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check result against the reference
+template<typename T>
+void check(const std::vector<T> &src, const std::vector<T> &dst,
+        const std::vector<double> &src_ref, const std::vector<double> &dst_ref)
+{
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        TEST_ASSERT(std::abs(src[i]-src_ref[i]) <= eps*std::abs(src_ref[i]));
+        TEST_ASSERT(std::abs(dst[i]-dst_ref[i])
+                <= 10*eps*(1+std::abs(dst_ref[i])));
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k)
+{
+    constexpr double pi = 3.141592653589793238462643383279502884L;
+    // Init test input
+    std::vector<T> bias(k), src(m*n*k), dst(m*n*k);
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        src[i] = T(i%23)/T(2) - T((i/3)%13);
+    }
+    for(Index i = 0; i < k; ++i)
+    {
+        bias[i] = T(i%7)/T(4) - T(1);
+    }
+    // Get reference result in double precision
+    std::vector<double> src_ref(m*n*k), dst_ref(m*n*k);
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        double z = T(src[i] + bias[(i/m)%k]);
+        src_ref[i] = z;
+        dst_ref[i] = 0.5 * z * (1.0+std::tanh(std::sqrt(2.0/pi)
+                    * (z+0.044715*z*z*z)));
+    }
+    // Check low-level CPU kernel
+    std::vector<T> src_cpu(src), dst_cpu(dst);
+    std::cout << "Run kernel::bias_gelutanh::cpu<T>\n";
+    cpu<T>(m, n, k, &bias[0], &src_cpu[0], &dst_cpu[0]);
+    check(src_cpu, dst_cpu, src_ref, dst_ref);
+    std::cout << "OK: kernel::bias_gelutanh::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> src_cuda(src), dst_cuda(dst);
+    std::cout << "Run kernel::bias_gelutanh::cuda<T>\n";
+    run_cuda<T>(m, n, k, bias, src_cuda, dst_cuda);
+    check(src_cuda, dst_cuda, src_ref, dst_ref);
+    std::cout << "OK: kernel::bias_gelutanh::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    // Bias along rows and along columns of a matrix
+    validate<fp32_t>(1, 30, 70);
+    validate<fp32_t>(300, 5, 1);
+    validate<fp32_t>(7, 9, 11);
+    validate<fp64_t>(1, 30, 70);
+    validate<fp64_t>(300, 5, 1);
+    validate<fp64_t>(7, 9, 11);
+    return 0;
+}
@@ -0,0 +1,152 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/bias_gelutanh_backward.cc
+ * Backward of bias addition followed by approximate GeLU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-06
+ * */
+
+#include "nntile/kernel/bias_gelutanh_backward.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::bias_gelutanh_backward;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, Index k, const std::vector<T> &src,
+        const std::vector<T> &dst_grad, std::vector<T> &src_grad,
+        std::vector<T> &bias_grad)
+{
+    // Copy to device
+    T *dev_src, *dev_dst_grad, *dev_src_grad, *dev_bias_grad;
+    cudaError_t cuda_err = cudaMalloc(&dev_src, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst_grad, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_src_grad, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_bias_grad, sizeof(T)*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*m*n*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_dst_grad, &dst_grad[0], sizeof(T)*m*n*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_bias_grad, &bias_grad[0], sizeof(T)*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, m, n, k, dev_src, dev_dst_grad, dev_src_grad,
+            dev_bias_grad);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&src_grad[0], dev_src_grad, sizeof(T)*m*n*k,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&bias_grad[0], dev_bias_grad, sizeof(T)*k,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst_grad);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src_grad);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_bias_grad);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check result against the reference, rounding errors grow with size of sums
+template<typename T>
+void check(Index size, const std::vector<T> &val,
+        const std::vector<double> &ref)
+{
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    const double tol = 10 * eps * (size+10);
+    for(Index i = 0; i < val.size(); ++i)
+    {
+        TEST_ASSERT(std::abs(val[i]-ref[i]) <= tol*(1+std::abs(ref[i])));
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k)
+{
+    constexpr double pi = 3.141592653589793238462643383279502884L;
+    const double f = std::sqrt(2.0/pi);
+    // Init test input
+    std::vector<T> src(m*n*k), dst_grad(m*n*k), src_grad(m*n*k), bias_grad(k);
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        src[i] = T(i%23)/T(2) - T((i/3)%13);
+        dst_grad[i] = T(i%5)/T(3) - T((i/3)%7)/T(4);
+        src_grad[i] = T(i%3) - T(1);
+    }
+    for(Index i = 0; i < k; ++i)
+    {
+        bias_grad[i] = T(i%4) - T(1);
+    }
+    // Get reference result in double precision
+    std::vector<double> src_grad_ref(m*n*k),
+        bias_grad_ref(bias_grad.begin(), bias_grad.end());
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        double z = src[i];
+        double th = std::tanh(f * (z+0.044715*z*z*z));
+        double grad = 0.5*(1.0+th) + 0.5*z*(1.0-th*th)*f*(1.0+3*0.044715*z*z);
+        src_grad_ref[i] = grad * dst_grad[i];
+        bias_grad_ref[(i/m)%k] += src_grad_ref[i];
+    }
+    // Check low-level CPU kernel
+    std::vector<T> src_grad_cpu(src_grad), bias_grad_cpu(bias_grad);
+    std::cout << "Run kernel::bias_gelutanh_backward::cpu<T>\n";
+    cpu<T>(m, n, k, &src[0], &dst_grad[0], &src_grad_cpu[0],
+            &bias_grad_cpu[0]);
+    check(1, src_grad_cpu, src_grad_ref);
+    check(m*n, bias_grad_cpu, bias_grad_ref);
+    std::cout << "OK: kernel::bias_gelutanh_backward::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> src_grad_cuda(src_grad), bias_grad_cuda(bias_grad);
+    std::cout << "Run kernel::bias_gelutanh_backward::cuda<T>\n";
+    run_cuda<T>(m, n, k, src, dst_grad, src_grad_cuda, bias_grad_cuda);
+    check(1, src_grad_cuda, src_grad_ref);
+    check(m*n, bias_grad_cuda, bias_grad_ref);
+    std::cout << "OK: kernel::bias_gelutanh_backward::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    // Bias along rows and along columns of a matrix, including fibers that
+    // are reduced in shared memory of CUDA blocks
+    validate<fp32_t>(1, 300, 70);
+    validate<fp32_t>(600, 50, 3);
+    validate<fp32_t>(7, 9, 11);
+    validate<fp64_t>(1, 300, 70);
+    validate<fp64_t>(600, 50, 3);
+    validate<fp64_t>(7, 9, 11);
+    return 0;
+}
@@ -9,7 +9,7 @@
  *
  * @version 1.0.0
  * @author Aleksandr Mikhalev
- * @date 2023-05-02
+ * @date 2024-01-29
  * */
 
 #include "nntile/kernel/conv2d.hh"
@@ -18,30 +18,37 @@
 #include <stdexcept>
 #include <limits>
 #include <iostream>
+#include <cmath>
 
 using namespace nntile;
 using namespace nntile::kernel::conv2d;
 
 #ifdef NNTILE_USE_CUDA
+// Operation of CUDA kernels: forward, backward over src or over kernel. All
+// of them have two inputs and an output with the same layout of arguments
+enum class Op {forward, backward_input, backward_weight};
+
 template<typename T>
-void run_cuda(Index nx, Index ny, const std::vector<T> &src,
-        Index mx, Index my, const std::vector<T> &kernel, std::vector<T> &dst)
+void run_cuda(Index offset_n, Index offset_m, Index batch, Index src_n,
+        Index src_m, const std::vector<T> &src, Index kernel_n,
+        Index kernel_m, const std::vector<T> &kernel, Index dst_n,
+        Index dst_m, std::vector<T> &dst, Op op=Op::forward)
 {
     // Copy to device
     T *dev_src, *dev_kernel, *dev_dst;
-    cudaError_t cuda_err = cudaMalloc(&dev_src, sizeof(T)*nx*ny);
+    cudaError_t cuda_err = cudaMalloc(&dev_src, sizeof(T)*src.size());
     TEST_ASSERT(cuda_err == cudaSuccess);
-    cuda_err = cudaMalloc(&dev_kernel, sizeof(T)*mx*my);
+    cuda_err = cudaMalloc(&dev_kernel, sizeof(T)*kernel.size());
     TEST_ASSERT(cuda_err == cudaSuccess);
-    cuda_err = cudaMalloc(&dev_dst, sizeof(T)*(nx+mx-1)*(ny+my-1));
+    cuda_err = cudaMalloc(&dev_dst, sizeof(T)*dst.size());
     TEST_ASSERT(cuda_err == cudaSuccess);
-    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*nx*ny,
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*src.size(),
             cudaMemcpyHostToDevice);
     TEST_ASSERT(cuda_err == cudaSuccess);
-    cuda_err = cudaMemcpy(dev_kernel, &kernel[0], sizeof(T)*mx*my,
+    cuda_err = cudaMemcpy(dev_kernel, &kernel[0], sizeof(T)*kernel.size(),
             cudaMemcpyHostToDevice);
     TEST_ASSERT(cuda_err == cudaSuccess);
-    cuda_err = cudaMemcpy(dev_dst, &dst[0], sizeof(T)*(nx+mx-1)*(ny+my-1),
+    cuda_err = cudaMemcpy(dev_dst, &dst[0], sizeof(T)*dst.size(),
             cudaMemcpyHostToDevice);
     TEST_ASSERT(cuda_err == cudaSuccess);
     // Init stream
@@ -49,11 +56,15 @@ void run_cuda(Index nx, Index ny, const std::vector<T> &src,
     cuda_err = cudaStreamCreate(&stream);
     TEST_ASSERT(cuda_err == cudaSuccess);
     // Launch low-level CUDA kernel
-    cuda<T>(stream, nx, ny, dev_src, mx, my, dev_kernel, dev_dst);
+    auto kernel_func = op == Op::forward ? cuda<T>
+        : op == Op::backward_input ? cuda_backward_input<T>
+        : cuda_backward_weight<T>;
+    kernel_func(stream, offset_n, offset_m, batch, src_n, src_m, dev_src,
+            kernel_n, kernel_m, dev_kernel, dst_n, dst_m, dev_dst);
     cuda_err = cudaStreamSynchronize(stream);
     TEST_ASSERT(cuda_err == cudaSuccess);
     // Copy result and deallocate device memory
-    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(T)*(nx+mx-1)*(ny+my-1),
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(T)*dst.size(),
             cudaMemcpyDeviceToHost);
     TEST_ASSERT(cuda_err == cudaSuccess);
     cuda_err = cudaFree(dev_src);
@@ -67,66 +78,244 @@ void run_cuda(Index nx, Index ny, const std::vector<T> &src,
 }
 #endif // NNTILE_USE_CUDA
 
-// Templated validation
+// Check result against the reference with a tolerance relative to norms
 template<typename T>
-void validate(Index nx, Index ny, Index px, Index py, Index mx, Index my, Index qx, Index qy)
+void check(const std::vector<T> &dst, const std::vector<T> &ref,
+        const std::vector<T> &ref_abs)
 {
     constexpr T eps = std::numeric_limits<T>::epsilon();
+    T max_abs = 0;
+    for(Index i = 0; i < ref_abs.size(); ++i)
+    {
+        max_abs = std::max(max_abs, ref_abs[i]);
+    }
+    for(Index i = 0; i < dst.size(); ++i)
+    {
+        TEST_ASSERT(std::abs(dst[i]-ref[i]) <= 100*eps*max_abs);
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index offset_n, Index offset_m, Index batch, Index src_n,
+        Index src_m, Index kernel_n, Index kernel_m, Index dst_n, Index dst_m)
+{
     // Init test input
-    std::vector<T> src(nx*ny), kernel(mx*my), dst((nx+mx-1)*(ny+my-1));
-    for(Index i0 = 0; i0 < ny+my-1; ++i0)
+    std::vector<T> src(batch*src_n*src_m), kernel(batch*kernel_n*kernel_m),
+        dst(batch*dst_n*dst_m);
+    for(Index i = 0; i < src.size(); ++i)
     {
-        for(Index i1 = 0; i1 < nx+mx-1; ++i1)
-        {
-			dst[i1*(ny+my-1)+i0] = -1;
-        }
+        src[i] = T(i%7) - T(3.5);
     }
-    for(Index i0 = 0; i0 < ny; ++i0)
+    for(Index i = 0; i < kernel.size(); ++i)
     {
-        for(Index i1 = 0; i1 < nx; ++i1)
-        {
-            src[i1*ny+i0] = (i0 == py && i1 == px) ? 1 : 0;
-        }
+        kernel[i] = T(1) / T(i%5+1);
+    }
+    for(Index i = 0; i < dst.size(); ++i)
+    {
+        dst[i] = T(i%3);
     }
-    for(Index i0 = 0; i0 < my; ++i0)
+    // Get reference result by definition in double precision
+    std::vector<T> ref(dst), ref_abs(dst.size());
+    for(Index b = 0; b < batch; ++b)
     {
-        for(Index i1 = 0; i1 < mx; ++i1)
+        for(Index d1 = 0; d1 < dst_n; ++d1)
         {
-            kernel[i1*my+i0] = (i0 == qy && i1 == qx) ? 1 : 0;
+            for(Index d2 = 0; d2 < dst_m; ++d2)
+            {
+                double sum = 0, sum_abs = std::abs(dst[(b*dst_n+d1)*dst_m+d2]);
+                for(Index j1 = 0; j1 < kernel_n; ++j1)
+                {
+                    Index i1 = d1 + offset_n - j1;
+                    if(i1 < 0 or i1 >= src_n)
+                    {
+                        continue;
+                    }
+                    for(Index j2 = 0; j2 < kernel_m; ++j2)
+                    {
+                        Index i2 = d2 + offset_m - j2;
+                        if(i2 < 0 or i2 >= src_m)
+                        {
+                            continue;
+                        }
+                        double val = double(src[(b*src_n+i1)*src_m+i2])
+                            * kernel[(b*kernel_n+j1)*kernel_m+j2];
+                        sum += val;
+                        sum_abs += std::abs(val);
+                    }
+                }
+                ref[(b*dst_n+d1)*dst_m+d2] += sum;
+                ref_abs[(b*dst_n+d1)*dst_m+d2] = sum_abs;
+            }
         }
     }
-    // Save original dst
-    std::vector<T> dst_save(dst);
-    // Check low-level CPU kernel
+    // Check low-level CPU kernels
+    std::vector<T> dst2(dst);
     std::cout << "Run kernel::conv2d::cpu<T>\n";
-    cpu<T>(nx, ny, &src[0], mx, my, &kernel[0], &dst[0]);
-    for(Index i0 = 0; i0 < ny + my - 1; ++i0)
+    cpu<T>(offset_n, offset_m, batch, src_n, src_m, &src[0], kernel_n,
+            kernel_m, &kernel[0], dst_n, dst_m, &dst2[0]);
+    check(dst2, ref, ref_abs);
+    std::cout << "OK: kernel::conv2d::cpu<T>\n";
+    dst2 = dst;
+    std::cout << "Run kernel::conv2d::cpu_direct<T>\n";
+    cpu_direct<T>(offset_n, offset_m, batch, src_n, src_m, &src[0], kernel_n,
+            kernel_m, &kernel[0], dst_n, dst_m, &dst2[0]);
+    check(dst2, ref, ref_abs);
+    std::cout << "OK: kernel::conv2d::cpu_direct<T>\n";
+    if(kernel_n == 3 and kernel_m == 3)
+    {
+        dst2 = dst;
+        std::cout << "Run kernel::conv2d::cpu_winograd<T>\n";
+        cpu_winograd<T>(offset_n, offset_m, batch, src_n, src_m, &src[0],
+                &kernel[0], dst_n, dst_m, &dst2[0]);
+        check(dst2, ref, ref_abs);
+        std::cout << "OK: kernel::conv2d::cpu_winograd<T>\n";
+    }
+#ifdef NNTILE_USE_CBLAS
+    dst2 = dst;
+    std::cout << "Run kernel::conv2d::cpu_im2col<T>\n";
+    cpu_im2col<T>(offset_n, offset_m, batch, src_n, src_m, &src[0], kernel_n,
+            kernel_m, &kernel[0], dst_n, dst_m, &dst2[0]);
+    check(dst2, ref, ref_abs);
+    std::cout << "OK: kernel::conv2d::cpu_im2col<T>\n";
+#endif // NNTILE_USE_CBLAS
+    dst2 = dst;
+    std::cout << "Run kernel::conv2d::cpu_fft<T>\n";
+    cpu_fft<T>(offset_n, offset_m, batch, src_n, src_m, &src[0], kernel_n,
+            kernel_m, &kernel[0], dst_n, dst_m, &dst2[0]);
+    check(dst2, ref, ref_abs);
+    std::cout << "OK: kernel::conv2d::cpu_fft<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    dst2 = dst;
+    std::cout << "Run kernel::conv2d::cuda<T>\n";
+    run_cuda<T>(offset_n, offset_m, batch, src_n, src_m, src, kernel_n,
+            kernel_m, kernel, dst_n, dst_m, dst2);
+    check(dst2, ref, ref_abs);
+    std::cout << "OK: kernel::conv2d::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+// Validation of gradients over src and kernel
+template<typename T>
+void validate_backward(Index offset_n, Index offset_m, Index batch,
+        Index src_n, Index src_m, Index kernel_n, Index kernel_m, Index dst_n,
+        Index dst_m)
+{
+    std::vector<T> src(batch*src_n*src_m), kernel(batch*kernel_n*kernel_m),
+        dst_grad(batch*dst_n*dst_m);
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        src[i] = T(i%7) - T(3.5);
+    }
+    for(Index i = 0; i < kernel.size(); ++i)
+    {
+        kernel[i] = T(1) / T(i%5+1);
+    }
+    for(Index i = 0; i < dst_grad.size(); ++i)
+    {
+        dst_grad[i] = T(i%3) - T(1);
+    }
+    // Gradients are accumulated into initial values
+    std::vector<T> src_grad(src.size(), T(1)), kernel_grad(kernel.size(),
+            T(-1));
+    std::vector<T> src_ref(src_grad), kernel_ref(kernel_grad),
+        src_abs(src.size()), kernel_abs(kernel.size());
+    for(Index b = 0; b < batch; ++b)
     {
-        for(Index i1 = 0; i1 < nx + mx - 1; ++i1)
+        for(Index i1 = 0; i1 < src_n; ++i1)
         {
-			T ref = (i0 == py+qy && i1 == px+qx) ? 1 : 0;
-            T val = dst[i1*(ny+my-1)+i0];
-            TEST_ASSERT(std::abs(val-ref) <= 10*eps);
+            for(Index i2 = 0; i2 < src_m; ++i2)
+            {
+                for(Index j1 = 0; j1 < kernel_n; ++j1)
+                {
+                    Index d1 = i1 + j1 - offset_n;
+                    if(d1 < 0 or d1 >= dst_n)
+                    {
+                        continue;
+                    }
+                    for(Index j2 = 0; j2 < kernel_m; ++j2)
+                    {
+                        Index d2 = i2 + j2 - offset_m;
+                        if(d2 < 0 or d2 >= dst_m)
+                        {
+                            continue;
+                        }
+                        Index i = (b*src_n+i1)*src_m + i2;
+                        Index j = (b*kernel_n+j1)*kernel_m + j2;
+                        T dy = dst_grad[(b*dst_n+d1)*dst_m+d2];
+                        src_ref[i] += dy * kernel[j];
+                        src_abs[i] += std::abs(dy * kernel[j]);
+                        kernel_ref[j] += dy * src[i];
+                        kernel_abs[j] += std::abs(dy * src[i]);
+                    }
+                }
+            }
         }
     }
-    std::cout << "OK: kernel::conv2d::cpu<T>\n";
+    for(Index i = 0; i < src_abs.size(); ++i)
+    {
+        src_abs[i] += 1;
+    }
+    for(Index i = 0; i < kernel_abs.size(); ++i)
+    {
+        kernel_abs[i] += 1;
+    }
+    std::vector<T> res(src_grad);
+    std::cout << "Run kernel::conv2d::cpu_backward_input<T>\n";
+    cpu_backward_input<T>(offset_n, offset_m, batch, dst_n, dst_m,
+            &dst_grad[0], kernel_n, kernel_m, &kernel[0], src_n, src_m,
+            &res[0]);
+    check(res, src_ref, src_abs);
+    std::cout << "OK: kernel::conv2d::cpu_backward_input<T>\n";
+    res = kernel_grad;
+    std::cout << "Run kernel::conv2d::cpu_backward_weight<T>\n";
+    cpu_backward_weight<T>(offset_n, offset_m, batch, src_n, src_m, &src[0],
+            dst_n, dst_m, &dst_grad[0], kernel_n, kernel_m, &res[0]);
+    check(res, kernel_ref, kernel_abs);
+    std::cout << "OK: kernel::conv2d::cpu_backward_weight<T>\n";
+#ifdef NNTILE_USE_CUDA
+    res = src_grad;
+    std::cout << "Run kernel::conv2d::cuda_backward_input<T>\n";
+    run_cuda<T>(offset_n, offset_m, batch, dst_n, dst_m, dst_grad, kernel_n,
+            kernel_m, kernel, src_n, src_m, res, Op::backward_input);
+    check(res, src_ref, src_abs);
+    std::cout << "OK: kernel::conv2d::cuda_backward_input<T>\n";
+    res = kernel_grad;
+    std::cout << "Run kernel::conv2d::cuda_backward_weight<T>\n";
+    run_cuda<T>(offset_n, offset_m, batch, src_n, src_m, src, dst_n, dst_m,
+            dst_grad, kernel_n, kernel_m, res, Op::backward_weight);
+    check(res, kernel_ref, kernel_abs);
+    std::cout << "OK: kernel::conv2d::cuda_backward_weight<T>\n";
+#endif // NNTILE_USE_CUDA
 }
 
-void validate_all(Index nx, Index ny, Index px, Index py, Index mx, Index my, Index qx, Index qy){
-	validate<fp32_t>(nx, ny, px, py, mx, my, qx, qy);
-	validate<fp32_t>(mx, my, qx, qy, nx, ny, px, py);
-	validate<fp64_t>(nx, ny, px, py, mx, my, qx, qy);
-	validate<fp64_t>(mx, my, qx, qy, nx, ny, px, py);
+// Check both orders of arguments and full output as well as a window of it
+void validate_all(Index batch, Index nx, Index ny, Index mx, Index my)
+{
+    validate<fp32_t>(0, 0, batch, nx, ny, mx, my, nx+mx-1, ny+my-1);
+    validate<fp32_t>(0, 0, batch, mx, my, nx, ny, nx+mx-1, ny+my-1);
+    validate<fp64_t>(0, 0, batch, nx, ny, mx, my, nx+mx-1, ny+my-1);
+    validate<fp64_t>(0, 0, batch, mx, my, nx, ny, nx+mx-1, ny+my-1);
+    validate<fp32_t>(mx/2, my/2, batch, nx, ny, mx, my, nx, ny);
+    validate<fp64_t>(mx/2, my/2, batch, nx, ny, mx, my, nx, ny);
+    validate<fp32_t>(-2, 3, batch, nx, ny, mx, my, nx+1, ny+2);
+    validate<fp64_t>(-2, 3, batch, nx, ny, mx, my, nx+1, ny+2);
+    validate_backward<fp32_t>(0, 0, batch, nx, ny, mx, my, nx+mx-1,
+            ny+my-1);
+    validate_backward<fp64_t>(mx/2, my/2, batch, nx, ny, mx, my, nx, ny);
+    validate_backward<fp64_t>(-2, 3, batch, nx, ny, mx, my, nx+1, ny+2);
 }
 
 int main(int argc, char **argv)
 {
-	validate_all(4, 4, 0, 0, 1, 1, 0, 0);
-	validate_all(5, 7, 0, 0, 1, 1, 0, 0);
-	validate_all(4, 4, 0, 0, 3, 3, 0, 0);
-	validate_all(5, 7, 0, 0, 4, 9, 0, 0);
-	validate_all(5, 7, 1, 4, 4, 9, 2, 5);
-
+    validate_all(1, 4, 4, 1, 1);
+    validate_all(1, 5, 7, 1, 1);
+    validate_all(2, 4, 4, 3, 3);
+    validate_all(2, 9, 6, 3, 3);
+    validate_all(1, 2, 1, 3, 3);
+    validate_all(1, 5, 7, 4, 9);
+    validate_all(3, 20, 17, 11, 6);
+    validate_all(1, 40, 33, 19, 23);
     return 0;
 }
-
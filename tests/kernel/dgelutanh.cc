@@ -14,10 +14,12 @@
 
 #include "nntile/kernel/dgelutanh.hh"
 #include "nntile/kernel/gelutanh_inplace.hh"
+#include "nntile/kernel/simd.hh"
 #include "../testing.hh"
 #include <vector>
 #include <stdexcept>
 #include <cmath>
+#include <limits>
 #include <iostream>
 
 using namespace nntile;
@@ -54,6 +56,20 @@ void run_cuda(Index nelems, std::vector<T> &data)
 }
 #endif // NNTILE_USE_CUDA
 
+// Bound on difference of vectorized and scalar versions, that is 8+2|f(z)|
+// ulp of the sum of absolute values of the terms of the derivative
+template<typename T>
+T simd_bound(T z)
+{
+    constexpr T pi = 3.141592653589793238462643383279502884L;
+    const T f3 = -T{2}*std::sqrt(T{2}/pi), f4 = f3*T{0.044715},
+        f5 = T{3}*f4;
+    T f = z * (f3+f4*z*z);
+    T inv = T{1} / (std::exp(f)+T{1});
+    T terms = inv + std::abs(z*(f3+f5*z*z))*(T{1}-inv)*inv;
+    return (8+2*std::abs(f)) * std::numeric_limits<T>::epsilon() * terms;
+}
+
 // Templated validation
 template<typename T>
 void validate(Index nelems)
@@ -67,7 +83,9 @@ void validate(Index nelems)
         data[i] = T(2*i+1-nelems) / T{1000};
     }
     std::vector<T> data_save(data);
-    // Check low-level CPU kernel
+    // Check low-level CPU kernel without vectorization
+    using kernel::simd::Level;
+    kernel::simd::set_level(Level::NONE);
     std::cout << "Run kernel::dgelutanh::cpu<T>\n";
     cpu<T>(nelems, &data[0]);
     for(Index i = 0; i < nelems; ++i)
@@ -105,6 +123,26 @@ void validate(Index nelems)
         TEST_ASSERT(data[i] >= val_ref_min and data[i] <= val_ref_max);
     }
     std::cout << "OK: kernel::dgelutanh::cpu<T>\n";
+    // Compare vectorized versions against the scalar one
+    std::vector<T> data_scalar(data);
+    for(Level level: {Level::AVX2, Level::AVX512})
+    {
+        if(kernel::simd::set_level(level) != level)
+        {
+            continue;
+        }
+        data = data_save;
+        std::cout << "Run kernel::dgelutanh::cpu<T> with SIMD level "
+            << static_cast<int>(level) << "\n";
+        cpu<T>(nelems, &data[0]);
+        for(Index i = 0; i < nelems; ++i)
+        {
+            T diff = std::abs(data[i] - data_scalar[i]);
+            TEST_ASSERT(diff <= simd_bound(data_save[i]));
+        }
+        std::cout << "OK: kernel::dgelutanh::cpu<T>\n";
+    }
+    kernel::simd::set_level(Level::AVX512);
 #ifdef NNTILE_USE_CUDA
     // Check low-level CUDA kernel
     data = data_save;
@@ -172,9 +210,11 @@ int main(int argc, char **argv)
     validate<fp32_t>(0);
     validate<fp32_t>(1);
     validate<fp32_t>(80000);
+    validate<fp32_t>(1002);
     validate<fp64_t>(0);
     validate<fp64_t>(1);
     validate<fp64_t>(80000);
+    validate<fp64_t>(1002);
     return 0;
 }
 
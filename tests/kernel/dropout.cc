@@ -0,0 +1,161 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/dropout.cc
+ * Dropout operation with regenerated mask
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/dropout.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::dropout;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index nelems, unsigned long long seed, Index sequence, T p,
+        const std::vector<T> &src, T beta, std::vector<T> &dst)
+{
+    // Copy to device
+    T *dev_src, *dev_dst;
+    cudaError_t cuda_err = cudaMalloc(&dev_src, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_dst, &dst[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, nelems, seed, sequence, p, dev_src, beta, dev_dst);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(T)*nelems,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Run tests for the given precision
+template<typename T>
+void validate(Index nelems, T p)
+{
+    unsigned long long seed = 1000000007ULL;
+    Index sequence = 3;
+    std::vector<T> src(nelems), dst(nelems), dst2(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        src[i] = T(i+1);
+        dst[i] = T(-1);
+    }
+    // Check forward pass
+    std::cout << "Run kernel::dropout::cpu<T>\n";
+    cpu<T>(nelems, seed, sequence, p, &src[0], T{0}, &dst[0]);
+    Index ndropped = 0;
+    for(Index i = 0; i < nelems; ++i)
+    {
+        if(dst[i] == T{0})
+        {
+            ++ndropped;
+        }
+        else
+        {
+            TEST_ASSERT(std::abs(dst[i]*(T{1}-p)-src[i]) <= 1e-6*src[i]);
+        }
+    }
+    // Fraction of dropped elements is close to p
+    if(nelems >= 10000)
+    {
+        T frac = T(ndropped) / T(nelems);
+        TEST_ASSERT(std::abs(frac-p) <= 5*std::sqrt(p*(1-p)/nelems)+1e-6);
+    }
+    if(p == T{0})
+    {
+        TEST_ASSERT(ndropped == 0);
+    }
+    // Backward regenerates the same mask and accumulates
+    for(Index i = 0; i < nelems; ++i)
+    {
+        dst2[i] = T(1);
+    }
+    cpu<T>(nelems, seed, sequence, p, &src[0], T{1}, &dst2[0]);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(dst2[i] == T(1)+dst[i]);
+    }
+    // The same result inplace
+    dst2 = src;
+    cpu<T>(nelems, seed, sequence, p, &dst2[0], T{0}, &dst2[0]);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(dst2[i] == dst[i]);
+    }
+    // Another sequence gives another mask
+    if(nelems >= 10000 and p > T{0})
+    {
+        cpu<T>(nelems, seed, sequence+1, p, &src[0], T{0}, &dst2[0]);
+        Index ndiff = 0;
+        for(Index i = 0; i < nelems; ++i)
+        {
+            if((dst[i] == T{0}) != (dst2[i] == T{0}))
+            {
+                ++ndiff;
+            }
+        }
+        TEST_ASSERT(ndiff > 0);
+    }
+    std::cout << "OK: kernel::dropout::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // CUDA produces the same mask
+    std::cout << "Run kernel::dropout::cuda<T>\n";
+    for(Index i = 0; i < nelems; ++i)
+    {
+        dst2[i] = T(1);
+    }
+    run_cuda<T>(nelems, seed, sequence, p, src, T{1}, dst2);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(std::abs(dst2[i]-T(1)-dst[i]) <= 1e-6*src[i]);
+    }
+    std::cout << "OK: kernel::dropout::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(0, 0.5);
+    validate<fp32_t>(7, 0.5);
+    validate<fp32_t>(100000, 0.0);
+    validate<fp32_t>(100000, 0.1);
+    validate<fp32_t>(100001, 0.9);
+    validate<fp64_t>(0, 0.5);
+    validate<fp64_t>(7, 0.5);
+    validate<fp64_t>(100000, 0.0);
+    validate<fp64_t>(100000, 0.1);
+    validate<fp64_t>(100001, 0.9);
+    return 0;
+}
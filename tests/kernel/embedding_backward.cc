@@ -0,0 +1,166 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/embedding_backward.cc
+ * Backward embeddings from vocabulary on a buffer
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-13
+ * */
+
+#include "nntile/kernel/embedding_backward.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <cmath>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::embedding_backward;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, Index k, Index k_start, Index k_size,
+        Index vocab_start, Index vocab_size, const std::vector<Index> &index,
+        const std::vector<T> &embed, std::vector<T> &vocab)
+{
+    // Allocate on device
+    Index *dev_index, *dev_tmp;
+    T *dev_embed, *dev_vocab;
+    cudaError_t cuda_err = cudaMalloc(&dev_index, sizeof(Index)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_tmp, sizeof(Index)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_embed, sizeof(T)*embed.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_vocab, sizeof(T)*vocab.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy to device
+    cuda_err = cudaMemcpy(dev_index, &index[0], sizeof(Index)*m*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_embed, &embed[0], sizeof(T)*embed.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_vocab, &vocab[0], sizeof(T)*vocab.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, m, n, k, k_start, k_size, vocab_start, vocab_size,
+            dev_index, dev_embed, dev_vocab+k_size*vocab_start, dev_tmp);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&vocab[0], dev_vocab, sizeof(T)*vocab.size(),
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_index);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_tmp);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_embed);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_vocab);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k, Index k_start, Index k_size,
+        Index vocab_size, Index shard_start, Index shard_size)
+{
+    // Only the shard [shard_start, shard_start+shard_size) of vocabulary is
+    // updated
+    // Init test input with many repeated tokens
+    std::vector<Index> index(m*n);
+    for(Index i = 0; i < m*n; ++i)
+    {
+        index[i] = (i*i+3*i) % vocab_size;
+    }
+    std::vector<T> embed(m*k*n);
+    for(Index i = 0; i < m*k*n; ++i)
+    {
+        embed[i] = T(2*i+1-m*k*n) / T{1000};
+    }
+    std::vector<T> vocab_init(k_size*vocab_size);
+    for(Index i = 0; i < k_size*vocab_size; ++i)
+    {
+        vocab_init[i] = T(i) / T{10};
+    }
+    // Naive reference in the order of positions
+    std::vector<T> vocab_ref(vocab_init);
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i1 = 0; i1 < m; ++i1)
+        {
+            Index token = index[i2*m+i1];
+            if(token < shard_start or token >= shard_start+shard_size)
+            {
+                continue;
+            }
+            for(Index i0 = 0; i0 < k_size; ++i0)
+            {
+                vocab_ref[token*k_size+i0] +=
+                    embed[(i2*k+k_start+i0)*m+i1];
+            }
+        }
+    }
+    // Check low-level kernel
+    std::vector<T> vocab(vocab_init);
+    std::vector<Index> tmp(m*n);
+    std::cout << "Run kernel::embedding_backward::cpu<T>\n";
+    cpu<T>(m, n, k, k_start, k_size, shard_start, shard_size, &index[0],
+            &embed[0], &vocab[k_size*shard_start], &tmp[0]);
+    for(Index i = 0; i < k_size*vocab_size; ++i)
+    {
+        T diff = std::abs(vocab[i]-vocab_ref[i]);
+        TEST_ASSERT(diff <= 10*T{1e-6}*(std::abs(vocab_ref[i])+1));
+    }
+    // Result shall not depend on anything but inputs
+    std::vector<T> vocab2(vocab_init);
+    cpu<T>(m, n, k, k_start, k_size, shard_start, shard_size, &index[0],
+            &embed[0], &vocab2[k_size*shard_start], &tmp[0]);
+    for(Index i = 0; i < k_size*vocab_size; ++i)
+    {
+        TEST_ASSERT(vocab[i] == vocab2[i]);
+    }
+    std::cout << "OK: kernel::embedding_backward::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> vocab_cuda(vocab_init);
+    std::cout << "Run kernel::embedding_backward::cuda<T>\n";
+    run_cuda<T>(m, n, k, k_start, k_size, shard_start, shard_size, index,
+            embed, vocab_cuda);
+    for(Index i = 0; i < k_size*vocab_size; ++i)
+    {
+        T diff = std::abs(vocab_cuda[i]-vocab_ref[i]);
+        TEST_ASSERT(diff <= 10*T{1e-6}*(std::abs(vocab_ref[i])+1));
+    }
+    std::cout << "OK: kernel::embedding_backward::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, 1, 1, 0, 1, 1, 0, 1);
+    validate<fp32_t>(10, 20, 30, 5, 15, 7, 0, 7);
+    validate<fp32_t>(32, 33, 16, 0, 16, 1000, 0, 1000);
+    validate<fp32_t>(32, 33, 16, 0, 16, 1000, 400, 300);
+    validate<fp64_t>(1, 1, 1, 0, 1, 1, 0, 1);
+    validate<fp64_t>(10, 20, 30, 5, 15, 7, 0, 7);
+    validate<fp64_t>(32, 33, 16, 0, 16, 1000, 0, 1000);
+    validate<fp64_t>(32, 33, 16, 0, 16, 1000, 400, 300);
+    return 0;
+}
+
@@ -0,0 +1,189 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/embedding_pos_backward.cc
+ * Backward of embeddings of tokens and positions
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/embedding_pos_backward.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <cmath>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::embedding_pos_backward;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, Index k, Index k_start, Index k_size,
+        Index pos_size, const std::vector<Index> &index,
+        const std::vector<Index> &pos, const std::vector<T> &embed,
+        std::vector<T> &vocab, std::vector<T> &pos_vocab)
+{
+    // Allocate on device
+    Index *dev_index, *dev_pos, *dev_tmp;
+    T *dev_embed, *dev_vocab, *dev_pos_vocab;
+    cudaError_t cuda_err = cudaMalloc(&dev_index, sizeof(Index)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_pos, sizeof(Index)*pos_size);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_tmp, sizeof(Index)*(m*n+pos_size));
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_embed, sizeof(T)*embed.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_vocab, sizeof(T)*vocab.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_pos_vocab, sizeof(T)*pos_vocab.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy to device
+    cuda_err = cudaMemcpy(dev_index, &index[0], sizeof(Index)*m*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_pos, &pos[0], sizeof(Index)*pos_size,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_embed, &embed[0], sizeof(T)*embed.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_vocab, &vocab[0], sizeof(T)*vocab.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_pos_vocab, &pos_vocab[0],
+            sizeof(T)*pos_vocab.size(), cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, m, n, k, k_start, k_size, pos_size, dev_index, dev_pos,
+            dev_embed, dev_vocab, dev_pos_vocab, dev_tmp);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&vocab[0], dev_vocab, sizeof(T)*vocab.size(),
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&pos_vocab[0], dev_pos_vocab,
+            sizeof(T)*pos_vocab.size(), cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_index);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_pos);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_tmp);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_embed);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_vocab);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_pos_vocab);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check result against the reference
+template<typename T>
+void check(const std::vector<T> &val, const std::vector<T> &ref)
+{
+    for(Index i = 0; i < val.size(); ++i)
+    {
+        T diff = std::abs(val[i]-ref[i]);
+        TEST_ASSERT(diff <= 10*T{1e-6}*(std::abs(ref[i])+1));
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k, Index k_start, Index k_size,
+        Index pos_size, Index vocab_size, Index max_pos)
+{
+    // Init test input with repeated tokens and positions, positions are
+    // repeated over the rest of tokens
+    std::vector<Index> index(m*n), pos(pos_size);
+    for(Index i = 0; i < m*n; ++i)
+    {
+        index[i] = (i*i+3*i) % vocab_size;
+    }
+    for(Index i = 0; i < pos_size; ++i)
+    {
+        pos[i] = (5*i+1) % max_pos;
+    }
+    std::vector<T> embed(m*k*n);
+    for(Index i = 0; i < m*k*n; ++i)
+    {
+        embed[i] = T(2*i+1-m*k*n) / T{1000};
+    }
+    std::vector<T> vocab_init(k_size*vocab_size), pos_init(k_size*max_pos);
+    for(Index i = 0; i < k_size*vocab_size; ++i)
+    {
+        vocab_init[i] = T(i) / T{10};
+    }
+    for(Index i = 0; i < k_size*max_pos; ++i)
+    {
+        pos_init[i] = T(1-i) / T{4};
+    }
+    // Naive reference in the order of positions
+    std::vector<T> vocab_ref(vocab_init), pos_ref(pos_init);
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i1 = 0; i1 < m; ++i1)
+        {
+            Index token = i2*m + i1;
+            for(Index i0 = 0; i0 < k_size; ++i0)
+            {
+                T val = embed[(i2*k+k_start+i0)*m+i1];
+                vocab_ref[index[token]*k_size+i0] += val;
+                pos_ref[pos[token%pos_size]*k_size+i0] += val;
+            }
+        }
+    }
+    // Check low-level kernel
+    std::vector<T> vocab(vocab_init), pos_vocab(pos_init);
+    std::vector<Index> tmp(m*n+pos_size);
+    std::cout << "Run kernel::embedding_pos_backward::cpu<T>\n";
+    cpu<T>(m, n, k, k_start, k_size, pos_size, &index[0], &pos[0],
+            &embed[0], &vocab[0], &pos_vocab[0], &tmp[0]);
+    check(vocab, vocab_ref);
+    check(pos_vocab, pos_ref);
+    // Result shall not depend on anything but inputs
+    std::vector<T> vocab2(vocab_init), pos_vocab2(pos_init);
+    cpu<T>(m, n, k, k_start, k_size, pos_size, &index[0], &pos[0],
+            &embed[0], &vocab2[0], &pos_vocab2[0], &tmp[0]);
+    TEST_ASSERT(vocab == vocab2);
+    TEST_ASSERT(pos_vocab == pos_vocab2);
+    std::cout << "OK: kernel::embedding_pos_backward::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> vocab_cuda(vocab_init), pos_vocab_cuda(pos_init);
+    std::cout << "Run kernel::embedding_pos_backward::cuda<T>\n";
+    run_cuda<T>(m, n, k, k_start, k_size, pos_size, index, pos, embed,
+            vocab_cuda, pos_vocab_cuda);
+    check(vocab_cuda, vocab_ref);
+    check(pos_vocab_cuda, pos_ref);
+    std::cout << "OK: kernel::embedding_pos_backward::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, 1, 1, 0, 1, 1, 1, 1);
+    validate<fp32_t>(10, 20, 30, 5, 15, 40, 7, 13);
+    validate<fp32_t>(1, 60, 16, 0, 16, 20, 1000, 20);
+    validate<fp64_t>(1, 1, 1, 0, 1, 1, 1, 1);
+    validate<fp64_t>(10, 20, 30, 5, 15, 40, 7, 13);
+    validate<fp64_t>(1, 60, 16, 0, 16, 20, 1000, 20);
+    return 0;
+}
+
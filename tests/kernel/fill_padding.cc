@@ -0,0 +1,119 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/fill_padding.cc
+ * Fill padding of a tile beyond a logical extent along an axis
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/fill_padding.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::fill_padding;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, Index k, Index k_start, T val,
+        std::vector<T> &data)
+{
+    // Copy to device
+    Index nelems = m * n * k;
+    T *dev_data;
+    cudaError_t cuda_err = cudaMalloc(&dev_data, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_data, &data[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, m, n, k, k_start, val, dev_data);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&data[0], dev_data, sizeof(T)*nelems,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_data);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check that only padding is overwritten
+template<typename T>
+void check(Index m, Index n, Index k, Index k_start, T val,
+        const std::vector<T> &data, const std::vector<T> &data_save)
+{
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i1 = 0; i1 < k; ++i1)
+        {
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                Index i = (i2*k+i1)*m + i0;
+                if(i1 < k_start)
+                {
+                    TEST_ASSERT(data[i] == data_save[i]);
+                }
+                else
+                {
+                    TEST_ASSERT(data[i] == val);
+                }
+            }
+        }
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k, Index k_start)
+{
+    T val = -1.0;
+    // Init test input
+    Index nelems = m * n * k;
+    std::vector<T> data(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        data[i] = T(i+1);
+    }
+    std::vector<T> data_save(data);
+    // Check low-level kernel
+    std::cout << "Run kernel::fill_padding::cpu<T>\n";
+    cpu<T>(m, n, k, k_start, val, &data[0]);
+    check<T>(m, n, k, k_start, val, data, data_save);
+    std::cout << "OK: kernel::fill_padding::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    data = data_save;
+    std::cout << "Run kernel::fill_padding::cuda<T>\n";
+    run_cuda<T>(m, n, k, k_start, val, data);
+    check<T>(m, n, k, k_start, val, data, data_save);
+    std::cout << "OK: kernel::fill_padding::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, 1, 1, 0);
+    validate<fp32_t>(3, 5, 7, 4);
+    validate<fp32_t>(20, 30, 10, 9);
+    validate<fp64_t>(1, 1, 1, 0);
+    validate<fp64_t>(3, 5, 7, 4);
+    validate<fp64_t>(20, 30, 10, 9);
+    return 0;
+}
+
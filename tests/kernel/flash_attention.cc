@@ -0,0 +1,269 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/flash_attention.cc
+ * Fused single-pass flash attention forward
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#include "nntile/kernel/flash_attention.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+using namespace nntile;
+using namespace nntile::kernel::flash_attention;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index seq, Index head, Index batch, Index n_batch,
+        Index kv_group, const std::vector<T> &K, const std::vector<T> &Q,
+        const bool_t *mask, const std::vector<T> &V, std::vector<T> &maxsumexp,
+        std::vector<T> &A)
+{
+    // Alloc on device
+    T *dev_K, *dev_Q, *dev_V, *dev_maxsumexp, *dev_A;
+    bool_t *dev_mask = nullptr;
+    Index nelems = head * seq * batch, kv_nelems = nelems / kv_group;
+    cudaError_t cuda_err = cudaMalloc(&dev_K, sizeof(T)*kv_nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_Q, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_V, sizeof(T)*kv_nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_A, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_maxsumexp, sizeof(T)*2*seq*batch);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Causal mask is not copied
+    if(mask)
+    {
+        cuda_err = cudaMalloc(&dev_mask, sizeof(bool_t)*seq*seq);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+        cuda_err = cudaMemcpy(dev_mask, mask, sizeof(bool_t)*seq*seq,
+                cudaMemcpyHostToDevice);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+    }
+    // Copy to device
+    cuda_err = cudaMemcpy(dev_K, &K[0], sizeof(T)*kv_nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_Q, &Q[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_V, &V[0], sizeof(T)*kv_nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_A, &A[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_maxsumexp, &maxsumexp[0], sizeof(T)*2*seq*batch,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, seq, head, batch, n_batch, kv_group, dev_K, dev_Q,
+            dev_mask, dev_V, dev_maxsumexp, dev_A);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&A[0], dev_A, sizeof(T)*nelems,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&maxsumexp[0], dev_maxsumexp, sizeof(T)*2*seq*batch,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_K);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_Q);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_V);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_A);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_maxsumexp);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_mask);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check result against explicitly computed attention over two tiles of keys
+template<typename T>
+void check(Index seq, Index head, Index batch, Index n_batch, Index kv_group,
+        const std::vector<T> (&K)[2], const std::vector<T> &Q,
+        const bool_t *mask[2], const std::vector<T> (&V)[2],
+        const std::vector<T> &maxsumexp, const std::vector<T> &A)
+{
+    constexpr T eps = T(10) * std::numeric_limits<T>::epsilon();
+    const T scale = T(1) / std::sqrt(T(head));
+    std::vector<T> score(2*seq), A_ref(head);
+    for(Index b = 0; b < batch; ++b)
+    {
+        // Head of keys and values, that is shared by kv_group heads
+        Index b_kv = b%n_batch + n_batch*(b/(n_batch*kv_group));
+        for(Index q = 0; q < seq; ++q)
+        {
+            T max = -std::numeric_limits<T>::infinity(), sum = 0;
+            for(Index t = 0; t < 2; ++t)
+            {
+                for(Index k = 0; k < seq; ++k)
+                {
+                    T s = 0;
+                    for(Index h = 0; h < head; ++h)
+                    {
+                        s += K[t][(b_kv*seq+k)*head+h]
+                            * Q[(b*seq+q)*head+h];
+                    }
+                    score[t*seq+k] = scale * s;
+                    if(mask[t][q*seq+k] and max < scale*s)
+                    {
+                        max = scale * s;
+                    }
+                }
+            }
+            for(Index h = 0; h < head; ++h)
+            {
+                A_ref[h] = 0;
+            }
+            for(Index t = 0; t < 2; ++t)
+            {
+                for(Index k = 0; k < seq; ++k)
+                {
+                    if(mask[t][q*seq+k])
+                    {
+                        T p = std::exp(score[t*seq+k]-max);
+                        sum += p;
+                        for(Index h = 0; h < head; ++h)
+                        {
+                            A_ref[h] += p * V[t][(b_kv*seq+k)*head+h];
+                        }
+                    }
+                }
+            }
+            Index i = b*seq + q;
+            TEST_ASSERT(std::abs(maxsumexp[2*i]-max)
+                    <= eps*(1+std::abs(max)));
+            TEST_ASSERT(std::abs(maxsumexp[2*i+1]-sum) <= eps*sum);
+            for(Index h = 0; h < head; ++h)
+            {
+                T val = A_ref[h] / sum;
+                TEST_ASSERT(std::abs(A[i*head+h]-val)
+                        <= eps*(1+std::abs(val)));
+            }
+        }
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index seq, Index head, Index batch, Index n_batch=1,
+        Index kv_group=1)
+{
+    // Init test input: two tiles of keys and values for a tile of queries
+    Index nelems = head * seq * batch, kv_nelems = nelems / kv_group;
+    std::vector<T> K[2], V[2], Q(nelems);
+    for(Index t = 0; t < 2; ++t)
+    {
+        K[t].resize(kv_nelems);
+        V[t].resize(kv_nelems);
+        for(Index i = 0; i < kv_nelems; ++i)
+        {
+            K[t][i] = T(((3*i+7*t) % 23) - 11) / T{10};
+            V[t][i] = T(((5*i+t) % 17) - 8) / T{8};
+        }
+    }
+    for(Index i = 0; i < nelems; ++i)
+    {
+        Q[i] = T((i % 19) - 9) / T{7};
+    }
+    // Causal-like mask for the first tile, full one for the second one. The
+    // first query of the second tile sees nothing at all.
+    std::unique_ptr<bool_t[]> mask0(new bool_t[seq*seq]),
+        mask1(new bool_t[seq*seq]);
+    for(Index q = 0; q < seq; ++q)
+    {
+        for(Index k = 0; k < seq; ++k)
+        {
+            mask0[q*seq+k] = bool_t(k <= q);
+            mask1[q*seq+k] = bool_t(q > 0);
+        }
+    }
+    const bool_t *mask[2] = {&mask0[0], &mask1[0]};
+    // The first tile is causal, so it is also generated out of indices
+    const bool_t *mask_causal[2] = {nullptr, &mask1[0]};
+    // Check low-level kernel
+    std::vector<T> maxsumexp(2*seq*batch, T{0}), A(nelems, T{0});
+    std::cout << "Run kernel::flash_attention::cpu<T>\n";
+    for(Index t = 0; t < 2; ++t)
+    {
+        cpu<T>(seq, head, batch, n_batch, kv_group, &K[t][0], &Q[0], mask[t],
+                &V[t][0], &maxsumexp[0], &A[0]);
+    }
+    check<T>(seq, head, batch, n_batch, kv_group, K, Q, mask, V, maxsumexp,
+            A);
+    std::fill(maxsumexp.begin(), maxsumexp.end(), T{0});
+    std::fill(A.begin(), A.end(), T{0});
+    for(Index t = 0; t < 2; ++t)
+    {
+        cpu<T>(seq, head, batch, n_batch, kv_group, &K[t][0], &Q[0],
+                mask_causal[t], &V[t][0], &maxsumexp[0], &A[0]);
+    }
+    check<T>(seq, head, batch, n_batch, kv_group, K, Q, mask, V, maxsumexp,
+            A);
+    std::cout << "OK: kernel::flash_attention::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> maxsumexp_cuda(2*seq*batch, T{0}), A_cuda(nelems, T{0});
+    std::cout << "Run kernel::flash_attention::cuda<T>\n";
+    for(Index t = 0; t < 2; ++t)
+    {
+        run_cuda<T>(seq, head, batch, n_batch, kv_group, K[t], Q, mask[t],
+                V[t], maxsumexp_cuda, A_cuda);
+    }
+    check<T>(seq, head, batch, n_batch, kv_group, K, Q, mask, V,
+            maxsumexp_cuda, A_cuda);
+    std::fill(maxsumexp_cuda.begin(), maxsumexp_cuda.end(), T{0});
+    std::fill(A_cuda.begin(), A_cuda.end(), T{0});
+    for(Index t = 0; t < 2; ++t)
+    {
+        run_cuda<T>(seq, head, batch, n_batch, kv_group, K[t], Q,
+                mask_causal[t], V[t], maxsumexp_cuda, A_cuda);
+    }
+    check<T>(seq, head, batch, n_batch, kv_group, K, Q, mask, V,
+            maxsumexp_cuda, A_cuda);
+    std::cout << "OK: kernel::flash_attention::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, 1, 1);
+    validate<fp32_t>(32, 16, 3);
+    validate<fp32_t>(100, 64, 2);
+    // Grouped-query attention with 3 sequences and 8 heads of queries
+    validate<fp32_t>(32, 16, 24, 3, 4);
+    validate<fp64_t>(1, 1, 1);
+    validate<fp64_t>(32, 16, 3);
+    validate<fp64_t>(100, 64, 2);
+    validate<fp64_t>(32, 16, 24, 3, 4);
+    validate<fp64_t>(17, 8, 4, 1, 4);
+    return 0;
+}
+
@@ -0,0 +1,271 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/flash_attention_backward.cc
+ * Fused single-pass flash attention backward
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-25
+ * */
+
+#include "nntile/kernel/flash_attention_backward.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+using namespace nntile;
+using namespace nntile::kernel::flash_attention_backward;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index seq, Index head, Index batch, const std::vector<T> &K,
+        const std::vector<T> &Q, const bool_t *mask,
+        const std::vector<T> &maxsumexp, const std::vector<T> &dA,
+        const std::vector<T> &V, const std::vector<T> &sumprod_slice,
+        std::vector<T> &dQ, std::vector<T> &dK, std::vector<T> &dV)
+{
+    // Alloc on device
+    Index nelems = head * seq * batch;
+    const std::vector<T> *src[6] = {&K, &Q, &maxsumexp, &dA, &V,
+        &sumprod_slice};
+    std::vector<T> *dst[3] = {&dQ, &dK, &dV};
+    T *dev_src[6], *dev_dst[3];
+    bool_t *dev_mask = nullptr;
+    cudaError_t cuda_err;
+    for(Index i = 0; i < 6; ++i)
+    {
+        cuda_err = cudaMalloc(&dev_src[i], sizeof(T)*src[i]->size());
+        TEST_ASSERT(cuda_err == cudaSuccess);
+        cuda_err = cudaMemcpy(dev_src[i], &(*src[i])[0],
+                sizeof(T)*src[i]->size(), cudaMemcpyHostToDevice);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+    }
+    for(Index i = 0; i < 3; ++i)
+    {
+        cuda_err = cudaMalloc(&dev_dst[i], sizeof(T)*nelems);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+        cuda_err = cudaMemcpy(dev_dst[i], &(*dst[i])[0], sizeof(T)*nelems,
+                cudaMemcpyHostToDevice);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+    }
+    // Causal mask is not copied
+    if(mask)
+    {
+        cuda_err = cudaMalloc(&dev_mask, sizeof(bool_t)*seq*seq);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+        cuda_err = cudaMemcpy(dev_mask, mask, sizeof(bool_t)*seq*seq,
+                cudaMemcpyHostToDevice);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+    }
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, seq, head, batch, dev_src[0], dev_src[1], dev_mask,
+            dev_src[2], dev_src[3], dev_src[4], dev_src[5], dev_dst[0],
+            dev_dst[1], dev_dst[2]);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    for(Index i = 0; i < 3; ++i)
+    {
+        cuda_err = cudaMemcpy(&(*dst[i])[0], dev_dst[i], sizeof(T)*nelems,
+                cudaMemcpyDeviceToHost);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+        cuda_err = cudaFree(dev_dst[i]);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+    }
+    for(Index i = 0; i < 6; ++i)
+    {
+        cuda_err = cudaFree(dev_src[i]);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+    }
+    cuda_err = cudaFree(dev_mask);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Templated validation
+template<typename T>
+void validate(Index seq, Index head, Index batch)
+{
+    constexpr T eps = T(100) * std::numeric_limits<T>::epsilon();
+    const T scale = T(1) / std::sqrt(T(head));
+    // Init test input
+    Index nelems = head * seq * batch;
+    std::vector<T> K(nelems), Q(nelems), V(nelems), dA(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        K[i] = T(((3*i+1) % 23) - 11) / T{10};
+        Q[i] = T((i % 19) - 9) / T{7};
+        V[i] = T(((5*i+2) % 17) - 8) / T{8};
+        dA[i] = T(((7*i+3) % 13) - 6) / T{5};
+    }
+    // Causal mask, the last query sees no keys at all
+    std::unique_ptr<bool_t[]> mask(new bool_t[seq*seq]);
+    for(Index q = 0; q < seq; ++q)
+    {
+        for(Index k = 0; k < seq; ++k)
+        {
+            mask[q*seq+k] = bool_t(k <= q and q < seq-1);
+        }
+    }
+    // Reference attention weights, maxsumexp and sumprod_slice
+    std::vector<T> P(seq*seq*batch, T{0}), maxsumexp(2*seq*batch, T{0}),
+        sumprod_slice(seq*batch, T{0});
+    for(Index b = 0; b < batch; ++b)
+    {
+        for(Index q = 0; q < seq; ++q)
+        {
+            T *P_q = &P[(b*seq+q)*seq];
+            T max = -std::numeric_limits<T>::infinity(), sum = 0;
+            for(Index k = 0; k < seq; ++k)
+            {
+                if(!mask[q*seq+k])
+                {
+                    continue;
+                }
+                T s = 0;
+                for(Index h = 0; h < head; ++h)
+                {
+                    s += K[(b*seq+k)*head+h] * Q[(b*seq+q)*head+h];
+                }
+                P_q[k] = scale * s;
+                max = std::max(max, P_q[k]);
+            }
+            for(Index k = 0; k < seq; ++k)
+            {
+                if(mask[q*seq+k])
+                {
+                    P_q[k] = std::exp(P_q[k]-max);
+                    sum += P_q[k];
+                }
+            }
+            if(sum == 0)
+            {
+                continue;
+            }
+            maxsumexp[2*(b*seq+q)] = max;
+            maxsumexp[2*(b*seq+q)+1] = sum;
+            for(Index k = 0; k < seq; ++k)
+            {
+                P_q[k] /= sum;
+            }
+            // sum_h A[h,q] * dA[h,q]
+            for(Index h = 0; h < head; ++h)
+            {
+                T A = 0;
+                for(Index k = 0; k < seq; ++k)
+                {
+                    A += P_q[k] * V[(b*seq+k)*head+h];
+                }
+                sumprod_slice[b*seq+q] += A * dA[(b*seq+q)*head+h];
+            }
+        }
+    }
+    // Reference gradients, added to some initial values
+    std::vector<T> dQ_init(nelems), dK_init(nelems), dV_init(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        dQ_init[i] = T(i % 5);
+        dK_init[i] = T(-(i % 3));
+        dV_init[i] = T(i % 2);
+    }
+    std::vector<T> dQ_ref(dQ_init), dK_ref(dK_init), dV_ref(dV_init);
+    for(Index b = 0; b < batch; ++b)
+    {
+        for(Index q = 0; q < seq; ++q)
+        {
+            for(Index k = 0; k < seq; ++k)
+            {
+                T p = P[(b*seq+q)*seq+k], dp = 0;
+                for(Index h = 0; h < head; ++h)
+                {
+                    dp += V[(b*seq+k)*head+h] * dA[(b*seq+q)*head+h];
+                }
+                T ds = scale * p * (dp-sumprod_slice[b*seq+q]);
+                for(Index h = 0; h < head; ++h)
+                {
+                    dV_ref[(b*seq+k)*head+h] += p * dA[(b*seq+q)*head+h];
+                    dQ_ref[(b*seq+q)*head+h] += ds * K[(b*seq+k)*head+h];
+                    dK_ref[(b*seq+k)*head+h] += ds * Q[(b*seq+q)*head+h];
+                }
+            }
+        }
+    }
+    // Check low-level kernel
+    std::vector<T> dQ(dQ_init), dK(dK_init), dV(dV_init);
+    std::cout << "Run kernel::flash_attention_backward::cpu<T>\n";
+    cpu<T>(seq, head, batch, &K[0], &Q[0], &mask[0], &maxsumexp[0], &dA[0],
+            &V[0], &sumprod_slice[0], &dQ[0], &dK[0], &dV[0]);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(std::abs(dQ[i]-dQ_ref[i]) <= eps*(1+std::abs(dQ_ref[i])));
+        TEST_ASSERT(std::abs(dK[i]-dK_ref[i]) <= eps*(1+std::abs(dK_ref[i])));
+        TEST_ASSERT(std::abs(dV[i]-dV_ref[i]) <= eps*(1+std::abs(dV_ref[i])));
+    }
+    // Causal mask out of indices, the last query is skipped anyway due to
+    // its zero sum of exponents
+    dQ = dQ_init;
+    dK = dK_init;
+    dV = dV_init;
+    cpu<T>(seq, head, batch, &K[0], &Q[0], nullptr, &maxsumexp[0], &dA[0],
+            &V[0], &sumprod_slice[0], &dQ[0], &dK[0], &dV[0]);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(std::abs(dQ[i]-dQ_ref[i]) <= eps*(1+std::abs(dQ_ref[i])));
+        TEST_ASSERT(std::abs(dK[i]-dK_ref[i]) <= eps*(1+std::abs(dK_ref[i])));
+        TEST_ASSERT(std::abs(dV[i]-dV_ref[i]) <= eps*(1+std::abs(dV_ref[i])));
+    }
+    std::cout << "OK: kernel::flash_attention_backward::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    dQ = dQ_init;
+    dK = dK_init;
+    dV = dV_init;
+    std::cout << "Run kernel::flash_attention_backward::cuda<T>\n";
+    run_cuda<T>(seq, head, batch, K, Q, &mask[0], maxsumexp, dA, V,
+            sumprod_slice, dQ, dK, dV);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(std::abs(dQ[i]-dQ_ref[i]) <= eps*(1+std::abs(dQ_ref[i])));
+        TEST_ASSERT(std::abs(dK[i]-dK_ref[i]) <= eps*(1+std::abs(dK_ref[i])));
+        TEST_ASSERT(std::abs(dV[i]-dV_ref[i]) <= eps*(1+std::abs(dV_ref[i])));
+    }
+    dQ = dQ_init;
+    dK = dK_init;
+    dV = dV_init;
+    run_cuda<T>(seq, head, batch, K, Q, nullptr, maxsumexp, dA, V,
+            sumprod_slice, dQ, dK, dV);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(std::abs(dQ[i]-dQ_ref[i]) <= eps*(1+std::abs(dQ_ref[i])));
+        TEST_ASSERT(std::abs(dK[i]-dK_ref[i]) <= eps*(1+std::abs(dK_ref[i])));
+        TEST_ASSERT(std::abs(dV[i]-dV_ref[i]) <= eps*(1+std::abs(dV_ref[i])));
+    }
+    std::cout << "OK: kernel::flash_attention_backward::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, 1, 1);
+    validate<fp32_t>(32, 16, 3);
+    validate<fp32_t>(100, 64, 2);
+    validate<fp64_t>(1, 1, 1);
+    validate<fp64_t>(32, 16, 3);
+    validate<fp64_t>(100, 64, 2);
+    return 0;
+}
+
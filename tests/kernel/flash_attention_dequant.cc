@@ -0,0 +1,268 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/flash_attention_dequant.cc
+ * Fused attention over quantized keys and values
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/flash_attention_dequant.hh"
+#include "nntile/kernel/quantize.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+using namespace nntile;
+using namespace nntile::kernel::flash_attention_dequant;
+
+// Quantized tile of keys or values with scales per token and head
+template<typename Q>
+struct QuantizedTile
+{
+    std::vector<Q> data;
+    std::vector<fp32_t> scale;
+};
+
+#ifdef NNTILE_USE_CUDA
+// Copy an array to a newly allocated device buffer
+template<typename T>
+T *to_device(const T *src, Index size)
+{
+    T *dev;
+    cudaError_t cuda_err = cudaMalloc(&dev, sizeof(T)*size);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev, src, sizeof(T)*size, cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    return dev;
+}
+
+template<typename T>
+T *to_device(const std::vector<T> &src)
+{
+    return to_device(&src[0], src.size());
+}
+
+template<typename Q>
+void run_cuda(Index k_seq, Index q_seq, Index head, Index batch,
+        Index n_batch, Index kv_group, Index mask_stride,
+        const QuantizedTile<Q> &K, const std::vector<fp32_t> &query,
+        const bool_t *mask, const QuantizedTile<Q> &V,
+        std::vector<fp32_t> &maxsumexp, std::vector<fp32_t> &A)
+{
+    // Copy to device
+    Q *dev_K = to_device(K.data), *dev_V = to_device(V.data);
+    fp32_t *dev_K_scale = to_device(K.scale),
+           *dev_V_scale = to_device(V.scale), *dev_query = to_device(query),
+           *dev_maxsumexp = to_device(maxsumexp), *dev_A = to_device(A);
+    bool_t *dev_mask = to_device(mask, k_seq*q_seq*(mask_stride ? n_batch
+            : 1));
+    // Init stream
+    cudaStream_t stream;
+    cudaError_t cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<Q>(stream, k_seq, q_seq, head, batch, n_batch, kv_group,
+            mask_stride, dev_K, dev_K_scale, dev_query, dev_mask, dev_V,
+            dev_V_scale, dev_maxsumexp, dev_A);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&A[0], dev_A, sizeof(fp32_t)*A.size(),
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&maxsumexp[0], dev_maxsumexp,
+            sizeof(fp32_t)*maxsumexp.size(), cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    for(void *ptr: {(void *)dev_K, (void *)dev_V, (void *)dev_K_scale,
+            (void *)dev_V_scale, (void *)dev_query, (void *)dev_maxsumexp,
+            (void *)dev_A, (void *)dev_mask})
+    {
+        cuda_err = cudaFree(ptr);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+    }
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check result against attention over two tiles of dequantized keys
+template<typename Q>
+void check(const Index (&k_seq)[2], Index q_seq, Index head, Index batch,
+        Index n_batch, Index kv_group, bool per_batch,
+        const QuantizedTile<Q> (&K)[2], const std::vector<fp32_t> &query,
+        const std::unique_ptr<bool_t[]> (&mask)[2],
+        const QuantizedTile<Q> (&V)[2],
+        const std::vector<fp32_t> &maxsumexp, const std::vector<fp32_t> &A)
+{
+    constexpr double eps = std::numeric_limits<fp32_t>::epsilon();
+    const double scale = 1.0 / std::sqrt(double(head));
+    std::vector<double> A_ref(head);
+    for(Index b = 0; b < batch; ++b)
+    {
+        Index b_kv = b%n_batch + n_batch*(b/(n_batch*kv_group));
+        Index b_mask = per_batch ? b%n_batch : 0;
+        for(Index q = 0; q < q_seq; ++q)
+        {
+            double max = -std::numeric_limits<double>::infinity(), sum = 0;
+            std::vector<double> score[2];
+            for(Index t = 0; t < 2; ++t)
+            {
+                score[t].resize(k_seq[t]);
+                for(Index k = 0; k < k_seq[t]; ++k)
+                {
+                    double s = 0;
+                    for(Index h = 0; h < head; ++h)
+                    {
+                        s += static_cast<fp32_t>(
+                                K[t].data[(b_kv*k_seq[t]+k)*head+h])
+                            * double(query[(b*q_seq+q)*head+h]);
+                    }
+                    s *= scale * K[t].scale[b_kv*k_seq[t]+k];
+                    score[t][k] = s;
+                    if(mask[t][(b_mask*q_seq+q)*k_seq[t]+k] and max < s)
+                    {
+                        max = s;
+                    }
+                }
+            }
+            std::fill(A_ref.begin(), A_ref.end(), 0.0);
+            for(Index t = 0; t < 2; ++t)
+            {
+                for(Index k = 0; k < k_seq[t]; ++k)
+                {
+                    if(!mask[t][(b_mask*q_seq+q)*k_seq[t]+k])
+                    {
+                        continue;
+                    }
+                    double p = std::exp(score[t][k]-max);
+                    sum += p;
+                    double v_scale = V[t].scale[b_kv*k_seq[t]+k];
+                    for(Index h = 0; h < head; ++h)
+                    {
+                        A_ref[h] += p * v_scale * static_cast<fp32_t>(
+                                V[t].data[(b_kv*k_seq[t]+k)*head+h]);
+                    }
+                }
+            }
+            Index i = b*q_seq + q;
+            TEST_ASSERT(std::abs(maxsumexp[2*i]-max)
+                    <= 100*eps*(1+std::abs(max)));
+            TEST_ASSERT(std::abs(maxsumexp[2*i+1]-sum) <= 100*eps*sum);
+            for(Index h = 0; h < head; ++h)
+            {
+                double val = A_ref[h] / sum;
+                TEST_ASSERT(std::abs(A[i*head+h]-val)
+                        <= 100*eps*(1+std::abs(val)));
+            }
+        }
+    }
+}
+
+// Templated validation
+template<typename Q>
+void validate(Index k_seq0, Index k_seq1, Index q_seq, Index head,
+        Index batch, Index n_batch=1, Index kv_group=1, bool per_batch=false)
+{
+    // Init test input: two tiles of quantized keys and values, e.g., tiles
+    // of KV-cache, for a tile of queries
+    const Index k_seq[2] = {k_seq0, k_seq1};
+    QuantizedTile<Q> K[2], V[2];
+    std::unique_ptr<bool_t[]> mask[2];
+    Index n_mask = per_batch ? n_batch : 1;
+    for(Index t = 0; t < 2; ++t)
+    {
+        Index kv_nelems = head * k_seq[t] * batch / kv_group;
+        std::vector<fp32_t> K_src(kv_nelems), V_src(kv_nelems);
+        for(Index i = 0; i < kv_nelems; ++i)
+        {
+            K_src[i] = fp32_t(((3*i+7*t) % 23) - 11) / fp32_t{10};
+            V_src[i] = fp32_t(((5*i+t) % 17) - 8) / fp32_t{8};
+        }
+        for(auto *tile: {&K[t], &V[t]})
+        {
+            tile->data.resize(kv_nelems);
+            tile->scale.resize(kv_nelems/head);
+        }
+        // Scales per token and head
+        kernel::quantize::cpu<Q>(1, kv_nelems, head, &K_src[0],
+                &K[t].data[0], &K[t].scale[0]);
+        kernel::quantize::cpu<Q>(1, kv_nelems, head, &V_src[0],
+                &V[t].data[0], &V[t].scale[0]);
+        // The first query sees nothing in the second tile, every sequence
+        // of a per-batch mask has its own number of keys in the first tile
+        mask[t].reset(new bool_t[k_seq[t]*q_seq*n_mask]);
+        for(Index b = 0; b < n_mask; ++b)
+        {
+            for(Index q = 0; q < q_seq; ++q)
+            {
+                for(Index k = 0; k < k_seq[t]; ++k)
+                {
+                    bool val = (t == 0) ? k <= q+b : q > 0;
+                    mask[t][(b*q_seq+q)*k_seq[t]+k] = bool_t(val);
+                }
+            }
+        }
+    }
+    Index nelems = head * q_seq * batch;
+    std::vector<fp32_t> query(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        query[i] = fp32_t((i % 19) - 9) / fp32_t{7};
+    }
+    // Check low-level kernel
+    std::vector<fp32_t> maxsumexp(2*q_seq*batch, 0), A(nelems, 0);
+    std::cout << "Run kernel::flash_attention_dequant::cpu<Q>\n";
+    for(Index t = 0; t < 2; ++t)
+    {
+        Index mask_stride = per_batch ? k_seq[t]*q_seq : 0;
+        cpu<Q>(k_seq[t], q_seq, head, batch, n_batch, kv_group, mask_stride,
+                &K[t].data[0], &K[t].scale[0], &query[0], &mask[t][0],
+                &V[t].data[0], &V[t].scale[0], &maxsumexp[0], &A[0]);
+    }
+    check<Q>(k_seq, q_seq, head, batch, n_batch, kv_group, per_batch, K,
+            query, mask, V, maxsumexp, A);
+    std::cout << "OK: kernel::flash_attention_dequant::cpu<Q>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<fp32_t> maxsumexp_cuda(2*q_seq*batch, 0),
+        A_cuda(nelems, 0);
+    std::cout << "Run kernel::flash_attention_dequant::cuda<Q>\n";
+    for(Index t = 0; t < 2; ++t)
+    {
+        Index mask_stride = per_batch ? k_seq[t]*q_seq : 0;
+        run_cuda<Q>(k_seq[t], q_seq, head, batch, n_batch, kv_group,
+                mask_stride, K[t], query, &mask[t][0], V[t], maxsumexp_cuda,
+                A_cuda);
+    }
+    check<Q>(k_seq, q_seq, head, batch, n_batch, kv_group, per_batch, K,
+            query, mask, V, maxsumexp_cuda, A_cuda);
+    std::cout << "OK: kernel::flash_attention_dequant::cuda<Q>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<std::int8_t>(1, 1, 1, 1, 1);
+    // Decoding of a single token against long tiles of KV-cache
+    validate<std::int8_t>(300, 129, 1, 64, 2);
+    validate<std::int8_t>(32, 16, 5, 16, 3);
+    // Grouped-query attention with 3 sequences, each with its own mask
+    validate<std::int8_t>(40, 24, 2, 16, 24, 3, 4, true);
+    validate<fp8_e4m3_t>(1, 1, 1, 1, 1);
+    validate<fp8_e4m3_t>(300, 129, 1, 64, 2);
+    validate<fp8_e4m3_t>(32, 16, 5, 16, 3);
+    validate<fp8_e4m3_t>(40, 24, 2, 16, 24, 3, 4, true);
+    return 0;
+}
+
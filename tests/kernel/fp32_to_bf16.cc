@@ -0,0 +1,166 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/fp32_to_bf16.cc
+ * Conversions between fp32_t and bf16_t arrays
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-01-31
+ * */
+
+#include "nntile/kernel/fp32_to_bf16.hh"
+#include "nntile/kernel/bf16_to_fp32.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+#include <cstring>
+
+using namespace nntile;
+
+#ifdef NNTILE_USE_CUDA
+void run_cuda(Index nelems, const std::vector<fp32_t> &src,
+        std::vector<bf16_t> &dst, std::vector<fp32_t> &dst2)
+{
+    // Copy to device
+    fp32_t *dev_src, *dev_dst2;
+    bf16_t *dev_dst;
+    cudaError_t cuda_err = cudaMalloc(&dev_src, sizeof(fp32_t)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(bf16_t)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst2, sizeof(fp32_t)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(fp32_t)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernels
+    kernel::fp32_to_bf16::cuda(stream, nelems, dev_src, dev_dst);
+    kernel::bf16_to_fp32::cuda(stream, nelems, dev_dst, dev_dst2);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(bf16_t)*nelems,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&dst2[0], dev_dst2, sizeof(fp32_t)*nelems,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst2);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Get single precision value from its bits
+fp32_t from_bits(std::uint32_t bits)
+{
+    fp32_t val;
+    std::memcpy(&val, &bits, sizeof(val));
+    return val;
+}
+
+// Check conversions of an array, that covers special values and ties
+void check(const std::vector<fp32_t> &src, const std::vector<bf16_t> &dst,
+        const std::vector<fp32_t> &dst2)
+{
+    constexpr fp32_t inf = std::numeric_limits<fp32_t>::infinity();
+    // bf16_t keeps 8 bits of mantissa
+    constexpr fp32_t eps = 1.0f / 256;
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        // Back conversion is exact
+        TEST_ASSERT(bf16_t(dst2[i]).value == dst[i].value);
+        if(std::isnan(src[i]))
+        {
+            TEST_ASSERT(std::isnan(dst2[i]));
+        }
+        else if(std::isinf(src[i]))
+        {
+            TEST_ASSERT(dst2[i] == src[i]);
+        }
+        else if(std::abs(src[i]) <= from_bits(0x7f7f7fffu))
+        {
+            // Rounding to the nearest is within half a unit in the last place,
+            // which is fixed for subnormal values
+            TEST_ASSERT(std::abs(dst2[i]-src[i]) <= eps*std::abs(src[i])
+                    + from_bits(0x00008000u));
+        }
+        else
+        {
+            // Overflow
+            TEST_ASSERT(dst2[i] == std::copysign(inf, src[i]));
+        }
+    }
+    // Ties are rounded to even
+    TEST_ASSERT(dst[0].value == 0x3f80u);
+    TEST_ASSERT(dst[1].value == 0x3f82u);
+    TEST_ASSERT(dst[2].value == 0x3f81u);
+}
+
+void validate(Index nelems)
+{
+    constexpr fp32_t inf = std::numeric_limits<fp32_t>::infinity();
+    constexpr fp32_t nan = std::numeric_limits<fp32_t>::quiet_NaN();
+    // Init test input
+    std::vector<fp32_t> src(nelems);
+    src[0] = from_bits(0x3f808000u);
+    src[1] = from_bits(0x3f818000u);
+    src[2] = from_bits(0x3f808001u);
+    src[3] = inf;
+    src[4] = -inf;
+    src[5] = nan;
+    src[6] = std::numeric_limits<fp32_t>::max();
+    src[7] = std::numeric_limits<fp32_t>::denorm_min();
+    for(Index i = 8; i < nelems; ++i)
+    {
+        src[i] = std::sin(fp32_t(i)) * std::pow(fp32_t(2), fp32_t(i%61-30));
+    }
+    std::vector<bf16_t> dst(nelems);
+    std::vector<fp32_t> dst2(nelems);
+    // Check low-level CPU kernels
+    std::cout << "Run kernel::fp32_to_bf16::cpu\n";
+    kernel::fp32_to_bf16::cpu(nelems, &src[0], &dst[0]);
+    kernel::bf16_to_fp32::cpu(nelems, &dst[0], &dst2[0]);
+    check(src, dst, dst2);
+    std::cout << "OK: kernel::fp32_to_bf16::cpu\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernels
+    std::vector<bf16_t> dst_cuda(nelems);
+    std::vector<fp32_t> dst2_cuda(nelems);
+    std::cout << "Run kernel::fp32_to_bf16::cuda\n";
+    run_cuda(nelems, src, dst_cuda, dst2_cuda);
+    check(src, dst_cuda, dst2_cuda);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        // NaN payloads of the CUDA intrinsics may differ
+        if(not std::isnan(src[i]))
+        {
+            TEST_ASSERT(dst_cuda[i].value == dst[i].value);
+        }
+    }
+    std::cout << "OK: kernel::fp32_to_bf16::cuda\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate(8);
+    validate(1000);
+    return 0;
+}
@@ -0,0 +1,185 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/fused_elementwise.cc
+ * Chain of elementwise operations on buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/fused_elementwise.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+#include <cmath>
+#include <limits>
+
+using namespace nntile;
+using namespace nntile::kernel::fused_elementwise;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index nelems, const program_t<T> &program,
+        std::vector<std::vector<T>> &buffers)
+{
+    // Copy to device
+    std::vector<T *> dev_buffers(program.nbuffers);
+    cudaError_t cuda_err;
+    for(int j = 0; j < program.nbuffers; ++j)
+    {
+        cuda_err = cudaMalloc(&dev_buffers[j], sizeof(T)*nelems);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+        cuda_err = cudaMemcpy(dev_buffers[j], buffers[j].data(),
+                sizeof(T)*nelems, cudaMemcpyHostToDevice);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+    }
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, nelems, program, &dev_buffers[0]);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    for(int j = 0; j < program.nbuffers; ++j)
+    {
+        cuda_err = cudaMemcpy(buffers[j].data(), dev_buffers[j],
+                sizeof(T)*nelems, cudaMemcpyDeviceToHost);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+        cuda_err = cudaFree(dev_buffers[j]);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+    }
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Apply operations one by one to entire buffers
+template<typename T>
+void reference(Index nelems, const program_t<T> &program,
+        std::vector<std::vector<T>> &buffers)
+{
+    for(int k = 0; k < program.nops; ++k)
+    {
+        const op_t<T> &op = program.ops[k];
+        std::vector<T> &src = buffers[op.src], &dst = buffers[op.dst];
+        for(Index i = 0; i < nelems; ++i)
+        {
+            switch(op.code)
+            {
+                case opcode_t::ADD:
+                    dst[i] = op.alpha*src[i] + op.beta*dst[i];
+                    break;
+                case opcode_t::PROD:
+                    dst[i] = src[i] * dst[i];
+                    break;
+                case opcode_t::SCAL:
+                    dst[i] = op.alpha * src[i];
+                    break;
+                case opcode_t::ADD_SCALAR:
+                    dst[i] = op.alpha + op.beta*dst[i];
+                    break;
+                case opcode_t::HYPOT:
+                    dst[i] = std::hypot(op.alpha*src[i], op.beta*dst[i]);
+                    break;
+                case opcode_t::SQRT:
+                    dst[i] = std::sqrt(src[i]);
+                    break;
+            }
+        }
+    }
+}
+
+// Run tests for the given precision
+template<typename T>
+void validate(Index nelems)
+{
+    // Running mean and deviation of a gradient, as in optimizers, with an
+    // auxiliary buffer d, that is written before being read
+    enum {g, m, v, d, u};
+    program_t<T> program;
+    program.nbuffers = 5;
+    program.nops = 7;
+    program.ops[0] = {opcode_t::SCAL, g, d, T(0.5), T(0)};
+    program.ops[1] = {opcode_t::ADD, d, m, T(0.1), T(0.9)};
+    program.ops[2] = {opcode_t::HYPOT, g, v, T(0.3), T(0.7)};
+    program.ops[3] = {opcode_t::SQRT, v, d, T(0), T(0)};
+    program.ops[4] = {opcode_t::ADD_SCALAR, d, d, T(1e-3), T(1)};
+    program.ops[5] = {opcode_t::PROD, m, d, T(0), T(0)};
+    program.ops[6] = {opcode_t::ADD, g, m, T(0), T(-2)};
+    // Check derived access modes, buffer u is not used at all
+    bool load[MAX_BUFFERS], store[MAX_BUFFERS];
+    get_access<T>(program, load, store);
+    TEST_ASSERT(load[g] and not store[g]);
+    TEST_ASSERT(load[m] and store[m]);
+    TEST_ASSERT(load[v] and store[v]);
+    TEST_ASSERT(not load[d] and store[d]);
+    TEST_ASSERT(not load[u] and not store[u]);
+    std::vector<std::vector<T>> buffers(program.nbuffers,
+            std::vector<T>(nelems));
+    for(Index i = 0; i < nelems; ++i)
+    {
+        buffers[g][i] = T(i%13) - T(6);
+        buffers[m][i] = T(1) / T(i+1);
+        buffers[v][i] = T(i%7) + T(1);
+        buffers[d][i] = T(-1);
+        buffers[u][i] = T(i);
+    }
+    auto ref_buffers = buffers;
+    reference<T>(nelems, program, ref_buffers);
+    // Check low-level kernel
+    std::cout << "Run kernel::fused_elementwise::cpu<T>\n";
+    auto cpu_buffers = buffers;
+    std::vector<T *> ptr(program.nbuffers);
+    for(int j = 0; j < program.nbuffers; ++j)
+    {
+        ptr[j] = cpu_buffers[j].data();
+    }
+    cpu<T>(nelems, program, &ptr[0]);
+    T eps = std::numeric_limits<T>::epsilon();
+    for(int j = 0; j < program.nbuffers; ++j)
+    {
+        for(Index i = 0; i < nelems; ++i)
+        {
+            T ref = ref_buffers[j][i];
+            TEST_ASSERT(std::abs(cpu_buffers[j][i]-ref)
+                    <= 10*eps*(std::abs(ref)+1));
+        }
+    }
+    std::cout << "OK: kernel::fused_elementwise::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check the same on CUDA
+    std::cout << "Run kernel::fused_elementwise::cuda<T>\n";
+    auto cuda_buffers = buffers;
+    run_cuda<T>(nelems, program, cuda_buffers);
+    for(int j = 0; j < program.nbuffers; ++j)
+    {
+        for(Index i = 0; i < nelems; ++i)
+        {
+            T ref = ref_buffers[j][i];
+            TEST_ASSERT(std::abs(cuda_buffers[j][i]-ref)
+                    <= 10*eps*(std::abs(ref)+1));
+        }
+    }
+    std::cout << "OK: kernel::fused_elementwise::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(0);
+    validate<fp32_t>(1);
+    validate<fp32_t>(1000);
+    validate<fp64_t>(0);
+    validate<fp64_t>(1);
+    validate<fp64_t>(1000);
+    return 0;
+}
+
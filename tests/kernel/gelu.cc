@@ -13,10 +13,12 @@
  * */
 
 #include "nntile/kernel/gelu.hh"
+#include "nntile/kernel/simd.hh"
 #include "../testing.hh"
 #include <vector>
 #include <stdexcept>
 #include <cmath>
+#include <limits>
 #include <iostream>
 
 using namespace nntile;
@@ -64,7 +66,9 @@ void validate(Index nelems)
         data[i] = T(2*i+1-nelems) / T{1000};
     }
     std::vector<T> data_save(data);
-    // Check low-level CPU kernel
+    // Check low-level CPU kernel without vectorization
+    using kernel::simd::Level;
+    kernel::simd::set_level(Level::NONE);
     std::cout << "Run kernel::gelu::cpu<T>\n";
     cpu<T>(nelems, &data[0]);
     for(Index i = 0; i < nelems; ++i)
@@ -88,6 +92,29 @@ void validate(Index nelems)
         TEST_ASSERT(data[i] >= val_ref_min and data[i] <= val_ref_max);
     }
     std::cout << "OK: kernel::gelu::cpu<T>\n";
+    // Vectorized versions are within 6 ulp of the scalar one, unless erfc
+    // is not a normalized number
+    std::vector<T> data_scalar(data);
+    for(Level level: {Level::AVX2, Level::AVX512})
+    {
+        if(kernel::simd::set_level(level) != level)
+        {
+            continue;
+        }
+        data = data_save;
+        std::cout << "Run kernel::gelu::cpu<T> with SIMD level "
+            << static_cast<int>(level) << "\n";
+        cpu<T>(nelems, &data[0]);
+        for(Index i = 0; i < nelems; ++i)
+        {
+            T val_ref = data_scalar[i];
+            T diff = std::abs(data[i] - val_ref);
+            T tiny = std::abs(data_save[i]) * std::numeric_limits<T>::min();
+            TEST_ASSERT(diff <= 6*eps*std::abs(val_ref) + tiny);
+        }
+        std::cout << "OK: kernel::gelu::cpu<T>\n";
+    }
+    kernel::simd::set_level(Level::AVX512);
 #ifdef NNTILE_USE_CUDA
     // Check low-level CUDA kernel
     data = data_save;
@@ -122,9 +149,11 @@ int main(int argc, char **argv)
     validate<fp32_t>(0);
     validate<fp32_t>(1);
     validate<fp32_t>(80000);
+    validate<fp32_t>(1002);
     validate<fp64_t>(0);
     validate<fp64_t>(1);
     validate<fp64_t>(80000);
+    validate<fp64_t>(1002);
     return 0;
 }
 
@@ -12,12 +12,159 @@
  * @date 2023-07-01
  * */
 
+#include "nntile/kernel/gelutanh.hh"
+#include "nntile/kernel/simd.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <cmath>
+#include <limits>
 #include <iostream>
 
+using namespace nntile;
+using namespace nntile::kernel::gelutanh;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index nelems, const std::vector<T> &src, std::vector<T> &dst)
+{
+    // Copy to device
+    T *dev_src, *dev_dst;
+    cudaError_t cuda_err = cudaMalloc(&dev_src, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, nelems, dev_src, dev_dst);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(T)*nelems,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check output against 0.5z(1+tanh(sqrt(2/pi)(z+0.044715z^3)))
+template<typename T>
+void check_ref(Index nelems, const std::vector<T> &src,
+        const std::vector<T> &dst)
+{
+    constexpr T pi = 3.141592653589793238462643383279502884L;
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    for(Index i = 0; i < nelems; ++i)
+    {
+        T x = src[i];
+        T y = std::sqrt(T{2}/pi) * (x+T{0.044715}*x*x*x);
+        T z = T{1}+std::tanh(y);
+        T val_ref = T{0.5} * x * z;
+        // Obtain range of correct values
+        T val_ref_min, val_ref_max;
+        if(val_ref < 0)
+        {
+            val_ref_min = val_ref * (T{1}+eps) - eps;
+            val_ref_max = val_ref * (T{1}-eps) + eps;
+        }
+        else
+        {
+            val_ref_min = val_ref * (T{1}-eps) - eps;
+            val_ref_max = val_ref * (T{1}+eps) + eps;
+        }
+        // NaN-aware comparisons
+        TEST_ASSERT(dst[i] >= val_ref_min and dst[i] <= val_ref_max);
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index nelems)
+{
+    constexpr T pi = 3.141592653589793238462643383279502884L;
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    // Init test input
+    std::vector<T> src(nelems), dst(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        src[i] = T(2*i+1-nelems) / T{1000};
+    }
+    // Check low-level CPU kernel without vectorization
+    using kernel::simd::Level;
+    kernel::simd::set_level(Level::NONE);
+    std::cout << "Run kernel::gelutanh::cpu<T>\n";
+    cpu<T>(nelems, &src[0], &dst[0]);
+    check_ref<T>(nelems, src, dst);
+    std::cout << "OK: kernel::gelutanh::cpu<T>\n";
+    // Vectorized versions are within 6+2|f(z)| ulp of the scalar one
+    std::vector<T> dst_scalar(dst);
+    const T f3 = -T{2}*std::sqrt(T{2}/pi), f4 = f3*T{0.044715};
+    for(Level level: {Level::AVX2, Level::AVX512})
+    {
+        if(kernel::simd::set_level(level) != level)
+        {
+            continue;
+        }
+        std::cout << "Run kernel::gelutanh::cpu<T> with SIMD level "
+            << static_cast<int>(level) << "\n";
+        cpu<T>(nelems, &src[0], &dst[0]);
+        for(Index i = 0; i < nelems; ++i)
+        {
+            T z = src[i];
+            T f = std::abs(z * (f3+f4*z*z));
+            T diff = std::abs(dst[i] - dst_scalar[i]);
+            TEST_ASSERT(diff <= (6+2*f)*eps*std::abs(dst_scalar[i]));
+        }
+        std::cout << "OK: kernel::gelutanh::cpu<T>\n";
+    }
+    kernel::simd::set_level(Level::AVX512);
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::cout << "Run kernel::gelutanh::cuda<T>\n";
+    run_cuda<T>(nelems, src, dst);
+    check_ref<T>(nelems, src, dst);
+    std::cout << "OK: kernel::gelutanh::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+// Throughput on production shapes of tiles of GPT2 in bytes per second
+template<typename T>
+void perf(const char *dtype, Index nelems)
+{
+    std::vector<T> src(nelems, T{0.5}), dst(nelems);
+    testing::perf_check(std::string("kernel_gelutanh_cpu_")+dtype,
+            2.0*sizeof(T)*nelems,
+            [&](){cpu<T>(nelems, &src[0], &dst[0]);});
+}
+
 int main(int argc, char **argv)
 {
-    // Not implemented
-    std::cout << "This test is not yet implemented\n";
-    return -1;
+    // Inner activations of GPT2 of 1024 tokens by 3072 features
+    if(testing::perf_mode(argc, argv))
+    {
+        perf<fp32_t>("fp32", 1024*3072);
+        perf<fp64_t>("fp64", 1024*3072);
+        return 0;
+    }
+    validate<fp32_t>(0);
+    validate<fp32_t>(1);
+    validate<fp32_t>(1002);
+    validate<fp32_t>(80000);
+    validate<fp64_t>(0);
+    validate<fp64_t>(1);
+    validate<fp64_t>(1002);
+    validate<fp64_t>(80000);
+    return 0;
 }
 
@@ -12,12 +12,146 @@
  * @date 2023-05-02
  * */
 
+#include "nntile/kernel/gelutanh_backward.hh"
+#include "nntile/kernel/dgelutanh.hh"
+#include "nntile/kernel/simd.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <cmath>
+#include <limits>
 #include <iostream>
 
+using namespace nntile;
+using namespace nntile::kernel;
+using namespace nntile::kernel::gelutanh_backward;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index nelems, const std::vector<T> &x, const std::vector<T> &dy,
+        std::vector<T> &dx)
+{
+    // Copy to device
+    T *dev_x, *dev_dy, *dev_dx;
+    cudaError_t cuda_err = cudaMalloc(&dev_x, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dy, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dx, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_x, &x[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_dy, &dy[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_dx, &dx[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, nelems, dev_x, dev_dy, dev_dx);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&dx[0], dev_dx, sizeof(T)*nelems,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_x);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dy);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dx);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check dx against dx_init+dy*AGeLU'(x) with AGeLU' of dgelutanh kernel
+/*! Tolerance is 8+2|f(z)| ulp of the sum of absolute values of the terms of
+ * the derivative and 1 ulp of each of the two summands. The CUDA kernel and
+ * vectorized CPU kernels are checked against the same bound.
+ * */
+template<typename T>
+void check_ref(Index nelems, const std::vector<T> &x,
+        const std::vector<T> &dy, const std::vector<T> &dx_init,
+        const std::vector<T> &deriv, const std::vector<T> &dx)
+{
+    constexpr T pi = 3.141592653589793238462643383279502884L;
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    const T f3 = -T{2}*std::sqrt(T{2}/pi), f4 = f3*T{0.044715},
+        f5 = T{3}*f4;
+    for(Index i = 0; i < nelems; ++i)
+    {
+        T z = x[i];
+        T f = z * (f3+f4*z*z);
+        T inv = T{1} / (std::exp(f)+T{1});
+        T terms = inv + std::abs(z*(f3+f5*z*z))*(T{1}-inv)*inv;
+        T grad = dy[i] * deriv[i];
+        T val_ref = dx_init[i] + grad;
+        T tol = (8+2*std::abs(f)) * eps * terms * std::abs(dy[i])
+            + eps * (std::abs(dx_init[i])+std::abs(grad));
+        TEST_ASSERT(std::abs(dx[i]-val_ref) <= tol);
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index nelems)
+{
+    // Init test input
+    std::vector<T> x(nelems), dy(nelems), dx_init(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        x[i] = T(2*i+1-nelems) / T{1000};
+        dy[i] = T(i%7-3) / T{4};
+        dx_init[i] = T(i%5) / T{10};
+    }
+    // Reference derivative by the scalar dgelutanh kernel
+    using kernel::simd::Level;
+    kernel::simd::set_level(Level::NONE);
+    std::vector<T> deriv(x);
+    dgelutanh::cpu<T>(nelems, &deriv[0]);
+    // Check low-level CPU kernel with all the supported instruction sets
+    std::vector<T> dx(nelems);
+    for(Level level: {Level::NONE, Level::AVX2, Level::AVX512})
+    {
+        if(kernel::simd::set_level(level) != level)
+        {
+            continue;
+        }
+        dx = dx_init;
+        std::cout << "Run kernel::gelutanh_backward::cpu<T> with SIMD level "
+            << static_cast<int>(level) << "\n";
+        cpu<T>(nelems, &x[0], &dy[0], &dx[0]);
+        check_ref<T>(nelems, x, dy, dx_init, deriv, dx);
+        std::cout << "OK: kernel::gelutanh_backward::cpu<T>\n";
+    }
+    kernel::simd::set_level(Level::AVX512);
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    dx = dx_init;
+    std::cout << "Run kernel::gelutanh_backward::cuda<T>\n";
+    run_cuda<T>(nelems, x, dy, dx);
+    check_ref<T>(nelems, x, dy, dx_init, deriv, dx);
+    std::cout << "OK: kernel::gelutanh_backward::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
 int main(int argc, char **argv)
 {
-    // Not implemented
-    std::cout << "This test is not yet implemented\n";
-    return -1;
+    validate<fp32_t>(0);
+    validate<fp32_t>(1);
+    validate<fp32_t>(1002);
+    validate<fp32_t>(80000);
+    validate<fp64_t>(0);
+    validate<fp64_t>(1);
+    validate<fp64_t>(1002);
+    validate<fp64_t>(80000);
+    return 0;
 }
 
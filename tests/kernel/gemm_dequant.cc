@@ -0,0 +1,165 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/gemm_dequant.cc
+ * Gemm with dequantization of 8-bit weights on the fly
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/gemm_dequant.hh"
+#include "nntile/kernel/quantize.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::gemm_dequant;
+
+#ifdef NNTILE_USE_CUDA
+template<typename Q>
+void run_cuda(Index m, Index n, Index k, Index group, fp32_t alpha,
+        const std::vector<Q> &A, const std::vector<fp32_t> &scale,
+        const std::vector<fp32_t> &B, fp32_t beta, std::vector<fp32_t> &C)
+{
+    // Copy to device
+    Q *dev_A;
+    fp32_t *dev_scale, *dev_B, *dev_C;
+    cudaError_t cuda_err = cudaMalloc(&dev_A, sizeof(Q)*m*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_scale, sizeof(fp32_t)*m*(k/group));
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_B, sizeof(fp32_t)*k*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_C, sizeof(fp32_t)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_A, &A[0], sizeof(Q)*m*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_scale, &scale[0], sizeof(fp32_t)*m*(k/group),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_B, &B[0], sizeof(fp32_t)*k*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_C, &C[0], sizeof(fp32_t)*m*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<Q>(stream, m, n, k, group, alpha, dev_A, dev_scale, dev_B, beta,
+            dev_C);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&C[0], dev_C, sizeof(fp32_t)*m*n,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_A);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_scale);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_B);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_C);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check result against the reference
+void check(const std::vector<fp32_t> &C, const std::vector<double> &C_ref,
+        double norm)
+{
+    constexpr double eps = std::numeric_limits<fp32_t>::epsilon();
+    for(Index i = 0; i < C.size(); ++i)
+    {
+        TEST_ASSERT(std::abs(C[i]-C_ref[i]) <= 10*eps*norm);
+    }
+}
+
+// Templated validation
+template<typename Q>
+void validate(Index m, Index n, Index k, Index group, fp32_t beta)
+{
+    constexpr fp32_t alpha = -0.5;
+    // Init weights and quantize them
+    std::vector<fp32_t> W(m*k), scale(m*(k/group)), B(k*n), C(m*n);
+    std::vector<Q> A(m*k);
+    for(Index i = 0; i < W.size(); ++i)
+    {
+        W[i] = fp32_t(i%23)/fp32_t(7) - fp32_t((i/3)%13);
+    }
+    nntile::kernel::quantize::cpu<Q>(m, k, group, &W[0], &A[0], &scale[0]);
+    for(Index i = 0; i < B.size(); ++i)
+    {
+        B[i] = fp32_t(i%11)/fp32_t(5) - fp32_t(1);
+    }
+    for(Index i = 0; i < C.size(); ++i)
+    {
+        C[i] = fp32_t(i%5) - fp32_t(2);
+    }
+    // Get reference result in double precision by dequantized weights
+    std::vector<double> C_ref(m*n);
+    double norm = 0;
+    for(Index j = 0; j < n; ++j)
+    {
+        for(Index i = 0; i < m; ++i)
+        {
+            double sum = 0, sum_abs = 0;
+            for(Index l = 0; l < k; ++l)
+            {
+                double a = double(scale[(l/group)*m+i])
+                    * static_cast<fp32_t>(A[l*m+i]);
+                sum += a * B[j*k+l];
+                sum_abs += std::abs(a * B[j*k+l]);
+            }
+            C_ref[j*m+i] = alpha*sum;
+            if(beta != 0)
+            {
+                C_ref[j*m+i] += beta*double(C[j*m+i]);
+            }
+            norm = std::max(norm, std::abs(alpha)*sum_abs
+                    + std::abs(beta*double(C[j*m+i])));
+        }
+    }
+    // Check low-level CPU kernel
+    std::vector<fp32_t> C_cpu(C);
+    std::cout << "Run kernel::gemm_dequant::cpu<Q>\n";
+    cpu<Q>(m, n, k, group, alpha, &A[0], &scale[0], &B[0], beta, &C_cpu[0]);
+    check(C_cpu, C_ref, norm);
+    std::cout << "OK: kernel::gemm_dequant::cpu<Q>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<fp32_t> C_cuda(C);
+    std::cout << "Run kernel::gemm_dequant::cuda<Q>\n";
+    run_cuda<Q>(m, n, k, group, alpha, A, scale, B, beta, C_cuda);
+    check(C_cuda, C_ref, norm);
+    std::cout << "OK: kernel::gemm_dequant::cuda<Q>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    // Decoding of a single token, a tail of columns and blocks of rows
+    validate<std::int8_t>(300, 1, 64, 64, 0);
+    validate<std::int8_t>(300, 11, 64, 16, 1);
+    validate<std::int8_t>(7, 20, 9, 3, -1);
+    validate<fp8_e4m3_t>(300, 1, 64, 64, 0);
+    validate<fp8_e4m3_t>(300, 11, 64, 16, 1);
+    validate<fp8_e4m3_t>(7, 20, 9, 3, -1);
+    return 0;
+}
+
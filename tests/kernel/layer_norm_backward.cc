@@ -0,0 +1,234 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/layer_norm_backward.cc
+ * Backward of fused layer normalization
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-05
+ * */
+
+#include "nntile/kernel/layer_norm_backward.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::layer_norm_backward;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, Index k, const std::vector<T> &src,
+        const std::vector<T> &dst_grad, const std::vector<T> &gamma,
+        const std::vector<T> &mean, const std::vector<T> &inv_stddev,
+        std::vector<T> &src_grad, std::vector<T> &gamma_grad,
+        std::vector<T> &beta_grad)
+{
+    // Copy to device
+    T *dev_src, *dev_dst_grad, *dev_gamma, *dev_mean, *dev_inv_stddev,
+      *dev_src_grad, *dev_gamma_grad, *dev_beta_grad;
+    cudaError_t cuda_err = cudaMalloc(&dev_src, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst_grad, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_gamma, sizeof(T)*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_mean, sizeof(T)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_inv_stddev, sizeof(T)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_src_grad, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_gamma_grad, sizeof(T)*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_beta_grad, sizeof(T)*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*m*n*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_dst_grad, &dst_grad[0], sizeof(T)*m*n*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_gamma, &gamma[0], sizeof(T)*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_mean, &mean[0], sizeof(T)*m*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_inv_stddev, &inv_stddev[0], sizeof(T)*m*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src_grad, &src_grad[0], sizeof(T)*m*n*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_gamma_grad, &gamma_grad[0], sizeof(T)*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_beta_grad, &beta_grad[0], sizeof(T)*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, m, n, k, dev_src, dev_dst_grad, dev_gamma, dev_mean,
+            dev_inv_stddev, dev_src_grad, dev_gamma_grad, dev_beta_grad);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&src_grad[0], dev_src_grad, sizeof(T)*m*n*k,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&gamma_grad[0], dev_gamma_grad, sizeof(T)*k,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&beta_grad[0], dev_beta_grad, sizeof(T)*k,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst_grad);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_gamma);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_mean);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_inv_stddev);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src_grad);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_gamma_grad);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_beta_grad);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check result against the reference, rounding errors grow with size of sums
+template<typename T>
+void check(Index size, const std::vector<T> &val,
+        const std::vector<double> &ref)
+{
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    const double tol = 10 * eps * (size+10);
+    for(Index i = 0; i < val.size(); ++i)
+    {
+        TEST_ASSERT(std::abs(val[i]-ref[i]) <= tol*(1+std::abs(ref[i])));
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k)
+{
+    const double eps = 1e-5;
+    // Init test input
+    std::vector<T> src(m*n*k), dst_grad(m*n*k), gamma(k), mean(m*n),
+        inv_stddev(m*n), src_grad(m*n*k), gamma_grad(k), beta_grad(k);
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        src[i] = T(i%13)/T(7) - T((i/7)%5);
+        dst_grad[i] = T(i%5)/T(3) - T((i/3)%7)/T(4);
+        src_grad[i] = T(i%3) - T(1);
+    }
+    for(Index i = 0; i < k; ++i)
+    {
+        gamma[i] = T(1) + T(i%3)/T(2);
+        gamma_grad[i] = T(i%4);
+        beta_grad[i] = -T(i%3);
+    }
+    // Statistics of input, that are computed by the forward pass
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            double sum = 0, ssq = 0;
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                sum += src[(i2*k+i1)*m+i0];
+            }
+            double avg = sum / k;
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                double diff = src[(i2*k+i1)*m+i0] - avg;
+                ssq += diff * diff;
+            }
+            mean[i2*m+i0] = avg;
+            inv_stddev[i2*m+i0] = 1.0 / std::sqrt(ssq/k+eps);
+        }
+    }
+    // Get reference result in double precision
+    std::vector<double> src_grad_ref(src_grad.begin(), src_grad.end()),
+        gamma_grad_ref(gamma_grad.begin(), gamma_grad.end()),
+        beta_grad_ref(beta_grad.begin(), beta_grad.end()), xhat(k);
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            double inv = inv_stddev[i2*m+i0], sum_g = 0, sum_gx = 0;
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                Index i = (i2*k+i1)*m + i0;
+                xhat[i1] = (double(src[i])-mean[i2*m+i0]) * inv;
+                sum_g += double(dst_grad[i]) * gamma[i1];
+                sum_gx += double(dst_grad[i]) * gamma[i1] * xhat[i1];
+                gamma_grad_ref[i1] += double(dst_grad[i]) * xhat[i1];
+                beta_grad_ref[i1] += dst_grad[i];
+            }
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                Index i = (i2*k+i1)*m + i0;
+                src_grad_ref[i] += inv / k * (k*double(dst_grad[i])*gamma[i1]
+                        - sum_g - xhat[i1]*sum_gx);
+            }
+        }
+    }
+    // Check low-level CPU kernel
+    std::vector<T> src_grad_cpu(src_grad), gamma_grad_cpu(gamma_grad),
+        beta_grad_cpu(beta_grad);
+    std::cout << "Run kernel::layer_norm_backward::cpu<T>\n";
+    cpu<T>(m, n, k, &src[0], &dst_grad[0], &gamma[0], &mean[0],
+            &inv_stddev[0], &src_grad_cpu[0], &gamma_grad_cpu[0],
+            &beta_grad_cpu[0]);
+    check(k, src_grad_cpu, src_grad_ref);
+    check(m*n, gamma_grad_cpu, gamma_grad_ref);
+    check(m*n, beta_grad_cpu, beta_grad_ref);
+    std::cout << "OK: kernel::layer_norm_backward::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> src_grad_cuda(src_grad), gamma_grad_cuda(gamma_grad),
+        beta_grad_cuda(beta_grad);
+    std::cout << "Run kernel::layer_norm_backward::cuda<T>\n";
+    run_cuda<T>(m, n, k, src, dst_grad, gamma, mean, inv_stddev,
+            src_grad_cuda, gamma_grad_cuda, beta_grad_cuda);
+    check(k, src_grad_cuda, src_grad_ref);
+    check(m*n, gamma_grad_cuda, gamma_grad_ref);
+    check(m*n, beta_grad_cuda, beta_grad_ref);
+    std::cout << "OK: kernel::layer_norm_backward::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    // Single-element fibers, a block per fiber and a thread per fiber on CUDA
+    validate<fp32_t>(1, 3, 1);
+    validate<fp32_t>(1, 9, 700);
+    validate<fp32_t>(3, 5, 20);
+    validate<fp32_t>(40, 3, 50);
+    validate<fp64_t>(1, 3, 1);
+    validate<fp64_t>(1, 9, 700);
+    validate<fp64_t>(3, 5, 20);
+    validate<fp64_t>(40, 3, 50);
+    return 0;
+}
+
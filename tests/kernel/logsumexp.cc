@@ -12,12 +12,129 @@
  * @date 2023-05-02
  * */
 
+#include "nntile/kernel/logsumexp.hh"
+#include "nntile/kernel/simd.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
 #include <iostream>
 
+using namespace nntile;
+using namespace nntile::kernel::logsumexp;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index nelems, const std::vector<T> &maxsumexp,
+        std::vector<T> &logsumexp)
+{
+    // Copy to device
+    T *dev_maxsumexp, *dev_logsumexp;
+    cudaError_t cuda_err = cudaMalloc(&dev_maxsumexp, sizeof(T)*2*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_logsumexp, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_maxsumexp, &maxsumexp[0], sizeof(T)*2*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, nelems, dev_maxsumexp, dev_logsumexp);
+    // Wait for result and destroy stream
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&logsumexp[0], dev_logsumexp, sizeof(T)*nelems,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_maxsumexp);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_logsumexp);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check output against logarithms of test input
+template<typename T>
+void check(Index nelems, const std::vector<T> &maxsumexp,
+        const std::vector<T> &logsumexp)
+{
+    constexpr T epsilon = std::numeric_limits<T>::epsilon();
+    for(Index i = 0; i < nelems; ++i)
+    {
+        T max = maxsumexp[2*i];
+        T log_sum = std::log(maxsumexp[2*i+1]);
+        T val_ref = max + log_sum;
+        TEST_ASSERT(std::abs(logsumexp[i]-val_ref)
+                <= 4*epsilon*(std::abs(max)+std::abs(log_sum)));
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index nelems)
+{
+    // Init test input with sums of exponents of different magnitudes
+    std::vector<T> maxsumexp(2*nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        maxsumexp[2*i] = T(i%17) / T{4} - T{2};
+        maxsumexp[2*i+1] = std::pow(T{10}, T(i%23)/T{4} - T{2});
+    }
+    // Result without vectorization
+    using kernel::simd::Level;
+    kernel::simd::set_level(Level::NONE);
+    std::vector<T> logsumexp_scalar(nelems);
+    cpu<T>(nelems, &maxsumexp[0], &logsumexp_scalar[0]);
+    // Check low-level kernel with all the supported instruction sets
+    for(Level level: {Level::NONE, Level::AVX2, Level::AVX512})
+    {
+        if(kernel::simd::set_level(level) != level)
+        {
+            continue;
+        }
+        std::vector<T> logsumexp(nelems);
+        std::cout << "Run kernel::logsumexp::cpu<T> with SIMD level "
+            << static_cast<int>(level) << "\n";
+        cpu<T>(nelems, &maxsumexp[0], &logsumexp[0]);
+        check<T>(nelems, maxsumexp, logsumexp);
+        // Vectorized result is close to the scalar one
+        for(Index i = 0; i < nelems; ++i)
+        {
+            T log_sum = std::log(maxsumexp[2*i+1]);
+            TEST_ASSERT(std::abs(logsumexp[i]-logsumexp_scalar[i])
+                    <= 4*std::numeric_limits<T>::epsilon()
+                    *(std::abs(maxsumexp[2*i])+std::abs(log_sum)));
+        }
+        std::cout << "OK: kernel::logsumexp::cpu<T>\n";
+    }
+    kernel::simd::set_level(Level::AVX512);
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> logsumexp_cuda(nelems);
+    std::cout << "Run kernel::logsumexp::cuda<T>\n";
+    run_cuda<T>(nelems, maxsumexp, logsumexp_cuda);
+    check<T>(nelems, maxsumexp, logsumexp_cuda);
+    std::cout << "OK: kernel::logsumexp::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
 int main(int argc, char **argv)
 {
-    // Not implemented
-    std::cout << "This test is not yet implemented\n";
-    return -1;
+    validate<fp32_t>(1);
+    validate<fp32_t>(7);
+    validate<fp32_t>(100);
+    validate<fp32_t>(1001);
+    validate<fp64_t>(1);
+    validate<fp64_t>(7);
+    validate<fp64_t>(100);
+    validate<fp64_t>(1001);
+    return 0;
 }
 
@@ -24,11 +24,13 @@
 #include <gtest/gtest.h>
 
 #include "nntile/kernel/maxsumexp.hh"
+#include "nntile/kernel/simd.hh"
 
 using namespace nntile;
 using nntile::kernel::maxsumexp::cpu;
 using nntile::kernel::maxsumexp::LaunchMaxSumExp1;
 using nntile::kernel::maxsumexp::LaunchMaxSumExp3;
+using nntile::kernel::maxsumexp::LaunchMaxSumExpCoalesced;
 
 // TileShape (aka batch size, reduced size, seq len) represents a shape of tile
 // which is reduced along the middle (seq len) axis.
@@ -98,15 +100,39 @@ protected:
 
     template <typename T> void RunTest(void) {
         Index m = batch_size_, n = seq_len_, k = reduced_size_;
+        using kernel::simd::Level;
 
-        std::vector<T> src = GenerateData<T>();
-        std::vector<T> maxsumexp(2 * batch_size_ * seq_len_);
-        cpu<T>(m, n, k, &src[0], &maxsumexp[0]);
-        AssertSimple<T>(maxsumexp);
-
-        std::vector<T> maxsumexp_copy(maxsumexp);
-        cpu<T>(m, n, k, &src[0], &maxsumexp[0]);
-        AssertDetailed<T>(maxsumexp, maxsumexp_copy);
+        // Check all the supported instruction sets
+        for (Level level : {Level::NONE, Level::AVX2, Level::AVX512}) {
+            if (kernel::simd::set_level(level) != level) {
+                continue;
+            }
+            std::vector<T> src = GenerateData<T>();
+            std::vector<T> maxsumexp(2 * batch_size_ * seq_len_);
+            cpu<T>(m, n, k, &src[0], &maxsumexp[0]);
+            AssertSimple<T>(maxsumexp);
+
+            std::vector<T> maxsumexp_copy(maxsumexp);
+            cpu<T>(m, n, k, &src[0], &maxsumexp[0]);
+            AssertDetailed<T>(maxsumexp, maxsumexp_copy);
+
+            // Masked out values in between do not change the result
+            std::vector<T> src_mask(2 * m * k * n);
+            T constexpr inf = std::numeric_limits<T>::infinity();
+            for (Index i2 = 0; i2 < n; ++i2) {
+                for (Index i1 = 0; i1 < k; ++i1) {
+                    for (Index i0 = 0; i0 < m; ++i0) {
+                        Index i = (i2 * 2 * k + 2 * i1) * m + i0;
+                        src_mask[i] = src[(i2 * k + i1) * m + i0];
+                        src_mask[i + m] = -inf;
+                    }
+                }
+            }
+            std::vector<T> maxsumexp_mask(2 * batch_size_ * seq_len_);
+            cpu<T>(m, n, 2 * k, &src_mask[0], &maxsumexp_mask[0]);
+            AssertSimple<T>(maxsumexp_mask);
+        }
+        kernel::simd::set_level(Level::AVX512);
     }
 
 protected:
@@ -196,8 +222,14 @@ protected:
     template <typename T>
     void LaunchKernel(cudaStream_t stream_, Index m, Index n, Index k,
                       T const *input, T *output) {
-        LaunchMaxSumExp1<T>(stream_, m, n, k, input, output);
+        if (coalesced_) {
+            LaunchMaxSumExpCoalesced<T>(stream_, m, n, k, input, output);
+        } else {
+            LaunchMaxSumExp1<T>(stream_, m, n, k, input, output);
+        }
     }
+
+    bool coalesced_ = false;
 };
 
 TEST_P(MaxSumExpCUDA, FP64) {
@@ -212,10 +244,29 @@ TEST_P(MaxSumExpCUDA, FP32) {
 static auto const kTestParams =
     ::testing::Values(std::make_tuple(1, 9, 10), std::make_tuple(8, 9, 1),
                       std::make_tuple(8, 1, 10), std::make_tuple(4, 7, 8),
-                      std::make_tuple(32, 1024, 1024));
+                      std::make_tuple(32, 1024, 1024),
+                      std::make_tuple(40, 3, 100));
 
 INSTANTIATE_TEST_SUITE_P(Kernel, MaxSumExpCUDA, kTestParams);
 
+class MaxSumExpCoalescedCUDA : public MaxSumExpCUDA {
+protected:
+    void SetUp(void) override {
+        MaxSumExpCUDA::SetUp();
+        coalesced_ = true;
+    }
+};
+
+TEST_P(MaxSumExpCoalescedCUDA, FP64) {
+    RunTest<double>();
+}
+
+TEST_P(MaxSumExpCoalescedCUDA, FP32) {
+    RunTest<float>();
+}
+
+INSTANTIATE_TEST_SUITE_P(Kernel, MaxSumExpCoalescedCUDA, kTestParams);
+
 class MaxSumExp3CUDA : public MaxSumExpCPU {
 protected:
     template <typename T>
@@ -0,0 +1,158 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/moe_combine_backward.cc
+ * Gradient of weights of experts, that combine tokens
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/moe_combine_backward.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::moe_combine_backward;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index seq, Index seq_start, Index seq_size,
+        Index batch_start, Index batch_size, Index capacity, Index n_experts,
+        Index expert, const std::vector<Index> &slots,
+        const std::vector<T> &dst_grad, const std::vector<T> &src,
+        std::vector<T> &probs_grad)
+{
+    // Copy to device
+    Index *dev_slots;
+    T *dev_dst_grad, *dev_src, *dev_probs_grad;
+    cudaError_t cuda_err = cudaMalloc(&dev_slots,
+            sizeof(Index)*slots.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst_grad, sizeof(T)*dst_grad.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_src, sizeof(T)*src.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_probs_grad, sizeof(T)*probs_grad.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_slots, &slots[0], sizeof(Index)*slots.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_dst_grad, &dst_grad[0],
+            sizeof(T)*dst_grad.size(), cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*src.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_probs_grad, &probs_grad[0],
+            sizeof(T)*probs_grad.size(), cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, m, seq, seq_start, seq_size, batch_start, batch_size,
+            capacity, n_experts, expert, dev_slots, dev_dst_grad, dev_src,
+            dev_probs_grad);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&probs_grad[0], dev_probs_grad,
+            sizeof(T)*probs_grad.size(), cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_slots);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst_grad);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_probs_grad);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+template<typename T>
+void validate(Index m)
+{
+    // Tile of 3 positions of 2 sequences out of 5 positions of 4 sequences
+    Index seq = 5, seq_start = 1, seq_size = 3, batch_start = 1,
+          batch_size = 2, n_tokens = seq * 4;
+    Index capacity = 6, n_experts = 3, expert = 1;
+    // Distinct tokens of every expert with a free slot
+    std::vector<Index> slots(capacity*n_experts);
+    for(Index e = 0; e < n_experts; ++e)
+    {
+        for(Index c = 0; c < capacity; ++c)
+        {
+            slots[e*capacity+c] = (c == 4) ? -1 : (c+5+e) % n_tokens;
+        }
+    }
+    Index tile_tokens = seq_size * batch_size;
+    std::vector<T> dst_grad(m*tile_tokens), src(m*capacity);
+    for(Index i = 0; i < m*tile_tokens; ++i)
+    {
+        dst_grad[i] = T(i % 7) - T(3);
+    }
+    for(Index i = 0; i < m*capacity; ++i)
+    {
+        src[i] = T(i % 11) - T(5);
+    }
+    // Gradients of other experts and tokens stay untouched
+    std::vector<T> probs_grad(n_experts*tile_tokens, T(-1)), ref(probs_grad);
+    for(Index c = 0; c < capacity; ++c)
+    {
+        Index t = slots[expert*capacity+c];
+        Index s = t%seq - seq_start, b = t/seq - batch_start;
+        if(t < 0 or s < 0 or s >= seq_size or b < 0 or b >= batch_size)
+        {
+            continue;
+        }
+        Index local = s + b*seq_size;
+        T sum = 0;
+        for(Index i = 0; i < m; ++i)
+        {
+            sum += dst_grad[i+local*m] * src[i+c*m];
+        }
+        ref[local*n_experts+expert] += sum;
+    }
+    std::cout << "Run kernel::moe_combine_backward::cpu<T>\n";
+    cpu<T>(m, seq, seq_start, seq_size, batch_start, batch_size, capacity,
+            n_experts, expert, &slots[0], &dst_grad[0], &src[0],
+            &probs_grad[0]);
+    for(Index i = 0; i < n_experts*tile_tokens; ++i)
+    {
+        TEST_ASSERT(probs_grad[i] == ref[i]);
+    }
+    std::cout << "OK: kernel::moe_combine_backward::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    std::vector<T> probs_grad_cuda(n_experts*tile_tokens, T(-1));
+    std::cout << "Run kernel::moe_combine_backward::cuda<T>\n";
+    run_cuda<T>(m, seq, seq_start, seq_size, batch_start, batch_size,
+            capacity, n_experts, expert, slots, dst_grad, src,
+            probs_grad_cuda);
+    for(Index i = 0; i < n_experts*tile_tokens; ++i)
+    {
+        TEST_ASSERT(probs_grad_cuda[i] == ref[i]);
+    }
+    std::cout << "OK: kernel::moe_combine_backward::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1);
+    validate<fp32_t>(7);
+    validate<fp64_t>(40);
+    return 0;
+}
+
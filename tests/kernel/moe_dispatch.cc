@@ -0,0 +1,158 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/moe_dispatch.cc
+ * Gather of tokens into buffers of experts
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/moe_dispatch.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::moe_dispatch;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index seq, Index seq_start, Index seq_size,
+        Index batch_start, Index batch_size, Index capacity, Index n_experts,
+        Index expert, const std::vector<Index> &slots,
+        const std::vector<T> &probs, bool weighted,
+        const std::vector<T> &src, std::vector<T> &dst)
+{
+    // Copy to device
+    Index *dev_slots;
+    T *dev_probs, *dev_src, *dev_dst;
+    cudaError_t cuda_err = cudaMalloc(&dev_slots,
+            sizeof(Index)*slots.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_probs, sizeof(T)*probs.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_src, sizeof(T)*src.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(T)*dst.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_slots, &slots[0], sizeof(Index)*slots.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_probs, &probs[0], sizeof(T)*probs.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*src.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_dst, &dst[0], sizeof(T)*dst.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, m, seq, seq_start, seq_size, batch_start, batch_size,
+            capacity, n_experts, expert, dev_slots,
+            weighted ? dev_probs : nullptr, dev_src, dev_dst);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(T)*dst.size(),
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_slots);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_probs);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+template<typename T>
+void validate(Index m, bool weighted)
+{
+    // Tile of 3 positions of 2 sequences out of 5 positions of 4 sequences
+    Index seq = 5, seq_start = 1, seq_size = 3, batch_start = 1,
+          batch_size = 2, n_tokens = seq * 4;
+    Index capacity = 6, n_experts = 3, expert = 1;
+    // Distinct tokens of every expert with a free slot
+    std::vector<Index> slots(capacity*n_experts);
+    for(Index e = 0; e < n_experts; ++e)
+    {
+        for(Index c = 0; c < capacity; ++c)
+        {
+            slots[e*capacity+c] = (c == 4) ? -1 : (c+5+e) % n_tokens;
+        }
+    }
+    Index tile_tokens = seq_size * batch_size;
+    std::vector<T> probs(n_experts*tile_tokens), src(m*tile_tokens);
+    for(Index i = 0; i < n_experts*tile_tokens; ++i)
+    {
+        probs[i] = T(1) / T(i+1);
+    }
+    for(Index i = 0; i < m*tile_tokens; ++i)
+    {
+        src[i] = T(i % 11) - T(5);
+    }
+    // Slots with tokens of other tiles stay untouched
+    std::vector<T> dst(m*capacity, T(-1)), ref(dst);
+    for(Index c = 0; c < capacity; ++c)
+    {
+        Index t = slots[expert*capacity+c];
+        Index s = t%seq - seq_start, b = t/seq - batch_start;
+        if(t < 0 or s < 0 or s >= seq_size or b < 0 or b >= batch_size)
+        {
+            continue;
+        }
+        Index local = s + b*seq_size;
+        T w = weighted ? probs[local*n_experts+expert] : T(1);
+        for(Index i = 0; i < m; ++i)
+        {
+            ref[i+c*m] = w * src[i+local*m];
+        }
+    }
+    std::cout << "Run kernel::moe_dispatch::cpu<T>\n";
+    cpu<T>(m, seq, seq_start, seq_size, batch_start, batch_size, capacity,
+            n_experts, expert, &slots[0], weighted ? &probs[0] : nullptr,
+            &src[0], &dst[0]);
+    for(Index i = 0; i < m*capacity; ++i)
+    {
+        TEST_ASSERT(dst[i] == ref[i]);
+    }
+    std::cout << "OK: kernel::moe_dispatch::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    std::vector<T> dst_cuda(m*capacity, T(-1));
+    std::cout << "Run kernel::moe_dispatch::cuda<T>\n";
+    run_cuda<T>(m, seq, seq_start, seq_size, batch_start, batch_size,
+            capacity, n_experts, expert, slots, probs, weighted, src,
+            dst_cuda);
+    for(Index i = 0; i < m*capacity; ++i)
+    {
+        TEST_ASSERT(dst_cuda[i] == ref[i]);
+    }
+    std::cout << "OK: kernel::moe_dispatch::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, false);
+    validate<fp32_t>(7, true);
+    validate<fp64_t>(40, false);
+    validate<fp64_t>(40, true);
+    return 0;
+}
+
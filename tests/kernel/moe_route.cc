@@ -0,0 +1,81 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/moe_route.cc
+ * Routing of tokens to experts with a limited capacity
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/moe_route.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+#include <cmath>
+#include <limits>
+
+using namespace nntile;
+using namespace nntile::kernel::moe_route;
+
+template<typename T>
+void validate(Index k, Index n_tokens, Index n_experts, Index capacity)
+{
+    // Experts of tokens, some choices are missing
+    std::vector<Index> experts(k*n_tokens);
+    for(Index t = 0; t < n_tokens; ++t)
+    {
+        for(Index j = 0; j < k; ++j)
+        {
+            experts[t*k+j] = (t*t+3*j) % (n_experts+1) - 1;
+        }
+    }
+    std::vector<Index> slots(capacity*n_experts);
+    std::vector<T> load(n_experts);
+    std::cout << "Run kernel::moe_route::cpu<T>\n";
+    cpu<T>(k, n_tokens, n_experts, capacity, &experts[0], &slots[0],
+            &load[0]);
+    // Reference placement in order of choices and tokens
+    std::vector<Index> count(n_experts, 0);
+    for(Index j = 0; j < k; ++j)
+    {
+        for(Index t = 0; t < n_tokens; ++t)
+        {
+            Index e = experts[t*k+j];
+            if(e < 0)
+            {
+                continue;
+            }
+            if(count[e] < capacity)
+            {
+                TEST_ASSERT(slots[e*capacity+count[e]] == t);
+            }
+            ++count[e];
+        }
+    }
+    for(Index e = 0; e < n_experts; ++e)
+    {
+        for(Index c = count[e]; c < capacity; ++c)
+        {
+            TEST_ASSERT(slots[e*capacity+c] == -1);
+        }
+        T ref = T(count[e]) / T(k*n_tokens);
+        TEST_ASSERT(std::abs(load[e]-ref) <= 10*std::abs(ref)
+                *std::numeric_limits<T>::epsilon());
+    }
+    std::cout << "OK: kernel::moe_route::cpu<T>\n";
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, 10, 3, 4);
+    validate<fp32_t>(2, 17, 4, 3);
+    validate<fp64_t>(2, 17, 4, 100);
+    return 0;
+}
+
@@ -0,0 +1,295 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/multi_adam_step.cc
+ * Fused Adam and AdamW steps on many buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-02
+ * */
+
+#include "nntile/kernel/multi_adam_step.hh"
+#include "nntile/kernel/adam_step.hh"
+#include "nntile/kernel/adamw_step.hh"
+#include "nntile/kernel/simd.hh"
+#include "nntile/kernel/parallel.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::multi_adam_step;
+
+// Buffers of a set of parameters
+template<typename T>
+struct State
+{
+    std::vector<std::vector<T>> grad, first_moment, second_moment, p;
+    explicit State(const std::vector<Index> &num_elems)
+    {
+        Index ntensors = num_elems.size();
+        grad.resize(ntensors);
+        first_moment.resize(ntensors);
+        second_moment.resize(ntensors);
+        p.resize(ntensors);
+        for(Index j = 0; j < ntensors; ++j)
+        {
+            grad[j].resize(num_elems[j]);
+            first_moment[j].resize(num_elems[j]);
+            second_moment[j].resize(num_elems[j]);
+            p[j].resize(num_elems[j]);
+            for(Index i = 0; i < num_elems[j]; ++i)
+            {
+                grad[j][i] = T(2*i+j+1) / T(i+j+7) - T(0.5);
+                first_moment[j][i] = T(0.01) * T((i+j)%7);
+                second_moment[j][i] = T(0.02) * T((i+2*j)%5);
+                p[j][i] = T(i%11) - T(j%3);
+            }
+        }
+    }
+};
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(const std::vector<Index> &num_elems, Index num_iter, T beta_1,
+        T beta_2, T eps, T lr, T weight_decay, bool decoupled,
+        State<T> &state, const T *scalars=nullptr)
+{
+    Index ntensors = num_elems.size();
+    std::vector<T *> dev[4];
+    std::vector<std::vector<T>> *host[4] = {&state.grad, &state.first_moment,
+        &state.second_moment, &state.p};
+    cudaError_t cuda_err;
+    for(int k = 0; k < 4; ++k)
+    {
+        dev[k].resize(ntensors);
+        for(Index j = 0; j < ntensors; ++j)
+        {
+            cuda_err = cudaMalloc(&dev[k][j], sizeof(T)*num_elems[j]);
+            TEST_ASSERT(cuda_err == cudaSuccess);
+            cuda_err = cudaMemcpy(dev[k][j], (*host[k])[j].data(),
+                    sizeof(T)*num_elems[j], cudaMemcpyHostToDevice);
+            TEST_ASSERT(cuda_err == cudaSuccess);
+        }
+    }
+    // Learning rate and scale of gradients are in the device memory
+    T *dev_scalars = nullptr;
+    if(scalars != nullptr)
+    {
+        cuda_err = cudaMalloc(&dev_scalars, 2*sizeof(T));
+        TEST_ASSERT(cuda_err == cudaSuccess);
+        cuda_err = cudaMemcpy(dev_scalars, scalars, 2*sizeof(T),
+                cudaMemcpyHostToDevice);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+    }
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, ntensors, &num_elems[0], num_iter, beta_1, beta_2, eps,
+            lr, weight_decay, decoupled, &dev[0][0], &dev[1][0], &dev[2][0],
+            &dev[3][0], dev_scalars);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    for(int k = 0; k < 4; ++k)
+    {
+        for(Index j = 0; j < ntensors; ++j)
+        {
+            cuda_err = cudaMemcpy((*host[k])[j].data(), dev[k][j],
+                    sizeof(T)*num_elems[j], cudaMemcpyDeviceToHost);
+            TEST_ASSERT(cuda_err == cudaSuccess);
+            cuda_err = cudaFree(dev[k][j]);
+            TEST_ASSERT(cuda_err == cudaSuccess);
+        }
+    }
+    if(dev_scalars != nullptr)
+    {
+        cuda_err = cudaFree(dev_scalars);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+    }
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Compare buffers of two sets of parameters
+template<typename T>
+void check(const State<T> &state, const State<T> &ref)
+{
+    constexpr T eps = 10 * std::numeric_limits<T>::epsilon();
+    const std::vector<std::vector<T>> *a[4] = {&state.grad,
+        &state.first_moment, &state.second_moment, &state.p};
+    const std::vector<std::vector<T>> *b[4] = {&ref.grad, &ref.first_moment,
+        &ref.second_moment, &ref.p};
+    for(int k = 0; k < 4; ++k)
+    {
+        for(Index j = 0; j < a[k]->size(); ++j)
+        {
+            for(Index i = 0; i < (*a[k])[j].size(); ++i)
+            {
+                T val = (*a[k])[j][i], val_ref = (*b[k])[j][i];
+                TEST_ASSERT(std::abs(val-val_ref)
+                        <= eps*(1+std::abs(val_ref)));
+            }
+        }
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(const std::vector<Index> &num_elems, Index num_iter,
+        T weight_decay, bool decoupled)
+{
+    const T beta_1 = 0.9, beta_2 = 0.999, eps = 1e-8, lr = 1e-2;
+    Index ntensors = num_elems.size();
+    // Get reference result by single-buffer kernels
+    auto reference = [&](State<T> &ref)
+    {
+        for(Index j = 0; j < ntensors; ++j)
+        {
+            if(decoupled)
+            {
+                kernel::adamw_step::cpu<T>(num_iter, num_elems[j], beta_1,
+                        beta_2, eps, lr, weight_decay, ref.grad[j].data(),
+                        ref.first_moment[j].data(),
+                        ref.second_moment[j].data(), ref.p[j].data());
+            }
+            else
+            {
+                kernel::adam_step::cpu<T>(num_iter, num_elems[j], beta_1,
+                        beta_2, eps, lr, weight_decay, ref.grad[j].data(),
+                        ref.first_moment[j].data(),
+                        ref.second_moment[j].data(), ref.p[j].data());
+            }
+        }
+    };
+    // Reference is computed without vectorization
+    using kernel::simd::Level;
+    kernel::simd::set_level(Level::NONE);
+    State<T> ref(num_elems);
+    reference(ref);
+    // Reference for gradients, that are scaled by a half, e.g., by clipping
+    const T scalars[2] = {lr, T(0.5)};
+    State<T> ref_scaled(num_elems);
+    for(Index j = 0; j < ntensors; ++j)
+    {
+        for(Index i = 0; i < num_elems[j]; ++i)
+        {
+            ref_scaled.grad[j][i] *= scalars[1];
+        }
+    }
+    reference(ref_scaled);
+    // Kernel does not change gradients
+    ref_scaled.grad = ref.grad;
+    // Check low-level CPU kernel with all the supported instruction sets,
+    // sequentially and with buffers split among threads
+    for(Level level: {Level::NONE, Level::AVX2, Level::AVX512})
+    for(int nthreads: {1, 4})
+    {
+        if(kernel::simd::set_level(level) != level)
+        {
+            continue;
+        }
+        kernel::parallel::Scope threads(nthreads);
+        State<T> state(num_elems);
+        std::vector<T *> ptr[4];
+        for(Index j = 0; j < ntensors; ++j)
+        {
+            ptr[0].push_back(state.grad[j].data());
+            ptr[1].push_back(state.first_moment[j].data());
+            ptr[2].push_back(state.second_moment[j].data());
+            ptr[3].push_back(state.p[j].data());
+        }
+        std::cout << "Run kernel::multi_adam_step::cpu<T> with SIMD level "
+            << static_cast<int>(level) << " and " << nthreads
+            << " threads\n";
+        cpu<T>(ntensors, &num_elems[0], num_iter, beta_1, beta_2, eps, lr,
+                weight_decay, decoupled, &ptr[0][0], &ptr[1][0], &ptr[2][0],
+                &ptr[3][0]);
+        check(state, ref);
+        std::cout << "OK: kernel::multi_adam_step::cpu<T>\n";
+        // Learning rate is read from scalars instead of the argument
+        State<T> state_scaled(num_elems);
+        for(Index j = 0; j < ntensors; ++j)
+        {
+            ptr[0][j] = state_scaled.grad[j].data();
+            ptr[1][j] = state_scaled.first_moment[j].data();
+            ptr[2][j] = state_scaled.second_moment[j].data();
+            ptr[3][j] = state_scaled.p[j].data();
+        }
+        std::cout << "Run kernel::multi_adam_step::cpu<T> with scalars\n";
+        cpu<T>(ntensors, &num_elems[0], num_iter, beta_1, beta_2, eps, T(0),
+                weight_decay, decoupled, &ptr[0][0], &ptr[1][0], &ptr[2][0],
+                &ptr[3][0], scalars);
+        check(state_scaled, ref_scaled);
+        std::cout << "OK: kernel::multi_adam_step::cpu<T> with scalars\n";
+        // Single-buffer kernels with the same instruction set
+        State<T> state_single(num_elems);
+        std::cout << "Run kernel::" << (decoupled ? "adamw" : "adam")
+            << "_step::cpu<T>\n";
+        reference(state_single);
+        check(state_single, ref);
+        std::cout << "OK: kernel::" << (decoupled ? "adamw" : "adam")
+            << "_step::cpu<T>\n";
+    }
+    kernel::simd::set_level(Level::AVX512);
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    State<T> state_cuda(num_elems);
+    std::cout << "Run kernel::multi_adam_step::cuda<T>\n";
+    run_cuda<T>(num_elems, num_iter, beta_1, beta_2, eps, lr, weight_decay,
+            decoupled, state_cuda);
+    check(state_cuda, ref);
+    std::cout << "OK: kernel::multi_adam_step::cuda<T>\n";
+    State<T> state_cuda_scaled(num_elems);
+    std::cout << "Run kernel::multi_adam_step::cuda<T> with scalars\n";
+    run_cuda<T>(num_elems, num_iter, beta_1, beta_2, eps, T(0), weight_decay,
+            decoupled, state_cuda_scaled, scalars);
+    check(state_cuda_scaled, ref_scaled);
+    std::cout << "OK: kernel::multi_adam_step::cuda<T> with scalars\n";
+#endif // NNTILE_USE_CUDA
+}
+
+// Check both weight decays on the first and on a later iteration
+template<typename T>
+void validate_all(const std::vector<Index> &num_elems)
+{
+    validate<T>(num_elems, 1, 0, false);
+    validate<T>(num_elems, 3, 0, false);
+    validate<T>(num_elems, 1, 0.1, false);
+    validate<T>(num_elems, 5, 0.1, false);
+    validate<T>(num_elems, 1, 0.1, true);
+    validate<T>(num_elems, 5, 0.1, true);
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<Index> num_elems1 = {1}, num_elems2 = {7, 1, 300, 0, 65};
+    // Buffers, that are large enough to be split among threads
+    std::vector<Index> num_elems4 = {70001, 3, 40000};
+    // More buffers than a single CUDA launch processes
+    std::vector<Index> num_elems3(250);
+    for(Index j = 0; j < num_elems3.size(); ++j)
+    {
+        num_elems3[j] = (j*37) % 101;
+    }
+    validate_all<fp32_t>(num_elems1);
+    validate_all<fp32_t>(num_elems2);
+    validate_all<fp32_t>(num_elems3);
+    validate_all<fp32_t>(num_elems4);
+    validate_all<fp64_t>(num_elems1);
+    validate_all<fp64_t>(num_elems2);
+    validate_all<fp64_t>(num_elems3);
+    validate_all<fp64_t>(num_elems4);
+    return 0;
+}
+
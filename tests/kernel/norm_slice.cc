@@ -136,10 +136,18 @@ int main(int argc, char **argv)
     validate<fp32_t>(8, 9, 1, 1.0, -1.0);
     validate<fp32_t>(8, 1, 10, -1.0, 1.0);
     validate<fp32_t>(4, 7, 8, 0.0, 2.0);
+    validate<fp32_t>(1, 5, 64, 1.0, 1.0);
+    validate<fp32_t>(1, 3, 300, -1.0, 0.0);
+    validate<fp32_t>(40, 3, 10, 1.0, -1.0);
+    validate<fp32_t>(33, 2, 100, -1.0, 0.0);
     validate<fp64_t>(1, 9, 10, 2.0, 0.0);
     validate<fp64_t>(8, 9, 1, 1.0, 1.0);
     validate<fp64_t>(8, 1, 10, -1.0, -1.0);
     validate<fp64_t>(4, 7, 8, 2.5, 1.25);
+    validate<fp64_t>(1, 5, 64, 1.0, 1.0);
+    validate<fp64_t>(1, 3, 1500, 2.0, -1.0);
+    validate<fp64_t>(64, 3, 100, 2.0, 1.0);
+    validate<fp64_t>(48, 2, 7, 1.0, 0.0);
     return 0;
 }
 
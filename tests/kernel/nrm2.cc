@@ -0,0 +1,169 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/nrm2.cc
+ * Euclidean norm of a buffer accumulated into a scalar by hypot
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/nrm2.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+using namespace nntile;
+using namespace nntile::kernel::nrm2;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index nelems, T alpha, const std::vector<T> &src, T beta,
+        T &dst)
+{
+    // Allocate on device
+    Index nwork = std::min<Index>((nelems+8191)/8192, 256);
+    nwork = std::max<Index>(nwork, 1);
+    T *dev_src, *dev_dst, *dev_work;
+    cudaError_t cuda_err = cudaMalloc(&dev_src, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(T));
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_work, sizeof(T)*nwork);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy to device
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_dst, &dst, sizeof(T), cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, nelems, alpha, dev_src, beta, dev_dst, nwork, dev_work);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&dst, dev_dst, sizeof(T), cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_work);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Check the result against a norm computed in long double
+template<typename T>
+void check(T dst, T dst_ref)
+{
+    if(std::isnan(dst_ref))
+    {
+        TEST_ASSERT(std::isnan(dst));
+    }
+    else if(std::isinf(dst_ref) or dst_ref == T(0))
+    {
+        TEST_ASSERT(dst == dst_ref);
+    }
+    else
+    {
+        T eps = std::numeric_limits<T>::epsilon();
+        TEST_ASSERT(std::abs(dst/dst_ref-T(1)) <= 10*eps);
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index nelems, T scale, T alpha, T beta)
+{
+    // Init test input with values of different magnitudes
+    std::vector<T> src(nelems);
+    long double ssq = 0;
+    for(Index i = 0; i < nelems; ++i)
+    {
+        src[i] = scale * T(1+i%7) / T((i%3) ? 3 : -5);
+        ssq += (long double)src[i] * (long double)src[i];
+    }
+    T dst_init = scale * T(nelems%5);
+    T dst_ref = std::hypot(std::abs(alpha)*std::sqrt(ssq),
+            (long double)beta*dst_init);
+    // Check low-level kernel
+    T dst = dst_init;
+    std::cout << "Run kernel::nrm2::cpu<T>\n";
+    cpu<T>(nelems, alpha, &src[0], beta, &dst);
+    check<T>(dst, dst_ref);
+    std::cout << "OK: kernel::nrm2::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    T dst_cuda = dst_init;
+    std::cout << "Run kernel::nrm2::cuda<T>\n";
+    run_cuda<T>(nelems, alpha, src, beta, dst_cuda);
+    check<T>(dst_cuda, dst_ref);
+    std::cout << "OK: kernel::nrm2::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+// Zeros, infinities and NaNs
+template<typename T>
+void validate_special(Index nelems)
+{
+    std::vector<T> src(nelems, T(0));
+    T dst = -1;
+    cpu<T>(nelems, T(1), &src[0], T(0), &dst);
+    TEST_ASSERT(dst == T(0));
+    src[nelems/2] = std::numeric_limits<T>::infinity();
+    cpu<T>(nelems, T(1), &src[0], T(0), &dst);
+    TEST_ASSERT(std::isinf(dst));
+    src[nelems/2] = std::numeric_limits<T>::quiet_NaN();
+    cpu<T>(nelems, T(1), &src[0], T(0), &dst);
+    TEST_ASSERT(std::isnan(dst));
+#ifdef NNTILE_USE_CUDA
+    run_cuda<T>(nelems, T(1), src, T(0), dst);
+    TEST_ASSERT(std::isnan(dst));
+    src[nelems/2] = T(0);
+    run_cuda<T>(nelems, T(1), src, T(0), dst);
+    TEST_ASSERT(dst == T(0));
+#endif // NNTILE_USE_CUDA
+}
+
+template<typename T>
+void validate_many()
+{
+    // Tail of a lane, tail of a block, many blocks
+    for(Index nelems: {1, 15, 1000, 100000})
+    {
+        validate<T>(nelems, T(1), T(1), T(0));
+        validate<T>(nelems, T(1), T(-2), T(0.5));
+        validate<T>(nelems, T(1), T(0), T(1));
+        // Squares overflow and underflow, so the two-pass algorithm is used
+        T huge = std::sqrt(std::numeric_limits<T>::max());
+        T tiny = std::sqrt(std::numeric_limits<T>::min());
+        validate<T>(nelems, huge, T(0.5), T(1));
+        validate<T>(nelems, tiny, T(1), T(0));
+        validate<T>(nelems, tiny*tiny, T(1), T(1));
+    }
+    validate_special<T>(1);
+    validate_special<T>(100000);
+}
+
+int main(int argc, char **argv)
+{
+    validate_many<fp32_t>();
+    validate_many<fp64_t>();
+    return 0;
+}
+
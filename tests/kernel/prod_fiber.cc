@@ -12,12 +12,129 @@
  * @date 2023-07-03
  * */
 
+#include "nntile/kernel/prod_fiber.hh"
+#include "nntile/kernel/simd.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
 #include <iostream>
 
+using namespace nntile;
+using namespace nntile::kernel::prod_fiber;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, Index k, T alpha, const std::vector<T> &src,
+        std::vector<T> &dst)
+{
+    // Copy to device
+    T *dev_src, *dev_dst;
+    cudaError_t cuda_err = cudaMalloc(&dev_src, sizeof(T)*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_dst, &dst[0], sizeof(T)*m*n*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, m, n, k, alpha, dev_src, dev_dst);
+    // Wait for result and destroy stream
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(T)*m*n*k,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k)
+{
+    constexpr T alpha = -1.5;
+    // Init test input
+    std::vector<T> src(k), dst(m*n*k);
+    for(Index i2 = 0; i2 < k; ++i2)
+    {
+        src[i2] = T(i2+1) / T{7};
+    }
+    for(Index i = 0; i < m*n*k; ++i)
+    {
+        dst[i] = T(i%19) / T{5} - T{1};
+    }
+    // Reference result by a naive loop, products are rounded exactly as in
+    // the kernel
+    std::vector<T> dst_ref(dst);
+    for(Index i0 = 0; i0 < m; ++i0)
+    {
+        for(Index i1 = 0; i1 < n; ++i1)
+        {
+            for(Index i2 = 0; i2 < k; ++i2)
+            {
+                dst_ref[(i1*k+i2)*m+i0] *= alpha * src[i2];
+            }
+        }
+    }
+    // Check low-level kernel with all the supported instruction sets. The
+    // first mode of 16, 32, 64 or 128 goes into a specialized loop.
+    using kernel::simd::Level;
+    for(Level level: {Level::NONE, Level::AVX2, Level::AVX512})
+    {
+        if(kernel::simd::set_level(level) != level)
+        {
+            continue;
+        }
+        std::vector<T> dst_cpu(dst);
+        std::cout << "Run kernel::prod_fiber::cpu<T> with SIMD level "
+            << static_cast<int>(level) << "\n";
+        cpu<T>(m, n, k, alpha, &src[0], &dst_cpu[0]);
+        for(Index i = 0; i < m*n*k; ++i)
+        {
+            TEST_ASSERT(dst_cpu[i] == dst_ref[i]);
+        }
+        std::cout << "OK: kernel::prod_fiber::cpu<T>\n";
+    }
+    kernel::simd::set_level(Level::AVX512);
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    std::vector<T> dst_cuda(dst);
+    std::cout << "Run kernel::prod_fiber::cuda<T>\n";
+    run_cuda<T>(m, n, k, alpha, src, dst_cuda);
+    for(Index i = 0; i < m*n*k; ++i)
+    {
+        TEST_ASSERT(std::abs(dst_cuda[i]-dst_ref[i])
+                <= 2*eps*std::abs(dst_ref[i]));
+    }
+    std::cout << "OK: kernel::prod_fiber::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
 int main(int argc, char **argv)
 {
-    // Not implemented
-    std::cout << "This test is not yet implemented\n";
-    return -1;
+    for(Index m: {1, 7, 16, 32, 64, 128})
+    {
+        validate<fp32_t>(m, 3, 5);
+        validate<fp32_t>(m, 1, 20);
+        validate<fp64_t>(m, 3, 5);
+        validate<fp64_t>(m, 1, 20);
+    }
+    return 0;
 }
 
@@ -0,0 +1,146 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/quantize.cc
+ * Quantization of weights into 8-bit types with per-group scales
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/quantize.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+using namespace nntile;
+using namespace nntile::kernel::quantize;
+
+#ifdef NNTILE_USE_CUDA
+template<typename Q>
+void run_cuda(Index m, Index k, Index group, const std::vector<fp32_t> &src,
+        std::vector<Q> &dst, std::vector<fp32_t> &scale)
+{
+    // Copy to device
+    fp32_t *dev_src, *dev_scale;
+    Q *dev_dst;
+    cudaError_t cuda_err = cudaMalloc(&dev_src, sizeof(fp32_t)*m*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(Q)*m*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_scale, sizeof(fp32_t)*m*(k/group));
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(fp32_t)*m*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<Q>(stream, m, k, group, dev_src, dev_dst, dev_scale);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(Q)*m*k,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&scale[0], dev_scale, sizeof(fp32_t)*m*(k/group),
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_scale);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check scales and errors of dequantized values
+template<typename Q>
+void check(Index m, Index k, Index group, const std::vector<fp32_t> &src,
+        const std::vector<Q> &dst, const std::vector<fp32_t> &scale)
+{
+    constexpr fp32_t eps = std::numeric_limits<fp32_t>::epsilon();
+    constexpr bool is_int8 = std::is_same_v<Q, std::int8_t>;
+    constexpr fp32_t qmax = is_int8 ? 127 : 448;
+    for(Index g = 0; g < k/group; ++g)
+    {
+        for(Index i = 0; i < m; ++i)
+        {
+            fp32_t amax = 0;
+            for(Index l = g*group; l < (g+1)*group; ++l)
+            {
+                amax = std::max(amax, std::abs(src[l*m+i]));
+            }
+            fp32_t s = scale[g*m+i];
+            TEST_ASSERT(std::abs(s*qmax-amax) <= 2*eps*amax);
+            for(Index l = g*group; l < (g+1)*group; ++l)
+            {
+                fp32_t x = src[l*m+i];
+                fp32_t y = s * static_cast<fp32_t>(dst[l*m+i]);
+                // Half of a unit in the last place of Q with a subnormal
+                // part for FP8
+                fp32_t tol = is_int8 ? 0.5*s : 0.0625*std::abs(x)
+                    + 0.001*s;
+                TEST_ASSERT(std::abs(x-y) <= tol*(1+4*eps));
+            }
+        }
+    }
+}
+
+// Templated validation
+template<typename Q>
+void validate(Index m, Index k, Index group)
+{
+    // Init test input, the last row is zero
+    std::vector<fp32_t> src(m*k);
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        src[i] = fp32_t(i%23)/fp32_t(7) - fp32_t((i/3)%13);
+        if(i%m == m-1)
+        {
+            src[i] = 0;
+        }
+    }
+    // Check low-level CPU kernel
+    std::vector<Q> dst(m*k);
+    std::vector<fp32_t> scale(m*(k/group));
+    std::cout << "Run kernel::quantize::cpu<Q>\n";
+    cpu<Q>(m, k, group, &src[0], &dst[0], &scale[0]);
+    check<Q>(m, k, group, src, dst, scale);
+    std::cout << "OK: kernel::quantize::cpu<Q>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<Q> dst_cuda(m*k);
+    std::vector<fp32_t> scale_cuda(m*(k/group));
+    std::cout << "Run kernel::quantize::cuda<Q>\n";
+    run_cuda<Q>(m, k, group, src, dst_cuda, scale_cuda);
+    check<Q>(m, k, group, src, dst_cuda, scale_cuda);
+    std::cout << "OK: kernel::quantize::cuda<Q>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    // Per-channel and per-group scales
+    validate<std::int8_t>(30, 70, 70);
+    validate<std::int8_t>(30, 70, 7);
+    validate<std::int8_t>(1, 64, 1);
+    validate<fp8_e4m3_t>(30, 70, 70);
+    validate<fp8_e4m3_t>(30, 70, 7);
+    validate<fp8_e4m3_t>(1, 64, 1);
+    return 0;
+}
+
@@ -0,0 +1,225 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/quantized_adam_step.cc
+ * Fused Adam step with block-wise 8-bit moments
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/quantized_adam_step.hh"
+#include "nntile/kernel/adam_step.hh"
+#include "nntile/kernel/adamw_step.hh"
+#include "nntile/kernel/simd.hh"
+#include "nntile/kernel/parallel.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::quantized_adam_step;
+
+// Buffers of a parameter with quantized moments
+struct State
+{
+    std::vector<fp32_t> grad, first_scale, second_scale, p;
+    std::vector<std::int8_t> first_moment;
+    std::vector<fp8_e4m3_t> second_moment;
+    State(Index num_elems, Index block):
+        grad(num_elems), first_scale((num_elems+block-1)/block),
+        second_scale((num_elems+block-1)/block), p(num_elems),
+        first_moment(num_elems), second_moment(num_elems)
+    {
+        for(Index i = 0; i < num_elems; ++i)
+        {
+            grad[i] = fp32_t(2*i+1) / fp32_t(i+7) - 0.5f;
+            p[i] = fp32_t(i%11) - 3;
+            first_moment[i] = std::int8_t(i%255 - 127);
+            second_moment[i] = fp8_e4m3_t(fp32_t(i%13) * 30);
+        }
+        for(Index b = 0; b < first_scale.size(); ++b)
+        {
+            first_scale[b] = 1e-3f * (b%3+1);
+            second_scale[b] = 1e-4f * (b%5+1);
+        }
+    }
+    // Dequantized moments
+    std::vector<fp32_t> first(Index block) const
+    {
+        std::vector<fp32_t> res(p.size());
+        for(Index i = 0; i < p.size(); ++i)
+        {
+            res[i] = first_scale[i/block] * first_moment[i];
+        }
+        return res;
+    }
+    std::vector<fp32_t> second(Index block) const
+    {
+        std::vector<fp32_t> res(p.size());
+        for(Index i = 0; i < p.size(); ++i)
+        {
+            res[i] = second_scale[i/block] * fp32_t(second_moment[i]);
+        }
+        return res;
+    }
+};
+
+#ifdef NNTILE_USE_CUDA
+template<typename Q>
+Q *to_device(const std::vector<Q> &host)
+{
+    Q *dev;
+    cudaError_t cuda_err = cudaMalloc(&dev, sizeof(Q)*host.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev, host.data(), sizeof(Q)*host.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    return dev;
+}
+
+template<typename Q>
+void to_host(Q *dev, std::vector<Q> &host)
+{
+    cudaError_t cuda_err = cudaMemcpy(host.data(), dev,
+            sizeof(Q)*host.size(), cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+
+void run_cuda(Index num_iter, Index block, fp32_t beta_1, fp32_t beta_2,
+        fp32_t eps, fp32_t lr, fp32_t weight_decay, bool decoupled,
+        State &state)
+{
+    Index num_elems = state.p.size();
+    auto grad = to_device(state.grad);
+    auto first_moment = to_device(state.first_moment);
+    auto first_scale = to_device(state.first_scale);
+    auto second_moment = to_device(state.second_moment);
+    auto second_scale = to_device(state.second_scale);
+    auto p = to_device(state.p);
+    // Init stream
+    cudaStream_t stream;
+    cudaError_t cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda(stream, num_iter, num_elems, block, beta_1, beta_2, eps, lr,
+            weight_decay, decoupled, grad, first_moment, first_scale,
+            second_moment, second_scale, p);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    to_host(grad, state.grad);
+    to_host(first_moment, state.first_moment);
+    to_host(first_scale, state.first_scale);
+    to_host(second_moment, state.second_moment);
+    to_host(second_scale, state.second_scale);
+    to_host(p, state.p);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Compare a state with single precision reference moments and parameters
+void check(const State &state, Index block, const std::vector<fp32_t> &f,
+        const std::vector<fp32_t> &s, const std::vector<fp32_t> &p)
+{
+    constexpr fp32_t eps = 10 * std::numeric_limits<fp32_t>::epsilon();
+    auto f_q = state.first(block), s_q = state.second(block);
+    for(Index i = 0; i < p.size(); ++i)
+    {
+        TEST_ASSERT(std::abs(state.p[i]-p[i]) <= eps*(1+std::abs(p[i])));
+        // Rounding error of int8 is a half of the scale
+        fp32_t f_scale = state.first_scale[i/block];
+        TEST_ASSERT(std::abs(f_q[i]-f[i]) <= 0.5f*f_scale*(1+eps)
+                + eps*std::abs(f[i]));
+        // Relative rounding error of normal FP8 E4M3 is 2^-4, and absolute
+        // error of subnormal values is 2^-10 of the scale
+        fp32_t s_scale = state.second_scale[i/block];
+        TEST_ASSERT(std::abs(s_q[i]-s[i]) <= 0.0625f*std::abs(s[i])
+                + 0x1p-10f*s_scale + eps*std::abs(s[i]));
+    }
+    // Scales correspond to the largest elements of blocks
+    for(Index b = 0; b < state.first_scale.size(); ++b)
+    {
+        fp32_t f_max = 0, s_max = 0;
+        for(Index i = b*block; i < std::min<Index>((b+1)*block, p.size()); ++i)
+        {
+            f_max = std::max(f_max, std::abs(f[i]));
+            s_max = std::max(s_max, s[i]);
+        }
+        TEST_ASSERT(std::abs(state.first_scale[b]*127-f_max) <= eps*f_max);
+        TEST_ASSERT(std::abs(state.second_scale[b]*448-s_max) <= eps*s_max);
+    }
+}
+
+// Validation against single precision kernels with dequantized moments
+void validate(Index num_elems, Index block, Index num_iter,
+        fp32_t weight_decay, bool decoupled)
+{
+    const fp32_t beta_1 = 0.9, beta_2 = 0.999, eps = 1e-8, lr = 1e-2;
+    // Reference is computed without vectorization
+    using kernel::simd::Level;
+    kernel::simd::set_level(Level::NONE);
+    State init(num_elems, block);
+    auto f = init.first(block), s = init.second(block);
+    auto grad = init.grad, p = init.p;
+    if(decoupled)
+    {
+        kernel::adamw_step::cpu<fp32_t>(num_iter, num_elems, beta_1, beta_2,
+                eps, lr, weight_decay, &grad[0], &f[0], &s[0], &p[0]);
+    }
+    else
+    {
+        kernel::adam_step::cpu<fp32_t>(num_iter, num_elems, beta_1, beta_2,
+                eps, lr, weight_decay, &grad[0], &f[0], &s[0], &p[0]);
+    }
+    // Check low-level CPU kernel sequentially and with blocks split among
+    // threads
+    for(int nthreads: {1, 4})
+    {
+        kernel::parallel::Scope threads(nthreads);
+        State state(num_elems, block);
+        std::cout << "Run kernel::quantized_adam_step::cpu with "
+            << nthreads << " threads\n";
+        cpu(num_iter, num_elems, block, beta_1, beta_2, eps, lr,
+                weight_decay, decoupled, &state.grad[0],
+                &state.first_moment[0], &state.first_scale[0],
+                &state.second_moment[0], &state.second_scale[0],
+                &state.p[0]);
+        check(state, block, f, s, p);
+        std::cout << "OK: kernel::quantized_adam_step::cpu\n";
+    }
+    kernel::simd::set_level(Level::AVX512);
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    State state_cuda(num_elems, block);
+    std::cout << "Run kernel::quantized_adam_step::cuda\n";
+    run_cuda(num_iter, block, beta_1, beta_2, eps, lr, weight_decay,
+            decoupled, state_cuda);
+    check(state_cuda, block, f, s, p);
+    std::cout << "OK: kernel::quantized_adam_step::cuda\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    for(Index num_elems: {1, 300, 70001})
+    for(Index block: {64, 256, 4096})
+    for(Index num_iter: {1, 3})
+    {
+        validate(num_elems, block, num_iter, 0, false);
+        validate(num_elems, block, num_iter, 0.1, false);
+        validate(num_elems, block, num_iter, 0.1, true);
+    }
+    return 0;
+}
+
@@ -45,6 +45,42 @@ static inline fp64_t chameleon_randn(unsigned long long &seed, fp64_t mean,
     return stddev*t3 + mean;
 }
 
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index ndim, Index nelems, unsigned long long seed, T mean,
+        T stddev, const Index *start, const Index *shape,
+        const Index *underlying_shape, std::vector<T> &data,
+        const Index *stride)
+{
+    // Allocate device memory
+    T *dev_data;
+    Index *dev_tmp_index;
+    cudaError_t cuda_err = cudaMalloc(&dev_data, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_tmp_index, sizeof(Index)*4*ndim);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, ndim, nelems, seed, mean, stddev, start, shape,
+            underlying_shape, dev_data, stride, dev_tmp_index);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&data[0], dev_data, sizeof(T)*nelems,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_data);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_tmp_index);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
 template<typename T>
 void validate_empty_shape()
 {
@@ -151,6 +187,19 @@ void validate_full(std::array<Index, NDIM> shape)
     // Check if result is different for the first element
     TEST_ASSERT(data[0] != data_ref[0])
     std::cout << "OK: kernel::randn::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // CUDA generates the same sequence up to rounding errors
+    std::cout << "Run kernel::randn::cuda<T>\n";
+    run_cuda<T>(NDIM, nelems, seed, mean, stddev, &start[0], &shape[0],
+            &shape[0], data, &stride[0]);
+    T eps = T{100} * std::numeric_limits<T>::epsilon();
+    for(Index i = 0; i < nelems; ++i)
+    {
+        T diff = std::abs(data[i]-data_ref[i]);
+        TEST_ASSERT(diff <= eps*(T{1}+std::abs(data_ref[i])));
+    }
+    std::cout << "OK: kernel::randn::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
 }
 
 // Check generation of a full contiguous 0-dimensional array
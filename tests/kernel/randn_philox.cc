@@ -0,0 +1,258 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/randn_philox.cc
+ * Randn operation by a counter-based Philox generator
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/randn_philox.hh"
+#include "nntile/kernel/simd.hh"
+#include "../testing.hh"
+#include <array>
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::randn_philox;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T, std::size_t NDIM>
+void run_cuda(Index nelems, unsigned long long seed, T mean, T stddev,
+        const std::array<Index, NDIM> &start,
+        const std::array<Index, NDIM> &shape,
+        const std::array<Index, NDIM> &underlying_shape,
+        std::vector<T> &data, const std::array<Index, NDIM> &stride)
+{
+    // Allocate on device
+    T *dev_data;
+    Index *dev_tmp_index;
+    cudaError_t cuda_err = cudaMalloc(&dev_data, sizeof(T)*data.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_tmp_index, sizeof(Index)*4*NDIM);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, NDIM, nelems, seed, mean, stddev, &start[0], &shape[0],
+            &underlying_shape[0], dev_data, &stride[0], dev_tmp_index);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&data[0], dev_data, sizeof(T)*data.size(),
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_data);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_tmp_index);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check the generator against known answers of the reference implementation
+void validate_philox()
+{
+    uint32_t ctr[4] = {0, 0, 0, 0};
+    philox4x32_10(ctr, 0, 0);
+    TEST_ASSERT(ctr[0] == 0x6627e8d5 and ctr[1] == 0xe169c58d
+            and ctr[2] == 0xbc57ac4c and ctr[3] == 0x9b00dbd8);
+    uint32_t ctr2[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+    philox4x32_10(ctr2, 0xffffffff, 0xffffffff);
+    TEST_ASSERT(ctr2[0] == 0x408f276d and ctr2[1] == 0x41c83b0e
+            and ctr2[2] == 0xa20bc7c6 and ctr2[3] == 0x6d5451fd);
+    uint32_t ctr3[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+    philox4x32_10(ctr3, 0xa4093822, 0x299f31d0);
+    TEST_ASSERT(ctr3[0] == 0xd16cfe09 and ctr3[1] == 0x94fdcceb
+            and ctr3[2] == 0x5001e420 and ctr3[3] == 0x24126ea1);
+}
+
+// Check an element against the scalar generator. Vectorized kernels differ
+// from it by a few ulp, while the scalar kernel is exactly the same.
+template<typename T>
+void check_element(T val, unsigned long long seed, Index offset, T mean,
+        T stddev, kernel::simd::Level level)
+{
+    constexpr T eps = 16 * std::numeric_limits<T>::epsilon();
+    T ref = philox_randn(seed, offset, mean, stddev);
+    if(level == kernel::simd::Level::NONE)
+    {
+        TEST_ASSERT(val == ref);
+    }
+    else
+    {
+        TEST_ASSERT(std::abs(val-ref) <= eps*(std::abs(mean)+stddev
+                    +std::abs(ref)));
+    }
+}
+
+// Check statistics of a long sequence and dependence on parameters
+template<typename T>
+void validate_full(Index nelems, kernel::simd::Level level)
+{
+    unsigned long long seed = 1000;
+    T mean = 1, stddev = 2;
+    Index start = 0, stride = 1, tmp_index;
+    std::vector<T> data(nelems);
+    std::cout << "Run kernel::randn_philox::cpu<T> with SIMD level "
+        << static_cast<int>(level) << "\n";
+    cpu<T>(1, nelems, seed, mean, stddev, &start, &nelems, &nelems,
+            &data[0], &stride, &tmp_index);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        check_element<T>(data[i], seed, i, mean, stddev, level);
+    }
+    std::cout << "OK: kernel::randn_philox::cpu<T>\n";
+    double sum = 0, sum2 = 0;
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(std::isfinite(data[i]));
+        sum += data[i];
+        sum2 += (data[i]-mean) * (data[i]-mean);
+    }
+    // Sample mean and variance are within several standard errors
+    double sample_mean = sum / nelems, sample_var = sum2 / nelems;
+    TEST_ASSERT(std::abs(sample_mean-mean) < 5*stddev/std::sqrt(nelems));
+    TEST_ASSERT(std::abs(sample_var-stddev*stddev)
+            < 5*std::sqrt(2.0/nelems)*stddev*stddev);
+    // Different seed generates a different sequence
+    T data0 = philox_randn(seed+1, 0, mean, stddev);
+    TEST_ASSERT(data0 != data[0]);
+    // Scalar output is the first element of the sequence
+    T scalar;
+    cpu<T>(0, 1, seed, mean, stddev, nullptr, nullptr, nullptr, &scalar,
+            nullptr, nullptr);
+    TEST_ASSERT(scalar == data[0]);
+}
+
+// Check partial generation, where parameters start, shape and stride are
+// actually checked
+template<typename T, std::size_t NDIM>
+void validate_part(std::array<Index, NDIM> underlying_shape,
+        std::array<Index, NDIM> start, std::array<Index, NDIM> shape,
+        kernel::simd::Level level)
+{
+    // Set default values for tests
+    T mean = 0, stddev = 1;
+    unsigned long long seed = -1;
+    // Entire underlying array as a contiguous vector
+    Index underlying_nelems = 1;
+    for(Index i = 0; i < NDIM; ++i)
+    {
+        underlying_nelems *= underlying_shape[i];
+    }
+    std::vector<T> underlying(underlying_nelems);
+    Index zero = 0, one = 1, tmp;
+    cpu<T>(1, underlying_nelems, seed, mean, stddev, &zero,
+            &underlying_nelems, &underlying_nelems, &underlying[0], &one,
+            &tmp);
+    // Init strides
+    std::array<Index, NDIM> stride, tmp_index;
+    stride[0] = 2;
+    Index nelems = shape[0];
+    Index size = (shape[0]-1)*stride[0] + 1;
+    for(Index i = 1; i < NDIM; ++i)
+    {
+        stride[i] = stride[i-1]*shape[i-1] + 1; // Stride is larger than needed
+        nelems *= shape[i];
+        size += (shape[i]-1) * stride[i];
+    }
+    // Run kernel
+    std::vector<T> data(size);
+    std::cout << "Run kernel::randn_philox::cpu<T> with SIMD level "
+        << static_cast<int>(level) << "\n";
+    cpu<T>(NDIM, nelems, seed, mean, stddev, &start[0], &shape[0],
+            &underlying_shape[0], &data[0], &stride[0], &tmp_index[0]);
+    // Check if the result is the same as the reference one
+    std::vector<Index> offsets(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        // Get index of the current element within output array
+        Index offset = i;
+        std::array<Index, NDIM> index;
+        for(Index j = 0; j < NDIM; ++j)
+        {
+            index[j] = offset % shape[j];
+            offset /= shape[j];
+        }
+        // Convert underlying index to underlying memory offset
+        Index underlying_offset = index[NDIM-1] + start[NDIM-1];
+        for(Index j = NDIM-2; j >= 0; --j)
+        {
+            underlying_offset = index[j] + start[j]
+                + underlying_offset*underlying_shape[j];
+        }
+        // Convert index to memory offset
+        offset = 0;
+        for(Index j = 0; j < NDIM; ++j)
+        {
+            offset += stride[j] * index[j];
+        }
+        offsets[i] = offset;
+        // Compare results, that shall not depend on a generated subarray
+        check_element<T>(data[offset], seed, underlying_offset, mean, stddev,
+                level);
+        TEST_ASSERT(data[offset] == underlying[underlying_offset]);
+    }
+    std::cout << "OK: kernel::randn_philox::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // CUDA kernel relies on the same generator, but it is compiled by a
+    // different compiler with its own math functions
+    constexpr T eps = 100 * std::numeric_limits<T>::epsilon();
+    std::vector<T> data_cuda(size);
+    std::cout << "Run kernel::randn_philox::cuda<T>\n";
+    run_cuda<T, NDIM>(nelems, seed, mean, stddev, start, shape,
+            underlying_shape, data_cuda, stride);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        T ref = data[offsets[i]];
+        TEST_ASSERT(std::abs(data_cuda[offsets[i]]-ref)
+                <= eps*(1+std::abs(ref)));
+    }
+    std::cout << "OK: kernel::randn_philox::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+// Run multiple tests for a given precision with all the supported
+// instruction sets
+template<typename T>
+void validate_many()
+{
+    using kernel::simd::Level;
+    for(Level level: {Level::NONE, Level::AVX2, Level::AVX512})
+    {
+        if(kernel::simd::set_level(level) != level)
+        {
+            continue;
+        }
+        validate_full<T>(100000, level);
+        validate_part<T, 1>({1}, {0}, {1}, level);
+        validate_part<T, 2>({2, 3}, {0, 0}, {1, 1}, level);
+        validate_part<T, 2>({2, 3}, {1, 2}, {1, 1}, level);
+        validate_part<T, 4>({3, 4, 5, 6}, {0, 0, 0, 0}, {2, 4, 2, 3}, level);
+        validate_part<T, 4>({3, 4, 5, 6}, {1, 2, 1, 3}, {2, 2, 3, 3}, level);
+        validate_part<T, 2>({1000, 1000}, {450, 450}, {450, 450}, level);
+        validate_part<T, 2>({1000, 1000}, {3, 7}, {37, 5}, level);
+    }
+    kernel::simd::set_level(Level::AVX512);
+}
+
+int main(int argc, char **argv)
+{
+    validate_philox();
+    validate_many<fp32_t>();
+    validate_many<fp64_t>();
+    return 0;
+}
@@ -0,0 +1,173 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/rms_norm.cc
+ * Root mean square layer normalization
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/rms_norm.hh"
+#include "nntile/kernel/simd.hh"
+#include "nntile/kernel/parallel.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::rms_norm;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, Index k, T eps, const std::vector<T> &src,
+        const std::vector<T> &gamma, std::vector<T> &inv_rms,
+        std::vector<T> &dst)
+{
+    // Copy to device
+    T *dev_src, *dev_gamma, *dev_inv_rms, *dev_dst;
+    cudaError_t cuda_err = cudaMalloc(&dev_src, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_gamma, sizeof(T)*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_inv_rms, sizeof(T)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*m*n*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_gamma, &gamma[0], sizeof(T)*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, m, n, k, eps, dev_src, dev_gamma, dev_inv_rms, dev_dst);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&inv_rms[0], dev_inv_rms, sizeof(T)*m*n,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(T)*m*n*k,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_gamma);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_inv_rms);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check result against the reference, rounding errors grow with k
+template<typename T>
+void check(Index k, const std::vector<T> &val, const std::vector<double> &ref)
+{
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    const double tol = 10 * eps * (k+10);
+    for(Index i = 0; i < val.size(); ++i)
+    {
+        TEST_ASSERT(std::abs(val[i]-ref[i]) <= tol*(1+std::abs(ref[i])));
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k)
+{
+    const T eps = 1e-5;
+    // Init test input
+    std::vector<T> src(m*n*k), gamma(k);
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        src[i] = T(i%13)/T(7) - T((i/7)%5);
+    }
+    for(Index i = 0; i < k; ++i)
+    {
+        gamma[i] = T(1) + T(i%3)/T(2);
+    }
+    // Get reference result by definition in double precision
+    std::vector<double> inv_rms_ref(m*n), dst_ref(m*n*k);
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            double ssq = 0;
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                double val = src[(i2*k+i1)*m+i0];
+                ssq += val * val;
+            }
+            double inv = 1.0 / std::sqrt(ssq/k+eps);
+            inv_rms_ref[i2*m+i0] = inv;
+            for(Index i1 = 0; i1 < k; ++i1)
+            {
+                dst_ref[(i2*k+i1)*m+i0] = src[(i2*k+i1)*m+i0] * inv
+                    * gamma[i1];
+            }
+        }
+    }
+    // Check low-level CPU kernel with all the supported instruction sets,
+    // sequentially and with slices split among threads
+    using kernel::simd::Level;
+    for(Level level: {Level::NONE, Level::AVX2, Level::AVX512})
+    for(int nthreads: {1, 4})
+    {
+        if(kernel::simd::set_level(level) != level)
+        {
+            continue;
+        }
+        kernel::parallel::Scope threads(nthreads);
+        std::vector<T> inv_rms(m*n), dst(m*n*k);
+        std::cout << "Run kernel::rms_norm::cpu<T> with SIMD level "
+            << static_cast<int>(level) << " and " << nthreads
+            << " threads\n";
+        cpu<T>(m, n, k, eps, &src[0], &gamma[0], &inv_rms[0], &dst[0]);
+        check(k, inv_rms, inv_rms_ref);
+        check(k, dst, dst_ref);
+        std::cout << "OK: kernel::rms_norm::cpu<T>\n";
+    }
+    kernel::simd::set_level(Level::AVX512);
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> inv_rms_cuda(m*n), dst_cuda(m*n*k);
+    std::cout << "Run kernel::rms_norm::cuda<T>\n";
+    run_cuda<T>(m, n, k, eps, src, gamma, inv_rms_cuda, dst_cuda);
+    check(k, inv_rms_cuda, inv_rms_ref);
+    check(k, dst_cuda, dst_ref);
+    std::cout << "OK: kernel::rms_norm::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    // Single-element fibers, a block per fiber and a thread per fiber on
+    // CUDA, vectors along the middle and the first mode with remainders
+    validate<fp32_t>(1, 3, 1);
+    validate<fp32_t>(1, 9, 700);
+    validate<fp32_t>(3, 5, 20);
+    validate<fp32_t>(40, 3, 50);
+    validate<fp32_t>(5, 2000, 20);
+    validate<fp64_t>(1, 3, 1);
+    validate<fp64_t>(1, 9, 700);
+    validate<fp64_t>(3, 5, 20);
+    validate<fp64_t>(40, 3, 50);
+    return 0;
+}
+
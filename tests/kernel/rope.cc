@@ -0,0 +1,156 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/rope.cc
+ * Rotary position embedding
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/rope.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::rope;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, Index k, Index head_size, Index offset_m,
+        Index offset_n, T base, bool inverse, std::vector<T> &data)
+{
+    // Copy to device
+    T *dev_data;
+    cudaError_t cuda_err = cudaMalloc(&dev_data, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_data, &data[0], sizeof(T)*m*n*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, m, n, k, head_size, offset_m, offset_n, base, inverse,
+            dev_data);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&data[0], dev_data, sizeof(T)*m*n*k,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_data);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+template<typename T>
+void validate(Index head_size, Index n, Index k, Index position)
+{
+    // Angles are up to position+n, values are up to 6 by absolute value
+    const T eps = 20 * std::numeric_limits<T>::epsilon() * (1+position+n)
+        * 6;
+    const T base = 10000;
+    // Init data
+    Index m = head_size, nelems = m * n * k;
+    std::vector<T> data(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        data[i] = T(i % 13) - T(6);
+    }
+    // Reference rotation of pairs as complex numbers
+    std::vector<T> ref(data);
+    for(Index l = 0; l < k; ++l)
+    {
+        for(Index j = 0; j < n; ++j)
+        {
+            for(Index p = 0; p < m/2; ++p)
+            {
+                double angle = (position+j) * std::pow(double(base),
+                        -2.0*p/head_size);
+                Index i = 2*p + j*m + l*m*n;
+                double x0 = data[i], x1 = data[i+1];
+                ref[i] = std::cos(angle)*x0 - std::sin(angle)*x1;
+                ref[i+1] = std::sin(angle)*x0 + std::cos(angle)*x1;
+            }
+        }
+    }
+    // Check the whole array on CPU
+    std::vector<T> res(data);
+    std::cout << "Run kernel::rope::cpu<T>\n";
+    cpu<T>(m, n, k, head_size, 0, position, base, false, &res[0]);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(std::abs(res[i]-ref[i]) <= eps);
+    }
+    // Inverse rotation restores the input
+    cpu<T>(m, n, k, head_size, 0, position, base, true, &res[0]);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(std::abs(res[i]-data[i]) <= eps);
+    }
+    // Window of the first axis and of positions, as in a tile of a tensor
+    Index wm = m / 2 - (m/2) % 2, wn = n / 2 + 1, offm = m - wm,
+          offn = n - wn;
+    std::vector<T> window(wm*wn*k);
+    for(Index l = 0; l < k; ++l)
+    {
+        for(Index j = 0; j < wn; ++j)
+        {
+            for(Index i = 0; i < wm; ++i)
+            {
+                window[i+j*wm+l*wm*wn] = data[offm+i+(offn+j)*m+l*m*n];
+            }
+        }
+    }
+    cpu<T>(wm, wn, k, head_size, offm, position+offn, base, false,
+            &window[0]);
+    for(Index l = 0; l < k; ++l)
+    {
+        for(Index j = 0; j < wn; ++j)
+        {
+            for(Index i = 0; i < wm; ++i)
+            {
+                T val = ref[offm+i+(offn+j)*m+l*m*n];
+                TEST_ASSERT(std::abs(window[i+j*wm+l*wm*wn]-val) <= eps);
+            }
+        }
+    }
+    std::cout << "OK: kernel::rope::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    std::vector<T> res_cuda(data);
+    std::cout << "Run kernel::rope::cuda<T>\n";
+    run_cuda<T>(m, n, k, head_size, 0, position, base, false, res_cuda);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(std::abs(res_cuda[i]-ref[i]) <= eps);
+    }
+    run_cuda<T>(m, n, k, head_size, 0, position, base, true, res_cuda);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(std::abs(res_cuda[i]-data[i]) <= eps);
+    }
+    std::cout << "OK: kernel::rope::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(8, 5, 3, 0);
+    validate<fp32_t>(64, 33, 2, 1000);
+    validate<fp64_t>(8, 5, 3, 0);
+    validate<fp64_t>(128, 17, 4, 123);
+    return 0;
+}
+
@@ -0,0 +1,206 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/sgd_step.cc
+ * Fused SGD step with momentum
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/sgd_step.hh"
+#include "nntile/kernel/simd.hh"
+#include "nntile/kernel/parallel.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::sgd_step;
+
+// Buffers of a parameter
+template<typename T>
+struct State
+{
+    std::vector<T> grad, velocity, p;
+    explicit State(Index num_elems):
+        grad(num_elems), velocity(num_elems), p(num_elems)
+    {
+        for(Index i = 0; i < num_elems; ++i)
+        {
+            grad[i] = T(2*i+1) / T(i+7) - T(0.5);
+            velocity[i] = T(0.01) * T(i%7);
+            p[i] = T(i%11) - T(3);
+        }
+    }
+};
+
+// Reference step, composed of separate operations as in optimizer.SGD
+template<typename T>
+void reference(Index num_iter, T momentum, T dampening, T lr, T weight_decay,
+        bool nesterov, State<T> &state)
+{
+    for(Index i = 0; i < state.p.size(); ++i)
+    {
+        T g = state.grad[i] + weight_decay*state.p[i];
+        if(momentum != T(0))
+        {
+            if(num_iter == 1)
+            {
+                state.velocity[i] = g;
+            }
+            else
+            {
+                state.velocity[i] = momentum*state.velocity[i]
+                    + (1-dampening)*g;
+            }
+            if(nesterov)
+            {
+                g = g + momentum*state.velocity[i];
+            }
+            else
+            {
+                g = state.velocity[i];
+            }
+        }
+        state.p[i] = state.p[i] - lr*g;
+    }
+}
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index num_iter, T momentum, T dampening, T lr, T weight_decay,
+        bool nesterov, State<T> &state)
+{
+    Index num_elems = state.p.size();
+    std::vector<T> *host[3] = {&state.grad, &state.velocity, &state.p};
+    T *dev[3];
+    cudaError_t cuda_err;
+    for(int k = 0; k < 3; ++k)
+    {
+        cuda_err = cudaMalloc(&dev[k], sizeof(T)*num_elems);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+        cuda_err = cudaMemcpy(dev[k], host[k]->data(), sizeof(T)*num_elems,
+                cudaMemcpyHostToDevice);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+    }
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, num_iter, num_elems, momentum, dampening, lr,
+            weight_decay, nesterov, dev[0], dev[1], dev[2]);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    for(int k = 0; k < 3; ++k)
+    {
+        cuda_err = cudaMemcpy(host[k]->data(), dev[k], sizeof(T)*num_elems,
+                cudaMemcpyDeviceToHost);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+        cuda_err = cudaFree(dev[k]);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+    }
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Compare buffers of two states
+template<typename T>
+void check(const State<T> &state, const State<T> &ref, T momentum)
+{
+    constexpr T eps = 10 * std::numeric_limits<T>::epsilon();
+    for(Index i = 0; i < ref.p.size(); ++i)
+    {
+        TEST_ASSERT(state.grad[i] == ref.grad[i]);
+        TEST_ASSERT(std::abs(state.p[i]-ref.p[i])
+                <= eps*(1+std::abs(ref.p[i])));
+        // Velocity is not touched without momentum
+        if(momentum == T(0))
+        {
+            TEST_ASSERT(state.velocity[i] == ref.velocity[i]);
+        }
+        else
+        {
+            TEST_ASSERT(std::abs(state.velocity[i]-ref.velocity[i])
+                    <= eps*(1+std::abs(ref.velocity[i])));
+        }
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index num_elems, Index num_iter, T momentum, T weight_decay,
+        bool nesterov)
+{
+    const T dampening = 0.1, lr = 1e-2;
+    State<T> ref(num_elems);
+    reference<T>(num_iter, momentum, dampening, lr, weight_decay, nesterov,
+            ref);
+    // Check low-level CPU kernel with all the supported instruction sets,
+    // sequentially and with buffers split among threads
+    using kernel::simd::Level;
+    for(Level level: {Level::NONE, Level::AVX2, Level::AVX512})
+    for(int nthreads: {1, 4})
+    {
+        if(kernel::simd::set_level(level) != level)
+        {
+            continue;
+        }
+        kernel::parallel::Scope threads(nthreads);
+        State<T> state(num_elems);
+        std::cout << "Run kernel::sgd_step::cpu<T> with SIMD level "
+            << static_cast<int>(level) << " and " << nthreads
+            << " threads\n";
+        cpu<T>(num_iter, num_elems, momentum, dampening, lr, weight_decay,
+                nesterov, &state.grad[0], &state.velocity[0], &state.p[0]);
+        check(state, ref, momentum);
+        std::cout << "OK: kernel::sgd_step::cpu<T>\n";
+    }
+    kernel::simd::set_level(Level::AVX512);
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    State<T> state_cuda(num_elems);
+    std::cout << "Run kernel::sgd_step::cuda<T>\n";
+    run_cuda<T>(num_iter, momentum, dampening, lr, weight_decay, nesterov,
+            state_cuda);
+    check(state_cuda, ref, momentum);
+    std::cout << "OK: kernel::sgd_step::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+// Check plain, heavy-ball and Nesterov momentum on the first and on a later
+// iteration
+template<typename T>
+void validate_all(Index num_elems)
+{
+    for(Index num_iter: {1, 3})
+    for(T weight_decay: {T(0), T(0.1)})
+    {
+        validate<T>(num_elems, num_iter, 0, weight_decay, false);
+        validate<T>(num_elems, num_iter, 0.9, weight_decay, false);
+        validate<T>(num_elems, num_iter, 0.9, weight_decay, true);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    validate_all<fp32_t>(1);
+    validate_all<fp32_t>(300);
+    // Buffers, that are large enough to be split among threads
+    validate_all<fp32_t>(70001);
+    validate_all<fp64_t>(1);
+    validate_all<fp64_t>(300);
+    validate_all<fp64_t>(70001);
+    return 0;
+}
+
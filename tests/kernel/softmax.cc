@@ -12,12 +12,186 @@
  * @date 2023-07-02
  * */
 
+#include "nntile/kernel/softmax.hh"
+#include "nntile/kernel/simd.hh"
+#include "nntile/kernel/parallel.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
 #include <iostream>
 
+using namespace nntile;
+using namespace nntile::kernel::softmax;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, Index k, const std::vector<T> &maxsumexp,
+        const std::vector<T> &src, T alpha, std::vector<T> &dst)
+{
+    // Copy to device
+    T *dev_maxsumexp, *dev_src, *dev_dst;
+    cudaError_t cuda_err = cudaMalloc(&dev_maxsumexp, sizeof(T)*2*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_src, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_maxsumexp, &maxsumexp[0], sizeof(T)*2*m*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*m*n*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, m, n, k, dev_maxsumexp, dev_src, alpha, dev_dst);
+    // Wait for result and destroy stream
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(T)*m*n*k,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_maxsumexp);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check output against the exact softmax of test input
+template<typename T>
+void check(Index m, Index n, Index k, T alpha, const std::vector<T> &dst)
+{
+    constexpr T epsilon = std::numeric_limits<T>::epsilon();
+    for(Index i0 = 0; i0 < m; ++i0)
+    {
+        for(Index i1 = 0; i1 < n; ++i1)
+        {
+            for(Index i2 = 0; i2 < k; ++i2)
+            {
+                T val = dst[(i1*k+i2)*m+i0];
+                T val_ref = alpha * std::exp(T(i2-k+1) / T{100}) * T{100}
+                    / T(i0+i1+1);
+                T tmp = std::abs(val - val_ref);
+                TEST_ASSERT(tmp/val_ref < 100*epsilon);
+            }
+        }
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k)
+{
+    constexpr T epsilon = std::numeric_limits<T>::epsilon();
+    constexpr T alpha = 0.5;
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    // Init test input
+    std::vector<T> maxsumexp(2*m*n), src(m*n*k);
+    for(Index i0 = 0; i0 < m; ++i0)
+    {
+        for(Index i1 = 0; i1 < n; ++i1)
+        {
+            for(Index i2 = 0; i2 < k; ++i2)
+            {
+                src[(i1*k+i2)*m+i0] = T(i0+i1+i2) / T{100};
+            }
+        }
+    }
+    for(Index i0 = 0; i0 < m; ++i0)
+    {
+        for(Index i1 = 0; i1 < n; ++i1)
+        {
+            T max = T(i0+i1+k-1) / T{100};
+            maxsumexp[2*(i1*m+i0)] = max;
+            maxsumexp[2*(i1*m+i0)+1] = T(i0+i1+1) / T{100};
+        }
+    }
+    // Masked out values are zeroed
+    std::vector<T> src_mask(src);
+    for(Index i = 0; i < m*n*k; i += 3)
+    {
+        src_mask[i] = -inf;
+    }
+    // Result without vectorization
+    using kernel::simd::Level;
+    kernel::simd::set_level(Level::NONE);
+    std::vector<T> dst_scalar(m*n*k);
+    cpu<T>(m, n, k, &maxsumexp[0], &src[0], alpha, &dst_scalar[0]);
+    // Check low-level kernel with all the supported instruction sets,
+    // sequentially and with slices split among threads
+    for(Level level: {Level::NONE, Level::AVX2, Level::AVX512})
+    for(int nthreads: {1, 4})
+    {
+        if(kernel::simd::set_level(level) != level)
+        {
+            continue;
+        }
+        kernel::parallel::Scope threads(nthreads);
+        std::vector<T> dst(m*n*k);
+        std::cout << "Run kernel::softmax::cpu<T> with SIMD level "
+            << static_cast<int>(level) << " and " << nthreads
+            << " threads\n";
+        cpu<T>(m, n, k, &maxsumexp[0], &src[0], alpha, &dst[0]);
+        check<T>(m, n, k, alpha, dst);
+        // Vectorized result is close to the scalar one
+        for(Index i = 0; i < m*n*k; ++i)
+        {
+            TEST_ASSERT(std::abs(dst[i]-dst_scalar[i])
+                    <= 10*epsilon*std::abs(dst_scalar[i]));
+        }
+        std::vector<T> dst_mask(m*n*k);
+        cpu<T>(m, n, k, &maxsumexp[0], &src_mask[0], alpha, &dst_mask[0]);
+        for(Index i = 0; i < m*n*k; ++i)
+        {
+            if(i % 3 == 0)
+            {
+                TEST_ASSERT(dst_mask[i] == T{0});
+            }
+            else
+            {
+                TEST_ASSERT(dst_mask[i] == dst[i]);
+            }
+        }
+        std::cout << "OK: kernel::softmax::cpu<T>\n";
+    }
+    kernel::simd::set_level(Level::AVX512);
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> dst_cuda(m*n*k);
+    std::cout << "Run kernel::softmax::cuda<T>\n";
+    run_cuda<T>(m, n, k, maxsumexp, src, alpha, dst_cuda);
+    check<T>(m, n, k, alpha, dst_cuda);
+    std::cout << "OK: kernel::softmax::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
 int main(int argc, char **argv)
 {
-    // Not implemented
-    std::cout << "This test is not yet implemented\n";
-    return -1;
+    validate<fp32_t>(1, 9, 11);
+    validate<fp32_t>(8, 1, 11);
+    validate<fp32_t>(8, 9, 1);
+    validate<fp32_t>(19, 5, 3);
+    validate<fp32_t>(1, 450, 450);
+    validate<fp32_t>(450, 1, 450);
+    validate<fp32_t>(450, 450, 1);
+    validate<fp64_t>(1, 9, 11);
+    validate<fp64_t>(8, 1, 11);
+    validate<fp64_t>(8, 9, 1);
+    validate<fp64_t>(19, 5, 3);
+    validate<fp64_t>(1, 450, 450);
+    validate<fp64_t>(450, 1, 450);
+    validate<fp64_t>(450, 450, 1);
+    return 0;
 }
 
@@ -0,0 +1,188 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/softmax_crossentropy.cc
+ * Fused loss and gradient of softmax cross-entropy on a buffer
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-14
+ * */
+
+#include "nntile/kernel/softmax_crossentropy.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::softmax_crossentropy;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index n_labels, Index n_outputs, Index label_start, T scale,
+        const std::vector<T> &maxsumexp, const std::vector<T> &src,
+        const std::vector<Index> &labels, std::vector<T> &dst, T &val)
+{
+    // Allocate on device
+    T *dev_maxsumexp, *dev_src, *dev_dst, *dev_val;
+    Index *dev_labels;
+    Index nelems = n_labels * n_outputs;
+    cudaError_t cuda_err = cudaMalloc(&dev_maxsumexp, sizeof(T)*2*n_outputs);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_src, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_val, sizeof(T));
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_labels, sizeof(Index)*n_outputs);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy to device
+    cuda_err = cudaMemcpy(dev_maxsumexp, &maxsumexp[0], sizeof(T)*2*n_outputs,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_val, &val, sizeof(T), cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_labels, &labels[0], sizeof(Index)*n_outputs,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, n_labels, n_outputs, label_start, scale, dev_maxsumexp,
+            dev_src, dev_labels, dev_dst, dev_val);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(T)*nelems,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&val, dev_val, sizeof(T), cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_maxsumexp);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_val);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_labels);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Templated validation
+template<typename T>
+void validate(Index n_labels, Index n_outputs, Index n_chunks)
+{
+    T scale = 0.5;
+    constexpr T eps = 10 * std::numeric_limits<T>::epsilon();
+    // Init test input with a masked out logit
+    Index nelems = n_labels * n_outputs;
+    std::vector<T> src(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        src[i] = T(std::sin(T(i)));
+    }
+    src[1] = -std::numeric_limits<T>::infinity();
+    std::vector<Index> labels(n_outputs);
+    for(Index i = 0; i < n_outputs; ++i)
+    {
+        labels[i] = (3*i+2) % n_labels;
+    }
+    // Reference loss and gradient and maximums and sums of exponents
+    std::vector<T> maxsumexp(2*n_outputs), dst_ref(nelems);
+    T val_ref = 0;
+    for(Index i = 0; i < n_outputs; ++i)
+    {
+        T max = -std::numeric_limits<T>::infinity(), sum = 0;
+        for(Index j = 0; j < n_labels; ++j)
+        {
+            max = std::max(max, src[i*n_labels+j]);
+        }
+        for(Index j = 0; j < n_labels; ++j)
+        {
+            sum += std::exp(src[i*n_labels+j]-max);
+        }
+        maxsumexp[2*i] = max;
+        maxsumexp[2*i+1] = sum;
+        for(Index j = 0; j < n_labels; ++j)
+        {
+            dst_ref[i*n_labels+j] = scale * std::exp(src[i*n_labels+j]-max)
+                / sum;
+        }
+        dst_ref[i*n_labels+labels[i]] -= scale;
+        val_ref += scale * (max+std::log(sum)-src[i*n_labels+labels[i]]);
+    }
+    // Chunks of labels are processed independently
+    Index chunk = (n_labels+n_chunks-1) / n_chunks;
+    std::cout << "Run kernel::softmax_crossentropy::cpu<T>\n";
+    std::vector<T> dst(nelems);
+    T val = 0;
+    for(Index start = 0; start < n_labels; start += chunk)
+    {
+        Index size = std::min(chunk, n_labels-start);
+        std::vector<T> src_chunk(size*n_outputs), dst_chunk(size*n_outputs);
+        for(Index i = 0; i < n_outputs; ++i)
+        {
+            for(Index j = 0; j < size; ++j)
+            {
+                src_chunk[i*size+j] = src[i*n_labels+start+j];
+            }
+        }
+        cpu<T>(size, n_outputs, start, scale, &maxsumexp[0], &src_chunk[0],
+                &labels[0], &dst_chunk[0], &val);
+        for(Index i = 0; i < n_outputs; ++i)
+        {
+            for(Index j = 0; j < size; ++j)
+            {
+                dst[i*n_labels+start+j] = dst_chunk[i*size+j];
+            }
+        }
+    }
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(std::abs(dst[i]-dst_ref[i]) <= eps);
+    }
+    TEST_ASSERT(std::abs(val-val_ref) <= eps*std::abs(val_ref));
+    std::cout << "OK: kernel::softmax_crossentropy::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel on the whole buffer
+    std::cout << "Run kernel::softmax_crossentropy::cuda<T>\n";
+    T val_cuda = 0;
+    run_cuda<T>(n_labels, n_outputs, 0, scale, maxsumexp, src, labels, dst,
+            val_cuda);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(std::abs(dst[i]-dst_ref[i]) <= eps);
+    }
+    TEST_ASSERT(std::abs(val_cuda-val_ref) <= eps*std::abs(val_ref));
+    std::cout << "OK: kernel::softmax_crossentropy::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(10, 1, 1);
+    validate<fp32_t>(100, 30, 3);
+    validate<fp32_t>(1000, 20, 7);
+    validate<fp64_t>(10, 1, 1);
+    validate<fp64_t>(100, 30, 3);
+    validate<fp64_t>(1000, 20, 7);
+    return 0;
+}
+
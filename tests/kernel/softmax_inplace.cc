@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/softmax_inplace.hh"
+#include "nntile/kernel/simd.hh"
 #include "../testing.hh"
 #include <vector>
 #include <stdexcept>
@@ -91,23 +92,55 @@ void validate(Index m, Index n, Index k)
         }
     }
     std::vector<T> dst_save(dst);
-    // Check low-level kernel
-    std::cout << "Run kernel::softmax_inplace::cpu<T>\n";
-    cpu<T>(m, n, k, &maxsumexp[0], alpha, &dst[0]);
-    for(Index i0 = 0; i0 < m; ++i0)
+    // Check low-level kernel with all the supported instruction sets
+    using kernel::simd::Level;
+    for(Level level: {Level::NONE, Level::AVX2, Level::AVX512})
     {
-        for(Index i1 = 0; i1 < n; ++i1)
+        if(kernel::simd::set_level(level) != level)
         {
-            for(Index i2 = 0; i2 < k; ++i2)
+            continue;
+        }
+        dst = dst_save;
+        std::cout << "Run kernel::softmax_inplace::cpu<T> with SIMD level "
+            << static_cast<int>(level) << "\n";
+        cpu<T>(m, n, k, &maxsumexp[0], alpha, &dst[0]);
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            for(Index i1 = 0; i1 < n; ++i1)
             {
-                T val = dst[(i1*k+i2)*m+i0];
-                T val_ref = std::exp(T(i2-k+1) / T{100}) * T{100} / T(i0+i1+1);
-                T tmp = std::abs(val - val_ref);
-                TEST_ASSERT(tmp/val_ref < 100*epsilon);
+                for(Index i2 = 0; i2 < k; ++i2)
+                {
+                    T val = dst[(i1*k+i2)*m+i0];
+                    T val_ref = std::exp(T(i2-k+1) / T{100}) * T{100}
+                        / T(i0+i1+1);
+                    T tmp = std::abs(val - val_ref);
+                    TEST_ASSERT(tmp/val_ref < 100*epsilon);
+                }
             }
         }
+        // Masked out values are zeroed
+        std::vector<T> dst_mask(dst_save);
+        constexpr T inf = std::numeric_limits<T>::infinity();
+        for(Index i = 0; i < m*n*k; i += 3)
+        {
+            dst_mask[i] = -inf;
+        }
+        cpu<T>(m, n, k, &maxsumexp[0], alpha, &dst_mask[0]);
+        for(Index i = 0; i < m*n*k; ++i)
+        {
+            if(i % 3 == 0)
+            {
+                TEST_ASSERT(dst_mask[i] == T{0});
+            }
+            else
+            {
+                TEST_ASSERT(dst_mask[i] == dst[i]);
+            }
+        }
+        std::cout << "OK: kernel::softmax_inplace::cpu<T>\n";
     }
-    std::cout << "OK: kernel::softmax_inplace::cpu<T>\n";
+    kernel::simd::set_level(Level::AVX512);
+    dst = dst_save;
 #ifdef NNTILE_USE_CUDA
     // Check low-level CUDA kernel
     dst = dst_save;
@@ -0,0 +1,170 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/softmax_online.cc
+ * Online softmax along the middle axis of several buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/softmax_online.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::softmax_online;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, const std::vector<Index> &k, T alpha,
+        std::vector<std::vector<T>> &dst)
+{
+    Index ntiles = k.size();
+    std::vector<T *> dev_dst(ntiles);
+    cudaError_t cuda_err;
+    // Copy to device
+    for(Index j = 0; j < ntiles; ++j)
+    {
+        cuda_err = cudaMalloc(&dev_dst[j], sizeof(T)*dst[j].size());
+        TEST_ASSERT(cuda_err == cudaSuccess);
+        cuda_err = cudaMemcpy(dev_dst[j], &dst[j][0],
+                sizeof(T)*dst[j].size(), cudaMemcpyHostToDevice);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+    }
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, m, n, ntiles, &k[0], alpha, &dev_dst[0]);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    for(Index j = 0; j < ntiles; ++j)
+    {
+        cuda_err = cudaMemcpy(&dst[j][0], dev_dst[j],
+                sizeof(T)*dst[j].size(), cudaMemcpyDeviceToHost);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+        cuda_err = cudaFree(dev_dst[j]);
+        TEST_ASSERT(cuda_err == cudaSuccess);
+    }
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check result against explicitly computed softmax
+template<typename T>
+void check(Index m, Index n, const std::vector<Index> &k, T alpha,
+        const std::vector<std::vector<T>> &src,
+        const std::vector<std::vector<T>> &dst)
+{
+    constexpr T eps = T(100) * std::numeric_limits<T>::epsilon();
+    Index ntiles = k.size();
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            T max = -std::numeric_limits<T>::infinity(), sum = 0;
+            for(Index j = 0; j < ntiles; ++j)
+            {
+                for(Index i1 = 0; i1 < k[j]; ++i1)
+                {
+                    max = std::max(max, src[j][(i2*k[j]+i1)*m+i0]);
+                }
+            }
+            for(Index j = 0; j < ntiles; ++j)
+            {
+                for(Index i1 = 0; i1 < k[j]; ++i1)
+                {
+                    T val = src[j][(i2*k[j]+i1)*m+i0];
+                    if(not std::isinf(val))
+                    {
+                        sum += std::exp(val-max);
+                    }
+                }
+            }
+            for(Index j = 0; j < ntiles; ++j)
+            {
+                for(Index i1 = 0; i1 < k[j]; ++i1)
+                {
+                    Index i = (i2*k[j]+i1)*m + i0;
+                    T val = src[j][i], ref = 0;
+                    if(not std::isinf(val))
+                    {
+                        ref = alpha * std::exp(val-max) / sum;
+                    }
+                    TEST_ASSERT(std::abs(dst[j][i]-ref) <= eps*std::abs(ref)
+                            + std::numeric_limits<T>::min());
+                }
+            }
+        }
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, const std::vector<Index> &k)
+{
+    Index ntiles = k.size();
+    T alpha = 0.5;
+    // Init test input, some values are masked out
+    std::vector<std::vector<T>> src(ntiles);
+    for(Index j = 0; j < ntiles; ++j)
+    {
+        src[j].resize(m*k[j]*n);
+        for(Index i = 0; i < m*k[j]*n; ++i)
+        {
+            if((i+j) % 7 == 3)
+            {
+                src[j][i] = -std::numeric_limits<T>::infinity();
+            }
+            else
+            {
+                src[j][i] = T((5*i+3*j) % 23) / T{4} - T{2};
+            }
+        }
+    }
+    // Check low-level kernel
+    std::vector<std::vector<T>> dst(src);
+    std::vector<T *> dst_ptr(ntiles);
+    for(Index j = 0; j < ntiles; ++j)
+    {
+        dst_ptr[j] = &dst[j][0];
+    }
+    std::cout << "Run kernel::softmax_online::cpu<T>\n";
+    cpu<T>(m, n, ntiles, &k[0], alpha, &dst_ptr[0]);
+    check<T>(m, n, k, alpha, src, dst);
+    std::cout << "OK: kernel::softmax_online::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<std::vector<T>> dst_cuda(src);
+    std::cout << "Run kernel::softmax_online::cuda<T>\n";
+    run_cuda<T>(m, n, k, alpha, dst_cuda);
+    check<T>(m, n, k, alpha, src, dst_cuda);
+    std::cout << "OK: kernel::softmax_online::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, 1, {1});
+    validate<fp32_t>(3, 5, {4, 7, 1});
+    validate<fp32_t>(1, 4, {100, 28});
+    validate<fp64_t>(1, 1, {1});
+    validate<fp64_t>(3, 5, {4, 7, 1});
+    validate<fp64_t>(1, 4, {100, 28});
+    // Slice does not fit into shared memory of CUDA
+    validate<fp64_t>(1, 2, {4000, 3000});
+    return 0;
+}
+
@@ -0,0 +1,177 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/strassen.cc
+ * Strassen multiplication operation
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/kernel/strassen.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+#include <cmath>
+#include <limits>
+
+using namespace nntile;
+using namespace nntile::kernel::strassen;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(TransOp transA, TransOp transB, Index m, Index n, Index k,
+        T alpha, const std::vector<T> &A, const std::vector<T> &B, T beta,
+        std::vector<T> &C, int nlevels)
+{
+    // Copy to device
+    T *dev_A, *dev_B, *dev_C, *dev_work;
+    Index work_size = workspace_size(m, n, k, nlevels) + 1;
+    cudaError_t cuda_err = cudaMalloc(&dev_A, sizeof(T)*m*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_B, sizeof(T)*k*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_C, sizeof(T)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_work, sizeof(T)*work_size);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_A, &A[0], sizeof(T)*m*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_B, &B[0], sizeof(T)*k*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_C, &C[0], sizeof(T)*m*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream and cuBLAS handle
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cublasHandle_t handle;
+    TEST_ASSERT(cublasCreate(&handle) == CUBLAS_STATUS_SUCCESS);
+    TEST_ASSERT(cublasSetStream(handle, stream) == CUBLAS_STATUS_SUCCESS);
+    // Launch low-level kernel
+    cuda<T>(handle, transA, transB, m, n, k, alpha, dev_A, dev_B, beta,
+            dev_C, dev_work, nlevels);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&C[0], dev_C, sizeof(T)*m*n,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    TEST_ASSERT(cublasDestroy(handle) == CUBLAS_STATUS_SUCCESS);
+    cuda_err = cudaFree(dev_A);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_B);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_C);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_work);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Relative error of C against its reference in Frobenius norm
+template<typename T>
+T rel_error(const std::vector<T> &C, const std::vector<T> &C_ref)
+{
+    T diff = 0, norm = 0;
+    for(Index i = 0; i < C.size(); ++i)
+    {
+        diff += (C[i]-C_ref[i]) * (C[i]-C_ref[i]);
+        norm += C_ref[i] * C_ref[i];
+    }
+    return std::sqrt(diff / norm);
+}
+
+// Run tests for the given precision
+template<typename T>
+void validate(TransOp transA, TransOp transB, Index m, Index n, Index k,
+        T beta)
+{
+    T eps = 10 * std::numeric_limits<T>::epsilon() * k;
+    T alpha = -1.5;
+    // Init test input
+    std::vector<T> A(m*k), B(k*n), C(m*n), C_ref(m*n);
+    for(Index i = 0; i < m*k; ++i)
+    {
+        A[i] = T(2*i+1-m*k) / T(m*k);
+    }
+    for(Index i = 0; i < k*n; ++i)
+    {
+        B[i] = std::cos(T(i));
+    }
+    for(Index i = 0; i < m*n; ++i)
+    {
+        C[i] = T(i % 7) - T(3);
+    }
+    // Reference by the definition
+    for(Index j = 0; j < n; ++j)
+    {
+        for(Index i = 0; i < m; ++i)
+        {
+            T sum = 0;
+            for(Index l = 0; l < k; ++l)
+            {
+                T a = transA.value == TransOp::NoTrans ? A[i+l*m] : A[l+i*k];
+                T b = transB.value == TransOp::NoTrans ? B[l+j*k] : B[j+l*n];
+                sum += a * b;
+            }
+            C_ref[i+j*m] = alpha*sum + beta*C[i+j*m];
+        }
+    }
+    // Check low-level CPU kernel
+    std::vector<T> C_cpu(C);
+    std::cout << "Run kernel::strassen::cpu<T>\n";
+    cpu<T>(transA, transB, m, n, k, alpha, &A[0], &B[0], beta, &C_cpu[0]);
+    TEST_ASSERT(rel_error(C_cpu, C_ref) <= eps);
+    std::cout << "OK: kernel::strassen::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel with different depths of recursion
+    for(int nlevels = 0; nlevels <= 3; ++nlevels)
+    {
+        std::vector<T> C_cuda(C);
+        // C is not read if beta is zero
+        if(beta == T{0})
+        {
+            for(Index i = 0; i < m*n; ++i)
+            {
+                C_cuda[i] = std::numeric_limits<T>::quiet_NaN();
+            }
+        }
+        std::cout << "Run kernel::strassen::cuda<T>\n";
+        run_cuda<T>(transA, transB, m, n, k, alpha, A, B, beta, C_cuda,
+                nlevels);
+        TEST_ASSERT(rel_error(C_cuda, C_ref) <= eps);
+        std::cout << "OK: kernel::strassen::cuda<T>\n";
+    }
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    TransOp opN(TransOp::NoTrans), opT(TransOp::Trans);
+    for(TransOp transA: {opN, opT})
+    {
+        for(TransOp transB: {opN, opT})
+        {
+            // Even sizes, odd sizes and sizes only one level deep
+            validate<fp32_t>(transA, transB, 64, 64, 64, 0.0);
+            validate<fp32_t>(transA, transB, 33, 17, 20, 1.0);
+            validate<fp32_t>(transA, transB, 6, 10, 5, -0.5);
+            validate<fp64_t>(transA, transB, 64, 64, 64, 0.0);
+            validate<fp64_t>(transA, transB, 33, 17, 20, 1.0);
+            validate<fp64_t>(transA, transB, 6, 10, 5, -0.5);
+        }
+    }
+    return 0;
+}
+
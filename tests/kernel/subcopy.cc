@@ -9,7 +9,7 @@
  *
  * @version 1.0.0
  * @author Aleksandr Mikhalev
- * @date 2023-03-27
+ * @date 2024-02-15
  * */
 
 #include "nntile/kernel/subcopy.hh"
@@ -22,6 +22,46 @@
 using namespace nntile;
 using namespace nntile::kernel::subcopy;
 
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index ndim, const Index *src_start, const Index *src_stride,
+        const Index *copy_shape, const std::vector<T> &src,
+        const Index *dst_start, const Index *dst_stride, std::vector<T> &dst)
+{
+    // Copy to device
+    T *dev_src, *dev_dst;
+    cudaError_t cuda_err = cudaMalloc(&dev_src, sizeof(T)*src.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(T)*dst.size());
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*src.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_dst, &dst[0], sizeof(T)*dst.size(),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, ndim, src_start, src_stride, copy_shape, dev_src,
+            dst_start, dst_stride, dev_dst);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(T)*dst.size(),
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
 // Templated validation
 template<typename T, std::size_t NDIM>
 void validate(std::array<Index, NDIM> src, std::array<Index, NDIM> dst,
@@ -153,6 +193,17 @@ void validate(std::array<Index, NDIM> src, std::array<Index, NDIM> dst,
         }
     }
     std::cout << "Ok: kernel::subcopy::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // CUDA produces the same result
+    std::cout << "Run kernel::subcopy::cuda<T>\n";
+    run_cuda<T>(NDIM, &src_start[0], &src_stride[0], &copy_shape[0],
+            src_data, &dst_start[0], &dst_stride[0], dst2_data);
+    for(Index i = 0; i < dst_nelems; ++i)
+    {
+        TEST_ASSERT(dst2_data[i] == dst_data[i]);
+    }
+    std::cout << "Ok: kernel::subcopy::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
 }
 
 // Run multiple tests for a given precision
@@ -169,6 +220,12 @@ void validate_many()
     validate<T, 3>({1, 0, 0}, {-1, 0, 0}, {2, 3, 4});
     validate<T, 3>({0, 1, -1}, {3, -4, 5}, {2, 3, 4});
     validate<T, 2>({384, 500}, {0, 0}, {384, 500});
+    // Leading dimensions are contiguous in both arrays
+    validate<T, 3>({0, 0, 1}, {0, 0, -2}, {3, 4, 5});
+    validate<T, 3>({0, 1, 0}, {0, -1, 2}, {3, 4, 5});
+    validate<T, 4>({0, 2, 0, 1}, {1, 0, -1, 0}, {3, 2, 4, 2});
+    validate<T, 6>({1, 0, 1, 0, 1, 0}, {0, 1, 0, 1, 0, 1},
+            {2, 2, 2, 2, 2, 2});
 }
 
 int main(int argc, char **argv)
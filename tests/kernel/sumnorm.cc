@@ -218,10 +218,18 @@ int main(int argc, char **argv)
     validate<fp32_t>(8, 9, 1);
     validate<fp32_t>(8, 1, 10);
     validate<fp32_t>(4, 7, 8);
+    validate<fp32_t>(16, 3, 5);
+    validate<fp32_t>(64, 2, 7);
+    validate<fp32_t>(1, 3, 300);
+    validate<fp32_t>(40, 2, 100);
     validate<fp64_t>(1, 9, 10);
     validate<fp64_t>(8, 9, 1);
     validate<fp64_t>(8, 1, 10);
     validate<fp64_t>(4, 7, 8);
+    validate<fp64_t>(32, 3, 5);
+    validate<fp64_t>(128, 2, 3);
+    validate<fp64_t>(1, 2, 700);
+    validate<fp64_t>(33, 3, 70);
     return 0;
 }
 
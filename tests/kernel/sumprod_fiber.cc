@@ -12,12 +12,127 @@
  * @date 2023-05-02
  * */
 
+#include "nntile/kernel/sumprod_fiber.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
 #include <iostream>
 
+using namespace nntile;
+using namespace nntile::kernel::sumprod_fiber;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, Index k, T alpha, const std::vector<T> &src1,
+        const std::vector<T> &src2, T beta, std::vector<T> &dst)
+{
+    // Copy to device
+    T *dev_src1, *dev_src2, *dev_dst;
+    cudaError_t cuda_err = cudaMalloc(&dev_src1, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_src2, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(T)*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src1, &src1[0], sizeof(T)*m*n*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src2, &src2[0], sizeof(T)*m*n*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_dst, &dst[0], sizeof(T)*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, m, n, k, alpha, dev_src1, dev_src2, beta, dev_dst);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(T)*k,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src1);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src2);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k, T alpha, T beta)
+{
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    // Init test input with small integers, so that sums are exact
+    std::vector<T> src1(m*n*k), src2(m*n*k), dst(k);
+    for(Index i = 0; i < m*n*k; ++i)
+    {
+        src1[i] = T(i%7) - T(3);
+        src2[i] = T(i%5) - T(1);
+    }
+    for(Index i2 = 0; i2 < k; ++i2)
+    {
+        dst[i2] = T(i2%3) - T(1);
+    }
+    // Reference result
+    std::vector<T> ref(k);
+    for(Index i2 = 0; i2 < k; ++i2)
+    {
+        double sum = 0;
+        for(Index i1 = 0; i1 < n; ++i1)
+        {
+            for(Index i0 = 0; i0 < m; ++i0)
+            {
+                Index i = (i1*k+i2)*m + i0;
+                sum += double(src1[i]) * double(src2[i]);
+            }
+        }
+        ref[i2] = T(beta*double(dst[i2]) + alpha*sum);
+    }
+    // Check low-level kernel
+    std::vector<T> dst_cpu(dst);
+    std::cout << "Run kernel::sumprod_fiber::cpu<T>\n";
+    cpu<T>(m, n, k, alpha, &src1[0], &src2[0], beta, &dst_cpu[0]);
+    for(Index i2 = 0; i2 < k; ++i2)
+    {
+        TEST_ASSERT(std::abs(dst_cpu[i2]-ref[i2])
+                <= 10*eps*std::abs(ref[i2]));
+    }
+    std::cout << "OK: kernel::sumprod_fiber::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> dst_cuda(dst);
+    std::cout << "Run kernel::sumprod_fiber::cuda<T>\n";
+    run_cuda<T>(m, n, k, alpha, src1, src2, beta, dst_cuda);
+    for(Index i2 = 0; i2 < k; ++i2)
+    {
+        TEST_ASSERT(std::abs(dst_cuda[i2]-ref[i2])
+                <= 10*eps*std::abs(ref[i2]));
+    }
+    std::cout << "OK: kernel::sumprod_fiber::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
 int main(int argc, char **argv)
 {
-    // Not implemented
-    std::cout << "This test is not yet implemented\n";
-    return -1;
+    validate<fp32_t>(1, 9, 10, 1.0, 1.0);
+    validate<fp32_t>(8, 9, 1, 2.0, 0.0);
+    validate<fp32_t>(1, 400, 3, -1.0, 2.0);
+    validate<fp32_t>(40, 3, 5, 1.0, -1.0);
+    validate<fp64_t>(1, 9, 10, 2.0, -2.0);
+    validate<fp64_t>(4, 7, 8, -1.0, 2.0);
+    validate<fp64_t>(1, 300, 2, 1.0, 0.0);
+    validate<fp64_t>(64, 200, 2, -2.0, 1.0);
+    return 0;
 }
 
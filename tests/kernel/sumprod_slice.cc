@@ -143,10 +143,14 @@ int main(int argc, char **argv)
     validate<fp32_t>(8, 9, 1, 2.0, 0.0);
     validate<fp32_t>(8, 1, 10, 1.0, -1.0);
     validate<fp32_t>(4, 7, 8, 0.0, 1.0);
+    validate<fp32_t>(40, 3, 10, 1.0, -1.0);
+    validate<fp32_t>(33, 2, 100, -1.0, 0.0);
     validate<fp64_t>(1, 9, 10, 2.0, -2.0);
     validate<fp64_t>(8, 9, 1, -2.0, 2.0);
     validate<fp64_t>(8, 1, 10, 1.0, 2.0);
     validate<fp64_t>(4, 7, 8, -1.0, 2.0);
+    validate<fp64_t>(64, 3, 100, 2.0, 1.0);
+    validate<fp64_t>(48, 2, 7, 1.0, 0.0);
     return 0;
 }
 
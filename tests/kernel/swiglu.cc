@@ -0,0 +1,117 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/swiglu.cc
+ * SiLU-gated product of buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/swiglu.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::swiglu;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index nelems, const std::vector<T> &gate,
+        const std::vector<T> &up, std::vector<T> &dst)
+{
+    // Copy to device
+    T *dev_gate, *dev_up, *dev_dst;
+    cudaError_t cuda_err = cudaMalloc(&dev_gate, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_up, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_gate, &gate[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_up, &up[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, nelems, dev_gate, dev_up, dev_dst);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(T)*nelems,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_gate);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_up);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Templated validation
+template<typename T>
+void validate(Index nelems)
+{
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    // Init test input, large negative gates saturate the exponent
+    std::vector<T> gate(nelems), up(nelems), dst(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        gate[i] = T(i%23)/T(2) - T((i/3)%13) - T(i%7 == 0 ? 100 : 0);
+        up[i] = T(i%5)/T(3) - T((i/3)%7)/T(4);
+    }
+    // Get reference result in double precision
+    std::vector<double> ref(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        double z = gate[i];
+        ref[i] = z / (1.0+std::exp(-z)) * up[i];
+    }
+    // Check low-level CPU kernel
+    std::cout << "Run kernel::swiglu::cpu<T>\n";
+    cpu<T>(nelems, &gate[0], &up[0], &dst[0]);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(std::abs(dst[i]-ref[i]) <= 10*eps*(1+std::abs(ref[i])));
+    }
+    std::cout << "OK: kernel::swiglu::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> dst_cuda(nelems);
+    std::cout << "Run kernel::swiglu::cuda<T>\n";
+    run_cuda<T>(nelems, gate, up, dst_cuda);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(std::abs(dst_cuda[i]-ref[i])
+                <= 10*eps*(1+std::abs(ref[i])));
+    }
+    std::cout << "OK: kernel::swiglu::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1);
+    validate<fp32_t>(1000);
+    validate<fp64_t>(1);
+    validate<fp64_t>(1000);
+    return 0;
+}
+
@@ -0,0 +1,153 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/swiglu_backward.cc
+ * Backward of SiLU-gated product of buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/kernel/swiglu_backward.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::swiglu_backward;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index nelems, const std::vector<T> &gate,
+        const std::vector<T> &up, const std::vector<T> &dst_grad,
+        std::vector<T> &gate_grad, std::vector<T> &up_grad)
+{
+    // Copy to device
+    T *dev_gate, *dev_up, *dev_dst_grad, *dev_gate_grad, *dev_up_grad;
+    cudaError_t cuda_err = cudaMalloc(&dev_gate, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_up, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst_grad, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_gate_grad, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_up_grad, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_gate, &gate[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_up, &up[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_dst_grad, &dst_grad[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_gate_grad, &gate_grad[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_up_grad, &up_grad[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, nelems, dev_gate, dev_up, dev_dst_grad, dev_gate_grad,
+            dev_up_grad);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&gate_grad[0], dev_gate_grad, sizeof(T)*nelems,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&up_grad[0], dev_up_grad, sizeof(T)*nelems,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_gate);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_up);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst_grad);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_gate_grad);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_up_grad);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check result against the reference
+template<typename T>
+void check(const std::vector<T> &val, const std::vector<double> &ref)
+{
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    for(Index i = 0; i < val.size(); ++i)
+    {
+        TEST_ASSERT(std::abs(val[i]-ref[i]) <= 20*eps*(1+std::abs(ref[i])));
+    }
+}
+
+// Templated validation
+template<typename T>
+void validate(Index nelems)
+{
+    // Init test input, large negative gates saturate the exponent
+    std::vector<T> gate(nelems), up(nelems), dst_grad(nelems),
+        gate_grad(nelems), up_grad(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        gate[i] = T(i%23)/T(2) - T((i/3)%13) - T(i%7 == 0 ? 100 : 0);
+        up[i] = T(i%5)/T(3) - T((i/3)%7)/T(4);
+        dst_grad[i] = T(i%11)/T(5) - T(1);
+        gate_grad[i] = T(i%3) - T(1);
+        up_grad[i] = T(i%4) - T(2);
+    }
+    // Get reference result in double precision, gradients are accumulated
+    std::vector<double> gate_grad_ref(gate_grad.begin(), gate_grad.end()),
+        up_grad_ref(up_grad.begin(), up_grad.end());
+    for(Index i = 0; i < nelems; ++i)
+    {
+        double z = gate[i];
+        double s = 1.0 / (1.0+std::exp(-z));
+        gate_grad_ref[i] += dst_grad[i] * up[i] * s * (1.0+z*(1.0-s));
+        up_grad_ref[i] += dst_grad[i] * z * s;
+    }
+    // Check low-level CPU kernel
+    std::vector<T> gate_grad_cpu(gate_grad), up_grad_cpu(up_grad);
+    std::cout << "Run kernel::swiglu_backward::cpu<T>\n";
+    cpu<T>(nelems, &gate[0], &up[0], &dst_grad[0], &gate_grad_cpu[0],
+            &up_grad_cpu[0]);
+    check(gate_grad_cpu, gate_grad_ref);
+    check(up_grad_cpu, up_grad_ref);
+    std::cout << "OK: kernel::swiglu_backward::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> gate_grad_cuda(gate_grad), up_grad_cuda(up_grad);
+    std::cout << "Run kernel::swiglu_backward::cuda<T>\n";
+    run_cuda<T>(nelems, gate, up, dst_grad, gate_grad_cuda, up_grad_cuda);
+    check(gate_grad_cuda, gate_grad_ref);
+    check(up_grad_cuda, up_grad_ref);
+    std::cout << "OK: kernel::swiglu_backward::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1);
+    validate<fp32_t>(1000);
+    validate<fp64_t>(1);
+    validate<fp64_t>(1000);
+    return 0;
+}
+
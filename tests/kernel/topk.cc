@@ -0,0 +1,187 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/topk.cc
+ * Largest values and their indices along middle axis
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-11
+ * */
+
+#include "nntile/kernel/topk.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <algorithm>
+
+using namespace nntile;
+using namespace nntile::kernel::topk;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, Index k, Index nk, Index offset, Index size,
+        bool init, const std::vector<T> &src, std::vector<T> &values,
+        std::vector<Index> &indices)
+{
+    // Copy to device
+    T *dev_src, *dev_values;
+    Index *dev_indices;
+    cudaError_t cuda_err = cudaMalloc(&dev_src, sizeof(T)*m*n*k);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_values, sizeof(T)*nk*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_indices, sizeof(Index)*nk*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*m*n*k,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_values, &values[0], sizeof(T)*nk*m*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_indices, &indices[0], sizeof(Index)*nk*m*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, m, n, k, nk, offset, size, init, dev_src, dev_values,
+            dev_indices);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&values[0], dev_values, sizeof(T)*nk*m*n,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&indices[0], dev_indices, sizeof(Index)*nk*m*n,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_values);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_indices);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Compare with sorting of slices of the whole array of m-by-k-by-n elements,
+// whose elements with indices not less than size are ignored
+template<typename T>
+void check(Index m, Index n, Index k, Index nk, Index size,
+        const std::vector<T> &src, const std::vector<T> &values,
+        const std::vector<Index> &indices)
+{
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i1 = 0; i1 < m; ++i1)
+        {
+            std::vector<Index> order;
+            for(Index i0 = 0; i0 < std::min(k, size); ++i0)
+            {
+                order.push_back(i0);
+            }
+            auto value = [&](Index i0)
+            {
+                return static_cast<fp64_t>(src[(i2*k+i0)*m+i1]);
+            };
+            // Stable sort keeps smaller indices of ties first
+            std::stable_sort(order.begin(), order.end(),
+                    [&](Index a, Index b){return value(a) > value(b);});
+            Index col = i1 + i2*m;
+            for(Index j = 0; j < nk; ++j)
+            {
+                fp64_t val = static_cast<fp64_t>(values[col*nk+j]);
+                Index idx = indices[col*nk+j];
+                if(j < order.size())
+                {
+                    TEST_ASSERT(idx == order[j]);
+                    TEST_ASSERT(val == value(order[j]));
+                }
+                else
+                {
+                    TEST_ASSERT(idx == -1);
+                    TEST_ASSERT(val == -std::numeric_limits<fp64_t>
+                            ::infinity());
+                }
+            }
+        }
+    }
+}
+
+// Templated validation, the middle axis is split into two tiles
+template<typename T>
+void validate(Index m, Index n, Index k, Index k1, Index nk, Index size)
+{
+    // Init test input with ties
+    std::vector<T> src(m*n*k);
+    for(Index i = 0; i < src.size(); ++i)
+    {
+        src[i] = T(fp32_t((i*37)%29) - fp32_t(10));
+    }
+    // Tiles of the source array
+    Index k2 = k - k1;
+    std::vector<T> src1(m*n*k1), src2(m*n*k2);
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i0 = 0; i0 < k; ++i0)
+        {
+            for(Index i1 = 0; i1 < m; ++i1)
+            {
+                T val = src[(i2*k+i0)*m+i1];
+                if(i0 < k1)
+                {
+                    src1[(i2*k1+i0)*m+i1] = val;
+                }
+                else
+                {
+                    src2[(i2*k2+i0-k1)*m+i1] = val;
+                }
+            }
+        }
+    }
+    // Check low-level CPU kernel, the second tile goes first, garbage of
+    // output is overwritten
+    std::vector<T> values(nk*m*n, T(1.0));
+    std::vector<Index> indices(nk*m*n, 0);
+    std::cout << "Run kernel::topk::cpu<T>\n";
+    cpu<T>(m, n, k2, nk, k1, size, true, &src2[0], &values[0], &indices[0]);
+    cpu<T>(m, n, k1, nk, 0, size, false, &src1[0], &values[0], &indices[0]);
+    check<T>(m, n, k, nk, size, src, values, indices);
+    std::cout << "OK: kernel::topk::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel
+    std::vector<T> values_cuda(nk*m*n, T(1.0));
+    std::vector<Index> indices_cuda(nk*m*n, 0);
+    std::cout << "Run kernel::topk::cuda<T>\n";
+    run_cuda<T>(m, n, k2, nk, k1, size, true, src2, values_cuda,
+            indices_cuda);
+    run_cuda<T>(m, n, k1, nk, 0, size, false, src1, values_cuda,
+            indices_cuda);
+    check<T>(m, n, k, nk, size, src, values_cuda, indices_cuda);
+    std::cout << "OK: kernel::topk::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(3, 5, 100, 40, 1, 100);
+    validate<fp32_t>(3, 5, 100, 40, 7, 100);
+    validate<fp32_t>(1, 4, 100, 60, 5, 90);
+    validate<fp32_t>(2, 3, 10, 4, 8, 7);
+    validate<fp64_t>(3, 5, 100, 40, 7, 100);
+    validate<fp64_t>(1, 4, 100, 60, 5, 50);
+    validate<bf16_t>(3, 5, 100, 40, 7, 100);
+    validate<fp16_t>(1, 4, 100, 60, 5, 90);
+    return 0;
+}
+
@@ -0,0 +1,177 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/topk_sample.cc
+ * Sampling of tokens among the largest logits
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-11
+ * */
+
+#include "nntile/kernel/topk_sample.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::kernel::topk_sample;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index nk, Index n, fp32_t temperature, fp32_t top_p,
+        unsigned long long seed, Index sequence, const std::vector<T> &values,
+        const std::vector<Index> &indices, std::vector<Index> &ids)
+{
+    // Copy to device
+    T *dev_values;
+    Index *dev_indices, *dev_ids;
+    cudaError_t cuda_err = cudaMalloc(&dev_values, sizeof(T)*nk*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_indices, sizeof(Index)*nk*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_ids, sizeof(Index)*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_values, &values[0], sizeof(T)*nk*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_indices, &indices[0], sizeof(Index)*nk*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda<T>(stream, nk, n, temperature, top_p, seed, sequence, dev_values,
+            dev_indices, dev_ids);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&ids[0], dev_ids, sizeof(Index)*n,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_values);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_indices);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_ids);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check frequencies of sampled ids. All the columns have the same nk-2
+// valid candidates with logits 0, -1, -2 and so on, so that frequencies
+// shall be close to the softmax over the nucleus.
+void check(Index nk, Index n, fp32_t temperature, fp32_t top_p,
+        const std::vector<Index> &ids)
+{
+    Index nvalid = nk - 2;
+    std::vector<fp64_t> prob(nvalid), freq(nvalid, 0);
+    fp64_t total = 0;
+    for(Index l = 0; l < nvalid; ++l)
+    {
+        prob[l] = std::exp(-fp64_t(l)/temperature);
+        total += prob[l];
+    }
+    // Nucleus
+    fp64_t mass = 0;
+    Index cnt = 0;
+    while(cnt < nvalid and mass < top_p*total)
+    {
+        mass += prob[cnt];
+        ++cnt;
+    }
+    for(Index j = 0; j < n-1; ++j)
+    {
+        // Ids are 10 times the position of a candidate
+        Index l = ids[j] / 10;
+        TEST_ASSERT(ids[j] == 10*l and l >= 0 and l < cnt);
+        freq[l] += 1.0 / fp64_t(n-1);
+    }
+    for(Index l = 0; l < cnt; ++l)
+    {
+        TEST_ASSERT(std::abs(freq[l]-prob[l]/mass) < 0.02);
+    }
+    // The last column has no valid candidates
+    TEST_ASSERT(ids[n-1] == -1);
+}
+
+// Templated validation
+template<typename T>
+void validate(Index nk, Index n, fp32_t temperature, fp32_t top_p)
+{
+    // Init candidates, the last column has no valid candidates
+    std::vector<T> values(nk*n);
+    std::vector<Index> indices(nk*n);
+    for(Index j = 0; j < n; ++j)
+    {
+        for(Index l = 0; l < nk; ++l)
+        {
+            bool valid = l < nk-2 and j < n-1;
+            values[j*nk+l] = valid ? T(-fp32_t(l))
+                : T(-std::numeric_limits<fp32_t>::infinity());
+            indices[j*nk+l] = valid ? 10*l : -1;
+        }
+    }
+    unsigned long long seed = 12345;
+    // Check low-level CPU kernel
+    std::vector<Index> ids(n), ids2(n);
+    std::cout << "Run kernel::topk_sample::cpu<T>\n";
+    cpu<T>(nk, n, temperature, top_p, seed, 0, &values[0], &indices[0],
+            &ids[0]);
+    if(temperature == 0)
+    {
+        for(Index j = 0; j < n-1; ++j)
+        {
+            TEST_ASSERT(ids[j] == 0);
+        }
+        TEST_ASSERT(ids[n-1] == -1);
+    }
+    else
+    {
+        check(nk, n, temperature, top_p, ids);
+    }
+    // The same seed and sequence give the same ids
+    cpu<T>(nk, n, temperature, top_p, seed, 0, &values[0], &indices[0],
+            &ids2[0]);
+    TEST_ASSERT(ids == ids2);
+    std::cout << "OK: kernel::topk_sample::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    // Check low-level CUDA kernel, that uses the same random numbers
+    std::vector<Index> ids_cuda(n);
+    std::cout << "Run kernel::topk_sample::cuda<T>\n";
+    run_cuda<T>(nk, n, temperature, top_p, seed, 0, values, indices,
+            ids_cuda);
+    Index nmismatch = 0;
+    for(Index j = 0; j < n; ++j)
+    {
+        nmismatch += (ids[j] != ids_cuda[j]);
+    }
+    // Rounding of exponents may only move rare boundary cases
+    TEST_ASSERT(nmismatch <= n/1000);
+    std::cout << "OK: kernel::topk_sample::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(6, 100, 0.0, 1.0);
+    validate<fp32_t>(3, 100, 1.0, 1.0);
+    validate<fp32_t>(10, 20001, 1.0, 1.0);
+    validate<fp32_t>(10, 20001, 0.5, 0.9);
+    validate<fp32_t>(10, 20001, 2.0, 0.1);
+    validate<fp64_t>(10, 20001, 1.5, 0.8);
+    validate<bf16_t>(10, 20001, 1.0, 0.95);
+    validate<fp16_t>(10, 20001, 1.0, 1.0);
+    return 0;
+}
+
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/transpose.hh"
+#include "nntile/kernel/simd.hh"
 #include "../testing.hh"
 #include <vector>
 #include <stdexcept>
@@ -58,6 +59,34 @@ void run_cuda(Index m, Index n, T alpha, const std::vector<T> &src,
     cuda_err = cudaStreamDestroy(stream);
     TEST_ASSERT(cuda_err == cudaSuccess);
 }
+
+template<typename T>
+void run_cuda_inplace(Index n, T alpha, std::vector<T> &data)
+{
+    // Copy to device
+    T *dev_data;
+    cudaError_t cuda_err = cudaMalloc(&dev_data, sizeof(T)*n*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_data, &data[0], sizeof(T)*n*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level CUDA kernel
+    cuda_inplace<T>(stream, n, alpha, dev_data);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&data[0], dev_data, sizeof(T)*n*n,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_data);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
 #endif // NNTILE_USE_CUDA
 
 // Templated validation
@@ -80,19 +109,30 @@ void validate(Index m, Index n)
     }
     // Save original dst
     std::vector<T> dst_save(dst);
-    // Check low-level CPU kernel
-    std::cout << "Run kernel::transpose::cpu<T>\n";
-    cpu<T>(m, n, -2.0, &src[0], &dst[0]);
-    for(Index i0 = 0; i0 < m; ++i0)
+    // Check low-level CPU kernel with all the supported instruction sets
+    using kernel::simd::Level;
+    for(Level level: {Level::NONE, Level::AVX2, Level::AVX512})
     {
-        for(Index i1 = 0; i1 < n; ++i1)
+        if(kernel::simd::set_level(level) != level)
         {
-            T val = dst[i0*n+i1];
-            T val_ref = -2.0 * src[i1*m+i0];
-            TEST_ASSERT(std::abs(val/val_ref-T{1}) <= 10*eps);
+            continue;
         }
+        dst = dst_save;
+        std::cout << "Run kernel::transpose::cpu<T> with SIMD level "
+            << static_cast<int>(level) << "\n";
+        cpu<T>(m, n, -2.0, &src[0], &dst[0]);
+        for(Index i0 = 0; i0 < m; ++i0)
+        {
+            for(Index i1 = 0; i1 < n; ++i1)
+            {
+                T val = dst[i0*n+i1];
+                T val_ref = -2.0 * src[i1*m+i0];
+                TEST_ASSERT(std::abs(val/val_ref-T{1}) <= 10*eps);
+            }
+        }
+        std::cout << "OK: kernel::transpose::cpu<T>\n";
     }
-    std::cout << "OK: kernel::transpose::cpu<T>\n";
+    kernel::simd::set_level(Level::AVX512);
 #ifdef NNTILE_USE_CUDA
     // Check low-level CUDA kernel
     dst = dst_save;
@@ -111,6 +151,41 @@ void validate(Index m, Index n)
 #endif // NNTILE_USE_CUDA
 }
 
+// Validation of inplace transpose of a square buffer
+template<typename T>
+void validate_inplace(Index n)
+{
+    std::vector<T> src(n*n);
+    for(Index i = 0; i < n*n; ++i)
+    {
+        src[i] = T(i+1) / T{20};
+    }
+    std::vector<T> data(src);
+    std::cout << "Run kernel::transpose::cpu_inplace<T>\n";
+    cpu_inplace<T>(n, -2.0, &data[0]);
+    for(Index i0 = 0; i0 < n; ++i0)
+    {
+        for(Index i1 = 0; i1 < n; ++i1)
+        {
+            TEST_ASSERT(data[i0*n+i1] == T{-2.0}*src[i1*n+i0]);
+        }
+    }
+    std::cout << "OK: kernel::transpose::cpu_inplace<T>\n";
+#ifdef NNTILE_USE_CUDA
+    data = src;
+    std::cout << "Run kernel::transpose::cuda_inplace<T>\n";
+    run_cuda_inplace<T>(n, -2.0, data);
+    for(Index i0 = 0; i0 < n; ++i0)
+    {
+        for(Index i1 = 0; i1 < n; ++i1)
+        {
+            TEST_ASSERT(data[i0*n+i1] == T{-2.0}*src[i1*n+i0]);
+        }
+    }
+    std::cout << "OK: kernel::transpose::cuda_inplace<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
 int main(int argc, char **argv)
 {
     validate<fp32_t>(1, 9);
@@ -121,6 +196,15 @@ int main(int argc, char **argv)
     validate<fp64_t>(8, 9);
     validate<fp64_t>(8, 1);
     validate<fp64_t>(4, 7);
+    // Sizes with full and partial micro-blocks and cache blocks
+    validate<fp32_t>(67, 130);
+    validate<fp64_t>(67, 130);
+    validate_inplace<fp32_t>(1);
+    validate_inplace<fp32_t>(7);
+    validate_inplace<fp32_t>(130);
+    validate_inplace<fp64_t>(1);
+    validate_inplace<fp64_t>(7);
+    validate_inplace<fp64_t>(130);
     return 0;
 }
 
@@ -58,6 +58,25 @@ void validate_cpu(Index m, Index n, Index k)
         TEST_ASSERT(dst[i] == dst2[i]);
     }
     std::cout << "OK: starpu::add_slice::submit<T> restricted to CPU\n";
+    // Single task for two destination tiles, that share the source tile
+    std::vector<T> dst3(dst2), dst4(dst2);
+    kernel::add_slice::cpu<T>(m, n, k, 0.5, &src[0], -0.5, &dst[0]);
+    VariableHandle dst3_handle(&dst3[0], sizeof(T)*m*n*k, STARPU_RW),
+        dst4_handle(&dst4[0], sizeof(T)*m*n*k, STARPU_RW);
+    std::cout << "Run aggregated starpu::add_slice::submit<T> restricted to "
+        "CPU\n";
+    add_slice::submit<T>(m, n, k, 0.5, src_handle, -0.5,
+            std::vector<Handle>{dst3_handle, dst4_handle});
+    starpu_task_wait_for_all();
+    dst3_handle.unregister();
+    dst4_handle.unregister();
+    for(Index i = 0; i < m*n*k; ++i)
+    {
+        TEST_ASSERT(dst[i] == dst3[i]);
+        TEST_ASSERT(dst[i] == dst4[i]);
+    }
+    std::cout << "OK: aggregated starpu::add_slice::submit<T> restricted to "
+        "CPU\n";
 }
 
 #ifdef NNTILE_USE_CUDA
@@ -13,6 +13,8 @@
  * */
 
 #include "nntile/starpu/conv2d.hh"
+#include "nntile/starpu/conv2d_backward_input.hh"
+#include "nntile/starpu/conv2d_backward_weight.hh"
 #include "nntile/kernel/conv2d.hh"
 #include "../testing.hh"
 
@@ -49,14 +51,16 @@ void validate_cpu(Index nx, Index ny, Index mx, Index my)
     std::vector<T> dst2(dst);
     // Launch low-level kernel
     std::cout << "Run kernel::conv2d::cpu<T>\n";
-    kernel::conv2d::cpu<T>(nx, ny, &src[0], mx, my, &kernel[0], &dst[0]);
+    kernel::conv2d::cpu<T>(0, 0, 1, nx, ny, &src[0], mx, my, &kernel[0],
+            nx+mx-1, ny+my-1, &dst[0]);
     // Check by actually submitting a task
     VariableHandle src_handle(&src[0], sizeof(T)*nx*ny, STARPU_R),
         kernel_handle(&kernel[0], sizeof(T)*mx*my, STARPU_R),
-		dst2_handle(&dst2[0], sizeof(T)*(nx+mx-1)*(ny+my-1), STARPU_W);
+		dst2_handle(&dst2[0], sizeof(T)*(nx+mx-1)*(ny+my-1), STARPU_RW);
     conv2d::restrict_where(STARPU_CPU);
     std::cout << "Run starpu::conv2d::submit<T> restricted to CPU\n";
-    conv2d::submit<T>(nx, ny, src_handle, mx, my, kernel_handle, dst2_handle);
+    conv2d::submit<T>(0, 0, 1, nx, ny, src_handle, mx, my, kernel_handle,
+            nx+mx-1, ny+my-1, dst2_handle);
     starpu_task_wait_for_all();
     dst2_handle.unregister();
     // Check result
@@ -67,6 +71,65 @@ void validate_cpu(Index nx, Index ny, Index mx, Index my)
     std::cout << "OK: starpu::conv2d::submit<T> restricted to CPU\n";
 }
 
+template<typename T>
+void validate_backward_cpu(Index nx, Index ny, Index mx, Index my)
+{
+    // Init all the data
+    Index dx = nx + mx - 1, dy = ny + my - 1;
+    std::vector<T> src(nx*ny), kernel(mx*my), dst_grad(dx*dy);
+    for(Index i = 0; i < nx*ny; ++i)
+    {
+        src[i] = T(i % 7) - 3;
+    }
+    for(Index i = 0; i < mx*my; ++i)
+    {
+        kernel[i] = T(i % 5) - 2;
+    }
+    for(Index i = 0; i < dx*dy; ++i)
+    {
+        dst_grad[i] = T(i % 3) - 1;
+    }
+    std::vector<T> src_grad(nx*ny, T(1)), kernel_grad(mx*my, T(1));
+    std::vector<T> src_grad2(src_grad), kernel_grad2(kernel_grad);
+    // Launch low-level kernels
+    std::cout << "Run kernel::conv2d::cpu_backward_input<T>\n";
+    kernel::conv2d::cpu_backward_input<T>(0, 0, 1, dx, dy, &dst_grad[0], mx,
+            my, &kernel[0], nx, ny, &src_grad[0]);
+    std::cout << "Run kernel::conv2d::cpu_backward_weight<T>\n";
+    kernel::conv2d::cpu_backward_weight<T>(0, 0, 1, nx, ny, &src[0], dx, dy,
+            &dst_grad[0], mx, my, &kernel_grad[0]);
+    // Check by actually submitting tasks
+    VariableHandle src_handle(&src[0], sizeof(T)*nx*ny, STARPU_R),
+        kernel_handle(&kernel[0], sizeof(T)*mx*my, STARPU_R),
+        dst_grad_handle(&dst_grad[0], sizeof(T)*dx*dy, STARPU_R),
+        src_grad2_handle(&src_grad2[0], sizeof(T)*nx*ny, STARPU_RW),
+        kernel_grad2_handle(&kernel_grad2[0], sizeof(T)*mx*my, STARPU_RW);
+    conv2d_backward_input::restrict_where(STARPU_CPU);
+    conv2d_backward_weight::restrict_where(STARPU_CPU);
+    std::cout << "Run starpu::conv2d_backward_input::submit<T> restricted to "
+        "CPU\n";
+    conv2d_backward_input::submit<T>(0, 0, 1, dx, dy, dst_grad_handle, mx,
+            my, kernel_handle, nx, ny, src_grad2_handle);
+    std::cout << "Run starpu::conv2d_backward_weight::submit<T> restricted "
+        "to CPU\n";
+    conv2d_backward_weight::submit<T>(0, 0, 1, nx, ny, src_handle, dx, dy,
+            dst_grad_handle, mx, my, kernel_grad2_handle);
+    starpu_task_wait_for_all();
+    src_grad2_handle.unregister();
+    kernel_grad2_handle.unregister();
+    // Check results
+    for(Index i = 0; i < nx*ny; ++i)
+    {
+        TEST_ASSERT(src_grad[i] == src_grad2[i]);
+    }
+    for(Index i = 0; i < mx*my; ++i)
+    {
+        TEST_ASSERT(kernel_grad[i] == kernel_grad2[i]);
+    }
+    std::cout << "OK: starpu::conv2d_backward_{input,weight}::submit<T> "
+        "restricted to CPU\n";
+}
+
 #ifdef NNTILE_USE_CUDA
 template<typename T>
 void validate_cuda(Index nx, Index ny, Index mx, Index my)
@@ -114,7 +177,11 @@ void validate_cuda(Index nx, Index ny, Index mx, Index my)
             cudaMemcpyHostToDevice);
     TEST_ASSERT(cuda_err == cudaSuccess);
     std::cout << "Run kernel::conv2d::cuda<T>\n";
-    kernel::conv2d::cuda<T>(stream, nx, ny, dev_src, mx, my, dev_kernel, dev_dst);
+    cuda_err = cudaMemcpy(dev_dst, &dst[0], sizeof(T)*(nx+mx-1)*(ny+my-1),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    kernel::conv2d::cuda<T>(stream, 0, 0, 1, nx, ny, dev_src, mx, my,
+            dev_kernel, nx+mx-1, ny+my-1, dev_dst);
     // Wait for result and destroy stream
     cuda_err = cudaStreamSynchronize(stream);
     TEST_ASSERT(cuda_err == cudaSuccess);
@@ -134,10 +201,11 @@ void validate_cuda(Index nx, Index ny, Index mx, Index my)
     // Check by actually submitting a task
     VariableHandle src_handle(&src[0], sizeof(T)*nx*ny, STARPU_R),
 		kernel_handle(&kernel[0], sizeof(T)*mx*my, STARPU_R),
-        dst2_handle(&dst2[0], sizeof(T)*(nx+mx-1)*(ny+my-1), STARPU_W);
+        dst2_handle(&dst2[0], sizeof(T)*(nx+mx-1)*(ny+my-1), STARPU_RW);
     conv2d::restrict_where(STARPU_CUDA);
     std::cout << "Run starpu::conv2d::submit<T> restricted to CUDA\n";
-    conv2d::submit<T>(nx, ny, src_handle, mx, my, kernel_handle, dst2_handle);
+    conv2d::submit<T>(0, 0, 1, nx, ny, src_handle, mx, my, kernel_handle,
+            nx+mx-1, ny+my-1, dst2_handle);
     starpu_task_wait_for_all();
     dst2_handle.unregister();
     // Check result
@@ -155,9 +223,13 @@ int main(int argc, char **argv)
     Config starpu(1, 1, 0);
     // Init codelet
     conv2d::init();
+    conv2d_backward_input::init();
+    conv2d_backward_weight::init();
     // Launch all tests
     validate_cpu<fp32_t>(3, 5, 7, 9);
     validate_cpu<fp64_t>(3, 5, 7, 9);
+    validate_backward_cpu<fp32_t>(3, 5, 7, 9);
+    validate_backward_cpu<fp64_t>(4, 6, 3, 3);
 
 #ifdef NNTILE_USE_CUDA
     validate_cuda<fp32_t>(3, 5, 7, 9);
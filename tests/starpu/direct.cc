@@ -0,0 +1,89 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/starpu/direct.cc
+ * Direct execution of tasks by the submitting thread
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/starpu/direct.hh"
+#include "nntile/starpu/scal_inplace.hh"
+#include "nntile/starpu/copy.hh"
+#include "nntile/starpu/clear.hh"
+#include "../testing.hh"
+#include <vector>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::starpu;
+
+template<typename T>
+void validate(Index nelems)
+{
+    std::vector<T> src(nelems), dst(nelems, T{-1});
+    for(Index i = 0; i < nelems; ++i)
+    {
+        src[i] = T(i);
+    }
+    VariableHandle src_handle(&src[0], sizeof(T)*nelems, STARPU_RW),
+        dst_handle(&dst[0], sizeof(T)*nelems, STARPU_RW);
+    // Tasks with dependencies, that are executed in order of submission
+    std::cout << "Run tasks in direct mode\n";
+    direct::enter();
+    TEST_ASSERT(direct::is_active());
+    scal_inplace::submit<T>(T{2}, nelems, src_handle);
+    copy::submit(src_handle, dst_handle);
+    clear::submit(src_handle);
+    scal_inplace::submit<T>(T{3}, nelems, dst_handle);
+    direct::exit();
+    TEST_ASSERT(not direct::is_active());
+    // Tasks with hints of kinds of workers
+    {
+        scheduler::WhereScope where_cpu(STARPU_CPU);
+        TEST_ASSERT(scheduler::where_get() == STARPU_CPU);
+        {
+            // Codelets cannot run on CUDA, so tasks are not restricted
+            scheduler::WhereScope where_cuda(STARPU_CUDA);
+            scal_inplace::submit<T>(T{-1}, nelems, dst_handle);
+        }
+        TEST_ASSERT(scheduler::where_get() == STARPU_CPU);
+        scal_inplace::submit<T>(T{-1}, nelems, dst_handle);
+    }
+    TEST_ASSERT(scheduler::where_get() == 0);
+    // Tasks after direct mode go to StarPU and see results of direct ones
+    scal_inplace::submit<T>(T{-1}, nelems, dst_handle);
+    starpu_task_wait_for_all();
+    src_handle.unregister();
+    dst_handle.unregister();
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(src[i] == T{0});
+        TEST_ASSERT(dst[i] == T(-6*i));
+    }
+    std::cout << "OK: tasks in direct mode\n";
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    Config starpu(1, 0, 0);
+    // Init codelets
+    scal_inplace::init();
+    copy::init();
+    clear::init();
+    scal_inplace::restrict_where(STARPU_CPU);
+    copy::restrict_where(STARPU_CPU);
+    clear::restrict_where(STARPU_CPU);
+    // Launch all tests
+    validate<fp32_t>(1);
+    validate<fp32_t>(1000);
+    validate<fp64_t>(1000);
+    return 0;
+}
+
@@ -60,6 +60,36 @@ void validate_cpu(Index m, Index n)
     std::cout << "OK: starpu::transpose::submit<T> restricted to CPU\n";
 }
 
+template<typename T>
+void validate_cpu_inplace(Index n)
+{
+    // Init all the data
+    std::vector<T> data(n*n);
+    for(Index i = 0; i < n*n; ++i)
+    {
+        data[i] = T(2*i+2);
+    }
+    std::vector<T> data2(data);
+    // Launch low-level kernel
+    std::cout << "Run kernel::transpose::cpu_inplace<T>\n";
+    kernel::transpose::cpu_inplace<T>(n, 0.5, &data[0]);
+    // Check by actually submitting a task
+    VariableHandle data2_handle(&data2[0], sizeof(T)*n*n, STARPU_RW);
+    transpose::restrict_where(STARPU_CPU);
+    std::cout << "Run starpu::transpose::submit_inplace<T> restricted to "
+        "CPU\n";
+    transpose::submit_inplace<T>(n, 0.5, data2_handle);
+    starpu_task_wait_for_all();
+    data2_handle.unregister();
+    // Check result
+    for(Index i = 0; i < n*n; ++i)
+    {
+        TEST_ASSERT(data[i] == data2[i]);
+    }
+    std::cout << "OK: starpu::transpose::submit_inplace<T> restricted to "
+        "CPU\n";
+}
+
 #ifdef NNTILE_USE_CUDA
 template<typename T>
 void validate_cuda(Index m, Index n)
@@ -142,6 +172,8 @@ int main(int argc, char **argv)
     // Bias for middle axis
     validate_cpu<fp32_t>(3, 5);
     validate_cpu<fp64_t>(3, 5);
+    validate_cpu_inplace<fp32_t>(5);
+    validate_cpu_inplace<fp64_t>(5);
 #ifdef NNTILE_USE_CUDA
     validate_cuda<fp32_t>(3, 5);
     validate_cuda<fp64_t>(3, 5);
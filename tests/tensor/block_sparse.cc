@@ -0,0 +1,181 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/block_sparse.cc
+ * Block-sparse tensor and operations, that skip absent tiles
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/block_sparse.hh"
+#include "nntile/tensor/gemm.hh"
+#include "nntile/tensor/gather.hh"
+#include "nntile/tensor/scatter.hh"
+#include "nntile/starpu/gemm.hh"
+#include "nntile/starpu/gemm_grouped.hh"
+#include "nntile/starpu/copy.hh"
+#include "nntile/starpu/clear.hh"
+#include "nntile/starpu/scal_inplace.hh"
+#include "nntile/starpu/subcopy.hh"
+#include "../testing.hh"
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+// Compare two tensors through their single-tiled copies
+template<typename T>
+void check_equal(const Tensor<T> &A, const Tensor<T> &B,
+        const Tensor<T> &A_single, const Tensor<T> &B_single)
+{
+    gather<T>(A, A_single);
+    gather<T>(B, B_single);
+    if(A_single.get_tile_handle(0).mpi_get_rank()
+            != starpu_mpi_world_rank())
+    {
+        return;
+    }
+    auto A_local = A_single.get_tile(0).acquire(STARPU_R),
+         B_local = B_single.get_tile(0).acquire(STARPU_R);
+    for(Index i = 0; i < A_single.nelems; ++i)
+    {
+        T diff = std::abs(A_local[i] - B_local[i]);
+        T norm = std::abs(A_local[i]);
+        TEST_ASSERT(diff <= 10*T(1e-6)*(norm+1));
+    }
+    A_local.release();
+    B_local.release();
+}
+
+template<typename T>
+void check(const TransOp &transA, T beta)
+{
+    // Sync to be sure old tags are destroyed on all nodes
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    int mpi_rank = starpu_mpi_world_rank();
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_root = 0;
+    starpu_mpi_tag_t last_tag = 0;
+    T alpha = -0.5;
+    TransOp opT(TransOp::Trans), opN(TransOp::NoTrans);
+    // Matrices with 3x3 grids of tiles
+    std::vector<Index> sh = {6, 6}, basetile = {2, 2};
+    TensorTraits tr(sh, basetile), tr_single(sh, sh);
+    std::vector<int> dist0 = {mpi_root};
+    Tensor<T> A_single(tr_single, dist0, last_tag),
+        B_single(tr_single, dist0, last_tag),
+        C_single(tr_single, dist0, last_tag),
+        D_single(tr_single, dist0, last_tag);
+    if(mpi_rank == mpi_root)
+    {
+        auto A_local = A_single.get_tile(0).acquire(STARPU_W),
+             B_local = B_single.get_tile(0).acquire(STARPU_W),
+             C_local = C_single.get_tile(0).acquire(STARPU_W);
+        for(Index i = 0; i < A_single.nelems; ++i)
+        {
+            A_local[i] = T(i%7) - T(3);
+            B_local[i] = T(i%5) - T(2);
+            C_local[i] = T(i%3) - T(1);
+        }
+        A_local.release();
+        B_local.release();
+        C_local.release();
+    }
+    std::vector<int> distr(tr.grid.nelems);
+    for(Index i = 0; i < tr.grid.nelems; ++i)
+    {
+        distr[i] = (i+1) % mpi_size;
+    }
+    // The first row of tiles is absent, so the first row of tiles of the
+    // product gets no contributions
+    std::vector<bool> layout = {false, true, false, false, false, true,
+        false, true, true};
+    BlockSparseTensor<T> W(tr, distr, layout, last_tag);
+    TEST_ASSERT(W.nonzero_tiles.size() == 4);
+    TEST_ASSERT(W.nonzero_tiles[0] == 1 and W.nonzero_tiles[3] == 8);
+    TEST_ASSERT(W.is_nonzero(5) and not W.is_nonzero(4));
+    TEST_ASSERT(W.density() == 4.0/9.0);
+    Tensor<T> A(tr, distr, last_tag), B(tr, distr, last_tag),
+        C(tr, distr, last_tag), D(tr, distr, last_tag);
+    scatter<T>(A_single, A);
+    scatter<T>(B_single, B);
+    // Prune A and bring it back into a dense tensor with zeros
+    copy_block_sparse<T>(A, W);
+    copy_block_sparse<T>(W, A);
+    // Products with a block-sparse operand A or B match dense ones
+    for(Index sparse_A = 0; sparse_A < 2; ++sparse_A)
+    {
+        const Tensor<T> &X = sparse_A ? W : B, &Y = sparse_A ? B : W,
+            &X_dense = sparse_A ? A : B, &Y_dense = sparse_A ? B : A;
+        scatter<T>(C_single, C);
+        scatter<T>(C_single, D);
+        gemm<T, T>(alpha, transA, X_dense, opN, Y_dense, beta, C, 1, 0);
+        gemm_block_sparse<T>(alpha, transA, X, opN, Y, beta, D, 1, 0);
+        check_equal<T>(C, D, C_single, D_single);
+    }
+    // Product into a block-sparse tensor matches the same tiles of the
+    // dense product
+    BlockSparseTensor<T> G(tr, distr, layout, last_tag);
+    scatter<T>(C_single, C);
+    copy_block_sparse<T>(C, G);
+    gemm<T, T>(alpha, transA, A, opT, B, beta, C, 1, 0);
+    gemm_block_sparse<T>(alpha, transA, A, opT, B, beta, G, 1, 0);
+    scatter<T>(C_single, D);
+    copy_block_sparse<T>(G, D);
+    copy_block_sparse<T>(C, W);
+    copy_block_sparse<T>(W, C);
+    check_equal<T>(C, D, C_single, D_single);
+    W.unregister();
+    G.unregister();
+}
+
+template<typename T>
+void validate()
+{
+    TransOp opT(TransOp::Trans), opN(TransOp::NoTrans);
+    check<T>(opN, 0);
+    check<T>(opN, 1);
+    check<T>(opT, -2);
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Check throwing exceptions
+    starpu_mpi_tag_t last_tag = 0;
+    std::vector<Index> sh = {4, 4}, sh_ = {4, 2}, basetile = {2, 2};
+    TensorTraits tr(sh, basetile), tr_(sh_, basetile);
+    std::vector<int> distr(4, 0), distr_(2, 0);
+    std::vector<bool> layout = {true, false, false, true};
+    TEST_THROW(BlockSparseTensor<T>(tr, distr_, layout, last_tag));
+    TEST_THROW(BlockSparseTensor<T>(tr, distr, {true}, last_tag));
+    BlockSparseTensor<T> A(tr, distr, layout, last_tag);
+    Tensor<T> B(tr_, distr_, last_tag);
+    TEST_THROW(copy_block_sparse<T>(A, B));
+    TEST_THROW(gemm_block_sparse<T>(1, opN, A, opN, B, 0, A, 1, 0));
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::gemm::init();
+    starpu::gemm_grouped::init();
+    starpu::copy::init();
+    starpu::clear::init();
+    starpu::scal_inplace::init();
+    starpu::subcopy::init();
+    starpu::gemm::restrict_where(STARPU_CPU);
+    starpu::gemm_grouped::restrict_where(STARPU_CPU);
+    starpu::copy::restrict_where(STARPU_CPU);
+    starpu::clear::restrict_where(STARPU_CPU);
+    starpu::scal_inplace::restrict_where(STARPU_CPU);
+    starpu::subcopy::restrict_where(STARPU_CPU);
+    validate<fp32_t>();
+    validate<fp64_t>();
+    return 0;
+}
+
@@ -0,0 +1,166 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/collectives.cc
+ * Hierarchical collective operations over replicas of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/collectives.hh"
+#include "nntile/tensor/gather.hh"
+#include "nntile/tensor/scatter.hh"
+#include "nntile/starpu/add.hh"
+#include "nntile/starpu/copy.hh"
+#include "nntile/starpu/subcopy.hh"
+#include "../testing.hh"
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+// Fill single-tiled tensor with values that depend on a seed
+template<typename T>
+void fill(const Tensor<T> &single, Index seed)
+{
+    if(single.get_tile_handle(0).mpi_get_rank() != starpu_mpi_world_rank())
+    {
+        return;
+    }
+    auto local = single.get_tile(0).acquire(STARPU_W);
+    for(Index i = 0; i < single.nelems; ++i)
+    {
+        local[i] = T((i+seed)%7) - T(3);
+    }
+    local.release();
+}
+
+// Check that a tensor matches values of seeds added together
+template<typename T>
+void check_sum(const Tensor<T> &t, const Tensor<T> &single,
+        const std::vector<Index> &seeds)
+{
+    gather<T>(t, single);
+    if(single.get_tile_handle(0).mpi_get_rank() != starpu_mpi_world_rank())
+    {
+        return;
+    }
+    auto local = single.get_tile(0).acquire(STARPU_R);
+    for(Index i = 0; i < single.nelems; ++i)
+    {
+        T ref = 0;
+        for(Index seed: seeds)
+        {
+            ref += T((i+seed)%7) - T(3);
+        }
+        TEST_ASSERT(local[i] == ref);
+    }
+    local.release();
+}
+
+template<typename T>
+void check(Index nreplicas, Index ranks_per_node)
+{
+    // Sync to be sure old tags are destroyed on all nodes
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    int mpi_size = starpu_mpi_world_size();
+    starpu_mpi_tag_t last_tag = 0;
+    std::vector<Index> sh = {6, 4}, basetile = {2, 3};
+    TensorTraits tr(sh, basetile), tr_single(sh, sh);
+    std::vector<int> dist0 = {0};
+    Tensor<T> single(tr_single, dist0, last_tag);
+    // Every replica is placed onto its own rank
+    std::vector<Tensor<T>> replicas;
+    std::vector<Index> seeds;
+    for(Index r = 0; r < nreplicas; ++r)
+    {
+        std::vector<int> distr(tr.grid.nelems, r%mpi_size);
+        replicas.emplace_back(tr, distr, last_tag);
+        seeds.push_back(r);
+    }
+    auto init = [&]()
+    {
+        for(Index r = 0; r < nreplicas; ++r)
+        {
+            fill<T>(single, r);
+            scatter<T>(single, replicas[r]);
+        }
+    };
+    // Broadcast
+    init();
+    broadcast<T>(replicas, ranks_per_node);
+    for(const auto &t: replicas)
+    {
+        check_sum<T>(t, single, {0});
+    }
+    // Reduce
+    init();
+    reduce<T>(replicas, ranks_per_node);
+    check_sum<T>(replicas[0], single, seeds);
+    // All-reduce
+    init();
+    allreduce<T>(replicas, ranks_per_node);
+    for(const auto &t: replicas)
+    {
+        check_sum<T>(t, single, seeds);
+    }
+    // All-gather of a tensor, distributed over all ranks
+    std::vector<int> distr(tr.grid.nelems);
+    for(Index i = 0; i < tr.grid.nelems; ++i)
+    {
+        distr[i] = i % mpi_size;
+    }
+    Tensor<T> src(tr, distr, last_tag);
+    fill<T>(single, 5);
+    scatter<T>(single, src);
+    init();
+    allgather<T>(src, replicas, ranks_per_node);
+    for(const auto &t: replicas)
+    {
+        check_sum<T>(t, single, {5});
+    }
+}
+
+template<typename T>
+void validate()
+{
+    for(Index nreplicas = 1; nreplicas <= 5; ++nreplicas)
+    {
+        check<T>(nreplicas, 0);
+        check<T>(nreplicas, 2);
+    }
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Check throwing exceptions
+    starpu_mpi_tag_t last_tag = 0;
+    std::vector<Index> sh = {2, 2}, sh_ = {2, 1};
+    TensorTraits tr(sh, sh), tr_(sh, sh_), tr21(sh_, sh_);
+    std::vector<int> dist0 = {0}, dist00 = {0, 0};
+    Tensor<T> A(tr, dist0, last_tag), B(tr_, dist00, last_tag),
+        C(tr21, dist0, last_tag);
+    TEST_THROW(broadcast<T>({}));
+    TEST_THROW(reduce<T>({A, B}));
+    TEST_THROW(allreduce<T>({A, C}));
+    TEST_THROW(allgather<T>(A, {C}));
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::add::init();
+    starpu::copy::init();
+    starpu::subcopy::init();
+    starpu::add::restrict_where(STARPU_CPU);
+    starpu::copy::restrict_where(STARPU_CPU);
+    starpu::subcopy::restrict_where(STARPU_CPU);
+    validate<fp32_t>();
+    validate<fp64_t>();
+    return 0;
+}
+
@@ -0,0 +1,210 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/contract.cc
+ * Contraction of two tensors, described by einsum-like subscripts
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/contract.hh"
+#include "nntile/tensor/gather.hh"
+#include "nntile/tensor/scatter.hh"
+#include "nntile/starpu/gemm.hh"
+#include "nntile/starpu/gemm_grouped.hh"
+#include "nntile/starpu/subcopy.hh"
+#include "nntile/starpu/accumulate.hh"
+#include "../testing.hh"
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+// Shape and base tile of a mode, so that modes are split into tiles with a
+// leftover tile
+static Index mode_shape(char l)
+{
+    return 2 + l%4;
+}
+
+static Index mode_basetile(char l)
+{
+    return (mode_shape(l)+1) / 2;
+}
+
+static TensorTraits traits_of(const std::string &labels, bool single)
+{
+    std::vector<Index> shape(labels.size()), basetile(labels.size());
+    for(Index i = 0; i < labels.size(); ++i)
+    {
+        shape[i] = mode_shape(labels[i]);
+        basetile[i] = single ? shape[i] : mode_basetile(labels[i]);
+    }
+    return TensorTraits(shape, basetile);
+}
+
+// Offset of an element in a contiguous array, given values of all modes
+static Index offset_of(const std::string &labels,
+        const std::vector<Index> &value)
+{
+    Index offset = 0, stride = 1;
+    for(char l: labels)
+    {
+        offset += value[l] * stride;
+        stride *= mode_shape(l);
+    }
+    return offset;
+}
+
+template<typename T>
+void check(const std::string &a, const std::string &b, const std::string &c,
+        T alpha, T beta)
+{
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    starpu_mpi_tag_t last_tag = 0;
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_rank = starpu_mpi_world_rank();
+    int mpi_root = 0;
+    std::vector<int> dist_root = {mpi_root};
+    Tensor<T> A_single(traits_of(a, true), dist_root, last_tag),
+        B_single(traits_of(b, true), dist_root, last_tag),
+        C_single(traits_of(c, true), dist_root, last_tag);
+    std::vector<T> C_ref(C_single.nelems);
+    if(mpi_rank == mpi_root)
+    {
+        auto A_local = A_single.get_tile(0).acquire(STARPU_W),
+             B_local = B_single.get_tile(0).acquire(STARPU_W),
+             C_local = C_single.get_tile(0).acquire(STARPU_W);
+        for(Index i = 0; i < A_single.nelems; ++i)
+        {
+            A_local[i] = T(i%7) - T(3);
+        }
+        for(Index i = 0; i < B_single.nelems; ++i)
+        {
+            B_local[i] = T(i%5) / T(2) - T(1);
+        }
+        for(Index i = 0; i < C_single.nelems; ++i)
+        {
+            C_local[i] = T(i%3);
+            C_ref[i] = beta * C_local[i];
+        }
+        // Reference result by loops over values of all modes
+        std::string modes;
+        for(char l: a+b+c)
+        {
+            if(modes.find(l) == std::string::npos)
+            {
+                modes += l;
+            }
+        }
+        std::vector<Index> value(128, 0);
+        bool done = false;
+        while(not done)
+        {
+            C_ref[offset_of(c, value)] += alpha * A_local[offset_of(a, value)]
+                * B_local[offset_of(b, value)];
+            done = true;
+            for(char l: modes)
+            {
+                if(++value[l] < mode_shape(l))
+                {
+                    done = false;
+                    break;
+                }
+                value[l] = 0;
+            }
+        }
+        A_local.release();
+        B_local.release();
+        C_local.release();
+    }
+    auto distr = [&](const TensorTraits &traits, int shift)
+    {
+        std::vector<int> result(traits.grid.nelems);
+        for(Index i = 0; i < traits.grid.nelems; ++i)
+        {
+            result[i] = (i+shift) % mpi_size;
+        }
+        return result;
+    };
+    TensorTraits A_traits = traits_of(a, false),
+        B_traits = traits_of(b, false), C_traits = traits_of(c, false);
+    Tensor<T> A(A_traits, distr(A_traits, 0), last_tag),
+        B(B_traits, distr(B_traits, 1), last_tag),
+        C(C_traits, distr(C_traits, 2), last_tag);
+    scatter<T>(A_single, A);
+    scatter<T>(B_single, B);
+    scatter<T>(C_single, C);
+    contract<T>(alpha, A, B, beta, C, a+","+b+"->"+c, last_tag);
+    gather<T>(C, C_single);
+    if(mpi_rank == mpi_root)
+    {
+        auto C_local = C_single.get_tile(0).acquire(STARPU_R);
+        for(Index i = 0; i < C_single.nelems; ++i)
+        {
+            T tol = 10 * T(1e-6) * (std::abs(C_ref[i])+1);
+            TEST_ASSERT(std::abs(C_local[i]-C_ref[i]) <= tol);
+        }
+        C_local.release();
+    }
+}
+
+template<typename T>
+void validate()
+{
+    // Layouts of gemm, including transposed and swapped operands
+    check<T>("ik", "kj", "ij", T(1), T(0));
+    check<T>("ki", "kj", "ij", T(-1), T(1));
+    check<T>("ij", "jk", "ki", T(2), T(0));
+    check<T>("abc", "cd", "abd", T(1), T(0));
+    // Contractions, that need permutations of operands
+    check<T>("bac", "cd", "abd", T(1), T(-1));
+    check<T>("hdb", "hdc", "hbc", T(0.5), T(0));
+    check<T>("dhb", "dhc", "bch", T(1), T(2));
+    // Plans do not move data, if layouts of gemm fit
+    auto plan = contract_plan("ij,jk->ki", traits_of("ij", false),
+            traits_of("jk", false), traits_of("ki", false), false);
+    TEST_ASSERT(plan.swap and plan.nelems_moved == 0);
+    TEST_ASSERT(plan.trans_first.value == TransOp::Trans);
+    TEST_ASSERT(plan.trans_second.value == TransOp::Trans);
+    plan = contract_plan("dhb,dhc->bch", traits_of("dhb", false),
+            traits_of("dhc", false), traits_of("bch", false), true);
+    TEST_ASSERT(plan.perm_C.empty() and plan.batch_ndim == 1);
+    TEST_ASSERT(plan.nelems_moved == traits_of("dhb", false).nelems
+            + traits_of("dhc", false).nelems);
+    // Check throwing exceptions
+    auto A = traits_of("ij", false), B = traits_of("jk", false),
+         C = traits_of("ik", false);
+    TEST_THROW(contract_plan("ij,jk", A, B, C, false));
+    TEST_THROW(contract_plan("ij,jk->il", A, B, C, false));
+    TEST_THROW(contract_plan("ii,jk->ik", A, B, C, false));
+    TEST_THROW(contract_plan("i1,jk->ik", A, B, C, false));
+    TEST_THROW(contract_plan("ij,jk->ikl", A, B, C, false));
+    TEST_THROW(contract_plan("ij,ik->ik", A, B, C, false));
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::gemm::init();
+    starpu::gemm_grouped::init();
+    starpu::subcopy::init();
+    starpu::accumulate::init();
+    starpu::gemm::restrict_where(STARPU_CPU);
+    starpu::gemm_grouped::restrict_where(STARPU_CPU);
+    starpu::subcopy::restrict_where(STARPU_CPU);
+    starpu::accumulate::restrict_where(STARPU_CPU);
+    // Launch all tests
+    validate<fp32_t>();
+    validate<fp64_t>();
+    return 0;
+}
+
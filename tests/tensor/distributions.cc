@@ -46,6 +46,11 @@ void validate()
     TEST_THROW(block_cyclic(tensor_grid3, mpi_grid2, start_rank, max_rank3));
     TEST_THROW(block_cyclic(tensor_grid2, mpi_grid2, -1, 1));
     TEST_THROW(block_cyclic(tensor_grid2, mpi_grid2, 1, 1));
+    // Tiles of every MPI node are spread over its devices
+    std::vector<int> devices({0, 0, 1, 2, 1, 0});
+    TEST_ASSERT(devices == local_cyclic({1, 0, 1, 1, 0, 1}, 3));
+    TEST_ASSERT(std::vector<int>(4, 0) == local_cyclic({0, 1, 2, 3}, 2));
+    TEST_THROW(local_cyclic({0, 1}, 0));
 }
 
 int main(int argc, char ** argv)
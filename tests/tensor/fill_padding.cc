@@ -0,0 +1,129 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/fill_padding.cc
+ * Fill padding of a tensor beyond its logical shape
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/fill_padding.hh"
+#include "nntile/starpu/fill_padding.hh"
+#include "nntile/tensor/gather.hh"
+#include "nntile/tensor/scatter.hh"
+#include "nntile/starpu/subcopy.hh"
+#include "nntile/starpu/copy.hh"
+#include "../testing.hh"
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+template<typename T>
+void check(const std::vector<Index> &shape, const std::vector<Index> &basetile)
+{
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Some preparation
+    T val = -0.5;
+    starpu_mpi_tag_t last_tag = 0;
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_rank = starpu_mpi_world_rank();
+    int mpi_root = 0;
+    // Padded tensor consists of uniform tiles
+    auto padded = padded_shape(shape, basetile);
+    TensorTraits traits(padded, basetile);
+    TEST_ASSERT(traits.leftover_shape == basetile);
+    // Generate single-tile tensor
+    TensorTraits single_traits(padded, padded);
+    std::vector<int> dist_root = {mpi_root};
+    Tensor<T> single(single_traits, dist_root, last_tag);
+    if(mpi_rank == mpi_root)
+    {
+        auto tile = single.get_tile(0);
+        auto tile_local = tile.acquire(STARPU_W);
+        for(Index i = 0; i < tile.nelems; ++i)
+        {
+            tile_local[i] = T(i);
+        }
+        tile_local.release();
+    }
+    // Generate distributed-tile tensor
+    std::vector<int> distr(traits.grid.nelems);
+    for(Index i = 0; i < traits.grid.nelems; ++i)
+    {
+        distr[i] = (i+1) % mpi_size;
+    }
+    Tensor<T> A(traits, distr, last_tag);
+    scatter<T>(single, A);
+    fill_padding<T>(val, shape, A);
+    gather<T>(A, single);
+    // Compare results
+    if(mpi_rank == mpi_root)
+    {
+        auto tile = single.get_tile(0);
+        auto tile_local = tile.acquire(STARPU_R);
+        std::vector<Index> index(tile.ndim, 0);
+        for(Index i = 0; i < tile.nelems; ++i)
+        {
+            bool padding = false;
+            for(Index j = 0; j < tile.ndim; ++j)
+            {
+                padding = padding or index[j] >= shape[j];
+            }
+            if(padding)
+            {
+                TEST_ASSERT(tile_local[i] == val);
+            }
+            else
+            {
+                TEST_ASSERT(tile_local[i] == T(i));
+            }
+            tile.next_index(index);
+        }
+        tile_local.release();
+    }
+}
+
+template<typename T>
+void validate()
+{
+    check<T>({5}, {5});
+    check<T>({11}, {5});
+    check<T>({11, 12, 13}, {5, 6, 7});
+    check<T>({4, 12, 3}, {5, 5, 2});
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Check throwing exceptions
+    starpu_mpi_tag_t last_tag = 0;
+    TEST_THROW(padded_shape({10}, {5, 5}));
+    TEST_THROW(padded_shape({0}, {5}));
+    TensorTraits traits({10, 10}, {5, 5});
+    std::vector<int> distr(traits.grid.nelems, 0);
+    Tensor<T> A(traits, distr, last_tag);
+    TEST_THROW(fill_padding<T>(0, {10}, A));
+    TEST_THROW(fill_padding<T>(0, {11, 10}, A));
+    TEST_THROW(fill_padding<T>(0, {-1, 10}, A));
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::fill_padding::init();
+    starpu::subcopy::init();
+    starpu::copy::init();
+    starpu::fill_padding::restrict_where(STARPU_CPU);
+    starpu::subcopy::restrict_where(STARPU_CPU);
+    starpu::copy::restrict_where(STARPU_CPU);
+    // Launch all tests
+    validate<fp32_t>();
+    validate<fp64_t>();
+    return 0;
+}
+
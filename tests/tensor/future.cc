@@ -0,0 +1,81 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/future.cc
+ * Future of values of tensors, that waits only for their tasks
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/future.hh"
+#include "nntile/tensor/clear.hh"
+#include "nntile/starpu/clear.hh"
+#include "../testing.hh"
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+template<typename T>
+void validate()
+{
+    // Sync to be sure old tags are destroyed on all nodes
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    int mpi_rank = starpu_mpi_world_rank();
+    int mpi_size = starpu_mpi_world_size();
+    starpu_mpi_tag_t last_tag = 0;
+    std::vector<Index> sh = {6, 5}, basetile = {2, 3};
+    TensorTraits tr(sh, basetile);
+    std::vector<int> distr(tr.grid.nelems);
+    for(Index i = 0; i < tr.grid.nelems; ++i)
+    {
+        distr[i] = i % mpi_size;
+    }
+    Tensor<T> A(tr, distr, last_tag), B(tr, distr, last_tag);
+    // Future, that waits for nothing, is ready
+    TensorFuture empty;
+    TEST_ASSERT(empty.is_ready());
+    empty.wait();
+    // Wait for values of a single tensor
+    clear_async<T>(A);
+    auto future = await_tensor<T>(A);
+    future.wait();
+    TEST_ASSERT(future.is_ready());
+    for(Index i = 0; i < tr.grid.nelems; ++i)
+    {
+        if(distr[i] != mpi_rank)
+        {
+            continue;
+        }
+        auto tile = A.get_tile(i);
+        auto tile_local = tile.acquire(STARPU_R);
+        for(Index j = 0; j < tile.nelems; ++j)
+        {
+            TEST_ASSERT(tile_local[j] == T(0));
+        }
+        tile_local.release();
+    }
+    // Wait for values of several tensors, while the future is not kept
+    clear_async<T>(B);
+    await_tensors<T>({A, B}).wait();
+    await_tensor<T>(B);
+    A.unregister();
+    B.unregister();
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::clear::init();
+    starpu::clear::restrict_where(STARPU_CPU);
+    validate<fp32_t>();
+    validate<fp64_t>();
+    return 0;
+}
+
@@ -13,11 +13,15 @@
  * */
 
 #include "nntile/tensor/gemm.hh"
+#include "nntile/tensor/tree_reduction.hh"
+#include "nntile/tensor/aggregate.hh"
 #include "nntile/tile/gemm.hh"
 #include "nntile/tensor/gather.hh"
 #include "nntile/tensor/scatter.hh"
 #include "nntile/starpu/gemm.hh"
+#include "nntile/starpu/gemm_grouped.hh"
 #include "nntile/starpu/subcopy.hh"
+#include "nntile/starpu/accumulate.hh"
 #include "../testing.hh"
 
 using namespace nntile;
@@ -213,12 +217,162 @@ void check()
         C_single_local.release();
         D_single_local.release();
     }
+    // Check tree reduction with beta=1
+    if(mpi_rank == mpi_root)
+    {
+        tile::gemm<T>(one, opT, A_single_tile, opN, B_single_tile, one,
+                C_single_tile, 2, 1);
+    }
+    tensor::gemm<T>(one, opT, A, opN, B, one, D, 2, 1, redux_tree);
+    gather<T>(D, D_single);
+    if(mpi_rank == mpi_root)
+    {
+        auto C_single_local = C_single_tile.acquire(STARPU_R);
+        auto D_single_local = D_single_tile.acquire(STARPU_R);
+        for(Index i = 0; i < D.nelems; ++i)
+        {
+            TEST_ASSERT(C_single_local[i] == D_single_local[i]);
+        }
+        C_single_local.release();
+        D_single_local.release();
+    }
+    // Check split of contracted dimensions into 2 chains with beta=-1
+    if(mpi_rank == mpi_root)
+    {
+        tile::gemm<T>(one, opT, A_single_tile, opN, B_single_tile, mone,
+                C_single_tile, 2, 1);
+    }
+    tensor::set_gemm_split_k(2*D.grid.nelems);
+    tensor::gemm<T>(one, opT, A, opN, B, mone, D, 2, 1);
+    tensor::set_gemm_split_k(0);
+    gather<T>(D, D_single);
+    if(mpi_rank == mpi_root)
+    {
+        auto C_single_local = C_single_tile.acquire(STARPU_R);
+        auto D_single_local = D_single_tile.acquire(STARPU_R);
+        for(Index i = 0; i < D.nelems; ++i)
+        {
+            TEST_ASSERT(C_single_local[i] == D_single_local[i]);
+        }
+        C_single_local.release();
+        D_single_local.release();
+    }
+    TEST_THROW(tensor::set_gemm_split_k(-1));
+}
+
+// Split of tiles of C between CPU and CUDA workers with a fixed share
+template<typename T>
+void check_hetero()
+{
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    int mpi_rank = starpu_mpi_world_rank();
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_root = 0;
+    starpu_mpi_tag_t last_tag = 0;
+    TransOp opT(TransOp::Trans), opN(TransOp::NoTrans);
+    T one = 1, mone = -1;
+    std::vector<Index> shA = {4, 6}, shAT = {6, 4}, shB = {6, 7},
+        shC = {4, 7};
+    TensorTraits trA(shA, shA), trAT(shAT, shAT), trB(shB, shB),
+        trC(shC, shC);
+    std::vector<int> dist0 = {mpi_root};
+    Tensor<T> A_single(trA, dist0, last_tag),
+        AT_single(trAT, dist0, last_tag),
+        B_single(trB, dist0, last_tag),
+        C_single(trC, dist0, last_tag),
+        D_single(trC, dist0, last_tag);
+    auto A_single_tile = A_single.get_tile(0),
+         AT_single_tile = AT_single.get_tile(0),
+         B_single_tile = B_single.get_tile(0),
+         C_single_tile = C_single.get_tile(0),
+         D_single_tile = D_single.get_tile(0);
+    if(mpi_rank == mpi_root)
+    {
+        auto A_local = A_single_tile.acquire(STARPU_W),
+             AT_local = AT_single_tile.acquire(STARPU_W),
+             B_local = B_single_tile.acquire(STARPU_W),
+             C_local = C_single_tile.acquire(STARPU_W),
+             D_local = D_single_tile.acquire(STARPU_W);
+        for(Index i = 0; i < A_single.nelems; ++i)
+        {
+            A_local[i] = T(i%5) - T(2);
+            AT_local[i] = T(i%3) + T(1);
+        }
+        for(Index i = 0; i < B_single.nelems; ++i)
+        {
+            B_local[i] = T(i%7) - T(3);
+        }
+        for(Index i = 0; i < C_single.nelems; ++i)
+        {
+            C_local[i] = T(i%4);
+            D_local[i] = C_local[i];
+        }
+        A_local.release();
+        AT_local.release();
+        B_local.release();
+        C_local.release();
+        D_local.release();
+    }
+    // Tiles of C of 2 or 3 columns are split, a tile of 1 column is not
+    std::vector<Index> tileA = {2, 3}, tileAT = {3, 2}, tileB = {3, 3},
+        tileC = {2, 3};
+    TensorTraits trA_(shA, tileA), trAT_(shAT, tileAT), trB_(shB, tileB),
+        trC_(shC, tileC);
+    std::vector<int> distA(trA_.grid.nelems), distB(trB_.grid.nelems),
+        distC(trC_.grid.nelems);
+    for(Index i = 0; i < distA.size(); ++i)
+    {
+        distA[i] = i % mpi_size;
+    }
+    for(Index i = 0; i < distB.size(); ++i)
+    {
+        distB[i] = (i+1) % mpi_size;
+    }
+    for(Index i = 0; i < distC.size(); ++i)
+    {
+        distC[i] = (i+2) % mpi_size;
+    }
+    Tensor<T> A(trA_, distA, last_tag), AT(trAT_, distA, last_tag),
+        B(trB_, distB, last_tag), D(trC_, distC, last_tag);
+    scatter<T>(A_single, A);
+    scatter<T>(AT_single, AT);
+    scatter<T>(B_single, B);
+    scatter<T>(D_single, D);
+    tensor::set_gemm_hetero(true, 0.5);
+    TEST_ASSERT(tensor::get_gemm_hetero());
+    // Check beta=-1 and beta=1 with both transpositions of A
+    if(mpi_rank == mpi_root)
+    {
+        tile::gemm<T>(one, opN, A_single_tile, opN, B_single_tile, mone,
+                C_single_tile, 1, 0);
+        tile::gemm<T>(mone, opT, AT_single_tile, opN, B_single_tile, one,
+                C_single_tile, 1, 0);
+    }
+    tensor::gemm<T>(one, opN, A, opN, B, mone, D, 1, 0);
+    tensor::gemm<T>(mone, opT, AT, opN, B, one, D, 1, 0);
+    tensor::set_gemm_hetero(false);
+    TEST_ASSERT(not tensor::get_gemm_hetero());
+    gather<T>(D, D_single);
+    if(mpi_rank == mpi_root)
+    {
+        auto C_local = C_single_tile.acquire(STARPU_R);
+        auto D_local = D_single_tile.acquire(STARPU_R);
+        for(Index i = 0; i < D.nelems; ++i)
+        {
+            TEST_ASSERT(C_local[i] == D_local[i]);
+        }
+        C_local.release();
+        D_local.release();
+    }
+    TEST_THROW(tensor::set_gemm_hetero(true, -0.5));
+    TEST_THROW(tensor::set_gemm_hetero(true, 1));
 }
 
 template<typename T>
 void validate()
 {
     check<T>();
+    check_hetero<T>();
     // Barrier to wait for cleanup of previously used tags
     starpu_mpi_barrier(MPI_COMM_WORLD);
     // Check throwing exceptions
@@ -283,12 +437,32 @@ int main(int argc, char **argv)
     starpu::Config starpu(1, 0, 0);
     // Init codelet
     starpu::gemm::init();
+    starpu::gemm_grouped::init();
     starpu::subcopy::init();
+    starpu::accumulate::init();
     starpu::gemm::restrict_where(STARPU_CPU);
+    starpu::gemm_grouped::restrict_where(STARPU_CPU);
     starpu::subcopy::restrict_where(STARPU_CPU);
-    // Launch all tests
+    starpu::accumulate::restrict_where(STARPU_CPU);
+    // Launch all tests with strict order of accumulating tasks
+    starpu::Config::commute_disable();
+    validate<fp32_t>();
+    validate<fp64_t>();
+    // Launch all tests once again with commute mode, results must not change
+    starpu::Config::commute_enable();
+    validate<fp32_t>();
+    validate<fp64_t>();
+    // Launch all tests in deterministic mode of reductions
+    starpu::Config::deterministic_enable();
+    validate<fp32_t>();
+    validate<fp64_t>();
+    starpu::Config::deterministic_disable();
+    // Launch all tests without grouping of tiny tiles into grouped tasks
+    Index aggregate_nelems = get_aggregate_nelems();
+    set_aggregate_nelems(0);
     validate<fp32_t>();
     validate<fp64_t>();
+    set_aggregate_nelems(aggregate_nelems);
     return 0;
 }
 
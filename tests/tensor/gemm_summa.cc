@@ -0,0 +1,147 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/gemm_summa.cc
+ * Communication-avoiding distributed GEMM for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-15
+ * */
+
+#include "nntile/tensor/gemm_summa.hh"
+#include "nntile/tensor/gemm.hh"
+#include "nntile/tensor/gather.hh"
+#include "nntile/tensor/scatter.hh"
+#include "nntile/tensor/distributions.hh"
+#include "nntile/starpu/gemm.hh"
+#include "nntile/starpu/gemm_grouped.hh"
+#include "nntile/starpu/add.hh"
+#include "nntile/starpu/subcopy.hh"
+#include "../testing.hh"
+#include <cmath>
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+template<typename T>
+void check(const TransOp &transA, const TransOp &transB, T beta,
+        Index nreplicas)
+{
+    // Sync to be sure old tags are destroyed on all nodes
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    int mpi_rank = starpu_mpi_world_rank();
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_root = 0;
+    starpu_mpi_tag_t last_tag = 0;
+    T alpha = -0.5;
+    // Matrices with 3x3 grids of tiles and a batch of 2 tiles
+    std::vector<Index> sh = {6, 6, 4}, basetile = {2, 2, 2};
+    TensorTraits tr(sh, basetile), tr_single(sh, sh);
+    std::vector<int> dist0 = {mpi_root};
+    Tensor<T> A_single(tr_single, dist0, last_tag),
+        B_single(tr_single, dist0, last_tag),
+        C_single(tr_single, dist0, last_tag);
+    if(mpi_rank == mpi_root)
+    {
+        auto A_local = A_single.get_tile(0).acquire(STARPU_W),
+             B_local = B_single.get_tile(0).acquire(STARPU_W),
+             C_local = C_single.get_tile(0).acquire(STARPU_W);
+        for(Index i = 0; i < A_single.nelems; ++i)
+        {
+            A_local[i] = T(i%7) - T(3);
+            B_local[i] = T(i%5) - T(2);
+            C_local[i] = T(i%3) - T(1);
+        }
+        A_local.release();
+        B_local.release();
+        C_local.release();
+    }
+    // Block-cyclic distribution of all the layers
+    std::vector<int> mpi_grid = {2, 2, 1};
+    auto distr = distributions::block_cyclic(tr.grid.shape, mpi_grid, 0,
+            mpi_size);
+    Tensor<T> A(tr, distr, last_tag), B(tr, distr, last_tag),
+        C(tr, distr, last_tag), D(tr, distr, last_tag);
+    std::vector<Tensor<T>> replicas;
+    for(Index r = 1; r <= nreplicas; ++r)
+    {
+        auto replica_distr = distributions::block_cyclic(tr.grid.shape,
+                mpi_grid, (4*r)%mpi_size, mpi_size);
+        replicas.emplace_back(tr, replica_distr, last_tag);
+    }
+    scatter<T>(A_single, A);
+    scatter<T>(B_single, B);
+    scatter<T>(C_single, C);
+    scatter<T>(C_single, D);
+    // Reference result by the simple gemm
+    gemm<T, T>(alpha, transA, A, transB, B, beta, C, 1, 1);
+    gemm_summa<T>(alpha, transA, A, transB, B, beta, D, 1, 1, replicas);
+    gather<T>(C, A_single);
+    gather<T>(D, B_single);
+    if(mpi_rank == mpi_root)
+    {
+        auto C_local = A_single.get_tile(0).acquire(STARPU_R),
+             D_local = B_single.get_tile(0).acquire(STARPU_R);
+        for(Index i = 0; i < C.nelems; ++i)
+        {
+            // Values are small integers, only the order of summation
+            // differs
+            TEST_ASSERT(std::abs(C_local[i]-D_local[i]) <= 1e-5);
+        }
+        C_local.release();
+        D_local.release();
+    }
+}
+
+template<typename T>
+void validate()
+{
+    TransOp opT(TransOp::Trans), opN(TransOp::NoTrans);
+    for(Index nreplicas = 0; nreplicas <= 3; ++nreplicas)
+    {
+        check<T>(opN, opN, 0, nreplicas);
+        check<T>(opT, opN, 1, nreplicas);
+        check<T>(opN, opT, -1, nreplicas);
+        check<T>(opT, opT, 2, nreplicas);
+    }
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Check throwing exceptions on wrong replicas
+    starpu_mpi_tag_t last_tag = 0;
+    TransOp opN_(TransOp::NoTrans);
+    T one = 1;
+    std::vector<Index> shape22 = {2, 2}, shape21 = {2, 1};
+    TensorTraits tr22(shape22, shape22), tr22_(shape22, shape21),
+        tr21(shape21, shape21);
+    std::vector<int> dist0 = {0}, dist00 = {0, 0};
+    Tensor<T> mat22(tr22, dist0, last_tag), mat22_(tr22_, dist00, last_tag),
+        mat21(tr21, dist0, last_tag);
+    TEST_THROW(gemm_summa<T>(one, opN_, mat22, opN_, mat22, one, mat22, 1, 0,
+                {mat21}));
+    TEST_THROW(gemm_summa<T>(one, opN_, mat22, opN_, mat22, one, mat22, 1, 0,
+                {mat22_}));
+    TEST_THROW(gemm_summa<T>(one, opN_, mat22, opN_, mat21, one, mat22, 1, 0));
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::gemm::init();
+    starpu::gemm_grouped::init();
+    starpu::add::init();
+    starpu::subcopy::init();
+    starpu::gemm::restrict_where(STARPU_CPU);
+    starpu::gemm_grouped::restrict_where(STARPU_CPU);
+    starpu::add::restrict_where(STARPU_CPU);
+    starpu::subcopy::restrict_where(STARPU_CPU);
+    validate<fp32_t>();
+    validate<fp64_t>();
+    return 0;
+}
+
@@ -0,0 +1,90 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/hierarchical.cc
+ * Tensor with two levels of tiles
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/hierarchical.hh"
+#include "nntile/tensor/fill.hh"
+#include "nntile/tensor/scal_inplace.hh"
+#include "nntile/starpu/fill.hh"
+#include "nntile/starpu/scal_inplace.hh"
+#include "../testing.hh"
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+template<typename T>
+void validate()
+{
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    starpu_mpi_tag_t last_tag = 0;
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_rank = starpu_mpi_world_rank();
+    TensorTraits traits({3, 12}, {3, 6});
+    std::vector<int> distr = {0, 1%mpi_size};
+    {
+        HierarchicalTensor<T> A(traits, distr, 2, last_tag);
+        TEST_ASSERT(A.level() == TileLevel::Node);
+        TEST_ASSERT(A.node().grid.shape[1] == 2);
+        // Elementwise operation on device tiles
+        const auto &device = A.device();
+        TEST_ASSERT(A.level() == TileLevel::Device);
+        TEST_ASSERT(device.grid.shape[1] == 6);
+        TEST_ASSERT(device.basetile_shape[1] == 2);
+        for(Index i = 0; i < device.grid.nelems; ++i)
+        {
+            TEST_ASSERT(device.tile_distr[i] == distr[i/3]);
+        }
+        fill_async<T>(T(-0.5), device);
+        // Another operation on node tiles, ordered after the previous one
+        const auto &node = A.node();
+        TEST_ASSERT(A.level() == TileLevel::Node);
+        scal_inplace_async<T>(T(3), node);
+        for(Index i = 0; i < node.grid.nelems; ++i)
+        {
+            if(node.tile_distr[i] == mpi_rank)
+            {
+                auto tile = node.get_tile(i);
+                auto tile_local = tile.acquire(STARPU_R);
+                for(Index j = 0; j < tile.nelems; ++j)
+                {
+                    TEST_ASSERT(tile_local[j] == T(-1.5));
+                }
+                tile_local.release();
+            }
+        }
+        // Destructor switches back to node tiles
+        A.device();
+    }
+    starpu_task_wait_for_all();
+    // Base tile of device tiles shall divide base tile of node tiles
+    TEST_THROW(HierarchicalTensor<T>(traits, distr, 4, last_tag));
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::fill::init();
+    starpu::scal_inplace::init();
+    starpu::fill::restrict_where(STARPU_CPU);
+    starpu::scal_inplace::restrict_where(STARPU_CPU);
+    // Launch all tests
+    validate<fp32_t>();
+    validate<fp64_t>();
+    return 0;
+}
+
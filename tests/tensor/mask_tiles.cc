@@ -0,0 +1,99 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/mask_tiles.cc
+ * Classification of tiles of a boolean mask of attention
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/mask_tiles.hh"
+#include "nntile/tensor/scatter.hh"
+#include "nntile/starpu/subcopy.hh"
+#include "nntile/starpu/copy.hh"
+#include "../testing.hh"
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+// Check kinds of tiles of a causal mask
+void check(Index seq, Index seq_tile)
+{
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    starpu_mpi_tag_t last_tag = 0;
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_rank = starpu_mpi_world_rank();
+    int mpi_root = 0;
+    // Causal mask: key k is seen by query q if k <= q
+    std::vector<Index> shape{seq, seq}, basetile{seq_tile, seq_tile};
+    TensorTraits single_traits(shape, shape);
+    std::vector<int> dist_root = {mpi_root};
+    Tensor<bool_t> single(single_traits, dist_root, last_tag);
+    if(mpi_rank == mpi_root)
+    {
+        auto tile = single.get_tile(0);
+        auto tile_local = tile.acquire(STARPU_W);
+        for(Index q = 0; q < seq; ++q)
+        {
+            for(Index k = 0; k < seq; ++k)
+            {
+                tile_local[q*seq+k] = bool_t(k <= q);
+            }
+        }
+        tile_local.release();
+    }
+    TensorTraits mask_traits(shape, basetile);
+    std::vector<int> mask_distr(mask_traits.grid.nelems);
+    for(Index i = 0; i < mask_traits.grid.nelems; ++i)
+    {
+        mask_distr[i] = (i+1) % mpi_size;
+    }
+    Tensor<bool_t> mask(mask_traits, mask_distr, last_tag);
+    scatter<bool_t>(single, mask);
+    // Every node gets the same kinds of tiles
+    auto kinds = mask_tiles(mask);
+    TEST_ASSERT(kinds.size() == mask.grid.nelems);
+    for(Index i = 0; i < mask.grid.nelems; ++i)
+    {
+        auto index = mask.grid.linear_to_index(i);
+        Index k_start = index[0] * seq_tile, q_start = index[1] * seq_tile;
+        Index k_end = std::min(k_start+seq_tile, seq) - 1;
+        Index q_end = std::min(q_start+seq_tile, seq) - 1;
+        MaskTile kind = MaskTile::partial;
+        if(k_start > q_end)
+        {
+            kind = MaskTile::empty;
+        }
+        else if(k_end <= q_start)
+        {
+            kind = MaskTile::full;
+        }
+        TEST_ASSERT(kinds[i] == kind);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::subcopy::init();
+    starpu::copy::init();
+    starpu::subcopy::restrict_where(STARPU_CPU);
+    starpu::copy::restrict_where(STARPU_CPU);
+    // Launch all tests
+    check(1, 1);
+    check(8, 8);
+    check(16, 4);
+    check(10, 3);
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    return 0;
+}
+
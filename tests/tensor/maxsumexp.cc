@@ -17,6 +17,8 @@
 #include "nntile/tile/maxsumexp.hh"
 #include "nntile/tile/clear.hh"
 #include "nntile/starpu/maxsumexp.hh"
+#include "nntile/starpu/accumulate_maxsumexp.hh"
+#include "nntile/tensor/tree_reduction.hh"
 #include "nntile/tensor/scatter.hh"
 #include "nntile/tensor/gather.hh"
 #include "nntile/starpu/subcopy.hh"
@@ -30,7 +32,7 @@ using namespace nntile::tensor;
 
 template<typename T>
 void check(const std::vector<Index> &shape, const std::vector<Index> &basetile,
-        Index axis)
+        Index axis, int redux=0)
 {
     // Barrier to wait for cleanup of previously used tags
     starpu_mpi_barrier(MPI_COMM_WORLD);
@@ -83,7 +85,7 @@ void check(const std::vector<Index> &shape, const std::vector<Index> &basetile,
     Tensor<T> dst(dst_traits, dst_distr, last_tag);
     // Perform tensor-wise and tile-wise maxsumexp operations
     clear<T>(dst);
-    maxsumexp<T>(src, dst, axis);
+    maxsumexp<T>(src, dst, axis, redux);
     if(mpi_rank == mpi_root)
     {
         tile::clear(dst_single.get_tile(0));
@@ -118,6 +120,9 @@ void validate()
     check<T>({11, 12, 13}, {5, 6, 5}, 0);
     check<T>({11, 12, 13}, {5, 6, 5}, 1);
     check<T>({11, 12, 13}, {5, 6, 5}, 2);
+    // Explicit tree reduction over many source tiles
+    check<T>({11, 12}, {2, 6}, 0, redux_tree);
+    check<T>({11, 12, 13}, {5, 6, 2}, 2, redux_tree);
     // Sync to guarantee old data tags are cleaned up and can be reused
     starpu_mpi_barrier(MPI_COMM_WORLD);
     // Check throwing exceptions
@@ -149,10 +154,12 @@ int main(int argc, char **argv)
     starpu::Config starpu(1, 0, 0);
     // Init codelet
     starpu::maxsumexp::init();
+    starpu::accumulate_maxsumexp::init();
     starpu::subcopy::init();
     starpu::copy::init();
     starpu::clear::init();
     starpu::maxsumexp::restrict_where(STARPU_CPU);
+    starpu::accumulate_maxsumexp::restrict_where(STARPU_CPU);
     starpu::subcopy::restrict_where(STARPU_CPU);
     starpu::copy::restrict_where(STARPU_CPU);
     starpu::clear::restrict_where(STARPU_CPU);
@@ -16,6 +16,8 @@
 #include "nntile/tile/norm_slice.hh"
 #include "nntile/tile/clear.hh"
 #include "nntile/starpu/norm_slice.hh"
+#include "nntile/starpu/accumulate_hypot.hh"
+#include "nntile/tensor/tree_reduction.hh"
 #include "nntile/tensor/scatter.hh"
 #include "nntile/tensor/gather.hh"
 #include "nntile/starpu/subcopy.hh"
@@ -29,7 +31,7 @@ using namespace nntile::tensor;
 
 template<typename T>
 void check(const std::vector<Index> &shape, const std::vector<Index> &basetile,
-        Index axis)
+        Index axis, int redux=0)
 {
     T alpha = -1.0, beta = 0.5;
     // Barrier to wait for cleanup of previously used tags
@@ -95,7 +97,7 @@ void check(const std::vector<Index> &shape, const std::vector<Index> &basetile,
     Tensor<T> dst(dst_traits, dst_distr, last_tag);
     scatter<T>(dst_single, dst);
     // Perform tensor-wise and tile-wise norm_slice operations
-    norm_slice<T>(alpha, src, beta, dst, axis);
+    norm_slice<T>(alpha, src, beta, dst, axis, redux);
     if(mpi_rank == mpi_root)
     {
         tile::norm_slice<T>(alpha, src_single.get_tile(0), beta,
@@ -130,6 +132,9 @@ void validate()
     check<T>({11, 12, 13}, {5, 6, 5}, 0);
     check<T>({11, 12, 13}, {5, 6, 5}, 1);
     check<T>({11, 12, 13}, {5, 6, 5}, 2);
+    // Explicit tree reduction over many source tiles
+    check<T>({11, 12}, {2, 6}, 0, redux_tree);
+    check<T>({11, 12, 13}, {5, 6, 2}, 2, redux_tree);
     // Sync to guarantee old data tags are cleaned up and can be reused
     starpu_mpi_barrier(MPI_COMM_WORLD);
     // Check throwing exceptions
@@ -161,10 +166,12 @@ int main(int argc, char **argv)
     starpu::Config starpu(1, 0, 0);
     // Init codelet
     starpu::norm_slice::init();
+    starpu::accumulate_hypot::init();
     starpu::subcopy::init();
     starpu::copy::init();
     starpu::clear::init();
     starpu::norm_slice::restrict_where(STARPU_CPU);
+    starpu::accumulate_hypot::restrict_where(STARPU_CPU);
     starpu::subcopy::restrict_where(STARPU_CPU);
     starpu::copy::restrict_where(STARPU_CPU);
     starpu::clear::restrict_where(STARPU_CPU);
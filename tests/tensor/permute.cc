@@ -0,0 +1,102 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/permute.cc
+ * Permutation of axes of Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/permute.hh"
+#include "nntile/tensor/gather.hh"
+#include "nntile/tensor/scatter.hh"
+#include "nntile/starpu/subcopy.hh"
+#include "../testing.hh"
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+template<typename T>
+void validate()
+{
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    starpu_mpi_tag_t last_tag = 0;
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_rank = starpu_mpi_world_rank();
+    int mpi_root = 0;
+    std::vector<Index> shape = {3, 4, 5}, basetile = {2, 3, 2},
+        perm = {2, 0, 1}, dst_shape = {5, 3, 4}, dst_basetile = {2, 2, 3};
+    TensorTraits src_single_traits(shape, shape),
+        dst_single_traits(dst_shape, dst_shape),
+        src_traits(shape, basetile), dst_traits(dst_shape, dst_basetile);
+    std::vector<int> dist_root = {mpi_root};
+    Tensor<T> src_single(src_single_traits, dist_root, last_tag),
+        dst_single(dst_single_traits, dist_root, last_tag);
+    if(mpi_rank == mpi_root)
+    {
+        auto tile_local = src_single.get_tile(0).acquire(STARPU_W);
+        for(Index i = 0; i < src_single.nelems; ++i)
+        {
+            tile_local[i] = T(i);
+        }
+        tile_local.release();
+    }
+    // Distribute tiles of src and dst differently
+    std::vector<int> src_distr(src_traits.grid.nelems),
+        dst_distr(dst_traits.grid.nelems);
+    for(Index i = 0; i < src_traits.grid.nelems; ++i)
+    {
+        src_distr[i] = i % mpi_size;
+    }
+    for(Index i = 0; i < dst_traits.grid.nelems; ++i)
+    {
+        dst_distr[i] = (i+1) % mpi_size;
+    }
+    Tensor<T> src(src_traits, src_distr, last_tag),
+        dst(dst_traits, dst_distr, last_tag);
+    scatter<T>(src_single, src);
+    permute<T>(src, dst, perm);
+    gather<T>(dst, dst_single);
+    if(mpi_rank == mpi_root)
+    {
+        auto tile_local = dst_single.get_tile(0).acquire(STARPU_R);
+        for(Index i0 = 0; i0 < shape[0]; ++i0)
+        {
+            for(Index i1 = 0; i1 < shape[1]; ++i1)
+            {
+                for(Index i2 = 0; i2 < shape[2]; ++i2)
+                {
+                    Index src_i = i0 + shape[0]*(i1+shape[1]*i2);
+                    Index dst_i = i2 + dst_shape[0]*(i0+dst_shape[1]*i1);
+                    TEST_ASSERT(tile_local[dst_i] == T(src_i));
+                }
+            }
+        }
+        tile_local.release();
+    }
+    // Check throwing exceptions
+    TEST_THROW(permute<T>(src, dst, {2, 1, 0}));
+    TEST_THROW(permute<T>(src, dst, {2, 0, 0}));
+    TEST_THROW(permute<T>(src, dst, {2, 0}));
+    TEST_THROW(permute<T>(src, src, perm));
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::subcopy::init();
+    starpu::subcopy::restrict_where(STARPU_CPU);
+    // Launch all tests
+    validate<fp32_t>();
+    validate<fp64_t>();
+    return 0;
+}
+
@@ -0,0 +1,142 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/redistribute.cc
+ * Redistribute operation for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-02-09
+ * */
+
+#include "nntile/tensor/redistribute.hh"
+#include "nntile/starpu/subcopy.hh"
+#include "../testing.hh"
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+template<typename T>
+void check(const std::vector<Index> &shape,
+        const std::vector<Index> &src_basetile,
+        const std::vector<Index> &dst_basetile)
+{
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Some preparation
+    starpu_mpi_tag_t last_tag = 0;
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_rank = starpu_mpi_world_rank();
+    // Traits of source and destination tensors
+    TensorTraits src_traits(shape, src_basetile),
+                 dst_traits(shape, dst_basetile);
+    // Distributions for source and destination tiles
+    Index src_ntiles = src_traits.grid.nelems;
+    Index dst_ntiles = dst_traits.grid.nelems;
+    std::vector<int> src_distr(src_ntiles), dst_distr(dst_ntiles);
+    for(Index i = 0; i < src_ntiles; ++i)
+    {
+        src_distr[i] = (i+1) % mpi_size;
+    }
+    for(Index i = 0; i < dst_ntiles; ++i)
+    {
+        dst_distr[i] = (i*i+2) % mpi_size;
+    }
+    // Init source tensor by global linear indices of elements
+    Tensor<T> src(src_traits, src_distr, last_tag);
+    for(Index i = 0; i < src_ntiles; ++i)
+    {
+        if(src_distr[i] == mpi_rank)
+        {
+            auto tile_handle = src.get_tile_handle(i);
+            auto tile_local = tile_handle.acquire(STARPU_W);
+            T *tile_local_ptr = reinterpret_cast<T *>(tile_local.get_ptr());
+            auto tile_traits = src.get_tile_traits(i);
+            auto tile_index = src.grid.linear_to_index(i);
+            for(Index j = 0; j < src.ndim; ++j)
+            {
+                tile_index[j] *= src.basetile_shape[j];
+            }
+            for(Index j = 0; j < tile_traits.nelems; ++j)
+            {
+                auto global_index = tile_traits.linear_to_index(j);
+                for(Index k = 0; k < src.ndim; ++k)
+                {
+                    global_index[k] += tile_index[k];
+                }
+                tile_local_ptr[j] = T(src.index_to_linear(global_index));
+            }
+            tile_local.release();
+        }
+    }
+    // Redistribute
+    Tensor<T> dst(dst_traits, dst_distr, last_tag);
+    redistribute<T>(src, dst);
+    // Check result
+    for(Index i = 0; i < dst_ntiles; ++i)
+    {
+        if(dst_distr[i] == mpi_rank)
+        {
+            auto tile_handle = dst.get_tile_handle(i);
+            auto tile_local = tile_handle.acquire(STARPU_R);
+            T *tile_local_ptr = reinterpret_cast<T *>(tile_local.get_ptr());
+            auto tile_traits = dst.get_tile_traits(i);
+            auto tile_index = dst.grid.linear_to_index(i);
+            for(Index j = 0; j < dst.ndim; ++j)
+            {
+                tile_index[j] *= dst.basetile_shape[j];
+            }
+            for(Index j = 0; j < tile_traits.nelems; ++j)
+            {
+                auto global_index = tile_traits.linear_to_index(j);
+                for(Index k = 0; k < dst.ndim; ++k)
+                {
+                    global_index[k] += tile_index[k];
+                }
+                TEST_ASSERT(tile_local_ptr[j]
+                        == T(dst.index_to_linear(global_index)));
+            }
+            tile_local.release();
+        }
+    }
+}
+
+template<typename T>
+void validate()
+{
+    check<T>({}, {}, {});
+    check<T>({11, 12, 13}, {11, 12, 13}, {11, 12, 13});
+    check<T>({11, 12, 13}, {2, 3, 4}, {2, 3, 4});
+    check<T>({11, 12, 13}, {11, 12, 13}, {2, 3, 4});
+    check<T>({11, 12, 13}, {2, 3, 4}, {11, 12, 13});
+    check<T>({11, 12, 13}, {2, 3, 4}, {3, 4, 5});
+    check<T>({11, 12, 13}, {3, 4, 5}, {2, 3, 4});
+    check<T>({1000, 1000}, {300, 1000}, {1000, 300});
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Check throwing exceptions
+    starpu_mpi_tag_t last_tag = 0;
+    std::vector<Index> sh34 = {3, 4}, sh23 = {2, 3}, sh33 = {3, 3};
+    TensorTraits trA(sh34, sh23), trB(sh33, sh23);
+    std::vector<int> dist0000 = {0, 0, 0, 0}, dist00 = {0, 0};
+    Tensor<T> A(trA, dist0000, last_tag),
+        B(trB, dist00, last_tag);
+    TEST_THROW(redistribute<T>(A, B));
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::subcopy::init();
+    starpu::subcopy::restrict_where(STARPU_CPU);
+    // Launch all tests
+    validate<fp32_t>();
+    validate<fp64_t>();
+    validate<Index>();
+    return 0;
+}
@@ -16,6 +16,8 @@
 #include "nntile/tensor/sum_slice.hh"
 #include "nntile/tile/sum_slice.hh"
 #include "nntile/starpu/sum_slice.hh"
+#include "nntile/starpu/accumulate.hh"
+#include "nntile/tensor/tree_reduction.hh"
 #include "nntile/tensor/scatter.hh"
 #include "nntile/tensor/gather.hh"
 #include "nntile/starpu/subcopy.hh"
@@ -28,7 +30,7 @@ using namespace nntile::tensor;
 
 template<typename T>
 void check(const std::vector<Index> &shape, const std::vector<Index> &basetile,
-        Index axis)
+        Index axis, int redux=0)
 {
     T alpha = -1.0, beta = 0.5;
     // Barrier to wait for cleanup of previously used tags
@@ -94,7 +96,7 @@ void check(const std::vector<Index> &shape, const std::vector<Index> &basetile,
     Tensor<T> dst(dst_traits, dst_distr, last_tag);
     scatter<T>(dst_single, dst);
     // Perform tensor-wise and tile-wise sum_slice operations
-    sum_slice<T>(alpha, src, beta, dst, axis);
+    sum_slice<T>(alpha, src, beta, dst, axis, redux);
     if(mpi_rank == mpi_root)
     {
         tile::sum_slice<T>(alpha, src_single.get_tile(0), beta,
@@ -129,6 +131,9 @@ void validate()
     check<T>({11, 12, 13}, {5, 6, 5}, 0);
     check<T>({11, 12, 13}, {5, 6, 5}, 1);
     check<T>({11, 12, 13}, {5, 6, 5}, 2);
+    // Explicit tree reduction over many source tiles
+    check<T>({11, 12}, {2, 6}, 0, redux_tree);
+    check<T>({11, 12, 13}, {5, 6, 2}, 2, redux_tree);
     // Sync to guarantee old data tags are cleaned up and can be reused
     starpu_mpi_barrier(MPI_COMM_WORLD);
     // Check throwing exceptions
@@ -160,12 +165,19 @@ int main(int argc, char **argv)
     starpu::Config starpu(1, 0, 0);
     // Init codelet
     starpu::sum_slice::init();
+    starpu::accumulate::init();
     starpu::subcopy::init();
     starpu::copy::init();
     starpu::sum_slice::restrict_where(STARPU_CPU);
+    starpu::accumulate::restrict_where(STARPU_CPU);
     starpu::subcopy::restrict_where(STARPU_CPU);
     starpu::copy::restrict_where(STARPU_CPU);
-    // Launch all tests
+    // Launch all tests with strict order of accumulating tasks
+    starpu::Config::commute_disable();
+    validate<fp32_t>();
+    validate<fp64_t>();
+    // Launch all tests once again with commute mode, results must not change
+    starpu::Config::commute_enable();
     validate<fp32_t>();
     validate<fp64_t>();
     return 0;
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/tensor/tensor.hh"
+#include "nntile/tensor/partition.hh"
 #include "../testing.hh"
 
 using namespace nntile;
@@ -46,7 +47,11 @@ void check(const Tensor<T> &A)
         const auto tile_index = A.grid.linear_to_index(i);
         TEST_ASSERT(A.get_tile_shape(tile_index)
                 == A.get_tile(tile_index).shape);
+        TEST_ASSERT(A.get_tile_shape(tile_index)
+                == A.get_tile_traits(i).shape);
     }
+    // Traits are stored once per distinct shape of tiles
+    TEST_ASSERT(A.tile_traits.size() == Index(1)<<A.leftover_axes.size());
 }
 
 template<typename T>
@@ -87,6 +92,89 @@ void validate()
         TEST_ASSERT(t5d2.get_tile(i).mpi_get_rank() == i+3);
     }
     check<T>(t5d2);
+    // View of the last and the first tiles of a vector in a reversed order
+    TensorTraits view_traits({6}, {3});
+    Tensor<T> view(view_traits, vector, {2, 0});
+    TEST_ASSERT(view.get_tile(0).mpi_get_rank() == vector_distr[2]);
+    TEST_ASSERT(view.get_tile(1).mpi_get_rank() == vector_distr[0]);
+    TEST_ASSERT(static_cast<starpu_data_handle_t>(view.get_tile_handle(0))
+            == static_cast<starpu_data_handle_t>(vector.get_tile_handle(2)));
+    check<T>(view);
+    // Tiles of the view shall be of the same shape as the source tiles
+    TEST_THROW(Tensor<T>(view_traits, vector, {2, 3}));
+    TEST_THROW(Tensor<T>(view_traits, vector, {0}));
+    TEST_THROW(Tensor<T>(view_traits, vector, {0, 4}));
+    // Tile-aligned slices end with a leftover only at the end of the source
+    Tensor<T> slice(vector, {2}, {2});
+    TEST_ASSERT(slice.shape[0] == 4);
+    TEST_ASSERT(slice.get_tile(1).mpi_get_rank() == vector_distr[3]);
+    check<T>(slice);
+    Tensor<T> slice2d(t5d2, {1, 0, 2, 0, 1}, {2, 4, 1, 1, 2});
+    TEST_ASSERT(slice2d.shape[0] == 22 and slice2d.shape[1] == 40);
+    TEST_ASSERT(slice2d.shape[2] == 10 and slice2d.shape[4] == 21);
+    TEST_ASSERT(static_cast<starpu_data_handle_t>(
+                slice2d.get_tile_handle({1, 3, 0, 0, 1}))
+            == static_cast<starpu_data_handle_t>(
+                t5d2.get_tile_handle({2, 3, 2, 0, 2})));
+    check<T>(slice2d);
+    TEST_THROW(Tensor<T>(vector, {3}, {2}));
+    TEST_THROW(Tensor<T>(vector, {0}, {0}));
+    TEST_THROW(Tensor<T>(vector, {0, 0}, {1, 1}));
+    // Tiles of a matrix are split into parts of 3 columns, so that the
+    // leftover tile of 4 columns gives parts of 3 and 1 columns
+    TensorTraits split_traits({4, 10}, {4, 6});
+    Tensor<T> split(split_traits, {0, 0}, last_tag);
+    TEST_THROW(TensorPartition<T>(split, 4, last_tag));
+    TEST_THROW(TensorPartition<T>(scalar, 1, last_tag));
+    auto tile_local = split.get_tile_handle(1).acquire(STARPU_W);
+    T *tile_ptr = reinterpret_cast<T *>(tile_local.get_ptr());
+    for(Index i = 0; i < 16; ++i)
+    {
+        tile_ptr[i] = T(i);
+    }
+    tile_local.release();
+    {
+        TensorPartition<T> partition(split, 3, last_tag);
+        TEST_ASSERT(partition.parts.grid.shape[1] == 4);
+        TEST_ASSERT(partition.parts.get_tile(3).shape[1] == 1);
+        check<T>(partition.parts);
+        partition.partition_submit();
+        auto part_local = partition.parts.get_tile_handle(3).acquire(
+                STARPU_R);
+        T *part_ptr = reinterpret_cast<T *>(part_local.get_ptr());
+        for(Index i = 0; i < 4; ++i)
+        {
+            TEST_ASSERT(part_ptr[i] == T(i+12));
+        }
+        part_local.release();
+        partition.unpartition_submit();
+        starpu_task_wait_for_all();
+    }
+    split.unregister();
+    // Tensor, allocated by StarPU, is unregistered without blocking, while
+    // a tensor with user buffers writes values back before return
+    Tensor<T> lazy(split_traits, {0, 0}, last_tag);
+    auto lazy_local = lazy.get_tile_handle(0).acquire(STARPU_W);
+    lazy_local.release();
+    lazy.unregister_submit();
+    TEST_ASSERT(static_cast<starpu_data_handle_t>(lazy.get_tile_handle(0))
+            == nullptr);
+    std::vector<T> buffer0(24), buffer1(16);
+    Tensor<T> user(split_traits, {0, 0}, last_tag,
+            {&buffer0[0], &buffer1[0]});
+    auto user_local = user.get_tile_handle(1).acquire(STARPU_W);
+    T *user_ptr = reinterpret_cast<T *>(user_local.get_ptr());
+    for(Index i = 0; i < 16; ++i)
+    {
+        user_ptr[i] = T(i+1);
+    }
+    user_local.release();
+    user.unregister_submit();
+    for(Index i = 0; i < 16; ++i)
+    {
+        TEST_ASSERT(buffer1[i] == T(i+1));
+    }
+    starpu_task_wait_for_all();
 }
 
 int main(int argc, char ** argv)
@@ -0,0 +1,128 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/transfer_dtype.cc
+ * Lossy precision of transfers of tiles of Tensor<T> between MPI nodes
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2024-03-15
+ * */
+
+#include "nntile/tensor/copy.hh"
+#include "nntile/starpu/copy.hh"
+#include "nntile/starpu/fp32_to_bf16.hh"
+#include "nntile/starpu/bf16_to_fp32.hh"
+#include "../testing.hh"
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+// Value of an element, that is not representable in half precision
+fp32_t value(Index i)
+{
+    return fp32_t(i%7) + fp32_t(1) / fp32_t(3);
+}
+
+void check(const std::vector<Index> &shape,
+        const std::vector<Index> &basetile)
+{
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    starpu_mpi_tag_t last_tag = 0;
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_rank = starpu_mpi_world_rank();
+    TensorTraits traits(shape, basetile);
+    Index ntiles = traits.grid.nelems;
+    std::vector<int> src_distr(ntiles), dst_distr(ntiles);
+    for(Index i = 0; i < ntiles; ++i)
+    {
+        src_distr[i] = (i+1) % mpi_size;
+        dst_distr[i] = (i*i+2) % mpi_size;
+    }
+    Tensor<fp32_t> src(traits, src_distr, last_tag),
+        dst(traits, dst_distr, last_tag);
+    src.set_transfer_dtype("bf16");
+    for(Index i = 0; i < ntiles; ++i)
+    {
+        if(src_distr[i] == mpi_rank)
+        {
+            auto tile = src.get_tile(i);
+            auto tile_local = tile.acquire(STARPU_W);
+            for(Index j = 0; j < tile.nelems; ++j)
+            {
+                tile_local[j] = value(j);
+            }
+            tile_local.release();
+        }
+    }
+    // Copies of the same tile twice in a row are sent twice
+    copy<fp32_t>(src, dst);
+    copy<fp32_t>(src, dst);
+    for(Index i = 0; i < ntiles; ++i)
+    {
+        if(dst_distr[i] == mpi_rank)
+        {
+            auto tile = dst.get_tile(i);
+            auto tile_local = tile.acquire(STARPU_R);
+            for(Index j = 0; j < tile.nelems; ++j)
+            {
+                // Tiles are rounded only in flight
+                fp32_t ref = value(j);
+                if(src_distr[i] != dst_distr[i])
+                {
+                    ref = fp32_t(bf16_t(ref));
+                }
+                TEST_ASSERT(tile_local[j] == ref);
+            }
+            tile_local.release();
+        }
+    }
+    // Owner keeps exact values
+    for(Index i = 0; i < ntiles; ++i)
+    {
+        if(src_distr[i] == mpi_rank)
+        {
+            auto tile = src.get_tile(i);
+            auto tile_local = tile.acquire(STARPU_R);
+            for(Index j = 0; j < tile.nelems; ++j)
+            {
+                TEST_ASSERT(tile_local[j] == value(j));
+            }
+            tile_local.release();
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::copy::init();
+    starpu::fp32_to_bf16::init();
+    starpu::bf16_to_fp32::init();
+    // Launch all tests
+    check({11, 12, 13}, {11, 12, 13});
+    check({11, 12, 13}, {3, 4, 5});
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Check throwing exceptions
+    starpu_mpi_tag_t last_tag = 0;
+    std::vector<Index> sh = {2, 3};
+    TensorTraits tr(sh, sh);
+    std::vector<int> dist0 = {0};
+    Tensor<fp32_t> A(tr, dist0, last_tag);
+    Tensor<fp64_t> B(tr, dist0, last_tag);
+    TEST_THROW(A.set_transfer_dtype("fp8"));
+    TEST_THROW(B.set_transfer_dtype("bf16"));
+#ifndef NNTILE_USE_CUDA
+    TEST_THROW(A.set_transfer_dtype("fp16"));
+#endif // NNTILE_USE_CUDA
+    A.set_transfer_dtype("fp32");
+    return 0;
+}
+
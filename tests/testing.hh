@@ -12,7 +12,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
 #include <stdexcept>
+#include <string>
 
 // Check an exception-throwing expression
 #define TEST_THROW(...)\
@@ -48,3 +56,94 @@
     }\
 }\
 
+namespace nntile
+{
+namespace testing
+{
+
+//! Check if a test shall time kernels instead of checking their correctness
+/*! Performance mode is requested by the --perf argument of a test. */
+inline bool perf_mode(int argc, char **argv)
+{
+    for(int i = 1; i < argc; ++i)
+    {
+        if(std::strcmp(argv[i], "--perf") == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//! Time a kernel and compare its throughput against a stored baseline
+/*! The kernel is launched repeatedly for at least 0.2 seconds after a
+ * warmup and the best time of a single launch is used. Throughput is the
+ * provided amount of work, e.g., bytes read and written, per second.
+ * Baselines are lines "name throughput" of a file, given by environment
+ * variable NNTILE_PERF_BASELINE. A missing baseline is stored, while a
+ * throughput below (1-NNTILE_PERF_THRESHOLD) times the baseline throws an
+ * exception. Default threshold is 0.1. If NNTILE_PERF_UPDATE is set to 1,
+ * all baselines are replaced by the measured values. Without a file of
+ * baselines the throughput is only printed.
+ * */
+template<typename F>
+void perf_check(const std::string &name, double work, F &&kernel)
+{
+    using clock = std::chrono::steady_clock;
+    kernel();
+    double best = 0, total = 0;
+    for(int i = 0; i < 3 or total < 0.2; ++i)
+    {
+        auto time0 = clock::now();
+        kernel();
+        double time = std::chrono::duration<double>(clock::now()-time0)
+            .count();
+        best = (i == 0) ? time : std::min(best, time);
+        total += time;
+    }
+    double throughput = work / best;
+    std::cout << "PERF " << name << ": " << throughput*1e-9 << " G/s\n";
+    const char *path = std::getenv("NNTILE_PERF_BASELINE");
+    if(path == nullptr or path[0] == '\0')
+    {
+        return;
+    }
+    // Read all the baselines
+    std::map<std::string, double> baselines;
+    {
+        std::ifstream in(path);
+        std::string key;
+        double value;
+        while(in >> key >> value)
+        {
+            baselines[key] = value;
+        }
+    }
+    const char *update = std::getenv("NNTILE_PERF_UPDATE");
+    auto it = baselines.find(name);
+    if(it == baselines.end() or (update != nullptr
+                and std::strcmp(update, "1") == 0))
+    {
+        baselines[name] = throughput;
+        std::ofstream out(path);
+        out.precision(17);
+        for(const auto &baseline: baselines)
+        {
+            out << baseline.first << " " << baseline.second << "\n";
+        }
+        return;
+    }
+    const char *threshold_env = std::getenv("NNTILE_PERF_THRESHOLD");
+    double threshold = threshold_env ? std::atof(threshold_env) : 0.1;
+    std::cout << "PERF " << name << ": baseline " << it->second*1e-9
+        << " G/s\n";
+    if(throughput < (1-threshold)*it->second)
+    {
+        throw std::runtime_error("Throughput of " + name + " regressed "
+                "below the baseline");
+    }
+}
+
+} // namespace testing
+} // namespace nntile
+
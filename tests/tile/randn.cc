@@ -22,13 +22,13 @@ using namespace nntile::tile;
 template<typename T>
 void validate()
 {
-    // Only CPU implementation is check, as there is no other backend yet
+    // CPU and CUDA implementations generate the same sequence
     Tile<T> dst({3, 4, 5}), dst2(dst.shape);
     std::vector<Index> start{1, 1, 1}, underlying_shape{5, 6, 7};
     unsigned long long seed = -1;
     T mean = 1, stddev = 2;
     // Check some valid parameters
-    starpu::VariableHandle tmp_index(sizeof(Index)*2*3, STARPU_R);
+    starpu::VariableHandle tmp_index(sizeof(Index)*4*3, STARPU_R);
     starpu::randn::submit<T>(3, dst.nelems, seed, mean, stddev, start,
         dst.shape, dst.stride, underlying_shape, dst, tmp_index);
     randn(dst2, start, underlying_shape, seed, mean, stddev);
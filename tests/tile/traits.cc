@@ -104,6 +104,17 @@ void validate_traits(const TileTraits &traits)
             TEST_THROW(traits.contains_index(index2));
         }
     }
+    // Check in-place and incremental coordinates
+    std::vector<Index> index(traits.ndim+1, -1), next_index(traits.ndim, 0);
+    TEST_THROW(traits.linear_to_index(traits.nelems, index));
+    for(Index i = 0; i < traits.nelems; ++i)
+    {
+        traits.linear_to_index(i, index);
+        TEST_ASSERT(index == traits.linear_to_index(i));
+        TEST_ASSERT(index == next_index);
+        TEST_ASSERT(traits.next_index(next_index) == (i+1 < traits.nelems));
+    }
+    TEST_ASSERT(next_index == std::vector<Index>(traits.ndim, 0));
 }
 
 int main(int argc, char **argv)
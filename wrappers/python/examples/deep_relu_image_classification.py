@@ -42,6 +42,7 @@ parser.add_argument("--lr", type=float)
 # parser.add_argument("--fp32_fast_fp16", action="store_true")
 # parser.add_argument("--fp32_convert_fp16", action="store_true")
 parser.add_argument("--fp32_fast_tf32", action="store_true")
+parser.add_argument("--batch_norm", action="store_true")
 
 
 # Parse arguments
@@ -147,7 +148,7 @@ x_moments = nntile.tensor.TensorMoments(x, x_grad, x_grad_required)
 gemm_ndim = 1
 m = nntile.model.DeepReLU(x_moments, 'R', gemm_ndim, args.hidden_dim, \
             args.hidden_dim_tile, args.depth, n_classes, next_tag, \
-            fp32_fast_tf32=args.fp32_fast_tf32)
+            fp32_fast_tf32=args.fp32_fast_tf32, batch_norm=args.batch_norm)
 # if args.fp32_fast_tf32:
     
 #     print("GEMM TF32")
@@ -231,6 +232,11 @@ print("All computations done in {} + {} = {} seconds".format(time0, time1, \
 print("Train GFLOPs/s (based on gemms): {}" \
         .format(n_flops * 1e-9 / (time0+time1)))
 
+# Batch normalizations with running statistics are merged into weights of
+# linear layers for inference
+if args.batch_norm:
+    m.fold_batch_norm_async()
+
 # Get inference rate based on train data
 time0 = -time.time()
 for x in batch_data:
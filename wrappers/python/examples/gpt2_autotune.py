@@ -0,0 +1,87 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/examples/gpt2_autotune.py
+# Find tile sizes of GPT2 model, that are the best for the actual hardware
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-10
+
+# Imports
+import json
+import argparse
+import nntile
+from transformers import GPT2Config
+
+# Create argument parser
+parser = argparse.ArgumentParser(prog="GPT2 tile autotuner", \
+        description="This example benchmarks layers of a GPT2 model with " \
+        "different tile sizes and recommends the fastest ones.")
+parser.add_argument("--model", default="gpt2")
+parser.add_argument("--model-path", default=".model")
+parser.add_argument("--config-path", type=str, default="")
+parser.add_argument("--minibatch-size", type=int, default=1)
+parser.add_argument("--nntile-restrict", choices=["cpu", "cuda", None], \
+        default=None)
+parser.add_argument("--nntile-flashattention", action="store_true")
+parser.add_argument("--nntile-use-redux", action="store_true")
+parser.add_argument("--niters", type=int, default=3)
+parser.add_argument("--nwarmup", type=int, default=2)
+parser.add_argument("--npasses", type=int, default=2)
+parser.add_argument("--output", type=str, default="")
+
+# Parse arguments
+args = parser.parse_args()
+print(args)
+
+# Check arguments
+assert args.minibatch_size > 0
+assert args.niters > 0
+assert args.nwarmup >= 0
+assert args.npasses > 0
+
+# Read config of the model
+if args.config_path:
+    with open(args.config_path) as f:
+        config = GPT2Config(**json.load(f))
+else:
+    config = GPT2Config.from_pretrained(args.model, cache_dir=args.model_path)
+inner_dim = config.n_inner if config.n_inner is not None \
+        else 4 * config.hidden_size
+
+# Initialize StarPU
+nntile_config = nntile.starpu.Config(-1, -1, 1)
+nntile.starpu.init()
+if args.nntile_restrict == "cuda":
+    nntile.starpu.restrict_cuda()
+elif args.nntile_restrict == "cpu":
+    nntile.starpu.restrict_cpu()
+next_tag = 0
+
+# Tune tile sizes
+tuner = nntile.autotune.GPT2Autotuner(config.n_embd, inner_dim, \
+        config.n_head, config.n_positions, args.minibatch_size, next_tag, \
+        flashattention=args.nntile_flashattention, \
+        redux=args.nntile_use_redux, \
+        layer_norm_epsilon=config.layer_norm_epsilon, niters=args.niters, \
+        nwarmup=args.nwarmup)
+tiles = tuner.tune(npasses=args.npasses, verbose=True)
+next_tag = tuner.get_next_tag()
+print("Best time of a transformer block: {} seconds".format(tuner.best_time))
+print("Recommended tile sizes: {}".format(tiles))
+print("Recommended options of gpt2_training.py: --n-embd-tile={} " \
+        "--n-inner-tile={} --n-head-tile={} --seq-len-tile={} " \
+        "--minibatch-size-tile={}".format(tiles["embed_dim_tile"], \
+        tiles["inner_dim_tile"], tiles["n_head_tile"], \
+        tiles["seq_len_tile"], tiles["minibatch_size_tile"]))
+if args.output:
+    with open(args.output, "w") as f:
+        json.dump({"tiles": tiles, "time": tuner.best_time, \
+                "minibatch_size": args.minibatch_size, \
+                "flashattention": args.nntile_flashattention, \
+                "redux": args.nntile_use_redux, \
+                "restrict": args.nntile_restrict}, f, indent=4)
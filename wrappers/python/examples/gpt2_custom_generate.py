@@ -26,8 +26,9 @@ from transformers import GPT2TokenizerFast, GPT2LMHeadModel, GPT2Model, \
 from datasets import load_dataset
 from nntile.model.gpt2 import GPT2Config as GPT2Config_nntile, \
         GPT2Model as GPT2Model_nntile
-from nntile.tensor import copy_async
+from nntile.tensor import copy_async, topk_async, topk_sample_async
 from nntile.loss import Frob
+from nntile.inference import InferenceEngine, Request
 import pdb 
 from typing import Union, Optional, Tuple, List
 from packaging import version
@@ -60,6 +61,13 @@ parser.add_argument("--nwarmup", type=int, default=0)
 parser.add_argument("--input", choices=["text"], default="text")
 parser.add_argument("--input-path", default="input.txt")
 parser.add_argument("--ntokens", type=int, default=10)
+parser.add_argument("--kv-cache", action="store_true")
+parser.add_argument("--continuous-batching", action="store_true")
+parser.add_argument("--kv-cache-pages", type=int, default=0)
+parser.add_argument("--temperature", type=float, default=0.0)
+parser.add_argument("--top-k", type=int, default=1)
+parser.add_argument("--top-p", type=float, default=1.0)
+parser.add_argument("--seed", type=int, default=0)
 
 # Parse arguments
 args = parser.parse_args()
@@ -155,68 +163,151 @@ model_nntile_config = GPT2Config_nntile(config.vocab_size, args.embd_tile, \
         config.n_inner, args.inner_tile, config.layer_norm_epsilon, \
         config.num_hidden_layers, config.n_head, args.head_tile, \
         "gelutanh", args.flashattention, args.redux)
-model_nntile, next_tag = GPT2Model_nntile.from_torch(model_torch, \
-        args.minibatch, args.minibatch_tile, config.n_positions, \
-        args.seq_tile, model_nntile_config, next_tag, args.fp32_fast_tf32)
+if args.continuous_batching:
+    # Every sequence of a minibatch is a slot of continuous batching
+    model_nntile, next_tag = GPT2Model_nntile.from_torch(model_torch, \
+            args.minibatch, args.minibatch_tile, 1, 1, model_nntile_config, \
+            next_tag, args.fp32_fast_tf32, kv_cache_size=config.n_positions, \
+            kv_cache_size_tile=args.seq_tile, kv_cache_per_sequence=True, \
+            kv_cache_pages=args.kv_cache_pages, inference=True)
+elif args.kv_cache:
+    # Process a single new token per forward pass, keys and values of all the
+    # previous tokens are kept in KV-cache
+    model_nntile, next_tag = GPT2Model_nntile.from_torch(model_torch, \
+            args.minibatch, args.minibatch_tile, 1, 1, model_nntile_config, \
+            next_tag, args.fp32_fast_tf32, kv_cache_size=config.n_positions, \
+            kv_cache_size_tile=args.seq_tile, inference=True)
+else:
+    model_nntile, next_tag = GPT2Model_nntile.from_torch(model_torch, \
+            args.minibatch, args.minibatch_tile, config.n_positions, \
+            args.seq_tile, model_nntile_config, next_tag, \
+            args.fp32_fast_tf32, inference=True)
 #model_torch.eval()
 del model_torch
 
 # Warmup
 if args.nwarmup > 0:
     input_value = torch.randint(config.vocab_size, \
-            (1, config.n_positions), dtype=torch.int64)
+            tuple(model_nntile.activations[0].value.shape[::-1]), \
+            dtype=torch.int64)
     model_nntile.activations[0].value.from_array(input_value.T)
+    if args.kv_cache or args.continuous_batching:
+        model_nntile.reset_kv_cache_async()
     for i in range(args.nwarmup):
         model_nntile.forward_async()
     nntile.starpu.wait_for_all()
 
+# Candidates and chosen tokens of every position, so that tokens are chosen
+# on the device and only their ids are read back
+if not args.continuous_batching:
+    logits = model_nntile.activations[-1].value
+    traits = nntile.tensor.TensorTraits([args.top_k]+logits.shape[1:], \
+            [args.top_k]+logits.basetile_shape[1:])
+    distr = [0] * traits.grid.nelems
+    topk_values = type(logits)(traits, distr, next_tag)
+    next_tag = topk_values.next_tag
+    topk_indices = nntile.tensor.Tensor_int64(traits, distr, next_tag)
+    next_tag = topk_indices.next_tag
+    traits = nntile.tensor.TensorTraits(logits.shape[1:], \
+            logits.basetile_shape[1:])
+    tokens = nntile.tensor.Tensor_int64(traits, [0]*traits.grid.nelems, \
+            next_tag)
+    next_tag = tokens.next_tag
+    tokens_numpy = np.zeros((1, 1), dtype=np.int64, order='F')
+
+# Choose new tokens among the first 50257 logits and read the token of a
+# single position
+def choose_tokens(seed, pos):
+    topk_async(logits, topk_values, topk_indices, 0, 50257)
+    topk_sample_async(topk_values, topk_indices, tokens, args.temperature, \
+            args.top_p, seed)
+    tokens.to_array(tokens_numpy, [pos, 0])
+
 # Prepare input batches
 if args.input == "text":
     with open(args.input_path) as fd:
         lines = fd.readlines()
     tokenizer = GPT2TokenizerFast.from_pretrained(args.tokenizer, \
             cache_dir=args.tokenizer_path)
-    input_numpy = config.eos_token_id * np.ones((1, config.n_positions), \
-            dtype=np.int64)
-    input_tokens = np.array(list(map(lambda x: tokenizer(x)["input_ids"], \
-            lines)))
-    input_tokens_start = input_tokens.shape[1]-1
-    input_numpy[0, 0:input_tokens_start] = input_tokens[0, :-1]
-
-# Run forward 50 times autoregressively
-output_numpy = np.zeros((config.vocab_size, config.n_positions, 1), \
-        dtype=np.float32, order='F')
-for i in range(args.ntokens):
-    model_nntile.activations[0].value.from_array(input_numpy.T)
-    model_nntile.forward_async()
-    model_nntile.activations[-1].value.to_array(output_numpy)
-    #with torch.no_grad():
-    #    torch_output_numpy = model_torch(torch.tensor(input_numpy))[0].numpy().T
-    #print(np.linalg.norm(torch_output_numpy-output_numpy) /
-    #        np.linalg.norm(torch_output_numpy))
-    #print(output_numpy[input_numpy[0, 0], 0, 0], output_numpy[:, 0, 0].max())
-    new_id = output_numpy[:50257, input_tokens_start+i-1, 0].argmax()
-    #print(new_id, output_numpy[new_id, input_tokens_start+i, 0])
-    input_numpy[0, input_tokens_start+i] = new_id
-    print(tokenizer.decode(input_numpy[0, 0:input_tokens_start+i+1]))
+    # Only the first line is used without continuous batching
+    if not args.continuous_batching:
+        input_numpy = config.eos_token_id * np.ones((1, \
+                config.n_positions), dtype=np.int64)
+        input_tokens = np.array(list(map(lambda x: \
+                tokenizer(x)["input_ids"], lines[:1])))
+        input_tokens_start = input_tokens.shape[1]-1
+        input_numpy[0, 0:input_tokens_start] = input_tokens[0, :-1]
+
+# Every line of the input is a separate request, requests are processed by
+# slots of continuous batching
+if args.continuous_batching:
+    engine = InferenceEngine(model_nntile, next_tag, 50257, \
+            args.temperature, args.top_k, args.top_p, args.seed)
+    next_tag = engine.next_tag
+    requests = [Request(tokenizer(line)["input_ids"], args.ntokens, \
+            config.eos_token_id) for line in lines]
+    engine.generate(requests)
+    for request in requests:
+        print(tokenizer.decode(request.prompt+request.tokens))
+# Generate tokens with KV-cache: every forward pass processes a single token
+# and returns logits of the next token only
+elif args.kv_cache:
+    token_numpy = np.zeros((1, 1), dtype=np.int64, order='F')
+    model_nntile.reset_kv_cache_async()
+    for pos in range(input_tokens_start+args.ntokens-1):
+        token_numpy[0, 0] = input_numpy[0, pos]
+        model_nntile.set_kv_cache_pos(pos)
+        model_nntile.activations[0].value.from_array(token_numpy)
+        model_nntile.forward_async()
+        # Logits for the prompt tokens are not needed
+        if pos < input_tokens_start-1:
+            continue
+        choose_tokens(args.seed+pos, 0)
+        new_id = tokens_numpy[0, 0]
+        input_numpy[0, pos+1] = new_id
+        print(tokenizer.decode(input_numpy[0, 0:pos+2]))
+else:
+    # Run forward 50 times autoregressively
+    for i in range(args.ntokens):
+        model_nntile.activations[0].value.from_array(input_numpy.T)
+        model_nntile.forward_async()
+        choose_tokens(args.seed+i, input_tokens_start+i-1)
+        #with torch.no_grad():
+        #    torch_output_numpy = model_torch(torch.tensor(input_numpy))[0].numpy().T
+        #print(np.linalg.norm(torch_output_numpy-output_numpy) /
+        #        np.linalg.norm(torch_output_numpy))
+        #print(output_numpy[input_numpy[0, 0], 0, 0], output_numpy[:, 0, 0].max())
+        new_id = tokens_numpy[0, 0]
+        #print(new_id, output_numpy[new_id, input_tokens_start+i, 0])
+        input_numpy[0, input_tokens_start+i] = new_id
+        print(tokenizer.decode(input_numpy[0, 0:input_tokens_start+i+1]))
 
 nntile.starpu.wait_for_all()
 time1 = time.time() - time0
 print("Generate time: {} seconds".format(time1))
-print("Generate throughput tokens/sec: {}".format( \
-        args.ntokens * config.n_positions / time1))
-print("Generate performance: {} Tflops/s".format(nflops_seq \
-        * args.ntokens / time1 * 1e-12))
+if args.continuous_batching:
+    print("Generate throughput tokens/sec: {}".format(sum(len( \
+            request.tokens) for request in requests) / time1))
+elif args.kv_cache:
+    print("Generate throughput tokens/sec: {}".format(args.ntokens / time1))
+else:
+    print("Generate throughput tokens/sec: {}".format( \
+            args.ntokens * config.n_positions / time1))
+    print("Generate performance: {} Tflops/s".format(nflops_seq \
+            * args.ntokens / time1 * 1e-12))
+
+# Unregister candidates and chosen tokens
+if args.continuous_batching:
+    engine.unregister()
+else:
+    topk_values.unregister()
+    topk_indices.unregister()
+    tokens.unregister()
 
 # Unregister intermediate activations to free some space
 for t in model_nntile.activations:
     t.unregister()
 
-# Unregister gradients of parameters to free some space
-for t in model_nntile.parameters:
-    if t.grad is not None and t.grad_required:
-        t.grad.unregister()
-
 # Unregister temporaries of each layer to free some space
 for l in model_nntile.layers:
     for t in l.temporaries:
@@ -66,6 +66,7 @@ parser.add_argument("--restrict", choices=["cpu", "cuda", None], \
 parser.add_argument("--flashattention", action="store_true")
 parser.add_argument("--redux", action="store_true")
 parser.add_argument("--fp32-fast-tf32", action="store_true")
+parser.add_argument("--nworker-per-cuda", type=int, default=1)
 parser.add_argument("--nforward", type=int, default=0)
 parser.add_argument("--nforward-warmup", type=int, default=0)
 parser.add_argument("--nbackward", type=int, default=0)
@@ -176,7 +177,8 @@ nflops_seq = nflops_seq_fwd + nflops_seq_bwd
 # Initialize NNTile and StarPU
 time0 = time.time()
 # Set up StarPU+MPI and init codelets
-nntile_config = nntile.starpu.Config(-1, -1, 1)
+nntile_config = nntile.starpu.Config(-1, -1, 1, \
+        nworker_per_cuda=args.nworker_per_cuda)
 nntile.starpu.profiling_init()
 nntile.starpu.profiling_disable()
 nntile.starpu.init()
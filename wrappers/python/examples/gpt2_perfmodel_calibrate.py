@@ -0,0 +1,172 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/examples/gpt2_perfmodel_calibrate.py
+# Calibrate StarPU performance models for GPT2 training and export them
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-07
+
+# Fresh nodes start with uncalibrated performance models, so the dmda
+# scheduler misplaces tasks during the first training iterations. This script
+# runs several training iterations of a GPT2 model with the same tile sizes as
+# a production job, forcing StarPU to calibrate all the involved codelets, and
+# exports calibrated models as a bundle for a named hardware profile. The
+# production job imports the bundle before StarPU is initialized, e.g.
+#
+#   nntile.starpu.perfmodel_import(bundle, profile)
+#   config = nntile.starpu.Config(-1, -1, 1)
+#
+# or through --perfmodel-bundle and --perfmodel-profile options of the
+# gpt2_training.py example.
+
+# Imports
+import os
+import json
+import time
+import argparse
+import numpy as np
+import torch
+from transformers import GPT2LMHeadModel, GPT2Config
+
+# Create argument parser
+parser = argparse.ArgumentParser(prog="GPT2 performance model calibration", \
+        description="This example calibrates StarPU performance models of " \
+        "codelets, used by training of a GPT2 model with the given tile " \
+        "sizes, and exports them as a bundle for a hardware profile.")
+parser.add_argument("--config-path", type=str, required=True)
+parser.add_argument("--perfmodel-bundle", type=str, required=True)
+parser.add_argument("--perfmodel-profile", type=str, required=True)
+parser.add_argument("--seq-len-tile", type=int, default=1024)
+parser.add_argument("--minibatch-size", type=int, default=1)
+parser.add_argument("--minibatch-size-tile", type=int, default=1)
+parser.add_argument("--n-embd-tile", type=int, default=384)
+parser.add_argument("--n-inner-tile", type=int, default=1536)
+parser.add_argument("--n-head-tile", type=int, default=-1)
+parser.add_argument("--nntile-restrict", choices=["cpu", "cuda", None], \
+        default=None)
+parser.add_argument("--nntile-flashattention", action="store_true")
+parser.add_argument("--nntile-use-redux", action="store_true")
+parser.add_argument("--niters", type=int, default=10)
+
+# Parse arguments
+args = parser.parse_args()
+print(args)
+
+# Check arguments
+assert args.seq_len_tile > 0
+assert args.minibatch_size > 0
+assert args.minibatch_size_tile > 0
+assert args.minibatch_size % args.minibatch_size_tile == 0
+assert args.n_embd_tile > 0
+assert args.n_inner_tile > 0
+assert args.niters > 0
+
+# Force calibration of performance models. It shall be set before StarPU is
+# initialized.
+os.environ["STARPU_CALIBRATE"] = "1"
+
+import nntile
+from nntile.model.gpt2 import GPT2Config as GPT2Config_nntile, \
+        GPT2Model as GPT2Model_nntile
+
+# Read config of the model
+with open(args.config_path) as f:
+    conf_dict = json.load(f)
+config = GPT2Config(**conf_dict)
+if args.n_head_tile == -1:
+    args.n_head_tile = config.n_head
+assert config.n_head % args.n_head_tile == 0
+assert config.n_positions % args.seq_len_tile == 0
+config.attn_pdrop = 0
+config.embd_pdrop = 0
+config.resid_pdrop = 0
+inner_dim = config.n_inner if config.n_inner is not None \
+        else 4 * config.hidden_size
+config.n_inner = inner_dim
+model_torch = GPT2LMHeadModel(config)
+model_torch.lm_head.weight = torch.nn.Parameter(model_torch.lm_head \
+        .weight.detach().clone())
+
+# Models are named after the hardware profile instead of the hostname
+nntile.starpu.perfmodel_set_profile(args.perfmodel_profile)
+nntile_config = nntile.starpu.Config(-1, -1, 1)
+nntile.starpu.init()
+if args.nntile_restrict == "cuda":
+    nntile.starpu.restrict_cuda()
+elif args.nntile_restrict == "cpu":
+    nntile.starpu.restrict_cpu()
+next_tag = 0
+
+# Prepare GPT2 model with the same tile sizes as the production job
+nntile_model_config = GPT2Config_nntile(config.vocab_size, args.n_embd_tile, \
+        config.n_embd, args.n_embd_tile, config.max_position_embeddings, \
+        config.n_inner, args.n_inner_tile, config.layer_norm_epsilon, \
+        config.num_hidden_layers, config.n_head, args.n_head_tile, \
+        "gelutanh", args.nntile_flashattention, args.nntile_use_redux)
+nntile_model, next_tag = GPT2Model_nntile.from_torch(model_torch, \
+        args.minibatch_size, args.minibatch_size_tile, config.n_positions, \
+        args.seq_len_tile, nntile_model_config, next_tag)
+del model_torch
+
+# Random input and labels cover the same codelets as a real dataset
+x_traits = nntile.tensor.TensorTraits( \
+        [config.n_positions, args.minibatch_size], \
+        [args.seq_len_tile, args.minibatch_size_tile])
+x_distr = [0] * x_traits.grid.nelems
+tokens = np.random.randint(config.vocab_size, \
+        size=(config.n_positions, args.minibatch_size), dtype=np.int64)
+labels = nntile.tensor.Tensor_int64(x_traits, x_distr, next_tag)
+next_tag = labels.next_tag
+labels.from_array(np.asfortranarray(np.roll(tokens, -1, axis=0)))
+nntile_model.activations[0].value.from_array(np.asfortranarray(tokens))
+optimizer = nntile.optimizer.FusedAdam(nntile_model.get_parameters(), \
+        1e-12, next_tag)
+next_tag = optimizer.get_next_tag()
+loss, next_tag = nntile.loss.CrossEntropy.generate_simple( \
+        nntile_model.activations[-1], next_tag, \
+        scale=1.0/(args.minibatch_size*config.n_positions))
+nntile.tensor.copy_async(labels, loss.y)
+
+# Training iterations, that calibrate performance models
+for i in range(args.niters):
+    time0 = time.time()
+    nntile_model.clear_gradients()
+    nntile_model.forward_async()
+    loss.calc_async()
+    nntile_model.backward_async()
+    optimizer.step()
+    nntile.starpu.wait_for_all()
+    print("Calibration iteration {}/{} in {} seconds".format(i+1, \
+            args.niters, time.time()-time0), flush=True)
+
+# Unregister all tensors and shut down StarPU to write models to disk
+loss.unregister()
+optimizer.unregister()
+labels.unregister()
+nntile_model.unregister()
+nntile_config.shutdown()
+
+# Export calibrated models together with a description of the bundle
+nfiles = nntile.starpu.perfmodel_export(args.perfmodel_bundle, \
+        args.perfmodel_profile)
+manifest = {"profile": args.perfmodel_profile, \
+        "config": conf_dict, \
+        "seq_len_tile": args.seq_len_tile, \
+        "minibatch_size": args.minibatch_size, \
+        "minibatch_size_tile": args.minibatch_size_tile, \
+        "n_embd_tile": args.n_embd_tile, \
+        "n_inner_tile": args.n_inner_tile, \
+        "n_head_tile": args.n_head_tile, \
+        "flashattention": args.nntile_flashattention, \
+        "redux": args.nntile_use_redux, \
+        "restrict": args.nntile_restrict}
+with open(os.path.join(args.perfmodel_bundle, \
+        "{}.json".format(args.perfmodel_profile)), "w") as f:
+    json.dump(manifest, f, indent=4)
+print("Exported {} files of performance models into {}".format(nfiles, \
+        args.perfmodel_bundle))
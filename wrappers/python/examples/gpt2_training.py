@@ -19,6 +19,7 @@ import math
 import numpy as np
 import time
 import sys
+import os
 from torch import Tensor
 import torch.nn as nn
 from transformers import GPT2TokenizerFast, GPT2LMHeadModel, GPT2Model, \
@@ -77,6 +78,35 @@ parser.add_argument("--nntile-restrict", choices=["cpu", "cuda", None], \
         default=None)
 parser.add_argument("--nntile-flashattention", action="store_true")
 parser.add_argument("--nntile-use-redux", action="store_true")
+parser.add_argument("--nntile-dataset-memmap", type=str, default="")
+# Flat binary file of tokens, that is written from the tokenized dataset only
+# if it does not exist yet
+parser.add_argument("--nntile-dataset-bin", type=str, default="")
+parser.add_argument("--nntile-dataset-bin-dtype", \
+        choices=["uint16", "uint32", "int64"], default="uint16")
+parser.add_argument("--nntile-checkpoint-blocks", type=int, default=0)
+# Invalidate temporaries of layers after their last use within a step
+parser.add_argument("--nntile-plan-memory", action="store_true")
+# Update only used rows of embeddings (sparse gradients and lazy Adam)
+parser.add_argument("--nntile-lazy-embeddings", action="store_true")
+# Fuse the head with the loss, processing vocabulary by chunks of this size
+# (training only, as logits are not materialized)
+parser.add_argument("--nntile-lm-head-vocab-tile", type=int, default=0)
+# Pack documents into sequences without padding, attention is confined to
+# documents and skips tiles of different ones (flash attention only)
+parser.add_argument("--nntile-packed", action="store_true")
+parser.add_argument("--nntile-stats", action="store_true")
+# Timeline of tasks of actual training for Perfetto UI, MPI rank is appended
+# to the name of the file
+parser.add_argument("--nntile-trace", type=str, default="")
+# Per-layer breakdown of time of actual training with efficiency relative to
+# a given peak GFLOP/s of a single CUDA worker
+parser.add_argument("--nntile-profile-layers", action="store_true")
+parser.add_argument("--nntile-peak-gflops", type=float, default=0.0)
+parser.add_argument("--nntile-memory-sampling-ms", type=int, default=0)
+parser.add_argument("--nntile-host-pool", action="store_true")
+parser.add_argument("--perfmodel-bundle", type=str, default="")
+parser.add_argument("--perfmodel-profile", type=str, default="")
 parser.add_argument("--nntile-nforward", type=int, default=0)
 parser.add_argument("--nntile-nforward-warmup", type=int, default=0)
 parser.add_argument("--nntile-nbackward", type=int, default=0)
@@ -110,6 +140,19 @@ assert args.torch_nepochs >= 0
 assert args.nntile_nforward >= 0
 assert args.nntile_nbackward >= 0
 assert args.nntile_nepochs >= 0
+assert args.nntile_checkpoint_blocks >= 0
+assert args.nntile_lm_head_vocab_tile >= 0
+if args.nntile_lm_head_vocab_tile > 0:
+    assert not args.check and not args.check_fp64
+    assert args.nntile_nforward == 0 and args.nntile_nbackward == 0
+if args.nntile_packed:
+    # Columns of a minibatch share boundaries of documents
+    assert args.minibatch_size == 1
+    assert args.nntile_flashattention
+    assert not args.check_fp64 and args.torch_nepochs == 0
+    assert not args.nntile_dataset_memmap
+    assert not args.nntile_dataset_bin
+assert not (args.nntile_dataset_memmap and args.nntile_dataset_bin)
 
 # Set Torch default device to cpu
 torch.set_default_device("cpu")
@@ -176,6 +219,10 @@ nflops_seq = config.num_hidden_layers*nflops_seq_block \
 
 # Initialize NNTile and StarPU
 time0 = time.time()
+# Import calibrated performance models before StarPU is initialized
+if args.perfmodel_bundle:
+    nntile.starpu.perfmodel_import(args.perfmodel_bundle, \
+            args.perfmodel_profile)
 # Set up StarPU+MPI and init codelets
 nntile_config = nntile.starpu.Config(-1, -1, 1)
 nntile.starpu.profiling_init()
@@ -186,9 +233,15 @@ if args.nntile_restrict == "cuda":
     nntile.starpu.restrict_cuda()
 elif args.nntile_restrict == "cpu":
     nntile.starpu.restrict_cpu()
+# Pinned CPU buffers of tiles, reused by temporaries of each step
+if args.nntile_host_pool:
+    nntile.starpu.host_pool_enable()
 time1 = time.time() - time0
 print("StarPU + NNTile + MPI init in {} seconds".format(time1))
 next_tag = 0
+# Track memory of all tensors to find out what is resident at the peak
+if args.nntile_memory_sampling_ms > 0:
+    nntile.starpu.memory_tracking_enable(args.nntile_memory_sampling_ms)
 
 # optim = torch.optim.SGD(model_torch.parameters(), lr=1e-1)
 # input_value = torch.randint(config.vocab_size, \
@@ -204,10 +257,17 @@ nntile_model_config = GPT2Config_nntile(config.vocab_size, args.n_embd_tile, \
         config.n_embd, args.n_embd_tile, config.max_position_embeddings, \
         config.n_inner, args.n_inner_tile, config.layer_norm_epsilon, \
         config.num_hidden_layers, config.n_head, args.n_head_tile, \
-        "gelutanh", args.nntile_flashattention, args.nntile_use_redux)
+        "gelutanh", args.nntile_flashattention, args.nntile_use_redux, \
+        sparse_embedding_grad=args.nntile_lazy_embeddings, \
+        lm_head_vocab_tile=args.nntile_lm_head_vocab_tile)
 nntile_model, next_tag = GPT2Model_nntile.from_torch(model_torch, \
         args.minibatch_size, args.minibatch_size_tile, config.n_positions, \
         args.seq_len_tile, nntile_model_config, next_tag)
+# Recompute activations of transformer blocks during backward to save memory
+nntile_model.set_block_checkpoints(args.nntile_checkpoint_blocks)
+nntile_model.set_tensor_names()
+if args.nntile_plan_memory:
+    print(nntile_model.plan_memory().report())
 
 # Check that to_torch method works
 # base_model_torch = GPT2LMHeadModel(config)
@@ -438,8 +498,13 @@ if args.nntile_nbackward > 0:
     print("NNTile backward performance: {} Tflops/s".format(2 * nflops_seq \
             * args.nntile_nbackward * args.minibatch_size / time1 * 1e-12))
 
-# Prepare input and output batches if real training is required
-if args.torch_nepochs > 0 or args.nntile_nepochs > 0 or args.check_fp64:
+# Prepare input and output batches if real training is required. Tokenization
+# is skipped if NNTile trains on an already written binary file of tokens.
+dataset_bin_ready = args.nntile_dataset_bin \
+        and os.path.exists(args.nntile_dataset_bin) \
+        and args.torch_nepochs == 0 and not args.check_fp64
+if (args.torch_nepochs > 0 or args.nntile_nepochs > 0 or args.check_fp64) \
+        and not dataset_bin_ready:
     # Read dataset
     if args.dataset == "WikiText-103":
         train_dataset = load_dataset("wikitext", "wikitext-103-v1", \
@@ -455,18 +520,31 @@ if args.torch_nepochs > 0 or args.nntile_nepochs > 0 or args.check_fp64:
             cache_dir=args.model_path)
     map_train_tokens = map(lambda x: tokenizer(x["text"])["input_ids"], \
             train_dataset)
-    list_train_tokens = []
-    for seq in map_train_tokens:
-        list_train_tokens.extend(seq)
-    num_train_tokens = len(list_train_tokens)
-    num_train_seq = num_train_tokens // (config.n_positions+1)
-    num_train_batches = num_train_seq // args.batch_size
-    num_train_tokens_truncated = num_train_batches * args.batch_size \
-            * (config.n_positions+1)
-    train_tokens = np.array(list_train_tokens[:num_train_tokens_truncated], \
-            order='F', dtype=np.int64)
-    train_tokens = train_tokens.reshape(num_train_batches, \
-            num_minibatch, args.minibatch_size, config.n_positions+1)
+    if args.nntile_packed:
+        # Rows of inputs and labels with offsets of their documents
+        train_inputs, train_labels, train_segments = \
+                nntile.packing.pack_sequences(map_train_tokens, \
+                config.n_positions)
+        num_train_batches = train_inputs.shape[0] // args.batch_size
+    else:
+        list_train_tokens = []
+        for seq in map_train_tokens:
+            list_train_tokens.extend(seq)
+        num_train_tokens = len(list_train_tokens)
+        num_train_seq = num_train_tokens // (config.n_positions+1)
+        num_train_batches = num_train_seq // args.batch_size
+        num_train_tokens_truncated = num_train_batches * args.batch_size \
+                * (config.n_positions+1)
+        if args.nntile_dataset_bin \
+                and not os.path.exists(args.nntile_dataset_bin):
+            np.array(list_train_tokens, \
+                    dtype=args.nntile_dataset_bin_dtype) \
+                    .tofile(args.nntile_dataset_bin)
+        train_tokens = np.array( \
+                list_train_tokens[:num_train_tokens_truncated], order='F', \
+                dtype=np.int64)
+        train_tokens = train_tokens.reshape(num_train_batches, \
+                num_minibatch, args.minibatch_size, config.n_positions+1)
     print("Number of train sequences: {}".format(num_train_batches \
             * args.batch_size))
     print("Number of train batches: {}".format(num_train_batches))
@@ -529,33 +607,83 @@ if args.nntile_nepochs > 0:
             [config.n_positions, args.minibatch_size], \
             [args.seq_len_tile, args.minibatch_size_tile])
     x_distr = [0] * x_traits.grid.nelems
-    for i in range(num_train_batches):
+    # Stream batches from a memory-mapped file instead of preloading them
+    loader = None
+    if args.nntile_dataset_memmap:
+        with open(args.nntile_dataset_memmap, "wb") as f:
+            np.save(f, train_tokens)
+        loader = nntile.loader.MemmapLoader(args.nntile_dataset_memmap, \
+                args.seq_len_tile, args.minibatch_size_tile, next_tag)
+        next_tag = loader.get_next_tag()
+        num_train_batches_preload = 0
+    elif args.nntile_dataset_bin:
+        # Random windows of the whole file, as many tokens per epoch as the
+        # file contains
+        loader = nntile.loader.TokenFileLoader(args.nntile_dataset_bin, \
+                config.n_positions, args.seq_len_tile, args.minibatch_size, \
+                args.minibatch_size_tile, num_minibatch, 0, next_tag, \
+                args.nntile_dataset_bin_dtype)
+        next_tag = loader.get_next_tag()
+        num_train_batches = len(loader)
+        print("Number of train batches of binary file: {}".format( \
+                num_train_batches))
+        num_train_batches_preload = 0
+    else:
+        num_train_batches_preload = num_train_batches
+    batch_segments = None
+    if args.nntile_packed:
+        batch_segments = []
+    for i in range(num_train_batches_preload):
         minibatch_input = []
         minibatch_output = []
         for j in range(num_minibatch):
+            if args.nntile_packed:
+                row = i*num_minibatch + j
+                inputs = train_inputs[row:row+1].T
+                labels = train_labels[row:row+1].T
+            else:
+                inputs = train_tokens[i, j, :, :-1].T
+                labels = train_tokens[i, j, :, 1:].T
             x = nntile.tensor.Tensor_int64(x_traits, x_distr, next_tag)
             next_tag = x.next_tag
-            x.from_array(np.asfortranarray(train_tokens[i, j, :, :-1].T))
+            x.from_array(np.asfortranarray(inputs))
             minibatch_input.append(x)
             y = nntile.tensor.Tensor_int64(x_traits, x_distr, next_tag)
             next_tag = y.next_tag
-            y.from_array(np.asfortranarray(train_tokens[i, j, :, 1:].T))
+            y.from_array(np.asfortranarray(labels))
             minibatch_output.append(y)
         batch_input.append(minibatch_input)
         batch_output.append(minibatch_output)
+        if args.nntile_packed:
+            batch_segments.append(train_segments[i*num_minibatch: \
+                    (i+1)*num_minibatch])
     time1 = time.time() - time0
     print("From PyTorch loader to NNTile batches in {} seconds".format(time1))
     # Set up learning rate and optimizer for training
-    optimizer = nntile.optimizer.FusedAdam(nntile_model.get_parameters(), \
-            args.lr, next_tag)
+    if args.nntile_lazy_embeddings:
+        optimizer = nntile.optimizer.LazyAdam(nntile_model.get_parameters(), \
+                args.lr, next_tag)
+    else:
+        optimizer = nntile.optimizer.FusedAdam( \
+                nntile_model.get_parameters(), args.lr, next_tag)
     next_tag = optimizer.get_next_tag()
-    # Define Cross Entropy loss function
-    loss, next_tag = nntile.loss.CrossEntropy.generate_simple( \
-            nntile_model.activations[-1], next_tag, \
-            scale=1.0/(args.batch_size*config.n_positions))
+    # Define Cross Entropy loss function, that is the fused head itself if
+    # requested
+    if args.nntile_lm_head_vocab_tile > 0:
+        loss = nntile_model.lm_head
+        loss.scale = 1.0 / (args.batch_size*config.n_positions)
+    else:
+        loss, next_tag = nntile.loss.CrossEntropy.generate_simple( \
+                nntile_model.activations[-1], next_tag, \
+                scale=1.0/(args.batch_size*config.n_positions))
     # Set up training pipeline
-    pipeline = nntile.pipeline.Pipeline(batch_input, batch_output, \
-            nntile_model, optimizer, loss, args.nntile_nepochs_warmup)
+    if loader is None:
+        pipeline = nntile.pipeline.Pipeline(batch_input, batch_output, \
+                nntile_model, optimizer, loss, args.nntile_nepochs_warmup, \
+                segments=batch_segments)
+    else:
+        pipeline = nntile.pipeline.Pipeline(loader, None, nntile_model, \
+                optimizer, loss, args.nntile_nepochs_warmup)
     # Warmup training
     #nntile.starpu.pause()
     pipeline.train_async()
@@ -564,13 +692,45 @@ if args.nntile_nepochs > 0:
     # Actual training
     pipeline.n_epochs = args.nntile_nepochs
     nntile.starpu.profiling_enable()
+    if args.nntile_stats:
+        nntile.starpu.stats_reset()
+        nntile.starpu.stats_enable()
+    if args.nntile_profile_layers:
+        profiler = nntile_model.profile_layers({"CUDA": \
+                args.nntile_peak_gflops} if args.nntile_peak_gflops > 0 \
+                else None)
+        profiler.__enter__()
+    elif args.nntile_trace:
+        nntile.starpu.trace_clear()
+        nntile.starpu.trace_enable()
     #nntile.starpu.pause()
     time0 = time.time()
     pipeline.train_async()
     #nntile.starpu.resume()
     nntile.starpu.wait_for_all()
     nntile.starpu.profiling_disable()
+    if args.nntile_profile_layers:
+        profiler.__exit__(None, None, None)
+        print(profiler.report())
+    if args.nntile_trace:
+        nntile.starpu.trace_disable()
+        nntile.starpu.trace_export("{}.{}.json".format(args.nntile_trace, \
+                nntile.starpu.mpi_world_rank()))
     time1 = time.time() - time0
+    if args.nntile_stats:
+        nntile.starpu.stats_disable()
+        # Codelets sorted by their total time
+        stats = sorted(nntile.starpu.stats_get(), key=lambda s: s["time"], \
+                reverse=True)
+        print("{:<40} {:>8} {:>10} {:>10} {:>10}".format("Codelet", \
+                "Tasks", "Time (s)", "GFLOP/s", "GB/s"))
+        for s in stats:
+            print("{:<40} {:>8} {:>10.4f} {:>10.2f} {:>10.2f}".format( \
+                    s["name"], s["ntasks"], s["time"], s["gflops"], \
+                    s["gbps"]))
+            for w in s["workers"]:
+                print("    {:<36} {:>8} {:>10.4f}".format(w["worker"], \
+                        w["ntasks"], w["time"]))
     print("NNTile training time: {} seconds".format(time1))
     print("NNTile training throughput tokens/sec: {}".format( \
             args.nntile_nepochs * num_train_batches * args.batch_size \
@@ -581,11 +741,27 @@ if args.nntile_nepochs > 0:
     loss_np = np.zeros((1), dtype=np.float32)
     loss.val.to_array(loss_np)
     print("NNTile loss on the last batch: {}".format(loss_np[0]))
-    loss.unregister()
+    # Fused head is unregistered together with the model
+    if loss is not nntile_model.lm_head:
+        loss.unregister()
     optimizer.unregister()
     for batch in batch_input+batch_output:
         for x in batch:
             x.unregister()
+    if loader is not None:
+        loader.unregister()
+
+# Report peak memory usage of every memory node with its largest tensors
+if args.nntile_memory_sampling_ms > 0:
+    for node in nntile.starpu.memory_get_stats():
+        print("Memory node {}: peak {} MB (StarPU peak {} MB)".format( \
+                node["name"], node["peak"] / 2**20, \
+                node["starpu_peak"] / 2**20))
+        largest = sorted(node["peak_by_name"].items(), \
+                key=lambda x: x[1], reverse=True)
+        for name, size in largest[:10]:
+            print("    {:<50} {:>10.2f} MB".format(name, size / 2**20))
+    nntile.starpu.memory_tracking_disable()
 
 # Unregister all tensors related to model
 nntile_model.unregister()
@@ -11,5 +11,9 @@
 # @author Aleksandr Mikhalev
 # @date 2023-02-22
 
-from .nntile_core import starpu, tile, TransOp, trans, notrans
-from . import layer, loss, model, tensor, pipeline, optimizer
+from .nntile_core import starpu, tile, TransOp, trans, notrans, \
+        GemmCompute, gemm_default, gemm_fast_tf32, gemm_fast_fp16, \
+        gemm_fast_bf16
+from . import layer, loss, model, tensor, pipeline, optimizer, graph, \
+        loader, autotune, checkpoint, safetensors, readback, packing, \
+        bucketing, profiler, memory_planner
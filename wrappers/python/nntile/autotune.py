@@ -0,0 +1,216 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/autotune.py
+# Autotuner of tile shapes, that benchmarks layers on the actual hardware
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-10
+
+import nntile
+from nntile.tensor import TensorTraits, TensorMoments, Tensor_fp32, \
+        Tensor_bool, randn_async
+from nntile.layer import LayerNorm, Attention, FlashAttention
+from nntile.model.gpt2 import GPT2Config, GPT2MLP
+import numpy as np
+import time
+from typing import Dict, List
+
+# Time of a single call to func averaged over niters calls after nwarmup
+# calls. Warmup calls also calibrate StarPU performance models, so that the
+# dmda scheduler places tasks properly when timing.
+def benchmark(func, niters: int=3, nwarmup: int=1) -> float:
+    for i in range(nwarmup):
+        func()
+    nntile.starpu.wait_for_all()
+    time0 = time.time()
+    for i in range(niters):
+        func()
+    nntile.starpu.wait_for_all()
+    return (time.time()-time0) / niters
+
+# Candidate tile sizes of a dimension: its divisors, that are not smaller
+# than min_tile, with the dimension itself always included
+def tile_candidates(dim: int, min_tile: int=1, max_candidates: int=8) \
+        -> List[int]:
+    divisors = [d for d in range(max(min_tile, 1), dim+1) if dim % d == 0]
+    if len(divisors) == 0:
+        return [dim]
+    # Keep the largest divisors, that do not produce too many tiles
+    return divisors[-max_candidates:]
+
+class GPT2Autotuner:
+    """Autotuner of tile shapes of a GPT2 model
+
+    Tile sizes embed_dim_tile, inner_dim_tile, n_head_tile, seq_len_tile and
+    minibatch_size_tile are chosen by coordinate descent: each tile size in
+    turn is set to the candidate, that minimizes time of forward and
+    backward passes of a transformer block (2 layer normalizations, an
+    attention and an MLP), while other tile sizes are fixed. Time of every
+    layer is measured on the actual hardware and cached.
+    """
+    def __init__(self, embed_dim: int, inner_dim: int, n_head: int, \
+            seq_len: int, minibatch_size: int, next_tag: int, \
+            flashattention: bool=False, redux: bool=False, \
+            layer_norm_epsilon: float=1e-5, activation_function: str= \
+            "gelutanh", candidates: Dict[str, List[int]]=None, \
+            niters: int=3, nwarmup: int=1):
+        self.embed_dim = embed_dim
+        self.inner_dim = inner_dim
+        self.n_head = n_head
+        self.seq_len = seq_len
+        self.minibatch_size = minibatch_size
+        sizes = {"embed_dim_tile": embed_dim, "inner_dim_tile": inner_dim, \
+                "n_head_tile": n_head, "seq_len_tile": seq_len, \
+                "minibatch_size_tile": minibatch_size}
+        head_size = embed_dim // n_head
+        if candidates is None:
+            candidates = {}
+        self.candidates = {}
+        for name, size in sizes.items():
+            if name in candidates:
+                c = list(candidates[name])
+            elif name == "n_head_tile":
+                c = tile_candidates(size)
+            else:
+                c = tile_candidates(size, min_tile=32)
+            for tile in c:
+                if tile <= 0 or size % tile != 0:
+                    raise ValueError("Candidate {} of {} does not divide " \
+                            "{}".format(tile, name, size))
+            self.candidates[name] = c
+        # Embedding tiles shall not split attention heads
+        self.candidates["embed_dim_tile"] = [t for t in \
+                self.candidates["embed_dim_tile"] if t % head_size == 0] \
+                or [embed_dim]
+        self.next_tag = next_tag
+        self.flashattention = flashattention
+        self.redux = redux
+        self.layer_norm_epsilon = layer_norm_epsilon
+        self.activation_function = activation_function
+        self.niters = niters
+        self.nwarmup = nwarmup
+        self.cache = {}
+
+    def get_next_tag(self):
+        return self.next_tag
+
+    def _activation(self, shape, basetile):
+        traits = TensorTraits(shape, basetile)
+        distr = [0] * traits.grid.nelems
+        value = Tensor_fp32(traits, distr, self.next_tag)
+        self.next_tag = value.next_tag
+        grad = Tensor_fp32(traits, distr, self.next_tag)
+        self.next_tag = grad.next_tag
+        randn_async(value, [0]*len(shape), shape, 1, 0.0, 1.0)
+        randn_async(grad, [0]*len(shape), shape, 2, 0.0, 1.0)
+        return TensorMoments(value, grad, True)
+
+    # Time of forward and backward passes of layers constructed by make
+    def _time(self, key, x_basetile, make):
+        if key in self.cache:
+            return self.cache[key]
+        shape = [self.embed_dim, self.seq_len, self.minibatch_size]
+        x = self._activation(shape, x_basetile)
+        # Layers, their output and all the tensors to be unregistered
+        layers, y, tensors = make(x)
+        for l in layers:
+            l.init_randn_async()
+        randn_async(y.grad, [0]*len(y.grad.shape), y.grad.shape, 3, 0.0, \
+                1.0)
+        def func():
+            for l in layers:
+                l.forward_async()
+            for l in reversed(layers):
+                l.backward_async()
+        result = benchmark(func, self.niters, self.nwarmup)
+        for l in layers:
+            l.unregister()
+        for t in tensors + [x]:
+            t.unregister()
+        self.cache[key] = result
+        return result
+
+    def time_layer_norm(self, tiles: Dict[str, int]) -> float:
+        x_basetile = [tiles["embed_dim_tile"], tiles["seq_len_tile"], \
+                tiles["minibatch_size_tile"]]
+        def make(x):
+            layer, self.next_tag = LayerNorm.generate_simple(x, 0, \
+                    self.layer_norm_epsilon, self.next_tag, redux=self.redux)
+            return [layer], layer.activations_output[0], \
+                    layer.activations_output
+        return self._time(("layer_norm",)+tuple(x_basetile), x_basetile, \
+                make)
+
+    def time_attention(self, tiles: Dict[str, int]) -> float:
+        x_basetile = [tiles["embed_dim_tile"], tiles["seq_len_tile"], \
+                tiles["minibatch_size_tile"]]
+        seq_len = self.seq_len
+        def make(x):
+            mask_traits = TensorTraits([seq_len, seq_len], \
+                    [tiles["seq_len_tile"], tiles["seq_len_tile"]])
+            mask = Tensor_bool(mask_traits, [0]*mask_traits.grid.nelems, \
+                    self.next_tag)
+            self.next_tag = mask.next_tag
+            mask.from_array(np.array(np.triu(np.ones((seq_len, seq_len))), \
+                    dtype=bool, order="F"))
+            if self.flashattention:
+                AttLayer = FlashAttention
+            else:
+                AttLayer = Attention
+            layer, self.next_tag = AttLayer.generate_simple(x, x, x, \
+                    self.n_head, tiles["n_head_tile"], self.next_tag, True, \
+                    mask, redux=self.redux)
+            return [layer], layer.activations_output[0], \
+                    layer.activations_output+[mask]
+        return self._time(("attention", tiles["n_head_tile"]) \
+                +tuple(x_basetile), x_basetile, make)
+
+    def time_mlp(self, tiles: Dict[str, int]) -> float:
+        x_basetile = [tiles["embed_dim_tile"], tiles["seq_len_tile"], \
+                tiles["minibatch_size_tile"]]
+        # Only parameters of the MLP are meaningful
+        config = GPT2Config(1, 1, self.embed_dim, tiles["embed_dim_tile"], \
+                1, self.inner_dim, tiles["inner_dim_tile"], \
+                self.layer_norm_epsilon, 1, self.n_head, \
+                tiles["n_head_tile"], self.activation_function, \
+                self.flashattention, self.redux)
+        def make(x):
+            mlp = GPT2MLP(x, config, self.next_tag)
+            self.next_tag = mlp.next_tag
+            return mlp.layers, mlp.activations[-1], mlp.activations[1:]
+        return self._time(("mlp", tiles["inner_dim_tile"]) \
+                +tuple(x_basetile), x_basetile, make)
+
+    # Time of forward and backward passes of a transformer block
+    def time_block(self, tiles: Dict[str, int]) -> float:
+        return 2*self.time_layer_norm(tiles) + self.time_attention(tiles) \
+                + self.time_mlp(tiles)
+
+    def tune(self, npasses: int=2, verbose: bool=False) -> Dict[str, int]:
+        tiles = {name: c[-1] for name, c in self.candidates.items()}
+        best_time = self.time_block(tiles)
+        for i_pass in range(npasses):
+            changed = False
+            for name, c in self.candidates.items():
+                for tile in c:
+                    if tile == tiles[name]:
+                        continue
+                    new_tiles = dict(tiles)
+                    new_tiles[name] = tile
+                    new_time = self.time_block(new_tiles)
+                    if verbose:
+                        print("{}: {} seconds".format(new_tiles, new_time), \
+                                flush=True)
+                    if new_time < best_time:
+                        best_time = new_time
+                        tiles = new_tiles
+                        changed = True
+            if not changed:
+                break
+        self.best_time = best_time
+        return tiles
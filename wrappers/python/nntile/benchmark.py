@@ -0,0 +1,243 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/benchmark.py
+# End-to-end benchmark of training throughput of GPT2 models
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+"""End-to-end benchmark of training throughput of GPT2 models
+
+A sweep over fixed GPT2 configurations, base tile shapes and numbers of
+CUDA workers is run by
+
+    python -m nntile.benchmark --models small,medium --gpus 1,2,4 \\
+            --output gpt2_benchmark.json
+
+Every point of the sweep runs in its own process, as StarPU is initialized
+once per process, and trains a randomly initialized model on random tokens.
+Results are written as JSON records with tokens/s, TFLOP/s (of matrix
+products of forward and backward passes), peak memory of every memory node
+and scaling efficiency relative to the smallest number of GPUs of the same
+model and tiles, so that results of different releases can be compared.
+"""
+
+import argparse
+import json
+import subprocess
+import sys
+import time
+from typing import Dict, List
+
+# Fixed configurations: number of blocks, embedding size and number of heads
+MODELS = {
+        "tiny": (2, 128, 4),
+        "small": (12, 768, 12),
+        "medium": (24, 1024, 16),
+        "large": (36, 1280, 20),
+        "xl": (48, 1600, 25),
+        }
+
+VOCAB_SIZE = 50257
+
+# Default tiles of sequence, embedding and inner dimensions of models
+TILES = {
+        "tiny": ["128:64:256"],
+        "small": ["1024:384:1536", "1024:768:3072", "512:768:1536"],
+        "medium": ["1024:512:2048", "1024:1024:4096"],
+        "large": ["1024:640:2560", "1024:1280:5120"],
+        "xl": ["1024:800:3200", "1024:1600:6400"],
+        }
+
+def nflops_forward(model: str, seq_len: int, vocab_size: int) -> float:
+    """Forward FLOPs of matrix products per sequence of a model"""
+    n_layer, n_embd, _ = MODELS[model]
+    n_inner = 4 * n_embd
+    nflops_block = 2*seq_len*n_embd*(3+1)*n_embd \
+            + 4*seq_len*seq_len*n_embd + 4*seq_len*n_embd*n_inner
+    return n_layer*nflops_block + 2*seq_len*n_embd*vocab_size
+
+def run_point(args) -> Dict:
+    """Train a model at a single point of the sweep in this process"""
+    import numpy as np
+    import nntile
+    from nntile.model.gpt2 import GPT2Config, GPT2Model
+    n_layer, n_embd, n_head = MODELS[args.model]
+    seq_len_tile, n_embd_tile, n_inner_tile = map(int, args.tiles.split(":"))
+    seq_len = args.seq_len
+    vocab_size = args.vocab_size
+    config = nntile.starpu.Config(args.ncpus, args.gpus, 1 if args.gpus > 0 \
+            else 0)
+    nntile.starpu.init()
+    if args.gpus > 0:
+        nntile.starpu.restrict_cuda()
+    nntile.starpu.memory_tracking_enable(100)
+    model_config = GPT2Config(vocab_size, n_embd_tile, n_embd, n_embd_tile, \
+            seq_len, 4*n_embd, n_inner_tile, 1e-5, n_layer, n_head, n_head, \
+            "gelutanh", args.flashattention)
+    next_tag = 0
+    model = GPT2Model._generate(args.minibatch_size, \
+            args.minibatch_size_tile, seq_len, seq_len_tile, model_config, \
+            next_tag)
+    next_tag = model.next_tag
+    for layer in model.layers:
+        layer.init_randn_async()
+    # Random tokens of every minibatch of every batch
+    num_minibatch = args.batch_size // args.minibatch_size
+    rng = np.random.default_rng(0)
+    x_traits = nntile.tensor.TensorTraits([seq_len, args.minibatch_size], \
+            [seq_len_tile, args.minibatch_size_tile])
+    x_distr = [0] * x_traits.grid.nelems
+    batch_input = []
+    batch_output = []
+    for i in range(args.num_batches):
+        minibatch_input = []
+        minibatch_output = []
+        for j in range(num_minibatch):
+            tokens = rng.integers(vocab_size, \
+                    size=(seq_len+1, args.minibatch_size), dtype=np.int64)
+            x = nntile.tensor.Tensor_int64(x_traits, x_distr, next_tag)
+            next_tag = x.next_tag
+            x.from_array(np.asfortranarray(tokens[:-1]))
+            minibatch_input.append(x)
+            y = nntile.tensor.Tensor_int64(x_traits, x_distr, next_tag)
+            next_tag = y.next_tag
+            y.from_array(np.asfortranarray(tokens[1:]))
+            minibatch_output.append(y)
+        batch_input.append(minibatch_input)
+        batch_output.append(minibatch_output)
+    optimizer = nntile.optimizer.FusedAdam(model.get_parameters(), 1e-4, \
+            next_tag)
+    next_tag = optimizer.get_next_tag()
+    loss, next_tag = nntile.loss.CrossEntropy.generate_simple( \
+            model.activations[-1], next_tag)
+    pipeline = nntile.pipeline.Pipeline(batch_input, batch_output, model, \
+            optimizer, loss, args.warmup_epochs)
+    pipeline.train_async()
+    nntile.starpu.wait_for_all()
+    # Peak memory is measured for the actual training only
+    nntile.starpu.memory_sample()
+    nntile.starpu.memory_reset_peak()
+    pipeline.n_epochs = args.epochs
+    time0 = time.time()
+    pipeline.train_async()
+    nntile.starpu.wait_for_all()
+    elapsed = time.time() - time0
+    nntile.starpu.memory_sample()
+    peak_memory = {node["name"]: node["starpu_peak"] \
+            for node in nntile.starpu.memory_get_stats()}
+    nseqs = args.epochs * args.num_batches * args.batch_size
+    result = {
+            "model": args.model,
+            "tiles": args.tiles,
+            "gpus": args.gpus,
+            "seq_len": seq_len,
+            "batch_size": args.batch_size,
+            "minibatch_size": args.minibatch_size,
+            "minibatch_size_tile": args.minibatch_size_tile,
+            "time": elapsed,
+            "tokens_per_s": nseqs * seq_len / elapsed,
+            "tflops": 3 * nflops_forward(args.model, seq_len, vocab_size) \
+                    * nseqs / elapsed * 1e-12,
+            "peak_memory": peak_memory,
+            "loss": float(pipeline.loss_hist[-1]),
+            }
+    loss.unregister()
+    optimizer.unregister()
+    for batch in batch_input+batch_output:
+        for x in batch:
+            x.unregister()
+    model.unregister()
+    nntile.starpu.memory_tracking_disable()
+    return result
+
+def run_sweep(args) -> List[Dict]:
+    """Run every point of the sweep in a subprocess"""
+    results = []
+    for model in args.models.split(","):
+        tiles = args.tiles.split(",") if args.tiles else TILES[model]
+        for tile in tiles:
+            base = None
+            for gpus in map(int, args.gpus.split(",")):
+                cmd = [sys.executable, "-m", "nntile.benchmark", "--point", \
+                        "--model", model, "--tiles", tile, \
+                        "--gpus", str(gpus)] + args.point_args
+                proc = subprocess.run(cmd, stdout=subprocess.PIPE, \
+                        universal_newlines=True)
+                lines = [l for l in proc.stdout.splitlines() \
+                        if l.startswith("{")]
+                if proc.returncode != 0 or not lines:
+                    # Failed points, e.g., out of memory, are kept
+                    result = {"model": model, "tiles": tile, "gpus": gpus, \
+                            "error": proc.returncode}
+                else:
+                    result = json.loads(lines[-1])
+                    # Efficiency of scaling from the first number of GPUs
+                    if base is None:
+                        base = result
+                    result["scaling_efficiency"] = \
+                            result["tokens_per_s"] / base["tokens_per_s"] \
+                            * max(base["gpus"], 1) / max(gpus, 1)
+                print(json.dumps(result), file=sys.stderr, flush=True)
+                results.append(result)
+    return results
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(prog="python -m nntile.benchmark", \
+            description="End-to-end benchmark of training of GPT2 models")
+    parser.add_argument("--models", default="small", \
+            help="Comma-separated list of {}".format(",".join(MODELS)))
+    parser.add_argument("--tiles", default="", help="Comma-separated list " \
+            "of seq_len_tile:n_embd_tile:n_inner_tile, defaults depend on " \
+            "models")
+    parser.add_argument("--gpus", default="1", help="Comma-separated list " \
+            "of numbers of CUDA workers, zero means CPU only")
+    parser.add_argument("--output", default="gpt2_benchmark.json")
+    # Options of a single point of the sweep, that are passed to subprocesses
+    point = parser.add_argument_group("point")
+    point.add_argument("--seq-len", type=int, default=1024)
+    point.add_argument("--vocab-size", type=int, default=VOCAB_SIZE)
+    point.add_argument("--batch-size", type=int, default=8)
+    point.add_argument("--minibatch-size", type=int, default=8)
+    point.add_argument("--minibatch-size-tile", type=int, default=8)
+    point.add_argument("--num-batches", type=int, default=2)
+    point.add_argument("--epochs", type=int, default=3)
+    point.add_argument("--warmup-epochs", type=int, default=1)
+    point.add_argument("--ncpus", type=int, default=-1)
+    point.add_argument("--flashattention", action="store_true")
+    # Internal options of a subprocess
+    parser.add_argument("--point", action="store_true", \
+            help=argparse.SUPPRESS)
+    parser.add_argument("--model", help=argparse.SUPPRESS)
+    args = parser.parse_args(argv)
+    if args.batch_size % args.minibatch_size != 0:
+        raise ValueError("Batch shall consist of whole minibatches")
+    if args.point:
+        args.gpus = int(args.gpus)
+        print(json.dumps(run_point(args)), flush=True)
+        return
+    for model in args.models.split(","):
+        if model not in MODELS:
+            raise ValueError("Unknown model {}".format(model))
+    args.point_args = []
+    for action in point._group_actions:
+        value = getattr(args, action.dest)
+        if isinstance(value, bool):
+            if value:
+                args.point_args.append(action.option_strings[0])
+        else:
+            args.point_args.extend([action.option_strings[0], str(value)])
+    results = run_sweep(args)
+    with open(args.output, "w") as f:
+        json.dump({"benchmark": "gpt2_training", "time": time.time(), \
+                "results": results}, f, indent=1)
+    if any("error" in result for result in results):
+        sys.exit(1)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,136 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/benchmark_submission.py
+# Throughput of submission and execution of tiny tasks from Python
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+"""Throughput of submission and execution of tiny tasks from Python
+
+A sweep over scheduling policies is run by
+
+    python -m nntile.benchmark_submission --scheds dmda,eager,lws \\
+            --output submission_python.json
+
+Every policy runs in its own process, as StarPU is initialized once per
+process. Tasks of clear_async and add_async are submitted for tensors with
+a growing number of tiles of a few elements, so that both the cost of a
+call of the Python bindings (a single tile) and the cost of a task
+(many tiles) are visible. Records have the same fields as records of the
+C++ benchmark nntile_submission with path "python", so that both can be
+compared: submission rate is the number of tasks divided by time of the
+submission loop, while task rate also includes waiting for all the tasks.
+"""
+
+import argparse
+import json
+import subprocess
+import sys
+import time
+from typing import Dict, List
+
+SCHEDS = "dmda,eager,lws,nntile_locality"
+
+def run_point(args) -> List[Dict]:
+    """Measure all operations and numbers of tiles in this process"""
+    import nntile
+    config = nntile.starpu.Config(args.ncpus, args.ncuda, 1, args.sched)
+    nntile.starpu.init()
+    ops = {
+            "clear": lambda x, y: nntile.tensor.clear_async(y),
+            "add": lambda x, y: nntile.tensor.add_async(1.0, x, 1.0, y),
+            }
+    results = []
+    next_tag = 0
+    ntiles = 1
+    while ntiles <= args.max_ntiles:
+        traits = nntile.tensor.TensorTraits([ntiles*args.tile], [args.tile])
+        distr = [0] * ntiles
+        x = nntile.tensor.Tensor_fp32(traits, distr, next_tag)
+        next_tag = x.next_tag
+        y = nntile.tensor.Tensor_fp32(traits, distr, next_tag)
+        next_tag = y.next_tag
+        nntile.tensor.clear_async(x)
+        for op, submit in ops.items():
+            # Warmup allocates tiles
+            submit(x, y)
+            nntile.starpu.wait_for_all()
+            time0 = time.perf_counter()
+            for i in range(args.niters):
+                submit(x, y)
+            time1 = time.perf_counter()
+            nntile.starpu.wait_for_all()
+            time2 = time.perf_counter()
+            ntasks = ntiles * args.niters
+            result = {
+                    "sched": args.sched,
+                    "op": op,
+                    "path": "python",
+                    "dtype": "fp32",
+                    "ntiles": ntiles,
+                    "ntasks": ntasks,
+                    "submit_rate": ntasks / (time1-time0),
+                    "task_rate": ntasks / (time2-time0),
+                    "submit_us": (time1-time0) / ntasks * 1e6,
+                    }
+            print(json.dumps(result), file=sys.stderr, flush=True)
+            results.append(result)
+        x.unregister()
+        y.unregister()
+        ntiles *= 16
+    return results
+
+def main(argv=None):
+    parser = argparse.ArgumentParser( \
+            prog="python -m nntile.benchmark_submission", \
+            description="Throughput of submission of tiny tasks")
+    parser.add_argument("--scheds", default=SCHEDS, \
+            help="Comma-separated list of scheduling policies")
+    parser.add_argument("--output", default="submission_python.json")
+    # Options of a single policy, that are passed to subprocesses
+    point = parser.add_argument_group("point")
+    point.add_argument("--niters", type=int, default=5)
+    point.add_argument("--max-ntiles", type=int, default=65536)
+    point.add_argument("--tile", type=int, default=16)
+    point.add_argument("--ncpus", type=int, default=-1)
+    point.add_argument("--ncuda", type=int, default=-1)
+    # Internal options of a subprocess
+    parser.add_argument("--sched", help=argparse.SUPPRESS)
+    args = parser.parse_args(argv)
+    if args.niters <= 0 or args.max_ntiles <= 0 or args.tile <= 0:
+        raise ValueError("Number of iterations, tiles and size of tiles " \
+                "shall be positive")
+    if args.sched is not None:
+        print(json.dumps(run_point(args)), flush=True)
+        return
+    point_args = []
+    for action in point._group_actions:
+        point_args.extend([action.option_strings[0], \
+                str(getattr(args, action.dest))])
+    results = []
+    failed = False
+    for sched in args.scheds.split(","):
+        cmd = [sys.executable, "-m", "nntile.benchmark_submission", \
+                "--sched", sched] + point_args
+        proc = subprocess.run(cmd, stdout=subprocess.PIPE, \
+                universal_newlines=True)
+        lines = [l for l in proc.stdout.splitlines() if l.startswith("[")]
+        if proc.returncode != 0 or not lines:
+            results.append({"sched": sched, "error": proc.returncode})
+            failed = True
+        else:
+            results.extend(json.loads(lines[-1]))
+    with open(args.output, "w") as f:
+        json.dump({"benchmark": "submission", "time": time.time(), \
+                "results": results}, f, indent=1)
+    if failed:
+        sys.exit(1)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,68 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/bucketing.py
+# Bucketing of variable-length sequences by their lengths
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+"""Buckets of sequence lengths
+
+A model, that is built for the longest sequences, pays the full cost of
+attention and of all the activations for every short sequence. Instead,
+several instances of the model for a few sequence lengths share parameters
+and optimizer states (see GPT2Model.create_buckets), and every minibatch is
+processed by the instance of its length (see nntile.pipeline.Pipeline).
+
+Tokenized documents are cut into rows of bucket lengths without padding: a
+document takes rows of the longest bucket, that fits into the rest of it,
+so a short document is a single short row. Inputs and labels of a row are
+its tokens shifted by one. The rest of a document, that is shorter than the
+shortest bucket, is dropped.
+"""
+
+import numpy as np
+from typing import List, Tuple
+
+def bucket_sequences(seqs: List[List[int]], seq_lens: List[int], \
+        minibatch_size: int) -> List[Tuple[np.ndarray, np.ndarray]]:
+    """Cut tokenized documents into minibatches of bucket lengths
+
+    Parameters:
+        seqs: tokenized documents
+        seq_lens: lengths of buckets
+        minibatch_size: number of rows of a minibatch
+
+    Returns inputs and labels of minibatches of shape [minibatch_size,
+    seq_len] for lengths seq_len of buckets, in the order, in which
+    minibatches are filled. Incomplete minibatches are dropped.
+    """
+    if minibatch_size <= 0:
+        raise ValueError("minibatch_size shall be positive")
+    if len(seq_lens) == 0 or min(seq_lens) <= 0:
+        raise ValueError("Lengths of buckets shall be positive")
+    seq_lens = sorted(set(seq_lens), reverse=True)
+    # Rows of minibatches of every bucket, that are not complete yet
+    rows = {seq_len: [] for seq_len in seq_lens}
+    minibatches = []
+    for seq in seqs:
+        seq = np.asarray(seq, dtype=np.int64)
+        start = 0
+        while True:
+            # The longest bucket, that fits into the rest of the document
+            rest = seq.size - 1 - start
+            seq_len = next((n for n in seq_lens if n <= rest), None)
+            if seq_len is None:
+                break
+            rows[seq_len].append(seq[start:start+seq_len+1])
+            start += seq_len
+            if len(rows[seq_len]) == minibatch_size:
+                tokens = np.array(rows[seq_len])
+                minibatches.append((tokens[:, :-1], tokens[:, 1:]))
+                rows[seq_len] = []
+    return minibatches
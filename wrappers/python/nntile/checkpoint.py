@@ -0,0 +1,449 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/checkpoint.py
+# Sharded binary checkpoints of tensors, that are written and read by owners
+# of tiles
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-14
+
+"""Sharded binary checkpoints of tensors
+
+A checkpoint is a directory with a binary file rank{r}.bin for every MPI node
+and an index.json, that describes all the tensors. Every tile is stored in
+the file of its owner at an offset, aligned to a page, in a Fortran order
+without any header. The layout depends only on shapes, tiles and
+distributions of tensors, so every node computes it without communications
+and writes its tiles directly from their StarPU handles in parallel with
+other nodes.
+
+Writes are StarPU tasks, that only read tiles, so save_async returns right
+after submission and the checkpoint is written while the next steps of
+training are computed. Updates of the tensors wait only for writes of their
+own tiles. The index is written by PendingCheckpoint.wait() after all the
+tiles are stored, so a checkpoint without an index is incomplete.
+
+Writes of save_async hold tiles until they are on disk. snapshot_async
+copies tiles into staging tensors in RAM by tasks instead, so updates of
+tensors wait only for a copy, and a separate host thread writes staging
+tiles into files without occupying StarPU workers. Both are consistent at
+the point of submission, e.g. at a boundary of training iterations.
+
+Tiles can be read back into existing tensors by load_async even with a
+different distribution, if all the files are visible to every node, or
+registered right in memory-mapped files by load_mmap without any copies.
+
+CheckpointManager keeps the last checkpoints of a training run in
+subdirectories step{n} of a root directory. After a failure, training is
+restarted from the last complete checkpoint, possibly on a different number
+of MPI nodes: a new model places its tiles onto the new nodes, and every
+node reads only its own tiles right from files of the old owners, so no
+tensor is gathered on a single node.
+"""
+
+import nntile
+from nntile.tensor import TensorTraits, Tensor_fp64, Tensor_fp32, \
+        Tensor_fp16, Tensor_bf16, Tensor_int64, Tensor_bool, Tensor_int8, \
+        Tensor_fp8_e4m3
+import numpy as np
+import json
+import os
+import re
+import shutil
+import threading
+from typing import Dict, List, Optional
+
+# Tiles start at offsets, aligned to this number of bytes
+ALIGNMENT = 4096
+
+# Type name and size of an element of every tensor type
+_dtypes = {
+        Tensor_fp64: ("fp64", 8),
+        Tensor_fp32: ("fp32", 4),
+        Tensor_fp16: ("fp16", 2),
+        Tensor_bf16: ("bf16", 2),
+        Tensor_int64: ("int64", 8),
+        Tensor_bool: ("bool", 1),
+        Tensor_int8: ("int8", 1),
+        Tensor_fp8_e4m3: ("fp8_e4m3", 1),
+        }
+
+_tensor_types = {name: cls for cls, (name, size) in _dtypes.items()}
+
+# Types, that are registered from memory-mapped files without conversion
+_numpy_dtypes = {
+        "fp64": np.float64,
+        "fp32": np.float32,
+        "int64": np.int64,
+        "bool": np.bool_,
+        "int8": np.int8,
+        }
+
+def state_tensors(params, **states):
+    """Dictionary of values of parameters and lists of state tensors
+
+    Names are "params.{i}" for values of parameters and "{state}.{i}" for
+    tensors of each list of states. None entries of lists of states, e.g.,
+    absent factors of moments of some parameters, are skipped.
+    """
+    tensors = {"params.{}".format(i): p.value for i, p in enumerate(params)}
+    for state, values in states.items():
+        for i, x in enumerate(values):
+            if x is not None:
+                tensors["{}.{}".format(state, i)] = x
+    return tensors
+
+def _rank_file(r: int):
+    return "rank{}.bin".format(r)
+
+def _tile_shapes(traits):
+    return [traits.get_tile_shape(traits.grid.linear_to_index(i)) \
+            for i in range(traits.grid.nelems)]
+
+# Place every tile of every tensor into the file of its owner
+def _layout(tensors: Dict):
+    sizes = {}
+    index = {}
+    for name, x in tensors.items():
+        if type(x) not in _dtypes:
+            raise TypeError("Unsupported type of tensor {}".format(name))
+        dtype, elem_size = _dtypes[type(x)]
+        tiles = []
+        for r, shape in zip(x.distribution, _tile_shapes(x)):
+            offset = sizes.get(r, 0)
+            offset = -(-offset // ALIGNMENT) * ALIGNMENT
+            nbytes = int(np.prod(shape)) * elem_size
+            tiles.append([_rank_file(r), offset, nbytes])
+            sizes[r] = offset + nbytes
+        index[name] = {"dtype": dtype, "shape": list(x.shape), \
+                "basetile_shape": list(x.basetile_shape), \
+                "distribution": list(x.distribution), "tiles": tiles}
+    return index, sizes
+
+class PendingCheckpoint(object):
+    """Checkpoint, that is being written
+
+    Call wait() before the saved tensors are unregistered.
+    """
+
+    def __init__(self, path: str, index: Dict):
+        self.path = path
+        self.index = index
+        self.done = False
+
+    def wait(self):
+        """Wait for all the tiles and write the index
+
+        Waits for all the submitted tasks of all the MPI nodes.
+        """
+        if self.done:
+            return
+        nntile.starpu.wait_for_all()
+        self.done = True
+        nerrors = nntile.starpu.tile_io_nerrors()
+        if nerrors > 0:
+            raise IOError("Failed to write {} tiles of checkpoint {}" \
+                    .format(nerrors, self.path))
+        self._write_index()
+
+    def _write_index(self):
+        if nntile.starpu.mpi_world_rank() != 0:
+            return
+        # Index appears only after it is completely written
+        tmp = os.path.join(self.path, "index.json.tmp")
+        with open(tmp, "w") as fp:
+            json.dump(self.index, fp)
+        os.replace(tmp, os.path.join(self.path, "index.json"))
+
+class PendingSnapshot(PendingCheckpoint):
+    """Checkpoint, that is written from staging tensors by a host thread
+
+    Saved tensors may be updated and unregistered right away. Call wait()
+    to release the staging tensors and write the index.
+    """
+
+    def __init__(self, path: str, index: Dict, staging: Dict):
+        super().__init__(path, index)
+        self.staging = staging
+        self.error = None
+        self.thread = threading.Thread(target=self._write, daemon=True)
+        self.thread.start()
+
+    # Write staging tiles, as soon as they are copied
+    def _write(self):
+        try:
+            for name, x in self.staging.items():
+                tiles = self.index["tensors"][name]["tiles"]
+                x.write_tiles_acquire([os.path.join(self.path, t[0]) \
+                        for t in tiles], [t[1] for t in tiles])
+        except Exception as e:
+            self.error = e
+
+    def is_written(self):
+        """Check if all the local tiles are already written"""
+        return not self.thread.is_alive()
+
+    def wait(self):
+        """Wait for the host thread and write the index
+
+        Synchronizes all the MPI nodes, but does not wait for other tasks.
+        """
+        if self.done:
+            return
+        self.thread.join()
+        self.done = True
+        for x in self.staging.values():
+            x.unregister()
+        self.staging = {}
+        if self.error is not None:
+            raise IOError("Failed to write checkpoint {}: {}" \
+                    .format(self.path, self.error))
+        nntile.starpu.mpi_barrier()
+        self._write_index()
+
+# Create directory and allocate file of the current node
+def _prepare_files(path: str, tensors: Dict, attrs: Optional[Dict]):
+    index, sizes = _layout(tensors)
+    rank = nntile.starpu.mpi_world_rank()
+    os.makedirs(path, exist_ok=True)
+    filename = os.path.join(path, _rank_file(rank))
+    with open(filename, "wb") as fp:
+        fp.truncate(sizes.get(rank, 0))
+    return {"version": 1, "world_size": nntile.starpu.mpi_world_size(), \
+            "attrs": attrs if attrs is not None else {}, "tensors": index}
+
+def save_async(path: str, tensors: Dict, attrs: Optional[Dict]=None):
+    """Submit writes of tensors into a checkpoint directory
+
+    Parameters:
+        path: checkpoint directory, that is created if needed
+        tensors: dictionary of tensors by names, that shall be the same on
+            all the MPI nodes
+        attrs: JSON-serializable attributes, stored in the index
+
+    Returns PendingCheckpoint.
+    """
+    # File of the current node is allocated before any tile is written
+    index = _prepare_files(path, tensors, attrs)
+    for name, x in tensors.items():
+        tiles = index["tensors"][name]["tiles"]
+        x.write_tiles_async([os.path.join(path, t[0]) for t in tiles], \
+                [t[1] for t in tiles])
+    return PendingCheckpoint(path, index)
+
+def snapshot_async(path: str, tensors: Dict, next_tag: int, \
+        attrs: Optional[Dict]=None):
+    """Submit copies of tensors into staging tensors and write them into a
+    checkpoint directory by a host thread
+
+    Parameters are the same as of save_async, next_tag is used for staging
+    tensors.
+
+    Returns PendingSnapshot and the next tag.
+    """
+    index = _prepare_files(path, tensors, attrs)
+    staging = {}
+    for name, x in tensors.items():
+        traits = TensorTraits(x.shape, x.basetile_shape)
+        y = type(x)(traits, x.distribution, next_tag)
+        next_tag = y.next_tag
+        x.stage_tiles_async(y)
+        staging[name] = y
+    return PendingSnapshot(path, index, staging), next_tag
+
+def save(path: str, tensors: Dict, attrs: Optional[Dict]=None):
+    """Blocking version of save_async"""
+    save_async(path, tensors, attrs).wait()
+
+def read_index(path: str):
+    """Read index of a complete checkpoint"""
+    with open(os.path.join(path, "index.json"), "r") as fp:
+        return json.load(fp)
+
+def read_attrs(path: str):
+    """Read attributes of a checkpoint"""
+    return read_index(path)["attrs"]
+
+def load_async(path: str, tensors: Dict):
+    """Submit reads of tiles of a checkpoint into existing tensors
+
+    Tensors shall have the same types and tiles as the saved ones, but their
+    distributions may be different, if files of all the MPI nodes are
+    visible to the current one. Errors of reads are reported by
+    nntile.starpu.tile_io_nerrors().
+
+    Returns attributes of the checkpoint.
+    """
+    index = read_index(path)
+    for name, x in tensors.items():
+        info = index["tensors"][name]
+        if _dtypes[type(x)][0] != info["dtype"]:
+            raise TypeError("Type of tensor {} does not match checkpoint" \
+                    .format(name))
+        if list(x.shape) != info["shape"] or \
+                list(x.basetile_shape) != info["basetile_shape"]:
+            raise ValueError("Tiles of tensor {} do not match checkpoint" \
+                    .format(name))
+        tiles = info["tiles"]
+        x.read_tiles_async([os.path.join(path, t[0]) for t in tiles], \
+                [t[1] for t in tiles])
+    return index["attrs"]
+
+def load(path: str, tensors: Dict):
+    """Blocking version of load_async"""
+    attrs = load_async(path, tensors)
+    nntile.starpu.wait_for_all()
+    nerrors = nntile.starpu.tile_io_nerrors()
+    if nerrors > 0:
+        raise IOError("Failed to read {} tiles of checkpoint {}" \
+                .format(nerrors, path))
+    return attrs
+
+def load_mmap(path: str, next_tag: int, names=None):
+    """Register tensors of a checkpoint right in memory-mapped files
+
+    Local tiles are mapped privately: changes of the tensors are not written
+    back into the files. Tiles keep the saved distribution, if the number of
+    MPI nodes is the same, otherwise the owner of a tile is its saved owner
+    modulo the number of nodes. Only types with a numpy counterpart are
+    supported, tensors of other types shall be loaded by load_async.
+
+    Returns dictionary of tensors by names and the next tag.
+    """
+    index = read_index(path)
+    world_size = nntile.starpu.mpi_world_size()
+    rank = nntile.starpu.mpi_world_rank()
+    if names is None:
+        names = list(index["tensors"].keys())
+    tensors = {}
+    for name in names:
+        info = index["tensors"][name]
+        if info["dtype"] not in _numpy_dtypes:
+            raise TypeError("Tensor {} of type {} cannot be memory-mapped" \
+                    .format(name, info["dtype"]))
+        dtype = _numpy_dtypes[info["dtype"]]
+        traits = TensorTraits(info["shape"], \
+                info["basetile_shape"])
+        distr = info["distribution"]
+        if index["world_size"] != world_size:
+            distr = [r % world_size for r in distr]
+        buffers = []
+        for r, shape, tile in zip(distr, _tile_shapes(traits), \
+                info["tiles"]):
+            if r != rank:
+                buffers.append(np.empty(0, dtype=dtype))
+                continue
+            buffers.append(np.memmap(os.path.join(path, tile[0]), \
+                    dtype=dtype, mode="c", offset=tile[1], \
+                    shape=tuple(shape), order="F"))
+        x = _tensor_types[info["dtype"]].from_buffers(traits, distr, \
+                next_tag, buffers)
+        next_tag = x.next_tag
+        tensors[name] = x
+    return tensors, next_tag
+
+class CheckpointManager(object):
+    """Rotation of checkpoints of a training run and restart from the last
+    complete one
+
+    Checkpoints are written into subdirectories step{n} of the root by
+    save_async or snapshot_async. At most one checkpoint is being written at
+    a time: a new one waits for the previous one, and then only the last
+    keep complete checkpoints are left. Directories of checkpoints, that
+    were interrupted by a failure, have no index and are never restored.
+
+    Parameters:
+        root: directory for checkpoints, shared by all the MPI nodes
+        keep: number of complete checkpoints to keep
+    """
+
+    def __init__(self, root: str, keep: int=2):
+        if keep < 1:
+            raise ValueError("At least one checkpoint shall be kept")
+        self.root = root
+        self.keep = keep
+        self.pending = None
+
+    def path(self, step: int) -> str:
+        return os.path.join(self.root, "step{}".format(step))
+
+    def steps(self) -> List[int]:
+        """Steps of complete checkpoints in ascending order"""
+        if not os.path.isdir(self.root):
+            return []
+        result = []
+        for name in os.listdir(self.root):
+            m = re.fullmatch(r"step(\d+)", name)
+            if m is not None and os.path.exists(os.path.join(self.root, \
+                    name, "index.json")):
+                result.append(int(m.group(1)))
+        return sorted(result)
+
+    def latest(self) -> Optional[int]:
+        """Step of the last complete checkpoint or None"""
+        steps = self.steps()
+        return steps[-1] if steps else None
+
+    def wait(self):
+        """Wait for the checkpoint, that is being written, and remove old
+        ones"""
+        if self.pending is None:
+            return
+        self.pending.wait()
+        self.pending = None
+        if nntile.starpu.mpi_world_rank() == 0:
+            for step in self.steps()[:-self.keep]:
+                shutil.rmtree(self.path(step), ignore_errors=True)
+
+    # Prepare directory of a new checkpoint
+    def _start(self, step: int, attrs: Optional[Dict]):
+        self.wait()
+        path = self.path(step)
+        # Checkpoint of the same step from an interrupted run is replaced,
+        # and it shall not look complete meanwhile
+        if nntile.starpu.mpi_world_rank() == 0:
+            index = os.path.join(path, "index.json")
+            if os.path.exists(index):
+                os.remove(index)
+        nntile.starpu.mpi_barrier()
+        attrs = dict(attrs) if attrs is not None else {}
+        attrs["step"] = step
+        return path, attrs
+
+    def save_async(self, step: int, tensors: Dict, \
+            attrs: Optional[Dict]=None):
+        """Submit writes of a checkpoint of a step (see save_async)"""
+        path, attrs = self._start(step, attrs)
+        self.pending = save_async(path, tensors, attrs)
+        return self.pending
+
+    def snapshot_async(self, step: int, tensors: Dict, next_tag: int, \
+            attrs: Optional[Dict]=None):
+        """Submit a snapshot of a step (see snapshot_async)
+
+        Returns PendingSnapshot and the next tag.
+        """
+        path, attrs = self._start(step, attrs)
+        self.pending, next_tag = snapshot_async(path, tensors, next_tag, \
+                attrs)
+        return self.pending, next_tag
+
+    def restore(self, tensors: Dict) -> Optional[Dict]:
+        """Read the last complete checkpoint into tensors
+
+        Tensors shall have the same types and tiles as the saved ones, while
+        their distributions may correspond to a different number of MPI
+        nodes (see load_async). All the nodes shall see the same root.
+
+        Returns attributes of the checkpoint with its step or None, if there
+        is no complete checkpoint.
+        """
+        step = self.latest()
+        if step is None:
+            return None
+        return load(self.path(step), tensors)
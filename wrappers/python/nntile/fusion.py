@@ -0,0 +1,179 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/fusion.py
+# Lazy mode, that fuses chains of elementwise operations on tensors
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-15
+
+from .nntile_core import tensor as core_tensor
+
+# Codes of operations, the same as nntile::kernel::fused_elementwise::opcode_t
+_ADD, _PROD, _SCAL, _ADD_SCALAR, _HYPOT, _SQRT = range(6)
+# Limits of a single fused program, the same as in the kernel
+_MAX_OPS = 32
+_MAX_BUFFERS = 16
+# Precisions, supported by fused_elementwise
+_suffixes = ["fp32", "fp64"]
+# Fusion, that is currently active
+_fusing = None
+
+class Fusion(object):
+    """Lazy mode, that fuses consecutive elementwise operations
+
+    Inside of the context, calls to add_async, prod_async, scal_async,
+    scal_inplace_async, axpy_async (with a scalar alpha), add_scalar_async,
+    hypot_async, sqrt_async and sqrt_inplace_async are not submitted at once.
+    Consecutive calls on tensors with the same shape, basetile and
+    distribution are recorded into a program, which is submitted by
+    fused_elementwise_async as a single task per tile. Any other operation
+    (including reading of a tensor) submits the recorded program first, so
+    the order of operations is preserved.
+
+    Fusion can be used during capture of a TaskGraph, while a TaskGraph
+    cannot be captured inside of fusion.
+    """
+
+    def __init__(self):
+        self.ops = []
+        self.buffers = []
+        self.key = None
+        self.saved = []
+
+    def _index(self, x):
+        for i, buf in enumerate(self.buffers):
+            if buf is x:
+                return i
+        self.buffers.append(x)
+        return len(self.buffers) - 1
+
+    def _append(self, suffix, code, src, dst, alpha=0.0, beta=0.0):
+        """Record an operation, return False if it cannot be fused"""
+        key = (suffix, tuple(dst.shape), tuple(dst.basetile_shape), \
+                tuple(dst.distribution))
+        src_key = (suffix, tuple(src.shape), tuple(src.basetile_shape), \
+                tuple(src.distribution))
+        if src_key != key:
+            self.flush()
+            return False
+        nnew = len({id(src), id(dst)} - {id(buf) for buf in self.buffers})
+        if key != self.key or len(self.ops) == _MAX_OPS \
+                or len(self.buffers)+nnew > _MAX_BUFFERS:
+            self.flush()
+            self.key = key
+        self.ops.append((code, self._index(src), self._index(dst), alpha, \
+                beta))
+        return True
+
+    def flush(self):
+        """Submit recorded operations"""
+        if self.ops:
+            self.fused[self.key[0]](self.ops, self.buffers)
+        self.ops = []
+        self.buffers = []
+        self.key = None
+
+    def _flushing(self, op):
+        def flushing_op(*args, **kwargs):
+            self.flush()
+            return op(*args, **kwargs)
+        return flushing_op
+
+    def _patch(self, obj, name, new):
+        self.saved.append((obj, name, getattr(obj, name)))
+        setattr(obj, name, new)
+
+    def _fused_ops(self, suffix):
+        """Recording versions of elementwise operations of a precision"""
+        # Original operations are called, if arguments cannot be fused
+        orig = {name: getattr(core_tensor, name+"_"+suffix) for name in \
+                ["add_async", "prod_async", "scal_async", "hypot_async", \
+                "sqrt_async", "axpy_async"]}
+        tensor_type = getattr(core_tensor, "Tensor_"+suffix)
+        def add(alpha, x, beta, y):
+            if not self._append(suffix, _ADD, x, y, alpha, beta):
+                orig["add_async"](alpha, x, beta, y)
+        def prod(x, y):
+            if not self._append(suffix, _PROD, x, y):
+                orig["prod_async"](x, y)
+        def scal(alpha, x, y):
+            if not self._append(suffix, _SCAL, x, y, alpha):
+                orig["scal_async"](alpha, x, y)
+        def scal_inplace(alpha, x):
+            self._append(suffix, _SCAL, x, x, alpha)
+        def add_scalar(alpha, beta, x):
+            self._append(suffix, _ADD_SCALAR, x, x, alpha, beta)
+        def hypot(alpha, x, beta, y):
+            if not self._append(suffix, _HYPOT, x, y, alpha, beta):
+                orig["hypot_async"](alpha, x, beta, y)
+        def sqrt(x, y):
+            if not self._append(suffix, _SQRT, x, y):
+                orig["sqrt_async"](x, y)
+        def sqrt_inplace(x):
+            self._append(suffix, _SQRT, x, x)
+        def axpy(alpha, x, y):
+            # Tensor alpha is not supported by fused programs
+            if isinstance(alpha, tensor_type) \
+                    or not self._append(suffix, _ADD, x, y, alpha, 1.0):
+                self.flush()
+                orig["axpy_async"](alpha, x, y)
+        return {"add_async": add, "prod_async": prod, "scal_async": scal, \
+                "scal_inplace_async": scal_inplace, \
+                "add_scalar_async": add_scalar, "hypot_async": hypot, \
+                "sqrt_async": sqrt, "sqrt_inplace_async": sqrt_inplace, \
+                "axpy_async": axpy}
+
+    def __enter__(self):
+        global _fusing
+        if _fusing is not None:
+            raise RuntimeError("Nested fusion")
+        self.fused = {suffix: getattr(core_tensor, \
+                "fused_elementwise_async_"+suffix) for suffix in _suffixes}
+        recorded = {}
+        for suffix in _suffixes:
+            for name, op in self._fused_ops(suffix).items():
+                recorded[name+"_"+suffix] = op
+        for name in dir(core_tensor):
+            obj = getattr(core_tensor, name)
+            if name.startswith("_") or not callable(obj):
+                continue
+            if isinstance(obj, type):
+                # Methods of tensor classes
+                if not name.startswith("Tensor_"):
+                    continue
+                for method in dir(obj):
+                    value = getattr(obj, method)
+                    if method.startswith("_") or not callable(value):
+                        continue
+                    self._patch(obj, method, self._flushing(value))
+            elif name in recorded:
+                self._patch(core_tensor, name, recorded[name])
+            else:
+                self._patch(core_tensor, name, self._flushing(obj))
+        _fusing = self
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        global _fusing
+        try:
+            if exc_type is None:
+                self.flush()
+        finally:
+            for obj, name, value in reversed(self.saved):
+                setattr(obj, name, value)
+            self.saved = []
+            self.ops = []
+            self.buffers = []
+            self.key = None
+            _fusing = None
+        return False
+
+def fuse():
+    """Context manager, that fuses chains of elementwise operations"""
+    return Fusion()
+
@@ -0,0 +1,137 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/graph.py
+# Capture and replay of a sequence of submitted operations
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-07
+
+from .nntile_core import tensor as core_tensor, starpu as core_starpu
+from . import fusion
+
+# Methods of tensors, that submit tasks and are recorded during capture
+_recorded_methods = ["wont_use", "invalidate_submit"]
+# Functions of StarPU, that are recorded during capture, so that replayed
+# tasks are traced with their scopes
+_recorded_starpu = ["trace_scope_set"]
+# Methods of tensors, that depend on actual data or destroy tensors, and
+# therefore cannot be replayed
+_forbidden_methods = ["from_array", "to_array", "unregister"]
+# Graph, that is currently being captured
+_capturing = None
+
+class TaskGraph(object):
+    """Sequence of submitted operations, that can be replayed
+
+    During capture every call to the core tensor operations (and task
+    submitting methods of tensors) is forwarded as usual and recorded
+    together with its arguments. Replay calls the recorded operations again
+    directly, skipping all the Python logic of layers, models and type
+    dispatch, that produced them. Replay with new data is done by updating
+    contents of the captured tensors, e.g., by copy_async into an input
+    activation before replay.
+
+    Captured code shall not depend on values of tensors, shall not create
+    tensors, that are unregistered before replay, and shall not use scalars,
+    that change between iterations (like a step counter of an optimizer).
+    Reading or unregistering tensors during capture raises an error.
+
+    Capture with submit=False only records operations without submitting
+    them, e.g., to find out which tensors are used by a piece of code (see
+    nntile.memory_planner).
+    """
+    def __init__(self):
+        self.ops = []
+
+    def __len__(self):
+        return len(self.ops)
+
+    def capture(self, submit: bool=True):
+        """Context manager, that records operations into the graph"""
+        return _Capture(self, submit)
+
+    def replay(self):
+        """Submit all the recorded operations again"""
+        if _capturing is not None:
+            raise RuntimeError("Cannot replay a graph during capture")
+        for op, args, kwargs in self.ops:
+            op(*args, **kwargs)
+
+    def clear(self):
+        """Drop recorded operations and references to their arguments"""
+        self.ops = []
+
+
+class _Capture(object):
+    def __init__(self, graph: TaskGraph, submit: bool=True):
+        self.graph = graph
+        self.submit = submit
+        self.saved = []
+
+    def _record(self, op):
+        ops = self.graph.ops
+        submit = self.submit
+        def recorded_op(*args, **kwargs):
+            ops.append((op, args, kwargs))
+            if submit:
+                return op(*args, **kwargs)
+        return recorded_op
+
+    @staticmethod
+    def _forbidden(name):
+        def forbidden_op(*args, **kwargs):
+            raise RuntimeError("{} cannot be called during capture of a " \
+                    "task graph".format(name))
+        return forbidden_op
+
+    def _patch(self, obj, name, new):
+        self.saved.append((obj, name, getattr(obj, name)))
+        setattr(obj, name, new)
+
+    def __enter__(self):
+        global _capturing
+        if _capturing is not None:
+            raise RuntimeError("Nested capture of task graphs")
+        if fusion._fusing is not None:
+            raise RuntimeError("Cannot capture a task graph during fusion")
+        self.graph.clear()
+        for name in dir(core_tensor):
+            obj = getattr(core_tensor, name)
+            if name.startswith("_") or not callable(obj):
+                continue
+            if isinstance(obj, type):
+                # Methods of tensor classes
+                if not name.startswith("Tensor_"):
+                    continue
+                for method in _recorded_methods:
+                    if hasattr(obj, method):
+                        self._patch(obj, method, \
+                                self._record(getattr(obj, method)))
+                for method in _forbidden_methods:
+                    if hasattr(obj, method):
+                        self._patch(obj, method, self._forbidden(method))
+            elif name in ["tensor_from_array", "tensor_to_array"]:
+                self._patch(core_tensor, name, self._forbidden(name))
+            else:
+                self._patch(core_tensor, name, self._record(obj))
+        for name in _recorded_starpu:
+            self._patch(core_starpu, name, \
+                    self._record(getattr(core_starpu, name)))
+        _capturing = self.graph
+        return self.graph
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        global _capturing
+        for obj, name, value in reversed(self.saved):
+            setattr(obj, name, value)
+        self.saved = []
+        _capturing = None
+        # Incomplete graph shall not be replayed
+        if exc_type is not None:
+            self.graph.clear()
+        return False
@@ -0,0 +1,426 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/inference.py
+# Continuous batching and speculative decoding of generation requests on top
+# of GPT2Model
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-04
+
+from nntile.layer import Linear
+from nntile.model.gpt2 import GPT2Model
+from nntile.tensor import TensorTraits, Tensor_int64, topk_async, \
+        topk_sample_async
+from collections import deque
+import numpy as np
+from typing import List, Optional
+
+class Request(object):
+    """Single generation request
+
+    Tokens of the prompt are followed by at most max_new_tokens generated
+    tokens. Generation stops at the eos_token_id, if it is set, or when the
+    sequence fills the KV-cache.
+    """
+
+    def __init__(self, prompt: List[int], max_new_tokens: int, \
+            eos_token_id: Optional[int]=None):
+        if len(prompt) == 0:
+            raise ValueError("Prompt shall not be empty")
+        if max_new_tokens <= 0:
+            raise ValueError("max_new_tokens shall be positive")
+        self.prompt = list(prompt)
+        self.max_new_tokens = max_new_tokens
+        self.eos_token_id = eos_token_id
+        self.tokens = []
+        self.done = False
+
+    # Number of tokens of the sequence
+    def __len__(self):
+        return len(self.prompt) + len(self.tokens)
+
+    # Token at position pos of the sequence
+    def __getitem__(self, pos: int):
+        if pos < len(self.prompt):
+            return self.prompt[pos]
+        return self.tokens[pos-len(self.prompt)]
+
+class InferenceEngine(object):
+    """Continuous batching of generation requests
+
+    Every sequence of a batch of the model is a slot, that processes a single
+    request at a time. Each step feeds a single new token of every active
+    slot, that is either the next token of the prompt or the last generated
+    token. Finished requests are evicted and queued requests are admitted
+    into free slots between steps, so short and long requests share the same
+    batch.
+
+    Keys and values are stored in a ring buffer: all the slots write new
+    keys and values at the same position of the KV-cache, that is advanced
+    after each step, and the mask of every slot enables only the positions of
+    its own sequence. GPT2 uses absolute positional embeddings, so the order
+    of keys within the cache does not matter. A sequence cannot be longer
+    than the KV-cache.
+
+    With paged KV-cache (kv_cache_pages>0 of GPT2Model) every slot gets pages
+    of the shared pool on demand instead, and a request is admitted only if
+    the pool has enough pages for its prompt and max_new_tokens. Pages are
+    returned to the pool as soon as the request finishes, so memory is not
+    reserved for the longest possible sequence of every slot.
+
+    Positional ids and the mask of the next step do not depend on generated
+    tokens, so they are uploaded while the current step is computed. Only
+    ids of new tokens wait for the logits.
+
+    New tokens are chosen on the device among the first vocab_size logits:
+    top_k candidates of every slot are found by topk_async and a token is
+    sampled by topk_sample_async with the given temperature and nucleus
+    top_p within the candidates, so only ids of tokens are read back. Zero
+    temperature means greedy choice.
+
+    The model shall be created by GPT2Model.from_torch with seq_len=1,
+    kv_cache_size>0 and kv_cache_per_sequence=True.
+    """
+
+    def __init__(self, model: GPT2Model, next_tag: int, \
+            vocab_size: Optional[int]=None, temperature: float=0.0, \
+            top_k: int=1, top_p: float=1.0, seed: int=0):
+        if model.kv_cache_size == 0 or not model.kv_cache_per_sequence:
+            raise ValueError("Model shall use KV-cache with positions of " \
+                    "every sequence")
+        if type(model.lm_head) is not Linear:
+            raise ValueError("Model shall output logits")
+        seq_len, n_slots = model.activations[0].value.shape
+        if seq_len != 1:
+            raise ValueError("Model shall process a single token per step")
+        self.model = model
+        self.logits = model.activations[-1].value
+        if vocab_size is None:
+            vocab_size = self.logits.shape[0]
+        if vocab_size > self.logits.shape[0]:
+            raise ValueError("vocab_size is larger than the number of logits")
+        if top_k <= 0 or top_k > vocab_size:
+            raise ValueError("top_k shall be in [1, vocab_size]")
+        self.vocab_size = vocab_size
+        self.temperature = temperature
+        self.top_p = top_p
+        self.seed = seed
+        self.nsteps = 0
+        # Candidates and chosen tokens of all the slots
+        traits = TensorTraits([top_k]+self.logits.shape[1:], \
+                [top_k]+self.logits.basetile_shape[1:])
+        distr = [0] * traits.grid.nelems
+        self.values = type(self.logits)(traits, distr, next_tag)
+        next_tag = self.values.next_tag
+        self.indices = Tensor_int64(traits, distr, next_tag)
+        next_tag = self.indices.next_tag
+        traits = TensorTraits(self.logits.shape[1:], \
+                self.logits.basetile_shape[1:])
+        distr = [0] * traits.grid.nelems
+        self.tokens = Tensor_int64(traits, distr, next_tag)
+        self.next_tag = self.tokens.next_tag
+        self.n_slots = n_slots
+        self.kv_cache_size = model.kv_cache_size
+        self.slots = [None] * n_slots
+        # Pages of every slot and the pool of free pages for paged KV-cache
+        self.paged = model.kv_cache_pages > 0
+        if self.paged:
+            self.page_size = model.mask.basetile_shape[0]
+            self.free_pages = list(range(model.kv_cache_pages))
+            # Pages, that are promised to admitted requests
+            self.reserved = 0
+            self.pages = [[] for i in range(n_slots)]
+            self.slot_reserved = [0] * n_slots
+        # Number of tokens of each slot, that are already in the KV-cache
+        self.cached = np.zeros(n_slots, dtype=np.int64)
+        self.queue = deque()
+        # Position of the KV-cache, where the next step writes
+        self.pos = 0
+        # Input of the next step is already uploaded except token ids
+        self.prepared = False
+        self.ids = np.zeros((1, n_slots), dtype=np.int64, order="F")
+        self.output = np.zeros((1, n_slots), dtype=np.int64, order="F")
+        model.reset_kv_cache_async()
+
+    # Queue a request for generation
+    def submit(self, request: Request):
+        if len(request.prompt) > self.kv_cache_size:
+            raise ValueError("Prompt does not fit into KV-cache")
+        if self.paged and self._npages(request) > self.model.kv_cache_pages:
+            raise ValueError("Request does not fit into pages of KV-cache")
+        self.queue.append(request)
+
+    # Number of pages for all the tokens, that a request feeds
+    def _npages(self, request: Request):
+        ntokens = min(len(request.prompt)+request.max_new_tokens-1, \
+                self.kv_cache_size)
+        return -(-ntokens // self.page_size)
+
+    # Check if there are any unfinished requests
+    def busy(self):
+        return len(self.queue) > 0 or any(s is not None for s in self.slots)
+
+    # Evict finished requests and admit queued ones into free slots
+    def _schedule(self):
+        for i, request in enumerate(self.slots):
+            if request is not None and request.done:
+                self.slots[i] = None
+                if self.paged:
+                    self.free_pages.extend(self.pages[i])
+                    self.pages[i] = []
+                    self.reserved -= self.slot_reserved[i]
+                    self.slot_reserved[i] = 0
+            if self.slots[i] is not None or not self.queue:
+                continue
+            if self.paged:
+                # Requests are admitted in order of arrival
+                npages = self._npages(self.queue[0])
+                if self.reserved+npages > self.model.kv_cache_pages:
+                    continue
+                self.reserved += npages
+                self.slot_reserved[i] = npages
+            self.slots[i] = self.queue.popleft()
+            self.cached[i] = 0
+
+    # Upload positional ids and the mask of the next step
+    def _prepare(self):
+        self._schedule()
+        if self.paged:
+            self._prepare_pages()
+            return
+        positions = np.zeros((1, self.n_slots), dtype=np.int64)
+        mask = np.zeros((self.kv_cache_size, 1, self.n_slots), dtype=bool)
+        for i, request in enumerate(self.slots):
+            # Free slot attends only to its own new token, which keeps its
+            # output finite
+            n = self.cached[i] if request is not None else 0
+            keys = np.arange(self.pos-n, self.pos+1) % self.kv_cache_size
+            mask[keys, 0, i] = True
+            positions[0, i] = n
+        self.model.set_kv_cache_state(self.pos, positions, mask)
+        self.prepared = True
+
+    # Take new pages from the pool and upload the mask of the next step
+    def _prepare_pages(self):
+        mask = np.zeros((self.kv_cache_size, 1, self.n_slots), dtype=bool)
+        for i, request in enumerate(self.slots):
+            if request is None:
+                continue
+            n = self.cached[i]
+            if n == len(self.pages[i]) * self.page_size:
+                self.pages[i].append(self.free_pages.pop())
+            mask[:n+1, 0, i] = True
+        self.model.set_kv_cache_pages(self.pages, self.cached.tolist(), mask)
+        self.prepared = True
+
+    # Perform a single step for all the active slots. Returns requests, that
+    # got a new token.
+    def step(self):
+        if not self.prepared:
+            self._prepare()
+        for i, request in enumerate(self.slots):
+            if request is not None and not request.done:
+                self.ids[0, i] = request[self.cached[i]]
+            else:
+                self.ids[0, i] = 0
+        self.model.activations[0].value.from_array(self.ids)
+        self.model.forward_async()
+        # Slots, that fed the last token of a sequence, get a new token
+        active = []
+        for i, request in enumerate(self.slots):
+            if request is None or request.done:
+                continue
+            self.cached[i] += 1
+            if self.cached[i] == len(request):
+                active.append((i, request))
+        self.pos = (self.pos+1) % self.kv_cache_size
+        # Sequences, that run out of new tokens or the KV-cache, finish at
+        # this step, so their slots are reused by the next step
+        for i, request in active:
+            if len(request.tokens)+1 == request.max_new_tokens \
+                    or len(request) == self.kv_cache_size:
+                request.done = True
+        # Choose new tokens on the device
+        if active:
+            topk_async(self.logits, self.values, self.indices, 0, \
+                    self.vocab_size)
+            topk_sample_async(self.values, self.indices, self.tokens, \
+                    self.temperature, self.top_p, self.seed+self.nsteps)
+        self.nsteps += 1
+        # Upload the next input while the current step is computed
+        self.prepared = False
+        if self.busy():
+            self._prepare()
+        if not active:
+            return []
+        self.tokens.to_array(self.output)
+        for i, request in active:
+            token = int(self.output[0, i])
+            request.tokens.append(token)
+            # Slot of a request, that generated EOS, is evicted one step
+            # later, as the next input is already uploaded
+            if token == request.eos_token_id:
+                request.done = True
+        return [request for i, request in active]
+
+    # Generate tokens for all the requests
+    def generate(self, requests: List[Request]):
+        for request in requests:
+            self.submit(request)
+        while self.busy():
+            self.step()
+        return requests
+
+    # Unregister candidates and chosen tokens
+    def unregister(self):
+        self.values.unregister()
+        self.indices.unregister()
+        self.tokens.unregister()
+
+class SpeculativeDecoder(object):
+    """Greedy speculative decoding of a single sequence with a draft model
+
+    The draft model proposes tokens one by one and the main model verifies
+    all of them by a single forward pass over a window of seq_len tokens:
+    the last token of the sequence followed by seq_len-1 draft tokens. Draft
+    tokens are accepted while they coincide with the greedy choice of the
+    main model and the choice of the main model after the last accepted
+    token is appended as well, so every pass of the main model produces at
+    least one token and the output is exactly the greedy output of the main
+    model. The prompt is fed to the main model by windows of seq_len tokens.
+
+    Keys and values of rejected tokens stay in KV-caches after the accepted
+    positions, where they are masked out and overwritten by the next
+    windows. Tokens are chosen on the device by topk_async, so only their
+    ids are read back.
+
+    Both models shall be created by GPT2Model.from_torch with batch_size=1,
+    kv_cache_size>0 and without kv_cache_per_sequence. The draft model
+    processes a single token per step and its KV-cache shall be at least as
+    large, as the KV-cache of the main model.
+    """
+
+    def __init__(self, model: GPT2Model, draft: GPT2Model, next_tag: int, \
+            vocab_size: Optional[int]=None):
+        for m in (model, draft):
+            if m.kv_cache_size == 0 or m.kv_cache_per_sequence:
+                raise ValueError("Models shall use KV-cache with shared " \
+                        "positions")
+            if type(m.lm_head) is not Linear:
+                raise ValueError("Models shall output logits")
+            if m.activations[0].value.shape[1] != 1:
+                raise ValueError("Models shall process a single sequence")
+        window = model.activations[0].value.shape[0]
+        if window < 2:
+            raise ValueError("Main model shall process at least 2 tokens")
+        if draft.activations[0].value.shape[0] != 1:
+            raise ValueError("Draft model shall process a single token")
+        if draft.kv_cache_size < model.kv_cache_size:
+            raise ValueError("KV-cache of the draft model is too small")
+        self.model = model
+        self.draft = draft
+        # Number of draft tokens per pass of the main model
+        self.k = window - 1
+        self.kv_cache_size = model.kv_cache_size
+        nlogits = min(model.activations[-1].value.shape[0], \
+                draft.activations[-1].value.shape[0])
+        if vocab_size is None:
+            vocab_size = nlogits
+        if vocab_size > nlogits:
+            raise ValueError("vocab_size is larger than the number of logits")
+        self.vocab_size = vocab_size
+        self.tensors = {}
+        for m in (model, draft):
+            logits = m.activations[-1].value
+            traits = TensorTraits([1]+logits.shape[1:], \
+                    [1]+logits.basetile_shape[1:])
+            distr = [0] * traits.grid.nelems
+            values = type(logits)(traits, distr, next_tag)
+            next_tag = values.next_tag
+            indices = Tensor_int64(traits, distr, next_tag)
+            next_tag = indices.next_tag
+            output = np.zeros(traits.shape, dtype=np.int64, order="F")
+            self.tensors[id(m)] = (values, indices, output)
+        self.next_tag = next_tag
+        # Passes of the main model and numbers of proposed and accepted
+        # draft tokens
+        self.nsteps = 0
+        self.nproposed = 0
+        self.naccepted = 0
+
+    # Feed tokens at positions starting at pos
+    def _feed(self, model: GPT2Model, pos: int, tokens: List[int]):
+        model.set_kv_cache_pos(pos)
+        ids = np.array(tokens, dtype=np.int64, order="F").reshape(-1, 1)
+        model.activations[0].value.from_array(ids)
+        model.forward_async()
+
+    # Greedy choice of the model after every token of the last forward pass
+    def _choose(self, model: GPT2Model) -> List[int]:
+        values, indices, output = self.tensors[id(model)]
+        topk_async(model.activations[-1].value, values, indices, 0, \
+                self.vocab_size)
+        indices.to_array(output)
+        return [int(x) for x in output[0, :, 0]]
+
+    # Generate tokens for a single request
+    def generate(self, request: Request) -> Request:
+        if len(request.prompt) > self.kv_cache_size:
+            raise ValueError("Prompt does not fit into KV-cache")
+        self.model.reset_kv_cache_async()
+        self.draft.reset_kv_cache_async()
+        # Numbers of tokens of the sequence, that are in KV-caches
+        cached = 0
+        draft_cached = 0
+        while not request.done:
+            n = len(request)
+            # Window shall fit into the KV-cache, so it may start before the
+            # first token, that is not in the KV-cache yet
+            start = min(cached, self.kv_cache_size-self.k-1)
+            pending = [request[i] for i in range(start, n)]
+            if len(pending) > self.k+1:
+                self._feed(self.model, start, pending[:self.k+1])
+                cached = start + self.k + 1
+                continue
+            # Draft model catches up with the sequence and proposes tokens
+            ndraft = self.k + 1 - len(pending)
+            drafts = []
+            for i in range(ndraft):
+                while draft_cached < n+i:
+                    token = request[draft_cached] if draft_cached < n \
+                            else drafts[draft_cached-n]
+                    self._feed(self.draft, draft_cached, [token])
+                    draft_cached += 1
+                drafts.append(self._choose(self.draft)[0])
+            # Verification of all the draft tokens by a single pass
+            self._feed(self.model, start, pending+drafts)
+            chosen = self._choose(self.model)[len(pending)-1:]
+            naccepted = 0
+            while naccepted < ndraft and \
+                    drafts[naccepted] == chosen[naccepted]:
+                naccepted += 1
+            cached = n + naccepted
+            draft_cached = min(draft_cached, n+naccepted)
+            self.nsteps += 1
+            self.nproposed += ndraft
+            self.naccepted += naccepted
+            for token in chosen[:naccepted+1]:
+                request.tokens.append(token)
+                # The last token of a full KV-cache gets no successor
+                if len(request.tokens) == request.max_new_tokens \
+                        or token == request.eos_token_id \
+                        or len(request) == self.kv_cache_size+1:
+                    request.done = True
+                    break
+        return request
+
+    # Unregister candidates and chosen tokens
+    def unregister(self):
+        for values, indices, output in self.tensors.values():
+            values.unregister()
+            indices.unregister()
@@ -14,12 +14,22 @@
 from .base_layer import BaseLayer
 from .act import Act
 from .linear import Linear
+from .factorized_linear import LowRankLinear, TTLinear
+from .tied_linear import TiedLinear
+from .linear_crossentropy import LinearCrossEntropy
 from .attention import Attention
 from .flash_attention import FlashAttention
+from .dropout import Dropout
 from .embedding import Embedding
+from .embedding_pos import EmbeddingPos
 from .layer_norm import LayerNorm
+from .batch_norm_act import BatchNormAct
+from .add_layer_norm import AddLayerNorm
+from .rms_norm import RMSNorm
+from .swiglu import SwiGLU
 from .fp32_to_fp16 import FP32_to_FP16
 from .fp16_to_fp32 import FP16_to_FP32
 from .add_slice import AddSlice
+from .moe import MoE
 
-from .mixer import Mixer, MixerMlp, GAP
+from .mixer import Mixer, MixerMlp, GAP, FusedMixer
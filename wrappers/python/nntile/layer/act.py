@@ -15,7 +15,7 @@ from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
         copy_async, prod_async, relu_async, relu_backward_async, gelu_async, \
         gelu_backward_async, gelutanh_async, gelutanh_backward_async, \
         gelutanh_inplace_async, relu_forward_async
-from nntile.layer.base_layer import BaseLayer
+from nntile.layer.base_layer import BaseLayer, cpp_class, cpp_moments
 import numpy as np
 from typing import List, Callable
 
@@ -30,11 +30,20 @@ class Act(BaseLayer):
     func: Callable[[Tensor], None]
     dfunc: Callable[[Tensor], None]
 
-    # Construct activation layer with all the provided data
-    def __init__(self, x: TensorMoments, y: TensorMoments, funcname: str):
+    # Construct activation layer with all the provided data. In-place layer
+    # overwrites X by Y, so Y.value shall be X.value and X shall have no
+    # other consumers. Backward of in-place ReLU uses the stored output, as
+    # Y > 0 exactly where X > 0, so no mask is stored at all. GELU is not
+    # monotonic and cannot be differentiated through its output, so
+    # in-place GELU supports only inference.
+    def __init__(self, x: TensorMoments, y: TensorMoments, funcname: str, \
+            inplace: bool=False):
         # Check if activation is actually implemented
         if funcname not in Act.activations:
             raise ValueError
+        if inplace and y.value is not x.value:
+            raise ValueError("In-place activation requires Y.value to be " \
+                    "X.value")
         # Redirect to BaseLayer initialization
         super().__init__([x], [y], [], [])
         # Set up local named parameters
@@ -42,25 +51,34 @@ class Act(BaseLayer):
         self.y = y
         self.funcname = funcname
         self.func, self.dfunc = Act.activations[funcname]
+        self.inplace = inplace
 
     # Simple generator for the normalization layer
     @staticmethod
-    def generate_simple(x: TensorMoments, funcname: str, next_tag: int):
+    def generate_simple(x: TensorMoments, funcname: str, next_tag: int, \
+            inplace: bool=False):
         # Get traits of X
         x_traits = TensorTraits(x.value.shape, x.value.basetile_shape)
         # Create Y with the same traits and distribution as X
-        y_value = type(x.value)(x_traits, x.value.distribution, next_tag)
-        next_tag = y_value.next_tag
+        if inplace:
+            y_value = x.value
+        else:
+            y_value = type(x.value)(x_traits, x.value.distribution, next_tag)
+            next_tag = y_value.next_tag
         y_grad = type(x.value)(x_traits, x.value.distribution, next_tag)
         next_tag = y_grad.next_tag
         y = TensorMoments(y_value, y_grad, True)
         # Create activation layer with all the provided tensors
-        layer = Act(x, y, funcname)
+        layer = Act(x, y, funcname, inplace)
         # Return layer and next tag to be used
         return (layer, next_tag)
 
     # Forward propagation of the activation layer
     def forward_async(self):
+        if self.inplace:
+            self.func(self.x.value)
+            self.x.value.wont_use()
+            return
         if self.funcname == "relu":
             relu_forward_async(self.x.value, self.y.value)
         if self.funcname == "gelutanh":
@@ -73,10 +91,25 @@ class Act(BaseLayer):
 
     # Backward propagation of the activation layer
     def backward_async(self):
-        # Gradient over X (input)
+        if self.inplace and self.funcname != "relu":
+            raise RuntimeError("In-place {} supports only inference" \
+                    .format(self.funcname))
+        # Gradient over X (input). Input of in-place ReLU is overwritten by
+        # its output with the same sign pattern.
         if self.x.grad_required:
             self.dfunc(self.x.value, self.y.grad, self.x.grad)
             self.x.value.wont_use()
             self.x.grad.wont_use()
             self.y.grad.wont_use()
 
+    # C++ counterpart of the layer
+    def to_cpp(self):
+        # C++ layer keeps input and output in different tensors
+        if self.inplace:
+            return None
+        cls = cpp_class("Act", self.x.value)
+        moments = [cpp_moments(t) for t in (self.x, self.y)]
+        if cls is None or None in moments:
+            return None
+        return cls(*moments, self.funcname)
+
@@ -15,7 +15,7 @@
 
 from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
         TransOp, trans, notrans, copy_async, gemm_async, randn_async, add_async
-from nntile.layer.base_layer import BaseLayer
+from nntile.layer.base_layer import BaseLayer, cpp_class, cpp_moments
 import numpy as np
 from typing import List
 
@@ -51,6 +51,13 @@ class Add(BaseLayer):
         self.y.grad.wont_use()
         self.res.grad.wont_use()
 
+    def to_cpp(self):
+        cls = cpp_class("Add", self.res.value)
+        moments = [cpp_moments(t) for t in (self.x, self.y, self.res)]
+        if cls is None or None in moments:
+            return None
+        return cls(*moments)
+
     def unregister(self):
         self.res.unregister()
 
@@ -0,0 +1,144 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/layer/add_layer_norm.py
+# AddLayerNorm layer of NNTile Python package, that fuses a residual
+# connection with the following layer normalization
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+from nntile.tensor import TensorTraits, TensorMoments, copy_async, \
+        add_async, add_layer_norm_async, add_layer_norm_backward_async
+from nntile.layer.base_layer import BaseLayer, cpp_class, cpp_moments
+from nntile.layer.layer_norm import LayerNorm
+
+class AddLayerNorm(BaseLayer):
+    x: TensorMoments
+    r: TensorMoments
+    res: TensorMoments
+    norm: LayerNorm
+
+    # Residual sum res = x + r and its normalization y, that are both
+    # outputs of the layer. Normalization is described by a LayerNorm of
+    # res, which is also used when the fused kernels do not apply.
+    def __init__(self, x: TensorMoments, r: TensorMoments, \
+            res: TensorMoments, norm: LayerNorm):
+        # Redirect to BaseLayer initialization
+        super().__init__([x, r], [res, norm.y], norm.parameters, \
+                norm.temporaries)
+        self.x = x
+        self.r = r
+        self.res = res
+        self.norm = norm
+        self.y = norm.y
+        self.gamma = norm.gamma
+        self.beta = norm.beta
+
+    # The fused kernel computes the sum, statistics and output of a tile by a
+    # single task. Distributions are checked at every call, as models assign
+    # ranks to layers after they are generated.
+    @property
+    def fused(self) -> bool:
+        distr = self.y.value.distribution
+        return self.norm.fused and self.res.value.distribution == distr
+
+    # Backward of the fused kernel accumulates gradients of both inputs,
+    # gamma and beta by the same task, so all of them shall be on one node
+    @property
+    def fused_backward(self) -> bool:
+        if not self.fused or self.x.grad is None or self.r.grad is None:
+            return False
+        rank = self.gamma.grad.distribution[0]
+        distr = self.res.grad.distribution + self.x.grad.distribution \
+                + self.r.grad.distribution + self.beta.grad.distribution
+        return all(r == rank for r in distr)
+
+    # Simple generator for the layer
+    @staticmethod
+    def generate_simple(x: TensorMoments, r: TensorMoments, axis: int, \
+            eps: float, next_tag: int, redux: bool=False, fused: bool=True):
+        # Residual sum gets the same traits and distribution as X
+        res_traits = TensorTraits(x.value.shape, x.value.basetile_shape)
+        res_distr = x.value.distribution
+        res_value = type(x.value)(res_traits, res_distr, next_tag)
+        next_tag = res_value.next_tag
+        res_grad = type(x.value)(res_traits, res_distr, next_tag)
+        next_tag = res_grad.next_tag
+        res = TensorMoments(res_value, res_grad, True)
+        norm, next_tag = LayerNorm.generate_simple(res, axis, eps, next_tag, \
+                redux=redux, fused=fused)
+        return AddLayerNorm(x, r, res, norm), next_tag
+
+    # Forward propagation of the layer
+    def forward_async(self):
+        if self.fused:
+            # Sum inputs and normalize the sum by a single pass
+            add_layer_norm_async(self.norm.eps**2, self.x.value, \
+                    self.r.value, self.gamma.value, self.beta.value, \
+                    self.res.value, self.norm.mean, self.norm.inv_stddev, \
+                    self.y.value, self.norm.axis)
+            # Statistics are needed only by the backward
+            self.norm.mean.wont_use()
+            self.norm.inv_stddev.wont_use()
+            # Inputs, outputs, gamma and beta can be offloaded from GPU
+            self.x.value.wont_use()
+            self.r.value.wont_use()
+            self.gamma.value.wont_use()
+            self.beta.value.wont_use()
+            self.res.value.wont_use()
+            self.y.value.wont_use()
+            return
+        copy_async(self.x.value, self.res.value)
+        add_async(1, self.r.value, 1, self.res.value)
+        self.x.value.wont_use()
+        self.r.value.wont_use()
+        self.norm.forward_async()
+
+    # C++ counterpart of the fused layer
+    def to_cpp(self):
+        cls = cpp_class("AddLayerNorm", self.x.value)
+        moments = [cpp_moments(t) for t in (self.x, self.r, self.res, \
+                self.y, self.gamma, self.beta)]
+        if cls is None or not self.fused_backward or None in moments:
+            return None
+        return cls(*moments, self.norm.mean, self.norm.inv_stddev, \
+                self.norm.axis, self.norm.eps**2, self.norm.redux)
+
+    # Backward propagation of the layer
+    def backward_async(self):
+        if self.fused_backward:
+            # Gradient of res from the next residual connection is added to
+            # the gradient through the normalization, and the total is
+            # accumulated into gradients of both inputs
+            add_layer_norm_backward_async(self.res.value, self.y.grad, \
+                    self.gamma.value, self.norm.mean, self.norm.inv_stddev, \
+                    self.res.grad, self.x.grad, self.r.grad, self.gamma.grad, \
+                    self.beta.grad, self.norm.axis, redux=self.norm.redux)
+            # mean and inv_stddev can be deleted
+            self.norm.mean.invalidate_submit()
+            self.norm.inv_stddev.invalidate_submit()
+            # All the other tensors can be offloaded from GPU
+            self.res.value.wont_use()
+            self.y.grad.wont_use()
+            self.gamma.value.wont_use()
+            self.res.grad.wont_use()
+            self.x.grad.wont_use()
+            self.r.grad.wont_use()
+            self.gamma.grad.wont_use()
+            self.beta.grad.wont_use()
+            return
+        # Normalization accumulates its gradient into grad res
+        self.norm.backward_async()
+        if self.x.grad is not None:
+            add_async(1, self.res.grad, 1, self.x.grad)
+            self.x.grad.wont_use()
+        if self.r.grad is not None:
+            add_async(1, self.res.grad, 1, self.r.grad)
+            self.r.grad.wont_use()
+        self.res.grad.wont_use()
+
@@ -12,7 +12,7 @@
 # @author Aleksandr Katrutsa
 # @date 2023-09-29
 
-from .base_layer import BaseLayer
+from .base_layer import BaseLayer, cpp_class, cpp_moments
 from nntile.tensor import add_async, copy_async, add_slice_async, sum_slice_async
 from nntile.tensor import TensorTraits, TensorMoments
 
@@ -49,6 +49,14 @@ class AddSlice(BaseLayer):
         self.x.grad.wont_use()
         self.y.grad.wont_use()
         self.u.grad.wont_use()
+
+    # C++ counterpart of the layer
+    def to_cpp(self):
+        cls = cpp_class("AddSlice", self.u.value)
+        moments = [cpp_moments(t) for t in (self.x, self.y, self.u)]
+        if cls is None or None in moments:
+            return None
+        return cls(*moments, self.axis, self.redux)
         
     # Simple generator for the add_slice layer
     @staticmethod
@@ -16,11 +16,26 @@ from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
         TransOp, trans, notrans, clear_async, gemm_async, randn_async, \
         maxsumexp_async, softmax_inplace_async, sumprod_slice_async, \
         add_slice_async, prod_async, mask_scalar_async, add_fiber_async, \
-        sum_fiber_async, transpose_async, copy_async, gemm_ex_async
+        sum_fiber_async, transpose_async, copy_async, gemm_ex_async, \
+        copy_intersection_async, background_priority, rope_async, \
+        rope_backward_async, flash_attention_async, \
+        flash_attention_backward_async, flash_attention_dequant_async, \
+        quantize_async, Tensor_fp32, Tensor_int8, Tensor_fp8_e4m3
 
-from nntile.layer.base_layer import BaseLayer
+from nntile.layer.base_layer import BaseLayer, cpp_class, cpp_moments
 import numpy as np
-from typing import List
+from typing import List, Optional
+
+# Types of elements of quantized KV-cache
+_kv_cache_types = {"int8": Tensor_int8, "fp8_e4m3": Tensor_fp8_e4m3}
+
+# View of a tensor of a given shape and basetile, whose tile with index
+# (i_0, i_1, ...) is the tile src_index([i_0, i_1, ...]) of the source tensor
+def _tile_view(src, shape, basetile, src_index):
+    traits = TensorTraits(shape, basetile)
+    tiles = [src.grid.index_to_linear(src_index(traits.grid.linear_to_index( \
+            i))) for i in range(traits.grid.nelems)]
+    return type(src)(traits, src, tiles)
 
 # Multi-head attention
 # Inputs:
@@ -29,6 +44,31 @@ from typing import List
 #  x_v: (n_emb_v, n_seq, n_batch) tensor
 # Output:
 #  y: (n_emb, n_seq, n_batch) tensor
+# In KV-cache (incremental decoding) mode n_seq is the number of new tokens.
+# Keys and values of new tokens are stored in (head_size, n_kv_cache, n_batch,
+# n_head) caches at position kv_cache_pos and the new queries attend to the
+# whole cache, so the mask shall be of shape (n_kv_cache, n_seq). A mask of
+# shape (n_kv_cache, n_seq, n_batch) sets keys of every sequence of a batch
+# separately, which is used by continuous batching (see nntile.inference).
+# Paged KV-cache keeps keys and values in a pool of (head_size, page_size,
+# n_pages, n_head) tensors, where each tile is a page. Every sequence gets
+# its own list of pages (see set_kv_cache_pages), so n_kv_cache is only the
+# longest possible sequence and the mask of shape (n_kv_cache, n_seq, n_batch)
+# refers to positions within a sequence.
+# Quantized KV-cache keeps keys and values in int8 or FP8 E4M3 with a scale
+# per token and head (see kv_cache_dtype of generate_simple). Keys and values
+# of new tokens are quantized before they are stored, and the softmax reads
+# the 8-bit cache directly (see tensor.flash_attention_dequant), so the same
+# memory holds 4 times more tokens than a single precision cache.
+# Packed projections of self-attention keep weights of queries, keys and values
+# in a single (3*n_head, head_size, n_emb) tensor w_qkv, so that all of them
+# are computed by a single gemm, that reads the input once. Tensors w_q, w_k,
+# w_v and q_transposed, k_transposed, v_transposed are views of tiles of the
+# packed ones, split along the head axis.
+# Fused mode computes attention with a single pass over keys and values and
+# its backward recomputes attention weights out of maxsumexp of the forward
+# (see tensor.flash_attention), so the (n_seq, n_seq, n_batch, n_head) tensor
+# a is never used and StarPU does not allocate it.
 class Attention(BaseLayer):
     x_q: TensorMoments
     x_k: TensorMoments
@@ -51,6 +91,14 @@ class Attention(BaseLayer):
     b_transposed: TensorMoments
     n_head: int
     head_size: int
+    k_cache: TensorOrNone
+    v_cache: TensorOrNone
+    kv_cache_pos: int
+    kv_cache_paged: bool
+    rope_base: float
+    w_qkv: TensorMoments
+    qkv_transposed: TensorMoments
+    fused: bool
 
     # Construct attention layer with all the provided data
     def __init__(self, x_q: TensorMoments, x_k: TensorMoments, \
@@ -64,7 +112,11 @@ class Attention(BaseLayer):
             b: TensorMoments, b_transposed: TensorMoments, \
             in_proj_bias_q: TensorMoments, in_proj_bias_k: TensorMoments, \
             in_proj_bias_v: TensorMoments, out_proj_bias: TensorMoments, \
-            mask=None, redux: bool=False, fp32_fast_tf32: bool=False):
+            mask=None, redux: bool=False, fp32_fast_tf32: bool=False, \
+            k_cache: TensorOrNone=None, v_cache: TensorOrNone=None, \
+            kv_cache_paged: bool=False, rope_base: float=0.0, \
+            w_qkv: TensorMoments=None, qkv_transposed: TensorMoments=None, \
+            fused: bool=False, kv_cache_quant: Optional[List]=None):
         qkv_bias_list = []
         if in_proj_bias_q:
             qkv_bias_list.append(in_proj_bias_q)
@@ -84,7 +136,8 @@ class Attention(BaseLayer):
         super().__init__([x_q, x_k, x_v], [y], [w_q, w_k, w_v] + \
                 qkv_bias_list + [w] + bias_list_out_proj, \
                 [q_transposed, q, k_transposed, k, v_transposed, v, a, \
-                a_maxsumexp, a_sumprod_slice, b, b_transposed])
+                a_maxsumexp, a_sumprod_slice, b, b_transposed, k_cache, \
+                v_cache, qkv_transposed] + (kv_cache_quant or []))
         self.x_q = x_q
         self.x_q.grad.set_reduction_add()
         self.x_k = x_k
@@ -143,13 +196,63 @@ class Attention(BaseLayer):
         else:
             self.redux = 0
         self.fp32_fast_tf32 = fp32_fast_tf32
+        if (k_cache is None) != (v_cache is None):
+            raise ValueError("Both k_cache and v_cache shall be provided")
+        self.k_cache = k_cache
+        self.v_cache = v_cache
+        self.kv_cache_pos = 0
+        if kv_cache_paged:
+            if k_cache is None:
+                raise ValueError("Paged KV-cache requires pools of pages")
+            if b.value.basetile_shape[2] != 1:
+                raise ValueError("Paged KV-cache requires a single " \
+                        "sequence per tile")
+        self.kv_cache_paged = kv_cache_paged
+        # Scales of tokens and heads of quantized KV-cache, followed by
+        # quantized keys and values of new tokens and their scales
+        if kv_cache_quant is not None:
+            if k_cache is None or kv_cache_paged or mask is None:
+                raise ValueError("Quantized KV-cache requires a mask and " \
+                        "does not support paged KV-cache")
+            self.k_cache_scale, self.v_cache_scale, self.k_new, \
+                    self.k_new_scale, self.v_new, self.v_new_scale \
+                    = kv_cache_quant
+        else:
+            self.k_cache_scale = self.v_cache_scale = None
+            self.k_new = self.k_new_scale = None
+            self.v_new = self.v_new_scale = None
+        # Rotary position embedding of queries and keys is applied in-place
+        # by positions of tokens, if its base is positive
+        if rope_base > 0 and head_size % 2 != 0:
+            raise ValueError("Rotary position embedding requires even " \
+                    "head_size")
+        self.rope_base = rope_base
+        # Views of tiles of every sequence for paged KV-cache
+        self.kv_cache_views = [None] * b.value.shape[2]
+        # Parameters w_q, w_k and w_v are views of the packed weight
+        if (w_qkv is None) != (qkv_transposed is None):
+            raise ValueError("Both w_qkv and qkv_transposed shall be " \
+                    "provided")
+        if w_qkv is not None and (x_k is not x_q or x_v is not x_q):
+            raise ValueError("Packed projections require the same input " \
+                    "for queries, keys and values")
+        self.w_qkv = w_qkv
+        self.qkv_transposed = qkv_transposed
+        # Fused kernels take a mask of keys and queries of the input
+        if fused and (mask is None or k_cache is not None):
+            raise ValueError("Fused attention requires a mask and does " \
+                    "not support KV-cache")
+        self.fused = fused
 
     # Simple generator for the linear layer
     @staticmethod
     def generate_simple(x_q: TensorMoments, x_k: TensorMoments, \
             x_v: TensorMoments, n_head: int, n_head_tile: int, next_tag: int, \
             bias=False, mask=None, redux: bool=False, \
-            fp32_fast_tf32: bool=False):
+            fp32_fast_tf32: bool=False, kv_cache_size: int=0, \
+            kv_cache_size_tile: int=0, kv_cache_pages: int=0, \
+            rope_base: float=0.0, packed_qkv: bool=False, \
+            fused: bool=False, kv_cache_dtype: Optional[str]=None):
         # Get sizes
         n_emb, n_seq, n_batch = x_q.value.shape
         n_emb_tile, n_seq_tile, n_batch_tile = x_q.value.basetile_shape
@@ -171,6 +274,27 @@ class Attention(BaseLayer):
             raise ValueError("Invalid basetile shape of x_v")
         # Fixed for now
         head_size_tile = head_size
+        # Views of queries, keys and values are made of whole tiles
+        if packed_qkv:
+            if x_k is not x_q or x_v is not x_q:
+                raise ValueError("Packed projections require the same " \
+                        "input for queries, keys and values")
+            if n_head % n_head_tile != 0:
+                raise ValueError("n_head shall be a multiple of " \
+                        "n_head_tile for packed projections")
+        # Keys of softmax are either tokens of the input or the KV-cache
+        if kv_cache_size > 0:
+            if kv_cache_size_tile <= 0:
+                kv_cache_size_tile = kv_cache_size
+            n_seq_k = kv_cache_size
+            n_seq_k_tile = kv_cache_size_tile
+            # Sequences consist of whole pages
+            if kv_cache_pages > 0 and kv_cache_size % kv_cache_size_tile != 0:
+                raise ValueError("kv_cache_size shall be a multiple of " \
+                        "kv_cache_size_tile for paged KV-cache")
+        else:
+            n_seq_k = n_seq
+            n_seq_k_tile = n_seq_tile
         # Define shape of each tensor
         w_q_shape = [n_head, head_size, n_emb]
         w_k_shape = [n_head, head_size, n_emb_k]
@@ -182,7 +306,7 @@ class Attention(BaseLayer):
         k_shape = [head_size, n_seq, n_batch, n_head]
         v_transposed_shape = [n_head, head_size, n_seq, n_batch]
         v_shape = [head_size, n_seq, n_batch, n_head]
-        a_shape = [n_seq, n_seq, n_batch, n_head]
+        a_shape = [n_seq_k, n_seq, n_batch, n_head]
         a_maxsumexp_shape = [2, n_seq, n_batch, n_head]
         a_sumprod_slice_shape = [n_seq, n_batch, n_head]
         b_shape = [head_size, n_seq, n_batch, n_head]
@@ -198,7 +322,7 @@ class Attention(BaseLayer):
         k_basetile = [head_size_tile, n_seq_tile, n_batch_tile, n_head_tile]
         v_transposed_basetile = [n_head_tile, head_size_tile, n_seq_tile, n_batch_tile]
         v_basetile = [head_size_tile, n_seq_tile, n_batch_tile, n_head_tile]
-        a_basetile = [n_seq_tile, n_seq_tile, n_batch_tile, n_head_tile]
+        a_basetile = [n_seq_k_tile, n_seq_tile, n_batch_tile, n_head_tile]
         a_maxsumexp_basetile = [2, n_seq_tile, n_batch_tile, n_head_tile]
         a_sumprod_slice_basetile = [n_seq_tile, n_batch_tile, n_head_tile]
         b_basetile = [head_size_tile, n_seq_tile, n_batch_tile, n_head_tile]
@@ -242,12 +366,50 @@ class Attention(BaseLayer):
                     [head_size_tile, n_head_tile])
             in_proj_bias_qkv_distr = [0] * in_proj_bias_qkv_traits.grid.nelems
         # Define all the lists
+        if packed_qkv:
+            # Packed weight and projections, the i-th of them is a view of
+            # tiles i*n_head/n_head_tile and further along the head axis
+            head_tiles = n_head // n_head_tile
+            def qkv_view(t, traits, i):
+                return _tile_view(t, traits.shape, traits.basetile_shape, \
+                        lambda index: [index[0]+i*head_tiles]+index[1:])
+            def qkv_views(t, traits):
+                return [TensorMoments(qkv_view(t.value, traits, i), \
+                        qkv_view(t.grad, traits, i), True) for i in range(3)]
+            w_qkv_traits = TensorTraits([3*n_head, head_size, n_emb], \
+                    w_q_basetile)
+            w_qkv_distr = [0] * w_qkv_traits.grid.nelems
+            w_qkv_value = type(x_q.value)(w_qkv_traits, w_qkv_distr, \
+                    next_tag)
+            next_tag = w_qkv_value.next_tag
+            w_qkv_grad = type(x_q.value)(w_qkv_traits, w_qkv_distr, \
+                    next_tag)
+            next_tag = w_qkv_grad.next_tag
+            w_qkv = TensorMoments(w_qkv_value, w_qkv_grad, True)
+            qkv_transposed_traits = TensorTraits([3*n_head, head_size, \
+                    n_seq, n_batch], q_transposed_basetile)
+            qkv_transposed_distr = [0] * qkv_transposed_traits.grid.nelems
+            qkv_transposed_value = type(x_q.value)(qkv_transposed_traits, \
+                    qkv_transposed_distr, next_tag)
+            next_tag = qkv_transposed_value.next_tag
+            qkv_transposed_grad = type(x_q.value)(qkv_transposed_traits, \
+                    qkv_transposed_distr, next_tag)
+            next_tag = qkv_transposed_grad.next_tag
+            qkv_transposed = TensorMoments(qkv_transposed_value, \
+                    qkv_transposed_grad, True)
+            w_q, w_k, w_v = qkv_views(w_qkv, w_q_traits)
+            q_transposed, k_transposed, v_transposed = qkv_views( \
+                    qkv_transposed, q_transposed_traits)
+        else:
+            w_qkv = None
+            qkv_transposed = None
         # w_q
-        w_q_value = type(x_q.value)(w_q_traits, w_q_distr, next_tag)
-        next_tag = w_q_value.next_tag
-        w_q_grad = type(x_q.value)(w_q_traits, w_q_distr, next_tag)
-        next_tag = w_q_grad.next_tag
-        w_q = TensorMoments(w_q_value, w_q_grad, True)
+        if not packed_qkv:
+            w_q_value = type(x_q.value)(w_q_traits, w_q_distr, next_tag)
+            next_tag = w_q_value.next_tag
+            w_q_grad = type(x_q.value)(w_q_traits, w_q_distr, next_tag)
+            next_tag = w_q_grad.next_tag
+            w_q = TensorMoments(w_q_value, w_q_grad, True)
         if bias:
             in_proj_bias_q_value = type(x_q.value)( \
                     in_proj_bias_qkv_traits, in_proj_bias_qkv_distr, \
@@ -262,11 +424,12 @@ class Attention(BaseLayer):
         else:
             bias_inproj_q = None
         # w_k
-        w_k_value = type(x_q.value)(w_k_traits, w_k_distr, next_tag)
-        next_tag = w_k_value.next_tag
-        w_k_grad = type(x_q.value)(w_k_traits, w_k_distr, next_tag)
-        next_tag = w_k_grad.next_tag
-        w_k = TensorMoments(w_k_value, w_k_grad, True)
+        if not packed_qkv:
+            w_k_value = type(x_q.value)(w_k_traits, w_k_distr, next_tag)
+            next_tag = w_k_value.next_tag
+            w_k_grad = type(x_q.value)(w_k_traits, w_k_distr, next_tag)
+            next_tag = w_k_grad.next_tag
+            w_k = TensorMoments(w_k_value, w_k_grad, True)
         if bias:
             in_proj_bias_k_value = type(x_q.value)( \
                     in_proj_bias_qkv_traits, in_proj_bias_qkv_distr, \
@@ -281,11 +444,12 @@ class Attention(BaseLayer):
         else:
             bias_inproj_k = None
         # w_v
-        w_v_value = type(x_q.value)(w_v_traits, w_v_distr, next_tag)
-        next_tag = w_v_value.next_tag
-        w_v_grad = type(x_q.value)(w_v_traits, w_v_distr, next_tag)
-        next_tag = w_v_grad.next_tag
-        w_v = TensorMoments(w_v_value, w_v_grad, True)
+        if not packed_qkv:
+            w_v_value = type(x_q.value)(w_v_traits, w_v_distr, next_tag)
+            next_tag = w_v_value.next_tag
+            w_v_grad = type(x_q.value)(w_v_traits, w_v_distr, next_tag)
+            next_tag = w_v_grad.next_tag
+            w_v = TensorMoments(w_v_value, w_v_grad, True)
         if bias:
             in_proj_bias_v_value = type(x_q.value)( \
                     in_proj_bias_qkv_traits, in_proj_bias_qkv_distr, \
@@ -306,11 +470,15 @@ class Attention(BaseLayer):
         next_tag = w_grad.next_tag
         w = TensorMoments(w_value, w_grad, True)
         # q_transposed
-        q_transposed_value = type(x_q.value)(q_transposed_traits, q_transposed_distr, next_tag)
-        next_tag = q_transposed_value.next_tag
-        q_transposed_grad = type(x_q.value)(q_transposed_traits, q_transposed_distr, next_tag)
-        next_tag = q_transposed_grad.next_tag
-        q_transposed = TensorMoments(q_transposed_value, q_transposed_grad, True)
+        if not packed_qkv:
+            q_transposed_value = type(x_q.value)(q_transposed_traits, \
+                    q_transposed_distr, next_tag)
+            next_tag = q_transposed_value.next_tag
+            q_transposed_grad = type(x_q.value)(q_transposed_traits, \
+                    q_transposed_distr, next_tag)
+            next_tag = q_transposed_grad.next_tag
+            q_transposed = TensorMoments(q_transposed_value, \
+                    q_transposed_grad, True)
         # q
         q_value = type(x_q.value)(q_traits, q_distr, next_tag)
         next_tag = q_value.next_tag
@@ -318,11 +486,15 @@ class Attention(BaseLayer):
         next_tag = q_grad.next_tag
         q = TensorMoments(q_value, q_grad, True)
         # k_transposed
-        k_transposed_value = type(x_q.value)(k_transposed_traits, k_transposed_distr, next_tag)
-        next_tag = k_transposed_value.next_tag
-        k_transposed_grad = type(x_q.value)(k_transposed_traits, k_transposed_distr, next_tag)
-        next_tag = k_transposed_grad.next_tag
-        k_transposed = TensorMoments(k_transposed_value, k_transposed_grad, True)
+        if not packed_qkv:
+            k_transposed_value = type(x_q.value)(k_transposed_traits, \
+                    k_transposed_distr, next_tag)
+            next_tag = k_transposed_value.next_tag
+            k_transposed_grad = type(x_q.value)(k_transposed_traits, \
+                    k_transposed_distr, next_tag)
+            next_tag = k_transposed_grad.next_tag
+            k_transposed = TensorMoments(k_transposed_value, \
+                    k_transposed_grad, True)
         # k
         k_value = type(x_q.value)(k_traits, k_distr, next_tag)
         next_tag = k_value.next_tag
@@ -330,11 +502,15 @@ class Attention(BaseLayer):
         next_tag = k_grad.next_tag
         k = TensorMoments(k_value, k_grad, True)
         # v_transposed
-        v_transposed_value = type(x_q.value)(v_transposed_traits, v_transposed_distr, next_tag)
-        next_tag = v_transposed_value.next_tag
-        v_transposed_grad = type(x_q.value)(v_transposed_traits, v_transposed_distr, next_tag)
-        next_tag = v_transposed_grad.next_tag
-        v_transposed = TensorMoments(v_transposed_value, v_transposed_grad, True)
+        if not packed_qkv:
+            v_transposed_value = type(x_q.value)(v_transposed_traits, \
+                    v_transposed_distr, next_tag)
+            next_tag = v_transposed_value.next_tag
+            v_transposed_grad = type(x_q.value)(v_transposed_traits, \
+                    v_transposed_distr, next_tag)
+            next_tag = v_transposed_grad.next_tag
+            v_transposed = TensorMoments(v_transposed_value, \
+                    v_transposed_grad, True)
         # v
         v_value = type(x_q.value)(v_traits, v_distr, next_tag)
         next_tag = v_value.next_tag
@@ -367,6 +543,66 @@ class Attention(BaseLayer):
         b_transposed_grad = type(x_q.value)(b_transposed_traits, b_transposed_distr, next_tag)
         next_tag = b_transposed_grad.next_tag
         b_transposed = TensorMoments(b_transposed_value, b_transposed_grad, True)
+        # Allocate KV-cache if needed
+        if kv_cache_pages > 0:
+            # Pool of pages, shared by all the sequences
+            kv_cache_traits = TensorTraits( \
+                    [head_size, kv_cache_size_tile, kv_cache_pages, n_head], \
+                    [head_size_tile, kv_cache_size_tile, 1, n_head_tile])
+        elif kv_cache_size > 0:
+            kv_cache_traits = TensorTraits( \
+                    [head_size, kv_cache_size, n_batch, n_head], \
+                    [head_size_tile, kv_cache_size_tile, n_batch_tile, \
+                    n_head_tile])
+        # Elements of KV-cache are of the type of the input by default
+        kv_cache_type = type(x_q.value)
+        if kv_cache_dtype is not None:
+            if kv_cache_dtype not in _kv_cache_types:
+                raise ValueError("Unknown type of KV-cache")
+            if kv_cache_size == 0 or kv_cache_pages > 0:
+                raise ValueError("Quantized KV-cache requires non-paged " \
+                        "KV-cache")
+            if type(x_q.value) is not Tensor_fp32:
+                raise TypeError("Quantized KV-cache requires fp32 inputs")
+            kv_cache_type = _kv_cache_types[kv_cache_dtype]
+        if kv_cache_size > 0:
+            kv_cache_distr = [0] * kv_cache_traits.grid.nelems
+            k_cache = kv_cache_type(kv_cache_traits, kv_cache_distr, \
+                    next_tag)
+            next_tag = k_cache.next_tag
+            v_cache = kv_cache_type(kv_cache_traits, kv_cache_distr, \
+                    next_tag)
+            next_tag = v_cache.next_tag
+        else:
+            k_cache = None
+            v_cache = None
+        # Quantized KV-cache needs scales of every token and head of the
+        # cache and temporaries to quantize keys and values of new tokens
+        if kv_cache_dtype is not None:
+            scale_traits = TensorTraits([1]+kv_cache_traits.shape[1:], \
+                    [1]+kv_cache_traits.basetile_shape[1:])
+            k_cache_scale = Tensor_fp32(scale_traits, kv_cache_distr, \
+                    next_tag)
+            next_tag = k_cache_scale.next_tag
+            v_cache_scale = Tensor_fp32(scale_traits, kv_cache_distr, \
+                    next_tag)
+            next_tag = v_cache_scale.next_tag
+            new_traits = TensorTraits(k.value.shape, k.value.basetile_shape)
+            new_scale_traits = TensorTraits([1]+k.value.shape[1:], \
+                    [1]+k.value.basetile_shape[1:])
+            new_distr = k.value.distribution
+            k_new = kv_cache_type(new_traits, new_distr, next_tag)
+            next_tag = k_new.next_tag
+            k_new_scale = Tensor_fp32(new_scale_traits, new_distr, next_tag)
+            next_tag = k_new_scale.next_tag
+            v_new = kv_cache_type(new_traits, new_distr, next_tag)
+            next_tag = v_new.next_tag
+            v_new_scale = Tensor_fp32(new_scale_traits, new_distr, next_tag)
+            next_tag = v_new_scale.next_tag
+            kv_cache_quant = [k_cache_scale, v_cache_scale, k_new, \
+                    k_new_scale, v_new, v_new_scale]
+        else:
+            kv_cache_quant = None
         # Allocate tensors for bias for q, k, v and output projection
         if bias:
             out_proj_bias_traits = TensorTraits([n_emb], [n_emb_tile])
@@ -393,24 +629,188 @@ class Attention(BaseLayer):
                 q, k_transposed, k, v_transposed, v, a, a_maxsumexp, \
                 a_sumprod_slice, b, b_transposed, bias_inproj_q, \
                 bias_inproj_k, bias_inproj_v, out_proj_bias, mask, \
-                redux=redux, fp32_fast_tf32=fp32_fast_tf32)
+                redux=redux, fp32_fast_tf32=fp32_fast_tf32, \
+                k_cache=k_cache, v_cache=v_cache, \
+                kv_cache_paged=kv_cache_pages>0, rope_base=rope_base, \
+                w_qkv=w_qkv, qkv_transposed=qkv_transposed, fused=fused, \
+                kv_cache_quant=kv_cache_quant)
         # Return layer and next tag to be used
         return (layer, next_tag)
 
+    # Use KV-cache of another layer with the same shape and tiles of the
+    # cache instead of own one, e.g., of a model with other tiles of new
+    # tokens (see GPT2Model.create_plan). Own cache is unregistered.
+    def share_kv_cache(self, other):
+        if self.k_cache is None or other.k_cache is None:
+            raise RuntimeError("Layers shall be in KV-cache mode")
+        if self.kv_cache_paged != other.kv_cache_paged \
+                or type(self.k_cache) is not type(other.k_cache) \
+                or self.k_cache.shape != other.k_cache.shape \
+                or self.k_cache.basetile_shape \
+                != other.k_cache.basetile_shape:
+            raise ValueError("Layers shall have the same KV-cache")
+        mapping = {id(self.k_cache): other.k_cache, \
+                id(self.v_cache): other.v_cache}
+        if self.k_cache_scale is not None:
+            mapping[id(self.k_cache_scale)] = other.k_cache_scale
+            mapping[id(self.v_cache_scale)] = other.v_cache_scale
+        self.temporaries = [mapping.get(id(t), t) for t in self.temporaries]
+        for t in (self.k_cache, self.v_cache, self.k_cache_scale, \
+                self.v_cache_scale):
+            if t is not None:
+                t.unregister()
+        self.k_cache = other.k_cache
+        self.v_cache = other.v_cache
+        self.k_cache_scale = other.k_cache_scale
+        self.v_cache_scale = other.v_cache_scale
+        # Views of pages refer to the old cache
+        self.kv_cache_views = [None] * len(self.kv_cache_views)
+
+    # Clear KV-cache and start a new sequence
+    def reset_kv_cache_async(self):
+        if self.k_cache is None:
+            raise RuntimeError("Layer is not in KV-cache mode")
+        # Unused part of the cache is multiplied by zero softmax weights, so it
+        # shall not contain any NaN or infinity. Masked keys of quantized
+        # cache are not read at all and zero scales are enough.
+        if self.k_cache_scale is not None:
+            clear_async(self.k_cache_scale)
+            clear_async(self.v_cache_scale)
+        else:
+            clear_async(self.k_cache)
+            clear_async(self.v_cache)
+        self.kv_cache_pos = 0
+        self.kv_cache_views = [None] * len(self.kv_cache_views)
+
+    # Set position of the first new token within KV-cache
+    def set_kv_cache_pos(self, pos: int):
+        if self.k_cache is None or self.kv_cache_paged:
+            raise RuntimeError("Layer is not in KV-cache mode")
+        n_seq = self.x_q.value.shape[1]
+        if pos < 0 or pos+n_seq > self.k_cache.shape[1]:
+            raise ValueError("New tokens do not fit into KV-cache")
+        self.kv_cache_pos = pos
+
+    # Set pages of every sequence of paged KV-cache. Sequence i consists of
+    # pages page_tables[i] of the pool, keys and values of its new tokens are
+    # stored at positions starting at kv_lens[i]. Sequences without pages are
+    # skipped and their output is zero.
+    def set_kv_cache_pages(self, page_tables: List[List[int]], \
+            kv_lens: List[int]):
+        if not self.kv_cache_paged:
+            raise RuntimeError("Layer is not in paged KV-cache mode")
+        n_batch = len(self.kv_cache_views)
+        if len(page_tables) != n_batch or len(kv_lens) != n_batch:
+            raise ValueError("Pages shall be set for every sequence")
+        n_seq = self.x_q.value.shape[1]
+        page_size = self.k_cache.shape[1]
+        max_pages = self.a.value.shape[0] // page_size
+        for i in range(n_batch):
+            pages = page_tables[i]
+            if not pages:
+                self.kv_cache_views[i] = None
+                continue
+            if len(pages) > max_pages:
+                raise ValueError("Sequence is too long")
+            if kv_lens[i] < 0 or kv_lens[i]+n_seq > len(pages)*page_size:
+                raise ValueError("New tokens do not fit into pages")
+            npages = len(pages)
+            # Tiles of the i-th sequence
+            def batch_view(t, axis, ntiles=0):
+                tile_start = [0] * t.ndim
+                tile_start[axis] = i
+                tile_shape = list(t.grid.shape)
+                tile_shape[axis] = 1
+                if ntiles > 0:
+                    tile_shape[0] = ntiles
+                return type(t)(t, tile_start, tile_shape)
+            # Pages of the i-th sequence
+            def pages_view(t):
+                shape = [t.shape[0], npages*page_size, 1, t.shape[3]]
+                def src_index(index):
+                    return [index[0], 0, pages[index[1]], index[3]]
+                return _tile_view(t, shape, t.basetile_shape, src_index)
+            self.kv_cache_views[i] = (kv_lens[i], pages_view(self.k_cache), \
+                    pages_view(self.v_cache), batch_view(self.q.value, 2), \
+                    batch_view(self.k.value, 2), \
+                    batch_view(self.v.value, 2), \
+                    batch_view(self.a.value, 2, npages), \
+                    batch_view(self.a_maxsumexp, 2), \
+                    batch_view(self.b.value, 2), \
+                    batch_view(self.mask, 2, npages) if self.mask else None)
+
+    # Attention of every sequence to its own pages of paged KV-cache
+    def _forward_paged_async(self):
+        for i, views in enumerate(self.kv_cache_views):
+            if views is None:
+                continue
+            pos, k_cache, v_cache, q, k, v, a, a_maxsumexp, b, mask = views
+            # New tokens of every sequence start at its own position
+            if self.rope_base > 0:
+                rope_async(self.rope_base, pos, q)
+                rope_async(self.rope_base, pos, k)
+            copy_intersection_async(k, [0, pos, 0, 0], k_cache, [0, 0, 0, 0])
+            copy_intersection_async(v, [0, pos, 0, 0], v_cache, [0, 0, 0, 0])
+            if self.fp32_fast_tf32:
+                gemm_ex_async(1.0/self.head_size**0.5, trans, k_cache, \
+                        notrans, q, 0.0, a, 1, 2, redux=self.redux)
+            else:
+                gemm_async(1.0/self.head_size**0.5, trans, k_cache, \
+                        notrans, q, 0.0, a, 1, 2, redux=self.redux)
+            clear_async(a_maxsumexp)
+            if mask:
+                mask_scalar_async(mask, self.val, a, 1)
+            maxsumexp_async(a, a_maxsumexp, 0, redux=self.redux)
+            softmax_inplace_async(a_maxsumexp, 1.0, a, 0)
+            if self.fp32_fast_tf32:
+                gemm_ex_async(1.0, notrans, v_cache, notrans, a, 0.0, b, 1, \
+                        2, redux=self.redux)
+            else:
+                gemm_async(1.0, notrans, v_cache, notrans, a, 0.0, b, 1, 2, \
+                        redux=self.redux)
+        # Sequences without pages produce zeros
+        for i, views in enumerate(self.kv_cache_views):
+            if views is None:
+                clear_async(_tile_view(self.b.value, self.b.value.shape[:2] \
+                        + [1] + self.b.value.shape[3:], \
+                        self.b.value.basetile_shape, \
+                        lambda index: index[:2] + [i] + index[3:]))
+        self.q.value.wont_use()
+        self.k.value.wont_use()
+        self.v.value.wont_use()
+        self.a_maxsumexp.invalidate_submit()
+        self.a.value.wont_use()
+        if self.mask:
+            self.mask.wont_use()
+
     # Forward propagation of the attention layer
     def forward_async(self):
+        # Compute query, key and value tensors at once for packed projections
+        # QKV_transposed = einsum('jkl,lmn->jkmn', W_QKV, X)
+        # gemm (3*n_head, head_size, n_emb) by (n_emb, n_seq, n_batch) into
+        # (3*n_head, head_size, n_seq, n_batch)
+        if self.w_qkv is not None:
+            if self.fp32_fast_tf32:
+                gemm_ex_async(1.0, notrans, self.w_qkv.value, notrans, \
+                        self.x_q.value, 0.0, self.qkv_transposed.value, 1, \
+                        0, redux=self.redux)
+            else:
+                gemm_async(1.0, notrans, self.w_qkv.value, notrans, \
+                        self.x_q.value, 0.0, self.qkv_transposed.value, 1, \
+                        0, redux=self.redux)
         # Compute query, key and value tensors
         # Q_transposed = einsum('jkl,lmn->jkmn', W_Q, X_Q)
         # gemm (n_head, head_size, n_emb) by (n_emb, n_seq, n_batch) into
         # (n_head, head_size, n_seq, n_batch)
-        if self.fp32_fast_tf32:
-            gemm_ex_async(1.0, notrans, self.w_q.value, notrans, \
-                    self.x_q.value, 0.0, self.q_transposed.value, 1, 0, \
-                    redux=self.redux)
-        else:
-            gemm_async(1.0, notrans, self.w_q.value, notrans, \
-                    self.x_q.value, 0.0, self.q_transposed.value, 1, 0, \
-                    redux=self.redux)
+        if self.w_qkv is None:
+            if self.fp32_fast_tf32:
+                gemm_ex_async(1.0, notrans, self.w_q.value, notrans, \
+                        self.x_q.value, 0.0, self.q_transposed.value, 1, \
+                        0, redux=self.redux)
+            else:
+                gemm_async(1.0, notrans, self.w_q.value, notrans, \
+                        self.x_q.value, 0.0, self.q_transposed.value, 1, \
+                        0, redux=self.redux)
         # Rotate axes into (head_size, n_seq, n_batch, n_head)
         transpose_async(1.0, self.q_transposed.value, self.q.value, 1)
         # X_Q, W_Q and Q_transposed can be offloaded from GPU
@@ -425,17 +825,22 @@ class Attention(BaseLayer):
             add_fiber_async(1, self.in_proj_bias_q.value, 1, \
                     self.q.value, 0, 1)
             self.in_proj_bias_q.value.wont_use()
+        # Rotate queries by positions of new tokens (paged KV-cache rotates
+        # every sequence separately)
+        if self.rope_base > 0 and not self.kv_cache_paged:
+            rope_async(self.rope_base, self.kv_cache_pos, self.q.value)
         # K_transposed = einsum('jkl,lmn->jkmn', W_K, X_K)
         # gemm (n_head, head_size, n_emb) by (n_emb, n_seq, n_batch) into
         # (n_head, head_size, n_seq, n_batch)
-        if self.fp32_fast_tf32:
-            gemm_ex_async(1.0, notrans, self.w_k.value, notrans, \
-                    self.x_k.value, 0.0, self.k_transposed.value, 1, 0, \
-                    redux=self.redux)
-        else:
-            gemm_async(1.0, notrans, self.w_k.value, notrans, \
-                    self.x_k.value, 0.0, self.k_transposed.value, 1, 0, \
-                    redux=self.redux)
+        if self.w_qkv is None:
+            if self.fp32_fast_tf32:
+                gemm_ex_async(1.0, notrans, self.w_k.value, notrans, \
+                        self.x_k.value, 0.0, self.k_transposed.value, 1, \
+                        0, redux=self.redux)
+            else:
+                gemm_async(1.0, notrans, self.w_k.value, notrans, \
+                        self.x_k.value, 0.0, self.k_transposed.value, 1, \
+                        0, redux=self.redux)
         # Rotate axes into (head_size, n_seq, n_batch, n_head)
         transpose_async(1.0, self.k_transposed.value, self.k.value, 1)
         # X_K, W_K and K_transposed can be offloaded from GPU
@@ -450,17 +855,28 @@ class Attention(BaseLayer):
             add_fiber_async(1, self.in_proj_bias_k.value, 1, \
                     self.k.value, 0, 1)
             self.in_proj_bias_k.value.wont_use()
+        # Rotate keys before they are stored in KV-cache
+        if self.rope_base > 0 and not self.kv_cache_paged:
+            rope_async(self.rope_base, self.kv_cache_pos, self.k.value)
+        # Store keys of new tokens in KV-cache and use the cache for softmax
+        if self.k_cache is not None and not self.kv_cache_paged:
+            self._store_kv_cache_async(self.k.value, self.k_cache, \
+                    self.k_cache_scale, self.k_new, self.k_new_scale)
+            k_value = self.k_cache
+        else:
+            k_value = self.k.value
         # V_transposed = einsum('jkl,lmn->jkmn', W_V, X_V)
         # gemm (n_head, head_size, n_emb) by (n_emb, n_seq, n_batch) into
         # (n_head, head_size, n_seq, n_batch)
-        if self.fp32_fast_tf32:
-            gemm_ex_async(1.0, notrans, self.w_v.value, notrans, \
-                    self.x_v.value, 0.0, self.v_transposed.value, 1, 0, \
-                    redux=self.redux)
-        else:
-            gemm_async(1.0, notrans, self.w_v.value, notrans, \
-                    self.x_v.value, 0.0, self.v_transposed.value, 1, 0, \
-                    redux=self.redux)
+        if self.w_qkv is None:
+            if self.fp32_fast_tf32:
+                gemm_ex_async(1.0, notrans, self.w_v.value, notrans, \
+                        self.x_v.value, 0.0, self.v_transposed.value, 1, \
+                        0, redux=self.redux)
+            else:
+                gemm_async(1.0, notrans, self.w_v.value, notrans, \
+                        self.x_v.value, 0.0, self.v_transposed.value, 1, \
+                        0, redux=self.redux)
         # Rotate axes into (head_size, n_seq, n_batch, n_head)
         transpose_async(1.0, self.v_transposed.value, self.v.value, 1)
         # X_V, W_V and V_transposed can be offloaded from GPU
@@ -475,28 +891,84 @@ class Attention(BaseLayer):
             add_fiber_async(1, self.in_proj_bias_v.value, 1, \
                     self.v.value, 0, 1)
             self.in_proj_bias_v.value.wont_use()
+        # Store values of new tokens in KV-cache
+        if self.v_cache is not None and not self.kv_cache_paged:
+            self._store_kv_cache_async(self.v.value, self.v_cache, \
+                    self.v_cache_scale, self.v_new, self.v_new_scale)
+            v_value = self.v_cache
+        else:
+            v_value = self.v.value
+        if self.kv_cache_paged:
+            self._forward_paged_async()
+        else:
+            self._forward_softmax_async(k_value, v_value)
+        self._forward_output_async()
+
+    # Store keys or values of new tokens in KV-cache at kv_cache_pos.
+    # Quantized cache gets 8-bit values and scales of every token and head.
+    def _store_kv_cache_async(self, x, cache, cache_scale, x_new, \
+            x_new_scale):
+        offset = [0, self.kv_cache_pos, 0, 0]
+        if cache_scale is None:
+            copy_intersection_async(x, offset, cache, [0, 0, 0, 0])
+            return
+        quantize_async(x, x_new, x_new_scale, 0, self.head_size)
+        copy_intersection_async(x_new, offset, cache, [0, 0, 0, 0])
+        copy_intersection_async(x_new_scale, offset, cache_scale, \
+                [0, 0, 0, 0])
+        x_new.invalidate_submit()
+        x_new_scale.invalidate_submit()
+
+    # Softmax of attention weights and its product with values
+    def _forward_softmax_async(self, k_value, v_value):
+        if self.k_cache_scale is not None:
+            # Single pass over 8-bit keys and values, that are dequantized
+            # on the fly
+            flash_attention_dequant_async(self.q.value, k_value, \
+                    self.k_cache_scale, v_value, self.v_cache_scale, \
+                    self.mask, self.a_maxsumexp, self.b.value)
+            self.q.value.wont_use()
+            k_value.wont_use()
+            v_value.wont_use()
+            self.k_cache_scale.wont_use()
+            self.v_cache_scale.wont_use()
+            self.mask.wont_use()
+            self.a_maxsumexp.invalidate_submit()
+            return
+        if self.fused:
+            # Single pass over K and V with online softmax, that also
+            # produces A_maxsumexp for the backward
+            flash_attention_async(self.q.value, k_value, v_value, self.mask, \
+                    self.a_maxsumexp, self.b.value)
+            self.q.value.wont_use()
+            k_value.wont_use()
+            v_value.wont_use()
+            self.mask.wont_use()
+            self.a_maxsumexp.wont_use()
+            return
         # Get tensor for softmax
         # A = 1.0/sqrt(head_size) * einsum('jklb,jmlb->kmlb', K, Q)
         # single batched gemm (head_size, n_seq, batch=n_batch, batch=n_head)
         # by (head_size, n_seq, batch=n_batch, batch=n_head) into
         # (n_seq, n_seq, batch=n_batch, batch=n_head)
         if self.fp32_fast_tf32:
-            gemm_ex_async(1.0/self.head_size**0.5, trans, self.k.value, \
+            gemm_ex_async(1.0/self.head_size**0.5, trans, k_value, \
                     notrans, self.q.value, 0.0, self.a.value, 1, 2, \
                     redux=self.redux)
         else:
-            gemm_async(1.0/self.head_size**0.5, trans, self.k.value, \
+            gemm_async(1.0/self.head_size**0.5, trans, k_value, \
                     notrans, self.q.value, 0.0, self.a.value, 1, 2, \
                     redux=self.redux)
         clear_async(self.a_maxsumexp)
         # Q and K can be offloaded from GPU
         self.q.value.wont_use()
-        self.k.value.wont_use()
+        k_value.wont_use()
         # Calculate softmax inplace
         # A = softmax(A, axis=0)
         # Apply mask if needed
         if self.mask:
-            mask_scalar_async(self.mask, self.val, self.a.value, 2)
+            mask_scalar_async(self.mask, self.val, self.a.value, \
+                    self.a.value.ndim-self.mask.ndim)
             self.mask.wont_use()
         # Calculate max and sumexp along axis
         maxsumexp_async(self.a.value, self.a_maxsumexp, 0, redux=self.redux)
@@ -511,14 +983,17 @@ class Attention(BaseLayer):
         # by (n_seq, n_seq, batch=n_batch, batch=n_head) into
         # (head_size, n_seq, batch=n_batch, batch=n_head)
         if self.fp32_fast_tf32:
-            gemm_ex_async(1.0, notrans, self.v.value, notrans, \
+            gemm_ex_async(1.0, notrans, v_value, notrans, \
                     self.a.value, 0.0, self.b.value, 1, 2, redux=self.redux)
         else:
-            gemm_async(1.0, notrans, self.v.value, notrans, \
+            gemm_async(1.0, notrans, v_value, notrans, \
                     self.a.value, 0.0, self.b.value, 1, 2, redux=self.redux)
         # V and A can be offloaded from GPU
-        self.v.value.wont_use()
+        v_value.wont_use()
         self.a.value.wont_use()
+
+    # Output projection of results of all the heads
+    def _forward_output_async(self):
         # Accumulate result from all the heads
         # rotate axes (head_size, n_seq, n_batch, n_head) into
         # (n_head, head_size, n_seq, n_batch) and then
@@ -536,8 +1011,12 @@ class Attention(BaseLayer):
                     redux=self.redux)
         # W, B and B_transposed can be offloaded from GPU
         self.w.value.wont_use()
-        #self.b.value.wont_use()
-        self.b.value.invalidate_submit()
+        if self.fused:
+            # B is needed by the fused backward
+            self.b.value.wont_use()
+        else:
+            #self.b.value.wont_use()
+            self.b.value.invalidate_submit()
         self.b_transposed.value.wont_use()
         # Apply bias if needed
         if self.out_proj_bias is not None:
@@ -548,6 +1027,11 @@ class Attention(BaseLayer):
 
     # Backward propagation of the linear layer
     def backward_async(self):
+        if self.k_cache is not None:
+            raise RuntimeError("Backward is not supported in KV-cache mode")
+        # Gradients over weights are off the critical path of backward, so
+        # they give way to gradients over inputs
+        w_priority = background_priority()
         # Apply backward of bias if needed
         if self.out_proj_bias is not None:
             if self.out_proj_bias.grad_required:
@@ -560,11 +1044,11 @@ class Attention(BaseLayer):
             if self.fp32_fast_tf32:
                 gemm_ex_async(1.0, notrans, self.y.grad, trans, \
                         self.b_transposed.value, 1.0, self.w.grad, 2, 0, \
-                        redux=self.redux)
+                        redux=self.redux, priority=w_priority)
             else:
                 gemm_async(1.0, notrans, self.y.grad, trans, \
                         self.b_transposed.value, 1.0, self.w.grad, 2, 0, \
-                        redux=self.redux)
+                        redux=self.redux, priority=w_priority)
         # B_transposed can be deleted
         #self.b_transposed.value.wont_use()
         self.b_transposed.value.invalidate_submit()
@@ -588,6 +1072,94 @@ class Attention(BaseLayer):
             transpose_async(1.0, self.b_transposed.grad, self.b.grad, 1)
         #self.b_transposed.grad.wont_use()
         self.b_transposed.grad.invalidate_submit()
+        self._backward_softmax_async()
+        # Backward for bias of V
+        if self.in_proj_bias_v is not None:
+            if self.in_proj_bias_v.grad_required:
+                sum_fiber_async(1, self.v.grad, 1, self.in_proj_bias_v.grad, \
+                        0, 1, redux=self.redux)
+                self.in_proj_bias_v.grad.wont_use()
+        # Backward for axes rotation (V_transposed->V)
+        if self.v_transposed.grad_required:
+            # Rotate axes (head_size, n_seq, n_batch, n_head) into
+            # (n_head, head_size, n_seq, n_batch)
+            transpose_async(1.0, self.v.grad, self.v_transposed.grad, 3)
+        # dV can be deleted
+        #self.v.grad.wont_use()
+        self.v.grad.invalidate_submit()
+        # Backward for V_transposed = einsum('jkl,lmn->jkmn', W_V, X_V),
+        # packed projections are done later at once
+        if self.w_qkv is None:
+            self._backward_projection_async(self.x_v, self.w_v, \
+                    self.v_transposed, w_priority)
+        # Backward for rotary position embedding of K
+        if self.rope_base > 0:
+            rope_backward_async(self.rope_base, self.kv_cache_pos, \
+                    self.k.grad)
+        # Backward for bias of K
+        if self.in_proj_bias_k is not None:
+            if self.in_proj_bias_k.grad_required:
+                sum_fiber_async(1, self.k.grad, 1, self.in_proj_bias_k.grad, \
+                        0, 1, redux=self.redux)
+                self.in_proj_bias_k.grad.wont_use()
+        # Backward for axes rotation (K_transposed->K)
+        if self.k_transposed.grad_required:
+            # Rotate axes (head_size, n_seq, n_batch, n_head) into
+            # (n_head, head_size, n_seq, n_batch)
+            transpose_async(1.0, self.k.grad, self.k_transposed.grad, 3)
+        # dK can be deleted
+        #self.k.grad.wont_use()
+        self.k.grad.invalidate_submit()
+        # Backward for K_transposed = einsum('jkl,lmn->jkmn', W_K, X_K),
+        # packed projections are done later at once
+        if self.w_qkv is None:
+            self._backward_projection_async(self.x_k, self.w_k, \
+                    self.k_transposed, w_priority)
+        # Backward for rotary position embedding of Q
+        if self.rope_base > 0:
+            rope_backward_async(self.rope_base, self.kv_cache_pos, \
+                    self.q.grad)
+        # Backward for bias of Q
+        if self.in_proj_bias_q is not None:
+            if self.in_proj_bias_q.grad_required:
+                sum_fiber_async(1, self.q.grad, 1, self.in_proj_bias_q.grad, \
+                        0, 1, redux=self.redux)
+                self.in_proj_bias_q.grad.wont_use()
+        # Backward for axes rotation (Q_transposed->Q)
+        if self.q_transposed.grad_required:
+            # Rotate axes (head_size, n_seq, n_batch, n_head) into
+            # (n_head, head_size, n_seq, n_batch)
+            transpose_async(1.0, self.q.grad, self.q_transposed.grad, 3)
+        # dQ can be deleted
+        #self.q.grad.wont_use()
+        self.q.grad.invalidate_submit()
+        # Backward for Q_transposed = einsum('jkl,lmn->jkmn', W_Q, X_Q) or
+        # for all the packed projections at once
+        if self.w_qkv is None:
+            self._backward_projection_async(self.x_q, self.w_q, \
+                    self.q_transposed, w_priority)
+        else:
+            self._backward_projection_async(self.x_q, self.w_qkv, \
+                    self.qkv_transposed, w_priority)
+
+    # Backward of softmax of attention weights and its product with values
+    def _backward_softmax_async(self):
+        if self.fused:
+            # Single-pass fused backward recomputes attention weights
+            flash_attention_backward_async(self.q.value, self.q.grad, \
+                    self.k.value, self.k.grad, self.v.value, self.v.grad, \
+                    self.mask, self.a_maxsumexp, self.b.value, self.b.grad, \
+                    self.a_sumprod_slice, redux=self.redux)
+            self.mask.wont_use()
+            # Inputs of the backward can be deleted
+            self.b.value.invalidate_submit()
+            self.b.grad.invalidate_submit()
+            self.a_maxsumexp.invalidate_submit()
+            self.a_sumprod_slice.invalidate_submit()
+            self.q.value.invalidate_submit()
+            self.k.value.invalidate_submit()
+            self.v.value.invalidate_submit()
+            return
         # Backward for B = einsum('jklb,kmlb->jmlb', V, A)
         if self.a.grad_required:
             # dA = einsum('jklb,jmlb->kmlb', V, dB)
@@ -628,7 +1200,8 @@ class Attention(BaseLayer):
         self.a.value.invalidate_submit()
         # Backward for mask if needed
         if self.mask:
-            mask_scalar_async(self.mask, 0, self.a.grad, 2)
+            mask_scalar_async(self.mask, 0, self.a.grad, \
+                    self.a.grad.ndim-self.mask.ndim)
             self.mask.wont_use()
         # Backward for:
         # A = 1.0/sqrt(head_size) * einsum('jklb,jmlb->kmlb', K, Q)
@@ -661,143 +1234,66 @@ class Attention(BaseLayer):
         # dA can be deleted
         #self.a.grad.wont_use()
         self.a.grad.invalidate_submit()
-        # Backward for bias of V
-        if self.in_proj_bias_v is not None:
-            if self.in_proj_bias_v.grad_required:
-                sum_fiber_async(1, self.v.grad, 1, self.in_proj_bias_v.grad, \
-                        0, 1, redux=self.redux)
-                self.in_proj_bias_v.grad.wont_use()
-        # Backward for axes rotation (V_transposed->V)
-        if self.v_transposed.grad_required:
-            # Rotate axes (head_size, n_seq, n_batch, n_head) into
-            # (n_head, head_size, n_seq, n_batch)
-            transpose_async(1.0, self.v.grad, self.v_transposed.grad, 3)
-        # dV can be deleted
-        #self.v.grad.wont_use()
-        self.v.grad.invalidate_submit()
-        # Backward for V_transposed = einsum('jkl,lmn->jkmn', W_V, X_V)
-        if self.x_v.grad_required:
-            # dX_V += einsum('jkl,jkmn->lmn', W_V, dV_transposed)
-            if self.fp32_fast_tf32:
-                gemm_ex_async(1.0, trans, self.w_v.value, notrans, \
-                        self.v_transposed.grad, 1.0, self.x_v.grad, 2, 0, \
-                        redux=self.redux)
-            else:
-                gemm_async(1.0, trans, self.w_v.value, notrans, \
-                        self.v_transposed.grad, 1.0, self.x_v.grad, 2, 0, \
-                        redux=self.redux)
-        # W_V can be offloaded from GPU
-        self.w_v.value.wont_use()
-        # dX_V can be offloaded from GPU
-        self.x_v.grad.wont_use()
-        if self.w_v.grad_required:
-            # dW_V += einsum('jkmn,lmn->jkl', dV_transposed, X_V)
-            if self.fp32_fast_tf32:
-                gemm_ex_async(1.0, notrans, self.v_transposed.grad, trans, \
-                        self.x_v.value, 1.0, self.w_v.grad, 2, 0, \
-                        redux=self.redux)
-            else:
-                gemm_async(1.0, notrans, self.v_transposed.grad, trans, \
-                        self.x_v.value, 1.0, self.w_v.grad, 2, 0, \
-                        redux=self.redux)
-        # dW_V can be offloaded from GPU
-        self.w_v.grad.wont_use()
-        # X_V can be offloaded from GPU
-        self.x_v.value.wont_use()
-        # dV_transposed can be deleted
-        #self.v_transposed.grad.wont_use()
-        self.v_transposed.grad.invalidate_submit()
-        # Backward for bias of K
-        if self.in_proj_bias_k is not None:
-            if self.in_proj_bias_k.grad_required:
-                sum_fiber_async(1, self.k.grad, 1, self.in_proj_bias_k.grad, \
-                        0, 1, redux=self.redux)
-                self.in_proj_bias_k.grad.wont_use()
-        # Backward for axes rotation (K_transposed->K)
-        if self.k_transposed.grad_required:
-            # Rotate axes (head_size, n_seq, n_batch, n_head) into
-            # (n_head, head_size, n_seq, n_batch)
-            transpose_async(1.0, self.k.grad, self.k_transposed.grad, 3)
-        # dK can be deleted
-        #self.k.grad.wont_use()
-        self.k.grad.invalidate_submit()
-        # Backward for K_transposed = einsum('jkl,lmn->jkmn', W_K, X_K)
-        if self.x_k.grad_required:
-            # dX_K += einsum('jkl,jkmn->lmn', W_K, dK_transposed)
-            if self.fp32_fast_tf32:
-                gemm_ex_async(1.0, trans, self.w_k.value, notrans, \
-                        self.k_transposed.grad, 1.0, self.x_k.grad, 2, 0, \
-                        redux=self.redux)
-            else:
-                gemm_async(1.0, trans, self.w_k.value, notrans, \
-                        self.k_transposed.grad, 1.0, self.x_k.grad, 2, 0, \
-                        redux=self.redux)
-        # W_K can be offloaded from GPU
-        self.w_k.value.wont_use()
-        # dX_K can be offloaded from GPU
-        self.x_k.grad.wont_use()
-        if self.w_k.grad_required:
-            # dW_K += einsum('jkmn,lmn->jkl', dK_transposed, X_K)
-            if self.fp32_fast_tf32:
-                gemm_ex_async(1.0, notrans, self.k_transposed.grad, trans, \
-                        self.x_k.value, 1.0, self.w_k.grad, 2, 0, \
-                        redux=self.redux)
-            else:
-                gemm_async(1.0, notrans, self.k_transposed.grad, trans, \
-                        self.x_k.value, 1.0, self.w_k.grad, 2, 0, \
-                        redux=self.redux)
-        # dW_K can be offloaded from GPU
-        self.w_k.grad.wont_use()
-        # X_K can be offloaded from GPU
-        self.x_k.value.wont_use()
-        # dK_transposed can be deleted
-        #self.k_transposed.grad.wont_use()
-        self.k_transposed.grad.invalidate_submit()
-        # Backward for bias of Q
-        if self.in_proj_bias_q is not None:
-            if self.in_proj_bias_q.grad_required:
-                sum_fiber_async(1, self.q.grad, 1, self.in_proj_bias_q.grad, \
-                        0, 1, redux=self.redux)
-                self.in_proj_bias_q.grad.wont_use()
-        # Backward for axes rotation (Q_transposed->Q)
-        if self.q_transposed.grad_required:
-            # Rotate axes (head_size, n_seq, n_batch, n_head) into
-            # (n_head, head_size, n_seq, n_batch)
-            transpose_async(1.0, self.q.grad, self.q_transposed.grad, 3)
-        # dQ can be deleted
-        #self.q.grad.wont_use()
-        self.q.grad.invalidate_submit()
-        # Backward for Q_transposed = einsum('jkl,lmn->jkmn', W_Q, X_Q)
-        if self.x_q.grad_required:
-            # dX_Q += einsum('jkl,jkmn->lmn', W_Q, dQ_transposed)
+
+    # Backward for a projection T_transposed = einsum('jkl,lmn->jkmn', W, X)
+    def _backward_projection_async(self, x: TensorMoments, w: TensorMoments, \
+            t_transposed: TensorMoments, w_priority: int):
+        if x.grad_required:
+            # dX += einsum('jkl,jkmn->lmn', W, dT_transposed)
             if self.fp32_fast_tf32:
-                gemm_ex_async(1.0, trans, self.w_q.value, notrans, \
-                        self.q_transposed.grad, 1.0, self.x_q.grad, 2, 0, \
+                gemm_ex_async(1.0, trans, w.value, notrans, \
+                        t_transposed.grad, 1.0, x.grad, 2, 0, \
                         redux=self.redux)
             else:
-                gemm_async(1.0, trans, self.w_q.value, notrans, \
-                        self.q_transposed.grad, 1.0, self.x_q.grad, 2, 0, \
+                gemm_async(1.0, trans, w.value, notrans, \
+                        t_transposed.grad, 1.0, x.grad, 2, 0, \
                         redux=self.redux)
-            self.x_q.grad.wont_use()
-        # W_Q can be offloaded from GPU
-        self.w_q.value.wont_use()
-        # dX_Q can be offloaded from GPU
-        self.x_q.grad.wont_use()
-        if self.w_q.grad_required:
-            # dW_Q += einsum('jkmn,lmn->jkl', dQ_transposed, X_Q)
+        # W can be offloaded from GPU
+        w.value.wont_use()
+        # dX can be offloaded from GPU
+        x.grad.wont_use()
+        if w.grad_required:
+            # dW += einsum('jkmn,lmn->jkl', dT_transposed, X)
             if self.fp32_fast_tf32:
-                gemm_ex_async(1.0, notrans, self.q_transposed.grad, trans, \
-                        self.x_q.value, 1.0, self.w_q.grad, 2, 0, \
-                        redux=self.redux)
+                gemm_ex_async(1.0, notrans, t_transposed.grad, trans, \
+                        x.value, 1.0, w.grad, 2, 0, redux=self.redux, \
+                        priority=w_priority)
             else:
-                gemm_async(1.0, notrans, self.q_transposed.grad, trans, \
-                        self.x_q.value, 1.0, self.w_q.grad, 2, 0, \
-                        redux=self.redux)
-        # dW_Q can be offloaded from GPU
-        self.w_q.grad.wont_use()
-        # X_Q can be offloaded from GPU
-        self.x_q.value.wont_use()
-        # dQ_transposed can be deleted
-        #self.q_transposed.grad.wont_use()
-        self.q_transposed.grad.invalidate_submit()
+                gemm_async(1.0, notrans, t_transposed.grad, trans, \
+                        x.value, 1.0, w.grad, 2, 0, redux=self.redux, \
+                        priority=w_priority)
+        # dW can be offloaded from GPU
+        w.grad.wont_use()
+        # X can be offloaded from GPU
+        x.value.wont_use()
+        # dT_transposed can be deleted
+        t_transposed.grad.invalidate_submit()
+
+    # Packed weight is not a parameter, as the optimizers get its views
+    def unregister(self):
+        super().unregister()
+        if self.w_qkv is not None:
+            self.w_qkv.unregister()
 
+    # C++ counterpart of the layer without KV-cache
+    def to_cpp(self):
+        cls = cpp_class("Attention", self.x_q.value)
+        if cls is None or self.k_cache is not None or self.fp32_fast_tf32 \
+                or self.w_qkv is not None or self.fused:
+            return None
+        moments = [cpp_moments(t) for t in (self.x_q, self.x_k, self.x_v, \
+                self.y, self.w_q, self.w_k, self.w_v, self.w, \
+                self.q_transposed, self.q, self.k_transposed, self.k, \
+                self.v_transposed, self.v, self.a)]
+        tail = [cpp_moments(t) for t in (self.b, self.b_transposed)]
+        biases = [cpp_moments(t) if t is not None else None for t in \
+                (self.in_proj_bias_q, self.in_proj_bias_k, \
+                self.in_proj_bias_v, self.out_proj_bias)]
+        if None in moments or None in tail:
+            return None
+        for t, bias in zip((self.in_proj_bias_q, self.in_proj_bias_k, \
+                self.in_proj_bias_v, self.out_proj_bias), biases):
+            if t is not None and bias is None:
+                return None
+        return cls(*moments, self.a_maxsumexp, self.a_sumprod_slice, *tail, \
+                *biases, self.mask if self.mask else None, self.redux)
@@ -11,10 +11,29 @@
 # @author Aleksandr Mikhalev
 # @date 2023-05-06
 
-from nntile.tensor import Tensor, TensorMoments, randn_async
+from nntile.tensor import Tensor, TensorMoments, randn_async, Tensor_fp32, \
+        Tensor_fp64
+from nntile.nntile_core import layer as core_layer
 import numpy as np
 from typing import List, Union
 
+# Suffix of C++ layers for a type of tensors or None, if there are none
+def cpp_type(x: Tensor):
+    return {Tensor_fp32: "fp32", Tensor_fp64: "fp64"}.get(type(x))
+
+# C++ layer class of a given name for the type of tensor x or None
+def cpp_class(name: str, x: Tensor):
+    suffix = cpp_type(x)
+    if suffix is None:
+        return None
+    return getattr(core_layer, name+"_"+suffix)
+
+# C++ value and gradient of a tensor or None, if gradient is not required
+def cpp_moments(x: TensorMoments):
+    if x.grad is None or not x.grad_required:
+        return None
+    return getattr(core_layer, "Moments_"+cpp_type(x.value))(x.value, x.grad)
+
 class BaseLayer(object):
     # Input activations with moments
     activations_input: List[TensorMoments]
@@ -57,11 +76,19 @@ class BaseLayer(object):
         self.forward_async()
         starpu.wait_for_all()
 
+    # Counterpart of the layer from nntile_core.layer, that submits the same
+    # tasks from C++, or None if the current configuration of the layer has
+    # none (see BaseModel.set_cpp_submission)
+    def to_cpp(self):
+        return None
+
     # Unregister layer weights and temporary tensors
+    # Tensors are unregistered after all the submitted tasks on them, so
+    # that the submitting thread is not blocked
     def unregister(self):
         for p in self.parameters:
-            p.unregister()
+            p.unregister_submit()
         for t in self.temporaries:
             if t is not None:
-                t.unregister()
+                t.unregister_submit()
 
@@ -0,0 +1,312 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/layer/batch_norm_act.py
+# Batch normalization fused with an activation of NNTile Python package
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+from nntile.tensor import TensorTraits, Tensor, TensorMoments, \
+        BatchNormActivation, add_async, add_scalar_async, clear_async, \
+        copy_async, fill_async, pow_async, prod_async, prod_fiber_async, \
+        sum_fiber_async, sumprod_fiber_async, relu_forward_async, \
+        gelutanh_async, batch_norm_act_async, batch_norm_act_backward_async, \
+        batch_norm_backward_async
+from nntile.layer.base_layer import BaseLayer
+from nntile.layer.linear import Linear
+import numpy as np
+from typing import Optional
+
+class BatchNormAct(BaseLayer):
+    """Batch normalization over all axes except the axis of features,
+    followed by an activation
+
+    Normalization and the activation are applied by a single pass over data,
+    and the backward recomputes the normalized input from X and the stored
+    statistics instead of keeping it. Statistics of a batch are computed by
+    reductions over fibers in training mode, and running statistics are
+    updated with the given momentum as in torch.nn.BatchNorm1d. Running
+    statistics are used if training attribute is False.
+
+    For inference, normalization can be folded into the preceding Linear
+    layer (see fold_async), after which the layer applies only the
+    activation.
+    """
+    x: TensorMoments
+    y: TensorMoments
+    gamma: TensorMoments
+    beta: TensorMoments
+    activations = {None: BatchNormActivation.none, \
+            'relu': BatchNormActivation.relu, \
+            'gelutanh': BatchNormActivation.gelutanh}
+    training: bool
+    folded: bool
+
+    # Construct normalization layer with all the provided data. Gradient of
+    # output of normalization tmp_z_grad is distributed as the statistics,
+    # so that sums of its fibers are accumulated on their owners.
+    def __init__(self, x: TensorMoments, y: TensorMoments, \
+            gamma: TensorMoments, beta: TensorMoments, mean: Tensor, \
+            inv_stddev: Tensor, var: Tensor, sum_z_grad: Tensor, \
+            sum_z_grad_xhat: Tensor, tmp_z_grad: Tensor, \
+            running_mean: Tensor, running_var: Tensor, axis: int, \
+            funcname: Optional[str], eps: float=1e-5, momentum: float=0.1, \
+            redux: bool=False):
+        if funcname not in BatchNormAct.activations:
+            raise ValueError("Activation must be None, 'relu' or 'gelutanh'")
+        # Redirect to BaseLayer initialization
+        super().__init__([x], [y], [gamma, beta], [mean, inv_stddev, var, \
+                sum_z_grad, sum_z_grad_xhat, tmp_z_grad])
+        self.x = x
+        if self.x.grad is not None:
+            self.x.grad.set_reduction_add()
+        self.y = y
+        self.gamma = gamma
+        self.gamma.grad.set_reduction_add()
+        self.beta = beta
+        self.beta.grad.set_reduction_add()
+        self.mean = mean
+        self.mean.set_reduction_add()
+        self.inv_stddev = inv_stddev
+        self.var = var
+        self.var.set_reduction_add()
+        self.sum_z_grad = sum_z_grad
+        self.sum_z_grad.set_reduction_add()
+        self.sum_z_grad_xhat = sum_z_grad_xhat
+        self.sum_z_grad_xhat.set_reduction_add()
+        self.tmp_z_grad = tmp_z_grad
+        # Running statistics are kept between steps, so they are neither
+        # parameters nor temporaries
+        self.running_mean = running_mean
+        self.running_var = running_var
+        self.axis = axis
+        self.funcname = funcname
+        self.act = BatchNormAct.activations[funcname]
+        self.eps = eps
+        self.momentum = momentum
+        # Number of elements of a single feature
+        self.n = int(np.prod(x.value.shape)) // x.value.shape[axis]
+        if redux:
+            self.redux = 1
+        else:
+            self.redux = 0
+        self.training = True
+        self.folded = False
+        # Mean, that was used by the last forward
+        self.used_mean = self.mean
+
+    # Simple generator for the normalization layer
+    @staticmethod
+    def generate_simple(x: TensorMoments, axis: int, \
+            funcname: Optional[str], next_tag: int, eps: float=1e-5, \
+            momentum: float=0.1, redux: bool=False):
+        # Get traits of X
+        x_traits = TensorTraits(x.value.shape, x.value.basetile_shape)
+        # Create Y with the same traits and distribution as X
+        x_distr = x.value.distribution
+        y_value = type(x.value)(x_traits, x_distr, next_tag)
+        next_tag = y_value.next_tag
+        y_grad = type(x.value)(x_traits, x_distr, next_tag)
+        next_tag = y_grad.next_tag
+        y = TensorMoments(y_value, y_grad, True)
+        # Vectors of features are distributed as the first tiles of X along
+        # the axis
+        feat_traits = TensorTraits([x.value.shape[axis]], \
+                [x.value.basetile_shape[axis]])
+        feat_distr = []
+        for i in range(x.value.grid.shape[axis]):
+            feat_distr.append(x_distr[x.value.grid.stride[axis]*i])
+        def feature_vector(next_tag):
+            t = type(x.value)(feat_traits, feat_distr, next_tag)
+            return t, t.next_tag
+        gamma_value, next_tag = feature_vector(next_tag)
+        gamma_grad, next_tag = feature_vector(next_tag)
+        gamma = TensorMoments(gamma_value, gamma_grad, True)
+        beta_value, next_tag = feature_vector(next_tag)
+        beta_grad, next_tag = feature_vector(next_tag)
+        beta = TensorMoments(beta_value, beta_grad, True)
+        mean, next_tag = feature_vector(next_tag)
+        inv_stddev, next_tag = feature_vector(next_tag)
+        var, next_tag = feature_vector(next_tag)
+        sum_z_grad, next_tag = feature_vector(next_tag)
+        sum_z_grad_xhat, next_tag = feature_vector(next_tag)
+        running_mean, next_tag = feature_vector(next_tag)
+        running_var, next_tag = feature_vector(next_tag)
+        # Tile of gradient of output of normalization is owned by the owner
+        # of the corresponding tile of features
+        z_distr = []
+        for i in range(x.value.grid.nelems):
+            tile_index = x.value.grid.linear_to_index(i)
+            z_distr.append(feat_distr[tile_index[axis]])
+        tmp_z_grad = type(x.value)(x_traits, z_distr, next_tag)
+        next_tag = tmp_z_grad.next_tag
+        layer = BatchNormAct(x, y, gamma, beta, mean, inv_stddev, var, \
+                sum_z_grad, sum_z_grad_xhat, tmp_z_grad, running_mean, \
+                running_var, axis, funcname, eps, momentum, redux)
+        # Init parameters and running statistics as PyTorch does
+        fill_async(1.0, gamma.value)
+        clear_async(beta.value)
+        clear_async(running_mean)
+        fill_async(1.0, running_var)
+        # Return layer and next tag to be used
+        return (layer, next_tag)
+
+    # Statistics of the current batch and update of running statistics
+    def _batch_statistics_async(self):
+        inv_n = 1.0 / self.n
+        sum_fiber_async(inv_n, self.x.value, 0.0, self.mean, self.axis, 0, \
+                redux=self.redux)
+        sumprod_fiber_async(inv_n, self.x.value, self.x.value, 0.0, \
+                self.var, self.axis, redux=self.redux)
+        # Biased variance var = E[X^2] - E[X]^2
+        copy_async(self.mean, self.inv_stddev)
+        prod_async(self.mean, self.inv_stddev)
+        add_async(-1.0, self.inv_stddev, 1.0, self.var)
+        if self.momentum > 0:
+            add_async(self.momentum, self.mean, 1.0-self.momentum, \
+                    self.running_mean)
+            # Running variance is unbiased
+            unbias = self.n / max(self.n-1, 1)
+            add_async(self.momentum*unbias, self.var, 1.0-self.momentum, \
+                    self.running_var)
+        copy_async(self.var, self.inv_stddev)
+
+    # Forward propagation of the normalization layer
+    def forward_async(self):
+        if self.folded:
+            # Normalization is a part of the preceding linear layer
+            if self.funcname == "relu":
+                relu_forward_async(self.x.value, self.y.value)
+            elif self.funcname == "gelutanh":
+                gelutanh_async(self.x.value, self.y.value)
+            else:
+                copy_async(self.x.value, self.y.value)
+        else:
+            if self.training:
+                self._batch_statistics_async()
+                self.used_mean = self.mean
+            else:
+                copy_async(self.running_var, self.inv_stddev)
+                self.used_mean = self.running_mean
+            # inv_stddev = 1 / sqrt(var+eps)
+            add_scalar_async(self.eps, 1.0, self.inv_stddev)
+            pow_async(1.0, -0.5, self.inv_stddev)
+            # Normalize, scale, shift and apply activation by a single pass
+            batch_norm_act_async(self.x.value, self.used_mean, \
+                    self.inv_stddev, self.gamma.value, self.beta.value, \
+                    self.y.value, self.axis, self.act)
+            self.gamma.value.wont_use()
+            self.beta.value.wont_use()
+        self.x.value.wont_use()
+        self.y.value.wont_use()
+
+    # Backward propagation of the normalization layer
+    def backward_async(self):
+        if self.folded:
+            raise RuntimeError("Folded normalization supports only inference")
+        mean = self.used_mean
+        # Gradient of output of normalization and its sums over features
+        clear_async(self.sum_z_grad)
+        clear_async(self.sum_z_grad_xhat)
+        batch_norm_act_backward_async(self.x.value, mean, self.inv_stddev, \
+                self.gamma.value, self.beta.value, self.y.grad, \
+                self.tmp_z_grad, self.sum_z_grad, self.sum_z_grad_xhat, \
+                self.axis, self.act, redux=self.redux)
+        self.y.grad.wont_use()
+        self.beta.value.wont_use()
+        # Sums are gradients of beta and gamma
+        if self.beta.grad_required:
+            add_async(1.0, self.sum_z_grad, 1.0, self.beta.grad)
+            self.beta.grad.wont_use()
+        if self.gamma.grad_required:
+            add_async(1.0, self.sum_z_grad_xhat, 1.0, self.gamma.grad)
+            self.gamma.grad.wont_use()
+        if self.x.grad_required:
+            if self.training:
+                # Statistics depend on X
+                batch_norm_backward_async(self.x.value, mean, \
+                        self.inv_stddev, self.gamma.value, self.sum_z_grad, \
+                        self.sum_z_grad_xhat, self.tmp_z_grad, self.axis)
+            else:
+                # Running statistics are constants
+                copy_async(self.gamma.value, self.var)
+                prod_async(self.inv_stddev, self.var)
+                prod_fiber_async(self.var, 1.0, self.tmp_z_grad, self.axis)
+            add_async(1.0, self.tmp_z_grad, 1.0, self.x.grad)
+            self.x.grad.wont_use()
+        self.x.value.wont_use()
+        self.gamma.value.wont_use()
+        self.tmp_z_grad.invalidate_submit()
+        self.sum_z_grad.invalidate_submit()
+        self.sum_z_grad_xhat.invalidate_submit()
+        self.mean.invalidate_submit()
+        self.inv_stddev.invalidate_submit()
+
+    # Fold normalization with running statistics into the preceding linear
+    # layer for inference, so that
+    #   W' = diag(gamma/sqrt(running_var+eps)) W
+    #   b' = gamma/sqrt(running_var+eps) (b-running_mean) + beta
+    # Afterwards this layer applies only the activation. Linear layer
+    # without bias gets a new one, so the next tag is returned.
+    def fold_async(self, linear: Linear, next_tag: int) -> int:
+        if self.folded:
+            raise ValueError("Normalization is already folded")
+        if linear.y.value is not self.x.value:
+            raise ValueError("Output of the linear layer shall be the input " \
+                    "of normalization")
+        if linear.activation is not None or linear.w_q is not None \
+                or linear.lora_a is not None:
+            raise ValueError("Linear layer with an activation, quantized " \
+                    "weights or low-rank adapters cannot be folded")
+        if linear.w.value.ndim-linear.ndim != 1:
+            raise ValueError("Linear layer shall have a single axis of " \
+                    "output features")
+        # Output features of Y are the first axis for side 'R', and the last
+        # one for side 'L', and the same holds for W
+        if linear.side == 'R':
+            y_axis, w_axis = 0, 0
+        else:
+            y_axis = linear.y.value.ndim - 1
+            w_axis = linear.w.value.ndim - 1
+        if self.axis != y_axis:
+            raise ValueError("Normalization shall be over output features " \
+                    "of the linear layer")
+        # Scale gamma/sqrt(running_var+eps) is stored into inv_stddev and
+        # shift beta-running_mean*scale into var
+        copy_async(self.running_var, self.inv_stddev)
+        add_scalar_async(self.eps, 1.0, self.inv_stddev)
+        pow_async(1.0, -0.5, self.inv_stddev)
+        prod_async(self.gamma.value, self.inv_stddev)
+        copy_async(self.running_mean, self.var)
+        prod_async(self.inv_stddev, self.var)
+        add_async(1.0, self.beta.value, -1.0, self.var)
+        prod_fiber_async(self.inv_stddev, 1.0, linear.w.value, w_axis)
+        if linear.b is None:
+            b_traits = TensorTraits(self.var.shape, self.var.basetile_shape)
+            b_distr = [0] * b_traits.grid.nelems
+            b_value = type(self.var)(b_traits, b_distr, next_tag)
+            next_tag = b_value.next_tag
+            copy_async(self.var, b_value)
+            # Bias for inference only does not need a gradient
+            linear.b = TensorMoments(b_value, None, False)
+            linear.parameters.append(linear.b)
+        else:
+            prod_async(self.inv_stddev, linear.b.value)
+            add_async(1.0, self.var, 1.0, linear.b.value)
+        linear.w.value.wont_use()
+        linear.b.value.wont_use()
+        self.inv_stddev.invalidate_submit()
+        self.var.invalidate_submit()
+        self.folded = True
+        return next_tag
+
+    # Unregister parameters, temporaries and running statistics
+    def unregister(self):
+        super().unregister()
+        self.running_mean.unregister_submit()
+        self.running_var.unregister_submit()
@@ -0,0 +1,106 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/layer/dropout.py
+# Dropout layer of NNTile Python package
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-15
+
+from nntile.tensor import TensorTraits, TensorMoments, copy_async, \
+        add_async, dropout_async
+from nntile.layer.base_layer import BaseLayer
+
+# Increment of seed between steps, that keeps masks of layers with close
+# seeds apart
+SEED_STEP = 0x9E3779B97F4A7C15
+
+class Dropout(BaseLayer):
+    """Dropout layer, that never stores its mask
+
+    Forward zeroes out each element of X with probability p and scales the
+    remaining ones by 1/(1-p). Mask is generated from a seed by a
+    counter-based generator, and backward regenerates the same mask from the
+    same seed. Seed changes after every backward, so that recomputation of
+    a checkpointed forward reproduces the mask of the original forward.
+    Replay of a captured task graph would reuse the seed of the capture, so
+    Pipeline does not capture models with active dropout.
+
+    Dropout is applied only if training attribute is True.
+    """
+    x: TensorMoments
+    y: TensorMoments
+    p: float
+    seed: int
+    step: int
+    training: bool
+
+    # Construct dropout layer with all the provided data
+    def __init__(self, x: TensorMoments, y: TensorMoments, p: float, \
+            seed: int):
+        if p < 0 or p >= 1:
+            raise ValueError("Dropout probability shall be in range [0, 1)")
+        # Redirect to BaseLayer initialization
+        super().__init__([x], [y], [], [])
+        self.x = x
+        if self.x.grad is not None:
+            self.x.grad.set_reduction_add()
+        self.y = y
+        self.p = p
+        self.seed = seed
+        self.step = 0
+        self.training = True
+
+    # Simple generator for the dropout layer
+    @staticmethod
+    def generate_simple(x: TensorMoments, p: float, seed: int, \
+            next_tag: int):
+        # Get traits of X
+        x_traits = TensorTraits(x.value.shape, x.value.basetile_shape)
+        # Create Y with the same traits and distribution as X
+        y_value = type(x.value)(x_traits, x.value.distribution, next_tag)
+        next_tag = y_value.next_tag
+        y_grad = type(x.value)(x_traits, x.value.distribution, next_tag)
+        next_tag = y_grad.next_tag
+        y = TensorMoments(y_value, y_grad, True)
+        # Create dropout layer with all the provided tensors
+        layer = Dropout(x, y, p, seed)
+        # Return layer and next tag to be used
+        return (layer, next_tag)
+
+    # Whether the mask is applied
+    @property
+    def stochastic(self) -> bool:
+        return self.training and self.p > 0
+
+    # Seed of the current step
+    def get_seed(self) -> int:
+        return (self.seed + self.step*SEED_STEP) % 2**64
+
+    # Forward propagation of the dropout layer
+    def forward_async(self):
+        if self.stochastic:
+            dropout_async(self.get_seed(), self.p, self.x.value, 0.0, \
+                    self.y.value)
+        else:
+            copy_async(self.x.value, self.y.value)
+        self.x.value.wont_use()
+        self.y.value.wont_use()
+
+    # Backward propagation of the dropout layer
+    def backward_async(self):
+        if self.x.grad_required:
+            if self.stochastic:
+                dropout_async(self.get_seed(), self.p, self.y.grad, 1.0, \
+                        self.x.grad)
+            else:
+                add_async(1.0, self.y.grad, 1.0, self.x.grad)
+            self.x.grad.wont_use()
+            self.y.grad.wont_use()
+        # Next forward uses a new mask
+        if self.stochastic:
+            self.step += 1
@@ -12,8 +12,10 @@
 # @date 2023-09-29
 
 from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
-        Tensor_int64, clear_async, embedding_async, embedding_backward_async
-from nntile.layer.base_layer import BaseLayer
+        Tensor_int64, Tensor_bool, clear_async, embedding_async, \
+        embedding_backward_async, embedding_rows_async
+from nntile.layer.base_layer import BaseLayer, cpp_class, cpp_moments
+import nntile
 import numpy as np
 from typing import List
 
@@ -22,10 +24,15 @@ class Embedding(BaseLayer):
     y: TensorMoments
     w: TensorMoments
 
-    # Construct linear layer with all the provided data
+    # Construct embedding layer with all the provided data. If rows is
+    # provided, gradient of vocabulary is sparse: backward also marks rows of
+    # vocabulary, used by tokens, in a mask w.rows, so that an optimizer
+    # updates only the marked rows. The mask is cleared together with the
+    # gradient of vocabulary.
     def __init__(self, x: Tensor_int64, y: TensorMoments, w: TensorMoments, \
-            axis: int):
-        # Redirect to BaseClass initialization
+            axis: int, rows: Tensor_bool=None):
+        # Redirect to BaseClass initialization. The mask is not a temporary,
+        # as it is read by an optimizer after the backward pass.
         super().__init__([x], [y], [w], [])
         # Named storage
         self.x = x
@@ -33,20 +40,31 @@ class Embedding(BaseLayer):
         self.w = w
         self.w.grad.set_reduction_add()
         self.axis = axis
+        self.rows = rows
+        self.w.rows = rows
 
-    # Simple generator for the embedding layer
+    # Simple generator for the embedding layer. If vocab_tile is provided,
+    # vocabulary is split into shards of vocab_tile rows, that are
+    # distributed over MPI nodes in a round-robin way. Lookups are done by
+    # owners of shards, so that only gathered embeddings and their gradients
+    # are sent over network instead of shards of vocabulary.
     @staticmethod
     def generate_simple(x: Tensor_int64, TensorType, axis: int, \
             vocab_size: int, emb_size: int, y_emb_tile: int, w_emb_tile: int, \
-            next_tag: int):
+            next_tag: int, sparse_grad: bool=False, vocab_tile: int=None):
         # Check embedding tile sizes
         if y_emb_tile % w_emb_tile != 0:
             raise ValueError("y_emb_tile % w_emb_tile != 0")
         # Embeddings vocabulary
         w_shape = [emb_size, vocab_size]
-        w_basetile = [w_emb_tile, vocab_size]
+        if vocab_tile is None:
+            vocab_tile = vocab_size
+        w_basetile = [w_emb_tile, vocab_tile]
         w_traits = TensorTraits(w_shape, w_basetile)
-        w_distr = [0] * w_traits.grid.nelems
+        w_grid_emb = w_traits.grid.shape[0]
+        world_size = nntile.starpu.mpi_world_size()
+        w_distr = [(i//w_grid_emb) % world_size \
+                for i in range(w_traits.grid.nelems)]
         w_value = TensorType(w_traits, w_distr, next_tag)
         next_tag = w_value.next_tag
         w_grad = TensorType(w_traits, w_distr, next_tag)
@@ -64,8 +82,16 @@ class Embedding(BaseLayer):
         y_grid = TensorType(y_traits, y_distr, next_tag)
         next_tag = y_grid.next_tag
         y = TensorMoments(y_value, y_grid, True)
+        # Mask of used rows of vocabulary for a sparse gradient
+        if sparse_grad:
+            rows_traits = TensorTraits([vocab_size], [vocab_size])
+            rows = Tensor_bool(rows_traits, [0], next_tag)
+            next_tag = rows.next_tag
+            clear_async(rows)
+        else:
+            rows = None
         # Create embedding layer with all the provided data
-        layer = Embedding(x, y, w, axis)
+        layer = Embedding(x, y, w, axis, rows)
         # Return layer and next tag to be used
         return (layer, next_tag)
 
@@ -79,11 +105,30 @@ class Embedding(BaseLayer):
 
     # Backward propagation of the embedding layer
     def backward_async(self):
+        # Frozen vocabulary takes no gradient
+        if not self.w.grad_required:
+            return
         # redux=1 leads to performance loss, as each embedding_backward is a
         # sparse operation, but reduction plays with a full dense vocabulary
         embedding_backward_async(self.x, self.y.grad, self.w.grad, self.axis, \
                 redux=0)
+        if self.rows is not None:
+            embedding_rows_async(self.x, self.rows)
+            self.rows.wont_use()
         self.x.wont_use()
         self.y.grad.wont_use()
         self.w.grad.wont_use()
 
+    # C++ counterpart of the layer
+    def to_cpp(self):
+        cls = cpp_class("Embedding", self.y.value)
+        moments = [cpp_moments(t) for t in (self.y, self.w)]
+        if cls is None or None in moments:
+            return None
+        return cls(self.x, *moments, self.axis, self.rows)
+
+    # Unregister layer weights and the mask of rows
+    def unregister(self):
+        super().unregister()
+        if self.rows is not None:
+            self.rows.unregister()
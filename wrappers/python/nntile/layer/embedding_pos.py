@@ -0,0 +1,132 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/layer/embedding_pos.py
+# Embedding of tokens with added positional embedding of NNTile Python package
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+from nntile.tensor import TensorTraits, TensorMoments, Tensor_int64, \
+        Tensor_bool, clear_async, embedding_pos_async, \
+        embedding_pos_backward_async, embedding_rows_async
+from nntile.layer.base_layer import BaseLayer
+
+class EmbeddingPos(BaseLayer):
+    x: Tensor_int64
+    pos: Tensor_int64
+    y: TensorMoments
+    w: TensorMoments
+    w_pos: TensorMoments
+
+    # Construct layer Y = W[:, X] + W_pos[:, pos] of a token embedding and a
+    # positional embedding. The same as two Embedding layers and AddSlice (or
+    # Add), but every tile of Y is written once, and backward reads every
+    # tile of gradient of Y once for both vocabularies. Modes of positions
+    # pos are the leading modes of tokens X, positions are repeated over the
+    # rest of modes of X. Sparse gradients are marked the same way as in
+    # Embedding layer with masks w.rows and w_pos.rows.
+    def __init__(self, x: Tensor_int64, pos: Tensor_int64, y: TensorMoments, \
+            w: TensorMoments, w_pos: TensorMoments, axis: int, \
+            rows: Tensor_bool=None, pos_rows: Tensor_bool=None):
+        # Order of parameters is the same as for two Embedding layers
+        super().__init__([x, pos], [y], [w, w_pos], [])
+        # Named storage
+        self.x = x
+        self.pos = pos
+        self.y = y
+        self.w = w
+        self.w.grad.set_reduction_add()
+        self.w_pos = w_pos
+        self.w_pos.grad.set_reduction_add()
+        self.axis = axis
+        self.rows = rows
+        self.w.rows = rows
+        self.pos_rows = pos_rows
+        self.w_pos.rows = pos_rows
+
+    # Simple generator for the layer
+    @staticmethod
+    def generate_simple(x: Tensor_int64, pos: Tensor_int64, TensorType, \
+            axis: int, vocab_size: int, max_pos: int, emb_size: int, \
+            y_emb_tile: int, w_emb_tile: int, next_tag: int, \
+            sparse_grad: bool=False):
+        # Check embedding tile sizes
+        if y_emb_tile % w_emb_tile != 0:
+            raise ValueError("y_emb_tile % w_emb_tile != 0")
+        # Vocabularies of tokens and positions
+        def vocab(size, next_tag):
+            w_traits = TensorTraits([emb_size, size], [w_emb_tile, size])
+            w_distr = [0] * w_traits.grid.nelems
+            w_value = TensorType(w_traits, w_distr, next_tag)
+            next_tag = w_value.next_tag
+            w_grad = TensorType(w_traits, w_distr, next_tag)
+            next_tag = w_grad.next_tag
+            return TensorMoments(w_value, w_grad, True), next_tag
+        w, next_tag = vocab(vocab_size, next_tag)
+        w_pos, next_tag = vocab(max_pos, next_tag)
+        # Output embeddings
+        y_shape = x.shape.copy()
+        y_shape.insert(axis, emb_size)
+        y_basetile = x.basetile_shape.copy()
+        y_basetile.insert(axis, y_emb_tile)
+        y_traits = TensorTraits(y_shape, y_basetile)
+        y_distr = [0] * y_traits.grid.nelems
+        y_value = TensorType(y_traits, y_distr, next_tag)
+        next_tag = y_value.next_tag
+        y_grad = TensorType(y_traits, y_distr, next_tag)
+        next_tag = y_grad.next_tag
+        y = TensorMoments(y_value, y_grad, True)
+        # Masks of used rows of vocabularies for sparse gradients
+        def mask(size, next_tag):
+            if not sparse_grad:
+                return None, next_tag
+            rows = Tensor_bool(TensorTraits([size], [size]), [0], next_tag)
+            clear_async(rows)
+            return rows, rows.next_tag
+        rows, next_tag = mask(vocab_size, next_tag)
+        pos_rows, next_tag = mask(max_pos, next_tag)
+        layer = EmbeddingPos(x, pos, y, w, w_pos, axis, rows, pos_rows)
+        # Return layer and next tag to be used
+        return (layer, next_tag)
+
+    # Forward propagation of the layer, all the output is overwritten
+    def forward_async(self):
+        embedding_pos_async(self.x, self.pos, self.w.value, \
+                self.w_pos.value, self.y.value, self.axis)
+        self.x.wont_use()
+        self.pos.wont_use()
+        self.w.value.wont_use()
+        self.w_pos.value.wont_use()
+        self.y.value.wont_use()
+
+    # Backward propagation of the layer
+    def backward_async(self):
+        # Frozen vocabularies take no gradient
+        if not self.w.grad_required and not self.w_pos.grad_required:
+            return
+        # Sparse updates of vocabularies do not benefit from reduction (see
+        # Embedding layer)
+        embedding_pos_backward_async(self.x, self.pos, self.y.grad, \
+                self.w.grad, self.w_pos.grad, self.axis, redux=0)
+        for index, rows in ((self.x, self.rows), (self.pos, self.pos_rows)):
+            if rows is not None:
+                embedding_rows_async(index, rows)
+                rows.wont_use()
+        self.x.wont_use()
+        self.pos.wont_use()
+        self.y.grad.wont_use()
+        self.w.grad.wont_use()
+        self.w_pos.grad.wont_use()
+
+    # Unregister layer weights and the masks of rows
+    def unregister(self):
+        super().unregister()
+        for rows in (self.rows, self.pos_rows):
+            if rows is not None:
+                rows.unregister()
+
@@ -0,0 +1,369 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/layer/factorized_linear.py
+# Linear layers with low-rank and tensor-train factorized weights
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+from nntile.tensor import TensorTraits, Tensor, TensorMoments, notrans, \
+        trans, gemm_async, transpose_async, background_priority
+from nntile.layer.base_layer import BaseLayer
+import numpy as np
+from typing import List, Optional
+
+# Tensor with moments of given shape and basetile of the same type as x
+def _moments(x: Tensor, shape: List[int], tile: List[int], next_tag: int):
+    traits = TensorTraits(shape, tile)
+    # TODO change distribution
+    distr = [0] * traits.grid.nelems
+    value = type(x)(traits, distr, next_tag)
+    grad = type(x)(traits, distr, value.next_tag)
+    return TensorMoments(value, grad, True), grad.next_tag
+
+class LowRankLinear(BaseLayer):
+    """Linear layer Y = U V X with weights of a low rank
+
+    X is of shape in_shape+batch_shape, where len(in_shape)=ndim, U is of
+    shape out_shape+[rank] and V is of shape [rank]+in_shape, that is the
+    side 'R' without transposition of X of the Linear layer. There are two
+    orders of contractions. The factored one computes H = V X of shape
+    [rank]+batch_shape and then Y = U H. The dense one forms the weight
+    W = U V, computes Y = W X and backward goes through dW = dY X^T. The
+    order with a smaller number of flops of forward and backward together
+    is chosen, unless it is provided explicitly.
+    """
+    x: TensorMoments
+    y: TensorMoments
+    u: TensorMoments
+    v: TensorMoments
+    h: Optional[TensorMoments]
+    w: Optional[TensorMoments]
+    ndim: int
+    order: str
+
+    # Construct low-rank linear layer with all the provided data
+    def __init__(self, x: TensorMoments, y: TensorMoments, \
+            u: TensorMoments, v: TensorMoments, ndim: int, \
+            h: Optional[TensorMoments]=None, \
+            w: Optional[TensorMoments]=None, redux: bool=False):
+        if ndim <= 0:
+            raise ValueError("ndim must be positive integer")
+        if h is not None:
+            self.order = "factored"
+            temporaries = [h]
+        elif w is not None:
+            self.order = "dense"
+            temporaries = [w]
+        else:
+            raise ValueError("Either h or w shall be provided")
+        super().__init__([x], [y], [u, v], temporaries)
+        self.x = x
+        if self.x.grad is not None:
+            self.x.grad.set_reduction_add()
+        self.y = y
+        self.y.value.set_reduction_add()
+        self.u = u
+        self.u.grad.set_reduction_add()
+        self.v = v
+        self.v.grad.set_reduction_add()
+        self.h = h
+        if h is not None:
+            self.h.value.set_reduction_add()
+            self.h.grad.set_reduction_add()
+        self.w = w
+        if w is not None:
+            self.w.value.set_reduction_add()
+            self.w.grad.set_reduction_add()
+        self.ndim = ndim
+        if redux:
+            self.redux = 1
+        else:
+            self.redux = 0
+
+    # Number of multiply-add operations of forward and backward together
+    @staticmethod
+    def cost(in_features: int, out_features: int, nbatch: int, rank: int, \
+            order: str) -> int:
+        if order == "factored":
+            return 3 * rank * nbatch * (in_features+out_features)
+        elif order == "dense":
+            return 3 * in_features * out_features * (rank+nbatch)
+        raise ValueError("order must be either 'factored' or 'dense'")
+
+    # Simple generator for the low-rank linear layer
+    @staticmethod
+    def generate_simple(x: TensorMoments, in_features_ndim: int, \
+            out_features_shape: List[int], \
+            out_features_basetile_shape: List[int], rank: int, \
+            next_tag: int, rank_tile: int=0, order: Optional[str]=None, \
+            redux: bool=False):
+        if rank <= 0:
+            raise ValueError("rank must be positive integer")
+        if rank_tile <= 0:
+            rank_tile = rank
+        ndim = in_features_ndim
+        in_shape = x.value.shape[:ndim]
+        in_tile = x.value.basetile_shape[:ndim]
+        batch_shape = x.value.shape[ndim:]
+        batch_tile = x.value.basetile_shape[ndim:]
+        if order is None:
+            args = (int(np.prod(in_shape)), int(np.prod(out_features_shape)), \
+                    int(np.prod(batch_shape)), rank)
+            if LowRankLinear.cost(*args, "dense") \
+                    < LowRankLinear.cost(*args, "factored"):
+                order = "dense"
+            else:
+                order = "factored"
+        u, next_tag = _moments(x.value, out_features_shape+[rank], \
+                out_features_basetile_shape+[rank_tile], next_tag)
+        v, next_tag = _moments(x.value, [rank]+in_shape, \
+                [rank_tile]+in_tile, next_tag)
+        y, next_tag = _moments(x.value, out_features_shape+batch_shape, \
+                out_features_basetile_shape+batch_tile, next_tag)
+        h = None
+        w = None
+        if order == "factored":
+            h, next_tag = _moments(x.value, [rank]+batch_shape, \
+                    [rank_tile]+batch_tile, next_tag)
+        elif order == "dense":
+            w, next_tag = _moments(x.value, out_features_shape+in_shape, \
+                    out_features_basetile_shape+in_tile, next_tag)
+        else:
+            raise ValueError("order must be either 'factored' or 'dense'")
+        layer = LowRankLinear(x, y, u, v, ndim, h, w, redux)
+        return (layer, next_tag)
+
+    # Forward propagation of the low-rank linear layer
+    def forward_async(self):
+        u = self.u.value
+        v = self.v.value
+        if self.order == "factored":
+            # H = V X, Y = U H
+            h = self.h.value
+            gemm_async(1.0, notrans, v, notrans, self.x.value, 0.0, h, \
+                    self.ndim, 0, redux=self.redux)
+            gemm_async(1.0, notrans, u, notrans, h, 0.0, self.y.value, 1, \
+                    0, redux=self.redux)
+            h.wont_use()
+        else:
+            # W = U V, Y = W X
+            w = self.w.value
+            gemm_async(1.0, notrans, u, notrans, v, 0.0, w, 1, 0, \
+                    redux=self.redux)
+            gemm_async(1.0, notrans, w, notrans, self.x.value, 0.0, \
+                    self.y.value, self.ndim, 0, redux=self.redux)
+            w.wont_use()
+        u.wont_use()
+        v.wont_use()
+        self.x.value.wont_use()
+        self.y.value.wont_use()
+
+    # Backward propagation of the low-rank linear layer
+    def backward_async(self):
+        u = self.u
+        v = self.v
+        x = self.x
+        y_grad = self.y.grad
+        w_priority = background_priority()
+        batch_ndim = x.value.ndim - self.ndim
+        out_ndim = u.value.ndim - 1
+        if self.order == "factored":
+            h = self.h
+            # dU += dY H^T, dH = U^T dY
+            if u.grad_required:
+                gemm_async(1.0, notrans, y_grad, trans, h.value, 1.0, \
+                        u.grad, batch_ndim, 0, redux=self.redux, \
+                        priority=w_priority)
+            gemm_async(1.0, trans, u.value, notrans, y_grad, 0.0, h.grad, \
+                    out_ndim, 0, redux=self.redux)
+            # dV += dH X^T, dX += V^T dH
+            if v.grad_required:
+                gemm_async(1.0, notrans, h.grad, trans, x.value, 1.0, \
+                        v.grad, batch_ndim, 0, redux=self.redux, \
+                        priority=w_priority)
+            if x.grad_required:
+                gemm_async(1.0, trans, v.value, notrans, h.grad, 1.0, \
+                        x.grad, 1, 0, redux=self.redux)
+            h.value.wont_use()
+            h.grad.wont_use()
+        else:
+            w = self.w
+            # dW = dY X^T, dU += dW V^T, dV += U^T dW
+            if u.grad_required or v.grad_required:
+                gemm_async(1.0, notrans, y_grad, trans, x.value, 0.0, \
+                        w.grad, batch_ndim, 0, redux=self.redux, \
+                        priority=w_priority)
+                if u.grad_required:
+                    gemm_async(1.0, notrans, w.grad, trans, v.value, 1.0, \
+                            u.grad, self.ndim, 0, redux=self.redux, \
+                            priority=w_priority)
+                if v.grad_required:
+                    gemm_async(1.0, trans, u.value, notrans, w.grad, 1.0, \
+                            v.grad, out_ndim, 0, redux=self.redux, \
+                            priority=w_priority)
+            # dX += W^T dY
+            if x.grad_required:
+                gemm_async(1.0, trans, w.value, notrans, y_grad, 1.0, \
+                        x.grad, out_ndim, 0, redux=self.redux)
+            w.value.wont_use()
+            w.grad.wont_use()
+        for t in [u.value, u.grad, v.value, v.grad, x.value, y_grad]:
+            t.wont_use()
+
+class TTLinear(BaseLayer):
+    """Linear layer with weights in the tensor-train format
+
+    X is of shape in_shape+batch_shape and Y is of shape
+    out_shape+batch_shape, where len(in_shape)=len(out_shape)=d>1. The
+    weight W[out_1,...,out_d,in_1,...,in_d] is a product of cores G_1 of
+    shape [in_1,out_1,r_1], G_k of shape [r_{k-1},in_k,out_k,r_k] and G_d of
+    shape [r_{d-1},in_d,out_d]. The weight is never formed. Instead, cores
+    are contracted with X one by one by gemms over a product of a rank and
+    an input mode, and the result is rotated by a transposition, so that the
+    next contracted modes lead. The intermediate C_k is of shape
+    [in_{k+1},...,in_d]+batch_shape+[out_1,...,out_k,r_k] and Z_k is C_k,
+    where r_k goes first. Forward and backward cost
+    sum_k r_{k-1} r_k in_k...in_d out_1...out_k nbatch multiply-adds each,
+    which is much smaller than for the dense weight for small ranks.
+    """
+    x: TensorMoments
+    y: TensorMoments
+    cores: List[TensorMoments]
+    c: List[TensorMoments]
+    z: List[TensorMoments]
+
+    # Construct tensor-train linear layer with all the provided data
+    def __init__(self, x: TensorMoments, y: TensorMoments, \
+            cores: List[TensorMoments], c: List[TensorMoments], \
+            z: List[TensorMoments], redux: bool=False):
+        d = len(cores)
+        if d <= 1:
+            raise ValueError("Tensor-train shall have at least 2 cores")
+        if len(c) != d or len(z) != d-1:
+            raise ValueError("Wrong number of intermediate tensors")
+        super().__init__([x], [y], list(cores), list(c)+list(z))
+        self.x = x
+        if self.x.grad is not None:
+            self.x.grad.set_reduction_add()
+        self.y = y
+        self.y.value.set_reduction_add()
+        self.cores = list(cores)
+        for g in self.cores:
+            g.grad.set_reduction_add()
+        self.c = list(c)
+        self.z = list(z)
+        for t in self.c + self.z:
+            t.value.set_reduction_add()
+            t.grad.set_reduction_add()
+        if redux:
+            self.redux = 1
+        else:
+            self.redux = 0
+
+    # Simple generator for the tensor-train linear layer
+    @staticmethod
+    def generate_simple(x: TensorMoments, out_features_shape: List[int], \
+            out_features_basetile_shape: List[int], ranks: List[int], \
+            next_tag: int, redux: bool=False):
+        d = len(out_features_shape)
+        if d <= 1:
+            raise ValueError("Tensor-train shall have at least 2 cores")
+        if len(ranks) != d-1:
+            raise ValueError("len(ranks) shall be len(out_features_shape)-1")
+        if x.value.ndim <= d:
+            raise ValueError("X shall have batch modes")
+        in_shape = x.value.shape[:d]
+        in_tile = x.value.basetile_shape[:d]
+        batch_shape = x.value.shape[d:]
+        batch_tile = x.value.basetile_shape[d:]
+        cores = []
+        c = []
+        z = []
+        # Shape and basetile of Z_{k-1} beyond contracted modes
+        rest = in_shape[1:] + batch_shape
+        rest_tile = in_tile[1:] + batch_tile
+        for k in range(d):
+            out = [out_features_shape[k]]
+            out_tile = [out_features_basetile_shape[k]]
+            left = [ranks[k-1]] if k > 0 else []
+            right = [ranks[k]] if k < d-1 else []
+            g, next_tag = _moments(x.value, left+[in_shape[k]]+out+right, \
+                    left+[in_tile[k]]+out_tile+right, next_tag)
+            cores.append(g)
+            c_k, next_tag = _moments(x.value, rest+out+right, \
+                    rest_tile+out_tile+right, next_tag)
+            c.append(c_k)
+            if k < d-1:
+                z_k, next_tag = _moments(x.value, right+rest+out, \
+                        right+rest_tile+out_tile, next_tag)
+                z.append(z_k)
+                rest = rest[1:] + out
+                rest_tile = rest_tile[1:] + out_tile
+        y, next_tag = _moments(x.value, out_features_shape+batch_shape, \
+                out_features_basetile_shape+batch_tile, next_tag)
+        layer = TTLinear(x, y, cores, c, z, redux)
+        return (layer, next_tag)
+
+    # Forward propagation of the tensor-train linear layer
+    def forward_async(self):
+        d = len(self.cores)
+        z_prev = self.x.value
+        for k in range(d):
+            # C_k = einsum('ij,ik->jk', Z_{k-1}, G_k), where 'i' is the
+            # multi-index of a rank and an input mode
+            ndim = 1 if k == 0 else 2
+            c_k = self.c[k].value
+            gemm_async(1.0, trans, z_prev, notrans, self.cores[k].value, \
+                    0.0, c_k, ndim, 0, redux=self.redux)
+            self.cores[k].value.wont_use()
+            z_prev.wont_use()
+            if k < d-1:
+                # The new rank goes first
+                z_prev = self.z[k].value
+                transpose_async(1.0, c_k, z_prev, c_k.ndim-1)
+            c_k.wont_use()
+        # Output modes go before the batch ones
+        c_d = self.c[d-1].value
+        transpose_async(1.0, c_d, self.y.value, c_d.ndim-d)
+        self.y.value.wont_use()
+
+    # Backward propagation of the tensor-train linear layer
+    def backward_async(self):
+        d = len(self.cores)
+        w_priority = background_priority()
+        transpose_async(1.0, self.y.grad, self.c[d-1].grad, d)
+        self.y.grad.wont_use()
+        for k in reversed(range(d)):
+            g = self.cores[k]
+            c_grad = self.c[k].grad
+            if k > 0:
+                z_prev = self.z[k-1]
+            else:
+                z_prev = self.x
+            # Number of modes of G_k, that are not contracted with Z_{k-1}
+            ndim_out = g.value.ndim - (1 if k == 0 else 2)
+            # dG_k += einsum('ij,jk->ik', Z_{k-1}, dC_k)
+            if g.grad_required:
+                gemm_async(1.0, notrans, z_prev.value, notrans, c_grad, \
+                        1.0, g.grad, c_grad.ndim-ndim_out, 0, \
+                        redux=self.redux, priority=w_priority)
+                g.grad.wont_use()
+            # dZ_{k-1} = einsum('ik,jk->ij', G_k, dC_k)
+            if k > 0:
+                gemm_async(1.0, notrans, g.value, trans, c_grad, 0.0, \
+                        z_prev.grad, ndim_out, 0, redux=self.redux)
+                transpose_async(1.0, z_prev.grad, self.c[k-1].grad, 1)
+                z_prev.grad.wont_use()
+            elif self.x.grad_required:
+                gemm_async(1.0, notrans, g.value, trans, c_grad, 1.0, \
+                        self.x.grad, ndim_out, 0, redux=self.redux)
+                self.x.grad.wont_use()
+            g.value.wont_use()
+            z_prev.value.wont_use()
+            c_grad.wont_use()
@@ -18,11 +18,56 @@ from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
         add_slice_async, prod_async, mask_scalar_async, add_fiber_async, \
         sum_fiber_async, transpose_async, copy_async, flash_maxsumexp_async, \
         flash_softmax_gemm_async, flash_softmax_gemm_backward_async, \
-        gemm_ex_async
+        gemm_ex_async, flash_attention_async, flash_attention_backward_async, \
+        background_priority, MaskTile
 
-from nntile.layer.base_layer import BaseLayer
+from nntile.layer.base_layer import BaseLayer, cpp_class, cpp_moments
+from nntile.layer.dropout import SEED_STEP
 import numpy as np
-from typing import List
+from typing import List, Optional, Tuple
+
+# Causal mask of shape (n_seq, n_seq) of keys and queries of a sliding
+# window: a query sees every dilation-th of window previous keys (including
+# itself) and n_global first tokens
+def sliding_window_mask(n_seq: int, window: int, dilation: int=1, \
+        n_global: int=0) -> np.ndarray:
+    k = np.arange(n_seq)[:, np.newaxis]
+    q = np.arange(n_seq)[np.newaxis, :]
+    dist = q - k
+    mask = (dist >= 0) & (dist < window*dilation) & (dist % dilation == 0)
+    mask |= (dist >= 0) & (k < n_global)
+    return np.array(mask, dtype=bool, order="F")
+
+# Block-sparse layout of a mask of shape (n_seq, n_seq), that is split into
+# tiles of shape (seq_tile, seq_tile). Layout is the same for all the layers
+# as long as the sequence length and tiles are the same. Causal tiles on the
+# diagonal are not read by the fused flash attention.
+def block_layout(mask: np.ndarray, seq_tile: int) -> List[MaskTile]:
+    n_tiles = [(n-1)//seq_tile + 1 for n in mask.shape]
+    layout = []
+    # Tiles of a tensor are ordered with the leading index of keys
+    for j in range(n_tiles[1]):
+        for i in range(n_tiles[0]):
+            tile = mask[i*seq_tile:(i+1)*seq_tile, j*seq_tile:(j+1)*seq_tile]
+            if not tile.any():
+                layout.append(MaskTile.empty)
+            elif tile.all():
+                layout.append(MaskTile.full)
+            elif i == j and tile.shape[0] == tile.shape[1] and \
+                    (tile == np.triu(np.ones(tile.shape, dtype=bool))).all():
+                layout.append(MaskTile.causal)
+            else:
+                layout.append(MaskTile.partial)
+    return layout
+
+# Block-sparse layout out of a list of active pairs (q_tile, k_tile), tiles of
+# the mask are applied for the active pairs and the rest are skipped
+def pairs_layout(pairs: List[Tuple[int, int]], n_tiles: int) \
+        -> List[MaskTile]:
+    layout = [MaskTile.empty] * (n_tiles*n_tiles)
+    for q_tile, k_tile in pairs:
+        layout[k_tile+q_tile*n_tiles] = MaskTile.partial
+    return layout
 
 # Multi-head attention
 # Inputs:
@@ -52,6 +97,7 @@ class FlashAttention(BaseLayer):
     b: TensorMoments
     b_transposed: TensorMoments
     n_head: int
+    n_head_kv: int
     head_size: int
 
     # Construct attention layer with all the provided data
@@ -66,7 +112,9 @@ class FlashAttention(BaseLayer):
             b: TensorMoments, b_transposed: TensorMoments, \
             in_proj_bias_q: TensorMoments, in_proj_bias_k: TensorMoments, \
             in_proj_bias_v: TensorMoments, out_proj_bias: TensorMoments, \
-            mask=None, redux: bool=False, fp32_fast_tf32: bool=False):
+            mask=None, redux: bool=False, fp32_fast_tf32: bool=False, \
+            fused: bool=False, dropout_p: float=0.0, seed: int=0, \
+            mask_layout: Optional[List[MaskTile]]=None, ring: bool=False):
         assert w_q.value.shape[0] % w_q.value.basetile_shape[0] == 0
         qkv_bias_list = []
         if in_proj_bias_q:
@@ -132,6 +180,11 @@ class FlashAttention(BaseLayer):
         self.in_proj_bias_v = in_proj_bias_v
         self.out_proj_bias = out_proj_bias
         self.n_head = w_q.value.shape[0]
+        # Keys and values may have fewer heads (grouped-query attention)
+        self.n_head_kv = w_k.value.shape[0]
+        if self.n_head % self.n_head_kv != 0:
+            raise ValueError("Number of heads of queries shall be divisible " \
+                    "by number of heads of keys and values")
         n_emb = x_q.value.shape[0]
         head_size = n_emb // self.n_head
         # Stupid check, that is not necessary, as the code shall work
@@ -139,6 +192,9 @@ class FlashAttention(BaseLayer):
             raise RuntimeError
         self.head_size = head_size
         self.mask = mask
+        # Block-sparse layout of the mask, that is read from the mask on
+        # every call if it is not provided (see block_layout)
+        self.mask_layout = mask_layout
         if mask:
             self.val = -np.float32(np.inf)
         if redux:
@@ -146,13 +202,35 @@ class FlashAttention(BaseLayer):
         else:
             self.redux = 0
         self.fp32_fast_tf32 = fp32_fast_tf32
+        # Fused single-pass kernels never touch tensor a
+        self.fused = fused
+        # Dropout of attention weights regenerates its mask in backward from
+        # the seed, that changes after every backward (see Dropout layer)
+        if dropout_p < 0 or dropout_p >= 1:
+            raise ValueError("Dropout probability shall be in range [0, 1)")
+        if fused and dropout_p > 0:
+            raise NotImplementedError("Dropout is not supported by fused " \
+                    "kernels")
+        self.dropout_p = dropout_p
+        # Sequence-parallel forward passes tiles of K and V over a ring of
+        # nodes, that own tiles of Q, instead of bringing them all to every
+        # tile of Q. It is only implemented by the fused forward.
+        if ring and not fused:
+            raise NotImplementedError("Ring attention requires fused " \
+                    "kernels")
+        self.ring = ring
+        self.seed = seed
+        self.step = 0
+        self.training = True
 
     # Simple generator for the linear layer
     @staticmethod
     def generate_simple(x_q: TensorMoments, x_k: TensorMoments, \
             x_v: TensorMoments, n_head: int, n_head_tile: int, next_tag: int, \
             bias=False, mask=None, redux: bool=False, \
-            fp32_fast_tf32: bool=False):
+            fp32_fast_tf32: bool=False, fused: bool=False, \
+            dropout_p: float=0.0, seed: int=0, n_head_kv: int=None, \
+            mask_layout: Optional[List[MaskTile]]=None, ring: bool=False):
         # Get sizes
         n_emb, n_seq, n_batch = x_q.value.shape
         n_emb_tile, n_seq_tile, n_batch_tile = x_q.value.basetile_shape
@@ -160,6 +238,18 @@ class FlashAttention(BaseLayer):
         # Stupid check, that is not necessary, as the code shall work
         if n_emb != head_size * n_head:
             raise RuntimeError
+        # Grouped-query attention: every head of keys and values serves
+        # kv_group consecutive heads of queries. Each tile of queries holds
+        # all the heads of queries of a tile of keys and values.
+        if n_head_kv is None:
+            n_head_kv = n_head
+        if n_head % n_head_kv != 0:
+            raise ValueError("n_head shall be divisible by n_head_kv")
+        kv_group = n_head // n_head_kv
+        if n_head_tile % kv_group != 0:
+            raise ValueError("n_head_tile shall be divisible by " \
+                    "n_head/n_head_kv")
+        n_head_kv_tile = n_head_tile // kv_group
         n_emb_k = x_k.value.shape[0]
         n_emb_k_tile = x_k.value.basetile_shape[0]
         if [n_seq, n_batch] != x_k.value.shape[1:]:
@@ -177,15 +267,15 @@ class FlashAttention(BaseLayer):
         head_size_tile = head_size
         # Define shape of each tensor
         w_q_shape = [n_head, head_size, n_emb]
-        w_k_shape = [n_head, head_size, n_emb_k]
-        w_v_shape = [n_head, head_size, n_emb_v]
+        w_k_shape = [n_head_kv, head_size, n_emb_k]
+        w_v_shape = [n_head_kv, head_size, n_emb_v]
         w_shape = [n_emb, n_head, head_size]
         q_transposed_shape = [n_head, head_size, n_seq, n_batch]
         q_shape = [head_size, n_seq, n_batch, n_head]
-        k_transposed_shape = [n_head, head_size, n_seq, n_batch]
-        k_shape = [head_size, n_seq, n_batch, n_head]
-        v_transposed_shape = [n_head, head_size, n_seq, n_batch]
-        v_shape = [head_size, n_seq, n_batch, n_head]
+        k_transposed_shape = [n_head_kv, head_size, n_seq, n_batch]
+        k_shape = [head_size, n_seq, n_batch, n_head_kv]
+        v_transposed_shape = [n_head_kv, head_size, n_seq, n_batch]
+        v_shape = [head_size, n_seq, n_batch, n_head_kv]
         a_shape = [n_seq, n_seq, n_batch, n_head]
         a_maxsumexp_shape = [2, n_seq, n_batch, n_head]
         a_sumprod_slice_shape = [n_seq, n_batch, n_head]
@@ -193,15 +283,19 @@ class FlashAttention(BaseLayer):
         b_transposed_shape = [n_head, head_size, n_seq, n_batch]
         # Define tile shapes of each tensor
         w_q_basetile = [n_head_tile, head_size_tile, n_emb_tile]
-        w_k_basetile = [n_head_tile, head_size_tile, n_emb_k_tile]
-        w_v_basetile = [n_head_tile, head_size_tile, n_emb_v_tile]
+        w_k_basetile = [n_head_kv_tile, head_size_tile, n_emb_k_tile]
+        w_v_basetile = [n_head_kv_tile, head_size_tile, n_emb_v_tile]
         w_basetile = [n_emb_tile, n_head_tile, head_size_tile]
         q_transposed_basetile = [n_head_tile, head_size_tile, n_seq_tile, n_batch_tile]
         q_basetile = [head_size_tile, n_seq_tile, n_batch_tile, n_head_tile]
-        k_transposed_basetile = [n_head_tile, head_size_tile, n_seq_tile, n_batch_tile]
-        k_basetile = [head_size_tile, n_seq_tile, n_batch_tile, n_head_tile]
-        v_transposed_basetile = [n_head_tile, head_size_tile, n_seq_tile, n_batch_tile]
-        v_basetile = [head_size_tile, n_seq_tile, n_batch_tile, n_head_tile]
+        k_transposed_basetile = [n_head_kv_tile, head_size_tile, n_seq_tile, \
+                n_batch_tile]
+        k_basetile = [head_size_tile, n_seq_tile, n_batch_tile, \
+                n_head_kv_tile]
+        v_transposed_basetile = [n_head_kv_tile, head_size_tile, n_seq_tile, \
+                n_batch_tile]
+        v_basetile = [head_size_tile, n_seq_tile, n_batch_tile, \
+                n_head_kv_tile]
         a_basetile = [n_seq_tile, n_seq_tile, n_batch_tile, n_head_tile]
         a_maxsumexp_basetile = [2, n_seq_tile, n_batch_tile, n_head_tile]
         a_sumprod_slice_basetile = [n_seq_tile, n_batch_tile, n_head_tile]
@@ -245,6 +339,9 @@ class FlashAttention(BaseLayer):
             in_proj_bias_qkv_traits = TensorTraits([head_size, n_head], \
                     [head_size_tile, n_head_tile])
             in_proj_bias_qkv_distr = [0] * in_proj_bias_qkv_traits.grid.nelems
+            in_proj_bias_kv_traits = TensorTraits([head_size, n_head_kv], \
+                    [head_size_tile, n_head_kv_tile])
+            in_proj_bias_kv_distr = [0] * in_proj_bias_kv_traits.grid.nelems
         # Define all the lists
         # w_q
         w_q_value = type(x_q.value)(w_q_traits, w_q_distr, next_tag)
@@ -273,11 +370,11 @@ class FlashAttention(BaseLayer):
         w_k = TensorMoments(w_k_value, w_k_grad, True)
         if bias:
             in_proj_bias_k_value = type(x_q.value)( \
-                    in_proj_bias_qkv_traits, in_proj_bias_qkv_distr, \
+                    in_proj_bias_kv_traits, in_proj_bias_kv_distr, \
                     next_tag)
             next_tag = in_proj_bias_k_value.next_tag
             in_proj_bias_k_grad = type(x_q.value)( \
-                    in_proj_bias_qkv_traits, in_proj_bias_qkv_distr, \
+                    in_proj_bias_kv_traits, in_proj_bias_kv_distr, \
                     next_tag)
             next_tag = in_proj_bias_k_grad.next_tag
             bias_inproj_k = TensorMoments(in_proj_bias_k_value, \
@@ -292,11 +389,11 @@ class FlashAttention(BaseLayer):
         w_v = TensorMoments(w_v_value, w_v_grad, True)
         if bias:
             in_proj_bias_v_value = type(x_q.value)( \
-                    in_proj_bias_qkv_traits, in_proj_bias_qkv_distr, \
+                    in_proj_bias_kv_traits, in_proj_bias_kv_distr, \
                     next_tag)
             next_tag = in_proj_bias_v_value.next_tag
             in_proj_bias_v_grad = type(x_q.value)( \
-                    in_proj_bias_qkv_traits, in_proj_bias_qkv_distr, \
+                    in_proj_bias_kv_traits, in_proj_bias_kv_distr, \
                     next_tag)
             next_tag = in_proj_bias_v_grad.next_tag
             bias_inproj_v = TensorMoments(in_proj_bias_v_value, \
@@ -398,10 +495,23 @@ class FlashAttention(BaseLayer):
                 q, k_transposed, k, v_transposed, v, a, a_maxsumexp, \
                 a_sumprod_slice, b, b_transposed, bias_inproj_q, \
                 bias_inproj_k, bias_inproj_v, out_proj_bias, mask, \
-                redux=redux, fp32_fast_tf32=fp32_fast_tf32)
+                redux=redux, fp32_fast_tf32=fp32_fast_tf32, fused=fused, \
+                dropout_p=dropout_p, seed=seed, mask_layout=mask_layout, \
+                ring=ring)
         # Return layer and next tag to be used
         return (layer, next_tag)
 
+    # Whether attention weights are dropped out
+    @property
+    def stochastic(self) -> bool:
+        return self.training and self.dropout_p > 0
+
+    # Dropout probability and seed of the current step
+    def _dropout_args(self):
+        if not self.stochastic:
+            return 0.0, 0
+        return self.dropout_p, (self.seed + self.step*SEED_STEP) % 2**64
+
     # Forward propagation of the attention layer
     def forward_async(self):
         # Compute query, key and value tensors
@@ -487,39 +597,51 @@ class FlashAttention(BaseLayer):
         # (n_seq, n_seq, batch=n_batch, batch=n_head)
         #gemm_async(1.0/self.head_size**0.5, trans, self.k.value, \
         #        notrans, self.q.value, 0.0, self.a.value, 1, 2, redux=self.redux)
-        clear_async(self.a_maxsumexp)
-        # Use flash-like maxsumexp
-        flash_maxsumexp_async(self.q.value, self.k.value, self.mask, \
-                self.a_maxsumexp, self.a.value, redux=self.redux, \
-                fp32_fast_tf32=self.fp32_fast_tf32)
-        # Q and K can be offloaded from GPU
-        self.q.value.wont_use()
-        self.k.value.wont_use()
-        # Calculate softmax inplace
-        # A = softmax(A, axis=0)
-        # Apply mask if needed
-        #if self.mask:
-        #    mask_scalar_async(self.mask, self.val, self.a.value, 2)
-        #    self.mask.wont_use()
-        # Calculate max and sumexp along axis
-        # Temporary disable maxsumexp for testing
-        #maxsumexp_async(self.a.value, self.a_maxsumexp, 0, redux=self.redux)
-        # Use flash-like softmax+gemm
-        flash_softmax_gemm_async(self.q.value, self.k.value, self.v.value, \
-                self.mask, self.a_maxsumexp, self.b.value, self.a.value, \
-                redux=self.redux, fp32_fast_tf32=self.fp32_fast_tf32)
-        # Finally, get the inplace softmax
-        #softmax_inplace_async(self.a_maxsumexp, self.a.value, 0)
-        # A_maxsumexp can be deleted
-        #self.a_maxsumexp.wont_use()
-        self.a_maxsumexp.invalidate_submit()
-        # Apply value tensor
-        # B = einsum('jklb,kmlb->jmlb', V, A)
-        # batched gemm (head_size, n_seq, batch=n_batch, batch=n_head)
-        # by (n_seq, n_seq, batch=n_batch, batch=n_head) into
-        # (head_size, n_seq, batch=n_batch, batch=n_head)
-        #gemm_async(1.0, notrans, self.v.value, notrans, \
-        #        self.a.value, 0.0, self.b.value, 1, 2, redux=self.redux)
+        if self.fused:
+            # Single pass over K and V with online softmax, that also
+            # produces A_maxsumexp for the backward
+            flash_attention_async(self.q.value, self.k.value, self.v.value, \
+                    self.mask, self.a_maxsumexp, self.b.value, \
+                    layout=self.mask_layout, ring=self.ring)
+            self.q.value.wont_use()
+            self.k.value.wont_use()
+            self.a_maxsumexp.wont_use()
+        else:
+            clear_async(self.a_maxsumexp)
+            # Use flash-like maxsumexp
+            flash_maxsumexp_async(self.q.value, self.k.value, self.mask, \
+                    self.a_maxsumexp, self.a.value, redux=self.redux, \
+                    fp32_fast_tf32=self.fp32_fast_tf32, \
+                    layout=self.mask_layout)
+            # Q and K can be offloaded from GPU
+            self.q.value.wont_use()
+            self.k.value.wont_use()
+            # Calculate softmax inplace
+            # A = softmax(A, axis=0)
+            # Apply mask if needed
+            #if self.mask:
+            #    mask_scalar_async(self.mask, self.val, self.a.value, 2)
+            #    self.mask.wont_use()
+            # Calculate max and sumexp along axis
+            # Temporary disable maxsumexp for testing
+            #maxsumexp_async(self.a.value, self.a_maxsumexp, 0, redux=self.redux)
+            # Use flash-like softmax+gemm, that also applies dropout
+            dropout_p, seed = self._dropout_args()
+            flash_softmax_gemm_async(self.q.value, self.k.value, self.v.value, \
+                    self.mask, self.a_maxsumexp, self.b.value, self.a.value, \
+                    redux=self.redux, fp32_fast_tf32=self.fp32_fast_tf32, \
+                    dropout_p=dropout_p, seed=seed, layout=self.mask_layout)
+            # Finally, get the inplace softmax
+            #softmax_inplace_async(self.a_maxsumexp, self.a.value, 0)
+            # A_maxsumexp is reused by backward, so it can only be offloaded
+            self.a_maxsumexp.wont_use()
+            # Apply value tensor
+            # B = einsum('jklb,kmlb->jmlb', V, A)
+            # batched gemm (head_size, n_seq, batch=n_batch, batch=n_head)
+            # by (n_seq, n_seq, batch=n_batch, batch=n_head) into
+            # (head_size, n_seq, batch=n_batch, batch=n_head)
+            #gemm_async(1.0, notrans, self.v.value, notrans, \
+            #        self.a.value, 0.0, self.b.value, 1, 2, redux=self.redux)
         # V and A can be offloaded from GPU
         self.v.value.wont_use()
         self.a.value.wont_use()
@@ -540,8 +662,11 @@ class FlashAttention(BaseLayer):
                     redux=self.redux)
         # W, B and B_transposed can be offloaded from GPU
         self.w.value.wont_use()
-        #self.b.value.wont_use()
-        self.b.value.invalidate_submit()
+        if self.fused:
+            # B is needed by the fused backward
+            self.b.value.wont_use()
+        else:
+            self.b.value.invalidate_submit()
         self.b_transposed.value.wont_use()
         # Apply bias if needed
         if self.out_proj_bias is not None:
@@ -552,6 +677,13 @@ class FlashAttention(BaseLayer):
 
     # Backward propagation of the linear layer
     def backward_async(self):
+        # Backward kernels require the same heads of queries, keys and values
+        if self.n_head_kv != self.n_head:
+            raise NotImplementedError("Backward of grouped-query attention " \
+                    "is not supported")
+        # Gradients over weights are off the critical path of backward, so
+        # they give way to gradients over inputs
+        w_priority = background_priority()
         # Apply backward of bias if needed
         if self.out_proj_bias is not None:
             if self.out_proj_bias.grad_required:
@@ -564,11 +696,11 @@ class FlashAttention(BaseLayer):
             if self.fp32_fast_tf32:
                 gemm_ex_async(1.0, notrans, self.y.grad, trans, \
                         self.b_transposed.value, 1.0, self.w.grad, 2, 0, \
-                        redux=self.redux)
+                        redux=self.redux, priority=w_priority)
             else:
                 gemm_async(1.0, notrans, self.y.grad, trans, \
                         self.b_transposed.value, 1.0, self.w.grad, 2, 0, \
-                        redux=self.redux)
+                        redux=self.redux, priority=w_priority)
         # B_transposed can be deleted
         #self.b_transposed.value.wont_use()
         self.b_transposed.value.invalidate_submit()
@@ -592,13 +724,28 @@ class FlashAttention(BaseLayer):
             transpose_async(1.0, self.b_transposed.grad, self.b.grad, 1)
         #self.b_transposed.grad.wont_use()
         self.b_transposed.grad.invalidate_submit()
-        # Flash-like backward of softmax+gemm
-        clear_async(self.a_sumprod_slice)
-        flash_softmax_gemm_backward_async(self.q.value, self.q.grad, \
-                self.k.value, self.k.grad, self.v.value, self.v.grad, \
-                self.mask, self.a_maxsumexp, self.b.grad, self.a.value, \
-                self.a.grad, self.a_sumprod_slice, redux=self.redux, \
-                fp32_fast_tf32=self.fp32_fast_tf32)
+        if self.fused:
+            # Single-pass fused backward recomputes attention weights
+            flash_attention_backward_async(self.q.value, self.q.grad, \
+                    self.k.value, self.k.grad, self.v.value, self.v.grad, \
+                    self.mask, self.a_maxsumexp, self.b.value, self.b.grad, \
+                    self.a_sumprod_slice, redux=self.redux, \
+                    layout=self.mask_layout)
+            self.b.value.invalidate_submit()
+        else:
+            # Flash-like backward of softmax+gemm, that regenerates the
+            # dropout mask of the forward
+            clear_async(self.a_sumprod_slice)
+            dropout_p, seed = self._dropout_args()
+            flash_softmax_gemm_backward_async(self.q.value, self.q.grad, \
+                    self.k.value, self.k.grad, self.v.value, self.v.grad, \
+                    self.mask, self.a_maxsumexp, self.b.grad, self.a.value, \
+                    self.a.grad, self.a_sumprod_slice, redux=self.redux, \
+                    fp32_fast_tf32=self.fp32_fast_tf32, dropout_p=dropout_p, \
+                    seed=seed, layout=self.mask_layout)
+            # Next forward uses a new mask
+            if self.stochastic:
+                self.step += 1
         # Backward for B = einsum('jklb,kmlb->jmlb', V, A)
         #if self.a.grad_required:
         #    # dA = einsum('jklb,jmlb->kmlb', V, dB)
@@ -686,11 +833,11 @@ class FlashAttention(BaseLayer):
             if self.fp32_fast_tf32:
                 gemm_ex_async(1.0, notrans, self.v_transposed.grad, trans, \
                         self.x_v.value, 1.0, self.w_v.grad, 2, 0, \
-                        redux=self.redux)
+                        redux=self.redux, priority=w_priority)
             else:
                 gemm_async(1.0, notrans, self.v_transposed.grad, trans, \
                         self.x_v.value, 1.0, self.w_v.grad, 2, 0, \
-                        redux=self.redux)
+                        redux=self.redux, priority=w_priority)
         # dW_V can be offloaded from GPU
         self.w_v.grad.wont_use()
         # X_V can be offloaded from GPU
@@ -732,11 +879,11 @@ class FlashAttention(BaseLayer):
             if self.fp32_fast_tf32:
                 gemm_ex_async(1.0, notrans, self.k_transposed.grad, trans, \
                         self.x_k.value, 1.0, self.w_k.grad, 2, 0, \
-                        redux=self.redux)
+                        redux=self.redux, priority=w_priority)
             else:
                 gemm_async(1.0, notrans, self.k_transposed.grad, trans, \
                         self.x_k.value, 1.0, self.w_k.grad, 2, 0, \
-                        redux=self.redux)
+                        redux=self.redux, priority=w_priority)
         # dW_K can be offloaded from GPU
         self.w_k.grad.wont_use()
         # X_K can be offloaded from GPU
@@ -779,11 +926,11 @@ class FlashAttention(BaseLayer):
             if self.fp32_fast_tf32:
                 gemm_ex_async(1.0, notrans, self.q_transposed.grad, trans, \
                         self.x_q.value, 1.0, self.w_q.grad, 2, 0, \
-                        redux=self.redux)
+                        redux=self.redux, priority=w_priority)
             else:
                 gemm_async(1.0, notrans, self.q_transposed.grad, trans, \
                         self.x_q.value, 1.0, self.w_q.grad, 2, 0, \
-                        redux=self.redux)
+                        redux=self.redux, priority=w_priority)
         # dW_Q can be offloaded from GPU
         self.w_q.grad.wont_use()
         # X_Q can be offloaded from GPU
@@ -792,3 +939,25 @@ class FlashAttention(BaseLayer):
         #self.q_transposed.grad.wont_use()
         self.q_transposed.grad.invalidate_submit()
 
+    # C++ counterpart of the layer without dropout, TF32 and ring
+    def to_cpp(self):
+        cls = cpp_class("FlashAttention", self.x_q.value)
+        if cls is None or self.fp32_fast_tf32 or self.dropout_p > 0 \
+                or not self.mask or self.ring:
+            return None
+        moments = [cpp_moments(t) for t in (self.x_q, self.x_k, self.x_v, \
+                self.y, self.w_q, self.w_k, self.w_v, self.w, \
+                self.q_transposed, self.q, self.k_transposed, self.k, \
+                self.v_transposed, self.v, self.a)]
+        tail = [cpp_moments(t) for t in (self.b, self.b_transposed)]
+        biases = [cpp_moments(t) if t is not None else None for t in \
+                (self.in_proj_bias_q, self.in_proj_bias_k, \
+                self.in_proj_bias_v, self.out_proj_bias)]
+        if None in moments or None in tail:
+            return None
+        for t, bias in zip((self.in_proj_bias_q, self.in_proj_bias_k, \
+                self.in_proj_bias_v, self.out_proj_bias), biases):
+            if t is not None and bias is None:
+                return None
+        return cls(*moments, self.a_maxsumexp, self.a_sumprod_slice, *tail, \
+                *biases, self.mask, self.fused, self.redux)
@@ -13,7 +13,7 @@
 
 from nntile.tensor import TensorTraits, Tensor_fp32, Tensor_fp16, \
         TensorMoments
-from nntile.nntile_core.tensor import fp32_to_fp16_async, fp16_to_fp32_async
+from nntile.nntile_core import tensor as core_tensor
 from nntile.layer.base_layer import BaseLayer
 import numpy as np
 from typing import List, Callable
@@ -48,9 +48,9 @@ class FP32_to_FP16(BaseLayer):
 
     # Forward propagation of the activation layer
     def forward_async(self):
-        fp32_to_fp16_async(self.x.value, self.y.value)
+        core_tensor.fp32_to_fp16_async(self.x.value, self.y.value)
 
     # Backward propagation of the activation layer
     def backward_async(self):
-        fp16_to_fp32_async(self.y.grad, self.x.grad)
+        core_tensor.fp16_to_fp32_async(self.y.grad, self.x.grad)
 
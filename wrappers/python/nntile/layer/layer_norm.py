@@ -9,7 +9,7 @@
 #
 # @version 1.0.0
 # @author Aleksandr Mikhalev
-# @date 2023-09-29
+# @date 2024-02-05
 
 from nntile.tensor import TensorTraits, Tensor_fp32, Tensor_fp64, Tensor, \
         TensorOrNone, TensorMoments, \
@@ -17,8 +17,9 @@ from nntile.tensor import TensorTraits, Tensor_fp32, Tensor_fp64, Tensor, \
         fill_async, pow_async, prod_slice_async, sumprod_slice_async, \
         axpy_async, prod_fiber_async, prod_fiber3_async, add_slice3_async, \
         add_fiber_async, sum_fiber_async, sumprod_fiber_async, \
-        clear_async, copy_async, hypot_scalar_inverse_async
-from nntile.layer.base_layer import BaseLayer
+        clear_async, copy_async, hypot_scalar_inverse_async, \
+        layer_norm_async, layer_norm_backward_async
+from nntile.layer.base_layer import BaseLayer, cpp_class, cpp_moments
 import numpy as np
 from typing import List
 
@@ -33,12 +34,13 @@ class LayerNorm(BaseLayer):
     inv_stddev: Tensor
     axis: int
     eps: float
+    fused: bool
 
     # Construct normalization layer with all the provided data
     def __init__(self, x: TensorMoments, y: TensorMoments, \
             gamma: TensorMoments, beta: TensorMoments, tmp_y_value: Tensor, \
             tmp_y_grad: Tensor, mean: Tensor, inv_stddev: Tensor, axis: int, \
-            eps: float, redux: bool=False):
+            eps: float, redux: bool=False, fused: bool=True):
         # Redirect to BaseLayer initialization
         super().__init__([x], [y], [gamma, beta], [tmp_y_value, tmp_y_grad, \
                 mean, inv_stddev])
@@ -61,11 +63,20 @@ class LayerNorm(BaseLayer):
             self.redux = 1
         else:
             self.redux = 0
+        # Fused kernels compute statistics of a fiber by a single task, so
+        # the axis shall not be split into tiles. Backward of the fused
+        # kernel accumulates gradients of gamma and beta on the node of
+        # every tile of grad X.
+        self.fused = fused and self.x.value.grid.shape[axis] == 1
+        self.fused_backward = self.fused and self.x.grad is not None \
+                and all(r == self.gamma.grad.distribution[0] \
+                for r in self.x.grad.distribution) \
+                and self.beta.grad.distribution == self.gamma.grad.distribution
 
     # Simple generator for the normalization layer
     @staticmethod
     def generate_simple(x: TensorMoments, axis: int, eps: float,
-            next_tag: int, redux: bool=False):
+            next_tag: int, redux: bool=False, fused: bool=True):
         # Get traits of X
         x_traits = TensorTraits(x.value.shape, x.value.basetile_shape)
         # Create Y with the same traits and distribution as X
@@ -122,7 +133,7 @@ class LayerNorm(BaseLayer):
         next_tag = inv_stddev.next_tag
         # Create LayerNorm object with all the provided tensors
         layer = LayerNorm(x, y, gamma, beta, tmp_y_value, tmp_y_grad, mean, \
-                inv_stddev, axis, eps, redux=redux)
+                inv_stddev, axis, eps, redux=redux, fused=fused)
         # Init gamma and beta
         clear_async(beta.value)
         fill_async(1.0, gamma.value)
@@ -131,6 +142,20 @@ class LayerNorm(BaseLayer):
 
     # Forward propagation of the normalization layer
     def forward_async(self):
+        if self.fused:
+            # Normalize, scale and shift input by a single pass
+            layer_norm_async(self.eps**2, self.x.value, self.gamma.value, \
+                    self.beta.value, self.mean, self.inv_stddev, \
+                    self.y.value, self.axis)
+            # Statistics are needed only by the backward
+            self.mean.wont_use()
+            self.inv_stddev.wont_use()
+            # X, gamma, beta and Y can be offloaded from GPU
+            self.x.value.wont_use()
+            self.gamma.value.wont_use()
+            self.beta.value.wont_use()
+            self.y.value.wont_use()
+            return
         # Get means over given axis
         sum_slice_async(1.0/self.l, self.x.value, 0.0, self.mean, self.axis, \
                 redux=self.redux)
@@ -166,8 +191,42 @@ class LayerNorm(BaseLayer):
         # Y can be offloaded from GPU
         self.y.value.wont_use()
 
+    # C++ counterpart of the fused layer
+    def to_cpp(self):
+        cls = cpp_class("LayerNorm", self.x.value)
+        moments = [cpp_moments(t) for t in (self.x, self.y, self.gamma, \
+                self.beta)]
+        if cls is None or not self.fused_backward or None in moments:
+            return None
+        return cls(*moments, self.mean, self.inv_stddev, self.axis, \
+                self.eps**2, self.redux)
+
     # Backward propagation of the normalization layer
     def backward_async(self):
+        if self.fused_backward:
+            # Normalized input is recomputed from X, mean and inv_stddev
+            layer_norm_backward_async(self.x.value, self.y.grad, \
+                    self.gamma.value, self.mean, self.inv_stddev, \
+                    self.x.grad, self.gamma.grad, self.beta.grad, \
+                    self.axis, redux=self.redux)
+            # mean and inv_stddev can be deleted
+            self.mean.invalidate_submit()
+            self.inv_stddev.invalidate_submit()
+            # X, dY, gamma and all the gradients can be offloaded from GPU
+            self.x.value.wont_use()
+            self.y.grad.wont_use()
+            self.gamma.value.wont_use()
+            self.x.grad.wont_use()
+            self.gamma.grad.wont_use()
+            self.beta.grad.wont_use()
+            return
+        if self.fused:
+            # Chain of operations below expects normalized input
+            copy_async(self.x.value, self.tmp_y_value)
+            add_slice_async(-1.0, self.mean, 1.0, self.tmp_y_value, \
+                    self.axis)
+            prod_slice_async(self.inv_stddev, 1.0, self.tmp_y_value, \
+                    self.axis)
         # Accumulate gradient over beta
         sum_fiber_async(1.0, self.y.grad, 1.0, self.beta.grad, self.axis, 0,
                 redux=self.redux)
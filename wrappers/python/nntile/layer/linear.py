@@ -16,8 +16,11 @@ import nntile
 from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
         TransOp, trans, notrans, copy_async, gemm_async, randn_async, \
         add_slice_async, add_fiber_async, sum_slice_async, sum_fiber_async, \
-        gemm_ex_async
-from nntile.layer.base_layer import BaseLayer
+        gemm_ex_async, gemm_bias_gelutanh_async, bias_gelutanh_backward_async, \
+        gelutanh_async, gelutanh_backward_async, clear_async, \
+        gemm_summa_async, gemm_dequant_async, quantize_async, \
+        QuantizedTensor, background_priority
+from nntile.layer.base_layer import BaseLayer, cpp_class, cpp_moments
 import numpy as np
 from typing import List, Union, Optional
 
@@ -36,6 +39,16 @@ class Linear(BaseLayer):
     y_fp16: TensorMoments
     w_fp16: TensorMoments
     b: Union[TensorMoments, None]
+    activation: Union[str, None]
+    y_pre: Union[TensorMoments, None]
+    y_replicas: List[Tensor]
+    x_grad_replicas: List[Tensor]
+    w_q: Optional[QuantizedTensor]
+    w_scale: Optional[Tensor]
+    lora_a: Optional[TensorMoments]
+    lora_b: Optional[TensorMoments]
+    lora_h: Optional[TensorMoments]
+    lora_scale: float
 
     # Construct linear layer with all the provided data
     def __init__(self, side: str, trans_x: TransOp, x: TensorMoments, \
@@ -46,19 +59,30 @@ class Linear(BaseLayer):
             x_fp16: Optional[TensorMoments] = None, \
             w_fp16: Optional[TensorMoments] = None, \
             y_fp16: Optional[TensorMoments] = None, \
-            redux: bool = False):
+            redux: bool = False, activation: Optional[str] = None, \
+            y_pre: Optional[TensorMoments] = None):
         # Check parameter side
         if side != 'L' and side != 'R':
             raise ValueError("side must be either 'L' or 'R'")
         # Check parameter ndim
         if ndim <= 0:
             raise ValueError("ndim must be positive integer")
+        # Check activation, that needs its input for the backward pass
+        if activation is not None:
+            if activation != 'gelutanh':
+                raise ValueError("activation must be either None or " \
+                        "'gelutanh'")
+            if y_pre is None:
+                raise ValueError("activation requires y_pre")
+        else:
+            y_pre = None
         # Redirect to BaseClass initialization
         if b is None:
-            super().__init__([x], [y], [w], [x_fp16, w_fp16, y_fp16])
+            super().__init__([x], [y], [w], [x_fp16, w_fp16, y_fp16, y_pre])
             self.b = None
         else:
-            super().__init__([x], [y], [w, b], [x_fp16, w_fp16, y_fp16])
+            super().__init__([x], [y], [w, b], \
+                    [x_fp16, w_fp16, y_fp16, y_pre])
             self.b = b
             self.b.grad.set_reduction_add()
         # Set up local named parameters
@@ -70,6 +94,11 @@ class Linear(BaseLayer):
             self.x.grad.set_reduction_add()
         self.y = y
         self.y.value.set_reduction_add()
+        # Output of gemm with bias, that is the input of the activation
+        self.activation = activation
+        self.y_pre = y_pre
+        if self.y_pre is not None:
+            self.y_pre.value.set_reduction_add()
         self.w = w
         self.w.grad.set_reduction_add()
         self.x_fp16 = x_fp16
@@ -77,6 +106,17 @@ class Linear(BaseLayer):
         self.y_fp16 = y_fp16
         self.fp32_fast_tf32 = fp32_fast_tf32
         self.fp32_convert_fp16 = fp32_convert_fp16
+        # Replicas of outputs of gemms for tensor parallelism
+        self.y_replicas = []
+        self.x_grad_replicas = []
+        # Quantized weights for inference
+        self.w_q = None
+        self.w_scale = None
+        # Low-rank adapters
+        self.lora_a = None
+        self.lora_b = None
+        self.lora_h = None
+        self.lora_scale = 0.0
         if redux:
             self.redux = 1
         else:
@@ -88,7 +128,8 @@ class Linear(BaseLayer):
             in_features_ndim: int, out_features_shape: List[int], \
             out_features_basetile_shape: List[int], next_tag: int, \
             bias: bool=True, fp32_fast_tf32: bool=False, \
-            fp32_convert_fp16: bool=False, redux: bool=False):
+            fp32_convert_fp16: bool=False, redux: bool=False, \
+            activation: Optional[str]=None):
         # Define shapes
         ndim = in_features_ndim
         add_shape = out_features_shape
@@ -153,6 +194,15 @@ class Linear(BaseLayer):
         next_tag = y_grad.next_tag
         # Define Y as TensorMoments
         y = TensorMoments(y_value, y_grad, True)
+        # Input of the activation with the same traits and distribution as Y
+        if activation is not None:
+            y_pre_value = type(x.value)(y_traits, y_distr, next_tag)
+            next_tag = y_pre_value.next_tag
+            y_pre_grad = type(x.value)(y_traits, y_distr, next_tag)
+            next_tag = y_pre_grad.next_tag
+            y_pre = TensorMoments(y_pre_value, y_pre_grad, True)
+        else:
+            y_pre = None
         # Create linear layer with all the provided data
         if type(x.value) is not nntile.tensor.Tensor_fp32:
             fp32_fast_tf32 = False
@@ -169,24 +219,277 @@ class Linear(BaseLayer):
             x_fp16 = TensorMoments(x_fp16_value, x_fp16_grad, True)
             w_fp16_value = Tensor_fp16(w_traits, w_distr, next_tag)
             next_tag = w_fp16_value.next_tag
-            w_fp16_grad = Tensor_fp16(w_traits, w_distr, next_tag)
-            next_tag = w_fp16_grad.next_tag
-            w_fp16 = TensorMoments(w_fp16_value, w_fp16_grad, True)
+            # Gradient over W is accumulated in fp32 directly
+            w_fp16 = TensorMoments(w_fp16_value, None, False)
             y_fp16_value = Tensor_fp16(y_traits, y_distr, next_tag)
             next_tag = y_fp16_value.next_tag
             y_fp16_grad = Tensor_fp16(y_traits, y_distr, next_tag)
             next_tag = y_fp16_grad.next_tag
             y_fp16 = TensorMoments(y_fp16_value, y_fp16_grad, True)
             layer = Linear(side, trans_x, x, y, w, ndim, b, fp32_fast_tf32, \
-                    fp32_convert_fp16, x_fp16, w_fp16, y_fp16)
+                    fp32_convert_fp16, x_fp16, w_fp16, y_fp16, \
+                    activation=activation, y_pre=y_pre)
         else:
             layer = Linear(side, trans_x, x, y, w, ndim, b, fp32_fast_tf32, \
-                    redux=redux)
+                    redux=redux, activation=activation, y_pre=y_pre)
         # Return layer and next tag to be used
         return (layer, next_tag)
 
+    # Set up tensor parallelism, when the contracted dimension of W is split
+    # into contiguous blocks over MPI ranks (Megatron-style). Row-parallel
+    # forward (contraction over the split dimension of X) accumulates
+    # partial products on ranks of blocks into y_replicas, that are then
+    # reduced into Y (see gemm_summa_async). In the same way, x_grad_replicas
+    # serve backward of a column-parallel layer, where the split dimension of
+    # W is the dimension of Y. Replicas are temporaries of the same shape and
+    # basetile as Y or X, distributed on the ranks of the blocks except the
+    # first one. Such gemms do not use fp32_fast_tf32 and fp32_convert_fp16.
+    def set_tensor_parallel(self, y_replicas: List[Tensor]=[], \
+            x_grad_replicas: List[Tensor]=[]):
+        for t in y_replicas:
+            if t.shape != self.y.value.shape or \
+                    t.basetile_shape != self.y.value.basetile_shape:
+                raise ValueError("Replicas of Y shall have the same shape " \
+                        "and basetile as Y")
+        for t in x_grad_replicas:
+            if t.shape != self.x.value.shape or \
+                    t.basetile_shape != self.x.value.basetile_shape:
+                raise ValueError("Replicas of dX shall have the same shape " \
+                        "and basetile as X")
+        if self.activation is not None and y_replicas:
+            raise ValueError("Replicas of Y are not supported with fused " \
+                    "activation")
+        self.y_replicas = list(y_replicas)
+        self.x_grad_replicas = list(x_grad_replicas)
+        self.temporaries.extend(self.y_replicas + self.x_grad_replicas)
+
+    # Quantize weights for inference with weight-only quantization
+    # Weights are converted into dtype ('int8' or 'fp8_e4m3') with a single
+    # precision scale per group of consecutive input features of an output
+    # feature, group=0 meaning a single scale per output feature of a tile.
+    # Forward uses the quantized weights, while the single precision weights
+    # and their gradient are invalidated to release memory, so the layer
+    # cannot be trained any more. Only side 'R' without transposition of X is
+    # supported, which is the case for MLP of GPT2.
+    def quantize(self, next_tag: int, dtype: str="int8", group: int=0):
+        if self.side != 'R' or self.trans_x != notrans:
+            raise ValueError("Only side 'R' without transposition of X " \
+                    "supports quantization")
+        if type(self.w.value) is not nntile.tensor.Tensor_fp32:
+            raise TypeError("Only single precision weights can be quantized")
+        if self.y_replicas or self.fp32_convert_fp16:
+            raise ValueError("Quantization is not supported with replicas " \
+                    "of Y or conversion into fp16")
+        if self.w_q is not None:
+            raise ValueError("Weights are already quantized")
+        if dtype == "int8":
+            tensor_type = nntile.tensor.Tensor_int8
+        elif dtype == "fp8_e4m3":
+            tensor_type = nntile.tensor.Tensor_fp8_e4m3
+        else:
+            raise ValueError("dtype must be either 'int8' or 'fp8_e4m3'")
+        w = self.w.value
+        axis = w.ndim - self.ndim
+        if group == 0:
+            group = w.basetile_shape[axis]
+        scale_shape = list(w.shape)
+        scale_shape[axis] //= group
+        scale_basetile = list(w.basetile_shape)
+        scale_basetile[axis] //= group
+        self.w_q = tensor_type(TensorTraits(w.shape, w.basetile_shape), \
+                w.distribution, next_tag)
+        next_tag = self.w_q.next_tag
+        self.w_scale = nntile.tensor.Tensor_fp32(TensorTraits(scale_shape, \
+                scale_basetile), w.distribution, next_tag)
+        next_tag = self.w_scale.next_tag
+        quantize_async(w, self.w_q, self.w_scale, axis, group)
+        w.invalidate_submit()
+        self.w.grad.invalidate_submit()
+        self.w_q.wont_use()
+        self.w_scale.wont_use()
+        self.temporaries.extend([self.w_q, self.w_scale])
+        return next_tag
+
+    # Add low-rank adapters (LoRA) for fine-tuning with frozen weights, so
+    # that Y = W X + scale B A X with scale = alpha / rank. Only adapters A
+    # and B are trained: weights and bias do not require gradients any more,
+    # so neither the gemm over dW is submitted nor memory for dW is
+    # allocated. A is initialized randomly and B by zeros, so the layer
+    # produces the same output as before. Intermediate H = A X (H = X A for
+    # side 'L') and its gradient are temporaries of shape of Y, where
+    # output features are replaced by the rank. Only X without
+    # transposition is supported.
+    def add_lora(self, rank: int, next_tag: int, alpha: Optional[float]=None, \
+            rank_tile: int=0, seed: int=100):
+        if self.trans_x != notrans:
+            raise ValueError("Only X without transposition supports LoRA")
+        if self.w_q is not None or self.fp32_convert_fp16 \
+                or self.y_replicas or self.x_grad_replicas:
+            raise ValueError("LoRA is not supported with quantization, " \
+                    "conversion into fp16 or replicas")
+        if self.lora_a is not None:
+            raise ValueError("LoRA adapters are already added")
+        if rank <= 0:
+            raise ValueError("rank must be positive integer")
+        if rank_tile <= 0:
+            rank_tile = rank
+        if alpha is None:
+            alpha = rank
+        x = self.x.value
+        w = self.w.value
+        if self.side == 'L':
+            in_shape = w.shape[:self.ndim]
+            in_tile = w.basetile_shape[:self.ndim]
+            a_shape = in_shape + [rank]
+            a_tile = in_tile + [rank_tile]
+            b_shape = [rank] + w.shape[self.ndim:]
+            b_tile = [rank_tile] + w.basetile_shape[self.ndim:]
+            h_shape = x.shape[:-self.ndim] + [rank]
+            h_tile = x.basetile_shape[:-self.ndim] + [rank_tile]
+        else:
+            in_shape = w.shape[-self.ndim:]
+            in_tile = w.basetile_shape[-self.ndim:]
+            a_shape = [rank] + in_shape
+            a_tile = [rank_tile] + in_tile
+            b_shape = w.shape[:-self.ndim] + [rank]
+            b_tile = w.basetile_shape[:-self.ndim] + [rank_tile]
+            h_shape = [rank] + x.shape[self.ndim:]
+            h_tile = [rank_tile] + x.basetile_shape[self.ndim:]
+        def moments(shape, tile, next_tag):
+            traits = TensorTraits(shape, tile)
+            # TODO change distribution
+            distr = [0] * traits.grid.nelems
+            value = type(x)(traits, distr, next_tag)
+            grad = type(x)(traits, distr, value.next_tag)
+            grad.set_reduction_add()
+            return TensorMoments(value, grad, True), grad.next_tag
+        self.lora_a, next_tag = moments(a_shape, a_tile, next_tag)
+        self.lora_b, next_tag = moments(b_shape, b_tile, next_tag)
+        self.lora_h, next_tag = moments(h_shape, h_tile, next_tag)
+        self.lora_h.value.set_reduction_add()
+        self.lora_scale = alpha / rank
+        randn_async(self.lora_a.value, [0]*len(a_shape), a_shape, seed, \
+                0.0, 1.0/np.sqrt(np.prod(in_shape)))
+        clear_async(self.lora_b.value)
+        # Freeze weights and bias, releasing memory of their gradients
+        for p in [self.w, self.b]:
+            if p is None:
+                continue
+            p.grad_required = False
+            if p.grad is not None:
+                p.grad.invalidate_submit()
+        self.parameters.extend([self.lora_a, self.lora_b])
+        self.temporaries.append(self.lora_h)
+        return next_tag
+
+    # Merge adapters into weights for inference, so that forward costs the
+    # same as without adapters. Adapters are unregistered, while weights
+    # and bias stay frozen.
+    def merge_lora(self):
+        if self.lora_a is None:
+            raise ValueError("There are no LoRA adapters")
+        if self.side == 'L':
+            gemm_async(self.lora_scale, notrans, self.lora_a.value, notrans, \
+                    self.lora_b.value, 1.0, self.w.value, 1, 0)
+        else:
+            gemm_async(self.lora_scale, notrans, self.lora_b.value, notrans, \
+                    self.lora_a.value, 1.0, self.w.value, 1, 0)
+        self.parameters.remove(self.lora_a)
+        self.parameters.remove(self.lora_b)
+        self.temporaries.remove(self.lora_h)
+        for t in [self.lora_a, self.lora_b, self.lora_h]:
+            t.unregister()
+        self.lora_a = None
+        self.lora_b = None
+        self.lora_h = None
+        self.lora_scale = 0.0
+
+    # Add the low-rank update scale B A X (scale X A B for side 'L') to the
+    # output of gemm
+    def _lora_forward_async(self, y_value: Tensor):
+        a = self.lora_a.value
+        b = self.lora_b.value
+        h = self.lora_h.value
+        if self.side == 'L':
+            gemm_async(1.0, notrans, self.x.value, notrans, a, 0.0, h, \
+                    self.ndim, 0, redux=self.redux)
+            gemm_async(self.lora_scale, notrans, h, notrans, b, 1.0, \
+                    y_value, 1, 0, redux=self.redux)
+        else:
+            gemm_async(1.0, notrans, a, notrans, self.x.value, 0.0, h, \
+                    self.ndim, 0, redux=self.redux)
+            gemm_async(self.lora_scale, notrans, b, notrans, h, 1.0, \
+                    y_value, 1, 0, redux=self.redux)
+        a.wont_use()
+        b.wont_use()
+        h.wont_use()
+
+    # Gradients over adapters and contribution of adapters into gradient
+    # over X
+    def _lora_backward_async(self, y_grad: Tensor):
+        a = self.lora_a
+        b = self.lora_b
+        h = self.lora_h
+        w_priority = background_priority()
+        batch_ndim = self.x.value.ndim - self.ndim
+        out_ndim = self.w.value.ndim - self.ndim
+        if self.side == 'L':
+            # dB += scale H^T dY, dH = scale dY B^T
+            gemm_async(self.lora_scale, trans, h.value, notrans, y_grad, \
+                    1.0, b.grad, batch_ndim, 0, redux=self.redux, \
+                    priority=w_priority)
+            gemm_async(self.lora_scale, notrans, y_grad, trans, b.value, \
+                    0.0, h.grad, out_ndim, 0, redux=self.redux)
+            # dA += X^T dH, dX += dH A^T
+            gemm_async(1.0, trans, self.x.value, notrans, h.grad, 1.0, \
+                    a.grad, batch_ndim, 0, redux=self.redux, \
+                    priority=w_priority)
+            if self.x.grad_required:
+                gemm_async(1.0, notrans, h.grad, trans, a.value, 1.0, \
+                        self.x.grad, 1, 0, redux=self.redux)
+        else:
+            # dB += scale dY H^T, dH = scale B^T dY
+            gemm_async(self.lora_scale, notrans, y_grad, trans, h.value, \
+                    1.0, b.grad, batch_ndim, 0, redux=self.redux, \
+                    priority=w_priority)
+            gemm_async(self.lora_scale, trans, b.value, notrans, y_grad, \
+                    0.0, h.grad, out_ndim, 0, redux=self.redux)
+            # dA += dH X^T, dX += A^T dH
+            gemm_async(1.0, notrans, h.grad, trans, self.x.value, 1.0, \
+                    a.grad, batch_ndim, 0, redux=self.redux, \
+                    priority=w_priority)
+            if self.x.grad_required:
+                gemm_async(1.0, trans, a.value, notrans, h.grad, 1.0, \
+                        self.x.grad, 1, 0, redux=self.redux)
+        for t in [a.value, a.grad, b.value, b.grad, h.value, h.grad]:
+            t.wont_use()
+
     # Forward propagation of the linear layer
     def forward_async(self):
+        # Gemm with bias and activation are fused into a single operation
+        if self.activation is not None and self.b is not None \
+                and self.w_q is None and self.lora_a is None \
+                and not self.fp32_fast_tf32 and not self.fp32_convert_fp16:
+            if self.side == 'L':
+                gemm_bias_gelutanh_async(1.0, self.trans_x, self.x.value, \
+                        notrans, self.w.value, self.b.value, \
+                        self.y_pre.value, self.y.value, self.ndim, \
+                        self.y.value.ndim-1, redux=self.redux)
+            else:
+                gemm_bias_gelutanh_async(1.0, notrans, self.w.value, \
+                        self.trans_x, self.x.value, self.b.value, \
+                        self.y_pre.value, self.y.value, self.ndim, 0, \
+                        redux=self.redux)
+            self.w.value.wont_use()
+            self.x.value.wont_use()
+            self.y.value.wont_use()
+            self.b.value.wont_use()
+            return
+        # Output of gemm with bias is the input of the activation if any
+        if self.activation is not None:
+            y_value = self.y_pre.value
+        else:
+            y_value = self.y.value
         # Convert fp32 to fp16 if needed
         if self.fp32_convert_fp16:
             fp32_to_fp16_async(self.x.value, self.x_fp16.value)
@@ -197,66 +500,115 @@ class Linear(BaseLayer):
             # 'i' is a multi-index of dimension X.ndim-ndim
             # 'j' is a multi-index of dimension ndim
             # 'k' is a multi-index of dimension W.ndim-ndim
-            if self.fp32_fast_tf32:
+            if self.y_replicas:
+                gemm_summa_async(1.0, self.trans_x, self.x.value, notrans, \
+                        self.w.value, 0.0, y_value, self.ndim, 0, \
+                        self.y_replicas, redux=self.redux)
+            elif self.fp32_fast_tf32:
                 gemm_ex_async(1.0, self.trans_x, self.x.value, notrans, \
-                        self.w.value, 0.0, self.y.value, self.ndim, 0, \
+                        self.w.value, 0.0, y_value, self.ndim, 0, \
                         redux=self.redux)
             elif self.fp32_convert_fp16:
                 gemm_async(1.0, self.trans_x, self.x_fp16.value, notrans, \
                         self.w_fp16.value, 0.0, self.y_fp16.value, \
                         self.ndim, 0, redux=self.redux)
-                fp16_to_fp32_async(self.y_fp16.value, self.y.value)
+                fp16_to_fp32_async(self.y_fp16.value, y_value)
                 self.x_fp16.value.wont_use()
                 self.w_fp16.value.wont_use()
                 self.y_fp16.value.wont_use()
             else:
                 gemm_async(1.0, self.trans_x, self.x.value, notrans, \
-                        self.w.value, 0.0, self.y.value, self.ndim, 0, \
+                        self.w.value, 0.0, y_value, self.ndim, 0, \
                         redux=self.redux)
+            if self.lora_a is not None:
+                self._lora_forward_async(y_value)
             if self.b is not None:
-                add_fiber_async(1.0, self.b.value, 1.0, self.y.value,
-                        self.y.value.ndim-1, 0)
+                add_fiber_async(1.0, self.b.value, 1.0, y_value,
+                        y_value.ndim-1, 0)
         else:
             # Y = einsum('ij,jk->ik', W, op(X))
             # 'i' is a multi-index of dimension W.ndim-ndim
             # 'j' is a multi-index of dimension ndim
             # 'k' is a multi-index of dimension X.ndim-ndim
-            if self.fp32_fast_tf32:
+            if self.w_q is not None:
+                gemm_dequant_async(1.0, self.w_q, self.w_scale, \
+                        self.x.value, 0.0, y_value, self.ndim)
+                self.w_q.wont_use()
+                self.w_scale.wont_use()
+            elif self.y_replicas:
+                gemm_summa_async(1.0, notrans, self.w.value, self.trans_x, \
+                        self.x.value, 0.0, y_value, self.ndim, 0, \
+                        self.y_replicas, redux=self.redux)
+            elif self.fp32_fast_tf32:
                 gemm_ex_async(1.0, notrans, self.w.value, self.trans_x, \
-                        self.x.value, 0.0, self.y.value, self.ndim, 0, \
+                        self.x.value, 0.0, y_value, self.ndim, 0, \
                         redux=self.redux)
             elif self.fp32_convert_fp16:
                 gemm_async(1.0, notrans, self.w_fp16.value, self.trans_x, \
                         self.x_fp16.value, 0.0, self.y_fp16.value, \
                         self.ndim, 0, redux=self.redux)
-                fp16_to_fp32_async(self.y_fp16.value, self.y.value)
+                fp16_to_fp32_async(self.y_fp16.value, y_value)
                 self.x_fp16.value.wont_use()
                 self.w_fp16.value.wont_use()
                 self.y_fp16.value.wont_use()
             else:
                 gemm_async(1.0, notrans, self.w.value, self.trans_x, \
-                        self.x.value, 0.0, self.y.value, self.ndim, 0, \
+                        self.x.value, 0.0, y_value, self.ndim, 0, \
                         redux=self.redux)
+            if self.lora_a is not None:
+                self._lora_forward_async(y_value)
             if self.b is not None:
-                add_fiber_async(1.0, self.b.value, 1.0, self.y.value, 0, 0)
+                add_fiber_async(1.0, self.b.value, 1.0, y_value, 0, 0)
+        # Apply activation
+        if self.activation is not None:
+            gelutanh_async(self.y_pre.value, self.y.value)
+            self.y.value.wont_use()
         # Hint for StarPU that W tensor will
         # not be used soon and it is advised to offload data from GPU
         self.w.value.wont_use()
         self.x.value.wont_use()
-        self.y.value.wont_use()
+        y_value.wont_use()
         if self.b is not None:
             self.b.value.wont_use()
 
     # Backward propagation of the linear layer
     def backward_async(self):
+        if self.w_q is not None:
+            raise RuntimeError("Quantized linear layer supports only " \
+                    "inference")
+        # Gradients over weights are off the critical path of backward, so
+        # they give way to gradients over inputs
+        w_priority = background_priority()
+        # Gradient over output of gemm with bias, that is the input of the
+        # activation if any. Gradient over bias is computed by the same
+        # operation if possible.
+        b_grad_done = False
+        if self.activation is not None:
+            y_grad = self.y_pre.grad
+            if self.side == 'L':
+                b_axis = self.y.value.ndim - 1
+            else:
+                b_axis = 0
+            if self.b is not None and self.b.grad_required:
+                bias_gelutanh_backward_async(self.y_pre.value, self.y.grad, \
+                        y_grad, self.b.grad, b_axis, redux=self.redux)
+                self.b.grad.wont_use()
+                b_grad_done = True
+            else:
+                clear_async(y_grad)
+                gelutanh_backward_async(self.y_pre.value, self.y.grad, y_grad)
+            self.y_pre.value.wont_use()
+            self.y.grad.wont_use()
+        else:
+            y_grad = self.y.grad
         # Convert fp32 to fp16 if needed
         if self.fp32_convert_fp16:
-            fp32_to_fp16_async(self.y.grad, self.y_fp16.grad)
+            fp32_to_fp16_async(y_grad, self.y_fp16.grad)
         # Gradient over W (weights)
         if self.w.grad_required:
-            # Convert fp32 to fp16 if needed
-            if self.fp32_convert_fp16:
-                fp32_to_fp16_async(self.w.grad, self.w_fp16.grad)
+            # Products of fp16 tensors are accumulated directly in fp32
+            # gradient over W, so it is not rounded into fp16 over many
+            # accumulated minibatches
             gemm_ndim = self.x.value.ndim - self.ndim
             if self.side == 'L':
                 # Backward for Y = einsum('ij,jk->ik', op(X), W)
@@ -267,29 +619,31 @@ class Linear(BaseLayer):
                 if self.trans_x == notrans:
                     if self.fp32_fast_tf32:
                         gemm_ex_async(1.0, trans, self.x.value, notrans, \
-                                self.y.grad, 1.0, self.w.grad, gemm_ndim, 0, \
-                                redux=self.redux)
+                                y_grad, 1.0, self.w.grad, gemm_ndim, 0, \
+                                redux=self.redux, priority=w_priority)
                     elif self.fp32_convert_fp16:
                         gemm_async(1.0, trans, self.x_fp16.value, notrans, \
-                                self.y_fp16.grad, 1.0, self.w_fp16.grad, \
-                                gemm_ndim, 0, redux=self.redux)
+                                self.y_fp16.grad, 1.0, self.w.grad, \
+                                gemm_ndim, 0, redux=self.redux, \
+                                priority=w_priority)
                     else:
                         gemm_async(1.0, trans, self.x.value, notrans, \
-                                self.y.grad, 1.0, self.w.grad, gemm_ndim, 0, \
-                                redux=self.redux)
+                                y_grad, 1.0, self.w.grad, gemm_ndim, 0, \
+                                redux=self.redux, priority=w_priority)
                 else:
                     if self.fp32_fast_tf32:
                         gemm_ex_async(1.0, notrans, self.x.value, notrans, \
-                                self.y.grad, 1.0, self.w.grad, gemm_ndim, 0, \
-                                redux=self.redux)
+                                y_grad, 1.0, self.w.grad, gemm_ndim, 0, \
+                                redux=self.redux, priority=w_priority)
                     elif self.fp32_convert_fp16:
                         gemm_async(1.0, notrans, self.x_fp16.value, notrans, \
-                                self.y_fp16.grad, 1.0, self.w_fp16.grad, \
-                                gemm_ndim, 0, redux=self.redux)
+                                self.y_fp16.grad, 1.0, self.w.grad, \
+                                gemm_ndim, 0, redux=self.redux, \
+                                priority=w_priority)
                     else:
                         gemm_async(1.0, notrans, self.x.value, notrans, \
-                                self.y.grad, 1.0, self.w.grad, gemm_ndim, 0, \
-                                redux=self.redux)
+                                y_grad, 1.0, self.w.grad, gemm_ndim, 0, \
+                                redux=self.redux, priority=w_priority)
             else:
                 # Backward for Y = einsum('ij,jk->ik', W, op(X))
                 # dW += einsum('ik,jk->ij', dY, op(X))
@@ -298,49 +652,52 @@ class Linear(BaseLayer):
                 # 'k' is a multi-index of dimension X.ndim-ndim
                 if self.trans_x == notrans:
                     if self.fp32_fast_tf32:
-                        gemm_ex_async(1.0, notrans, self.y.grad, trans, \
+                        gemm_ex_async(1.0, notrans, y_grad, trans, \
                                 self.x.value, 1.0, self.w.grad, gemm_ndim, 0, \
-                                redux=self.redux)
+                                redux=self.redux, priority=w_priority)
                     elif self.fp32_convert_fp16:
                         gemm_async(1.0, notrans, self.y_fp16.grad, trans, \
-                                self.x_fp16.value, 1.0, self.w_fp16.grad, \
-                                gemm_ndim, 0, redux=self.redux)
+                                self.x_fp16.value, 1.0, self.w.grad, \
+                                gemm_ndim, 0, redux=self.redux, \
+                                priority=w_priority)
                     else:
-                        gemm_async(1.0, notrans, self.y.grad, trans, \
+                        gemm_async(1.0, notrans, y_grad, trans, \
                                 self.x.value, 1.0, self.w.grad, gemm_ndim, 0, \
-                                redux=self.redux)
+                                redux=self.redux, priority=w_priority)
                 else:
                     if self.fp32_fast_tf32:
-                        gemm_ex_async(1.0, notrans, self.y.grad, notrans, \
+                        gemm_ex_async(1.0, notrans, y_grad, notrans, \
                                 self.x.value, 1.0, self.w.grad, gemm_ndim, 0, \
-                                redux=self.redux)
+                                redux=self.redux, priority=w_priority)
                     elif self.fp32_convert_fp16:
                         gemm_async(1.0, notrans, self.y_fp16.grad, notrans, \
-                                self.x_fp16.value, 1.0, self.w_fp16.grad, \
-                                gemm_ndim, 0, redux=self.redux)
+                                self.x_fp16.value, 1.0, self.w.grad, \
+                                gemm_ndim, 0, redux=self.redux, \
+                                priority=w_priority)
                     else:
-                        gemm_async(1.0, notrans, self.y.grad, notrans, \
+                        gemm_async(1.0, notrans, y_grad, notrans, \
                                 self.x.value, 1.0, self.w.grad, gemm_ndim, 0, \
-                                redux=self.redux)
-            # Convert fp16 to fp32 if needed and offload data
+                                redux=self.redux, priority=w_priority)
+            # Offload data
             if self.fp32_convert_fp16:
-                fp16_to_fp32_async(self.w_fp16.grad, self.w.grad)
                 self.x_fp16.value.wont_use()
-                self.w_fp16.grad.wont_use()
             # Hint StarPU to offload gradient over W if needed
             self.w.grad.wont_use()
             self.x.value.wont_use()
-            self.y.grad.wont_use()
-        if self.b is not None:
+            y_grad.wont_use()
+        if self.b is not None and not b_grad_done:
             if self.b.grad_required:
                 if self.side == 'L':
-                    sum_fiber_async(1.0, self.y.grad, 1.0, self.b.grad, \
+                    sum_fiber_async(1.0, y_grad, 1.0, self.b.grad, \
                             self.y.value.ndim-1, 0, redux=self.redux)
                 else:
-                    sum_fiber_async(1.0, self.y.grad, 1.0, self.b.grad, 0, 0, \
+                    sum_fiber_async(1.0, y_grad, 1.0, self.b.grad, 0, 0, \
                             redux=self.redux)
                 self.b.grad.wont_use()
-                self.y.grad.wont_use()
+                y_grad.wont_use()
+        # Gradients over adapters
+        if self.lora_a is not None:
+            self._lora_backward_async(y_grad)
         # Gradient over X (input)
         if self.x.grad_required:
             # Convert fp32 to fp16 if needed
@@ -355,8 +712,12 @@ class Linear(BaseLayer):
                 # 'k' is a multi-index of dimension W.ndim-ndim
                 if self.trans_x == notrans:
                     # dX += einsum('ik,jk->ij', dY, W)
-                    if self.fp32_fast_tf32:
-                        gemm_ex_async(1.0, notrans, self.y.grad, trans, \
+                    if self.x_grad_replicas:
+                        gemm_summa_async(1.0, notrans, y_grad, trans, \
+                                self.w.value, 1.0, self.x.grad, gemm_ndim, 0, \
+                                self.x_grad_replicas, redux=self.redux)
+                    elif self.fp32_fast_tf32:
+                        gemm_ex_async(1.0, notrans, y_grad, trans, \
                                 self.w.value, 1.0, self.x.grad, gemm_ndim, 0, \
                                 redux=self.redux)
                     elif self.fp32_convert_fp16:
@@ -364,14 +725,18 @@ class Linear(BaseLayer):
                                 self.w_fp16.value, 1.0, self.x_fp16.grad, \
                                 gemm_ndim, 0, redux=self.redux)
                     else:
-                        gemm_async(1.0, notrans, self.y.grad, trans, \
+                        gemm_async(1.0, notrans, y_grad, trans, \
                                 self.w.value, 1.0, self.x.grad, gemm_ndim, 0, \
                                 redux=self.redux)
                 else:
                     # dX += einsum('ik,jk->ij', W, dY)
-                    if self.fp32_fast_tf32:
+                    if self.x_grad_replicas:
+                        gemm_summa_async(1.0, notrans, self.w.value, trans, \
+                                y_grad, 1.0, self.x.grad, gemm_ndim, 0, \
+                                self.x_grad_replicas, redux=self.redux)
+                    elif self.fp32_fast_tf32:
                         gemm_ex_async(1.0, notrans, self.w.value, trans, \
-                                self.y.grad, 1.0, self.x.grad, gemm_ndim, 0, \
+                                y_grad, 1.0, self.x.grad, gemm_ndim, 0, \
                                 redux=self.redux)
                     elif self.fp32_convert_fp16:
                         gemm_async(1.0, notrans, self.w_fp16.value, trans, \
@@ -379,7 +744,7 @@ class Linear(BaseLayer):
                                 gemm_ndim, 0, redux=self.redux)
                     else:
                         gemm_async(1.0, notrans, self.w.value, trans, \
-                                self.y.grad, 1.0, self.x.grad, gemm_ndim, 0, \
+                                y_grad, 1.0, self.x.grad, gemm_ndim, 0, \
                                 redux=self.redux)
             else:
                 # Backward for Y = einsum('ij,jk->ik', W, op(X))
@@ -389,9 +754,13 @@ class Linear(BaseLayer):
                 # 'k' is a multi-index of dimension X.ndim-ndim
                 if self.trans_x == notrans:
                     # dX += einsum('ij,ik->jk', W, dY)
-                    if self.fp32_fast_tf32:
+                    if self.x_grad_replicas:
+                        gemm_summa_async(1.0, trans, self.w.value, notrans, \
+                                y_grad, 1.0, self.x.grad, gemm_ndim, 0, \
+                                self.x_grad_replicas, redux=self.redux)
+                    elif self.fp32_fast_tf32:
                         gemm_ex_async(1.0, trans, self.w.value, notrans, \
-                                self.y.grad, 1.0, self.x.grad, gemm_ndim, 0, \
+                                y_grad, 1.0, self.x.grad, gemm_ndim, 0, \
                                 redux=self.redux)
                     elif self.fp32_convert_fp16:
                         gemm_async(1.0, trans, self.w_fp16.value, notrans, \
@@ -399,12 +768,16 @@ class Linear(BaseLayer):
                                 gemm_ndim, 0, redux=self.redux)
                     else:
                         gemm_async(1.0, trans, self.w.value, notrans, \
-                                self.y.grad, 1.0, self.x.grad, gemm_ndim, 0, \
+                                y_grad, 1.0, self.x.grad, gemm_ndim, 0, \
                                 redux=self.redux)
                 else:
                     # dX = einsum('ij,ik->jk', dY, W)
-                    if self.fp32_fast_tf32:
-                        gemm_ex_async(1.0, trans, self.y.grad, notrans, \
+                    if self.x_grad_replicas:
+                        gemm_summa_async(1.0, trans, y_grad, notrans, \
+                                self.w.value, 1.0, self.x.grad, gemm_ndim, 0, \
+                                self.x_grad_replicas, redux=self.redux)
+                    elif self.fp32_fast_tf32:
+                        gemm_ex_async(1.0, trans, y_grad, notrans, \
                                 self.w.value, 1.0, self.x.grad, gemm_ndim, 0, \
                                 redux=self.redux)
                     elif self.fp32_convert_fp16:
@@ -412,7 +785,7 @@ class Linear(BaseLayer):
                                 self.w_fp16.value, 1.0, self.x_fp16.grad, \
                                 gemm_ndim, 0, redux=self.redux)
                     else:
-                        gemm_async(1.0, trans, self.y.grad, notrans, \
+                        gemm_async(1.0, trans, y_grad, notrans, \
                                 self.w.value, 1.0, self.x.grad, gemm_ndim, 0, \
                                 redux=self.redux)
             # Convert fp16 to fp32 if needed and offload data
@@ -424,6 +797,34 @@ class Linear(BaseLayer):
             self.x.grad.wont_use()
         self.x.value.wont_use()
         self.y.value.wont_use()
+        y_grad.wont_use()
         self.y.grad.wont_use()
         self.w.value.wont_use()
 
+    # C++ counterpart of the layer without an activation, conversions of
+    # types, replicas, quantization and adapters
+    def to_cpp(self):
+        cls = cpp_class("Dense", self.x.value)
+        if cls is None or self.activation is not None \
+                or self.fp32_fast_tf32 or self.fp32_convert_fp16 \
+                or self.y_replicas or self.x_grad_replicas \
+                or self.w_q is not None or self.lora_a is not None:
+            return None
+        y = cpp_moments(self.y)
+        if y is None:
+            return None
+        # Values of X, W and b are placeholders of their gradients, if they
+        # are not required
+        def moments(t):
+            m = cpp_moments(t)
+            if m is None:
+                return type(y)(t.value, t.value), False
+            return m, True
+        x, x_grad_required = moments(self.x)
+        w, w_grad_required = moments(self.w)
+        b, b_grad_required = None, False
+        if self.b is not None:
+            b, b_grad_required = moments(self.b)
+        return cls(self.side, self.trans_x, x, y, w, b, self.ndim, \
+                x_grad_required, self.redux, w_grad_required, \
+                b_grad_required)
@@ -0,0 +1,189 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/layer/linear_crossentropy.py
+# Linear head layer fused with cross-entropy loss of NNTile Python package
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-15
+
+from nntile.tensor import TensorTraits, Tensor, TensorMoments, \
+        Tensor_int64, trans, notrans, gemm_async, clear_async, \
+        maxsumexp_async, softmax_crossentropy_async
+from nntile.layer.base_layer import BaseLayer
+from typing import List
+
+class LinearCrossEntropy(BaseLayer):
+    """Linear head layer without bias, fused with cross-entropy loss
+
+    Logits W @ X are never materialized for the entire vocabulary. Weight W
+    is split into chunks along the vocabulary, each chunk being a separate
+    parameter. The first pass over chunks computes logits of a chunk and
+    accumulates maxsumexp over the vocabulary. The second pass recomputes
+    logits of each chunk, gets the loss and its gradient over the logits of
+    the chunk by the fused softmax_crossentropy and immediately accumulates
+    gradients over the chunk of W and over X. Therefore, only two chunks of
+    logits and of their gradients are alive at any time at the cost of one
+    extra gemm.
+
+    The layer is the last one of a model and also works as its loss: it
+    holds labels y and value val of the loss, so that it can be passed to
+    Pipeline instead of a loss. Gradients are computed by forward_async if
+    they are required, while backward_async does nothing.
+    """
+    x: TensorMoments
+    w: List[TensorMoments]
+    y: Tensor_int64
+    val: Tensor
+    maxsumexp: Tensor
+    logits: List[TensorMoments]
+    # Gradients are ready after forward, loss scaling cannot be applied to
+    # the output gradient of the model (see Pipeline)
+    grads_in_forward = True
+
+    # Construct layer with all the provided data
+    def __init__(self, x: TensorMoments, w: List[TensorMoments], \
+            labels: Tensor_int64, val: Tensor, maxsumexp: Tensor, \
+            logits: List[TensorMoments], scale: float=1.0, \
+            redux: bool=False):
+        # Labels and loss are not temporaries, as they outlive forward and
+        # backward passes
+        super().__init__([x], [], w, [maxsumexp] + logits)
+        self.x = x
+        if self.x.grad is not None:
+            self.x.grad.set_reduction_add()
+        self.w = w
+        for w_chunk in self.w:
+            w_chunk.grad.set_reduction_add()
+        self.y = labels
+        self.val = val
+        self.val.set_reduction_add()
+        self.maxsumexp = maxsumexp
+        self.maxsumexp.set_reduction_maxsumexp()
+        self.logits = logits
+        self.scale = scale
+        if redux:
+            self.redux = 1
+        else:
+            self.redux = 0
+
+    # Simple generator, vocabulary is split into chunks of vocab_tile
+    @staticmethod
+    def generate_simple(x: TensorMoments, vocab_size: int, vocab_tile: int, \
+            next_tag: int, scale: float=1.0, redux: bool=False):
+        if vocab_tile <= 0 or vocab_tile > vocab_size:
+            raise ValueError("vocab_tile shall be in range [1, vocab_size]")
+        embed_dim = x.value.shape[0]
+        embed_dim_tile = x.value.basetile_shape[0]
+        shape = x.value.shape[1:]
+        basetile = x.value.basetile_shape[1:]
+        tensor_type = type(x.value)
+        # Chunks of W
+        w = []
+        for start in range(0, vocab_size, vocab_tile):
+            chunk = min(vocab_tile, vocab_size-start)
+            w_traits = TensorTraits([chunk, embed_dim], \
+                    [chunk, embed_dim_tile])
+            w_distr = [0] * w_traits.grid.nelems
+            w_value = tensor_type(w_traits, w_distr, next_tag)
+            next_tag = w_value.next_tag
+            w_grad = tensor_type(w_traits, w_distr, next_tag)
+            next_tag = w_grad.next_tag
+            w.append(TensorMoments(w_value, w_grad, True))
+        labels_traits = TensorTraits(shape, basetile)
+        distr = [0] * labels_traits.grid.nelems
+        labels = Tensor_int64(labels_traits, distr, next_tag)
+        next_tag = labels.next_tag
+        val_traits = TensorTraits([], [])
+        val = tensor_type(val_traits, [0], next_tag)
+        next_tag = val.next_tag
+        maxsumexp_traits = TensorTraits([2]+shape, [2]+basetile)
+        maxsumexp = tensor_type(maxsumexp_traits, distr, next_tag)
+        next_tag = maxsumexp.next_tag
+        # Two buffers of logits for full chunks and one for the last
+        # incomplete chunk if any
+        chunks = [vocab_tile] * min(2, vocab_size//vocab_tile)
+        if vocab_size % vocab_tile != 0:
+            chunks.append(vocab_size % vocab_tile)
+        logits = []
+        for chunk in chunks:
+            logits_traits = TensorTraits([chunk]+shape, [chunk]+basetile)
+            logits_value = tensor_type(logits_traits, distr, next_tag)
+            next_tag = logits_value.next_tag
+            logits_grad = tensor_type(logits_traits, distr, next_tag)
+            next_tag = logits_grad.next_tag
+            logits.append(TensorMoments(logits_value, logits_grad, True))
+        layer = LinearCrossEntropy(x, w, labels, val, maxsumexp, logits, \
+                scale=scale, redux=redux)
+        return layer, next_tag
+
+    # Buffer of logits for a chunk of W
+    def _logits(self, i_chunk: int) -> TensorMoments:
+        if self.w[i_chunk].value.shape[0] != self.logits[0].value.shape[0]:
+            return self.logits[-1]
+        return self.logits[i_chunk % 2]
+
+    # Logits of a chunk of the vocabulary
+    def _chunk_forward_async(self, i_chunk: int) -> TensorMoments:
+        logits = self._logits(i_chunk)
+        gemm_async(1.0, notrans, self.w[i_chunk].value, notrans, \
+                self.x.value, 0.0, logits.value, 1, 0, redux=self.redux)
+        return logits
+
+    # Forward propagation accumulates the loss and gradients if needed
+    def forward_async(self):
+        # The first pass gets maxsumexp over the entire vocabulary
+        clear_async(self.maxsumexp)
+        for i_chunk in range(len(self.w)):
+            logits = self._chunk_forward_async(i_chunk)
+            maxsumexp_async(logits.value, self.maxsumexp, 0, \
+                    redux=self.redux)
+            logits.value.invalidate_submit()
+        # The second pass gets the loss and gradients chunk by chunk
+        label_offset = 0
+        for i_chunk, w_chunk in enumerate(self.w):
+            logits = self._chunk_forward_async(i_chunk)
+            softmax_crossentropy_async(self.scale, self.maxsumexp, \
+                    logits.value, self.y, logits.grad, self.val, \
+                    label_offset)
+            label_offset += logits.value.shape[0]
+            logits.value.invalidate_submit()
+            # dW += dY @ X^T
+            if w_chunk.grad_required:
+                gemm_async(1.0, notrans, logits.grad, trans, self.x.value, \
+                        1.0, w_chunk.grad, self.x.value.ndim-1, 0, \
+                        redux=self.redux)
+                w_chunk.grad.wont_use()
+            # dX += W^T @ dY
+            if self.x.grad_required:
+                gemm_async(1.0, trans, w_chunk.value, notrans, logits.grad, \
+                        1.0, self.x.grad, 1, 0, redux=self.redux)
+            logits.grad.invalidate_submit()
+            w_chunk.value.wont_use()
+        self.x.value.wont_use()
+        if self.x.grad_required:
+            self.x.grad.wont_use()
+        self.maxsumexp.wont_use()
+        self.val.wont_use()
+        self.y.wont_use()
+
+    # Gradients are already accumulated by the forward propagation
+    def backward_async(self):
+        pass
+
+    # Loss is computed by the forward propagation
+    def calc_async(self):
+        pass
+
+    def get_val(self, val_np):
+        self.val.to_array(val_np)
+
+    # Unregister weights, temporaries, labels and loss
+    def unregister(self):
+        super().unregister()
+        self.y.unregister()
+        self.val.unregister()
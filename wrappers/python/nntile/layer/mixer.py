@@ -1,6 +1,8 @@
-from nntile.tensor import TensorMoments, TensorTraits, notrans, add_async, add_slice_async, sum_slice_async, clear_async, transpose_async
+from typing import Optional
+from nntile.tensor import TensorMoments, TensorTraits, notrans, add_async, add_slice_async, sum_slice_async, clear_async
 from nntile.layer.base_layer import BaseLayer
 from nntile.layer.layer_norm import LayerNorm
+from nntile.layer.add_layer_norm import AddLayerNorm
 from nntile.layer.linear import Linear
 from nntile.layer.act import Act
 
@@ -10,37 +12,25 @@ class GAP(BaseLayer):
     y: TensorMoments
 
     # Construct GAP layer with all the provided data
-    def __init__(self, x: TensorMoments, y: TensorMoments, yT: TensorMoments):
+    def __init__(self, x: TensorMoments, y: TensorMoments):
         self.x = x
         self.y = y
-        self.yT = yT
         
         # Redirect to BaseClass initialization
-        super().__init__([x], [y], [], [yT])
+        super().__init__([x], [y], [], [])
 
 
     def unregister(self):
         super().unregister()
 
 
+    # Output is averaged over the first axis and it is not transposed, so
+    # the next layer shall contract it with trans flag, e.g., Linear with
+    # side 'R' and trans_x=trans. It saves a transposed copy of activations.
     @staticmethod
     def generate_simple(x: TensorMoments, next_tag: int):
-        yT_shape = x.value.shape[1:]
-        yT_basetile_shape = x.value.basetile_shape[1:]
-        yT_traits = TensorTraits(yT_shape, yT_basetile_shape)
-        yT_distr = [0] * yT_traits.grid.nelems
-        yT_value = type(x.value)(yT_traits, yT_distr, next_tag)
-        next_tag = yT_value.next_tag
-
-        # Create gradient of Y with the same traits and distribution as Y
-        yT_grad = type(x.value)(yT_traits, yT_distr, next_tag)
-        next_tag = yT_grad.next_tag
-        # Define Y as TensorMoments
-        yT = TensorMoments(yT_value, yT_grad, True)
-
-
-        y_shape = yT_shape[::-1]
-        y_basetile_shape = yT_basetile_shape[::-1]
+        y_shape = x.value.shape[1:]
+        y_basetile_shape = x.value.basetile_shape[1:]
         y_traits = TensorTraits(y_shape, y_basetile_shape)
         y_distr = [0] * y_traits.grid.nelems
         y_value = type(x.value)(y_traits, y_distr, next_tag)
@@ -53,21 +43,19 @@ class GAP(BaseLayer):
         y = TensorMoments(y_value, y_grad, True)
 
         # Create GAP layer with all the provided data
-        layer = GAP(x, y, yT)
+        layer = GAP(x, y)
         # Return layer and next tag to be used
         return (layer, next_tag)
     
 
     def forward_async(self):
         alpha = 1 / (self.x.value.shape[0])
-        sum_slice_async(alpha, self.x.value, 0.0, self.yT.value, 0)
-        transpose_async(1.0, self.yT.value, self.y.value, 1)
+        sum_slice_async(alpha, self.x.value, 0.0, self.y.value, 0)
 
 
     def backward_async(self):
         alpha = 1 / (self.x.value.shape[0])
-        transpose_async(1.0, self.y.grad, self.yT.grad, 1)
-        add_slice_async(alpha, self.yT.grad, 0.0, self.x.grad, 0)
+        add_slice_async(alpha, self.y.grad, 0.0, self.x.grad, 0)
 
 
 class MixerMlp(BaseLayer):
@@ -76,12 +64,13 @@ class MixerMlp(BaseLayer):
     y: TensorMoments
     linear_1: Linear
     linear_2: Linear
-    act: Act
+    act: Optional[Act]
 
 
-    # Construct MixerMlp layer with all the provided data
+    # Construct MixerMlp layer with all the provided data. Activation is None
+    # if it is fused into the first linear layer.
     def __init__(self, side: str, x: TensorMoments, y: TensorMoments, 
-                 linear_1: Linear, linear_2: Linear, act: Act):
+                 linear_1: Linear, linear_2: Linear, act: Optional[Act]):
         # Check parameter side
         if side != 'L' and side != 'R':
             raise ValueError("side must be either 'L' or 'R'")
@@ -94,7 +83,12 @@ class MixerMlp(BaseLayer):
         self.linear_2 = linear_2
         self.act = act
 
-        layer_temporaries = list(self.linear_1.activations_output + self.act.activations_output + self.linear_2.activations_output)
+        if act is None:
+            layer_temporaries = list(self.linear_1.activations_output \
+                    + [self.linear_1.y_pre] \
+                    + self.linear_2.activations_output)
+        else:
+            layer_temporaries = list(self.linear_1.activations_output + self.act.activations_output + self.linear_2.activations_output)
         layer_parameters = list(self.linear_1.parameters + self.linear_2.parameters)
         
         # Redirect to BaseClass initialization
@@ -115,8 +109,11 @@ class MixerMlp(BaseLayer):
                 clear_async(t.grad)
 
 
+    # Fused variant adds biases and computes gemm, bias and the tanh
+    # approximation of GeLU of the first linear layer by a single operation
     @staticmethod
-    def generate_simple(x: TensorMoments, side: str, next_tag: int):
+    def generate_simple(x: TensorMoments, side: str, next_tag: int,
+            fused: bool=False):
         if side == 'R':
             add_shape = x.value.shape[0] * 4
             add_basetile_shape = x.value.shape[0] * 4
@@ -125,6 +122,16 @@ class MixerMlp(BaseLayer):
             add_shape = x.value.shape[-1] * 4
             add_basetile_shape = x.value.shape[-1] * 4
             init_shape = x.value.shape[-1]
+        if fused:
+            linear_1_layer, next_tag = Linear.generate_simple(x, side, \
+                    notrans, 1, [add_shape], [add_basetile_shape], \
+                    next_tag, bias=True, activation='gelutanh')
+            linear_2_layer, next_tag = Linear.generate_simple( \
+                    linear_1_layer.y, side, notrans, 1, [init_shape], \
+                    [init_shape], next_tag, bias=True)
+            layer = MixerMlp(side, x, linear_2_layer.y, linear_1_layer, \
+                    linear_2_layer, None)
+            return (layer, next_tag)
         linear_1_layer, next_tag = Linear.generate_simple(x, side, notrans, 1, [add_shape], [add_basetile_shape], next_tag, bias=False)
         act_layer, next_tag = Act.generate_simple(linear_1_layer.y, 'gelu', next_tag)
         linear_2_layer, next_tag = Linear.generate_simple(act_layer.y, side, notrans, 1, [init_shape], [init_shape], next_tag, bias=False)
@@ -136,13 +143,15 @@ class MixerMlp(BaseLayer):
 
     def forward_async(self):
         self.linear_1.forward_async()
-        self.act.forward_async()
+        if self.act is not None:
+            self.act.forward_async()
         self.linear_2.forward_async()
 
 
     def backward_async(self):
         self.linear_2.backward_async()
-        self.act.backward_async()
+        if self.act is not None:
+            self.act.backward_async()
         self.linear_1.backward_async()
 
 
@@ -224,4 +233,82 @@ class Mixer(BaseLayer):
         add_async(1.0, self.mlp_2.linear_2.y.grad, 1.0, self.mlp_1.y.grad)
         self.mlp_1.backward_async()
         self.norm_1.backward_async()
-        add_async(1.0, self.mlp_1.linear_2.y.grad, 1.0, self.x.grad)
\ No newline at end of file
+        add_async(1.0, self.mlp_1.linear_2.y.grad, 1.0, self.x.grad)
+
+
+# Mixer block, that fuses the residual connection after the token-mixing MLP
+# with the following normalization and uses MLPs with fused bias and GeLU.
+# Outputs of the token-mixing and channel-mixing MLPs are then computed with
+# two passes over activations less than in Mixer.
+class FusedMixer(BaseLayer):
+    x: TensorMoments
+    y: TensorMoments
+    norm_1: LayerNorm
+    add_norm: AddLayerNorm
+    mlp_1: MixerMlp
+    mlp_2: MixerMlp
+
+    # Construct mixer layer with all the provided data
+    def __init__(self, x: TensorMoments, y: TensorMoments, \
+            norm_1: LayerNorm, add_norm: AddLayerNorm, mlp_1: MixerMlp, \
+            mlp_2: MixerMlp):
+        self.x = x
+        self.y = y
+        self.norm_1 = norm_1
+        self.add_norm = add_norm
+        self.mlp_1 = mlp_1
+        self.mlp_2 = mlp_2
+        layer_parameters = norm_1.parameters + mlp_1.parameters \
+                + add_norm.parameters + mlp_2.parameters
+        layer_tmp = norm_1.activations_output + mlp_1.temporaries \
+                + add_norm.activations_output + mlp_2.temporaries
+        # Redirect to BaseClass initialization
+        super().__init__([x], [y], layer_parameters, layer_tmp)
+
+    def unregister(self):
+        super().unregister()
+        self.norm_1.unregister()
+        self.add_norm.unregister()
+        self.mlp_1.unregister()
+        self.mlp_2.unregister()
+
+    # Clear gradients of activations and parameters
+    def clear_gradients(self):
+        for t in self.activations_input + self.activations_output \
+                + self.temporaries + self.parameters:
+            if t.grad is not None and t.grad_required:
+                clear_async(t.grad)
+
+    # Simple generator for the fused mixer layer
+    @staticmethod
+    def generate_simple(x: TensorMoments, next_tag: int):
+        eps = 1e-5
+        norm_1, next_tag = LayerNorm.generate_simple(x, 2, eps, next_tag)
+        mlp_1, next_tag = MixerMlp.generate_simple(norm_1.y, 'R', next_tag, \
+                fused=True)
+        add_norm, next_tag = AddLayerNorm.generate_simple(x, mlp_1.y, 2, \
+                eps, next_tag)
+        mlp_2, next_tag = MixerMlp.generate_simple(add_norm.y, 'L', \
+                next_tag, fused=True)
+        layer = FusedMixer(x, mlp_2.y, norm_1, add_norm, mlp_1, mlp_2)
+        return (layer, next_tag)
+
+    # Forward propagation of the mixer layer
+    def forward_async(self):
+        self.norm_1.forward_async()
+        self.mlp_1.forward_async()
+        # Residual sum of the token-mixing block and its normalization
+        self.add_norm.forward_async()
+        self.mlp_2.forward_async()
+        add_async(1.0, self.add_norm.res.value, 1.0, self.y.value)
+        self.add_norm.res.value.wont_use()
+
+    # Backward propagation of the mixer layer
+    def backward_async(self):
+        # Gradient of the residual connection of the channel-mixing block
+        add_async(1.0, self.y.grad, 1.0, self.add_norm.res.grad)
+        self.mlp_2.backward_async()
+        # Gradients of the sum are accumulated into grads of X and mlp_1.y
+        self.add_norm.backward_async()
+        self.mlp_1.backward_async()
+        self.norm_1.backward_async()
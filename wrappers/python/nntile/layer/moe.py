@@ -0,0 +1,322 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/layer/moe.py
+# Mixture-of-experts feed-forward layer with top-k routing of tokens
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+from nntile.tensor import TensorTraits, Tensor, TensorMoments, notrans, \
+        trans, clear_async, gemm_async, maxsumexp_async, \
+        softmax_inplace_async, sumprod_slice_async, add_slice_async, \
+        prod_async, topk_async, gather_async, sum_fiber_async, \
+        add_fiber_async, gelutanh_async, gelutanh_backward_async, \
+        moe_route_async, moe_dispatch_async, moe_dispatch_backward_async, \
+        moe_combine_async, moe_combine_backward_async, Tensor_fp32, \
+        Tensor_int64
+from nntile.layer.base_layer import BaseLayer
+import numpy as np
+from typing import List
+
+# Mixture of experts, that replaces the MLP of a transformer block
+# Inputs:
+#  x: (n_emb, n_seq, n_batch) tensor
+# Output:
+#  y: (n_emb, n_seq, n_batch) tensor
+# A router w_gate of shape (n_experts, n_emb) gives probabilities of experts
+# for every token and every token is sent to top_k most probable experts.
+# Expert e takes at most capacity tokens into slot buffers of shape (n_emb,
+# capacity), earlier choices of tokens have priority over later ones and
+# tokens beyond capacity are dropped by the expert. Every expert is an MLP
+# with weights w1 of shape (n_inner, n_emb) and w2 of shape (n_emb, n_inner)
+# over its buffer, all the experts are batched along the last axis. Outputs
+# of experts are scaled by routing probabilities and summed up for every
+# token. A token, dropped by all its experts, gets zero output, so it passes
+# through the residual connection unchanged.
+# Every tile of buffers and weights belongs to a single expert, so experts
+# are placed onto MPI ranks by set_expert_ranks, while the router and the
+# tokens stay where they are.
+class MoE(BaseLayer):
+    x: TensorMoments
+    y: TensorMoments
+    w_gate: TensorMoments
+    w1: TensorMoments
+    w2: TensorMoments
+    probs: TensorMoments
+    probs_maxsumexp: Tensor
+    probs_sumprod_slice: Tensor
+    topk_values: Tensor
+    topk_indices: Tensor_int64
+    experts: Tensor_int64
+    slots: Tensor_int64
+    load: Tensor
+    importance: Tensor
+    buf_in: TensorMoments
+    h: TensorMoments
+    g: TensorMoments
+    buf_out: TensorMoments
+    n_experts: int
+    top_k: int
+    capacity: int
+    aux_loss_coef: float
+
+    # Construct mixture-of-experts layer with all the provided data
+    def __init__(self, x: TensorMoments, y: TensorMoments, \
+            w_gate: TensorMoments, w1: TensorMoments, w2: TensorMoments, \
+            probs: TensorMoments, probs_maxsumexp: Tensor, \
+            probs_sumprod_slice: Tensor, topk_values: Tensor, \
+            topk_indices: Tensor_int64, experts: Tensor_int64, \
+            slots: Tensor_int64, load: Tensor, importance: Tensor, \
+            buf_in: TensorMoments, h: TensorMoments, g: TensorMoments, \
+            buf_out: TensorMoments, aux_loss_coef: float=0.0, \
+            redux: bool=False):
+        # Redirect to BaseClass initialization
+        super().__init__([x], [y], [w_gate, w1, w2], [probs, \
+                probs_maxsumexp, probs_sumprod_slice, topk_values, \
+                topk_indices, experts, slots, load, importance, buf_in, h, \
+                g, buf_out])
+        self.x = x
+        self.y = y
+        self.w_gate = w_gate
+        self.w1 = w1
+        self.w2 = w2
+        self.probs = probs
+        self.probs_maxsumexp = probs_maxsumexp
+        self.probs_maxsumexp.set_reduction_maxsumexp()
+        self.probs_sumprod_slice = probs_sumprod_slice
+        self.topk_values = topk_values
+        self.topk_indices = topk_indices
+        self.experts = experts
+        self.slots = slots
+        self.load = load
+        self.importance = importance
+        self.buf_in = buf_in
+        self.h = h
+        self.g = g
+        self.buf_out = buf_out
+        self.n_experts = w_gate.value.shape[0]
+        self.top_k = topk_values.shape[0]
+        self.capacity = slots.shape[0]
+        self.aux_loss_coef = aux_loss_coef
+        if redux:
+            self.redux = 1
+        else:
+            self.redux = 0
+
+    # Number of slots of every expert, taken by top_k choices of n_tokens
+    # tokens, that are spread evenly with a given capacity factor
+    @staticmethod
+    def get_capacity(n_tokens: int, n_experts: int, top_k: int, \
+            capacity_factor: float) -> int:
+        capacity = int(np.ceil(capacity_factor * n_tokens * top_k \
+                / n_experts))
+        # A token takes at most one slot of an expert
+        return max(1, min(capacity, n_tokens))
+
+    # Simple generator for the mixture-of-experts layer
+    @staticmethod
+    def generate_simple(x: TensorMoments, n_experts: int, top_k: int, \
+            n_inner: int, n_inner_tile: int, next_tag: int, \
+            capacity_factor: float=1.25, aux_loss_coef: float=0.0, \
+            redux: bool=False):
+        # Get sizes
+        n_emb, n_seq, n_batch = x.value.shape
+        n_emb_tile, n_seq_tile, n_batch_tile = x.value.basetile_shape
+        if top_k < 1 or top_k > n_experts:
+            raise ValueError("top_k shall be in range [1, n_experts]")
+        capacity = MoE.get_capacity(n_seq*n_batch, n_experts, top_k, \
+                capacity_factor)
+        # All the experts of a token are in a single tile
+        tokens_shape = [n_seq, n_batch]
+        tokens_basetile = [n_seq_tile, n_batch_tile]
+        # Every tile of buffers and weights belongs to a single expert
+        traits = {
+            "w_gate": ([n_experts, n_emb], [n_experts, n_emb_tile]),
+            "w1": ([n_inner, n_emb, n_experts], \
+                    [n_inner_tile, n_emb_tile, 1]),
+            "w2": ([n_emb, n_inner, n_experts], \
+                    [n_emb_tile, n_inner_tile, 1]),
+            "probs": ([n_experts]+tokens_shape, [n_experts]+tokens_basetile),
+            "probs_maxsumexp": ([2]+tokens_shape, [2]+tokens_basetile),
+            "probs_sumprod_slice": (tokens_shape, tokens_basetile),
+            "topk": ([top_k]+tokens_shape, [top_k]+tokens_basetile),
+            "experts": ([top_k]+tokens_shape, [top_k]+tokens_shape),
+            "slots": ([capacity, n_experts], [capacity, n_experts]),
+            "load": ([n_experts], [n_experts]),
+            "buf": ([n_emb, capacity, n_experts], [n_emb_tile, capacity, 1]),
+            "h": ([n_inner, capacity, n_experts], \
+                    [n_inner_tile, capacity, 1]),
+        }
+        def tensor(name, next_tag, dtype=type(x.value)):
+            t_traits = TensorTraits(*traits[name])
+            t_distr = [0] * t_traits.grid.nelems
+            t = dtype(t_traits, t_distr, next_tag)
+            return t, t.next_tag
+        def moments(name, next_tag):
+            value, next_tag = tensor(name, next_tag)
+            grad, next_tag = tensor(name, next_tag)
+            return TensorMoments(value, grad, True), next_tag
+        w_gate, next_tag = moments("w_gate", next_tag)
+        w1, next_tag = moments("w1", next_tag)
+        w2, next_tag = moments("w2", next_tag)
+        probs, next_tag = moments("probs", next_tag)
+        probs_maxsumexp, next_tag = tensor("probs_maxsumexp", next_tag)
+        probs_sumprod_slice, next_tag = tensor("probs_sumprod_slice", \
+                next_tag)
+        topk_values, next_tag = tensor("topk", next_tag)
+        topk_indices, next_tag = tensor("topk", next_tag, Tensor_int64)
+        experts, next_tag = tensor("experts", next_tag, Tensor_int64)
+        slots, next_tag = tensor("slots", next_tag, Tensor_int64)
+        load, next_tag = tensor("load", next_tag)
+        importance, next_tag = tensor("load", next_tag)
+        buf_in, next_tag = moments("buf", next_tag)
+        h, next_tag = moments("h", next_tag)
+        g, next_tag = moments("h", next_tag)
+        buf_out, next_tag = moments("buf", next_tag)
+        # Output has the same traits and distribution as the input
+        y_traits = TensorTraits(x.value.shape, x.value.basetile_shape)
+        y_distr = x.value.distribution
+        y_value = type(x.value)(y_traits, y_distr, next_tag)
+        next_tag = y_value.next_tag
+        y_grad = type(x.value)(y_traits, y_distr, next_tag)
+        next_tag = y_grad.next_tag
+        y = TensorMoments(y_value, y_grad, True)
+        # Create mixture-of-experts layer with all the provided data
+        layer = MoE(x, y, w_gate, w1, w2, probs, probs_maxsumexp, \
+                probs_sumprod_slice, topk_values, topk_indices, experts, \
+                slots, load, importance, buf_in, h, g, buf_out, \
+                aux_loss_coef=aux_loss_coef, redux=redux)
+        # Return layer and next tag to be used
+        return (layer, next_tag)
+
+    # Place tiles of every expert onto ranks[e % len(ranks)]
+    def set_expert_ranks(self, ranks: List[int]):
+        ranks = [ranks[e % len(ranks)] for e in range(self.n_experts)]
+        for t in [self.w1, self.w2, self.buf_in, self.h, self.g, \
+                self.buf_out]:
+            shape = t.value.grid.shape
+            stride = int(np.prod(shape[:2]))
+            distr = [ranks[i//stride] for i in range(t.value.grid.nelems)]
+            t.value.set_distribution(distr)
+            if t.grad is not None:
+                t.grad.set_distribution(distr)
+
+    # Forward propagation of the mixture-of-experts layer
+    def forward_async(self):
+        # Logits of experts of shape (n_experts, n_seq, n_batch)
+        gemm_async(1.0, notrans, self.w_gate.value, notrans, self.x.value, \
+                0.0, self.probs.value, 1, 0, redux=self.redux)
+        # Routing probabilities with softmax over experts
+        clear_async(self.probs_maxsumexp)
+        maxsumexp_async(self.probs.value, self.probs_maxsumexp, 0, \
+                redux=self.redux)
+        softmax_inplace_async(self.probs_maxsumexp, 1.0, self.probs.value, 0)
+        self.probs_maxsumexp.invalidate_submit()
+        # Choices of experts of all the tokens are routed at once
+        topk_async(self.probs.value, self.topk_values, self.topk_indices, 0)
+        self.topk_values.invalidate_submit()
+        gather_async(self.topk_indices, self.experts)
+        self.topk_indices.invalidate_submit()
+        moe_route_async(self.experts, self.slots, self.load)
+        self.experts.invalidate_submit()
+        # Mean probabilities of experts for the load-balancing loss
+        if self.aux_loss_coef != 0:
+            n_tokens = self.x.value.shape[1] * self.x.value.shape[2]
+            sum_fiber_async(1.0/n_tokens, self.probs.value, 0.0, \
+                    self.importance, 0, 0, redux=self.redux)
+        # Tokens are sent to their experts
+        moe_dispatch_async(self.slots, self.x.value, self.buf_in.value)
+        self.x.value.wont_use()
+        # Batched MLPs of experts
+        gemm_async(1.0, notrans, self.w1.value, notrans, self.buf_in.value, \
+                0.0, self.h.value, 1, 1)
+        self.w1.value.wont_use()
+        gelutanh_async(self.h.value, self.g.value)
+        gemm_async(1.0, notrans, self.w2.value, notrans, self.g.value, \
+                0.0, self.buf_out.value, 1, 1)
+        self.w2.value.wont_use()
+        # Outputs of experts, scaled by probabilities, are sent back
+        clear_async(self.y.value)
+        moe_combine_async(self.slots, self.probs.value, self.buf_out.value, \
+                self.y.value)
+        self.y.value.wont_use()
+
+    # Load-balancing loss coef * n_experts * sum(load * importance) of the
+    # last forward pass, where load is the fraction of choices, taken by an
+    # expert, and importance is the mean routing probability of an expert.
+    # It equals coef for perfectly balanced routing.
+    def get_aux_loss(self) -> float:
+        if self.aux_loss_coef == 0:
+            return 0.0
+        dtype = np.float32 if type(self.load) is Tensor_fp32 else np.float64
+        load = np.zeros(self.load.shape, order="F", dtype=dtype)
+        importance = np.zeros_like(load)
+        self.load.to_array(load)
+        self.importance.to_array(importance)
+        return float(self.aux_loss_coef * self.n_experts \
+                * np.dot(load, importance))
+
+    # Backward propagation of the mixture-of-experts layer
+    def backward_async(self):
+        # Gradients of outputs of experts and of routing probabilities
+        clear_async(self.probs.grad)
+        moe_combine_backward_async(self.slots, self.probs.value, \
+                self.buf_out.value, self.y.grad, self.buf_out.grad, \
+                self.probs.grad)
+        self.buf_out.value.invalidate_submit()
+        self.y.grad.wont_use()
+        # Gradient of the load-balancing loss, where load is a constant
+        if self.aux_loss_coef != 0:
+            n_tokens = self.x.value.shape[1] * self.x.value.shape[2]
+            add_fiber_async(self.aux_loss_coef*self.n_experts/n_tokens, \
+                    self.load, 1.0, self.probs.grad, 0, 0)
+        # Batched MLPs of experts
+        gemm_async(1.0, notrans, self.buf_out.grad, trans, self.g.value, \
+                1.0, self.w2.grad, 1, 1)
+        self.g.value.invalidate_submit()
+        gemm_async(1.0, trans, self.w2.value, notrans, self.buf_out.grad, \
+                0.0, self.g.grad, 1, 1)
+        self.buf_out.grad.invalidate_submit()
+        self.w2.value.wont_use()
+        clear_async(self.h.grad)
+        gelutanh_backward_async(self.h.value, self.g.grad, self.h.grad)
+        self.h.value.invalidate_submit()
+        self.g.grad.invalidate_submit()
+        gemm_async(1.0, notrans, self.h.grad, trans, self.buf_in.value, \
+                1.0, self.w1.grad, 1, 1)
+        self.buf_in.value.invalidate_submit()
+        gemm_async(1.0, trans, self.w1.value, notrans, self.h.grad, \
+                0.0, self.buf_in.grad, 1, 1)
+        self.h.grad.invalidate_submit()
+        self.w1.value.wont_use()
+        # Gradients of dispatched tokens are sent back
+        if self.x.grad_required:
+            moe_dispatch_backward_async(self.slots, self.buf_in.grad, \
+                    self.x.grad)
+        self.buf_in.grad.invalidate_submit()
+        self.slots.invalidate_submit()
+        # Backward of softmax over experts turns into gradient over logits
+        sumprod_slice_async(1.0, self.probs.value, self.probs.grad, 0.0, \
+                self.probs_sumprod_slice, 0, redux=self.redux)
+        add_slice_async(-1.0, self.probs_sumprod_slice, 1.0, \
+                self.probs.grad, 0)
+        self.probs_sumprod_slice.invalidate_submit()
+        prod_async(self.probs.value, self.probs.grad)
+        self.probs.value.invalidate_submit()
+        # Gradients of the router and of the input
+        gemm_async(1.0, notrans, self.probs.grad, trans, self.x.value, 1.0, \
+                self.w_gate.grad, 2, 0, redux=self.redux)
+        self.x.value.wont_use()
+        if self.x.grad_required:
+            gemm_async(1.0, trans, self.w_gate.value, notrans, \
+                    self.probs.grad, 1.0, self.x.grad, 1, 0, \
+                    redux=self.redux)
+            self.x.grad.wont_use()
+        self.probs.grad.invalidate_submit()
+        self.w_gate.value.wont_use()
+
@@ -0,0 +1,190 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/layer/rms_norm.py
+# RMSNorm layer of NNTile Python package
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+from nntile.tensor import TensorTraits, Tensor, TensorMoments, \
+        fill_async, copy_async, axpy_async, prod_slice_async, \
+        prod_fiber3_async, sumprod_slice_async, sumprod_fiber_async, \
+        rms_norm_async, rms_norm_backward_async
+from nntile.layer.base_layer import BaseLayer, cpp_class, cpp_moments
+
+class RMSNorm(BaseLayer):
+    x: TensorMoments
+    y: TensorMoments
+    gamma: TensorMoments
+    tmp_y_value: Tensor
+    tmp_y_grad: Tensor
+    inv_rms: Tensor
+    mean_gx: Tensor
+    axis: int
+    eps: float
+
+    # Construct root mean square normalization layer with all the provided
+    # data. Root mean square of a fiber is computed by a single task, so the
+    # axis shall not be split into tiles.
+    def __init__(self, x: TensorMoments, y: TensorMoments, \
+            gamma: TensorMoments, tmp_y_value: Tensor, tmp_y_grad: Tensor, \
+            inv_rms: Tensor, mean_gx: Tensor, axis: int, eps: float, \
+            redux: bool=False):
+        if x.value.grid.shape[axis] != 1:
+            raise ValueError("Axis of normalization shall not be split " \
+                    "into tiles")
+        # Redirect to BaseLayer initialization
+        super().__init__([x], [y], [gamma], [tmp_y_value, tmp_y_grad, \
+                inv_rms, mean_gx])
+        self.x = x
+        self.y = y
+        self.gamma = gamma
+        self.gamma.grad.set_reduction_add()
+        self.tmp_y_value = tmp_y_value
+        self.tmp_y_grad = tmp_y_grad
+        self.inv_rms = inv_rms
+        self.mean_gx = mean_gx
+        self.mean_gx.set_reduction_add()
+        self.axis = axis
+        self.l = self.x.value.shape[axis]
+        self.eps = eps
+        if redux:
+            self.redux = 1
+        else:
+            self.redux = 0
+
+    # Backward of the fused kernel accumulates gradient of gamma on the node
+    # of every tile of grad X. Distributions are checked at every call, as
+    # models may assign ranks to layers after they are generated.
+    @property
+    def fused_backward(self) -> bool:
+        if self.x.grad is None:
+            return False
+        rank = self.gamma.grad.distribution[0]
+        return all(r == rank for r in self.x.grad.distribution)
+
+    # Simple generator for the normalization layer
+    @staticmethod
+    def generate_simple(x: TensorMoments, axis: int, eps: float, \
+            next_tag: int, redux: bool=False):
+        # Get traits of X
+        x_traits = TensorTraits(x.value.shape, x.value.basetile_shape)
+        # Create Y with the same traits and distribution as X
+        x_distr = x.value.distribution
+        y_value = type(x.value)(x_traits, x_distr, next_tag)
+        next_tag = y_value.next_tag
+        y_grad = type(x.value)(x_traits, x_distr, next_tag)
+        next_tag = y_grad.next_tag
+        y = TensorMoments(y_value, y_grad, True)
+        # Gamma parameter is owned by the node of the first tile of X
+        gamma_traits = TensorTraits([x.value.shape[axis]], \
+                [x.value.basetile_shape[axis]])
+        gamma_distr = [x_distr[0]]
+        gamma_value = type(x.value)(gamma_traits, gamma_distr, next_tag)
+        next_tag = gamma_value.next_tag
+        gamma_grad = type(x.value)(gamma_traits, gamma_distr, next_tag)
+        next_tag = gamma_grad.next_tag
+        gamma = TensorMoments(gamma_value, gamma_grad, True)
+        # Temporary tensors for the backward without the fused kernel
+        tmp_y_value = type(x.value)(x_traits, x_distr, next_tag)
+        next_tag = tmp_y_value.next_tag
+        tmp_y_grad = type(x.value)(x_traits, x_distr, next_tag)
+        next_tag = tmp_y_grad.next_tag
+        # Inverses of root mean squares are distributed as the corresponding
+        # tiles of X
+        rms_shape = x.value.shape[:axis] + x.value.shape[axis+1:]
+        rms_basetile = x.value.basetile_shape[:axis] \
+                + x.value.basetile_shape[axis+1:]
+        rms_traits = TensorTraits(rms_shape, rms_basetile)
+        rms_distr = []
+        for i in range(rms_traits.grid.nelems):
+            rms_tile_index = rms_traits.grid.linear_to_index(i)
+            x_tile_index = rms_tile_index[0:axis] + [0] \
+                    + rms_tile_index[axis:]
+            x_tile_offset = x.value.grid.index_to_linear(x_tile_index)
+            rms_distr.append(x_distr[x_tile_offset])
+        inv_rms = type(x.value)(rms_traits, rms_distr, next_tag)
+        next_tag = inv_rms.next_tag
+        mean_gx = type(x.value)(rms_traits, rms_distr, next_tag)
+        next_tag = mean_gx.next_tag
+        # Create RMSNorm object with all the provided tensors
+        layer = RMSNorm(x, y, gamma, tmp_y_value, tmp_y_grad, inv_rms, \
+                mean_gx, axis, eps, redux=redux)
+        # Init gamma
+        fill_async(1.0, gamma.value)
+        # Return layer and next tag to be used
+        return (layer, next_tag)
+
+    # Forward propagation of the normalization layer
+    def forward_async(self):
+        # Normalize and scale input by a single task per tile
+        rms_norm_async(self.eps, self.x.value, self.gamma.value, \
+                self.inv_rms, self.y.value, self.axis)
+        # Inverses of root mean squares are needed only by the backward
+        self.inv_rms.wont_use()
+        # X, gamma and Y can be offloaded from GPU
+        self.x.value.wont_use()
+        self.gamma.value.wont_use()
+        self.y.value.wont_use()
+
+    # C++ counterpart of the layer
+    def to_cpp(self):
+        cls = cpp_class("RMSNorm", self.x.value)
+        moments = [cpp_moments(t) for t in (self.x, self.y, self.gamma)]
+        if cls is None or not self.fused_backward or None in moments:
+            return None
+        return cls(*moments, self.inv_rms, self.axis, self.eps, self.redux)
+
+    # Backward propagation of the normalization layer
+    def backward_async(self):
+        if self.fused_backward:
+            # Normalized input is recomputed from X and inv_rms
+            rms_norm_backward_async(self.x.value, self.y.grad, \
+                    self.gamma.value, self.inv_rms, self.x.grad, \
+                    self.gamma.grad, self.axis, redux=self.redux)
+            # inv_rms can be deleted
+            self.inv_rms.invalidate_submit()
+            # X, dY, gamma and all the gradients can be offloaded from GPU
+            self.x.value.wont_use()
+            self.y.grad.wont_use()
+            self.gamma.value.wont_use()
+            self.x.grad.wont_use()
+            self.gamma.grad.wont_use()
+            return
+        # Normalized input
+        copy_async(self.x.value, self.tmp_y_value)
+        prod_slice_async(self.inv_rms, 1.0, self.tmp_y_value, self.axis)
+        # X can be offloaded from GPU
+        self.x.value.wont_use()
+        # Accumulate gradient over gamma
+        sumprod_fiber_async(1.0, self.y.grad, self.tmp_y_value, 1.0, \
+                self.gamma.grad, self.axis, redux=self.redux)
+        self.gamma.grad.wont_use()
+        if self.x.grad is None:
+            self.inv_rms.invalidate_submit()
+            self.tmp_y_value.invalidate_submit()
+            return
+        # Define gradient over normalized input
+        prod_fiber3_async(self.gamma.value, 1.0, self.y.grad, \
+                self.tmp_y_grad, self.axis)
+        self.y.grad.wont_use()
+        self.gamma.value.wont_use()
+        # Minus mean of product of the gradient and normalized input
+        sumprod_slice_async(-1.0/self.l, self.tmp_y_grad, self.tmp_y_value, \
+                0.0, self.mean_gx, self.axis, redux=self.redux)
+        prod_slice_async(self.mean_gx, 1.0, self.tmp_y_value, self.axis)
+        self.mean_gx.invalidate_submit()
+        axpy_async(1.0, self.tmp_y_grad, self.tmp_y_value)
+        self.tmp_y_grad.invalidate_submit()
+        # Multiply by inverses of root mean squares and accumulate
+        prod_slice_async(self.inv_rms, 1.0, self.tmp_y_value, self.axis)
+        self.inv_rms.invalidate_submit()
+        axpy_async(1.0, self.tmp_y_value, self.x.grad)
+        self.tmp_y_value.invalidate_submit()
+        self.x.grad.wont_use()
+
@@ -0,0 +1,73 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/layer/swiglu.py
+# SwiGLU activation of gated MLP of NNTile Python package
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+from nntile.tensor import TensorTraits, TensorMoments, swiglu_async, \
+        swiglu_backward_async
+from nntile.layer.base_layer import BaseLayer
+
+class SwiGLU(BaseLayer):
+    gate: TensorMoments
+    up: TensorMoments
+    y: TensorMoments
+
+    # Construct SiLU-gated product Y = SiLU(gate) * up of outputs of two
+    # up-projections of a gated MLP, that share shape and tiling. Neither
+    # activation of the gate nor its gradient is stored, as both are
+    # recomputed by the fused kernels within the single pass over tiles.
+    def __init__(self, gate: TensorMoments, up: TensorMoments, \
+            y: TensorMoments):
+        # Gradients of both inputs are accumulated by the same task
+        if gate.grad_required != up.grad_required:
+            raise ValueError("Gradients are required either for both gate " \
+                    "and up or for none of them")
+        # Redirect to BaseLayer initialization
+        super().__init__([gate, up], [y], [], [])
+        self.gate = gate
+        self.up = up
+        self.y = y
+
+    # Simple generator for the SwiGLU layer
+    @staticmethod
+    def generate_simple(gate: TensorMoments, up: TensorMoments, \
+            next_tag: int):
+        # Create Y with the same traits and distribution as the gate
+        y_traits = TensorTraits(gate.value.shape, gate.value.basetile_shape)
+        y_value = type(gate.value)(y_traits, gate.value.distribution, \
+                next_tag)
+        next_tag = y_value.next_tag
+        y_grad = type(gate.value)(y_traits, gate.value.distribution, \
+                next_tag)
+        next_tag = y_grad.next_tag
+        y = TensorMoments(y_value, y_grad, True)
+        layer = SwiGLU(gate, up, y)
+        # Return layer and next tag to be used
+        return (layer, next_tag)
+
+    # Forward propagation of the SwiGLU layer
+    def forward_async(self):
+        swiglu_async(self.gate.value, self.up.value, self.y.value)
+        self.gate.value.wont_use()
+        self.up.value.wont_use()
+        self.y.value.wont_use()
+
+    # Backward propagation of the SwiGLU layer
+    def backward_async(self):
+        if self.gate.grad_required:
+            swiglu_backward_async(self.gate.value, self.up.value, \
+                    self.y.grad, self.gate.grad, self.up.grad)
+            self.gate.value.wont_use()
+            self.up.value.wont_use()
+            self.y.grad.wont_use()
+            self.gate.grad.wont_use()
+            self.up.grad.wont_use()
+
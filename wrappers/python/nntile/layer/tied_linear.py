@@ -0,0 +1,89 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/layer/tied_linear.py
+# Linear layer with a weight of an embedding layer of NNTile Python package
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+from nntile.tensor import TensorTraits, TensorMoments, notrans, trans, \
+        gemm_async, gemm_ex_async, background_priority
+from nntile.layer.base_layer import BaseLayer
+
+class TiedLinear(BaseLayer):
+    x: TensorMoments
+    y: TensorMoments
+    w: TensorMoments
+
+    # Construct linear layer Y = einsum('ji,jk->ik', W, X) without bias, that
+    # reuses vocabulary W of shape (n_emb, vocab_size) of an embedding layer
+    # (e.g., a head of a language model with tied embeddings). W is not a
+    # parameter of this layer, as it is owned by the embedding layer, so the
+    # optimizer keeps a single state for it. Gradients over W of both layers
+    # are accumulated into the same tensor.
+    def __init__(self, x: TensorMoments, y: TensorMoments, w: TensorMoments, \
+            fp32_fast_tf32: bool=False, redux: bool=False):
+        if x.value.basetile_shape[0] != w.value.basetile_shape[0]:
+            raise ValueError("Embedding dimension of X and W shall be " \
+                    "tiled in the same way")
+        # Embedding layers mark only rows of their tokens
+        if getattr(w, "rows", None) is not None:
+            raise ValueError("Tied weight cannot have a sparse gradient")
+        # Redirect to BaseClass initialization
+        super().__init__([x], [y], [], [])
+        self.x = x
+        if self.x.grad is not None:
+            self.x.grad.set_reduction_add()
+        self.y = y
+        self.y.value.set_reduction_add()
+        self.w = w
+        self.w.grad.set_reduction_add()
+        self.gemm = gemm_ex_async if fp32_fast_tf32 else gemm_async
+        self.redux = 1 if redux else 0
+
+    # Simple generator for the layer
+    @staticmethod
+    def generate_simple(x: TensorMoments, w: TensorMoments, next_tag: int, \
+            fp32_fast_tf32: bool=False, redux: bool=False):
+        y_shape = w.value.shape[1:] + x.value.shape[1:]
+        y_basetile = w.value.basetile_shape[1:] + x.value.basetile_shape[1:]
+        y_traits = TensorTraits(y_shape, y_basetile)
+        y_distr = [0] * y_traits.grid.nelems
+        y_value = type(x.value)(y_traits, y_distr, next_tag)
+        next_tag = y_value.next_tag
+        y_grad = type(x.value)(y_traits, y_distr, next_tag)
+        next_tag = y_grad.next_tag
+        y = TensorMoments(y_value, y_grad, True)
+        layer = TiedLinear(x, y, w, fp32_fast_tf32, redux)
+        return (layer, next_tag)
+
+    # Forward propagation of the layer
+    def forward_async(self):
+        self.gemm(1.0, trans, self.w.value, notrans, self.x.value, 0.0, \
+                self.y.value, 1, 0, redux=self.redux)
+        self.w.value.wont_use()
+        self.x.value.wont_use()
+        self.y.value.wont_use()
+
+    # Backward propagation of the layer
+    def backward_async(self):
+        if self.w.grad_required:
+            # dW += einsum('jk,ik->ji', X, dY)
+            self.gemm(1.0, notrans, self.x.value, trans, self.y.grad, 1.0, \
+                    self.w.grad, self.x.value.ndim-1, 0, redux=self.redux, \
+                    priority=background_priority())
+            self.w.grad.wont_use()
+        if self.x.grad_required:
+            # dX += einsum('ji,ik->jk', W, dY)
+            self.gemm(1.0, notrans, self.w.value, notrans, self.y.grad, 1.0, \
+                    self.x.grad, 1, 0, redux=self.redux)
+            self.x.grad.wont_use()
+        self.w.value.wont_use()
+        self.x.value.wont_use()
+        self.y.grad.wont_use()
+
@@ -0,0 +1,192 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/loader.py
+# Streaming loader of training batches from memory-mapped files
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-08
+
+from nntile.tensor import TensorTraits, Tensor_int64
+from nntile.nntile_core.tensor import TokenFile, load_tokens_async
+from concurrent.futures import ThreadPoolExecutor
+import numpy as np
+from typing import List, Union
+
+class MemmapLoader(object):
+    """Loader of tokens, that streams batches from a memory-mapped array
+
+    Tokens are stored in a 4-dimensional array of shape [num_batches,
+    num_minibatch, minibatch_size, seq_len+1], e.g., in a .npy file produced
+    by np.save from the token array of gpt2_training.py. Inputs of a sequence
+    are its first seq_len tokens, while labels are its last seq_len tokens.
+
+    Minibatches are loaded into staging tensors, that are allocated by StarPU
+    in pinned memory if CUDA workers are present. There are num_buffers sets
+    of staging tensors: while Pipeline submits tasks for the current batch,
+    a background thread reads the next batch from the file and puts it into
+    the next set of staging tensors. Iterating over the loader yields pairs
+    of lists of input and label tensors, so it can be passed as x argument
+    of Pipeline with y=None.
+    """
+    def __init__(self, tokens: Union[str, np.ndarray], seq_len_tile: int, \
+            minibatch_size_tile: int, next_tag: int, num_buffers: int=2):
+        if num_buffers < 2:
+            raise ValueError("num_buffers must be at least 2")
+        if type(tokens) is str:
+            tokens = np.load(tokens, mmap_mode="r")
+        if tokens.ndim != 4:
+            raise ValueError("Array of tokens must be 4-dimensional")
+        self.tokens = tokens
+        num_batches, num_minibatch, minibatch_size, seq_len = tokens.shape
+        seq_len -= 1
+        self.num_batches = num_batches
+        self.num_minibatch = num_minibatch
+        x_traits = TensorTraits([seq_len, minibatch_size], \
+                [seq_len_tile, minibatch_size_tile])
+        x_distr = [0] * x_traits.grid.nelems
+        self.buffers = []
+        for i in range(num_buffers):
+            xs = []
+            ys = []
+            for j in range(num_minibatch):
+                x = Tensor_int64(x_traits, x_distr, next_tag)
+                next_tag = x.next_tag
+                xs.append(x)
+                y = Tensor_int64(x_traits, x_distr, next_tag)
+                next_tag = y.next_tag
+                ys.append(y)
+            self.buffers.append((xs, ys))
+        self.next_tag = next_tag
+        self.executor = ThreadPoolExecutor(max_workers=1)
+
+    def get_next_tag(self):
+        return self.next_tag
+
+    def __len__(self):
+        return self.num_batches
+
+    # Read a batch from the file into a set of staging tensors. Copying into
+    # tensors waits for tasks, that still read previous contents of the
+    # staging tensors, without holding GIL.
+    def _load(self, i_batch: int, i_buffer: int):
+        xs, ys = self.buffers[i_buffer]
+        for j in range(self.num_minibatch):
+            seqs = np.asarray(self.tokens[i_batch, j])
+            xs[j].from_array(np.asfortranarray(seqs[:, :-1].T))
+            ys[j].from_array(np.asfortranarray(seqs[:, 1:].T))
+
+    def __iter__(self):
+        num_buffers = len(self.buffers)
+        if self.num_batches == 0:
+            return
+        future = self.executor.submit(self._load, 0, 0)
+        for i_batch in range(self.num_batches):
+            future.result()
+            # Staging tensors of the next batch were last used by the batch,
+            # whose tasks are already submitted
+            if i_batch+1 < self.num_batches:
+                future = self.executor.submit(self._load, i_batch+1, \
+                        (i_batch+1) % num_buffers)
+            yield self.buffers[i_batch % num_buffers]
+
+    def unregister(self):
+        self.executor.shutdown(wait=True)
+        for xs, ys in self.buffers:
+            for x in xs+ys:
+                x.unregister()
+
+class TokenFileLoader(object):
+    """Loader of random windows of tokens of a flat binary file
+
+    The file is a concatenation of tokens of all documents of a corpus
+    without any header, e.g., written by tokens.astype(np.uint16).tofile().
+    It is mapped into memory by the C++ core (see nntile.tensor.TokenFile),
+    so corpora of many gigabytes open instantly and there is no tokenization
+    or any other Python code on the critical path of training.
+
+    Every sequence is a window of seq_len+1 tokens at a random position,
+    drawn from the seed, the index of the batch and the index of the
+    sequence, so the order of batches is reproducible. Inputs of a sequence
+    are its first seq_len tokens, while labels are its last seq_len tokens.
+    Tiles of staging tensors are filled by tasks on CPU workers. There are
+    num_buffers sets of staging tensors, so tasks, that load the next batch,
+    are submitted before the current batch is yielded, and they run in
+    parallel with computations of the current batch. Iterating over the
+    loader yields pairs of lists of input and label tensors, so it can be
+    passed as x argument of Pipeline with y=None.
+    """
+    def __init__(self, path: str, seq_len: int, seq_len_tile: int, \
+            minibatch_size: int, minibatch_size_tile: int, \
+            num_minibatch: int, num_batches: int, next_tag: int, \
+            dtype: str="uint16", seed: int=0, num_buffers: int=2):
+        if num_buffers < 2:
+            raise ValueError("num_buffers must be at least 2")
+        self.file = TokenFile(path, dtype)
+        if self.file.ntokens <= seq_len:
+            raise ValueError("File contains too few tokens")
+        if num_batches <= 0:
+            # The same number of tokens, as in the file
+            num_batches = self.file.ntokens // ((seq_len+1) \
+                    * minibatch_size * num_minibatch)
+        self.num_batches = num_batches
+        self.num_minibatch = num_minibatch
+        self.seed = seed
+        self.epoch = 0
+        x_traits = TensorTraits([seq_len, minibatch_size], \
+                [seq_len_tile, minibatch_size_tile])
+        x_distr = [0] * x_traits.grid.nelems
+        self.buffers = []
+        for i in range(num_buffers):
+            xs = []
+            ys = []
+            for j in range(num_minibatch):
+                x = Tensor_int64(x_traits, x_distr, next_tag)
+                next_tag = x.next_tag
+                xs.append(x)
+                y = Tensor_int64(x_traits, x_distr, next_tag)
+                next_tag = y.next_tag
+                ys.append(y)
+            self.buffers.append((xs, ys))
+        self.next_tag = next_tag
+
+    def get_next_tag(self):
+        return self.next_tag
+
+    def __len__(self):
+        return self.num_batches
+
+    # Submit tasks, that load a batch into a set of staging tensors. Every
+    # minibatch of every epoch gets its own windows.
+    def _load(self, i_batch: int, i_buffer: int):
+        xs, ys = self.buffers[i_buffer]
+        for j in range(self.num_minibatch):
+            step = (self.epoch*self.num_batches+i_batch)*self.num_minibatch \
+                    + j
+            load_tokens_async(self.file, self.seed, step, 0, xs[j])
+            load_tokens_async(self.file, self.seed, step, 1, ys[j])
+
+    def __iter__(self):
+        num_buffers = len(self.buffers)
+        if self.num_batches == 0:
+            return
+        self._load(0, 0)
+        for i_batch in range(self.num_batches):
+            # Staging tensors of the next batch were last used by the batch,
+            # whose tasks are already submitted
+            if i_batch+1 < self.num_batches:
+                self._load(i_batch+1, (i_batch+1) % num_buffers)
+            yield self.buffers[i_batch % num_buffers]
+        self.epoch += 1
+
+    def unregister(self):
+        # Unregistration of staging tensors waits for tasks, that read the
+        # file, so it is closed afterwards
+        for xs, ys in self.buffers:
+            for x in xs+ys:
+                x.unregister()
+        self.file.close()
@@ -14,7 +14,7 @@
 
 from nntile.tensor import softmax_async, clear_async, copy_async, \
         subtract_indexed_outputs_async, logsumexp_async, maxsumexp_async, \
-        total_sum_accum_async, scal_inplace_async
+        total_sum_accum_async, scal_inplace_async, softmax_crossentropy_async
 from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
         Tensor_int64
 import numpy as np
@@ -49,19 +49,21 @@ class CrossEntropy:
             redux: bool=False, scale: float=1.0) -> tuple:
         shape = model_output.value.shape[1:]
         basetile = model_output.value.basetile_shape[1:]
+        # Logits can be tiled along the vocabulary, while labels follow the
+        # first tile of each column of tiles
+        nchunks = model_output.value.grid.shape[0]
+        distr = model_output.value.distribution[::nchunks]
         labels_traits = TensorTraits(shape, basetile)
-        labels = Tensor_int64(labels_traits, model_output.value.distribution, \
-                next_tag)
+        labels = Tensor_int64(labels_traits, distr, next_tag)
         next_tag = labels.next_tag 
         maxsumexp_traits = TensorTraits([2]+shape, [2]+basetile)
-        maxsumexp = type(model_output.value)(maxsumexp_traits, \
-                model_output.value.distribution, next_tag)
+        maxsumexp = type(model_output.value)(maxsumexp_traits, distr, \
+                next_tag)
         next_tag = maxsumexp.next_tag
         val_traits = TensorTraits([], [])
         val = type(model_output.value)(val_traits, [0], next_tag)
         next_tag = val.next_tag
-        logsumexp = type(model_output.value)(labels_traits, \
-                model_output.value.distribution, next_tag)
+        logsumexp = type(model_output.value)(labels_traits, distr, next_tag)
         next_tag = logsumexp.next_tag
         loss = CrossEntropy(model_output, labels, val, maxsumexp, logsumexp, \
                 redux=redux, scale=scale)
@@ -79,19 +81,21 @@ class CrossEntropy:
     def get_grad(self, grad_np):
         self.model_output.grad.to_array(grad_np)
 
-    # Get value and gradient if needed
+    # Get value and gradient if needed. Gradient is computed together with
+    # the value by a fused kernel, that reads logits only once after the
+    # maxsumexp pass and supports logits tiled along the vocabulary.
     def calc_async(self):
         clear_async(self.maxsumexp)
         maxsumexp_async(self.model_output.value, self.maxsumexp, 0, \
                 redux=self.redux)
-        logsumexp_async(self.maxsumexp, self.logsumexp)
-        total_sum_accum_async(self.scale, self.logsumexp, \
-                self.model_output.value, self.y, self.val)
         if self.model_output.grad_required is True:
-            softmax_async(self.maxsumexp, self.model_output.value, \
-                    self.scale, self.model_output.grad, 0)
-            subtract_indexed_outputs_async(self.scale, self.y, \
-                    self.model_output.grad)
+            softmax_crossentropy_async(self.scale, self.maxsumexp, \
+                    self.model_output.value, self.y, self.model_output.grad, \
+                    self.val)
+        else:
+            logsumexp_async(self.maxsumexp, self.logsumexp)
+            total_sum_accum_async(self.scale, self.logsumexp, \
+                    self.model_output.value, self.y, self.val)
         self.model_output.value.wont_use()
         self.model_output.grad.wont_use()
         self.maxsumexp.wont_use()
@@ -0,0 +1,138 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/memory_planner.py
+# Liveness analysis of temporaries of layers of a model
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+"""Liveness analysis of temporaries of layers of a model
+
+Temporaries of every layer are separate tensors, that keep their memory for
+the whole lifetime of the model, although most of them are used only by the
+forward or by the backward propagation of their layer. The planner records
+operations of forward and backward of every layer without submitting them
+(see nntile.graph.TaskGraph) and finds the tensors, that every stage uses.
+A step of training runs stages in order forward of layers 0, ..., n-1 and
+backward of layers n-1, ..., 0, so a temporary is alive from its first till
+its last use within a step.
+
+The model invalidates every temporary right after the stage of its last use
+(see BaseModel.plan_memory). StarPU puts memory of invalidated tiles into
+its cache of allocations, that serves new allocations of the same size, so
+temporaries with non-overlapping lifetimes, e.g., temporaries of attention
+layers of a deep GPT2, share the same buffers. As with activation
+checkpointing, forward of a layer shall not depend on the previous state of
+its temporaries. Temporaries of layers, that cannot be recorded (e.g., they
+read tensors during forward), are kept for the whole step.
+"""
+
+from .graph import TaskGraph
+from .checkpoint import _dtypes
+from nntile.tensor import TensorMoments
+from typing import Dict, List, Tuple
+
+# Stage of a step of training as an index of a layer and a direction
+Stage = Tuple[int, str]
+
+def _collect(x, found: Dict):
+    if isinstance(x, (list, tuple)):
+        for y in x:
+            _collect(y, found)
+    elif type(x) in _dtypes:
+        found[id(x)] = x
+
+def _temporaries(l) -> Dict:
+    found = {}
+    for t in l.temporaries:
+        if type(t) is TensorMoments:
+            t = [t.value, t.grad]
+        _collect(t, found)
+    return found
+
+def _nbytes(x) -> int:
+    return x.nelems * _dtypes[type(x)][1]
+
+class MemoryPlan(object):
+    """Stages of last uses of temporaries of a model
+
+    Attributes:
+        retire: temporaries to invalidate after every stage
+        total_bytes: size of all the used temporaries
+        peak_bytes: maximal size of alive temporaries during a step
+    """
+
+    def __init__(self):
+        self.retire: Dict[Stage, List] = {}
+        self.total_bytes = 0
+        self.peak_bytes = 0
+
+    @property
+    def nretired(self) -> int:
+        return sum(len(x) for x in self.retire.values())
+
+    def report(self) -> str:
+        return "Temporaries of {:.1f} MB, {} tensors are retired, planned " \
+                "peak {:.1f} MB".format(self.total_bytes/2**20, \
+                self.nretired, self.peak_bytes/2**20)
+
+
+def _used_tensors(stage_async) -> Dict:
+    graph = TaskGraph()
+    with graph.capture(submit=False):
+        stage_async()
+    found = {}
+    for op, args, kwargs in graph.ops:
+        _collect(args, found)
+        _collect(list(kwargs.values()), found)
+    return found
+
+def plan_temporaries(layers: List) -> MemoryPlan:
+    """Find the last stage of a step of training, that uses each temporary"""
+    nlayers = len(layers)
+    # Temporaries by ids, counted once if layers share them
+    temporaries = {}
+    for l in layers:
+        temporaries.update(_temporaries(l))
+    # Positions of stages within a step
+    stages = [(i, "forward") for i in range(nlayers)] + \
+            [(i, "backward") for i in reversed(range(nlayers))]
+    first = {}
+    last = {}
+    kept = set()
+    for pos, (i, direction) in enumerate(stages):
+        l = layers[i]
+        # Layers, that read tensors or depend on results of operations,
+        # cannot be recorded
+        try:
+            used = _used_tensors(getattr(l, direction+"_async"))
+        except Exception:
+            kept.update(_temporaries(l))
+            continue
+        for key in used:
+            if key in temporaries:
+                first.setdefault(key, pos)
+                last[key] = pos
+    plan = MemoryPlan()
+    alive = [0] * len(stages)
+    for key, t in temporaries.items():
+        # Unused temporaries are never allocated
+        if key not in first and key not in kept:
+            continue
+        size = _nbytes(t)
+        plan.total_bytes += size
+        if key in kept:
+            start, end = 0, len(stages)-1
+        else:
+            start, end = first[key], last[key]
+            plan.retire.setdefault(stages[end], []).append(t)
+        for pos in range(start, end+1):
+            alive[pos] += size
+    plan.peak_bytes = max(alive, default=0)
+    return plan
+
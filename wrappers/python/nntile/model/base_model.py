@@ -13,7 +13,14 @@
 
 from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
         clear_async
-from nntile.layer.base_layer import BaseLayer
+from nntile.layer.base_layer import BaseLayer, cpp_type
+from nntile.layer.linear import Linear
+from nntile.layer.linear_crossentropy import LinearCrossEntropy
+from nntile.nntile_core import starpu as core_starpu
+from nntile.nntile_core import tensor as core_tensor
+from nntile.nntile_core import layer as core_layer
+from nntile.profiler import LayerProfiler
+from nntile.memory_planner import MemoryPlan, plan_temporaries
 import numpy as np
 from typing import List
 
@@ -30,22 +37,444 @@ class BaseModel:
         self.parameters = []
         for l in layers:
             self.parameters.extend(l.parameters)
+        self.checkpoints = []
+        # Prefetch parameters of the next layer (see _prefetch_layer)
+        self.prefetch = True
+        self.cpp_submission = False
+        self.cpp_chains = {}
+        self.cpp_chain_ends = {}
+        self.memory_plan = None
+        self.inference = False
+        self.offload_layers = []
+        self.offload_after = {}
+        self.offload_before = {}
 
     # Add a new layer with corresponding new activations
     def append(self, layer: BaseLayer):
         self.activations.append(layer.activations_output)
         self.layers.append(layer)
         self.parameters.append(layer.parameters)
+        if self.checkpoints:
+            self.set_checkpoints(self.checkpoints)
+        elif self.cpp_submission:
+            self.set_cpp_submission()
+        if self.memory_plan is not None:
+            self.plan_memory()
+        if self.offload_layers:
+            self.set_offload(self.offload_layers, self.offload_lookahead)
+
+    # Set activation checkpointing policy. Layers are split into segments,
+    # that start at the provided indices of layers. Values of activations,
+    # that are used only within a segment, and of temporaries of its layers
+    # are invalidated after forward propagation of the segment, so StarPU
+    # can reuse their memory. Backward propagation recomputes them by the
+    # forward propagation of the segment right before its backward
+    # propagation. Therefore, forward of any layer shall not depend on its
+    # previous state. Empty list of checkpoints disables checkpointing.
+    def set_checkpoints(self, checkpoints: List[int]):
+        checkpoints = sorted(set(checkpoints))
+        nlayers = len(self.layers)
+        for i in checkpoints:
+            if i <= 0 or i >= nlayers:
+                raise ValueError("Checkpoint shall be an index of a layer " \
+                        "in range [1, {})".format(nlayers))
+        self.checkpoints = checkpoints
+        bounds = [0] + checkpoints + [nlayers]
+        self.segments = list(zip(bounds[:-1], bounds[1:]))
+        # Segment of the last layer, consuming each activation
+        last_consumer = {}
+        for i_seg, (start, end) in enumerate(self.segments):
+            for l in self.layers[start:end]:
+                for x in l.activations_input:
+                    last_consumer[id(x)] = i_seg
+        # Activations, produced and consumed by the same segment only.
+        # Outputs of the model (with no consumers) are kept.
+        self.segment_activations = []
+        for i_seg, (start, end) in enumerate(self.segments):
+            internal = []
+            for l in self.layers[start:end]:
+                for y in l.activations_output:
+                    if last_consumer.get(id(y), -1) == i_seg:
+                        internal.append(y)
+            self.segment_activations.append(internal)
+        # Values, shared with kept activations (e.g., input of an in-place
+        # activation layer), are kept as well
+        internal_ids = set(id(x) for internal in self.segment_activations \
+                for x in internal)
+        kept_values = set(id(x.value) for x in self.activations \
+                if id(x) not in internal_ids)
+        self.segment_activations = [[x for x in internal \
+                if id(x.value) not in kept_values] \
+                for internal in self.segment_activations]
+        # Chains of C++ layers shall not cross checkpoints
+        if self.cpp_submission:
+            self.set_cpp_submission()
+        # Recomputed activations are not offloaded
+        if self.offload_layers:
+            self.set_offload(self.offload_layers, self.offload_lookahead)
+
+    # Offload values of output activations of the provided layers to host
+    # memory, as an alternative to recomputation. Transfers from GPU are
+    # submitted right after forward of the last layer, that consumes an
+    # activation, and transfers back are prefetched before backward of the
+    # layer, that is lookahead layers after the last consumer, so that they
+    # overlap with backward of the later layers. Layers with C++
+    # counterparts are handled by whole chains. Outputs of the model and
+    # activations, that are recomputed with checkpointing, are not
+    # offloaded. Empty list of layers disables offloading.
+    def set_offload(self, layers: List[int], lookahead: int=2):
+        nlayers = len(self.layers)
+        layers = sorted(set(layers))
+        for i in layers:
+            if i < 0 or i >= nlayers:
+                raise ValueError("Offloaded layer shall be an index of a " \
+                        "layer in range [0, {})".format(nlayers))
+        if lookahead < 0:
+            raise ValueError("lookahead shall be non-negative")
+        self.offload_layers = layers
+        self.offload_lookahead = lookahead
+        # Stages of forward after which and of backward before which values
+        # are transferred
+        self.offload_after = {}
+        self.offload_before = {}
+        last_consumer = {}
+        for i, l in enumerate(self.layers):
+            for x in l.activations_input:
+                last_consumer[id(x.value)] = i
+        # Backward recomputes outputs of all segments but the last one
+        recomputed = set()
+        if self.checkpoints:
+            recomputed = set(id(y.value) for l in \
+                    self.layers[:self.segments[-1][0]] \
+                    for y in l.activations_output)
+        offloaded = set()
+        for i in layers:
+            for y in self.layers[i].activations_output:
+                key = id(y.value)
+                if key not in last_consumer or key in recomputed \
+                        or key in offloaded:
+                    continue
+                offloaded.add(key)
+                consumer = last_consumer[key]
+                self.offload_after.setdefault(consumer, []).append(y.value)
+                prefetch = min(consumer+lookahead, nlayers-1)
+                self.offload_before.setdefault(prefetch, []).append(y.value)
+
+    # Offload values, whose last consumer is in range [start, end)
+    def _offload(self, start: int, end: int):
+        if self.inference:
+            return
+        for i in range(start, end):
+            for x in self.offload_after.get(i, []):
+                x.offload_async()
+
+    # Prefetch offloaded values back before backward of layers in range
+    # [start, end)
+    def _prefetch_offloaded(self, start: int, end: int):
+        for i in reversed(range(start, end)):
+            for x in self.offload_before.get(i, []):
+                x.prefetch_async()
+
+    # Invalidate values of intermediate activations and temporaries of a
+    # segment of layers
+    def _free_segment(self, i_seg: int):
+        for x in self.segment_activations[i_seg]:
+            x.value.invalidate_submit()
+        start, end = self.segments[i_seg]
+        for l in self.layers[start:end]:
+            for t in l.temporaries:
+                if t is None:
+                    continue
+                if type(t) is TensorMoments:
+                    t = t.value
+                if t is not None:
+                    t.invalidate_submit()
+
+    # Invalidate temporaries of layers after the stage of their last use
+    # within a step of training (see nntile.memory_planner), so that
+    # temporaries with non-overlapping lifetimes share memory. Forward of
+    # any layer shall not depend on the previous state of its temporaries.
+    # Returns the plan with the peak memory of temporaries.
+    def plan_memory(self, enable: bool=True) -> MemoryPlan:
+        self.memory_plan = None
+        if not enable:
+            return None
+        self.memory_plan = plan_temporaries(self.layers)
+        return self.memory_plan
+
+    # Invalidate temporaries, whose last use is the given stage of layers in
+    # range [start, end)
+    def _retire(self, start: int, end: int, direction: str):
+        if self.memory_plan is None:
+            return
+        for i in range(start, end):
+            for t in self.memory_plan.retire.get((i, direction), []):
+                t.invalidate_submit()
+
+    # Hint StarPU to prefetch parameters of a layer, so that their transfers
+    # to GPU overlap with computations of the current layer. Gradients are
+    # prefetched for backward propagation.
+    def _prefetch_layer(self, i: int, grads: bool=False):
+        if not self.prefetch or i < 0 or i >= len(self.layers):
+            return
+        for p in self.layers[i].parameters:
+            p.value.prefetch_async()
+            if grads and p.grad is not None and p.grad_required:
+                p.grad.prefetch_async()
+
+    # Submit chains of layers with C++ counterparts (see BaseLayer.to_cpp)
+    # by single calls of nntile_core.layer.Sequential, that release the GIL,
+    # instead of submitting every task from Python. Layers without C++
+    # counterparts are submitted from Python as usual. Chains do not cross
+    # checkpoints and parameters within a chain are not prefetched.
+    def set_cpp_submission(self, enable: bool=True):
+        self.cpp_submission = enable
+        self.cpp_chains = {}
+        self.cpp_chain_ends = {}
+        if not enable:
+            return
+        bounds = set(self.checkpoints)
+        chain_start = 0
+        chain = []
+        chain_type = None
+        for i, l in enumerate(self.layers + [None]):
+            cpp_layer = l.to_cpp() if l is not None else None
+            layer_type = cpp_type(l.activations_output[0].value) \
+                    if cpp_layer is not None else None
+            if cpp_layer is None or i in bounds or layer_type != chain_type:
+                # Single layers are submitted from Python
+                if len(chain) > 1:
+                    seq = getattr(core_layer, "Sequential_"+chain_type)(chain)
+                    self.cpp_chains[chain_start] = (i, seq)
+                    self.cpp_chain_ends[i-1] = (chain_start, seq)
+                chain_start = i
+                chain = []
+                chain_type = layer_type
+            if cpp_layer is not None:
+                chain.append(cpp_layer)
+
+    # Profiler of tasks of layers, submitted within its context, e.g.,
+    #   with model.profile_layers({"CUDA": 60000}) as profiler:
+    #       model.forward_async()
+    #       model.backward_async()
+    #   nntile.starpu.wait_for_all()
+    #   print(profiler.report())
+    def profile_layers(self, peak_gflops=None) -> LayerProfiler:
+        return LayerProfiler(peak_gflops)
+
+    # Scope of traced tasks of layers in range [start, end) (see
+    # nntile.starpu.trace_enable)
+    def _trace_scope(self, start: int, end: int, stage: str):
+        if not core_starpu.trace_is_enabled():
+            return
+        if end-start == 1:
+            name = "{} {}".format(type(self.layers[start]).__name__, start)
+        else:
+            name = "layers {}-{}".format(start, end-1)
+        core_starpu.trace_scope_set("{} {}".format(name, stage))
+
+    # Forward propagation of layers in range [start, end). Tasks of the i-th
+    # layer get priority priority+i, if it is provided. Recomputation of a
+    # segment for backward does not offload activations.
+    def _forward_layers(self, start: int, end: int, priority=None,
+            offload: bool=True):
+        self._prefetch_layer(start)
+        i = start
+        while i < end:
+            if priority is not None:
+                core_starpu.priority_set(priority+i)
+            if i in self.cpp_chains:
+                chain_end, seq = self.cpp_chains[i]
+                self._trace_scope(i, chain_end, "forward")
+                self._prefetch_layer(chain_end)
+                seq.forward_async()
+                self._retire(i, chain_end, "forward")
+                if offload:
+                    self._offload(i, chain_end)
+                i = chain_end
+                continue
+            self._prefetch_layer(i+1)
+            self._trace_scope(i, i+1, "forward")
+            self.layers[i].forward_async()
+            self._retire(i, i+1, "forward")
+            if offload:
+                self._offload(i, i+1)
+            i += 1
+
+    # Backward propagation of layers in range [start, end). Tasks of the i-th
+    # layer get priority priority+i.
+    def _backward_layers(self, start: int, end: int, priority: int):
+        self._prefetch_layer(end-1, True)
+        i = end - 1
+        while i >= start:
+            if i in self.cpp_chain_ends:
+                chain_start, seq = self.cpp_chain_ends[i]
+                self._prefetch_offloaded(chain_start, i+1)
+                self._prefetch_layer(chain_start-1, True)
+                self._trace_scope(chain_start, i+1, "backward")
+                seq.backward_async(priority+chain_start)
+                self._retire(chain_start, i+1, "backward")
+                i = chain_start - 1
+                continue
+            core_starpu.priority_set(priority+i)
+            self._prefetch_offloaded(i, i+1)
+            self._prefetch_layer(i-1, True)
+            self._trace_scope(i, i+1, "backward")
+            self.layers[i].backward_async()
+            self._retire(i, i+1, "backward")
+            i -= 1
 
     # Forward propagation
     def forward_async(self):
-        for l in self.layers:
-            l.forward_async()
+        if not self.checkpoints:
+            self._forward_layers(0, len(self.layers))
+            return
+        nsegments = len(self.segments)
+        for i_seg, (start, end) in enumerate(self.segments):
+            self._forward_layers(start, end)
+            # The last segment is immediately used by backward propagation
+            if i_seg < nsegments-1:
+                self._free_segment(i_seg)
 
-    # Backward propagation
+    # Backward propagation. Tasks of the i-th layer get priority i, which is
+    # the length of the remaining critical path of backward (it is used by
+    # the locality-aware scheduler, see nntile.starpu.scheduler_locality,
+    # and by predefined policies, that sort tasks by priorities, e.g.
+    # dmdas). Gradients over weights of layers get the lower priority of
+    # nntile.tensor.background_priority(), so gradients over activations
+    # are computed first.
     def backward_async(self):
-        for l in reversed(self.layers):
-            l.backward_async()
+        if self.inference:
+            raise RuntimeError("Model is in inference only mode")
+        priority = core_starpu.priority_get()
+        if not self.checkpoints:
+            self._backward_layers(0, len(self.layers), priority)
+            core_starpu.priority_set(priority)
+            return
+        nsegments = len(self.segments)
+        for i_seg in reversed(range(nsegments)):
+            start, end = self.segments[i_seg]
+            # Recompute activations of the segment
+            if i_seg < nsegments-1:
+                self._forward_layers(start, end, priority, offload=False)
+            self._backward_layers(start, end, priority)
+            self._free_segment(i_seg)
+        core_starpu.priority_set(priority)
+
+    # Use parameters of another model of the same structure instead of own
+    # ones, e.g., for another set of activations, that processes the next
+    # microbatch, while the current one is still in backward (see
+    # nntile.pipeline.Pipeline). Own parameters are unregistered and
+    # references to them in attributes of layers are replaced. Mapping is
+    # shared by all layers, as a layer may refer to a parameter of a
+    # preceding layer (see layer.TiedLinear).
+    def share_parameters(self, other):
+        if len(self.layers) != len(other.layers):
+            raise ValueError("Models shall have the same structure")
+        mapping = {}
+        for l, l_other in zip(self.layers, other.layers):
+            if len(l.parameters) != len(l_other.parameters):
+                raise ValueError("Models shall have the same structure")
+            for p, p_other in zip(l.parameters, l_other.parameters):
+                if p.value.shape != p_other.value.shape or \
+                        p.value.basetile_shape != p_other.value.basetile_shape:
+                    raise ValueError("Models shall have the same parameters")
+                mapping[id(p)] = p_other
+                # Mask of rows of a sparse gradient (see layer.Embedding)
+                rows = getattr(p, "rows", None)
+                if rows is not None:
+                    mapping[id(rows)] = p_other.rows
+            def replace(x):
+                if type(x) is list:
+                    return [replace(y) for y in x]
+                return mapping.get(id(x), x)
+            own = list(l.parameters)
+            for name, x in list(vars(l).items()):
+                setattr(l, name, replace(x))
+            for p in own:
+                p.unregister()
+                rows = getattr(p, "rows", None)
+                if rows is not None:
+                    rows.unregister()
+        self.parameters = []
+        for l in self.layers:
+            self.parameters.extend(l.parameters)
+        # C++ layers refer to the old parameters
+        if self.cpp_submission:
+            self.set_cpp_submission()
+
+    # Parameters, that require gradients, e.g., for optimizers of a model
+    # with frozen parameters, that do not keep states of frozen ones
+    def trainable_parameters(self) -> List[TensorMoments]:
+        return [p for p in self.parameters if p.grad is not None \
+                and p.grad_required]
+
+    # Freeze all parameters, so that backward of layers skips gradients over
+    # them and memory of their gradients is released (see
+    # nntile.starpu.host_pool_enable for lazy allocation)
+    def freeze_parameters(self):
+        for p in self.parameters:
+            p.grad_required = False
+            if p.grad is not None:
+                p.grad.invalidate_submit()
+        # C++ layers of frozen parameters are replaced by Python ones
+        if self.cpp_submission:
+            self.set_cpp_submission()
+
+    # Fine-tuning with low-rank adapters (LoRA): all the parameters are
+    # frozen and adapters of a given rank are added to linear layers (see
+    # layer.Linear.add_lora). Adapter of the i-th linear layer is initialized
+    # with seed+i, so that adapters of layers of the same shape are
+    # independent. Returns the next tag to be used.
+    def add_lora(self, rank: int, next_tag: int, alpha: float=None, \
+            rank_tile: int=0, seed: int=100) -> int:
+        self.freeze_parameters()
+        linear_layers = [l for l in self.layers if isinstance(l, Linear)]
+        for i, l in enumerate(linear_layers):
+            next_tag = l.add_lora(rank, next_tag, alpha, rank_tile, seed+i)
+        self.parameters = []
+        for l in self.layers:
+            self.parameters.extend(l.parameters)
+        if self.checkpoints:
+            self.set_checkpoints(self.checkpoints)
+        elif self.cpp_submission:
+            self.set_cpp_submission()
+        if self.memory_plan is not None:
+            self.plan_memory()
+        return next_tag
+
+    # Switch the model into inference only mode: gradients of parameters,
+    # activations and temporaries of layers (e.g., gradients over
+    # intermediates of attention) are unregistered. Memory of a tensor is
+    # allocated on its first write, so gradients dropped right after
+    # construction of a model never take memory and serving takes memory of
+    # weights, activations and temporaries of forward only. Backward is not
+    # possible afterwards.
+    def set_inference(self):
+        def drop_grad(t):
+            if t.grad is not None:
+                t.grad.unregister_submit()
+            t.grad = None
+            t.grad_required = False
+        # Fused head with the loss computes gradients during forward
+        for l in self.layers:
+            if isinstance(l, LinearCrossEntropy):
+                raise ValueError("Fused head with the loss cannot be used " \
+                        "for inference")
+        for l in self.layers:
+            for t in l.parameters:
+                drop_grad(t)
+            for t in l.temporaries:
+                if type(t) is TensorMoments:
+                    drop_grad(t)
+        for t in self.activations:
+            drop_grad(t)
+        self.inference = True
+        # C++ layers refer to the dropped gradients
+        if self.cpp_submission:
+            self.set_cpp_submission()
+        if self.memory_plan is not None:
+            self.plan_memory()
 
     # Clear all gradients (parameters and inter-layer activations)
     def clear_gradients(self):
@@ -57,6 +486,10 @@ class BaseModel:
         for t in self.parameters:
             if t.grad is not None and t.grad_required:
                 clear_async(t.grad)
+                # Mask of rows of a sparse gradient (see layer.Embedding)
+                rows = getattr(t, "rows", None)
+                if rows is not None:
+                    clear_async(rows)
 
     # Clear gradients of inter-layer activations
     def clear_activations_grads(self):
@@ -64,13 +497,76 @@ class BaseModel:
             if t.grad is not None and t.grad_required:
                 clear_async(t.grad)
 
-    # Unregister all tensors related to this model
-    def unregister(self):
+    # Switch layers with random behavior (e.g., dropout) between training
+    # and evaluation modes
+    def set_training(self, training: bool=True):
+        for l in self.layers:
+            if hasattr(l, "training"):
+                l.training = training
+
+    # Unregister all tensors related to this model. Tensors are unregistered
+    # after all the submitted tasks on them without blocking, unless wait is
+    # set, that waits for all the tasks.
+    def unregister(self, wait: bool=False):
         for l in self.layers:
             l.unregister()
         for x in self.activations:
-            x.unregister()
+            x.unregister_submit()
+        if wait:
+            core_starpu.wait_for_all()
+
+    # Pin tiles of parameters and their gradients to CUDA devices, so that
+    # weights stay on GPUs and only activations move between devices. Tiles
+    # of each tensor are spread cyclically over devices of their MPI node.
+    # Takes effect with the locality-aware scheduler (see
+    # nntile.starpu.scheduler_locality).
+    def pin_parameters(self, ndevices: int=0):
+        if ndevices <= 0:
+            ndevices = core_starpu.get_ndevices()
+        if ndevices <= 0:
+            return
+        for p in self.parameters:
+            devices = core_tensor.distributions.local_cyclic( \
+                    p.value.distribution, ndevices)
+            p.value.set_device_distribution(devices)
+            if p.grad is not None:
+                p.grad.set_device_distribution(devices)
+
+    # Place tiles of parameters and their gradients on NUMA nodes, so that
+    # bandwidth-bound updates of a tile run on cores, that are close to its
+    # memory. Tiles of each tensor are spread cyclically over NUMA nodes.
+    # Requires StarPU to be initialized with NUMA support (see
+    # nntile.starpu.Config).
+    def place_parameters_numa(self, nnuma: int=0):
+        if nnuma <= 0:
+            nnuma = core_starpu.get_nnuma()
+        if nnuma <= 1:
+            return
+        for p in self.parameters:
+            numa = core_tensor.distributions.local_cyclic( \
+                    p.value.distribution, nnuma)
+            p.value.set_numa_distribution(numa)
+            if p.grad is not None:
+                p.grad.set_numa_distribution(numa)
 
     def get_parameters(self):
         return self.parameters
 
+    # Name all tensors of the model for memory tracking (see
+    # nntile.starpu.memory_tracking_enable)
+    def set_tensor_names(self, prefix: str=""):
+        def set_name(t, name):
+            if type(t) is TensorMoments:
+                set_name(t.value, name)
+                set_name(t.grad, name+" grad")
+            elif t is not None:
+                t.set_name(prefix+name)
+        for i, x in enumerate(self.activations):
+            set_name(x, "activation {}".format(i))
+        for i, l in enumerate(self.layers):
+            layer_name = "{} {}".format(type(l).__name__, i)
+            for j, p in enumerate(l.parameters):
+                set_name(p, "{} parameter {}".format(layer_name, j))
+            for j, t in enumerate(l.temporaries):
+                set_name(t, "{} temporary {}".format(layer_name, j))
+
@@ -0,0 +1,229 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/model/data_parallel.py
+# Data-parallel training of replicas of a model
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-09
+
+from nntile.tensor import add_async, copy_async, convert_async, \
+        TensorTraits, Tensor_fp32, Tensor_fp16, Tensor_bf16
+from nntile.model.base_model import BaseModel
+from typing import List, Optional
+
+class DataParallel:
+    """Data-parallel wrapper around replicas of the same model
+
+    Every replica is a model with the same structure, that is placed onto
+    its own MPI rank (through distribution of its tensors) or into the same
+    process, where StarPU spreads independent tasks of replicas over
+    available workers. Each replica processes its own input in forward and
+    backward passes. Gradients of parameters are summed over all the
+    replicas by a tree all-reduce, so that all the replicas see the same
+    gradients. The all-reduce is submitted bucket by bucket, as soon as
+    backward passes of all the replicas are submitted for layers, that
+    produce the gradients. Therefore, communication of gradients of the last
+    layers overlaps with backward passes of the first layers.
+
+    Optimizer is applied to parameters of all the replicas, which remain the
+    same after each step, as they start from the same values (see
+    broadcast_parameters_async) and get the same gradients.
+
+    Optional compression ('fp16' or 'bf16') halves the bytes, that are sent
+    between replicas. Gradients are converted into the given precision
+    before every transfer, and received values are converted back and
+    summed in single precision. The final sum is rounded into the given
+    precision on all the replicas, including the first one, so that they
+    still get exactly the same gradients. Compression requires fp32
+    gradients and temporaries of the given precision and of fp32 for every
+    gradient of every replica, that are created with tags from next_tag.
+    """
+    replicas: List[BaseModel]
+    next_tag: int
+
+    def __init__(self, replicas: List[BaseModel], \
+            bucket_nelems: int=1048576, compression: Optional[str]=None, \
+            next_tag: int=0):
+        if len(replicas) == 0:
+            raise ValueError("List of replicas shall not be empty")
+        nlayers = len(replicas[0].layers)
+        nparams = len(replicas[0].parameters)
+        for r in replicas[1:]:
+            if len(r.layers) != nlayers or len(r.parameters) != nparams:
+                raise ValueError("Replicas shall have the same structure")
+            for p0, p in zip(replicas[0].parameters, r.parameters):
+                if p0.value.shape != p.value.shape or \
+                        p0.value.basetile_shape != p.value.basetile_shape:
+                    raise ValueError("Replicas shall have the same " \
+                            "parameters")
+        self.replicas = replicas
+        self.bucket_nelems = bucket_nelems
+        # Gradient of a parameter is ready after backward of the first layer
+        # (in forward order), that uses it
+        param_index = {id(p): i for i, p in \
+                enumerate(replicas[0].parameters)}
+        param_ready = [None] * nparams
+        for i_layer in reversed(range(nlayers)):
+            for p in replicas[0].layers[i_layer].parameters:
+                param_ready[param_index[id(p)]] = i_layer
+        self.ready_params = [[] for i in range(nlayers)]
+        for i_param, i_layer in enumerate(param_ready):
+            p = replicas[0].parameters[i_param]
+            if i_layer is not None and p.grad is not None \
+                    and p.grad_required:
+                self.ready_params[i_layer].append(i_param)
+        # Buffers of compressed and received gradients of every replica
+        if compression == "fp16":
+            low_type = Tensor_fp16
+        elif compression == "bf16":
+            low_type = Tensor_bf16
+        elif compression is not None:
+            raise ValueError("Compression shall be 'fp16' or 'bf16'")
+        self.compression = compression
+        self.compressed = {}
+        self.received = {}
+        if compression is not None:
+            for params in self.ready_params:
+                for i_param in params:
+                    self.compressed[i_param] = []
+                    self.received[i_param] = []
+                    for r in replicas:
+                        grad = r.parameters[i_param].grad
+                        if type(grad) is not Tensor_fp32:
+                            raise TypeError("Compression requires fp32 " \
+                                    "gradients")
+                        traits = TensorTraits(grad.shape, \
+                                grad.basetile_shape)
+                        low = low_type(traits, grad.distribution, next_tag)
+                        next_tag = low.next_tag
+                        recv = Tensor_fp32(traits, grad.distribution, \
+                                next_tag)
+                        next_tag = recv.next_tag
+                        self.compressed[i_param].append(low)
+                        self.received[i_param].append(recv)
+        self.next_tag = next_tag
+
+    # Copy parameters of the first replica into all the other replicas
+    def broadcast_parameters_async(self):
+        for i in range(len(self.replicas[0].parameters)):
+            self._broadcast([r.parameters[i].value for r in self.replicas])
+
+    # Tree broadcast of the first tensor into the others
+    @staticmethod
+    def _broadcast(tensors):
+        n = len(tensors)
+        step = 1
+        while step < n:
+            step *= 2
+        while step > 1:
+            step //= 2
+            for i in range(0, n-step, 2*step):
+                copy_async(tensors[i], tensors[i+step])
+
+    # Tree all-reduce of gradients of a bucket of parameters
+    def _allreduce(self, bucket):
+        n = len(self.replicas)
+        for i_param in bucket:
+            grads = [r.parameters[i_param].grad for r in self.replicas]
+            if self.compression is not None:
+                self._allreduce_compressed(grads, \
+                        self.compressed[i_param], self.received[i_param])
+                continue
+            step = 1
+            while step < n:
+                for i in range(0, n-step, 2*step):
+                    add_async(1.0, grads[i+step], 1.0, grads[i])
+                step *= 2
+            self._broadcast(grads)
+
+    # Tree all-reduce, that sends only compressed gradients
+    @staticmethod
+    def _allreduce_compressed(grads, compressed, received):
+        n = len(grads)
+        step = 1
+        while step < n:
+            for i in range(0, n-step, 2*step):
+                convert_async(grads[i+step], compressed[i+step])
+                # Compressed tiles are sent to ranks of the destination
+                convert_async(compressed[i+step], received[i])
+                add_async(1.0, received[i], 1.0, grads[i])
+            step *= 2
+        # The same rounding of the sum on all the replicas
+        convert_async(grads[0], compressed[0])
+        convert_async(compressed[0], grads[0])
+        while step > 1:
+            step //= 2
+            for i in range(0, n-step, 2*step):
+                convert_async(compressed[i], grads[i+step])
+                convert_async(grads[i+step], compressed[i+step])
+
+    # Forward propagation of all the replicas
+    def forward_async(self):
+        for r in self.replicas:
+            r.forward_async()
+
+    # Backward propagation of all the replicas, interleaved with all-reduce
+    # of gradients
+    def backward_async(self):
+        r0 = self.replicas[0]
+        nlayers = len(r0.layers)
+        for r in self.replicas[1:]:
+            if r.checkpoints != r0.checkpoints:
+                raise RuntimeError("Replicas shall have the same " \
+                        "checkpoints")
+        if r0.checkpoints:
+            segments = r0.segments
+        else:
+            segments = [(0, nlayers)]
+        nsegments = len(segments)
+        bucket = []
+        bucket_nelems = 0
+        for i_seg in reversed(range(nsegments)):
+            start, end = segments[i_seg]
+            # Recompute activations of the segment (see BaseModel)
+            if r0.checkpoints and i_seg < nsegments-1:
+                for r in self.replicas:
+                    for l in r.layers[start:end]:
+                        l.forward_async()
+            for i_layer in reversed(range(start, end)):
+                for r in self.replicas:
+                    r.layers[i_layer].backward_async()
+                for i_param in self.ready_params[i_layer]:
+                    bucket.append(i_param)
+                    bucket_nelems += r0.parameters[i_param].value.nelems
+                if bucket_nelems >= self.bucket_nelems:
+                    self._allreduce(bucket)
+                    bucket = []
+                    bucket_nelems = 0
+            if r0.checkpoints:
+                for r in self.replicas:
+                    r._free_segment(i_seg)
+        self._allreduce(bucket)
+
+    # Clear all gradients of all the replicas
+    def clear_gradients(self):
+        for r in self.replicas:
+            r.clear_gradients()
+
+    # Parameters of all the replicas to be updated by an optimizer
+    def get_parameters(self):
+        params = []
+        for r in self.replicas:
+            params.extend(r.get_parameters())
+        return params
+
+    # Unregister all the replicas and buffers of compression
+    def unregister(self):
+        for r in self.replicas:
+            r.unregister()
+        for buffers in [self.compressed, self.received]:
+            for tensors in buffers.values():
+                for t in tensors:
+                    t.unregister()
+        self.compressed = {}
+        self.received = {}
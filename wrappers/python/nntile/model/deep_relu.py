@@ -16,6 +16,7 @@ from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
 from nntile.model.base_model import BaseModel
 from nntile.layer.linear import Linear
 from nntile.layer.act import Act
+from nntile.layer.batch_norm_act import BatchNormAct
 import numpy as np
 from typing import List
 
@@ -28,7 +29,8 @@ class DeepReLU(BaseModel):
     def __init__(self, x: TensorMoments, side: str, ndim: int, \
             add_shape: int, add_basetile_shape: int, nlayers: int, \
             n_classes:int, next_tag: int, bias: bool=False, \
-            fp32_fast_tf32: bool=False):
+            fp32_fast_tf32: bool=False, inplace_relu: bool=False, \
+            batch_norm: bool=False):
         # Check parameter side
         if side != 'L' and side != 'R':
             raise ValueError("side must be either 'L' or 'R'")
@@ -49,8 +51,9 @@ class DeepReLU(BaseModel):
         # self.fp32_convert_fp16 = new_layer.fp32_convert_fp16
         layers.append(new_layer)
         activations.extend(new_layer.activations_output)
-        new_layer, next_tag = Act.generate_simple(activations[-1], "relu", \
-                next_tag)
+        # In-place ReLU keeps only its output for backward (see layer.Act)
+        new_layer, next_tag = self._generate_relu(activations[-1], side, \
+                next_tag, inplace_relu, batch_norm)
         layers.append(new_layer)
         activations.extend(new_layer.activations_output)
         # Internal linear layers with the same internal shape
@@ -60,8 +63,8 @@ class DeepReLU(BaseModel):
                     [add_basetile_shape], next_tag, bias, fp32_fast_tf32=fp32_fast_tf32)
             layers.append(new_layer)
             activations.extend(new_layer.activations_output)
-            new_layer, next_tag = Act.generate_simple(activations[-1], \
-                    "relu", next_tag)
+            new_layer, next_tag = self._generate_relu(activations[-1], \
+                    side, next_tag, inplace_relu, batch_norm)
             layers.append(new_layer)
             activations.extend(new_layer.activations_output)
         # Finalizing linear layer that converts result back to proper shape
@@ -74,6 +77,23 @@ class DeepReLU(BaseModel):
         # Fill Base Model with the generated data
         super().__init__(activations, layers)
 
+    # ReLU of hidden features, that are normalized over a batch if required.
+    # Features are the last axis for side 'L' and the first one otherwise.
+    @staticmethod
+    def _generate_relu(x: TensorMoments, side: str, next_tag: int, \
+            inplace_relu: bool, batch_norm: bool):
+        if batch_norm:
+            axis = x.value.ndim-1 if side == 'L' else 0
+            return BatchNormAct.generate_simple(x, axis, "relu", next_tag)
+        return Act.generate_simple(x, "relu", next_tag, inplace=inplace_relu)
+
+    # Fold all batch normalizations into the preceding linear layers, after
+    # which the model is only for inference
+    def fold_batch_norm_async(self):
+        for prev, l in zip(self.layers[:-1], self.layers[1:]):
+            if type(l) is BatchNormAct:
+                self.next_tag = l.fold_async(prev, self.next_tag)
+
     # Randomly init all linear layers
     def init_randn_async(self):
         for l in self.layers:
@@ -15,11 +15,16 @@
 from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
         notrans, trans, Tensor_fp32, Tensor_int64, Tensor_bool
 from nntile.model.base_model import BaseModel
-from nntile.layer import Linear, Embedding, AddSlice, LayerNorm, Attention, \
-        FlashAttention, Act
+from nntile.layer import Linear, EmbeddingPos, LayerNorm, Attention, \
+        FlashAttention, Act, LinearCrossEntropy, Dropout, MoE, AddLayerNorm, \
+        SwiGLU, TiedLinear
 import numpy as np
-from typing import List, Dict
+from typing import List, Dict, Optional
 from nntile.layer.add import Add
+from nntile.nntile_core import starpu as core_starpu
+from nntile.safetensors import SafetensorsCheckpoint
+from nntile.packing import segment_positions, segment_mask
+from nntile.layer.flash_attention import block_layout
 import torch
 
 class GPT2Config(Dict):
@@ -29,7 +34,16 @@ class GPT2Config(Dict):
             inner_dim: int, inner_dim_tile: int, \
             layer_norm_epsilon: float, num_hidden_layers: int, n_head: int, \
             n_head_tile: int, activation_function: str, \
-            flashattention: bool=True, use_redux: bool=False):
+            flashattention: bool=True, use_redux: bool=False, \
+            flashattention_fused: bool=False, \
+            sparse_embedding_grad: bool=False, lm_head_vocab_tile: int=0, \
+            embd_pdrop: float=0.0, resid_pdrop: float=0.0, \
+            attn_pdrop: float=0.0, dropout_seed: int=0, \
+            tensor_parallel: int=1, pipeline_parallel: int=1, \
+            moe_num_experts: int=0, moe_top_k: int=1, \
+            moe_capacity_factor: float=1.25, moe_aux_loss_coef: float=0.01, \
+            tie_word_embeddings: bool=False, \
+            kv_cache_dtype: Optional[str]=None):
         self["vocab_size"] = vocab_size
         self["vocab_embed_dim_tile"] = vocab_embed_dim_tile
         self["embed_dim"] = embed_dim
@@ -41,19 +55,80 @@ class GPT2Config(Dict):
         self["num_hidden_layers"] = num_hidden_layers
         self["n_head"] = n_head
         self["n_head_tile"] = n_head_tile
+        # Activation "swiglu" turns MLPs into gated ones with two
+        # up-projections (see GPT2MLP)
         self["activation_function"] = activation_function
         self["flashattention"] = flashattention
         self["redux"] = use_redux
+        self["flashattention_fused"] = flashattention_fused
+        # Gradients of embeddings mark used rows (see optimizer.LazyAdam)
+        self["sparse_embedding_grad"] = sparse_embedding_grad
+        # Positive value fuses the head with the cross-entropy loss, that
+        # processes the vocabulary by chunks (see layer.LinearCrossEntropy)
+        self["lm_head_vocab_tile"] = lm_head_vocab_tile
+        # Dropout probabilities of embeddings, of outputs of attentions and
+        # MLPs and of attention weights as in GPT2 by Hugging Face. Masks are
+        # regenerated from seeds, starting with dropout_seed.
+        self["embd_pdrop"] = embd_pdrop
+        self["resid_pdrop"] = resid_pdrop
+        self["attn_pdrop"] = attn_pdrop
+        self["dropout_seed"] = dropout_seed
+        # Transformer blocks are split into pipeline_parallel stages of
+        # consecutive blocks, each stage is placed onto its own group of
+        # tensor_parallel MPI ranks. MLPs of a stage split their inner
+        # dimension over ranks of the group (see GPT2MLP), while the other
+        # layers of the stage are on the first rank of the group.
+        # Microbatches of the pipeline are tiles of the batch dimension:
+        # StarPU-MPI starts the next stage on a tile as soon as the previous
+        # stage finishes it, so stages work on different tiles concurrently.
+        self["tensor_parallel"] = tensor_parallel
+        self["pipeline_parallel"] = pipeline_parallel
+        # Positive number of experts replaces MLPs of transformer blocks by
+        # mixtures of experts of the same inner dimension, every token is
+        # routed to moe_top_k experts with moe_capacity_factor times more
+        # slots than in perfectly balanced routing (see layer.MoE). Experts
+        # of a stage are spread over ranks of its group.
+        self["moe_num_experts"] = moe_num_experts
+        self["moe_top_k"] = moe_top_k
+        self["moe_capacity_factor"] = moe_capacity_factor
+        self["moe_aux_loss_coef"] = moe_aux_loss_coef
+        # The unfused head reuses vocabulary of the embedding of tokens
+        # instead of its own weight (see layer.TiedLinear)
+        self["tie_word_embeddings"] = tie_word_embeddings
+        # KV-cache of incremental decoding keeps keys and values in "int8"
+        # or "fp8_e4m3", if set (see layer.Attention)
+        self["kv_cache_dtype"] = kv_cache_dtype
 
     def __getattr__(self, attr):
         return self[attr]
 
+# Place all tensors of layers onto a single MPI rank
+def _set_layers_rank(layers: List, rank: int):
+    def set_rank(t):
+        if type(t) is TensorMoments:
+            set_rank(t.value)
+            set_rank(t.grad)
+            # Mask of rows of a sparse gradient (see layer.Embedding)
+            set_rank(getattr(t, "rows", None))
+        elif t is not None:
+            t.set_distribution([rank] * t.grid.nelems)
+    for l in layers:
+        for t in l.activations_output + l.parameters + l.temporaries:
+            set_rank(t)
+
+# Distribution of tiles of a tensor, that depends only on the tile index
+# along a given axis
+def _axis_distribution(t: Tensor, axis: int, ranks: List[int]):
+    shape = t.grid.shape
+    stride = int(np.prod(shape[:axis]))
+    return [ranks[(i//stride) % shape[axis]] for i in range(t.grid.nelems)]
+
 class GPT2MLP(BaseModel):
     next_tag: int
 
     # Construct model with all the provided data
     def __init__(self, x: TensorMoments, config: GPT2Config, next_tag: int, \
-            fp32_fast_tf32: bool=False):
+            fp32_fast_tf32: bool=False, ranks: List[int]=[0]):
         # Init activations and list of layers
         activations = [x]
         layers = []
@@ -71,9 +146,21 @@ class GPT2MLP(BaseModel):
                 redux=redux, fp32_fast_tf32=fp32_fast_tf32)
         layers.append(new_layer)
         activations.extend(new_layer.activations_output)
-        
-        new_layer, next_tag = Act.generate_simple(activations[-1], \
-                config["activation_function"], next_tag)
+        if activation_function == "swiglu":
+            # Gated MLP projects the input the second time with the same
+            # tiling, so that SiLU of the gate and its product with the
+            # second projection are computed by a single fused task per tile
+            gate = activations[-1]
+            new_layer, next_tag = Linear.generate_simple(x, "R", notrans, \
+                    gemm_ndim, [inner_dim], [inner_dim_tile], next_tag, \
+                    redux=redux, fp32_fast_tf32=fp32_fast_tf32)
+            layers.append(new_layer)
+            activations.extend(new_layer.activations_output)
+            new_layer, next_tag = SwiGLU.generate_simple(gate, \
+                    activations[-1], next_tag)
+        else:
+            new_layer, next_tag = Act.generate_simple(activations[-1], \
+                    activation_function, next_tag)
         layers.append(new_layer)
         activations.extend(new_layer.activations_output)
 
@@ -82,9 +169,57 @@ class GPT2MLP(BaseModel):
                 next_tag, redux=redux, fp32_fast_tf32=fp32_fast_tf32)
         layers.append(new_layer)
         activations.extend(new_layer.activations_output)
-        self.next_tag = next_tag
         # Fill Base Model with the generated data
         super().__init__(activations, layers)
+        if ranks != [0]:
+            next_tag = self._set_tensor_parallel(ranks, next_tag)
+        self.next_tag = next_tag
+
+    # Megatron-style tensor parallelism over the given MPI ranks. Tiles of
+    # the inner dimension are split into contiguous blocks, one block per
+    # rank, so that the first linear layer is column-parallel and the second
+    # one is row-parallel. Weights, biases and inner activations of a block
+    # stay on its rank, inputs and gradients of outputs are sent to all the
+    # ranks, and partial sums over blocks are reduced on the first rank
+    # through replicas (see Linear.set_tensor_parallel).
+    def _set_tensor_parallel(self, ranks: List[int], next_tag: int):
+        # Both linear layers of the gate and of the up-projection of a gated
+        # MLP are column-parallel
+        *inner_layers, linear_out = self.layers
+        linears_in = [l for l in inner_layers if type(l) is Linear]
+        _set_layers_rank(self.layers, ranks[0])
+        ntiles = linears_in[0].w.value.grid.shape[0]
+        nblocks = min(len(ranks), ntiles)
+        # The same split of the contracted dimension as in gemm_summa_async
+        inner_ranks = [ranks[i*nblocks//ntiles] for i in range(ntiles)]
+        inner = [(l.y, 0) for l in inner_layers] + [(linear_out.w, 1)]
+        for l in linears_in:
+            inner.extend([(l.w, 0), (l.b, 0)])
+        for t, axis in inner:
+            if t is None:
+                continue
+            distr = _axis_distribution(t.value, axis, inner_ranks)
+            t.value.set_distribution(distr)
+            if t.grad is not None:
+                t.grad.set_distribution(distr)
+        # Replicas of the output and of the gradient of the input
+        def replicas(x: Tensor, next_tag: int):
+            traits = TensorTraits(x.shape, x.basetile_shape)
+            result = []
+            for r in range(1, nblocks):
+                distr = [ranks[r]] * traits.grid.nelems
+                result.append(type(x)(traits, distr, next_tag))
+                next_tag = result[-1].next_tag
+            return result, next_tag
+        y_replicas, next_tag = replicas(linear_out.y.value, next_tag)
+        linear_out.set_tensor_parallel(y_replicas=y_replicas)
+        for linear_in in linears_in:
+            if linear_in.x.grad_required:
+                x_grad_replicas, next_tag = replicas(linear_in.x.value, \
+                        next_tag)
+                linear_in.set_tensor_parallel( \
+                        x_grad_replicas=x_grad_replicas)
+        return next_tag
 
     # Randomly init all linear layers
     def init_randn_async(self):
@@ -111,13 +246,16 @@ class GPT2Model(BaseModel):
     # Construct model with all the provided data
     def __init__(self, input_ids: TensorMoments, \
             positional_ids: TensorMoments, config: GPT2Config, next_tag: int, \
-            fp32_fast_tf32: bool=False):
+            fp32_fast_tf32: bool=False, kv_cache_size: int=0, \
+            kv_cache_size_tile: int=0, kv_cache_per_sequence: bool=False, \
+            kv_cache_pages: int=0, inference: bool=False):
         # Check parameter side
         vocab_size = config["vocab_size"]
         vocab_embed_dim_tile = config["vocab_embed_dim_tile"]
         self.embed_dim = config["embed_dim"]
         embed_dim_tile = config["embed_dim_tile"]
         max_position_embeddings = config["max_position_embeddings"]
+        self.max_position_embeddings = max_position_embeddings
         inner_dim = config["inner_dim"]
         inner_dim_tile = config["inner_dim_tile"]
         layer_norm_epsilon = config["layer_norm_epsilon"]
@@ -126,75 +264,199 @@ class GPT2Model(BaseModel):
         n_head_tile = config["n_head_tile"]
         flashattention = config["flashattention"]
         redux = config["redux"]
+        sparse_embedding_grad = config.get("sparse_embedding_grad", False)
+        lm_head_vocab_tile = config.get("lm_head_vocab_tile", 0)
+        embd_pdrop = config.get("embd_pdrop", 0.0)
+        resid_pdrop = config.get("resid_pdrop", 0.0)
+        attn_pdrop = config.get("attn_pdrop", 0.0)
+        dropout_seed = config.get("dropout_seed", 0)
+        tensor_parallel = config.get("tensor_parallel", 1)
+        pipeline_parallel = config.get("pipeline_parallel", 1)
+        moe_num_experts = config.get("moe_num_experts", 0)
+        self.moe_num_experts = moe_num_experts
+        if moe_num_experts > 0 \
+                and config["activation_function"] != "gelutanh":
+            raise NotImplementedError("Experts support only gelutanh " \
+                    "activation")
+        if tensor_parallel < 1 or pipeline_parallel < 1:
+            raise ValueError("Degrees of tensor and pipeline parallelism " \
+                    "shall be positive")
+        if pipeline_parallel > max(num_hidden_layers, 1):
+            raise ValueError("There are more pipeline stages than " \
+                    "transformer blocks")
+        tie_word_embeddings = config.get("tie_word_embeddings", False)
+        if tie_word_embeddings:
+            if lm_head_vocab_tile > 0:
+                raise NotImplementedError("Fused head has no tied weights")
+            if sparse_embedding_grad:
+                raise ValueError("Tied embeddings have dense gradients")
+            if vocab_embed_dim_tile != embed_dim_tile:
+                raise ValueError("Tied embeddings require " \
+                        "vocab_embed_dim_tile == embed_dim_tile")
         self.fp32_fast_tf32 = fp32_fast_tf32
-        if flashattention:
+        # MPI ranks of groups of pipeline stages. Ranks are wrapped around
+        # the number of MPI processes, so the same model runs on any number
+        # of processes.
+        mpi_size = core_starpu.mpi_world_size()
+        self.stage_ranks = [[(s*tensor_parallel+t) % mpi_size \
+                for t in range(tensor_parallel)] \
+                for s in range(pipeline_parallel)]
+        parallel = tensor_parallel > 1 or pipeline_parallel > 1
+        att_kwargs = {}
+        seq_len = input_ids.value.shape[0]
+        seq_len_tile = input_ids.value.basetile_shape[0]
+        batch_size = input_ids.value.shape[1]
+        batch_size_tile = input_ids.value.basetile_shape[1]
+        # Incremental decoding: input_ids are new tokens only, while keys and
+        # values of all the previous tokens are kept in per-layer caches
+        self.kv_cache_size = kv_cache_size
+        if kv_cache_size > 0:
+            if kv_cache_size_tile <= 0:
+                kv_cache_size_tile = kv_cache_size
+            if kv_cache_size > max_position_embeddings:
+                raise ValueError("KV-cache is longer than maximal number of " \
+                        "positions")
+            # Softmax matrix is only (kv_cache_size, seq_len), so there is no
+            # need in the flash attention
+            AttLayer = Attention
+            att_kwargs["kv_cache_size"] = kv_cache_size
+            att_kwargs["kv_cache_size_tile"] = kv_cache_size_tile
+            # Pages of kv_cache_size_tile tokens are shared by sequences
+            att_kwargs["kv_cache_pages"] = kv_cache_pages
+            att_kwargs["kv_cache_dtype"] = config.get("kv_cache_dtype")
+            mask_shape = (kv_cache_size, seq_len)
+            mask_basetile = (kv_cache_size_tile, seq_len_tile)
+            # Every sequence of a batch has its own positions and the mask
+            if kv_cache_per_sequence:
+                mask_shape += (batch_size,)
+                mask_basetile += (batch_size_tile,)
+        elif flashattention:
             AttLayer = FlashAttention
+            # Single-pass fused kernels do not need seq-by-seq temporaries
+            att_kwargs["fused"] = config["flashattention_fused"]
         else:
             AttLayer = Attention
-        seq_len = input_ids.value.shape[0]
-        seq_len_tile = input_ids.value.basetile_shape[0]
+        if attn_pdrop > 0:
+            if AttLayer is not FlashAttention or att_kwargs["fused"]:
+                raise NotImplementedError("Dropout of attention weights " \
+                        "requires non-fused flash attention")
+            att_kwargs["dropout_p"] = attn_pdrop
+        self.kv_cache_per_sequence = kv_cache_per_sequence
+        positional_ids_ndim = 2 if kv_cache_per_sequence else 1
+        if positional_ids.value.ndim != positional_ids_ndim:
+            raise ValueError("Positional ids shall be of shape (seq_len, " \
+                    "batch_size) if and only if kv_cache_per_sequence is set")
+        if kv_cache_per_sequence and kv_cache_size == 0:
+            raise ValueError("kv_cache_per_sequence requires KV-cache")
+        if kv_cache_pages > 0 and not kv_cache_per_sequence:
+            raise ValueError("Paged KV-cache requires kv_cache_per_sequence")
+        self.kv_cache_pages = kv_cache_pages
+        self.kv_cache_size_tile = kv_cache_size_tile
+        # Configuration for other plans of execution (see create_plan)
+        self.config = config
+        if kv_cache_size == 0:
+            mask_shape = (seq_len, seq_len)
+            mask_basetile = (seq_len_tile, seq_len_tile)
         activations = [input_ids, positional_ids]
         layers = []
-        mask_traits = TensorTraits((seq_len, seq_len), \
-                (seq_len_tile, seq_len_tile))
+        self.attn_layers = []
+        self.moe_layers = []
+        mask_traits = TensorTraits(mask_shape, mask_basetile)
         mask_distr = [0] * mask_traits.grid.nelems
         self.mask = Tensor_bool(mask_traits, mask_distr, next_tag)
         next_tag = self.mask.next_tag
-        mask_np = np.array(np.triu(np.ones((seq_len, seq_len))), dtype=bool, \
-                order="F")
-        self.mask.from_array(mask_np)
-
-        wte_layer, next_tag = Embedding.generate_simple(input_ids.value, \
-                Tensor_fp32, 0, vocab_size, self.embed_dim, embed_dim_tile, \
-                vocab_embed_dim_tile, next_tag)
-        layers.append(wte_layer)
-        activations.extend(wte_layer.activations_output)
-        
-        wpe_layer, next_tag = Embedding.generate_simple(positional_ids.value, \
-                Tensor_fp32, 0, max_position_embeddings, self.embed_dim, \
-                embed_dim_tile, vocab_embed_dim_tile, next_tag)
-        layers.append(wpe_layer)
-        activations.extend(wpe_layer.activations_output)
+        self.mask.from_array(self._causal_mask(mask_shape, 0))
 
-        add_slice_layer, next_tag = AddSlice.generate_simple(activations[-2], \
-                activations[-1], 2, next_tag, redux=redux)
-        layers.append(add_slice_layer)
-        activations.extend(add_slice_layer.activations_output)
+        # Token and positional embeddings are fused into a single layer with
+        # parameters wte and wpe. Positional ids of shape (seq_len,) are
+        # repeated over the batch
+        embed_layer, next_tag = EmbeddingPos.generate_simple(input_ids.value, \
+                positional_ids.value, Tensor_fp32, 0, vocab_size, \
+                max_position_embeddings, self.embed_dim, embed_dim_tile, \
+                vocab_embed_dim_tile, next_tag, \
+                sparse_grad=sparse_embedding_grad)
+        layers.append(embed_layer)
+        activations.extend(embed_layer.activations_output)
 
+        # Every dropout gets its own seed
+        seeds = iter(range(dropout_seed, dropout_seed+3*num_hidden_layers+1))
+        def dropout(p, next_tag):
+            seed = next(seeds)
+            if p > 0:
+                new_layer, next_tag = Dropout.generate_simple( \
+                        activations[-1], p, seed, next_tag)
+                layers.append(new_layer)
+                activations.extend(new_layer.activations_output)
+            return next_tag
+        next_tag = dropout(embd_pdrop, next_tag)
+        if parallel:
+            _set_layers_rank(layers, self.stage_ranks[0][0])
+
+        # Index of the first layer of each transformer block
+        self.block_starts = []
         for h_idx in range(num_hidden_layers):
+            self.block_starts.append(len(layers))
+            stage = h_idx * pipeline_parallel // num_hidden_layers
+            block_input = activations[-1]
             l_norm, next_tag = LayerNorm.generate_simple(activations[-1], 0, \
                     layer_norm_epsilon, next_tag, redux=redux)
             layers.append(l_norm)
             activations.extend(l_norm.activations_output)
 
+            attn_seed = next(seeds)
+            if attn_pdrop > 0:
+                att_kwargs["seed"] = attn_seed
             attn_layer, next_tag = AttLayer.generate_simple( \
                     activations[-1], activations[-1], activations[-1], \
                     self.n_head, n_head_tile, next_tag, True, self.mask, \
-                    redux=redux, fp32_fast_tf32=fp32_fast_tf32)
+                    redux=redux, fp32_fast_tf32=fp32_fast_tf32, **att_kwargs)
             layers.append(attn_layer)
+            self.attn_layers.append(attn_layer)
             activations.extend(attn_layer.activations_output)
+            next_tag = dropout(resid_pdrop, next_tag)
 
-            new_layer, next_tag = Add.generate_simple(activations[-3], \
-                    activations[-1], next_tag)
-            layers.append(new_layer)
-            activations.extend(new_layer.activations_output)
+            # Residual connection and the following normalization are fused,
+            # the residual sum is the input of the next residual connection
+            add_norm, next_tag = AddLayerNorm.generate_simple(block_input, \
+                    activations[-1], 0, layer_norm_epsilon, next_tag, \
+                    redux=redux)
+            layers.append(add_norm)
+            activations.extend(add_norm.activations_output)
+            mlp_input = add_norm.res
 
-            l_norm, next_tag = LayerNorm.generate_simple(activations[-1], 0, \
-                    layer_norm_epsilon, next_tag, redux=redux)
-            layers.append(l_norm)
-            activations.extend(l_norm.activations_output)
-
-            gpt_block = GPT2MLP(activations[-1], config, next_tag, \
-                    fp32_fast_tf32=fp32_fast_tf32)
-            next_tag = gpt_block.next_tag
+            if parallel:
+                _set_layers_rank(layers[self.block_starts[-1]:], \
+                        self.stage_ranks[stage][0])
+            mlp_ranks = self.stage_ranks[stage] if parallel else [0]
+            if moe_num_experts > 0:
+                moe_layer, next_tag = MoE.generate_simple(activations[-1], \
+                        moe_num_experts, config["moe_top_k"], inner_dim, \
+                        inner_dim_tile, next_tag, \
+                        capacity_factor=config["moe_capacity_factor"], \
+                        aux_loss_coef=config["moe_aux_loss_coef"], \
+                        redux=redux)
+                if parallel:
+                    _set_layers_rank([moe_layer], mlp_ranks[0])
+                    moe_layer.set_expert_ranks(mlp_ranks)
+                activations.extend(moe_layer.activations_output)
+                layers.append(moe_layer)
+                self.moe_layers.append(moe_layer)
+            else:
+                gpt_block = GPT2MLP(activations[-1], config, next_tag, \
+                        fp32_fast_tf32=fp32_fast_tf32, ranks=mlp_ranks)
+                next_tag = gpt_block.next_tag
 
-            activations.extend(gpt_block.activations[1:])
-            layers.extend(gpt_block.layers) 
+                activations.extend(gpt_block.activations[1:])
+                layers.extend(gpt_block.layers) 
+            mlp_end = len(layers)
+            next_tag = dropout(resid_pdrop, next_tag)
 
-            new_layer, next_tag = Add.generate_simple(activations[-5], \
+            new_layer, next_tag = Add.generate_simple(mlp_input, \
                     activations[-1], next_tag)
             layers.append(new_layer)
             activations.extend(new_layer.activations_output)
+            if parallel:
+                _set_layers_rank(layers[mlp_end:], self.stage_ranks[stage][0])
 
         l_norm, next_tag = LayerNorm.generate_simple(activations[-1], 0, \
                 layer_norm_epsilon, next_tag, redux=redux)
@@ -202,18 +464,206 @@ class GPT2Model(BaseModel):
         layers.append(l_norm)
         activations.extend(l_norm.activations_output)
 
-        lm_head_layer, next_tag = Linear.generate_simple( \
-                activations[-1], "R", notrans, 1, [vocab_size], [vocab_size], \
-                next_tag, False, redux=redux, fp32_fast_tf32=fp32_fast_tf32)
+        # Fused head does not output logits, it is the loss of the model
+        # itself with scale of the loss set by the user
+        if lm_head_vocab_tile > 0:
+            lm_head_layer, next_tag = LinearCrossEntropy.generate_simple( \
+                    activations[-1], vocab_size, lm_head_vocab_tile, \
+                    next_tag, redux=redux)
+        elif tie_word_embeddings:
+            lm_head_layer, next_tag = TiedLinear.generate_simple( \
+                    activations[-1], embed_layer.w, next_tag, \
+                    fp32_fast_tf32=fp32_fast_tf32, redux=redux)
+        else:
+            lm_head_layer, next_tag = Linear.generate_simple( \
+                    activations[-1], "R", notrans, 1, [vocab_size], \
+                    [vocab_size], next_tag, False, redux=redux, \
+                    fp32_fast_tf32=fp32_fast_tf32)
 
         layers.append(lm_head_layer)
         activations.extend(lm_head_layer.activations_output)
+        self.lm_head = lm_head_layer
+        if parallel:
+            _set_layers_rank(layers[-2:], self.stage_ranks[-1][0])
 
         self.next_tag = next_tag
         # Fill Base Model with the generated data
         super().__init__(activations, layers)
+        # Drop gradients and temporaries of backward for serving
+        if inference:
+            self.set_inference()
+
+    # Sum of load-balancing losses of mixtures of experts of the last
+    # forward pass, that is not a part of the loss of the head. Gradients of
+    # the losses are added by backward passes of the mixtures of experts.
+    def get_aux_loss(self) -> float:
+        return sum(l.get_aux_loss() for l in self.moe_layers)
+
+    # Checkpoint activations at every blocks_per_segment-th transformer
+    # block. Zero value disables checkpointing.
+    def set_block_checkpoints(self, blocks_per_segment: int=1):
+        if blocks_per_segment < 0:
+            raise ValueError("blocks_per_segment shall be non-negative")
+        if blocks_per_segment > 0 and self.kv_cache_size > 0:
+            raise RuntimeError("Checkpointing cannot be used in KV-cache " \
+                    "mode")
+        if blocks_per_segment == 0:
+            self.set_checkpoints([])
+        else:
+            self.set_checkpoints(self.block_starts[::blocks_per_segment])
+
+    # Causal mask of shape (n_keys, n_queries) for queries starting at pos
+    @staticmethod
+    def _causal_mask(mask_shape, pos: int):
+        mask = np.triu(np.ones(mask_shape[:2]), -pos)
+        # The same mask for all sequences of a batch
+        if len(mask_shape) == 3:
+            mask = np.repeat(mask[:, :, np.newaxis], mask_shape[2], axis=2)
+        return np.array(mask, dtype=bool, order="F")
+
+    # Clear KV-cache of all attention layers and start a new sequence
+    def reset_kv_cache_async(self):
+        for l in self.attn_layers:
+            l.reset_kv_cache_async()
+        if self.kv_cache_pages == 0:
+            self.set_kv_cache_pos(0)
+
+    # Set position of the first new token of the next forward pass. Positional
+    # ids and mask are updated accordingly.
+    def set_kv_cache_pos(self, pos: int):
+        if self.kv_cache_size == 0 or self.kv_cache_pages > 0:
+            raise RuntimeError("Model is not in KV-cache mode")
+        seq_len, batch_size = self.activations[0].value.shape
+        positions = np.arange(pos, pos+seq_len)
+        if self.kv_cache_per_sequence:
+            positions = np.repeat(positions[:, np.newaxis], batch_size, \
+                    axis=1)
+        self.set_kv_cache_state(pos, positions, \
+                self._causal_mask(self.mask.shape, pos))
+
+    # Set position of the first new token within KV-cache together with
+    # positional ids of new tokens and the mask of shape (kv_cache_size,
+    # seq_len) or (kv_cache_size, seq_len, batch_size), if every sequence of
+    # a batch has its own positions
+    def set_kv_cache_state(self, pos: int, positions: np.ndarray, \
+            mask: np.ndarray):
+        if self.kv_cache_size == 0:
+            raise RuntimeError("Model is not in KV-cache mode")
+        for l in self.attn_layers:
+            l.set_kv_cache_pos(pos)
+        self.activations[1].value.from_array(np.array(positions, \
+                order="F", dtype=np.int64))
+        self.mask.from_array(np.array(mask, order="F", dtype=bool))
+
+    # Set pages of every sequence of paged KV-cache (see
+    # Attention.set_kv_cache_pages) together with the mask of shape
+    # (kv_cache_size, seq_len, batch_size) over positions within sequences.
+    # New tokens of the i-th sequence start at position kv_lens[i].
+    def set_kv_cache_pages(self, page_tables: List[List[int]], \
+            kv_lens: List[int], mask: np.ndarray):
+        if self.kv_cache_pages == 0:
+            raise RuntimeError("Model is not in paged KV-cache mode")
+        for l in self.attn_layers:
+            l.set_kv_cache_pages(page_tables, kv_lens)
+        seq_len = self.activations[0].value.shape[0]
+        positions = np.arange(seq_len)[:, np.newaxis] + np.array(kv_lens)
+        self.activations[1].value.from_array(np.array(positions, \
+                order="F", dtype=np.int64))
+        self.mask.from_array(np.array(mask, order="F", dtype=bool))
+
+    # Set boundaries of packed sequences (see nntile.packing) of the next
+    # forward and backward passes. Positional ids restart at every segment,
+    # while the mask confines attention to segments and its block-sparse
+    # layout lets flash attention skip tiles of different segments. All the
+    # columns of a batch share the same boundaries.
+    def set_packed_sequences(self, cu_seqlens: np.ndarray):
+        if self.kv_cache_size > 0:
+            raise RuntimeError("Packed sequences cannot be used in KV-cache " \
+                    "mode")
+        seq_len = self.activations[0].value.shape[0]
+        cu_seqlens = np.asarray(cu_seqlens, dtype=np.int64)
+        if cu_seqlens[0] != 0 or cu_seqlens[-1] != seq_len or \
+                np.any(np.diff(cu_seqlens) <= 0):
+            raise ValueError("Offsets of segments shall increase from 0 " \
+                    "to seq_len")
+        if np.max(np.diff(cu_seqlens)) > self.max_position_embeddings:
+            raise ValueError("Segment is longer than maximal number of " \
+                    "positions")
+        self.activations[1].value.from_array(np.array( \
+                segment_positions(cu_seqlens), order="F", dtype=np.int64))
+        mask = segment_mask(cu_seqlens)
+        self.mask.from_array(mask)
+        layout = block_layout(mask, self.mask.basetile_shape[0])
+        for l in self.attn_layers:
+            if hasattr(l, "mask_layout"):
+                l.mask_layout = layout
+
+    # Quantize weights of linear layers of MLPs and of the LM head for
+    # inference (see Linear.quantize). Projections of attention are kept in
+    # single precision. The model cannot be trained after quantization.
+    def quantize_linear(self, dtype: str="int8", group: int=0):
+        for l in self.layers:
+            if type(l) is Linear:
+                self.next_tag = l.quantize(self.next_tag, dtype, group)
+
+    # Separate plan of execution of the same model with other numbers and
+    # tiles of new tokens, e.g., long tiles for the prefill of a prompt and
+    # a single token for decoding. Plans share parameters and KV-caches, so
+    # switching between them copies nothing. Every plan has its own
+    # activations, temporaries and the mask. Batch and tiles of KV-cache
+    # stay the same. Plans shall be created before quantization of weights.
+    def create_plan(self, seq_len: int, seq_len_tile: int, next_tag: int):
+        if any(getattr(l, "w_q", None) is not None for l in self.layers):
+            raise RuntimeError("Plans shall be created before quantization")
+        x = self.activations[0].value
+        plan = GPT2Model._generate(x.shape[1], x.basetile_shape[1], seq_len, \
+                seq_len_tile, self.config, next_tag, \
+                fp32_fast_tf32=self.fp32_fast_tf32, \
+                kv_cache_size=self.kv_cache_size, \
+                kv_cache_size_tile=self.kv_cache_size_tile, \
+                kv_cache_per_sequence=self.kv_cache_per_sequence, \
+                kv_cache_pages=self.kv_cache_pages, inference=self.inference)
+        plan.share_parameters(self)
+        if self.kv_cache_size > 0:
+            for l, l_other in zip(plan.attn_layers, self.attn_layers):
+                l.share_kv_cache(l_other)
+        return plan, plan.next_tag
+
+    # Instances of the model for buckets of sequence lengths (see
+    # nntile.bucketing), so that minibatches of short sequences do not pay
+    # for the full length. Instances share parameters with this model, so an
+    # optimizer of this model updates all of them, and have their own
+    # activations, temporaries and masks. This model is the instance of its
+    # own sequence length. Instances are returned in the order of seq_lens
+    # together with the next tag.
+    def create_buckets(self, seq_lens: List[int], seq_len_tiles: List[int], \
+            next_tag: int):
+        if len(seq_lens) != len(seq_len_tiles):
+            raise ValueError("Every bucket shall have its tile")
+        if self.kv_cache_size > 0:
+            raise RuntimeError("Buckets are for training without KV-cache")
+        if max(seq_lens) > self.max_position_embeddings:
+            raise ValueError("Buckets shall not be longer than the number " \
+                    "of positional embeddings")
+        x = self.activations[0].value
+        buckets = []
+        # The model itself is the first bucket of its shape, repeated
+        # buckets of the same shape are other sets of activations
+        used_self = False
+        for seq_len, seq_len_tile in zip(seq_lens, seq_len_tiles):
+            if not used_self and seq_len == x.shape[0] \
+                    and seq_len_tile == x.basetile_shape[0]:
+                buckets.append(self)
+                used_self = True
+            else:
+                bucket, next_tag = self.create_plan(seq_len, seq_len_tile, \
+                        next_tag)
+                buckets.append(bucket)
+        return buckets, next_tag
 
     def to_torch(self, base_torch_model):
+        if self.moe_num_experts > 0:
+            raise NotImplementedError("GPT2 checkpoints have no experts")
         nntile_p_idx = 0
         attn_embed_dim = self.embed_dim
         attn_nheads = self.n_head
@@ -221,10 +671,24 @@ class GPT2Model(BaseModel):
         for name, p in base_torch_model.named_parameters():
             layer_name = name.split(".")[-2]
             if layer_name in ("lm_head",):
+                # Weight of the fused head is split into chunks
                 p_np = np.array(np.zeros(p.shape, dtype=np.float32), order="F")
-                self.parameters[nntile_p_idx].value.to_array(p_np)
+                start = 0
+                # Tied head has no parameters of its own
+                if type(self.lm_head) is TiedLinear:
+                    w_np = np.zeros(self.lm_head.w.value.shape, \
+                            dtype=np.float32, order="F")
+                    self.lm_head.w.value.to_array(w_np)
+                    p_np[:] = w_np.T
+                for p_nntile in self.lm_head.parameters:
+                    end = start + p_nntile.value.shape[0]
+                    p_chunk_np = np.zeros(p_nntile.value.shape, \
+                            dtype=np.float32, order="F")
+                    p_nntile.value.to_array(p_chunk_np)
+                    p_np[start:end] = p_chunk_np
+                    start = end
                 p.data = torch.from_numpy(p_np)
-                nntile_p_idx += 1
+                nntile_p_idx += len(self.lm_head.parameters)
             elif layer_name == "c_attn" and name.split(".")[-1] == "weight":
                 # p_torch_np = p_torch.cpu().detach().numpy()
                 # Read Q, K and V weights
@@ -273,16 +737,26 @@ class GPT2Model(BaseModel):
                 p.data = torch.from_numpy(p_np.T)
                 nntile_p_idx += 1
 
+    # Create model with input tokens and positional ids of the given shape
     @staticmethod
-    def from_torch(torch_gpt2, batch_size: int, batch_size_tile: int, \
-            seq_len: int, seq_len_tile: int, config: GPT2Config, \
-            next_tag: int, fp32_fast_tf32: bool=False):
-        positional_ids_traits = TensorTraits([seq_len], [seq_len_tile])
+    def _generate(batch_size: int, batch_size_tile: int, seq_len: int, \
+            seq_len_tile: int, config: GPT2Config, next_tag: int, \
+            fp32_fast_tf32: bool=False, kv_cache_size: int=0, \
+            kv_cache_size_tile: int=0, kv_cache_per_sequence: bool=False, \
+            kv_cache_pages: int=0, inference: bool=False):
+        positional_ids_np = np.arange(seq_len)
+        if kv_cache_per_sequence:
+            positional_ids_traits = TensorTraits([seq_len, batch_size], \
+                    [seq_len_tile, batch_size_tile])
+            positional_ids_np = np.repeat(positional_ids_np[:, np.newaxis], \
+                    batch_size, axis=1)
+        else:
+            positional_ids_traits = TensorTraits([seq_len], [seq_len_tile])
         positional_ids_distr = [0] * positional_ids_traits.grid.nelems
         positional_ids_value = Tensor_int64(positional_ids_traits, \
                 positional_ids_distr, next_tag)
         next_tag = positional_ids_value.next_tag
-        positional_ids_value.from_array(np.array(np.arange(seq_len), \
+        positional_ids_value.from_array(np.array(positional_ids_np, \
                 order="F", dtype=np.int64))
         positional_ids = TensorMoments(positional_ids_value, None, False)
         
@@ -296,7 +770,27 @@ class GPT2Model(BaseModel):
         x_moments = TensorMoments(x, x_grad, x_grad_required)
 
         gpt2_nntile = GPT2Model(x_moments, positional_ids, config, next_tag, \
-                fp32_fast_tf32=fp32_fast_tf32)
+                fp32_fast_tf32=fp32_fast_tf32, kv_cache_size=kv_cache_size, \
+                kv_cache_size_tile=kv_cache_size_tile, \
+                kv_cache_per_sequence=kv_cache_per_sequence, \
+                kv_cache_pages=kv_cache_pages, inference=inference)
+        return gpt2_nntile
+
+    @staticmethod
+    def from_torch(torch_gpt2, batch_size: int, batch_size_tile: int, \
+            seq_len: int, seq_len_tile: int, config: GPT2Config, \
+            next_tag: int, fp32_fast_tf32: bool=False, \
+            kv_cache_size: int=0, kv_cache_size_tile: int=0, \
+            kv_cache_per_sequence: bool=False, kv_cache_pages: int=0, \
+            inference: bool=False):
+        if config.get("moe_num_experts", 0) > 0:
+            raise NotImplementedError("GPT2 checkpoints have no experts")
+        gpt2_nntile = GPT2Model._generate(batch_size, batch_size_tile, \
+                seq_len, seq_len_tile, config, next_tag, \
+                fp32_fast_tf32=fp32_fast_tf32, kv_cache_size=kv_cache_size, \
+                kv_cache_size_tile=kv_cache_size_tile, \
+                kv_cache_per_sequence=kv_cache_per_sequence, \
+                kv_cache_pages=kv_cache_pages, inference=inference)
         nntile_p_idx = 0
         attn_embed_dim = config["embed_dim"]
         attn_nheads = config["n_head"]
@@ -304,9 +798,14 @@ class GPT2Model(BaseModel):
         for name, p_torch in torch_gpt2.named_parameters():
             layer_name = name.split(".")[-2]
             if layer_name in ("lm_head",):
-                p_nntile = gpt2_nntile.parameters[nntile_p_idx]
-                p_nntile.value.from_array(p_torch.cpu().detach().numpy())
-                nntile_p_idx += 1
+                # Weight of the fused head is split into chunks
+                p_torch_np = p_torch.cpu().detach().numpy()
+                start = 0
+                for p_nntile in gpt2_nntile.lm_head.parameters:
+                    end = start + p_nntile.value.shape[0]
+                    p_nntile.value.from_array(p_torch_np[start:end])
+                    start = end
+                nntile_p_idx += len(gpt2_nntile.lm_head.parameters)
             elif layer_name == "c_attn" and name.split(".")[-1] == "weight":
                 p_torch_np = p_torch.cpu().detach().numpy()
                 # Read Q, K and V weights
@@ -347,9 +846,79 @@ class GPT2Model(BaseModel):
                 nntile_p_idx += 1
 
         return gpt2_nntile, gpt2_nntile.next_tag
+
+    # Load weights of a HuggingFace GPT2 checkpoint in safetensors format
+    # without PyTorch. Tiles are filled in parallel right from tensors of
+    # memory-mapped files, so host memory is not doubled. Layout of
+    # parameters is the same as in from_torch. Weights of the head are taken
+    # from the embedding of tokens, if they are tied.
+    @staticmethod
+    def from_safetensors(path: str, batch_size: int, batch_size_tile: int, \
+            seq_len: int, seq_len_tile: int, config: GPT2Config, \
+            next_tag: int, fp32_fast_tf32: bool=False, \
+            kv_cache_size: int=0, kv_cache_size_tile: int=0, \
+            kv_cache_per_sequence: bool=False, kv_cache_pages: int=0, \
+            inference: bool=False):
+        if config.get("moe_num_experts", 0) > 0:
+            raise NotImplementedError("GPT2 checkpoints have no experts")
+        gpt2_nntile = GPT2Model._generate(batch_size, batch_size_tile, \
+                seq_len, seq_len_tile, config, next_tag, \
+                fp32_fast_tf32=fp32_fast_tf32, kv_cache_size=kv_cache_size, \
+                kv_cache_size_tile=kv_cache_size_tile, \
+                kv_cache_per_sequence=kv_cache_per_sequence, \
+                kv_cache_pages=kv_cache_pages, inference=inference)
+        weights = SafetensorsCheckpoint(path)
+        embed_dim = config["embed_dim"]
+        n_head = config["n_head"]
+        head_size = embed_dim // n_head
+        params = iter(gpt2_nntile.parameters)
+        # Conv1D of HuggingFace stores transposed weights
+        def load(name, transform=lambda a: a.T):
+            p = next(params, None)
+            if p is None:
+                raise ValueError("Checkpoint has more tensors than the model")
+            weights.load_async(p.value, name, transform)
+        load("wte.weight")
+        load("wpe.weight")
+        for i in range(config["num_hidden_layers"]):
+            h = "h.{}.".format(i)
+            load(h+"ln_1.weight")
+            load(h+"ln_1.bias")
+            # Q, K and V weights and biases
+            for j in range(3):
+                load(h+"attn.c_attn.weight", lambda a, j=j: \
+                        a[:, j*embed_dim:(j+1)*embed_dim].T \
+                        .reshape(n_head, head_size, embed_dim))
+            for j in range(3):
+                load(h+"attn.c_attn.bias", lambda a, j=j: \
+                        a[j*embed_dim:(j+1)*embed_dim] \
+                        .reshape(n_head, head_size).T)
+            load(h+"attn.c_proj.weight", lambda a: \
+                    a.T.reshape(embed_dim, n_head, head_size))
+            load(h+"attn.c_proj.bias")
+            load(h+"ln_2.weight")
+            load(h+"ln_2.bias")
+            load(h+"mlp.c_fc.weight")
+            load(h+"mlp.c_fc.bias")
+            load(h+"mlp.c_proj.weight")
+            load(h+"mlp.c_proj.bias")
+        load("ln_f.weight")
+        load("ln_f.bias")
+        # Weight of the fused head is split into chunks
+        head = "lm_head.weight" if "lm_head.weight" in weights \
+                else "wte.weight"
+        start = 0
+        for p_nntile in gpt2_nntile.lm_head.parameters:
+            end = start + p_nntile.value.shape[0]
+            load(head, lambda a, start=start, end=end: a[start:end])
+            start = end
+        if next(params, None) is not None:
+            raise ValueError("Checkpoint has less tensors than the model")
+        weights.wait()
+        return gpt2_nntile, gpt2_nntile.next_tag
     
-    def unregister(self):
-        super().unregister()
+    def unregister(self, wait: bool=False):
         if self.mask:
-            self.mask.unregister()
+            self.mask.unregister_submit()
+        super().unregister(wait)
 
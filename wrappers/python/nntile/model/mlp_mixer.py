@@ -11,10 +11,10 @@
 # @author Gleb Karpov
 # @date 2023-09-07
 
-from nntile.tensor import TensorTraits, Tensor_fp32, TensorMoments, notrans, clear_async
+from nntile.tensor import TensorTraits, Tensor_fp32, TensorMoments, notrans, trans, clear_async
 from nntile.model.base_model import BaseModel
 from nntile.layer.linear import Linear
-from nntile.layer.mixer import Mixer, GAP
+from nntile.layer.mixer import Mixer, FusedMixer, GAP
 import numpy as np
 import torch
 
@@ -22,8 +22,10 @@ import torch
 class MlpMixer(BaseModel):
     next_tag: int
 
-    # Construct model with all the provided data
-    def __init__(self, x: TensorMoments, embedding_dim: int, n_layers: int, n_classes: int, next_tag: int):
+    # Construct model with all the provided data. Fused mixer blocks have
+    # biases and the tanh approximation of GeLU (see FusedMixer).
+    def __init__(self, x: TensorMoments, embedding_dim: int, n_layers: int, n_classes: int, next_tag: int,
+            fused: bool=False):
 
         # Check number of layers
         if n_layers < 1:
@@ -44,7 +46,11 @@ class MlpMixer(BaseModel):
         activations.extend(new_layer.activations_output)
 
         for _ in range(1, n_layers + 1):
-            new_layer, next_tag = Mixer.generate_simple(activations[-1], next_tag)
+            if fused:
+                new_layer, next_tag = FusedMixer.generate_simple( \
+                        activations[-1], next_tag)
+            else:
+                new_layer, next_tag = Mixer.generate_simple(activations[-1], next_tag)
             layers.append(new_layer)
             activations.extend(new_layer.activations_output)
 
@@ -53,8 +59,9 @@ class MlpMixer(BaseModel):
         layers.append(new_layer)
         activations.extend(new_layer.activations_output)
 
-        # Final classification fully connected layer
-        new_layer, next_tag = Linear.generate_simple(activations[-1], 'R', notrans, 1, [n_classes], [n_classes], next_tag,bias=False)
+        # Final classification fully connected layer, that contracts the
+        # last axis of non-transposed output of GAP
+        new_layer, next_tag = Linear.generate_simple(activations[-1], 'R', trans, 1, [n_classes], [n_classes], next_tag,bias=False)
         layers.append(new_layer)
         activations.extend(new_layer.activations_output)
         
@@ -64,11 +71,8 @@ class MlpMixer(BaseModel):
 
     
     # Unregister all tensors related to this model
-    def unregister(self):
-        for l in self.layers:
-            l.unregister()
-        for x in self.activations:
-            x.unregister()
+    def unregister(self, wait: bool=False):
+        super().unregister(wait)
 
 
     # Clear gradients of inter-layer activations
@@ -22,34 +22,122 @@
 #include <sstream>
 #include <cstring>
 #include <thread>
+#include <tuple>
+#ifdef NNTILE_USE_CUDA
+#   include <cuda_runtime.h>
+#endif // NNTILE_USE_CUDA
 
 using namespace nntile;
 namespace py = pybind11;
 
+// BF16 and FP16 scalars are passed from and to Python as floats
+namespace pybind11::detail
+{
+template<>
+struct type_caster<bf16_t>
+{
+    PYBIND11_TYPE_CASTER(bf16_t, _("float"));
+    bool load(handle src, bool convert)
+    {
+        type_caster<fp32_t> caster;
+        if(not caster.load(src, convert))
+        {
+            return false;
+        }
+        value = static_cast<fp32_t>(caster);
+        return true;
+    }
+    static handle cast(bf16_t src, return_value_policy policy, handle parent)
+    {
+        return PyFloat_FromDouble(static_cast<fp32_t>(src));
+    }
+};
+
+template<>
+struct type_caster<fp16_t>
+{
+    PYBIND11_TYPE_CASTER(fp16_t, _("float"));
+    bool load(handle src, bool convert)
+    {
+        type_caster<fp32_t> caster;
+        if(not caster.load(src, convert))
+        {
+            return false;
+        }
+        value = static_cast<fp32_t>(caster);
+        return true;
+    }
+    static handle cast(fp16_t src, return_value_policy policy, handle parent)
+    {
+        return PyFloat_FromDouble(static_cast<fp32_t>(src));
+    }
+};
+} // namespace pybind11::detail
+
 constexpr auto _wait_for_all_sleep_time = std::chrono::milliseconds(1);
 
+// Submission of tasks and waiting for them do not touch Python objects, so
+// such wrappers release the GIL and other Python threads, e.g., ones that
+// prepare the next batch, run meanwhile
+using release_gil = py::call_guard<py::gil_scoped_release>;
+
 // Extend (sub)module with nntile::starpu functionality
 void def_mod_starpu(py::module_ &m)
 {
     using namespace nntile::starpu;
     using namespace std::chrono_literals;
     py::class_<Config>(m, "Config").
-        def(py::init<int, int, int>()).
+        def(py::init<int, int, int, const std::string &,
+                const std::string &, std::size_t, bool, int>(),
+                py::arg("ncpus")=-1, py::arg("ncuda")=-1,
+                py::arg("cublas")=-1, py::arg("sched")="dmda",
+                py::arg("disk_path")="", py::arg("disk_size")=0,
+                py::arg("numa")=false, py::arg("nworker_per_cuda")=1).
+        def("attach_disk", &Config::attach_disk).
+        def_readonly("disk_node", &Config::disk_node).
+        def("sched_ctx_create", &Config::sched_ctx_create,
+                py::arg("workers"), py::arg("name"), py::arg("policy")="").
+        def("sched_ctx_delete", &Config::sched_ctx_delete).
         def("shutdown", &Config::shutdown);
+    // Scheduling contexts of workers for co-located workloads
+    m.def("sched_ctx_enter", Config::sched_ctx_enter);
+    m.def("sched_ctx_exit", Config::sched_ctx_exit);
+    m.def("sched_ctx_add_workers", Config::sched_ctx_add_workers);
+    m.def("sched_ctx_remove_workers", Config::sched_ctx_remove_workers);
+    m.def("sched_ctx_get_workers", Config::sched_ctx_get_workers);
+    m.def("sched_ctx_wait", Config::sched_ctx_wait,
+            py::call_guard<py::gil_scoped_release>());
+    m.def("get_worker_ids", Config::get_worker_ids, py::arg("cuda")=false);
+    // Locality-aware scheduler and priorities of submitted tasks
+    m.attr("scheduler_locality") = scheduler::name;
+    m.def("priority_set", scheduler::priority_set);
+    m.def("priority_get", scheduler::priority_get);
+    m.def("priority_background_set", scheduler::priority_background_set);
+    m.def("priority_background_get", scheduler::priority_background_get);
+    // Restriction of kinds of workers for submitted tasks
+    m.attr("where_cpu") = static_cast<uint32_t>(STARPU_CPU);
+    m.attr("where_cuda") = static_cast<uint32_t>(STARPU_CUDA);
+    m.def("where_set", scheduler::where_set);
+    m.def("where_get", scheduler::where_get);
+    m.def("get_ndevices", scheduler::get_ndevices);
+    m.def("get_nnuma", scheduler::get_nnuma);
+    // Threads, that submit tasks of tiles of tensor operations
+    m.def("submitters_set_nthreads", submitters::set_nthreads);
+    m.def("submitters_get_nthreads", submitters::get_nthreads);
     m.def("init", init);
     m.def("pause", starpu_pause);
     m.def("resume", starpu_resume);
     m.def("wait_for_all", [](){
             while(true)
             {
-                int nsubmitted = starpu_task_nsubmitted();
-                //int nready = starpu_task_nready();
-                //std::cout << "S=" << nsubmitted << " R=" << nready << "\n";
-                //if (nready > nsubmitted)
-                //{
-                //    std::cout << "======================\n";
-                //}
-                std::this_thread::sleep_for(_wait_for_all_sleep_time);
+                int nsubmitted;
+                // Other Python threads run while tasks are executed, the GIL
+                // is taken back only to check for signals
+                {
+                    py::gil_scoped_release release;
+                    nsubmitted = starpu_task_nsubmitted();
+                    std::this_thread::sleep_for(_wait_for_all_sleep_time);
+                }
                 if(nsubmitted == 0)
                 {
                     break;
@@ -59,10 +147,212 @@ void def_mod_starpu(py::module_ &m)
                     throw py::error_already_set();
                 }
             }
+            py::gil_scoped_release release;
             starpu_mpi_wait_for_all(MPI_COMM_WORLD);});
+    m.def("mpi_world_size", [](){return starpu_mpi_world_size();});
+    m.def("mpi_world_rank", [](){return starpu_mpi_world_rank();});
+    m.def("mpi_barrier", [](){starpu_mpi_barrier(MPI_COMM_WORLD);},
+            py::call_guard<py::gil_scoped_release>());
+    m.def("tile_io_nerrors", tile_io::get_nerrors);
     m.def("restrict_cuda", [](){restrict_where(STARPU_CUDA);});
     m.def("restrict_cpu", [](){restrict_where(STARPU_CPU);});
     m.def("restrict_restore", [](){restore_where();});
+    m.def("offload_enter", offload::enter);
+    m.def("offload_exit", offload::exit);
+    m.def("offload_is_active", offload::is_active);
+    m.def("direct_enter", direct::enter);
+    m.def("direct_exit", direct::exit);
+    m.def("direct_is_active", direct::is_active);
+    m.def("commute_enable", [](){Config::commute_enable();});
+    m.def("commute_disable", [](){Config::commute_disable();});
+    m.def("commute_is_enabled", [](){return Config::commute_is_enabled();});
+    m.def("deterministic_enable", [](){Config::deterministic_enable();});
+    m.def("deterministic_disable", [](){Config::deterministic_disable();});
+    m.def("deterministic_is_enabled",
+            [](){return Config::deterministic_is_enabled();});
+    m.def("perfmodel_dir", [](){return Config::perfmodel_dir().string();});
+    m.def("perfmodel_set_profile", Config::perfmodel_set_profile);
+    m.def("perfmodel_import", Config::perfmodel_import);
+    m.def("perfmodel_export", Config::perfmodel_export);
+    m.def("stats_enable", [](){Codelet::stats_enable();});
+    m.def("stats_disable", [](){Codelet::stats_disable();});
+    m.def("stats_is_enabled", [](){return Codelet::stats_is_enabled();});
+    m.def("stats_reset", [](){Codelet::stats_reset();});
+    // Statistics of all codelets, that executed at least one task
+    m.def("stats_get", [](){
+            py::list result;
+            for(auto cl: Codelet::get_registry())
+            {
+                CodeletWorkerStats total;
+                py::list workers;
+                for(int i = 0; i < cl->stats.size(); ++i)
+                {
+                    const auto &s = cl->stats[i];
+                    if(s.ntasks == 0)
+                    {
+                        continue;
+                    }
+                    char worker_name[64];
+                    starpu_worker_get_name(i, worker_name,
+                            sizeof(worker_name));
+                    py::dict w;
+                    w["worker"] = std::string(worker_name);
+                    w["ntasks"] = s.ntasks;
+                    w["time"] = s.time;
+                    w["flops"] = s.flops;
+                    w["bytes"] = s.bytes;
+                    workers.append(w);
+                    total.ntasks += s.ntasks;
+                    total.time += s.time;
+                    total.flops += s.flops;
+                    total.bytes += s.bytes;
+                }
+                if(total.ntasks == 0)
+                {
+                    continue;
+                }
+                py::dict d;
+                d["name"] = std::string(cl->starpu_codelet::name);
+                d["ntasks"] = total.ntasks;
+                d["time"] = total.time;
+                d["flops"] = total.flops;
+                d["bytes"] = total.bytes;
+                d["gflops"] = total.time > 0 ? total.flops/total.time*1e-9
+                    : 0.0;
+                d["gbps"] = total.time > 0 ? total.bytes/total.time*1e-9
+                    : 0.0;
+                d["workers"] = workers;
+                result.append(d);
+            }
+            return result;});
+    m.def("strassen_enable", strassen::enable,
+            py::arg("leaf_size")=512);
+    m.def("strassen_disable", strassen::disable);
+    m.def("strassen_is_enabled", strassen::is_enabled);
+    m.def("host_pool_enable", HostMemoryPool::enable,
+            py::arg("max_cached")=std::size_t(-1),
+            py::arg("huge_page_size")=std::size_t(0));
+    m.def("host_pool_disable", HostMemoryPool::disable);
+    m.def("host_pool_is_enabled", HostMemoryPool::is_enabled);
+    m.def("host_pool_trim", HostMemoryPool::trim);
+    m.def("host_pool_get_stats", [](){
+            auto s = HostMemoryPool::get_stats();
+            py::dict d;
+            d["nhits"] = s.nhits;
+            d["nmisses"] = s.nmisses;
+            d["used"] = s.used;
+            d["cached"] = s.cached;
+            d["huge"] = s.huge;
+            return d;});
+    m.def("memory_tracking_enable", MemoryTracker::enable,
+            py::arg("sampling_period_ms")=0);
+    m.def("memory_tracking_disable", MemoryTracker::disable);
+    m.def("memory_tracking_is_enabled", MemoryTracker::is_enabled);
+    m.def("memory_sample", MemoryTracker::sample);
+    m.def("memory_reset_peak", MemoryTracker::reset_peak);
+    // Current and peak memory usage of all memory nodes
+    m.def("memory_get_stats", [](){
+            py::list result;
+            auto nodes = MemoryTracker::get_stats();
+            for(unsigned node = 0; node < nodes.size(); ++node)
+            {
+                const auto &s = nodes[node];
+                char node_name[64];
+                starpu_memory_node_get_name(node, node_name,
+                        sizeof(node_name));
+                py::dict d;
+                d["node"] = node;
+                d["name"] = std::string(node_name);
+                d["total"] = starpu_memory_get_total(node);
+                d["starpu_used"] = s.starpu_used;
+                d["starpu_peak"] = s.starpu_peak;
+                d["used"] = s.used;
+                d["peak"] = s.peak;
+                d["used_by_name"] = s.used_by_name;
+                d["peak_by_name"] = s.peak_by_name;
+                result.append(d);
+            }
+            return result;});
+    // All tracked handles with memory nodes, where they are allocated
+    m.def("memory_get_handles", [](){
+            py::list result;
+            for(const auto &[info, nodes]: MemoryTracker::get_handles())
+            {
+                py::dict d;
+                d["name"] = info.name;
+                d["size"] = info.size;
+                d["nodes"] = nodes;
+                result.append(d);
+            }
+            return result;});
+    // Transfers between memory nodes, per pair of nodes and per tensor
+    m.def("transfers_enable", MemoryTracker::transfers_enable);
+    m.def("transfers_disable", MemoryTracker::transfers_disable);
+    m.def("transfers_is_enabled", MemoryTracker::transfers_is_enabled);
+    m.def("transfers_reset", MemoryTracker::transfers_reset);
+    m.def("transfers_get_by_bus", [](){
+            py::list result;
+            for(const auto &s: MemoryTracker::transfers_get_by_bus())
+            {
+                char src_name[64], dst_name[64];
+                starpu_memory_node_get_name(s.src, src_name,
+                        sizeof(src_name));
+                starpu_memory_node_get_name(s.dst, dst_name,
+                        sizeof(dst_name));
+                py::dict d;
+                d["src"] = s.src;
+                d["dst"] = s.dst;
+                d["src_name"] = std::string(src_name);
+                d["dst_name"] = std::string(dst_name);
+                d["bytes"] = s.bytes;
+                d["count"] = s.count;
+                d["time"] = s.time;
+                result.append(d);
+            }
+            return result;});
+    m.def("transfers_get_by_name", [](){
+            py::list result;
+            for(const auto &[name, s]: MemoryTracker::transfers_get_by_name())
+            {
+                py::dict d;
+                d["name"] = name;
+                d["src"] = s.src;
+                d["dst"] = s.dst;
+                d["bytes"] = s.bytes;
+                d["count"] = s.count;
+                result.append(d);
+            }
+            return result;});
+    // Timeline of tasks in the Chrome trace format
+    m.def("trace_enable", trace::enable);
+    m.def("trace_disable", trace::disable);
+    m.def("trace_is_enabled", trace::is_enabled);
+    m.def("trace_clear", trace::clear);
+    m.def("trace_scope_set", trace::scope_set);
+    m.def("trace_scope_get", trace::scope_get);
+    m.def("trace_export", trace::export_json);
+    m.def("trace_get_events", [](){
+            py::list result;
+            for(const auto &event: trace::get_events())
+            {
+                py::dict d;
+                d["name"] = event.name;
+                d["scope"] = event.scope;
+                d["data"] = event.data;
+                d["priority"] = event.priority;
+                d["flops"] = event.flops;
+                d["workerid"] = event.workerid;
+                char worker_name[64];
+                starpu_worker_get_name(event.workerid, worker_name,
+                        sizeof(worker_name));
+                d["worker"] = std::string(worker_name);
+                d["submit_us"] = event.submit_us;
+                d["fetch_us"] = event.fetch_us;
+                d["start_us"] = event.start_us;
+                d["end_us"] = event.end_us;
+                result.append(d);
+            }
+            return result;});
     m.def("profiling_init", [](){
             //starpu_profiling_init();
             });
@@ -165,11 +455,13 @@ void def_class_tile(py::module_ &m, const char *name)
     using namespace nntile::tile;
     py::class_<Tile<T>, TileTraits>(m, name, py::multiple_inheritance()).
         def(py::init<const TileTraits &>()).
-        def("unregister", &Tile<T>::unregister).
-        def("from_array", tile_from_array<T>).
-        def("to_array", tile_to_array<T>);
-    m.def("tile_from_array", tile_from_array<T>);
-    m.def("tile_to_array", tile_to_array<T>);
+        def("unregister", &Tile<T>::unregister, release_gil()).
+        def("unregister_submit", &Tile<T>::unregister_submit, release_gil()).
+        // Copies acquire the tile and wait for tasks on it
+        def("from_array", tile_from_array<T>, release_gil()).
+        def("to_array", tile_to_array<T>, release_gil());
+    m.def("tile_from_array", tile_from_array<T>, release_gil());
+    m.def("tile_to_array", tile_to_array<T>, release_gil());
 }
 
 // Extend (sub)module with nntile::tile functionality
@@ -202,10 +494,172 @@ void def_mod_tile(py::module_ &m)
     def_class_tile<fp64_t>(m, "Tile_fp64");
 }
 
+// Copy elements between numpy array and tile, converting them if needed. Types
+// without numpy counterpart (BF16) are exchanged through their compute type.
+template<typename Src, typename Dst>
+static void copy_elems(Index nelems, const Src *src, Dst *dst)
+{
+    if constexpr(std::is_same_v<Src, Dst>)
+    {
+        std::memcpy(dst, src, nelems*sizeof(Dst));
+    }
+    else
+    {
+        for(Index i = 0; i < nelems; ++i)
+        {
+            dst[i] = src[i];
+        }
+    }
+}
+
+#ifdef NNTILE_USE_CUDA
+// Copy a tile from or to a contiguous Fortran-order array on its CUDA device
+/*! Tiles, that have an owner device (see starpu::scheduler::set_device), are
+ * written right into memory of the device, and tiles, that are already
+ * valid on their device, are read from there. Slabs of shape[0]*shape[1]
+ * elements are copied by cudaMemcpy2D, so that neither a host buffer of a
+ * tile nor a transfer of a tile back to the host is needed. Returns false,
+ * if the tile shall be copied through the host.
+ * */
+template<typename T, typename A, bool from_array>
+static bool copy_tile_device(const tile::Tile<T> &tile,
+        const std::vector<Index> &stride, A *array)
+{
+    if constexpr(!std::is_same_v<std::remove_const_t<A>, T>)
+    {
+        return false;
+    }
+    else
+    {
+        auto handle = static_cast<starpu_data_handle_t>(tile);
+        int node = starpu::scheduler::get_device_node(handle);
+        if(node < 0)
+        {
+            return false;
+        }
+        if(!from_array and !starpu_data_is_on_node(handle, node))
+        {
+            return false;
+        }
+        starpu_data_acquire_on_node(handle, node,
+                from_array ? STARPU_W : STARPU_R);
+        T *tile_ptr = reinterpret_cast<T *>(
+                starpu_data_handle_to_pointer(handle, node));
+        Index nrows = tile.ndim > 1 ? tile.shape[1] : 1;
+        Index tile_ld = tile.shape[0];
+        Index array_ld = tile.ndim > 1 ? stride[1] : tile.shape[0];
+        Index nslabs = tile.nelems / (tile_ld*nrows);
+        std::vector<Index> slab_index(tile.ndim, 0);
+        cudaError_t err = cudaSuccess;
+        for(Index k = 0; k < nslabs and err == cudaSuccess; ++k)
+        {
+            Index array_offset = 0;
+            for(Index j = 2; j < tile.ndim; ++j)
+            {
+                array_offset += slab_index[j] * stride[j];
+            }
+            T *tile_slab = tile_ptr + k*tile_ld*nrows;
+            if constexpr(from_array)
+            {
+                err = cudaMemcpy2D(tile_slab, tile_ld*sizeof(T),
+                        array+array_offset, array_ld*sizeof(T),
+                        tile_ld*sizeof(T), nrows, cudaMemcpyHostToDevice);
+            }
+            else
+            {
+                err = cudaMemcpy2D(array+array_offset, array_ld*sizeof(T),
+                        tile_slab, tile_ld*sizeof(T), tile_ld*sizeof(T),
+                        nrows, cudaMemcpyDeviceToHost);
+            }
+            // Get index of the next slab
+            for(Index j = 2; j < tile.ndim; ++j)
+            {
+                ++slab_index[j];
+                if(slab_index[j] < tile.shape[j])
+                {
+                    break;
+                }
+                slab_index[j] = 0;
+            }
+        }
+        starpu_data_release_on_node(handle, node);
+        if(err != cudaSuccess)
+        {
+            throw std::runtime_error(cudaGetErrorString(err));
+        }
+        return true;
+    }
+}
+#endif // NNTILE_USE_CUDA
+
+// Copy tiles of a tensor from or to a contiguous Fortran-order array
+/*! Each tile is copied directly between its part of the array and its
+ * buffer, so neither a temporary copy of the whole tensor nor a scatter or a
+ * gather is needed. This is only possible if all the tiles are local.
+ * */
+template<typename T, typename A, bool from_array>
+static void copy_tiles(const tensor::Tensor<T> &tensor, A *array)
+{
+    for(Index i = 0; i < tensor.grid.nelems; ++i)
+    {
+        auto tile = tensor.get_tile(i);
+        auto tile_index = tensor.grid.linear_to_index(i);
+        // Offset of the first element of the tile within the array
+        Index offset = 0;
+        for(Index j = 0; j < tensor.ndim; ++j)
+        {
+            offset += tile_index[j] * tensor.basetile_shape[j]
+                * tensor.stride[j];
+        }
+#ifdef NNTILE_USE_CUDA
+        if(copy_tile_device<T, A, from_array>(tile, tensor.stride,
+                    array+offset))
+        {
+            continue;
+        }
+#endif // NNTILE_USE_CUDA
+        auto tile_local = tile.acquire(from_array ? STARPU_W : STARPU_R);
+        T *tile_ptr = tile_local.get_ptr();
+        // Copy contiguous columns of the tile one by one
+        Index ncols = tile.nelems / tile.shape[0];
+        std::vector<Index> col_index(tensor.ndim, 0);
+        for(Index k = 0; k < ncols; ++k)
+        {
+            Index array_offset = offset;
+            for(Index j = 1; j < tensor.ndim; ++j)
+            {
+                array_offset += col_index[j] * tensor.stride[j];
+            }
+            if constexpr(from_array)
+            {
+                copy_elems(tile.shape[0], array+array_offset,
+                        tile_ptr+k*tile.shape[0]);
+            }
+            else
+            {
+                copy_elems(tile.shape[0], tile_ptr+k*tile.shape[0],
+                        array+array_offset);
+            }
+            // Get index of the next column
+            for(Index j = 1; j < tensor.ndim; ++j)
+            {
+                ++col_index[j];
+                if(col_index[j] < tile.shape[j])
+                {
+                    break;
+                }
+                col_index[j] = 0;
+            }
+        }
+        tile_local.release();
+    }
+}
+
 // numpy.ndarray -> Tensor
 template<typename T>
 void tensor_from_array(const tensor::Tensor<T> &tensor,
-        const py::array_t<T, py::array::f_style | py::array::forcecast> &array)
+        const py::array_t<compute_t<T>,
+            py::array::f_style | py::array::forcecast> &array)
 {
     // Treat special 0-dimensional case, where NNTile assumes 1 element in a
     // tensor, while 0-dimensional numpy array assumes there no array elements
@@ -225,7 +679,7 @@ void tensor_from_array(const tensor::Tensor<T> &tensor,
         if(mpi_rank == tile.mpi_get_rank())
         {
             auto tile_local = tile.acquire(STARPU_W);
-            std::memcpy(tile_local.get_ptr(), array.data(), sizeof(T));
+            copy_elems(1, array.data(), tile_local.get_ptr());
             tile_local.release();
         }
         tile.mpi_flush();
@@ -243,12 +697,21 @@ void tensor_from_array(const tensor::Tensor<T> &tensor,
             throw std::runtime_error("array.shape()[i] != tensor.shape[i]");
         }
     }
+    // Copy tiles directly if all of them are local
+    if(starpu_mpi_world_size() == 1)
+    {
+        copy_tiles<T, const compute_t<T>, true>(tensor, array.data());
+        return;
+    }
     // Create temporary single-tile tensor
     tensor::TensorTraits tmp_traits(tensor.shape, tensor.shape);
     int64_t tmp_tag = 0;
     int flag;
-    //starpu_mpi_comm_get_attr(MPI_COMM_WORLD, STARPU_MPI_TAG_UB, &tmp_tag, \
-    //        &flag);
+#ifdef NNTILE_USE_MPI
+    // Temporary tensor uses the largest tag to avoid collisions
+    starpu_mpi_comm_get_attr(MPI_COMM_WORLD, STARPU_MPI_TAG_UB, &tmp_tag,
+            &flag);
+#endif // NNTILE_USE_MPI
     std::vector<int> tmp_distr{0};
     tensor::Tensor<T> tmp(tmp_traits, tmp_distr, tmp_tag);
     // Acquire tile and copy data
@@ -257,8 +720,7 @@ void tensor_from_array(const tensor::Tensor<T> &tensor,
     if(mpi_rank == tile.mpi_get_rank())
     {
         auto tile_local = tile.acquire(STARPU_W);
-        std::memcpy(tile_local.get_ptr(), array.data(),
-                tile.nelems*sizeof(T));
+        copy_elems(tile.nelems, array.data(), tile_local.get_ptr());
         tile_local.release();
     }
     tensor::scatter<T>(tmp, tensor);
@@ -269,7 +731,7 @@ void tensor_from_array(const tensor::Tensor<T> &tensor,
 // Tensor -> numpy.ndarray
 template<typename T>
 void tensor_to_array(const tensor::Tensor<T> &tensor,
-        py::array_t<T, py::array::f_style> &array)
+        py::array_t<compute_t<T>, py::array::f_style> &array)
 {
     // Treat special 0-dimensional case, where NNTile assumes 1 element in a
     // tensor, while 0-dimensional numpy array assumes there no array elements
@@ -289,7 +751,7 @@ void tensor_to_array(const tensor::Tensor<T> &tensor,
         if(mpi_rank == tile.mpi_get_rank())
         {
             auto tile_local = tile.acquire(STARPU_R);
-            std::memcpy(array.mutable_data(), tile_local.get_ptr(), sizeof(T));
+            copy_elems(1, tile_local.get_ptr(), array.mutable_data());
             tile_local.release();
         }
         tile.mpi_flush();
@@ -307,12 +769,21 @@ void tensor_to_array(const tensor::Tensor<T> &tensor,
             throw std::runtime_error("array.shape()[i] != tensor.shape[i]");
         }
     }
+    // Copy tiles directly if all of them are local
+    if(starpu_mpi_world_size() == 1)
+    {
+        copy_tiles<T, compute_t<T>, false>(tensor, array.mutable_data());
+        return;
+    }
     // Create temporary single-tile tensor
     tensor::TensorTraits tmp_traits(tensor.shape, tensor.shape);
     int64_t tmp_tag = 0;
     int flag;
-    //starpu_mpi_comm_get_attr(MPI_COMM_WORLD, STARPU_MPI_TAG_UB, &tmp_tag, \
+#ifdef NNTILE_USE_MPI
+    // Temporary tensor uses the largest tag to avoid collisions
+    starpu_mpi_comm_get_attr(MPI_COMM_WORLD, STARPU_MPI_TAG_UB, &tmp_tag,
             &flag);
+#endif // NNTILE_USE_MPI
     std::vector<int> tmp_distr{0};
     tensor::Tensor<T> tmp(tmp_traits, tmp_distr, tmp_tag);
     tensor::gather<T>(tensor, tmp);
@@ -322,39 +793,548 @@ void tensor_to_array(const tensor::Tensor<T> &tensor,
     if(mpi_rank == tile.mpi_get_rank())
     {
         auto tile_local = tile.acquire(STARPU_R);
-        std::memcpy(array.mutable_data(), tile_local.get_ptr(),
-                tile.nelems*sizeof(T));
+        copy_elems(tile.nelems, tile_local.get_ptr(),
+                array.mutable_data());
         tile_local.release();
     }
     tmp.unregister();
 }
 
+// Copy intersection of tiles of a tensor with a subarray, that starts at a
+// given index, from or to a contiguous Fortran-order array of the subarray
+// shape. Only local tiles, that intersect the subarray, are acquired. Tiles
+// are acquired for reading and writing when data is copied into them, as
+// their elements outside the subarray are kept.
+template<typename T, typename A, bool from_array>
+static void copy_slice_tiles(const tensor::Tensor<T> &tensor,
+        const std::vector<Index> &start, const std::vector<Index> &shape,
+        A *array)
+{
+    Index ndim = tensor.ndim;
+    // Range of indices of intersecting tiles
+    std::vector<Index> tile_begin(ndim), tile_end(ndim);
+    Index ntiles = 1;
+    for(Index j = 0; j < ndim; ++j)
+    {
+        if(shape[j] == 0)
+        {
+            return;
+        }
+        tile_begin[j] = start[j] / tensor.basetile_shape[j];
+        tile_end[j] = (start[j]+shape[j]-1)/tensor.basetile_shape[j] + 1;
+        ntiles *= tile_end[j] - tile_begin[j];
+    }
+    std::vector<Index> array_stride(ndim);
+    for(Index j = 0, stride = 1; j < ndim; ++j)
+    {
+        array_stride[j] = stride;
+        stride *= shape[j];
+    }
+    std::vector<Index> tile_index(tile_begin);
+    for(Index t = 0; t < ntiles; ++t)
+    {
+        auto tile = tensor.get_tile(tile_index);
+        // Intersection of the tile and the subarray in global indices
+        std::vector<Index> lo(ndim), hi(ndim);
+        for(Index j = 0; j < ndim; ++j)
+        {
+            Index tile_start = tile_index[j] * tensor.basetile_shape[j];
+            lo[j] = std::max(start[j], tile_start);
+            hi[j] = std::min(start[j]+shape[j], tile_start+tile.shape[j]);
+        }
+        auto tile_local = tile.acquire(from_array ? STARPU_RW : STARPU_R);
+        T *tile_ptr = tile_local.get_ptr();
+        // Copy contiguous columns of the intersection one by one
+        Index nrows = hi[0] - lo[0];
+        Index ncols = 1;
+        for(Index j = 1; j < ndim; ++j)
+        {
+            ncols *= hi[j] - lo[j];
+        }
+        std::vector<Index> col_index(lo);
+        for(Index k = 0; k < ncols; ++k)
+        {
+            Index tile_offset = 0, array_offset = 0;
+            for(Index j = 0; j < ndim; ++j)
+            {
+                Index tile_start = tile_index[j] * tensor.basetile_shape[j];
+                tile_offset += (col_index[j]-tile_start) * tile.stride[j];
+                array_offset += (col_index[j]-start[j]) * array_stride[j];
+            }
+            if constexpr(from_array)
+            {
+                copy_elems(nrows, array+array_offset, tile_ptr+tile_offset);
+            }
+            else
+            {
+                copy_elems(nrows, tile_ptr+tile_offset, array+array_offset);
+            }
+            // Get index of the next column
+            for(Index j = 1; j < ndim; ++j)
+            {
+                ++col_index[j];
+                if(col_index[j] < hi[j])
+                {
+                    break;
+                }
+                col_index[j] = lo[j];
+            }
+        }
+        tile_local.release();
+        // Get index of the next tile
+        for(Index j = 0; j < ndim; ++j)
+        {
+            ++tile_index[j];
+            if(tile_index[j] < tile_end[j])
+            {
+                break;
+            }
+            tile_index[j] = tile_begin[j];
+        }
+    }
+}
+
+// Check that a subarray of a given shape, that starts at a given index, is
+// within a tensor
+static void check_slice(const tensor::TensorTraits &traits,
+        const std::vector<Index> &start, const py::array &array)
+{
+    if(traits.ndim == 0)
+    {
+        throw std::runtime_error("Slices of 0-dimensional tensors are not "
+                "supported");
+    }
+    if(start.size() != traits.ndim)
+    {
+        throw std::runtime_error("start.size() != tensor.ndim");
+    }
+    if(array.ndim() != traits.ndim)
+    {
+        throw std::runtime_error("tensor.ndim != array.ndim()");
+    }
+    for(Index i = 0; i < traits.ndim; ++i)
+    {
+        if(start[i] < 0 or start[i]+array.shape()[i] > traits.shape[i])
+        {
+            throw std::runtime_error("Subarray is out of the tensor");
+        }
+    }
+}
+
+// Subarray of Tensor, that starts at a given index -> numpy.ndarray
+/*! Only tiles, that intersect the subarray, are read. If not all the tiles
+ * are local, the subarray is collected by copy_intersection into a temporary
+ * single-tile tensor of the root node instead of the whole tensor.
+ * */
+template<typename T>
+void tensor_to_array_slice(const tensor::Tensor<T> &tensor,
+        py::array_t<compute_t<T>, py::array::f_style> &array,
+        const std::vector<Index> &start)
+{
+    check_slice(tensor, start, array);
+    std::vector<Index> shape(array.shape(), array.shape()+array.ndim());
+    if(starpu_mpi_world_size() == 1)
+    {
+        copy_slice_tiles<T, compute_t<T>, false>(tensor, start, shape,
+                array.mutable_data());
+        return;
+    }
+    // Create temporary single-tile tensor
+    tensor::TensorTraits tmp_traits(shape, shape);
+    int64_t tmp_tag = 0;
+    int flag;
+#ifdef NNTILE_USE_MPI
+    // Temporary tensor uses the largest tag to avoid collisions
+    starpu_mpi_comm_get_attr(MPI_COMM_WORLD, STARPU_MPI_TAG_UB, &tmp_tag,
+            &flag);
+#endif // NNTILE_USE_MPI
+    std::vector<int> tmp_distr{0};
+    tensor::Tensor<T> tmp(tmp_traits, tmp_distr, tmp_tag);
+    std::vector<Index> zero(tensor.ndim, 0);
+    tensor::copy_intersection<T>(tensor, zero, tmp, start);
+    // Acquire tile and copy data
+    int mpi_rank = starpu_mpi_world_rank();
+    auto tile = tmp.get_tile(0);
+    if(mpi_rank == tile.mpi_get_rank())
+    {
+        auto tile_local = tile.acquire(STARPU_R);
+        copy_elems(tile.nelems, tile_local.get_ptr(),
+                array.mutable_data());
+        tile_local.release();
+    }
+    tmp.unregister();
+}
+
+// numpy.ndarray -> subarray of Tensor, that starts at a given index
+/*! Only tiles, that intersect the subarray, are updated, and their other
+ * elements are kept.
+ * */
+template<typename T>
+void tensor_from_array_slice(const tensor::Tensor<T> &tensor,
+        const py::array_t<compute_t<T>,
+            py::array::f_style | py::array::forcecast> &array,
+        const std::vector<Index> &start)
+{
+    check_slice(tensor, start, array);
+    std::vector<Index> shape(array.shape(), array.shape()+array.ndim());
+    if(starpu_mpi_world_size() == 1)
+    {
+        copy_slice_tiles<T, const compute_t<T>, true>(tensor, start, shape,
+                array.data());
+        return;
+    }
+    // Create temporary single-tile tensor
+    tensor::TensorTraits tmp_traits(shape, shape);
+    int64_t tmp_tag = 0;
+    int flag;
+#ifdef NNTILE_USE_MPI
+    // Temporary tensor uses the largest tag to avoid collisions
+    starpu_mpi_comm_get_attr(MPI_COMM_WORLD, STARPU_MPI_TAG_UB, &tmp_tag,
+            &flag);
+#endif // NNTILE_USE_MPI
+    std::vector<int> tmp_distr{0};
+    tensor::Tensor<T> tmp(tmp_traits, tmp_distr, tmp_tag);
+    // Acquire tile and copy data
+    int mpi_rank = starpu_mpi_world_rank();
+    auto tile = tmp.get_tile(0);
+    if(mpi_rank == tile.mpi_get_rank())
+    {
+        auto tile_local = tile.acquire(STARPU_W);
+        copy_elems(tile.nelems, array.data(), tile_local.get_ptr());
+        tile_local.release();
+    }
+    std::vector<Index> zero(tensor.ndim, 0);
+    tensor::copy_intersection<T>(tmp, start, tensor, zero);
+    tmp.unregister();
+    tensor.mpi_flush();
+}
+
+// List of numpy.ndarray -> Tensor without copying
+/*! Local tiles are registered with memory of the provided arrays, one array
+ * per tile in the order of tiles. Arrays shall be writeable and contiguous in
+ * a Fortran order with exactly the same type and shape as their tiles, as
+ * no conversion is allowed. Arrays for tiles of other MPI nodes are ignored.
+ * */
+template<typename T>
+tensor::Tensor<T> tensor_from_buffers(const tensor::TensorTraits &traits,
+        const std::vector<int> &distribution, starpu_mpi_tag_t next_tag,
+        const std::vector<py::array_t<T, py::array::f_style>> &buffers)
+{
+    if(buffers.size() != traits.grid.nelems)
+    {
+        throw std::runtime_error("buffers.size() != traits.grid.nelems");
+    }
+    if(distribution.size() != traits.grid.nelems)
+    {
+        throw std::runtime_error("Wrong distribution");
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    std::vector<T *> tile_ptrs(traits.grid.nelems, nullptr);
+    for(Index i = 0; i < traits.grid.nelems; ++i)
+    {
+        if(distribution[i] != mpi_rank)
+        {
+            continue;
+        }
+        const auto &buffer = buffers[i];
+        auto tile_shape = traits.get_tile_shape(traits.grid.linear_to_index(
+                    i));
+        if(not buffer.writeable())
+        {
+            throw std::runtime_error("Buffer is not writeable");
+        }
+        if(buffer.ndim() != static_cast<Index>(tile_shape.size()))
+        {
+            throw std::runtime_error("buffer.ndim() != tile.ndim");
+        }
+        for(Index j = 0; j < buffer.ndim(); ++j)
+        {
+            if(buffer.shape()[j] != tile_shape[j])
+            {
+                throw std::runtime_error("buffer.shape()[j] != "
+                        "tile.shape[j]");
+            }
+        }
+        tile_ptrs[i] = const_cast<T *>(buffer.data());
+    }
+    return tensor::Tensor<T>(traits, distribution, next_tag, tile_ptrs);
+}
+
+// Strided numpy.ndarray -> Tensor by tasks
+/*! Arrays of any strides are accepted, e.g. transposed or sliced views of a
+ * memory-mapped file. BF16 values are passed as uint16 arrays with bf16 set.
+ * The array shall not be freed until the tasks are done.
+ * */
+template<typename T>
+void tensor_load_strided_async(const tensor::Tensor<T> &tensor,
+        const py::array &array, bool bf16)
+{
+    using starpu::tile_io::src_type_t;
+    src_type_t src_type;
+    if(bf16)
+    {
+        if(not py::isinstance<py::array_t<std::uint16_t>>(array))
+        {
+            throw std::runtime_error("BF16 values shall be passed as "
+                    "uint16");
+        }
+        src_type = src_type_t::bf16;
+    }
+    else if(py::isinstance<py::array_t<fp64_t>>(array))
+    {
+        src_type = src_type_t::fp64;
+    }
+    else if(py::isinstance<py::array_t<fp32_t>>(array))
+    {
+        src_type = src_type_t::fp32;
+    }
+    else if(array.dtype().kind() == 'f' and array.itemsize() == 2)
+    {
+        src_type = src_type_t::fp16;
+    }
+    else
+    {
+        throw std::runtime_error("Unsupported type of array");
+    }
+    if(tensor.ndim != array.ndim())
+    {
+        throw std::runtime_error("tensor.ndim != array.ndim()");
+    }
+    std::vector<Index> stride(tensor.ndim);
+    for(Index i = 0; i < tensor.ndim; ++i)
+    {
+        if(array.shape()[i] != tensor.shape[i])
+        {
+            throw std::runtime_error("array.shape()[i] != tensor.shape[i]");
+        }
+        if(array.strides()[i] < 0 or array.strides()[i]%array.itemsize() != 0)
+        {
+            throw std::runtime_error("Wrong strides of array");
+        }
+        stride[i] = array.strides()[i] / array.itemsize();
+    }
+    tensor::load_strided_async<T>(tensor, array.data(), src_type, stride);
+}
+
+// Minimal subset of DLPack ABI (version 0.8) as declared in dlpack.h
+namespace dlpack
+{
+struct DLDevice
+{
+    int32_t device_type;
+    int32_t device_id;
+};
+struct DLDataType
+{
+    uint8_t code;
+    uint8_t bits;
+    uint16_t lanes;
+};
+struct DLTensor
+{
+    void *data;
+    DLDevice device;
+    int32_t ndim;
+    DLDataType dtype;
+    int64_t *shape;
+    int64_t *strides;
+    uint64_t byte_offset;
+};
+struct DLManagedTensor
+{
+    DLTensor dl_tensor;
+    void *manager_ctx;
+    void (*deleter)(DLManagedTensor *self);
+};
+constexpr int32_t kDLCPU = 1;
+constexpr uint8_t kDLInt = 0, kDLFloat = 2, kDLBfloat = 4, kDLBool = 6;
+} // namespace dlpack
+
+// Tile, acquired in CPU RAM for a consumer of DLPack capsule
+template<typename T>
+struct DLPackContext
+{
+    tile::TileLocalData<T> tile_local;
+    std::vector<int64_t> shape, strides;
+    dlpack::DLManagedTensor managed;
+};
+
+// Release acquired tile when a consumer does not need it any more
+template<typename T>
+static void dlpack_deleter(dlpack::DLManagedTensor *self)
+{
+    auto ctx = reinterpret_cast<DLPackContext<T> *>(self->manager_ctx);
+    // Destructor of the acquired local data releases the tile
+    delete ctx;
+}
+
+// Tensor -> DLPack capsule without copying
+/*! Only a tensor of a single tile, that is owned by the current MPI node, can
+ * be exported. The tile is acquired in CPU RAM for reading and writing until
+ * the consumer releases it, so tasks, that use the tensor, wait for it.
+ * */
+template<typename T>
+py::capsule tensor_to_dlpack(const tensor::Tensor<T> &tensor,
+        py::object stream)
+{
+    dlpack::DLDataType dtype{0, static_cast<uint8_t>(8*sizeof(T)), 1};
+    if constexpr(std::is_same_v<T, bf16_t>)
+    {
+        dtype.code = dlpack::kDLBfloat;
+    }
+    else if constexpr(std::is_same_v<T, fp16_t>)
+    {
+        dtype.code = dlpack::kDLFloat;
+    }
+    else if constexpr(std::is_same_v<T, bool_t>)
+    {
+        dtype.code = dlpack::kDLBool;
+    }
+    else if constexpr(std::is_floating_point_v<T>)
+    {
+        dtype.code = dlpack::kDLFloat;
+    }
+    else
+    {
+        dtype.code = dlpack::kDLInt;
+    }
+    if(tensor.grid.nelems != 1)
+    {
+        throw std::runtime_error("Only single-tile tensors can be exported "
+                "through DLPack");
+    }
+    auto tile = tensor.get_tile(0);
+    if(tile.mpi_get_rank() != starpu_mpi_world_rank())
+    {
+        throw std::runtime_error("Tile is not owned by this MPI node");
+    }
+    auto ctx = new DLPackContext<T>{tile.acquire(STARPU_RW),
+        std::vector<int64_t>(tensor.shape.begin(), tensor.shape.end()),
+        std::vector<int64_t>(tensor.stride.begin(), tensor.stride.end())};
+    auto &dl = ctx->managed.dl_tensor;
+    dl.data = ctx->tile_local.get_ptr();
+    dl.device = {dlpack::kDLCPU, 0};
+    dl.ndim = tensor.ndim;
+    dl.dtype = dtype;
+    dl.shape = ctx->shape.data();
+    dl.strides = ctx->strides.data();
+    dl.byte_offset = 0;
+    ctx->managed.manager_ctx = ctx;
+    ctx->managed.deleter = dlpack_deleter<T>;
+    // Capsule, that was not consumed, releases the tile itself
+    return py::capsule(&ctx->managed, "dltensor", [](PyObject *capsule){
+            if(PyCapsule_IsValid(capsule, "dltensor"))
+            {
+                auto managed = reinterpret_cast<dlpack::DLManagedTensor *>(
+                        PyCapsule_GetPointer(capsule, "dltensor"));
+                managed->deleter(managed);
+            }});
+}
+
+// Extend (sub)module with nntile::tensor::Readback<T>
+template<typename T>
+void def_class_readback(py::module_ &m, const char *name)
+{
+    using namespace nntile::tensor;
+    py::class_<Readback<T>>(m, name).
+        def(py::init<Index>(), py::arg("capacity")).
+        def("submit", &Readback<T>::submit, release_gil()).
+        def("is_ready", &Readback<T>::is_ready).
+        def("wait", &Readback<T>::wait, release_gil()).
+        def_property_readonly("next_ticket", &Readback<T>::get_next_ticket).
+        def_property_readonly("capacity", &Readback<T>::get_capacity);
+}
+
 // Extend (sub)module with nntile::tensor::Tensor<T>
 template<typename T>
 void def_class_tensor(py::module_ &m, const char *name)
 {
     using namespace nntile::tensor;
-    py::class_<Tensor<T>, TensorTraits>(m, name, py::multiple_inheritance()).
-        def(py::init<const TensorTraits &, const std::vector<int> &,
+    py::class_<Tensor<T>, TensorTraits> cls(m, name,
+            py::multiple_inheritance());
+    cls.def(py::init<const TensorTraits &, const std::vector<int> &,
                 starpu_mpi_tag_t &>()).
+        // View, that shares tiles of another tensor
+        def(py::init<const TensorTraits &, const Tensor<T> &,
+                const std::vector<Index> &>()).
+        // Tile-aligned slice, that shares tiles of another tensor
+        def(py::init<const Tensor<T> &, const std::vector<Index> &,
+                const std::vector<Index> &>(), py::arg("src"),
+                py::arg("tile_start"), py::arg("tile_shape")).
         def_readonly("next_tag", &Tensor<T>::next_tag).
-        def("unregister", &Tensor<T>::unregister).
-        // Temporary disable invalidate_submit and use wont_use instead
-        //def("invalidate_submit", &Tensor<T>::invalidate_submit).
-        def("invalidate_submit", &Tensor<T>::wont_use).
-        def("wont_use", &Tensor<T>::wont_use).
-        def("from_array", tensor_from_array<T>).
-        def("to_array", tensor_to_array<T>).
+        def("unregister", &Tensor<T>::unregister, release_gil()).
+        // Tensors, allocated by StarPU, are unregistered without waiting
+        def("unregister_submit", &Tensor<T>::unregister_submit,
+                release_gil()).
+        def("invalidate_submit", &Tensor<T>::invalidate_submit,
+                release_gil()).
+        def("wont_use", &Tensor<T>::wont_use, release_gil()).
+        def("offload_async", &Tensor<T>::offload_async, release_gil()).
+        def("prefetch_async", &Tensor<T>::prefetch_async,
+                py::arg("node")=-1, release_gil()).
+        def("set_name", &Tensor<T>::set_name).
+        // Copies wait for tasks on the tensor, so other Python threads may
+        // submit tasks meanwhile
+        def("from_array", tensor_from_array<T>,
+                py::call_guard<py::gil_scoped_release>()).
+        def("to_array", tensor_to_array<T>,
+                py::call_guard<py::gil_scoped_release>()).
+        // Copies of subarrays touch only intersecting tiles
+        def("from_array", tensor_from_array_slice<T>, py::arg("array"),
+                py::arg("start"),
+                py::call_guard<py::gil_scoped_release>()).
+        def("to_array", tensor_to_array_slice<T>, py::arg("array"),
+                py::arg("start"),
+                py::call_guard<py::gil_scoped_release>()).
+        // Tiles are written and read directly by their owners
+        def("write_tiles_async", write_tiles_async<T>, release_gil()).
+        def("read_tiles_async", read_tiles_async<T>, release_gil()).
+        def("stage_tiles_async", stage_tiles_async<T>, release_gil()).
+        // Waits for tasks on the tensor and for file operations, so other
+        // Python threads may run meanwhile
+        def("write_tiles_acquire", write_tiles_acquire<T>,
+                py::call_guard<py::gil_scoped_release>()).
+        def("set_distribution", &Tensor<T>::set_distribution).
+        def("set_device_distribution",
+                &Tensor<T>::set_device_distribution).
+        def("set_numa_distribution", &Tensor<T>::set_numa_distribution).
+        def("set_spill", &Tensor<T>::set_spill, py::arg("allowed")=true).
+        def("set_transfer_dtype", &Tensor<T>::set_transfer_dtype).
         def("set_reduction_add", &Tensor<T>::set_reduction_add).
         def("set_reduction_hypot", &Tensor<T>::set_reduction_hypot).
         def("set_reduction_maxsumexp", &Tensor<T>::set_reduction_maxsumexp).
-        def("print_scalar_async", &Tensor<T>::print_scalar_async).
+        def("print_scalar_async", &Tensor<T>::print_scalar_async,
+                release_gil()).
         // Get tile
         def("get_tile", static_cast<tile::Tile<T>(Tensor<T>::*)(Index) const>(
                     &Tensor<T>::get_tile)).
-        def_readonly("distribution", &Tensor<T>::tile_distr);
-    m.def("tensor_to_array", tensor_to_array<T>);
-    m.def("tensor_from_array", tensor_from_array<T>);
+        def_readonly("distribution", &Tensor<T>::tile_distr).
+        def_readonly("device_distribution", &Tensor<T>::tile_devices).
+        def_readonly("numa_distribution", &Tensor<T>::tile_numa);
+    m.def("tensor_to_array", tensor_to_array<T>, release_gil());
+    m.def("tensor_from_array", tensor_from_array<T>, release_gil());
+    // Zero-copy exchange of data, DLPack 0.8 has no type code for FP8
+    if constexpr(not std::is_same_v<T, fp8_e4m3_t>)
+    {
+        cls.def("__dlpack__", tensor_to_dlpack<T>,
+                py::arg("stream")=py::none());
+        cls.def("__dlpack_device__", [](const Tensor<T> &tensor){
+                return py::make_tuple(dlpack::kDLCPU, 0);});
+    }
+    if constexpr(std::is_floating_point_v<T> or std::is_same_v<T, fp16_t>
+            or std::is_same_v<T, bf16_t>)
+    {
+        cls.def("load_strided_async", tensor_load_strided_async<T>,
+                py::arg("array"), py::arg("bf16")=false);
+    }
+    if constexpr(std::is_arithmetic_v<T>)
+    {
+        // Arrays are kept alive as long as the tensor
+        cls.def_static("from_buffers", tensor_from_buffers<T>,
+                py::arg("traits"), py::arg("distribution"),
+                py::arg("next_tag"), py::arg("buffers").noconvert(),
+                py::keep_alive<0, 4>());
+    }
 }
 
 // Extend (sub)module with nntile::tensor::distributions functionality
@@ -362,12 +1342,59 @@ void def_tensor_distributions(py::module_ &m)
 {
     using namespace nntile::tensor::distributions;
     m.def("block_cyclic", &block_cyclic);
+    m.def("local_cyclic", &local_cyclic);
+}
+
+// Fused elementwise operations, described by tuples (code, src, dst, alpha,
+// beta), as opcodes are not exposed to Python as a separate type
+template<typename T>
+void fused_elementwise_async_tuples(
+        const std::vector<std::tuple<int, int, int, T, T>> &ops,
+        const std::vector<tensor::Tensor<T>> &buffers)
+{
+    using namespace nntile::kernel::fused_elementwise;
+    std::vector<op_t<T>> program_ops(ops.size());
+    for(std::size_t k = 0; k < ops.size(); ++k)
+    {
+        auto &op = program_ops[k];
+        op.code = static_cast<opcode_t>(std::get<0>(ops[k]));
+        op.src = std::get<1>(ops[k]);
+        op.dst = std::get<2>(ops[k]);
+        op.alpha = std::get<3>(ops[k]);
+        op.beta = std::get<4>(ops[k]);
+    }
+    tensor::fused_elementwise_async<T>(program_ops, buffers);
+}
+
+// Define tensor-wise gemm, where redux and compute mode are optional
+template<typename F>
+static void def_gemm(py::module_ &m, const char *name, F func)
+{
+    m.def(name, func, py::arg("alpha"), py::arg("transA"), py::arg("A"),
+            py::arg("transB"), py::arg("B"), py::arg("beta"), py::arg("C"),
+            py::arg("ndim"), py::arg("batch_ndim"), py::arg("redux")=0,
+            py::arg("compute")=GemmCompute(GemmCompute::Default),
+            release_gil());
+}
+
+// Contraction of tensors, that returns the next free tag after tags of its
+// temporary tensors
+template<typename T>
+starpu_mpi_tag_t contract_async_next_tag(T alpha, const tensor::Tensor<T> &A,
+        const tensor::Tensor<T> &B, T beta, const tensor::Tensor<T> &C,
+        const std::string &subscripts, starpu_mpi_tag_t next_tag, int redux)
+{
+    tensor::contract_async<T>(alpha, A, B, beta, C, subscripts, next_tag,
+            redux);
+    return next_tag;
 }
 
 // Extend (sub)module with nntile::tensor functionality
 void def_mod_tensor(py::module_ &m)
 {
     using namespace nntile::tensor;
+    // Value of redux argument, that asks for explicit tree reduction
+    m.attr("redux_tree") = redux_tree;
     // Define wrapper for TensorTraits
     py::class_<TensorTraits, tile::TileTraits>(m, "TensorTraits",
             py::multiple_inheritance()).
@@ -392,370 +1419,1063 @@ void def_mod_tensor(py::module_ &m)
     def_class_tensor<fp64_t>(m, "Tensor_fp64");
     def_class_tensor<fp32_t>(m, "Tensor_fp32");
     def_class_tensor<fp16_t>(m, "Tensor_fp16");
+    def_class_tensor<bf16_t>(m, "Tensor_bf16");
     def_class_tensor<Index>(m, "Tensor_int64");
     def_class_tensor<bool_t>(m, "Tensor_bool");
+    // Quantized weights
+    def_class_tensor<std::int8_t>(m, "Tensor_int8");
+    def_class_tensor<fp8_e4m3_t>(m, "Tensor_fp8_e4m3");
+    // Asynchronous readback of scalar tensors
+    def_class_readback<fp64_t>(m, "Readback_fp64");
+    def_class_readback<fp32_t>(m, "Readback_fp32");
+    // Future of values of tensors
+    py::class_<TensorFuture>(m, "TensorFuture").
+        def(py::init<>()).
+        def("is_ready", &TensorFuture::is_ready).
+        def("wait", &TensorFuture::wait, release_gil());
+    m.def("await_tensor_fp64", &await_tensor<fp64_t>);
+    m.def("await_tensor_fp32", &await_tensor<fp32_t>);
+    m.def("await_tensor_int64", &await_tensor<Index>);
+    m.def("await_tensor_bool", &await_tensor<bool_t>);
+    m.def("await_tensors_fp64", &await_tensors<fp64_t>);
+    m.def("await_tensors_fp32", &await_tensors<fp32_t>);
+    // Flat binary file of tokens, that is mapped into memory
+    py::class_<TokenFile>(m, "TokenFile").
+        def(py::init([](const std::string &path, const std::string &dtype){
+                    using starpu::tile_io::token_type_t;
+                    token_type_t token_type;
+                    if(dtype == "uint16")
+                    {
+                        token_type = token_type_t::uint16;
+                    }
+                    else if(dtype == "uint32")
+                    {
+                        token_type = token_type_t::uint32;
+                    }
+                    else if(dtype == "int64")
+                    {
+                        token_type = token_type_t::int64;
+                    }
+                    else
+                    {
+                        throw std::runtime_error("Unsupported dtype of "
+                                "tokens");
+                    }
+                    return new TokenFile(path, token_type);}),
+                py::arg("path"), py::arg("dtype")="uint16").
+        def_readonly("ntokens", &TokenFile::ntokens).
+        def("close", &TokenFile::close);
+    m.def("load_tokens_async", load_tokens_async, release_gil());
     // Add tensor.distributions submodule
     auto distributions = m.def_submodule("distributions");
     def_tensor_distributions(distributions);
 
     // Add functions for Tensor<T>
-    m.def("gemm_async_fp64", &gemm_async<fp64_t, fp64_t>);
-    m.def("gemm_async_fp32", &gemm_async<fp32_t, fp32_t>);
-    m.def("gemm_async_fp16", &gemm_async<fp16_t, fp32_t>);
-    m.def("gemm_fp64", &gemm<fp64_t, fp64_t>);
-    m.def("gemm_fp32", &gemm<fp32_t, fp32_t>);
-    m.def("gemm_fp16", &gemm<fp16_t, fp32_t>);
-    // Mixed precision gemm (FP32_FAST_FP16)
-    m.def("gemm_ex_async_fp32", &gemm_ex_async<fp32_t>);
-    m.def("gemm_ex_fp32", &gemm_ex<fp32_t>);
+    def_gemm(m, "gemm_async_fp64", &gemm_async<fp64_t, fp64_t>);
+    def_gemm(m, "gemm_async_fp32", &gemm_async<fp32_t, fp32_t>);
+    def_gemm(m, "gemm_async_fp16", &gemm_async<fp16_t, fp32_t>);
+    def_gemm(m, "gemm_async_bf16", &gemm_async<bf16_t, fp32_t>);
+    def_gemm(m, "gemm_fp64", &gemm<fp64_t, fp64_t>);
+    def_gemm(m, "gemm_fp32", &gemm<fp32_t, fp32_t>);
+    def_gemm(m, "gemm_fp16", &gemm<fp16_t, fp32_t>);
+    def_gemm(m, "gemm_bf16", &gemm<bf16_t, fp32_t>);
+    // Gemm of half precision tensors into a single precision tensor
+    def_gemm(m, "gemm_mixed_async_fp16", &gemm_mixed_async<fp16_t>);
+    def_gemm(m, "gemm_mixed_async_bf16", &gemm_mixed_async<bf16_t>);
+    def_gemm(m, "gemm_mixed_fp16", &gemm_mixed<fp16_t>);
+    def_gemm(m, "gemm_mixed_bf16", &gemm_mixed<bf16_t>);
+    // Communication-avoiding distributed gemm (SUMMA and 2.5D)
+    m.def("gemm_summa_async_fp64", &gemm_summa_async<fp64_t>, release_gil());
+    m.def("gemm_summa_async_fp32", &gemm_summa_async<fp32_t>, release_gil());
+    m.def("gemm_summa_fp64", &gemm_summa<fp64_t>, release_gil());
+    m.def("gemm_summa_fp32", &gemm_summa<fp32_t>, release_gil());
+    // Gemm with TF32 tensor cores, the same as gemm with gemm_fast_tf32
+    m.def("gemm_ex_async_fp32", &gemm_ex_async<fp32_t>, release_gil());
+    m.def("gemm_ex_fp32", &gemm_ex<fp32_t>, release_gil());
 
     // Add activation functions for Tensor<T>
-    m.def("relu_async_fp64", &relu_async<fp64_t>);
-    m.def("relu_async_fp32", &relu_async<fp32_t>);
-    m.def("relu_fp64", &relu<fp64_t>);
-    m.def("relu_fp32", &relu<fp32_t>);
-
-    m.def("relu_forward_async_fp64", &relu_forward_async<fp64_t>);
-    m.def("relu_forward_async_fp32", &relu_forward_async<fp32_t>);
-    m.def("relu_forward_fp64", &relu_forward<fp64_t>);
-    m.def("relu_forward_fp32", &relu_forward<fp32_t>);
-
-    m.def("relu_backward_async_fp64", &relu_backward_async<fp64_t>);
-    m.def("relu_backward_async_fp32", &relu_backward_async<fp32_t>);
-    m.def("relu_backward_fp64", &relu_backward<fp64_t>);
-    m.def("relu_backward_fp32", &relu_backward<fp32_t>);
-
-    m.def("drelu_async_fp64", &drelu_async<fp64_t>);
-    m.def("drelu_async_fp32", &drelu_async<fp32_t>);
-    m.def("drelu_fp64", &drelu<fp64_t>);
-    m.def("drelu_fp32", &drelu<fp32_t>);
+    m.def("relu_async_fp64", &relu_async<fp64_t>, release_gil());
+    m.def("relu_async_fp32", &relu_async<fp32_t>, release_gil());
+    m.def("relu_fp64", &relu<fp64_t>, release_gil());
+    m.def("relu_fp32", &relu<fp32_t>, release_gil());
+
+    m.def("relu_forward_async_fp64", &relu_forward_async<fp64_t>,
+            release_gil());
+    m.def("relu_forward_async_fp32", &relu_forward_async<fp32_t>,
+            release_gil());
+    m.def("relu_forward_fp64", &relu_forward<fp64_t>, release_gil());
+    m.def("relu_forward_fp32", &relu_forward<fp32_t>, release_gil());
+
+    m.def("relu_backward_async_fp64", &relu_backward_async<fp64_t>,
+            release_gil());
+    m.def("relu_backward_async_fp32", &relu_backward_async<fp32_t>,
+            release_gil());
+    m.def("relu_backward_fp64", &relu_backward<fp64_t>, release_gil());
+    m.def("relu_backward_fp32", &relu_backward<fp32_t>, release_gil());
+
+    m.def("rope_async_fp64", &rope_async<fp64_t>, release_gil());
+    m.def("rope_async_fp32", &rope_async<fp32_t>, release_gil());
+    m.def("rope_fp64", &rope<fp64_t>, release_gil());
+    m.def("rope_fp32", &rope<fp32_t>, release_gil());
+    m.def("rope_backward_async_fp64", &rope_backward_async<fp64_t>,
+            release_gil());
+    m.def("rope_backward_async_fp32", &rope_backward_async<fp32_t>,
+            release_gil());
+    m.def("rope_backward_fp64", &rope_backward<fp64_t>, release_gil());
+    m.def("rope_backward_fp32", &rope_backward<fp32_t>, release_gil());
+
+    m.def("moe_route_async_fp64", &moe_route_async<fp64_t>, release_gil());
+    m.def("moe_route_async_fp32", &moe_route_async<fp32_t>, release_gil());
+    m.def("moe_route_fp64", &moe_route<fp64_t>, release_gil());
+    m.def("moe_route_fp32", &moe_route<fp32_t>, release_gil());
+    m.def("moe_dispatch_async_fp64", &moe_dispatch_async<fp64_t>,
+            release_gil());
+    m.def("moe_dispatch_async_fp32", &moe_dispatch_async<fp32_t>,
+            release_gil());
+    m.def("moe_dispatch_fp64", &moe_dispatch<fp64_t>, release_gil());
+    m.def("moe_dispatch_fp32", &moe_dispatch<fp32_t>, release_gil());
+    m.def("moe_dispatch_backward_async_fp64",
+            &moe_dispatch_backward_async<fp64_t>, release_gil());
+    m.def("moe_dispatch_backward_async_fp32",
+            &moe_dispatch_backward_async<fp32_t>, release_gil());
+    m.def("moe_dispatch_backward_fp64", &moe_dispatch_backward<fp64_t>,
+            release_gil());
+    m.def("moe_dispatch_backward_fp32", &moe_dispatch_backward<fp32_t>,
+            release_gil());
+    m.def("moe_combine_async_fp64", &moe_combine_async<fp64_t>, release_gil());
+    m.def("moe_combine_async_fp32", &moe_combine_async<fp32_t>, release_gil());
+    m.def("moe_combine_fp64", &moe_combine<fp64_t>, release_gil());
+    m.def("moe_combine_fp32", &moe_combine<fp32_t>, release_gil());
+    m.def("moe_combine_backward_async_fp64",
+            &moe_combine_backward_async<fp64_t>, release_gil());
+    m.def("moe_combine_backward_async_fp32",
+            &moe_combine_backward_async<fp32_t>, release_gil());
+    m.def("moe_combine_backward_fp64", &moe_combine_backward<fp64_t>,
+            release_gil());
+    m.def("moe_combine_backward_fp32", &moe_combine_backward<fp32_t>,
+            release_gil());
+
+    m.def("drelu_async_fp64", &drelu_async<fp64_t>, release_gil());
+    m.def("drelu_async_fp32", &drelu_async<fp32_t>, release_gil());
+    m.def("drelu_fp64", &drelu<fp64_t>, release_gil());
+    m.def("drelu_fp32", &drelu<fp32_t>, release_gil());
+
+    m.def("dropout_async_fp64", &dropout_async<fp64_t>, release_gil());
+    m.def("dropout_async_fp32", &dropout_async<fp32_t>, release_gil());
+    m.def("dropout_fp64", &dropout<fp64_t>, release_gil());
+    m.def("dropout_fp32", &dropout<fp32_t>, release_gil());
+
     // Add other functions for Tensor<T>
-    m.def("fill_async_fp64", &fill_async<fp64_t>);
-    m.def("fill_async_fp32", &fill_async<fp32_t>);
-    m.def("fill_fp64", &fill<fp64_t>);
-    m.def("fill_fp32", &fill<fp32_t>);
-
-    m.def("sum_slice_async_fp64", &sum_slice_async<fp64_t>);
-    m.def("sum_slice_async_fp32", &sum_slice_async<fp32_t>);
-    m.def("sum_slice_fp64", &sum_slice<fp64_t>);
-    m.def("sum_slice_fp32", &sum_slice<fp32_t>);
-
-    m.def("sum_fiber_async_fp64", &sum_fiber_async<fp64_t>);
-    m.def("sum_fiber_async_fp32", &sum_fiber_async<fp32_t>);
-    m.def("sum_fiber_fp64", &sum_fiber<fp64_t>);
-    m.def("sum_fiber_fp32", &sum_fiber<fp32_t>);
-
-    m.def("norm_slice_async_fp64", &norm_slice_async<fp64_t>);
-    m.def("norm_slice_async_fp32", &norm_slice_async<fp32_t>);
-    m.def("norm_slice_fp64", &norm_slice<fp64_t>);
-    m.def("norm_slice_fp32", &norm_slice<fp32_t>);
-
-    m.def("pow_async_fp64", &pow_async<fp64_t>);
-    m.def("pow_async_fp32", &pow_async<fp32_t>);
-    m.def("pow_fp64", &pow<fp64_t>);
-    m.def("pow_fp32", &pow<fp32_t>);
-
-    m.def("sumnorm_async_fp64", &sumnorm_async<fp64_t>);
-    m.def("sumnorm_async_fp32", &sumnorm_async<fp32_t>);
-    m.def("sumnorm_fp64", &sumnorm<fp64_t>);
-    m.def("sumnorm_fp32", &sumnorm<fp32_t>);
-
-    m.def("flash_softmax_gemm_async_fp64", &flash_softmax_gemm_async<fp64_t>);
-    m.def("flash_softmax_gemm_async_fp32", &flash_softmax_gemm_async<fp32_t>);
-    m.def("flash_softmax_gemm_fp64", &flash_softmax_gemm<fp64_t>);
-    m.def("flash_softmax_gemm_fp32", &flash_softmax_gemm<fp32_t>);
-
-    m.def("flash_softmax_gemm_backward_async_fp64", &flash_softmax_gemm_backward_async<fp64_t>);
-    m.def("flash_softmax_gemm_backward_async_fp32", &flash_softmax_gemm_backward_async<fp32_t>);
-    m.def("flash_softmax_gemm_backward_fp64", &flash_softmax_gemm_backward<fp64_t>);
-    m.def("flash_softmax_gemm_backward_fp32", &flash_softmax_gemm_backward<fp32_t>);
-
-    m.def("softmax_async_fp64", &softmax_async<fp64_t>);
-    m.def("softmax_async_fp32", &softmax_async<fp32_t>);
-    m.def("softmax_fp64", &softmax<fp64_t>);
-    m.def("softmax_fp32", &softmax<fp32_t>);
-
-    m.def("softmax_inplace_async_fp64", &softmax_inplace_async<fp64_t>);
-    m.def("softmax_inplace_async_fp32", &softmax_inplace_async<fp32_t>);
-    m.def("softmax_inplace_fp64", &softmax_inplace<fp64_t>);
-    m.def("softmax_inplace_fp32", &softmax_inplace<fp32_t>);
-
-    m.def("scatter_async_fp64", &scatter_async<fp64_t>);
-    m.def("scatter_async_fp32", &scatter_async<fp32_t>);
-    m.def("scatter_async_int64", &scatter_async<Index>);
-    m.def("scatter_async_bool", &scatter_async<bool_t>);
-    m.def("scatter_fp64", &scatter<fp64_t>);
-    m.def("scatter_fp32", &scatter<fp32_t>);
-    m.def("scatter_int64", &scatter<Index>);
-    m.def("scatter_bool", &scatter<bool_t>);
-    m.def("randn_async_fp64", &randn_async<fp64_t>);
-    m.def("randn_async_fp32", &randn_async<fp32_t>);
-    m.def("randn_fp64", &randn<fp64_t>);
-    m.def("randn_fp32", &randn<fp32_t>);
-    m.def("prod_async_fp64", &prod_async<fp64_t>);
-    m.def("prod_async_fp32", &prod_async<fp32_t>);
-    m.def("prod_fp64", &prod<fp64_t>);
-    m.def("prod_fp32", &prod<fp32_t>);
-    m.def("nrm2_async_fp64", &nrm2_async<fp64_t>);
-    m.def("nrm2_async_fp32", &nrm2_async<fp32_t>);
-    m.def("nrm2_fp64", &nrm2<fp64_t>);
-    m.def("nrm2_fp32", &nrm2<fp32_t>);
-    m.def("normalize_async_fp64", &normalize_async<fp64_t>);
-    m.def("normalize_async_fp32", &normalize_async<fp32_t>);
-    m.def("normalize_fp64", &normalize<fp64_t>);
-    m.def("normalize_fp32", &normalize<fp32_t>);
-
-    m.def("flash_maxsumexp_async_fp64", &flash_maxsumexp_async<fp64_t>);
-    m.def("flash_maxsumexp_async_fp32", &flash_maxsumexp_async<fp32_t>);
-    m.def("flash_maxsumexp_fp64", &flash_maxsumexp<fp64_t>);
-    m.def("flash_maxsumexp_fp32", &flash_maxsumexp<fp32_t>);
-
-    m.def("maxsumexp_async_fp64", &maxsumexp_async<fp64_t>);
-    m.def("maxsumexp_async_fp32", &maxsumexp_async<fp32_t>);
-    m.def("maxsumexp_fp64", &maxsumexp<fp64_t>);
-    m.def("maxsumexp_fp32", &maxsumexp<fp32_t>);
-
-    m.def("add_slice_async_fp64", &add_slice_async<fp64_t>);
-    m.def("add_slice_async_fp32", &add_slice_async<fp32_t>);
-    m.def("add_slice_fp64", &add_slice<fp64_t>);
-    m.def("add_slice_fp32", &add_slice<fp32_t>);
-
-    m.def("add_slice3_async_fp64", &add_slice3_async<fp64_t>);
-    m.def("add_slice3_async_fp32", &add_slice3_async<fp32_t>);
-    m.def("add_slice3_fp64", &add_slice3<fp64_t>);
-    m.def("add_slice3_fp32", &add_slice3<fp32_t>);
-
-    m.def("add_async_fp64", &add_async<fp64_t>);
-    m.def("add_async_fp32", &add_async<fp32_t>);
-    m.def("add_fp64", &add<fp64_t>);
-    m.def("add_fp32", &add<fp32_t>);
-
-    m.def("add_scalar_async_fp64", &add_scalar_async<fp64_t>);
-    m.def("add_scalar_async_fp32", &add_scalar_async<fp32_t>);
-    m.def("add_scalar_fp64", &add_scalar<fp64_t>);
-    m.def("add_scalar_fp32", &add_scalar<fp32_t>);
-
-    m.def("add_fiber_async_fp64", &add_fiber_async<fp64_t>);
-    m.def("add_fiber_async_fp32", &add_fiber_async<fp32_t>);
-    m.def("add_fiber_fp64", &add_fiber<fp64_t>);
-    m.def("add_fiber_fp32", &add_fiber<fp32_t>);
-
-    m.def("prod_slice_async_fp64", &prod_slice_async<fp64_t>);
-    m.def("prod_slice_async_fp32", &prod_slice_async<fp32_t>);
-    m.def("prod_slice_fp64", &prod_slice<fp64_t>);
-    m.def("prod_slice_fp32", &prod_slice<fp32_t>);
-
-    m.def("prod_fiber_async_fp64", &prod_fiber_async<fp64_t>);
-    m.def("prod_fiber_async_fp32", &prod_fiber_async<fp32_t>);
-    m.def("prod_fiber_fp64", &prod_fiber<fp64_t>);
-    m.def("prod_fiber_fp32", &prod_fiber<fp32_t>);
-
-    m.def("prod_fiber3_async_fp64", &prod_fiber3_async<fp64_t>);
-    m.def("prod_fiber3_async_fp32", &prod_fiber3_async<fp32_t>);
-    m.def("prod_fiber3_fp64", &prod_fiber3<fp64_t>);
-    m.def("prod_fiber3_fp32", &prod_fiber3<fp32_t>);
-
-    m.def("gather_async_fp64", &gather_async<fp64_t>);
-    m.def("gather_async_fp32", &gather_async<fp32_t>);
-    m.def("gather_async_int64", &gather_async<Index>);
-    m.def("gather_async_bool", &gather_async<bool_t>);
-    m.def("gather_fp64", &gather<fp64_t>);
-    m.def("gather_fp32", &gather<fp32_t>);
-    m.def("gather_int64", &gather<Index>);
-    m.def("gather_bool", &gather<bool_t>);
-
-    m.def("copy_intersection_async_fp64", &copy_intersection_async<fp64_t>);
-    m.def("copy_intersection_async_fp32", &copy_intersection_async<fp32_t>);
-    m.def("copy_intersection_async_int64", &copy_intersection_async<Index>);
-
-    m.def("copy_intersection_fp64", &copy_intersection<fp64_t>);
-    m.def("copy_intersection_fp32", &copy_intersection<fp32_t>);
-    m.def("copy_intersection_int64", &copy_intersection<Index>);
+    m.def("fill_async_fp64", &fill_async<fp64_t>, release_gil());
+    m.def("fill_async_fp32", &fill_async<fp32_t>, release_gil());
+    m.def("fill_fp64", &fill<fp64_t>, release_gil());
+    m.def("fill_fp32", &fill<fp32_t>, release_gil());
+    m.def("padded_shape", &padded_shape);
+    m.def("fill_padding_async_fp64", &fill_padding_async<fp64_t>,
+            release_gil());
+    m.def("fill_padding_async_fp32", &fill_padding_async<fp32_t>,
+            release_gil());
+    m.def("fill_padding_fp64", &fill_padding<fp64_t>, release_gil());
+    m.def("fill_padding_fp32", &fill_padding<fp32_t>, release_gil());
+
+    m.def("sum_slice_async_fp64", &sum_slice_async<fp64_t>, release_gil());
+    m.def("sum_slice_async_fp32", &sum_slice_async<fp32_t>, release_gil());
+    m.def("sum_slice_async_bf16", &sum_slice_async<bf16_t>, release_gil());
+    m.def("sum_slice_async_fp16", &sum_slice_async<fp16_t>, release_gil());
+    m.def("sum_slice_fp64", &sum_slice<fp64_t>, release_gil());
+    m.def("sum_slice_fp32", &sum_slice<fp32_t>, release_gil());
+    m.def("sum_slice_bf16", &sum_slice<bf16_t>, release_gil());
+    m.def("sum_slice_fp16", &sum_slice<fp16_t>, release_gil());
+
+    m.def("sum_fiber_async_fp64", &sum_fiber_async<fp64_t>, release_gil());
+    m.def("sum_fiber_async_fp32", &sum_fiber_async<fp32_t>, release_gil());
+    m.def("sum_fiber_fp64", &sum_fiber<fp64_t>, release_gil());
+    m.def("sum_fiber_fp32", &sum_fiber<fp32_t>, release_gil());
+
+    m.def("norm_slice_async_fp64", &norm_slice_async<fp64_t>, release_gil());
+    m.def("norm_slice_async_fp32", &norm_slice_async<fp32_t>, release_gil());
+    m.def("norm_slice_fp64", &norm_slice<fp64_t>, release_gil());
+    m.def("norm_slice_fp32", &norm_slice<fp32_t>, release_gil());
+
+    m.def("layer_norm_async_fp64", &layer_norm_async<fp64_t>, release_gil());
+    m.def("layer_norm_async_fp32", &layer_norm_async<fp32_t>, release_gil());
+    m.def("layer_norm_fp64", &layer_norm<fp64_t>, release_gil());
+    m.def("layer_norm_fp32", &layer_norm<fp32_t>, release_gil());
+
+    m.def("layer_norm_backward_async_fp64",
+            &layer_norm_backward_async<fp64_t>, release_gil());
+    m.def("layer_norm_backward_async_fp32",
+            &layer_norm_backward_async<fp32_t>, release_gil());
+    m.def("layer_norm_backward_fp64", &layer_norm_backward<fp64_t>,
+            release_gil());
+    m.def("layer_norm_backward_fp32", &layer_norm_backward<fp32_t>,
+            release_gil());
+
+    m.def("add_layer_norm_async_fp64", &add_layer_norm_async<fp64_t>,
+            release_gil());
+    m.def("add_layer_norm_async_fp32", &add_layer_norm_async<fp32_t>,
+            release_gil());
+    m.def("add_layer_norm_fp64", &add_layer_norm<fp64_t>, release_gil());
+    m.def("add_layer_norm_fp32", &add_layer_norm<fp32_t>, release_gil());
+
+    m.def("add_layer_norm_backward_async_fp64",
+            &add_layer_norm_backward_async<fp64_t>, release_gil());
+    m.def("add_layer_norm_backward_async_fp32",
+            &add_layer_norm_backward_async<fp32_t>, release_gil());
+    m.def("add_layer_norm_backward_fp64", &add_layer_norm_backward<fp64_t>,
+            release_gil());
+    m.def("add_layer_norm_backward_fp32", &add_layer_norm_backward<fp32_t>,
+            release_gil());
+
+    m.def("rms_norm_async_fp64", &rms_norm_async<fp64_t>, release_gil());
+    m.def("rms_norm_async_fp32", &rms_norm_async<fp32_t>, release_gil());
+    m.def("rms_norm_fp64", &rms_norm<fp64_t>, release_gil());
+    m.def("rms_norm_fp32", &rms_norm<fp32_t>, release_gil());
+
+    m.def("rms_norm_backward_async_fp64", &rms_norm_backward_async<fp64_t>,
+            release_gil());
+    m.def("rms_norm_backward_async_fp32", &rms_norm_backward_async<fp32_t>,
+            release_gil());
+    m.def("rms_norm_backward_fp64", &rms_norm_backward<fp64_t>,
+            release_gil());
+    m.def("rms_norm_backward_fp32", &rms_norm_backward<fp32_t>,
+            release_gil());
+
+    m.def("swiglu_async_fp64", &swiglu_async<fp64_t>, release_gil());
+    m.def("swiglu_async_fp32", &swiglu_async<fp32_t>, release_gil());
+    m.def("swiglu_fp64", &swiglu<fp64_t>, release_gil());
+    m.def("swiglu_fp32", &swiglu<fp32_t>, release_gil());
+
+    m.def("swiglu_backward_async_fp64", &swiglu_backward_async<fp64_t>,
+            release_gil());
+    m.def("swiglu_backward_async_fp32", &swiglu_backward_async<fp32_t>,
+            release_gil());
+    m.def("swiglu_backward_fp64", &swiglu_backward<fp64_t>, release_gil());
+    m.def("swiglu_backward_fp32", &swiglu_backward<fp32_t>, release_gil());
+
+    m.def("embedding_pos_async_fp64", &embedding_pos_async<fp64_t>,
+            release_gil());
+    m.def("embedding_pos_async_fp32", &embedding_pos_async<fp32_t>,
+            release_gil());
+    m.def("embedding_pos_fp64", &embedding_pos<fp64_t>, release_gil());
+    m.def("embedding_pos_fp32", &embedding_pos<fp32_t>, release_gil());
+
+    m.def("embedding_pos_backward_async_fp64",
+            &embedding_pos_backward_async<fp64_t>, release_gil());
+    m.def("embedding_pos_backward_async_fp32",
+            &embedding_pos_backward_async<fp32_t>, release_gil());
+    m.def("embedding_pos_backward_fp64", &embedding_pos_backward<fp64_t>,
+            release_gil());
+    m.def("embedding_pos_backward_fp32", &embedding_pos_backward<fp32_t>,
+            release_gil());
+
+    m.def("softmax_online_async_fp64", &softmax_online_async<fp64_t>,
+            release_gil());
+    m.def("softmax_online_async_fp32", &softmax_online_async<fp32_t>,
+            release_gil());
+    m.def("softmax_online_fp64", &softmax_online<fp64_t>, release_gil());
+    m.def("softmax_online_fp32", &softmax_online<fp32_t>, release_gil());
+
+    m.def("bias_gelutanh_async_fp64", &bias_gelutanh_async<fp64_t>,
+            release_gil());
+    m.def("bias_gelutanh_async_fp32", &bias_gelutanh_async<fp32_t>,
+            release_gil());
+    m.def("bias_gelutanh_fp64", &bias_gelutanh<fp64_t>, release_gil());
+    m.def("bias_gelutanh_fp32", &bias_gelutanh<fp32_t>, release_gil());
+
+    m.def("bias_gelutanh_backward_async_fp64",
+            &bias_gelutanh_backward_async<fp64_t>, release_gil());
+    m.def("bias_gelutanh_backward_async_fp32",
+            &bias_gelutanh_backward_async<fp32_t>, release_gil());
+    m.def("bias_gelutanh_backward_fp64", &bias_gelutanh_backward<fp64_t>,
+            release_gil());
+    m.def("bias_gelutanh_backward_fp32", &bias_gelutanh_backward<fp32_t>,
+            release_gil());
+
+    // Activations, that are fused with batch normalization
+    py::enum_<activation_t>(m, "BatchNormActivation").
+        value("none", activation_t::NONE).
+        value("relu", activation_t::RELU).
+        value("gelutanh", activation_t::GELUTANH);
+
+    m.def("batch_norm_act_async_fp64", &batch_norm_act_async<fp64_t>,
+            release_gil());
+    m.def("batch_norm_act_async_fp32", &batch_norm_act_async<fp32_t>,
+            release_gil());
+    m.def("batch_norm_act_fp64", &batch_norm_act<fp64_t>, release_gil());
+    m.def("batch_norm_act_fp32", &batch_norm_act<fp32_t>, release_gil());
+
+    m.def("batch_norm_act_backward_async_fp64",
+            &batch_norm_act_backward_async<fp64_t>, release_gil());
+    m.def("batch_norm_act_backward_async_fp32",
+            &batch_norm_act_backward_async<fp32_t>, release_gil());
+    m.def("batch_norm_act_backward_fp64", &batch_norm_act_backward<fp64_t>,
+            release_gil());
+    m.def("batch_norm_act_backward_fp32", &batch_norm_act_backward<fp32_t>,
+            release_gil());
+
+    m.def("batch_norm_backward_async_fp64",
+            &batch_norm_backward_async<fp64_t>, release_gil());
+    m.def("batch_norm_backward_async_fp32",
+            &batch_norm_backward_async<fp32_t>, release_gil());
+    m.def("batch_norm_backward_fp64", &batch_norm_backward<fp64_t>,
+            release_gil());
+    m.def("batch_norm_backward_fp32", &batch_norm_backward<fp32_t>,
+            release_gil());
+
+    m.def("gemm_bias_gelutanh_async_fp64",
+            &gemm_bias_gelutanh_async<fp64_t>, release_gil());
+    m.def("gemm_bias_gelutanh_async_fp32",
+            &gemm_bias_gelutanh_async<fp32_t>, release_gil());
+    m.def("gemm_bias_gelutanh_fp64", &gemm_bias_gelutanh<fp64_t>,
+            release_gil());
+    m.def("gemm_bias_gelutanh_fp32", &gemm_bias_gelutanh<fp32_t>,
+            release_gil());
+
+    m.def("quantize_async_int8", &quantize_async<std::int8_t>, release_gil());
+    m.def("quantize_async_fp8_e4m3", &quantize_async<fp8_e4m3_t>,
+            release_gil());
+    m.def("quantize_int8", &quantize<std::int8_t>, release_gil());
+    m.def("quantize_fp8_e4m3", &quantize<fp8_e4m3_t>, release_gil());
+
+    m.def("gemm_dequant_async_int8", &gemm_dequant_async<std::int8_t>,
+            release_gil());
+    m.def("gemm_dequant_async_fp8_e4m3", &gemm_dequant_async<fp8_e4m3_t>,
+            release_gil());
+    m.def("gemm_dequant_int8", &gemm_dequant<std::int8_t>, release_gil());
+    m.def("gemm_dequant_fp8_e4m3", &gemm_dequant<fp8_e4m3_t>, release_gil());
+
+    m.def("flash_attention_dequant_async_int8",
+            &flash_attention_dequant_async<std::int8_t>, release_gil());
+    m.def("flash_attention_dequant_async_fp8_e4m3",
+            &flash_attention_dequant_async<fp8_e4m3_t>, release_gil());
+    m.def("flash_attention_dequant_int8",
+            &flash_attention_dequant<std::int8_t>, release_gil());
+    m.def("flash_attention_dequant_fp8_e4m3",
+            &flash_attention_dequant<fp8_e4m3_t>, release_gil());
+
+    m.def("topk_async_fp64", &topk_async<fp64_t>, release_gil());
+    m.def("topk_async_fp32", &topk_async<fp32_t>, release_gil());
+    m.def("topk_async_bf16", &topk_async<bf16_t>, release_gil());
+    m.def("topk_async_fp16", &topk_async<fp16_t>, release_gil());
+    m.def("topk_fp64", &topk<fp64_t>, release_gil());
+    m.def("topk_fp32", &topk<fp32_t>, release_gil());
+    m.def("topk_bf16", &topk<bf16_t>, release_gil());
+    m.def("topk_fp16", &topk<fp16_t>, release_gil());
+
+    m.def("topk_sample_async_fp64", &topk_sample_async<fp64_t>, release_gil());
+    m.def("topk_sample_async_fp32", &topk_sample_async<fp32_t>, release_gil());
+    m.def("topk_sample_async_bf16", &topk_sample_async<bf16_t>, release_gil());
+    m.def("topk_sample_async_fp16", &topk_sample_async<fp16_t>, release_gil());
+    m.def("topk_sample_fp64", &topk_sample<fp64_t>, release_gil());
+    m.def("topk_sample_fp32", &topk_sample<fp32_t>, release_gil());
+    m.def("topk_sample_bf16", &topk_sample<bf16_t>, release_gil());
+    m.def("topk_sample_fp16", &topk_sample<fp16_t>, release_gil());
+
+    m.def("pow_async_fp64", &pow_async<fp64_t>, release_gil());
+    m.def("pow_async_fp32", &pow_async<fp32_t>, release_gil());
+    m.def("pow_fp64", &pow<fp64_t>, release_gil());
+    m.def("pow_fp32", &pow<fp32_t>, release_gil());
+
+    m.def("sumnorm_async_fp64", &sumnorm_async<fp64_t>, release_gil());
+    m.def("sumnorm_async_fp32", &sumnorm_async<fp32_t>, release_gil());
+    m.def("sumnorm_fp64", &sumnorm<fp64_t>, release_gil());
+    m.def("sumnorm_fp32", &sumnorm<fp32_t>, release_gil());
+
+    m.def("flash_softmax_gemm_async_fp64", &flash_softmax_gemm_async<fp64_t>,
+            release_gil());
+    m.def("flash_softmax_gemm_async_fp32", &flash_softmax_gemm_async<fp32_t>,
+            release_gil());
+    m.def("flash_softmax_gemm_fp64", &flash_softmax_gemm<fp64_t>,
+            release_gil());
+    m.def("flash_softmax_gemm_fp32", &flash_softmax_gemm<fp32_t>,
+            release_gil());
+
+    m.def("flash_softmax_gemm_backward_async_fp64", &flash_softmax_gemm_backward_async<fp64_t>,
+            release_gil());
+    m.def("flash_softmax_gemm_backward_async_fp32", &flash_softmax_gemm_backward_async<fp32_t>,
+            release_gil());
+    m.def("flash_softmax_gemm_backward_fp64", &flash_softmax_gemm_backward<fp64_t>,
+            release_gil());
+    m.def("flash_softmax_gemm_backward_fp32", &flash_softmax_gemm_backward<fp32_t>,
+            release_gil());
+
+    // Kinds of tiles of a mask, that define block-sparse layout of attention
+    py::enum_<MaskTile>(m, "MaskTile").
+        value("empty", MaskTile::empty).
+        value("partial", MaskTile::partial).
+        value("full", MaskTile::full).
+        value("causal", MaskTile::causal);
+    m.def("mask_tiles", &mask_tiles, release_gil());
+
+    m.def("flash_attention_async_fp64", &flash_attention_async<fp64_t>,
+            release_gil());
+    m.def("flash_attention_async_fp32", &flash_attention_async<fp32_t>,
+            release_gil());
+    m.def("flash_attention_fp64", &flash_attention<fp64_t>, release_gil());
+    m.def("flash_attention_fp32", &flash_attention<fp32_t>, release_gil());
+    m.def("flash_attention_ring_async_fp64",
+            &flash_attention_ring_async<fp64_t>, release_gil());
+    m.def("flash_attention_ring_async_fp32",
+            &flash_attention_ring_async<fp32_t>, release_gil());
+    m.def("flash_attention_ring_fp64", &flash_attention_ring<fp64_t>,
+            release_gil());
+    m.def("flash_attention_ring_fp32", &flash_attention_ring<fp32_t>,
+            release_gil());
+
+    m.def("flash_attention_backward_async_fp64", &flash_attention_backward_async<fp64_t>,
+            release_gil());
+    m.def("flash_attention_backward_async_fp32", &flash_attention_backward_async<fp32_t>,
+            release_gil());
+    m.def("flash_attention_backward_fp64", &flash_attention_backward<fp64_t>,
+            release_gil());
+    m.def("flash_attention_backward_fp32", &flash_attention_backward<fp32_t>,
+            release_gil());
+
+    m.def("softmax_async_fp64", &softmax_async<fp64_t>, release_gil());
+    m.def("softmax_async_fp32", &softmax_async<fp32_t>, release_gil());
+    m.def("softmax_fp64", &softmax<fp64_t>, release_gil());
+    m.def("softmax_fp32", &softmax<fp32_t>, release_gil());
+
+    m.def("softmax_inplace_async_fp64", &softmax_inplace_async<fp64_t>,
+            release_gil());
+    m.def("softmax_inplace_async_fp32", &softmax_inplace_async<fp32_t>,
+            release_gil());
+    m.def("softmax_inplace_async_bf16", &softmax_inplace_async<bf16_t>,
+            release_gil());
+    m.def("softmax_inplace_async_fp16", &softmax_inplace_async<fp16_t>,
+            release_gil());
+    m.def("softmax_inplace_fp64", &softmax_inplace<fp64_t>, release_gil());
+    m.def("softmax_inplace_fp32", &softmax_inplace<fp32_t>, release_gil());
+    m.def("softmax_inplace_bf16", &softmax_inplace<bf16_t>, release_gil());
+    m.def("softmax_inplace_fp16", &softmax_inplace<fp16_t>, release_gil());
+
+    m.def("scatter_async_fp64", &scatter_async<fp64_t>, release_gil());
+    m.def("scatter_async_fp32", &scatter_async<fp32_t>, release_gil());
+    m.def("scatter_async_bf16", &scatter_async<bf16_t>, release_gil());
+    m.def("scatter_async_int64", &scatter_async<Index>, release_gil());
+    m.def("scatter_async_bool", &scatter_async<bool_t>, release_gil());
+    m.def("scatter_fp64", &scatter<fp64_t>, release_gil());
+    m.def("scatter_fp32", &scatter<fp32_t>, release_gil());
+    m.def("scatter_bf16", &scatter<bf16_t>, release_gil());
+    m.def("scatter_int64", &scatter<Index>, release_gil());
+    m.def("scatter_bool", &scatter<bool_t>, release_gil());
+    m.def("randn_async_fp64", &randn_async<fp64_t>, release_gil());
+    m.def("randn_async_fp32", &randn_async<fp32_t>, release_gil());
+    m.def("randn_fp64", &randn<fp64_t>, release_gil());
+    m.def("randn_fp32", &randn<fp32_t>, release_gil());
+    m.def("randn_philox_async_fp64", &randn_philox_async<fp64_t>,
+            release_gil());
+    m.def("randn_philox_async_fp32", &randn_philox_async<fp32_t>,
+            release_gil());
+    m.def("randn_philox_fp64", &randn_philox<fp64_t>, release_gil());
+    m.def("randn_philox_fp32", &randn_philox<fp32_t>, release_gil());
+    m.def("prod_async_fp64", &prod_async<fp64_t>, release_gil());
+    m.def("prod_async_fp32", &prod_async<fp32_t>, release_gil());
+    m.def("prod_async_bf16", &prod_async<bf16_t>, release_gil());
+    m.def("prod_async_fp16", &prod_async<fp16_t>, release_gil());
+    m.def("prod_fp64", &prod<fp64_t>, release_gil());
+    m.def("prod_fp32", &prod<fp32_t>, release_gil());
+    m.def("prod_bf16", &prod<bf16_t>, release_gil());
+    m.def("prod_fp16", &prod<fp16_t>, release_gil());
+    m.def("nrm2_async_fp64", &nrm2_async<fp64_t>, release_gil());
+    m.def("nrm2_async_fp32", &nrm2_async<fp32_t>, release_gil());
+    m.def("nrm2_fp64", &nrm2<fp64_t>, release_gil());
+    m.def("nrm2_fp32", &nrm2<fp32_t>, release_gil());
+    m.def("normalize_async_fp64", &normalize_async<fp64_t>, release_gil());
+    m.def("normalize_async_fp32", &normalize_async<fp32_t>, release_gil());
+    m.def("normalize_fp64", &normalize<fp64_t>, release_gil());
+    m.def("normalize_fp32", &normalize<fp32_t>, release_gil());
+
+    m.def("flash_maxsumexp_async_fp64", &flash_maxsumexp_async<fp64_t>,
+            release_gil());
+    m.def("flash_maxsumexp_async_fp32", &flash_maxsumexp_async<fp32_t>,
+            release_gil());
+    m.def("flash_maxsumexp_fp64", &flash_maxsumexp<fp64_t>, release_gil());
+    m.def("flash_maxsumexp_fp32", &flash_maxsumexp<fp32_t>, release_gil());
+
+    m.def("maxsumexp_async_fp64", &maxsumexp_async<fp64_t>, release_gil());
+    m.def("maxsumexp_async_fp32", &maxsumexp_async<fp32_t>, release_gil());
+    m.def("maxsumexp_async_bf16", &maxsumexp_async<bf16_t>, release_gil());
+    m.def("maxsumexp_async_fp16", &maxsumexp_async<fp16_t>, release_gil());
+    m.def("maxsumexp_fp64", &maxsumexp<fp64_t>, release_gil());
+    m.def("maxsumexp_fp32", &maxsumexp<fp32_t>, release_gil());
+    m.def("maxsumexp_bf16", &maxsumexp<bf16_t>, release_gil());
+    m.def("maxsumexp_fp16", &maxsumexp<fp16_t>, release_gil());
+
+    m.def("set_aggregate_nelems", &set_aggregate_nelems, release_gil());
+    m.def("get_aggregate_nelems", &get_aggregate_nelems, release_gil());
+    m.def("set_gemm_split_k", &set_gemm_split_k, release_gil());
+    m.def("get_gemm_split_k", &get_gemm_split_k, release_gil());
+    m.def("set_gemm_hetero", &set_gemm_hetero, py::arg("enable"),
+            py::arg("cpu_share")=0.0, release_gil());
+    m.def("get_gemm_hetero", &get_gemm_hetero, release_gil());
+    m.def("add_slice_async_fp64", &add_slice_async<fp64_t>, release_gil());
+    m.def("add_slice_async_fp32", &add_slice_async<fp32_t>, release_gil());
+    m.def("add_slice_fp64", &add_slice<fp64_t>, release_gil());
+    m.def("add_slice_fp32", &add_slice<fp32_t>, release_gil());
+
+    m.def("add_slice3_async_fp64", &add_slice3_async<fp64_t>, release_gil());
+    m.def("add_slice3_async_fp32", &add_slice3_async<fp32_t>, release_gil());
+    m.def("add_slice3_fp64", &add_slice3<fp64_t>, release_gil());
+    m.def("add_slice3_fp32", &add_slice3<fp32_t>, release_gil());
+
+    m.def("add_async_fp64", &add_async<fp64_t>, release_gil());
+    m.def("add_async_fp32", &add_async<fp32_t>, release_gil());
+    m.def("add_async_bf16", &add_async<bf16_t>, release_gil());
+    m.def("add_async_fp16", &add_async<fp16_t>, release_gil());
+    m.def("add_fp64", &add<fp64_t>, release_gil());
+    m.def("add_fp32", &add<fp32_t>, release_gil());
+    m.def("add_bf16", &add<bf16_t>, release_gil());
+    m.def("add_fp16", &add<fp16_t>, release_gil());
+
+    m.def("add_scalar_async_fp64", &add_scalar_async<fp64_t>, release_gil());
+    m.def("add_scalar_async_fp32", &add_scalar_async<fp32_t>, release_gil());
+    m.def("add_scalar_fp64", &add_scalar<fp64_t>, release_gil());
+    m.def("add_scalar_fp32", &add_scalar<fp32_t>, release_gil());
+
+    m.def("add_fiber_async_fp64", &add_fiber_async<fp64_t>, release_gil());
+    m.def("add_fiber_async_fp32", &add_fiber_async<fp32_t>, release_gil());
+    m.def("add_fiber_fp64", &add_fiber<fp64_t>, release_gil());
+    m.def("add_fiber_fp32", &add_fiber<fp32_t>, release_gil());
+
+    m.def("prod_slice_async_fp64", &prod_slice_async<fp64_t>, release_gil());
+    m.def("prod_slice_async_fp32", &prod_slice_async<fp32_t>, release_gil());
+    m.def("prod_slice_fp64", &prod_slice<fp64_t>, release_gil());
+    m.def("prod_slice_fp32", &prod_slice<fp32_t>, release_gil());
+
+    m.def("prod_fiber_async_fp64", &prod_fiber_async<fp64_t>, release_gil());
+    m.def("prod_fiber_async_fp32", &prod_fiber_async<fp32_t>, release_gil());
+    m.def("prod_fiber_fp64", &prod_fiber<fp64_t>, release_gil());
+    m.def("prod_fiber_fp32", &prod_fiber<fp32_t>, release_gil());
+
+    m.def("prod_fiber3_async_fp64", &prod_fiber3_async<fp64_t>, release_gil());
+    m.def("prod_fiber3_async_fp32", &prod_fiber3_async<fp32_t>, release_gil());
+    m.def("prod_fiber3_fp64", &prod_fiber3<fp64_t>, release_gil());
+    m.def("prod_fiber3_fp32", &prod_fiber3<fp32_t>, release_gil());
+
+    m.def("gather_async_fp64", &gather_async<fp64_t>, release_gil());
+    m.def("gather_async_fp32", &gather_async<fp32_t>, release_gil());
+    m.def("gather_async_bf16", &gather_async<bf16_t>, release_gil());
+    m.def("gather_async_int64", &gather_async<Index>, release_gil());
+    m.def("gather_async_bool", &gather_async<bool_t>, release_gil());
+    m.def("gather_fp64", &gather<fp64_t>, release_gil());
+    m.def("gather_fp32", &gather<fp32_t>, release_gil());
+    m.def("gather_bf16", &gather<bf16_t>, release_gil());
+    m.def("gather_int64", &gather<Index>, release_gil());
+    m.def("gather_bool", &gather<bool_t>, release_gil());
+    m.def("broadcast_async_fp64", &broadcast_async<fp64_t>, release_gil());
+    m.def("broadcast_async_fp32", &broadcast_async<fp32_t>, release_gil());
+    m.def("reduce_async_fp64", &reduce_async<fp64_t>, release_gil());
+    m.def("reduce_async_fp32", &reduce_async<fp32_t>, release_gil());
+    m.def("allreduce_async_fp64", &allreduce_async<fp64_t>, release_gil());
+    m.def("allreduce_async_fp32", &allreduce_async<fp32_t>, release_gil());
+    m.def("allgather_async_fp64", &allgather_async<fp64_t>, release_gil());
+    m.def("allgather_async_fp32", &allgather_async<fp32_t>, release_gil());
+
+    m.def("copy_intersection_async_fp64", &copy_intersection_async<fp64_t>,
+            release_gil());
+    m.def("copy_intersection_async_fp32", &copy_intersection_async<fp32_t>,
+            release_gil());
+    m.def("copy_intersection_async_int64", &copy_intersection_async<Index>,
+            release_gil());
+    m.def("copy_intersection_async_int8",
+            &copy_intersection_async<std::int8_t>, release_gil());
+    m.def("copy_intersection_async_fp8_e4m3",
+            &copy_intersection_async<fp8_e4m3_t>, release_gil());
+
+    m.def("copy_intersection_fp64", &copy_intersection<fp64_t>, release_gil());
+    m.def("copy_intersection_fp32", &copy_intersection<fp32_t>, release_gil());
+    m.def("copy_intersection_int64", &copy_intersection<Index>, release_gil());
+    m.def("copy_intersection_int8", &copy_intersection<std::int8_t>,
+            release_gil());
+    m.def("copy_intersection_fp8_e4m3", &copy_intersection<fp8_e4m3_t>,
+            release_gil());
+
+    m.def("redistribute_async_fp64", &redistribute_async<fp64_t>,
+            release_gil());
+    m.def("redistribute_async_fp32", &redistribute_async<fp32_t>,
+            release_gil());
+    m.def("redistribute_async_int64", &redistribute_async<Index>,
+            release_gil());
+
+    m.def("redistribute_fp64", &redistribute<fp64_t>, release_gil());
+    m.def("redistribute_fp32", &redistribute<fp32_t>, release_gil());
+    m.def("redistribute_int64", &redistribute<Index>, release_gil());
     
-    m.def("copy_async_fp64", &copy_async<fp64_t>);
-    m.def("copy_async_fp32", &copy_async<fp32_t>);
-    m.def("copy_async_int64", &copy_async<Index>);
-
-    m.def("copy_fp64", &copy<fp64_t>);
-    m.def("copy_fp32", &copy<fp32_t>);
-    m.def("copy_int64", &copy<Index>);
-
-    m.def("clear_async_fp64", &clear_async<fp64_t>);
-    m.def("clear_async_fp32", &clear_async<fp32_t>);
-    m.def("clear_async_fp16", &clear_async<fp16_t>);
-    m.def("clear_fp64", &clear<fp64_t>);
-    m.def("clear_fp32", &clear<fp32_t>);
-    m.def("clear_fp16", &clear<fp16_t>);
+    m.def("copy_async_fp64", &copy_async<fp64_t>, release_gil());
+    m.def("copy_async_fp32", &copy_async<fp32_t>, release_gil());
+    m.def("copy_async_int64", &copy_async<Index>, release_gil());
+
+    m.def("copy_fp64", &copy<fp64_t>, release_gil());
+    m.def("copy_fp32", &copy<fp32_t>, release_gil());
+    m.def("copy_int64", &copy<Index>, release_gil());
+
+    m.def("clear_async_fp64", &clear_async<fp64_t>, release_gil());
+    m.def("clear_async_fp32", &clear_async<fp32_t>, release_gil());
+    m.def("clear_async_fp16", &clear_async<fp16_t>, release_gil());
+    m.def("clear_async_bf16", &clear_async<bf16_t>, release_gil());
+    m.def("clear_async_bool", &clear_async<bool_t>, release_gil());
+    m.def("clear_fp64", &clear<fp64_t>, release_gil());
+    m.def("clear_fp32", &clear<fp32_t>, release_gil());
+    m.def("clear_fp16", &clear<fp16_t>, release_gil());
+    m.def("clear_bf16", &clear<bf16_t>, release_gil());
+    m.def("clear_bool", &clear<bool_t>, release_gil());
         
     m.def("axpy_async_fp64", py::overload_cast<fp64_t, const Tensor<fp64_t>&,
-            const Tensor<fp64_t>&>(&axpy_async<fp64_t>));
+            const Tensor<fp64_t>&>(&axpy_async<fp64_t>), release_gil());
     m.def("axpy_async_fp32", py::overload_cast<fp32_t, const Tensor<fp32_t>&,
-            const Tensor<fp32_t>&>(&axpy_async<fp32_t>));
+            const Tensor<fp32_t>&>(&axpy_async<fp32_t>), release_gil());
     m.def("axpy_fp64", py::overload_cast<fp64_t, const Tensor<fp64_t>&,
-            const Tensor<fp64_t>&>(&axpy<fp64_t>));
+            const Tensor<fp64_t>&>(&axpy<fp64_t>), release_gil());
     m.def("axpy_fp32", py::overload_cast<fp32_t, const Tensor<fp32_t>&,
-            const Tensor<fp32_t>&>(&axpy<fp32_t>));
+            const Tensor<fp32_t>&>(&axpy<fp32_t>), release_gil());
 
     m.def("axpy_async_fp64", py::overload_cast<const Tensor<fp64_t>&,
             const Tensor<fp64_t>&,
-            const Tensor<fp64_t>&>(&axpy_async<fp64_t>));
+            const Tensor<fp64_t>&>(&axpy_async<fp64_t>), release_gil());
     m.def("axpy_async_fp32", py::overload_cast<const Tensor<fp32_t>&,
             const Tensor<fp32_t>&,
-            const Tensor<fp32_t>&>(&axpy_async<fp32_t>));
+            const Tensor<fp32_t>&>(&axpy_async<fp32_t>), release_gil());
     m.def("axpy_fp64", py::overload_cast<const Tensor<fp64_t>&,
-            const Tensor<fp64_t>&, const Tensor<fp64_t>&>(&axpy<fp64_t>));
+            const Tensor<fp64_t>&, const Tensor<fp64_t>&>(&axpy<fp64_t>),
+            release_gil());
     m.def("axpy_fp32", py::overload_cast<const Tensor<fp32_t>&,
-            const Tensor<fp32_t>&, const Tensor<fp32_t>&>(&axpy<fp32_t>));
-
-    m.def("sqrt_async_fp64", &sqrt_async<fp64_t>);
-    m.def("sqrt_async_fp32", &sqrt_async<fp32_t>);
-    m.def("sqrt_fp64", &sqrt<fp64_t>);
-    m.def("sqrt_fp32", &sqrt<fp32_t>);
-    m.def("sqrt_inplace_async_fp64", &sqrt_inplace_async<fp64_t>);
-    m.def("sqrt_inplace_async_fp32", &sqrt_inplace_async<fp32_t>);
-    m.def("sqrt_inplace_fp64", &sqrt_inplace<fp64_t>);
-    m.def("sqrt_inplace_fp32", &sqrt_inplace<fp32_t>);
-    m.def("maximum_async_fp64", &maximum_async<fp64_t>);
-    m.def("maximum_async_fp32", &maximum_async<fp32_t>);
-    m.def("maximum_fp64", &maximum<fp64_t>);
-    m.def("maximum_fp32", &maximum<fp32_t>);
-
-    m.def("addcdiv_async_fp64", &addcdiv_async<fp64_t>);
-    m.def("addcdiv_async_fp32", &addcdiv_async<fp32_t>);
-    m.def("addcdiv_fp64", &addcdiv<fp64_t>);
-    m.def("addcdiv_fp32", &addcdiv<fp32_t>);
-
-    m.def("logsumexp_async_fp64", &logsumexp_async<fp64_t>);
-    m.def("logsumexp_async_fp32", &logsumexp_async<fp32_t>);
-    m.def("logsumexp_fp64", &logsumexp<fp64_t>);
-    m.def("logsumexp_fp32", &logsumexp<fp32_t>);
-
-    m.def("total_sum_accum_async_fp64", &total_sum_accum_async<fp64_t>);
-    m.def("total_sum_accum_async_fp32", &total_sum_accum_async<fp32_t>);
-    m.def("total_sum_accum_fp64", &total_sum_accum<fp64_t>);
-    m.def("total_sum_accum_fp32", &total_sum_accum<fp32_t>);
+            const Tensor<fp32_t>&, const Tensor<fp32_t>&>(&axpy<fp32_t>),
+            release_gil());
+
+    m.def("sqrt_async_fp64", &sqrt_async<fp64_t>, release_gil());
+    m.def("sqrt_async_fp32", &sqrt_async<fp32_t>, release_gil());
+    m.def("sqrt_fp64", &sqrt<fp64_t>, release_gil());
+    m.def("sqrt_fp32", &sqrt<fp32_t>, release_gil());
+    m.def("sqrt_inplace_async_fp64", &sqrt_inplace_async<fp64_t>,
+            release_gil());
+    m.def("sqrt_inplace_async_fp32", &sqrt_inplace_async<fp32_t>,
+            release_gil());
+    m.def("sqrt_inplace_fp64", &sqrt_inplace<fp64_t>, release_gil());
+    m.def("sqrt_inplace_fp32", &sqrt_inplace<fp32_t>, release_gil());
+    m.def("maximum_async_fp64", &maximum_async<fp64_t>, release_gil());
+    m.def("maximum_async_fp32", &maximum_async<fp32_t>, release_gil());
+    m.def("maximum_fp64", &maximum<fp64_t>, release_gil());
+    m.def("maximum_fp32", &maximum<fp32_t>, release_gil());
+
+    m.def("addcdiv_async_fp64", &addcdiv_async<fp64_t>, release_gil());
+    m.def("addcdiv_async_fp32", &addcdiv_async<fp32_t>, release_gil());
+    m.def("addcdiv_fp64", &addcdiv<fp64_t>, release_gil());
+    m.def("addcdiv_fp32", &addcdiv<fp32_t>, release_gil());
+
+    m.def("logsumexp_async_fp64", &logsumexp_async<fp64_t>, release_gil());
+    m.def("logsumexp_async_fp32", &logsumexp_async<fp32_t>, release_gil());
+    m.def("logsumexp_fp64", &logsumexp<fp64_t>, release_gil());
+    m.def("logsumexp_fp32", &logsumexp<fp32_t>, release_gil());
+
+    m.def("total_sum_accum_async_fp64", &total_sum_accum_async<fp64_t>,
+            release_gil());
+    m.def("total_sum_accum_async_fp32", &total_sum_accum_async<fp32_t>,
+            release_gil());
+    m.def("total_sum_accum_fp64", &total_sum_accum<fp64_t>, release_gil());
+    m.def("total_sum_accum_fp32", &total_sum_accum<fp32_t>, release_gil());
+
+    m.def("softmax_crossentropy_async_fp64",
+            &softmax_crossentropy_async<fp64_t>, release_gil());
+    m.def("softmax_crossentropy_async_fp32",
+            &softmax_crossentropy_async<fp32_t>, release_gil());
+    m.def("softmax_crossentropy_fp64", &softmax_crossentropy<fp64_t>,
+            release_gil());
+    m.def("softmax_crossentropy_fp32", &softmax_crossentropy<fp32_t>,
+            release_gil());
 
     m.def("subtract_indexed_outputs_async_fp64",
-            &subtract_indexed_outputs_async<fp64_t>);
+            &subtract_indexed_outputs_async<fp64_t>, release_gil());
     m.def("subtract_indexed_outputs_async_fp32",
-            &subtract_indexed_outputs_async<fp32_t>);
-    m.def("subtract_indexed_outputs_fp64", &subtract_indexed_outputs<fp64_t>);
-    m.def("subtract_indexed_outputs_fp32", &subtract_indexed_outputs<fp32_t>);
+            &subtract_indexed_outputs_async<fp32_t>, release_gil());
+    m.def("subtract_indexed_outputs_fp64", &subtract_indexed_outputs<fp64_t>,
+            release_gil());
+    m.def("subtract_indexed_outputs_fp32", &subtract_indexed_outputs<fp32_t>,
+            release_gil());
     
-    m.def("scal_async_fp64", &scal_async<fp64_t>);
-    m.def("scal_async_fp32", &scal_async<fp32_t>);
-    m.def("scal_fp64", &scal<fp64_t>);
-    m.def("scal_fp32", &scal<fp32_t>);
-
-    m.def("adam_step_async_fp64", &adam_step_async<fp64_t>);
-    m.def("adam_step_async_fp32", &adam_step_async<fp32_t>);
-    m.def("adam_step_fp64", &adam_step<fp64_t>);
-    m.def("adam_step_fp32", &adam_step<fp32_t>);
-
-    m.def("adamw_step_async_fp64", &adamw_step_async<fp64_t>);
-    m.def("adamw_step_async_fp32", &adamw_step_async<fp32_t>);
-    m.def("adamw_step_fp64", &adamw_step<fp64_t>);
-    m.def("adamw_step_fp32", &adamw_step<fp32_t>);
-
-    m.def("scal_inplace_async_fp64", &scal_inplace_async<fp64_t>);
-    m.def("scal_inplace_async_fp32", &scal_inplace_async<fp32_t>);
-    m.def("scal_inplace_fp64", &scal_inplace<fp64_t>);
-    m.def("scal_inplace_fp32", &scal_inplace<fp32_t>);
-
-    m.def("sumprod_slice_async_fp64", &sumprod_slice_async<fp64_t>);
-    m.def("sumprod_slice_async_fp32", &sumprod_slice_async<fp32_t>);
-    m.def("sumprod_slice_fp64", &sumprod_slice<fp64_t>);
-    m.def("sumprod_slice_fp32", &sumprod_slice<fp32_t>);
+    m.def("scal_async_fp64", &scal_async<fp64_t>, release_gil());
+    m.def("scal_async_fp32", &scal_async<fp32_t>, release_gil());
+    m.def("scal_fp64", &scal<fp64_t>, release_gil());
+    m.def("scal_fp32", &scal<fp32_t>, release_gil());
+
+    m.def("adam_step_async_fp64", &adam_step_async<fp64_t>, release_gil());
+    m.def("adam_step_async_fp32", &adam_step_async<fp32_t>, release_gil());
+    m.def("adam_step_fp64", &adam_step<fp64_t>, release_gil());
+    m.def("adam_step_fp32", &adam_step<fp32_t>, release_gil());
+
+    m.def("sparse_adam_step_async_fp64", &sparse_adam_step_async<fp64_t>,
+            release_gil());
+    m.def("sparse_adam_step_async_fp32", &sparse_adam_step_async<fp32_t>,
+            release_gil());
+    m.def("sparse_adam_step_fp64", &sparse_adam_step<fp64_t>, release_gil());
+    m.def("sparse_adam_step_fp32", &sparse_adam_step<fp32_t>, release_gil());
+
+    m.def("sgd_step_async_fp64", &sgd_step_async<fp64_t>, release_gil());
+    m.def("sgd_step_async_fp32", &sgd_step_async<fp32_t>, release_gil());
+    m.def("sgd_step_fp64", &sgd_step<fp64_t>, release_gil());
+    m.def("sgd_step_fp32", &sgd_step<fp32_t>, release_gil());
+
+    m.def("adafactor_step_async_fp64", &adafactor_step_async<fp64_t>,
+            release_gil());
+    m.def("adafactor_step_async_fp32", &adafactor_step_async<fp32_t>,
+            release_gil());
+    m.def("adafactor_step_fp64", &adafactor_step<fp64_t>, release_gil());
+    m.def("adafactor_step_fp32", &adafactor_step<fp32_t>, release_gil());
+
+    m.def("quantized_adam_step_async", &quantized_adam_step_async,
+            release_gil());
+    m.def("quantized_adam_step", &quantized_adam_step, release_gil());
+
+    m.def("adamw_step_async_fp64", &adamw_step_async<fp64_t>, release_gil());
+    m.def("adamw_step_async_fp32", &adamw_step_async<fp32_t>, release_gil());
+    m.def("adamw_step_fp64", &adamw_step<fp64_t>, release_gil());
+    m.def("adamw_step_fp32", &adamw_step<fp32_t>, release_gil());
+
+    m.def("multi_adam_step_async_fp64", &multi_adam_step_async<fp64_t>,
+            release_gil());
+    m.def("multi_adam_step_async_fp32", &multi_adam_step_async<fp32_t>,
+            release_gil());
+    m.def("multi_adam_step_fp64", &multi_adam_step<fp64_t>, release_gil());
+    m.def("multi_adam_step_fp32", &multi_adam_step<fp32_t>, release_gil());
+    m.def("multi_adam_step_scaled_async_fp64",
+            &multi_adam_step_scaled_async<fp64_t>, release_gil());
+    m.def("multi_adam_step_scaled_async_fp32",
+            &multi_adam_step_scaled_async<fp32_t>, release_gil());
+    m.def("multi_adam_step_scaled_fp64", &multi_adam_step_scaled<fp64_t>,
+            release_gil());
+    m.def("multi_adam_step_scaled_fp32", &multi_adam_step_scaled<fp32_t>,
+            release_gil());
+
+    m.def("global_nrm2_async_fp64", &global_nrm2_async<fp64_t>,
+            release_gil());
+    m.def("global_nrm2_async_fp32", &global_nrm2_async<fp32_t>,
+            release_gil());
+    m.def("global_nrm2_fp64", &global_nrm2<fp64_t>, release_gil());
+    m.def("global_nrm2_fp32", &global_nrm2<fp32_t>, release_gil());
+
+    m.def("clip_scale_async_fp64", &clip_scale_async<fp64_t>, release_gil());
+    m.def("clip_scale_async_fp32", &clip_scale_async<fp32_t>, release_gil());
+    m.def("clip_scale_fp64", &clip_scale<fp64_t>, release_gil());
+    m.def("clip_scale_fp32", &clip_scale<fp32_t>, release_gil());
+
+    m.def("fused_elementwise_async_fp64",
+            &fused_elementwise_async_tuples<fp64_t>, release_gil());
+    m.def("fused_elementwise_async_fp32",
+            &fused_elementwise_async_tuples<fp32_t>, release_gil());
+
+    m.def("scal_inplace_async_fp64", &scal_inplace_async<fp64_t>,
+            release_gil());
+    m.def("scal_inplace_async_fp32", &scal_inplace_async<fp32_t>,
+            release_gil());
+    m.def("scal_inplace_fp64", &scal_inplace<fp64_t>, release_gil());
+    m.def("scal_inplace_fp32", &scal_inplace<fp32_t>, release_gil());
+
+    m.def("sumprod_slice_async_fp64", &sumprod_slice_async<fp64_t>,
+            release_gil());
+    m.def("sumprod_slice_async_fp32", &sumprod_slice_async<fp32_t>,
+            release_gil());
+    m.def("sumprod_slice_fp64", &sumprod_slice<fp64_t>, release_gil());
+    m.def("sumprod_slice_fp32", &sumprod_slice<fp32_t>, release_gil());
     
-    m.def("sumprod_fiber_async_fp64", &sumprod_fiber_async<fp64_t>);
-    m.def("sumprod_fiber_async_fp32", &sumprod_fiber_async<fp32_t>);
-    m.def("sumprod_fiber_fp64", &sumprod_fiber<fp64_t>);
-    m.def("sumprod_fiber_fp32", &sumprod_fiber<fp32_t>);
+    m.def("sumprod_fiber_async_fp64", &sumprod_fiber_async<fp64_t>,
+            release_gil());
+    m.def("sumprod_fiber_async_fp32", &sumprod_fiber_async<fp32_t>,
+            release_gil());
+    m.def("sumprod_fiber_fp64", &sumprod_fiber<fp64_t>, release_gil());
+    m.def("sumprod_fiber_fp32", &sumprod_fiber<fp32_t>, release_gil());
     
     // gelu and dgelu
-    m.def("gelu_async_fp64", &gelu_async<fp64_t>);
-    m.def("gelu_async_fp32", &gelu_async<fp32_t>);
-    m.def("gelu_fp64", &gelu<fp64_t>);
-    m.def("gelu_fp32", &gelu<fp32_t>);
-    m.def("gelu_backward_async_fp64", &gelu_backward_async<fp64_t>);
-    m.def("gelu_backward_async_fp32", &gelu_backward_async<fp32_t>);
-    m.def("gelu_backward_fp64", &gelu_backward<fp64_t>);
-    m.def("gelu_backward_fp32", &gelu_backward<fp32_t>);
-
-    m.def("gelutanh_async_fp64", &gelutanh_async<fp64_t>);
-    m.def("gelutanh_async_fp32", &gelutanh_async<fp32_t>);
-    m.def("gelutanh_fp64", &gelutanh<fp64_t>);
-    m.def("gelutanh_fp32", &gelutanh<fp32_t>);
-    m.def("gelutanh_inplace_async_fp64", &gelutanh_inplace_async<fp64_t>);
-    m.def("gelutanh_inplace_async_fp32", &gelutanh_inplace_async<fp32_t>);
-    m.def("gelutanh_inplace_fp64", &gelutanh_inplace<fp64_t>);
-    m.def("gelutanh_inplace_fp32", &gelutanh_inplace<fp32_t>);
-    m.def("gelutanh_backward_async_fp64", &gelutanh_backward_async<fp64_t>);
-    m.def("gelutanh_backward_async_fp32", &gelutanh_backward_async<fp32_t>);
-    m.def("gelutanh_backward_fp64", &gelutanh_backward<fp64_t>);
-    m.def("gelutanh_backward_fp32", &gelutanh_backward<fp32_t>);
+    m.def("gelu_async_fp64", &gelu_async<fp64_t>, release_gil());
+    m.def("gelu_async_fp32", &gelu_async<fp32_t>, release_gil());
+    m.def("gelu_fp64", &gelu<fp64_t>, release_gil());
+    m.def("gelu_fp32", &gelu<fp32_t>, release_gil());
+    m.def("gelu_backward_async_fp64", &gelu_backward_async<fp64_t>,
+            release_gil());
+    m.def("gelu_backward_async_fp32", &gelu_backward_async<fp32_t>,
+            release_gil());
+    m.def("gelu_backward_fp64", &gelu_backward<fp64_t>, release_gil());
+    m.def("gelu_backward_fp32", &gelu_backward<fp32_t>, release_gil());
+
+    m.def("gelutanh_async_fp64", &gelutanh_async<fp64_t>, release_gil());
+    m.def("gelutanh_async_fp32", &gelutanh_async<fp32_t>, release_gil());
+    m.def("gelutanh_fp64", &gelutanh<fp64_t>, release_gil());
+    m.def("gelutanh_fp32", &gelutanh<fp32_t>, release_gil());
+    m.def("gelutanh_inplace_async_fp64", &gelutanh_inplace_async<fp64_t>,
+            release_gil());
+    m.def("gelutanh_inplace_async_fp32", &gelutanh_inplace_async<fp32_t>,
+            release_gil());
+    m.def("gelutanh_inplace_async_bf16", &gelutanh_inplace_async<bf16_t>,
+            release_gil());
+    m.def("gelutanh_inplace_async_fp16", &gelutanh_inplace_async<fp16_t>,
+            release_gil());
+    m.def("gelutanh_inplace_fp64", &gelutanh_inplace<fp64_t>, release_gil());
+    m.def("gelutanh_inplace_fp32", &gelutanh_inplace<fp32_t>, release_gil());
+    m.def("gelutanh_inplace_bf16", &gelutanh_inplace<bf16_t>, release_gil());
+    m.def("gelutanh_inplace_fp16", &gelutanh_inplace<fp16_t>, release_gil());
+    m.def("gelutanh_backward_async_fp64", &gelutanh_backward_async<fp64_t>,
+            release_gil());
+    m.def("gelutanh_backward_async_fp32", &gelutanh_backward_async<fp32_t>,
+            release_gil());
+    m.def("gelutanh_backward_fp64", &gelutanh_backward<fp64_t>, release_gil());
+    m.def("gelutanh_backward_fp32", &gelutanh_backward<fp32_t>, release_gil());
     
-    m.def("dgelu_async_fp64", &dgelu_async<fp64_t>);
-    m.def("dgelu_async_fp32", &dgelu_async<fp32_t>);
-    m.def("dgelu_fp64", &dgelu<fp64_t>);
-    m.def("dgelu_fp32", &dgelu<fp32_t>);
-    m.def("dgelutanh_async_fp64", &dgelutanh_async<fp64_t>);
-    m.def("dgelutanh_async_fp32", &dgelutanh_async<fp32_t>);
-    m.def("dgelutanh_fp64", &dgelutanh<fp64_t>);
-    m.def("dgelutanh_fp32", &dgelutanh<fp32_t>);   
+    m.def("dgelu_async_fp64", &dgelu_async<fp64_t>, release_gil());
+    m.def("dgelu_async_fp32", &dgelu_async<fp32_t>, release_gil());
+    m.def("dgelu_fp64", &dgelu<fp64_t>, release_gil());
+    m.def("dgelu_fp32", &dgelu<fp32_t>, release_gil());
+    m.def("dgelutanh_async_fp64", &dgelutanh_async<fp64_t>, release_gil());
+    m.def("dgelutanh_async_fp32", &dgelutanh_async<fp32_t>, release_gil());
+    m.def("dgelutanh_fp64", &dgelutanh<fp64_t>, release_gil());
+    m.def("dgelutanh_fp32", &dgelutanh<fp32_t>, release_gil());
 
     // Embedding forward pass
-    m.def("embedding_async_fp64", &embedding_async<fp64_t>);
-    m.def("embedding_async_fp32", &embedding_async<fp32_t>);
-    m.def("embedding_fp64", &embedding<fp64_t>);
-    m.def("embedding_fp32", &embedding<fp32_t>);
+    m.def("embedding_async_fp64", &embedding_async<fp64_t>, release_gil());
+    m.def("embedding_async_fp32", &embedding_async<fp32_t>, release_gil());
+    m.def("embedding_fp64", &embedding<fp64_t>, release_gil());
+    m.def("embedding_fp32", &embedding<fp32_t>, release_gil());
 
     // Embedding backward pass
-    m.def("embedding_backward_async_fp64", &embedding_backward_async<fp64_t>);
-    m.def("embedding_backward_async_fp32", &embedding_backward_async<fp32_t>);
-    m.def("embedding_backward_fp64", &embedding_backward<fp64_t>);
-    m.def("embedding_backward_fp32", &embedding_backward<fp32_t>);
+    m.def("embedding_backward_async_fp64", &embedding_backward_async<fp64_t>,
+            release_gil());
+    m.def("embedding_backward_async_fp32", &embedding_backward_async<fp32_t>,
+            release_gil());
+    m.def("embedding_backward_fp64", &embedding_backward<fp64_t>,
+            release_gil());
+    m.def("embedding_backward_fp32", &embedding_backward<fp32_t>,
+            release_gil());
+
+    // Mark rows of vocabulary, used by tokens
+    m.def("embedding_rows_async", &embedding_rows_async, release_gil());
+    m.def("embedding_rows", &embedding_rows, release_gil());
 
     // FP32 <-> FP16
-    m.def("fp32_to_fp16_async", &fp32_to_fp16_async);
-    m.def("fp16_to_fp32_async", &fp16_to_fp32_async);
-
-    m.def("mask_scalar_async_fp64", &mask_scalar_async<fp64_t>);
-    m.def("mask_scalar_async_fp32", &mask_scalar_async<fp32_t>);
-    m.def("mask_scalar_fp64", &mask_scalar<fp64_t>);
-    m.def("mask_scalar_fp32", &mask_scalar<fp32_t>);
-
-    m.def("hypot_async_fp64", &hypot_async<fp64_t>);
-    m.def("hypot_async_fp32", &hypot_async<fp32_t>);
-    m.def("hypot_fp64", &hypot<fp64_t>);
-    m.def("hypot_fp32", &hypot<fp32_t>);
-
-    m.def("hypot_scalar_inverse_async_fp64", &hypot_scalar_inverse_async<fp64_t>);
-    m.def("hypot_scalar_inverse_async_fp32", &hypot_scalar_inverse_async<fp32_t>);
-    m.def("hypot_scalar_inverse_fp64", &hypot_scalar_inverse<fp64_t>);
-    m.def("hypot_scalar_inverse_fp32", &hypot_scalar_inverse<fp32_t>);
-
-    m.def("transpose_async_fp64", &transpose_async<fp64_t>);
-    m.def("transpose_async_fp32", &transpose_async<fp32_t>);
-    m.def("transpose_fp64", &transpose<fp64_t>);
-    m.def("transpose_fp32", &transpose<fp32_t>);
-
-    m.def("conv2d_async_fp64", &transpose_async<fp64_t>);
-    m.def("conv2d_async_fp32", &transpose_async<fp32_t>);
-    m.def("conv2d_fp64", &transpose<fp64_t>);
-    m.def("conv2d_fp32", &transpose<fp32_t>);
-
-    m.def("strassen_fp64", &strassen<fp64_t, fp64_t>);
-    m.def("strassen_fp32", &strassen<fp32_t, fp32_t>);
+    m.def("fp32_to_fp16_async", &fp32_to_fp16_async, release_gil());
+    m.def("fp16_to_fp32_async", &fp16_to_fp32_async, release_gil());
+
+    // FP32 <-> BF16
+    m.def("fp32_to_bf16_async", &fp32_to_bf16_async, release_gil());
+    m.def("bf16_to_fp32_async", &bf16_to_fp32_async, release_gil());
+
+    m.def("mask_scalar_async_fp64", &mask_scalar_async<fp64_t>, release_gil());
+    m.def("mask_scalar_async_fp32", &mask_scalar_async<fp32_t>, release_gil());
+    m.def("mask_scalar_fp64", &mask_scalar<fp64_t>, release_gil());
+    m.def("mask_scalar_fp32", &mask_scalar<fp32_t>, release_gil());
+
+    m.def("hypot_async_fp64", &hypot_async<fp64_t>, release_gil());
+    m.def("hypot_async_fp32", &hypot_async<fp32_t>, release_gil());
+    m.def("hypot_fp64", &hypot<fp64_t>, release_gil());
+    m.def("hypot_fp32", &hypot<fp32_t>, release_gil());
+
+    m.def("hypot_scalar_inverse_async_fp64", &hypot_scalar_inverse_async<fp64_t>,
+            release_gil());
+    m.def("hypot_scalar_inverse_async_fp32", &hypot_scalar_inverse_async<fp32_t>,
+            release_gil());
+    m.def("hypot_scalar_inverse_fp64", &hypot_scalar_inverse<fp64_t>,
+            release_gil());
+    m.def("hypot_scalar_inverse_fp32", &hypot_scalar_inverse<fp32_t>,
+            release_gil());
+
+    m.def("transpose_async_fp64", &transpose_async<fp64_t>, release_gil());
+    m.def("transpose_async_fp32", &transpose_async<fp32_t>, release_gil());
+    m.def("transpose_fp64", &transpose<fp64_t>, release_gil());
+    m.def("transpose_fp32", &transpose<fp32_t>, release_gil());
+
+    m.def("permute_async_fp64", &permute_async<fp64_t>, release_gil());
+    m.def("permute_async_fp32", &permute_async<fp32_t>, release_gil());
+    m.def("permute_fp64", &permute<fp64_t>, release_gil());
+    m.def("permute_fp32", &permute<fp32_t>, release_gil());
+
+    m.def("contract_async_fp64", &contract_async_next_tag<fp64_t>,
+            py::arg("alpha"), py::arg("A"), py::arg("B"), py::arg("beta"),
+            py::arg("C"), py::arg("subscripts"), py::arg("next_tag"),
+            py::arg("redux")=0, release_gil());
+    m.def("contract_async_fp32", &contract_async_next_tag<fp32_t>,
+            py::arg("alpha"), py::arg("A"), py::arg("B"), py::arg("beta"),
+            py::arg("C"), py::arg("subscripts"), py::arg("next_tag"),
+            py::arg("redux")=0, release_gil());
+
+    m.def("conv2d_async_fp64", &conv2d_async<fp64_t>, release_gil());
+    m.def("conv2d_async_fp32", &conv2d_async<fp32_t>, release_gil());
+    m.def("conv2d_fp64", &conv2d<fp64_t>, release_gil());
+    m.def("conv2d_fp32", &conv2d<fp32_t>, release_gil());
+    m.def("conv2d_backward_input_async_fp64", &conv2d_backward_input_async<fp64_t>,
+            release_gil());
+    m.def("conv2d_backward_input_async_fp32", &conv2d_backward_input_async<fp32_t>,
+            release_gil());
+    m.def("conv2d_backward_input_fp64", &conv2d_backward_input<fp64_t>, release_gil());
+    m.def("conv2d_backward_input_fp32", &conv2d_backward_input<fp32_t>, release_gil());
+    m.def("conv2d_backward_weight_async_fp64", &conv2d_backward_weight_async<fp64_t>,
+            release_gil());
+    m.def("conv2d_backward_weight_async_fp32", &conv2d_backward_weight_async<fp32_t>,
+            release_gil());
+    m.def("conv2d_backward_weight_fp64", &conv2d_backward_weight<fp64_t>, release_gil());
+    m.def("conv2d_backward_weight_fp32", &conv2d_backward_weight<fp32_t>, release_gil());
+
+    m.def("strassen_async_fp64", &strassen_async<fp64_t, fp64_t>,
+            release_gil());
+    m.def("strassen_async_fp32", &strassen_async<fp32_t, fp32_t>,
+            release_gil());
+    m.def("strassen_fp64", &strassen<fp64_t, fp64_t>, release_gil());
+    m.def("strassen_fp32", &strassen<fp32_t, fp32_t>, release_gil());
     // m.def("strassen_fp16", &strassen<fp16_t, fp32_t>);
 }
 
+// Define C++ layers of a given type
+template<typename T>
+void def_class_layer(py::module_ &m, const char *suffix)
+{
+    using namespace nntile::layer;
+    using tensor::Tensor;
+    auto name = [suffix](const char *cls)
+    {
+        return std::string(cls) + "_" + suffix;
+    };
+    py::class_<Moments<T>>(m, name("Moments").c_str()).
+        def(py::init<const Tensor<T> &, const Tensor<T> &>(),
+                py::arg("value"), py::arg("grad")).
+        def_readonly("value", &Moments<T>::value).
+        def_readonly("grad", &Moments<T>::grad);
+    py::class_<Module<T>, std::shared_ptr<Module<T>>>(m,
+            name("Module").c_str()).
+        def("forward_async", &Module<T>::forward_async,
+                py::call_guard<py::gil_scoped_release>()).
+        def("backward_async", &Module<T>::backward_async,
+                py::call_guard<py::gil_scoped_release>());
+    py::class_<Act<T>, Module<T>, std::shared_ptr<Act<T>>>(m,
+            name("Act").c_str()).
+        def(py::init<const Moments<T> &, const Moments<T> &,
+                const std::string &>(), py::arg("x"), py::arg("y"),
+                py::arg("funcname"));
+    py::class_<Add<T>, Module<T>, std::shared_ptr<Add<T>>>(m,
+            name("Add").c_str()).
+        def(py::init<const Moments<T> &, const Moments<T> &,
+                const Moments<T> &>(), py::arg("x"), py::arg("y"),
+                py::arg("res"));
+    py::class_<AddLayerNorm<T>, Module<T>, std::shared_ptr<AddLayerNorm<T>>>(
+            m, name("AddLayerNorm").c_str()).
+        def(py::init<const Moments<T> &, const Moments<T> &,
+                const Moments<T> &, const Moments<T> &, const Moments<T> &,
+                const Moments<T> &, const Tensor<T> &, const Tensor<T> &,
+                Index, T, int>(), py::arg("x"), py::arg("r"), py::arg("res"),
+                py::arg("y"), py::arg("gamma"), py::arg("beta"),
+                py::arg("mean"), py::arg("inv_stddev"), py::arg("axis"),
+                py::arg("eps"), py::arg("redux")=0);
+    py::class_<AddSlice<T>, Module<T>, std::shared_ptr<AddSlice<T>>>(m,
+            name("AddSlice").c_str()).
+        def(py::init<const Moments<T> &, const Moments<T> &,
+                const Moments<T> &, Index, int>(), py::arg("x"),
+                py::arg("y"), py::arg("u"), py::arg("axis"),
+                py::arg("redux")=0);
+    py::class_<Dense<T>, Module<T>, std::shared_ptr<Dense<T>>>(m,
+            name("Dense").c_str()).
+        def(py::init<char, const TransOp &, const Moments<T> &,
+                const Moments<T> &, const Moments<T> &,
+                const std::optional<Moments<T>> &, Index, bool, int, bool,
+                bool>(),
+                py::arg("side"), py::arg("trans_x"), py::arg("x"),
+                py::arg("y"), py::arg("w"), py::arg("b"), py::arg("ndim"),
+                py::arg("x_grad_required")=true, py::arg("redux")=0,
+                py::arg("w_grad_required")=true,
+                py::arg("b_grad_required")=true);
+    py::class_<Embedding<T>, Module<T>, std::shared_ptr<Embedding<T>>>(m,
+            name("Embedding").c_str()).
+        def(py::init<const Tensor<Index> &, const Moments<T> &,
+                const Moments<T> &, Index,
+                const std::optional<Tensor<bool_t>> &>(), py::arg("x"),
+                py::arg("y"), py::arg("w"), py::arg("axis"),
+                py::arg("rows")=py::none());
+    py::class_<LayerNorm<T>, Module<T>, std::shared_ptr<LayerNorm<T>>>(m,
+            name("LayerNorm").c_str()).
+        def(py::init<const Moments<T> &, const Moments<T> &,
+                const Moments<T> &, const Moments<T> &, const Tensor<T> &,
+                const Tensor<T> &, Index, T, int>(), py::arg("x"),
+                py::arg("y"), py::arg("gamma"), py::arg("beta"),
+                py::arg("mean"), py::arg("inv_stddev"), py::arg("axis"),
+                py::arg("eps"), py::arg("redux")=0);
+    py::class_<RMSNorm<T>, Module<T>, std::shared_ptr<RMSNorm<T>>>(m,
+            name("RMSNorm").c_str()).
+        def(py::init<const Moments<T> &, const Moments<T> &,
+                const Moments<T> &, const Tensor<T> &, Index, T, int>(),
+                py::arg("x"), py::arg("y"), py::arg("gamma"),
+                py::arg("inv_rms"), py::arg("axis"), py::arg("eps"),
+                py::arg("redux")=0);
+    using M = const Moments<T> &;
+    using OptM = const std::optional<Moments<T>> &;
+    py::class_<Attention<T>, Module<T>, std::shared_ptr<Attention<T>>>(m,
+            name("Attention").c_str()).
+        def(py::init<M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+                const Tensor<T> &, const Tensor<T> &, M, M, OptM, OptM, OptM,
+                OptM, const std::optional<Tensor<bool_t>> &, int>(),
+                py::arg("x_q"), py::arg("x_k"), py::arg("x_v"), py::arg("y"),
+                py::arg("w_q"), py::arg("w_k"), py::arg("w_v"), py::arg("w"),
+                py::arg("q_transposed"), py::arg("q"),
+                py::arg("k_transposed"), py::arg("k"),
+                py::arg("v_transposed"), py::arg("v"), py::arg("a"),
+                py::arg("a_maxsumexp"), py::arg("a_sumprod_slice"),
+                py::arg("b"), py::arg("b_transposed"),
+                py::arg("in_proj_bias_q"), py::arg("in_proj_bias_k"),
+                py::arg("in_proj_bias_v"), py::arg("out_proj_bias"),
+                py::arg("mask"), py::arg("redux")=0);
+    py::class_<FlashAttention<T>, Attention<T>,
+        std::shared_ptr<FlashAttention<T>>>(m,
+            name("FlashAttention").c_str()).
+        def(py::init<M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+                const Tensor<T> &, const Tensor<T> &, M, M, OptM, OptM, OptM,
+                OptM, const Tensor<bool_t> &, bool, int>(),
+                py::arg("x_q"), py::arg("x_k"), py::arg("x_v"), py::arg("y"),
+                py::arg("w_q"), py::arg("w_k"), py::arg("w_v"), py::arg("w"),
+                py::arg("q_transposed"), py::arg("q"),
+                py::arg("k_transposed"), py::arg("k"),
+                py::arg("v_transposed"), py::arg("v"), py::arg("a"),
+                py::arg("a_maxsumexp"), py::arg("a_sumprod_slice"),
+                py::arg("b"), py::arg("b_transposed"),
+                py::arg("in_proj_bias_q"), py::arg("in_proj_bias_k"),
+                py::arg("in_proj_bias_v"), py::arg("out_proj_bias"),
+                py::arg("mask"), py::arg("fused")=false,
+                py::arg("redux")=0);
+    // Forward and backward of all the layers are submitted with the GIL
+    // released, so Python threads are not blocked by submission
+    py::class_<Sequential<T>>(m, name("Sequential").c_str()).
+        def(py::init<const std::vector<std::shared_ptr<Module<T>>> &>(),
+                py::arg("layers")).
+        def("append", &Sequential<T>::append).
+        def("forward_async", &Sequential<T>::forward_async,
+                py::call_guard<py::gil_scoped_release>()).
+        def("backward_async", &Sequential<T>::backward_async,
+                py::arg("first_priority"),
+                py::call_guard<py::gil_scoped_release>()).
+        def("__len__", [](const Sequential<T> &seq)
+                {
+                    return seq.layers.size();
+                });
+}
+
+// Extend (sub)module with nntile::layer functionality
+void def_mod_layer(py::module_ &m)
+{
+    def_class_layer<fp64_t>(m, "fp64");
+    def_class_layer<fp32_t>(m, "fp32");
+}
+
 // Main extension module with all wrappers
 PYBIND11_MODULE(nntile_core, m)
 {
     // Add starpu submodule
     auto starpu = m.def_submodule("starpu");
     def_mod_starpu(starpu);
+    // Define GemmCompute class and corresponding constants before tensor
+    // submodule, as they are default arguments of gemm functions
+    py::class_<GemmCompute>(m, "GemmCompute").
+        // Constructor
+        def(py::init<const enum GemmCompute::Value &>());
+    m.attr("gemm_default") = py::cast(new GemmCompute(GemmCompute::Default));
+    m.attr("gemm_fast_tf32") = py::cast(
+            new GemmCompute(GemmCompute::FastTF32));
+    m.attr("gemm_fast_fp16") = py::cast(
+            new GemmCompute(GemmCompute::FastFP16));
+    m.attr("gemm_fast_bf16") = py::cast(
+            new GemmCompute(GemmCompute::FastBF16));
     // Add tile submodule
     auto tile = m.def_submodule("tile");
     def_mod_tile(tile);
@@ -768,4 +2488,7 @@ PYBIND11_MODULE(nntile_core, m)
         def(py::init<const enum TransOp::Value &>());
     m.attr("notrans") = py::cast(new TransOp(TransOp::NoTrans));
     m.attr("trans") = py::cast(new TransOp(TransOp::Trans));
+    // Add layer submodule after TransOp, that is an argument of layers
+    auto layer = m.def_submodule("layer");
+    def_mod_layer(layer);
 }
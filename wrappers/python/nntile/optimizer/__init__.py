@@ -13,6 +13,11 @@
 # @date 2023-11-26
 
 from .sgd import SGD
-from .adam import Adam, FusedAdam
+from .adam import Adam, FusedAdam, LazyAdam
 from .adamw import FusedAdamW
+from .adafactor import Adafactor
+from .quantized_adam import QuantizedAdam, QuantizedAdamW
 from .empty import Empty
+from .loss_scaler import StaticLossScaler, DynamicLossScaler
+from .mixed_precision import MixedPrecision
+from .sharded import Sharded
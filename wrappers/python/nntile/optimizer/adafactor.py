@@ -0,0 +1,148 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/optimizer/adafactor.py
+# Adafactor optimizer with factored second moments
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+import nntile
+import numpy as np
+from nntile.tensor import TensorTraits
+
+class Adafactor:
+    """Adafactor without first moments and without clipping of updates
+
+    Second moments of a parameter with at least 2 dimensions are factored
+    into moving averages of means of squared gradients over all dimensions
+    but the first one (row) and over all dimensions but the last one (col),
+    i.e., v = row*col/mean(row), so the state takes only m+n elements for a
+    m-by-n matrix instead of m*n. Second moments of other parameters are
+    kept as is. Weight decay is decoupled as in AdamW.
+    """
+    # Scalar attributes of a checkpoint
+    _state_attrs = ["num_iter", "beta2", "lr", "start_lr", "full_lr_iter", \
+            "eps", "weight_decay"]
+
+    def __init__(self, params, lr, next_tag, beta2=0.999, weight_decay=0., \
+            eps=1e-30, start_lr=None, full_lr_iter=None):
+        self.params = params
+        self.next_tag = next_tag
+        self.num_iter = 1
+        self.rows = []
+        self.cols = []
+        self.means = []
+        for p in self.params:
+            t = p.value
+            tensor_type = type(t)
+            dist = t.distribution
+            if t.ndim == 0:
+                raise ValueError("Scalar parameters are not supported")
+            if t.ndim < 2:
+                traits = TensorTraits(t.shape, t.basetile_shape)
+                self.rows.append(tensor_type(traits, dist, self.next_tag))
+                self.next_tag = self.rows[-1].next_tag
+                self.cols.append(None)
+                self.means.append(None)
+                continue
+            # Tiles of factors are placed with the tiles of the first row
+            # and of the first column of the grid of tiles of parameter
+            grid = t.grid.shape
+            traits = TensorTraits([t.shape[0]], [t.basetile_shape[0]])
+            self.rows.append(tensor_type(traits, dist[:grid[0]], \
+                    self.next_tag))
+            self.next_tag = self.rows[-1].next_tag
+            stride = int(np.prod(grid[:-1]))
+            traits = TensorTraits([t.shape[-1]], [t.basetile_shape[-1]])
+            self.cols.append(tensor_type(traits, \
+                    [dist[j*stride] for j in range(grid[-1])], \
+                    self.next_tag))
+            self.next_tag = self.cols[-1].next_tag
+            self.means.append(tensor_type(TensorTraits([], []), [dist[0]], \
+                    self.next_tag))
+            self.next_tag = self.means[-1].next_tag
+        self.lr = lr
+        self.start_lr = start_lr
+        self.full_lr_iter = full_lr_iter
+        self.beta2 = beta2
+        self.weight_decay = weight_decay
+        self.eps = eps
+
+    def get_next_tag(self):
+        return self.next_tag
+
+    def unregister(self):
+        for x in self.rows+self.cols+self.means:
+            if x is not None:
+                x.unregister()
+
+    # Learning rate of the current iteration with a linear warmup
+    def get_lr(self):
+        cur_lr = self.lr
+        if self.start_lr is not None and self.full_lr_iter is not None:
+            if self.num_iter < self.full_lr_iter and self.full_lr_iter > 1:
+                cur_lr = (self.lr-self.start_lr) / (self.full_lr_iter-1)
+                cur_lr = cur_lr*(self.num_iter-1) + self.start_lr
+        return cur_lr
+
+    def step(self):
+        cur_lr = self.get_lr()
+        # Moving averages are initialized by the first gradients
+        beta = 0. if self.num_iter == 1 else self.beta2
+        for i, p in enumerate(self.params):
+            t = p.value
+            row, col, mean = self.rows[i], self.cols[i], self.means[i]
+            if col is None:
+                nntile.tensor.sumprod_fiber_async(1-self.beta2, p.grad, \
+                        p.grad, beta, row, 0)
+            else:
+                # Means of squared gradients over fibers
+                m, n = t.shape[0], t.shape[-1]
+                nntile.tensor.sumprod_fiber_async((1-self.beta2)*m/t.nelems, \
+                        p.grad, p.grad, beta, row, 0)
+                nntile.tensor.sumprod_fiber_async((1-self.beta2)*n/t.nelems, \
+                        p.grad, p.grad, beta, col, t.ndim-1)
+                nntile.tensor.sum_slice_async(1./m, row, 0., mean, 0)
+            nntile.tensor.fused_adafactor_step(t, p.grad, row, col, mean, \
+                    cur_lr, self.eps, self.beta2, self.weight_decay, \
+                    self.num_iter)
+            t.wont_use()
+            # dP can be deleted
+            p.grad.invalidate_submit()
+            for x in (row, col, mean):
+                if x is not None:
+                    x.wont_use()
+        self.num_iter += 1
+
+    # Factors and, optionally, values of parameters by names
+    def _checkpoint_tensors(self, with_params):
+        return nntile.checkpoint.state_tensors( \
+                self.params if with_params else [], rows=self.rows, \
+                cols=self.cols, means=self.means)
+
+    def save_checkpoint_async(self, path, save_params=True):
+        """Submit writes of factors and values of parameters into a sharded
+        checkpoint, see nntile.checkpoint. Returns PendingCheckpoint."""
+        attrs = {name: getattr(self, name) for name in self._state_attrs}
+        return nntile.checkpoint.save_async(path, \
+                self._checkpoint_tensors(save_params), attrs)
+
+    def snapshot_checkpoint_async(self, path, next_tag, save_params=True):
+        """Same as save_checkpoint_async, but the next steps wait only for
+        copies into staging tensors. Returns PendingSnapshot and the next
+        tag."""
+        attrs = {name: getattr(self, name) for name in self._state_attrs}
+        return nntile.checkpoint.snapshot_async(path, \
+                self._checkpoint_tensors(save_params), next_tag, attrs)
+
+    def load_checkpoint(self, path, load_params=True):
+        attrs = nntile.checkpoint.load(path, \
+                self._checkpoint_tensors(load_params))
+        for name in self._state_attrs:
+            setattr(self, name, attrs[name])
+
@@ -14,11 +14,15 @@
 
 import nntile
 import numpy as np
-from nntile.tensor import TensorTraits
+from nntile.tensor import TensorTraits, Tensor_int64
 import pickle
 import torch
 
 class Adam:
+    # Scalar attributes of a checkpoint
+    _state_attrs = ["num_iter", "beta1", "beta2", "lr", "eps", \
+            "weight_decay"]
+
     def __init__(self, params, lr, next_tag, beta1=0.9, beta2=0.999, \
             amsgrad=False, weight_decay=0., eps=1e-8, dtype=np.float32):
         self.params = params
@@ -151,13 +155,49 @@ class Adam:
         for i in range(len(max_second_moments)):
             self.max_second_moments[i].from_array(max_second_moments[i])
 
+    # Moments and, optionally, values of parameters by names
+    def _checkpoint_tensors(self, with_params):
+        return nntile.checkpoint.state_tensors( \
+                self.params if with_params else [], \
+                first_moments=self.first_moments, \
+                second_moments=self.second_moments, \
+                max_second_moments=self.max_second_moments)
+
+    def save_checkpoint_async(self, path, save_params=True):
+        """Submit writes of moments and values of parameters into a sharded
+        checkpoint, see nntile.checkpoint. Returns PendingCheckpoint."""
+        attrs = {name: getattr(self, name) for name in self._state_attrs}
+        return nntile.checkpoint.save_async(path, \
+                self._checkpoint_tensors(save_params), attrs)
+
+    def snapshot_checkpoint_async(self, path, next_tag, save_params=True):
+        """Same as save_checkpoint_async, but the next steps wait only for
+        copies into staging tensors. Returns PendingSnapshot and the next
+        tag."""
+        attrs = {name: getattr(self, name) for name in self._state_attrs}
+        return nntile.checkpoint.snapshot_async(path, \
+                self._checkpoint_tensors(save_params), next_tag, attrs)
+
+    def load_checkpoint(self, path, load_params=True):
+        attrs = nntile.checkpoint.load(path, \
+                self._checkpoint_tensors(load_params))
+        for name in self._state_attrs:
+            setattr(self, name, attrs[name])
 
 
 class FusedAdam:
+    # Scalar attributes of a checkpoint
+    _state_attrs = ["num_iter", "beta1", "beta2", "lr", "start_lr", \
+            "full_lr_iter", "eps", "weight_decay"]
+
     def __init__(self, params, lr, next_tag, beta1=0.9, beta2=0.999, \
             weight_decay=0., eps=1e-8, dtype=np.float32, start_lr=None, \
-            full_lr_iter=None):
+            full_lr_iter=None, multi_tensor=True, max_nelems=1048576, \
+            max_grad_norm=None):
         self.params = params
+        # Update tiles of all parameters by a small number of tasks
+        self.multi_tensor = multi_tensor
+        self.max_nelems = max_nelems
         self.next_tag = next_tag
         self.num_iter = 1
         self.dtype=dtype
@@ -178,6 +218,20 @@ class FusedAdam:
         self.beta2 = beta2
         self.weight_decay = weight_decay
         self.eps = eps
+        # Gradients are clipped by their global norm on the device: the norm,
+        # learning rate and scale of gradients are stored in tensors, that
+        # are read by tasks of the step without synchronization with the host
+        self.max_grad_norm = max_grad_norm
+        self.grad_norm = None
+        self.scalars = None
+        if max_grad_norm is not None:
+            tensor_type = type(self.params[0].value)
+            self.grad_norm = tensor_type(TensorTraits([], []), [0], \
+                    self.next_tag)
+            self.next_tag = self.grad_norm.next_tag
+            self.scalars = tensor_type(TensorTraits([2], [2]), [0], \
+                    self.next_tag)
+            self.next_tag = self.scalars.next_tag
 
     def get_next_tag(self):
         return self.next_tag
@@ -186,18 +240,47 @@ class FusedAdam:
         for i in range(len(self.first_moments)):
             self.first_moments[i].unregister()
             self.second_moments[i].unregister()
+        if self.grad_norm is not None:
+            self.grad_norm.unregister()
+            self.scalars.unregister()
 
-    def step(self):
+    # Submit computation of the global norm of gradients and of the scalars
+    # of the step. Returns tensor of scalars or None without clipping.
+    def _clip_async(self, cur_lr):
+        if self.max_grad_norm is None:
+            return None
+        nntile.tensor.global_nrm2_async([p.grad for p in self.params], \
+                self.grad_norm)
+        nntile.tensor.clip_scale_async(cur_lr, self.max_grad_norm, \
+                self.grad_norm, self.scalars)
+        return self.scalars
+
+    # Learning rate of the current iteration with a linear warmup
+    def get_lr(self):
         cur_lr = self.lr
         if self.start_lr is not None and self.full_lr_iter is not None:
             if self.num_iter < self.full_lr_iter and self.full_lr_iter > 1:
                 cur_lr = (self.lr-self.start_lr) / (self.full_lr_iter-1)
                 cur_lr = cur_lr*(self.num_iter-1) + self.start_lr
+        return cur_lr
+
+    def step(self):
+        cur_lr = self.get_lr()
+        scalars = self._clip_async(cur_lr)
+        if self.multi_tensor:
+            nntile.tensor.fused_multi_adam_step( \
+                    [p.value for p in self.params], \
+                    [p.grad for p in self.params], self.first_moments, \
+                    self.second_moments, cur_lr, self.eps, self.beta1, \
+                    self.beta2, self.weight_decay, self.num_iter, \
+                    decoupled=False, max_nelems=self.max_nelems, \
+                    scalars=scalars)
         for i, p in enumerate(self.params):
-            nntile.tensor.fused_adam_step(p.value, p.grad, \
-                    self.first_moments[i], self.second_moments[i], cur_lr, \
-                    self.eps, self.beta1, self.beta2, self.weight_decay, \
-                    self.num_iter)
+            if not self.multi_tensor:
+                nntile.tensor.fused_adam_step(p.value, p.grad, \
+                        self.first_moments[i], self.second_moments[i], \
+                        cur_lr, self.eps, self.beta1, self.beta2, \
+                        self.weight_decay, self.num_iter, scalars=scalars)
             p.value.wont_use()
             # dP can be deleted
             #p.grad.wont_use()
@@ -258,3 +341,97 @@ class FusedAdam:
             self.first_moments[i].from_array(first_moments[i].to(torch.float32))
             self.second_moments[i].from_array(second_moments[i].to(torch.float32))
 
+    # Moments and, optionally, values of parameters by names
+    def _checkpoint_tensors(self, with_params):
+        return nntile.checkpoint.state_tensors( \
+                self.params if with_params else [], \
+                first_moments=self.first_moments, \
+                second_moments=self.second_moments)
+
+    def save_checkpoint_async(self, path, save_params=True):
+        """Submit writes of moments and values of parameters into a sharded
+        checkpoint, see nntile.checkpoint. Returns PendingCheckpoint."""
+        attrs = {name: getattr(self, name) for name in self._state_attrs}
+        return nntile.checkpoint.save_async(path, \
+                self._checkpoint_tensors(save_params), attrs)
+
+    def snapshot_checkpoint_async(self, path, next_tag, save_params=True):
+        """Same as save_checkpoint_async, but the next steps wait only for
+        copies into staging tensors. Returns PendingSnapshot and the next
+        tag."""
+        attrs = {name: getattr(self, name) for name in self._state_attrs}
+        return nntile.checkpoint.snapshot_async(path, \
+                self._checkpoint_tensors(save_params), next_tag, attrs)
+
+    def load_checkpoint(self, path, load_params=True):
+        attrs = nntile.checkpoint.load(path, \
+                self._checkpoint_tensors(load_params))
+        for name in self._state_attrs:
+            setattr(self, name, attrs[name])
+
+class LazyAdam(FusedAdam):
+    """Fused Adam, that updates only used rows of embedding vocabularies
+
+    Parameters with a mask of used rows (see layer.Embedding with
+    sparse_grad=True) are updated only in the marked columns of the
+    vocabulary, that correspond to tokens of the minibatch. Bias correction
+    of each such column depends on the number of steps, that were done for
+    the column, instead of a global iteration number. Therefore, rows of
+    unused tokens and their moments are not read or written at all. All
+    other parameters are updated as in FusedAdam.
+    """
+    def __init__(self, params, lr, next_tag, **kwargs):
+        if kwargs.get("max_grad_norm") is not None:
+            raise ValueError("Clipping of gradients is not supported by " \
+                    "sparse updates")
+        super().__init__(params, lr, next_tag, **kwargs)
+        # Numbers of steps of each column of each tile of sparse parameters
+        self.cols_iter = []
+        for p in self.params:
+            if getattr(p, "rows", None) is None:
+                self.cols_iter.append(None)
+                continue
+            shape = [p.value.grid.shape[0], p.value.shape[1]]
+            traits = TensorTraits(shape, [1, shape[1]])
+            cols_iter = Tensor_int64(traits, p.value.distribution, \
+                    self.next_tag)
+            self.next_tag = cols_iter.next_tag
+            cols_iter.from_array(np.zeros(shape, dtype=np.int64, order="F"))
+            self.cols_iter.append(cols_iter)
+
+    def unregister(self):
+        super().unregister()
+        for cols_iter in self.cols_iter:
+            if cols_iter is not None:
+                cols_iter.unregister()
+
+    def step(self):
+        cur_lr = self.get_lr()
+        dense = [i for i, t in enumerate(self.cols_iter) if t is None]
+        if self.multi_tensor and len(dense) > 0:
+            nntile.tensor.fused_multi_adam_step( \
+                    [self.params[i].value for i in dense], \
+                    [self.params[i].grad for i in dense], \
+                    [self.first_moments[i] for i in dense], \
+                    [self.second_moments[i] for i in dense], cur_lr, \
+                    self.eps, self.beta1, self.beta2, self.weight_decay, \
+                    self.num_iter, decoupled=False, \
+                    max_nelems=self.max_nelems)
+        for i, p in enumerate(self.params):
+            if self.cols_iter[i] is not None:
+                nntile.tensor.sparse_adam_step(p.value, p.grad, \
+                        self.first_moments[i], self.second_moments[i], \
+                        p.rows, self.cols_iter[i], cur_lr, self.eps, \
+                        self.beta1, self.beta2, self.weight_decay)
+                p.rows.wont_use()
+                self.cols_iter[i].wont_use()
+            elif not self.multi_tensor:
+                nntile.tensor.fused_adam_step(p.value, p.grad, \
+                        self.first_moments[i], self.second_moments[i], \
+                        cur_lr, self.eps, self.beta1, self.beta2, \
+                        self.weight_decay, self.num_iter)
+            p.value.wont_use()
+            p.grad.invalidate_submit()
+            self.first_moments[i].wont_use()
+            self.second_moments[i].wont_use()
+        self.num_iter += 1
@@ -19,10 +19,17 @@ import pickle
 import torch
 
 class FusedAdamW:
+    # Scalar attributes of a checkpoint
+    _state_attrs = ["num_iter", "beta1", "beta2", "lr", "start_lr", \
+            "full_lr_iter", "eps", "weight_decay"]
+
     def __init__(self, params, lr, next_tag, beta1=0.9, beta2=0.999, \
             weight_decay=0., eps=1e-8, dtype=np.float32, start_lr=None, \
-            full_lr_iter=None):
+            full_lr_iter=None, multi_tensor=True, max_nelems=1048576):
         self.params = params
+        # Update tiles of all parameters by a small number of tasks
+        self.multi_tensor = multi_tensor
+        self.max_nelems = max_nelems
         self.next_tag = next_tag
         self.num_iter = 1
         self.dtype=dtype
@@ -58,11 +65,19 @@ class FusedAdamW:
             if self.num_iter < self.full_lr_iter and self.full_lr_iter > 1:
                 cur_lr = (self.lr-self.start_lr) / (self.full_lr_iter-1)
                 cur_lr = cur_lr*(self.num_iter-1) + self.start_lr
+        if self.multi_tensor:
+            nntile.tensor.fused_multi_adam_step( \
+                    [p.value for p in self.params], \
+                    [p.grad for p in self.params], self.first_moments, \
+                    self.second_moments, cur_lr, self.eps, self.beta1, \
+                    self.beta2, self.weight_decay, self.num_iter, \
+                    decoupled=True, max_nelems=self.max_nelems)
         for i, p in enumerate(self.params):
-            nntile.tensor.fused_adamw_step(p.value, p.grad, \
-                    self.first_moments[i], self.second_moments[i], cur_lr, \
-                    self.eps, self.beta1, self.beta2, self.weight_decay, \
-                    self.num_iter)
+            if not self.multi_tensor:
+                nntile.tensor.fused_adamw_step(p.value, p.grad, \
+                        self.first_moments[i], self.second_moments[i], \
+                        cur_lr, self.eps, self.beta1, self.beta2, \
+                        self.weight_decay, self.num_iter)
             p.value.wont_use()
             # dP can be deleted
             #p.grad.wont_use()
@@ -128,3 +143,30 @@ class FusedAdamW:
             del s
         del stored_states, first_moments, second_moments
 
+    # Moments and, optionally, values of parameters by names
+    def _checkpoint_tensors(self, with_params):
+        return nntile.checkpoint.state_tensors( \
+                self.params if with_params else [], \
+                first_moments=self.first_moments, \
+                second_moments=self.second_moments)
+
+    def save_checkpoint_async(self, path, save_params=True):
+        """Submit writes of moments and values of parameters into a sharded
+        checkpoint, see nntile.checkpoint. Returns PendingCheckpoint."""
+        attrs = {name: getattr(self, name) for name in self._state_attrs}
+        return nntile.checkpoint.save_async(path, \
+                self._checkpoint_tensors(save_params), attrs)
+
+    def snapshot_checkpoint_async(self, path, next_tag, save_params=True):
+        """Same as save_checkpoint_async, but the next steps wait only for
+        copies into staging tensors. Returns PendingSnapshot and the next
+        tag."""
+        attrs = {name: getattr(self, name) for name in self._state_attrs}
+        return nntile.checkpoint.snapshot_async(path, \
+                self._checkpoint_tensors(save_params), next_tag, attrs)
+
+    def load_checkpoint(self, path, load_params=True):
+        attrs = nntile.checkpoint.load(path, \
+                self._checkpoint_tensors(load_params))
+        for name in self._state_attrs:
+            setattr(self, name, attrs[name])
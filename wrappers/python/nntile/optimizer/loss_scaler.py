@@ -0,0 +1,70 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/optimizer/loss_scaler.py
+# Loss scaling for training in half precision
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-01
+
+class StaticLossScaler:
+    """Constant scale of the loss"""
+    def __init__(self, scale=1.0):
+        self.scale = float(scale)
+
+    def update(self, found_inf: bool):
+        pass
+
+    def state_dict(self):
+        return {"scale": self.scale}
+
+    def load_state_dict(self, state):
+        self.scale = state["scale"]
+
+
+class DynamicLossScaler(StaticLossScaler):
+    """Scale of the loss, that adapts to overflows of gradients
+
+    The scale is multiplied by backoff_factor each time gradients overflow
+    and by growth_factor after growth_interval steps in a row without
+    overflows.
+    """
+    def __init__(self, init_scale=2.**16, growth_factor=2., \
+            backoff_factor=0.5, growth_interval=2000, min_scale=1.):
+        if growth_factor <= 1.:
+            raise ValueError("growth_factor must be greater than 1")
+        if backoff_factor <= 0. or backoff_factor >= 1.:
+            raise ValueError("backoff_factor must be within (0, 1)")
+        if growth_interval <= 0:
+            raise ValueError("growth_interval must be positive integer")
+        super().__init__(init_scale)
+        self.growth_factor = growth_factor
+        self.backoff_factor = backoff_factor
+        self.growth_interval = growth_interval
+        self.min_scale = min_scale
+        self.num_good_steps = 0
+        self.num_skipped_steps = 0
+
+    def update(self, found_inf: bool):
+        if found_inf:
+            self.scale = max(self.scale*self.backoff_factor, self.min_scale)
+            self.num_good_steps = 0
+            self.num_skipped_steps += 1
+        else:
+            self.num_good_steps += 1
+            if self.num_good_steps == self.growth_interval:
+                self.scale *= self.growth_factor
+                self.num_good_steps = 0
+
+    def state_dict(self):
+        return {"scale": self.scale, "num_good_steps": self.num_good_steps, \
+                "num_skipped_steps": self.num_skipped_steps}
+
+    def load_state_dict(self, state):
+        self.scale = state["scale"]
+        self.num_good_steps = state["num_good_steps"]
+        self.num_skipped_steps = state["num_skipped_steps"]
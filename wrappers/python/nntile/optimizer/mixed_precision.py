@@ -0,0 +1,144 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/optimizer/mixed_precision.py
+# Mixed precision training with single precision master weights
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-01
+
+import nntile
+import numpy as np
+from nntile.tensor import TensorTraits, TensorMoments, Tensor_fp32
+from .loss_scaler import StaticLossScaler
+
+class MixedPrecision:
+    """Optimizer, that updates single precision copies of parameters
+
+    Parameters of a model are stored in half precision (fp16 or bf16), that
+    is used by forward and backward passes. The optimizer of type opt_type is
+    applied to single precision master weights. At every step gradients are
+    converted into single precision, divided by the loss scale and checked
+    for overflow. Steps with overflowed gradients are skipped. Updated master
+    weights are converted back into parameters of the model. Parameters,
+    that are already in single precision, serve as their own master weights.
+
+    With offload=True all tasks of the optimizer run on CPU workers (see
+    nntile.starpu.offload_enter), so master weights, their gradients and
+    states of the optimizer (e.g., moments of FusedAdam) stay in host RAM,
+    while GPUs hold only half precision parameters and gradients, that are
+    streamed layer by layer (see BaseModel.prefetch). This allows training
+    of models, that do not fit into GPU memory. Half precision gradients are
+    converted on CPU, so only half of the bytes of gradients go through PCIe.
+    """
+    def __init__(self, params, next_tag, opt_type, loss_scaler=None, \
+            check_overflow=True, offload=False, **opt_kwargs):
+        self.params = params
+        self.next_tag = next_tag
+        self.offload = offload
+        self._offload_enter()
+        if loss_scaler is None:
+            loss_scaler = StaticLossScaler()
+        self.loss_scaler = loss_scaler
+        self.check_overflow = check_overflow
+        self.master_params = []
+        self.tmp = []
+        for p in self.params:
+            if type(p.value) is Tensor_fp32:
+                self.master_params.append(p)
+            else:
+                p_traits = TensorTraits(p.value.shape, p.value.basetile_shape)
+                value = Tensor_fp32(p_traits, p.value.distribution, \
+                        self.next_tag)
+                self.next_tag = value.next_tag
+                grad = Tensor_fp32(p_traits, p.value.distribution, \
+                        self.next_tag)
+                self.next_tag = grad.next_tag
+                nntile.tensor.convert_async(p.value, value)
+                self.master_params.append(TensorMoments(value, grad, True))
+            if self.check_overflow:
+                ndim = len(p.value.shape)
+                tmp_traits = TensorTraits(p.value.grid.shape, [1]*ndim)
+                self.tmp.append(Tensor_fp32(tmp_traits, \
+                        p.value.distribution, self.next_tag))
+                self.next_tag = self.tmp[-1].next_tag
+        if self.check_overflow:
+            norm_traits = TensorTraits([], [])
+            self.norm = Tensor_fp32(norm_traits, [0], self.next_tag)
+            self.next_tag = self.norm.next_tag
+        self.opt = opt_type(self.master_params, next_tag=self.next_tag, \
+                **opt_kwargs)
+        self.next_tag = self.opt.get_next_tag()
+        self.num_skipped_steps = 0
+        self._offload_exit()
+
+    # Submit tasks to CPU workers in the offload mode
+    def _offload_enter(self):
+        if self.offload:
+            nntile.starpu.offload_enter()
+
+    def _offload_exit(self):
+        if self.offload:
+            nntile.starpu.offload_exit()
+
+    def get_next_tag(self):
+        return self.next_tag
+
+    def get_loss_scale(self):
+        return self.loss_scaler.scale
+
+    def unregister(self):
+        self.opt.unregister()
+        for p, m in zip(self.params, self.master_params):
+            if m is not p:
+                m.unregister()
+        for t in self.tmp:
+            t.unregister()
+        if self.check_overflow:
+            self.norm.unregister()
+
+    # Get gradients of master weights and check if they are finite
+    def unscale_grads(self) -> bool:
+        inv_scale = 1.0 / self.loss_scaler.scale
+        for i, (p, m) in enumerate(zip(self.params, self.master_params)):
+            if m is not p:
+                nntile.tensor.convert_async(p.grad, m.grad)
+                p.grad.invalidate_submit()
+            if inv_scale != 1.0:
+                nntile.tensor.scal_inplace_async(inv_scale, m.grad)
+            if self.check_overflow:
+                beta = 0.0 if i == 0 else 1.0
+                nntile.tensor.nrm2_async(1.0, m.grad, beta, self.norm, \
+                        self.tmp[i])
+                self.tmp[i].invalidate_submit()
+        if not self.check_overflow or len(self.params) == 0:
+            return True
+        # Limit parallelism through value of norm of gradients
+        norm_np = np.zeros((1,), dtype=np.float32, order="F")
+        self.norm.to_array(norm_np)
+        return bool(np.isfinite(norm_np[0]))
+
+    def step(self):
+        self._offload_enter()
+        try:
+            self._step()
+        finally:
+            self._offload_exit()
+
+    def _step(self):
+        finite = self.unscale_grads()
+        self.loss_scaler.update(not finite)
+        if not finite:
+            self.num_skipped_steps += 1
+            for m in self.master_params:
+                m.grad.invalidate_submit()
+            return
+        self.opt.step()
+        for p, m in zip(self.params, self.master_params):
+            if m is not p:
+                nntile.tensor.convert_async(m.value, p.value)
+                m.value.wont_use()
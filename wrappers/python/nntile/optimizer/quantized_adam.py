@@ -0,0 +1,147 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/optimizer/quantized_adam.py
+# Adam and AdamW with 8-bit moments
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+import nntile
+import numpy as np
+from nntile.tensor import TensorTraits, Tensor_fp32, Tensor_int8, \
+        Tensor_fp8_e4m3
+
+class QuantizedAdam:
+    """Fused Adam with moments, that are stored in 8 bits
+
+    First moments are stored as int8 values and second moments as FP8 E4M3
+    values. Every block of block elements of every tile has its own scales,
+    that map the largest absolute value of the block into 127 or 448
+    respectively. The fused step dequantizes moments of a block, updates
+    them and parameters in single precision and quantizes moments back, so
+    the state takes a quarter of a state of FusedAdam. Only single precision
+    parameters are supported.
+    """
+    # Scalar attributes of a checkpoint
+    _state_attrs = ["num_iter", "beta1", "beta2", "lr", "start_lr", \
+            "full_lr_iter", "eps", "weight_decay", "block"]
+
+    def __init__(self, params, lr, next_tag, beta1=0.9, beta2=0.999, \
+            weight_decay=0., eps=1e-8, start_lr=None, full_lr_iter=None, \
+            decoupled=False, block=256):
+        self.params = params
+        self.next_tag = next_tag
+        self.num_iter = 1
+        self.decoupled = decoupled
+        self.block = block
+        self.first_moments = []
+        self.first_scales = []
+        self.second_moments = []
+        self.second_scales = []
+        for p in self.params:
+            t = p.value
+            if type(t) is not Tensor_fp32:
+                raise TypeError("Only fp32 parameters are supported")
+            traits = TensorTraits(t.shape, t.basetile_shape)
+            self.first_moments.append(Tensor_int8(traits, t.distribution, \
+                    self.next_tag))
+            self.next_tag = self.first_moments[-1].next_tag
+            self.second_moments.append(Tensor_fp8_e4m3(traits, \
+                    t.distribution, self.next_tag))
+            self.next_tag = self.second_moments[-1].next_tag
+            # Scales of blocks of each tile are kept with the tile
+            nblocks = (int(np.prod(t.basetile_shape))+block-1) // block
+            grid = list(t.grid.shape)
+            traits = TensorTraits([nblocks]+grid, [nblocks]+[1]*len(grid))
+            self.first_scales.append(Tensor_fp32(traits, t.distribution, \
+                    self.next_tag))
+            self.next_tag = self.first_scales[-1].next_tag
+            self.second_scales.append(Tensor_fp32(traits, t.distribution, \
+                    self.next_tag))
+            self.next_tag = self.second_scales[-1].next_tag
+        self.lr = lr
+        self.start_lr = start_lr
+        self.full_lr_iter = full_lr_iter
+        self.beta1 = beta1
+        self.beta2 = beta2
+        self.weight_decay = weight_decay
+        self.eps = eps
+
+    def get_next_tag(self):
+        return self.next_tag
+
+    def unregister(self):
+        for x in self.first_moments+self.first_scales+self.second_moments \
+                +self.second_scales:
+            x.unregister()
+
+    # Learning rate of the current iteration with a linear warmup
+    def get_lr(self):
+        cur_lr = self.lr
+        if self.start_lr is not None and self.full_lr_iter is not None:
+            if self.num_iter < self.full_lr_iter and self.full_lr_iter > 1:
+                cur_lr = (self.lr-self.start_lr) / (self.full_lr_iter-1)
+                cur_lr = cur_lr*(self.num_iter-1) + self.start_lr
+        return cur_lr
+
+    def step(self):
+        cur_lr = self.get_lr()
+        for i, p in enumerate(self.params):
+            nntile.tensor.fused_quantized_adam_step(p.value, p.grad, \
+                    self.first_moments[i], self.first_scales[i], \
+                    self.second_moments[i], self.second_scales[i], cur_lr, \
+                    self.eps, self.beta1, self.beta2, self.weight_decay, \
+                    self.num_iter, self.block, decoupled=self.decoupled)
+            p.value.wont_use()
+            # dP can be deleted
+            p.grad.invalidate_submit()
+            self.first_moments[i].wont_use()
+            self.first_scales[i].wont_use()
+            self.second_moments[i].wont_use()
+            self.second_scales[i].wont_use()
+        self.num_iter += 1
+
+    # Quantized moments with their scales and, optionally, values of
+    # parameters by names
+    def _checkpoint_tensors(self, with_params):
+        return nntile.checkpoint.state_tensors( \
+                self.params if with_params else [], \
+                first_moments=self.first_moments, \
+                first_scales=self.first_scales, \
+                second_moments=self.second_moments, \
+                second_scales=self.second_scales)
+
+    def save_checkpoint_async(self, path, save_params=True):
+        """Submit writes of moments and values of parameters into a sharded
+        checkpoint, see nntile.checkpoint. Returns PendingCheckpoint."""
+        attrs = {name: getattr(self, name) for name in self._state_attrs}
+        return nntile.checkpoint.save_async(path, \
+                self._checkpoint_tensors(save_params), attrs)
+
+    def snapshot_checkpoint_async(self, path, next_tag, save_params=True):
+        """Same as save_checkpoint_async, but the next steps wait only for
+        copies into staging tensors. Returns PendingSnapshot and the next
+        tag."""
+        attrs = {name: getattr(self, name) for name in self._state_attrs}
+        return nntile.checkpoint.snapshot_async(path, \
+                self._checkpoint_tensors(save_params), next_tag, attrs)
+
+    def load_checkpoint(self, path, load_params=True):
+        attrs = nntile.checkpoint.load(path, \
+                self._checkpoint_tensors(load_params))
+        for name in self._state_attrs:
+            if name == "block" and attrs[name] != self.block:
+                raise ValueError("Checkpoint has scales of other blocks")
+            setattr(self, name, attrs[name])
+
+class QuantizedAdamW(QuantizedAdam):
+    """QuantizedAdam with decoupled weight decay as in FusedAdamW"""
+    def __init__(self, params, lr, next_tag, **kwargs):
+        kwargs["decoupled"] = True
+        super().__init__(params, lr, next_tag, **kwargs)
+
@@ -51,19 +51,11 @@ class SGD:
                 s.unregister()
             
     def step(self):
+        # Velocity and parameters are updated by a single fused task per
+        # tile, and gradients are not changed
         for i, p in enumerate(self.params):
-            if self.weight_decay != 0.:
-                nntile.tensor.axpy_async(self.weight_decay, p.value, p.grad)
-
-            if self.momentum > 0:
-                if self.num_iter == 0:
-                    nntile.tensor.copy_async(p.grad, self.states[i])
-                else:
-                    nntile.tensor.scal_inplace_async(self.momentum, self.states[i])
-                    nntile.tensor.axpy_async(1 - self.damping, p.grad, self.states[i])
-                if self.nesterov:
-                    nntile.tensor.axpy_async(self.momentum, self.states[i], p.grad)
-                else:
-                    nntile.tensor.copy_async(self.states[i], p.grad)
-            nntile.tensor.axpy_async(-self.lr, p.grad, p.value)
+            velocity = self.states[i] if self.momentum > 0 else None
+            nntile.tensor.fused_sgd_step(p.value, p.grad, velocity, self.lr,
+                    self.momentum, self.damping, self.weight_decay,
+                    self.nesterov, self.num_iter+1)
         self.num_iter += 1
@@ -0,0 +1,93 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/optimizer/sharded.py
+# Optimizer with state sharded across MPI ranks
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-09
+
+import nntile
+import numpy as np
+from nntile.tensor import TensorTraits, TensorMoments, Tensor_fp32
+
+class Sharded:
+    """Optimizer, whose state is sharded across MPI ranks
+
+    Moments of optimizer of type opt_type follow distribution of tensors it
+    updates. This wrapper creates shards: copies of parameters with the same
+    tiling, whose tiles are spread evenly over the given MPI ranks, and
+    applies the optimizer to shards. Thus moments of every tile are stored
+    only on a single rank, and each rank keeps nearly the same amount of the
+    optimizer state, regardless of placement of parameters. At every step
+    gradients are sent to owners of shards, shards are updated and then
+    updated values are sent back to owners of parameters.
+
+    If master_weights is True, shards of half precision parameters are
+    stored in single precision, serving as sharded master weights. Loss
+    scaling is not applied, so it is suited for bf16 parameters.
+    """
+    def __init__(self, params, next_tag, opt_type, ranks=None, \
+            master_weights=False, **opt_kwargs):
+        self.params = params
+        self.next_tag = next_tag
+        if ranks is None:
+            ranks = list(range(nntile.starpu.mpi_world_size()))
+        if len(ranks) == 0:
+            raise ValueError("List of ranks shall not be empty")
+        self.ranks = ranks
+        self.master_weights = master_weights
+        # Number of elements of shards on each rank
+        self.rank_nelems = [0] * len(ranks)
+        self.shards = []
+        for p in self.params:
+            if master_weights:
+                shard_type = Tensor_fp32
+            else:
+                shard_type = type(p.value)
+            shard_traits = TensorTraits(p.value.shape, \
+                    p.value.basetile_shape)
+            shard_distr = self._distribute(p.value)
+            value = shard_type(shard_traits, shard_distr, self.next_tag)
+            self.next_tag = value.next_tag
+            grad = shard_type(shard_traits, shard_distr, self.next_tag)
+            self.next_tag = grad.next_tag
+            nntile.tensor.convert_async(p.value, value)
+            self.shards.append(TensorMoments(value, grad, True))
+        self.opt = opt_type(self.shards, next_tag=self.next_tag, \
+                **opt_kwargs)
+        self.next_tag = self.opt.get_next_tag()
+
+    # Greedily put every tile onto the least loaded rank
+    def _distribute(self, t):
+        distr = []
+        for i in range(t.grid.nelems):
+            tile_shape = t.get_tile_shape(t.grid.linear_to_index(i))
+            j = int(np.argmin(self.rank_nelems))
+            self.rank_nelems[j] += int(np.prod(tile_shape))
+            distr.append(self.ranks[j])
+        return distr
+
+    def get_next_tag(self):
+        return self.next_tag
+
+    def unregister(self):
+        self.opt.unregister()
+        for s in self.shards:
+            s.unregister()
+
+    def step(self):
+        # Scatter gradients to owners of shards
+        for p, s in zip(self.params, self.shards):
+            nntile.tensor.convert_async(p.grad, s.grad)
+            p.grad.invalidate_submit()
+        self.opt.step()
+        # Gather updated values to owners of parameters
+        for p, s in zip(self.params, self.shards):
+            nntile.tensor.convert_async(s.value, p.value)
+            s.value.wont_use()
+            p.value.wont_use()
@@ -0,0 +1,99 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/packing.py
+# Packing of variable-length sequences into rows without padding
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+"""Packed variable-length sequences
+
+Tokenized documents are concatenated into rows of a fixed number of tokens
+instead of padding every document up to the maximal length. Inputs and labels
+of a document are its tokens shifted by one, so no token is trained to
+predict the first token of the next document. A document, that does not fit
+into the rest of a row, is continued in the next row as a new segment.
+Boundaries of segments of a row are given by cumulative offsets cu_seqlens,
+that start with 0 and end with the number of tokens of a row.
+
+Attention of a packed row is confined to its segments by a block-diagonal
+causal mask. Its block-sparse layout (see nntile.layer.flash_attention)
+marks tiles of keys and queries of different segments as empty, so flash
+attention skips them, while tiles, that contain a boundary of segments,
+apply the mask. Positional ids restart at every segment.
+"""
+
+from nntile.layer.flash_attention import block_layout
+import numpy as np
+from typing import List, Tuple
+
+def pack_sequences(seqs: List[List[int]], seq_len: int, \
+        max_segment: int=0) -> Tuple[np.ndarray, np.ndarray, \
+        List[np.ndarray]]:
+    """Pack tokenized documents into rows of seq_len inputs and labels
+
+    Parameters:
+        seqs: tokenized documents, documents of less than 2 tokens are
+            skipped
+        seq_len: number of tokens of a row
+        max_segment: maximal length of a segment, e.g., the number of
+            positional embeddings, zero means seq_len
+
+    Returns inputs and labels of shape [n_rows, seq_len] and cumulative
+    offsets of segments of every row. The last incomplete row is dropped.
+    """
+    if seq_len <= 0:
+        raise ValueError("seq_len shall be positive")
+    if max_segment <= 0:
+        max_segment = seq_len
+    inputs = []
+    labels = []
+    offsets = []
+    row_inputs = []
+    row_labels = []
+    row_offsets = [0]
+    for seq in seqs:
+        seq = np.asarray(seq, dtype=np.int64)
+        start = 0
+        # Pairs of an input and a label of a document
+        while start < seq.size-1:
+            n = min(seq.size-1-start, seq_len-row_offsets[-1], max_segment)
+            row_inputs.append(seq[start:start+n])
+            row_labels.append(seq[start+1:start+n+1])
+            row_offsets.append(row_offsets[-1]+n)
+            start += n
+            if row_offsets[-1] == seq_len:
+                inputs.append(np.concatenate(row_inputs))
+                labels.append(np.concatenate(row_labels))
+                offsets.append(np.array(row_offsets, dtype=np.int64))
+                row_inputs = []
+                row_labels = []
+                row_offsets = [0]
+    inputs = np.array(inputs, dtype=np.int64).reshape(-1, seq_len)
+    labels = np.array(labels, dtype=np.int64).reshape(-1, seq_len)
+    return inputs, labels, offsets
+
+def segment_ids(cu_seqlens: np.ndarray) -> np.ndarray:
+    """Index of a segment of every token"""
+    return np.repeat(np.arange(len(cu_seqlens)-1), np.diff(cu_seqlens))
+
+def segment_positions(cu_seqlens: np.ndarray) -> np.ndarray:
+    """Positional ids, that restart at every segment"""
+    ids = segment_ids(cu_seqlens)
+    return np.arange(cu_seqlens[-1]) - np.asarray(cu_seqlens)[ids]
+
+def segment_mask(cu_seqlens: np.ndarray) -> np.ndarray:
+    """Block-diagonal causal mask of shape (n_keys, n_queries)"""
+    ids = segment_ids(cu_seqlens)
+    mask = np.triu(ids[:, np.newaxis] == ids[np.newaxis, :])
+    return np.array(mask, dtype=bool, order="F")
+
+def segment_layout(cu_seqlens: np.ndarray, seq_tile: int):
+    """Block-sparse layout of the block-diagonal causal mask"""
+    return block_layout(segment_mask(cu_seqlens), seq_tile)
+
@@ -13,9 +13,13 @@
 # @date 2023-09-20
 
 from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
-        copy_async, axpy_async, clear_async
+        copy_async, axpy_async, clear_async, scal_inplace_async, \
+        background_priority
 from nntile.layer.base_layer import BaseLayer
 from nntile.model.base_model import BaseModel
+from nntile.graph import TaskGraph
+from nntile.readback import ScalarReadback
+from nntile.nntile_core import starpu as core_starpu
 import numpy as np
 from typing import List, Any
 
@@ -29,14 +33,112 @@ class Pipeline(object):
     lr: float
 
     def __init__(self, x: List[List[Tensor]], y: List[List[Tensor]], \
-            model: BaseModel, opt, loss, n_epochs):
+            model: BaseModel, opt, loss, n_epochs, capture: bool=False, \
+            loss_lag: int=0, segments: List[List[np.ndarray]]=None):
         self.x = x
         self.y = y
-        self.model = model
+        # Offsets of packed sequences of every minibatch of every batch (see
+        # nntile.packing), that are set by set_packed_sequences of a model
+        self.segments = segments
+        # Several models, that share parameters (see
+        # BaseModel.share_parameters), with their own losses are sets of
+        # activations, that process consecutive minibatches in turn. Then
+        # forward of a minibatch does not wait for backward of the previous
+        # one to release activations, and both overlap.
+        if isinstance(model, list):
+            if not isinstance(loss, list) or len(loss) != len(model):
+                raise ValueError("Every set of activations shall have its " \
+                        "own loss")
+            self.models = model
+            self.losses = loss
+        else:
+            self.models = [model]
+            self.losses = [loss]
+        for m in self.models[1:]:
+            if len(m.parameters) != len(self.models[0].parameters) or \
+                    any(p is not q for p, q in zip(m.parameters, \
+                    self.models[0].parameters)):
+                raise ValueError("Sets of activations shall share parameters")
+        # Models of different shapes of inputs are buckets of sequence
+        # lengths (see GPT2Model.create_buckets), and a minibatch is
+        # routed to a bucket of its shape. Sets of activations of the same
+        # bucket are used in turn.
+        self.buckets = {}
+        for i_set, m in enumerate(self.models):
+            shape = tuple(m.activations[0].value.shape)
+            self.buckets.setdefault(shape, []).append(i_set)
+        # Optimizer updates parameters of the first model
+        self.model = self.models[0]
+        self.loss = self.losses[0]
         self.opt = opt
-        self.loss = loss
         self.n_epochs = n_epochs
         self.loss_hist = []
+        # Values of losses of at most loss_lag batches are read back
+        # asynchronously, so the next batches are submitted without waiting
+        # for them. Zero means a blocking readback after every batch.
+        self.readback = None
+        if loss_lag > 0:
+            self.readback = ScalarReadback(loss_lag*len(self.losses))
+        # Optimizer with master weights provides scale of the loss for
+        # training in half precision
+        self.get_loss_scale = getattr(opt, "get_loss_scale", None)
+        # Identical parts of iterations are captured once and replayed
+        # afterwards. The optimizer step is always submitted as is, as
+        # its scalar arguments change between steps.
+        self.capture = capture
+        self.graphs = {}
+        # Replay of a captured graph reuses seeds of dropout masks
+        if capture and any(getattr(l, "stochastic", False) \
+                for m in self.models for l in m.layers):
+            raise RuntimeError("Capture of task graphs is not supported " \
+                    "by layers with random masks, e.g., dropout")
+        # Tiles of attention, that are skipped, depend on a minibatch
+        if capture and segments is not None:
+            raise RuntimeError("Capture of task graphs is not supported " \
+                    "for packed sequences")
+
+    # Submit a stage of an iteration, replaying its graph if captured
+    def _submit(self, stage, func):
+        if not self.capture:
+            func()
+        elif stage in self.graphs:
+            self.graphs[stage].replay()
+        else:
+            graph = TaskGraph()
+            with graph.capture():
+                func()
+            self.graphs[stage] = graph
+
+    def _batch_begin(self):
+        # Zero out gradients of all weights and activations
+        self.model.clear_parameters_grads()
+        for loss in self.losses:
+            clear_async(loss.val)
+
+    def _minibatch_forward(self, model, loss):
+        # Clear gradients of inter-layer activations
+        model.clear_activations_grads()
+        # Perform forward pass
+        model.forward_async()
+        # Loss function shall be instatiated to read X from
+        # activations[-1].value of the model and write gradient into
+        # activations[-1].grad
+        if core_starpu.trace_is_enabled():
+            core_starpu.trace_scope_set("loss")
+        loss.calc_async()
+
+    def _batch_end(self):
+        # Invalidate gradients of parameters
+        for p in self.model.parameters:
+            p.value.wont_use()
+            #if p.grad_required:
+            #    p.grad.wont_use()
+        # Invalidate gradients of activations
+        for model in self.models:
+            for t in model.activations:
+                t.value.wont_use()
+                if t.grad_required:
+                    t.grad.wont_use()
 
     def train_async(self):
         batch_counter = 0
@@ -44,50 +146,99 @@ class Pipeline(object):
         for i_epoch in range(self.n_epochs):
             # print("Epoch ", i_epoch)
             num_batches = len(self.x)
-            for i_batch, (x_batch, y_batch) in enumerate(zip(self.x, self.y)):
-                # Zero out gradients of all weights and activations
-                self.model.clear_parameters_grads()
-                clear_async(self.loss.val)
+            # Loader of batches yields pairs of inputs and labels itself
+            if self.y is None:
+                batches = self.x
+            else:
+                batches = zip(self.x, self.y)
+            for i_batch, (x_batch, y_batch) in enumerate(batches):
+                loss_scale = 1.0
+                if self.get_loss_scale is not None:
+                    loss_scale = self.get_loss_scale()
+                # Gradients of parameters of such a loss are accumulated
+                # before the output gradient of the model can be scaled
+                if loss_scale != 1.0 and any(getattr(loss, \
+                        "grads_in_forward", False) for loss in self.losses):
+                    raise RuntimeError("Loss scaling is not supported by " \
+                            "losses, that compute gradients in forward")
+                self._submit("batch_begin", self._batch_begin)
+                # Number of minibatches of the batch routed to every bucket
+                bucket_uses = {}
                 # Accumulate gradients from subbatches
-                for x_minibatch, y_minibatch in zip(x_batch, y_batch):
-                    # Clear gradients of inter-layer activations
-                    self.model.clear_activations_grads()
+                for i_minibatch, (x_minibatch, y_minibatch) in \
+                        enumerate(zip(x_batch, y_batch)):
+                    # Minibatches use sets of activations of their bucket
+                    # in turn, counting only minibatches of the same bucket
+                    shape = tuple(x_minibatch.shape)
+                    sets = self.buckets.get(shape)
+                    if sets is None:
+                        raise ValueError("No model for a minibatch of " \
+                                "shape {}".format(x_minibatch.shape))
+                    i_use = bucket_uses.get(shape, 0)
+                    bucket_uses[shape] = i_use + 1
+                    i_set = sets[i_use % len(sets)]
+                    model = self.models[i_set]
+                    loss = self.losses[i_set]
+                    # Boundaries of packed sequences go into positional ids
+                    # and the mask of the model
+                    if self.segments is not None:
+                        model.set_packed_sequences( \
+                                self.segments[i_batch][i_minibatch])
                     # Copy input batch into activation[0] of the model
-                    copy_async(x_minibatch, self.model.activations[0].value)
-                    # Perform forward pass
-                    self.model.forward_async()
+                    copy_async(x_minibatch, model.activations[0].value)
                     # Copy true result into loss function
-                    copy_async(y_minibatch, self.loss.y)
-                    # Loss function shall be instatiated to read X from
-                    # activations[-1].value of the model and write gradient
-                    # into activations[-1].grad
-                    self.loss.calc_async()
+                    copy_async(y_minibatch, loss.y)
+                    # Clear gradients, forward pass and loss
+                    self._submit(("forward", i_set), \
+                            lambda: self._minibatch_forward(model, loss))
+                    # Scale gradient of the loss to keep small gradients
+                    # representable in half precision, the optimizer
+                    # unscales gradients of parameters
+                    if loss_scale != 1.0:
+                        scal_inplace_async(loss_scale, \
+                                model.activations[-1].grad)
                     # Print value asynchronously
                     #self.loss.val.print_scalar_async()
                     # Now do the backward pass
-                    self.model.backward_async()
+                    self._submit(("backward", i_set), model.backward_async)
                 # Apply optimizer after gradients for entire batch are
-                # accumulated
+                # accumulated. Updates are off the critical path of
+                # backward, so they give way to its remaining tasks.
+                priority = core_starpu.priority_get()
+                core_starpu.priority_set(background_priority())
+                if core_starpu.trace_is_enabled():
+                    core_starpu.trace_scope_set("optimizer step")
                 self.opt.step()
-                # Invalidate gradients of parameters
-                for p in self.model.parameters:
-                    p.value.wont_use()
-                    #if p.grad_required:
-                    #    p.grad.wont_use()
-                # Invalidate gradients of activations
-                for t in self.model.activations:
-                    t.value.wont_use()
-                    if t.grad_required:
-                        t.grad.wont_use()
-                # Limit parallelism through value of loss
-                loss_np = np.zeros((1,), dtype=np.float32, order="F")
-                self.loss.get_val(loss_np)
-                self.loss_hist.append(loss_np[0])
-                # print("Loss in {} epoch = {}".format(i_epoch, loss_np[0]))
-                print("Batch={}/{} Epoch={}/{} Loss={}".format( \
-                        i_batch+1, num_batches, i_epoch+1, self.n_epochs, \
-                        loss_np[0]), flush=True)
+                core_starpu.priority_set(priority)
+                self._submit("batch_end", self._batch_end)
+                if self.readback is not None:
+                    # Loss is delivered later, submission waits only if
+                    # losses of loss_lag batches are still pending
+                    self.readback.submit_async([loss.val for loss in \
+                            self.losses], self._log_loss_callback(i_batch, \
+                            num_batches, i_epoch))
+                    self.readback.poll()
+                else:
+                    # Limit parallelism through value of loss
+                    loss_np = np.zeros((1,), dtype=np.float32, order="F")
+                    loss_val = np.float32(0)
+                    for loss in self.losses:
+                        loss.get_val(loss_np)
+                        loss_val += loss_np[0]
+                    self._log_loss(loss_val, i_batch, num_batches, i_epoch)
             # nntile_xentropy_np = np.zeros((1,), dtype=np.float32, order="F")
             # self.loss.get_val(nntile_xentropy_np)
             # print("Last batch loss after in {} epoch = {}".format(i_epoch, nntile_xentropy_np[0]))
+        if self.readback is not None:
+            self.readback.wait()
+
+    def _log_loss(self, loss_val, i_batch, num_batches, i_epoch):
+        self.loss_hist.append(np.float32(loss_val))
+        print("Batch={}/{} Epoch={}/{} Loss={}".format(i_batch+1, \
+                num_batches, i_epoch+1, self.n_epochs, \
+                self.loss_hist[-1]), flush=True)
+
+    def _log_loss_callback(self, i_batch, num_batches, i_epoch):
+        return lambda loss_val: self._log_loss(loss_val, i_batch, \
+                num_batches, i_epoch)
 
@@ -0,0 +1,117 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/profiler.py
+# Per-layer timing and throughput of StarPU tasks
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+"""Per-layer timing and throughput of StarPU tasks
+
+LayerProfiler records tasks by tracing of StarPU (see
+nntile.starpu.trace_enable), while models tag tasks of every layer with a
+scope like "Linear 3 forward". Time of every task is split into compute
+time (execution on a worker), transfer time (fetching of input data by the
+worker) and wait time (the rest of the time since submission, i.e., waiting
+for dependencies and for a free worker). Achieved FLOP/s of a scope is its
+number of flops over its compute time and its efficiency is the ratio of
+the number of flops to the number of flops, that workers could execute at
+their peak performance during the same compute time.
+"""
+
+from .nntile_core import starpu as core_starpu
+from typing import Dict, List, Optional
+
+class LayerStats(object):
+    """Accumulated statistics of tasks of a single scope"""
+
+    def __init__(self, scope: str):
+        self.scope = scope
+        self.ntasks = 0
+        self.flops = 0.0
+        # Seconds spent by tasks in total over all workers
+        self.compute = 0.0
+        self.transfer = 0.0
+        self.wait = 0.0
+        # Flops, that workers could execute during the compute time
+        self.peak_flops = 0.0
+
+    @property
+    def gflops(self) -> float:
+        return self.flops / self.compute * 1e-9 if self.compute > 0 else 0.0
+
+    @property
+    def efficiency(self) -> float:
+        return self.flops / self.peak_flops if self.peak_flops > 0 else 0.0
+
+
+class LayerProfiler(object):
+    """Context manager, that attributes time of tasks to layers
+
+    Parameters:
+        peak_gflops: peak performance of a single worker in GFLOP/s by a
+            prefix of names of workers, e.g., {"CPU": 50, "CUDA": 60000}.
+            Efficiency of workers without peak performance is not reported.
+
+    Tasks, submitted within the context, are recorded. Statistics are ready
+    after all of them are finished, e.g., after nntile.starpu.wait_for_all().
+    Recorded events of tracing are dropped at the entry.
+    """
+
+    def __init__(self, peak_gflops: Optional[Dict[str, float]]=None):
+        self.peak_gflops = peak_gflops or {}
+
+    def __enter__(self):
+        core_starpu.trace_clear()
+        self.scope = core_starpu.trace_scope_get()
+        core_starpu.trace_enable()
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        core_starpu.trace_disable()
+        core_starpu.trace_scope_set(self.scope)
+        return False
+
+    def _peak(self, worker: str) -> float:
+        for prefix, gflops in self.peak_gflops.items():
+            if worker.startswith(prefix):
+                return gflops * 1e9
+        return 0.0
+
+    def get_stats(self) -> List[LayerStats]:
+        """Statistics of scopes in order of their first finished task"""
+        stats = {}
+        for e in core_starpu.trace_get_events():
+            scope = e["scope"] or "other"
+            if scope not in stats:
+                stats[scope] = LayerStats(scope)
+            s = stats[scope]
+            s.ntasks += 1
+            s.flops += e["flops"]
+            compute = (e["end_us"]-e["start_us"]) * 1e-6
+            transfer = e["fetch_us"] * 1e-6
+            s.compute += compute
+            s.transfer += transfer
+            s.wait += max((e["start_us"]-e["submit_us"])*1e-6-transfer, 0.0)
+            s.peak_flops += compute * self._peak(e["worker"])
+        return list(stats.values())
+
+    def report(self, sort_by: str="compute") -> str:
+        """Table of statistics of scopes, sorted by a given column"""
+        stats = sorted(self.get_stats(), key=lambda s: getattr(s, sort_by), \
+                reverse=True)
+        lines = ["{:<32} {:>7} {:>11} {:>11} {:>11} {:>10} {:>6}".format( \
+                "Scope", "Tasks", "Compute(s)", "Transfer(s)", "Wait(s)", \
+                "GFLOP/s", "Peak%")]
+        for s in stats:
+            peak = "{:6.1f}".format(100*s.efficiency) if s.peak_flops > 0 \
+                    else "{:>6}".format("-")
+            lines.append("{:<32} {:>7} {:>11.4f} {:>11.4f} {:>11.4f} " \
+                    "{:>10.2f} {}".format(s.scope[:32], s.ntasks, s.compute, \
+                    s.transfer, s.wait, s.gflops, peak))
+        return "\n".join(lines)
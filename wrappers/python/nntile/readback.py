@@ -0,0 +1,119 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/readback.py
+# Asynchronous readback of scalar tensors, e.g. values of losses
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+"""Asynchronous readback of scalar tensors
+
+Reading a scalar tensor by to_array waits for all the tasks, that update it,
+and for the transfer of its tile, on the critical path of a training loop.
+ScalarReadback submits a copy of a scalar tensor into a ring buffer in host
+memory by a low priority task instead and returns a ScalarFuture right
+away. Values are delivered in order of submission into callbacks by poll()
+or wait(), that are called by the training thread, so callbacks never run
+on threads of StarPU workers.
+"""
+
+from .nntile_core.tensor import Tensor_fp32, Tensor_fp64, Readback_fp32, \
+        Readback_fp64
+from collections import deque
+from typing import Callable, Optional
+
+_readbacks = {
+        Tensor_fp32: Readback_fp32,
+        Tensor_fp64: Readback_fp64,
+        }
+
+class ScalarFuture(object):
+    """Future value of a sum of scalar tensors"""
+
+    def __init__(self, readback, tickets, callback: Optional[Callable]):
+        self.readback = readback
+        self.tickets = tickets
+        self.callback = callback
+        self.value = None
+
+    def done(self):
+        """Check if the value is already delivered"""
+        return self.value is not None
+
+    def result(self):
+        """Wait for the value and deliver all the previous ones"""
+        while not self.done():
+            self.readback._complete(wait=True)
+        return self.value
+
+class ScalarReadback(object):
+    """Ring buffer in host memory for values of scalar tensors
+
+    At most capacity tensors are pending at any moment: a submission into a
+    full ring waits for the oldest value, so the ring also limits how many
+    steps of a training loop are in flight.
+    """
+
+    def __init__(self, capacity: int=64):
+        self.capacity = capacity
+        self.rings = {}
+        # Futures in order of submission and the number of their tickets
+        self.pending = deque()
+        self.npending = 0
+
+    def submit_async(self, x, callback: Optional[Callable]=None):
+        """Submit copies of a scalar tensor or of a list of them
+
+        Returns ScalarFuture of a sum of values of the tensors. The callback
+        gets the value, when it is delivered.
+        """
+        xs = x if isinstance(x, list) else [x]
+        if len(xs) > self.capacity:
+            raise ValueError("Number of tensors exceeds capacity")
+        # Slots of the oldest values are reused only after their delivery
+        while self.npending+len(xs) > self.capacity:
+            self._complete(wait=True)
+        tickets = []
+        for t in xs:
+            if type(t) not in _readbacks:
+                raise TypeError("Unsupported type of tensor")
+            if type(t) not in self.rings:
+                self.rings[type(t)] = _readbacks[type(t)](self.capacity)
+            ring = self.rings[type(t)]
+            tickets.append((ring, ring.submit(t)))
+        future = ScalarFuture(self, tickets, callback)
+        self.pending.append(future)
+        self.npending += len(tickets)
+        return future
+
+    # Deliver the oldest pending value, returns False if it is not ready
+    def _complete(self, wait: bool):
+        future = self.pending[0]
+        if not wait and not all(ring.is_ready(ticket) \
+                for ring, ticket in future.tickets):
+            return False
+        future.value = sum(ring.wait(ticket) \
+                for ring, ticket in future.tickets)
+        self.pending.popleft()
+        self.npending -= len(future.tickets)
+        if future.callback is not None:
+            future.callback(future.value)
+        return True
+
+    def poll(self):
+        """Deliver ready values without waiting, returns their number"""
+        n = 0
+        while self.pending and self._complete(wait=False):
+            n += 1
+        return n
+
+    def wait(self):
+        """Wait for all the pending values and deliver them"""
+        while self.pending:
+            self._complete(wait=True)
+
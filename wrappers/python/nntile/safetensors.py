@@ -0,0 +1,145 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/safetensors.py
+# Loading of tensors from memory-mapped safetensors files straight into tiles
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+"""Memory-mapped safetensors checkpoints
+
+A safetensors file is an 8-byte little-endian size of a JSON header, the
+header with dtype, shape and data_offsets of every tensor, and raw data of
+all the tensors in a C order. Files are mapped into memory read-only and
+every nntile tensor is filled from a strided numpy view of a tensor of the
+file, e.g. a transposed or a sliced one, by one task per tile. Therefore,
+tiles are filled in parallel and neither a PyTorch model nor a temporary
+copy of a whole tensor is created: host memory is used only for pages of
+the file, that the OS reads on demand.
+
+Sharded HuggingFace checkpoints with model.safetensors.index.json are also
+supported.
+"""
+
+import nntile
+import numpy as np
+import json
+import os
+import struct
+from typing import Callable
+
+# Types of safetensors, BF16 values are viewed as uint16
+_dtypes = {
+        "F64": np.float64,
+        "F32": np.float32,
+        "F16": np.float16,
+        "BF16": np.uint16,
+        "I64": np.int64,
+        "I32": np.int32,
+        "I8": np.int8,
+        "U8": np.uint8,
+        "BOOL": np.bool_,
+        }
+
+class SafetensorsFile(object):
+    """Single memory-mapped safetensors file"""
+
+    def __init__(self, filename: str):
+        with open(filename, "rb") as fp:
+            header_size = struct.unpack("<Q", fp.read(8))[0]
+            self.header = json.loads(fp.read(header_size))
+        self.metadata = self.header.pop("__metadata__", {})
+        self.data_offset = 8 + header_size
+        self.data = np.memmap(filename, dtype=np.uint8, mode="r")
+
+    def keys(self):
+        return self.header.keys()
+
+    def __contains__(self, name: str):
+        return name in self.header
+
+    def get(self, name: str):
+        """Numpy view of a tensor in a C order and a flag of BF16 type"""
+        info = self.header[name]
+        if info["dtype"] not in _dtypes:
+            raise TypeError("Unsupported type {} of tensor {}" \
+                    .format(info["dtype"], name))
+        begin, end = info["data_offsets"]
+        data = self.data[self.data_offset+begin:self.data_offset+end]
+        array = data.view(_dtypes[info["dtype"]]).reshape(info["shape"])
+        return array, info["dtype"] == "BF16"
+
+class SafetensorsCheckpoint(object):
+    """Safetensors file or a directory of a sharded HuggingFace checkpoint
+
+    Names of tensors are resolved with and without the given prefix, as
+    checkpoints of models with heads prefix names of the base model.
+    """
+
+    def __init__(self, path: str, prefix: str="transformer."):
+        self.prefix = prefix
+        self.files = {}
+        self.weight_map = {}
+        if os.path.isdir(path):
+            index = os.path.join(path, "model.safetensors.index.json")
+            if os.path.exists(index):
+                with open(index, "r") as fp:
+                    weight_map = json.load(fp)["weight_map"]
+                for name, filename in weight_map.items():
+                    self.weight_map[name] = os.path.join(path, filename)
+            else:
+                path = os.path.join(path, "model.safetensors")
+        if not self.weight_map:
+            for name in self._open(path).keys():
+                self.weight_map[name] = path
+        # Views, that are read by submitted tasks
+        self.pending = []
+
+    def _open(self, filename: str):
+        if filename not in self.files:
+            self.files[filename] = SafetensorsFile(filename)
+        return self.files[filename]
+
+    def _resolve(self, name: str):
+        if name in self.weight_map:
+            return name
+        if self.prefix+name in self.weight_map:
+            return self.prefix+name
+        raise KeyError("Tensor {} is not found".format(name))
+
+    def __contains__(self, name: str):
+        try:
+            self._resolve(name)
+            return True
+        except KeyError:
+            return False
+
+    def get(self, name: str):
+        """Numpy view of a tensor in a C order and a flag of BF16 type"""
+        name = self._resolve(name)
+        return self._open(self.weight_map[name]).get(name)
+
+    def load_async(self, x, name: str, \
+            transform: Callable=lambda a: a):
+        """Submit tasks, that fill tiles of x from a view of a tensor
+
+        Parameters:
+            x: floating point nntile tensor
+            name: name of a tensor of the checkpoint
+            transform: function of a numpy view, that returns a view of the
+                shape of x, e.g. a transposed one
+        """
+        array, bf16 = self.get(name)
+        array = transform(array)
+        x.load_strided_async(array, bf16)
+        self.pending.append(array)
+
+    def wait(self):
+        """Wait for all the submitted tasks and release views"""
+        nntile.starpu.wait_for_all()
+        self.pending = []
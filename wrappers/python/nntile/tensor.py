@@ -13,10 +13,18 @@
 # @date 2023-11-26
 
 from .nntile_core import tensor as core_tensor
+from .nntile_core import starpu as core_starpu
 from .nntile_core.tensor import TensorTraits, Tensor_fp32, Tensor_fp64, \
-        Tensor_int64, Tensor_fp16, Tensor_bool
-from .nntile_core import TransOp, notrans, trans
-from typing import Union, List
+        Tensor_int64, Tensor_fp16, Tensor_bf16, Tensor_bool, Tensor_int8, \
+        Tensor_fp8_e4m3, redux_tree, set_aggregate_nelems, \
+        get_aggregate_nelems, set_gemm_split_k, get_gemm_split_k, \
+        set_gemm_hetero, get_gemm_hetero, MaskTile, mask_tiles, TensorFuture, \
+        BatchNormActivation
+from .nntile_core import TransOp, notrans, trans, GemmCompute, \
+        gemm_default, gemm_fast_tf32, gemm_fast_fp16, gemm_fast_bf16
+from .fusion import Fusion, fuse
+from typing import Union, List, Optional
+import numpy as np
 
 # Multiprecision tensor as a union type for all precisions
 Tensor = Union[core_tensor.Tensor_fp32, core_tensor.Tensor_fp64]
@@ -25,6 +33,8 @@ TensorOrNone = Union[Tensor, None]
 # Union of multiprecision tensor and float
 TensorOrFloat = Union[Tensor, float]
 TensorFloatOrInt = Union[Tensor, core_tensor.Tensor_int64]
+# Quantized weights as a union type for all 8-bit types
+QuantizedTensor = Union[core_tensor.Tensor_int8, core_tensor.Tensor_fp8_e4m3]
 
 # Struct meant for tensor, its gradient and a flag if gradient is required
 class TensorMoments(object):
@@ -47,34 +57,253 @@ class TensorMoments(object):
         if self.grad is not None:
             self.grad.unregister()
 
-
-# Wrapper for multiprecision gemm
+    # Unregister without waiting for tasks on the tensors
+    def unregister_submit(self):
+        if self.value is not None:
+            self.value.unregister_submit()
+        if self.grad is not None:
+            self.grad.unregister_submit()
+
+
+# Tensor out of any object, that supports DLPack protocol (numpy, torch)
+def from_dlpack(x, next_tag: int, basetile_shape: List[int]=None):
+    """Create a tensor out of a CPU array, that supports DLPack protocol
+
+    Array is imported through numpy.from_dlpack without copying. If it is
+    contiguous in a Fortran order (e.g., a transposed torch tensor) and
+    basetile_shape is not provided, the resulting single-tile tensor uses
+    memory of the array directly. Otherwise, the array is copied tile by
+    tile into a new tensor.
+    """
+    array = np.from_dlpack(x)
+    dtypes = {np.dtype(np.float32): Tensor_fp32, \
+            np.dtype(np.float64): Tensor_fp64, \
+            np.dtype(np.int64): Tensor_int64, \
+            np.dtype(np.int8): Tensor_int8, \
+            np.dtype(np.bool_): Tensor_bool}
+    tensor_type = dtypes.get(array.dtype)
+    if tensor_type is None:
+        raise TypeError("Unsupported dtype {}".format(array.dtype))
+    shape = list(array.shape)
+    if basetile_shape is None:
+        basetile_shape = shape
+    traits = TensorTraits(shape, basetile_shape)
+    distr = [0] * traits.grid.nelems
+    if basetile_shape == shape and array.flags.f_contiguous \
+            and array.flags.writeable:
+        return tensor_type.from_buffers(traits, distr, next_tag, [array])
+    tensor = tensor_type(traits, distr, next_tag)
+    tensor.from_array(array)
+    return tensor
+
+# Numpy types, that tensors are exchanged through
+_array_dtypes = {Tensor_fp64: np.float64, Tensor_fp32: np.float32, \
+        Tensor_fp16: np.float32, Tensor_bf16: np.float32, \
+        Tensor_fp8_e4m3: np.float32, Tensor_int64: np.int64, \
+        Tensor_bool: np.bool_, Tensor_int8: np.int8}
+
+def to_array(x, start: List[int], shape: List[int]) -> np.ndarray:
+    """Copy a subarray of a tensor into a new Fortran-order array
+
+    Only tiles, that intersect the subarray, are read, e.g. logits of the
+    last position only.
+    """
+    array = np.zeros(shape, dtype=_array_dtypes[type(x)], order="F")
+    x.to_array(array, start)
+    return array
+
+def from_array(x, start: List[int], array: np.ndarray) -> None:
+    """Copy an array into a subarray of a tensor, that starts at start
+
+    Only tiles, that intersect the subarray, are updated.
+    """
+    x.from_array(array, start)
+
+# Priority of tasks off the critical path, e.g., gradients over parameters
+def background_priority() -> int:
+    return core_starpu.priority_background_get()
+
+# Wrapper for multiprecision gemm. Compute mode selects tensor cores on CUDA
+# devices for fp32 tensors (gemm_fast_tf32, gemm_fast_fp16 or
+# gemm_fast_bf16), while fp16 and bf16 tensors are always accumulated in fp32.
+# Tasks get the given priority instead of the current one, if it is set.
+# Tasks are restricted to the given kinds of workers (where_cpu, where_cuda or
+# their combination) instead of the current ones, if it is set.
 def gemm_async(alpha: float, trans_A: TransOp, A: Tensor, trans_B: TransOp, \
         B: Tensor, beta: float, C: Tensor, ndim: int, \
-        batch_ndim: int, redux: int=0) -> None:
-    if type(A) is not type(B) or type(A) is not type(C):
-        raise TypeError
-    if type(A) is core_tensor.Tensor_fp32:
+        batch_ndim: int, redux: int=0, \
+        compute: GemmCompute=gemm_default, \
+        priority: Optional[int]=None, where: Optional[int]=None) -> None:
+    # Products of half precision A and B may be accumulated directly in a
+    # single precision C, e.g., in gradients over weights
+    mixed = type(C) is core_tensor.Tensor_fp32 and type(A) in \
+            (core_tensor.Tensor_fp16, core_tensor.Tensor_bf16)
+    if type(A) is not type(B) or (type(A) is not type(C) and not mixed):
+        raise TypeError
+    if priority is not None:
+        current = core_starpu.priority_get()
+        core_starpu.priority_set(priority)
+        try:
+            gemm_async(alpha, trans_A, A, trans_B, B, beta, C, ndim, \
+                    batch_ndim, redux, compute)
+        finally:
+            core_starpu.priority_set(current)
+        return
+    if where is not None:
+        current = core_starpu.where_get()
+        core_starpu.where_set(where)
+        try:
+            gemm_async(alpha, trans_A, A, trans_B, B, beta, C, ndim, \
+                    batch_ndim, redux, compute)
+        finally:
+            core_starpu.where_set(current)
+        return
+    if mixed:
+        if type(A) is core_tensor.Tensor_fp16:
+            core_tensor.gemm_mixed_async_fp16(alpha, trans_A, A, trans_B, B,
+                    beta, C, ndim, batch_ndim, redux, compute)
+        else:
+            core_tensor.gemm_mixed_async_bf16(alpha, trans_A, A, trans_B, B,
+                    beta, C, ndim, batch_ndim, redux, compute)
+    elif type(A) is core_tensor.Tensor_fp32:
         core_tensor.gemm_async_fp32(alpha, trans_A, A, trans_B, B, beta, C,
-                ndim, batch_ndim, redux)
+                ndim, batch_ndim, redux, compute)
     elif type(A) is core_tensor.Tensor_fp64:
         core_tensor.gemm_async_fp64(alpha, trans_A, A, trans_B, B, beta, C,
-                ndim, batch_ndim, redux)
+                ndim, batch_ndim, redux, compute)
     elif type(A) is core_tensor.Tensor_fp16:
         core_tensor.gemm_async_fp16(alpha, trans_A, A, trans_B, B, beta, C,
-                ndim, batch_ndim, redux)
+                ndim, batch_ndim, redux, compute)
+    elif type(A) is core_tensor.Tensor_bf16:
+        core_tensor.gemm_async_bf16(alpha, trans_A, A, trans_B, B, beta, C,
+                ndim, batch_ndim, redux, compute)
     else:
         raise TypeError
 
-# Wrapper for multiprecision gemm_ex
-def gemm_ex_async(alpha: float, trans_A: TransOp, A: Tensor, \
+# Wrapper for multiprecision communication-avoiding distributed gemm. Tiles
+# of panels of A and B are broadcast along rows and columns of a process
+# grid, while optional replicas of C (temporaries of the same traits as C on
+# other layers of ranks) enable 2.5D algorithm with replication factor
+# len(C_replicas)+1.
+def gemm_summa_async(alpha: float, trans_A: TransOp, A: Tensor, \
         trans_B: TransOp, B: Tensor, beta: float, C: Tensor, ndim: int, \
-        batch_ndim: int, redux: int=0) -> None:
+        batch_ndim: int, C_replicas: List[Tensor]=[], redux: int=0) -> None:
     if type(A) is not type(B) or type(A) is not type(C):
         raise TypeError
+    for R in C_replicas:
+        if type(R) is not type(C):
+            raise TypeError
     if type(A) is core_tensor.Tensor_fp32:
-        core_tensor.gemm_ex_async_fp32(alpha, trans_A, A, trans_B, B, beta, C,
-                ndim, batch_ndim, redux)
+        core_tensor.gemm_summa_async_fp32(alpha, trans_A, A, trans_B, B, \
+                beta, C, ndim, batch_ndim, C_replicas, redux)
+    elif type(A) is core_tensor.Tensor_fp64:
+        core_tensor.gemm_summa_async_fp64(alpha, trans_A, A, trans_B, B, \
+                beta, C, ndim, batch_ndim, C_replicas, redux)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision gemm with TF32 tensor cores
+def gemm_ex_async(alpha: float, trans_A: TransOp, A: Tensor, \
+        trans_B: TransOp, B: Tensor, beta: float, C: Tensor, ndim: int, \
+        batch_ndim: int, redux: int=0, priority: Optional[int]=None) -> None:
+    gemm_async(alpha, trans_A, A, trans_B, B, beta, C, ndim, batch_ndim, \
+            redux, gemm_fast_tf32, priority)
+
+# Wrapper for multiprecision gemm with bias and approximate GeLU
+def gemm_bias_gelutanh_async(alpha: float, trans_A: TransOp, A: Tensor, \
+        trans_B: TransOp, B: Tensor, bias: Tensor, C: Tensor, D: Tensor, \
+        ndim: int, axis: int, redux: int=0) -> None:
+    if type(A) is not type(B) or type(A) is not type(bias) \
+            or type(A) is not type(C) or type(A) is not type(D):
+        raise TypeError
+    if type(A) is core_tensor.Tensor_fp32:
+        core_tensor.gemm_bias_gelutanh_async_fp32(alpha, trans_A, A, \
+                trans_B, B, bias, C, D, ndim, axis, redux)
+    elif type(A) is core_tensor.Tensor_fp64:
+        core_tensor.gemm_bias_gelutanh_async_fp64(alpha, trans_A, A, \
+                trans_B, B, bias, C, D, ndim, axis, redux)
+    else:
+        raise TypeError
+
+# Wrapper for quantization of fp32 weights into int8 or FP8 E4M3 tensors.
+# Consecutive elements along the axis are split into groups of the given
+# size with a scale per group, so that scale has the same shape as src
+# except the axis, which is divided by group. Group shall divide the
+# basetile along the axis, so per-channel scales correspond to a single
+# tile along the axis.
+def quantize_async(src: Tensor_fp32, dst: QuantizedTensor, \
+        scale: Tensor_fp32, axis: int, group: int) -> None:
+    if type(src) is not core_tensor.Tensor_fp32 \
+            or type(scale) is not core_tensor.Tensor_fp32:
+        raise TypeError
+    if type(dst) is core_tensor.Tensor_int8:
+        core_tensor.quantize_async_int8(src, dst, scale, axis, group)
+    elif type(dst) is core_tensor.Tensor_fp8_e4m3:
+        core_tensor.quantize_async_fp8_e4m3(src, dst, scale, axis, group)
+    else:
+        raise TypeError
+
+# Wrapper for gemm C = alpha*dequant(A)*B + beta*C, where A and scale are
+# produced by quantize_async along the first contracted axis of A
+# (A.ndim-ndim). Neither A nor B is transposed.
+def gemm_dequant_async(alpha: float, A: QuantizedTensor, \
+        scale: Tensor_fp32, B: Tensor_fp32, beta: float, C: Tensor_fp32, \
+        ndim: int) -> None:
+    if type(scale) is not core_tensor.Tensor_fp32 \
+            or type(B) is not core_tensor.Tensor_fp32 \
+            or type(C) is not core_tensor.Tensor_fp32:
+        raise TypeError
+    if type(A) is core_tensor.Tensor_int8:
+        core_tensor.gemm_dequant_async_int8(alpha, A, scale, B, beta, C, \
+                ndim)
+    elif type(A) is core_tensor.Tensor_fp8_e4m3:
+        core_tensor.gemm_dequant_async_fp8_e4m3(alpha, A, scale, B, beta, \
+                C, ndim)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision search of nk largest values and their indices
+# along an axis. Only the first size elements along the axis are considered,
+# which excludes padding of vocabulary. Argmax is the case of nk=1.
+def topk_async(x: Tensor, values: Tensor, indices: Tensor_int64, axis: int, \
+        size: int=-1) -> None:
+    if type(x) is not type(values) \
+            or type(indices) is not core_tensor.Tensor_int64:
+        raise TypeError
+    if size < 0:
+        size = x.shape[axis]
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.topk_async_fp32(x, values, indices, axis, size)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.topk_async_fp64(x, values, indices, axis, size)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.topk_async_bf16(x, values, indices, axis, size)
+    elif type(x) is core_tensor.Tensor_fp16:
+        core_tensor.topk_async_fp16(x, values, indices, axis, size)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision sampling of ids among candidates of topk_async
+# with temperature and nucleus of probability top_p. Zero temperature means
+# greedy choice.
+def topk_sample_async(values: Tensor, indices: Tensor_int64, \
+        ids: Tensor_int64, temperature: float, top_p: float, seed: int) \
+        -> None:
+    if type(indices) is not core_tensor.Tensor_int64 \
+            or type(ids) is not core_tensor.Tensor_int64:
+        raise TypeError
+    if type(values) is core_tensor.Tensor_fp32:
+        core_tensor.topk_sample_async_fp32(values, indices, ids, \
+                temperature, top_p, seed)
+    elif type(values) is core_tensor.Tensor_fp64:
+        core_tensor.topk_sample_async_fp64(values, indices, ids, \
+                temperature, top_p, seed)
+    elif type(values) is core_tensor.Tensor_bf16:
+        core_tensor.topk_sample_async_bf16(values, indices, ids, \
+                temperature, top_p, seed)
+    elif type(values) is core_tensor.Tensor_fp16:
+        core_tensor.topk_sample_async_fp16(values, indices, ids, \
+                temperature, top_p, seed)
     else:
         raise TypeError
 
@@ -105,6 +334,87 @@ def relu_backward_async(x: Tensor, dy: Tensor, dx: Tensor) -> None:
     else:
         raise TypeError
 
+# Wrapper for multiprecision in-place rotary position embedding
+def rope_async(base: float, position: int, x: Tensor) -> None:
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.rope_async_fp32(base, position, x)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.rope_async_fp64(base, position, x)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision backward of in-place rotary position embedding
+def rope_backward_async(base: float, position: int, dx: Tensor) -> None:
+    if type(dx) is core_tensor.Tensor_fp32:
+        core_tensor.rope_backward_async_fp32(base, position, dx)
+    elif type(dx) is core_tensor.Tensor_fp64:
+        core_tensor.rope_backward_async_fp64(base, position, dx)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision routing of tokens to slots of experts
+def moe_route_async(experts: Tensor_int64, slots: Tensor_int64, \
+        load: Tensor) -> None:
+    if type(experts) is not core_tensor.Tensor_int64 \
+            or type(slots) is not core_tensor.Tensor_int64:
+        raise TypeError
+    if type(load) is core_tensor.Tensor_fp32:
+        core_tensor.moe_route_async_fp32(experts, slots, load)
+    elif type(load) is core_tensor.Tensor_fp64:
+        core_tensor.moe_route_async_fp64(experts, slots, load)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision gather of tokens into buffers of experts
+def moe_dispatch_async(slots: Tensor_int64, x: Tensor, buf: Tensor) -> None:
+    if type(x) is not type(buf):
+        raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.moe_dispatch_async_fp32(slots, x, buf)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.moe_dispatch_async_fp64(slots, x, buf)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision backward of gather of tokens into experts
+def moe_dispatch_backward_async(slots: Tensor_int64, dbuf: Tensor, \
+        dx: Tensor) -> None:
+    if type(dbuf) is not type(dx):
+        raise TypeError
+    if type(dx) is core_tensor.Tensor_fp32:
+        core_tensor.moe_dispatch_backward_async_fp32(slots, dbuf, dx)
+    elif type(dx) is core_tensor.Tensor_fp64:
+        core_tensor.moe_dispatch_backward_async_fp64(slots, dbuf, dx)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision weighted scatter of outputs of experts
+def moe_combine_async(slots: Tensor_int64, probs: Tensor, buf: Tensor, \
+        y: Tensor) -> None:
+    if type(probs) is not type(y) or type(buf) is not type(y):
+        raise TypeError
+    if type(y) is core_tensor.Tensor_fp32:
+        core_tensor.moe_combine_async_fp32(slots, probs, buf, y)
+    elif type(y) is core_tensor.Tensor_fp64:
+        core_tensor.moe_combine_async_fp64(slots, probs, buf, y)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision backward of weighted scatter of outputs of
+# experts
+def moe_combine_backward_async(slots: Tensor_int64, probs: Tensor, \
+        buf: Tensor, dy: Tensor, dbuf: Tensor, dprobs: Tensor) -> None:
+    if type(probs) is not type(dy) or type(buf) is not type(dy):
+        raise TypeError
+    if type(dy) is core_tensor.Tensor_fp32:
+        core_tensor.moe_combine_backward_async_fp32(slots, probs, buf, dy, \
+                dbuf, dprobs)
+    elif type(dy) is core_tensor.Tensor_fp64:
+        core_tensor.moe_combine_backward_async_fp64(slots, probs, buf, dy, \
+                dbuf, dprobs)
+    else:
+        raise TypeError
+
 # Wrapper for multiprecision derivative of ReLU
 def drelu_async(x: Tensor) -> None:
     if type(x) is core_tensor.Tensor_fp32:
@@ -158,6 +468,8 @@ def gelutanh_inplace_async(x: Tensor) -> None:
         core_tensor.gelutanh_inplace_async_fp32(x)
     elif type(x) is core_tensor.Tensor_fp64:
         core_tensor.gelutanh_inplace_async_fp64(x)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.gelutanh_inplace_async_bf16(x)
     else:
         raise TypeError
 
@@ -179,6 +491,85 @@ def gelutanh_backward_async(x: Tensor, dy: Tensor, dx: Tensor) -> None:
     else:
         raise TypeError
 
+# Wrapper for multiprecision bias addition followed by approximate GeLU
+def bias_gelutanh_async(bias: Tensor, x: Tensor, y: Tensor, axis: int) \
+        -> None:
+    if type(x) is not type(bias) or type(x) is not type(y):
+        raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.bias_gelutanh_async_fp32(bias, x, y, axis)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.bias_gelutanh_async_fp64(bias, x, y, axis)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision backward of bias addition followed by
+# approximate GeLU
+def bias_gelutanh_backward_async(x: Tensor, dy: Tensor, dx: Tensor, \
+        dbias: Tensor, axis: int, redux: int=0) -> None:
+    if type(x) is not type(dy) or type(x) is not type(dx) \
+            or type(x) is not type(dbias):
+        raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.bias_gelutanh_backward_async_fp32(x, dy, dx, dbias, \
+                axis, redux)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.bias_gelutanh_backward_async_fp64(x, dy, dx, dbias, \
+                axis, redux)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision batch normalization with given statistics
+# followed by an activation
+def batch_norm_act_async(x: Tensor, mean: Tensor, inv_stddev: Tensor, \
+        gamma: Tensor, beta: Tensor, y: Tensor, axis: int, \
+        act: BatchNormActivation) -> None:
+    for t in (mean, inv_stddev, gamma, beta, y):
+        if type(x) is not type(t):
+            raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.batch_norm_act_async_fp32(x, mean, inv_stddev, gamma, \
+                beta, y, axis, act)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.batch_norm_act_async_fp64(x, mean, inv_stddev, gamma, \
+                beta, y, axis, act)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision backward of an activation, that follows batch
+# normalization, with accumulation of sums of gradients over features
+def batch_norm_act_backward_async(x: Tensor, mean: Tensor, \
+        inv_stddev: Tensor, gamma: Tensor, beta: Tensor, dy: Tensor, \
+        dz: Tensor, sum_dz: Tensor, sum_dz_xhat: Tensor, axis: int, \
+        act: BatchNormActivation, redux: int=0) -> None:
+    for t in (mean, inv_stddev, gamma, beta, dy, dz, sum_dz, sum_dz_xhat):
+        if type(x) is not type(t):
+            raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.batch_norm_act_backward_async_fp32(x, mean, inv_stddev, \
+                gamma, beta, dy, dz, sum_dz, sum_dz_xhat, axis, act, redux)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.batch_norm_act_backward_async_fp64(x, mean, inv_stddev, \
+                gamma, beta, dy, dz, sum_dz, sum_dz_xhat, axis, act, redux)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision backward of batch normalization over its input
+def batch_norm_backward_async(x: Tensor, mean: Tensor, inv_stddev: Tensor, \
+        gamma: Tensor, sum_dz: Tensor, sum_dz_xhat: Tensor, dz: Tensor, \
+        axis: int) -> None:
+    for t in (mean, inv_stddev, gamma, sum_dz, sum_dz_xhat, dz):
+        if type(x) is not type(t):
+            raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.batch_norm_backward_async_fp32(x, mean, inv_stddev, \
+                gamma, sum_dz, sum_dz_xhat, dz, axis)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.batch_norm_backward_async_fp64(x, mean, inv_stddev, \
+                gamma, sum_dz, sum_dz_xhat, dz, axis)
+    else:
+        raise TypeError
+
 # Wrapper for multiprecision fill
 def fill_async(val: float, x: Tensor) -> None:
     if type(x) is core_tensor.Tensor_fp32:
@@ -188,6 +579,25 @@ def fill_async(val: float, x: Tensor) -> None:
     else:
         raise TypeError
 
+# Shape of a padded tensor, which tiles are all of the base tile shape
+def padded_shape(shape: List[int], basetile_shape: List[int]) -> List[int]:
+    return core_tensor.padded_shape(shape, basetile_shape)
+
+# Wrapper for multiprecision fill_padding
+def fill_padding_async(val: float, logical_shape: List[int], x: Tensor) \
+        -> None:
+    """Set elements of a padded tensor beyond its logical shape to val
+
+    Padding shall be zero for gemm, sums and norms and -inf along an axis
+    of softmax or maxsumexp, so that results on the logical part of a
+    tensor do not depend on padding."""
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.fill_padding_async_fp32(val, logical_shape, x)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.fill_padding_async_fp64(val, logical_shape, x)
+    else:
+        raise TypeError
+
 # Wrapper for multiprecision sum_slice
 def sum_slice_async(alpha: float, x: Tensor, beta: float, sum_slice: Tensor, \
         axis: int, redux: int=0) -> None:
@@ -199,6 +609,9 @@ def sum_slice_async(alpha: float, x: Tensor, beta: float, sum_slice: Tensor, \
     elif type(x) is core_tensor.Tensor_fp64:
         core_tensor.sum_slice_async_fp64(alpha, x, beta, sum_slice, axis, \
                 redux)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.sum_slice_async_bf16(alpha, x, beta, sum_slice, axis, \
+                redux)
     else:
         raise TypeError
 
@@ -228,6 +641,118 @@ def norm_slice_async(alpha: float, x: Tensor, beta: float, \
         core_tensor.norm_slice_async_fp64(alpha, x, beta, norm_slice, axis, \
                 redux)
 
+# Wrapper for multiprecision fused layer normalization
+def layer_norm_async(eps: float, x: Tensor, gamma: Tensor, beta: Tensor, \
+        mean: Tensor, inv_stddev: Tensor, y: Tensor, axis: int) -> None:
+    if type(x) is not type(gamma) or type(x) is not type(beta) \
+            or type(x) is not type(mean) or type(x) is not type(inv_stddev) \
+            or type(x) is not type(y):
+        raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.layer_norm_async_fp32(eps, x, gamma, beta, mean, \
+                inv_stddev, y, axis)
+    else:
+        core_tensor.layer_norm_async_fp64(eps, x, gamma, beta, mean, \
+                inv_stddev, y, axis)
+
+# Wrapper for multiprecision backward of fused layer normalization
+def layer_norm_backward_async(x: Tensor, dy: Tensor, gamma: Tensor, \
+        mean: Tensor, inv_stddev: Tensor, dx: Tensor, dgamma: Tensor, \
+        dbeta: Tensor, axis: int, redux: int=0) -> None:
+    if type(x) is not type(dy) or type(x) is not type(gamma) \
+            or type(x) is not type(mean) or type(x) is not type(inv_stddev) \
+            or type(x) is not type(dx) or type(x) is not type(dgamma) \
+            or type(x) is not type(dbeta):
+        raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.layer_norm_backward_async_fp32(x, dy, gamma, mean, \
+                inv_stddev, dx, dgamma, dbeta, axis, redux)
+    else:
+        core_tensor.layer_norm_backward_async_fp64(x, dy, gamma, mean, \
+                inv_stddev, dx, dgamma, dbeta, axis, redux)
+
+# Wrapper for multiprecision fused residual addition and layer normalization
+def add_layer_norm_async(eps: float, x: Tensor, r: Tensor, gamma: Tensor, \
+        beta: Tensor, res: Tensor, mean: Tensor, inv_stddev: Tensor, \
+        y: Tensor, axis: int) -> None:
+    if type(x) is not type(r) or type(x) is not type(gamma) \
+            or type(x) is not type(beta) or type(x) is not type(res) \
+            or type(x) is not type(mean) or type(x) is not type(inv_stddev) \
+            or type(x) is not type(y):
+        raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.add_layer_norm_async_fp32(eps, x, r, gamma, beta, res, \
+                mean, inv_stddev, y, axis)
+    else:
+        core_tensor.add_layer_norm_async_fp64(eps, x, r, gamma, beta, res, \
+                mean, inv_stddev, y, axis)
+
+# Wrapper for multiprecision backward of fused residual addition and layer
+# normalization
+def add_layer_norm_backward_async(res: Tensor, dy: Tensor, gamma: Tensor, \
+        mean: Tensor, inv_stddev: Tensor, dres: Tensor, dx: Tensor, \
+        dr: Tensor, dgamma: Tensor, dbeta: Tensor, axis: int, \
+        redux: int=0) -> None:
+    if type(res) is not type(dy) or type(res) is not type(gamma) \
+            or type(res) is not type(mean) \
+            or type(res) is not type(inv_stddev) \
+            or type(res) is not type(dres) or type(res) is not type(dx) \
+            or type(res) is not type(dr) or type(res) is not type(dgamma) \
+            or type(res) is not type(dbeta):
+        raise TypeError
+    if type(res) is core_tensor.Tensor_fp32:
+        core_tensor.add_layer_norm_backward_async_fp32(res, dy, gamma, mean, \
+                inv_stddev, dres, dx, dr, dgamma, dbeta, axis, redux)
+    else:
+        core_tensor.add_layer_norm_backward_async_fp64(res, dy, gamma, mean, \
+                inv_stddev, dres, dx, dr, dgamma, dbeta, axis, redux)
+
+# Wrapper for multiprecision root mean square layer normalization
+def rms_norm_async(eps: float, x: Tensor, gamma: Tensor, inv_rms: Tensor, \
+        y: Tensor, axis: int) -> None:
+    if type(x) is not type(gamma) or type(x) is not type(inv_rms) \
+            or type(x) is not type(y):
+        raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.rms_norm_async_fp32(eps, x, gamma, inv_rms, y, axis)
+    else:
+        core_tensor.rms_norm_async_fp64(eps, x, gamma, inv_rms, y, axis)
+
+# Wrapper for multiprecision backward of root mean square layer normalization
+def rms_norm_backward_async(x: Tensor, dy: Tensor, gamma: Tensor, \
+        inv_rms: Tensor, dx: Tensor, dgamma: Tensor, axis: int, \
+        redux: int=0) -> None:
+    if type(x) is not type(dy) or type(x) is not type(gamma) \
+            or type(x) is not type(inv_rms) or type(x) is not type(dx) \
+            or type(x) is not type(dgamma):
+        raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.rms_norm_backward_async_fp32(x, dy, gamma, inv_rms, dx, \
+                dgamma, axis, redux)
+    else:
+        core_tensor.rms_norm_backward_async_fp64(x, dy, gamma, inv_rms, dx, \
+                dgamma, axis, redux)
+
+# Wrapper for multiprecision SiLU-gated product
+def swiglu_async(gate: Tensor, up: Tensor, y: Tensor) -> None:
+    if type(gate) is not type(up) or type(gate) is not type(y):
+        raise TypeError
+    if type(gate) is core_tensor.Tensor_fp32:
+        core_tensor.swiglu_async_fp32(gate, up, y)
+    else:
+        core_tensor.swiglu_async_fp64(gate, up, y)
+
+# Wrapper for multiprecision backward of SiLU-gated product
+def swiglu_backward_async(gate: Tensor, up: Tensor, dy: Tensor, \
+        dgate: Tensor, dup: Tensor) -> None:
+    if type(gate) is not type(up) or type(gate) is not type(dy) \
+            or type(gate) is not type(dgate) or type(gate) is not type(dup):
+        raise TypeError
+    if type(gate) is core_tensor.Tensor_fp32:
+        core_tensor.swiglu_backward_async_fp32(gate, up, dy, dgate, dup)
+    else:
+        core_tensor.swiglu_backward_async_fp64(gate, up, dy, dgate, dup)
+
 # Wrapper for multiprecision pow
 def pow_async(alpha: float, exp: float, x: Tensor) -> None:
     if type(x) is core_tensor.Tensor_fp32:
@@ -249,7 +774,8 @@ def sumnorm_async(x: Tensor, sumnorm: Tensor, axis: int) -> None:
 # Wrapper for multiprecision fast fused softmax+gemm
 def flash_softmax_gemm_async(Q: Tensor, K: Tensor, V: Tensor, \
         mask: Tensor_bool, maxsumexp: Tensor, dst: Tensor, tmp: Tensor, \
-        redux: int=0, fp32_fast_tf32: int=0) -> None:
+        redux: int=0, fp32_fast_tf32: int=0, dropout_p: float=0.0, \
+        seed: int=0, layout: Optional[List[MaskTile]]=None) -> None:
     if type(Q) is not type(K):
         raise TypeError
     if type(Q) is not type(V):
@@ -260,12 +786,14 @@ def flash_softmax_gemm_async(Q: Tensor, K: Tensor, V: Tensor, \
         raise TypeError
     if type(Q) is not type(tmp):
         raise TypeError
+    # Without a layout the mask is read on every call
+    layout = [] if layout is None else layout
     if type(Q) is core_tensor.Tensor_fp32:
         core_tensor.flash_softmax_gemm_async_fp32(Q, K, V, mask, maxsumexp, \
-                dst, tmp, redux, fp32_fast_tf32)
+                dst, tmp, redux, fp32_fast_tf32, dropout_p, seed, layout)
     elif type(Q) is core_tensor.Tensor_fp64:
         core_tensor.flash_softmax_gemm_async_fp64(Q, K, V, mask, maxsumexp, \
-                dst, tmp, redux, 0)
+                dst, tmp, redux, 0, dropout_p, seed, layout)
     else:
         raise TypeError
 
@@ -273,7 +801,9 @@ def flash_softmax_gemm_async(Q: Tensor, K: Tensor, V: Tensor, \
 def flash_softmax_gemm_backward_async(Q: Tensor, dQ: Tensor, K: Tensor, \
         dK: Tensor, V: Tensor, dV: Tensor, mask: Tensor_bool, \
         maxsumexp: Tensor, dst_grad: Tensor, tmp: Tensor, tmp_grad: Tensor, \
-        tmp_sumprod_slice: Tensor, redux: int=0, fp32_fast_tf32: int=0) -> None:
+        tmp_sumprod_slice: Tensor, redux: int=0, fp32_fast_tf32: int=0, \
+        dropout_p: float=0.0, seed: int=0, \
+        layout: Optional[List[MaskTile]]=None) -> None:
     if type(Q) is not type(dQ):
         raise TypeError
     if type(Q) is not type(K):
@@ -294,14 +824,103 @@ def flash_softmax_gemm_backward_async(Q: Tensor, dQ: Tensor, K: Tensor, \
         raise TypeError
     if type(Q) is not type(tmp_sumprod_slice):
         raise TypeError
+    layout = [] if layout is None else layout
     if type(Q) is core_tensor.Tensor_fp32:
         core_tensor.flash_softmax_gemm_backward_async_fp32(Q, dQ, K, dK, V, \
                 dV, mask, maxsumexp, dst_grad, tmp, tmp_grad, \
-                tmp_sumprod_slice, redux, fp32_fast_tf32)
+                tmp_sumprod_slice, redux, fp32_fast_tf32, dropout_p, seed, \
+                layout)
     elif type(Q) is core_tensor.Tensor_fp64:
         core_tensor.flash_softmax_gemm_backward_async_fp64(Q, dQ, K, dK, V, \
                 dV, mask, maxsumexp, dst_grad, tmp, tmp_grad, \
-                tmp_sumprod_slice, redux, 0)
+                tmp_sumprod_slice, redux, 0, dropout_p, seed, layout)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision fused single-pass flash attention. With ring
+# enabled, tiles of queries stay on their nodes, while tiles of keys and
+# values are passed over a ring of nodes (sequence parallelism).
+def flash_attention_async(Q: Tensor, K: Tensor, V: Tensor, mask: Tensor_bool, \
+        maxsumexp: Tensor, dst: Tensor, \
+        layout: Optional[List[MaskTile]]=None, ring: bool=False) -> None:
+    if type(Q) is not type(K):
+        raise TypeError
+    if type(Q) is not type(V):
+        raise TypeError
+    if type(Q) is not type(maxsumexp):
+        raise TypeError
+    if type(Q) is not type(dst):
+        raise TypeError
+    layout = [] if layout is None else layout
+    if type(Q) is core_tensor.Tensor_fp32:
+        if ring:
+            core_tensor.flash_attention_ring_async_fp32(Q, K, V, mask, \
+                    maxsumexp, dst, layout)
+        else:
+            core_tensor.flash_attention_async_fp32(Q, K, V, mask, maxsumexp, \
+                    dst, layout)
+    elif type(Q) is core_tensor.Tensor_fp64:
+        if ring:
+            core_tensor.flash_attention_ring_async_fp64(Q, K, V, mask, \
+                    maxsumexp, dst, layout)
+        else:
+            core_tensor.flash_attention_async_fp64(Q, K, V, mask, maxsumexp, \
+                    dst, layout)
+    else:
+        raise TypeError
+
+# Wrapper for fused single-pass attention of fp32 queries to quantized keys
+# and values, e.g., of a quantized KV-cache. Scales of keys and values are
+# produced by quantize_async along the axis 0 with groups of the size of a
+# head. Mask is of shape (n_seq_k, n_seq) or (n_seq_k, n_seq, n_batch).
+def flash_attention_dequant_async(Q: Tensor_fp32, K: QuantizedTensor, \
+        K_scale: Tensor_fp32, V: QuantizedTensor, V_scale: Tensor_fp32, \
+        mask: Tensor_bool, maxsumexp: Tensor_fp32, dst: Tensor_fp32) -> None:
+    if type(K) is not type(V):
+        raise TypeError
+    for x in (Q, K_scale, V_scale, maxsumexp, dst):
+        if type(x) is not core_tensor.Tensor_fp32:
+            raise TypeError
+    if type(K) is core_tensor.Tensor_int8:
+        core_tensor.flash_attention_dequant_async_int8(Q, K, K_scale, V, \
+                V_scale, mask, maxsumexp, dst)
+    elif type(K) is core_tensor.Tensor_fp8_e4m3:
+        core_tensor.flash_attention_dequant_async_fp8_e4m3(Q, K, K_scale, \
+                V, V_scale, mask, maxsumexp, dst)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision backward of fused single-pass flash attention
+def flash_attention_backward_async(Q: Tensor, dQ: Tensor, K: Tensor, \
+        dK: Tensor, V: Tensor, dV: Tensor, mask: Tensor_bool, \
+        maxsumexp: Tensor, dst: Tensor, dst_grad: Tensor, \
+        sumprod_slice: Tensor, redux: int=0, \
+        layout: Optional[List[MaskTile]]=None) -> None:
+    if type(Q) is not type(dQ):
+        raise TypeError
+    if type(Q) is not type(K):
+        raise TypeError
+    if type(Q) is not type(dK):
+        raise TypeError
+    if type(Q) is not type(V):
+        raise TypeError
+    if type(Q) is not type(dV):
+        raise TypeError
+    if type(Q) is not type(maxsumexp):
+        raise TypeError
+    if type(Q) is not type(dst):
+        raise TypeError
+    if type(Q) is not type(dst_grad):
+        raise TypeError
+    if type(Q) is not type(sumprod_slice):
+        raise TypeError
+    layout = [] if layout is None else layout
+    if type(Q) is core_tensor.Tensor_fp32:
+        core_tensor.flash_attention_backward_async_fp32(Q, dQ, K, dK, V, dV, \
+                mask, maxsumexp, dst, dst_grad, sumprod_slice, redux, layout)
+    elif type(Q) is core_tensor.Tensor_fp64:
+        core_tensor.flash_attention_backward_async_fp64(Q, dQ, K, dK, V, dV, \
+                mask, maxsumexp, dst, dst_grad, sumprod_slice, redux, layout)
     else:
         raise TypeError
 
@@ -328,6 +947,8 @@ def softmax_inplace_async(maxsumexp: Tensor, alpha, x: Tensor, \
         core_tensor.softmax_inplace_async_fp32(maxsumexp, alpha, x, axis)
     elif type(x) is core_tensor.Tensor_fp64:
         core_tensor.softmax_inplace_async_fp64(maxsumexp, alpha, x, axis)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.softmax_inplace_async_bf16(maxsumexp, alpha, x, axis)
     else:
         raise TypeError
 
@@ -337,12 +958,14 @@ def scatter_async(x: TensorFloatOrInt, y: TensorFloatOrInt) -> None:
         raise TypeError
     if type(x) is core_tensor.Tensor_fp32:
         core_tensor.scatter_async_fp32(x, y)
-    elif type(x) is core_tensor.Tensor_fp32:
+    elif type(x) is core_tensor.Tensor_fp64:
         core_tensor.scatter_async_fp64(x, y)
     elif type(x) is core_tensor.Tensor_int64:
         core_tensor.scatter_async_int64(x, y)
     elif type(x) is core_tensor.Tensor_bool:
         core_tensor.scatter_async_bool(x, y)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.scatter_async_bf16(x, y)
     else:
         raise TypeError
 
@@ -356,6 +979,29 @@ def randn_async(x: Tensor, start: List[int], shape: List[int], seed: int,
     else:
         raise TypeError
 
+# Wrapper for multiprecision randn by counter-based Philox generator, that
+# also runs on CUDA
+def randn_philox_async(x: Tensor, start: List[int], shape: List[int], \
+        seed: int, mean: float, dev: float) -> None:
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.randn_philox_async_fp32(x, start, shape, seed, mean, dev)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.randn_philox_async_fp64(x, start, shape, seed, mean, dev)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision dropout, that regenerates its mask from the seed
+def dropout_async(seed: int, p: float, x: Tensor, beta: float, y: Tensor) \
+        -> None:
+    if type(x) is not type(y):
+        raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.dropout_async_fp32(seed, p, x, beta, y)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.dropout_async_fp64(seed, p, x, beta, y)
+    else:
+        raise TypeError
+
 # Wrapper for multiprecision prod
 def prod_async(x: Tensor, y: Tensor) -> None:
     if type(x) is not type(y):
@@ -364,6 +1010,8 @@ def prod_async(x: Tensor, y: Tensor) -> None:
         core_tensor.prod_async_fp32(x, y)
     elif type(x) is core_tensor.Tensor_fp64:
         core_tensor.prod_async_fp64(x, y)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.prod_async_bf16(x, y)
     else:
         raise TypeError
     
@@ -390,6 +1038,31 @@ def nrm2_async(alpha:float, x: Tensor, beta: float, y: Tensor,
     else:
         raise TypeError
 
+# Euclidean norm of many tensors as a whole into a scalar tensor
+def global_nrm2_async(x: List[Tensor], y: Tensor) -> None:
+    for t in x:
+        if type(t) is not type(y):
+            raise TypeError
+    if type(y) is core_tensor.Tensor_fp32:
+        core_tensor.global_nrm2_async_fp32(x, y)
+    elif type(y) is core_tensor.Tensor_fp64:
+        core_tensor.global_nrm2_async_fp64(x, y)
+    else:
+        raise TypeError
+
+# Learning rate and scale of gradients for clipping by a global norm into a
+# tensor of shape [2], that is read by fused Adam steps
+def clip_scale_async(lr: float, max_norm: float, norm: Tensor, \
+        scalars: Tensor) -> None:
+    if type(norm) is not type(scalars):
+        raise TypeError
+    if type(norm) is core_tensor.Tensor_fp32:
+        core_tensor.clip_scale_async_fp32(lr, max_norm, norm, scalars)
+    elif type(norm) is core_tensor.Tensor_fp64:
+        core_tensor.clip_scale_async_fp64(lr, max_norm, norm, scalars)
+    else:
+        raise TypeError
+
 # Wrapper for multiprecision normalize
 def normalize_async(gb: Tensor, x: Tensor, y: Tensor, l: int, eps: float,
         axis: int) -> None:
@@ -405,19 +1078,20 @@ def normalize_async(gb: Tensor, x: Tensor, y: Tensor, l: int, eps: float,
 # Wrapper for multiprecision fast maxsumexp
 def flash_maxsumexp_async(Q: Tensor, K: Tensor, mask: Tensor_bool, \
         maxsumexp: Tensor, tmp: Tensor, redux: int=0, \
-        fp32_fast_tf32: int=0) -> None:
+        fp32_fast_tf32: int=0, layout: Optional[List[MaskTile]]=None) -> None:
     if type(Q) is not type(K):
         raise TypeError
     if type(Q) is not type(maxsumexp):
         raise TypeError
     if type(Q) is not type(tmp):
         raise TypeError
+    layout = [] if layout is None else layout
     if type(Q) is core_tensor.Tensor_fp32:
         core_tensor.flash_maxsumexp_async_fp32(Q, K, mask, maxsumexp, tmp, \
-                redux, fp32_fast_tf32)
+                redux, fp32_fast_tf32, layout)
     elif type(Q) is core_tensor.Tensor_fp64:
         core_tensor.flash_maxsumexp_async_fp64(Q, K, mask, maxsumexp, tmp, \
-                redux, 0)
+                redux, 0, layout)
     else:
         raise TypeError
 
@@ -430,6 +1104,8 @@ def maxsumexp_async(x: Tensor, maxsumexp: Tensor, axis: int, \
         core_tensor.maxsumexp_async_fp32(x, maxsumexp, axis, redux)
     elif type(x) is core_tensor.Tensor_fp64:
         core_tensor.maxsumexp_async_fp64(x, maxsumexp, axis, redux)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.maxsumexp_async_bf16(x, maxsumexp, axis, redux)
     else:
         raise TypeError
 
@@ -532,6 +1208,61 @@ def gather_async(x: TensorFloatOrInt, y: TensorFloatOrInt) -> None:
         core_tensor.gather_async_int64(x, y)
     elif type(x) is core_tensor.Tensor_bool:
         core_tensor.gather_async_bool(x, y)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.gather_async_bf16(x, y)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision hierarchical broadcast
+# Broadcast of the first tensor into the other ones
+def broadcast_async(tensors: List[Tensor], ranks_per_node: int=0) -> None:
+    for t in tensors[1:]:
+        if type(t) is not type(tensors[0]):
+            raise TypeError
+    if type(tensors[0]) is core_tensor.Tensor_fp32:
+        core_tensor.broadcast_async_fp32(tensors, ranks_per_node)
+    elif type(tensors[0]) is core_tensor.Tensor_fp64:
+        core_tensor.broadcast_async_fp64(tensors, ranks_per_node)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision hierarchical reduce
+# Sum of all the tensors into the first one
+def reduce_async(tensors: List[Tensor], ranks_per_node: int=0) -> None:
+    for t in tensors[1:]:
+        if type(t) is not type(tensors[0]):
+            raise TypeError
+    if type(tensors[0]) is core_tensor.Tensor_fp32:
+        core_tensor.reduce_async_fp32(tensors, ranks_per_node)
+    elif type(tensors[0]) is core_tensor.Tensor_fp64:
+        core_tensor.reduce_async_fp64(tensors, ranks_per_node)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision hierarchical allreduce
+# Sum of all the tensors into all of them
+def allreduce_async(tensors: List[Tensor], ranks_per_node: int=0) -> None:
+    for t in tensors[1:]:
+        if type(t) is not type(tensors[0]):
+            raise TypeError
+    if type(tensors[0]) is core_tensor.Tensor_fp32:
+        core_tensor.allreduce_async_fp32(tensors, ranks_per_node)
+    elif type(tensors[0]) is core_tensor.Tensor_fp64:
+        core_tensor.allreduce_async_fp64(tensors, ranks_per_node)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision hierarchical allgather
+# Copy of a distributed tensor into all the replicas
+def allgather_async(x: Tensor, replicas: List[Tensor], \
+        ranks_per_node: int=0) -> None:
+    for t in replicas:
+        if type(t) is not type(x):
+            raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.allgather_async_fp32(x, replicas, ranks_per_node)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.allgather_async_fp64(x, replicas, ranks_per_node)
     else:
         raise TypeError
 
@@ -546,6 +1277,24 @@ def copy_intersection_async(x: TensorFloatOrInt, x_offset: List[int], \
         core_tensor.copy_intersection_async_fp64(x, x_offset, y, y_offset)
     elif type(x) is core_tensor.Tensor_int64:
         core_tensor.copy_intersection_async_int64(x, x_offset, y, y_offset)
+    elif type(x) is core_tensor.Tensor_int8:
+        core_tensor.copy_intersection_async_int8(x, x_offset, y, y_offset)
+    elif type(x) is core_tensor.Tensor_fp8_e4m3:
+        core_tensor.copy_intersection_async_fp8_e4m3(x, x_offset, y, \
+                y_offset)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision redistribute
+def redistribute_async(x: TensorFloatOrInt, y: TensorFloatOrInt) -> None:
+    if type(x) is not type(y):
+        raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.redistribute_async_fp32(x, y)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.redistribute_async_fp64(x, y)
+    elif type(x) is core_tensor.Tensor_int64:
+        core_tensor.redistribute_async_int64(x, y)
     else:
         raise TypeError
 
@@ -562,12 +1311,39 @@ def copy_async(x: TensorFloatOrInt, y: TensorFloatOrInt) -> None:
     else:
         raise TypeError
 
+# Wrapper for copy with conversion between precisions
+def convert_async(x: Tensor, y: Tensor) -> None:
+    if type(x) is type(y):
+        copy_async(x, y)
+    elif type(x) is core_tensor.Tensor_fp32:
+        if type(y) is core_tensor.Tensor_fp16:
+            core_tensor.fp32_to_fp16_async(x, y)
+        elif type(y) is core_tensor.Tensor_bf16:
+            core_tensor.fp32_to_bf16_async(x, y)
+        else:
+            raise TypeError
+    elif type(y) is core_tensor.Tensor_fp32:
+        if type(x) is core_tensor.Tensor_fp16:
+            core_tensor.fp16_to_fp32_async(x, y)
+        elif type(x) is core_tensor.Tensor_bf16:
+            core_tensor.bf16_to_fp32_async(x, y)
+        else:
+            raise TypeError
+    else:
+        raise TypeError
+
 # Wrapper for multiprecision clear
 def clear_async(x: Tensor) -> None:
     if type(x) is core_tensor.Tensor_fp32:
         core_tensor.clear_async_fp32(x)
     elif type(x) is core_tensor.Tensor_fp64:
         core_tensor.clear_async_fp64(x)
+    elif type(x) is core_tensor.Tensor_fp16:
+        core_tensor.clear_async_fp16(x)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.clear_async_bf16(x)
+    elif type(x) is core_tensor.Tensor_bool:
+        core_tensor.clear_async_bool(x)
     else:
         raise TypeError
 
@@ -690,6 +1466,22 @@ def total_sum_accum_async(alpha: float, logsumexp: Tensor, src: Tensor, \
     else:
         raise TypeError
 
+# Wrapper for multiprecision fused loss and gradient of softmax cross-entropy
+def softmax_crossentropy_async(scale: float, maxsumexp: Tensor, src: Tensor, \
+        class_labels: Tensor_int64, dst: Tensor, val: Tensor, \
+        label_offset: int=0) -> None:
+    if type(maxsumexp) is not type(src) or type(src) is not type(dst) \
+            or type(dst) is not type(val):
+        raise TypeError
+    if type(src) is core_tensor.Tensor_fp32:
+        core_tensor.softmax_crossentropy_async_fp32(scale, maxsumexp, src, \
+                class_labels, dst, val, label_offset)
+    elif type(src) is core_tensor.Tensor_fp64:
+        core_tensor.softmax_crossentropy_async_fp64(scale, maxsumexp, src, \
+                class_labels, dst, val, label_offset)
+    else:
+        raise TypeError
+
 def subtract_indexed_outputs_async(val: float, class_labels: Tensor_int64, \
         dst: Tensor):
     if type(dst) is core_tensor.Tensor_fp32:
@@ -755,6 +1547,49 @@ def embedding_backward_async(index: Tensor_int64, embed: Tensor, \
     else:
         raise TypeError
 
+# Wrapper for embedding_rows
+def embedding_rows_async(index: Tensor_int64, rows: Tensor_bool) -> None:
+    core_tensor.embedding_rows_async(index, rows)
+
+# Wrapper for multiprecision embedding of tokens with added positional
+# embedding
+def embedding_pos_async(index: Tensor_int64, pos: Tensor_int64, \
+        vocab: Tensor, pos_vocab: Tensor, embed: Tensor, axis: int) -> None:
+    if type(vocab) is not type(embed) or type(pos_vocab) is not type(embed):
+        raise TypeError
+    if type(embed) is core_tensor.Tensor_fp32:
+        core_tensor.embedding_pos_async_fp32(index, pos, vocab, pos_vocab, \
+                embed, axis)
+    elif type(embed) is core_tensor.Tensor_fp64:
+        core_tensor.embedding_pos_async_fp64(index, pos, vocab, pos_vocab, \
+                embed, axis)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision embedding_pos_backward
+def embedding_pos_backward_async(index: Tensor_int64, pos: Tensor_int64, \
+        embed: Tensor, vocab: Tensor, pos_vocab: Tensor, axis: int, \
+        redux: int=0) -> None:
+    if type(vocab) is not type(embed) or type(pos_vocab) is not type(embed):
+        raise TypeError
+    if type(embed) is core_tensor.Tensor_fp32:
+        core_tensor.embedding_pos_backward_async_fp32(index, pos, embed, \
+                vocab, pos_vocab, axis, redux)
+    elif type(embed) is core_tensor.Tensor_fp64:
+        core_tensor.embedding_pos_backward_async_fp64(index, pos, embed, \
+                vocab, pos_vocab, axis, redux)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision softmax_online
+def softmax_online_async(alpha, x: Tensor, axis: int) -> None:
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.softmax_online_async_fp32(alpha, x, axis)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.softmax_online_async_fp64(alpha, x, axis)
+    else:
+        raise TypeError
+
 # Wrapper for multiprecision hypot
 def hypot_async(alpha: float, x: Tensor, beta: float, y: Tensor) -> None:
     if type(x) is not type(y):
@@ -775,15 +1610,23 @@ def hypot_scalar_inverse_async(eps: float, alpha: float, x: Tensor) -> None:
     else:
         raise TypeError
 
+# Learning rate and scale of gradients are read from scalars (see
+# clip_scale_async) instead of lr, if they are given
 def fused_adam_step(p: Tensor, grad: Tensor, first_moment: Tensor, second_moment: Tensor,
-                   lr: float, eps: float, beta1: float, beta2: float, weight_decay: float, num_iter: int):
+                   lr: float, eps: float, beta1: float, beta2: float, weight_decay: float, num_iter: int,
+                   scalars: TensorOrNone=None):
     if type(p) is not type(grad):
         raise TypeError
     if type(p) is not type(first_moment):
         raise TypeError
     if type(p) is not type(second_moment):
         raise TypeError
-    if type(p) is core_tensor.Tensor_fp32:
+    # A task per tile, as in adam_step
+    if scalars is not None:
+        fused_multi_adam_step([p], [grad], [first_moment], \
+                [second_moment], lr, eps, beta1, beta2, weight_decay, \
+                num_iter, max_nelems=1, scalars=scalars)
+    elif type(p) is core_tensor.Tensor_fp32:
         core_tensor.adam_step_async_fp32(num_iter, beta1, beta2, eps, lr, weight_decay,
                                          grad, first_moment, second_moment, p)
     elif type(p) is core_tensor.Tensor_fp64:
@@ -792,6 +1635,92 @@ def fused_adam_step(p: Tensor, grad: Tensor, first_moment: Tensor, second_moment
     else:
         raise TypeError
 
+# Adam step only for marked columns, each with its own number of steps
+def sparse_adam_step(p: Tensor, grad: Tensor, first_moment: Tensor, \
+        second_moment: Tensor, cols: Tensor_bool, cols_iter: Tensor_int64, \
+        lr: float, eps: float, beta1: float, beta2: float, \
+        weight_decay: float) -> None:
+    if type(p) is not type(grad):
+        raise TypeError
+    if type(p) is not type(first_moment):
+        raise TypeError
+    if type(p) is not type(second_moment):
+        raise TypeError
+    if type(p) is core_tensor.Tensor_fp32:
+        core_tensor.sparse_adam_step_async_fp32(beta1, beta2, eps, lr, \
+                weight_decay, cols, cols_iter, grad, first_moment, \
+                second_moment, p)
+    elif type(p) is core_tensor.Tensor_fp64:
+        core_tensor.sparse_adam_step_async_fp64(beta1, beta2, eps, lr, \
+                weight_decay, cols, cols_iter, grad, first_moment, \
+                second_moment, p)
+    else:
+        raise TypeError
+
+# SGD step with momentum, that updates velocity and parameters in a single
+# pass. Gradients are not changed, and velocity is not used without momentum.
+def fused_sgd_step(p: Tensor, grad: Tensor, velocity: TensorOrNone, \
+        lr: float, momentum: float, dampening: float, weight_decay: float, \
+        nesterov: bool, num_iter: int) -> None:
+    if type(p) is not type(grad):
+        raise TypeError
+    if velocity is None:
+        if momentum != 0:
+            raise ValueError("Momentum requires velocity")
+        velocity = grad
+    elif type(p) is not type(velocity):
+        raise TypeError
+    if type(p) is core_tensor.Tensor_fp32:
+        core_tensor.sgd_step_async_fp32(num_iter, momentum, dampening, lr, \
+                weight_decay, nesterov, grad, velocity, p)
+    elif type(p) is core_tensor.Tensor_fp64:
+        core_tensor.sgd_step_async_fp64(num_iter, momentum, dampening, lr, \
+                weight_decay, nesterov, grad, velocity, p)
+    else:
+        raise TypeError
+
+# Fused Adafactor step with second moments, that are factored into row and
+# col for parameters of at least 2 dimensions. Otherwise row keeps second
+# moments on its own
+def fused_adafactor_step(p: Tensor, grad: Tensor, row: Tensor, \
+        col: TensorOrNone, mean: TensorOrNone, lr: float, eps: float, \
+        beta2: float, weight_decay: float, num_iter: int) -> None:
+    if col is None:
+        col = row
+    if mean is None:
+        mean = row
+    for t in (grad, row, col, mean):
+        if type(p) is not type(t):
+            raise TypeError
+    if type(p) is core_tensor.Tensor_fp32:
+        core_tensor.adafactor_step_async_fp32(num_iter, beta2, eps, lr, \
+                weight_decay, row, col, mean, grad, p)
+    elif type(p) is core_tensor.Tensor_fp64:
+        core_tensor.adafactor_step_async_fp64(num_iter, beta2, eps, lr, \
+                weight_decay, row, col, mean, grad, p)
+    else:
+        raise TypeError
+
+# Fused Adam or AdamW step with int8 first moments and FP8 second moments,
+# that are quantized by blocks of block elements with scales of their own
+def fused_quantized_adam_step(p: Tensor, grad: Tensor, first_moment: Tensor, \
+        first_scale: Tensor, second_moment: Tensor, second_scale: Tensor, \
+        lr: float, eps: float, beta1: float, beta2: float, \
+        weight_decay: float, num_iter: int, block: int, \
+        decoupled: bool=False) -> None:
+    if type(p) is not core_tensor.Tensor_fp32:
+        raise TypeError
+    for t in (grad, first_scale, second_scale):
+        if type(t) is not core_tensor.Tensor_fp32:
+            raise TypeError
+    if type(first_moment) is not core_tensor.Tensor_int8:
+        raise TypeError
+    if type(second_moment) is not core_tensor.Tensor_fp8_e4m3:
+        raise TypeError
+    core_tensor.quantized_adam_step_async(num_iter, block, beta1, beta2, \
+            eps, lr, weight_decay, decoupled, grad, first_moment, \
+            first_scale, second_moment, second_scale, p)
+
 def fused_adamw_step(p: Tensor, grad: Tensor, first_moment: Tensor, second_moment: Tensor,
                    lr: float, eps: float, beta1: float, beta2: float, weight_decay: float, num_iter: int):
     if type(p) is not type(grad):
@@ -809,6 +1738,42 @@ def fused_adamw_step(p: Tensor, grad: Tensor, first_moment: Tensor, second_momen
     else:
         raise TypeError
 
+# Fused Adam or AdamW step for many parameters, that groups their tiles into
+# tasks of at most max_nelems elements
+def fused_multi_adam_step(p: List[Tensor], grad: List[Tensor], \
+        first_moment: List[Tensor], second_moment: List[Tensor], lr: float, \
+        eps: float, beta1: float, beta2: float, weight_decay: float, \
+        num_iter: int, decoupled: bool=False, max_nelems: int=1048576, \
+        scalars: TensorOrNone=None):
+    if len(p) == 0:
+        return
+    for t in grad+first_moment+second_moment+p:
+        if type(t) is not type(p[0]):
+            raise TypeError
+    if scalars is not None:
+        if type(scalars) is not type(p[0]):
+            raise TypeError
+        if type(p[0]) is core_tensor.Tensor_fp32:
+            core_tensor.multi_adam_step_scaled_async_fp32(num_iter, beta1, \
+                    beta2, eps, weight_decay, decoupled, grad, \
+                    first_moment, second_moment, p, scalars, max_nelems)
+        elif type(p[0]) is core_tensor.Tensor_fp64:
+            core_tensor.multi_adam_step_scaled_async_fp64(num_iter, beta1, \
+                    beta2, eps, weight_decay, decoupled, grad, \
+                    first_moment, second_moment, p, scalars, max_nelems)
+        else:
+            raise TypeError
+    elif type(p[0]) is core_tensor.Tensor_fp32:
+        core_tensor.multi_adam_step_async_fp32(num_iter, beta1, beta2, eps, \
+                lr, weight_decay, decoupled, grad, first_moment, \
+                second_moment, p, max_nelems)
+    elif type(p[0]) is core_tensor.Tensor_fp64:
+        core_tensor.multi_adam_step_async_fp64(num_iter, beta1, beta2, eps, \
+                lr, weight_decay, decoupled, grad, first_moment, \
+                second_moment, p, max_nelems)
+    else:
+        raise TypeError
+
 # Wrapper for multiprecision transpose
 def transpose_async(alpha: float, src: Tensor, dst: Tensor, ndim: int) -> None:
     if type(src) is not type(dst):
@@ -820,6 +1785,35 @@ def transpose_async(alpha: float, src: Tensor, dst: Tensor, ndim: int) -> None:
     else:
         raise TypeError
 
+# Wrapper for multiprecision permutation of axes, axis i of dst is axis
+# perm[i] of src as in numpy.transpose
+def permute_async(src: Tensor, dst: Tensor, perm: List[int]) -> None:
+    if type(src) is not type(dst):
+        raise TypeError
+    if type(src) is core_tensor.Tensor_fp32:
+        core_tensor.permute_async_fp32(src, dst, perm)
+    elif type(src) is core_tensor.Tensor_fp64:
+        core_tensor.permute_async_fp64(src, dst, perm)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision contraction c = alpha*contract(a,b) + beta*c,
+# described by subscripts like "ik,kj->ij" over axes of tensors. It is done
+# by a single gemm, and only operands, that do not fit layouts of gemm, are
+# permuted into temporary tensors. Returns next tag after the temporaries.
+def contract_async(alpha: float, a: Tensor, b: Tensor, beta: float, \
+        c: Tensor, subscripts: str, next_tag: int, redux: int=0) -> int:
+    if type(a) is not type(b) or type(a) is not type(c):
+        raise TypeError
+    if type(a) is core_tensor.Tensor_fp32:
+        return core_tensor.contract_async_fp32(alpha, a, b, beta, c, \
+                subscripts, next_tag, redux)
+    elif type(a) is core_tensor.Tensor_fp64:
+        return core_tensor.contract_async_fp64(alpha, a, b, beta, c, \
+                subscripts, next_tag, redux)
+    else:
+        raise TypeError
+
 # Wrapper for multiprecision conv2d
 def conv2d_async(src: Tensor, kernel: Tensor, dst: Tensor) -> None:
     if type(dst) is not type(src):
@@ -828,14 +1822,46 @@ def conv2d_async(src: Tensor, kernel: Tensor, dst: Tensor) -> None:
         raise TypeError
     if type(dst) is core_tensor.Tensor_fp32:
         core_tensor.conv2d_async_fp32(src, kernel, dst)
-    elif type(x) is core_tensor.Tensor_fp64:
+    elif type(dst) is core_tensor.Tensor_fp64:
         core_tensor.conv2d_async_fp64(src, kernel, dst)
     else:
         raise TypeError
 
-# Wrapper for multiprecision strassen
-def gemm_async(alpha: float, trans_A: TransOp, A: Tensor, trans_B: TransOp, \
-        B: Tensor, beta: float, C: Tensor, ndim: int, \
+# Wrapper for multiprecision gradient of conv2d over its input
+def conv2d_backward_input_async(dst_grad: Tensor, kernel: Tensor, \
+        src_grad: Tensor) -> None:
+    if type(src_grad) is not type(dst_grad):
+        raise TypeError
+    if type(src_grad) is not type(kernel):
+        raise TypeError
+    if type(src_grad) is core_tensor.Tensor_fp32:
+        core_tensor.conv2d_backward_input_async_fp32(dst_grad, kernel, \
+                src_grad)
+    elif type(src_grad) is core_tensor.Tensor_fp64:
+        core_tensor.conv2d_backward_input_async_fp64(dst_grad, kernel, \
+                src_grad)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision gradient of conv2d over its kernel
+def conv2d_backward_weight_async(src: Tensor, dst_grad: Tensor, \
+        kernel_grad: Tensor) -> None:
+    if type(kernel_grad) is not type(src):
+        raise TypeError
+    if type(kernel_grad) is not type(dst_grad):
+        raise TypeError
+    if type(kernel_grad) is core_tensor.Tensor_fp32:
+        core_tensor.conv2d_backward_weight_async_fp32(src, dst_grad, \
+                kernel_grad)
+    elif type(kernel_grad) is core_tensor.Tensor_fp64:
+        core_tensor.conv2d_backward_weight_async_fp64(src, dst_grad, \
+                kernel_grad)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision strassen over grids of tiles
+def strassen_async(alpha: float, trans_A: TransOp, A: Tensor, \
+        trans_B: TransOp, B: Tensor, beta: float, C: Tensor, ndim: int, \
         batch_ndim: int, redux: int=0) -> None:
     if type(A) is not type(B) or type(A) is not type(C):
         raise TypeError
@@ -845,8 +1871,27 @@ def gemm_async(alpha: float, trans_A: TransOp, A: Tensor, trans_B: TransOp, \
     elif type(A) is core_tensor.Tensor_fp64:
         core_tensor.strassen_async_fp64(alpha, trans_A, A, trans_B, B, beta, C,
                 ndim, batch_ndim, redux)
-    elif type(A) is core_tensor.Tensor_fp16:
-        core_tensor.strassen_async_fp16(alpha, trans_A, A, trans_B, B, beta, C,
-                ndim, batch_ndim, redux)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision future of values of tensors
+def await_tensor(x: Union[Tensor, List[Tensor]]) -> core_tensor.TensorFuture:
+    if type(x) is list:
+        if len(x) == 0:
+            return core_tensor.TensorFuture()
+        if type(x[0]) is core_tensor.Tensor_fp32:
+            return core_tensor.await_tensors_fp32(x)
+        elif type(x[0]) is core_tensor.Tensor_fp64:
+            return core_tensor.await_tensors_fp64(x)
+        else:
+            raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        return core_tensor.await_tensor_fp32(x)
+    elif type(x) is core_tensor.Tensor_fp64:
+        return core_tensor.await_tensor_fp64(x)
+    elif type(x) is core_tensor.Tensor_int64:
+        return core_tensor.await_tensor_int64(x)
+    elif type(x) is core_tensor.Tensor_bool:
+        return core_tensor.await_tensor_bool(x)
     else:
         raise TypeError
@@ -0,0 +1,402 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/torch_fx.py
+# Import of PyTorch models traced by torch.fx into fused NNTile layers
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+"""Import of PyTorch models traced by torch.fx into fused NNTile layers
+
+Unlike from_torch methods of models, that load parameters into hand-written
+NNTile models of a known architecture, from_torch_fx traces an arbitrary
+torch.nn.Module by torch.fx and maps nodes of the graph one by one to NNTile
+layers. Neighbouring nodes are fused into a single layer, if NNTile has a
+fused kernel for them:
+
+    * nn.Linear with bias followed by GELU with tanh approximation becomes
+      Linear with activation "gelutanh" (gemm_bias_gelutanh),
+    * residual add followed by nn.LayerNorm becomes AddLayerNorm, that
+      keeps the sum as its output for other users of the add,
+    * the last nn.Linear without bias, followed by the cross-entropy loss,
+      becomes LinearCrossEntropy, that never materializes logits.
+
+Tiles of all the dimensions are chosen automatically by pick_tile, so that
+no dimension has tiles larger than max_tile.
+
+NNTile tensors are stored in the Fortran order with features in the first
+dimensions, so every tensor of the imported model has the shape of the
+corresponding PyTorch tensor, reversed. Supported nodes are nn.Linear,
+nn.LayerNorm, nn.ReLU, nn.GELU, nn.Dropout, nn.Identity, their functional
+variants F.relu and F.gelu, additions of two tensors and reshapes of
+matrices [batch, features], that do not change them (like flatten). Other
+nodes raise NotImplementedError.
+"""
+
+import operator
+from typing import Dict, List, Optional, Tuple
+
+import numpy as np
+import torch
+import torch.fx
+import torch.nn as nn
+import torch.nn.functional as F
+
+import nntile
+from nntile.tensor import TensorTraits, TensorMoments, notrans
+from nntile.layer import Linear, Act, LayerNorm, AddLayerNorm, Dropout, \
+        LinearCrossEntropy
+from nntile.layer.add import Add
+from nntile.loss import CrossEntropy
+from nntile.model.base_model import BaseModel
+
+def pick_tile(dim: int, max_tile: int) -> int:
+    """Tile size of a dimension, that does not exceed max_tile
+
+    The largest divisor of the dimension is taken, unless it is less than
+    half of max_tile, in which case max_tile is taken and the last tile is
+    smaller than the others.
+    """
+    if max_tile <= 0:
+        raise ValueError("max_tile shall be positive")
+    if dim <= max_tile:
+        return dim
+    for tile in range(max_tile, max_tile//2, -1):
+        if dim % tile == 0:
+            return tile
+    return max_tile
+
+class FXModel(BaseModel):
+    """Model of NNTile layers, imported from a traced PyTorch model
+
+    Attribute plan lists the execution plan as pairs of names of fused nodes
+    of the graph and the NNTile layer, that computes them, in the order of
+    layers. Attribute loss is the loss of the model, that is either the
+    fused head (the last layer), a separate loss or None. Attribute output
+    is the output of the model, that is None for the fused head.
+    """
+    plan: List[Tuple[List[str], str]]
+    loss: Optional[object]
+    output: Optional[TensorMoments]
+    next_tag: int
+
+    def __init__(self, activations: List[TensorMoments], layers: List, \
+            plan: List[Tuple[List[str], str]], loss: Optional[object], \
+            output: Optional[TensorMoments], next_tag: int):
+        super().__init__(activations, layers)
+        self.plan = plan
+        self.loss = loss
+        self.output = output
+        self.next_tag = next_tag
+
+    def print_plan(self):
+        """Print the execution plan with fused nodes of each layer"""
+        for i, (nodes, layer) in enumerate(self.plan):
+            print("{}: {} <- {}".format(i, layer, ", ".join(nodes)))
+
+    def unregister(self, wait: bool=False):
+        if self.loss is not None and self.loss not in self.layers:
+            self.loss.unregister()
+        super().unregister(wait)
+
+class _Importer:
+    """Walk over nodes of a traced graph in topological order"""
+    def __init__(self, torch_model: nn.Module, next_tag: int, \
+            tensor_type, loss: Optional[str], fuse: bool, max_tile: int, \
+            batch_tile: Optional[int], redux: bool, seed: int):
+        if loss not in (None, "crossentropy"):
+            raise ValueError("loss shall be either None or 'crossentropy'")
+        self.gm = torch.fx.symbolic_trace(torch_model)
+        self.modules = dict(self.gm.named_modules())
+        self.next_tag = next_tag
+        self.tensor_type = tensor_type
+        self.loss_name = loss
+        self.fuse = fuse
+        self.max_tile = max_tile
+        self.batch_tile = batch_tile
+        self.redux = redux
+        self.seed = seed
+        # Activation of every computed node, None for non-tensor values
+        self.env: Dict[torch.fx.Node, Optional[TensorMoments]] = {}
+        self.activations = []
+        self.layers = []
+        self.plan = []
+        self.loss = None
+        self.output = None
+
+    def _module(self, node: torch.fx.Node) -> Optional[nn.Module]:
+        if node.op == "call_module":
+            return self.modules[node.target]
+        return None
+
+    def _input(self, node) -> TensorMoments:
+        if not isinstance(node, torch.fx.Node) or self.env.get(node) is None:
+            raise NotImplementedError("Argument {} is not a tensor" \
+                    .format(node))
+        return self.env[node]
+
+    def _append(self, layer, nodes: List[torch.fx.Node], name: str):
+        self.layers.append(layer)
+        self.activations.extend(layer.activations_output)
+        self.plan.append(([n.name for n in nodes], name))
+
+    # Name of NNTile activation, computed by a node, or None
+    def _activation(self, node: torch.fx.Node) -> Optional[str]:
+        module = self._module(node)
+        if isinstance(module, nn.ReLU):
+            return "relu"
+        if isinstance(module, nn.GELU):
+            return "gelutanh" if module.approximate == "tanh" else "gelu"
+        if node.op == "call_function":
+            if node.target in (F.relu, torch.relu):
+                return "relu"
+            if node.target is F.gelu:
+                if node.kwargs.get("approximate", "none") == "tanh":
+                    return "gelutanh"
+                return "gelu"
+        if node.op == "call_method" and node.target == "relu":
+            return "relu"
+        return None
+
+    # Check if a node is a sum of two tensors
+    def _is_add(self, node: torch.fx.Node) -> bool:
+        is_add = (node.op == "call_function" and node.target in \
+                (operator.add, torch.add)) or (node.op == "call_method" \
+                and node.target == "add")
+        return is_add and len(node.args) == 2 and len(node.kwargs) == 0 \
+                and all(isinstance(a, torch.fx.Node) for a in node.args)
+
+    # Check if a node is a reshape, that keeps a matrix [batch, features]
+    def _is_reshape(self, node: torch.fx.Node) -> bool:
+        if isinstance(self._module(node), (nn.Flatten, nn.Identity)):
+            return True
+        if node.op == "call_function" and node.target in (torch.flatten, \
+                torch.reshape):
+            return True
+        return node.op == "call_method" and node.target in ("view", \
+                "reshape", "flatten", "contiguous")
+
+    def _basetile(self, shape: List[int]) -> List[int]:
+        basetile = [pick_tile(dim, self.max_tile) for dim in shape]
+        if self.batch_tile is not None and len(shape) > 1:
+            basetile[-1] = min(shape[-1], self.batch_tile)
+        return basetile
+
+    def placeholder(self, node: torch.fx.Node, input_shape: List[int]):
+        if self.activations:
+            raise NotImplementedError("Only models with a single input are " \
+                    "supported")
+        shape = list(reversed(input_shape))
+        traits = TensorTraits(shape, self._basetile(shape))
+        distr = [0] * traits.grid.nelems
+        x_value = self.tensor_type(traits, distr, self.next_tag)
+        self.next_tag = x_value.next_tag
+        x = TensorMoments(x_value, None, False)
+        self.activations.append(x)
+        self.env[node] = x
+
+    def linear(self, node: torch.fx.Node, module: nn.Linear):
+        x = self._input(node.args[0])
+        if x.value.shape[0] != module.in_features:
+            raise ValueError("Wrong number of features of input of {}" \
+                    .format(node.name))
+        weight = module.weight.detach().cpu().numpy()
+        bias = module.bias is not None
+        out_features = module.out_features
+        out_tile = pick_tile(out_features, self.max_tile)
+        users = list(node.users)
+        # The last linear layer without bias is fused with the loss
+        if self.fuse and self.loss_name == "crossentropy" and not bias \
+                and len(users) == 1 and users[0].op == "output" \
+                and users[0].args[0] is node:
+            layer, self.next_tag = LinearCrossEntropy.generate_simple(x, \
+                    out_features, out_tile, self.next_tag, redux=self.redux)
+            start = 0
+            for w in layer.w:
+                end = start + w.value.shape[0]
+                w.value.from_array(weight[start:end])
+                start = end
+            self._append(layer, [node], "LinearCrossEntropy")
+            self.loss = layer
+            self.env[node] = None
+            return
+        # Bias and activation are fused into gemm
+        activation = None
+        if self.fuse and bias and len(users) == 1 \
+                and self._activation(users[0]) == "gelutanh":
+            activation = "gelutanh"
+        layer, self.next_tag = Linear.generate_simple(x, "R", notrans, 1, \
+                [out_features], [out_tile], self.next_tag, bias, \
+                redux=self.redux, activation=activation)
+        layer.w.value.from_array(weight)
+        if bias:
+            layer.b.value.from_array(module.bias.detach().cpu().numpy())
+        if activation is None:
+            self._append(layer, [node], "Linear")
+            self.env[node] = layer.y
+        else:
+            self._append(layer, [node, users[0]], \
+                    "Linear(activation={})".format(activation))
+            self.env[node] = layer.y_pre
+            self.env[users[0]] = layer.y
+
+    # Set gamma and beta of a normalization from a PyTorch layer
+    @staticmethod
+    def _load_norm(norm: LayerNorm, module: nn.LayerNorm):
+        n = norm.gamma.value.shape[0]
+        if module.elementwise_affine:
+            norm.gamma.value.from_array(module.weight.detach().cpu().numpy())
+            if module.bias is not None:
+                norm.beta.value.from_array( \
+                        module.bias.detach().cpu().numpy())
+            else:
+                norm.beta.value.from_array(np.zeros(n))
+        else:
+            norm.gamma.value.from_array(np.ones(n))
+            norm.beta.value.from_array(np.zeros(n))
+
+    @staticmethod
+    def _check_norm(node: torch.fx.Node, module: nn.LayerNorm, \
+            x: TensorMoments):
+        if len(module.normalized_shape) != 1 \
+                or module.normalized_shape[0] != x.value.shape[0]:
+            raise NotImplementedError("Normalization {} shall be over the " \
+                    "last dimension only".format(node.name))
+
+    def layer_norm(self, node: torch.fx.Node, module: nn.LayerNorm):
+        x = self._input(node.args[0])
+        self._check_norm(node, module, x)
+        layer, self.next_tag = LayerNorm.generate_simple(x, 0, module.eps, \
+                self.next_tag, redux=self.redux)
+        self._load_norm(layer, module)
+        self._append(layer, [node], "LayerNorm")
+        self.env[node] = layer.y
+
+    def add(self, node: torch.fx.Node):
+        x = self._input(node.args[0])
+        r = self._input(node.args[1])
+        if x.value.shape != r.value.shape:
+            raise NotImplementedError("Broadcasting in {} is not supported" \
+                    .format(node.name))
+        # Residual sum followed by a normalization, other users of the sum
+        # use the sum, that is an output of the fused layer
+        norm_node = None
+        if self.fuse:
+            for user in node.users:
+                module = self._module(user)
+                if isinstance(module, nn.LayerNorm) \
+                        and user.args[0] is node:
+                    norm_node = user
+                    break
+        if norm_node is not None:
+            module = self._module(norm_node)
+            self._check_norm(norm_node, module, x)
+            layer, self.next_tag = AddLayerNorm.generate_simple(x, r, 0, \
+                    module.eps, self.next_tag, redux=self.redux)
+            self._load_norm(layer.norm, module)
+            self._append(layer, [node, norm_node], "AddLayerNorm")
+            self.env[node] = layer.res
+            self.env[norm_node] = layer.y
+            return
+        layer, self.next_tag = Add.generate_simple(x, r, self.next_tag)
+        self._append(layer, [node], "Add")
+        self.env[node] = layer.res
+
+    def act(self, node: torch.fx.Node, funcname: str):
+        x = self._input(node.args[0])
+        layer, self.next_tag = Act.generate_simple(x, funcname, \
+                self.next_tag)
+        self._append(layer, [node], "Act({})".format(funcname))
+        self.env[node] = layer.y
+
+    def dropout(self, node: torch.fx.Node, module: nn.Dropout):
+        x = self._input(node.args[0])
+        if module.p == 0:
+            self.env[node] = x
+            return
+        layer, self.next_tag = Dropout.generate_simple(x, module.p, \
+                self.seed+len(self.layers), self.next_tag)
+        self._append(layer, [node], "Dropout")
+        self.env[node] = layer.y
+
+    def reshape(self, node: torch.fx.Node):
+        x = self._input(node.args[0])
+        identity = isinstance(self._module(node), nn.Identity) \
+                or node.target == "contiguous"
+        if not identity and len(x.value.shape) != 2:
+            raise NotImplementedError("Reshape {} of a tensor, that is not " \
+                    "a matrix, is not supported".format(node.name))
+        self.env[node] = x
+
+    def run(self, input_shape: List[int]) -> FXModel:
+        for node in self.gm.graph.nodes:
+            # Node was computed by a fused layer
+            if node in self.env:
+                continue
+            module = self._module(node)
+            if node.op == "placeholder":
+                self.placeholder(node, input_shape)
+            elif node.op == "output":
+                out = node.args[0]
+                if self.loss is None:
+                    self.output = self._input(out)
+            elif isinstance(module, nn.Linear):
+                self.linear(node, module)
+            elif isinstance(module, nn.LayerNorm):
+                self.layer_norm(node, module)
+            elif isinstance(module, nn.Dropout):
+                self.dropout(node, module)
+            elif self._activation(node) is not None:
+                self.act(node, self._activation(node))
+            elif self._is_add(node):
+                self.add(node)
+            elif self._is_reshape(node):
+                self.reshape(node)
+            elif node.op == "call_method" and node.target == "size":
+                # Sizes are used only by reshapes, that keep the matrix
+                self.env[node] = None
+            else:
+                raise NotImplementedError("Node {} ({} {}) is not supported" \
+                        .format(node.name, node.op, node.target))
+        if self.loss is None and self.loss_name == "crossentropy":
+            self.loss, self.next_tag = CrossEntropy.generate_simple( \
+                    self.output, self.next_tag, redux=self.redux)
+        return FXModel(self.activations, self.layers, self.plan, self.loss, \
+                self.output, self.next_tag)
+
+def from_torch_fx(torch_model: nn.Module, input_shape: List[int], \
+        next_tag: int, tensor_type=nntile.tensor.Tensor_fp32, \
+        loss: Optional[str]=None, fuse: bool=True, max_tile: int=1024, \
+        batch_tile: Optional[int]=None, redux: bool=False, seed: int=0) \
+        -> Tuple[FXModel, int]:
+    """Import a PyTorch model into NNTile layers through torch.fx
+
+    Parameters:
+        torch_model: PyTorch model with a single input, that is traced by
+            torch.fx.symbolic_trace
+        input_shape: Shape of the input of the PyTorch model, e.g., [batch,
+            features]. Input of the imported model has the reversed shape.
+        next_tag: Next unused MPI tag
+        tensor_type: Type of NNTile tensors
+        loss: "crossentropy" appends the cross-entropy loss over the first
+            dimension of the output, that is fused with the last linear
+            layer if possible. None does not append any loss.
+        fuse: Whether to fuse neighbouring nodes into fused layers
+        max_tile: Maximal tile size of every dimension
+        batch_tile: Tile size of the last (batch) dimension, that overrides
+            max_tile
+        redux: Whether to use reductions in layers
+        seed: Seed of the first dropout layer
+
+    Returns the imported model, that already holds the parameters of the
+    PyTorch model, and the next unused MPI tag.
+    """
+    importer = _Importer(torch_model, next_tag, tensor_type, loss, fuse, \
+            max_tile, batch_tile, redux, seed)
+    model = importer.run(list(input_shape))
+    return model, model.next_tag
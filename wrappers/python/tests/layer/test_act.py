@@ -102,10 +102,53 @@ def helper(dtype: np.dtype):
     print("Finish checking {}".format(Act.activations.keys()))
     assert True
 
+# In-place activations overwrite their input
+def helper_inplace(dtype: np.dtype):
+    A_shape = [4, 5, 6]
+    A_traits = nntile.tensor.TensorTraits(A_shape, A_shape)
+    next_tag = 0
+    A = Tensor[dtype](A_traits, [0], next_tag)
+    next_tag = A.next_tag
+    A_grad = Tensor[dtype](A_traits, [0], next_tag)
+    next_tag = A_grad.next_tag
+    A_moments = nntile.tensor.TensorMoments(A, A_grad, True)
+    np_A = np.array(np.random.randn(*A_shape), dtype=dtype, order='F')
+    np_B = np.zeros_like(np_A)
+    for funcname in Act.activations:
+        A.from_array(np_A)
+        nntile.tensor.clear_async(A_grad)
+        layer, next_tag = Act.generate_simple(A_moments, funcname, \
+                next_tag, inplace=True)
+        assert layer.y.value is A
+        layer.forward_async()
+        A.to_array(np_B)
+        if funcname == "relu":
+            np_C = np.maximum(np_A, 0)
+        elif funcname == "gelu":
+            np_C = F.gelu(torch.from_numpy(np_A)).numpy()
+        elif funcname == "gelutanh":
+            np_C = F.gelu(torch.from_numpy(np_A), approximate="tanh").numpy()
+        assert np.allclose(np_B, np_C)
+        layer.y.grad.from_array(2*np_A)
+        # Only ReLU is differentiated through its output
+        if funcname != "relu":
+            try:
+                layer.backward_async()
+                assert False
+            except RuntimeError:
+                pass
+        else:
+            layer.backward_async()
+            layer.x.grad.to_array(np_B)
+            assert (np_B == np.where(np_A > 0, 2*np_A, 0)).all()
+        layer.y.grad.unregister()
+    A_moments.unregister()
+
 # Test runner for different precisions
 def test():
     for dtype in dtypes:
         helper(dtype)
+        helper_inplace(dtype)
 
 # Repeat tests
 def test_repeat():
@@ -0,0 +1,90 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/layer/test_add_layer_norm.py
+# Test for nntile.layer.AddLayerNorm against PyTorch
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+import torch
+import nntile
+import numpy as np
+from nntile.tensor import TensorTraits, TensorMoments
+
+# Set up StarPU+MPI and init codelets
+config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+next_tag = 0
+
+def new_moments(traits):
+    global next_tag
+    distr = [0] * traits.grid.nelems
+    value = nntile.tensor.Tensor_fp32(traits, distr, next_tag)
+    next_tag = value.next_tag
+    grad = nntile.tensor.Tensor_fp32(traits, distr, next_tag)
+    next_tag = grad.next_tag
+    return TensorMoments(value, grad, True)
+
+def to_numpy(tensor):
+    res = np.zeros(tensor.shape, order="F", dtype=np.float32)
+    tensor.to_array(res)
+    return res
+
+def run(fused):
+    global next_tag
+    torch.manual_seed(0)
+    eps = 1e-5
+    traits = TensorTraits([8, 6, 2], [8, 3, 1])
+    x = new_moments(traits)
+    r = new_moments(traits)
+    layer, next_tag = nntile.layer.AddLayerNorm.generate_simple(x, r, 0, \
+            eps, next_tag, fused=fused)
+    assert layer.fused_backward == fused
+    x_torch = torch.randn(traits.shape, requires_grad=True)
+    r_torch = torch.randn(traits.shape, requires_grad=True)
+    norm_torch = torch.nn.LayerNorm(traits.shape[0], eps=eps)
+    with torch.no_grad():
+        norm_torch.weight.copy_(torch.randn(traits.shape[0]))
+        norm_torch.bias.copy_(torch.randn(traits.shape[0]))
+    x.value.from_array(np.asfortranarray(x_torch.detach().numpy()))
+    r.value.from_array(np.asfortranarray(r_torch.detach().numpy()))
+    layer.gamma.value.from_array(norm_torch.weight.detach().numpy())
+    layer.beta.value.from_array(norm_torch.bias.detach().numpy())
+    for t in [x, r, layer.gamma, layer.beta]:
+        nntile.tensor.clear_async(t.grad)
+    # The residual sum also gets a gradient from the next residual connection
+    dres_torch = torch.randn(traits.shape)
+    dy_torch = torch.randn(traits.shape)
+    layer.res.grad.from_array(np.asfortranarray(dres_torch.numpy()))
+    layer.y.grad.from_array(np.asfortranarray(dy_torch.numpy()))
+    layer.forward_async()
+    layer.backward_async()
+    res_torch = x_torch + r_torch
+    y_torch = norm_torch(res_torch.permute(1, 2, 0)).permute(2, 0, 1)
+    (torch.sum(res_torch*dres_torch) + torch.sum(y_torch*dy_torch)) \
+            .backward()
+    pairs = [(layer.res.value, res_torch.detach()), \
+            (layer.y.value, y_torch.detach()), (x.grad, x_torch.grad), \
+            (r.grad, r_torch.grad), \
+            (layer.gamma.grad, norm_torch.weight.grad), \
+            (layer.beta.grad, norm_torch.bias.grad)]
+    for t, t_torch in pairs:
+        t_ref = t_torch.numpy()
+        assert np.linalg.norm(to_numpy(t)-t_ref) \
+                <= 1e-5 * np.linalg.norm(t_ref)
+    layer.unregister()
+    x.unregister()
+    r.unregister()
+
+def test_add_layer_norm():
+    run(True)
+    run(False)
+
+if __name__ == "__main__":
+    test_add_layer_norm()
+
@@ -257,11 +257,174 @@ def helper(dtype: np.dtype):
     layer.unregister()
     return True
 
+# Helper function checks incremental decoding with KV-cache against a causal
+# forward pass over the whole sequence. Options of KV-cache, e.g., its type,
+# are passed to the decoding layer, tol is the relative error of outputs.
+def helper_kv_cache(dtype: np.dtype, tol: float=1e-4, **kwargs):
+    n_emb = 32
+    n_seq = 16
+    n_seq_tile = 8
+    n_batch = 3
+    n_head = 4
+    n_head_tile = 2
+    next_tag = 0
+    # Full sequence with a causal mask
+    X_shape = [n_emb, n_seq, n_batch]
+    X_traits = nntile.tensor.TensorTraits(X_shape, [n_emb, n_seq_tile, \
+            n_batch])
+    X_distr = [0] * X_traits.grid.nelems
+    X_value = Tensor[dtype](X_traits, X_distr, next_tag)
+    next_tag = X_value.next_tag
+    X_grad = Tensor[dtype](X_traits, X_distr, next_tag)
+    next_tag = X_grad.next_tag
+    np_X = np.array(np.random.randn(*X_shape), dtype=dtype, order='F')
+    X_value.from_array(np_X)
+    X = nntile.tensor.TensorMoments(X_value, X_grad, True)
+    mask_traits = nntile.tensor.TensorTraits([n_seq, n_seq], [n_seq_tile, \
+            n_seq_tile])
+    mask = nntile.tensor.Tensor_bool(mask_traits, \
+            [0]*mask_traits.grid.nelems, next_tag)
+    next_tag = mask.next_tag
+    mask.from_array(np.array(np.triu(np.ones((n_seq, n_seq))), \
+            dtype=bool, order='F'))
+    layer, next_tag = Attention.generate_simple(X, X, X, n_head, \
+            n_head_tile, next_tag, True, mask)
+    for p in layer.parameters:
+        p.value.from_array(np.array(np.random.randn(*p.value.shape), \
+                dtype=dtype, order='F'))
+    layer.forward_async()
+    np_Y = np.zeros(layer.y.value.shape, dtype=dtype, order='F')
+    layer.y.value.to_array(np_Y)
+    # A single new token per step
+    X1_shape = [n_emb, 1, n_batch]
+    X1_traits = nntile.tensor.TensorTraits(X1_shape, X1_shape)
+    X1_value = Tensor[dtype](X1_traits, [0], next_tag)
+    next_tag = X1_value.next_tag
+    X1_grad = Tensor[dtype](X1_traits, [0], next_tag)
+    next_tag = X1_grad.next_tag
+    X1 = nntile.tensor.TensorMoments(X1_value, X1_grad, True)
+    mask1_traits = nntile.tensor.TensorTraits([n_seq, 1], [n_seq_tile, 1])
+    mask1 = nntile.tensor.Tensor_bool(mask1_traits, \
+            [0]*mask1_traits.grid.nelems, next_tag)
+    next_tag = mask1.next_tag
+    layer1, next_tag = Attention.generate_simple(X1, X1, X1, n_head, \
+            n_head_tile, next_tag, True, mask1, kv_cache_size=n_seq, \
+            kv_cache_size_tile=n_seq_tile, **kwargs)
+    for p, p1 in zip(layer.parameters, layer1.parameters):
+        nntile.tensor.copy_async(p.value, p1.value)
+    layer1.reset_kv_cache_async()
+    np_Y1 = np.zeros(X1_shape, dtype=dtype, order='F')
+    for pos in range(n_seq):
+        layer1.set_kv_cache_pos(pos)
+        X1_value.from_array(np.array(np_X[:, pos:pos+1, :], order='F'))
+        mask1.from_array(np.array(np.triu(np.ones((n_seq, 1)), -pos), \
+                dtype=bool, order='F'))
+        layer1.forward_async()
+        layer1.y.value.to_array(np_Y1)
+        norm = np.linalg.norm(np_Y[:, pos, :])
+        diff = np.linalg.norm(np_Y[:, pos, :] - np_Y1[:, 0, :])
+        if diff > norm*tol:
+            return False
+    # Unregister
+    X.unregister()
+    X1.unregister()
+    mask.unregister()
+    mask1.unregister()
+    layer.unregister()
+    layer1.unregister()
+    return True
+
+# Layer with given options is the same as the default one
+def helper_same(dtype: np.dtype, **kwargs):
+    n_emb = 32
+    n_emb_tile = 16
+    n_seq = 16
+    n_seq_tile = 8
+    n_batch = 3
+    n_head = 4
+    n_head_tile = 2
+    next_tag = 0
+    X_shape = [n_emb, n_seq, n_batch]
+    X_traits = nntile.tensor.TensorTraits(X_shape, [n_emb_tile, n_seq_tile, \
+            n_batch])
+    X_distr = [0] * X_traits.grid.nelems
+    X = []
+    for i in range(2):
+        X_value = Tensor[dtype](X_traits, X_distr, next_tag)
+        next_tag = X_value.next_tag
+        X_grad = Tensor[dtype](X_traits, X_distr, next_tag)
+        next_tag = X_grad.next_tag
+        X.append(nntile.tensor.TensorMoments(X_value, X_grad, True))
+    np_X = np.array(np.random.randn(*X_shape), dtype=dtype, order='F')
+    np_dY = np.array(np.random.randn(*X_shape), dtype=dtype, order='F')
+    mask_traits = nntile.tensor.TensorTraits([n_seq, n_seq], [n_seq_tile, \
+            n_seq_tile])
+    mask = nntile.tensor.Tensor_bool(mask_traits, \
+            [0]*mask_traits.grid.nelems, next_tag)
+    next_tag = mask.next_tag
+    mask.from_array(np.array(np.triu(np.ones((n_seq, n_seq))), \
+            dtype=bool, order='F'))
+    layers = []
+    for i in range(2):
+        layer, next_tag = Attention.generate_simple(X[i], X[i], X[i], \
+                n_head, n_head_tile, next_tag, True, mask, \
+                **(kwargs if i == 1 else {}))
+        layers.append(layer)
+        X[i].value.from_array(np_X)
+        nntile.tensor.clear_async(X[i].grad)
+        layer.y.grad.from_array(np_dY)
+    for p, p1 in zip(layers[0].parameters, layers[1].parameters):
+        np_p = np.array(np.random.randn(*p.value.shape), dtype=dtype, \
+                order='F')
+        p.value.from_array(np_p)
+        p1.value.from_array(np_p)
+        nntile.tensor.clear_async(p.grad)
+        nntile.tensor.clear_async(p1.grad)
+    for layer in layers:
+        layer.forward_async()
+        layer.backward_async()
+    # Compare outputs and gradients
+    for t, t1 in zip([layers[0].y.value, X[0].grad] + [p.grad for p in \
+            layers[0].parameters], [layers[1].y.value, X[1].grad] + \
+            [p.grad for p in layers[1].parameters]):
+        np_t = np.zeros(t.shape, dtype=dtype, order='F')
+        t.to_array(np_t)
+        np_t1 = np.zeros(t1.shape, dtype=dtype, order='F')
+        t1.to_array(np_t1)
+        if np.linalg.norm(np_t1-np_t) > 1e-5*np.linalg.norm(np_t):
+            return False
+    # Unregister
+    for i in range(2):
+        X[i].unregister()
+        layers[i].unregister()
+    mask.unregister()
+    return True
+
 # Test runner for different precisions
 def test():
     for dtype in dtypes:
         assert helper(dtype)
 
+# Test incremental decoding with KV-cache
+def test_kv_cache():
+    for dtype in dtypes:
+        assert helper_kv_cache(dtype)
+
+# Test incremental decoding with 8-bit KV-cache
+def test_kv_cache_quantized():
+    assert helper_kv_cache(np.float32, 2e-2, kv_cache_dtype="int8")
+    assert helper_kv_cache(np.float32, 1e-1, kv_cache_dtype="fp8_e4m3")
+
+# Test packed projections of queries, keys and values
+def test_packed():
+    for dtype in dtypes:
+        assert helper_same(dtype, packed_qkv=True)
+
+# Test fused attention, that does not store attention weights
+def test_fused():
+    for dtype in dtypes:
+        assert helper_same(dtype, fused=True)
+
 # Repeat tests
 def test_repeat():
     for dtype in dtypes:
@@ -270,4 +433,8 @@ def test_repeat():
 if __name__ == "__main__":
     test()
     test_repeat()
+    test_kv_cache()
+    test_kv_cache_quantized()
+    test_packed()
+    test_fused()
 
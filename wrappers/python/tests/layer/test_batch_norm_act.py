@@ -0,0 +1,132 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/layer/test_batch_norm_act.py
+# Test for nntile.layer.BatchNormAct
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+# All necesary imports
+import nntile
+import numpy as np
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+# Define list of tested types
+dtypes = [np.float32, np.float64]
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+# Get BatchNorm1d from PyTorch
+import torch
+from torch.nn import BatchNorm1d, ReLU, GELU, Identity
+torch_act = {None: Identity, "relu": ReLU, \
+        "gelutanh": lambda: GELU(approximate="tanh")}
+
+def rel_error(a, b):
+    return np.linalg.norm(a-b) / np.linalg.norm(b)
+
+# Helper function returns bool value true if test passes
+def helper(dtype: np.dtype, funcname):
+    # Features are the first axis of X, as in outputs of Linear with side 'R'
+    n_in, n_feat, n_batch = 5, 8, 30
+    eps = 1e-5
+    momentum = 0.1
+    tol = 1e-5 if dtype == np.float32 else 1e-10
+    next_tag = 0
+    # Input of a linear layer
+    X_traits = nntile.tensor.TensorTraits([n_in, n_batch], [n_in, 10])
+    X = Tensor[dtype](X_traits, [0]*X_traits.grid.nelems, next_tag)
+    next_tag = X.next_tag
+    X = nntile.tensor.TensorMoments(X, None, False)
+    np_X = np.array(np.random.randn(n_in, n_batch), dtype=dtype, order='F')
+    X.value.from_array(np_X)
+    linear, next_tag = nntile.layer.Linear.generate_simple(X, 'R', \
+            nntile.tensor.notrans, 1, [n_feat], [4], next_tag, bias=False)
+    np_W = np.array(np.random.randn(n_feat, n_in), dtype=dtype, order='F')
+    linear.w.value.from_array(np_W)
+    # Init NNTile BatchNormAct over output of the linear layer
+    layer, next_tag = nntile.layer.BatchNormAct.generate_simple(linear.y, 0, \
+            funcname, next_tag, eps=eps, momentum=momentum)
+    np_gamma = np.array(np.random.randn(n_feat), dtype=dtype, order='F')
+    np_beta = np.array(np.random.randn(n_feat), dtype=dtype, order='F')
+    layer.gamma.value.from_array(np_gamma)
+    layer.beta.value.from_array(np_beta)
+    # Init PyTorch BatchNorm1d with the same parameters
+    torch_layer = BatchNorm1d(n_feat, eps=eps, momentum=momentum, \
+            dtype=torch.float64)
+    torch_layer.weight.data = torch.tensor(np_gamma, dtype=torch.float64)
+    torch_layer.bias.data = torch.tensor(np_beta, dtype=torch.float64)
+    act = torch_act[funcname]()
+    # Forward in training mode
+    linear.forward_async()
+    np_A = np.zeros((n_feat, n_batch), dtype=dtype, order='F')
+    linear.y.value.to_array(np_A)
+    layer.forward_async()
+    np_Y = np.zeros_like(np_A)
+    layer.y.value.to_array(np_Y)
+    torch_A = torch.tensor(np_A.T, dtype=torch.float64, requires_grad=True)
+    torch_Y = act(torch_layer(torch_A))
+    np_Y_torch = torch_Y.data.numpy().T
+    assert rel_error(np_Y, np_Y_torch) < tol
+    # Running statistics
+    np_mean = np.zeros(n_feat, dtype=dtype)
+    layer.running_mean.to_array(np_mean)
+    np_var = np.zeros(n_feat, dtype=dtype)
+    layer.running_var.to_array(np_var)
+    assert rel_error(np_mean, torch_layer.running_mean.numpy()) < tol
+    assert rel_error(np_var, torch_layer.running_var.numpy()) < tol
+    # Backward in training mode
+    np_Y_grad = np.array(np.random.randn(n_feat, n_batch), dtype=dtype, \
+            order='F')
+    layer.y.grad.from_array(np_Y_grad)
+    nntile.tensor.clear_async(layer.x.grad)
+    nntile.tensor.clear_async(layer.gamma.grad)
+    nntile.tensor.clear_async(layer.beta.grad)
+    layer.backward_async()
+    np_A_grad = np.zeros_like(np_A)
+    layer.x.grad.to_array(np_A_grad)
+    np_gamma_grad = np.zeros_like(np_gamma)
+    layer.gamma.grad.to_array(np_gamma_grad)
+    np_beta_grad = np.zeros_like(np_beta)
+    layer.beta.grad.to_array(np_beta_grad)
+    (torch_Y*torch.tensor(np_Y_grad.T, dtype=torch.float64)).sum().backward()
+    assert rel_error(np_A_grad, torch_A.grad.numpy().T) < tol
+    assert rel_error(np_gamma_grad, torch_layer.weight.grad.numpy()) < tol
+    assert rel_error(np_beta_grad, torch_layer.bias.grad.numpy()) < tol
+    # Forward in inference mode uses running statistics
+    layer.training = False
+    torch_layer.eval()
+    layer.forward_async()
+    layer.y.value.to_array(np_Y)
+    np_Y_torch = act(torch_layer(torch_A)).data.numpy().T
+    assert rel_error(np_Y, np_Y_torch) < tol
+    # Folding into the linear layer does not change inference
+    next_tag = layer.fold_async(linear, next_tag)
+    assert layer.folded and linear.b is not None
+    linear.forward_async()
+    layer.forward_async()
+    layer.y.value.to_array(np_Y)
+    assert rel_error(np_Y, np_Y_torch) < tol
+    # Unregister tensors
+    linear.unregister()
+    layer.unregister()
+    X.unregister()
+    linear.y.unregister()
+    layer.y.unregister()
+    return True
+
+# Test runner for different precisions and activations
+def test():
+    for dtype in dtypes:
+        for funcname in [None, "relu", "gelutanh"]:
+            assert helper(dtype, funcname)
+
+if __name__ == "__main__":
+    test()
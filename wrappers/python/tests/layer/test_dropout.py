@@ -0,0 +1,108 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/layer/test_dropout.py
+# Test for nntile.layer.Dropout
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-15
+
+# All necesary imports
+import nntile
+import numpy as np
+
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+# Define list of tested types
+dtypes = [np.float32, np.float64]
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+# Get multiprecision dropout layer
+Dropout = nntile.layer.Dropout
+
+# Helper function returns bool value true if test passes
+def helper(dtype: np.dtype, p: float):
+    if dtype == np.float32:
+        tol = 1e-6
+    else:
+        tol = 1e-12
+    shape = [40, 50, 30]
+    basetile = [20, 25, 30]
+    traits = nntile.tensor.TensorTraits(shape, basetile)
+    distr = [0] * traits.grid.nelems
+    next_tag = 0
+    x = Tensor[dtype](traits, distr, next_tag)
+    next_tag = x.next_tag
+    x_grad = Tensor[dtype](traits, distr, next_tag)
+    next_tag = x_grad.next_tag
+    x_moments = nntile.tensor.TensorMoments(x, x_grad, True)
+    layer, next_tag = Dropout.generate_simple(x_moments, p, 123, next_tag)
+    x_np = np.array(np.random.rand(*shape)+1, dtype=dtype, order="F")
+    dy_np = np.array(np.random.randn(*shape), dtype=dtype, order="F")
+    y_np = np.zeros_like(x_np)
+    dx_np = np.zeros_like(x_np)
+    # Forward pass
+    x.from_array(x_np)
+    layer.forward_async()
+    layer.y.value.to_array(y_np)
+    keep = y_np != 0
+    # Recomputation of forward, e.g., by checkpointing, gives the same mask
+    layer.forward_async()
+    y2_np = np.zeros_like(x_np)
+    layer.y.value.to_array(y2_np)
+    same_mask = (y2_np == y_np).all()
+    # Backward regenerates the mask of forward
+    nntile.tensor.clear_async(x_grad)
+    layer.y.grad.from_array(dy_np)
+    layer.backward_async()
+    x_grad.to_array(dx_np)
+    # The next step uses another mask
+    layer.forward_async()
+    layer.y.value.to_array(y2_np)
+    keep2 = y2_np != 0
+    # Evaluation mode does not drop anything
+    layer.training = False
+    layer.forward_async()
+    y3_np = np.zeros_like(x_np)
+    layer.y.value.to_array(y3_np)
+    layer.unregister()
+    layer.y.unregister()
+    x_moments.unregister()
+    if not same_mask:
+        return False
+    scale = 1.0 / (1.0-p)
+    if np.abs(y_np[keep]-scale*x_np[keep]).max() > tol*scale*2:
+        return False
+    nelems = x_np.size
+    if abs(1-keep.mean()-p) > 5*(p*(1-p)/nelems)**0.5:
+        return False
+    if np.abs(dx_np-scale*keep*dy_np).max() > tol*scale*4:
+        return False
+    if p > 0 and (keep == keep2).all():
+        return False
+    if not (y3_np == x_np).all():
+        return False
+    return True
+
+# Test runner for different precisions
+def test():
+    for dtype in dtypes:
+        assert helper(dtype, 0.0)
+        assert helper(dtype, 0.1)
+        assert helper(dtype, 0.5)
+
+# Repeat tests
+def test_repeat():
+    for dtype in dtypes:
+        assert helper(dtype, 0.1)
+
+if __name__ == "__main__":
+    test()
+    test_repeat()
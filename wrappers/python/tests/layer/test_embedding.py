@@ -28,7 +28,7 @@ import torch
 from torch.nn import Embedding
 
 # Helper function returns bool value true if test passes
-def helper(dtype: np.dtype):
+def helper(dtype: np.dtype, sparse_grad: bool=False, vocab_tile: int=None):
     # Describe single-tile tensor, located at node 0
     index_shape = [4, 5, 6]
     vocab_size = 1000
@@ -54,7 +54,8 @@ def helper(dtype: np.dtype):
     # Define NNTile embedding layer
     nntile_layer, next_tag = nntile.layer.Embedding.generate_simple( \
             nntile_index, Tensor[dtype], axis, vocab_size, emb_size, \
-            emb_size_tile, emb_size_tile, next_tag)
+            emb_size_tile, emb_size_tile, next_tag, sparse_grad=sparse_grad, \
+            vocab_tile=vocab_tile)
     nntile_layer.w.value.from_array(np_vocab)
     # Define PyTorch embedding layer
     torch_layer = Embedding(vocab_size, emb_size)
@@ -78,12 +79,24 @@ def helper(dtype: np.dtype):
     np_vocab_torch = torch_layer.weight.grad.numpy().T
     assert (np.linalg.norm(np_vocab_torch-np_vocab) \
             / np.linalg.norm(np_vocab_torch) < 1e-6)
+    # Mask of used rows of vocabulary
+    if sparse_grad:
+        np_rows = np.zeros([vocab_size], dtype=bool, order='F')
+        nntile_layer.w.rows.to_array(np_rows)
+        np_rows_ref = np.zeros([vocab_size], dtype=bool)
+        np_rows_ref[np_index.ravel()] = True
+        assert (np_rows == np_rows_ref).all()
+    nntile_layer.unregister()
+    nntile_index.unregister()
     return True
 
 # Test runner for different precisions
 def test():
     for dtype in dtypes:
         assert helper(dtype)
+        assert helper(dtype, sparse_grad=True)
+        # Vocabulary, split into shards
+        assert helper(dtype, vocab_tile=300)
 
 # Repeat tests
 def test_repeat():
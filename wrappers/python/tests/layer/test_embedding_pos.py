@@ -0,0 +1,93 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/layer/test_embedding_pos.py
+# Test for nntile.layer.EmbeddingPos
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+import nntile
+import numpy as np
+from nntile.tensor import TensorTraits
+
+# Set up StarPU+MPI and init codelets
+config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+dtypes = [np.float32, np.float64]
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+next_tag = 0
+
+def helper(dtype: np.dtype, sparse_grad: bool):
+    global next_tag
+    n_seq, n_seq_tile, n_batch, n_batch_tile = 8, 4, 3, 2
+    vocab_size, max_pos, emb_size = 50, 16, 10
+    rng = np.random.default_rng(0)
+    # Tokens of shape (seq, batch) and positions of shape (seq,), that are
+    # repeated over the batch
+    x_traits = TensorTraits([n_seq, n_batch], [n_seq_tile, n_batch_tile])
+    x = nntile.tensor.Tensor_int64(x_traits, [0]*x_traits.grid.nelems, \
+            next_tag)
+    next_tag = x.next_tag
+    pos_traits = TensorTraits([n_seq], [n_seq_tile])
+    pos = nntile.tensor.Tensor_int64(pos_traits, \
+            [0]*pos_traits.grid.nelems, next_tag)
+    next_tag = pos.next_tag
+    np_x = rng.integers(vocab_size, size=(n_seq, n_batch))
+    np_pos = rng.integers(max_pos, size=n_seq)
+    x.from_array(np.asfortranarray(np_x))
+    pos.from_array(np.asfortranarray(np_pos))
+    # Output tiles cover several tiles of vocabularies
+    layer, next_tag = nntile.layer.EmbeddingPos.generate_simple(x, pos, \
+            Tensor[dtype], 0, vocab_size, max_pos, emb_size, 6, 3, \
+            next_tag, sparse_grad=sparse_grad)
+    np_w = np.asfortranarray(rng.standard_normal((emb_size, vocab_size)), \
+            dtype=dtype)
+    np_w_pos = np.asfortranarray(rng.standard_normal((emb_size, max_pos)), \
+            dtype=dtype)
+    layer.w.value.from_array(np_w)
+    layer.w_pos.value.from_array(np_w_pos)
+    layer.forward_async()
+    y = np.zeros(layer.y.value.shape, order="F", dtype=dtype)
+    layer.y.value.to_array(y)
+    y_ref = np_w[:, np_x] + np_w_pos[:, np_pos][:, :, np.newaxis]
+    assert np.allclose(y, y_ref)
+    # Backward accumulates into gradients of both vocabularies
+    np_dy = np.asfortranarray(rng.standard_normal(y.shape), dtype=dtype)
+    layer.y.grad.from_array(np_dy)
+    nntile.tensor.clear_async(layer.w.grad)
+    nntile.tensor.clear_async(layer.w_pos.grad)
+    layer.backward_async()
+    dw_ref = np.zeros_like(np_w)
+    np.add.at(dw_ref.T, np_x.ravel(), np_dy.reshape(emb_size, -1).T)
+    dw_pos_ref = np.zeros_like(np_w_pos)
+    np.add.at(dw_pos_ref.T, np_pos, np_dy.sum(axis=2).T)
+    for t, ref in ((layer.w, dw_ref), (layer.w_pos, dw_pos_ref)):
+        grad = np.zeros(t.grad.shape, order="F", dtype=dtype)
+        t.grad.to_array(grad)
+        assert np.allclose(grad, ref)
+    if sparse_grad:
+        for t, index, size in ((layer.w, np_x, vocab_size), \
+                (layer.w_pos, np_pos, max_pos)):
+            rows = np.zeros([size], order="F", dtype=bool)
+            t.rows.to_array(rows)
+            rows_ref = np.zeros([size], dtype=bool)
+            rows_ref[index.ravel()] = True
+            assert (rows == rows_ref).all()
+    layer.unregister()
+    x.unregister()
+    pos.unregister()
+
+def test_embedding_pos():
+    for dtype in dtypes:
+        helper(dtype, False)
+        helper(dtype, True)
+
+if __name__ == "__main__":
+    test_embedding_pos()
+
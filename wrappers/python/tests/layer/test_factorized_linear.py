@@ -0,0 +1,129 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/layer/test_factorized_linear.py
+# Test for nntile.layer.factorized_linear
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+# All necesary imports
+import nntile
+import numpy as np
+
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+# Define list of tested types
+dtypes = [np.float32, np.float64]
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+tol = {np.float32: 1e-5, np.float64: 1e-10}
+
+def make_input(dtype: np.dtype, shape, tile, next_tag: int):
+    traits = nntile.tensor.TensorTraits(shape, tile)
+    mpi_distr = [0] * traits.grid.nelems
+    X = Tensor[dtype](traits, mpi_distr, next_tag)
+    X_grad = Tensor[dtype](traits, mpi_distr, X.next_tag)
+    np_X = np.array(np.random.randn(*shape), dtype=dtype, order='F')
+    X.from_array(np_X)
+    nntile.tensor.clear_async(X_grad)
+    return nntile.tensor.TensorMoments(X, X_grad, True), np_X, \
+            X_grad.next_tag
+
+def set_random(t):
+    np_t = np.array(np.random.randn(*t.shape), dtype=np.float64, order='F')
+    if type(t) is nntile.tensor.Tensor_fp32:
+        np_t = np.array(np_t, dtype=np.float32, order='F')
+    t.from_array(np_t)
+    return np_t
+
+def get(t, dtype):
+    np_t = np.zeros(t.shape, dtype=dtype, order='F')
+    t.to_array(np_t)
+    return np_t
+
+def close(a, b, dtype) -> bool:
+    return np.linalg.norm(a-b) <= tol[dtype] * np.linalg.norm(a)
+
+def helper_lowrank(dtype: np.dtype, order: str):
+    X, np_X, next_tag = make_input(dtype, [6, 4, 10], [3, 2, 5], 0)
+    layer, next_tag = nntile.layer.LowRankLinear.generate_simple(X, 2, \
+            [7], [4], 3, next_tag, order=order)
+    assert layer.order == order
+    np_U = set_random(layer.u.value)
+    np_V = set_random(layer.v.value)
+    nntile.tensor.clear_async(layer.u.grad)
+    nntile.tensor.clear_async(layer.v.grad)
+    layer.forward_async()
+    np_W = np.tensordot(np_U, np_V, 1)
+    np_Y = np.tensordot(np_W, np_X, 2)
+    assert close(np_Y, get(layer.y.value, dtype), dtype)
+    np_dY = set_random(layer.y.grad)
+    layer.backward_async()
+    np_dW = np.tensordot(np_dY, np_X, [[1], [2]])
+    np_dU = np.tensordot(np_dW, np_V, [[1, 2], [1, 2]])
+    np_dV = np.tensordot(np_U, np_dW, [[0], [0]])
+    np_dX = np.tensordot(np_W, np_dY, [[0], [0]])
+    assert close(np_dU, get(layer.u.grad, dtype), dtype)
+    assert close(np_dV, get(layer.v.grad, dtype), dtype)
+    assert close(np_dX, get(X.grad, dtype), dtype)
+    X.unregister()
+    layer.unregister()
+
+def helper_tt(dtype: np.dtype):
+    X, np_X, next_tag = make_input(dtype, [4, 3, 2, 6], [2, 3, 1, 3], 0)
+    layer, next_tag = nntile.layer.TTLinear.generate_simple(X, [5, 2, 3], \
+            [5, 1, 2], [2, 3], next_tag)
+    np_G = []
+    for g in layer.cores:
+        np_G.append(set_random(g.value))
+        nntile.tensor.clear_async(g.grad)
+    layer.forward_async()
+    # Dense weight of shape [out_1,out_2,out_3,in_1,in_2,in_3]
+    np_W = np.einsum("iar,rjbs,skc->abcijk", *np_G)
+    np_Y = np.tensordot(np_W, np_X, 3)
+    assert close(np_Y, get(layer.y.value, dtype), dtype)
+    np_dY = set_random(layer.y.grad)
+    layer.backward_async()
+    np_dW = np.tensordot(np_dY, np_X, [[3], [3]])
+    np_dG = [np.einsum("abcijk,rjbs,skc->iar", np_dW, np_G[1], np_G[2]), \
+            np.einsum("abcijk,iar,skc->rjbs", np_dW, np_G[0], np_G[2]), \
+            np.einsum("abcijk,iar,rjbs->skc", np_dW, np_G[0], np_G[1])]
+    for g, np_g in zip(layer.cores, np_dG):
+        assert close(np_g, get(g.grad, dtype), dtype)
+    np_dX = np.tensordot(np_W, np_dY, [[0, 1, 2], [0, 1, 2]])
+    assert close(np_dX, get(X.grad, dtype), dtype)
+    X.unregister()
+    layer.unregister()
+
+# Test runner for different precisions
+def test():
+    for dtype in dtypes:
+        helper_lowrank(dtype, "factored")
+        helper_lowrank(dtype, "dense")
+        helper_tt(dtype)
+
+# Choice of order of contractions by cost
+def test_order():
+    cost = nntile.layer.LowRankLinear.cost
+    assert cost(1024, 1024, 4096, 16, "factored") \
+            < cost(1024, 1024, 4096, 16, "dense")
+    assert cost(8, 8, 4096, 64, "dense") < cost(8, 8, 4096, 64, "factored")
+
+# Repeat tests
+def test_repeat():
+    for dtype in dtypes:
+        helper_lowrank(dtype, "factored")
+        helper_tt(dtype)
+
+if __name__ == "__main__":
+    test()
+    test_order()
+    test_repeat()
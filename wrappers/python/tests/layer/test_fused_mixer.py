@@ -0,0 +1,101 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/layer/test_fused_mixer.py
+# Test for nntile.layer.FusedMixer
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+# All necesary imports
+import nntile
+import numpy as np
+import torch
+import torch.nn.functional as F
+
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+# Define list of tested types
+dtypes = [np.float32, np.float64]
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+tol = {np.float32: 1e-5, np.float64: 1e-10}
+
+def set_random(t):
+    np_t = np.array(np.random.randn(*t.shape), dtype=np.float64, order='F')
+    if type(t) is nntile.tensor.Tensor_fp32:
+        np_t = np.array(np_t, dtype=np.float32, order='F')
+    t.from_array(np_t)
+    return np_t
+
+def get(t, dtype):
+    np_t = np.zeros(t.shape, dtype=dtype, order='F')
+    t.to_array(np_t)
+    return np_t
+
+def close(a, b, dtype) -> bool:
+    return np.linalg.norm(a-b) <= tol[dtype] * np.linalg.norm(a)
+
+# Token-mixing MLP contracts the first axis, channel-mixing MLP contracts
+# the last one
+def torch_mlp(x, w1, b1, w2, b2, side):
+    if side == 'R':
+        h = torch.tensordot(w1, x, 1) + b1[:, None, None]
+        h = F.gelu(h, approximate="tanh")
+        return torch.tensordot(w2, h, 1) + b2[:, None, None]
+    h = F.gelu(torch.tensordot(x, w1, 1) + b1, approximate="tanh")
+    return torch.tensordot(h, w2, 1) + b2
+
+def helper(dtype: np.dtype):
+    # Patches, batch and channels
+    shape = [4, 3, 6]
+    traits = nntile.tensor.TensorTraits(shape, shape)
+    mpi_distr = [0]
+    X = Tensor[dtype](traits, mpi_distr, 0)
+    X_grad = Tensor[dtype](traits, mpi_distr, X.next_tag)
+    next_tag = X_grad.next_tag
+    X_moments = nntile.tensor.TensorMoments(X, X_grad, True)
+    layer, next_tag = nntile.layer.FusedMixer.generate_simple(X_moments, \
+            next_tag)
+    np_X = set_random(X)
+    np_params = [set_random(p.value) for p in layer.parameters]
+    layer.clear_gradients()
+    layer.forward_async()
+    np_dY = set_random(layer.y.grad)
+    layer.backward_async()
+    # Reference with the same order of parameters: norm_1, mlp_1, add_norm
+    # and mlp_2
+    x = torch.tensor(np_X, requires_grad=True)
+    p = [torch.tensor(t, requires_grad=True) for t in np_params]
+    h = F.layer_norm(x, [shape[2]], p[0], p[1], eps=1e-5)
+    res = x + torch_mlp(h, *p[2:6], 'R')
+    h = F.layer_norm(res, [shape[2]], p[6], p[7], eps=1e-5)
+    y = res + torch_mlp(h, *p[8:12], 'L')
+    y.backward(torch.tensor(np_dY))
+    assert close(y.detach().numpy(), get(layer.y.value, dtype), dtype)
+    assert close(x.grad.numpy(), get(X_grad, dtype), dtype)
+    for t, t_torch in zip(layer.parameters, p):
+        assert close(t_torch.grad.numpy(), get(t.grad, dtype), dtype)
+    X_moments.unregister()
+    layer.unregister()
+
+# Test runner for different precisions
+def test():
+    for dtype in dtypes:
+        helper(dtype)
+
+# Repeat tests
+def test_repeat():
+    for dtype in dtypes:
+        helper(dtype)
+
+if __name__ == "__main__":
+    test()
+    test_repeat()
@@ -49,8 +49,8 @@ def helper(dtype: np.dtype):
 
     torch_data = torch.from_numpy(np_A)
     torch_output = torch_data.mean(dim=(0))
+    # Output of GAP is not transposed
     np_Y = np.array(torch_output.detach().numpy(), order="F", dtype=dtype)
-    np_Y = np_Y.transpose()
 
     np_Y2 = np.zeros_like(np_Y, order='F')
     layer.y.value.to_array(np_Y2)
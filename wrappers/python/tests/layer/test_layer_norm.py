@@ -9,7 +9,7 @@
 #
 # @version 1.0.0
 # @author Aleksandr Mikhalev
-# @date 2023-09-12
+# @date 2024-02-05
 
 # All necesary imports
 import nntile
@@ -28,7 +28,7 @@ import torch
 from torch.nn import LayerNorm
 
 # Helper function returns bool value true if test passes
-def helper(dtype: np.dtype):
+def helper(dtype: np.dtype, fused: bool):
     # Describe single-tile tensor, located at node 0
     A_shape = [20, 30]
     ndim = len(A_shape)
@@ -55,7 +55,7 @@ def helper(dtype: np.dtype):
     np_beta = np.array(rand_beta, dtype=dtype, order='F')
     # Init NNTile LayerNorm
     nntile_layer, next_tag = nntile.layer.LayerNorm.generate_simple(A, \
-            ndim-1, eps, next_tag)
+            ndim-1, eps, next_tag, fused=fused)
     nntile_layer.gamma.value.from_array(np_gamma)
     nntile_layer.beta.value.from_array(np_beta)
     # Init PyTorch LayerNorm
@@ -109,12 +109,14 @@ def helper(dtype: np.dtype):
 # Test runner for different precisions
 def test():
     for dtype in dtypes:
-        assert helper(dtype)
+        assert helper(dtype, True)
+        assert helper(dtype, False)
 
 # Repeat tests
 def test_repeat():
     for dtype in dtypes:
-        assert helper(dtype)
+        assert helper(dtype, True)
+        assert helper(dtype, False)
 
 if __name__ == "__main__":
     test()
@@ -387,6 +387,70 @@ def helper_torch_r(x_shape, w_shape, b_shape, n_contracted_dim):
     return True
 
 
+def helper_torch_gelutanh(side, x_shape, w_shape, b_shape, \
+        n_contracted_dim):
+    '''
+    y = gelutanh(x @ w + b) for side L and y = gelutanh(w @ x + b) for side R
+    '''
+    w_torch = torch.randn(w_shape, requires_grad=True)
+    b_torch = torch.randn(b_shape, requires_grad=True)
+    x_torch = torch.randn(x_shape, requires_grad=True)
+    if side == 'L':
+        y_torch = torch.tensordot(x_torch, w_torch, n_contracted_dim) \
+                + b_torch
+        add_shape = [*w_shape[n_contracted_dim:]]
+    else:
+        y_torch = torch.tensordot(w_torch, x_torch, n_contracted_dim) \
+                + b_torch.view(*b_torch.shape, \
+                *([1]*(len(x_shape)-n_contracted_dim)))
+        add_shape = [*w_shape[:-n_contracted_dim]]
+    y_torch = nn.functional.gelu(y_torch, approximate="tanh")
+    y_grad_torch = torch.randn(y_torch.shape)
+    y_torch.backward(y_grad_torch)
+    A_traits = nntile.tensor.TensorTraits(x_torch.shape, x_torch.shape)
+    mpi_distr = [0]
+    next_tag = 0
+    # Tensor objects
+    A = Tensor[np.float32](A_traits, mpi_distr, next_tag)
+    next_tag = A.next_tag
+    A_grad = Tensor[np.float32](A_traits, mpi_distr, next_tag)
+    next_tag = A_grad.next_tag
+    A_moments = nntile.tensor.TensorMoments(A, A_grad, True)
+    # Define linear layer with fused activation
+    layer, next_tag = Linear.generate_simple(A_moments, side, \
+            nntile.tensor.notrans, n_contracted_dim, add_shape, add_shape, \
+            next_tag, bias=True, activation='gelutanh')
+    np_W = np.array(w_torch.detach().numpy(), dtype=np.float32, order='F')
+    layer.w.value.from_array(np_W)
+    np_b = np.array(b_torch.detach().numpy(), dtype=np.float32, order='F')
+    layer.b.value.from_array(np_b)
+    nntile.tensor.clear_async(layer.w.grad)
+    nntile.tensor.clear_async(layer.b.grad)
+    np_A = np.array(x_torch.detach().numpy(), dtype=np.float32, order='F')
+    A.from_array(np_A)
+    nntile.tensor.clear_async(A_grad)
+    layer.forward_async()
+    layer.y.grad.from_array(np.array(y_grad_torch.numpy(), order="F", \
+            dtype=np.float32))
+    layer.backward_async()
+    # Compare forward and backward results against PyTorch
+    checks = [(layer.y.value, y_torch), (layer.w.grad, w_torch.grad), \
+            (layer.b.grad, b_torch.grad), (A_grad, x_torch.grad)]
+    for nntile_tensor, torch_tensor in checks:
+        torch_np = torch_tensor.detach().numpy()
+        nntile_np = np.zeros(torch_np.shape, dtype=np.float32, order="F")
+        nntile_tensor.to_array(nntile_np)
+        rel_error = np.linalg.norm(nntile_np-torch_np) \
+                / np.linalg.norm(torch_np)
+        if rel_error > 1e-5:
+            print("Rel error = {}".format(rel_error))
+            A_moments.unregister()
+            layer.unregister()
+            return False
+    A_moments.unregister()
+    layer.unregister()
+    return True
+
 def helper_torch_linear(x_shape, w_shape):
     linear_layer = nn.Linear(*w_shape)
     x_torch = torch.randn(x_shape, requires_grad=True)
@@ -476,12 +540,114 @@ def helper_torch_linear(x_shape, w_shape):
 
     return True
 
+# Helper function returns bool value true if test passes
+def helper_lora(dtype: np.dtype, side: str):
+    x_shape, out_shape, rank, alpha = [6, 4, 3], [5], 2, 4.0
+    if side == 'L':
+        x_shape = x_shape[::-1]
+    x_traits = nntile.tensor.TensorTraits(x_shape, x_shape)
+    mpi_distr = [0]
+    next_tag = 0
+    x = Tensor[dtype](x_traits, mpi_distr, next_tag)
+    next_tag = x.next_tag
+    x_grad = Tensor[dtype](x_traits, mpi_distr, next_tag)
+    next_tag = x_grad.next_tag
+    x_moments = nntile.tensor.TensorMoments(x, x_grad, True)
+    layer, next_tag = Linear.generate_simple(x_moments, side, \
+            nntile.tensor.notrans, 1, out_shape, out_shape, next_tag, \
+            bias=True)
+    np_W = np.array(np.random.randn(*layer.w.value.shape), dtype=dtype, \
+            order='F')
+    layer.w.value.from_array(np_W)
+    np_b = np.array(np.random.randn(*out_shape), dtype=dtype, order='F')
+    layer.b.value.from_array(np_b)
+    next_tag = layer.add_lora(rank, next_tag, alpha)
+    # Weights and bias are frozen and adapters are trainable
+    assert not layer.w.grad_required and not layer.b.grad_required
+    assert layer.parameters[-2:] == [layer.lora_a, layer.lora_b]
+    # B is zero after initialization, so it is reset to check the update
+    np_A = np.zeros(layer.lora_a.value.shape, dtype=dtype, order='F')
+    layer.lora_a.value.to_array(np_A)
+    np_B = np.array(np.random.randn(*layer.lora_b.value.shape), \
+            dtype=dtype, order='F')
+    layer.lora_b.value.from_array(np_B)
+    nntile.tensor.clear_async(layer.lora_a.grad)
+    nntile.tensor.clear_async(layer.lora_b.grad)
+    np_X = np.array(np.random.randn(*x_shape), dtype=dtype, order='F')
+    x.from_array(np_X)
+    nntile.tensor.clear_async(x_grad)
+    layer.forward_async()
+    np_dY = np.array(np.random.randn(*layer.y.value.shape), dtype=dtype, \
+            order='F')
+    layer.y.grad.from_array(np_dY)
+    layer.backward_async()
+    # Reference by PyTorch
+    X, W, b, A, B, dY = (torch.tensor(t) for t in (np_X, np_W, np_b, np_A, \
+            np_B, np_dY))
+    X.requires_grad_()
+    A.requires_grad_()
+    B.requires_grad_()
+    if side == 'L':
+        Y = X @ W + b + alpha/rank * (X @ A @ B)
+    else:
+        Y = torch.einsum("ij,jkl->ikl", W, X) + b[:, None, None] \
+                + alpha/rank * torch.einsum("ij,jkl->ikl", B @ A, X)
+    Y.backward(dY)
+    def check(t, t_torch):
+        ref = t_torch.detach().numpy()
+        val = np.zeros(ref.shape, dtype=dtype, order='F')
+        t.to_array(val)
+        return np.linalg.norm(val-ref) <= 1e-5*np.linalg.norm(ref)
+    ok = check(layer.y.value, Y) and check(x_grad, X.grad) \
+            and check(layer.lora_a.grad, A.grad) \
+            and check(layer.lora_b.grad, B.grad)
+    # Merged adapters give the same output
+    layer.merge_lora()
+    layer.forward_async()
+    if not ok or not check(layer.y.value, Y):
+        x_moments.unregister()
+        layer.unregister()
+        return False
+    x_moments.unregister()
+    layer.unregister()
+    return True
+
+# Helper function returns bool value true if test passes
+def helper_lora_model(dtype: np.dtype):
+    # Two layers with adapters of the same shape
+    x_shape, rank = [5, 3], 2
+    x_traits = nntile.tensor.TensorTraits(x_shape, x_shape)
+    mpi_distr = [0]
+    next_tag = 0
+    x = Tensor[dtype](x_traits, mpi_distr, next_tag)
+    next_tag = x.next_tag
+    x_moments = nntile.tensor.TensorMoments(x, None, False)
+    layer1, next_tag = Linear.generate_simple(x_moments, 'R', \
+            nntile.tensor.notrans, 1, [5], [5], next_tag)
+    layer2, next_tag = Linear.generate_simple(layer1.y, 'R', \
+            nntile.tensor.notrans, 1, [5], [5], next_tag)
+    model = nntile.model.BaseModel([x_moments, layer1.y, layer2.y], \
+            [layer1, layer2])
+    next_tag = model.add_lora(rank, next_tag)
+    np_A = []
+    for layer in (layer1, layer2):
+        val = np.zeros(layer.lora_a.value.shape, dtype=dtype, order='F')
+        layer.lora_a.value.to_array(val)
+        np_A.append(val)
+    # Adapters are randomly initialized independently
+    ok = np_A[0].shape == np_A[1].shape and (np_A[0] != np_A[1]).any()
+    # Model unregisters its activations, including the input
+    model.unregister()
+    return ok
 
 # Test runner for different precisions
 def test():
     for dtype in dtypes:
         assert helper_l(dtype)
         assert helper_r(dtype)
+        assert helper_lora(dtype, 'L')
+        assert helper_lora(dtype, 'R')
+        assert helper_lora_model(dtype)
     #assert helper_l_fp32_fast_fp16()
 
 # Repeat tests
@@ -518,6 +684,12 @@ def test_repeat():
 
     assert helper_torch_linear(x_shape=[64, 100], w_shape=[100, 10])
     assert helper_torch_linear(x_shape=[64, 128, 100], w_shape=[100, 20])
+    assert helper_torch_gelutanh('L', x_shape=[20, 10, 5],
+                                 w_shape=[10, 5, 7], b_shape=[7],
+                                 n_contracted_dim=2)
+    assert helper_torch_gelutanh('R', x_shape=[7, 3, 10],
+                                 w_shape=[16, 7], b_shape=[16],
+                                 n_contracted_dim=1)
 
 if __name__ == "__main__":
     test()
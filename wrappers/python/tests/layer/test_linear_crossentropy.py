@@ -0,0 +1,118 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/layer/test_linear_crossentropy.py
+# Test for nntile.layer.LinearCrossEntropy
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-15
+
+# All necesary imports
+import nntile
+import numpy as np
+import torch
+import torch.nn as nn
+
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+# Define list of tested types
+dtypes = [np.float32, np.float64]
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+# Get multiprecision fused layer
+LinearCrossEntropy = nntile.layer.LinearCrossEntropy
+
+# Helper function returns bool value true if test passes
+def helper(dtype: np.dtype, vocab_tile: int):
+    embed_dim, seq_len, batch_size, vocab_size = 6, 5, 3, 11
+    x_shape = [embed_dim, seq_len, batch_size]
+    x_basetile = [3, 5, 2]
+    x_traits = nntile.tensor.TensorTraits(x_shape, x_basetile)
+    x_distr = [0] * x_traits.grid.nelems
+    next_tag = 0
+    x = Tensor[dtype](x_traits, x_distr, next_tag)
+    next_tag = x.next_tag
+    x_grad = Tensor[dtype](x_traits, x_distr, next_tag)
+    next_tag = x_grad.next_tag
+    x_moments = nntile.tensor.TensorMoments(x, x_grad, True)
+    scale = 1.0 / (seq_len*batch_size)
+    layer, next_tag = LinearCrossEntropy.generate_simple(x_moments, \
+            vocab_size, vocab_tile, next_tag, scale=scale)
+    assert len(layer.parameters) == (vocab_size+vocab_tile-1) // vocab_tile
+    # Reference by torch
+    x_np = np.random.randn(*x_shape).astype(dtype, order="F")
+    w_np = np.random.randn(vocab_size, embed_dim).astype(dtype, order="F")
+    labels_np = np.random.randint(vocab_size, size=(seq_len, batch_size))
+    x.from_array(x_np)
+    start = 0
+    for w in layer.parameters:
+        end = start + w.value.shape[0]
+        w.value.from_array(np.asfortranarray(w_np[start:end]))
+        start = end
+    layer.y.from_array(np.asfortranarray(labels_np))
+    x_torch = torch.tensor(x_np, requires_grad=True)
+    w_torch = torch.tensor(w_np, requires_grad=True)
+    logits = torch.einsum("ve,esb->sbv", w_torch, x_torch)
+    loss_torch = nn.functional.cross_entropy(logits.reshape(-1, \
+            vocab_size), torch.tensor(labels_np).reshape(-1))
+    loss_torch.backward()
+    # NNTile computes loss and gradients by the forward pass
+    nntile.tensor.clear_async(x_grad)
+    for w in layer.parameters:
+        nntile.tensor.clear_async(w.grad)
+    nntile.tensor.clear_async(layer.val)
+    layer.forward_async()
+    layer.backward_async()
+    val_np = np.zeros((1,), dtype=dtype, order="F")
+    layer.get_val(val_np)
+    x_grad_np = np.zeros(x_shape, dtype=dtype, order="F")
+    x_grad.to_array(x_grad_np)
+    w_grad_np = np.zeros_like(w_np)
+    start = 0
+    for w in layer.parameters:
+        end = start + w.value.shape[0]
+        w_chunk_np = np.zeros(w.value.shape, dtype=dtype, order="F")
+        w.grad.to_array(w_chunk_np)
+        w_grad_np[start:end] = w_chunk_np
+        start = end
+    layer.unregister()
+    x_moments.unregister()
+    if dtype == np.float32:
+        tol = 1e-5
+    else:
+        tol = 1e-10
+    if abs(val_np[0]-loss_torch.item()) > tol*abs(loss_torch.item()):
+        return False
+    x_grad_ref = x_torch.grad.numpy()
+    if np.linalg.norm(x_grad_np-x_grad_ref) > \
+            tol*np.linalg.norm(x_grad_ref):
+        return False
+    w_grad_ref = w_torch.grad.numpy()
+    if np.linalg.norm(w_grad_np-w_grad_ref) > \
+            tol*np.linalg.norm(w_grad_ref):
+        return False
+    return True
+
+# Test runner for different precisions
+def test():
+    for dtype in dtypes:
+        # Single chunk, chunks of equal sizes and an incomplete last chunk
+        assert helper(dtype, 11)
+        assert helper(dtype, 4)
+        assert helper(dtype, 1)
+
+# Repeat tests
+def test_repeat():
+    for dtype in dtypes:
+        assert helper(dtype, 4)
+
+if __name__ == "__main__":
+    test()
+    test_repeat()
@@ -0,0 +1,100 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/layer/test_moe.py
+# Test for nntile.layer.MoE against PyTorch
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+import torch
+import nntile
+import numpy as np
+from nntile.tensor import TensorTraits, TensorMoments
+
+# Set up StarPU+MPI and init codelets
+config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+next_tag = 0
+
+# Reference with the same priority of choices and the same capacity
+def moe_torch(x, w_gate, w1, w2, top_k, capacity, coef):
+    n_emb, n_tokens = x.shape
+    n_experts = w_gate.shape[0]
+    probs = torch.softmax(w_gate @ x, 0)
+    experts = torch.topk(probs.detach(), top_k, 0).indices
+    count = [0] * n_experts
+    y = torch.zeros_like(x)
+    for j in range(top_k):
+        for t in range(n_tokens):
+            e = int(experts[j, t])
+            if count[e] == capacity:
+                continue
+            count[e] += 1
+            h = torch.nn.functional.gelu(w1[:, :, e] @ x[:, t], \
+                    approximate="tanh")
+            y[:, t] += probs[e, t] * (w2[:, :, e] @ h)
+    load = torch.tensor(count, dtype=x.dtype) / (top_k*n_tokens)
+    aux_loss = coef * n_experts * torch.sum(load * probs.mean(1))
+    return y, aux_loss
+
+def test_moe():
+    global next_tag
+    torch.manual_seed(0)
+    n_emb, n_emb_tile = 8, 4
+    n_inner, n_inner_tile = 12, 6
+    n_seq, n_seq_tile = 6, 3
+    n_batch, n_batch_tile = 2, 1
+    n_experts, top_k, coef = 4, 2, 0.01
+    x_traits = TensorTraits([n_emb, n_seq, n_batch], \
+            [n_emb_tile, n_seq_tile, n_batch_tile])
+    x_distr = [0] * x_traits.grid.nelems
+    x_value = nntile.tensor.Tensor_fp32(x_traits, x_distr, next_tag)
+    next_tag = x_value.next_tag
+    x_grad = nntile.tensor.Tensor_fp32(x_traits, x_distr, next_tag)
+    next_tag = x_grad.next_tag
+    x = TensorMoments(x_value, x_grad, True)
+    # Small capacity factor makes experts drop tokens
+    layer, next_tag = nntile.layer.MoE.generate_simple(x, n_experts, top_k, \
+            n_inner, n_inner_tile, next_tag, capacity_factor=0.75, \
+            aux_loss_coef=coef)
+    x_torch = torch.randn(n_emb, n_seq, n_batch, requires_grad=True)
+    params_torch = [torch.randn(p.value.shape, requires_grad=True) \
+            for p in layer.parameters]
+    x.value.from_array(np.asfortranarray(x_torch.detach().numpy()))
+    for p, p_torch in zip(layer.parameters, params_torch):
+        p.value.from_array(np.asfortranarray(p_torch.detach().numpy()))
+        nntile.tensor.clear_async(p.grad)
+    nntile.tensor.clear_async(x.grad)
+    dy_torch = torch.randn(n_emb, n_seq, n_batch)
+    layer.y.grad.from_array(np.asfortranarray(dy_torch.numpy()))
+    layer.forward_async()
+    layer.backward_async()
+    # Tokens of a batch are routed together in order of their indices
+    # s+n_seq*b in the layout of NNTile
+    x_tokens = x_torch.permute(0, 2, 1).reshape(n_emb, -1)
+    y_torch, aux_torch = moe_torch(x_tokens, *params_torch, top_k, \
+            layer.capacity, coef)
+    y_torch = y_torch.reshape(n_emb, n_batch, n_seq).permute(0, 2, 1)
+    (torch.sum(y_torch*dy_torch) + aux_torch).backward()
+    y = np.zeros(layer.y.value.shape, order="F", dtype=np.float32)
+    layer.y.value.to_array(y)
+    y_ref = y_torch.detach().numpy()
+    assert np.linalg.norm(y-y_ref) <= 1e-5 * np.linalg.norm(y_ref)
+    assert abs(layer.get_aux_loss()-aux_torch.item()) <= 1e-6
+    for t, t_torch in zip([x]+layer.parameters, [x_torch]+params_torch):
+        grad = np.zeros(t.grad.shape, order="F", dtype=np.float32)
+        t.grad.to_array(grad)
+        grad_ref = t_torch.grad.numpy()
+        assert np.linalg.norm(grad-grad_ref) \
+                <= 1e-5 * np.linalg.norm(grad_ref)
+    layer.unregister()
+    x.unregister()
+
+if __name__ == "__main__":
+    test_moe()
+
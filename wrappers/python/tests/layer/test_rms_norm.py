@@ -0,0 +1,80 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/layer/test_rms_norm.py
+# Test for nntile.layer.RMSNorm against PyTorch
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+import torch
+import nntile
+import numpy as np
+from nntile.tensor import TensorTraits, TensorMoments
+
+# Set up StarPU+MPI and init codelets
+config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+next_tag = 0
+
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+
+def to_numpy(tensor, dtype):
+    res = np.zeros(tensor.shape, order="F", dtype=dtype)
+    tensor.to_array(res)
+    return res
+
+def helper(dtype):
+    global next_tag
+    torch.manual_seed(0)
+    eps = 1e-6
+    # Normalized middle axis is not split, other axes are split into tiles
+    traits = TensorTraits([6, 16, 4], [4, 16, 2])
+    distr = [0] * traits.grid.nelems
+    x_value = Tensor[dtype](traits, distr, next_tag)
+    next_tag = x_value.next_tag
+    x_grad = Tensor[dtype](traits, distr, next_tag)
+    next_tag = x_grad.next_tag
+    x = TensorMoments(x_value, x_grad, True)
+    layer, next_tag = nntile.layer.RMSNorm.generate_simple(x, 1, eps, \
+            next_tag)
+    assert layer.fused_backward
+    torch_dtype = torch.float32 if dtype == np.float32 else torch.float64
+    x_torch = torch.randn(traits.shape, dtype=torch_dtype, \
+            requires_grad=True)
+    gamma_torch = torch.randn(traits.shape[1], dtype=torch_dtype, \
+            requires_grad=True)
+    dy_torch = torch.randn(traits.shape, dtype=torch_dtype)
+    x.value.from_array(np.asfortranarray(x_torch.detach().numpy()))
+    layer.gamma.value.from_array(gamma_torch.detach().numpy())
+    layer.y.grad.from_array(np.asfortranarray(dy_torch.numpy()))
+    nntile.tensor.clear_async(x.grad)
+    nntile.tensor.clear_async(layer.gamma.grad)
+    layer.forward_async()
+    layer.backward_async()
+    inv_rms = torch.rsqrt(torch.mean(x_torch**2, 1, keepdim=True)+eps)
+    y_torch = x_torch * inv_rms * gamma_torch.view(1, -1, 1)
+    torch.sum(y_torch*dy_torch).backward()
+    tol = 1e-5 if dtype == np.float32 else 1e-10
+    pairs = [(layer.y.value, y_torch.detach()), (x.grad, x_torch.grad), \
+            (layer.gamma.grad, gamma_torch.grad)]
+    for t, t_torch in pairs:
+        t_ref = t_torch.numpy()
+        assert np.linalg.norm(to_numpy(t, dtype)-t_ref) \
+                <= tol * np.linalg.norm(t_ref)
+    layer.unregister()
+    x.unregister()
+
+def test_rms_norm():
+    for dtype in [np.float32, np.float64]:
+        helper(dtype)
+
+if __name__ == "__main__":
+    test_rms_norm()
+
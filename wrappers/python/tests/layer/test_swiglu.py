@@ -0,0 +1,125 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/layer/test_swiglu.py
+# Test for nntile.layer.SwiGLU and gated GPT2MLP against PyTorch
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+import torch
+import nntile
+import numpy as np
+from nntile.tensor import TensorTraits, TensorMoments
+from nntile.model.gpt2 import GPT2MLP
+
+# Set up StarPU+MPI and init codelets
+config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+next_tag = 0
+
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+
+def to_numpy(tensor, dtype):
+    res = np.zeros(tensor.shape, order="F", dtype=dtype)
+    tensor.to_array(res)
+    return res
+
+def moments(traits, dtype):
+    global next_tag
+    distr = [0] * traits.grid.nelems
+    value = Tensor[dtype](traits, distr, next_tag)
+    next_tag = value.next_tag
+    grad = Tensor[dtype](traits, distr, next_tag)
+    next_tag = grad.next_tag
+    return TensorMoments(value, grad, True)
+
+def helper(dtype):
+    global next_tag
+    torch.manual_seed(0)
+    traits = TensorTraits([6, 8, 4], [4, 3, 2])
+    gate = moments(traits, dtype)
+    up = moments(traits, dtype)
+    layer, next_tag = nntile.layer.SwiGLU.generate_simple(gate, up, next_tag)
+    torch_dtype = torch.float32 if dtype == np.float32 else torch.float64
+    # Gates far below zero saturate the exponent
+    gate_torch = 4 * torch.randn(traits.shape, dtype=torch_dtype)
+    gate_torch[0, 0, 0] = -200
+    gate_torch.requires_grad_()
+    up_torch = torch.randn(traits.shape, dtype=torch_dtype, \
+            requires_grad=True)
+    dy_torch = torch.randn(traits.shape, dtype=torch_dtype)
+    gate.value.from_array(np.asfortranarray(gate_torch.detach().numpy()))
+    up.value.from_array(np.asfortranarray(up_torch.detach().numpy()))
+    layer.y.grad.from_array(np.asfortranarray(dy_torch.numpy()))
+    nntile.tensor.clear_async(gate.grad)
+    nntile.tensor.clear_async(up.grad)
+    layer.forward_async()
+    layer.backward_async()
+    y_torch = torch.nn.functional.silu(gate_torch) * up_torch
+    torch.sum(y_torch*dy_torch).backward()
+    tol = 1e-6 if dtype == np.float32 else 1e-12
+    pairs = [(layer.y.value, y_torch.detach()), \
+            (gate.grad, gate_torch.grad), (up.grad, up_torch.grad)]
+    for t, t_torch in pairs:
+        t_ref = t_torch.numpy()
+        assert np.linalg.norm(to_numpy(t, dtype)-t_ref) \
+                <= tol * np.linalg.norm(t_ref)
+    layer.unregister()
+    gate.unregister()
+    up.unregister()
+
+def test_swiglu():
+    for dtype in [np.float32, np.float64]:
+        helper(dtype)
+
+def test_gated_mlp():
+    global next_tag
+    torch.manual_seed(0)
+    n_emb, n_inner, n_tokens = 8, 12, 10
+    config = {"embed_dim": n_emb, "embed_dim_tile": 4, \
+            "inner_dim": n_inner, "inner_dim_tile": 6, \
+            "activation_function": "swiglu", "redux": False}
+    x = moments(TensorTraits([n_emb, n_tokens], [4, 5]), np.float32)
+    mlp = GPT2MLP(x, config, next_tag)
+    next_tag = mlp.next_tag
+    # Layers of gate, of up-projection, of activation and of output
+    assert len(mlp.layers) == 4
+    x_torch = torch.randn(n_emb, n_tokens, requires_grad=True)
+    params_torch = [torch.randn(p.value.shape, requires_grad=True) \
+            for p in mlp.parameters]
+    x.value.from_array(np.asfortranarray(x_torch.detach().numpy()))
+    for p, p_torch in zip(mlp.parameters, params_torch):
+        p.value.from_array(np.asfortranarray(p_torch.detach().numpy()))
+    mlp.clear_gradients()
+    nntile.tensor.clear_async(x.grad)
+    dy_torch = torch.randn(n_emb, n_tokens)
+    mlp.activations[-1].grad.from_array(np.asfortranarray(dy_torch.numpy()))
+    mlp.forward_async()
+    mlp.backward_async()
+    w_gate, b_gate, w_up, b_up, w_out, b_out = params_torch
+    h = torch.nn.functional.silu(w_gate@x_torch + b_gate.view(-1, 1)) \
+            * (w_up@x_torch + b_up.view(-1, 1))
+    y_torch = w_out@h + b_out.view(-1, 1)
+    torch.sum(y_torch*dy_torch).backward()
+    pairs = [(mlp.activations[-1].value, y_torch.detach()), \
+            (x.grad, x_torch.grad)]
+    pairs.extend((p.grad, p_torch.grad) \
+            for p, p_torch in zip(mlp.parameters, params_torch))
+    for t, t_torch in pairs:
+        t_ref = t_torch.numpy()
+        assert np.linalg.norm(to_numpy(t, np.float32)-t_ref) \
+                <= 1e-5 * np.linalg.norm(t_ref)
+    mlp.unregister()
+    x.unregister()
+
+if __name__ == "__main__":
+    test_swiglu()
+    test_gated_mlp()
+
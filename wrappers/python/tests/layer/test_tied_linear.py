@@ -0,0 +1,73 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/layer/test_tied_linear.py
+# Test for nntile.layer.TiedLinear against PyTorch
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+import torch
+import nntile
+import numpy as np
+from nntile.tensor import TensorTraits
+
+# Set up StarPU+MPI and init codelets
+config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+next_tag = 0
+
+def test_tied_linear():
+    global next_tag
+    torch.manual_seed(0)
+    n_seq, n_seq_tile, n_batch, n_batch_tile = 6, 3, 2, 1
+    vocab_size, n_emb, n_emb_tile = 20, 8, 4
+    x_traits = TensorTraits([n_seq, n_batch], [n_seq_tile, n_batch_tile])
+    x = nntile.tensor.Tensor_int64(x_traits, [0]*x_traits.grid.nelems, \
+            next_tag)
+    next_tag = x.next_tag
+    x_torch = torch.randint(vocab_size, (n_seq, n_batch))
+    x.from_array(np.asfortranarray(x_torch.numpy()))
+    # Head reads the output of the embedding with the same weight
+    emb, next_tag = nntile.layer.Embedding.generate_simple(x, \
+            nntile.tensor.Tensor_fp32, 0, vocab_size, n_emb, n_emb_tile, \
+            n_emb_tile, next_tag)
+    head, next_tag = nntile.layer.TiedLinear.generate_simple(emb.y, emb.w, \
+            next_tag)
+    assert head.parameters == []
+    assert head.y.value.shape == [vocab_size, n_seq, n_batch]
+    w_torch = torch.randn(vocab_size, n_emb, requires_grad=True)
+    emb.w.value.from_array(np.asfortranarray(w_torch.detach().numpy().T))
+    nntile.tensor.clear_async(emb.w.grad)
+    nntile.tensor.clear_async(emb.y.grad)
+    dy_torch = torch.randn(vocab_size, n_seq, n_batch)
+    head.y.grad.from_array(np.asfortranarray(dy_torch.numpy()))
+    emb.forward_async()
+    head.forward_async()
+    head.backward_async()
+    emb.backward_async()
+    # Gradient of the shared weight gets both contributions
+    h = torch.nn.functional.embedding(x_torch, w_torch).permute(2, 0, 1)
+    y_torch = torch.einsum("ve,esb->vsb", w_torch, h)
+    torch.sum(y_torch*dy_torch).backward()
+    y = np.zeros(head.y.value.shape, order="F", dtype=np.float32)
+    head.y.value.to_array(y)
+    y_ref = y_torch.detach().numpy()
+    assert np.linalg.norm(y-y_ref) <= 1e-5 * np.linalg.norm(y_ref)
+    grad = np.zeros(emb.w.grad.shape, order="F", dtype=np.float32)
+    emb.w.grad.to_array(grad)
+    grad_ref = w_torch.grad.numpy().T
+    assert np.linalg.norm(grad-grad_ref) <= 1e-5 * np.linalg.norm(grad_ref)
+    head.unregister()
+    emb.unregister()
+    emb.y.unregister()
+    head.y.unregister()
+    x.unregister()
+
+if __name__ == "__main__":
+    test_tied_linear()
+
@@ -42,8 +42,8 @@ def grad_crossentropy_np(final_layer_output, class_labels):
     return softmax
 
 # Helper function returns bool value true if test passes
-def helper(dtype: np.dtype):
-    # Describe single-tile tensor, located at node 0
+def helper(dtype: np.dtype, nclasses_tile: int=5, batch_size_tile: int=7):
+    # Describe tensor, located at node 0, that can be tiled along classes
     nclasses = 5
     batch_size = 7
     final_layer_output = np.array(np.random.randn(batch_size, nclasses), dtype=dtype, order="F")
@@ -54,8 +54,8 @@ def helper(dtype: np.dtype):
 
     next_tag = 0
     final_layer_output_traits = nntile.tensor.TensorTraits( \
-            [nclasses, batch_size], [nclasses, batch_size])
-    mpi_distr = [0]
+            [nclasses, batch_size], [nclasses_tile, batch_size_tile])
+    mpi_distr = [0] * final_layer_output_traits.grid.nelems
     final_layer_output_tensor = Tensor[dtype](final_layer_output_traits, mpi_distr, next_tag)
     next_tag = final_layer_output_tensor.next_tag
     final_layer_output_tensor.from_array(final_layer_output.T)
@@ -96,6 +96,8 @@ def helper(dtype: np.dtype):
 def test():
     for dtype in dtypes:
         assert helper(dtype)
+        # Chunks of classes and outputs
+        assert helper(dtype, 2, 3)
 
 # Repeat tests
 def test_repeat():
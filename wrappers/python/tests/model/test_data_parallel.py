@@ -0,0 +1,109 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/model/test_data_parallel.py
+# Test for nntile.model.DataParallel
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-09
+
+import torch.nn as nn
+import torch
+import nntile
+import numpy as np
+
+nntile_config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+
+def run_test(input_dim, hidden_dim, n_classes, n_layers, batch_size, \
+        n_replicas, bucket_nelems, checkpoints=[], compression=None):
+    layers = [nn.Linear(input_dim, hidden_dim, bias=True)]
+    layers.extend([nn.Linear(hidden_dim, hidden_dim, bias=True) \
+            for _ in range(n_layers-2)])
+    layers.append(nn.Linear(hidden_dim, n_classes, bias=True))
+    torch_mlp = nn.Sequential(*layers)
+    next_tag = 0
+    # Replicas and a reference model, that processes all inputs one by one
+    models = []
+    losses = []
+    for i in range(n_replicas+1):
+        model, next_tag = nntile.model.DeepReLU.from_torch(torch_mlp, \
+                batch_size, n_classes, "relu", next_tag)
+        model.set_checkpoints(checkpoints)
+        loss, next_tag = nntile.loss.CrossEntropy.generate_simple( \
+                model.activations[-1], next_tag)
+        models.append(model)
+        losses.append(loss)
+    dp_model = nntile.model.DataParallel(models[:-1], \
+            bucket_nelems=bucket_nelems, compression=compression, \
+            next_tag=next_tag)
+    next_tag = dp_model.next_tag
+    ref_model = models[-1]
+    ref_loss = losses[-1]
+    # Replicas start from the same parameters
+    for p in dp_model.replicas[1].parameters:
+        nntile.tensor.clear_async(p.value)
+    dp_model.broadcast_parameters_async()
+    # Data-parallel pass
+    xs = []
+    ys = []
+    dp_model.clear_gradients()
+    for i in range(n_replicas):
+        x_np = np.random.randn(input_dim, batch_size).astype(np.float32, \
+                order="F")
+        y_np = np.random.randint(n_classes, size=batch_size)
+        xs.append(x_np)
+        ys.append(y_np)
+        models[i].activations[0].value.from_array(x_np)
+        losses[i].y.from_array(y_np)
+    dp_model.forward_async()
+    for i in range(n_replicas):
+        losses[i].calc_async()
+    dp_model.backward_async()
+    # Reference accumulates gradients over all inputs
+    ref_model.clear_gradients()
+    for i in range(n_replicas):
+        ref_model.activations[0].value.from_array(xs[i])
+        ref_loss.y.from_array(ys[i])
+        ref_model.forward_async()
+        ref_loss.calc_async()
+        ref_model.backward_async()
+    # Compressed gradients are rounded into half precision
+    rtol = 1e-5 if compression is None else 1e-2
+    for i_param, p_ref in enumerate(ref_model.parameters):
+        ref_np = np.zeros(p_ref.grad.shape, dtype=np.float32, order="F")
+        p_ref.grad.to_array(ref_np)
+        replica_nps = []
+        for model in dp_model.replicas:
+            p = model.parameters[i_param]
+            p_np = np.zeros(p.grad.shape, dtype=np.float32, order="F")
+            p.grad.to_array(p_np)
+            assert np.linalg.norm(p_np-ref_np) <= \
+                    rtol * np.linalg.norm(ref_np)
+            replica_nps.append(p_np)
+        # Replicas get exactly the same gradients
+        for p_np in replica_nps[1:]:
+            assert (p_np == replica_nps[0]).all()
+    for loss in losses:
+        loss.unregister()
+    dp_model.unregister()
+    ref_model.unregister()
+
+if __name__ == "__main__":
+    run_test(input_dim=5, hidden_dim=100, n_classes=10, n_layers=5, \
+            batch_size=8, n_replicas=2, bucket_nelems=1)
+    run_test(input_dim=5, hidden_dim=100, n_classes=10, n_layers=5, \
+            batch_size=8, n_replicas=3, bucket_nelems=20000)
+    # Recomputation of checkpointed activations within data-parallel pass
+    run_test(input_dim=5, hidden_dim=100, n_classes=10, n_layers=5, \
+            batch_size=8, n_replicas=3, bucket_nelems=1, checkpoints=[4])
+    # Gradients are sent in half precision
+    run_test(input_dim=5, hidden_dim=100, n_classes=10, n_layers=5, \
+            batch_size=8, n_replicas=3, bucket_nelems=20000, \
+            compression="bf16")
+    run_test(input_dim=5, hidden_dim=100, n_classes=10, n_layers=5, \
+            batch_size=8, n_replicas=2, bucket_nelems=1, compression="fp16")
@@ -25,7 +25,8 @@ from typing import Dict
 def run_test(input_dim: int, hidden_dim: int, n_classes: int, bias: bool,
              n_layers: int, device: str, lr: float, n_epoch: int,
              optimizer: str, optimizer_params: Dict[str, float],
-             n_samples: int, batch_size: int, minibatch_size: int):
+             n_samples: int, batch_size: int, minibatch_size: int,
+             capture: bool=False, n_sets: int=1):
 
 
 
@@ -123,6 +124,18 @@ def run_test(input_dim: int, hidden_dim: int, n_classes: int, bias: bool,
     # Set up Cross Entropy loss function for the model
     loss, next_tag = nntile.loss.CrossEntropy.generate_simple(nntile_model.activations[-1],
                                                             next_tag)
+    # Extra sets of activations with shared parameters for overlapping
+    # minibatches
+    models = [nntile_model]
+    losses = [loss]
+    for i in range(1, n_sets):
+        model_i, next_tag = nntile.model.DeepReLU.from_torch(init_torch_mlp,
+                minibatch_size, n_classes, "relu", next_tag)
+        model_i.share_parameters(nntile_model)
+        loss_i, next_tag = nntile.loss.CrossEntropy.generate_simple(
+                model_i.activations[-1], next_tag)
+        models.append(model_i)
+        losses.append(loss_i)
     nntile_loss_hist = []
 
     if optimizer == "adam":
@@ -131,8 +144,13 @@ def run_test(input_dim: int, hidden_dim: int, n_classes: int, bias: bool,
         nntile_optimizer = nntile.optimizer.SGD(nntile_model.get_parameters(), lr, next_tag)
     next_tag = nntile_optimizer.get_next_tag()
 
-    pipeline = nntile.pipeline.Pipeline(batch_data, batch_labels, nntile_model, nntile_optimizer,
-                                        loss, n_epoch)
+    if n_sets > 1:
+        pipeline = nntile.pipeline.Pipeline(batch_data, batch_labels, models,
+                nntile_optimizer, losses, n_epoch, capture=capture)
+    else:
+        pipeline = nntile.pipeline.Pipeline(batch_data, batch_labels,
+                nntile_model, nntile_optimizer, loss, n_epoch,
+                capture=capture)
     pipeline.train_async()
 
     nntile.starpu.wait_for_all()
@@ -142,6 +160,11 @@ def run_test(input_dim: int, hidden_dim: int, n_classes: int, bias: bool,
         # print(abs(torch_loss_history[i] - nntile_loss_hist[i]) / torch_loss_history[i])
         assert abs(torch_loss_history[i] - nntile_loss_hist[i]) / torch_loss_history[i] < 1e-6
 
+    for loss_i in losses[1:]:
+        loss_i.unregister()
+    # Unregistering of shared parameters twice is harmless
+    for model_i in models[1:]:
+        model_i.unregister()
     loss.unregister()
     for batch in batch_data + batch_labels:
         for x in batch:
@@ -187,4 +210,20 @@ if __name__ == "__main__":
              n_layers=n_layers, device="cpu", lr=lr,
              n_epoch=n_epoch, optimizer="sgd", optimizer_params={},
              n_samples=n_samples, batch_size=batch_size,
-             minibatch_size=minibatch_size)
\ No newline at end of file
+             minibatch_size=minibatch_size)
+
+    # Replay of captured iterations shall reproduce the same losses
+    run_test(input_dim=input_dim, hidden_dim=hidden_dim,
+             n_classes=n_classes, bias=True,
+             n_layers=n_layers, device="cpu", lr=lr,
+             n_epoch=n_epoch, optimizer="adam", optimizer_params={},
+             n_samples=n_samples, batch_size=batch_size,
+             minibatch_size=minibatch_size, capture=True)
+
+    # Forward of the next minibatch overlaps with backward of the current one
+    run_test(input_dim=input_dim, hidden_dim=hidden_dim,
+             n_classes=n_classes, bias=True,
+             n_layers=n_layers, device="cpu", lr=lr,
+             n_epoch=n_epoch, optimizer="adam", optimizer_params={},
+             n_samples=n_samples, batch_size=batch_size,
+             minibatch_size=minibatch_size, n_sets=2)
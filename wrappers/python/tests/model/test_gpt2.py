@@ -225,7 +225,9 @@ def check_params(model_torch, nntile_model):
                 diff/norm))
 
 def run_test(num_samples, batch_size, minibatch_size, minibatch_size_tile,
-             seq_len_tile, device, optimizer, lr, nepochs):
+             seq_len_tile, device, optimizer, lr, nepochs,
+             checkpoint_blocks=0, tensor_parallel=1, pipeline_parallel=1,
+             cpp_submission=False, plan_memory=False, offload=False):
 
     assert num_samples % batch_size == 0
     assert batch_size % minibatch_size == 0
@@ -271,10 +273,20 @@ def run_test(num_samples, batch_size, minibatch_size, minibatch_size_tile,
         config.n_embd, n_embd_tile, config.max_position_embeddings, \
         config.n_inner, n_inner_tile, config.layer_norm_epsilon, \
         config.num_hidden_layers, config.n_head, n_head_tile, \
-        "gelutanh", nntile_flashattention, nntile_use_redux)
+        "gelutanh", nntile_flashattention, nntile_use_redux, \
+        tensor_parallel=tensor_parallel, pipeline_parallel=pipeline_parallel)
     nntile_model, next_tag = GPT2Model_nntile.from_torch(model_torch, \
             minibatch_size, minibatch_size_tile, config.n_positions, \
             seq_len_tile, nntile_model_config, next_tag)
+    nntile_model.set_block_checkpoints(checkpoint_blocks)
+    nntile_model.set_cpp_submission(cpp_submission)
+    if offload:
+        nntile_model.set_offload(range(len(nntile_model.layers)))
+        assert len(nntile_model.offload_after) > 0
+    if plan_memory:
+        plan = nntile_model.plan_memory()
+        assert plan.nretired > 0
+        assert plan.peak_bytes < plan.total_bytes
     loss, next_tag = nntile.loss.CrossEntropy.generate_simple( \
             nntile_model.activations[-1], next_tag)
 
@@ -378,4 +390,42 @@ if __name__ == "__main__":
             optimizer="sgd", lr=1e-4, nepochs=3)
     run_test(num_samples=8, batch_size=4, minibatch_size=2,
             minibatch_size_tile=2, seq_len_tile=1024, device="cpu",
-            optimizer="sgd", lr=1e-4, nepochs=3)
\ No newline at end of file
+            optimizer="sgd", lr=1e-4, nepochs=3)
+
+    # Recomputation of checkpointed activations shall not change losses
+    run_test(num_samples=8, batch_size=4, minibatch_size=2,
+            minibatch_size_tile=2, seq_len_tile=1024, device="cpu",
+            optimizer="adam", lr=1e-4, nepochs=3, checkpoint_blocks=1)
+
+    # Submission of transformer blocks from C++ shall not change losses
+    run_test(num_samples=8, batch_size=4, minibatch_size=2,
+            minibatch_size_tile=2, seq_len_tile=1024, device="cpu",
+            optimizer="adam", lr=1e-4, nepochs=3, cpp_submission=True)
+    run_test(num_samples=8, batch_size=4, minibatch_size=2,
+            minibatch_size_tile=2, seq_len_tile=1024, device="cpu",
+            optimizer="adam", lr=1e-4, nepochs=3, checkpoint_blocks=1,
+            cpp_submission=True)
+
+    # Tensor and pipeline parallel placement shall not change losses
+    run_test(num_samples=8, batch_size=4, minibatch_size=2,
+            minibatch_size_tile=1, seq_len_tile=1024, device="cpu",
+            optimizer="adam", lr=1e-4, nepochs=3, tensor_parallel=2,
+            pipeline_parallel=2)
+
+    # Retirement of temporaries after their last use shall not change losses
+    run_test(num_samples=8, batch_size=4, minibatch_size=2,
+            minibatch_size_tile=2, seq_len_tile=1024, device="cpu",
+            optimizer="adam", lr=1e-4, nepochs=3, plan_memory=True)
+    run_test(num_samples=8, batch_size=4, minibatch_size=2,
+            minibatch_size_tile=2, seq_len_tile=1024, device="cpu",
+            optimizer="adam", lr=1e-4, nepochs=3, checkpoint_blocks=1,
+            plan_memory=True)
+
+    # Offloading of activations to host memory shall not change losses
+    run_test(num_samples=8, batch_size=4, minibatch_size=2,
+            minibatch_size_tile=2, seq_len_tile=1024, device="cpu",
+            optimizer="adam", lr=1e-4, nepochs=3, offload=True)
+    run_test(num_samples=8, batch_size=4, minibatch_size=2,
+            minibatch_size_tile=2, seq_len_tile=1024, device="cpu",
+            optimizer="adam", lr=1e-4, nepochs=3, checkpoint_blocks=1,
+            offload=True)
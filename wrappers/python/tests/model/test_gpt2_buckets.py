@@ -0,0 +1,136 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/model/test_gpt2_buckets.py
+# Test for GPT2 models of buckets of sequence lengths
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+import torch
+import nntile
+import numpy as np
+from transformers import GPT2LMHeadModel, GPT2Config
+from nntile.model.gpt2 import GPT2Config as GPT2Config_nntile, \
+        GPT2Model as GPT2Model_nntile
+from nntile.bucketing import bucket_sequences
+
+# Set up StarPU+MPI and init codelets
+config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+next_tag = 0
+
+def test_buckets():
+    global next_tag
+    torch.manual_seed(0)
+    config = GPT2Config(vocab_size=64, n_positions=16, n_embd=32, n_layer=2, \
+            n_head=4, n_inner=64, activation_function="gelu_new", \
+            attn_pdrop=0, embd_pdrop=0, resid_pdrop=0)
+    model_torch = GPT2LMHeadModel(config)
+    model_torch.lm_head.weight = torch.nn.Parameter(model_torch.lm_head \
+            .weight.detach().clone())
+    model_torch.eval()
+    nntile_config = GPT2Config_nntile(config.vocab_size, config.n_embd, \
+            config.n_embd, config.n_embd, config.n_positions, \
+            config.n_inner, config.n_inner, config.layer_norm_epsilon, \
+            config.n_layer, config.n_head, config.n_head, "gelutanh", \
+            True, False)
+    model, next_tag = GPT2Model_nntile.from_torch(model_torch, 2, 2, 16, \
+            4, nntile_config, next_tag)
+    buckets, next_tag = model.create_buckets([8, 16], [4, 4], next_tag)
+    assert buckets[1] is model
+    for p, q in zip(buckets[0].parameters, model.parameters):
+        assert p.value is q.value
+    # Documents are cut into rows of bucket lengths
+    rng = np.random.default_rng(0)
+    docs = [rng.integers(config.vocab_size, size=n).tolist() \
+            for n in [9, 20, 12, 30]]
+    minibatches = bucket_sequences(docs, [8, 16], 2)
+    shapes = [x.shape for x, _ in minibatches]
+    assert shapes == [(2, 8), (2, 16)]
+    x, y = minibatches[0]
+    assert (x[:, 1:] == y[:, :-1]).all()
+    # Short bucket gives the same logits as PyTorch
+    bucket = buckets[0]
+    bucket.activations[0].value.from_array(np.asfortranarray(x.T))
+    bucket.forward_async()
+    logits = np.zeros(bucket.activations[-1].value.shape, order="F", \
+            dtype=np.float32)
+    bucket.activations[-1].value.to_array(logits)
+    with torch.no_grad():
+        logits_torch = model_torch(torch.tensor(x))[0].numpy()
+    diff = np.linalg.norm(logits.T - logits_torch)
+    assert diff <= 1e-4 * np.linalg.norm(logits_torch)
+    bucket.unregister()
+    model.unregister()
+
+def test_buckets_pipeline():
+    global next_tag
+    torch.manual_seed(0)
+    config = GPT2Config(vocab_size=64, n_positions=16, n_embd=32, n_layer=2, \
+            n_head=4, n_inner=64, activation_function="gelu_new", \
+            attn_pdrop=0, embd_pdrop=0, resid_pdrop=0)
+    model_torch = GPT2LMHeadModel(config)
+    model_torch.lm_head.weight = torch.nn.Parameter(model_torch.lm_head \
+            .weight.detach().clone())
+    nntile_config = GPT2Config_nntile(config.vocab_size, config.n_embd, \
+            config.n_embd, config.n_embd, config.n_positions, \
+            config.n_inner, config.n_inner, config.layer_norm_epsilon, \
+            config.n_layer, config.n_head, config.n_head, "gelutanh", \
+            True, False)
+    model, next_tag = GPT2Model_nntile.from_torch(model_torch, 2, 2, 16, \
+            4, nntile_config, next_tag)
+    # Two sets of activations for each of two buckets
+    buckets, next_tag = model.create_buckets([8, 16, 8, 16], [4, 4, 4, 4], \
+            next_tag)
+    assert buckets[1] is model
+    assert len(set(id(b) for b in buckets)) == 4
+    losses = []
+    for b in buckets:
+        loss, next_tag = nntile.loss.CrossEntropy.generate_simple( \
+                b.activations[-1], next_tag)
+        losses.append(loss)
+    opt = nntile.optimizer.SGD(model.get_parameters(), 1e-4, next_tag)
+    next_tag = opt.get_next_tag()
+    # A batch alternates sequence lengths of minibatches
+    rng = np.random.default_rng(0)
+    batch_input = []
+    batch_output = []
+    for seq_len in [8, 16, 8, 16]:
+        x_traits = nntile.tensor.TensorTraits([seq_len, 2], [4, 2])
+        x_distr = [0] * x_traits.grid.nelems
+        tokens = rng.integers(config.vocab_size, size=(2, seq_len+1))
+        x = nntile.tensor.Tensor_int64(x_traits, x_distr, next_tag)
+        next_tag = x.next_tag
+        x.from_array(np.asfortranarray(tokens[:, :-1].T))
+        batch_input.append(x)
+        y = nntile.tensor.Tensor_int64(x_traits, x_distr, next_tag)
+        next_tag = y.next_tag
+        y.from_array(np.asfortranarray(tokens[:, 1:].T))
+        batch_output.append(y)
+    pipeline = nntile.pipeline.Pipeline([batch_input], [batch_output], \
+            buckets, opt, losses, 1)
+    pipeline.train_async()
+    nntile.starpu.wait_for_all()
+    # Every set of activations of every bucket processed a minibatch
+    loss_np = np.zeros((1,), dtype=np.float32, order="F")
+    for loss in losses:
+        loss.get_val(loss_np)
+        assert loss_np[0] > 0
+    for loss in losses:
+        loss.unregister()
+    opt.unregister()
+    for x in batch_input+batch_output:
+        x.unregister()
+    for b in buckets:
+        if b is not model:
+            b.unregister()
+    model.unregister()
+
+if __name__ == "__main__":
+    test_buckets()
+    test_buckets_pipeline()
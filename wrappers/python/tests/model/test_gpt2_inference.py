@@ -0,0 +1,214 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/model/test_gpt2_inference.py
+# Test for continuous batching of generation requests of GPT2 model with
+# ring and paged KV-cache and sampling of tokens on the device
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-04
+
+import torch
+import nntile
+import numpy as np
+from transformers import GPT2LMHeadModel, GPT2Config
+from nntile.model.gpt2 import GPT2Config as GPT2Config_nntile, \
+        GPT2Model as GPT2Model_nntile
+from nntile.inference import InferenceEngine, Request, SpeculativeDecoder
+
+# Set up StarPU+MPI and init codelets
+config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+next_tag = 0
+
+# Greedy generation by the PyTorch model without any KV-cache
+def generate_torch(model_torch, prompt, max_new_tokens):
+    tokens = list(prompt)
+    with torch.no_grad():
+        for i in range(max_new_tokens):
+            logits = model_torch(torch.tensor([tokens]))[0]
+            tokens.append(int(logits[0, -1].argmax()))
+    return tokens[len(prompt):]
+
+# Check that generated tokens are among top_k logits of the PyTorch model
+def check_topk(model_torch, request, top_k):
+    tokens = request.prompt + request.tokens
+    with torch.no_grad():
+        logits = model_torch(torch.tensor([tokens]))[0]
+    for i in range(len(request.tokens)):
+        pos = len(request.prompt) + i
+        top = logits[0, pos-1].topk(top_k).indices.tolist()
+        assert tokens[pos] in top
+
+def run_test(kv_cache_pages, temperature=0.0, top_k=1, top_p=1.0, \
+        inference=False):
+    global next_tag
+    torch.manual_seed(0)
+    config = GPT2Config(vocab_size=64, n_positions=32, n_embd=32, n_layer=2, \
+            n_head=4, n_inner=64, activation_function="gelu_new", \
+            attn_pdrop=0, embd_pdrop=0, resid_pdrop=0)
+    model_torch = GPT2LMHeadModel(config)
+    model_torch.lm_head.weight = torch.nn.Parameter(model_torch.lm_head \
+            .weight.detach().clone())
+    model_torch.eval()
+    nntile_config = GPT2Config_nntile(config.vocab_size, config.n_embd, \
+            config.n_embd, config.n_embd, config.n_positions, \
+            config.n_inner, config.n_inner, config.layer_norm_epsilon, \
+            config.n_layer, config.n_head, config.n_head, "gelutanh", \
+            False, False)
+    # Only 2 slots for 5 requests of different lengths
+    n_slots = 2
+    kv_cache_size = 16
+    # Pages of 4 tokens are not enough for 2 longest sequences
+    model, next_tag = GPT2Model_nntile.from_torch(model_torch, n_slots, 1, \
+            1, 1, nntile_config, next_tag, kv_cache_size=kv_cache_size, \
+            kv_cache_size_tile=4 if kv_cache_pages else 8, \
+            kv_cache_per_sequence=True, kv_cache_pages=kv_cache_pages, \
+            inference=inference)
+    if inference:
+        # Neither parameters nor activations have gradients
+        for t in model.parameters + model.activations:
+            assert t.grad is None and not t.grad_required
+    engine = InferenceEngine(model, next_tag, temperature=temperature, \
+            top_k=top_k, top_p=top_p, seed=1)
+    next_tag = engine.next_tag
+    rng = np.random.default_rng(0)
+    requests = [Request(rng.integers(config.vocab_size, size=n).tolist(), \
+            m) for n, m in [(3, 5), (1, 2), (6, 4), (2, 7), (12, 8)]]
+    engine.generate(requests)
+    for request in requests:
+        assert request.done
+        # The last request runs out of the KV-cache
+        max_new_tokens = min(request.max_new_tokens, \
+                kv_cache_size-len(request.prompt)+1)
+        # Greedy choice or sampling within a tiny nucleus
+        if temperature == 0 or top_p < 1e-3:
+            assert request.tokens == generate_torch(model_torch, \
+                    request.prompt, max_new_tokens)
+        else:
+            assert len(request.tokens) == max_new_tokens
+            check_topk(model_torch, request, top_k)
+    engine.unregister()
+    model.unregister()
+
+def test_speculative_decoding():
+    global next_tag
+    torch.manual_seed(0)
+    config = GPT2Config(vocab_size=64, n_positions=32, n_embd=32, n_layer=2, \
+            n_head=4, n_inner=64, activation_function="gelu_new", \
+            attn_pdrop=0, embd_pdrop=0, resid_pdrop=0)
+    draft_config = GPT2Config(vocab_size=64, n_positions=32, n_embd=16, \
+            n_layer=1, n_head=2, n_inner=32, activation_function="gelu_new", \
+            attn_pdrop=0, embd_pdrop=0, resid_pdrop=0)
+    models_torch = []
+    for c in (config, draft_config):
+        m = GPT2LMHeadModel(c)
+        m.lm_head.weight = torch.nn.Parameter(m.lm_head.weight.detach() \
+                .clone())
+        m.eval()
+        models_torch.append(m)
+    model_torch, draft_torch = models_torch
+    kv_cache_size, k = 16, 3
+    def from_torch(m, c, seq_len):
+        global next_tag
+        nntile_config = GPT2Config_nntile(c.vocab_size, c.n_embd, c.n_embd, \
+                c.n_embd, c.n_positions, c.n_inner, c.n_inner, \
+                c.layer_norm_epsilon, c.n_layer, c.n_head, c.n_head, \
+                "gelutanh", False, False)
+        model, next_tag = GPT2Model_nntile.from_torch(m, 1, 1, seq_len, \
+                seq_len, nntile_config, next_tag, \
+                kv_cache_size=kv_cache_size, kv_cache_size_tile=8, \
+                inference=True)
+        return model
+    model = from_torch(model_torch, config, k+1)
+    rng = np.random.default_rng(0)
+    # Draft by the main model itself is always accepted, while a different
+    # draft model shall not change the output
+    for draft_torch_, draft_config_ in [(model_torch, config), \
+            (draft_torch, draft_config)]:
+        draft = from_torch(draft_torch_, draft_config_, 1)
+        decoder = SpeculativeDecoder(model, draft, next_tag)
+        next_tag = decoder.next_tag
+        # The last request runs out of the KV-cache
+        for n, m in [(1, 6), (5, 7), (14, 8)]:
+            request = Request(rng.integers(config.vocab_size, \
+                    size=n).tolist(), m)
+            decoder.generate(request)
+            assert request.done
+            max_new_tokens = min(m, kv_cache_size-n+1)
+            assert request.tokens == generate_torch(model_torch, \
+                    request.prompt, max_new_tokens)
+        if draft_torch_ is model_torch:
+            assert decoder.naccepted == decoder.nproposed
+        decoder.unregister()
+        draft.unregister()
+    model.unregister()
+
+def test_prefill_decode_plans():
+    global next_tag
+    torch.manual_seed(0)
+    config = GPT2Config(vocab_size=64, n_positions=32, n_embd=32, n_layer=2, \
+            n_head=4, n_inner=64, activation_function="gelu_new", \
+            attn_pdrop=0, embd_pdrop=0, resid_pdrop=0)
+    model_torch = GPT2LMHeadModel(config)
+    model_torch.lm_head.weight = torch.nn.Parameter(model_torch.lm_head \
+            .weight.detach().clone())
+    model_torch.eval()
+    nntile_config = GPT2Config_nntile(config.vocab_size, config.n_embd, \
+            config.n_embd, config.n_embd, config.n_positions, \
+            config.n_inner, config.n_inner, config.layer_norm_epsilon, \
+            config.n_layer, config.n_head, config.n_head, "gelutanh", \
+            False, False)
+    # Prompt is processed by a single tile, while decoding takes a single
+    # token at a time
+    n_prompt, max_new_tokens = 8, 6
+    prefill, next_tag = GPT2Model_nntile.from_torch(model_torch, 1, 1, \
+            n_prompt, n_prompt, nntile_config, next_tag, kv_cache_size=16, \
+            kv_cache_size_tile=8, inference=True)
+    decode, next_tag = prefill.create_plan(1, 1, next_tag)
+    assert decode.parameters[0].value is prefill.parameters[0].value
+    prompt = np.random.default_rng(0).integers(config.vocab_size, \
+            size=n_prompt).tolist()
+    def next_token(model, ids, pos):
+        model.set_kv_cache_pos(pos)
+        model.activations[0].value.from_array(np.array(ids, \
+                dtype=np.int64, order="F").reshape(-1, 1))
+        model.forward_async()
+        logits = np.zeros(model.activations[-1].value.shape, \
+                dtype=np.float32, order="F")
+        model.activations[-1].value.to_array(logits)
+        return int(logits[:, -1, 0].argmax())
+    prefill.reset_kv_cache_async()
+    tokens = [next_token(prefill, prompt, 0)]
+    while len(tokens) < max_new_tokens:
+        tokens.append(next_token(decode, tokens[-1:], \
+                n_prompt+len(tokens)-1))
+    assert tokens == generate_torch(model_torch, prompt, max_new_tokens)
+    decode.unregister()
+    prefill.unregister()
+
+def test_continuous_batching():
+    run_test(0)
+
+def test_paged_kv_cache():
+    run_test(6)
+
+def test_sampling():
+    run_test(0, temperature=1.0, top_k=4, top_p=1e-4)
+    run_test(6, temperature=1.0, top_k=4, top_p=0.9)
+
+def test_inference_mode():
+    run_test(0, inference=True)
+    run_test(6, inference=True)
+
+if __name__ == "__main__":
+    test_continuous_batching()
+    test_paged_kv_cache()
+    test_sampling()
+    test_inference_mode()
+    test_speculative_decoding()
+    test_prefill_decode_plans()
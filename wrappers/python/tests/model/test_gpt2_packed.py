@@ -0,0 +1,70 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/model/test_gpt2_packed.py
+# Test for GPT2 model on packed variable-length sequences
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+import torch
+import nntile
+import numpy as np
+from transformers import GPT2LMHeadModel, GPT2Config
+from nntile.model.gpt2 import GPT2Config as GPT2Config_nntile, \
+        GPT2Model as GPT2Model_nntile
+from nntile.packing import pack_sequences
+
+# Set up StarPU+MPI and init codelets
+config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+next_tag = 0
+
+def test_packed_forward():
+    global next_tag
+    torch.manual_seed(0)
+    config = GPT2Config(vocab_size=64, n_positions=16, n_embd=32, n_layer=2, \
+            n_head=4, n_inner=64, activation_function="gelu_new", \
+            attn_pdrop=0, embd_pdrop=0, resid_pdrop=0)
+    model_torch = GPT2LMHeadModel(config)
+    model_torch.lm_head.weight = torch.nn.Parameter(model_torch.lm_head \
+            .weight.detach().clone())
+    model_torch.eval()
+    nntile_config = GPT2Config_nntile(config.vocab_size, config.n_embd, \
+            config.n_embd, config.n_embd, config.n_positions, \
+            config.n_inner, config.n_inner, config.layer_norm_epsilon, \
+            config.n_layer, config.n_head, config.n_head, "gelutanh", \
+            True, False)
+    seq_len = 16
+    model, next_tag = GPT2Model_nntile.from_torch(model_torch, 1, 1, \
+            seq_len, 4, nntile_config, next_tag)
+    # Documents of different lengths, the last one is split between rows
+    rng = np.random.default_rng(0)
+    docs = [rng.integers(config.vocab_size, size=n).tolist() \
+            for n in [5, 7, 6, 9]]
+    inputs, labels, offsets = pack_sequences(docs, seq_len)
+    assert inputs.shape == (1, seq_len)
+    assert list(offsets[0]) == [0, 4, 10, 15, 16]
+    assert labels[0, 3] == docs[0][4]
+    model.activations[0].value.from_array(np.asfortranarray(inputs.T))
+    model.set_packed_sequences(offsets[0])
+    model.forward_async()
+    logits = np.zeros(model.activations[-1].value.shape, order="F", \
+            dtype=np.float32)
+    model.activations[-1].value.to_array(logits)
+    # Every segment is the same as a separate sequence
+    for start, end in zip(offsets[0][:-1], offsets[0][1:]):
+        with torch.no_grad():
+            logits_torch = model_torch(torch.tensor(inputs[:, \
+                    start:end]))[0].numpy()
+        diff = np.linalg.norm(logits[:, start:end, 0].T - logits_torch[0])
+        assert diff <= 1e-4 * np.linalg.norm(logits_torch)
+    model.unregister()
+
+if __name__ == "__main__":
+    test_packed_forward()
+
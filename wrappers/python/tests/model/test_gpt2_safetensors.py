@@ -0,0 +1,97 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/model/test_gpt2_safetensors.py
+# Test for loading of GPT2 model from safetensors files
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+import torch
+import nntile
+import numpy as np
+import json
+import os
+import struct
+import tempfile
+from transformers import GPT2LMHeadModel, GPT2Config
+from nntile.model.gpt2 import GPT2Config as GPT2Config_nntile, \
+        GPT2Model as GPT2Model_nntile
+
+# Set up StarPU+MPI and init codelets
+config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+next_tag = 0
+
+# Write tensors into a safetensors file without the safetensors package
+def save_safetensors(filename, tensors, bf16=False):
+    header = {}
+    data = []
+    offset = 0
+    for name, t in tensors.items():
+        if bf16:
+            # Upper halves of single precision values
+            a = t.detach().to(torch.bfloat16).to(torch.float32).numpy()
+            raw = (np.ascontiguousarray(a).view(np.uint32) >> 16) \
+                    .astype(np.uint16).tobytes()
+        else:
+            raw = np.ascontiguousarray(t.detach().numpy()).tobytes()
+        header[name] = {"dtype": "BF16" if bf16 else "F32", \
+                "shape": list(t.shape), \
+                "data_offsets": [offset, offset+len(raw)]}
+        data.append(raw)
+        offset += len(raw)
+    header = json.dumps(header).encode()
+    with open(filename, "wb") as fp:
+        fp.write(struct.pack("<Q", len(header)))
+        fp.write(header)
+        for raw in data:
+            fp.write(raw)
+
+def run_test(bf16):
+    global next_tag
+    torch.manual_seed(0)
+    config = GPT2Config(vocab_size=64, n_positions=32, n_embd=32, n_layer=2, \
+            n_head=4, n_inner=64, activation_function="gelu_new")
+    model_torch = GPT2LMHeadModel(config)
+    if bf16:
+        model_torch = model_torch.to(torch.bfloat16).to(torch.float32)
+    nntile_config = GPT2Config_nntile(config.vocab_size, 16, \
+            config.n_embd, 16, config.n_positions, config.n_inner, 32, \
+            config.layer_norm_epsilon, config.n_layer, config.n_head, 2, \
+            "gelutanh", False, False)
+    with tempfile.TemporaryDirectory() as path:
+        # Weights of the head are tied, so they are listed only once
+        state = dict(model_torch.named_parameters())
+        save_safetensors(os.path.join(path, "model.safetensors"), state, \
+                bf16)
+        model, next_tag = GPT2Model_nntile.from_safetensors(path, 2, 1, 8, \
+                4, nntile_config, next_tag)
+    # Reference is loaded through PyTorch
+    model_torch.lm_head.weight = torch.nn.Parameter(model_torch.lm_head \
+            .weight.detach().clone())
+    model_ref, next_tag = GPT2Model_nntile.from_torch(model_torch, 2, 1, 8, \
+            4, nntile_config, next_tag)
+    assert len(model.parameters) == len(model_ref.parameters)
+    for p, p_ref in zip(model.parameters, model_ref.parameters):
+        a = np.zeros(p.value.shape, dtype=np.float32, order="F")
+        a_ref = np.zeros(p.value.shape, dtype=np.float32, order="F")
+        p.value.to_array(a)
+        p_ref.value.to_array(a_ref)
+        assert (a == a_ref).all()
+    model.unregister()
+    model_ref.unregister()
+
+def test_fp32():
+    run_test(False)
+
+def test_bf16():
+    run_test(True)
+
+if __name__ == "__main__":
+    test_fp32()
+    test_bf16()
@@ -0,0 +1,88 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/model/test_torch_fx.py
+# Test for import of PyTorch models by torch.fx into NNTile
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+# All necesary imports
+import nntile
+from nntile.torch_fx import from_torch_fx, pick_tile
+import numpy as np
+import torch
+import torch.nn as nn
+import torch.nn.functional as F
+
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+class Block(nn.Module):
+    def __init__(self, dim: int, hidden: int, n_classes: int):
+        super().__init__()
+        self.fc1 = nn.Linear(dim, hidden)
+        self.act = nn.GELU(approximate="tanh")
+        self.fc2 = nn.Linear(hidden, dim)
+        self.ln = nn.LayerNorm(dim)
+        self.head = nn.Linear(dim, n_classes, bias=False)
+
+    def forward(self, x):
+        h = self.fc2(self.act(self.fc1(x)))
+        h = self.ln(x + h)
+        return self.head(F.relu(h))
+
+def test_pick_tile():
+    assert pick_tile(100, 1024) == 100
+    assert pick_tile(3072, 1024) == 1024
+    assert pick_tile(1536, 1024) == 768
+    assert pick_tile(1543, 1024) == 1024
+
+def test_torch_fx():
+    dim, hidden, n_classes, batch = 8, 16, 5, 6
+    torch.manual_seed(0)
+    torch_model = Block(dim, hidden, n_classes).double()
+    x = torch.randn(batch, dim, dtype=torch.float64)
+    labels = torch.randint(0, n_classes, (batch,))
+    next_tag = 0
+    # Forward without a loss, that returns logits
+    model, next_tag = from_torch_fx(torch_model, [batch, dim], next_tag, \
+            tensor_type=nntile.tensor.Tensor_fp64, max_tile=4, batch_tile=4)
+    assert [p[1] for p in model.plan] == ["Linear(activation=gelutanh)", \
+            "Linear", "AddLayerNorm", "Act(relu)", "Linear"]
+    model.activations[0].value.from_array(x.numpy().T)
+    model.forward_async()
+    y = np.zeros(model.output.value.shape, dtype=np.float64, order="F")
+    model.output.value.to_array(y)
+    y_torch = torch_model(x).detach().numpy()
+    assert np.linalg.norm(y.T-y_torch) <= 1e-10*np.linalg.norm(y_torch)
+    model.unregister()
+    # The last linear layer is fused with cross-entropy
+    model, next_tag = from_torch_fx(torch_model, [batch, dim], next_tag, \
+            tensor_type=nntile.tensor.Tensor_fp64, loss="crossentropy", \
+            max_tile=4, batch_tile=4)
+    assert model.plan[-1][1] == "LinearCrossEntropy"
+    assert model.output is None
+    model.activations[0].value.from_array(x.numpy().T)
+    model.loss.y.from_array(labels.numpy())
+    model.forward_async()
+    val = np.zeros((1,), dtype=np.float64, order="F")
+    model.loss.val.to_array(val)
+    val_torch = F.cross_entropy(torch_model(x), labels, reduction="sum")
+    assert abs(val[0]-val_torch.item()) <= 1e-10*abs(val_torch.item())
+    model.unregister()
+    # Without fusions every node is a separate layer
+    model, next_tag = from_torch_fx(torch_model, [batch, dim], next_tag, \
+            tensor_type=nntile.tensor.Tensor_fp64, fuse=False)
+    assert len(model.layers) == 7
+    model.unregister()
+
+if __name__ == "__main__":
+    test_pick_tile()
+    test_torch_fx()
@@ -0,0 +1,88 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_starpu_host_pool.py
+# Test for pool of pinned CPU memory for tiles
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-11
+
+# All necesary imports
+import nntile
+import numpy as np
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+def test():
+    nntile.starpu.host_pool_enable()
+    assert nntile.starpu.host_pool_is_enabled()
+    shape = [20, 30]
+    traits = nntile.tensor.TensorTraits(shape, [10, 15])
+    mpi_distr = [0] * traits.grid.nelems
+    next_tag = 0
+    # Memory is not allocated before the first write
+    A = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    stats = nntile.starpu.host_pool_get_stats()
+    assert stats["nmisses"] == 0
+    assert stats["used"] == 0
+    # Each tile takes the minimal size class of 4096 bytes
+    np_A = np.array(np.random.randn(*shape), dtype=np.float32, order='F')
+    A.from_array(np_A)
+    stats = nntile.starpu.host_pool_get_stats()
+    assert stats["nmisses"] == traits.grid.nelems
+    assert stats["used"] == 4096 * traits.grid.nelems
+    np_B = np.zeros_like(np_A)
+    A.to_array(np_B)
+    assert (np_A == np_B).all()
+    A.unregister()
+    stats = nntile.starpu.host_pool_get_stats()
+    assert stats["used"] == 0
+    assert stats["cached"] == 4096 * traits.grid.nelems
+    # Buffers are reused by a new tensor on its first write
+    B = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    nntile.tensor.clear_async(B)
+    B.to_array(np_B)
+    assert (np_B == 0).all()
+    stats = nntile.starpu.host_pool_get_stats()
+    assert stats["nhits"] == traits.grid.nelems
+    assert stats["nmisses"] == traits.grid.nelems
+    assert stats["cached"] == 0
+    B.unregister()
+    nntile.starpu.host_pool_trim()
+    assert nntile.starpu.host_pool_get_stats()["cached"] == 0
+    nntile.starpu.host_pool_disable()
+    assert not nntile.starpu.host_pool_is_enabled()
+
+def test_huge_pages():
+    huge_page_size = 2**21
+    nntile.starpu.host_pool_enable(huge_page_size=huge_page_size)
+    # Tiles of 8 MB are backed by huge pages, while small ones are not
+    shape = [2**21, 2]
+    traits = nntile.tensor.TensorTraits(shape, [2**21, 1])
+    mpi_distr = [0] * traits.grid.nelems
+    next_tag = 0
+    A = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    nntile.tensor.clear_async(A)
+    small_traits = nntile.tensor.TensorTraits([10], [10])
+    B = nntile.tensor.Tensor_fp32(small_traits, [0], next_tag)
+    nntile.tensor.clear_async(B)
+    nntile.starpu.wait_for_all()
+    stats = nntile.starpu.host_pool_get_stats()
+    assert stats["huge"] == 4 * 2**21 * traits.grid.nelems
+    np_B = np.ones([10], dtype=np.float32, order='F')
+    B.to_array(np_B)
+    assert (np_B == 0).all()
+    A.unregister()
+    B.unregister()
+    nntile.starpu.host_pool_disable()
+    assert nntile.starpu.host_pool_get_stats()["huge"] == 0
+
+if __name__ == "__main__":
+    test()
+    test_huge_pages()
@@ -0,0 +1,71 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_starpu_memory.py
+# Test for tracking of memory of StarPU data handles
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-11
+
+# All necesary imports
+import nntile
+import numpy as np
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+def test():
+    nntile.starpu.memory_tracking_enable()
+    assert nntile.starpu.memory_tracking_is_enabled()
+    shape = [20, 30]
+    traits = nntile.tensor.TensorTraits(shape, [10, 15])
+    mpi_distr = [0] * traits.grid.nelems
+    next_tag = 0
+    A = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    next_tag = A.next_tag
+    B = nntile.tensor.Tensor_fp64(traits, mpi_distr, next_tag)
+    A.set_name("A")
+    B.set_name("B")
+    handles = nntile.starpu.memory_get_handles()
+    assert sum(h["size"] for h in handles if h["name"] == "A") == 4*20*30
+    assert sum(h["size"] for h in handles if h["name"] == "B") == 8*20*30
+    # Buffers of tiles are allocated in RAM by the first task
+    nntile.tensor.clear_async(A)
+    nntile.tensor.clear_async(B)
+    nntile.starpu.wait_for_all()
+    nntile.starpu.memory_sample()
+    ram = nntile.starpu.memory_get_stats()[0]
+    assert ram["used_by_name"]["A"] == 4*20*30
+    assert ram["used_by_name"]["B"] == 8*20*30
+    assert ram["peak"] >= 12*20*30
+    # Unregistered tensors are not tracked, while the peak is kept
+    A.unregister()
+    nntile.starpu.memory_sample()
+    ram = nntile.starpu.memory_get_stats()[0]
+    assert "A" not in ram["used_by_name"]
+    assert ram["peak_by_name"]["A"] == 4*20*30
+    nntile.starpu.memory_reset_peak()
+    ram = nntile.starpu.memory_get_stats()[0]
+    assert ram["peak"] == ram["used"]
+    B.unregister()
+    # Periodic sampling by a background thread
+    nntile.starpu.memory_tracking_enable(sampling_period_ms=1)
+    C = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    nntile.tensor.clear_async(C)
+    nntile.starpu.wait_for_all()
+    nntile.starpu.memory_sample()
+    ram = nntile.starpu.memory_get_stats()[0]
+    # Default names of tensors are unique
+    assert len([name for name in ram["used_by_name"] \
+            if name.startswith("tensor ")]) == 1
+    C.unregister()
+    nntile.starpu.memory_tracking_disable()
+    assert nntile.starpu.memory_get_handles() == []
+
+if __name__ == "__main__":
+    test()
@@ -0,0 +1,64 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_starpu_sched_ctx.py
+# Test for scheduling contexts over subsets of workers
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+# All necesary imports
+import nntile
+import numpy as np
+# Set up StarPU configuration with two CPU workers and init it
+config = nntile.starpu.Config(2, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+def test():
+    workers = nntile.starpu.get_worker_ids()
+    assert len(workers) == 2
+    assert nntile.starpu.get_worker_ids(cuda=True) == []
+    # Workloads with their own workers and policies
+    train = config.sched_ctx_create(workers[:1], "train")
+    serve = config.sched_ctx_create(workers[1:], "serve", "eager")
+    assert nntile.starpu.sched_ctx_get_workers(train) == workers[:1]
+    assert nntile.starpu.sched_ctx_get_workers(serve) == workers[1:]
+    shape = [20, 30]
+    traits = nntile.tensor.TensorTraits(shape, [10, 15])
+    mpi_distr = [0] * traits.grid.nelems
+    A = nntile.tensor.Tensor_fp32(traits, mpi_distr, 0)
+    B = nntile.tensor.Tensor_fp32(traits, mpi_distr, A.next_tag)
+    np_A = np.array(np.random.randn(*shape), dtype=np.float32, order='F')
+    A.from_array(np_A)
+    nntile.starpu.sched_ctx_enter(train)
+    nntile.tensor.copy_async(A, B)
+    nntile.tensor.scal_inplace_async(2.0, B)
+    nntile.starpu.sched_ctx_wait(train)
+    nntile.starpu.sched_ctx_enter(serve)
+    nntile.tensor.scal_inplace_async(3.0, B)
+    nntile.starpu.sched_ctx_exit()
+    np_B = np.zeros_like(np_A)
+    B.to_array(np_B)
+    assert (np_B == 6*np_A).all()
+    # Rebalance workers at runtime
+    nntile.starpu.sched_ctx_add_workers(serve, workers[:1])
+    assert sorted(nntile.starpu.sched_ctx_get_workers(serve)) == workers
+    nntile.starpu.sched_ctx_remove_workers(serve, workers[1:])
+    assert nntile.starpu.sched_ctx_get_workers(serve) == workers[:1]
+    try:
+        nntile.starpu.sched_ctx_remove_workers(serve, workers[:1])
+        assert False
+    except RuntimeError:
+        pass
+    config.sched_ctx_delete(train)
+    config.sched_ctx_delete(serve)
+    A.unregister()
+    B.unregister()
+
+if __name__ == "__main__":
+    test()
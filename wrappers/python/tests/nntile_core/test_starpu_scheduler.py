@@ -0,0 +1,75 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_starpu_scheduler.py
+# Test for locality-aware scheduler of NNTile
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-15
+
+# All necesary imports
+import nntile
+import numpy as np
+# Set up StarPU configuration with the locality-aware scheduler and init it
+config = nntile.starpu.Config(1, 0, 0, nntile.starpu.scheduler_locality)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+def test():
+    shape = [20, 30]
+    traits = nntile.tensor.TensorTraits(shape, [10, 15])
+    mpi_distr = [0] * traits.grid.nelems
+    next_tag = 0
+    A = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    next_tag = A.next_tag
+    B = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    # Tiles are owned by devices in a block-cyclic manner
+    devices = nntile.nntile_core.tensor.distributions.block_cyclic( \
+            traits.grid.shape, [2, 1], 0, 2)
+    A.set_device_distribution(devices)
+    B.set_device_distribution(devices)
+    assert A.device_distribution == devices
+    # Tiles are owned by NUMA nodes as well, there is at least one of them
+    nnuma = nntile.starpu.get_nnuma()
+    assert nnuma >= 1
+    numa = nntile.nntile_core.tensor.distributions.block_cyclic( \
+            traits.grid.shape, [1, 2], 0, nnuma)
+    A.set_numa_distribution(numa)
+    B.set_numa_distribution(numa)
+    assert B.numa_distribution == numa
+    # Devices of a node are cycled over tiles, owned by the node
+    assert nntile.nntile_core.tensor.distributions.local_cyclic( \
+            mpi_distr, 2) == [0, 1, 0, 1]
+    np_A = np.array(np.random.randn(*shape), dtype=np.float32, order='F')
+    A.from_array(np_A)
+    # Tasks of different priorities give the same result
+    for priority in [0, 1, -1]:
+        nntile.starpu.priority_set(priority)
+        assert nntile.starpu.priority_get() == priority
+        nntile.tensor.copy_async(A, B)
+        nntile.tensor.scal_inplace_async(2.0, B)
+    nntile.starpu.priority_set(0)
+    np_B = np.zeros_like(np_A)
+    B.to_array(np_B)
+    assert (np_B == 2*np_A).all()
+    # Gemm with an explicit priority keeps the current priority intact
+    assert nntile.tensor.background_priority() < 0
+    traits_C = nntile.tensor.TensorTraits([shape[0]]*2, [10, 10])
+    C = nntile.tensor.Tensor_fp32(traits_C, [0]*traits_C.grid.nelems, \
+            B.next_tag)
+    nntile.tensor.gemm_async(1.0, nntile.notrans, A, nntile.trans, B, 0.0, \
+            C, 1, 0, priority=nntile.tensor.background_priority())
+    assert nntile.starpu.priority_get() == 0
+    np_C = np.zeros((shape[0], shape[0]), dtype=np.float32, order='F')
+    C.to_array(np_C)
+    assert np.allclose(np_C, 2*np_A@np_A.T, rtol=1e-4, atol=1e-4)
+    C.unregister()
+    A.unregister()
+    B.unregister()
+
+if __name__ == "__main__":
+    test()
@@ -0,0 +1,68 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_starpu_stats.py
+# Test for statistics of executed tasks of StarPU codelets
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-11
+
+# All necesary imports
+import nntile
+import numpy as np
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+def test():
+    # Describe tensors of 4 tiles, located at node 0
+    shape = [20, 30]
+    basetile = [10, 15]
+    traits = nntile.tensor.TensorTraits(shape, basetile)
+    mpi_distr = [0] * traits.grid.nelems
+    next_tag = 0
+    A = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    next_tag = A.next_tag
+    B = nntile.tensor.Tensor_fp32(traits, mpi_distr, next_tag)
+    np_A = np.array(np.random.randn(*shape), dtype=np.float32, order='F')
+    A.from_array(np_A)
+    B.from_array(np_A)
+    # Nothing is collected before statistics are enabled
+    nntile.starpu.stats_reset()
+    nntile.tensor.add_async(1.0, A, 1.0, B)
+    nntile.starpu.wait_for_all()
+    assert not nntile.starpu.stats_is_enabled()
+    stats = {s["name"]: s for s in nntile.starpu.stats_get()}
+    assert "nntile_add_fp32" not in stats
+    # Collect statistics of several tasks
+    nntile.starpu.stats_enable()
+    nntile.tensor.add_async(1.0, A, 1.0, B)
+    nntile.tensor.add_async(1.0, A, 1.0, B)
+    nntile.starpu.wait_for_all()
+    nntile.starpu.stats_disable()
+    stats = {s["name"]: s for s in nntile.starpu.stats_get()}
+    add_stats = stats["nntile_add_fp32"]
+    assert add_stats["ntasks"] == 2 * traits.grid.nelems
+    assert add_stats["flops"] == 2 * 3 * np_A.size
+    # Source is read and destination is read and written
+    assert add_stats["bytes"] == 2 * 3 * np_A.nbytes
+    assert add_stats["time"] > 0
+    assert sum(w["ntasks"] for w in add_stats["workers"]) \
+            == add_stats["ntasks"]
+    # Statistics are kept after disabling and cleared after reset
+    nntile.tensor.add_async(1.0, A, 1.0, B)
+    nntile.starpu.wait_for_all()
+    stats = {s["name"]: s for s in nntile.starpu.stats_get()}
+    assert stats["nntile_add_fp32"]["ntasks"] == 2 * traits.grid.nelems
+    nntile.starpu.stats_reset()
+    assert nntile.starpu.stats_get() == []
+    A.unregister()
+    B.unregister()
+
+if __name__ == "__main__":
+    test()
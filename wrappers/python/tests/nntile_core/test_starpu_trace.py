@@ -0,0 +1,62 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_starpu_trace.py
+# Test for timeline of tasks in the Chrome trace format
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+# All necesary imports
+import nntile
+import json
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+def test(tmp_path):
+    traits = nntile.tensor.TensorTraits([20, 30], [10, 15])
+    mpi_distr = [0] * traits.grid.nelems
+    A = nntile.tensor.Tensor_fp32(traits, mpi_distr, 0)
+    A.set_name("A")
+    # Tasks, submitted before tracing is enabled, are not recorded
+    nntile.tensor.clear_async(A)
+    nntile.starpu.wait_for_all()
+    nntile.starpu.trace_clear()
+    nntile.starpu.trace_enable()
+    assert nntile.starpu.trace_is_enabled()
+    nntile.starpu.trace_scope_set("layer 0 forward")
+    assert nntile.starpu.trace_scope_get() == "layer 0 forward"
+    nntile.tensor.fill_async(1.0, A)
+    nntile.starpu.wait_for_all()
+    nntile.starpu.trace_disable()
+    nntile.starpu.trace_scope_set("")
+    events = nntile.starpu.trace_get_events()
+    assert len(events) == traits.grid.nelems
+    # Written tiles are marked by asterisks
+    tiles = sorted(e["data"][0] for e in events)
+    assert tiles == ["*A[0,0]", "*A[0,1]", "*A[1,0]", "*A[1,1]"]
+    for e in events:
+        assert e["scope"] == "layer 0 forward"
+        assert e["submit_us"] <= e["start_us"] <= e["end_us"]
+    path = tmp_path / "trace.json"
+    nntile.starpu.trace_export(str(path))
+    with open(path) as f:
+        trace = json.load(f)
+    tasks = [e for e in trace["traceEvents"] if e["ph"] == "X"]
+    assert len(tasks) == traits.grid.nelems
+    assert all(e["cat"] == "layer 0 forward" for e in tasks)
+    assert min(e["ts"] for e in tasks) == 0
+    nntile.starpu.trace_clear()
+    assert nntile.starpu.trace_get_events() == []
+    A.unregister()
+
+if __name__ == "__main__":
+    import pathlib, tempfile
+    with tempfile.TemporaryDirectory() as tmp:
+        test(pathlib.Path(tmp))
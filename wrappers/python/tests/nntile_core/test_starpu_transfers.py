@@ -0,0 +1,56 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_starpu_transfers.py
+# Test for statistics of transfers between memory nodes
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+# All necesary imports
+import nntile
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(-1, -1, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+def test():
+    nntile.starpu.memory_tracking_enable()
+    nntile.starpu.transfers_enable()
+    assert nntile.starpu.transfers_is_enabled()
+    traits = nntile.tensor.TensorTraits([20, 30], [10, 15])
+    mpi_distr = [0] * traits.grid.nelems
+    A = nntile.tensor.Tensor_fp32(traits, mpi_distr, 0)
+    B = nntile.tensor.Tensor_fp32(traits, mpi_distr, A.next_tag)
+    A.set_name("A")
+    B.set_name("B")
+    nntile.tensor.fill_async(1.0, A)
+    # Copies may run on another memory node, e.g., on a GPU
+    for i in range(3):
+        nntile.tensor.copy_async(A, B)
+        nntile.tensor.copy_async(B, A)
+    nntile.starpu.wait_for_all()
+    by_bus = nntile.starpu.transfers_get_by_bus()
+    by_name = nntile.starpu.transfers_get_by_name()
+    # Every named transfer is a transfer between a pair of nodes
+    for t in by_name:
+        assert t["name"] in ["A", "B", "untracked"]
+        assert t["bytes"] == 4 * 10 * 15 * t["count"]
+        bus = [b for b in by_bus if b["src"] == t["src"] \
+                and b["dst"] == t["dst"]]
+        assert len(bus) == 1 and bus[0]["bytes"] >= t["bytes"]
+    nntile.starpu.transfers_reset()
+    assert nntile.starpu.transfers_get_by_bus() == []
+    assert nntile.starpu.transfers_get_by_name() == []
+    nntile.starpu.transfers_disable()
+    assert not nntile.starpu.transfers_is_enabled()
+    A.unregister()
+    B.unregister()
+    nntile.starpu.memory_tracking_disable()
+
+if __name__ == "__main__":
+    test()
@@ -9,7 +9,7 @@
 #
 # @version 1.0.0
 # @author Aleksandr Mikhalev
-# @date 2023-12-18
+# @date 2024-03-15
 
 # All necesary imports
 import nntile
@@ -34,19 +34,96 @@ def helper(dtype):
     src = np.array(np.random.randn(*shape), dtype=dtype, order='F')
     dst = np.zeros_like(src)
     tensor.from_array(src)
+    # Prefetch hints do not change values
+    tensor.prefetch_async()
+    tensor.prefetch_async(0)
+    # Spill policy does not change values without a disk memory node
+    tensor.set_spill()
     tensor.to_array(dst)
     nntile.starpu.wait_for_all()
     tensor.unregister()
     return (dst == src).all()
 
+# Multi-tile tensors are copied tile by tile, while buffers and DLPack
+# capsules share memory with tensors
+def helper_zero_copy(dtype):
+    shape = [5, 7]
+    next_tag = 0
+    # Round trip through a multi-tile tensor
+    traits = nntile.tensor.TensorTraits(shape, [2, 3])
+    mpi_distr = [0] * traits.grid.nelems
+    tensor = Tensor[dtype](traits, mpi_distr, next_tag)
+    next_tag = tensor.next_tag
+    src = np.array(np.random.randn(*shape), dtype=dtype, order='F')
+    dst = np.zeros_like(src)
+    tensor.from_array(src)
+    tensor.to_array(dst)
+    tensor.unregister()
+    if (dst != src).any():
+        return False
+    # Tensor shares memory with a buffer
+    traits = nntile.tensor.TensorTraits(shape, shape)
+    buf = np.array(src, order='F')
+    tensor = Tensor[dtype].from_buffers(traits, [0], next_tag, [buf])
+    next_tag = tensor.next_tag
+    nntile.tensor.clear_async(tensor)
+    tensor.unregister()
+    if (buf != 0).any():
+        return False
+    # Tensor is exported and imported through DLPack
+    tensor = nntile.tensor.from_dlpack(src, next_tag)
+    next_tag = tensor.next_tag
+    nntile.tensor.clear_async(tensor)
+    view = np.from_dlpack(tensor)
+    if (view != 0).any():
+        return False
+    del view
+    tensor.unregister()
+    return True
+
+# Subarrays are copied only through intersecting tiles
+def helper_slice(dtype):
+    shape = [5, 7]
+    traits = nntile.tensor.TensorTraits(shape, [2, 3])
+    mpi_distr = [0] * traits.grid.nelems
+    tensor = Tensor[dtype](traits, mpi_distr, 0)
+    src = np.array(np.random.randn(*shape), dtype=dtype, order='F')
+    tensor.from_array(src)
+    part = nntile.tensor.to_array(tensor, [1, 2], [3, 4])
+    if (part != src[1:4, 2:6]).any():
+        tensor.unregister()
+        return False
+    new = np.array(np.random.randn(2, 3), dtype=dtype, order='F')
+    nntile.tensor.from_array(tensor, [3, 1], new)
+    src[3:5, 1:4] = new
+    dst = np.zeros_like(src)
+    tensor.to_array(dst)
+    if (dst != src).any():
+        tensor.unregister()
+        return False
+    # Tile-aligned slice shares tiles with the tensor
+    view = Tensor[dtype](tensor, [1, 1], [2, 1])
+    if view.shape != [3, 3]:
+        tensor.unregister()
+        return False
+    nntile.tensor.clear_async(view)
+    src[2:5, 3:6] = 0
+    tensor.to_array(dst)
+    view.unregister()
+    tensor.unregister()
+    return (dst == src).all()
+
 def test():
     for dtype in dtypes:
         assert helper(dtype)
+        assert helper_zero_copy(dtype)
+        assert helper_slice(dtype)
 
 # Repeat tests
 def test_repeat():
     for dtype in dtypes:
         assert helper(dtype)
+        assert helper_zero_copy(dtype)
 
 if __name__ == "__main__":
     test()
@@ -0,0 +1,71 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_tensor_contract.py
+# Test for tensor::contract<T> Python wrapper
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+# All necesary imports
+import nntile
+import numpy as np
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+# Define list of tested types
+dtypes = [np.float32, np.float64]
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+# Shapes and base tiles of modes
+mode_shape = {"b": 4, "c": 5, "d": 3, "h": 2, "i": 3, "j": 4, "k": 5}
+mode_tile = {"b": 2, "c": 3, "d": 3, "h": 1, "i": 2, "j": 3, "k": 2}
+
+# Helper function returns bool value true if test passes
+def helper(dtype, subscripts: str):
+    inputs, c_modes = subscripts.split("->")
+    a_modes, b_modes = inputs.split(",")
+    next_tag = 0
+    tensors = []
+    arrays = []
+    for modes in [a_modes, b_modes, c_modes]:
+        shape = [mode_shape[l] for l in modes]
+        traits = nntile.tensor.TensorTraits(shape, \
+                [mode_tile[l] for l in modes])
+        t = Tensor[dtype](traits, [0]*traits.grid.nelems, next_tag)
+        next_tag = t.next_tag
+        x = np.array(np.random.randn(*shape), dtype=dtype, order='F')
+        t.from_array(x)
+        tensors.append(t)
+        arrays.append(x)
+    A, B, C = tensors
+    np_A, np_B, np_C = arrays
+    next_tag = nntile.tensor.contract_async(2.0, A, B, -1.0, C, subscripts, \
+            next_tag)
+    np_res = np.zeros_like(np_C)
+    C.to_array(np_res)
+    nntile.starpu.wait_for_all()
+    for t in tensors:
+        t.unregister()
+    # Compare results
+    np_ref = 2*np.einsum(subscripts, np_A, np_B) - np_C
+    return np.linalg.norm(np_res-np_ref) <= 1e-5*np.linalg.norm(np_ref)
+
+# Test runner for different precisions
+def test():
+    for dtype in dtypes:
+        # Layouts of gemm without permutations
+        assert helper(dtype, "ik,kj->ij")
+        assert helper(dtype, "ij,jk->ki")
+        # Head-wise products of attention need permutations
+        assert helper(dtype, "hdb,hdc->hbc")
+        assert helper(dtype, "dhb,dhc->bch")
+
+if __name__ == "__main__":
+    test()
@@ -0,0 +1,91 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_tensor_fused_elementwise.py
+# Test for tensor::fused_elementwise<T> and nntile.tensor.fuse
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-15
+
+# All necesary imports
+import nntile
+import numpy as np
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+# Define list of tested types
+dtypes = [np.float32, np.float64]
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+
+# Helper function returns bool value true if test passes
+def helper(dtype):
+    shape = [6, 9, 4]
+    basetile = [4, 5, 4]
+    traits = nntile.tensor.TensorTraits(shape, basetile)
+    mpi_distr = [0] * traits.grid.nelems
+    next_tag = 0
+    tensors = []
+    for i in range(4):
+        tensors.append(Tensor[dtype](traits, mpi_distr, next_tag))
+        next_tag = tensors[-1].next_tag
+    g, m, v, d = tensors
+    np_g = np.array(np.random.randn(*shape), dtype=dtype, order='F')
+    np_m = np.array(np.random.randn(*shape), dtype=dtype, order='F')
+    np_v = np.array(np.random.rand(*shape)+0.5, dtype=dtype, order='F')
+    g.from_array(np_g)
+    m.from_array(np_m)
+    v.from_array(np_v)
+    np_d = np.zeros(shape, dtype=dtype, order='F')
+    with nntile.tensor.fuse() as fusion:
+        nntile.tensor.add_async(0.1, g, 0.9, m)
+        nntile.tensor.hypot_async(0.3, g, 0.7, v)
+        nntile.tensor.sqrt_async(v, d)
+        nntile.tensor.add_scalar_async(1e-3, 1.0, d)
+        nntile.tensor.prod_async(m, d)
+        nntile.tensor.scal_inplace_async(-2.0, d)
+        nntile.tensor.axpy_async(0.5, g, v)
+        # All the operations are recorded into a single program
+        nops = len(fusion.ops)
+        # Reading a tensor submits recorded operations
+        d.to_array(np_d)
+        nops_after = len(fusion.ops)
+    np_m2 = np.zeros_like(np_d)
+    np_v2 = np.zeros_like(np_d)
+    m.to_array(np_m2)
+    v.to_array(np_v2)
+    nntile.starpu.wait_for_all()
+    for t in tensors:
+        t.unregister()
+    # Compare results
+    ref_m = 0.1*np_g + 0.9*np_m
+    ref_v = np.hypot(0.3*np_g, 0.7*np_v)
+    ref_d = -2.0 * ref_m * (np.sqrt(ref_v)+1e-3)
+    ref_v += 0.5 * np_g
+    if nops != 7 or nops_after != 0:
+        return False
+    tol = 10 * np.finfo(dtype).eps
+    for res, ref in [(np_m2, ref_m), (np_v2, ref_v), (np_d, ref_d)]:
+        if np.linalg.norm(res-ref) > tol*np.linalg.norm(ref):
+            return False
+    return True
+
+# Test runner for different precisions
+def test():
+    for dtype in dtypes:
+        assert helper(dtype)
+
+# Repeat tests
+def test_repeat():
+    for dtype in dtypes:
+        assert helper(dtype)
+
+if __name__ == "__main__":
+    test()
+    test_repeat()
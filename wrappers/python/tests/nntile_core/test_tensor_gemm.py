@@ -70,11 +70,67 @@ def helper(dtype):
             return False
     return True
 
+# Helper function checks gemm of several tiles by Strassen codelets
+def helper_strassen(dtype, trans_A, trans_B):
+    m, n, k, batch = 10, 11, 9, 2
+    m_tile, n_tile, k_tile = 6, 6, 5
+    if trans_A == nntile.notrans:
+        A_shape, A_tile = [m, k, batch], [m_tile, k_tile, 1]
+    else:
+        A_shape, A_tile = [k, m, batch], [k_tile, m_tile, 1]
+    if trans_B == nntile.notrans:
+        B_shape, B_tile = [k, n, batch], [k_tile, n_tile, 1]
+    else:
+        B_shape, B_tile = [n, k, batch], [n_tile, k_tile, 1]
+    next_tag = 0
+    tensors = []
+    for shape, tile in [(A_shape, A_tile), (B_shape, B_tile), \
+            ([m, n, batch], [m_tile, n_tile, 1])]:
+        traits = nntile.tensor.TensorTraits(shape, tile)
+        tensor = Tensor[dtype](traits, [0]*traits.grid.nelems, next_tag)
+        next_tag = tensor.next_tag
+        tensors.append(tensor)
+    A, B, C = tensors
+    src_A = np.array(np.random.randn(*A_shape), dtype=dtype, order='F')
+    src_B = np.array(np.random.randn(*B_shape), dtype=dtype, order='F')
+    src_C = np.array(np.random.randn(m, n, batch), dtype=dtype, order='F')
+    dst_C = np.zeros_like(src_C)
+    A.from_array(src_A)
+    B.from_array(src_B)
+    C.from_array(src_C)
+    # Blocks of 2 rows and columns are enough to recurse on all tiles
+    nntile.starpu.strassen_enable(2)
+    gemm[dtype](-1.5, trans_A, A, trans_B, B, 0.5, C, 1, 1, 0)
+    nntile.starpu.strassen_disable()
+    C.to_array(dst_C)
+    nntile.starpu.wait_for_all()
+    A.unregister()
+    B.unregister()
+    C.unregister()
+    for i in range(batch):
+        op_A = src_A[:, :, i] if trans_A == nntile.notrans \
+                else src_A[:, :, i].T
+        op_B = src_B[:, :, i] if trans_B == nntile.notrans \
+                else src_B[:, :, i].T
+        src_C[:, :, i] = 0.5*src_C[:, :, i] - 1.5*(op_A@op_B)
+        if np.linalg.norm(dst_C[:, :, i]-src_C[:, :, i]) \
+                / np.linalg.norm(src_C[:, :, i]) > 1e-4:
+            return False
+    return True
+
 # Test runner for different precisions
 def test():
     for dtype in dtypes:
         assert helper(dtype)
 
+# Test gemm by Strassen codelets for all transpositions
+def test_strassen():
+    trans = [nntile.notrans, nntile.trans]
+    for dtype in dtypes:
+        for trans_A in trans:
+            for trans_B in trans:
+                assert helper_strassen(dtype, trans_A, trans_B)
+
 # Repeat tests
 def test_repeat():
     for dtype in dtypes:
@@ -82,5 +138,6 @@ def test_repeat():
 
 if __name__ == "__main__":
     test()
+    test_strassen()
     test_repeat()
 
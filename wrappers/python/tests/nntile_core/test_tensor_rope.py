@@ -0,0 +1,84 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_tensor_rope.py
+# Test for tensor::rope<T> and tensor::rope_backward<T> Python wrappers
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+# All necesary imports
+import nntile
+import numpy as np
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+# Define list of tested types
+dtypes = [np.float32, np.float64]
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+# Define mapping between tested function and numpy type
+rope = {np.float32: nntile.nntile_core.tensor.rope_fp32,
+        np.float64: nntile.nntile_core.tensor.rope_fp64}
+rope_backward = {np.float32: nntile.nntile_core.tensor.rope_backward_fp32,
+        np.float64: nntile.nntile_core.tensor.rope_backward_fp64}
+
+# Reference rotation of interleaved pairs along the first axis
+def rope_numpy(base, position, x):
+    head_size = x.shape[0]
+    freq = base ** (-np.arange(0, head_size, 2) / head_size)
+    pos = position + np.arange(x.shape[1])
+    angle = freq[:, None] * pos[None, :]
+    angle = angle.reshape(angle.shape + (1,)*(x.ndim-2))
+    x0, x1 = x[0::2], x[1::2]
+    y = np.empty_like(x)
+    y[0::2] = np.cos(angle)*x0 - np.sin(angle)*x1
+    y[1::2] = np.sin(angle)*x0 + np.cos(angle)*x1
+    return y
+
+# Helper function returns bool value true if test passes
+def helper(dtype):
+    # Describe multi-tile tensor, located at node 0
+    shape = [8, 6, 3, 2]
+    basetile = [4, 4, 2, 1]
+    next_tag = 0
+    traits = nntile.tensor.TensorTraits(shape, basetile)
+    mpi_distr = [0] * traits.grid.nelems
+    # Tensor objects
+    A = Tensor[dtype](traits, mpi_distr, next_tag)
+    # Set initial values of tensors
+    rand_A = np.random.randn(*shape)
+    np_A = np.array(rand_A, dtype=dtype, order='F')
+    A.from_array(np_A)
+    base, position = 100.0, 5
+    rope[dtype](base, position, A)
+    np_B = np.zeros(shape, dtype=dtype, order='F')
+    A.to_array(np_B)
+    np_ref = rope_numpy(base, position, rand_A)
+    ok = np.allclose(np_B, np_ref, rtol=1e-5, atol=1e-5)
+    # Backward is the inverse rotation
+    rope_backward[dtype](base, position, A)
+    A.to_array(np_B)
+    nntile.starpu.wait_for_all()
+    A.unregister()
+    return ok and np.allclose(np_B, np_A, rtol=1e-5, atol=1e-5)
+
+# Test runner for different precisions
+def test():
+    for dtype in dtypes:
+        assert helper(dtype)
+
+# Repeat tests
+def test_repeat():
+    for dtype in dtypes:
+        assert helper(dtype)
+
+if __name__ == "__main__":
+    test()
+    test_repeat()
@@ -9,12 +9,15 @@ import numpy as np
 nntile_config = nntile.starpu.Config(1, 0, 0)
 nntile.starpu.init()
 
-def run_test(dim, num_steps, device, lr, tol=1e-5):
+def run_test(dim, num_steps, device, lr, tol=1e-5, max_grad_norm=None,
+             dim_tile=None, multi_tensor=True):
     torch_param = torch.randn((dim, ), device=device, requires_grad=True, dtype=torch.float32)
     next_tag = 0
+    if dim_tile is None:
+        dim_tile = dim
     x_traits = nntile.tensor.TensorTraits( \
                 [dim], \
-                [dim])
+                [dim_tile])
     x_distr = [0] * x_traits.grid.nelems
     x = nntile.tensor.Tensor_fp32(x_traits, x_distr, next_tag)
     next_tag = x.next_tag
@@ -22,7 +25,8 @@ def run_test(dim, num_steps, device, lr, tol=1e-5):
     x_grad = nntile.tensor.Tensor_fp32(x_traits, x_distr, next_tag)
     next_tag = x_grad.next_tag
     nntile_param = nntile.tensor.TensorMoments(x, x_grad, True)
-    nntile_optimizer = nntile.optimizer.FusedAdam([nntile_param], lr, next_tag)
+    nntile_optimizer = nntile.optimizer.FusedAdam([nntile_param], lr, next_tag,
+            multi_tensor=multi_tensor, max_grad_norm=max_grad_norm)
     next_tag = nntile_optimizer.get_next_tag()
 
     torch_optimizer = optim.Adam([torch_param], lr=lr)
@@ -30,6 +34,8 @@ def run_test(dim, num_steps, device, lr, tol=1e-5):
     for i_step in range(num_steps):
         torch_param.grad = torch.randn((dim, ), device=device)
         nntile_param.grad.from_array(torch_param.grad.detach().cpu().numpy())
+        if max_grad_norm is not None:
+            nn.utils.clip_grad_norm_([torch_param], max_grad_norm)
         torch_optimizer.step()
         nntile_optimizer.step()
         nntile_param.value.to_array(nntile_param_np)
@@ -53,3 +59,9 @@ if __name__ == "__main__":
 
     run_test(dim=1000, num_steps=100, device="cpu", lr=1e-4)
     #run_test(dim=1000, num_steps=100, device="cuda", lr=1e-4)
+
+    # Clipping by a global norm of gradients of all tiles on the device
+    run_test(dim=1000, num_steps=10, device="cpu", lr=1e-1, max_grad_norm=10,
+             dim_tile=300)
+    run_test(dim=1000, num_steps=10, device="cpu", lr=1e-1, max_grad_norm=10,
+             dim_tile=300, multi_tensor=False)
@@ -0,0 +1,72 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/optimizer/test_lazy_adam.py
+# Test for nntile.optimizer.LazyAdam
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-13
+
+import nntile
+import numpy as np
+
+nntile_config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+
+def run_test(vocab_size, emb_size, emb_size_tile, ntokens, num_steps, lr, \
+        beta1=0.9, beta2=0.999, eps=1e-8, tol=1e-5):
+    next_tag = 0
+    x_traits = nntile.tensor.TensorTraits([ntokens], [ntokens])
+    x = nntile.tensor.Tensor_int64(x_traits, [0], next_tag)
+    next_tag = x.next_tag
+    layer, next_tag = nntile.layer.Embedding.generate_simple(x, \
+            nntile.tensor.Tensor_fp32, 0, vocab_size, emb_size, \
+            emb_size_tile, emb_size_tile, next_tag, sparse_grad=True)
+    w_np = np.random.randn(emb_size, vocab_size).astype(np.float32, \
+            order="F")
+    layer.w.value.from_array(w_np)
+    optimizer = nntile.optimizer.LazyAdam(layer.parameters, lr, next_tag)
+    next_tag = optimizer.get_next_tag()
+    # Reference lazy Adam with a number of steps per row
+    w_ref = w_np.astype(np.float64)
+    m_ref = np.zeros_like(w_ref)
+    v_ref = np.zeros_like(w_ref)
+    t_ref = np.zeros(vocab_size, dtype=np.int64)
+    w_out = np.zeros_like(w_np)
+    for i_step in range(num_steps):
+        # Only a few tokens of the vocabulary are used
+        x_np = np.random.randint(vocab_size//4, size=ntokens)
+        x.from_array(x_np)
+        dy_np = np.random.randn(emb_size, ntokens).astype(np.float32, \
+                order="F")
+        layer.y.grad.from_array(dy_np)
+        nntile.tensor.clear_async(layer.w.grad)
+        nntile.tensor.clear_async(layer.rows)
+        layer.backward_async()
+        optimizer.step()
+        grad = np.zeros_like(w_ref)
+        np.add.at(grad.T, x_np, dy_np.T)
+        for j in np.unique(x_np):
+            t_ref[j] += 1
+            m_ref[:, j] = beta1*m_ref[:, j] + (1-beta1)*grad[:, j]
+            v_ref[:, j] = beta2*v_ref[:, j] + (1-beta2)*grad[:, j]**2
+            m_hat = m_ref[:, j] / (1-beta1**t_ref[j])
+            v_hat = v_ref[:, j] / (1-beta2**t_ref[j])
+            w_ref[:, j] -= lr * m_hat / (np.sqrt(v_hat)+eps)
+        layer.w.value.to_array(w_out)
+        assert np.linalg.norm(w_out-w_ref) <= tol*np.linalg.norm(w_ref)
+        # Rows of unused tokens are not changed at all
+        assert (w_out[:, vocab_size//4:] == w_np[:, vocab_size//4:]).all()
+    optimizer.unregister()
+    layer.unregister()
+    x.unregister()
+
+if __name__ == "__main__":
+    run_test(vocab_size=100, emb_size=30, emb_size_tile=30, ntokens=20, \
+            num_steps=5, lr=1e-2)
+    run_test(vocab_size=1000, emb_size=64, emb_size_tile=16, ntokens=50, \
+            num_steps=5, lr=1e-1)
@@ -0,0 +1,78 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/optimizer/test_mixed_precision.py
+# Test for nntile.optimizer.MixedPrecision
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-01
+
+import torch.optim as optim
+import torch
+import nntile
+import numpy as np
+
+nntile_config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+
+def run_test(dim, num_steps, lr, tol=1e-5, offload=False):
+    torch_param = torch.randn((dim, ), requires_grad=True, \
+            dtype=torch.float32)
+    next_tag = 0
+    x_traits = nntile.tensor.TensorTraits([dim], [dim])
+    x_distr = [0] * x_traits.grid.nelems
+    x = nntile.tensor.Tensor_bf16(x_traits, x_distr, next_tag)
+    next_tag = x.next_tag
+    # Master weights start from parameters rounded to bf16
+    torch_param.data = torch_param.data.to(torch.bfloat16).to(torch.float32)
+    x.from_array(torch_param.detach().numpy())
+    x_grad = nntile.tensor.Tensor_bf16(x_traits, x_distr, next_tag)
+    next_tag = x_grad.next_tag
+    nntile_param = nntile.tensor.TensorMoments(x, x_grad, True)
+    scaler = nntile.optimizer.DynamicLossScaler(init_scale=2.**10, \
+            growth_interval=3)
+    nntile_optimizer = nntile.optimizer.MixedPrecision([nntile_param], \
+            next_tag, nntile.optimizer.FusedAdam, loss_scaler=scaler, \
+            offload=offload, lr=lr)
+    next_tag = nntile_optimizer.get_next_tag()
+    torch_optimizer = optim.Adam([torch_param], lr=lr)
+    master_np = np.zeros((dim,), dtype=np.float32, order="F")
+    param_np = np.zeros((dim,), dtype=np.float32, order="F")
+    for i_step in range(num_steps):
+        scale = scaler.scale
+        grad = torch.randn((dim, )).to(torch.bfloat16).to(torch.float32)
+        # Overflowed step shall be skipped and decrease the scale
+        if i_step == num_steps // 2:
+            grad_np = (scale*grad).numpy()
+            grad_np[0] = np.inf
+            nntile_param.grad.from_array(grad_np)
+            nntile_optimizer.step()
+            assert scaler.scale == scale * scaler.backoff_factor
+            assert nntile_optimizer.num_skipped_steps == 1
+            continue
+        torch_param.grad = grad
+        nntile_param.grad.from_array((scale*grad).numpy())
+        torch_optimizer.step()
+        nntile_optimizer.step()
+        nntile_optimizer.master_params[0].value.to_array(master_np)
+        torch_np = torch_param.data.numpy()
+        assert np.linalg.norm(torch_np-master_np) / np.linalg.norm(torch_np) \
+                < tol
+        # Parameters are master weights rounded to bf16
+        nntile_param.value.to_array(param_np)
+        assert np.linalg.norm(param_np-master_np) \
+                <= 2**-8 * np.linalg.norm(master_np)
+    assert scaler.scale > 2.**10
+    assert not nntile.starpu.offload_is_active()
+    nntile_optimizer.unregister()
+    nntile_param.unregister()
+
+if __name__ == "__main__":
+    run_test(dim=1000, num_steps=20, lr=1e-1)
+    run_test(dim=1000, num_steps=20, lr=1e-4)
+    # Optimizer in host RAM gives the same result
+    run_test(dim=1000, num_steps=20, lr=1e-1, offload=True)
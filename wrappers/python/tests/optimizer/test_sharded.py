@@ -0,0 +1,79 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/optimizer/test_sharded.py
+# Test for nntile.optimizer.Sharded
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-02-09
+
+import torch.optim as optim
+import torch
+import nntile
+import numpy as np
+
+nntile_config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+
+def run_test(dim, dim_tile, num_steps, lr, master_weights, tol=1e-5):
+    torch_param = torch.randn((dim, ), requires_grad=True, \
+            dtype=torch.float32)
+    next_tag = 0
+    x_traits = nntile.tensor.TensorTraits([dim], [dim_tile])
+    x_distr = [0] * x_traits.grid.nelems
+    if master_weights:
+        x_type = nntile.tensor.Tensor_bf16
+        # Master weights start from parameters rounded to bf16
+        torch_param.data = torch_param.data.to(torch.bfloat16) \
+                .to(torch.float32)
+    else:
+        x_type = nntile.tensor.Tensor_fp32
+    x = x_type(x_traits, x_distr, next_tag)
+    next_tag = x.next_tag
+    x.from_array(torch_param.detach().numpy())
+    x_grad = x_type(x_traits, x_distr, next_tag)
+    next_tag = x_grad.next_tag
+    nntile_param = nntile.tensor.TensorMoments(x, x_grad, True)
+    nntile_optimizer = nntile.optimizer.Sharded([nntile_param], next_tag, \
+            nntile.optimizer.FusedAdam, master_weights=master_weights, lr=lr)
+    next_tag = nntile_optimizer.get_next_tag()
+    # Shards are balanced over ranks
+    nranks = len(nntile_optimizer.ranks)
+    assert max(nntile_optimizer.rank_nelems) \
+            <= (dim+nranks-1)//nranks + dim_tile
+    torch_optimizer = optim.Adam([torch_param], lr=lr)
+    shard_np = np.zeros((dim,), dtype=np.float32, order="F")
+    param_np = np.zeros((dim,), dtype=np.float32, order="F")
+    for i_step in range(num_steps):
+        grad = torch.randn((dim, ))
+        if master_weights:
+            grad = grad.to(torch.bfloat16).to(torch.float32)
+        torch_param.grad = grad
+        nntile_param.grad.from_array(grad.numpy())
+        torch_optimizer.step()
+        nntile_optimizer.step()
+        nntile_optimizer.shards[0].value.to_array(shard_np)
+        torch_np = torch_param.data.numpy()
+        assert np.linalg.norm(torch_np-shard_np) / np.linalg.norm(torch_np) \
+                < tol
+        # Parameters are gathered from shards
+        nntile_param.value.to_array(param_np)
+        if master_weights:
+            assert np.linalg.norm(param_np-shard_np) \
+                    <= 2**-8 * np.linalg.norm(shard_np)
+        else:
+            assert (param_np == shard_np).all()
+    nntile_optimizer.unregister()
+    nntile_param.unregister()
+
+if __name__ == "__main__":
+    run_test(dim=1000, dim_tile=100, num_steps=10, lr=1e-1, \
+            master_weights=False)
+    run_test(dim=1000, dim_tile=300, num_steps=10, lr=1e-4, \
+            master_weights=False)
+    run_test(dim=1000, dim_tile=100, num_steps=10, lr=1e-1, \
+            master_weights=True)
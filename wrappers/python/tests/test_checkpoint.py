@@ -0,0 +1,140 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/test_checkpoint.py
+# Test for nntile.checkpoint
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-14
+
+import nntile
+import numpy as np
+import os
+import tempfile
+
+# Set up StarPU+MPI and init codelets
+config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+
+shape = [7, 10]
+basetile_shape = [3, 4]
+types = {"fp32": (nntile.tensor.Tensor_fp32, np.float32), \
+        "fp64": (nntile.tensor.Tensor_fp64, np.float64), \
+        "bf16": (nntile.tensor.Tensor_bf16, np.float32), \
+        "int64": (nntile.tensor.Tensor_int64, np.int64)}
+
+def make_tensors(next_tag, rng=None):
+    traits = nntile.tensor.TensorTraits(shape, basetile_shape)
+    distr = [0] * traits.grid.nelems
+    tensors = {}
+    arrays = {}
+    for name, (cls, dtype) in types.items():
+        x = cls(traits, distr, next_tag)
+        next_tag = x.next_tag
+        if rng is not None:
+            # Values are exactly representable in all the types
+            a = np.array(rng.integers(-100, 100, size=shape), dtype=dtype, \
+                    order="F")
+        else:
+            a = np.zeros(shape, dtype=dtype, order="F")
+        x.from_array(a)
+        tensors[name] = x
+        arrays[name] = a
+    return tensors, arrays, next_tag
+
+def test_checkpoint():
+    rng = np.random.default_rng(0)
+    src, arrays, next_tag = make_tensors(0, rng)
+    with tempfile.TemporaryDirectory() as path:
+        pending = nntile.checkpoint.save_async(path, src, {"step": 5})
+        # Tensors may be updated right after submission of writes
+        for name, x in src.items():
+            x.from_array(np.zeros_like(arrays[name]))
+        pending.wait()
+        assert os.path.exists(os.path.join(path, "index.json"))
+        index = nntile.checkpoint.read_index(path)
+        for info in index["tensors"].values():
+            for tile in info["tiles"]:
+                assert tile[1] % nntile.checkpoint.ALIGNMENT == 0
+        # Read into existing tensors
+        dst, zeros, next_tag = make_tensors(next_tag)
+        assert nntile.checkpoint.load(path, dst) == {"step": 5}
+        for name, x in dst.items():
+            x.to_array(zeros[name])
+            assert (zeros[name] == arrays[name]).all()
+            x.unregister()
+        # Register tiles in memory-mapped files
+        names = ["fp32", "fp64", "int64"]
+        mapped, next_tag = nntile.checkpoint.load_mmap(path, next_tag, names)
+        for name in names:
+            a = np.zeros(shape, dtype=types[name][1], order="F")
+            mapped[name].to_array(a)
+            assert (a == arrays[name]).all()
+            # Files are mapped privately
+            mapped[name].from_array(np.zeros_like(a))
+            mapped[name].unregister()
+        dst, zeros, next_tag = make_tensors(next_tag)
+        nntile.checkpoint.load(path, dst)
+        for name, x in dst.items():
+            x.to_array(zeros[name])
+            assert (zeros[name] == arrays[name]).all()
+            x.unregister()
+    for x in src.values():
+        x.unregister()
+
+def test_snapshot():
+    rng = np.random.default_rng(1)
+    src, arrays, next_tag = make_tensors(0, rng)
+    with tempfile.TemporaryDirectory() as path:
+        pending, next_tag = nntile.checkpoint.snapshot_async(path, src, \
+                next_tag, {"step": 7})
+        # Updates wait only for copies into staging tensors
+        for name, x in src.items():
+            x.from_array(np.zeros_like(arrays[name]))
+            x.unregister()
+        pending.wait()
+        assert pending.is_written()
+        dst, zeros, next_tag = make_tensors(next_tag)
+        assert nntile.checkpoint.load(path, dst) == {"step": 7}
+        for name, x in dst.items():
+            x.to_array(zeros[name])
+            assert (zeros[name] == arrays[name]).all()
+            x.unregister()
+
+def test_manager():
+    rng = np.random.default_rng(2)
+    src, arrays, next_tag = make_tensors(0, rng)
+    with tempfile.TemporaryDirectory() as root:
+        manager = nntile.checkpoint.CheckpointManager(root, keep=2)
+        assert manager.restore(src) is None
+        for step in range(1, 4):
+            manager.save_async(step, src, {"lr": 0.1})
+        pending, next_tag = manager.snapshot_async(4, src, next_tag)
+        manager.wait()
+        assert manager.steps() == [3, 4]
+        # Checkpoint, interrupted by a failure, has no index
+        os.makedirs(manager.path(5))
+        assert manager.latest() == 4
+        dst, zeros, next_tag = make_tensors(next_tag)
+        assert manager.restore(dst) == {"step": 4}
+        for name, x in dst.items():
+            x.to_array(zeros[name])
+            assert (zeros[name] == arrays[name]).all()
+            x.unregister()
+        dst, zeros, next_tag = make_tensors(next_tag)
+        nntile.checkpoint.load(manager.path(3), dst)
+        assert nntile.checkpoint.read_attrs(manager.path(3)) == \
+                {"lr": 0.1, "step": 3}
+        for x in dst.values():
+            x.unregister()
+    for x in src.values():
+        x.unregister()
+
+if __name__ == "__main__":
+    test_checkpoint()
+    test_snapshot()
+    test_manager()
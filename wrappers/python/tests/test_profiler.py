@@ -0,0 +1,56 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/test_profiler.py
+# Test for nntile.profiler
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+import nntile
+import numpy as np
+from nntile.tensor import TensorTraits, TensorMoments
+from nntile.model.deep_linear import DeepLinear
+
+# Set up StarPU+MPI and init codelets
+config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+
+def test_profiler():
+    traits = TensorTraits([16, 8], [8, 4])
+    distr = [0] * traits.grid.nelems
+    x_value = nntile.tensor.Tensor_fp32(traits, distr, 0)
+    x_grad = nntile.tensor.Tensor_fp32(traits, distr, x_value.next_tag)
+    x = TensorMoments(x_value, x_grad, True)
+    model = DeepLinear(x, 'R', 1, 12, 6, 3, x_grad.next_tag)
+    model.init_randn_async()
+    nntile.tensor.randn_async(x.value, [0, 0], [16, 8], 0, 0.0, 1.0)
+    nntile.tensor.clear_async(x.grad)
+    model.clear_parameters_grads()
+    nntile.tensor.clear_async(model.activations[-1].grad)
+    nntile.starpu.wait_for_all()
+    with model.profile_layers({"CPU": 1e6}) as profiler:
+        model.forward_async()
+        model.backward_async()
+    nntile.starpu.wait_for_all()
+    stats = {s.scope: s for s in profiler.get_stats()}
+    for i in range(3):
+        for stage in ["forward", "backward"]:
+            s = stats["Linear {} {}".format(i, stage)]
+            assert s.ntasks > 0
+            assert s.flops > 0
+            assert s.compute >= 0 and s.transfer >= 0 and s.wait >= 0
+            assert 0 <= s.efficiency <= 1
+    # Flops of the forward pass of the first layer include its gemms
+    assert stats["Linear 0 forward"].flops >= 2 * 12 * 16 * 8
+    assert "Linear 0 forward" in profiler.report()
+    assert not nntile.starpu.trace_is_enabled()
+    model.unregister()
+    x.unregister()
+
+if __name__ == "__main__":
+    test_profiler()
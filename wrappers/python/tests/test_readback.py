@@ -0,0 +1,44 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/test_readback.py
+# Test for nntile.readback
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2024-03-15
+
+import nntile
+import numpy as np
+from nntile.readback import ScalarReadback
+
+# Set up StarPU+MPI and init codelets
+config = nntile.starpu.Config(1, 0, 0)
+nntile.starpu.init()
+
+def test_readback():
+    traits = nntile.tensor.TensorTraits([], [])
+    x = nntile.tensor.Tensor_fp32(traits, [0], 0)
+    y = nntile.tensor.Tensor_fp64(traits, [0], x.next_tag)
+    # Ring is smaller than the number of values, so slots are reused
+    readback = ScalarReadback(3)
+    values = []
+    futures = []
+    for i in range(10):
+        # Tensors are updated right after submission of readbacks
+        nntile.tensor.fill_async(float(i), x)
+        nntile.tensor.fill_async(0.5, y)
+        futures.append(readback.submit_async([x, y], values.append))
+        readback.poll()
+    assert futures[-1].result() == 9.5
+    readback.wait()
+    assert values == [i+0.5 for i in range(10)]
+    assert all(f.done() for f in futures)
+    x.unregister()
+    y.unregister()
+
+if __name__ == "__main__":
+    test_readback()